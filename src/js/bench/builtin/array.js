@@ -0,0 +1,32 @@
+// |bench| builtin/Array
+
+// The Array builtins which are self-hosted or inlined by Ion.
+
+var sink = 0;
+
+var numbers = [];
+for (var i = 0; i < 1000; i++) {
+    numbers.push((i * 7919) % 1000);
+}
+
+benchmark(() => {
+    sink += numbers.map(x => x * 2).filter(x => x % 3 == 0).reduce((a, b) => a + b, 0);
+}, { name: "map-filter-reduce" });
+
+benchmark(() => {
+    var array = [];
+    for (var i = 0; i < 1000; i++) {
+        array.push(i);
+    }
+    while (array.length) {
+        sink += array.pop();
+    }
+}, { name: "push-pop" });
+
+benchmark(() => {
+    sink += numbers.slice().sort((a, b) => a - b)[500];
+}, { name: "sort" });
+
+benchmark(() => {
+    sink += numbers.indexOf(999) + numbers.includes(-1) + numbers.concat(numbers).length;
+}, { name: "search-concat" });
@@ -0,0 +1,63 @@
+// |bench| builtin/Math
+
+// Transcendental Math functions in loops, as in physics and signal processing
+// code. Ion computes exp and log inline on x64 and calls out for the others.
+
+var sink = 0;
+
+var inputs = new Float64Array(1024);
+for (var i = 0; i < inputs.length; i++) {
+    inputs[i] = (i - 512) / 64;
+}
+
+var outputs = new Float64Array(inputs.length);
+
+// Each function gets its own loop, so that Ion sees a monomorphic call it can
+// inline.
+benchmark(() => {
+    for (var i = 0; i < inputs.length; i++) {
+        outputs[i] = Math.exp(inputs[i]);
+    }
+    sink += outputs[100];
+}, { name: "exp" });
+
+benchmark(() => {
+    for (var i = 0; i < inputs.length; i++) {
+        outputs[i] = Math.log(inputs[i] + 8.5);
+    }
+    sink += outputs[100];
+}, { name: "log" });
+
+benchmark(() => {
+    for (var i = 0; i < inputs.length; i++) {
+        outputs[i] = Math.sin(inputs[i]);
+    }
+    sink += outputs[100];
+}, { name: "sin" });
+
+benchmark(() => {
+    for (var i = 0; i < inputs.length; i++) {
+        outputs[i] = Math.cos(inputs[i]);
+    }
+    sink += outputs[100];
+}, { name: "cos" });
+
+benchmark(() => {
+    for (var i = 0; i < inputs.length; i++) {
+        outputs[i] = Math.pow(1.5, inputs[i]);
+    }
+    sink += outputs[100];
+}, { name: "pow" });
+
+// A softmax over the inputs, mixing exp and log with arithmetic.
+benchmark(() => {
+    var sum = 0;
+    for (var i = 0; i < inputs.length; i++) {
+        sum += Math.exp(inputs[i] / 8);
+    }
+    var logSum = Math.log(sum);
+    for (var i = 0; i < inputs.length; i++) {
+        outputs[i] = Math.exp(inputs[i] / 8 - logSum);
+    }
+    sink += outputs[512];
+}, { name: "softmax" });
@@ -0,0 +1,35 @@
+// |bench| builtin/RegExp
+
+// Matching with native regexp code, global replacement and captures.
+
+var sink = 0;
+
+var lines = [];
+for (var i = 0; i < 200; i++) {
+    lines.push("2018-07-" + (10 + i % 20) + " user" + i + "@example.com GET /index.html 200");
+}
+var log = lines.join("\n");
+
+var dateRe = /(\d{4})-(\d{2})-(\d{2})/g;
+var emailRe = /[a-z0-9]+@[a-z]+\.com/;
+
+benchmark(() => {
+    var count = 0;
+    dateRe.lastIndex = 0;
+    while (dateRe.exec(log)) {
+        count++;
+    }
+    sink += count;
+}, { name: "exec-global" });
+
+benchmark(() => {
+    var count = 0;
+    for (var i = 0; i < lines.length; i++) {
+        count += emailRe.test(lines[i]);
+    }
+    sink += count;
+}, { name: "test" });
+
+benchmark(() => {
+    sink += log.replace(/GET|POST/g, "REQ").length;
+}, { name: "replace-global" });
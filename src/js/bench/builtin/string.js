@@ -0,0 +1,32 @@
+// |bench| builtin/String
+
+// Concatenation, flattening of ropes, searching, splitting and case changes.
+
+var sink = 0;
+
+var words = [];
+for (var i = 0; i < 100; i++) {
+    words.push("word" + i);
+}
+var text = words.join(" ");
+var upper = text.toUpperCase();
+
+benchmark(() => {
+    var s = "";
+    for (var i = 0; i < words.length; i++) {
+        s += words[i] + ",";
+    }
+    sink += s.charCodeAt(s.length - 1);
+}, { name: "concat-flatten" });
+
+benchmark(() => {
+    sink += text.indexOf("word99") + text.lastIndexOf("word1 ") + text.includes("missing");
+}, { name: "search" });
+
+benchmark(() => {
+    sink += text.split(" ").length + upper.toLowerCase().length;
+}, { name: "split-case" });
+
+benchmark(() => {
+    sink += text.substring(10, 60).replace("word", "w").trim().length;
+}, { name: "substring-replace" });
@@ -0,0 +1,35 @@
+// |bench| builtin/TypedObject
+
+// Copying structs and arrays of structs between typed object arrays.
+
+var sink = 0;
+
+var T = TypedObject;
+var Vec3 = new T.StructType({ x: T.float64, y: T.float64, z: T.float64 });
+var Particle = new T.StructType({ pos: Vec3, vel: Vec3, mass: T.float32 });
+var Particles = Particle.array(1000);
+
+var a = new Particles();
+var b = new Particles();
+for (var i = 0; i < 1000; i++) {
+    a[i].pos.x = i;
+    a[i].vel.y = i * 2;
+    a[i].mass = 1;
+}
+
+function copyElements() {
+    for (var i = 0; i < 1000; i++) {
+        b[i] = a[i];
+    }
+    return b[999].pos.x;
+}
+
+function copyFields() {
+    for (var i = 0; i < 1000; i++) {
+        b[i].vel = a[i].pos;
+    }
+    return b[999].vel.x;
+}
+
+benchmark(() => { sink += copyElements(); }, { name: "copy-struct-elements" });
+benchmark(() => { sink += copyFields(); }, { name: "copy-struct-fields" });
@@ -0,0 +1,73 @@
+#!/usr/bin/env python
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+# Compare two results files written by run_bench.py, from a baseline build and
+# a new build, and flag the benchmarks which got slower.
+#
+# A benchmark has regressed if its median got slower by more than the
+# threshold and the 95% confidence intervals of the two medians don't
+# overlap, so that noise in either run isn't reported as a change. Exits with
+# status 1 if any benchmark regressed.
+
+from __future__ import print_function
+
+import argparse
+import json
+import sys
+
+
+def load(path):
+    with open(path) as f:
+        data = json.load(f)
+    results = {}
+    for result in data['results']:
+        key = (result['file'], result.get('name', ''))
+        results[key] = result
+    return results
+
+
+def compare(old, new, threshold):
+    regressions = 0
+    for key in sorted(set(old) & set(new)):
+        before = old[key]['median']
+        after = new[key]['median']
+        ratio = after['value'] / before['value'] if before['value'] else 1.0
+
+        status = ''
+        if ratio > 1 + threshold and after['lower'] > before['upper']:
+            status = 'REGRESSION'
+            regressions += 1
+        elif ratio < 1 - threshold and after['upper'] < before['lower']:
+            status = 'improvement'
+
+        name = '%s %s' % (new[key]['subsystem'], key[1] or key[0])
+        print('%-60s %12.1f %12.1f %+7.1f%% %s' %
+              (name, before['value'], after['value'], (ratio - 1) * 100, status))
+
+    for key in sorted(set(old) - set(new)):
+        print('%-60s only in the baseline' % ' '.join(key))
+    for key in sorted(set(new) - set(old)):
+        print('%-60s only in the new results' % ' '.join(key))
+
+    return regressions
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Compare two micro-benchmark runs.')
+    parser.add_argument('baseline', help='results of the baseline build')
+    parser.add_argument('new', help='results of the new build')
+    parser.add_argument('-t', '--threshold', type=float, default=0.05,
+                        help='relative change of the median to report (default 0.05)')
+    args = parser.parse_args(argv)
+
+    regressions = compare(load(args.baseline), load(args.new), args.threshold)
+    if regressions:
+        print('%d benchmark(s) regressed' % regressions)
+        return 1
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
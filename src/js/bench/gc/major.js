@@ -0,0 +1,12 @@
+// |bench| gc/GC
+
+// Full non-incremental GCs of a heap with a fixed number of live objects.
+
+var heap = [];
+for (var i = 0; i < 100000; i++) {
+    heap.push({ index: i, next: heap[i - 1] || null });
+}
+
+benchmark(() => {
+    gc();
+}, { name: "full-gc", stableCalls: 10, iterations: 30, minSampleMicros: 0 });
@@ -0,0 +1,27 @@
+// |bench| gc/Nursery
+
+// Allocation of short-lived objects, arrays and strings, which are collected
+// by minor GCs, and of objects which survive them.
+
+var sink = 0;
+var survivors = [];
+
+benchmark(() => {
+    for (var i = 0; i < 1000; i++) {
+        var obj = { a: i, b: [i, i + 1], c: "s" + i };
+        sink += obj.b.length;
+    }
+}, { name: "short-lived" });
+
+benchmark(() => {
+    for (var i = 0; i < 100; i++) {
+        survivors.push({ value: i });
+    }
+    if (survivors.length > 100000) {
+        survivors = [];
+    }
+}, { name: "tenured" });
+
+benchmark(() => {
+    minorgc();
+}, { name: "minorgc-empty" });
@@ -0,0 +1,403 @@
+// GC stress and latency benchmark, for evaluating GC and nursery tuning
+// against heap shapes like those of real pages rather than synthetic loops.
+//
+// Usage:
+//
+//   js bench/gc/stress.js [key=value...]
+//
+// graph=tree|list|array|weakmap|realms|mixed   shape of the live heap (mixed)
+// size=N           number of objects in the live graph (100000)
+// rate=N           objects allocated per millisecond by the mutator (2000)
+// survival=F       fraction of the allocations which replace part of the live
+//                  graph rather than dying young (0.05)
+// duration=MS      length of each mutator phase (2000)
+// phases=N         number of mutator phases (3)
+// realms=N         number of realms for graph=realms (16)
+// gcparam.NAME=V   call gcparam(NAME, V) before building the graph
+// replay=PATH      instead, replay a trace written by a JS_GC_TRACE build
+//
+// The result is printed as JSON: the configuration, and for each phase the
+// allocations made, the distributions of major GC slice pauses and nursery
+// collection times in microseconds from gcHistograms(), and the profile of
+// the last nursery collection from nurseryProfile().
+
+"use strict";
+
+var mainGlobal = this;
+
+var config = {
+    graph: "mixed",
+    size: 100000,
+    rate: 2000,
+    survival: 0.05,
+    duration: 2000,
+    phases: 3,
+    realms: 16,
+    replay: null,
+    gcparams: {},
+};
+
+for (var arg of scriptArgs) {
+    var eq = arg.indexOf("=");
+    if (eq < 0) {
+        throw new Error("Arguments must be key=value: " + arg);
+    }
+    var key = arg.substring(0, eq);
+    var value = arg.substring(eq + 1);
+    if (key.startsWith("gcparam.")) {
+        config.gcparams[key.substring(8)] = Number(value);
+    } else if (!(key in config)) {
+        throw new Error("Unknown option: " + key);
+    } else if (typeof config[key] == "number") {
+        config[key] = Number(value);
+    } else {
+        config[key] = value;
+    }
+}
+
+// A deterministic generator, so that runs with the same configuration build
+// the same graphs and make the same mutations.
+var seed = 1;
+function random() {
+    seed = (seed * 1103515245 + 12345) & 0x7fffffff;
+    return seed / 0x80000000;
+}
+
+function randomIndex(n) {
+    return Math.floor(random() * n);
+}
+
+function newNode(i) {
+    return { id: i, left: null, right: null, payload: "n" + i };
+}
+
+// Each graph has a |replace| method, which makes a new object reachable in
+// place of an old one, and a |count| of the objects it holds.
+function buildTree(size) {
+    var nodes = [];
+    for (var i = 0; i < size; i++) {
+        var node = newNode(i);
+        if (i > 0) {
+            var parent = nodes[(i - 1) >> 1];
+            if (i & 1) {
+                parent.left = node;
+            } else {
+                parent.right = node;
+            }
+        }
+        nodes.push(node);
+    }
+    return {
+        count: size,
+        root: nodes[0],
+        replace(obj) {
+            // Walk down from the root, so that whole subtrees die.
+            var node = this.root;
+            while (node.left && node.right && random() < 0.9) {
+                node = random() < 0.5 ? node.left : node.right;
+            }
+            obj.left = node.left;
+            node.left = obj;
+            node.right = null;
+        },
+    };
+}
+
+function buildList(size) {
+    var head = null;
+    for (var i = 0; i < size; i++) {
+        var node = newNode(i);
+        node.right = head;
+        head = node;
+    }
+    return {
+        count: size,
+        head,
+        replace(obj) {
+            obj.right = this.head.right ? this.head.right.right : null;
+            this.head = obj;
+        },
+    };
+}
+
+function buildArray(size) {
+    var array = new Array(size);
+    for (var i = 0; i < size; i++) {
+        array[i] = newNode(i);
+    }
+    return {
+        count: size,
+        array,
+        replace(obj) {
+            this.array[randomIndex(this.array.length)] = obj;
+        },
+    };
+}
+
+function buildWeakMap(size) {
+    // Half the keys are held strongly, so sweeping the map has both live and
+    // dead entries to deal with.
+    var map = new WeakMap();
+    var keys = [];
+    for (var i = 0; i < size; i++) {
+        var key = newNode(i);
+        map.set(key, { value: i });
+        if (i & 1) {
+            keys.push(key);
+        }
+    }
+    return {
+        count: size,
+        map,
+        keys,
+        replace(obj) {
+            var index = randomIndex(this.keys.length);
+            this.map.set(obj, { value: obj.id });
+            this.keys[index] = obj;
+        },
+    };
+}
+
+// Realms sharing the main global's compartment, as same-origin iframes do.
+function buildRealms(size, count) {
+    var globals = [];
+    var graphs = [];
+    for (var i = 0; i < count; i++) {
+        var g = newGlobal({ sameCompartmentAs: mainGlobal });
+        g.evaluate(newNode.toString() + buildArray.toString() + random.toString() +
+                   randomIndex.toString() + "var seed = " + (i + 1) + ";");
+        globals.push(g);
+        graphs.push(g.buildArray(Math.ceil(size / count)));
+    }
+    return {
+        count: size,
+        globals,
+        graphs,
+        replace(obj) {
+            this.graphs[randomIndex(this.graphs.length)].replace(obj);
+        },
+    };
+}
+
+function buildMixed(size) {
+    var parts = [buildTree(size >> 2), buildList(size >> 2), buildArray(size >> 2),
+                 buildWeakMap(size >> 2)];
+    return {
+        count: size,
+        parts,
+        replace(obj) {
+            this.parts[randomIndex(this.parts.length)].replace(obj);
+        },
+    };
+}
+
+function buildGraph() {
+    switch (config.graph) {
+      case "tree": return buildTree(config.size);
+      case "list": return buildList(config.size);
+      case "array": return buildArray(config.size);
+      case "weakmap": return buildWeakMap(config.size);
+      case "realms": return buildRealms(config.size, config.realms);
+      case "mixed": return buildMixed(config.size);
+    }
+    throw new Error("Unknown graph: " + config.graph);
+}
+
+// Sum the difference of two histograms from gcHistograms(), and estimate
+// its quantiles. Like the engine's Histogram::quantile, each quantile is the
+// end of the bucket it falls in, so is an upper bound.
+function bucketEnd(start) {
+    if (start < 4) {
+        return start + 1;
+    }
+    return start + Math.pow(2, Math.floor(Math.log2(start)) - 2);
+}
+
+function histogramDelta(before, after) {
+    before = before || { count: 0, sum: 0, buckets: {} };
+    var buckets = [];
+    for (var start in after.buckets) {
+        var delta = after.buckets[start] - (before.buckets[start] || 0);
+        if (delta > 0) {
+            buckets.push([Number(start), delta]);
+        }
+    }
+    buckets.sort((a, b) => a[0] - b[0]);
+
+    var count = after.count - before.count;
+    function quantile(q) {
+        var target = Math.ceil(q * count);
+        var seen = 0;
+        for (var [start, n] of buckets) {
+            seen += n;
+            if (seen >= target) {
+                return bucketEnd(start);
+            }
+        }
+        return 0;
+    }
+
+    return {
+        count,
+        sum: after.sum - before.sum,
+        p50: quantile(0.5),
+        p90: quantile(0.9),
+        p99: quantile(0.99),
+        max: buckets.length ? bucketEnd(buckets[buckets.length - 1][0]) : 0,
+    };
+}
+
+function measurePhase(name, run) {
+    var before = JSON.parse(gcHistograms());
+    var start = performance.now();
+    var allocated = run();
+    var elapsed = performance.now() - start;
+    var after = JSON.parse(gcHistograms());
+
+    return {
+        name,
+        elapsed_ms: elapsed,
+        allocated,
+        slice_pause_us: histogramDelta(before.slice_pause_us, after.slice_pause_us),
+        minor_gc_us: histogramDelta(before.minor_gc_us, after.minor_gc_us),
+        minor_gc_tenured_bytes: histogramDelta(before.minor_gc_tenured_bytes,
+                                               after.minor_gc_tenured_bytes),
+        nursery: JSON.parse(nurseryProfile()),
+    };
+}
+
+// Allocate at config.rate objects per millisecond, in one millisecond ticks.
+// A tick which finishes early waits for the rest of its millisecond, so the
+// allocation rate doesn't depend on how fast the machine is, as long as it
+// keeps up.
+function mutate(graph) {
+    var allocated = 0;
+    var sink = null;
+    var end = performance.now() + config.duration;
+    var tick = performance.now();
+    while (tick < end) {
+        for (var i = 0; i < config.rate; i++) {
+            var obj = newNode(allocated++);
+            if (random() < config.survival) {
+                graph.replace(obj);
+            } else {
+                sink = obj;
+            }
+        }
+        tick += 1;
+        while (performance.now() < tick) {
+        }
+    }
+    return allocated;
+}
+
+// Replay the allocations and lifetimes recorded in a trace from gc/GCTrace.cpp.
+// Objects are allocated with the number of slots of their AllocKind and
+// strings for string kinds. They are kept alive while the trace says the cell
+// was: nursery cells until the next minor GC unless they were promoted, and
+// tenured cells until they were finalized. Other kinds of cells are internal
+// to the engine and are skipped.
+var TraceEvent = {
+    NurseryAlloc: 2,
+    TenuredAlloc: 3,
+    PromoteToTenured: 9,
+    MinorGCEnd: 10,
+    TenuredFinalize: 12,
+    DataString: 16,
+};
+var ObjectSlots = [0, 0, 0, 0, 2, 2, 4, 4, 8, 8, 12, 12, 16, 16];
+var FatInlineStringKind = 27;
+var StringKind = 28;
+
+function allocateKind(kind, n) {
+    if (kind < ObjectSlots.length) {
+        if (kind < 2) {
+            return function() { return n; };
+        }
+        var obj = {};
+        for (var i = 0; i < ObjectSlots[kind]; i++) {
+            obj["s" + i] = n;
+        }
+        return obj;
+    }
+    if (kind == FatInlineStringKind) {
+        return String(n).padStart(16, "f");
+    }
+    if (kind == StringKind) {
+        return "string " + n;
+    }
+    return undefined;
+}
+
+function replay(path) {
+    var bytes = os.file.readFile(path, "binary");
+    var view = new DataView(bytes.buffer, bytes.byteOffset, bytes.byteLength);
+    var words = Math.floor(bytes.byteLength / 8);
+
+    // Words are in the byte order of the machine which wrote the trace.
+    function event(i) {
+        return view.getUint8(i * 8 + 7, true);
+    }
+    function extra(i) {
+        return view.getUint8(i * 8 + 6, true);
+    }
+    function payload(i) {
+        return view.getUint16(i * 8 + 4, true) * 0x100000000 + view.getUint32(i * 8, true);
+    }
+
+    var nursery = new Map();
+    var tenured = new Map();
+    var allocated = 0;
+    for (var i = 0; i < words; i++) {
+        switch (event(i)) {
+          case TraceEvent.NurseryAlloc:
+          case TraceEvent.TenuredAlloc: {
+            var cell = allocateKind(extra(i), allocated);
+            if (cell !== undefined) {
+                allocated++;
+                (event(i) == TraceEvent.NurseryAlloc ? nursery : tenured).set(payload(i), cell);
+            }
+            break;
+          }
+          case TraceEvent.PromoteToTenured: {
+            // The new address follows as a data word.
+            var src = payload(i++);
+            if (nursery.has(src)) {
+                tenured.set(payload(i), nursery.get(src));
+            }
+            break;
+          }
+          case TraceEvent.MinorGCEnd:
+            nursery.clear();
+            break;
+          case TraceEvent.TenuredFinalize:
+            tenured.delete(payload(i));
+            break;
+          case TraceEvent.DataString:
+            // Skip the words holding the characters.
+            i += Math.ceil(payload(i) / 8);
+            break;
+        }
+    }
+    return allocated;
+}
+
+for (var name in config.gcparams) {
+    gcparam(name, config.gcparams[name]);
+}
+
+var result = { config, phases: [] };
+if (config.replay) {
+    result.phases.push(measurePhase("replay", () => replay(config.replay)));
+} else {
+    var graph;
+    result.phases.push(measurePhase("build", () => {
+        graph = buildGraph();
+        return graph.count;
+    }));
+    for (var i = 0; i < config.phases; i++) {
+        result.phases.push(measurePhase("mutate" + i, () => mutate(graph)));
+    }
+}
+
+print(JSON.stringify(result, null, 2));
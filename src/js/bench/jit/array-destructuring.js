@@ -0,0 +1,45 @@
+// |bench| jit/ArrayDestructuring
+
+// Array destructuring declarations of packed arrays, which read the elements
+// directly instead of going through an ArrayIterator.
+
+var sink = 0;
+
+function pairs(points) {
+    var sum = 0;
+    for (var i = 0; i < points.length; i++) {
+        let [x, y] = points[i];
+        sum += x * y;
+    }
+    return sum;
+}
+
+function swaps(n) {
+    var a = 1, b = 2;
+    for (var i = 0; i < n; i++) {
+        const [c, d] = [b, a];
+        a = c;
+        b = d;
+    }
+    return a + b;
+}
+
+function skip(rows) {
+    var sum = 0;
+    for (var i = 0; i < rows.length; i++) {
+        let [first, , third] = rows[i];
+        sum += first + third;
+    }
+    return sum;
+}
+
+var points = [];
+var rows = [];
+for (var i = 0; i < 1000; i++) {
+    points.push([i, i + 1]);
+    rows.push([i, i * 2, i * 3, i * 4]);
+}
+
+benchmark(() => { sink += pairs(points); }, { name: "pairs" });
+benchmark(() => { sink += swaps(1000); }, { name: "swap" });
+benchmark(() => { sink += skip(rows); }, { name: "elision-and-close" });
@@ -0,0 +1,20 @@
+// |bench| jit/Ion --ion-eager --ion-offthread-compile=off
+
+// Ion compilation time. Each call creates a function with a different source
+// text, so nothing is cached, and --ion-eager compiles it on its first call.
+// Every call links Ion code, so the warm-up never looks stable and is capped.
+
+var sink = 0;
+var counter = 0;
+
+var body = "";
+for (var i = 0; i < 20; i++) {
+    body += "var v" + i + " = a * " + i + " + b;\n" +
+            "if (v" + i + " > c) { c = v" + i + " % 7; } else { c += v" + i + "; }\n";
+}
+body += "return c;";
+
+benchmark(() => {
+    var f = new Function("a", "b", "c", "// " + counter++ + "\n" + body);
+    sink += f(1, 2, 3);
+}, { name: "compile-function", maxWarmup: 20, minSampleMicros: 0 });
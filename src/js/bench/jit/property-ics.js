@@ -0,0 +1,56 @@
+// |bench| jit/CacheIR
+
+// Property gets and sets through monomorphic, polymorphic and megamorphic
+// inline caches, and calls of getters.
+
+var sink = 0;
+
+function makeShapes(count) {
+    var objects = [];
+    for (var i = 0; i < count; i++) {
+        var obj = {};
+        obj["p" + i] = i;
+        obj.x = i;
+        obj.y = i * 2;
+        objects.push(obj);
+    }
+    return objects;
+}
+
+function getX(objects) {
+    var sum = 0;
+    for (var i = 0; i < 1000; i++) {
+        sum += objects[i % objects.length].x;
+    }
+    return sum;
+}
+
+var mono = makeShapes(1);
+var poly = makeShapes(4);
+var mega = makeShapes(64);
+
+benchmark(() => { sink += getX(mono); }, { name: "get-monomorphic" });
+benchmark(() => { sink += getX(poly); }, { name: "get-polymorphic" });
+benchmark(() => { sink += getX(mega); }, { name: "get-megamorphic" });
+
+var point = { x: 0, y: 0 };
+benchmark(() => {
+    for (var i = 0; i < 1000; i++) {
+        point.x = i;
+        point.y = point.x + 1;
+    }
+    sink += point.y;
+}, { name: "set-monomorphic" });
+
+class Box {
+    constructor(v) { this._v = v; }
+    get value() { return this._v; }
+}
+var box = new Box(3);
+benchmark(() => {
+    var sum = 0;
+    for (var i = 0; i < 1000; i++) {
+        sum += box.value;
+    }
+    sink += sum;
+}, { name: "getter" });
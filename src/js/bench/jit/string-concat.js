@@ -0,0 +1,45 @@
+// |bench| jit/StringConcat
+
+// Template literals and chains of string additions, which Ion merges into a
+// single concatenation of all their parts.
+
+var sink = 0;
+
+function render(items) {
+    var length = 0;
+    for (var i = 0; i < items.length; i++) {
+        var item = items[i];
+        var row = `<li class="${item.kind}" id="item-${item.id}">${item.name}</li>`;
+        length += row.length;
+    }
+    return length;
+}
+
+function join(items) {
+    var length = 0;
+    for (var i = 0; i < items.length; i++) {
+        var item = items[i];
+        var line = item.kind + ":" + item.id + ":" + item.name + "\n";
+        length += line.length;
+    }
+    return length;
+}
+
+function long(items) {
+    var length = 0;
+    for (var i = 0; i < items.length; i++) {
+        var item = items[i];
+        var text = `${item.text} / ${item.text} / ${item.text}`;
+        length += text.length;
+    }
+    return length;
+}
+
+var items = [];
+for (var i = 0; i < 1000; i++) {
+    items.push({ kind: "kind" + (i % 7), id: i, name: "name" + i, text: "x".repeat(500) });
+}
+
+benchmark(() => { sink += render(items); }, { name: "template-literal" });
+benchmark(() => { sink += join(items); }, { name: "add-chain" });
+benchmark(() => { sink += long(items); }, { name: "template-literal-rope" });
@@ -0,0 +1,51 @@
+// |bench| jit/TryFinally
+
+// Hot loops whose bodies release resources in finally blocks, which Ion
+// compiles along with the try block.
+
+var sink = 0;
+
+function Resource() {
+    this.open = 0;
+}
+Resource.prototype.acquire = function () { this.open++; };
+Resource.prototype.release = function () { this.open--; };
+
+function cleanup(resource, values) {
+    var sum = 0;
+    for (var i = 0; i < values.length; i++) {
+        resource.acquire();
+        try {
+            sum += values[i] * 2;
+        } finally {
+            resource.release();
+        }
+    }
+    return sum;
+}
+
+function rarelyThrows(values) {
+    var sum = 0;
+    for (var i = 0; i < values.length; i++) {
+        try {
+            if (values[i] % 1000 === 999) {
+                throw values[i];
+            }
+            sum += values[i];
+        } catch (e) {
+            sum -= e;
+        } finally {
+            sum++;
+        }
+    }
+    return sum;
+}
+
+var resource = new Resource();
+var values = [];
+for (var i = 0; i < 10000; i++) {
+    values.push(i);
+}
+
+benchmark(() => { sink += cleanup(resource, values); }, { name: "try-finally" });
+benchmark(() => { sink += rarelyThrows(values); }, { name: "try-catch-finally" });
@@ -0,0 +1,155 @@
+// A pool of evalInWorker threads sharing a job queue in a SharedArrayBuffer,
+// for benchmarks of work spread over several threads.
+//
+//   loadRelativeToScript("../lib/worker-pool.js");
+//   var pool = new WorkerPool(4, "function job(i) { ... }");
+//   var timing = pool.run(1000);
+//   pool.close();
+//
+// The source passed to the pool is evaluated once by each worker, in its own
+// runtime, and must define job(i). run(count) calls job(i) for each i below
+// count, on whichever worker claims it first, and waits for all of them. The
+// workers are started once and wait between batches, so a run doesn't pay for
+// creating threads and contexts.
+//
+// run() returns the elapsed time of the batch, and stats() the jobs each
+// worker ran and how long it was busy running them, over all the batches so
+// far. An exception in a job is reported by the worker and rethrown by run().
+
+"use strict";
+
+var WorkerPool = (function() {
+    // Slots of the Int32Array at the start of the buffer.
+    var GENERATION = 0;     // incremented to start a batch, or to quit
+    var NEXT = 1;           // index of the next job to be claimed
+    var COUNT = 2;          // number of jobs in the batch
+    var DONE = 3;           // workers which have finished the batch
+    var READY = 4;          // workers which have started
+    var QUIT = 5;
+    var ERROR = 6;
+    var HEADER_SLOTS = 8;
+
+    // Then two doubles per worker: busy milliseconds and jobs run.
+    var STATS_OFFSET = HEADER_SLOTS * Int32Array.BYTES_PER_ELEMENT;
+
+    var START_TIMEOUT_MS = 30000;
+
+    function workerSource(size, source) {
+        return `
+            var sab = getSharedObject();
+            var ctl = new Int32Array(sab, 0, ${HEADER_SLOTS});
+            var stats = new Float64Array(sab, ${STATS_OFFSET}, ${2 * size});
+            ${source}
+            var id = Atomics.add(ctl, ${READY}, 1);
+            Atomics.notify(ctl, ${READY});
+            var generation = 0;
+            for (;;) {
+                Atomics.wait(ctl, ${GENERATION}, generation);
+                generation = Atomics.load(ctl, ${GENERATION});
+                if (Atomics.load(ctl, ${QUIT})) {
+                    break;
+                }
+                var start = performance.now();
+                var jobs = 0;
+                var count = Atomics.load(ctl, ${COUNT});
+                for (;;) {
+                    var i = Atomics.add(ctl, ${NEXT}, 1);
+                    if (i >= count) {
+                        break;
+                    }
+                    try {
+                        job(i);
+                    } catch (e) {
+                        printErr("worker " + id + ": job " + i + ": " + e);
+                        Atomics.store(ctl, ${ERROR}, 1);
+                    }
+                    jobs++;
+                }
+                stats[2 * id] += performance.now() - start;
+                stats[2 * id + 1] += jobs;
+                Atomics.add(ctl, ${DONE}, 1);
+                Atomics.notify(ctl, ${DONE});
+            }
+        `;
+    }
+
+    function WorkerPool(size, source) {
+        if (!(size >= 1)) {
+            throw new Error("A worker pool needs at least one worker");
+        }
+
+        this.size = size;
+        this.sab = new SharedArrayBuffer(STATS_OFFSET + 2 * size * Float64Array.BYTES_PER_ELEMENT);
+        this.ctl = new Int32Array(this.sab, 0, HEADER_SLOTS);
+        this.stats_ = new Float64Array(this.sab, STATS_OFFSET, 2 * size);
+        this.closed = false;
+
+        // The mailbox holds one object, so wait for every worker to have
+        // taken the buffer before another pool can replace it.
+        setSharedObject(this.sab);
+        var code = workerSource(size, source);
+        for (var i = 0; i < size; i++) {
+            evalInWorker(code);
+        }
+        this.waitUntil(READY, size, START_TIMEOUT_MS);
+    }
+
+    WorkerPool.prototype = {
+        // Wait for ctl[slot] to reach |value|.
+        waitUntil(slot, value, timeout) {
+            var deadline = timeout === undefined ? Infinity : performance.now() + timeout;
+            var current;
+            while ((current = Atomics.load(this.ctl, slot)) < value) {
+                var remaining = deadline - performance.now();
+                if (remaining <= 0) {
+                    throw new Error("Worker pool timed out: " + current + " of " + value +
+                                    " workers started");
+                }
+                Atomics.wait(this.ctl, slot, current, Math.min(remaining, 1000));
+            }
+        },
+
+        wake() {
+            Atomics.add(this.ctl, GENERATION, 1);
+            Atomics.notify(this.ctl, GENERATION);
+        },
+
+        run(count) {
+            if (this.closed) {
+                throw new Error("Worker pool is closed");
+            }
+
+            Atomics.store(this.ctl, NEXT, 0);
+            Atomics.store(this.ctl, COUNT, count);
+            Atomics.store(this.ctl, DONE, 0);
+
+            var start = performance.now();
+            this.wake();
+            this.waitUntil(DONE, this.size);
+            var elapsed = performance.now() - start;
+
+            if (Atomics.exchange(this.ctl, ERROR, 0)) {
+                throw new Error("A worker pool job failed");
+            }
+            return { elapsed_ms: elapsed, jobs: count };
+        },
+
+        stats() {
+            var workers = [];
+            for (var i = 0; i < this.size; i++) {
+                workers.push({ busy_ms: this.stats_[2 * i], jobs: this.stats_[2 * i + 1] });
+            }
+            return workers;
+        },
+
+        close() {
+            if (!this.closed) {
+                this.closed = true;
+                Atomics.store(this.ctl, QUIT, 1);
+                this.wake();
+            }
+        },
+    };
+
+    return WorkerPool;
+})();
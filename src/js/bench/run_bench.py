@@ -0,0 +1,114 @@
+#!/usr/bin/env python
+# This Source Code Form is subject to the terms of the Mozilla Public
+# License, v. 2.0. If a copy of the MPL was not distributed with this
+# file, You can obtain one at http://mozilla.org/MPL/2.0/.
+
+# Run the micro-benchmarks in this directory with a JS shell and write their
+# results as JSON, for compare_bench.py.
+#
+# Each benchmark file starts with a line
+#
+#   // |bench| SUBSYSTEM [SHELL-FLAGS...]
+#
+# naming the part of the engine it covers, such as jit/CacheIR, and any shell
+# flags it needs. The file calls the shell's benchmark() builtin once for each
+# case, and the shell runs with --bench so that it prints every result. Files
+# without the header, like gc/stress.js, are run by hand, and those in lib/ are
+# loaded by the benchmarks.
+
+from __future__ import print_function
+
+import argparse
+import json
+import os
+import subprocess
+import sys
+
+BENCH_DIR = os.path.dirname(os.path.abspath(__file__))
+HEADER = '// |bench|'
+
+
+def read_header(path):
+    with open(path) as f:
+        line = f.readline()
+    if not line.startswith(HEADER):
+        return None
+    words = line[len(HEADER):].split()
+    if not words:
+        raise Exception('%s: missing subsystem in header' % path)
+    return words[0], words[1:]
+
+
+def find_benchmarks(filters):
+    paths = []
+    for dirpath, dirnames, filenames in os.walk(BENCH_DIR):
+        dirnames.sort()
+        for filename in sorted(filenames):
+            if not filename.endswith('.js'):
+                continue
+            path = os.path.join(dirpath, filename)
+            relpath = os.path.relpath(path, BENCH_DIR)
+            if filters and not any(f in relpath for f in filters):
+                continue
+            if read_header(path):
+                paths.append(path)
+    return paths
+
+
+def parse_results(output):
+    # The shell prints each result as a JSON object, one after another.
+    decoder = json.JSONDecoder()
+    results = []
+    pos = 0
+    while True:
+        start = output.find('{', pos)
+        if start < 0:
+            return results
+        result, pos = decoder.raw_decode(output, start)
+        results.append(result)
+
+
+def run_benchmark(shell, shell_args, path):
+    subsystem, flags = read_header(path)
+    command = [shell, '--bench'] + shell_args + flags + ['-f', path]
+    proc = subprocess.Popen(command, stdout=subprocess.PIPE, stderr=subprocess.PIPE,
+                            universal_newlines=True)
+    out, err = proc.communicate()
+    if proc.returncode != 0:
+        raise Exception('%s failed with exit code %d:\n%s' % (path, proc.returncode, err))
+
+    relpath = os.path.relpath(path, BENCH_DIR)
+    results = parse_results(out)
+    for result in results:
+        result['file'] = relpath
+        result['subsystem'] = subsystem
+        result['flags'] = flags
+    return results
+
+
+def main(argv):
+    parser = argparse.ArgumentParser(description='Run the engine micro-benchmarks.')
+    parser.add_argument('shell', help='path to the JS shell')
+    parser.add_argument('filters', nargs='*',
+                        help='only run the benchmark files whose path contains one of these')
+    parser.add_argument('-o', '--output', help='write the results to this file')
+    parser.add_argument('-a', '--shell-arg', action='append', default=[],
+                        help='extra argument to pass to the shell')
+    args = parser.parse_args(argv)
+
+    results = []
+    for path in find_benchmarks(args.filters):
+        for result in run_benchmark(args.shell, args.shell_arg, path):
+            print('%-20s %-40s median %12.1f ns (%s)' %
+                  (result['subsystem'], result.get('name', result['file']),
+                   result['median']['value'], result['tier']))
+            results.append(result)
+
+    if args.output:
+        with open(args.output, 'w') as f:
+            json.dump({'shell': args.shell, 'results': results}, f, indent=2, sort_keys=True)
+    return 0
+
+
+if __name__ == '__main__':
+    sys.exit(main(sys.argv[1:]))
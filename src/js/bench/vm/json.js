@@ -0,0 +1,21 @@
+// |bench| vm/JSONParser
+
+// JSON.parse and JSON.stringify of a document with nested objects, arrays
+// and strings.
+
+var sink = 0;
+
+var doc = { items: [] };
+for (var i = 0; i < 100; i++) {
+    doc.items.push({ id: i, name: "item" + i, tags: ["a", "b", "c"], price: i / 4,
+                     active: i % 2 == 0, nested: { depth: 1, value: null } });
+}
+var text = JSON.stringify(doc);
+
+benchmark(() => {
+    sink += JSON.parse(text).items.length;
+}, { name: "parse" });
+
+benchmark(() => {
+    sink += JSON.stringify(doc).length;
+}, { name: "stringify" });
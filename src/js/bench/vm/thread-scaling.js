@@ -0,0 +1,116 @@
+// |bench| vm/Threads
+
+// Throughput of the same work spread over 1 to N worker threads, for catching
+// contention regressions on many-core hosts. Each batch gives every thread
+// the same number of jobs, so with no contention the time per batch stays the
+// same as threads are added, and the throughput grows with them.
+//
+// Every worker has its own runtime, so its GC heap and atoms table are its
+// own; what the workers share is the process: the helper threads and their
+// lock, the GC chunk and malloc allocators, and the permanent atoms.
+//
+//   compute  arithmetic only, the baseline for perfect scaling
+//   alloc    short-lived objects and arrays, and the chunks their GCs need
+//   atoms    property names made from new strings, which are atomized
+//   compile  scripts compiled by offThreadCompileScript on helper threads
+//
+// N is helperThreadCount(), or threads=N when run by hand:
+//
+//   js bench/vm/thread-scaling.js [threads=N] [kernel=NAME]
+//
+// Besides the benchmark() results, a summary of the throughput and speedup
+// over one thread is printed for each kernel.
+
+loadRelativeToScript("../lib/worker-pool.js");
+
+var JOBS_PER_THREAD = 16;
+
+var kernels = {
+    compute: `
+        function job(i) {
+            var x = i;
+            for (var j = 0; j < 100000; j++) {
+                x = (x * 31 + j) & 0xffff;
+            }
+            return x;
+        }
+    `,
+    alloc: `
+        var sink;
+        function job(i) {
+            for (var j = 0; j < 5000; j++) {
+                sink = { a: i, b: [j, j + 1], c: null };
+            }
+        }
+    `,
+    atoms: `
+        var round = 0;
+        function job(i) {
+            var obj = {};
+            round++;
+            for (var j = 0; j < 2000; j++) {
+                obj["k" + round + "_" + j] = j;
+            }
+        }
+    `,
+    compile: `
+        var source = "";
+        for (var k = 0; k < 200; k++) {
+            source += "function f" + k + "(a, b) { return a + b * " + k + "; }\\n";
+        }
+        function job(i) {
+            offThreadCompileScript(source + "f" + (i % 200) + "(1, 2);");
+            runOffThreadScript();
+        }
+    `,
+};
+
+var maxThreads = Math.max(1, helperThreadCount());
+var only = null;
+for (var arg of scriptArgs) {
+    var [key, value] = arg.split("=");
+    if (key == "threads") {
+        maxThreads = Number(value);
+    } else if (key == "kernel") {
+        only = value;
+    } else {
+        throw new Error("Unknown option: " + arg);
+    }
+}
+
+var threadCounts = [];
+for (var t = 1; t < maxThreads; t *= 2) {
+    threadCounts.push(t);
+}
+threadCounts.push(maxThreads);
+
+for (var name in kernels) {
+    if (only && name != only) {
+        continue;
+    }
+
+    var baseline = 0;
+    for (var threads of threadCounts) {
+        var pool = new WorkerPool(threads, kernels[name]);
+        var jobs = JOBS_PER_THREAD * threads;
+
+        // Each call waits for every worker, so it's the main thread's wait
+        // that's timed, not its JIT tier.
+        var result = JSON.parse(benchmark(() => pool.run(jobs), {
+            name: name + "/" + threads,
+            maxWarmup: 5,
+            stableCalls: 2,
+            iterations: 10,
+            minSampleMicros: 0,
+        }));
+        pool.close();
+
+        var throughput = jobs / (result.median.value / 1e9);
+        if (threads == 1) {
+            baseline = throughput;
+        }
+        print(name + " threads=" + threads +
+              " jobs/s=" + throughput.toFixed(1) +
+              " speedup=" + (throughput / baseline).toFixed(2));
+    }
+}
@@ -0,0 +1,15 @@
+// |bench| wasm/WasmCompile
+
+// Synchronous compilation of a wasm module with many small functions.
+
+var funcs = "";
+for (var i = 0; i < 200; i++) {
+    funcs += "(func $f" + i + " (param i32) (result i32)" +
+             " (i32.add (i32.mul (get_local 0) (i32.const " + i + ")) (i32.const 1)))\n";
+}
+var bytes = wasmTextToBinary("(module " + funcs + ")");
+var sink = 0;
+
+benchmark(() => {
+    sink += WebAssembly.Module.exports(new WebAssembly.Module(bytes)).length;
+}, { name: "module-200-functions", stableCalls: 10, minSampleMicros: 0 });
@@ -9,10 +9,15 @@
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/CheckedInt.h"
 #include "mozilla/DebugOnly.h"
+#include "mozilla/FloatingPoint.h"
 #include "mozilla/MathAlgorithms.h"
 #include "mozilla/TextUtils.h"
 
 #include <algorithm>
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define JS_ARRAY_SSE2
+#  include <emmintrin.h>
+#endif
 
 #include "jsapi.h"
 #include "jsfriendapi.h"
@@ -2054,13 +2059,43 @@ enum ComparatorMatchResult {
 } // namespace
 
 
+/*
+ * Match the bytecode of |x| or |x.key| for the argument |x| of a comparator
+ * function, advancing *pcp past it. *keyp is set to the name of the property,
+ * or to nullptr if the argument is used directly.
+ */
+static bool
+MatchComparatorOperand(JSScript* script, jsbytecode** pcp, uint16_t* argp, PropertyName** keyp)
+{
+    jsbytecode* pc = *pcp;
+    if (JSOp(*pc) != JSOP_GETARG) {
+        return false;
+    }
+    *argp = GET_ARGNO(pc);
+    pc += JSOP_GETARG_LENGTH;
+
+    if (JSOp(*pc) == JSOP_GETPROP || JSOp(*pc) == JSOP_LENGTH) {
+        *keyp = script->getName(pc);
+        pc += JSOP_GETPROP_LENGTH;
+    } else {
+        *keyp = nullptr;
+    }
+
+    *pcp = pc;
+    return true;
+}
+
 /*
  * Specialize behavior for comparator functions with particular common bytecode
- * patterns: namely, |return x - y| and |return y - x|.
+ * patterns: namely, |return x - y| and |return y - x|, and the same with the
+ * same property of both arguments, |return x.key - y.key|. In the latter case
+ * the property name is returned in |key|, otherwise it is set to nullptr.
  */
 static ComparatorMatchResult
-MatchNumericComparator(JSContext* cx, JSObject* obj)
+MatchNumericComparator(JSContext* cx, JSObject* obj, MutableHandle<PropertyName*> key)
 {
+    key.set(nullptr);
+
     if (!obj->is<JSFunction>()) {
         return Match_None;
     }
@@ -2078,17 +2113,14 @@ MatchNumericComparator(JSContext* cx, JSObject* obj)
     jsbytecode* pc = script->code();
 
     uint16_t arg0, arg1;
-    if (JSOp(*pc) != JSOP_GETARG) {
-        return Match_None;
-    }
-    arg0 = GET_ARGNO(pc);
-    pc += JSOP_GETARG_LENGTH;
-
-    if (JSOp(*pc) != JSOP_GETARG) {
+    PropertyName* key0;
+    PropertyName* key1;
+    if (!MatchComparatorOperand(script, &pc, &arg0, &key0) ||
+        !MatchComparatorOperand(script, &pc, &arg1, &key1) ||
+        key0 != key1)
+    {
         return Match_None;
     }
-    arg1 = GET_ARGNO(pc);
-    pc += JSOP_GETARG_LENGTH;
 
     if (JSOp(*pc) != JSOP_SUB) {
         return Match_None;
@@ -2099,15 +2131,17 @@ MatchNumericComparator(JSContext* cx, JSObject* obj)
         return Match_None;
     }
 
+    ComparatorMatchResult result;
     if (arg0 == 0 && arg1 == 1) {
-        return Match_LeftMinusRight;
-    }
-
-    if (arg0 == 1 && arg1 == 0) {
-        return Match_RightMinusLeft;
+        result = Match_LeftMinusRight;
+    } else if (arg0 == 1 && arg1 == 0) {
+        result = Match_RightMinusLeft;
+    } else {
+        return Match_None;
     }
 
-    return Match_None;
+    key.set(key0);
+    return result;
 }
 
 template <typename K, typename C>
@@ -2298,8 +2332,9 @@ js::intrinsic_ArrayNativeSort(JSContext* cx, unsigned argc, Value* vp)
     MOZ_ASSERT(fval.isUndefined() || IsCallable(fval));
 
     ComparatorMatchResult comp;
+    RootedPropertyName key(cx);
     if (fval.isObject()) {
-        comp = MatchNumericComparator(cx, &fval.toObject());
+        comp = MatchNumericComparator(cx, &fval.toObject(), &key);
         if (comp == Match_Failure) {
             return false;
         }
@@ -2316,6 +2351,16 @@ js::intrinsic_ArrayNativeSort(JSContext* cx, unsigned argc, Value* vp)
 
     RootedObject obj(cx, &args.thisv().toObject());
 
+    // Comparators of properties of the elements are only handled here if
+    // neither reading the elements nor reading their properties can run user
+    // code, so that we can leave the sorting to the self-hosted code, without
+    // any observable difference, when an element or a property value turns
+    // out not to meet the conditions.
+    if (key && !IsPackedArray(obj)) {
+        args.rval().setBoolean(false);
+        return true;
+    }
+
     uint64_t length;
     if (!GetLengthProperty(cx, obj, &length)) {
         return false;
@@ -2365,10 +2410,16 @@ js::intrinsic_ArrayNativeSort(JSContext* cx, unsigned argc, Value* vp)
         bool allInts = true;
         bool extraIndexed;
         RootedValue v(cx);
+        Vector<NumericElement, 0, TempAllocPolicy> keyElements(cx);
         if (IsPackedArray(obj)) {
             HandleArrayObject array = obj.as<ArrayObject>();
             extraIndexed = false;
 
+            /* MergeSort uses the upper half as scratch space. */
+            if (key && !keyElements.reserve(2 * size_t(len))) {
+                return false;
+            }
+
             for (uint32_t i = 0; i < len; i++) {
                 if (!CheckForInterrupt(cx)) {
                     return false;
@@ -2380,6 +2431,18 @@ js::intrinsic_ArrayNativeSort(JSContext* cx, unsigned argc, Value* vp)
                     ++undefs;
                     continue;
                 }
+                if (key) {
+                    Value keyValue;
+                    if (!v.isObject() ||
+                        !GetPropertyPure(cx, &v.toObject(), NameToId(key), &keyValue) ||
+                        !keyValue.isNumber())
+                    {
+                        args.rval().setBoolean(false);
+                        return true;
+                    }
+                    keyElements.infallibleAppend(NumericElement { keyValue.toNumber(),
+                                                                  vec.length() });
+                }
                 vec.infallibleAppend(v);
                 allStrings = allStrings && v.isString();
                 allInts = allInts && v.isInt32();
@@ -2441,6 +2504,13 @@ js::intrinsic_ArrayNativeSort(JSContext* cx, unsigned argc, Value* vp)
                     return false;
                 }
             }
+        } else if (key) {
+            MOZ_ALWAYS_TRUE(keyElements.resize(n * 2));
+            if (!MergeSortByKey(keyElements.begin(), n, keyElements.begin() + n,
+                                SortComparatorNumerics[comp], &vec))
+            {
+                return false;
+            }
         } else {
             if (allInts) {
                 MOZ_ALWAYS_TRUE(vec.resize(n * 2));
@@ -2483,6 +2553,234 @@ js::intrinsic_ArrayNativeSort(JSContext* cx, unsigned argc, Value* vp)
     return true;
 }
 
+// Searching the dense elements of packed arrays for values which are
+// strictly equal when their boxed representations are, that is for anything
+// but strings and BigInts. Numbers have up to three representations: an int32,
+// an integral double and, for zero, negative zero.
+
+static const size_t MaxSearchPatterns = 3;
+
+// Fill |patterns| with the raw bits of the Values which are equal to
+// |searchElement|, and return how many there are.
+static size_t
+SearchPatterns(const Value& searchElement, uint64_t patterns[MaxSearchPatterns])
+{
+    MOZ_ASSERT(!searchElement.isString());
+
+    if (!searchElement.isNumber()) {
+        patterns[0] = searchElement.asRawBits();
+        return 1;
+    }
+
+    double d = searchElement.toNumber();
+    if (mozilla::IsNaN(d)) {
+        return 0;
+    }
+
+    int32_t i;
+    if (!mozilla::NumberEqualsInt32(d, &i)) {
+        patterns[0] = DoubleValue(d).asRawBits();
+        return 1;
+    }
+
+    patterns[0] = Int32Value(i).asRawBits();
+    patterns[1] = DoubleValue(double(i)).asRawBits();
+    if (i != 0) {
+        return 2;
+    }
+    patterns[2] = DoubleValue(-0.0).asRawBits();
+    return 3;
+}
+
+#ifdef JS_ARRAY_SSE2
+// Returns a two bit mask with the bits for the Values of |block| which are
+// equal to any of the patterns set.
+static inline uint32_t
+MatchValueLanes(const Value* block, const __m128i* needles, size_t count)
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    __m128i eq = _mm_setzero_si128();
+    for (size_t j = 0; j < count; j++) {
+        // SSE2 only compares 32-bit lanes, so a Value matches if both of its
+        // halves do.
+        __m128i halves = _mm_cmpeq_epi32(v, needles[j]);
+        eq = _mm_or_si128(eq, _mm_and_si128(halves,
+                                            _mm_shuffle_epi32(halves, _MM_SHUFFLE(2, 3, 0, 1))));
+    }
+    return uint32_t(_mm_movemask_pd(_mm_castsi128_pd(eq)));
+}
+#endif
+
+static inline bool
+MatchesAnyPattern(const Value& v, const uint64_t* patterns, size_t count)
+{
+    uint64_t bits = v.asRawBits();
+    for (size_t j = 0; j < count; j++) {
+        if (bits == patterns[j]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Returns the index of the first (or, for LastIndexOf, the last) element in
+// [start, end) which matches one of the patterns, or -1.
+template <ArraySearch Search>
+static int32_t
+FindValue(const Value* data, uint32_t start, uint32_t end, const uint64_t* patterns,
+          size_t count)
+{
+#ifdef JS_ARRAY_SSE2
+    __m128i needles[MaxSearchPatterns];
+    for (size_t j = 0; j < count; j++) {
+        uint64_t lanes[2] = { patterns[j], patterns[j] };
+        needles[j] = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+    }
+#endif
+
+    if (Search == ArraySearch::LastIndexOf) {
+        uint32_t i = end;
+#ifdef JS_ARRAY_SSE2
+        while (i - start >= 2) {
+            i -= 2;
+            if (uint32_t mask = MatchValueLanes(data + i, needles, count)) {
+                return int32_t(i + (mask >> 1));
+            }
+        }
+#endif
+        while (i > start) {
+            i--;
+            if (MatchesAnyPattern(data[i], patterns, count)) {
+                return int32_t(i);
+            }
+        }
+        return -1;
+    }
+
+    uint32_t i = start;
+#ifdef JS_ARRAY_SSE2
+    for (; end - i >= 2; i += 2) {
+        if (uint32_t mask = MatchValueLanes(data + i, needles, count)) {
+            return int32_t(i + ((mask & 1) ? 0 : 1));
+        }
+    }
+#endif
+    for (; i < end; i++) {
+        if (MatchesAnyPattern(data[i], patterns, count)) {
+            return int32_t(i);
+        }
+    }
+    return -1;
+}
+
+template <ArraySearch Search>
+static int32_t
+SearchDenseElements(ArrayObject* arr, const Value& searchElement, uint32_t start, uint32_t end)
+{
+    JS::AutoCheckCannotGC nogc;
+    MOZ_ASSERT(IsPackedArray(arr));
+
+    // The self-hosted code checked that the range is within the array's
+    // length, which is its initialized length since the array is packed.
+    MOZ_ASSERT(end <= arr->getDenseInitializedLength());
+    if (start >= end) {
+        return -1;
+    }
+
+    const Value* data = arr->getDenseElementsAllowCopyOnWrite();
+
+    uint64_t patterns[MaxSearchPatterns];
+    size_t count = SearchPatterns(searchElement, patterns);
+    if (count == 0) {
+        // Includes uses SameValueZero, for which NaN is equal to NaN.
+        if (Search != ArraySearch::Includes) {
+            return -1;
+        }
+        for (uint32_t i = start; i < end; i++) {
+            if (data[i].isDouble() && mozilla::IsNaN(data[i].toDouble())) {
+                return int32_t(i);
+            }
+        }
+        return -1;
+    }
+
+    return FindValue<Search>(data, start, end, patterns, count);
+}
+
+// These are called from the self-hosted Array.prototype.indexOf, lastIndexOf
+// and includes for packed arrays, with the range of elements to search, when
+// the search element is neither a string nor a BigInt. lastIndexOf searches
+// the range backwards.
+template <ArraySearch Search>
+static bool
+intrinsic_ArrayNativeSearch(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 4);
+
+    ArrayObject* arr = &args[0].toObject().as<ArrayObject>();
+    uint32_t start = uint32_t(args[2].toNumber());
+    uint32_t end = uint32_t(args[3].toNumber());
+    int32_t index = SearchDenseElements<Search>(arr, args[1], start, end);
+    if (Search == ArraySearch::Includes) {
+        args.rval().setBoolean(index >= 0);
+    } else {
+        args.rval().setInt32(index);
+    }
+    return true;
+}
+
+bool
+js::intrinsic_ArrayNativeIndexOf(JSContext* cx, unsigned argc, Value* vp)
+{
+    return intrinsic_ArrayNativeSearch<ArraySearch::IndexOf>(cx, argc, vp);
+}
+
+bool
+js::intrinsic_ArrayNativeLastIndexOf(JSContext* cx, unsigned argc, Value* vp)
+{
+    return intrinsic_ArrayNativeSearch<ArraySearch::LastIndexOf>(cx, argc, vp);
+}
+
+bool
+js::intrinsic_ArrayNativeIncludes(JSContext* cx, unsigned argc, Value* vp)
+{
+    return intrinsic_ArrayNativeSearch<ArraySearch::Includes>(cx, argc, vp);
+}
+
+template <ArraySearch Search>
+int32_t
+js::ArraySearchInt32(ArrayObject* arr, int32_t value, int32_t start, int32_t end)
+{
+    AutoUnsafeCallWithABI unsafe;
+    MOZ_ASSERT(start >= 0);
+    MOZ_ASSERT(end >= 0);
+    return SearchDenseElements<Search>(arr, Int32Value(value), uint32_t(start), uint32_t(end));
+}
+
+template <ArraySearch Search>
+int32_t
+js::ArraySearchObject(ArrayObject* arr, JSObject* value, int32_t start, int32_t end)
+{
+    AutoUnsafeCallWithABI unsafe;
+    MOZ_ASSERT(start >= 0);
+    MOZ_ASSERT(end >= 0);
+    return SearchDenseElements<Search>(arr, ObjectValue(*value), uint32_t(start), uint32_t(end));
+}
+
+template int32_t
+js::ArraySearchInt32<ArraySearch::IndexOf>(ArrayObject*, int32_t, int32_t, int32_t);
+template int32_t
+js::ArraySearchInt32<ArraySearch::LastIndexOf>(ArrayObject*, int32_t, int32_t, int32_t);
+template int32_t
+js::ArraySearchInt32<ArraySearch::Includes>(ArrayObject*, int32_t, int32_t, int32_t);
+template int32_t
+js::ArraySearchObject<ArraySearch::IndexOf>(ArrayObject*, JSObject*, int32_t, int32_t);
+template int32_t
+js::ArraySearchObject<ArraySearch::LastIndexOf>(ArrayObject*, JSObject*, int32_t, int32_t);
+template int32_t
+js::ArraySearchObject<ArraySearch::Includes>(ArrayObject*, JSObject*, int32_t, int32_t);
+
 bool
 js::NewbornArrayPush(JSContext* cx, HandleObject obj, const Value& v)
 {
@@ -2957,6 +3255,20 @@ CopyDenseArrayElements(JSContext* cx, HandleNativeObject obj, uint32_t begin, ui
 {
     size_t initlen = obj->getDenseInitializedLength();
     MOZ_ASSERT(initlen <= UINT32_MAX, "initialized length shouldn't exceed UINT32_MAX");
+
+    // A copy of all of an array whose elements are already copy on write can
+    // share them with the same owner, without copying anything until one of
+    // the arrays is written to.
+    if (begin == 0 &&
+        count == initlen &&
+        obj->is<ArrayObject>() &&
+        obj->denseElementsAreCopyOnWrite() &&
+        obj->as<ArrayObject>().length() == count)
+    {
+        RootedArrayObject owner(cx, &obj->getElementsHeader()->ownerObject()->as<ArrayObject>());
+        return NewDenseCopyOnWriteArray(cx, owner, gc::DefaultHeap);
+    }
+
     uint32_t newlength = 0;
     if (initlen > begin) {
         newlength = Min<uint32_t>(initlen - begin, count);
@@ -3369,6 +3681,43 @@ array_splice_noRetVal(JSContext* cx, unsigned argc, Value* vp)
     return array_splice_impl(cx, argc, vp, false);
 }
 
+// Called from the self-hosted Array.prototype.copyWithin with the converted
+// arguments. Moves the elements with memmove, when they are all in dense
+// storage and neither reading nor writing them can run user code, and
+// returns |false| to notify the self-hosted code to copy them otherwise.
+bool
+js::intrinsic_ArrayNativeCopyWithin(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 4);
+
+    RootedObject obj(cx, &args[0].toObject());
+    double to = args[1].toNumber();
+    double from = args[2].toNumber();
+    double count = args[3].toNumber();
+    MOZ_ASSERT(to >= 0 && from >= 0 && count > 0);
+
+    // Holes are moved like the elements are, which deletes the elements at
+    // their targets when there are no other indexed properties.
+    double end = Max(to, from) + count;
+    if (end > UINT32_MAX ||
+        !CanOptimizeForDenseStorage<ArrayAccess::Write>(obj, uint64_t(end), cx))
+    {
+        args.rval().setBoolean(false);
+        return true;
+    }
+
+    DenseElementResult result = MoveDenseElements(cx, &obj->as<NativeObject>(), uint32_t(to),
+                                                  uint32_t(from), uint32_t(count));
+    MOZ_ASSERT(result != DenseElementResult::Incomplete);
+    if (result == DenseElementResult::Failure) {
+        return false;
+    }
+
+    args.rval().setBoolean(true);
+    return true;
+}
+
 struct SortComparatorIndexes
 {
     bool operator()(uint32_t a, uint32_t b, bool* lessOrEqualp) {
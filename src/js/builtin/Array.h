@@ -135,6 +135,31 @@ GetElements(JSContext* cx, HandleObject aobj, uint32_t length, js::Value* vp);
 extern bool
 intrinsic_ArrayNativeSort(JSContext* cx, unsigned argc, js::Value* vp);
 
+extern bool
+intrinsic_ArrayNativeCopyWithin(JSContext* cx, unsigned argc, js::Value* vp);
+
+extern bool
+intrinsic_ArrayNativeIndexOf(JSContext* cx, unsigned argc, js::Value* vp);
+
+extern bool
+intrinsic_ArrayNativeLastIndexOf(JSContext* cx, unsigned argc, js::Value* vp);
+
+extern bool
+intrinsic_ArrayNativeIncludes(JSContext* cx, unsigned argc, js::Value* vp);
+
+enum class ArraySearch { IndexOf, LastIndexOf, Includes };
+
+// Versions of intrinsic_ArrayNativeIndexOf, intrinsic_ArrayNativeLastIndexOf
+// and intrinsic_ArrayNativeIncludes for int32 and object values, called from
+// Ion code. They return the index found or -1, also for Includes.
+template <ArraySearch Search>
+int32_t
+ArraySearchInt32(ArrayObject* arr, int32_t value, int32_t start, int32_t end);
+
+template <ArraySearch Search>
+int32_t
+ArraySearchObject(ArrayObject* arr, JSObject* value, int32_t start, int32_t end);
+
 extern bool
 array_push(JSContext* cx, unsigned argc, js::Value* vp);
 
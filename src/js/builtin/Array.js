@@ -2,6 +2,13 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+// Whether the dense elements of packed arrays can be searched natively for
+// |searchElement|. Strings and BigInts have to be compared by their contents.
+function CanSearchDenseElements(searchElement) {
+    var type = typeof searchElement;
+    return type !== "string" && type !== "bigint";
+}
+
  /* ES5 15.4.4.14. */
 function ArrayIndexOf(searchElement/*, fromIndex*/) {
     /* Step 1. */
@@ -35,6 +42,9 @@ function ArrayIndexOf(searchElement/*, fromIndex*/) {
     }
 
     /* Step 9. */
+    if (IsPackedArray(O) && len <= O.length && CanSearchDenseElements(searchElement))
+        return ArrayNativeIndexOf(O, searchElement, k, len);
+
     for (; k < len; k++) {
         if (k in O && O[k] === searchElement)
             return k;
@@ -76,6 +86,9 @@ function ArrayLastIndexOf(searchElement/*, fromIndex*/) {
         k = n;
 
     /* Step 8. */
+    if (k >= 0 && IsPackedArray(O) && k < O.length && CanSearchDenseElements(searchElement))
+        return ArrayNativeLastIndexOf(O, searchElement, 0, k + 1);
+
     for (; k >= 0; k--) {
         if (k in O && O[k] === searchElement)
             return k;
@@ -584,6 +597,9 @@ function ArrayCopyWithin(target, start, end = undefined) {
     /* Step 15. */
     var count = std_Math_min(final - from, len - to);
 
+    if (count > 0 && ArrayNativeCopyWithin(O, to, from, count))
+        return O;
+
     /* Steps 16-17. */
     if (from < to && to < (from + count)) {
         from = from + count - 1;
@@ -681,6 +697,9 @@ function ArrayIncludes(searchElement, fromIndex = 0) {
     }
 
     // Step 10.
+    if (IsPackedArray(O) && len <= O.length && CanSearchDenseElements(searchElement))
+        return ArrayNativeIncludes(O, searchElement, k, len);
+
     while (k < len) {
         // Steps a-c.
         if (SameValueZero(searchElement, O[k]))
@@ -50,6 +50,7 @@
 #include "mozilla/Atomics.h"
 #include "mozilla/CheckedInt.h"
 #include "mozilla/FloatingPoint.h"
+#include "mozilla/HashFunctions.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/ScopeExit.h"
 #include "mozilla/Unused.h"
@@ -544,51 +545,93 @@ namespace js {
 
 // Represents one waiting worker.
 //
-// The type is declared opaque in SharedArrayObject.h.  Instances of
-// js::FutexWaiter are stack-allocated and linked onto a list across a
-// call to FutexThread::wait().
+// Instances of js::FutexWaiter are stack-allocated and linked onto a list
+// across a call to FutexThread::wait().
 //
-// The 'waiters' field of the SharedArrayRawBuffer points to the highest
-// priority waiter in the list, and lower priority nodes are linked through
-// the 'lower_pri' field.  The 'back' field goes the other direction.
-// The list is circular, so the 'lower_pri' field of the lowest priority
-// node points to the first node in the list.  The list has no dedicated
-// header node.
+// The 'waiters' field of the FutexShard for the waited-on location points
+// to the highest priority waiter in the list, and lower priority nodes are
+// linked through the 'lower_pri' field.  The 'back' field goes the other
+// direction.  The list is circular, so the 'lower_pri' field of the lowest
+// priority node points to the first node in the list.  The list has no
+// dedicated header node.
 
 class FutexWaiter
 {
   public:
-    FutexWaiter(uint32_t offset, JSContext* cx)
-      : offset(offset),
+    FutexWaiter(SharedArrayRawBuffer* sarb, uint32_t offset, JSContext* cx)
+      : sarb(sarb),
+        offset(offset),
         cx(cx),
         lower_pri(nullptr),
         back(nullptr)
     {
     }
 
+    SharedArrayRawBuffer* sarb;         // The buffer containing the location
     uint32_t    offset;                 // int32 element index within the SharedArrayBuffer
     JSContext* cx;                      // The waiting thread
     FutexWaiter* lower_pri;             // Lower priority nodes in circular doubly-linked list of waiters
     FutexWaiter* back;                  // Other direction
 };
 
-class AutoLockFutexAPI
-{
-    // We have to wrap this in a Maybe because of the way loading
-    // mozilla::Atomic pointers works.
-    mozilla::Maybe<js::UniqueLock<js::Mutex>> unique_;
+// The waiters on all the locations which hash to one shard, and the lock
+// which protects them.  As in the Linux futex hash table, waits and
+// notifications on locations in different shards proceed in parallel.
 
+class FutexShard
+{
   public:
-    AutoLockFutexAPI() {
-        js::Mutex* lock = FutexThread::lock_;
-        unique_.emplace(*lock);
+    FutexShard()
+      : lock(mutexid::FutexThread),
+        waiters(nullptr),
+        numWaiters(0)
+    {
     }
 
-    ~AutoLockFutexAPI() {
-        unique_.reset();
+    js::Mutex lock;
+    FutexWaiter* waiters;
+
+    // The number of waiters in the list.  This is only updated with the
+    // lock held, but notifications read it without the lock to return
+    // early when nobody is waiting.
+    mozilla::Atomic<uint32_t, mozilla::SequentiallyConsistent,
+                    mozilla::recordreplay::Behavior::DontPreserve> numWaiters;
+};
+
+class FutexShardTable
+{
+    static const size_t NumShards = 64;
+
+    FutexShard shards_[NumShards];
+
+  public:
+    static FutexShard& shardFor(SharedArrayRawBuffer* sarb, uint32_t byteOffset) {
+        FutexShardTable* table = FutexThread::shards_;
+        return table->shards_[mozilla::HashGeneric(sarb, byteOffset) % NumShards];
     }
+};
 
-    js::UniqueLock<js::Mutex>& unique() { return *unique_; }
+class AutoLockFutexShard
+{
+    FutexShard& shard_;
+    js::UniqueLock<js::Mutex> unique_;
+
+  public:
+    explicit AutoLockFutexShard(FutexShard& shard)
+      : shard_(shard),
+        unique_(shard.lock)
+    {}
+
+    // Wait with the shard locked, recording the shard's lock so that the
+    // wait can be interrupted.
+    FutexThread::WaitResult wait(JSContext* cx,
+                                 const mozilla::Maybe<mozilla::TimeDuration>& timeout)
+    {
+        cx->fx.waitLock_ = &shard_.lock;
+        FutexThread::WaitResult retval = cx->fx.wait(cx, unique_, timeout);
+        cx->fx.waitLock_ = nullptr;
+        return retval;
+    }
 };
 
 } // namespace js
@@ -608,36 +651,44 @@ AtomicsWait(JSContext* cx, SharedArrayRawBuffer* sarb, uint32_t byteOffset, T va
 
     SharedMem<T*> addr = sarb->dataPointerShared().cast<T*>() + (byteOffset / sizeof(T));
 
-    // This lock also protects the "waiters" field on SharedArrayRawBuffer,
-    // and it provides the necessary memory fence.
-    AutoLockFutexAPI lock;
+    // The shard's lock protects its list of waiters.
+    FutexShard& shard = FutexShardTable::shardFor(sarb, byteOffset);
+    AutoLockFutexShard lock(shard);
+
+    // Count this thread as a waiter before reading the value, so that a
+    // notifier which stored a new value and then found no waiters without
+    // taking the lock is guaranteed to be seen here.
+    shard.numWaiters++;
+    jit::AtomicOperations::fenceSeqCst();
 
     if (jit::AtomicOperations::loadSafeWhenRacy(addr) != value) {
+        shard.numWaiters--;
         return FutexThread::WaitResult::NotEqual;
     }
 
-    FutexWaiter w(byteOffset, cx);
-    if (FutexWaiter* waiters = sarb->waiters()) {
+    FutexWaiter w(sarb, byteOffset, cx);
+    if (FutexWaiter* waiters = shard.waiters) {
         w.lower_pri = waiters;
         w.back = waiters->back;
         waiters->back->lower_pri = &w;
         waiters->back = &w;
     } else {
         w.lower_pri = w.back = &w;
-        sarb->setWaiters(&w);
+        shard.waiters = &w;
     }
 
-    FutexThread::WaitResult retval = cx->fx.wait(cx, lock.unique(), timeout);
+    FutexThread::WaitResult retval = lock.wait(cx, timeout);
 
     if (w.lower_pri == &w) {
-        sarb->setWaiters(nullptr);
+        shard.waiters = nullptr;
     } else {
         w.lower_pri->back = w.back;
         w.back->lower_pri = w.lower_pri;
-        if (sarb->waiters() == &w) {
-            sarb->setWaiters(w.lower_pri);
+        if (shard.waiters == &w) {
+            shard.waiters = w.lower_pri;
         }
     }
+    shard.numWaiters--;
 
     return retval;
 }
@@ -726,17 +777,29 @@ js::atomics_notify_impl(SharedArrayRawBuffer* sarb, uint32_t byteOffset, int64_t
     // Validation should ensure this does not happen.
     MOZ_ASSERT(sarb, "notify is only applicable to shared memory");
 
-    AutoLockFutexAPI lock;
+    if (!count) {
+        return 0;
+    }
+
+    // Pairs with the fence in AtomicsWait: either the waiter sees the value
+    // stored before this notification or this sees the waiter.
+    FutexShard& shard = FutexShardTable::shardFor(sarb, byteOffset);
+    jit::AtomicOperations::fenceSeqCst();
+    if (!shard.numWaiters) {
+        return 0;
+    }
+
+    AutoLockFutexShard lock(shard);
 
     int64_t woken = 0;
 
-    FutexWaiter* waiters = sarb->waiters();
-    if (waiters && count) {
+    FutexWaiter* waiters = shard.waiters;
+    if (waiters) {
         FutexWaiter* iter = waiters;
         do {
             FutexWaiter* c = iter;
             iter = iter->lower_pri;
-            if (c->offset != byteOffset || !c->cx->fx.isWaiting()) {
+            if (c->sarb != sarb || c->offset != byteOffset || !c->cx->fx.isWaiting()) {
                 continue;
             }
             c->cx->fx.notify(FutexThread::NotifyExplicit);
@@ -805,45 +868,28 @@ js::atomics_notify(JSContext* cx, unsigned argc, Value* vp)
 /* static */ bool
 js::FutexThread::initialize()
 {
-    MOZ_ASSERT(!lock_);
-    lock_ = js_new<js::Mutex>(mutexid::FutexThread);
-    return lock_ != nullptr;
+    MOZ_ASSERT(!shards_);
+    shards_ = js_new<FutexShardTable>();
+    return shards_ != nullptr;
 }
 
 /* static */ void
 js::FutexThread::destroy()
 {
-    if (lock_) {
-        js::Mutex* lock = lock_;
-        js_delete(lock);
-        lock_ = nullptr;
+    if (shards_) {
+        FutexShardTable* shards = shards_;
+        js_delete(shards);
+        shards_ = nullptr;
     }
 }
 
-/* static */ void
-js::FutexThread::lock()
-{
-    // Load the atomic pointer.
-    js::Mutex* lock = lock_;
-
-    lock->lock();
-}
-
-/* static */ mozilla::Atomic<js::Mutex*, mozilla::SequentiallyConsistent,
-                             mozilla::recordreplay::Behavior::DontPreserve> FutexThread::lock_;
-
-/* static */ void
-js::FutexThread::unlock()
-{
-    // Load the atomic pointer.
-    js::Mutex* lock = lock_;
-
-    lock->unlock();
-}
+/* static */ mozilla::Atomic<FutexShardTable*, mozilla::SequentiallyConsistent,
+                             mozilla::recordreplay::Behavior::DontPreserve> FutexThread::shards_;
 
 js::FutexThread::FutexThread()
   : cond_(nullptr),
     state_(Idle),
+    waitLock_(nullptr),
     canWait_(false)
 {
 }
@@ -851,7 +897,7 @@ js::FutexThread::FutexThread()
 bool
 js::FutexThread::initInstance()
 {
-    MOZ_ASSERT(lock_);
+    MOZ_ASSERT(shards_);
     cond_ = js_new<js::ConditionVariable>();
     return cond_ != nullptr;
 }
@@ -864,6 +910,22 @@ js::FutexThread::destroyInstance()
     }
 }
 
+void
+js::FutexThread::notifyIfWaitingForInterrupt()
+{
+    // The thread may move to another shard's lock, or stop waiting, until
+    // its current lock is held.
+    while (js::Mutex* lock = waitLock_) {
+        js::LockGuard<js::Mutex> guard(*lock);
+        if (waitLock_ == lock) {
+            if (isWaiting()) {
+                notify(NotifyForJSInterrupt);
+            }
+            return;
+        }
+    }
+}
+
 bool
 js::FutexThread::isWaiting()
 {
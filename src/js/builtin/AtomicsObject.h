@@ -42,17 +42,17 @@ MOZ_MUST_USE bool atomics_isLockFree(JSContext* cx, unsigned argc, Value* vp);
 MOZ_MUST_USE bool atomics_wait(JSContext* cx, unsigned argc, Value* vp);
 MOZ_MUST_USE bool atomics_notify(JSContext* cx, unsigned argc, Value* vp);
 
+class FutexShardTable;
+
 class FutexThread
 {
-    friend class AutoLockFutexAPI;
+    friend class AutoLockFutexShard;
+    friend class FutexShardTable;
 
 public:
     static MOZ_MUST_USE bool initialize();
     static void destroy();
 
-    static void lock();
-    static void unlock();
-
     FutexThread();
     MOZ_MUST_USE bool initInstance();
     void destroyInstance();
@@ -101,6 +101,12 @@ public:
     // of wait() must handle the interrupt.
     void notify(NotifyReason reason);
 
+    // Notify the thread with NotifyForJSInterrupt if it is waiting.
+    //
+    // This takes the lock of the shard the thread is waiting in, so the futex
+    // lock must not be held around this call.
+    void notifyIfWaitingForInterrupt();
+
     bool isWaiting();
 
     // If canWait() returns false (the default) then wait() is disabled
@@ -133,11 +139,16 @@ public:
     // is about to wake up.
     FutexState state_;
 
-    // Shared futex lock for all runtimes.  We can perhaps do better,
-    // but any lock will need to be per-domain (consider SharedWorker)
-    // or coarser.
-    static mozilla::Atomic<js::Mutex*, mozilla::SequentiallyConsistent,
-                           mozilla::recordreplay::Behavior::DontPreserve> lock_;
+    // The lock of the shard this runtime is waiting in, or nullptr when it
+    // is not in a wait.  The futex state is protected by this lock.
+    mozilla::Atomic<js::Mutex*, mozilla::SequentiallyConsistent,
+                    mozilla::recordreplay::Behavior::DontPreserve> waitLock_;
+
+    // Futex locks and waiter lists shared by all runtimes, indexed by a
+    // hash of the waited-on address so that waits and notifications on
+    // unrelated locations do not contend.
+    static mozilla::Atomic<FutexShardTable*, mozilla::SequentiallyConsistent,
+                           mozilla::recordreplay::Behavior::DontPreserve> shards_;
 
     // A flag that controls whether waiting is allowed.
     ThreadData<bool> canWait_;
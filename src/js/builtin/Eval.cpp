@@ -53,6 +53,15 @@ IsEvalCacheCandidate(JSScript* script)
            !script->hasObjects();
 }
 
+static bool
+IsCompilationCacheCandidate(JSScript* script)
+{
+    // As above, but indirect eval scripts always run in the realm's global.
+    return !script->isDirectEvalInFunction() &&
+           !script->hasSingletons() &&
+           !script->hasObjects();
+}
+
 /* static */ HashNumber
 EvalCacheHashPolicy::hash(const EvalCacheLookup& l)
 {
@@ -83,6 +92,9 @@ class EvalScriptGuard
     EvalCacheLookup lookup_;
     mozilla::Maybe<DependentAddPtr<EvalCache>> p_;
 
+    /* Set if the script was looked up in the compilation cache instead. */
+    mozilla::Maybe<CompilationCacheLookup> compilationLookup_;
+
     RootedLinearString lookupStr_;
 
   public:
@@ -99,6 +111,10 @@ class EvalScriptGuard
                 if (!p_->add(cx_, cx_->caches().evalCache, lookup_, cacheEntry)) {
                     cx_->recoverFromOutOfMemory();
                 }
+            } else if (compilationLookup_ && IsCompilationCacheCandidate(script_)) {
+                // The string may have been moved by a minor GC since the lookup.
+                compilationLookup_->str = lookupStr_;
+                cx_->caches().compilationCache.add(*compilationLookup_, script_, nullptr);
             }
         }
     }
@@ -117,6 +133,17 @@ class EvalScriptGuard
         }
     }
 
+    void lookupInCompilationCache(JSLinearString* str, const char* filename, bool mutedErrors)
+    {
+        lookupStr_ = str;
+        compilationLookup_.emplace(str, cx_->realm(), filename,
+                                   CompilationCacheKind::IndirectEval, mutedErrors);
+        if (JSScript* script = cx_->caches().compilationCache.takeScript(*compilationLookup_)) {
+            script_ = script;
+            script_->uncacheForEval();
+        }
+    }
+
     void setNewScript(JSScript* script) {
         // JSScript::initFromEmitter has already called js_CallNewScriptHook.
         MOZ_ASSERT(!script_ && script);
@@ -267,23 +294,28 @@ EvalKernel(JSContext* cx, HandleValue v, EvalType evalType, AbstractFramePtr cal
 
     EvalScriptGuard esg(cx);
 
-    if (evalType == DIRECT_EVAL && caller.isFunctionFrame()) {
-        esg.lookupInEvalCache(linearStr, callerScript, pc);
+    RootedScript maybeScript(cx);
+    unsigned lineno;
+    const char* filename;
+    bool mutedErrors;
+    uint32_t pcOffset;
+    if (evalType == DIRECT_EVAL) {
+        if (caller.isFunctionFrame()) {
+            esg.lookupInEvalCache(linearStr, callerScript, pc);
+        }
+    } else {
+        // Indirect evals of the same string share a script wherever they're
+        // called from, as long as the options it was compiled with match.
+        DescribeScriptedCallerForCompilation(cx, &maybeScript, &filename, &lineno, &pcOffset,
+                                             &mutedErrors);
+        esg.lookupInCompilationCache(linearStr, filename, mutedErrors);
     }
 
     if (!esg.foundScript()) {
-        RootedScript maybeScript(cx);
-        unsigned lineno;
-        const char* filename;
-        bool mutedErrors;
-        uint32_t pcOffset;
         if (evalType == DIRECT_EVAL) {
             DescribeScriptedCallerForDirectEval(cx, callerScript, pc, &filename, &lineno,
                                                 &pcOffset, &mutedErrors);
             maybeScript = callerScript;
-        } else {
-            DescribeScriptedCallerForCompilation(cx, &maybeScript, &filename, &lineno, &pcOffset,
-                                                 &mutedErrors);
         }
 
         const char* introducerFilename = filename;
@@ -21,6 +21,8 @@
 #include "builtin/String.h"
 #include "js/StableStringChars.h"
 #include "util/StringBuffer.h"
+#include "util/Text.h"
+#include "util/Unicode.h"
 #include "vm/Interpreter.h"
 #include "vm/JSAtom.h"
 #include "vm/JSContext.h"
@@ -31,6 +33,7 @@
 #include "builtin/Boolean-inl.h"
 #include "vm/JSAtom-inl.h"
 #include "vm/NativeObject-inl.h"
+#include "vm/ObjectOperations-inl.h"
 
 using namespace js;
 
@@ -45,6 +48,31 @@ const Class js::JSONClass = {
     JSCLASS_HAS_CACHED_PROTO(JSProto_JSON)
 };
 
+// Maps characters < 256 to the value that must follow the '\\' in the quoted string.
+// Entries with 'u' are handled as \\u00xy, and entries with 0 are not escaped in any way.
+// Characters >= 256 are all assumed to be unescaped.
+static const Latin1Char escapeLookup[256] = {
+    // clang-format off
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't',
+    'n', 'u', 'f', 'r', 'u', 'u', 'u', 'u', 'u', 'u',
+    'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
+    'u', 'u', 0,   0,  '\"', 0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
+    0,   0,  '\\', // rest are all zeros
+    // clang-format on
+};
+
+static inline char
+ToLowerHex(uint8_t u)
+{
+    MOZ_ASSERT(u <= 0xF);
+    return "0123456789abcdef"[u];
+}
+
 /* ES5 15.12.3 Quote.
  * Requires that the destination has enough space allocated for src after escaping
  * (that is, `2 + 6 * (srcEnd - srcBegin)` characters).
@@ -53,32 +81,9 @@ template <typename SrcCharT, typename DstCharT>
 static MOZ_ALWAYS_INLINE RangedPtr<DstCharT>
 InfallibleQuote(RangedPtr<const SrcCharT> srcBegin, RangedPtr<const SrcCharT> srcEnd, RangedPtr<DstCharT> dstPtr)
 {
-    // Maps characters < 256 to the value that must follow the '\\' in the quoted string.
-    // Entries with 'u' are handled as \\u00xy, and entries with 0 are not escaped in any way.
-    // Characters >= 256 are all assumed to be unescaped.
-    static const Latin1Char escapeLookup[256] = {
-        // clang-format off
-        'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'b', 't',
-        'n', 'u', 'f', 'r', 'u', 'u', 'u', 'u', 'u', 'u',
-        'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u', 'u',
-        'u', 'u', 0,   0,  '\"', 0,   0,   0,   0,   0,
-        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-        0,   0,   0,   0,   0,   0,   0,   0,   0,   0,
-        0,   0,  '\\', // rest are all zeros
-        // clang-format on
-    };
-
     /* Step 1. */
     *dstPtr++ = '"';
 
-    auto ToLowerHex = [](uint8_t u) {
-        MOZ_ASSERT(u <= 0xF);
-        return "0123456789abcdef"[u];
-    };
-
     /* Step 2. */
     while (srcBegin != srcEnd) {
         const SrcCharT c = *srcBegin++;
@@ -191,18 +196,222 @@ Quote(JSContext* cx, StringBuffer& sb, JSString* str)
 
 namespace {
 
+/*
+ * The output of StringifyToUTF8. The JSON text is encoded as it is written,
+ * rather than being built as a string which has to be transcoded afterwards.
+ */
+class UTF8Sink
+{
+    JSContext* cx;
+    mozilla::Vector<char>& out;
+
+    bool reportOutOfMemory() {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+  public:
+    UTF8Sink(JSContext* cx, mozilla::Vector<char>& out)
+      : cx(cx),
+        out(out)
+    {}
+
+    mozilla::Vector<char>& buffer() {
+        return out;
+    }
+
+    MOZ_MUST_USE bool growByUninitialized(size_t n) {
+        return out.growByUninitialized(n) || reportOutOfMemory();
+    }
+
+    MOZ_MUST_USE bool append(char c) {
+        return out.append(c) || reportOutOfMemory();
+    }
+
+    MOZ_MUST_USE bool append(const char* chars, size_t len) {
+        return out.append(chars, len) || reportOutOfMemory();
+    }
+
+    template <size_t ArrayLength>
+    MOZ_MUST_USE bool append(const char (&array)[ArrayLength]) {
+        return append(array, ArrayLength - 1);
+    }
+
+    /* Append |chars| without escaping them, replacing lone surrogates. */
+    template <typename CharT>
+    MOZ_MUST_USE bool appendEncoded(const CharT* chars, size_t len) {
+        for (size_t i = 0; i < len; i++) {
+            uint32_t c = chars[i];
+            if (unicode::IsLeadSurrogate(c) && i + 1 < len &&
+                unicode::IsTrailSurrogate(chars[i + 1]))
+            {
+                c = unicode::UTF16Decode(c, chars[++i]);
+            } else if (unicode::IsSurrogate(c)) {
+                c = unicode::REPLACEMENT_CHARACTER;
+            }
+
+            uint8_t utf8[4];
+            uint32_t utf8Length = OneUcs4ToUtf8Char(utf8, c);
+            if (!append(reinterpret_cast<const char*>(utf8), utf8Length)) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+} /* anonymous namespace */
+
+/*
+ * Quote for UTF-8 output: the same escapes as InfallibleQuote, with the other
+ * chars encoded. Requires space for `2 + 6 * (srcEnd - src)` bytes at |dst|.
+ */
+template <typename SrcCharT>
+static char*
+InfallibleQuoteUTF8(const SrcCharT* src, const SrcCharT* srcEnd, char* dst)
+{
+    *dst++ = '"';
+
+    while (src != srcEnd) {
+        char16_t c = *src++;
+
+        if (MOZ_LIKELY(c < 0x80)) {
+            Latin1Char escaped = escapeLookup[c];
+            if (escaped == 0) {
+                *dst++ = char(c);
+                continue;
+            }
+
+            *dst++ = '\\';
+            *dst++ = char(escaped);
+            if (escaped == 'u') {
+                *dst++ = '0';
+                *dst++ = '0';
+                *dst++ = char('0' + (c >> 4));
+                *dst++ = ToLowerHex(c & 0xF);
+            }
+            continue;
+        }
+
+        if (c < 0x800) {
+            *dst++ = char(0xC0 | (c >> 6));
+            *dst++ = char(0x80 | (c & 0x3F));
+            continue;
+        }
+
+        if (!unicode::IsSurrogate(c)) {
+            *dst++ = char(0xE0 | (c >> 12));
+            *dst++ = char(0x80 | ((c >> 6) & 0x3F));
+            *dst++ = char(0x80 | (c & 0x3F));
+            continue;
+        }
+
+        if (MOZ_LIKELY(unicode::IsLeadSurrogate(c) &&
+                       src != srcEnd &&
+                       unicode::IsTrailSurrogate(*src)))
+        {
+            uint32_t codePoint = unicode::UTF16Decode(c, *src++);
+            dst += OneUcs4ToUtf8Char(reinterpret_cast<uint8_t*>(dst), codePoint);
+            continue;
+        }
+
+        // Lone surrogates are Unicode-escaped, as they can't be encoded.
+        *dst++ = '\\';
+        *dst++ = 'u';
+        *dst++ = ToLowerHex(c >> 12);
+        *dst++ = ToLowerHex((c >> 8) & 0xF);
+        *dst++ = ToLowerHex((c >> 4) & 0xF);
+        *dst++ = ToLowerHex(c & 0xF);
+    }
+
+    *dst++ = '"';
+    return dst;
+}
+
+static bool
+Quote(JSContext* cx, UTF8Sink& sink, JSString* str)
+{
+    JSLinearString* linear = str->ensureLinear(cx);
+    if (!linear) {
+        return false;
+    }
+
+    // As for StringBuffers, grow the buffer to the most that could be
+    // needed and shrink it back afterwards.
+    mozilla::Vector<char>& out = sink.buffer();
+    size_t len = linear->length();
+    size_t initialLength = out.length();
+    if (!sink.growByUninitialized(len * 6 + 2)) {
+        return false;
+    }
+
+    JS::AutoCheckCannotGC nogc;
+    char* dst = out.begin() + initialLength;
+    char* dstEnd;
+    if (linear->hasLatin1Chars()) {
+        const Latin1Char* chars = linear->latin1Chars(nogc);
+        dstEnd = InfallibleQuoteUTF8(chars, chars + len, dst);
+    } else {
+        const char16_t* chars = linear->twoByteChars(nogc);
+        dstEnd = InfallibleQuoteUTF8(chars, chars + len, dst);
+    }
+    out.shrinkTo(dstEnd - out.begin());
+    return true;
+}
+
+static bool
+AppendGap(StringBuffer& sb, const StringBuffer& gap)
+{
+    if (gap.isUnderlyingBufferLatin1()) {
+        return sb.append(gap.rawLatin1Begin(), gap.rawLatin1End());
+    }
+    return sb.append(gap.rawTwoByteBegin(), gap.rawTwoByteEnd());
+}
+
+static bool
+AppendGap(UTF8Sink& sink, const StringBuffer& gap)
+{
+    if (gap.isUnderlyingBufferLatin1()) {
+        return sink.appendEncoded(gap.rawLatin1Begin(), gap.length());
+    }
+    return sink.appendEncoded(gap.rawTwoByteBegin(), gap.length());
+}
+
+static bool
+AppendNumber(JSContext* cx, const Value& v, StringBuffer& sb)
+{
+    return NumberValueToStringBuffer(cx, v, sb);
+}
+
+static bool
+AppendNumber(JSContext* cx, const Value& v, UTF8Sink& sink)
+{
+    ToCStringBuf cbuf;
+    const char* cstr = NumberToCString(cx, &cbuf, v.toNumber());
+    if (!cstr) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+    return sink.append(cstr, strlen(cstr));
+}
+
+namespace {
+
 using ObjectVector = GCVector<JSObject*, 8>;
+using ShapeSet = GCHashSet<Shape*, MovableCellHasher<Shape*>, SystemAllocPolicy>;
 
+template <typename Sink>
 class StringifyContext
 {
   public:
-    StringifyContext(JSContext* cx, StringBuffer& sb, const StringBuffer& gap,
+    StringifyContext(JSContext* cx, Sink& sb, const StringBuffer& gap,
                      HandleObject replacer, const AutoIdVector& propertyList,
                      bool maybeSafely)
       : sb(sb),
         gap(gap),
         replacer(cx, replacer),
         stack(cx, ObjectVector(cx)),
+        noToJSONShapes(cx, ShapeSet()),
         propertyList(propertyList),
         depth(0),
         maybeSafely(maybeSafely)
@@ -211,10 +420,15 @@ class StringifyContext
         MOZ_ASSERT_IF(maybeSafely, gap.empty());
     }
 
-    StringBuffer& sb;
+    Sink& sb;
     const StringBuffer& gap;
     RootedObject replacer;
     Rooted<ObjectVector> stack;
+
+    // Shapes of native objects which have no toJSON property and don't
+    // resolve one. Dictionary shapes can change in place, so aren't included.
+    Rooted<ShapeSet> noToJSONShapes;
+
     const AutoIdVector& propertyList;
     uint32_t depth;
     bool maybeSafely;
@@ -222,27 +436,21 @@ class StringifyContext
 
 } /* anonymous namespace */
 
-static bool Str(JSContext* cx, const Value& v, StringifyContext* scx);
+template <typename Sink>
+static bool Str(JSContext* cx, const Value& v, StringifyContext<Sink>* scx);
 
+template <typename Sink>
 static bool
-WriteIndent(StringifyContext* scx, uint32_t limit)
+WriteIndent(StringifyContext<Sink>* scx, uint32_t limit)
 {
     if (!scx->gap.empty()) {
         if (!scx->sb.append('\n')) {
             return false;
         }
 
-        if (scx->gap.isUnderlyingBufferLatin1()) {
-            for (uint32_t i = 0; i < limit; i++) {
-                if (!scx->sb.append(scx->gap.rawLatin1Begin(), scx->gap.rawLatin1End())) {
-                    return false;
-                }
-            }
-        } else {
-            for (uint32_t i = 0; i < limit; i++) {
-                if (!scx->sb.append(scx->gap.rawTwoByteBegin(), scx->gap.rawTwoByteEnd())) {
-                    return false;
-                }
+        for (uint32_t i = 0; i < limit; i++) {
+            if (!AppendGap(scx->sb, scx->gap)) {
+                return false;
             }
         }
     }
@@ -250,6 +458,41 @@ WriteIndent(StringifyContext* scx, uint32_t limit)
     return true;
 }
 
+/*
+ * Whether |obj| is known to have neither an own nor an inherited toJSON
+ * property, without running any code to find out. This avoids a full
+ * property lookup for each of the objects being stringified, which almost
+ * never have one.
+ */
+template <typename Sink>
+static bool
+KnownToHaveNoToJSON(JSContext* cx, StringifyContext<Sink>* scx, JSObject* obj)
+{
+    jsid id = NameToId(cx->names().toJSON);
+    do {
+        if (!obj->isNative() || obj->hasDynamicPrototype()) {
+            return false;
+        }
+
+        NativeObject* nobj = &obj->as<NativeObject>();
+        Shape* shape = nobj->lastProperty();
+        if (shape->inDictionary() || !scx->noToJSONShapes.has(shape)) {
+            if (nobj->lookupPure(id) || ClassMayResolveId(cx->names(), nobj->getClass(), id, nobj)) {
+                return false;
+            }
+
+            // Ignore OOM, the set is only a cache.
+            if (!shape->inDictionary()) {
+                (void) scx->noToJSONShapes.put(shape);
+            }
+        }
+
+        obj = nobj->staticPrototype();
+    } while (obj);
+
+    return true;
+}
+
 namespace {
 
 template<typename KeyType>
@@ -278,9 +521,10 @@ class KeyStringifier<HandleId> {
  * ES5 15.12.3 Str, steps 2-4, extracted to enable preprocessing of property
  * values when stringifying objects in JO.
  */
-template<typename KeyType>
+template<typename KeyType, typename Sink>
 static bool
-PreprocessValue(JSContext* cx, HandleObject holder, KeyType key, MutableHandleValue vp, StringifyContext* scx)
+PreprocessValue(JSContext* cx, HandleObject holder, KeyType key, MutableHandleValue vp,
+                StringifyContext<Sink>* scx)
 {
     // We don't want to do any preprocessing here if scx->maybeSafely,
     // since the stuff we do here can have side-effects.
@@ -291,7 +535,7 @@ PreprocessValue(JSContext* cx, HandleObject holder, KeyType key, MutableHandleVa
     RootedString keyStr(cx);
 
     /* Step 2. */
-    if (vp.isObject()) {
+    if (vp.isObject() && !KnownToHaveNoToJSON(cx, scx, &vp.toObject())) {
         RootedValue toJSON(cx);
         RootedObject obj(cx, &vp.toObject());
         if (!GetProperty(cx, obj, obj, cx->names().toJSON, &toJSON)) {
@@ -383,7 +627,8 @@ IsFilteredValue(const Value& v)
 class CycleDetector
 {
   public:
-    CycleDetector(StringifyContext* scx, HandleObject obj)
+    template <typename Sink>
+    CycleDetector(StringifyContext<Sink>* scx, HandleObject obj)
       : stack_(&scx->stack), obj_(obj), appended_(false) {
     }
 
@@ -412,9 +657,64 @@ class CycleDetector
     bool appended_;
 };
 
+using SlotVector = Vector<uint32_t, 8>;
+
+/*
+ * Get the keys of the enumerable own properties of a plain object by walking
+ * its shape list, when it has no elements and only data properties, so their
+ * values can be read from |slots| for as long as the object keeps its shape.
+ * Otherwise leave |*optimized| false, for the generic path to be used.
+ */
+static bool
+GetPlainObjectKeys(JSContext* cx, HandleObject obj, AutoIdVector& ids, SlotVector& slots,
+                   bool* optimized)
+{
+    *optimized = false;
+
+    if (!obj->is<PlainObject>()) {
+        return true;
+    }
+
+    PlainObject* nobj = &obj->as<PlainObject>();
+    if (nobj->inDictionaryMode() || nobj->isIndexed() || nobj->getDenseInitializedLength()) {
+        return true;
+    }
+
+    size_t count = 0;
+    for (Shape::Range<NoGC> r(nobj->lastProperty()); !r.empty(); r.popFront()) {
+        Shape& shape = r.front();
+        if (!shape.isDataProperty()) {
+            return true;
+        }
+        if (shape.enumerable() && !JSID_IS_SYMBOL(shape.propid())) {
+            count++;
+        }
+    }
+
+    if (!ids.growBy(count) || !slots.growBy(count)) {
+        return false;
+    }
+
+    // The shape list starts with the most recently added property.
+    size_t i = count;
+    for (Shape::Range<NoGC> r(nobj->lastProperty()); !r.empty(); r.popFront()) {
+        Shape& shape = r.front();
+        if (shape.enumerable() && !JSID_IS_SYMBOL(shape.propid())) {
+            i--;
+            ids[i].set(shape.propid());
+            slots[i] = shape.slot();
+        }
+    }
+    MOZ_ASSERT(i == 0);
+
+    *optimized = true;
+    return true;
+}
+
 /* ES5 15.12.3 JO. */
+template <typename Sink>
 static bool
-JO(JSContext* cx, HandleObject obj, StringifyContext* scx)
+JO(JSContext* cx, HandleObject obj, StringifyContext<Sink>* scx)
 {
     /*
      * This method implements the JO algorithm in ES5 15.12.3, but:
@@ -441,6 +741,8 @@ JO(JSContext* cx, HandleObject obj, StringifyContext* scx)
     /* Steps 5-7. */
     Maybe<AutoIdVector> ids;
     const AutoIdVector* props;
+    SlotVector slots(cx);
+    RootedShape plainShape(cx);
     if (scx->replacer && !scx->replacer->isCallable()) {
         // NOTE: We can't assert |IsArray(scx->replacer)| because the replacer
         //       might have been a revocable proxy to an array.  Such a proxy
@@ -451,7 +753,13 @@ JO(JSContext* cx, HandleObject obj, StringifyContext* scx)
     } else {
         MOZ_ASSERT_IF(scx->replacer, scx->propertyList.length() == 0);
         ids.emplace(cx);
-        if (!GetPropertyKeys(cx, obj, JSITER_OWNONLY, ids.ptr())) {
+        bool optimized;
+        if (!GetPlainObjectKeys(cx, obj, *ids, slots, &optimized)) {
+            return false;
+        }
+        if (optimized) {
+            plainShape = obj->as<PlainObject>().lastProperty();
+        } else if (!GetPropertyKeys(cx, obj, JSITER_OWNONLY, ids.ptr())) {
             return false;
         }
         props = ids.ptr();
@@ -485,7 +793,9 @@ JO(JSContext* cx, HandleObject obj, StringifyContext* scx)
             MOZ_ASSERT(prop && prop.isNativeProperty() && prop.shape()->isDataDescriptor());
         }
 #endif // DEBUG
-        if (!GetProperty(cx, obj, obj, id, &outputValue)) {
+        if (plainShape && obj->as<PlainObject>().lastProperty() == plainShape) {
+            outputValue = obj->as<PlainObject>().getSlot(slots[i]);
+        } else if (!GetProperty(cx, obj, obj, id, &outputValue)) {
             return false;
         }
         if (!PreprocessValue(cx, obj, HandleId(id), &outputValue, scx)) {
@@ -527,8 +837,9 @@ JO(JSContext* cx, HandleObject obj, StringifyContext* scx)
 }
 
 /* ES5 15.12.3 JA. */
+template <typename Sink>
 static bool
-JA(JSContext* cx, HandleObject obj, StringifyContext* scx)
+JA(JSContext* cx, HandleObject obj, StringifyContext<Sink>* scx)
 {
     /*
      * This method implements the JA algorithm in ES5 15.12.3, but:
@@ -597,7 +908,14 @@ JA(JSContext* cx, HandleObject obj, StringifyContext* scx)
                 }
             }
 #endif
-            if (!GetElement(cx, obj, i, &outputValue)) {
+            // The elements of dense arrays are read directly, for as long as
+            // they remain dense.
+            if (obj->is<ArrayObject>() &&
+                i < obj->as<ArrayObject>().getDenseInitializedLength() &&
+                !obj->as<ArrayObject>().getDenseElement(i).isMagic(JS_ELEMENTS_HOLE))
+            {
+                outputValue = obj->as<ArrayObject>().getDenseElement(i);
+            } else if (!GetElement(cx, obj, i, &outputValue)) {
                 return false;
             }
             if (!PreprocessValue(cx, obj, i, &outputValue, scx)) {
@@ -633,8 +951,9 @@ JA(JSContext* cx, HandleObject obj, StringifyContext* scx)
     return scx->sb.append(']');
 }
 
+template <typename Sink>
 static bool
-Str(JSContext* cx, const Value& v, StringifyContext* scx)
+Str(JSContext* cx, const Value& v, StringifyContext<Sink>* scx)
 {
     /* Step 11 must be handled by the caller. */
     MOZ_ASSERT(!IsFilteredValue(v));
@@ -682,7 +1001,7 @@ Str(JSContext* cx, const Value& v, StringifyContext* scx)
             }
         }
 
-        return NumberValueToStringBuffer(cx, v, scx->sb);
+        return AppendNumber(cx, v, scx->sb);
     }
 
 #ifdef ENABLE_BIGINT
@@ -713,9 +1032,10 @@ Str(JSContext* cx, const Value& v, StringifyContext* scx)
 }
 
 /* ES6 24.3.2. */
-bool
-js::Stringify(JSContext* cx, MutableHandleValue vp, JSObject* replacer_, const Value& space_,
-              StringBuffer& sb, StringifyBehavior stringifyBehavior)
+template <typename Sink>
+static bool
+StringifyImpl(JSContext* cx, MutableHandleValue vp, JSObject* replacer_, const Value& space_,
+              Sink& sb, StringifyBehavior stringifyBehavior)
 {
     RootedObject replacer(cx, replacer_);
     RootedValue space(cx, space_);
@@ -868,8 +1188,8 @@ js::Stringify(JSContext* cx, MutableHandleValue vp, JSObject* replacer_, const V
     }
 
     /* Step 12. */
-    StringifyContext scx(cx, sb, gap, replacer, propertyList,
-                         stringifyBehavior == StringifyBehavior::RestrictedSafe);
+    StringifyContext<Sink> scx(cx, sb, gap, replacer, propertyList,
+                               stringifyBehavior == StringifyBehavior::RestrictedSafe);
     if (!PreprocessValue(cx, wrapper, HandleId(emptyId), vp, &scx)) {
         return false;
     }
@@ -880,6 +1200,21 @@ js::Stringify(JSContext* cx, MutableHandleValue vp, JSObject* replacer_, const V
     return Str(cx, vp, &scx);
 }
 
+bool
+js::Stringify(JSContext* cx, MutableHandleValue vp, JSObject* replacer, const Value& space,
+              StringBuffer& sb, StringifyBehavior stringifyBehavior)
+{
+    return StringifyImpl(cx, vp, replacer, space, sb, stringifyBehavior);
+}
+
+bool
+js::StringifyToUTF8(JSContext* cx, MutableHandleValue vp, JSObject* replacer, const Value& space,
+                    mozilla::Vector<char>& out)
+{
+    UTF8Sink sink(cx, out);
+    return StringifyImpl(cx, vp, replacer, space, sink, StringifyBehavior::Normal);
+}
+
 /* ES5 15.12.2 Walk. */
 static bool
 Walk(JSContext* cx, HandleObject holder, HandleId name, HandleValue reviver, MutableHandleValue vp)
@@ -8,6 +8,7 @@
 #define builtin_JSON_h
 
 #include "mozilla/Range.h"
+#include "mozilla/Vector.h"
 
 #include "NamespaceImports.h"
 
@@ -38,6 +39,14 @@ extern bool
 Stringify(JSContext* cx, js::MutableHandleValue vp, JSObject* replacer,
           const Value& space, StringBuffer& sb, StringifyBehavior stringifyBehavior);
 
+/**
+ * Like Stringify with StringifyBehavior::Normal, but appending the JSON text
+ * to |out| as UTF-8 rather than building it in a StringBuffer.
+ */
+extern bool
+StringifyToUTF8(JSContext* cx, js::MutableHandleValue vp, JSObject* replacer,
+                const Value& space, mozilla::Vector<char>& out);
+
 template <typename CharT>
 extern bool
 ParseJSONWithReviver(JSContext* cx, const mozilla::Range<const CharT> chars,
@@ -8,7 +8,11 @@
 
 #include "ds/OrderedHashTable.h"
 #include "gc/FreeOp.h"
+#include "jit/InlinableNatives.h"
 #include "js/Utility.h"
+#ifdef ENABLE_BIGINT
+#include "vm/BigIntType.h"
+#endif
 #include "vm/GlobalObject.h"
 #include "vm/Interpreter.h"
 #include "vm/Iteration.h"
@@ -41,6 +45,39 @@ HashableValue::setValue(JSContext* cx, HandleValue v)
             return false;
         }
         value = StringValue(str);
+        return true;
+    }
+
+#ifdef ENABLE_BIGINT
+    if (v.isBigInt()) {
+        if (IsInsideNursery(v.toBigInt())) {
+            // Keys are not post barriered, and BigInts are compared by value,
+            // so store a tenured copy of nursery BigInts.
+            RootedBigInt bi(cx, v.toBigInt());
+            BigInt* copy = BigInt::copy(cx, bi, gc::TenuredHeap);
+            if (!copy) {
+                return false;
+            }
+            value = BigIntValue(copy);
+        } else {
+            value = v;
+        }
+        return true;
+    }
+#endif
+
+    MOZ_ALWAYS_TRUE(setValuePure(v));
+    return true;
+}
+
+bool
+HashableValue::setValuePure(const Value& v)
+{
+    if (v.isString()) {
+        if (!v.toString()->isAtom()) {
+            return false;
+        }
+        value = v;
     } else if (v.isDouble()) {
         double d = v.toDouble();
         int32_t i;
@@ -53,6 +90,11 @@ HashableValue::setValue(JSContext* cx, HandleValue v)
         } else {
             value = v;
         }
+#ifdef ENABLE_BIGINT
+    } else if (v.isBigInt()) {
+        // Comparing BigInts can allocate, see operator==.
+        return false;
+#endif
     } else {
         value = v;
     }
@@ -461,8 +503,8 @@ const JSPropertySpec MapObject::properties[] = {
 
 const JSFunctionSpec MapObject::methods[] = {
     // clang-format off
-    JS_FN("get", get, 1, 0),
-    JS_FN("has", has, 1, 0),
+    JS_INLINABLE_FN("get", get, 1, 0, MapGet),
+    JS_INLINABLE_FN("has", has, 1, 0, MapHas),
     JS_FN("set", set, 2, 0),
     JS_FN("delete", delete_, 1, 0),
     JS_FN("keys", keys, 0, 0),
@@ -858,6 +900,38 @@ MapObject::has(JSContext* cx, HandleObject obj, HandleValue key, bool* rval)
     return true;
 }
 
+/* static */ bool
+MapObject::getPure(MapObject* obj, Value* vp)
+{
+    AutoUnsafeCallWithABI unsafe;
+
+    HashableValue k;
+    if (!k.setValuePure(*vp)) {
+        return false;
+    }
+
+    if (ValueMap::Entry* p = obj->getData()->get(k)) {
+        *vp = p->value;
+    } else {
+        vp->setUndefined();
+    }
+    return true;
+}
+
+/* static */ bool
+MapObject::hasPure(MapObject* obj, Value* vp)
+{
+    AutoUnsafeCallWithABI unsafe;
+
+    HashableValue k;
+    if (!k.setValuePure(*vp)) {
+        return false;
+    }
+
+    vp->setBoolean(obj->getData()->has(k));
+    return true;
+}
+
 bool
 MapObject::has_impl(JSContext* cx, const CallArgs& args)
 {
@@ -1319,7 +1393,7 @@ const JSPropertySpec SetObject::properties[] = {
 
 const JSFunctionSpec SetObject::methods[] = {
     // clang-format off
-    JS_FN("has", has, 1, 0),
+    JS_INLINABLE_FN("has", has, 1, 0, SetHas),
     JS_FN("add", add, 1, 0),
     JS_FN("delete", delete_, 1, 0),
     JS_FN("entries", entries, 0, 0),
@@ -1592,6 +1666,20 @@ SetObject::has(JSContext *cx, HandleObject obj, HandleValue key, bool *rval)
     return true;
 }
 
+/* static */ bool
+SetObject::hasPure(SetObject* obj, Value* vp)
+{
+    AutoUnsafeCallWithABI unsafe;
+
+    HashableValue k;
+    if (!k.setValuePure(*vp)) {
+        return false;
+    }
+
+    vp->setBoolean(obj->getData()->has(k));
+    return true;
+}
+
 bool
 SetObject::has(JSContext *cx, unsigned argc, Value *vp)
 {
@@ -42,6 +42,10 @@ class HashableValue
     HashableValue() : value(UndefinedValue()) {}
 
     MOZ_MUST_USE bool setValue(JSContext* cx, HandleValue v);
+
+    // Like setValue, but fail instead of doing anything that can GC, such as
+    // atomizing a string. BigInt keys always fail.
+    MOZ_MUST_USE bool setValuePure(const Value& v);
     HashNumber hash(const mozilla::HashCodeScrambler& hcs) const;
     bool operator==(const HashableValue& other) const;
     HashableValue trace(JSTracer* trc) const;
@@ -121,6 +125,12 @@ class MapObject : public NativeObject {
     static MOZ_MUST_USE bool has(JSContext *cx, HandleObject obj, HandleValue key, bool* rval);
     static MOZ_MUST_USE bool delete_(JSContext *cx, HandleObject obj, HandleValue key, bool* rval);
 
+    // Look up the key in |*vp| without GC, and replace it with the result of
+    // get() or has(). Return false, leaving |*vp| unchanged, if the key has to
+    // be atomized first. Ion code calls these before calling into the VM.
+    static bool getPure(MapObject* obj, Value* vp);
+    static bool hasPure(MapObject* obj, Value* vp);
+
     // Set call for public JSAPI exposure. Does not actually return map object
     // as stated in spec, expects caller to return a value. for instance, with
     // webidl maplike/setlike, should return interface object.
@@ -233,6 +243,9 @@ class SetObject : public NativeObject {
                                       MutableHandleValue iter);
     static MOZ_MUST_USE bool delete_(JSContext *cx, HandleObject obj, HandleValue key, bool *rval);
 
+    // See MapObject::hasPure.
+    static bool hasPure(SetObject* obj, Value* vp);
+
     using UnbarrieredTable = OrderedHashSet<Value, UnbarrieredHashPolicy, ZoneAllocPolicy>;
     friend class OrderedHashTableRef<SetObject>;
 
@@ -786,6 +786,29 @@ PropertyIsEnumerable(JSContext* cx, HandleObject obj, HandleId id, bool* enumera
     return true;
 }
 
+// Whether none of the properties of |from| are found on the prototype chain
+// of |to|.
+static bool
+AssignCannotReachPrototypeProperties(JSContext* cx, NativeObject* to, NativeObject* from)
+{
+    if (to->hasDynamicPrototype()) {
+        return false;
+    }
+    JSObject* proto = to->staticPrototype();
+    if (!proto) {
+        return true;
+    }
+
+    for (Shape::Range<NoGC> r(from->lastProperty()); !r.empty(); r.popFront()) {
+        JSObject* holder;
+        PropertyResult prop;
+        if (!LookupPropertyPure(cx, proto, r.front().propid(), &holder, &prop) || prop) {
+            return false;
+        }
+    }
+    return true;
+}
+
 static bool
 TryAssignNative(JSContext* cx, HandleObject to, HandleObject from, bool* optimized)
 {
@@ -807,6 +830,22 @@ TryAssignNative(JSContext* cx, HandleObject to, HandleObject from, bool* optimiz
         return true;
     }
 
+    // Assigning to an empty object can share the shape of |from|, as long as
+    // setting the properties can't find a setter or a non-writable property
+    // on the prototype chain.
+    if (to->as<NativeObject>().lastProperty()->isEmptyShape() &&
+        AssignCannotReachPrototypeProperties(cx, &to->as<NativeObject>(), fromNative))
+    {
+        if (!TryCopyShapeAndSlots(cx, to.as<NativeObject>(), from.as<NativeObject>(),
+                                  optimized))
+        {
+            return false;
+        }
+        if (*optimized) {
+            return true;
+        }
+    }
+
     // Get a list of |from| shapes. As long as from->lastProperty() == fromShape
     // we can use this to speed up both the enumerability check and the GetProp.
 
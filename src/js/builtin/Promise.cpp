@@ -3474,15 +3474,33 @@ InternalAwait(JSContext* cx, HandleValue value, HandleObject resultPromise,
     MOZ_ASSERT(onFulfilled.isInt32());
     MOZ_ASSERT(onRejected.isInt32());
 
-    // Step 2.
-    Rooted<PromiseObject*> promise(cx, CreatePromiseObjectWithoutResolutionFunctions(cx));
-    if (!promise) {
-        return false;
+    // Awaiting a primitive value or a native promise which uses the default
+    // Promise.prototype doesn't need the intermediate promise of step 2.
+    // For a primitive, the intermediate promise would already be fulfilled
+    // with the value, so the reaction job can be enqueued directly. For such
+    // a promise, PromiseResolve(%Promise%, value) returns the promise itself
+    // (tc39/ecma262#1250), so it can be reacted to without the extra
+    // PromiseResolveThenableJob.
+    Rooted<PromiseObject*> promise(cx);
+    bool isPrimitive = !value.isObject();
+    if (!isPrimitive && value.toObject().is<PromiseObject>()) {
+        promise = &value.toObject().as<PromiseObject>();
+        if (!cx->realm()->promiseLookup.isDefaultInstance(cx, promise)) {
+            promise = nullptr;
+        }
     }
 
-    // Step 3.
-    if (!ResolvePromiseInternal(cx, promise, value)) {
-        return false;
+    if (!isPrimitive && !promise) {
+        // Step 2.
+        promise = CreatePromiseObjectWithoutResolutionFunctions(cx);
+        if (!promise) {
+            return false;
+        }
+
+        // Step 3.
+        if (!ResolvePromiseInternal(cx, promise, value)) {
+            return false;
+        }
     }
 
     // Step 7-8.
@@ -3499,6 +3517,9 @@ InternalAwait(JSContext* cx, HandleValue value, HandleObject resultPromise,
     extraStep(reaction);
 
     // Step 9.
+    if (isPrimitive) {
+        return EnqueuePromiseReactionJob(cx, reaction, value, JS::PromiseState::Fulfilled);
+    }
     return PerformPromiseThenWithReaction(cx, promise, reaction);
 }
 
@@ -1235,6 +1235,19 @@ js::RegExpTesterRaw(JSContext* cx, HandleObject regexp, HandleString input,
     return false;
 }
 
+bool
+js::RegExpSearchLiteralPrefix(RegExpShared* re, JSString* input, size_t* startIndex)
+{
+    AutoUnsafeCallWithABI unsafe;
+
+    int res = StringFindPattern(&input->asLinear(), re->getLiteralPrefix(), *startIndex);
+    if (res == -1) {
+        return false;
+    }
+    *startIndex = res;
+    return true;
+}
+
 using CapturesVector = GCVector<Value, 4>;
 
 struct JSSubString
@@ -1469,6 +1482,59 @@ NeedTwoBytes(HandleLinearString string, HandleLinearString replacement,
     return false;
 }
 
+/*
+ * ES 2016 draft Mar 25, 2016 21.1.3.14.1 steps 9, 11: append the replacement
+ * for a match of |matched| at |position| in |string| to |sb|.
+ */
+static bool
+AppendSubstitution(JSContext* cx, HandleLinearString matched, HandleLinearString string,
+                   size_t position, Handle<CapturesVector> captures,
+                   HandleLinearString replacement, size_t firstDollarIndex, StringBuffer& sb)
+{
+    // Step 9.
+    CheckedInt<uint32_t> checkedTailPos(0);
+    checkedTailPos += position;
+    checkedTailPos += matched->length();
+    if (!checkedTailPos.isValid()) {
+        ReportAllocationOverflow(cx);
+        return false;
+    }
+    uint32_t tailPos = checkedTailPos.value();
+
+    // Step 11.
+    size_t reserveLength;
+    if (!FindReplaceLength(cx, matched, string, position, tailPos, captures, replacement,
+                           firstDollarIndex, &reserveLength))
+    {
+        return false;
+    }
+
+    if (NeedTwoBytes(string, replacement, matched, captures)) {
+        if (!sb.ensureTwoByteChars()) {
+            return false;
+        }
+    }
+
+    CheckedInt<size_t> newLength = sb.length();
+    newLength += reserveLength;
+    if (!newLength.isValid()) {
+        ReportAllocationOverflow(cx);
+        return false;
+    }
+    if (!sb.reserve(newLength.value())) {
+        return false;
+    }
+
+    if (replacement->hasLatin1Chars()) {
+        DoReplace<Latin1Char>(matched, string, position, tailPos, captures,
+                              replacement, firstDollarIndex, sb);
+    } else {
+        DoReplace<char16_t>(matched, string, position, tailPos, captures,
+                            replacement, firstDollarIndex, sb);
+    }
+    return true;
+}
+
 /* ES 2016 draft Mar 25, 2016 21.1.3.14.1. */
 bool
 js::RegExpGetSubstitution(JSContext* cx, HandleArrayObject matchResult, HandleLinearString string,
@@ -1490,10 +1556,7 @@ js::RegExpGetSubstitution(JSContext* cx, HandleArrayObject matchResult, HandleLi
         return false;
     }
 
-    // Step 2.
-    size_t matchLength = matched->length();
-
-    // Steps 3-5 (skipped).
+    // Steps 2-5 (skipped).
 
     // Step 6.
     MOZ_ASSERT(position <= string->length());
@@ -1522,53 +1585,340 @@ js::RegExpGetSubstitution(JSContext* cx, HandleArrayObject matchResult, HandleLi
 
     // Step 8 (skipped).
 
-    // Step 9.
-    CheckedInt<uint32_t> checkedTailPos(0);
-    checkedTailPos += position;
-    checkedTailPos += matchLength;
-    if (!checkedTailPos.isValid()) {
-        ReportAllocationOverflow(cx);
+    // Steps 9, 11.
+    StringBuffer result(cx);
+    if (!AppendSubstitution(cx, matched, string, position, captures, replacement,
+                            firstDollarIndex, result))
+    {
         return false;
     }
-    uint32_t tailPos = checkedTailPos.value();
 
-    // Step 11.
-    size_t reserveLength;
-    if (!FindReplaceLength(cx, matched, string, position, tailPos, captures, replacement,
-                           firstDollarIndex, &reserveLength))
+    // Step 12.
+    JSString* resultString = result.finishString();
+    if (!resultString) {
+        return false;
+    }
+
+    rval.setString(resultString);
+    return true;
+}
+
+/* ES 2017 draft rev 6859bb9ccaea9c6ede81d71e5320e3833b92cb3e 21.1.3.27.1 AdvanceStringIndex. */
+static size_t
+AdvanceStringIndex(HandleLinearString string, size_t index, bool fullUnicode)
+{
+    if (!fullUnicode || index + 1 >= string->length()) {
+        return index + 1;
+    }
+    if (!unicode::IsLeadSurrogate(string->latin1OrTwoByteChar(index)) ||
+        !unicode::IsTrailSurrogate(string->latin1OrTwoByteChar(index + 1)))
     {
+        return index + 1;
+    }
+    return index + 2;
+}
+
+static bool
+GetMatchedAndCaptures(JSContext* cx, HandleLinearString string, const MatchPairs& matches,
+                      MutableHandle<JSLinearString*> matched,
+                      MutableHandle<CapturesVector> captures)
+{
+    matched.set(NewDependentString(cx, string, matches[0].start, matches[0].length()));
+    if (!matched) {
         return false;
     }
 
-    StringBuffer result(cx);
-    if (NeedTwoBytes(string, replacement, matched, captures)) {
-        if (!result.ensureTwoByteChars()) {
+    captures.clear();
+    if (!captures.reserve(matches.length() - 1)) {
+        return false;
+    }
+    for (size_t i = 1; i < matches.length(); i++) {
+        const MatchPair& pair = matches[i];
+        if (pair.isUndefined()) {
+            captures.infallibleAppend(UndefinedValue());
+            continue;
+        }
+
+        JSLinearString* capture = NewDependentString(cx, string, pair.start, pair.length());
+        if (!capture) {
+            return false;
+        }
+        captures.infallibleAppend(StringValue(capture));
+    }
+    return true;
+}
+
+/*
+ * ES 2017 draft rev 03bfda119d060aca4099d2b77cf43f6d4f11cfa2 21.2.5.8
+ * steps 11-16, for a global RegExp with the original exec and a string
+ * replaceValue. The result is built in a single StringBuffer instead of
+ * returning to self-hosted code for every match. The caller has already
+ * performed step 8.b.
+ */
+static bool
+RegExpGlobalReplaceImpl(JSContext* cx, HandleObject regexp, HandleLinearString string,
+                        HandleLinearString replacement, int32_t firstDollarIndex,
+                        MutableHandleValue rval)
+{
+    bool fullUnicode = regexp->as<RegExpObject>().unicode();
+    size_t lengthS = string->length();
+
+    StringBuffer sb(cx);
+    if (string->hasTwoByteChars() || replacement->hasTwoByteChars()) {
+        if (!sb.ensureTwoByteChars()) {
+            return false;
+        }
+    }
+
+    VectorMatchPairs matches;
+    RootedLinearString matched(cx);
+    Rooted<CapturesVector> captures(cx, CapturesVector(cx));
+
+    size_t lastIndex = 0;
+    size_t nextSourcePosition = 0;
+    while (true) {
+        // Step 11.a.
+        RegExpRunStatus status = ExecuteRegExp(cx, regexp, string, int32_t(lastIndex), &matches,
+                                               nullptr);
+        if (status == RegExpRunStatus_Error) {
+            return false;
+        }
+
+        // Step 11.b.
+        if (status == RegExpRunStatus_Success_NotFound) {
+            break;
+        }
+
+        // Steps 14.c-f.
+        size_t position = matches[0].start;
+        size_t matchLength = matches[0].length();
+        lastIndex = position + matchLength;
+
+        // Step 14.l.ii.
+        if (!sb.appendSubstring(string, nextSourcePosition, position - nextSourcePosition)) {
+            return false;
+        }
+
+        // Steps 14.g-k.
+        if (firstDollarIndex < 0) {
+            if (!sb.append(replacement)) {
+                return false;
+            }
+        } else {
+            if (!GetMatchedAndCaptures(cx, string, matches, &matched, &captures)) {
+                return false;
+            }
+            if (!AppendSubstitution(cx, matched, string, position, captures, replacement,
+                                    size_t(firstDollarIndex), sb))
+            {
+                return false;
+            }
+        }
+
+        // Step 14.l.iii.
+        nextSourcePosition = lastIndex;
+
+        // Step 11.c.iii.2.
+        if (matchLength == 0) {
+            lastIndex = AdvanceStringIndex(string, lastIndex, fullUnicode);
+            if (lastIndex > lengthS) {
+                break;
+            }
+        }
+    }
+
+    // Steps 15-16.
+    if (nextSourcePosition < lengthS) {
+        if (!sb.appendSubstring(string, nextSourcePosition, lengthS - nextSourcePosition)) {
             return false;
         }
     }
 
-    if (!result.reserve(reserveLength)) {
+    JSString* result = sb.finishString();
+    if (!result) {
         return false;
     }
 
-    if (replacement->hasLatin1Chars()) {
-        DoReplace<Latin1Char>(matched, string, position, tailPos, captures,
-                              replacement, firstDollarIndex, result);
-    } else {
-        DoReplace<char16_t>(matched, string, position, tailPos, captures,
-                            replacement, firstDollarIndex, result);
+    rval.setString(result);
+    return true;
+}
+
+bool
+js::RegExpGlobalReplaceString(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 4);
+    MOZ_ASSERT(IsRegExpObject(args[0]));
+    MOZ_ASSERT(args[1].isString());
+    MOZ_ASSERT(args[2].isString());
+    MOZ_ASSERT(args[3].isInt32());
+
+    RootedObject regexp(cx, &args[0].toObject());
+
+    RootedLinearString string(cx, args[1].toString()->ensureLinear(cx));
+    if (!string) {
+        return false;
     }
 
-    // Step 12.
-    JSString* resultString = result.finishString();
-    if (!resultString) {
+    RootedLinearString replacement(cx, args[2].toString()->ensureLinear(cx));
+    if (!replacement) {
         return false;
     }
 
-    rval.setString(resultString);
+    return RegExpGlobalReplaceImpl(cx, regexp, string, replacement, args[3].toInt32(),
+                                   args.rval());
+}
+
+/*
+ * ES 2017 draft 6859bb9ccaea9c6ede81d71e5320e3833b92cb3e 21.2.5.11
+ * steps 17-23, for a non-sticky splitter with the original exec.
+ */
+static bool
+RegExpSplitImpl(JSContext* cx, HandleObject splitter, HandleLinearString string, uint32_t lim,
+                MutableHandleValue rval)
+{
+    MOZ_ASSERT(lim > 0);
+
+    bool unicodeMatching = splitter->as<RegExpObject>().unicode();
+
+    RootedArrayObject A(cx, NewDenseEmptyArray(cx));
+    if (!A) {
+        return false;
+    }
+
+    VectorMatchPairs matches;
+
+    // Step 14 (reordered).
+    size_t size = string->length();
+
+    // Step 17.
+    if (size == 0) {
+        // Step 17.a.
+        RegExpRunStatus status = ExecuteRegExp(cx, splitter, string, 0, &matches, nullptr);
+        if (status == RegExpRunStatus_Error) {
+            return false;
+        }
+
+        // Steps 17.b, 17.d.
+        if (status == RegExpRunStatus_Success_NotFound) {
+            if (!NewbornArrayPush(cx, A, StringValue(string))) {
+                return false;
+            }
+        }
+
+        // Step 17.e.
+        rval.setObject(*A);
+        return true;
+    }
+
+    // Step 15.
+    size_t p = 0;
+
+    // Step 18.
+    size_t q = p;
+
+    // Step 19.
+    while (q < size) {
+        // Steps 19.a-b. The splitter is not sticky, so the match is searched
+        // for from q instead of only being tried at q.
+        RegExpRunStatus status = ExecuteRegExp(cx, splitter, string, int32_t(q), &matches, nullptr);
+        if (status == RegExpRunStatus_Error) {
+            return false;
+        }
+
+        // Step 19.c.
+        if (status == RegExpRunStatus_Success_NotFound) {
+            break;
+        }
+
+        q = matches[0].start;
+        if (q >= size) {
+            break;
+        }
+
+        // Step 19.d.i.
+        size_t e = q + matches[0].length();
+
+        // Step 19.d.iii.
+        if (e == p) {
+            q = AdvanceStringIndex(string, q, unicodeMatching);
+            continue;
+        }
+
+        // Steps 19.d.iv.1-4.
+        JSString* sub = NewDependentString(cx, string, p, q - p);
+        if (!sub || !NewbornArrayPush(cx, A, StringValue(sub))) {
+            return false;
+        }
+
+        // Step 19.d.iv.5.
+        if (A->length() == lim) {
+            rval.setObject(*A);
+            return true;
+        }
+
+        // Step 19.d.iv.6.
+        p = e;
+
+        // Steps 19.d.iv.7-10.
+        for (size_t i = 1; i < matches.length(); i++) {
+            const MatchPair& pair = matches[i];
+            Value capture = UndefinedValue();
+            if (!pair.isUndefined()) {
+                JSString* str = NewDependentString(cx, string, pair.start, pair.length());
+                if (!str) {
+                    return false;
+                }
+                capture.setString(str);
+            }
+            if (!NewbornArrayPush(cx, A, capture)) {
+                return false;
+            }
+            if (A->length() == lim) {
+                rval.setObject(*A);
+                return true;
+            }
+        }
+
+        // Step 19.d.iv.11.
+        q = p;
+    }
+
+    // Steps 20-22.
+    JSString* sub = p >= size
+                    ? cx->emptyString()
+                    : NewDependentString(cx, string, p, size - p);
+    if (!sub || !NewbornArrayPush(cx, A, StringValue(sub))) {
+        return false;
+    }
+
+    // Step 23.
+    rval.setObject(*A);
     return true;
 }
 
+bool
+js::RegExpSplitOpt(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 3);
+    MOZ_ASSERT(IsRegExpObject(args[0]));
+    MOZ_ASSERT(args[1].isString());
+    MOZ_ASSERT(args[2].isNumber());
+
+    RootedObject splitter(cx, &args[0].toObject());
+
+    RootedLinearString string(cx, args[1].toString()->ensureLinear(cx));
+    if (!string) {
+        return false;
+    }
+
+    uint32_t lim;
+    MOZ_ALWAYS_TRUE(ToUint32(cx, args[2], &lim));
+
+    return RegExpSplitImpl(cx, splitter, string, lim, args.rval());
+}
+
 bool
 js::GetFirstDollarIndex(JSContext* cx, unsigned argc, Value* vp)
 {
@@ -97,6 +97,18 @@ RegExpInstanceOptimizable(JSContext* cx, unsigned argc, Value* vp);
 extern MOZ_MUST_USE bool
 RegExpInstanceOptimizableRaw(JSContext* cx, JSObject* obj, JSObject* proto);
 
+// Called by the JIT RegExp stubs: advance |*startIndex| to the first occurrence
+// of |re|'s literal prefix in the linear string |input|, returning false if
+// there is none.
+extern MOZ_MUST_USE bool
+RegExpSearchLiteralPrefix(RegExpShared* re, JSString* input, size_t* startIndex);
+
+extern MOZ_MUST_USE bool
+RegExpGlobalReplaceString(JSContext* cx, unsigned argc, Value* vp);
+
+extern MOZ_MUST_USE bool
+RegExpSplitOpt(JSContext* cx, unsigned argc, Value* vp);
+
 extern MOZ_MUST_USE bool
 RegExpGetSubstitution(JSContext* cx, HandleArrayObject matchResult, HandleLinearString string,
                       size_t position, HandleLinearString replacement, size_t firstDollarIndex,
@@ -192,17 +192,36 @@ function RegExpGlobalMatchOpt(rx, S, fullUnicode) {
 
     // Step 6.e.
     while (true) {
-        // Step 6.e.i.
-        var result = RegExpMatcher(rx, S, lastIndex);
+        var matchStr;
 
-        // Step 6.e.ii.
-        if (result === null)
-            return (n === 0) ? null : A;
+        // Only the matched substring is needed, so for short strings use the
+        // searcher and skip creating the result array and the capture strings.
+        if (lengthS < 0x7fff) {
+            // Step 6.e.i.
+            var position = RegExpSearcher(rx, S, lastIndex);
 
-        lastIndex = result.index + result[0].length;
+            // Step 6.e.ii.
+            if (position === -1)
+                return (n === 0) ? null : A;
 
-        // Step 6.e.iii.1.
-        var matchStr = result[0];
+            lastIndex = (position >> 15) & 0x7fff;
+            position = position & 0x7fff;
+
+            // Step 6.e.iii.1.
+            matchStr = Substring(S, position, lastIndex - position);
+        } else {
+            // Step 6.e.i.
+            var result = RegExpMatcher(rx, S, lastIndex);
+
+            // Step 6.e.ii.
+            if (result === null)
+                return (n === 0) ? null : A;
+
+            lastIndex = result.index + result[0].length;
+
+            // Step 6.e.iii.1.
+            matchStr = result[0];
+        }
 
         // Step 6.e.iii.2.
         _DefineDataProperty(A, n, matchStr);
@@ -293,13 +312,11 @@ function RegExpReplace(string, replaceValue) {
                 }
                 return RegExpGlobalReplaceOptFunc(rx, S, lengthS, replaceValue, flags);
             }
-            if (firstDollarIndex !== -1) {
-                return RegExpGlobalReplaceOptSubst(rx, S, lengthS, replaceValue, flags,
-                                                   firstDollarIndex);
-            }
-            if (lengthS < 0x7fff)
-                return RegExpGlobalReplaceShortOpt(rx, S, lengthS, replaceValue, flags);
-            return RegExpGlobalReplaceOpt(rx, S, lengthS, replaceValue, flags);
+            // Step 8.b.
+            rx.lastIndex = 0;
+
+            // Steps 11-16.
+            return RegExpGlobalReplaceString(rx, S, replaceValue, firstDollarIndex);
         }
 
         if (functionalReplace)
@@ -524,73 +541,10 @@ function RegExpGetFunctionalReplacement(result, S, position, replaceValue) {
     return ToString(callFunction(std_Function_apply, replaceValue, undefined, captures));
 }
 
-// ES 2017 draft rev 03bfda119d060aca4099d2b77cf43f6d4f11cfa2 21.2.5.8
-// steps 8.b-16.
-// Optimized path for @@replace with the following conditions:
-//   * global flag is true
-//   * S is a short string (lengthS < 0x7fff)
-//   * replaceValue is a string without "$"
-function RegExpGlobalReplaceShortOpt(rx, S, lengthS, replaceValue, flags)
-{
-    // Step 8.a.
-    var fullUnicode = !!(flags & REGEXP_UNICODE_FLAG);
-
-    // Step 8.b.
-    var lastIndex = 0;
-    rx.lastIndex = 0;
-
-    // Step 12 (reordered).
-    var accumulatedResult = "";
-
-    // Step 13 (reordered).
-    var nextSourcePosition = 0;
-
-    // Step 11.
-    while (true) {
-        // Step 11.a.
-        var result = RegExpSearcher(rx, S, lastIndex);
-
-        // Step 11.b.
-        if (result === -1)
-            break;
-
-        var position = result & 0x7fff;
-        lastIndex = (result >> 15) & 0x7fff;
-
-        // Step 14.l.ii.
-        accumulatedResult += Substring(S, nextSourcePosition,
-                                       position - nextSourcePosition) + replaceValue;
-
-        // Step 14.l.iii.
-        nextSourcePosition = lastIndex;
-
-        // Step 11.c.iii.2.
-        if (lastIndex === position) {
-            lastIndex = fullUnicode ? AdvanceStringIndex(S, lastIndex) : lastIndex + 1;
-            if (lastIndex > lengthS)
-                break;
-        }
-    }
-
-    // Step 15.
-    if (nextSourcePosition >= lengthS)
-        return accumulatedResult;
-
-    // Step 16.
-    return accumulatedResult + Substring(S, nextSourcePosition, lengthS - nextSourcePosition);
-}
-
 // ES 2017 draft rev 03bfda119d060aca4099d2b77cf43f6d4f11cfa2 21.2.5.8
 // steps 8-16.
 // Optimized path for @@replace.
 
-// Conditions:
-//   * global flag is true
-//   * replaceValue is a string without "$"
-#define FUNC_NAME RegExpGlobalReplaceOpt
-#include "RegExpGlobalReplaceOpt.h.js"
-#undef FUNC_NAME
-
 // Conditions:
 //   * global flag is true
 //   * replaceValue is a function
@@ -609,15 +563,6 @@ function RegExpGlobalReplaceShortOpt(rx, S, lengthS, replaceValue, flags)
 #undef ELEMBASE
 #undef FUNC_NAME
 
-// Conditions:
-//   * global flag is true
-//   * replaceValue is a string with "$"
-#define FUNC_NAME RegExpGlobalReplaceOptSubst
-#define SUBSTITUTION
-#include "RegExpGlobalReplaceOpt.h.js"
-#undef SUBSTITUTION
-#undef FUNC_NAME
-
 // Conditions:
 //   * global flag is false
 //   * replaceValue is a string without "$"
@@ -820,17 +765,17 @@ function RegExpSplit(string, limit) {
     if (lim === 0)
         return A;
 
+    // Steps 14, 17-23.
+    if (optimizable)
+        return RegExpSplitOpt(splitter, S, lim);
+
     // Step 14 (reordered).
     var size = S.length;
 
     // Step 17.
     if (size === 0) {
         // Step 17.a.
-        var z;
-        if (optimizable)
-            z = RegExpMatcher(splitter, S, 0);
-        else
-            z = RegExpExec(splitter, S, false);
+        var z = RegExpExec(splitter, S, false);
 
         // Step 17.b.
         if (z !== null)
@@ -848,42 +793,21 @@ function RegExpSplit(string, limit) {
 
     // Step 19.
     while (q < size) {
-        var e;
-        if (optimizable) {
-            // Step 19.a (skipped).
-            // splitter.lastIndex is not used.
-
-            // Step 19.b.
-            z = RegExpMatcher(splitter, S, q);
+        // Step 19.a.
+        splitter.lastIndex = q;
 
-            // Step 19.c.
-            if (z === null)
-                break;
+        // Step 19.b.
+        z = RegExpExec(splitter, S, false);
 
-            // splitter.lastIndex is not updated.
-            q = z.index;
-            if (q >= size)
-                break;
-
-            // Step 19.d.i.
-            e = q + z[0].length;
-        } else {
-            // Step 19.a.
-            splitter.lastIndex = q;
-
-            // Step 19.b.
-            z = RegExpExec(splitter, S, false);
-
-            // Step 19.c.
-            if (z === null) {
-                q = unicodeMatching ? AdvanceStringIndex(S, q) : q + 1;
-                continue;
-            }
-
-            // Step 19.d.i.
-            e = ToLength(splitter.lastIndex);
+        // Step 19.c.
+        if (z === null) {
+            q = unicodeMatching ? AdvanceStringIndex(S, q) : q + 1;
+            continue;
         }
 
+        // Step 19.d.i.
+        var e = ToLength(splitter.lastIndex);
+
         // Step 19.d.iii.
         if (e === p) {
             q = unicodeMatching ? AdvanceStringIndex(S, q) : q + 1;
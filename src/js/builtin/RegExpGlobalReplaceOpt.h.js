@@ -1,27 +1,21 @@
 // Function template for the following functions:
-//   * RegExpGlobalReplaceOpt
 //   * RegExpGlobalReplaceOptFunc
-//   * RegExpGlobalReplaceOptSubst
 //   * RegExpGlobalReplaceOptElemBase
 // Define the following macro and include this file to declare function:
 //   * FUNC_NAME     -- function name (required)
 //       e.g.
-//         #define FUNC_NAME RegExpGlobalReplaceOpt
-// Define the following macro (without value) to switch the code:
-//   * SUBSTITUTION     -- replaceValue is a string with "$"
+//         #define FUNC_NAME RegExpGlobalReplaceOptFunc
+// Define one of the following macros (without value) to switch the code:
 //   * FUNCTIONAL       -- replaceValue is a function
 //   * ELEMBASE         -- replaceValue is a function that returns an element
 //                         of an object
-//   * none of above    -- replaceValue is a string without "$"
+// A string replaceValue is handled by the native RegExpGlobalReplaceString.
 
 // ES 2017 draft 03bfda119d060aca4099d2b77cf43f6d4f11cfa2 21.2.5.8
 // steps 8.b-16.
 // Optimized path for @@replace with the following conditions:
 //   * global flag is true
 function FUNC_NAME(rx, S, lengthS, replaceValue, flags
-#ifdef SUBSTITUTION
-                   , firstDollarIndex
-#endif
 #ifdef ELEMBASE
                    , elemBase
 #endif
@@ -34,12 +28,10 @@ function FUNC_NAME(rx, S, lengthS, replaceValue, flags
     var lastIndex = 0;
     rx.lastIndex = 0;
 
-#if defined(FUNCTIONAL) || defined(ELEMBASE)
     // Save the original source and flags, so we can check if the replacer
     // function recompiled the regexp.
     var originalSource = UnsafeGetStringFromReservedSlot(rx, REGEXP_SOURCE_SLOT);
     var originalFlags = flags;
-#endif
 
     // Step 12 (reordered).
     var accumulatedResult = "";
@@ -73,8 +65,6 @@ function FUNC_NAME(rx, S, lengthS, replaceValue, flags
         var replacement;
 #if defined(FUNCTIONAL)
         replacement = RegExpGetFunctionalReplacement(result, S, position, replaceValue);
-#elif defined(SUBSTITUTION)
-        replacement = RegExpGetSubstitution(result, S, position, replaceValue, firstDollarIndex);
 #elif defined(ELEMBASE)
         if (IsObject(elemBase)) {
             var prop = GetStringDataProperty(elemBase, matched);
@@ -89,8 +79,6 @@ function FUNC_NAME(rx, S, lengthS, replaceValue, flags
 
         if (!IsObject(elemBase))
             replacement = RegExpGetFunctionalReplacement(result, S, position, replaceValue);
-#else
-        replacement = replaceValue;
 #endif
 
         // Step 14.l.ii.
@@ -108,7 +96,6 @@ function FUNC_NAME(rx, S, lengthS, replaceValue, flags
             lastIndex |= 0;
         }
 
-#if defined(FUNCTIONAL) || defined(ELEMBASE)
         // Ensure the current source and flags match the original regexp, the
         // replaceValue function may have called RegExp#compile.
         if (UnsafeGetStringFromReservedSlot(rx, REGEXP_SOURCE_SLOT) !== originalSource ||
@@ -116,7 +103,6 @@ function FUNC_NAME(rx, S, lengthS, replaceValue, flags
         {
             rx = regexp_construct_raw_flags(originalSource, originalFlags);
         }
-#endif
     }
 
     // Step 15.
@@ -6,6 +6,8 @@
 
 #include "builtin/Stream.h"
 
+#include <string.h>
+
 #include "js/Stream.h"
 
 #include "gc/Heap.h"
@@ -3735,6 +3737,68 @@ static MOZ_MUST_USE bool
 ReadableByteStreamControllerHandleQueueDrain(JSContext* cx,
                                              Handle<ReadableStreamController*> controller);
 
+/**
+ * Create a Uint8Array of |length| bytes and have the external underlying
+ * source of |stream| write the next chunk into it. The source overwrites the
+ * contents, so they aren't zeroed beforehand: only the bytes it didn't write
+ * are zeroed afterwards, which saves clearing large binary chunks twice.
+ */
+static MOZ_MUST_USE JSObject*
+WriteExternalSourceChunk(JSContext* cx, Handle<ReadableStream*> stream,
+                         Handle<ReadableStreamController*> controller, uint32_t length,
+                         size_t* bytesWritten)
+{
+    MOZ_ASSERT(stream->mode() == JS::ReadableStreamMode::ExternalSource);
+
+    RootedObject view(cx);
+    uint8_t* data = nullptr;
+    if (length == 0) {
+        view = JS_NewUint8Array(cx, 0);
+        if (!view) {
+            return nullptr;
+        }
+    } else {
+        data = cx->pod_malloc<uint8_t>(length);
+        if (!data) {
+            return nullptr;
+        }
+
+        RootedObject buffer(cx, JS_NewArrayBufferWithContents(cx, length, data));
+        if (!buffer) {
+            js_free(data);
+            return nullptr;
+        }
+
+        view = JS_NewUint8ArrayWithBuffer(cx, buffer, 0, length);
+        if (!view) {
+            return nullptr;
+        }
+    }
+
+    void* underlyingSource = controller->getFixedSlot(ControllerSlot_UnderlyingSource).toPrivate();
+
+    {
+        JS::AutoSuppressGCAnalysis suppressGC(cx);
+        JS::AutoCheckCannotGC noGC;
+        bool dummy;
+        void* buffer = JS_GetArrayBufferViewData(view, &dummy, noGC);
+        MOZ_ASSERT_IF(data, buffer == data);
+        auto cb = cx->runtime()->readableStreamWriteIntoReadRequestCallback;
+        MOZ_ASSERT(cb);
+        // TODO: use bytesWritten to correctly update the request's state.
+        // TODO: make this compartment-safe.
+        cb(cx, stream, underlyingSource, stream->embeddingFlags(), buffer, length,
+           bytesWritten);
+        MOZ_ASSERT(*bytesWritten <= length);
+
+        if (*bytesWritten < length) {
+            memset(static_cast<uint8_t*>(buffer) + *bytesWritten, 0, length - *bytesWritten);
+        }
+    }
+
+    return view;
+}
+
 /**
  * Streams spec, 3.10.5.2. [[PullSteps]] ()
  *
@@ -3767,28 +3831,13 @@ ReadableByteStreamControllerPullSteps(JSContext* cx, Handle<ReadableStreamContro
         RootedObject view(cx);
 
         if (stream->mode() == JS::ReadableStreamMode::ExternalSource) {
-            val = controller->getFixedSlot(ControllerSlot_UnderlyingSource);
-            void* underlyingSource = val.toPrivate();
-
-            view = JS_NewUint8Array(cx, queueTotalSize);
+            size_t bytesWritten;
+            view = WriteExternalSourceChunk(cx, stream, controller, uint32_t(queueTotalSize),
+                                            &bytesWritten);
             if (!view) {
                 return nullptr;
             }
 
-            size_t bytesWritten;
-            {
-                JS::AutoSuppressGCAnalysis suppressGC(cx);
-                JS::AutoCheckCannotGC noGC;
-                bool dummy;
-                void* buffer = JS_GetArrayBufferViewData(view, &dummy, noGC);
-                auto cb = cx->runtime()->readableStreamWriteIntoReadRequestCallback;
-                MOZ_ASSERT(cb);
-                // TODO: use bytesWritten to correctly update the request's state.
-                // TODO: make this compartment-safe.
-                cb(cx, stream, underlyingSource, stream->embeddingFlags(), buffer,
-                   queueTotalSize, &bytesWritten);
-            }
-
             queueTotalSize = queueTotalSize - bytesWritten;
         } else {
             // Step 3.b: Let entry be the first element of this.[[queue]].
@@ -4615,29 +4664,13 @@ ReadableStream::updateDataAvailableFromSource(JSContext* cx, Handle<ReadableStre
 
         // Step ii: Let transferredView be
         //          ! Construct(%Uint8Array%, transferredBuffer, byteOffset, byteLength).
-        JSObject* viewObj = JS_NewUint8Array(cx, availableData);
-        Rooted<ArrayBufferViewObject*> transferredView(cx, &viewObj->as<ArrayBufferViewObject>());
+        size_t bytesWritten;
+        RootedObject transferredView(cx, WriteExternalSourceChunk(cx, stream, controller,
+                                                                  availableData, &bytesWritten));
         if (!transferredView) {
             return false;
         }
 
-        Value val = controller->getFixedSlot(ControllerSlot_UnderlyingSource);
-        void* underlyingSource = val.toPrivate();
-
-        size_t bytesWritten;
-        {
-            JS::AutoSuppressGCAnalysis suppressGC(cx);
-            JS::AutoCheckCannotGC noGC;
-            bool dummy;
-            void* buffer = JS_GetArrayBufferViewData(transferredView, &dummy, noGC);
-            auto cb = cx->runtime()->readableStreamWriteIntoReadRequestCallback;
-            MOZ_ASSERT(cb);
-            // TODO: use bytesWritten to correctly update the request's state.
-            // TODO: make cross-compartment safe.
-            cb(cx, stream, underlyingSource, stream->embeddingFlags(), buffer,
-               availableData, &bytesWritten);
-        }
-
         // Step iii: Perform ! ReadableStreamFulfillReadRequest(stream, transferredView, false).
         RootedValue chunk(cx, ObjectValue(*transferredView));
         if (!ReadableStreamFulfillReadOrReadIntoRequest(cx, stream, chunk, false)) {
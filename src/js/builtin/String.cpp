@@ -10,6 +10,7 @@
 #include "mozilla/Attributes.h"
 #include "mozilla/CheckedInt.h"
 #include "mozilla/FloatingPoint.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/PodOperations.h"
 #include "mozilla/Range.h"
 #include "mozilla/TypeTraits.h"
@@ -60,6 +61,11 @@
 #include "vm/StringType-inl.h"
 #include "vm/TypeInference-inl.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define JS_STRING_SSE2
+#  include <emmintrin.h>
+#endif
+
 using namespace js;
 
 using JS::Symbol;
@@ -709,6 +715,114 @@ Final_Sigma(const Latin1Char* chars, size_t length, size_t index)
     return 0;
 }
 
+/*
+ * ASCII chars have no special casing, so runs of them can be case mapped a
+ * vector at a time by flipping bit 0x20 of the letters which change. These
+ * helpers handle whole vectors of ASCII chars and return the index of the
+ * first char they didn't handle, leaving the rest to the scalar loops.
+ */
+#ifdef JS_STRING_SSE2
+
+static const size_t ASCIICaseVectorLength = sizeof(__m128i);
+
+// Loads 16 chars as bytes. Returns false if any of them isn't ASCII.
+static MOZ_ALWAYS_INLINE bool
+LoadASCIIVector(const Latin1Char* chars, __m128i* v)
+{
+    *v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars));
+    return _mm_movemask_epi8(*v) == 0;
+}
+
+static MOZ_ALWAYS_INLINE bool
+LoadASCIIVector(const char16_t* chars, __m128i* v)
+{
+    __m128i lo = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars));
+    __m128i hi = _mm_loadu_si128(reinterpret_cast<const __m128i*>(chars + 8));
+
+    // Packing saturates chars above 0xff to 0xff, so any non-ASCII char
+    // sets the sign bit of its byte.
+    *v = _mm_packus_epi16(lo, hi);
+    return _mm_movemask_epi8(*v) == 0;
+}
+
+static MOZ_ALWAYS_INLINE void
+StoreASCIIVector(Latin1Char* chars, __m128i v)
+{
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(chars), v);
+}
+
+static MOZ_ALWAYS_INLINE void
+StoreASCIIVector(char16_t* chars, __m128i v)
+{
+    __m128i zero = _mm_setzero_si128();
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(chars), _mm_unpacklo_epi8(v, zero));
+    _mm_storeu_si128(reinterpret_cast<__m128i*>(chars + 8), _mm_unpackhi_epi8(v, zero));
+}
+
+// Returns 0x20 in the bytes of |v| which change when case mapped, 0 in the
+// others. |v| must only contain ASCII chars.
+template <bool ToUpper>
+static MOZ_ALWAYS_INLINE __m128i
+ASCIICaseChangeBits(__m128i v)
+{
+    const __m128i first = _mm_set1_epi8(ToUpper ? 'a' - 1 : 'A' - 1);
+    const __m128i last = _mm_set1_epi8(ToUpper ? 'z' + 1 : 'Z' + 1);
+    __m128i letters = _mm_and_si128(_mm_cmpgt_epi8(v, first), _mm_cmplt_epi8(v, last));
+    return _mm_and_si128(letters, _mm_set1_epi8(0x20));
+}
+
+#endif // JS_STRING_SSE2
+
+// Returns the index of the first char which may change when case mapped.
+template <bool ToUpper, typename CharT>
+static MOZ_ALWAYS_INLINE size_t
+SkipASCIICaseUnchanged(const CharT* chars, size_t length)
+{
+    size_t i = 0;
+#ifdef JS_STRING_SSE2
+    for (; length - i >= ASCIICaseVectorLength; i += ASCIICaseVectorLength) {
+        __m128i v;
+        if (!LoadASCIIVector(chars + i, &v)) {
+            break;
+        }
+        if (_mm_movemask_epi8(_mm_cmpeq_epi8(ASCIICaseChangeBits<ToUpper>(v),
+                                             _mm_setzero_si128())) != 0xffff)
+        {
+            break;
+        }
+    }
+#endif
+    return i;
+}
+
+// Case maps the chars from |startIndex| and returns the index of the first
+// char which wasn't mapped.
+template <bool ToUpper, typename CharT>
+static MOZ_ALWAYS_INLINE size_t
+MapASCIICase(CharT* destChars, const CharT* srcChars, size_t startIndex, size_t srcLength)
+{
+    size_t i = startIndex;
+#ifdef JS_STRING_SSE2
+    for (; srcLength - i >= ASCIICaseVectorLength; i += ASCIICaseVectorLength) {
+        __m128i v;
+        if (!LoadASCIIVector(srcChars + i, &v)) {
+            break;
+        }
+        StoreASCIIVector(destChars + i, _mm_xor_si128(v, ASCIICaseChangeBits<ToUpper>(v)));
+    }
+#endif
+    return i;
+}
+
+// Latin-1 strings may be uppercased into two-byte strings, which we don't
+// bother to vectorize.
+template <bool ToUpper, typename DestChar, typename SrcChar>
+static MOZ_ALWAYS_INLINE size_t
+MapASCIICase(DestChar* destChars, const SrcChar* srcChars, size_t startIndex, size_t srcLength)
+{
+    return startIndex;
+}
+
 // If |srcLength == destLength| is true, the destination buffer was allocated
 // with the same size as the source buffer. When we append characters which
 // have special casing mappings, we test |srcLength == destLength| to decide
@@ -725,8 +839,10 @@ ToLowerCaseImpl(CharT* destChars, const CharT* srcChars, size_t startIndex, size
     MOZ_ASSERT(srcLength <= destLength);
     MOZ_ASSERT_IF((IsSame<CharT, Latin1Char>::value), srcLength == destLength);
 
-    size_t j = startIndex;
-    for (size_t i = startIndex; i < srcLength; i++) {
+    // Nothing has been expanded yet, so the source and destination indices
+    // stay equal while mapping ASCII chars.
+    size_t j = MapASCIICase<false>(destChars, srcChars, startIndex, srcLength);
+    for (size_t i = j; i < srcLength; i++) {
         char16_t c = srcChars[i];
         if (!IsSame<CharT, Latin1Char>::value) {
             if (unicode::IsLeadSurrogate(c) && i + 1 < srcLength) {
@@ -828,7 +944,7 @@ ToLowerCase(JSContext* cx, JSLinearString* str)
         }
 
         // Look for the first character that changes when lowercased.
-        size_t i = 0;
+        size_t i = SkipASCIICaseUnchanged<false>(chars, length);
         for (; i < length; i++) {
             CharT c = chars[i];
             if (!IsSame<CharT, Latin1Char>::value) {
@@ -1110,8 +1226,8 @@ ToUpperCaseImpl(DestChar* destChars, const SrcChar* srcChars, size_t startIndex,
     MOZ_ASSERT(startIndex < srcLength);
     MOZ_ASSERT(srcLength <= destLength);
 
-    size_t j = startIndex;
-    for (size_t i = startIndex; i < srcLength; i++) {
+    size_t j = MapASCIICase<true>(destChars, srcChars, startIndex, srcLength);
+    for (size_t i = j; i < srcLength; i++) {
         char16_t c = srcChars[i];
         if (!IsSame<DestChar, Latin1Char>::value) {
             if (unicode::IsLeadSurrogate(c) && i + 1 < srcLength) {
@@ -1252,7 +1368,7 @@ ToUpperCase(JSContext* cx, JSLinearString* str)
         }
 
         // Look for the first character that changes when uppercased.
-        size_t i = 0;
+        size_t i = SkipASCIICaseUnchanged<true>(chars, length);
         for (; i < length; i++) {
             CharT c = chars[i];
             if (!IsSame<CharT, Latin1Char>::value) {
@@ -1892,6 +2008,83 @@ Matcher(const TextChar* text, uint32_t textlen, const PatChar* pat, uint32_t pat
      return -1;
  }
 
+#ifdef JS_STRING_SSE2
+
+static MOZ_ALWAYS_INLINE __m128i
+SplatChar(Latin1Char, char16_t c)
+{
+    MOZ_ASSERT(c <= 0xff);
+    return _mm_set1_epi8(char(c));
+}
+
+static MOZ_ALWAYS_INLINE __m128i
+SplatChar(char16_t, char16_t c)
+{
+    return _mm_set1_epi16(short(c));
+}
+
+static MOZ_ALWAYS_INLINE uint32_t
+CompareChars(const Latin1Char* text, __m128i c)
+{
+    __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+    return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(units, c)));
+}
+
+static MOZ_ALWAYS_INLINE uint32_t
+CompareChars(const char16_t* text, __m128i c)
+{
+    __m128i units = _mm_loadu_si128(reinterpret_cast<const __m128i*>(text));
+    return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi16(units, c)));
+}
+
+/*
+ * Like Matcher, but finds candidate positions a vector at a time by checking
+ * the first and the last char of the pattern together, which rules out most
+ * positions where only the first char matches. In the masks each position
+ * has sizeof(TextChar) bits, all set when both chars match.
+ */
+template <class InnerMatch, typename TextChar, typename PatChar>
+static int
+SimdMatcher(const TextChar* text, uint32_t textlen, const PatChar* pat, uint32_t patlen)
+{
+    MOZ_ASSERT(patlen > 0);
+    MOZ_ASSERT(textlen >= patlen);
+
+    uint32_t patLast = patlen - 1;
+    if (sizeof(TextChar) == 1 && sizeof(PatChar) > 1 && (pat[0] > 0xff || pat[patLast] > 0xff)) {
+        return -1;
+    }
+
+    const typename InnerMatch::Extent extent = InnerMatch::computeExtent(pat, patlen);
+
+    static const uint32_t CharsPerVector = sizeof(__m128i) / sizeof(TextChar);
+    static const uint32_t PositionBits = (1 << sizeof(TextChar)) - 1;
+    const __m128i first = SplatChar(TextChar(), pat[0]);
+    const __m128i last = SplatChar(TextChar(), pat[patLast]);
+
+    uint32_t i = 0;
+    uint32_t n = textlen - patlen + 1;
+    for (; n - i >= CharsPerVector; i += CharsPerVector) {
+        uint32_t mask = CompareChars(text + i, first) & CompareChars(text + i + patLast, last);
+        while (mask) {
+            uint32_t bit = mozilla::CountTrailingZeroes32(mask);
+            uint32_t pos = i + bit / sizeof(TextChar);
+            if (InnerMatch::match(pat + 1, text + pos + 1, extent)) {
+                return pos;
+            }
+            mask &= ~(PositionBits << bit);
+        }
+    }
+
+    for (; i < n; i++) {
+        if (text[i] == pat[0] && InnerMatch::match(pat + 1, text + i + 1, extent)) {
+            return i;
+        }
+    }
+    return -1;
+}
+
+#endif // JS_STRING_SSE2
 
 template <typename TextChar, typename PatChar>
 static MOZ_ALWAYS_INLINE int
@@ -1934,7 +2127,16 @@ StringMatch(const TextChar* text, uint32_t textLen, const PatChar* pat, uint32_t
      * From this, the values for "big enough" and "too small" are determined
      * empirically. See bug 526348.
      */
-    if (textLen >= 512 && patLen >= 11 && patLen <= sBMHPatLenMax) {
+#ifdef JS_STRING_SSE2
+    /*
+     * Checking the first and last chars a vector at a time beats BMH unless
+     * the pattern is long enough for BMH to skip large parts of the text.
+     */
+    static const uint32_t BMHMinPatLen = 64;
+#else
+    static const uint32_t BMHMinPatLen = 11;
+#endif
+    if (textLen >= 512 && patLen >= BMHMinPatLen && patLen <= sBMHPatLenMax) {
         int index = BoyerMooreHorspool(text, textLen, pat, patLen);
         if (index != sBMHBadPattern) {
             return index;
@@ -1946,6 +2148,16 @@ StringMatch(const TextChar* text, uint32_t textLen, const PatChar* pat, uint32_t
      * speed of memcmp. For small patterns, a simple loop is faster. We also can't
      * use memcmp if one of the strings is TwoByte and the other is Latin-1.
      */
+#ifdef JS_STRING_SSE2
+    // memchr is already vectorized for single Latin1 chars.
+    if (patLen > 1 || sizeof(TextChar) > 1) {
+        return (patLen > 128 && IsSame<TextChar, PatChar>::value)
+               ? SimdMatcher<MemCmp<TextChar, PatChar>, TextChar, PatChar>(text, textLen,
+                                                                           pat, patLen)
+               : SimdMatcher<ManualCmp<TextChar, PatChar>, TextChar, PatChar>(text, textLen,
+                                                                              pat, patLen);
+    }
+#endif
     return (patLen > 128 && IsSame<TextChar, PatChar>::value)
            ? Matcher<MemCmp<TextChar, PatChar>, TextChar, PatChar>(text, textLen, pat, patLen)
            : Matcher<ManualCmp<TextChar, PatChar>, TextChar, PatChar>(text, textLen, pat, patLen);
@@ -53,6 +53,7 @@
 #include "js/UbiNode.h"
 #include "js/UbiNodeBreadthFirst.h"
 #include "js/UbiNodeShortestPaths.h"
+#include "js/UbiNodeSnapshot.h"
 #include "js/UniquePtr.h"
 #include "js/Vector.h"
 #include "js/Wrapper.h"
@@ -66,12 +67,14 @@
 #include "vm/Iteration.h"
 #include "vm/JSContext.h"
 #include "vm/JSObject.h"
+#include "vm/JSONPrinter.h"
 #include "vm/ProxyObject.h"
 #include "vm/SavedStacks.h"
 #include "vm/Stack.h"
 #include "vm/StringType.h"
 #include "vm/TraceLogging.h"
 #include "wasm/AsmJS.h"
+#include "wasm/WasmInstance.h"
 #include "wasm/WasmJS.h"
 #include "wasm/WasmModule.h"
 #include "wasm/WasmSignalHandlers.h"
@@ -462,7 +465,13 @@ MinorGC(JSContext* cx, unsigned argc, Value* vp)
     _("allocationThreshold",        JSGC_ALLOCATION_THRESHOLD,           true)  \
     _("minEmptyChunkCount",         JSGC_MIN_EMPTY_CHUNK_COUNT,          true)  \
     _("maxEmptyChunkCount",         JSGC_MAX_EMPTY_CHUNK_COUNT,          true)  \
-    _("compactingEnabled",          JSGC_COMPACTING_ENABLED,             true)
+    _("compactingEnabled",          JSGC_COMPACTING_ENABLED,             true)  \
+    _("markingThreadCount",         JSGC_MARKING_THREAD_COUNT,           true)  \
+    _("tenuringThreadCount",        JSGC_TENURING_THREAD_COUNT,          true)  \
+    _("nurseryPauseTarget",         JSGC_NURSERY_PAUSE_TARGET,           true)  \
+    _("memoryPressure",             JSGC_MEMORY_PRESSURE,                true)  \
+    _("hugePages",                  JSGC_HUGE_PAGES,                     true)  \
+    _("numaLocalChunks",            JSGC_NUMA_LOCAL_CHUNKS,              true)
 
 static const struct ParamInfo {
     const char*     name;
@@ -899,6 +908,65 @@ WasmHasTier2CompilationCompleted(JSContext* cx, unsigned argc, Value* vp)
     return true;
 }
 
+static bool
+WasmFunctionCounts(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    if (!args.get(0).isObject()) {
+        JS_ReportErrorASCII(cx, "argument is not an object");
+        return false;
+    }
+
+    JSObject* unwrapped = CheckedUnwrap(&args.get(0).toObject());
+    if (!unwrapped || !unwrapped->is<WasmInstanceObject>()) {
+        JS_ReportErrorASCII(cx, "argument is not a WebAssembly.Instance");
+        return false;
+    }
+
+    const wasm::Instance& instance = unwrapped->as<WasmInstanceObject>().instance();
+    if (!instance.hasFuncCallCounts()) {
+        args.rval().setNull();
+        return true;
+    }
+
+    const wasm::MetadataTier& metadataTier = instance.metadata(instance.code().stableTier());
+    uint32_t numFuncImports = metadataTier.funcImports.length();
+    uint32_t numFuncs = metadataTier.funcToCodeRange.length();
+
+    RootedObject counts(cx, JS_NewArrayObject(cx, 0));
+    if (!counts) {
+        return false;
+    }
+
+    constexpr unsigned propAttrs = JSPROP_ENUMERATE;
+    for (uint32_t funcIndex = numFuncImports; funcIndex < numFuncs; funcIndex++) {
+        RootedObject entry(cx, JS_NewPlainObject(cx));
+        if (!entry) {
+            return false;
+        }
+
+        RootedString name(cx, instance.getFuncDisplayAtom(cx, funcIndex));
+        if (!name) {
+            return false;
+        }
+
+        if (!JS_DefineProperty(cx, entry, "index", funcIndex, propAttrs) ||
+            !JS_DefineProperty(cx, entry, "name", name, propAttrs) ||
+            !JS_DefineProperty(cx, entry, "count", instance.funcCallCount(funcIndex), propAttrs))
+        {
+            return false;
+        }
+
+        if (!JS_SetElement(cx, counts, funcIndex - numFuncImports, entry)) {
+            return false;
+        }
+    }
+
+    args.rval().setObject(*counts);
+    return true;
+}
+
 static bool
 IsLazyFunction(JSContext* cx, unsigned argc, Value* vp)
 {
@@ -2450,6 +2518,52 @@ DumpHeap(JSContext* cx, unsigned argc, Value* vp)
     return true;
 }
 
+static bool
+WriteHeapSnapshot(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    if (!args.requireAtLeast(cx, "writeHeapSnapshot", 1)) {
+        return false;
+    }
+    if (!args[0].isString()) {
+        JS_ReportErrorASCII(cx, "writeHeapSnapshot: filename expected");
+        return false;
+    }
+    bool wantNames = args.get(1).isUndefined() || ToBoolean(args[1]);
+
+    RootedString str(cx, args[0].toString());
+    UniqueChars fileName = JS_EncodeStringToUTF8(cx, str);
+    if (!fileName) {
+        return false;
+    }
+    FILE* fp = fopen(fileName.get(), "wb");
+    if (!fp) {
+        JS_ReportErrorUTF8(cx, "can't open %s", fileName.get());
+        return false;
+    }
+
+    bool ok;
+    {
+        Maybe<JS::AutoCheckCannotGC> maybeNoGC;
+        JS::ubi::RootList rootList(cx, maybeNoGC, wantNames);
+        ok = rootList.init() &&
+             JS::ubi::WriteHeapSnapshot(cx, JS::ubi::Node(&rootList), fp,
+                                        cx->runtime()->debuggerMallocSizeOf, wantNames,
+                                        maybeNoGC.ref());
+    }
+
+    if (fclose(fp) != 0) {
+        ok = false;
+    }
+    if (!ok) {
+        JS_ReportErrorUTF8(cx, "failed to write a heap snapshot to %s", fileName.get());
+        return false;
+    }
+
+    args.rval().setUndefined();
+    return true;
+}
+
 static bool
 Terminate(JSContext* cx, unsigned arg, Value* vp)
 {
@@ -3159,6 +3273,22 @@ Serialize(JSContext* cx, unsigned argc, Value* vp)
             }
         }
 
+        if (!JS_GetProperty(cx, opts, "detachArrayBuffersAtLeast", &v)) {
+            return false;
+        }
+
+        if (!v.isUndefined()) {
+            double nbytes;
+            if (!ToNumber(cx, v, &nbytes)) {
+                return false;
+            }
+            if (!(nbytes >= 0)) {
+                JS_ReportErrorASCII(cx, "Invalid value for 'detachArrayBuffersAtLeast'");
+                return false;
+            }
+            policy.detachArrayBuffersAtLeast(nbytes < double(SIZE_MAX) ? size_t(nbytes) : SIZE_MAX);
+        }
+
         if (!JS_GetProperty(cx, opts, "scope", &v)) {
             return false;
         }
@@ -3346,6 +3476,40 @@ DisableTraceLogger(JSContext* cx, unsigned argc, Value* vp)
 
     return true;
 }
+
+static bool
+DumpTraceLoggerRingBuffer(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    double seconds = mozilla::PositiveInfinity<double>();
+    if (args.length() > 0 && !ToNumber(cx, args[0], &seconds)) {
+        return false;
+    }
+
+    Sprinter sprinter(cx);
+    if (!sprinter.init()) {
+        return false;
+    }
+
+    TraceLoggerThread* logger = TraceLoggerForCurrentThread(cx);
+    if (logger && !logger->dumpRingBuffer(sprinter, seconds)) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+    if (sprinter.hadOutOfMemory()) {
+        return false;
+    }
+
+    JSString* str = JS_NewStringCopyZ(cx, sprinter.string());
+    if (!str) {
+        return false;
+    }
+
+    args.rval().setString(str);
+    return true;
+}
 #endif
 
 #if defined(DEBUG) || defined(JS_JITSPEW)
@@ -4538,6 +4702,236 @@ GetLcovInfo(JSContext* cx, unsigned argc, Value* vp)
     return true;
 }
 
+struct BailoutCountsPrinter
+{
+    Sprinter& sprinter;
+    JSONPrinter json;
+
+    explicit BailoutCountsPrinter(Sprinter& sprinter)
+      : sprinter(sprinter), json(sprinter)
+    {}
+
+    void scriptProperties(JSScript* script) {
+        json.beginStringProperty("filename");
+        if (const char* filename = script->filename()) {
+            for (const char* p = filename; *p; p++) {
+                if (*p == '"' || *p == '\\') {
+                    sprinter.putChar('\\');
+                }
+                if (uint8_t(*p) >= ' ') {
+                    sprinter.putChar(*p);
+                }
+            }
+        }
+        json.endStringProperty();
+        json.property("line", uint32_t(script->lineno()));
+        json.property("column", uint32_t(script->column()));
+    }
+};
+
+static void
+PrintBailoutSite(void* data, JSScript* script, uint32_t pcOffset, const char* kind,
+                 uint32_t count)
+{
+    BailoutCountsPrinter* printer = static_cast<BailoutCountsPrinter*>(data);
+    printer->json.beginObject();
+    printer->scriptProperties(script);
+    printer->json.property("pcOffset", pcOffset);
+    printer->json.property("kind", kind);
+    printer->json.property("count", count);
+    printer->json.endObject();
+}
+
+static void
+PrintInvalidation(void* data, JSScript* script, uint32_t count)
+{
+    BailoutCountsPrinter* printer = static_cast<BailoutCountsPrinter*>(data);
+    printer->json.beginObject();
+    printer->scriptProperties(script);
+    printer->json.property("count", count);
+    printer->json.endObject();
+}
+
+static bool
+GetAgedJitCodeBytesDiscarded(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    args.rval().setNumber(double(js::GetAgedJitCodeBytesDiscarded(cx)));
+    return true;
+}
+
+static bool
+GetNewObjectCacheStats(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    RootedObject obj(cx, JS_NewPlainObject(cx));
+    if (!obj) {
+        return false;
+    }
+
+    const NewObjectCache& cache = cx->runtime()->caches().newObjectCache;
+    RootedValue value(cx);
+    value.setNumber(double(cache.hitCount()));
+    if (!JS_DefineProperty(cx, obj, "hits", value, JSPROP_ENUMERATE)) {
+        return false;
+    }
+    value.setNumber(double(cache.missCount()));
+    if (!JS_DefineProperty(cx, obj, "misses", value, JSPROP_ENUMERATE)) {
+        return false;
+    }
+    value.setNumber(double(cache.sets()));
+    if (!JS_DefineProperty(cx, obj, "sets", value, JSPROP_ENUMERATE)) {
+        return false;
+    }
+
+    args.rval().setObject(*obj);
+    return true;
+}
+
+static bool
+GetCompilationCacheStats(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    RootedObject obj(cx, JS_NewPlainObject(cx));
+    if (!obj) {
+        return false;
+    }
+
+    const CompilationCache& cache = cx->runtime()->caches().compilationCache;
+    RootedValue value(cx);
+    value.setNumber(double(cache.hitCount()));
+    if (!JS_DefineProperty(cx, obj, "hits", value, JSPROP_ENUMERATE)) {
+        return false;
+    }
+    value.setNumber(double(cache.missCount()));
+    if (!JS_DefineProperty(cx, obj, "misses", value, JSPROP_ENUMERATE)) {
+        return false;
+    }
+    value.setNumber(double(cache.count()));
+    if (!JS_DefineProperty(cx, obj, "entries", value, JSPROP_ENUMERATE)) {
+        return false;
+    }
+
+    args.rval().setObject(*obj);
+    return true;
+}
+
+static bool
+SetNewObjectCacheSets(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    uint32_t sets;
+    if (!ToUint32(cx, args.get(0), &sets)) {
+        return false;
+    }
+
+    cx->runtime()->caches().newObjectCache.setNumSets(sets);
+    args.rval().setUndefined();
+    return true;
+}
+
+static bool
+GetGCHistograms(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    GCHistogramFormat format = GCHistogramFormat::JSON;
+    if (args.length() > 0) {
+        RootedString str(cx, ToString(cx, args[0]));
+        if (!str) {
+            return false;
+        }
+        bool isPrometheus;
+        if (!JS_StringEqualsAscii(cx, str, "prometheus", &isPrometheus)) {
+            return false;
+        }
+        bool isJson;
+        if (!JS_StringEqualsAscii(cx, str, "json", &isJson)) {
+            return false;
+        }
+        if (!isPrometheus && !isJson) {
+            JS_ReportErrorASCII(cx, "gcHistograms: format must be 'json' or 'prometheus'");
+            return false;
+        }
+        if (isPrometheus) {
+            format = GCHistogramFormat::Prometheus;
+        }
+    }
+
+    UniqueChars chars = js::RenderGCHistograms(cx, format);
+    if (!chars) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+    JSString* str = JS_NewStringCopyZ(cx, chars.get());
+    if (!str) {
+        return false;
+    }
+
+    args.rval().setString(str);
+    return true;
+}
+
+static bool
+GetNurseryProfile(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    JSRuntime* rt = cx->runtime();
+    UniqueChars chars = rt->gc.stats().renderNurseryJson(rt);
+    if (!chars) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+    JSString* str = JS_NewStringCopyZ(cx, chars.get());
+    if (!str) {
+        return false;
+    }
+
+    args.rval().setString(str);
+    return true;
+}
+
+static bool
+GetBailoutCounts(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    Sprinter sprinter(cx);
+    if (!sprinter.init()) {
+        return false;
+    }
+
+    {
+        BailoutCountsPrinter printer(sprinter);
+        printer.json.beginObject();
+        printer.json.beginListProperty("bailouts");
+        js::IterateBailoutCounts(cx, &printer, PrintBailoutSite, nullptr);
+        printer.json.endList();
+        printer.json.beginListProperty("invalidations");
+        js::IterateBailoutCounts(cx, &printer, nullptr, PrintInvalidation);
+        printer.json.endList();
+        printer.json.endObject();
+    }
+
+    if (sprinter.hadOutOfMemory()) {
+        return false;
+    }
+
+    JSString* str = JS_NewStringCopyZ(cx, sprinter.string());
+    if (!str) {
+        return false;
+    }
+
+    args.rval().setString(str);
+    return true;
+}
+
 #ifdef DEBUG
 static bool
 SetRNGState(JSContext* cx, unsigned argc, Value* vp)
@@ -6005,6 +6399,12 @@ gc::ZealModeHelpText),
 "  Returns a boolean indicating whether a given module has finished compiled code for tier2. \n"
 "This will return true early if compilation isn't two-tiered. "),
 
+    JS_FN_HELP("wasmFunctionCounts", WasmFunctionCounts, 1, 0,
+"wasmFunctionCounts(instance)",
+"  Returns an array with the index, name and number of calls of each function\n"
+"  defined by the module of the given WebAssembly.Instance, or null if the module\n"
+"  was compiled without --wasm-function-counts."),
+
     JS_FN_HELP("wasmGcEnabled", WasmGcEnabled, 1, 0,
 "wasmGcEnabled(bool)",
 "  Returns a boolean indicating whether the WebAssembly GC support is enabled."),
@@ -6065,6 +6465,8 @@ gc::ZealModeHelpText),
 "  clone buffer object. 'policy' may be an options hash. Valid keys:\n"
 "    'SharedArrayBuffer' - either 'allow' (the default) or 'deny'\n"
 "      to specify whether SharedArrayBuffers may be serialized.\n"
+"    'detachArrayBuffersAtLeast' - a byte length. ArrayBuffers at least this\n"
+"      long are detached into same-process clone buffers instead of copied.\n"
 "    'scope' - SameProcessSameThread, SameProcessDifferentThread,\n"
 "      DifferentProcess, or DifferentProcessForIndexedDB. Determines how some\n"
 "      values will be serialized. Clone buffers may only be deserialized with a\n"
@@ -6103,6 +6505,12 @@ gc::ZealModeHelpText),
     JS_FN_HELP("stopTraceLogger", DisableTraceLogger, 0, 0,
 "stopTraceLogger()",
 "  Stop logging this thread."),
+
+    JS_FN_HELP("dumpTraceLoggerRingBuffer", DumpTraceLoggerRingBuffer, 1, 0,
+"dumpTraceLoggerRingBuffer([seconds])",
+"  Return the events of this thread's trace logger ring buffer (see\n"
+"  TLOPTIONS=RingBuffer) from the last seconds, or all of them, one per line.\n"
+"  Each line has a time in microseconds and the event's text."),
 #endif
 
     JS_FN_HELP("reportOutOfMemory", ReportOutOfMemory, 0, 0,
@@ -6248,6 +6656,45 @@ gc::ZealModeHelpText),
 "  Generate LCOV tracefile for the given compartment.  If no global are provided then\n"
 "  the current global is used as the default one.\n"),
 
+    JS_FN_HELP("agedJitCodeBytesDiscarded", GetAgedJitCodeBytesDiscarded, 0, 0,
+"agedJitCodeBytesDiscarded()",
+"  Return the number of bytes of JIT code discarded so far because its script\n"
+"  had not run for the last jitCodeDiscardAge GCs.\n"),
+
+    JS_FN_HELP("newObjectCacheStats", GetNewObjectCacheStats, 0, 0,
+"newObjectCacheStats()",
+"  Return an object with the number of objects created from NewObjectCache hits,\n"
+"  the number of entries filled after misses, and the number of sets.\n"),
+
+    JS_FN_HELP("compilationCacheStats", GetCompilationCacheStats, 0, 0,
+"compilationCacheStats()",
+"  Return an object with the number of indirect evals and Function() calls\n"
+"  which reused cached code, the number which compiled it, and the number of\n"
+"  entries in the cache.\n"),
+
+    JS_FN_HELP("setNewObjectCacheSets", SetNewObjectCacheSets, 1, 0,
+"setNewObjectCacheSets(n)",
+"  Resize NewObjectCache to n sets of two entries, rounded down to a power of\n"
+"  two and clamped to [1, 64], and empty it.\n"),
+
+    JS_FN_HELP("gcHistograms", GetGCHistograms, 1, 0,
+"gcHistograms([format])",
+"  Return the histograms of GC slice pauses, nursery collection times, bytes\n"
+"  tenured by nursery collections and time spent in each GC phase kind since\n"
+"  the runtime was created, as a JSON string or, if format is 'prometheus', in\n"
+"  the Prometheus text exposition format.\n"),
+
+    JS_FN_HELP("nurseryProfile", GetNurseryProfile, 0, 0,
+"nurseryProfile()",
+"  Return a JSON string describing the last nursery collection: its reason,\n"
+"  the bytes and cells tenured, the nursery's capacity and the time spent in\n"
+"  each of its phases.\n"),
+
+    JS_FN_HELP("getBailoutCounts", GetBailoutCounts, 0, 0,
+"getBailoutCounts()",
+"  Return a JSON string with the bailouts of Ion code so far, by script, bytecode\n"
+"  offset and bailout kind, and the number of invalidations of each script.\n"),
+
 #ifdef DEBUG
     JS_FN_HELP("setRNGState", SetRNGState, 2, 0,
 "setRNGState(seed0, seed1)",
@@ -6335,6 +6782,12 @@ static const JSFunctionSpecWithHelp FuzzingUnsafeTestingFunctions[] = {
 "getErrorNotes(error)",
 "  Returns an array of error notes."),
 
+    JS_FN_HELP("writeHeapSnapshot", WriteHeapSnapshot, 2, 0,
+"writeHeapSnapshot(filename, [wantNames])",
+"  Write everything reachable from the GC roots to the named file, in the\n"
+"  streaming format described in js/UbiNodeSnapshot.h. Edge names are\n"
+"  included unless wantNames is false."),
+
     JS_FN_HELP("setTimeZone", SetTimeZone, 1, 0,
 "setTimeZone(tzname)",
 "  Set the 'TZ' environment variable to the given time zone and applies the new time zone.\n"
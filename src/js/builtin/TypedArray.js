@@ -346,9 +346,7 @@ function TypedArrayFill(value, start = 0, end = undefined) {
         ThrowTypeError(JSMSG_TYPED_ARRAY_DETACHED);
 
     // Step 10.
-    for (; k < final; k++) {
-        O[k] = value;
-    }
+    TypedArrayNativeFill(O, value, k, final);
 
     // Step 11.
     return O;
@@ -577,15 +575,9 @@ function TypedArrayIndexOf(searchElement, fromIndex = 0) {
             k = 0;
     }
 
-    // Step 12.
+    // Steps 12-13.
     // Omit steps a-b, since there are no holes in typed arrays.
-    for (; k < len; k++) {
-        if (O[k] === searchElement)
-            return k;
-    }
-
-    // Step 13.
-    return -1;
+    return TypedArrayNativeIndexOf(O, searchElement, k);
 }
 
 // ES6 draft rev30 (2014/12/24) 22.2.3.14 %TypedArray%.prototype.join(separator).
@@ -681,15 +673,11 @@ function TypedArrayLastIndexOf(searchElement/*, fromIndex*/) {
     // Steps 9-10.
     var k = n >= 0 ? std_Math_min(n, len - 1) : len + n;
 
-    // Step 11.
+    // Steps 11-12.
     // Omit steps a-b, since there are no holes in typed arrays.
-    for (; k >= 0; k--) {
-        if (O[k] === searchElement)
-            return k;
-    }
-
-    // Step 12.
-    return -1;
+    if (k < 0)
+        return -1;
+    return TypedArrayNativeLastIndexOf(O, searchElement, k);
 }
 
 // ES2017 draft rev 6859bb9ccaea9c6ede81d71e5320e3833b92cb3e
@@ -1191,6 +1179,9 @@ function TypedArraySort(comparefn) {
         return obj;
 
     if (comparefn === undefined) {
+        if (isTypedArray)
+            return TypedArrayNativeSort(obj);
+
         var kind = GetTypedArrayKind(obj);
         switch (kind) {
           case TYPEDARRAY_KIND_UINT8:
@@ -1424,18 +1415,13 @@ function TypedArrayIncludes(searchElement, fromIndex = 0) {
             k = 0;
     }
 
-    // Step 10.
-    while (k < len) {
-        // Steps a-c.
-        if (SameValueZero(searchElement, O[k]))
-            return true;
-
-        // Step d.
-        k++;
-    }
+    // If the buffer was detached while converting fromIndex, all the
+    // elements read as undefined.
+    if (IsDetachedBuffer(ViewedArrayBufferIfReified(O)))
+        return searchElement === undefined && k < len;
 
-    // Step 11.
-    return false;
+    // Steps 10-11.
+    return TypedArrayNativeIncludes(O, searchElement, k);
 }
 
 // ES2017 draft rev 6859bb9ccaea9c6ede81d71e5320e3833b92cb3e
@@ -247,6 +247,7 @@ ScalarTypeDescr::typeName(Type type)
         JS_FOR_EACH_SCALAR_TYPE_REPR(NUMERIC_TYPE_TO_STRING)
 #undef NUMERIC_TYPE_TO_STRING
       case Scalar::Int64:
+      case Scalar::Simd128:
       case Scalar::MaxTypedArrayViewType:
         break;
     }
@@ -286,6 +287,7 @@ ScalarTypeDescr::call(JSContext* cx, unsigned argc, Value* vp)
         JS_FOR_EACH_SCALAR_TYPE_REPR(SCALARTYPE_CALL)
 #undef SCALARTYPE_CALL
       case Scalar::Int64:
+      case Scalar::Simd128:
       case Scalar::MaxTypedArrayViewType:
         MOZ_CRASH();
     }
@@ -2692,6 +2694,33 @@ js::ClampToUint8(JSContext*, unsigned argc, Value* vp)
     return true;
 }
 
+bool
+js::TypedObjectCopyBytes(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 4);
+    MOZ_ASSERT(args[0].isObject() && args[0].toObject().is<TypedObject>());
+    MOZ_ASSERT(args[1].isInt32());
+    MOZ_ASSERT(args[2].isObject() && args[2].toObject().is<TypedObject>());
+    MOZ_ASSERT(args[3].isInt32());
+
+    TypedObject& target = args[0].toObject().as<TypedObject>();
+    int32_t targetOffset = args[1].toInt32();
+    TypedObject& source = args[2].toObject().as<TypedObject>();
+    int32_t size = args[3].toInt32();
+
+    /* Should be guaranteed by the self-hosted caller: */
+    MOZ_ASSERT(target.isAttached() && source.isAttached());
+    MOZ_ASSERT(!source.opaque());
+    MOZ_ASSERT(uint32_t(size) <= source.size());
+    MOZ_ASSERT(uint32_t(targetOffset) + uint32_t(size) <= target.size());
+
+    JS::AutoCheckCannotGC nogc(cx);
+    memmove(target.typedMem(targetOffset, nogc), source.typedMem(nogc), size);
+    args.rval().setUndefined();
+    return true;
+}
+
 bool
 js::GetTypedObjectModule(JSContext* cx, unsigned argc, Value* vp)
 {
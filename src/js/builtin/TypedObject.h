@@ -875,6 +875,14 @@ MOZ_MUST_USE bool TypedObjectTypeDescr(JSContext* cx, unsigned argc, Value* vp);
  */
 MOZ_MUST_USE bool ClampToUint8(JSContext* cx, unsigned argc, Value* vp);
 
+/*
+ * Usage: TypedObjectCopyBytes(targetObj, targetOffset, sourceObj, size)
+ *
+ * Copies `size` bytes from the start of the attached transparent typed
+ * object `sourceObj` to `targetObj` at `targetOffset`. The two may overlap.
+ */
+MOZ_MUST_USE bool TypedObjectCopyBytes(JSContext* cx, unsigned argc, Value* vp);
+
 /*
  * Usage: GetTypedObjectModule()
  *
@@ -146,6 +146,16 @@ function TypedObjectSet(descr, typedObj, offset, name, fromValue) {
   if (!TypedObjectIsAttached(typedObj))
     ThrowTypeError(JSMSG_TYPEDOBJECT_HANDLE_UNATTACHED);
 
+  // Typed objects of an equivalent type without references have the same
+  // layout, so copy their bytes instead of adapting each field and element.
+  if (IsObject(fromValue) && ObjectIsTransparentTypedObject(fromValue) &&
+      DescrsEquiv(descr, TypedObjectTypeDescr(fromValue))) {
+    if (!TypedObjectIsAttached(fromValue))
+      ThrowTypeError(JSMSG_TYPEDOBJECT_HANDLE_UNATTACHED);
+    TypedObjectCopyBytes(typedObj, offset, fromValue, DESCR_SIZE(descr));
+    return;
+  }
+
   switch (DESCR_KIND(descr)) {
   case JS_TYPEREPR_SCALAR_KIND:
     TypedObjectSetScalar(descr, typedObj, offset, fromValue);
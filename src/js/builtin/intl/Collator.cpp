@@ -50,7 +50,7 @@ const ClassOps CollatorObject::classOps_ = {
 const Class CollatorObject::class_ = {
     js_Object_str,
     JSCLASS_HAS_RESERVED_SLOTS(CollatorObject::SLOT_COUNT) |
-    JSCLASS_FOREGROUND_FINALIZE,
+    JSCLASS_BACKGROUND_FINALIZE,
     &CollatorObject::classOps_
 };
 
@@ -142,8 +142,6 @@ js::intl_Collator(JSContext* cx, unsigned argc, Value* vp)
 void
 js::CollatorObject::finalize(FreeOp* fop, JSObject* obj)
 {
-    MOZ_ASSERT(fop->onMainThread());
-
     const Value& slot = obj->as<CollatorObject>().getReservedSlot(CollatorObject::UCOLLATOR_SLOT);
     if (UCollator* coll = static_cast<UCollator*>(slot.toPrivate())) {
         ucol_close(coll);
@@ -418,6 +416,24 @@ NewUCollator(JSContext* cx, Handle<CollatorObject*> collator)
         }
     }
 
+    SharedIntlData::ICUCacheKey key;
+    if (!key.append(locale.get(), strlen(locale.get())) ||
+        !key.append(u'\0') ||
+        !key.append(char16_t(uStrength)) ||
+        !key.append(char16_t(uCaseLevel)) ||
+        !key.append(char16_t(uAlternate)) ||
+        !key.append(char16_t(uNumeric)) ||
+        !key.append(char16_t(uCaseFirst)))
+    {
+        ReportOutOfMemory(cx);
+        return nullptr;
+    }
+
+    SharedIntlData& sharedIntlData = cx->runtime()->sharedIntlData.ref();
+    if (UCollator* coll = sharedIntlData.cloneCachedCollator(key)) {
+        return coll;
+    }
+
     UErrorCode status = U_ZERO_ERROR;
     UCollator* coll = ucol_open(IcuLocale(locale.get()), &status);
     if (U_FAILURE(status)) {
@@ -437,6 +453,7 @@ NewUCollator(JSContext* cx, Handle<CollatorObject*> collator)
         return nullptr;
     }
 
+    sharedIntlData.cacheCollator(std::move(key), coll);
     return coll;
 }
 
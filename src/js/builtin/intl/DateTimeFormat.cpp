@@ -56,7 +56,7 @@ const ClassOps DateTimeFormatObject::classOps_ = {
 const Class DateTimeFormatObject::class_ = {
     js_Object_str,
     JSCLASS_HAS_RESERVED_SLOTS(DateTimeFormatObject::SLOT_COUNT) |
-    JSCLASS_FOREGROUND_FINALIZE,
+    JSCLASS_BACKGROUND_FINALIZE,
     &DateTimeFormatObject::classOps_
 };
 
@@ -165,8 +165,6 @@ js::intl_DateTimeFormat(JSContext* cx, unsigned argc, Value* vp)
 void
 js::DateTimeFormatObject::finalize(FreeOp* fop, JSObject* obj)
 {
-    MOZ_ASSERT(fop->onMainThread());
-
     const Value& slot =
         obj->as<DateTimeFormatObject>().getReservedSlot(DateTimeFormatObject::UDATE_FORMAT_SLOT);
     if (UDateFormat* df = static_cast<UDateFormat*>(slot.toPrivate())) {
@@ -718,6 +716,22 @@ NewUDateFormat(JSContext* cx, Handle<DateTimeFormatObject*> dateTimeFormat)
 
     mozilla::Range<const char16_t> patternChars = pattern.twoByteRange();
 
+    SharedIntlData::ICUCacheKey key;
+    if (!key.append(locale.get(), strlen(locale.get())) ||
+        !key.append(u'\0') ||
+        !key.append(timeZoneChars.begin().get(), timeZoneChars.length()) ||
+        !key.append(u'\0') ||
+        !key.append(patternChars.begin().get(), patternChars.length()))
+    {
+        ReportOutOfMemory(cx);
+        return nullptr;
+    }
+
+    SharedIntlData& sharedIntlData = cx->runtime()->sharedIntlData.ref();
+    if (UDateFormat* df = sharedIntlData.cloneCachedDateFormat(key)) {
+        return df;
+    }
+
     UErrorCode status = U_ZERO_ERROR;
     UDateFormat* df =
         udat_open(UDAT_PATTERN, UDAT_PATTERN, IcuLocale(locale.get()),
@@ -735,6 +749,7 @@ NewUDateFormat(JSContext* cx, Handle<DateTimeFormatObject*> dateTimeFormat)
 
     // An error here means the calendar is not Gregorian, so we don't care.
 
+    sharedIntlData.cacheDateFormat(std::move(key), df);
     return df;
 }
 
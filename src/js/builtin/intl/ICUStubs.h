@@ -178,6 +178,12 @@ ucol_close(UCollator* coll)
     MOZ_CRASH("ucol_close: Intl API disabled");
 }
 
+inline UCollator*
+ucol_safeClone(const UCollator* coll, void* stackBuffer, int32_t* pBufferSize, UErrorCode* status)
+{
+    MOZ_CRASH("ucol_safeClone: Intl API disabled");
+}
+
 inline UEnumeration*
 ucol_getKeywordValuesForLocale(const char* key, const char* locale, UBool commonlyUsed,
                                UErrorCode* status)
@@ -271,6 +277,12 @@ unum_close(UNumberFormat* fmt)
     MOZ_CRASH("unum_close: Intl API disabled");
 }
 
+inline UNumberFormat*
+unum_clone(const UNumberFormat* fmt, UErrorCode* status)
+{
+    MOZ_CRASH("unum_clone: Intl API disabled");
+}
+
 inline void
 unum_setTextAttribute(UNumberFormat* fmt, UNumberFormatTextAttribute tag, const UChar* newValue,
                       int32_t newValueLength, UErrorCode* status)
@@ -643,6 +655,12 @@ udat_close(UDateFormat* format)
     MOZ_CRASH("udat_close: Intl API disabled");
 }
 
+inline UDateFormat*
+udat_clone(const UDateFormat* format, UErrorCode* status)
+{
+    MOZ_CRASH("udat_clone: Intl API disabled");
+}
+
 inline int32_t
 udat_getSymbols(const UDateFormat *fmt, UDateFormatSymbolType type, int32_t symbolIndex,
                 UChar *result, int32_t resultLength, UErrorCode *status)
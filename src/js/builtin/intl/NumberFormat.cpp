@@ -18,6 +18,7 @@
 #include "builtin/intl/CommonFunctions.h"
 #include "builtin/intl/ICUStubs.h"
 #include "builtin/intl/ScopedICUObject.h"
+#include "builtin/intl/SharedIntlData.h"
 #include "ds/Sort.h"
 #include "gc/FreeOp.h"
 #include "js/CharacterEncoding.h"
@@ -25,6 +26,7 @@
 #include "js/StableStringChars.h"
 #include "js/TypeDecls.h"
 #include "vm/JSContext.h"
+#include "vm/Runtime.h"
 #include "vm/SelfHosting.h"
 #include "vm/Stack.h"
 
@@ -42,6 +44,7 @@ using js::intl::CallICU;
 using js::intl::DateTimeFormatOptions;
 using js::intl::GetAvailableLocales;
 using js::intl::IcuLocale;
+using js::intl::SharedIntlData;
 
 using JS::AutoStableStringChars;
 
@@ -58,7 +61,7 @@ const ClassOps NumberFormatObject::classOps_ = {
 const Class NumberFormatObject::class_ = {
     js_Object_str,
     JSCLASS_HAS_RESERVED_SLOTS(NumberFormatObject::SLOT_COUNT) |
-    JSCLASS_FOREGROUND_FINALIZE,
+    JSCLASS_BACKGROUND_FINALIZE,
     &NumberFormatObject::classOps_
 };
 
@@ -152,8 +155,6 @@ js::intl_NumberFormat(JSContext* cx, unsigned argc, Value* vp)
 void
 js::NumberFormatObject::finalize(FreeOp* fop, JSObject* obj)
 {
-    MOZ_ASSERT(fop->onMainThread());
-
     const Value& slot =
         obj->as<NumberFormatObject>().getReservedSlot(NumberFormatObject::UNUMBER_FORMAT_SLOT);
     if (UNumberFormat* nf = static_cast<UNumberFormat*>(slot.toPrivate())) {
@@ -377,6 +378,27 @@ NewUNumberFormat(JSContext* cx, Handle<NumberFormatObject*> numberFormat)
     }
     uUseGrouping = value.toBoolean();
 
+    SharedIntlData::ICUCacheKey key;
+    if (!key.append(locale.get(), strlen(locale.get())) ||
+        !key.append(u'\0') ||
+        !key.append(char16_t(uStyle)) ||
+        !(uCurrency ? key.append(uCurrency, 3) : key.append(u'\0')) ||
+        !key.append(char16_t(uMinimumIntegerDigits)) ||
+        !key.append(char16_t(uMinimumFractionDigits)) ||
+        !key.append(char16_t(uMaximumFractionDigits)) ||
+        !key.append(char16_t(uMinimumSignificantDigits)) ||
+        !key.append(char16_t(uMaximumSignificantDigits)) ||
+        !key.append(char16_t(uUseGrouping)))
+    {
+        ReportOutOfMemory(cx);
+        return nullptr;
+    }
+
+    SharedIntlData& sharedIntlData = cx->runtime()->sharedIntlData.ref();
+    if (UNumberFormat* nf = sharedIntlData.cloneCachedNumberFormat(key)) {
+        return nf;
+    }
+
     UErrorCode status = U_ZERO_ERROR;
     UNumberFormat* nf = unum_open(uStyle, nullptr, 0, IcuLocale(locale.get()), nullptr, &status);
     if (U_FAILURE(status)) {
@@ -404,6 +426,7 @@ NewUNumberFormat(JSContext* cx, Handle<NumberFormatObject*> numberFormat)
     unum_setAttribute(nf, UNUM_GROUPING_USED, uUseGrouping);
     unum_setAttribute(nf, UNUM_ROUNDING_MODE, UNUM_ROUND_HALFUP);
 
+    sharedIntlData.cacheNumberFormat(std::move(key), nf);
     return toClose.forget();
 }
 
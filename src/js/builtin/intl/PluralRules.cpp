@@ -44,7 +44,7 @@ const ClassOps PluralRulesObject::classOps_ = {
 const Class PluralRulesObject::class_ = {
     js_Object_str,
     JSCLASS_HAS_RESERVED_SLOTS(PluralRulesObject::SLOT_COUNT) |
-    JSCLASS_FOREGROUND_FINALIZE,
+    JSCLASS_BACKGROUND_FINALIZE,
     &PluralRulesObject::classOps_
 };
 
@@ -122,8 +122,6 @@ PluralRules(JSContext* cx, unsigned argc, Value* vp)
 void
 js::PluralRulesObject::finalize(FreeOp* fop, JSObject* obj)
 {
-    MOZ_ASSERT(fop->onMainThread());
-
     PluralRulesObject* pluralRules = &obj->as<PluralRulesObject>();
 
     const Value& prslot = pluralRules->getReservedSlot(PluralRulesObject::UPLURAL_RULES_SLOT);
@@ -10,6 +10,8 @@
 
 #include "mozilla/Assertions.h"
 #include "mozilla/HashFunctions.h"
+#include "mozilla/Move.h"
+#include "mozilla/PodOperations.h"
 #include "mozilla/TextUtils.h"
 
 #include <stdint.h>
@@ -400,6 +402,122 @@ js::intl::SharedIntlData::isUpperCaseFirst(JSContext* cx, HandleString locale, b
     return true;
 }
 
+static UCollator*
+CloneCollator(const UCollator* coll, UErrorCode* status)
+{
+    return ucol_safeClone(coll, nullptr, nullptr, status);
+}
+
+template<typename T, T* (*Clone)(const T*, UErrorCode*), typename Cache, typename Key>
+static T*
+CloneFromICUCache(Cache& cache, const Key& key)
+{
+    for (size_t i = 0; i < cache.length(); i++) {
+        const Key& entryKey = cache[i].key;
+        if (entryKey.length() != key.length() ||
+            !mozilla::PodEqual(entryKey.begin(), key.begin(), key.length()))
+        {
+            continue;
+        }
+
+        // Move the entry to the front, so the least recently used entry is
+        // always the last one.
+        for (size_t j = i; j > 0; j--) {
+            mozilla::Swap(cache[j], cache[j - 1]);
+        }
+
+        UErrorCode status = U_ZERO_ERROR;
+        T* clone = Clone(cache[0].object, &status);
+        if (U_FAILURE(status)) {
+            return nullptr;
+        }
+        return clone;
+    }
+    return nullptr;
+}
+
+template<typename T, T* (*Clone)(const T*, UErrorCode*), void (*Close)(T*),
+         typename Cache, typename Key>
+static void
+AddToICUCache(Cache& cache, size_t capacity, Key&& key, const T* object)
+{
+    UErrorCode status = U_ZERO_ERROR;
+    T* clone = Clone(object, &status);
+    if (U_FAILURE(status)) {
+        return;
+    }
+
+    if (cache.length() == capacity) {
+        Close(cache.back().object);
+        cache.popBack();
+    }
+
+    if (!cache.insert(cache.begin(), typename Cache::ElementType { std::move(key), clone })) {
+        Close(clone);
+    }
+}
+
+template<typename T, void (*Close)(T*), typename Cache>
+static void
+ClearICUCache(Cache& cache)
+{
+    for (auto& entry : cache) {
+        Close(entry.object);
+    }
+    cache.clearAndFree();
+}
+
+template<typename Cache>
+static size_t
+SizeOfICUCache(const Cache& cache, mozilla::MallocSizeOf mallocSizeOf)
+{
+    // The ICU objects are allocated by ICU and aren't measured.
+    size_t n = cache.sizeOfExcludingThis(mallocSizeOf);
+    for (const auto& entry : cache) {
+        n += entry.key.sizeOfExcludingThis(mallocSizeOf);
+    }
+    return n;
+}
+
+UCollator*
+js::intl::SharedIntlData::cloneCachedCollator(const ICUCacheKey& key)
+{
+    return CloneFromICUCache<UCollator, CloneCollator>(collatorCache, key);
+}
+
+UNumberFormat*
+js::intl::SharedIntlData::cloneCachedNumberFormat(const ICUCacheKey& key)
+{
+    return CloneFromICUCache<UNumberFormat, unum_clone>(numberFormatCache, key);
+}
+
+UDateFormat*
+js::intl::SharedIntlData::cloneCachedDateFormat(const ICUCacheKey& key)
+{
+    return CloneFromICUCache<UDateFormat, udat_clone>(dateFormatCache, key);
+}
+
+void
+js::intl::SharedIntlData::cacheCollator(ICUCacheKey&& key, const UCollator* coll)
+{
+    AddToICUCache<UCollator, CloneCollator, ucol_close>(collatorCache, ICUCacheCapacity,
+                                                        std::move(key), coll);
+}
+
+void
+js::intl::SharedIntlData::cacheNumberFormat(ICUCacheKey&& key, const UNumberFormat* nf)
+{
+    AddToICUCache<UNumberFormat, unum_clone, unum_close>(numberFormatCache, ICUCacheCapacity,
+                                                         std::move(key), nf);
+}
+
+void
+js::intl::SharedIntlData::cacheDateFormat(ICUCacheKey&& key, const UDateFormat* df)
+{
+    AddToICUCache<UDateFormat, udat_clone, udat_close>(dateFormatCache, ICUCacheCapacity,
+                                                       std::move(key), df);
+}
+
 void
 js::intl::SharedIntlData::destroyInstance()
 {
@@ -407,6 +525,9 @@ js::intl::SharedIntlData::destroyInstance()
     ianaZonesTreatedAsLinksByICU.clearAndCompact();
     ianaLinksCanonicalizedDifferentlyByICU.clearAndCompact();
     upperCaseFirstLocales.clearAndCompact();
+    ClearICUCache<UCollator, ucol_close>(collatorCache);
+    ClearICUCache<UNumberFormat, unum_close>(numberFormatCache);
+    ClearICUCache<UDateFormat, udat_close>(dateFormatCache);
 }
 
 void
@@ -427,5 +548,8 @@ js::intl::SharedIntlData::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf
     return availableTimeZones.shallowSizeOfExcludingThis(mallocSizeOf) +
            ianaZonesTreatedAsLinksByICU.shallowSizeOfExcludingThis(mallocSizeOf) +
            ianaLinksCanonicalizedDifferentlyByICU.shallowSizeOfExcludingThis(mallocSizeOf) +
-           upperCaseFirstLocales.shallowSizeOfExcludingThis(mallocSizeOf);
+           upperCaseFirstLocales.shallowSizeOfExcludingThis(mallocSizeOf) +
+           SizeOfICUCache(collatorCache, mallocSizeOf) +
+           SizeOfICUCache(numberFormatCache, mallocSizeOf) +
+           SizeOfICUCache(dateFormatCache, mallocSizeOf);
 }
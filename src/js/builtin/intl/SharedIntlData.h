@@ -17,8 +17,14 @@
 #include "js/GCHashTable.h"
 #include "js/RootingAPI.h"
 #include "js/Utility.h"
+#include "js/Vector.h"
 #include "vm/StringType.h"
 
+// ICU object types, declared as in the ICU headers.
+struct UCollator;
+typedef void* UNumberFormat;
+typedef void* UDateFormat;
+
 namespace js {
 
 namespace intl {
@@ -206,6 +212,60 @@ class SharedIntlData
      */
     bool isUpperCaseFirst(JSContext* cx, JS::Handle<JSString*> locale, bool* isUpperFirst);
 
+  public:
+    /**
+     * Key of a cached ICU object: the locale and the options the object was
+     * opened with, as built by the caller.
+     */
+    using ICUCacheKey = js::Vector<char16_t, 64, js::SystemAllocPolicy>;
+
+  private:
+    /**
+     * Opening an ICU collator or formatter is expensive, as it loads and
+     * parses the locale data, whereas cloning an existing object is cheap.
+     * Intl.Collator, Intl.NumberFormat and Intl.DateTimeFormat objects get a
+     * clone of a cached ICU object when one was opened with the same locale
+     * and options. This includes the objects created on each call of
+     * String.prototype.localeCompare, Number.prototype.toLocaleString and the
+     * Date.prototype.toLocale*String methods when they're called with locales
+     * or options.
+     *
+     * Each cache holds the most recently used objects, most recent first.
+     * SharedIntlData is only used on the main thread, so no locking is needed.
+     */
+    template<typename T>
+    struct ICUCacheEntry
+    {
+        ICUCacheKey key;
+        T* object;
+    };
+
+    template<typename T>
+    using ICUCache = js::Vector<ICUCacheEntry<T>, 0, js::SystemAllocPolicy>;
+
+    static const size_t ICUCacheCapacity = 8;
+
+    ICUCache<UCollator> collatorCache;
+    ICUCache<UNumberFormat> numberFormatCache;
+    ICUCache<UDateFormat> dateFormatCache;
+
+  public:
+    /**
+     * Returns a new clone of the cached object for |key|, which is then owned
+     * by the caller, or nullptr if there's no such object.
+     */
+    UCollator* cloneCachedCollator(const ICUCacheKey& key);
+    UNumberFormat* cloneCachedNumberFormat(const ICUCacheKey& key);
+    UDateFormat* cloneCachedDateFormat(const ICUCacheKey& key);
+
+    /**
+     * Adds a clone of an object the caller opened to the cache. Failures are
+     * ignored, as the cache is only an optimization.
+     */
+    void cacheCollator(ICUCacheKey&& key, const UCollator* coll);
+    void cacheNumberFormat(ICUCacheKey&& key, const UNumberFormat* nf);
+    void cacheDateFormat(ICUCacheKey&& key, const UDateFormat* df);
+
   public:
     void destroyInstance();
 
@@ -6767,20 +6767,36 @@ StructType::AddressOfField(JSContext* cx, unsigned argc, Value* vp)
 *******************************************************************************/
 
 // Helper class for handling allocation of function arguments.
+// Storage for an argument or return value of a call through a FunctionType.
+// Values no larger than a couple of words, which covers all the scalar types,
+// are stored inline, so most calls don't allocate.
 struct AutoValue
 {
   AutoValue() : mData(nullptr) { }
 
+  AutoValue(AutoValue&& other)
+    : mData(other.mData == other.mInline ? mInline : other.mData)
+  {
+    memcpy(mInline, other.mInline, sizeof(mInline));
+    other.mData = nullptr;
+  }
+
   ~AutoValue()
   {
-    js_free(mData);
+    if (mData != mInline) {
+      js_free(mData);
+    }
   }
 
   bool SizeToType(JSContext* cx, JSObject* type)
   {
     // Allocate a minimum of sizeof(ffi_arg) to handle small integers.
     size_t size = Align(CType::GetSize(type), sizeof(ffi_arg));
-    mData = js_malloc(size);
+    if (size <= sizeof(mInline)) {
+      mData = mInline;
+    } else {
+      mData = js_malloc(size);
+    }
     if (mData) {
       memset(mData, 0, size);
     }
@@ -6788,6 +6804,12 @@ struct AutoValue
   }
 
   void* mData;
+
+ private:
+  uint64_t mInline[2];
+
+  AutoValue(const AutoValue&) = delete;
+  void operator=(const AutoValue&) = delete;
 };
 
 static bool
@@ -7363,6 +7385,16 @@ FunctionType::Call(JSContext* cx,
     }
   }
 
+  // ffi_call takes an array of pointers to the argument values.
+  Vector<void*, 16, SystemAllocPolicy> argValues;
+  if (!argValues.reserve(values.length())) {
+    JS_ReportOutOfMemory(cx);
+    return false;
+  }
+  for (AutoValue& value : values) {
+    argValues.infallibleAppend(value.mData);
+  }
+
   // initialize a pointer to an appropriate location, for storing the result
   AutoValue returnValue;
   TypeCode typeCode = CType::GetTypeCode(fninfo->mReturnType);
@@ -7386,8 +7418,7 @@ FunctionType::Call(JSContext* cx,
   int savedErrno = errno;
   errno = 0;
 
-  ffi_call(&fninfo->mCIF, FFI_FN(fn), returnValue.mData,
-           reinterpret_cast<void**>(values.begin()));
+  ffi_call(&fninfo->mCIF, FFI_FN(fn), returnValue.mData, argValues.begin());
 
   // Save error value.
   // We need to save it before leaving the scope of |suspend| as destructing
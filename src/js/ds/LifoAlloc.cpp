@@ -10,31 +10,145 @@
 #include "mozilla/MathAlgorithms.h"
 
 #include "ds/MemoryProtectionExceptionHandler.h"
-
-#ifdef LIFO_CHUNK_PROTECT
-# include "gc/Memory.h"
-#endif
+#include "gc/Memory.h"
+#include "vm/JSContext.h"
 
 using namespace js;
 
+using mozilla::FloorLog2;
 using mozilla::RoundUpPow2;
 using mozilla::tl::BitSize;
 
+// Chunks are cached by the thread which frees them, which may not be the one
+// which allocated them, for example when Ion compilations are freed off
+// thread. Threads without a context don't cache chunks.
+static LifoChunkPool*
+CurrentThreadChunkPool()
+{
+    JSContext* cx = TlsContext.get();
+    return cx ? &cx->lifoChunkPool() : nullptr;
+}
+
+/* static */ bool
+LifoChunkPool::sizeClass(size_t size, size_t* index)
+{
+    MOZ_ASSERT(mozilla::IsPowerOfTwo(size));
+    size_t log2 = FloorLog2(size);
+    if (log2 < MinChunkSizeLog2 || log2 > MaxChunkSizeLog2) {
+        return false;
+    }
+    *index = log2 - MinChunkSizeLog2;
+    return true;
+}
+
+void*
+LifoChunkPool::take(size_t size)
+{
+    size_t index;
+    if (!sizeClass(size, &index) || !freeLists_[index]) {
+        return nullptr;
+    }
+
+    FreeChunk* chunk = freeLists_[index];
+    freeLists_[index] = chunk->next;
+    MOZ_ASSERT(cachedBytes_ >= size);
+    cachedBytes_ -= size;
+    return chunk;
+}
+
+bool
+LifoChunkPool::put(void* mem, size_t size)
+{
+    size_t index;
+    if (!sizeClass(size, &index) || cachedBytes_ + size > MaxCachedBytes) {
+        return false;
+    }
+
+    FreeChunk* chunk = static_cast<FreeChunk*>(mem);
+    chunk->next = freeLists_[index];
+    freeLists_[index] = chunk;
+    cachedBytes_ += size;
+    return true;
+}
+
+void
+LifoChunkPool::freeAll()
+{
+    for (FreeChunk*& list : freeLists_) {
+        while (list) {
+            FreeChunk* next = list->next;
+            js_free(list);
+            list = next;
+        }
+    }
+    cachedBytes_ = 0;
+}
+
+size_t
+LifoChunkPool::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const
+{
+    size_t n = 0;
+    for (FreeChunk* list : freeLists_) {
+        for (FreeChunk* chunk = list; chunk; chunk = chunk->next) {
+            n += mallocSizeOf(chunk);
+        }
+    }
+    return n;
+}
+
 namespace js {
 namespace detail {
 
+void
+BumpChunkDeletePolicy::operator()(const BumpChunk* chunk)
+{
+    BumpChunk* bc = const_cast<BumpChunk*>(chunk);
+    size_t size = bc->computedSizeOfIncludingThis();
+    bool mapped = bc->mapped();
+    bc->~BumpChunk();
+
+    if (mapped) {
+        gc::UnmapPages(bc, size);
+        return;
+    }
+
+    LifoChunkPool* pool = CurrentThreadChunkPool();
+    if (pool && pool->put(bc, size)) {
+        return;
+    }
+    js_free(bc);
+}
+
 /* static */
-UniquePtr<BumpChunk>
-BumpChunk::newWithCapacity(size_t size)
+UniqueBumpChunk
+BumpChunk::newWithCapacity(size_t size, bool hugePages)
 {
     MOZ_DIAGNOSTIC_ASSERT(RoundUpPow2(size) == size);
     MOZ_DIAGNOSTIC_ASSERT(size >= sizeof(BumpChunk));
-    void* mem = js_malloc(size);
+
+    bool mapped = false;
+    void* mem = nullptr;
+    if (hugePages && size >= HugeChunkSize) {
+        mem = gc::MapAlignedPages(size, HugeChunkSize);
+        if (mem) {
+            // This is only a hint, and the chunk is usable either way.
+            gc::MarkPagesHuge(mem, size);
+            mapped = true;
+        }
+    }
+    if (!mem) {
+        if (LifoChunkPool* pool = CurrentThreadChunkPool()) {
+            mem = pool->take(size);
+        }
+    }
+    if (!mem) {
+        mem = js_malloc(size);
+    }
     if (!mem) {
         return nullptr;
     }
 
-    UniquePtr<BumpChunk> result(new (mem) BumpChunk(size));
+    UniqueBumpChunk result(new (mem) BumpChunk(size, mapped));
 
     // We assume that the alignment of LIFO_ALLOC_ALIGN is less than that of the
     // underlying memory allocator -- creating a new BumpChunk should always
@@ -154,12 +268,17 @@ LifoAlloc::newChunkWithCapacity(size_t n)
         return nullptr;
     }
 
-    const size_t chunkSize = minSize > defaultChunkSize_
-                             ?  RoundUpPow2(minSize)
-                             : defaultChunkSize_;
+    size_t chunkSize = minSize > defaultChunkSize_
+                       ?  RoundUpPow2(minSize)
+                       : defaultChunkSize_;
+    if (useHugePages_ && curSize_ >= detail::BumpChunk::HugeChunkSize) {
+        if (chunkSize < detail::BumpChunk::HugeChunkSize) {
+            chunkSize = detail::BumpChunk::HugeChunkSize;
+        }
+    }
 
     // Create a new BumpChunk, and allocate space for it.
-    UniqueBumpChunk result = detail::BumpChunk::newWithCapacity(chunkSize);
+    UniqueBumpChunk result = detail::BumpChunk::newWithCapacity(chunkSize, useHugePages_);
     if (!result) {
         return nullptr;
     }
@@ -229,3 +348,23 @@ LifoAlloc::transferUnusedFrom(LifoAlloc* other)
     incrementCurSize(size);
     other->decrementCurSize(size);
 }
+
+void
+LifoAlloc::reuseReleasedChunksFrom(LifoAlloc* other, size_t maxBytes)
+{
+    MOZ_ASSERT(!markCount);
+
+    other->releaseAll();
+
+    size_t size = 0;
+    BumpChunkList kept;
+    while (!other->unused_.empty() && size < maxBytes) {
+        UniqueBumpChunk chunk = other->unused_.popFirst();
+        size += chunk->computedSizeOfIncludingThis();
+        kept.append(std::move(chunk));
+    }
+
+    appendUnused(std::move(kept));
+    incrementCurSize(size);
+    other->decrementCurSize(size);
+}
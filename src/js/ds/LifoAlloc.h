@@ -211,18 +211,32 @@ AlignPtr(uint8_t* orig)
     return result;
 }
 
+class BumpChunk;
+
+// Deleting a BumpChunk gives its memory to the LifoChunkPool of the current
+// thread if the pool has room for it, rather than back to the system.
+struct BumpChunkDeletePolicy
+{
+    void operator()(const BumpChunk* chunk);
+};
+
+using UniqueBumpChunk = UniquePtr<BumpChunk, BumpChunkDeletePolicy>;
+
 // A Chunk represent a single memory allocation made with the system
 // allocator. As the owner of the memory, it is responsible for the allocation
 // and the deallocation.
 //
 // This structure is only move-able, but not copyable.
-class BumpChunk : public SingleLinkedListElement<BumpChunk>
+class BumpChunk : public SingleLinkedListElement<BumpChunk, BumpChunkDeletePolicy>
 {
   private:
     // Pointer to the last byte allocated in this chunk.
     uint8_t* bump_;
     // Pointer to the first byte after this chunk.
     uint8_t* const capacity_;
+    // Whether the chunk was mapped directly, to be backed by huge pages,
+    // rather than allocated with malloc.
+    const bool mapped_;
 
 #ifdef MOZ_DIAGNOSTIC_ASSERT_ENABLED
     // Magic number used to check against poisoned values.
@@ -285,9 +299,10 @@ class BumpChunk : public SingleLinkedListElement<BumpChunk>
     BumpChunk& operator=(const BumpChunk&) = delete;
     BumpChunk(const BumpChunk&) = delete;
 
-    explicit BumpChunk(uintptr_t capacity)
+    BumpChunk(uintptr_t capacity, bool mapped)
       : bump_(begin()),
-        capacity_(base() + capacity)
+        capacity_(base() + capacity),
+        mapped_(mapped)
 #ifdef MOZ_DIAGNOSTIC_ASSERT_ENABLED
       , magic_(magicNumber)
 #endif
@@ -356,12 +371,19 @@ class BumpChunk : public SingleLinkedListElement<BumpChunk>
 
     // This function is the only way to allocate and construct a chunk. It
     // returns a UniquePtr to the newly allocated chunk.  The size given as
-    // argument includes the space needed for the header of the chunk.
-    static UniquePtr<BumpChunk> newWithCapacity(size_t size);
+    // argument includes the space needed for the header of the chunk. If
+    // |hugePages| is set and the chunk is at least HugeChunkSize, it is mapped
+    // on its own and backed by huge pages where the OS supports it.
+    static UniqueBumpChunk newWithCapacity(size_t size, bool hugePages);
+
+    // The smallest chunk which is backed by huge pages when asked for.
+    static const size_t HugeChunkSize = 2 * 1024 * 1024;
+
+    bool mapped() const { return mapped_; }
 
     // Report allocation.
     size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
-        return mallocSizeOf(this);
+        return mapped_ ? computedSizeOfIncludingThis() : mallocSizeOf(this);
     }
 
     // Report allocation size.
@@ -518,14 +540,71 @@ BumpChunk::begin()
 
 } // namespace detail
 
+// A cache of the memory of freed BumpChunks, so that the LifoAllocs of
+// compilations and parses, which are created and destroyed in quick
+// succession, mostly reuse memory which is already paged in rather than going
+// back to malloc each time. Only power-of-two sizes from 2^MinChunkSizeLog2 to
+// 2^MaxChunkSizeLog2 bytes are kept, up to MaxCachedBytes in total.
+//
+// Each JSContext owns one, which is only used by the context's thread: chunks
+// go to the pool of the thread which frees them, and are reused by the next
+// LifoAlloc which needs a chunk of the same size on that thread.
+class LifoChunkPool
+{
+  public:
+    static const size_t MinChunkSizeLog2 = 12;
+    static const size_t MaxChunkSizeLog2 = 20;
+    static const size_t MaxCachedBytes = 4 * 1024 * 1024;
+
+  private:
+    static const size_t NumSizeClasses = MaxChunkSizeLog2 - MinChunkSizeLog2 + 1;
+
+    // Cached memory is linked through its first word.
+    struct FreeChunk
+    {
+        FreeChunk* next;
+    };
+
+    FreeChunk* freeLists_[NumSizeClasses];
+    size_t cachedBytes_;
+
+    static bool sizeClass(size_t size, size_t* index);
+
+    LifoChunkPool(const LifoChunkPool&) = delete;
+    void operator=(const LifoChunkPool&) = delete;
+
+  public:
+    LifoChunkPool()
+      : cachedBytes_(0)
+    {
+        mozilla::PodArrayZero(freeLists_);
+    }
+
+    ~LifoChunkPool() { freeAll(); }
+
+    // Return cached memory of exactly |size| bytes, or nullptr if there is
+    // none.
+    void* take(size_t size);
+
+    // Cache the memory of a chunk of |size| bytes. Returns false if the
+    // memory isn't wanted and should be freed instead.
+    MOZ_MUST_USE bool put(void* mem, size_t size);
+
+    void freeAll();
+
+    size_t cachedBytes() const { return cachedBytes_; }
+    size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
+};
+
 // LIFO bump allocator: used for phase-oriented and fast LIFO allocations.
 //
 // Note: We leave BumpChunks latent in the set of unused chunks after they've
 // been released to avoid thrashing before a GC.
 class LifoAlloc
 {
-    using UniqueBumpChunk = js::UniquePtr<detail::BumpChunk>;
-    using BumpChunkList = detail::SingleLinkedList<detail::BumpChunk>;
+    using UniqueBumpChunk = detail::UniqueBumpChunk;
+    using BumpChunkList = detail::SingleLinkedList<detail::BumpChunk,
+                                                   detail::BumpChunkDeletePolicy>;
 
     // List of chunks containing allocated data. In the common case, the last
     // chunk of this list is always used to perform the allocations. When the
@@ -540,6 +619,7 @@ class LifoAlloc
     size_t      defaultChunkSize_;
     size_t      curSize_;
     size_t      peakSize_;
+    bool        useHugePages_;
 #if defined(DEBUG) || defined(JS_OOM_BREAKPOINT)
     bool        fallibleScope_;
 #endif
@@ -603,7 +683,8 @@ class LifoAlloc
 
   public:
     explicit LifoAlloc(size_t defaultChunkSize)
-      : peakSize_(0)
+      : peakSize_(0),
+        useHugePages_(false)
 #if defined(DEBUG) || defined(JS_OOM_BREAKPOINT)
       , fallibleScope_(true)
 #endif
@@ -625,6 +706,7 @@ class LifoAlloc
         defaultChunkSize_ = other->defaultChunkSize_;
         curSize_ = other->curSize_;
         peakSize_ = Max(peakSize_, other->peakSize_);
+        useHugePages_ = other->useHugePages_;
 #if defined(DEBUG) || defined(JS_OOM_BREAKPOINT)
         fallibleScope_ = other->fallibleScope_;
 #endif
@@ -638,10 +720,20 @@ class LifoAlloc
     // Append unused chunks from |other|. They are removed from |other|.
     void transferUnusedFrom(LifoAlloc* other);
 
+    // Release all the chunks of |other|, and append them to the unused chunks
+    // of this LifoAlloc until |maxBytes| have been moved. The remaining chunks
+    // stay in |other|, as unused chunks.
+    void reuseReleasedChunksFrom(LifoAlloc* other, size_t maxBytes);
+
     ~LifoAlloc() { freeAll(); }
 
     size_t defaultChunkSize() const { return defaultChunkSize_; }
 
+    // Once this LifoAlloc has grown past BumpChunk::HugeChunkSize, allocate
+    // its new chunks at least that large and back them with huge pages, to
+    // save TLB misses and page faults in large compilations.
+    void setUseHugePages() { useHugePages_ = true; }
+
     // Frees all held memory.
     void freeAll();
 
@@ -38,14 +38,92 @@
  */
 
 #include "mozilla/HashFunctions.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/Move.h"
 
+#include <string.h>
+
 #include "js/HashTable.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+# define JS_ORDEREDHASHTABLE_SSE2
+# include <emmintrin.h>
+#endif
+
 namespace js {
 
 namespace detail {
 
+/*
+ * The index of an OrderedHashTable is an open addressing table of positions
+ * in its data vector. Each slot of the index also has a control byte, which
+ * is Empty, Deleted, or the low seven bits of the hash code of the entry the
+ * slot refers to. The slots are probed a group of Width slots at a time: a
+ * lookup compares the hash fragment with all the control bytes of a group at
+ * once and only looks at the entries of the slots that match, so it usually
+ * reads one group of control bytes and a single entry.
+ */
+class OrderedHashIndexGroup
+{
+  public:
+    static const uint32_t Width = 16;
+
+    // Empty and Deleted are the only control bytes with the high bit set.
+    static const uint8_t Empty = 0x80;
+    static const uint8_t Deleted = 0xfe;
+
+    static uint8_t fragment(HashNumber h) { return uint8_t(h & 0x7f); }
+
+#ifdef JS_ORDEREDHASHTABLE_SSE2
+  private:
+    __m128i ctrl;
+
+  public:
+    explicit OrderedHashIndexGroup(const uint8_t* p)
+      : ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(p)))
+    {}
+
+    // Return a mask with bit i set if the i-th control byte is |c|.
+    uint32_t match(uint8_t c) const {
+        return uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(ctrl, _mm_set1_epi8(char(c)))));
+    }
+
+    uint32_t matchEmptyOrDeleted() const {
+        return uint32_t(_mm_movemask_epi8(ctrl));
+    }
+#else
+  private:
+    const uint8_t* ctrl;
+
+  public:
+    explicit OrderedHashIndexGroup(const uint8_t* p)
+      : ctrl(p)
+    {}
+
+    uint32_t match(uint8_t c) const {
+        uint32_t bits = 0;
+        for (uint32_t i = 0; i < Width; i++) {
+            if (ctrl[i] == c) {
+                bits |= uint32_t(1) << i;
+            }
+        }
+        return bits;
+    }
+
+    uint32_t matchEmptyOrDeleted() const {
+        uint32_t bits = 0;
+        for (uint32_t i = 0; i < Width; i++) {
+            if (ctrl[i] & 0x80) {
+                bits |= uint32_t(1) << i;
+            }
+        }
+        return bits;
+    }
+#endif
+
+    uint32_t matchEmpty() const { return match(Empty); }
+};
+
 /*
  * detail::OrderedHashTable is the underlying data structure used to implement both
  * OrderedHashMap and OrderedHashSet. Programs should use one of those two
@@ -61,22 +139,25 @@ class OrderedHashTable
     struct Data
     {
         T element;
-        Data* chain;
 
-        Data(const T& e, Data* c) : element(e), chain(c) {}
-        Data(T&& e, Data* c) : element(std::move(e)), chain(c) {}
+        explicit Data(const T& e) : element(e) {}
+        explicit Data(T&& e) : element(std::move(e)) {}
     };
 
     class Range;
     friend class Range;
 
   private:
-    Data** hashTable;           // hash table (has hashBuckets() elements)
+    typedef OrderedHashIndexGroup Group;
+
+    uint32_t* hashTable;        // positions in data (has hashBuckets() elements)
+    uint8_t* hashControl;       // control bytes of the hashTable slots
     Data* data;                 // data vector, an array of Data objects
                                 // data[0:dataLength] are constructed
     uint32_t dataLength;        // number of constructed elements in data
     uint32_t dataCapacity;      // size of data, in elements
     uint32_t liveCount;         // dataLength less empty (removed) entries
+    uint32_t hashUsed;          // number of hashTable slots that are not Empty
     uint32_t hashShift;         // multiplicative hash shift
     Range* ranges;              // list of all live Ranges on this table in malloc memory
     Range* nurseryRanges;       // list of all live Ranges on this table in the GC nursery
@@ -102,10 +183,12 @@ class OrderedHashTable
   public:
     OrderedHashTable(AllocPolicy& ap, mozilla::HashCodeScrambler hcs)
       : hashTable(nullptr),
+        hashControl(nullptr),
         data(nullptr),
         dataLength(0),
         dataCapacity(0),
         liveCount(0),
+        hashUsed(0),
         hashShift(0),
         ranges(nullptr),
         nurseryRanges(nullptr),
@@ -117,28 +200,28 @@ class OrderedHashTable
         MOZ_ASSERT(!hashTable, "init must be called at most once");
 
         uint32_t buckets = initialBuckets();
-        Data** tableAlloc = alloc.template pod_malloc<Data*>(buckets);
-        if (!tableAlloc) {
+        uint32_t* tableAlloc;
+        uint8_t* controlAlloc;
+        if (!allocIndex(buckets, &tableAlloc, &controlAlloc)) {
             return false;
         }
-        for (uint32_t i = 0; i < buckets; i++) {
-            tableAlloc[i] = nullptr;
-        }
 
-        uint32_t capacity = uint32_t(buckets * fillFactor());
+        uint32_t capacity = initialDataCapacity();
         Data* dataAlloc = alloc.template pod_malloc<Data>(capacity);
         if (!dataAlloc) {
-            alloc.free_(tableAlloc, buckets);
+            freeIndex(tableAlloc, controlAlloc, buckets);
             return false;
         }
 
         // clear() requires that members are assigned only after all allocation
         // has succeeded, and that this->ranges is left untouched.
         hashTable = tableAlloc;
+        hashControl = controlAlloc;
         data = dataAlloc;
         dataLength = 0;
         dataCapacity = capacity;
         liveCount = 0;
+        hashUsed = 0;
         hashShift = js::kHashNumberBits - initialBucketsLog2();
         MOZ_ASSERT(hashBuckets() == buckets);
         return true;
@@ -146,7 +229,9 @@ class OrderedHashTable
 
     ~OrderedHashTable() {
         forEachRange<Range::onTableDestroyed>();
-        alloc.free_(hashTable, hashBuckets());
+        if (hashTable) {
+            freeIndex(hashTable, hashControl, hashBuckets());
+        }
         freeData(data, dataLength, dataCapacity);
     }
 
@@ -186,19 +271,28 @@ class OrderedHashTable
         }
 
         if (dataLength == dataCapacity) {
-            // If the hashTable is more than 1/4 deleted data, simply rehash in
-            // place to free up some space. Otherwise, grow the table.
-            uint32_t newHashShift = liveCount >= dataCapacity * 0.75 ? hashShift - 1 : hashShift;
-            if (!rehash(newHashShift)) {
+            // If the data is more than 1/4 deleted entries, simply rehash in
+            // place to free up some space. Otherwise, grow the data if the
+            // index has room for more entries, or grow the table.
+            if (liveCount < dataCapacity * 0.75) {
+                rehashInPlace();
+            } else if (dataCapacity < maxDataCapacity(hashBuckets())) {
+                if (!growData()) {
+                    return false;
+                }
+            } else if (!rehash(hashShift - 1)) {
                 return false;
             }
         }
 
-        h >>= hashShift;
+        // The index is only ever reindexed before the new entry is
+        // constructed, so that reindexing does not add it twice.
+        if (hashUsed >= maxHashUsed()) {
+            reindex();
+        }
+        addToIndex(h, dataLength);
         liveCount++;
-        Data* e = &data[dataLength++];
-        new (e) Data(std::forward<ElementInput>(element), hashTable[h]);
-        hashTable[h] = e;
+        new (&data[dataLength++]) Data(std::forward<ElementInput>(element));
         return true;
     }
 
@@ -217,18 +311,19 @@ class OrderedHashTable
         // benefit.
 
         // If a matching entry exists, empty it.
-        Data* e = lookup(l, prepareHash(l));
-        if (e == nullptr) {
+        uint32_t slot = lookupSlot(l, prepareHash(l));
+        if (slot == NotFound) {
             *foundp = false;
             return true;
         }
 
         *foundp = true;
         liveCount--;
-        Ops::makeEmpty(&e->element);
+        uint32_t pos = hashTable[slot];
+        hashControl[slot] = Group::Deleted;
+        Ops::makeEmpty(&data[pos].element);
 
         // Update active Ranges.
-        uint32_t pos = e - data;
         forEachRange<&Range::onRemove>(pos);
 
         // If many entries have been removed, try to shrink the table.
@@ -252,7 +347,8 @@ class OrderedHashTable
      */
     MOZ_MUST_USE bool clear() {
         if (dataLength != 0) {
-            Data** oldHashTable = hashTable;
+            uint32_t* oldHashTable = hashTable;
+            uint8_t* oldHashControl = hashControl;
             Data* oldData = data;
             uint32_t oldHashBuckets = hashBuckets();
             uint32_t oldDataLength = dataLength;
@@ -265,7 +361,7 @@ class OrderedHashTable
                 return false;
             }
 
-            alloc.free_(oldHashTable, oldHashBuckets);
+            freeIndex(oldHashTable, oldHashControl, oldHashBuckets);
             freeData(oldData, oldDataLength, oldDataCapacity);
             forEachRange<&Range::onClear>();
         }
@@ -470,33 +566,11 @@ class OrderedHashTable
         void rekeyFront(const Key& k) {
             MOZ_ASSERT(valid());
             Data& entry = ht->data[i];
-            HashNumber oldHash = ht->prepareHash(Ops::getKey(entry.element)) >> ht->hashShift;
-            HashNumber newHash = ht->prepareHash(k) >> ht->hashShift;
+            HashNumber oldHash = ht->prepareHash(Ops::getKey(entry.element));
+            HashNumber newHash = ht->prepareHash(k);
             Ops::setKey(entry.element, k);
             if (newHash != oldHash) {
-                // Remove this entry from its old hash chain. (If this crashes
-                // reading nullptr, it would mean we did not find this entry on
-                // the hash chain where we expected it. That probably means the
-                // key's hash code changed since it was inserted, breaking the
-                // hash code invariant.)
-                Data** ep = &ht->hashTable[oldHash];
-                while (*ep != &entry) {
-                    ep = &(*ep)->chain;
-                }
-                *ep = entry.chain;
-
-                // Add it to the new hash chain. We could just insert it at the
-                // beginning of the chain. Instead, we do a bit of work to
-                // preserve the invariant that hash chains always go in reverse
-                // insertion order (descending memory order). No code currently
-                // depends on this invariant, so it's fine to kill it if
-                // needed.
-                ep = &ht->hashTable[newHash];
-                while (*ep && *ep > &entry) {
-                    ep = &(*ep)->chain;
-                }
-                entry.chain = *ep;
-                *ep = &entry;
+                ht->rekeyIndex(oldHash, newHash, i);
             }
         }
 
@@ -561,39 +635,18 @@ class OrderedHashTable
             return;
         }
 
-        Data* entry = lookup(current, prepareHash(current));
-        if (!entry) {
+        HashNumber oldHash = prepareHash(current);
+        uint32_t slot = lookupSlot(current, oldHash);
+        if (slot == NotFound) {
             return;
         }
 
-        HashNumber oldHash = prepareHash(current) >> hashShift;
-        HashNumber newHash = prepareHash(newKey) >> hashShift;
-
-        entry->element = element;
-
-        // Remove this entry from its old hash chain. (If this crashes
-        // reading nullptr, it would mean we did not find this entry on
-        // the hash chain where we expected it. That probably means the
-        // key's hash code changed since it was inserted, breaking the
-        // hash code invariant.)
-        Data** ep = &hashTable[oldHash];
-        while (*ep != entry) {
-            ep = &(*ep)->chain;
-        }
-        *ep = entry->chain;
-
-        // Add it to the new hash chain. We could just insert it at the
-        // beginning of the chain. Instead, we do a bit of work to
-        // preserve the invariant that hash chains always go in reverse
-        // insertion order (descending memory order). No code currently
-        // depends on this invariant, so it's fine to kill it if
-        // needed.
-        ep = &hashTable[newHash];
-        while (*ep && *ep > entry) {
-            ep = &(*ep)->chain;
+        HashNumber newHash = prepareHash(newKey);
+        uint32_t pos = hashTable[slot];
+        data[pos].element = element;
+        if (newHash != oldHash) {
+            rekeyIndex(oldHash, newHash, pos);
         }
-        entry->chain = *ep;
-        *ep = entry;
     }
 
     static size_t offsetOfDataLength() {
@@ -612,21 +665,34 @@ class OrderedHashTable
     }
 
   private:
-    /* Logarithm base 2 of the number of buckets in the hash table initially. */
-    static uint32_t initialBucketsLog2() { return 1; }
+    /*
+     * Logarithm base 2 of the number of buckets in the hash table initially.
+     * The table always has at least one whole group of slots.
+     */
+    static uint32_t initialBucketsLog2() { return 4; }
     static uint32_t initialBuckets() { return 1 << initialBucketsLog2(); }
 
     /*
-     * The maximum load factor (mean number of entries per bucket).
-     * It is an invariant that
-     *     dataCapacity == floor(hashBuckets() * fillFactor()).
-     *
-     * The fill factor should be between 2 and 4, and it should be chosen so that
-     * the fill factor times sizeof(Data) is close to but <= a power of 2.
-     * This fixed fill factor was chosen to make the size of the data
-     * array, in bytes, close to a power of two when sizeof(T) is 16.
+     * The data vector starts out small and grows up to maxDataCapacity() for
+     * the current size of the index. Since the index holds positions rather
+     * than pointers, growing the data does not require reindexing.
      */
-    static double fillFactor() { return 8.0 / 3.0; }
+    static uint32_t initialDataCapacity() { return 4; }
+
+    /*
+     * The maximum load factor of the index, counting only the live and
+     * removed entries which are still in |data|. It is an invariant that
+     *     dataCapacity <= maxDataCapacity(hashBuckets()).
+     */
+    static uint32_t maxDataCapacity(uint32_t buckets) { return buckets / 4 * 3; }
+
+    /*
+     * The maximum number of slots that are not Empty. Besides the entries in
+     * |data|, this counts the Deleted slots left behind by rekeying, which
+     * are discarded by reindex() before an insertion would exceed it. Probing
+     * relies on there always being some Empty slots.
+     */
+    uint32_t maxHashUsed() const { return hashBuckets() / 8 * 7; }
 
     /*
      * The minimum permitted value of (liveCount / dataLength).
@@ -656,13 +722,61 @@ class OrderedHashTable
         alloc.free_(data, capacity);
     }
 
-    Data* lookup(const Lookup& l, HashNumber h) {
-        for (Data* e = hashTable[h >> hashShift]; e; e = e->chain) {
-            if (Ops::match(Ops::getKey(e->element), l)) {
-                return e;
+    MOZ_MUST_USE bool allocIndex(uint32_t buckets, uint32_t** tablep, uint8_t** controlp) {
+        uint32_t* table = alloc.template pod_malloc<uint32_t>(buckets);
+        if (!table) {
+            return false;
+        }
+        uint8_t* control = alloc.template pod_malloc<uint8_t>(buckets);
+        if (!control) {
+            alloc.free_(table, buckets);
+            return false;
+        }
+        memset(control, Group::Empty, buckets);
+        *tablep = table;
+        *controlp = control;
+        return true;
+    }
+
+    void freeIndex(uint32_t* table, uint8_t* control, uint32_t buckets) {
+        alloc.free_(table, buckets);
+        alloc.free_(control, buckets);
+    }
+
+    static const uint32_t NotFound = UINT32_MAX;
+
+    /*
+     * Probe the groups of the index in triangular order, starting with the
+     * group containing slot |h >> shift|. This visits every group when the
+     * number of groups is a power of two.
+     */
+    static uint32_t firstGroup(HashNumber h, uint32_t shift) {
+        return (h >> shift) / Group::Width;
+    }
+
+    uint32_t lookupSlot(const Lookup& l, HashNumber h) {
+        uint8_t fragment = Group::fragment(h);
+        uint32_t groupMask = hashBuckets() / Group::Width - 1;
+        uint32_t g = firstGroup(h, hashShift);
+        for (uint32_t step = 1; ; step++) {
+            uint32_t base = g * Group::Width;
+            Group group(hashControl + base);
+            for (uint32_t bits = group.match(fragment); bits; bits &= bits - 1) {
+                uint32_t slot = base + mozilla::CountTrailingZeroes32(bits);
+                if (Ops::match(Ops::getKey(data[hashTable[slot]].element), l)) {
+                    return slot;
+                }
+            }
+            if (group.matchEmpty()) {
+                return NotFound;
             }
+            g = (g + step) & groupMask;
         }
-        return nullptr;
+    }
+
+    Data* lookup(const Lookup& l, HashNumber h) {
+        uint32_t slot = lookupSlot(l, h);
+        return slot == NotFound ? nullptr : &data[hashTable[slot]];
     }
 
     const Data* lookup(const Lookup& l) const {
@@ -676,21 +790,129 @@ class OrderedHashTable
         forEachRange<&Range::onCompact>();
     }
 
+    /*
+     * Add data[pos] to the index, in the first Empty or Deleted slot of its
+     * probe sequence, and return whether that slot was Empty.
+     */
+    static bool addToIndex(uint32_t* table, uint8_t* control, uint32_t buckets,
+                           uint32_t shift, HashNumber h, uint32_t pos)
+    {
+        uint32_t groupMask = buckets / Group::Width - 1;
+        uint32_t g = firstGroup(h, shift);
+        for (uint32_t step = 1; ; step++) {
+            uint32_t base = g * Group::Width;
+            uint32_t bits = Group(control + base).matchEmptyOrDeleted();
+            if (bits) {
+                uint32_t slot = base + mozilla::CountTrailingZeroes32(bits);
+                bool wasEmpty = control[slot] == Group::Empty;
+                control[slot] = Group::fragment(h);
+                table[slot] = pos;
+                return wasEmpty;
+            }
+            g = (g + step) & groupMask;
+        }
+    }
+
+    /* The caller must ensure that hashUsed < maxHashUsed(). */
+    void addToIndex(HashNumber h, uint32_t pos) {
+        MOZ_ASSERT(hashUsed < maxHashUsed());
+        if (addToIndex(hashTable, hashControl, hashBuckets(), hashShift, h, pos)) {
+            hashUsed++;
+        }
+    }
+
+    /*
+     * Mark the slot referring to data[pos] as Deleted. (If this crashes, it
+     * would mean we did not find this entry in the probe sequence where we
+     * expected it. That probably means the key's hash code changed since it
+     * was inserted, breaking the hash code invariant.)
+     */
+    void removeFromIndex(HashNumber h, uint32_t pos) {
+        uint8_t fragment = Group::fragment(h);
+        uint32_t groupMask = hashBuckets() / Group::Width - 1;
+        uint32_t g = firstGroup(h, hashShift);
+        for (uint32_t step = 1; ; step++) {
+            uint32_t base = g * Group::Width;
+            Group group(hashControl + base);
+            for (uint32_t bits = group.match(fragment); bits; bits &= bits - 1) {
+                uint32_t slot = base + mozilla::CountTrailingZeroes32(bits);
+                if (hashTable[slot] == pos) {
+                    hashControl[slot] = Group::Deleted;
+                    return;
+                }
+            }
+            MOZ_RELEASE_ASSERT(!group.matchEmpty());
+            g = (g + step) & groupMask;
+        }
+    }
+
+    /* Move data[pos], whose key has already been changed, in the index. */
+    void rekeyIndex(HashNumber oldHash, HashNumber newHash, uint32_t pos) {
+        removeFromIndex(oldHash, pos);
+        if (hashUsed >= maxHashUsed()) {
+            // Reindexing adds the entry under its new key.
+            reindex();
+            return;
+        }
+        addToIndex(newHash, pos);
+    }
+
+    void clearIndex() {
+        memset(hashControl, Group::Empty, hashBuckets());
+        hashUsed = 0;
+    }
+
+    /*
+     * Rebuild the index, discarding its Deleted slots. This does not move
+     * any entries in |data|, so Ranges are unaffected.
+     */
+    void reindex() {
+        clearIndex();
+        for (uint32_t i = 0; i < dataLength; i++) {
+            if (!Ops::isEmpty(Ops::getKey(data[i].element))) {
+                addToIndex(prepareHash(Ops::getKey(data[i].element)), i);
+            }
+        }
+    }
+
+    /*
+     * Grow |data| without changing the size of the index. On allocation
+     * failure, this leaves everything as it was and returns false.
+     */
+    MOZ_MUST_USE bool growData() {
+        uint32_t newCapacity = dataCapacity * 2;
+        uint32_t maxCapacity = maxDataCapacity(hashBuckets());
+        if (newCapacity > maxCapacity) {
+            newCapacity = maxCapacity;
+        }
+        MOZ_ASSERT(newCapacity > dataCapacity);
+
+        Data* newData = alloc.template pod_malloc<Data>(newCapacity);
+        if (!newData) {
+            return false;
+        }
+        for (uint32_t i = 0; i < dataLength; i++) {
+            new (&newData[i]) Data(std::move(data[i].element));
+        }
+
+        freeData(data, dataLength, dataCapacity);
+        data = newData;
+        dataCapacity = newCapacity;
+        return true;
+    }
+
     /* Compact the entries in |data| and rehash them. */
     void rehashInPlace() {
-        for (uint32_t i = 0, N = hashBuckets(); i < N; i++) {
-            hashTable[i] = nullptr;
-        }
+        clearIndex();
         Data* wp = data;
         Data* end = data + dataLength;
         for (Data* rp = data; rp != end; rp++) {
             if (!Ops::isEmpty(Ops::getKey(rp->element))) {
-                HashNumber h = prepareHash(Ops::getKey(rp->element)) >> hashShift;
+                HashNumber h = prepareHash(Ops::getKey(rp->element));
                 if (rp != wp) {
                     wp->element = std::move(rp->element);
                 }
-                wp->chain = hashTable[h];
-                hashTable[h] = wp;
+                addToIndex(h, wp - data);
                 wp++;
             }
         }
@@ -718,20 +940,29 @@ class OrderedHashTable
             return true;
         }
 
-        size_t newHashBuckets =
-            size_t(1) << (js::kHashNumberBits - newHashShift);
-        Data** newHashTable = alloc.template pod_malloc<Data*>(newHashBuckets);
-        if (!newHashTable) {
+        uint32_t newHashBuckets = uint32_t(1) << (js::kHashNumberBits - newHashShift);
+        uint32_t* newHashTable;
+        uint8_t* newHashControl;
+        if (!allocIndex(newHashBuckets, &newHashTable, &newHashControl)) {
             return false;
         }
-        for (uint32_t i = 0; i < newHashBuckets; i++) {
-            newHashTable[i] = nullptr;
-        }
 
-        uint32_t newCapacity = uint32_t(newHashBuckets * fillFactor());
+        // When growing, the data is full, so allocate all the data the new
+        // index can hold; when shrinking, leave room to grow to twice the
+        // live entries.
+        uint32_t newCapacity = maxDataCapacity(newHashBuckets);
+        if (newHashShift > hashShift) {
+            uint32_t wanted = liveCount * 2;
+            if (wanted < initialDataCapacity()) {
+                wanted = initialDataCapacity();
+            }
+            if (wanted < newCapacity) {
+                newCapacity = wanted;
+            }
+        }
         Data* newData = alloc.template pod_malloc<Data>(newCapacity);
         if (!newData) {
-            alloc.free_(newHashTable, newHashBuckets);
+            freeIndex(newHashTable, newHashControl, newHashBuckets);
             return false;
         }
 
@@ -739,18 +970,21 @@ class OrderedHashTable
         Data* end = data + dataLength;
         for (Data* p = data; p != end; p++) {
             if (!Ops::isEmpty(Ops::getKey(p->element))) {
-                HashNumber h = prepareHash(Ops::getKey(p->element)) >> newHashShift;
-                new (wp) Data(std::move(p->element), newHashTable[h]);
-                newHashTable[h] = wp;
+                HashNumber h = prepareHash(Ops::getKey(p->element));
+                (void) addToIndex(newHashTable, newHashControl, newHashBuckets, newHashShift, h,
+                                  wp - newData);
+                new (wp) Data(std::move(p->element));
                 wp++;
             }
         }
         MOZ_ASSERT(wp == newData + liveCount);
 
-        alloc.free_(hashTable, hashBuckets());
+        freeIndex(hashTable, hashControl, hashBuckets());
         freeData(data, dataLength, dataCapacity);
 
         hashTable = newHashTable;
+        hashControl = newHashControl;
+        hashUsed = liveCount;
         data = newData;
         dataLength = liveCount;
         dataCapacity = newCapacity;
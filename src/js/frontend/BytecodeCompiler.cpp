@@ -8,6 +8,9 @@
 
 #include "mozilla/IntegerPrintfMacros.h"
 #include "mozilla/Maybe.h"
+#include "mozilla/Utf8.h"
+
+#include <type_traits>
 
 #include "builtin/ModuleObject.h"
 #if defined(JS_BUILD_BINAST)
@@ -33,13 +36,17 @@ using namespace js::frontend;
 
 using mozilla::Maybe;
 using mozilla::Nothing;
+using mozilla::Utf8Unit;
 
 using JS::CompileOptions;
 using JS::ReadOnlyCompileOptions;
 using JS::SourceBufferHolder;
 
 // The BytecodeCompiler class contains resources common to compiling scripts and
-// function bodies.
+// function bodies. Unit is the type of the source's code units: char16_t for
+// source in a SourceBufferHolder, or Utf8Unit for UTF-8 source, which is
+// tokenized and stored in the ScriptSource without being inflated.
+template <typename Unit>
 class MOZ_STACK_CLASS BytecodeCompiler
 {
   public:
@@ -49,6 +56,11 @@ class MOZ_STACK_CLASS BytecodeCompiler
                      const ReadOnlyCompileOptions& options,
                      SourceBufferHolder& sourceBuffer,
                      HandleScope enclosingScope);
+    BytecodeCompiler(JSContext* cx,
+                     LifoAlloc& alloc,
+                     const ReadOnlyCompileOptions& options,
+                     const Unit* units, size_t length,
+                     HandleScope enclosingScope);
 
     JSScript* compileGlobalScript(ScopeKind scopeKind);
     JSScript* compileEvalScript(HandleObject environment, HandleScope enclosingScope);
@@ -62,6 +74,7 @@ class MOZ_STACK_CLASS BytecodeCompiler
   private:
     JSScript* compileScript(HandleObject environment, SharedContext* sc);
     bool checkLength();
+    bool setSourceCopy();
     bool createScriptSource(const Maybe<uint32_t>& parameterListEnd);
     bool canLazilyParse();
     bool createParser(ParseGoal goal);
@@ -74,7 +87,7 @@ class MOZ_STACK_CLASS BytecodeCompiler
     bool createScript();
     bool createScript(uint32_t toStringStart, uint32_t toStringEnd);
 
-    using TokenStreamPosition = frontend::TokenStreamPosition<char16_t>;
+    using TokenStreamPosition = frontend::TokenStreamPosition<Unit>;
 
     bool emplaceEmitter(Maybe<BytecodeEmitter>& emitter, SharedContext* sharedContext);
     bool handleParseFailure(const Directives& newDirectives, TokenStreamPosition& startPosition);
@@ -85,7 +98,12 @@ class MOZ_STACK_CLASS BytecodeCompiler
     JSContext* cx;
     LifoAlloc& alloc;
     const ReadOnlyCompileOptions& options;
-    SourceBufferHolder& sourceBuffer;
+
+    // The holder of the source, if it was passed as one, so that ScriptSource
+    // can take ownership of its buffer. Only used for char16_t.
+    SourceBufferHolder* sourceBuffer;
+    const Unit* units;
+    size_t length;
 
     RootedScope enclosingScope;
 
@@ -93,14 +111,28 @@ class MOZ_STACK_CLASS BytecodeCompiler
     ScriptSource* scriptSource;
 
     Maybe<UsedNameTracker> usedNames;
-    Maybe<Parser<SyntaxParseHandler, char16_t>> syntaxParser;
-    Maybe<Parser<FullParseHandler, char16_t>> parser;
+    Maybe<Parser<SyntaxParseHandler, Unit>> syntaxParser;
+    Maybe<Parser<FullParseHandler, Unit>> parser;
 
     Directives directives;
 
     RootedScript script;
 };
 
+template <>
+bool
+BytecodeCompiler<char16_t>::setSourceCopy()
+{
+    return scriptSource->setSourceCopy(cx, *sourceBuffer);
+}
+
+template <>
+bool
+BytecodeCompiler<Utf8Unit>::setSourceCopy()
+{
+    return scriptSource->setSourceCopy(cx, units, length);
+}
+
 AutoFrontendTraceLog::AutoFrontendTraceLog(JSContext* cx, const TraceLoggerTextId id,
                                            const ErrorReporter& errorReporter)
 #ifdef JS_TRACE_LOGGING
@@ -153,32 +185,50 @@ AutoFrontendTraceLog::AutoFrontendTraceLog(JSContext* cx, const TraceLoggerTextI
 { }
 #endif
 
-BytecodeCompiler::BytecodeCompiler(JSContext* cx,
-                                   LifoAlloc& alloc,
-                                   const ReadOnlyCompileOptions& options,
-                                   SourceBufferHolder& sourceBuffer,
-                                   HandleScope enclosingScope)
+template <typename Unit>
+BytecodeCompiler<Unit>::BytecodeCompiler(JSContext* cx,
+                                         LifoAlloc& alloc,
+                                         const ReadOnlyCompileOptions& options,
+                                         const Unit* units, size_t length,
+                                         HandleScope enclosingScope)
   : keepAtoms(cx),
     cx(cx),
     alloc(alloc),
     options(options),
-    sourceBuffer(sourceBuffer),
+    sourceBuffer(nullptr),
+    units(units),
+    length(length),
     enclosingScope(cx, enclosingScope),
     sourceObject(cx),
     scriptSource(nullptr),
     directives(options.strictOption),
     script(cx)
 {
-    MOZ_ASSERT(sourceBuffer.get());
+    MOZ_ASSERT(units);
+}
+
+template <typename Unit>
+BytecodeCompiler<Unit>::BytecodeCompiler(JSContext* cx,
+                                         LifoAlloc& alloc,
+                                         const ReadOnlyCompileOptions& options,
+                                         SourceBufferHolder& sourceBuffer,
+                                         HandleScope enclosingScope)
+  : BytecodeCompiler(cx, alloc, options, sourceBuffer.get(), sourceBuffer.length(),
+                     enclosingScope)
+{
+    static_assert(std::is_same<Unit, char16_t>::value,
+                  "SourceBufferHolder only holds UTF-16 source");
+    this->sourceBuffer = &sourceBuffer;
 }
 
+template <typename Unit>
 bool
-BytecodeCompiler::checkLength()
+BytecodeCompiler<Unit>::checkLength()
 {
     // Note this limit is simply so we can store sourceStart and sourceEnd in
     // JSScript as 32-bits. It could be lifted fairly easily, since the compiler
     // is using size_t internally already.
-    if (sourceBuffer.length() > UINT32_MAX) {
+    if (length > UINT32_MAX) {
         if (!cx->helperThread()) {
             JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr,
                                       JSMSG_SOURCE_TOO_LONG);
@@ -188,8 +238,9 @@ BytecodeCompiler::checkLength()
     return true;
 }
 
+template <typename Unit>
 bool
-BytecodeCompiler::createScriptSource(const Maybe<uint32_t>& parameterListEnd)
+BytecodeCompiler<Unit>::createScriptSource(const Maybe<uint32_t>& parameterListEnd)
 {
     if (!checkLength()) {
         return false;
@@ -205,7 +256,7 @@ BytecodeCompiler::createScriptSource(const Maybe<uint32_t>& parameterListEnd)
     if (!cx->realm()->behaviors().discardSource()) {
         if (options.sourceIsLazy) {
             scriptSource->setSourceRetrievable();
-        } else if (!scriptSource->setSourceCopy(cx, sourceBuffer)) {
+        } else if (!setSourceCopy()) {
             return false;
         }
     }
@@ -213,8 +264,9 @@ BytecodeCompiler::createScriptSource(const Maybe<uint32_t>& parameterListEnd)
     return true;
 }
 
+template <typename Unit>
 bool
-BytecodeCompiler::canLazilyParse()
+BytecodeCompiler<Unit>::canLazilyParse()
 {
     return options.canLazilyParse &&
            !cx->realm()->behaviors().disableLazyParsing() &&
@@ -227,13 +279,14 @@ BytecodeCompiler::canLazilyParse()
            !mozilla::recordreplay::IsRecordingOrReplaying();
 }
 
+template <typename Unit>
 bool
-BytecodeCompiler::createParser(ParseGoal goal)
+BytecodeCompiler<Unit>::createParser(ParseGoal goal)
 {
     usedNames.emplace(cx);
 
     if (canLazilyParse()) {
-        syntaxParser.emplace(cx, alloc, options, sourceBuffer.get(), sourceBuffer.length(),
+        syntaxParser.emplace(cx, alloc, options, units, length,
                              /* foldConstants = */ false, *usedNames, nullptr, nullptr,
                              sourceObject, goal);
         if (!syntaxParser->checkOptions()) {
@@ -241,38 +294,42 @@ BytecodeCompiler::createParser(ParseGoal goal)
         }
     }
 
-    parser.emplace(cx, alloc, options, sourceBuffer.get(), sourceBuffer.length(),
+    parser.emplace(cx, alloc, options, units, length,
                    /* foldConstants = */ true, *usedNames, syntaxParser.ptrOr(nullptr), nullptr,
                    sourceObject, goal);
     parser->ss = scriptSource;
     return parser->checkOptions();
 }
 
+template <typename Unit>
 bool
-BytecodeCompiler::createSourceAndParser(ParseGoal goal,
+BytecodeCompiler<Unit>::createSourceAndParser(ParseGoal goal,
                                         const Maybe<uint32_t>& parameterListEnd /* = Nothing() */)
 {
     return createScriptSource(parameterListEnd) &&
            createParser(goal);
 }
 
+template <typename Unit>
 bool
-BytecodeCompiler::createScript()
+BytecodeCompiler<Unit>::createScript()
 {
-    return createScript(0, sourceBuffer.length());
+    return createScript(0, length);
 }
 
+template <typename Unit>
 bool
-BytecodeCompiler::createScript(uint32_t toStringStart, uint32_t toStringEnd)
+BytecodeCompiler<Unit>::createScript(uint32_t toStringStart, uint32_t toStringEnd)
 {
     script = JSScript::Create(cx, options,
-                              sourceObject, /* sourceStart = */ 0, sourceBuffer.length(),
+                              sourceObject, /* sourceStart = */ 0, length,
                               toStringStart, toStringEnd);
     return script != nullptr;
 }
 
+template <typename Unit>
 bool
-BytecodeCompiler::emplaceEmitter(Maybe<BytecodeEmitter>& emitter, SharedContext* sharedContext)
+BytecodeCompiler<Unit>::emplaceEmitter(Maybe<BytecodeEmitter>& emitter, SharedContext* sharedContext)
 {
     BytecodeEmitter::EmitterMode emitterMode =
         options.selfHostingMode ? BytecodeEmitter::SelfHosting : BytecodeEmitter::Normal;
@@ -281,8 +338,9 @@ BytecodeCompiler::emplaceEmitter(Maybe<BytecodeEmitter>& emitter, SharedContext*
     return emitter->init();
 }
 
+template <typename Unit>
 bool
-BytecodeCompiler::handleParseFailure(const Directives& newDirectives,
+BytecodeCompiler<Unit>::handleParseFailure(const Directives& newDirectives,
                                      TokenStreamPosition& startPosition)
 {
     if (parser->hadAbortedSyntaxParse()) {
@@ -303,8 +361,9 @@ BytecodeCompiler::handleParseFailure(const Directives& newDirectives,
     return true;
 }
 
+template <typename Unit>
 bool
-BytecodeCompiler::deoptimizeArgumentsInEnclosingScripts(JSContext* cx, HandleObject environment)
+BytecodeCompiler<Unit>::deoptimizeArgumentsInEnclosingScripts(JSContext* cx, HandleObject environment)
 {
     RootedObject env(cx, environment);
     while (env->is<EnvironmentObject>() || env->is<DebugEnvironmentProxy>()) {
@@ -326,8 +385,9 @@ BytecodeCompiler::deoptimizeArgumentsInEnclosingScripts(JSContext* cx, HandleObj
     return true;
 }
 
+template <typename Unit>
 JSScript*
-BytecodeCompiler::compileScript(HandleObject environment, SharedContext* sc)
+BytecodeCompiler<Unit>::compileScript(HandleObject environment, SharedContext* sc)
 {
     if (!createSourceAndParser(ParseGoal::Script)) {
         return nullptr;
@@ -396,23 +456,26 @@ BytecodeCompiler::compileScript(HandleObject environment, SharedContext* sc)
     return script;
 }
 
+template <typename Unit>
 JSScript*
-BytecodeCompiler::compileGlobalScript(ScopeKind scopeKind)
+BytecodeCompiler<Unit>::compileGlobalScript(ScopeKind scopeKind)
 {
     GlobalSharedContext globalsc(cx, scopeKind, directives, options.extraWarningsOption);
     return compileScript(nullptr, &globalsc);
 }
 
+template <typename Unit>
 JSScript*
-BytecodeCompiler::compileEvalScript(HandleObject environment, HandleScope enclosingScope)
+BytecodeCompiler<Unit>::compileEvalScript(HandleObject environment, HandleScope enclosingScope)
 {
     EvalSharedContext evalsc(cx, environment, enclosingScope,
                              directives, options.extraWarningsOption);
     return compileScript(environment, &evalsc);
 }
 
+template <typename Unit>
 ModuleObject*
-BytecodeCompiler::compileModule()
+BytecodeCompiler<Unit>::compileModule()
 {
     if (!createSourceAndParser(ParseGoal::Module)) {
         return nullptr;
@@ -468,8 +531,9 @@ BytecodeCompiler::compileModule()
 // Compile a standalone JS function, which might appear as the value of an
 // event handler attribute in an HTML <INPUT> tag, or in a Function()
 // constructor.
+template <typename Unit>
 bool
-BytecodeCompiler::compileStandaloneFunction(MutableHandleFunction fun,
+BytecodeCompiler<Unit>::compileStandaloneFunction(MutableHandleFunction fun,
                                             GeneratorKind generatorKind,
                                             FunctionAsyncKind asyncKind,
                                             const Maybe<uint32_t>& parameterListEnd)
@@ -528,8 +592,9 @@ BytecodeCompiler::compileStandaloneFunction(MutableHandleFunction fun,
     return true;
 }
 
+template <typename Unit>
 ScriptSourceObject*
-BytecodeCompiler::sourceObjectPtr() const
+BytecodeCompiler<Unit>::sourceObjectPtr() const
 {
     return sourceObject.get();
 }
@@ -585,13 +650,14 @@ frontend::CreateScriptSourceObject(JSContext* cx, const ReadOnlyCompileOptions&
 // returns null), we must finish initializing the SSO.  This is because there
 // may be valid inner scripts observable by the debugger which reference the
 // partially-initialized SSO.
+template <typename Unit>
 class MOZ_STACK_CLASS AutoInitializeSourceObject
 {
-    BytecodeCompiler& compiler_;
+    BytecodeCompiler<Unit>& compiler_;
     ScriptSourceObject** sourceObjectOut_;
 
   public:
-    AutoInitializeSourceObject(BytecodeCompiler& compiler,
+    AutoInitializeSourceObject(BytecodeCompiler<Unit>& compiler,
                                ScriptSourceObject** sourceObjectOut)
       : compiler_(compiler),
         sourceObjectOut_(sourceObjectOut)
@@ -642,16 +708,14 @@ class MOZ_RAII AutoAssertReportedException
 #endif
 };
 
-JSScript*
-frontend::CompileGlobalScript(JSContext* cx, LifoAlloc& alloc, ScopeKind scopeKind,
-                              const ReadOnlyCompileOptions& options,
-                              SourceBufferHolder& srcBuf,
-                              ScriptSourceObject** sourceObjectOut)
+template <typename Unit>
+static JSScript*
+CompileGlobalScriptImpl(JSContext* cx, BytecodeCompiler<Unit>& compiler, ScopeKind scopeKind,
+                        ScriptSourceObject** sourceObjectOut)
 {
     MOZ_ASSERT(scopeKind == ScopeKind::Global || scopeKind == ScopeKind::NonSyntactic);
     AutoAssertReportedException assertException(cx);
-    BytecodeCompiler compiler(cx, alloc, options, srcBuf, /* enclosingScope = */ nullptr);
-    AutoInitializeSourceObject autoSSO(compiler, sourceObjectOut);
+    AutoInitializeSourceObject<Unit> autoSSO(compiler, sourceObjectOut);
     JSScript* script = compiler.compileGlobalScript(scopeKind);
     if (!script) {
         return nullptr;
@@ -660,6 +724,27 @@ frontend::CompileGlobalScript(JSContext* cx, LifoAlloc& alloc, ScopeKind scopeKi
     return script;
 }
 
+JSScript*
+frontend::CompileGlobalScript(JSContext* cx, LifoAlloc& alloc, ScopeKind scopeKind,
+                              const ReadOnlyCompileOptions& options,
+                              SourceBufferHolder& srcBuf,
+                              ScriptSourceObject** sourceObjectOut)
+{
+    BytecodeCompiler<char16_t> compiler(cx, alloc, options, srcBuf, /* enclosingScope = */ nullptr);
+    return CompileGlobalScriptImpl(cx, compiler, scopeKind, sourceObjectOut);
+}
+
+JSScript*
+frontend::CompileGlobalScript(JSContext* cx, LifoAlloc& alloc, ScopeKind scopeKind,
+                              const ReadOnlyCompileOptions& options,
+                              const Utf8Unit* units, size_t length,
+                              ScriptSourceObject** sourceObjectOut)
+{
+    BytecodeCompiler<Utf8Unit> compiler(cx, alloc, options, units, length,
+                                        /* enclosingScope = */ nullptr);
+    return CompileGlobalScriptImpl(cx, compiler, scopeKind, sourceObjectOut);
+}
+
 #if defined(JS_BUILD_BINAST)
 
 JSScript*
@@ -731,8 +816,8 @@ frontend::CompileEvalScript(JSContext* cx, LifoAlloc& alloc,
                             ScriptSourceObject** sourceObjectOut)
 {
     AutoAssertReportedException assertException(cx);
-    BytecodeCompiler compiler(cx, alloc, options, srcBuf, enclosingScope);
-    AutoInitializeSourceObject autoSSO(compiler, sourceObjectOut);
+    BytecodeCompiler<char16_t> compiler(cx, alloc, options, srcBuf, enclosingScope);
+    AutoInitializeSourceObject<char16_t> autoSSO(compiler, sourceObjectOut);
     JSScript* script = compiler.compileEvalScript(environment, enclosingScope);
     if (!script) {
         return nullptr;
@@ -758,8 +843,8 @@ frontend::CompileModule(JSContext* cx, const ReadOnlyCompileOptions& optionsInpu
     options.allowHTMLComments = false;
 
     RootedScope emptyGlobalScope(cx, &cx->global()->emptyGlobalScope());
-    BytecodeCompiler compiler(cx, alloc, options, srcBuf, emptyGlobalScope);
-    AutoInitializeSourceObject autoSSO(compiler, sourceObjectOut);
+    BytecodeCompiler<char16_t> compiler(cx, alloc, options, srcBuf, emptyGlobalScope);
+    AutoInitializeSourceObject<char16_t> autoSSO(compiler, sourceObjectOut);
     ModuleObject* module = compiler.compileModule();
     if (!module) {
         return nullptr;
@@ -838,8 +923,9 @@ class MOZ_STACK_CLASS AutoAssertFunctionDelazificationCompletion
     }
 };
 
-bool
-frontend::CompileLazyFunction(JSContext* cx, Handle<LazyScript*> lazy, const char16_t* chars, size_t length)
+template <typename Unit>
+static bool
+CompileLazyFunctionImpl(JSContext* cx, Handle<LazyScript*> lazy, const Unit* units, size_t length)
 {
     MOZ_ASSERT(cx->compartment() == lazy->functionNonDelazifying()->compartment());
 
@@ -883,9 +969,9 @@ frontend::CompileLazyFunction(JSContext* cx, Handle<LazyScript*> lazy, const cha
     UsedNameTracker usedNames(cx);
 
     RootedScriptSourceObject sourceObject(cx, &lazy->sourceObject());
-    Parser<FullParseHandler, char16_t> parser(cx, cx->tempLifoAlloc(), options, chars, length,
-                                              /* foldConstants = */ true, usedNames, nullptr,
-                                              lazy, sourceObject, lazy->parseGoal());
+    Parser<FullParseHandler, Unit> parser(cx, cx->tempLifoAlloc(), options, units, length,
+                                          /* foldConstants = */ true, usedNames, nullptr,
+                                          lazy, sourceObject, lazy->parseGoal());
     if (!parser.checkOptions()) {
         return false;
     }
@@ -926,6 +1012,20 @@ frontend::CompileLazyFunction(JSContext* cx, Handle<LazyScript*> lazy, const cha
     return true;
 }
 
+bool
+frontend::CompileLazyFunction(JSContext* cx, Handle<LazyScript*> lazy, const char16_t* units,
+                              size_t length)
+{
+    return CompileLazyFunctionImpl(cx, lazy, units, length);
+}
+
+bool
+frontend::CompileLazyFunction(JSContext* cx, Handle<LazyScript*> lazy, const Utf8Unit* units,
+                              size_t length)
+{
+    return CompileLazyFunctionImpl(cx, lazy, units, length);
+}
+
 #ifdef JS_BUILD_BINAST
 
 bool
@@ -1009,7 +1109,7 @@ frontend::CompileStandaloneFunction(JSContext* cx, MutableHandleFunction fun,
         scope = &cx->global()->emptyGlobalScope();
     }
 
-    BytecodeCompiler compiler(cx, cx->tempLifoAlloc(), options, srcBuf, scope);
+    BytecodeCompiler<char16_t> compiler(cx, cx->tempLifoAlloc(), options, srcBuf, scope);
     if (!compiler.compileStandaloneFunction(fun, GeneratorKind::NotGenerator,
                                             FunctionAsyncKind::SyncFunction,
                                             parameterListEnd))
@@ -1031,7 +1131,7 @@ frontend::CompileStandaloneGenerator(JSContext* cx, MutableHandleFunction fun,
 
     RootedScope emptyGlobalScope(cx, &cx->global()->emptyGlobalScope());
 
-    BytecodeCompiler compiler(cx, cx->tempLifoAlloc(), options, srcBuf, emptyGlobalScope);
+    BytecodeCompiler<char16_t> compiler(cx, cx->tempLifoAlloc(), options, srcBuf, emptyGlobalScope);
     if (!compiler.compileStandaloneFunction(fun, GeneratorKind::Generator,
                                             FunctionAsyncKind::SyncFunction,
                                             parameterListEnd))
@@ -1053,7 +1153,7 @@ frontend::CompileStandaloneAsyncFunction(JSContext* cx, MutableHandleFunction fu
 
     RootedScope emptyGlobalScope(cx, &cx->global()->emptyGlobalScope());
 
-    BytecodeCompiler compiler(cx, cx->tempLifoAlloc(), options, srcBuf, emptyGlobalScope);
+    BytecodeCompiler<char16_t> compiler(cx, cx->tempLifoAlloc(), options, srcBuf, emptyGlobalScope);
     if (!compiler.compileStandaloneFunction(fun, GeneratorKind::NotGenerator,
                                             FunctionAsyncKind::AsyncFunction,
                                             parameterListEnd))
@@ -1075,7 +1175,7 @@ frontend::CompileStandaloneAsyncGenerator(JSContext* cx, MutableHandleFunction f
 
     RootedScope emptyGlobalScope(cx, &cx->global()->emptyGlobalScope());
 
-    BytecodeCompiler compiler(cx, cx->tempLifoAlloc(), options, srcBuf, emptyGlobalScope);
+    BytecodeCompiler<char16_t> compiler(cx, cx->tempLifoAlloc(), options, srcBuf, emptyGlobalScope);
     if (!compiler.compileStandaloneFunction(fun, GeneratorKind::Generator,
                                             FunctionAsyncKind::AsyncFunction,
                                             parameterListEnd))
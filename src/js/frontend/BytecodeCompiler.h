@@ -8,6 +8,7 @@
 #define frontend_BytecodeCompiler_h
 
 #include "mozilla/Maybe.h"
+#include "mozilla/Utf8.h"
 
 #include "NamespaceImports.h"
 
@@ -36,6 +37,16 @@ CompileGlobalScript(JSContext* cx, LifoAlloc& alloc, ScopeKind scopeKind,
                     JS::SourceBufferHolder& srcBuf,
                     ScriptSourceObject** sourceObjectOut = nullptr);
 
+// Compile UTF-8 source directly, without inflating it to UTF-16: it is
+// tokenized as UTF-8 and stored that way in the ScriptSource, so lazy
+// functions are also compiled from it as UTF-8. |units| must stay alive until
+// the compilation has finished.
+JSScript*
+CompileGlobalScript(JSContext* cx, LifoAlloc& alloc, ScopeKind scopeKind,
+                    const JS::ReadOnlyCompileOptions& options,
+                    const mozilla::Utf8Unit* units, size_t length,
+                    ScriptSourceObject** sourceObjectOut = nullptr);
+
 #if defined(JS_BUILD_BINAST)
 
 JSScript*
@@ -66,7 +77,11 @@ CompileModule(JSContext* cx, const JS::ReadOnlyCompileOptions& options,
               ScriptSourceObject** sourceObjectOut = nullptr);
 
 MOZ_MUST_USE bool
-CompileLazyFunction(JSContext* cx, Handle<LazyScript*> lazy, const char16_t* chars, size_t length);
+CompileLazyFunction(JSContext* cx, Handle<LazyScript*> lazy, const char16_t* units, size_t length);
+
+MOZ_MUST_USE bool
+CompileLazyFunction(JSContext* cx, Handle<LazyScript*> lazy, const mozilla::Utf8Unit* units,
+                    size_t length);
 
 //
 // Compile a single function. The source in srcBuf must match the ECMA-262
@@ -3675,10 +3675,112 @@ BytecodeEmitter::emitDestructuringObjRestExclusionSet(ListNode* pattern)
     return true;
 }
 
+bool
+BytecodeEmitter::canUseArrayDestructuringFastPath(ListNode* pattern, DestructuringFlavor flav,
+                                                  uint32_t* count)
+{
+    MOZ_ASSERT(pattern->isKind(ParseNodeKind::Array));
+
+    static const uint32_t MaxFastPathElements = 16;
+
+    if (flav != DestructuringDeclaration || !pattern->head() ||
+        pattern->count() > MaxFastPathElements)
+    {
+        return false;
+    }
+
+    for (ParseNode* member : pattern->contents()) {
+        if (member->isKind(ParseNodeKind::Elision)) {
+            continue;
+        }
+        if (!member->isKind(ParseNodeKind::Name)) {
+            return false;
+        }
+
+        // Initializing a global or dynamically scoped name may run setters
+        // or proxy traps.
+        NameLocation loc = lookupName(member->as<NameNode>().name());
+        if (loc.kind() != NameLocation::Kind::FrameSlot &&
+            loc.kind() != NameLocation::Kind::EnvironmentCoordinate)
+        {
+            return false;
+        }
+    }
+
+    *count = pattern->count();
+    return true;
+}
+
+bool
+BytecodeEmitter::emitDestructuringOpsArrayWithFastPath(ListNode* pattern,
+                                                       DestructuringFlavor flav,
+                                                       uint32_t count)
+{
+    // Here's pseudo code for |let [a, , b] = x;|
+    //
+    //   if (OptimizeArrayDestructuring(x, 3)) {
+    //     a = x[0];
+    //     b = x[2];
+    //   } else {
+    //     // Iterator-based destructuring, as in emitDestructuringOpsArray.
+    //   }
+    //
+    // OptimizeArrayDestructuring only succeeds when the iterator protocol
+    // would produce the same values and have no other observable effects.
+    if (!emitUint32Operand(JSOP_OPTIMIZE_DESTRUCTURING, count)) { // ... OBJ OPTIMIZED
+        return false;
+    }
+
+    JumpList slowPath;
+    if (!emitJump(JSOP_IFEQ, &slowPath)) {                        // ... OBJ
+        return false;
+    }
+
+    uint32_t index = 0;
+    for (ParseNode* member : pattern->contents()) {
+        if (!member->isKind(ParseNodeKind::Elision)) {
+            if (!emit1(JSOP_DUP)) {                               // ... OBJ OBJ
+                return false;
+            }
+            if (!emitNumberOp(index)) {                           // ... OBJ OBJ INDEX
+                return false;
+            }
+            if (!emitElemOpBase(JSOP_GETELEM)) {                  // ... OBJ VALUE
+                return false;
+            }
+            if (!emitSetOrInitializeDestructuring(member, flav)) { // ... OBJ VALUE
+                return false;
+            }
+            if (!emit1(JSOP_POP)) {                               // ... OBJ
+                return false;
+            }
+        }
+        index++;
+    }
+
+    JumpList done;
+    if (!emitJump(JSOP_GOTO, &done)) {                            // ... OBJ
+        return false;
+    }
+
+    if (!emitJumpTargetAndPatch(slowPath)) {                      // ... OBJ
+        return false;
+    }
+    if (!emitDestructuringOpsArray(pattern, flav)) {              // ... OBJ
+        return false;
+    }
+
+    return emitJumpTargetAndPatch(done);                          // ... OBJ
+}
+
 bool
 BytecodeEmitter::emitDestructuringOps(ListNode* pattern, DestructuringFlavor flav)
 {
     if (pattern->isKind(ParseNodeKind::Array)) {
+        uint32_t count;
+        if (canUseArrayDestructuringFastPath(pattern, flav, &count)) {
+            return emitDestructuringOpsArrayWithFastPath(pattern, flav, count);
+        }
         return emitDestructuringOpsArray(pattern, flav);
     }
     return emitDestructuringOpsObject(pattern, flav);
@@ -6779,6 +6881,33 @@ BytecodeEmitter::isRestParameter(ParseNode* expr)
     return false;
 }
 
+bool
+BytecodeEmitter::isOptimizableSpreadArgument(ParseNode* expr)
+{
+    if (isRestParameter(expr)) {
+        return true;
+    }
+
+    // When the operand isn't an optimizable array it is evaluated a second
+    // time, as the operand of the spread into the intermediate array. Only
+    // allow names whose lookup can neither run code nor see a different value
+    // the second time. Self-hosted code spreads with its own iteration
+    // protocol, so leave it alone.
+    if (emitterMode == BytecodeEmitter::SelfHosting || !expr->isKind(ParseNodeKind::Name)) {
+        return false;
+    }
+
+    NameLocation loc = lookupName(expr->as<NameNode>().name());
+    switch (loc.kind()) {
+      case NameLocation::Kind::ArgumentSlot:
+      case NameLocation::Kind::FrameSlot:
+      case NameLocation::Kind::EnvironmentCoordinate:
+        return true;
+      default:
+        return false;
+    }
+}
+
 bool
 BytecodeEmitter::emitCalleeAndThis(ParseNode* callee, ParseNode* call, CallOrNewEmitter& cone)
 {
@@ -6993,8 +7122,8 @@ BytecodeEmitter::emitCallOrNew(BinaryNode* callNode,
     uint32_t argc = argsList->count();
     CallOrNewEmitter cone(this, op,
                           isSpread && (argc == 1) &&
-                          isRestParameter(argsList->head()->as<UnaryNode>().kid())
-                          ? CallOrNewEmitter::ArgumentsKind::SingleSpreadRest
+                          isOptimizableSpreadArgument(argsList->head()->as<UnaryNode>().kid())
+                          ? CallOrNewEmitter::ArgumentsKind::SingleSpread
                           : CallOrNewEmitter::ArgumentsKind::Other,
                           valueUsage);
     if (!emitCalleeAndThis(calleeNode, callNode, cone)) { // CALLEE THIS
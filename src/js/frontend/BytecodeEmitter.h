@@ -686,6 +686,17 @@ struct MOZ_STACK_CLASS BytecodeEmitter
     // {} lhs expression.
     MOZ_MUST_USE bool emitDestructuringOps(ListNode* pattern, DestructuringFlavor flav);
     MOZ_MUST_USE bool emitDestructuringOpsArray(ListNode* pattern, DestructuringFlavor flav);
+
+    // Array destructuring which only initializes local bindings, without
+    // defaults or rest elements, runs no user code between reading the
+    // elements. For these patterns emitDestructuringOpsArrayWithFastPath
+    // emits a guarded path reading the elements by index, ahead of the
+    // iterator-based path.
+    bool canUseArrayDestructuringFastPath(ListNode* pattern, DestructuringFlavor flav,
+                                          uint32_t* count);
+    MOZ_MUST_USE bool emitDestructuringOpsArrayWithFastPath(ListNode* pattern,
+                                                            DestructuringFlavor flav,
+                                                            uint32_t count);
     MOZ_MUST_USE bool emitDestructuringOpsObject(ListNode* pattern, DestructuringFlavor flav);
 
     enum class CopyOption {
@@ -763,6 +774,7 @@ struct MOZ_STACK_CLASS BytecodeEmitter
                                                 ValueUsage valueUsage = ValueUsage::WantValue);
 
     bool isRestParameter(ParseNode* expr);
+    bool isOptimizableSpreadArgument(ParseNode* expr);
 
     MOZ_MUST_USE bool emitArguments(ListNode* argsList, bool isCall, bool isSpread,
                                     CallOrNewEmitter& cone);
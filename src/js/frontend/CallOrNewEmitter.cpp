@@ -223,7 +223,7 @@ CallOrNewEmitter::wantSpreadOperand()
     MOZ_ASSERT(isSpread());
 
     state_ = State::WantSpreadOperand;
-    return isSingleSpreadRest();
+    return isSingleSpread();
 }
 
 bool
@@ -233,18 +233,18 @@ CallOrNewEmitter::emitSpreadArgumentsTest()
     MOZ_ASSERT(state_ == State::WantSpreadOperand);
     MOZ_ASSERT(isSpread());
 
-    if (isSingleSpreadRest()) {
-        // Emit a preparation code to optimize the spread call with a rest
-        // parameter:
+    if (isSingleSpread()) {
+        // Emit a preparation code to optimize the spread call with a single
+        // operand:
         //
         //   function f(...args) {
         //     g(...args);
         //   }
         //
-        // If the spread operand is a rest parameter and it's optimizable
-        // array, skip spread operation and pass it directly to spread call
-        // operation.  See the comment in OptimizeSpreadCall in
-        // Interpreter.cpp for the optimizable conditons.
+        // If the spread operand is an optimizable array, skip spread
+        // operation and pass it directly to spread call operation.  See the
+        // comment in OptimizeSpreadCall in Interpreter.cpp for the
+        // optimizable conditons.
 
         ifNotOptimizable_.emplace(bce_);
         //                                            // CALLEE THIS ARG0
@@ -271,7 +271,7 @@ CallOrNewEmitter::emitEnd(uint32_t argc, const Maybe<uint32_t>& beginPos)
 {
     MOZ_ASSERT(state_ == State::Arguments);
 
-    if (isSingleSpreadRest()) {
+    if (isSingleSpread()) {
         if (!ifNotOptimizable_->emitEnd()) {          // CALLEE THIS ARR
             return false;
         }
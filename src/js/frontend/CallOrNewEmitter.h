@@ -117,9 +117,9 @@ class MOZ_RAII AutoEmittingRunOnceLambda
 //     cone.emitEnd(1, Some(offset_of_callee));
 //
 //   `print(...rest);`
-//   where `rest` is rest parameter
+//   where `rest` is rest parameter or a local variable
 //     CallOrNewEmitter cone(this, JSOP_SPREADCALL,
-//                           CallOrNewEmitter::ArgumentsKind::SingleSpreadRest,
+//                           CallOrNewEmitter::ArgumentsKind::SingleSpread,
 //                           ValueUsage::WantValue);
 //     cone.emitNameCallee(print);
 //     cone.emitThis();
@@ -146,17 +146,22 @@ class MOZ_STACK_CLASS CallOrNewEmitter
     enum class ArgumentsKind {
         Other,
 
-        // Specify this for the following case:
+        // Specify this for the following cases:
         //
         //   function f(...rest) {
         //     g(...rest);
         //   }
         //
-        // This enables optimization to avoid allocating an intermediate array
-        // for spread operation.
+        //   function f(args) {
+        //     g(...args);
+        //   }
+        //
+        // where the single spread operand can be evaluated again without side
+        // effects. This enables optimization to avoid allocating an
+        // intermediate array for spread operation.
         //
         // wantSpreadOperand() returns true when this is specified.
-        SingleSpreadRest
+        SingleSpread
     };
 
   private:
@@ -165,7 +170,8 @@ class MOZ_STACK_CLASS CallOrNewEmitter
     // The opcode for the call or new.
     JSOp op_;
 
-    // Whether the call is a spread call with single rest parameter or not.
+    // Whether the call is a spread call with single optimizable operand or
+    // not.
     // See the comment in emitSpreadArgumentsTest for more details.
     ArgumentsKind argumentsKind_;
 
@@ -295,8 +301,8 @@ class MOZ_STACK_CLASS CallOrNewEmitter
         return JOF_OPTYPE(op_) == JOF_BYTE;
     }
 
-    MOZ_MUST_USE bool isSingleSpreadRest() const {
-        return argumentsKind_ == ArgumentsKind::SingleSpreadRest;
+    MOZ_MUST_USE bool isSingleSpread() const {
+        return argumentsKind_ == ArgumentsKind::SingleSpread;
     }
 
   public:
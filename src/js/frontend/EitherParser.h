@@ -16,6 +16,7 @@
 #include "mozilla/Move.h"
 #include "mozilla/Tuple.h"
 #include "mozilla/TypeTraits.h"
+#include "mozilla/Utf8.h"
 #include "mozilla/Variant.h"
 
 #include <utility>
@@ -126,8 +127,8 @@ namespace frontend {
 
 class EitherParser : public BCEParserHandle
 {
-    // Leave this as a variant, to promote good form until 8-bit parser integration.
-    mozilla::Variant<Parser<FullParseHandler, char16_t>* const> parser;
+    mozilla::Variant<Parser<FullParseHandler, char16_t>* const,
+                     Parser<FullParseHandler, mozilla::Utf8Unit>* const> parser;
 
     using Node = typename FullParseHandler::Node;
 
@@ -987,7 +987,12 @@ GeneralParser<ParseHandler, Unit>::GeneralParser(JSContext* cx, LifoAlloc& alloc
   : Base(cx, alloc, options, foldConstants, usedNames, syntaxParser, lazyOuterFunction,
          sourceObject, parseGoal),
     tokenStream(cx, options, units, length)
-{}
+{
+    // The syntax parser mostly sees the same names, so let it use our atoms.
+    if (syntaxParser) {
+        syntaxParser->tokenStream.shareAtomCache(tokenStream);
+    }
+}
 
 template <typename Unit>
 void
@@ -2795,6 +2800,7 @@ PerHandlerParser<SyntaxParseHandler>::finishFunction(bool isStandaloneFunction /
     }
     lazy->setGeneratorKind(funbox->generatorKind());
     lazy->setAsyncKind(funbox->asyncKind());
+    lazy->setFunLength(funbox->length);
     if (funbox->hasRest()) {
         lazy->setHasRest();
     }
@@ -3845,6 +3851,13 @@ Parser<FullParseHandler, Unit>::trySyntaxParseInnerFunction(CodeNode** funNode,
             break;
         }
 
+        // Functions which the embedding expects to be called soon, see
+        // TransitiveCompileOptions::eagerFunctionsSourceLength, are fully
+        // parsed as well, whether or not they are IIFEs.
+        if (toStringStart < options().eagerFunctionsSourceLength) {
+            break;
+        }
+
         SyntaxParser* syntaxParser = getSyntaxParser();
         if (!syntaxParser) {
             break;
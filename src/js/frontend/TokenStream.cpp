@@ -12,6 +12,7 @@
 #include "mozilla/Attributes.h"
 #include "mozilla/IntegerTypeTraits.h"
 #include "mozilla/Likely.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/MemoryChecking.h"
 #include "mozilla/ScopeExit.h"
@@ -42,8 +43,14 @@
 #include "vm/JSContext.h"
 #include "vm/Realm.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define JS_TOKENSTREAM_SSE2
+#  include <emmintrin.h>
+#endif
+
 using mozilla::ArrayLength;
 using mozilla::AssertedCast;
+using mozilla::CountTrailingZeroes32;
 using mozilla::DecodeOneUtf8CodePoint;
 using mozilla::IsAscii;
 using mozilla::IsAsciiAlpha;
@@ -474,6 +481,23 @@ TokenStreamCharsBase<Unit>::TokenStreamCharsBase(JSContext* cx, const Unit* unit
     sourceUnits(units, length, startOffset)
 {}
 
+template<typename Unit>
+MOZ_MUST_USE bool
+TokenStreamCharsBase<Unit>::appendAsciiUnitsToCharBuffer(const Unit* cur, const Unit* end)
+{
+    size_t oldLength = this->charBuffer.length();
+    if (!this->charBuffer.growByUninitialized(PointerRangeSize(cur, end))) {
+        return false;
+    }
+
+    char16_t* dest = this->charBuffer.begin() + oldLength;
+    while (cur < end) {
+        MOZ_ASSERT(IsAscii(*cur));
+        *dest++ = char16_t(CodeUnitValue(*cur++));
+    }
+    return true;
+}
+
 template<>
 MOZ_MUST_USE bool
 TokenStreamCharsBase<char16_t>::fillCharBufferFromSourceNormalizingAsciiLineBreaks(const char16_t* cur,
@@ -2098,11 +2122,110 @@ static const uint8_t firstCharKinds[] = {
 static_assert(LastCharKind < (1 << (sizeof(firstCharKinds[0]) * 8)),
               "Elements of firstCharKinds[] are too small");
 
+template<typename Unit, size_t N>
+static inline bool
+IsPlainAsciiCodeUnit(Unit unit, const char (&stops)[N])
+{
+    uint32_t value = CodeUnitValue(unit);
+    if (value >= 0x80 || value == '\n' || value == '\r') {
+        return false;
+    }
+    for (size_t i = 0; i < N; i++) {
+        if (value == uint8_t(stops[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+#ifdef JS_TOKENSTREAM_SSE2
+
+// The SkipPlainAsciiVectors functions return a pointer to the first code unit
+// in [units, limit) that isn't plain (per IsPlainAsciiCodeUnit), or a pointer
+// to the point where less than a vector's worth of code units remains.
+
+template<size_t N>
+static const char16_t*
+SkipPlainAsciiVectors(const char16_t* units, const char16_t* limit, const char (&stops)[N])
+{
+    static const size_t Lanes = sizeof(__m128i) / sizeof(char16_t);
+
+    const __m128i nonAsciiBits = _mm_set1_epi16(int16_t(0xFF80));
+    const __m128i zero = _mm_setzero_si128();
+    while (PointerRangeSize(units, limit) >= Lanes) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(units));
+
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi16(v, _mm_set1_epi16('\n')),
+                                       _mm_cmpeq_epi16(v, _mm_set1_epi16('\r')));
+        for (size_t i = 0; i < N; i++) {
+            special = _mm_or_si128(special, _mm_cmpeq_epi16(v, _mm_set1_epi16(stops[i])));
+        }
+        __m128i ascii = _mm_cmpeq_epi16(_mm_and_si128(v, nonAsciiBits), zero);
+
+        // Each lane sets two bits in the mask.
+        uint32_t mask = ~uint32_t(_mm_movemask_epi8(_mm_andnot_si128(special, ascii))) & 0xFFFF;
+        if (mask) {
+            return units + CountTrailingZeroes32(mask) / 2;
+        }
+        units += Lanes;
+    }
+    return units;
+}
+
+template<size_t N>
+static const Utf8Unit*
+SkipPlainAsciiVectors(const Utf8Unit* units, const Utf8Unit* limit, const char (&stops)[N])
+{
+    static const size_t Lanes = sizeof(__m128i) / sizeof(Utf8Unit);
+
+    while (PointerRangeSize(units, limit) >= Lanes) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(units));
+
+        __m128i special = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\n')),
+                                       _mm_cmpeq_epi8(v, _mm_set1_epi8('\r')));
+        for (size_t i = 0; i < N; i++) {
+            special = _mm_or_si128(special, _mm_cmpeq_epi8(v, _mm_set1_epi8(stops[i])));
+        }
+
+        // Non-ASCII units have their high bit set.
+        uint32_t mask = uint32_t(_mm_movemask_epi8(_mm_or_si128(special, v)));
+        if (mask) {
+            return units + CountTrailingZeroes32(mask);
+        }
+        units += Lanes;
+    }
+    return units;
+}
+
+#endif // JS_TOKENSTREAM_SSE2
+
+template<typename Unit>
+template<size_t N>
+void
+SourceUnits<Unit>::consumePlainAsciiCodeUnits(const char (&stops)[N])
+{
+    MOZ_ASSERT(ptr, "shouldn't use poisoned SourceUnits");
+
+    const Unit* p = ptr;
+#ifdef JS_TOKENSTREAM_SSE2
+    p = SkipPlainAsciiVectors(p, limit_, stops);
+#endif
+    while (p < limit_ && IsPlainAsciiCodeUnit(*p, stops)) {
+        p++;
+    }
+    ptr = p;
+}
+
 template<>
 void
 SourceUnits<char16_t>::consumeRestOfSingleLineComment()
 {
     while (MOZ_LIKELY(!atEnd())) {
+        consumePlainAsciiCodeUnits("");
+        if (atEnd()) {
+            return;
+        }
+
         char16_t unit = peekCodeUnit();
         if (IsLineTerminator(unit)) {
             return;
@@ -2117,6 +2240,11 @@ void
 SourceUnits<Utf8Unit>::consumeRestOfSingleLineComment()
 {
     while (MOZ_LIKELY(!atEnd())) {
+        consumePlainAsciiCodeUnits("");
+        if (atEnd()) {
+            return;
+        }
+
         const Utf8Unit unit = peekCodeUnit();
         if (IsSingleUnitLineTerminator(unit)) {
             return;
@@ -2814,6 +2942,9 @@ TokenStreamSpecific<Unit, AnyCharsAccess>::getTokenInternal(TokenKind* const ttp
                 unsigned linenoBefore = anyChars.lineno;
 
                 do {
+                    // Nothing needs doing for most of a comment's code units.
+                    this->sourceUnits.consumePlainAsciiCodeUnits("*@#");
+
                     int32_t unit = getCodeUnit();
                     if (unit == EOF) {
                         reportError(JSMSG_UNTERMINATED_COMMENT);
@@ -2936,7 +3067,21 @@ TokenStreamSpecific<Unit, AnyCharsAccess>::getStringOrTemplateToken(char untilCh
     // equivalents), \\, EOF.  Because we detect EOL sequences here and
     // put them back immediately, we can use getCodeUnit().
     int32_t unit;
-    while ((unit = getCodeUnit()) != untilChar) {
+    while (true) {
+        // Runs of ASCII code units that stand for themselves are copied in
+        // bulk.  Stopping at either quote, '`' and '$' regardless of the kind
+        // of literal keeps things simple.
+        const Unit* run = this->sourceUnits.addressOfNextCodeUnit();
+        this->sourceUnits.consumePlainAsciiCodeUnits("'\"`\\$");
+        if (!appendAsciiUnitsToCharBuffer(run, this->sourceUnits.addressOfNextCodeUnit())) {
+            return false;
+        }
+
+        unit = getCodeUnit();
+        if (unit == untilChar) {
+            break;
+        }
+
         if (unit == EOF) {
             ReportPrematureEndOfLiteral(JSMSG_EOF_BEFORE_END_OF_LITERAL);
             return false;
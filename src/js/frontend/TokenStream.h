@@ -1393,6 +1393,17 @@ class SourceUnits
      */
     void consumeRestOfSingleLineComment();
 
+    /**
+     * Consume ASCII code units that are neither LineTerminators nor any of
+     * the code units in |stops| (including its terminating '\0'), stopping at
+     * the end of the source or at the first code unit that doesn't qualify.
+     * Code units are examined a vector at a time where SSE2 is available.
+     *
+     * As no LineTerminator is consumed, line info doesn't need updating.
+     */
+    template<size_t N>
+    void consumePlainAsciiCodeUnits(const char (&stops)[N]);
+
     /**
      * The maximum radius of code around the location of an error that should
      * be included in a syntax error message -- this many code units to either
@@ -1462,6 +1473,48 @@ SourceUnits<mozilla::Utf8Unit>::ungetLineOrParagraphSeparator()
     MOZ_ASSERT(last == 0xA8 || last == 0xA9);
 }
 
+/**
+ * A small direct-mapped cache of the atoms most recently created for names
+ * and string literals.  The same names tend to recur within a few tokens, and
+ * the cache lets them be found again without the static strings lookup, the
+ * zone's atom cache or (for UTF-8 source) inflating them to UTF-16 first.  A
+ * full parser shares its cache with its syntax parser.
+ *
+ * The cached atoms are kept alive by the parser's AutoKeepAtoms.
+ */
+class TokenAtomCache
+{
+    static constexpr size_t NumEntriesLog2 = 8;
+
+    JSAtom* entries_[size_t(1) << NumEntriesLog2] = {};
+
+  public:
+    TokenAtomCache() = default;
+    TokenAtomCache(const TokenAtomCache&) = delete;
+    void operator=(const TokenAtomCache&) = delete;
+
+    template<typename CharT>
+    JSAtom* atomize(JSContext* cx, const CharT* chars, size_t length) {
+        HashNumber hash = mozilla::HashString(chars, length);
+        JSAtom*& entry = entries_[hash >> (js::kHashNumberBits - NumEntriesLog2)];
+        if (entry && entry->hash() == hash && entry->length() == length) {
+            JS::AutoCheckCannotGC nogc;
+            bool equal = entry->hasLatin1Chars()
+                         ? EqualChars(entry->latin1Chars(nogc), chars, length)
+                         : EqualChars(entry->twoByteChars(nogc), chars, length);
+            if (equal) {
+                return entry;
+            }
+        }
+
+        JSAtom* atom = AtomizeChars(cx, chars, length);
+        if (atom) {
+            entry = atom;
+        }
+        return atom;
+    }
+};
+
 class TokenStreamCharsShared
 {
     // Using char16_t (not Unit) is a simplifying decision that hopefully
@@ -1477,9 +1530,17 @@ class TokenStreamCharsShared
      */
     CharBuffer charBuffer;
 
+  private:
+    TokenAtomCache ownAtomCache;
+
+  protected:
+    /** The cache used to atomize names and literals, possibly shared. */
+    TokenAtomCache* atomCache;
+
   protected:
     explicit TokenStreamCharsShared(JSContext* cx)
-      : charBuffer(cx)
+      : charBuffer(cx),
+        atomCache(&ownAtomCache)
     {}
 
     MOZ_MUST_USE bool appendCodePointToCharBuffer(uint32_t codePoint);
@@ -1497,13 +1558,21 @@ class TokenStreamCharsShared
     }
 
     JSAtom* drainCharBufferIntoAtom(JSContext* cx) {
-        JSAtom* atom = AtomizeChars(cx, charBuffer.begin(), charBuffer.length());
+        JSAtom* atom = atomCache->atomize(cx, charBuffer.begin(), charBuffer.length());
         charBuffer.clear();
         return atom;
     }
 
   public:
     CharBuffer& getCharBuffer() { return charBuffer; }
+
+    /**
+     * Atomize using |other|'s atom cache, which must outlive this.  Used to
+     * share the full parser's cache with its syntax parser.
+     */
+    void shareAtomCache(TokenStreamCharsShared& other) {
+        atomCache = other.atomCache;
+    }
 };
 
 inline mozilla::Span<const char>
@@ -1547,7 +1616,7 @@ class TokenStreamCharsBase
         sourceUnits.ungetCodeUnit();
     }
 
-    static MOZ_ALWAYS_INLINE JSAtom*
+    MOZ_ALWAYS_INLINE JSAtom*
     atomizeSourceChars(JSContext* cx, mozilla::Span<const Unit> units);
 
     using SourceUnits = frontend::SourceUnits<Unit>;
@@ -1596,6 +1665,9 @@ class TokenStreamCharsBase
     MOZ_MUST_USE bool
     fillCharBufferFromSourceNormalizingAsciiLineBreaks(const Unit* cur, const Unit* end);
 
+    /** Append the provided range of ASCII code units to |charBuffer|. */
+    MOZ_MUST_USE bool appendAsciiUnitsToCharBuffer(const Unit* cur, const Unit* end);
+
     /**
      * Add a null-terminated line of context to error information, for the line
      * in |sourceUnits| that contains |offset|.  Also record the window's
@@ -1640,20 +1712,29 @@ TokenStreamCharsBase<Unit>::consumeKnownCodeUnit(int32_t unit)
 }
 
 template<>
-/* static */ MOZ_ALWAYS_INLINE JSAtom*
+MOZ_ALWAYS_INLINE JSAtom*
 TokenStreamCharsBase<char16_t>::atomizeSourceChars(JSContext* cx,
                                                    mozilla::Span<const char16_t> units)
 {
-    return AtomizeChars(cx, units.data(), units.size());
+    return atomCache->atomize(cx, units.data(), units.size());
 }
 
 template<>
-/* static */ MOZ_ALWAYS_INLINE JSAtom*
+MOZ_ALWAYS_INLINE JSAtom*
 TokenStreamCharsBase<mozilla::Utf8Unit>::atomizeSourceChars(JSContext* cx,
                                                             mozilla::Span<const mozilla::Utf8Unit> units)
 {
     auto chars = ToCharSpan(units);
-    return AtomizeUTF8Chars(cx, chars.data(), chars.size());
+
+    // ASCII text, by far the most common kind of name, can be atomized as
+    // Latin-1 without being inflated first.
+    for (char c : chars) {
+        if (MOZ_UNLIKELY(!mozilla::IsAscii(c))) {
+            return AtomizeUTF8Chars(cx, chars.data(), chars.size());
+        }
+    }
+    return atomCache->atomize(cx, reinterpret_cast<const JS::Latin1Char*>(chars.data()),
+                              chars.size());
 }
 
 template<typename Unit>
@@ -2315,6 +2396,7 @@ class MOZ_STACK_CLASS TokenStreamSpecific
     using typename CharsBase::SourceUnits;
 
   private:
+    using CharsBase::appendAsciiUnitsToCharBuffer;
     using TokenStreamCharsShared::appendCodePointToCharBuffer;
     using CharsBase::atomizeSourceChars;
     using GeneralCharsBase::badToken;
@@ -65,7 +65,6 @@ namespace gc {
     D(FAT_INLINE_ATOM,     String,       js::FatInlineAtom, js::FatInlineAtom, true,   false,  true) \
     D(ATOM,                String,       js::NormalAtom,    js::NormalAtom,    true,   false,  true) \
     D(SYMBOL,              Symbol,       JS::Symbol,        JS::Symbol,        true,   false,  false) \
-    IF_BIGINT(D(BIGINT,    BigInt,       JS::BigInt,        JS::BigInt,        true,   false,  false),) \
     D(JITCODE,             JitCode,      js::jit::JitCode,  js::jit::JitCode,  false,  false,  false) \
     D(SCOPE,               Scope,        js::Scope,         js::Scope,         true,   false,  true) \
     D(REGEXP_SHARED,       RegExpShared, js::RegExpShared,  js::RegExpShared,  true,   false,  true)
@@ -74,9 +73,13 @@ namespace gc {
     D(FAT_INLINE_STRING,   String,        JSFatInlineString, JSFatInlineString, true,   true,  true) \
     D(STRING,              String,        JSString,          JSString,          true,   true,  true)
 
+#define FOR_EACH_NURSERY_BIGINT_ALLOCKIND(D) \
+    IF_BIGINT(D(BIGINT,    BigInt,        JS::BigInt,        JS::BigInt,        true,   true,  false),)
+
 #define FOR_EACH_NONOBJECT_ALLOCKIND(D) \
     FOR_EACH_NONOBJECT_NONNURSERY_ALLOCKIND(D) \
-    FOR_EACH_NURSERY_STRING_ALLOCKIND(D)
+    FOR_EACH_NURSERY_STRING_ALLOCKIND(D) \
+    FOR_EACH_NURSERY_BIGINT_ALLOCKIND(D)
 
 #define FOR_EACH_ALLOCKIND(D)    \
     FOR_EACH_OBJECT_ALLOCKIND(D) \
@@ -11,8 +11,12 @@
 #include "gc/GCInternals.h"
 #include "gc/GCTrace.h"
 #include "gc/Nursery.h"
+#include "gc/Pretenuring.h"
 #include "jit/JitRealm.h"
 #include "threading/CpuCount.h"
+#ifdef ENABLE_BIGINT
+#include "vm/BigIntType.h"
+#endif
 #include "vm/JSContext.h"
 #include "vm/Runtime.h"
 #include "vm/StringType.h"
@@ -56,8 +60,15 @@ js::Allocate(JSContext* cx, AllocKind kind, size_t nDynamicSlots, InitialHeap he
         return nullptr;
     }
 
+    // Allocations attributed to a long-lived site are pretenured.
+    AllocSite* site = cx->nursery().currentAllocSite();
+    if (site && site->isLongLived()) {
+        heap = TenuredHeap;
+    }
+
     if (cx->nursery().isEnabled() && heap != TenuredHeap) {
-        JSObject* obj = rt->gc.tryNewNurseryObject<allowGC>(cx, thingSize, nDynamicSlots, clasp);
+        JSObject* obj = rt->gc.tryNewNurseryObject<allowGC>(cx, thingSize, nDynamicSlots, clasp,
+                                                            site);
         if (obj) {
             return obj;
         }
@@ -86,7 +97,8 @@ template JSObject* js::Allocate<JSObject, CanGC>(JSContext* cx, gc::AllocKind ki
 // nullptr.
 template <AllowGC allowGC>
 JSObject*
-GCRuntime::tryNewNurseryObject(JSContext* cx, size_t thingSize, size_t nDynamicSlots, const Class* clasp)
+GCRuntime::tryNewNurseryObject(JSContext* cx, size_t thingSize, size_t nDynamicSlots, const Class* clasp,
+                               AllocSite* site)
 {
     MOZ_RELEASE_ASSERT(!cx->helperThread());
 
@@ -94,7 +106,7 @@ GCRuntime::tryNewNurseryObject(JSContext* cx, size_t thingSize, size_t nDynamicS
     MOZ_ASSERT(!cx->isNurseryAllocSuppressed());
     MOZ_ASSERT(!cx->zone()->isAtomsZone());
 
-    JSObject* obj = cx->nursery().allocateObject(cx, thingSize, nDynamicSlots, clasp);
+    JSObject* obj = cx->nursery().allocateObject(cx, thingSize, nDynamicSlots, clasp, site);
     if (obj) {
         return obj;
     }
@@ -104,7 +116,7 @@ GCRuntime::tryNewNurseryObject(JSContext* cx, size_t thingSize, size_t nDynamicS
 
         // Exceeding gcMaxBytes while tenuring can disable the Nursery.
         if (cx->nursery().isEnabled()) {
-            return cx->nursery().allocateObject(cx, thingSize, nDynamicSlots, clasp);
+            return cx->nursery().allocateObject(cx, thingSize, nDynamicSlots, clasp, site);
         }
     }
     return nullptr;
@@ -223,6 +235,82 @@ js::AllocateString(JSContext* cx, InitialHeap heap)
 FOR_EACH_NURSERY_STRING_ALLOCKIND(DECL_ALLOCATOR_INSTANCES)
 #undef DECL_ALLOCATOR_INSTANCES
 
+#ifdef ENABLE_BIGINT
+// Attempt to allocate a new BigInt out of the nursery. If there is not enough
+// room in the nursery or there is an OOM, this method will return nullptr.
+template <AllowGC allowGC>
+JS::BigInt*
+GCRuntime::tryNewNurseryBigInt(JSContext* cx, size_t thingSize, AllocKind kind)
+{
+    MOZ_ASSERT(IsNurseryAllocable(kind));
+    MOZ_ASSERT(cx->isNurseryAllocAllowed());
+    MOZ_ASSERT(!cx->helperThread());
+    MOZ_ASSERT(!cx->isNurseryAllocSuppressed());
+    MOZ_ASSERT(!cx->zone()->isAtomsZone());
+
+    Cell* cell = cx->nursery().allocateBigInt(cx->zone(), thingSize, kind);
+    if (cell) {
+        return static_cast<JS::BigInt*>(cell);
+    }
+
+    if (allowGC && !cx->suppressGC) {
+        cx->runtime()->gc.minorGC(JS::gcreason::OUT_OF_NURSERY);
+
+        // Exceeding gcMaxBytes while tenuring can disable the Nursery, and
+        // other heuristics can disable nursery BigInts for this zone.
+        if (cx->nursery().isEnabled() && cx->zone()->allocNurseryBigInts) {
+            return static_cast<JS::BigInt*>(cx->nursery().allocateBigInt(cx->zone(), thingSize, kind));
+        }
+    }
+    return nullptr;
+}
+
+template <AllowGC allowGC /* = CanGC */>
+JS::BigInt*
+js::AllocateBigInt(JSContext* cx, InitialHeap heap)
+{
+    AllocKind kind = MapTypeToFinalizeKind<JS::BigInt>::kind;
+    size_t size = sizeof(JS::BigInt);
+    MOZ_ASSERT(size == Arena::thingSize(kind));
+
+    // Off-thread alloc cannot trigger GC or make runtime assertions.
+    if (cx->isNurseryAllocSuppressed()) {
+        JS::BigInt* bi = GCRuntime::tryNewTenuredThing<JS::BigInt, NoGC>(cx, kind, size);
+        if (MOZ_UNLIKELY(allowGC && !bi)) {
+            ReportOutOfMemory(cx);
+        }
+        return bi;
+    }
+
+    JSRuntime* rt = cx->runtime();
+    if (!rt->gc.checkAllocatorState<allowGC>(cx, kind)) {
+        return nullptr;
+    }
+
+    if (cx->nursery().isEnabled() &&
+        heap != TenuredHeap &&
+        cx->nursery().canAllocateBigInts() &&
+        cx->zone()->allocNurseryBigInts)
+    {
+        JS::BigInt* bi = rt->gc.tryNewNurseryBigInt<allowGC>(cx, size, kind);
+        if (bi) {
+            return bi;
+        }
+
+        // See the comment in AllocateString: NoGC callers must retry with
+        // CanGC so that the nursery is collected.
+        if (!allowGC) {
+            return nullptr;
+        }
+    }
+
+    return GCRuntime::tryNewTenuredThing<JS::BigInt, allowGC>(cx, kind, size);
+}
+
+template JS::BigInt* js::AllocateBigInt<NoGC>(JSContext* cx, InitialHeap heap);
+template JS::BigInt* js::AllocateBigInt<CanGC>(JSContext* cx, InitialHeap heap);
+#endif
+
 template <typename T, AllowGC allowGC /* = CanGC */>
 T*
 js::Allocate(JSContext* cx)
@@ -577,10 +665,23 @@ GCRuntime::wantBackgroundAllocation(const AutoLockGC& lock) const
     // allocation if we already have some empty chunks or when the runtime has
     // a small heap size (and therefore likely has a small growth rate).
     return allocTask.enabled() &&
-           emptyChunks(lock).count() < tunables.minEmptyChunkCount(lock) &&
+           emptyChunks(lock).count() < emptyChunkReserve(lock) &&
            (fullChunks(lock).count() + availableChunks(lock).count()) >= 4;
 }
 
+void
+GCRuntime::maybeStartBackgroundAllocation()
+{
+    {
+        AutoLockGC lock(rt);
+        if (!wantBackgroundAllocation(lock)) {
+            return;
+        }
+    }
+
+    startBackgroundAllocTaskIfIdle(); // Ignore failure.
+}
+
 Arena*
 GCRuntime::allocateArena(Chunk* chunk, Zone* zone, AllocKind thingKind,
                          ShouldCheckThresholds checkThresholds, const AutoLockGC& lock)
@@ -768,6 +869,20 @@ Chunk::allocate(JSRuntime* rt)
         return nullptr;
     }
     rt->gc.stats().count(gcstats::STAT_NEW_CHUNK);
+
+    // This is only a hint and allocation carries on without huge pages if it
+    // is refused. Chunks are smaller than a huge page, but adjacent chunks are
+    // usually mapped next to each other and can then share one.
+    if (rt->gc.useHugePages() && MarkPagesHuge(chunk, ChunkSize)) {
+        rt->gc.stats().count(gcstats::STAT_HUGE_PAGE_CHUNK);
+    }
+
+    // Also a hint. The chunk's pages haven't been touched yet, so this
+    // decides where all of them end up.
+    if (rt->gc.useNumaLocalChunks() && GetNumaNodeCount() > 1) {
+        BindPagesToNumaNode(chunk, ChunkSize, rt->gc.numaNodeForChunks());
+    }
+
     return chunk;
 }
 
@@ -64,6 +64,13 @@ Allocate<JSFatInlineString, NoGC>(JSContext* cx, gc::InitialHeap heap)
     return static_cast<JSFatInlineString*>(js::AllocateString<JSFatInlineString, NoGC>(cx, heap));
 }
 
+#ifdef ENABLE_BIGINT
+// Use for BigInts, which may be allocated in the nursery.
+template <AllowGC allowGC = CanGC>
+JS::BigInt*
+AllocateBigInt(JSContext* cx, gc::InitialHeap heap);
+#endif
+
 } // namespace js
 
 #endif // gc_Allocator_h
@@ -223,6 +223,20 @@ js::gc::SortedArenaList::extractEmpty(Arena** empty)
     }
 }
 
+void
+js::gc::SortedArenaList::takeFrom(SortedArenaList& other)
+{
+    MOZ_ASSERT(other.thingsPerArena_ == thingsPerArena_);
+    for (size_t i = 0; i <= thingsPerArena_; ++i) {
+        SortedArenaListSegment& segment = other.segments[i];
+        if (!segment.isEmpty()) {
+            segments[i].linkTo(segment.head);
+            segments[i].tailp = segment.tailp;
+            segment.clear();
+        }
+    }
+}
+
 js::gc::ArenaList
 js::gc::SortedArenaList::toArenaList()
 {
@@ -29,8 +29,10 @@ struct Statistics;
 namespace gc {
 
 class Arena;
+class ArenasToRelocate;
 struct FinalizePhase;
 class FreeSpan;
+class ParallelTenurer;
 class TenuredCell;
 
 /*
@@ -147,8 +149,9 @@ class ArenaList {
 
     Arena* removeRemainingArenas(Arena** arenap);
     Arena** pickArenasToRelocate(size_t& arenaTotalOut, size_t& relocTotalOut);
-    Arena* relocateArenas(Arena* toRelocate, Arena* relocated,
-                          js::SliceBudget& sliceBudget, gcstats::Statistics& stats);
+
+    // Appends |arenas| to the end of the list.
+    void restoreRemainingArenas(Arena* arenas);
 };
 
 /*
@@ -193,6 +196,10 @@ class SortedArenaList
     // Remove all empty arenas, inserting them as a linked list.
     inline void extractEmpty(Arena** empty);
 
+    // Moves the arenas of |other|, which must be for the same alloc kind, to
+    // the ends of the corresponding segments of this list.
+    inline void takeFrom(SortedArenaList& other);
+
     // Links up the tail of each non-empty segment to the head of the next
     // non-empty segment, creating a contiguous list that is returned as an
     // ArenaList. This is not a destructive operation: neither the head nor tail
@@ -331,8 +338,8 @@ class ArenaLists
 
     bool checkEmptyArenaList(AllocKind kind);
 
-    bool relocateArenas(Arena*& relocatedListOut, JS::gcreason::Reason reason,
-                        js::SliceBudget& sliceBudget, gcstats::Statistics& stats);
+    bool removeArenasToRelocate(ArenasToRelocate& toRelocate, JS::gcreason::Reason reason);
+    bool restoreUnrelocatedArenas(ArenasToRelocate& toRelocate);
 
     void queueForegroundObjectsForSweep(FreeOp* fop);
     void queueForegroundThingsForSweep();
@@ -343,6 +350,11 @@ class ArenaLists
                             SortedArenaList& sweepList);
     static void backgroundFinalize(FreeOp* fop, Arena* listHead, Arena** empty);
 
+    // Finish background finalization of |thingKind| by merging |finalized|,
+    // which holds all the swept arenas of that kind except the empty ones,
+    // back into the arena lists.
+    void mergeBackgroundFinalized(AllocKind thingKind, SortedArenaList& finalized);
+
     void setParallelAllocEnabled(bool enabled);
 
     // When finalizing arenas, whether to keep empty arenas on the list or
@@ -367,6 +379,7 @@ class ArenaLists
     friend class GCRuntime;
     friend class js::Nursery;
     friend class js::TenuringTracer;
+    friend class ParallelTenurer;
 };
 
 } /* namespace gc */
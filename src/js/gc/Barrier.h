@@ -283,6 +283,14 @@ template <typename S> struct ReadBarrierFunctor : public VoidDefaultAdaptor<S> {
     template <typename T> void operator()(T* t);
 };
 
+// Only objects, strings and BigInts are allocated in the nursery, so only
+// Values holding one of these need to be recorded in the store buffer.
+static MOZ_ALWAYS_INLINE bool
+ValueIsNurseryAllocable(const Value& v)
+{
+    return v.isObject() || v.isString() IF_BIGINT(|| v.isBigInt(),);
+}
+
 template <>
 struct InternalBarrierMethods<Value>
 {
@@ -298,19 +306,19 @@ struct InternalBarrierMethods<Value>
 
         // If the target needs an entry, add it.
         js::gc::StoreBuffer* sb;
-        if ((next.isObject() || next.isString()) && (sb = next.toGCThing()->storeBuffer())) {
+        if (ValueIsNurseryAllocable(next) && (sb = next.toGCThing()->storeBuffer())) {
             // If we know that the prev has already inserted an entry, we can
             // skip doing the lookup to add the new entry. Note that we cannot
             // safely assert the presence of the entry because it may have been
             // added via a different store buffer.
-            if ((prev.isObject() || prev.isString()) && prev.toGCThing()->storeBuffer()) {
+            if (ValueIsNurseryAllocable(prev) && prev.toGCThing()->storeBuffer()) {
                 return;
             }
             sb->putValue(vp);
             return;
         }
         // Remove the prev entry if the new value does not need it.
-        if ((prev.isObject() || prev.isString()) && (sb = prev.toGCThing()->storeBuffer())) {
+        if (ValueIsNurseryAllocable(prev) && (sb = prev.toGCThing()->storeBuffer())) {
             sb->unputValue(vp);
         }
     }
@@ -722,7 +730,7 @@ class HeapSlot : public WriteBarrieredBase<Value>
 #ifdef DEBUG
         assertPreconditionForWriteBarrierPost(owner, kind, slot, target);
 #endif
-        if (this->value.isObject() || this->value.isString()) {
+        if (ValueIsNurseryAllocable(this->value)) {
             gc::Cell* cell = this->value.toGCThing();
             if (cell->storeBuffer()) {
                 cell->storeBuffer()->putSlot(owner, kind, slot, 1);
@@ -77,6 +77,11 @@ struct alignas(gc::CellAlignBytes) Cell
     // 1376646.
     static constexpr uintptr_t JSSTRING_BIT = JS_BIT(1);
 
+    // When a Cell is in the nursery and JSSTRING_BIT is clear, this will
+    // indicate if it is a BigInt (1) or JSObject (0). Objects store their
+    // group pointer in the first word, which is always cell aligned.
+    static constexpr uintptr_t BIGINT_BIT = JS_BIT(2);
+
     MOZ_ALWAYS_INLINE bool isTenured() const { return !IsInsideNursery(this); }
     MOZ_ALWAYS_INLINE const TenuredCell& asTenured() const;
     MOZ_ALWAYS_INLINE TenuredCell& asTenured();
@@ -113,6 +118,12 @@ struct alignas(gc::CellAlignBytes) Cell
         return firstWord & JSSTRING_BIT;
     }
 
+    inline bool nurseryCellIsBigInt() const {
+        MOZ_ASSERT(!isTenured());
+        uintptr_t firstWord = *reinterpret_cast<const uintptr_t*>(this);
+        return (firstWord & (JSSTRING_BIT | BIGINT_BIT)) == BIGINT_BIT;
+    }
+
     template <class T>
     inline bool is() const {
         return getTraceKind() == JS::MapTypeToTraceKind<T>::kind;
@@ -162,6 +173,7 @@ class TenuredCell : public Cell
 
     // The return value indicates if the cell went from unmarked to marked.
     MOZ_ALWAYS_INLINE bool markIfUnmarked(MarkColor color = MarkColor::Black) const;
+    MOZ_ALWAYS_INLINE bool markIfUnmarkedAtomic() const;
     MOZ_ALWAYS_INLINE void markBlack() const;
     MOZ_ALWAYS_INLINE void copyMarkBitsFrom(const TenuredCell* src);
     MOZ_ALWAYS_INLINE void unmark();
@@ -295,6 +307,11 @@ Cell::getTraceKind() const
     if (nurseryCellIsString()) {
         return JS::TraceKind::String;
     }
+#ifdef ENABLE_BIGINT
+    if (nurseryCellIsBigInt()) {
+        return JS::TraceKind::BigInt;
+    }
+#endif
     return JS::TraceKind::Object;
 }
 
@@ -344,6 +361,12 @@ TenuredCell::markIfUnmarked(MarkColor color /* = Black */) const
     return chunk()->bitmap.markIfUnmarked(this, color);
 }
 
+bool
+TenuredCell::markIfUnmarkedAtomic() const
+{
+    return chunk()->bitmap.markIfUnmarkedAtomic(this);
+}
+
 void
 TenuredCell::markBlack() const
 {
@@ -176,6 +176,11 @@
  *  - The contents of those arenas are moved to new arenas.
  *  - All references to moved things are updated.
  *
+ * Arenas are moved by several RelocateArenasTasks at once. The slice budget is
+ * checked as arenas are moved, and a zone that is only partly compacted when
+ * the budget runs out is finished in the next slice, after references to
+ * things already moved have been updated.
+ *
  * Collecting Atoms
  * ----------------
  *
@@ -218,6 +223,8 @@
 #include "gc/GCInternals.h"
 #include "gc/GCTrace.h"
 #include "gc/Memory.h"
+#include "gc/ParallelMarking.h"
+#include "gc/ParallelTenuring.h"
 #include "gc/Policy.h"
 #include "gc/WeakMap.h"
 #include "jit/BaselineJIT.h"
@@ -227,6 +234,8 @@
 #include "jit/MacroAssembler.h"
 #include "js/SliceBudget.h"
 #include "proxy/DeadObjectProxy.h"
+#include "threading/CpuCount.h"
+#include "threading/LockGuard.h"
 #include "util/Windows.h"
 #ifdef ENABLE_BIGINT
 #include "vm/BigIntType.h"
@@ -344,10 +353,25 @@ namespace TuningDefaults {
     /* JSGC_COMPACTING_ENABLED */
     static const bool CompactingEnabled = true;
 
+    /* JSGC_MARKING_THREAD_COUNT */
+    static const uint32_t MarkingThreadCount = 1;
+
+    /* JSGC_TENURING_THREAD_COUNT */
+    static const uint32_t TenuringThreadCount = 1;
+
     /* JSGC_NURSERY_FREE_THRESHOLD_FOR_IDLE_COLLECTION */
     static const uint32_t NurseryFreeThresholdForIdleCollection =
         Nursery::NurseryChunkUsableSize / 4;
 
+    /* JSGC_NURSERY_PAUSE_TARGET */
+    static const uint32_t NurseryPauseTarget = 0; // in microseconds
+
+    /* JSGC_HUGE_PAGES */
+    static const bool HugePagesEnabled = false;
+
+    /* JSGC_NUMA_LOCAL_CHUNKS */
+    static const bool NumaLocalChunksEnabled = false;
+
 }}} // namespace js::gc::TuningDefaults
 
 /*
@@ -378,6 +402,15 @@ static const float MinLowFrequencyHeapGrowthFactor =
 /* Increase the IGC marking slice time if we are in highFrequencyGC mode. */
 static const int IGC_MARK_SLICE_MULTIPLIER = 2;
 
+/*
+ * Also increase it by the default budget for every IGC_MARK_SLICE_GROWTH_SLICES
+ * slices a collection has taken while it is still marking, up to
+ * IGC_MAX_MARK_SLICE_MULTIPLIER times the default budget, so that marking a
+ * large heap doesn't take hundreds of slices.
+ */
+static const size_t IGC_MARK_SLICE_GROWTH_SLICES = 20;
+static const int IGC_MAX_MARK_SLICE_MULTIPLIER = 4;
+
 const AllocKind gc::slotsToThingKind[] = {
     // clang-format off
     /*  0 */ AllocKind::OBJECT0,  AllocKind::OBJECT2,  AllocKind::OBJECT2,  AllocKind::OBJECT4,
@@ -398,6 +431,8 @@ static_assert(sizeof(uintptr_t) > JS_BITMASK(Cell::ReservedBits),
               "Cell::ReservedBits should support small malloc / aligned globals");
 static_assert(js::jit::CodeAlignment > JS_BITMASK(Cell::ReservedBits),
               "Cell::ReservedBits should support JIT code");
+static_assert(CellAlignBytes > Cell::BIGINT_BIT,
+              "Cell::BIGINT_BIT must be clear in pointers to gc::Cell");
 
 static_assert(mozilla::ArrayLength(slotsToThingKind) == SLOTS_TO_THING_KIND_LIMIT,
               "We have defined a slot count for each kind.");
@@ -809,7 +844,7 @@ GCRuntime::expireEmptyChunkPool(const AutoLockGC& lock)
     MOZ_ASSERT(tunables.minEmptyChunkCount(lock) <= tunables.maxEmptyChunkCount());
 
     ChunkPool expired;
-    while (emptyChunks(lock).count() > tunables.minEmptyChunkCount(lock)) {
+    while (emptyChunks(lock).count() > emptyChunkReserve(lock)) {
         Chunk* chunk = emptyChunks(lock).pop();
         prepareToFreeChunk(chunk->info);
         expired.push(chunk);
@@ -818,10 +853,16 @@ GCRuntime::expireEmptyChunkPool(const AutoLockGC& lock)
     MOZ_ASSERT(expired.verify());
     MOZ_ASSERT(emptyChunks(lock).verify());
     MOZ_ASSERT(emptyChunks(lock).count() <= tunables.maxEmptyChunkCount());
-    MOZ_ASSERT(emptyChunks(lock).count() <= tunables.minEmptyChunkCount(lock));
+    MOZ_ASSERT(emptyChunks(lock).count() <= emptyChunkReserve(lock));
     return expired;
 }
 
+unsigned
+GCRuntime::emptyChunkReserve(const AutoLockGC& lock) const
+{
+    return memoryPressure ? 0 : tunables.minEmptyChunkCount(lock);
+}
+
 static void
 FreeChunkPool(ChunkPool& pool)
 {
@@ -978,6 +1019,7 @@ GCRuntime::GCRuntime(JSRuntime* rt) :
     stats_(rt),
     marker(rt),
     usage(nullptr),
+    memoryPressure(false),
     rootsHash(256),
     nextCellUniqueId_(LargestTaggedNullCellPointer + 1), // Ensure disjoint from null tagged pointers.
     numArenasFreeCommitted(0),
@@ -1018,6 +1060,11 @@ GCRuntime::GCRuntime(JSRuntime* rt) :
     defaultTimeBudget_(TuningDefaults::DefaultTimeBudget),
     incrementalAllowed(true),
     compactingEnabled(TuningDefaults::CompactingEnabled),
+    markingThreadCount(TuningDefaults::MarkingThreadCount),
+    tenuringThreadCount(TuningDefaults::TenuringThreadCount),
+    hugePagesEnabled(TuningDefaults::HugePagesEnabled),
+    numaLocalChunksEnabled(TuningDefaults::NumaLocalChunksEnabled),
+    numaNode(0),
     rootsRemoved(false),
 #ifdef JS_GC_ZEAL
     zealModeBits(0),
@@ -1352,6 +1399,10 @@ GCRuntime::init(uint32_t maxbytes, uint32_t maxNurseryBytes)
 {
     MOZ_ASSERT(SystemPageSize());
 
+    // Chunks are placed on the node the runtime is created on, which is where
+    // its main thread is likely to stay if the embedder has bound it there.
+    numaNode = GetCurrentNumaNode();
+
     {
         AutoLockGCBgAlloc lock(rt);
 
@@ -1472,6 +1523,27 @@ GCRuntime::setParameter(JSGCParamKey key, uint32_t value, AutoLockGC& lock)
       case JSGC_COMPACTING_ENABLED:
         compactingEnabled = value != 0;
         break;
+      case JSGC_MARKING_THREAD_COUNT:
+        if (value == 0 || value > MaxMarkingThreadCount) {
+            return false;
+        }
+        markingThreadCount = value;
+        break;
+      case JSGC_TENURING_THREAD_COUNT:
+        if (value == 0 || value > MaxTenuringThreadCount) {
+            return false;
+        }
+        tenuringThreadCount = value;
+        break;
+      case JSGC_MEMORY_PRESSURE:
+        setMemoryPressure(value != 0, lock);
+        break;
+      case JSGC_HUGE_PAGES:
+        hugePagesEnabled = value != 0;
+        break;
+      case JSGC_NUMA_LOCAL_CHUNKS:
+        numaLocalChunksEnabled = value != 0;
+        break;
       default:
         if (!tunables.setParameter(key, value, lock)) {
             return false;
@@ -1578,6 +1650,9 @@ GCSchedulingTunables::setParameter(JSGCParamKey key, uint32_t value, const AutoL
         }
         nurseryFreeThresholdForIdleCollection_ = value;
         break;
+      case JSGC_NURSERY_PAUSE_TARGET:
+        nurseryPauseTarget_ = TimeDuration::FromMicroseconds(value);
+        break;
       default:
         MOZ_CRASH("Unknown GC parameter.");
     }
@@ -1678,7 +1753,8 @@ GCSchedulingTunables::GCSchedulingTunables()
     dynamicMarkSliceEnabled_(TuningDefaults::DynamicMarkSliceEnabled),
     minEmptyChunkCount_(TuningDefaults::MinEmptyChunkCount),
     maxEmptyChunkCount_(TuningDefaults::MaxEmptyChunkCount),
-    nurseryFreeThresholdForIdleCollection_(TuningDefaults::NurseryFreeThresholdForIdleCollection)
+    nurseryFreeThresholdForIdleCollection_(TuningDefaults::NurseryFreeThresholdForIdleCollection),
+    nurseryPauseTarget_(TimeDuration::FromMicroseconds(TuningDefaults::NurseryPauseTarget))
 {}
 
 void
@@ -1700,6 +1776,21 @@ GCRuntime::resetParameter(JSGCParamKey key, AutoLockGC& lock)
       case JSGC_COMPACTING_ENABLED:
         compactingEnabled = TuningDefaults::CompactingEnabled;
         break;
+      case JSGC_MARKING_THREAD_COUNT:
+        markingThreadCount = TuningDefaults::MarkingThreadCount;
+        break;
+      case JSGC_TENURING_THREAD_COUNT:
+        tenuringThreadCount = TuningDefaults::TenuringThreadCount;
+        break;
+      case JSGC_MEMORY_PRESSURE:
+        setMemoryPressure(false, lock);
+        break;
+      case JSGC_HUGE_PAGES:
+        hugePagesEnabled = TuningDefaults::HugePagesEnabled;
+        break;
+      case JSGC_NUMA_LOCAL_CHUNKS:
+        numaLocalChunksEnabled = TuningDefaults::NumaLocalChunksEnabled;
+        break;
       default:
         tunables.resetParameter(key, lock);
         for (ZonesIter zone(rt, WithAtoms); !zone.done(); zone.next()) {
@@ -1763,6 +1854,9 @@ GCSchedulingTunables::resetParameter(JSGCParamKey key, const AutoLockGC& lock)
         nurseryFreeThresholdForIdleCollection_ =
             TuningDefaults::NurseryFreeThresholdForIdleCollection;
         break;
+      case JSGC_NURSERY_PAUSE_TARGET:
+        nurseryPauseTarget_ = TimeDuration::FromMicroseconds(TuningDefaults::NurseryPauseTarget);
+        break;
       default:
         MOZ_CRASH("Unknown GC parameter.");
     }
@@ -1824,6 +1918,18 @@ GCRuntime::getParameter(JSGCParamKey key, const AutoLockGC& lock)
         return tunables.maxEmptyChunkCount();
       case JSGC_COMPACTING_ENABLED:
         return compactingEnabled;
+      case JSGC_MARKING_THREAD_COUNT:
+        return markingThreadCount;
+      case JSGC_TENURING_THREAD_COUNT:
+        return tenuringThreadCount;
+      case JSGC_NURSERY_PAUSE_TARGET:
+        return uint32_t(tunables.nurseryPauseTarget().ToMicroseconds());
+      case JSGC_MEMORY_PRESSURE:
+        return memoryPressure;
+      case JSGC_HUGE_PAGES:
+        return hugePagesEnabled;
+      case JSGC_NUMA_LOCAL_CHUNKS:
+        return numaLocalChunksEnabled;
       default:
         MOZ_ASSERT(key == JSGC_NUMBER);
         return uint32_t(number);
@@ -1839,6 +1945,34 @@ GCRuntime::setMarkStackLimit(size_t limit, AutoLockGC& lock)
     marker.setMaxCapacity(limit);
 }
 
+void
+GCRuntime::setMemoryPressure(bool pressure, AutoLockGC& lock)
+{
+    MOZ_ASSERT(!JS::RuntimeHeapIsBusy());
+
+    if (pressure == memoryPressure) {
+        return;
+    }
+    memoryPressure = pressure;
+
+    AutoUnlockGC unlock(lock);
+
+    if (!pressure) {
+        // Refill the empty chunk reserve.
+        maybeStartBackgroundAllocation();
+        return;
+    }
+
+    // Stop refilling the reserve and give memory back now rather than waiting
+    // for the next GC. If a GC is in progress it will decommit when it
+    // finishes sweeping.
+    allocTask.cancelAndWait();
+    if (!isIncrementalGCInProgress()) {
+        decommitTask.join();
+        startDecommit();
+    }
+}
+
 bool
 GCRuntime::addBlackRootsTracer(JSTraceDataOp traceOp, void* data)
 {
@@ -2223,6 +2357,13 @@ void
 GCMarker::delayMarkingChildren(const void* thing)
 {
     const TenuredCell* cell = TenuredCell::fromPointer(thing);
+    if (isParallelMarker()) {
+        // The delayed marking list is threaded through the arenas and so is
+        // shared by all markers. Hand the cell to the main thread instead.
+        TenuredCell* mutableCell = const_cast<TenuredCell*>(cell);
+        deferTracingChildren(JS::GCCellPtr(mutableCell, mutableCell->getTraceKind()));
+        return;
+    }
     cell->arena()->markOverflow = 1;
     delayMarkingArena(cell->arena());
 }
@@ -2382,20 +2523,144 @@ PtrIsInRange(const void* ptr, const void* start, size_t length)
 }
 #endif
 
+static const size_t MinCellUpdateBackgroundTasks = 2;
+static const size_t MaxCellUpdateBackgroundTasks = 8;
+
+static size_t
+CellUpdateBackgroundTaskCount()
+{
+    if (!CanUseExtraThreads()) {
+        return 0;
+    }
+
+    size_t targetTaskCount = HelperThreadState().cpuCount / 2;
+    return Min(Max(targetTaskCount, MinCellUpdateBackgroundTasks), MaxCellUpdateBackgroundTasks);
+}
+
+namespace js {
+namespace gc {
+
+struct ArenaListSegment
+{
+    Arena* begin;
+    Arena* end;
+};
+
+/*
+ * The arenas of a zone that have been chosen for relocation, which are handed
+ * out in segments to RelocateArenasTasks. Arenas that have not been handed out
+ * when the slice budget runs out are put back in the zone's arena lists.
+ */
+class ArenasToRelocate
+{
+  public:
+    explicit ArenasToRelocate(Zone* zone);
+
+    Zone* zone() const { return zone_; }
+
+    void add(AllocKind kind, Arena* arenas);
+
+    bool hasArenas(AllocKinds kinds) const;
+    ArenaListSegment getArenasToRelocate(AutoLockHelperThreadState& lock, AllocKinds kinds,
+                                         unsigned maxLength);
+
+    // Stop handing out arenas, leaving the rest for a later slice.
+    void stop(AutoLockHelperThreadState& lock) { stopped_ = true; }
+    bool isStopped() const { return stopped_; }
+
+    Arena* takeRemainingArenas(AllocKind kind);
+
+  private:
+    Zone* const zone_;
+    AllAllocKindArray<Arena*> arenas_;
+    bool stopped_;
+};
+
+/*
+ * Relocates segments of arenas. Tasks run on helper threads and on the main
+ * thread at the same time, so they allocate from their own free lists.
+ *
+ * Work that cannot be done in parallel is deferred to the main thread: moving
+ * unique IDs, which updates the zone's unique ID table, and relocating objects
+ * with an ObjectMoved hook.
+ */
+class RelocateArenasTask : public GCParallelTaskHelper<RelocateArenasTask>
+{
+  public:
+    // Maximum number of arenas to relocate in one block.
+#ifdef DEBUG
+    static const unsigned MaxArenasToProcess = 4;
+#else
+    static const unsigned MaxArenasToProcess = 32;
+#endif
+
+    // If |budget| is not null it is checked after each block, and the
+    // remaining arenas are left for a later slice once it is exhausted. It
+    // must only be passed to the task that runs on the main thread.
+    RelocateArenasTask(JSRuntime* rt, ArenasToRelocate* source, AllocKinds kinds,
+                       bool deferMainThreadWork, SliceBudget* budget);
+
+    void run();
+
+    bool deferringMainThreadWork() const { return deferMainThreadWork_; }
+
+    TenuredCell* allocateCell(AllocKind kind);
+    void deferCell(TenuredCell* cell);
+    void deferUniqueId(TenuredCell* dst, TenuredCell* src);
+
+    // Do the work this task deferred and add the arenas it relocated to
+    // |relocatedListOut|. This must be called on the main thread once no
+    // other task is running.
+    void finish(Arena*& relocatedListOut, gcstats::Statistics& stats);
+
+  private:
+    struct UniqueIdTransfer
+    {
+        TenuredCell* dst;
+        TenuredCell* src;
+    };
+
+    ArenasToRelocate* source_;
+    AllocKinds kinds_;
+    bool deferMainThreadWork_;
+    SliceBudget* budget_;
+
+    FreeLists freeLists_;
+
+    Arena* relocated_;
+    Arena* relocatedTail_;
+    size_t relocatedCount_;
+
+    Vector<TenuredCell*, 0, SystemAllocPolicy> deferredCells_;
+    Vector<UniqueIdTransfer, 0, SystemAllocPolicy> deferredUniqueIds_;
+
+    bool getArenasToRelocate(ArenaListSegment* arenasOut);
+};
+
+} // namespace gc
+} // namespace js
+
 static void
-RelocateCell(Zone* zone, TenuredCell* src, AllocKind thingKind, size_t thingSize)
+RelocateCell(Zone* zone, TenuredCell* src, AllocKind thingKind, size_t thingSize,
+             RelocateArenasTask* task)
 {
     JS::AutoSuppressGCAnalysis nogc(TlsContext.get());
 
     // Allocate a new cell.
     MOZ_ASSERT(zone == src->zone());
-    TenuredCell* dst = AllocateCellInGC(zone, thingKind);
+    TenuredCell* dst = task ? task->allocateCell(thingKind) : AllocateCellInGC(zone, thingKind);
 
     // Copy source cell contents to destination.
     memcpy(dst, src, thingSize);
 
     // Move any uid attached to the object.
-    src->zone()->transferUniqueId(dst, src);
+    if (task && task->deferringMainThreadWork()) {
+        if (zone->hasUniqueId(src)) {
+            task->deferUniqueId(dst, src);
+        }
+    } else {
+        src->zone()->transferUniqueId(dst, src);
+    }
 
     if (IsObjectAllocKind(thingKind)) {
         JSObject* srcObj = static_cast<JSObject*>(static_cast<Cell*>(src));
@@ -2427,6 +2692,7 @@ RelocateCell(Zone* zone, TenuredCell* src, AllocKind thingKind, size_t thingSize
 
         // Call object moved hook if present.
         if (JSObjectMovedOp op = srcObj->getClass()->extObjectMovedOp()) {
+            MOZ_ASSERT_IF(task, !task->deferringMainThreadWork());
             op(dstObj, srcObj);
         }
 
@@ -2443,8 +2709,20 @@ RelocateCell(Zone* zone, TenuredCell* src, AllocKind thingKind, size_t thingSize
     overlay->forwardTo(dst);
 }
 
-static void
-RelocateArena(Arena* arena, SliceBudget& sliceBudget)
+static bool
+HasObjectMovedOp(TenuredCell* cell, AllocKind thingKind)
+{
+    if (!IsObjectAllocKind(thingKind)) {
+        return false;
+    }
+
+    JSObject* obj = static_cast<JSObject*>(static_cast<Cell*>(cell));
+    return obj->getClass()->extObjectMovedOp();
+}
+
+// Relocate the cells in |arena| and return how many there were.
+static size_t
+RelocateArena(Arena* arena, RelocateArenasTask& task)
 {
     MOZ_ASSERT(arena->allocated());
     MOZ_ASSERT(!arena->hasDelayedMarking);
@@ -2456,12 +2734,24 @@ RelocateArena(Arena* arena, SliceBudget& sliceBudget)
     AllocKind thingKind = arena->getAllocKind();
     size_t thingSize = arena->getThingSize();
 
+    size_t count = 0;
     for (ArenaCellIterUnderGC i(arena); !i.done(); i.next()) {
-        RelocateCell(zone, i.getCell(), thingKind, thingSize);
-        sliceBudget.step();
+        TenuredCell* cell = i.getCell();
+        if (task.deferringMainThreadWork() && HasObjectMovedOp(cell, thingKind)) {
+            task.deferCell(cell);
+        } else {
+            RelocateCell(zone, cell, thingKind, thingSize, &task);
+        }
+        count++;
     }
 
+    return count;
+}
+
 #ifdef DEBUG
+static void
+CheckArenaRelocated(Arena* arena)
+{
     for (ArenaCellIterUnderGC i(arena); !i.done(); i.next()) {
         TenuredCell* src = i.getCell();
         MOZ_ASSERT(src->isForwarded());
@@ -2469,7 +2759,193 @@ RelocateArena(Arena* arena, SliceBudget& sliceBudget)
         MOZ_ASSERT(src->isMarkedBlack() == dest->isMarkedBlack());
         MOZ_ASSERT(src->isMarkedGray() == dest->isMarkedGray());
     }
+}
+#endif
+
+ArenasToRelocate::ArenasToRelocate(Zone* zone)
+  : zone_(zone), stopped_(false)
+{
+    for (AllocKind kind : AllAllocKinds()) {
+        arenas_[kind] = nullptr;
+    }
+}
+
+void
+ArenasToRelocate::add(AllocKind kind, Arena* arenas)
+{
+    MOZ_ASSERT(!arenas_[kind]);
+    arenas_[kind] = arenas;
+}
+
+bool
+ArenasToRelocate::hasArenas(AllocKinds kinds) const
+{
+    for (AllocKind kind : kinds) {
+        if (arenas_[kind]) {
+            return true;
+        }
+    }
+    return false;
+}
+
+ArenaListSegment
+ArenasToRelocate::getArenasToRelocate(AutoLockHelperThreadState& lock, AllocKinds kinds,
+                                      unsigned maxLength)
+{
+    if (stopped_) {
+        return { nullptr, nullptr };
+    }
+
+    for (AllocKind kind : kinds) {
+        Arena* begin = arenas_[kind];
+        if (!begin) {
+            continue;
+        }
+
+        Arena* last = begin;
+        unsigned count = 1;
+        while (last->next && count < maxLength) {
+            last = last->next;
+            count++;
+        }
+
+        arenas_[kind] = last->next;
+        return { begin, last->next };
+    }
+
+    return { nullptr, nullptr };
+}
+
+Arena*
+ArenasToRelocate::takeRemainingArenas(AllocKind kind)
+{
+    Arena* arenas = arenas_[kind];
+    arenas_[kind] = nullptr;
+    return arenas;
+}
+
+RelocateArenasTask::RelocateArenasTask(JSRuntime* rt, ArenasToRelocate* source,
+                                       AllocKinds kinds, bool deferMainThreadWork,
+                                       SliceBudget* budget)
+  : GCParallelTaskHelper(rt),
+    source_(source),
+    kinds_(kinds),
+    deferMainThreadWork_(deferMainThreadWork),
+    budget_(budget),
+    relocated_(nullptr),
+    relocatedTail_(nullptr),
+    relocatedCount_(0)
+{}
+
+bool
+RelocateArenasTask::getArenasToRelocate(ArenaListSegment* arenasOut)
+{
+    AutoLockHelperThreadState lock;
+    *arenasOut = source_->getArenasToRelocate(lock, kinds_, MaxArenasToProcess);
+    return arenasOut->begin != nullptr;
+}
+
+void
+RelocateArenasTask::run()
+{
+    ArenaListSegment arenas;
+    while (getArenasToRelocate(&arenas)) {
+        size_t cellCount = 0;
+        Arena* next;
+        for (Arena* arena = arenas.begin; arena != arenas.end; arena = next) {
+            next = arena->next;
+            cellCount += RelocateArena(arena, *this);
+
+            // Prepend to list of relocated arenas.
+            arena->next = relocated_;
+            relocated_ = arena;
+            if (!relocatedTail_) {
+                relocatedTail_ = arena;
+            }
+            relocatedCount_++;
+        }
+
+        if (budget_) {
+            budget_->step(cellCount);
+            if (budget_->isOverBudget()) {
+                AutoLockHelperThreadState lock;
+                source_->stop(lock);
+            }
+        }
+    }
+}
+
+TenuredCell*
+RelocateArenasTask::allocateCell(AllocKind kind)
+{
+    TenuredCell* cell = freeLists_.allocate(kind);
+    if (!cell) {
+        // The lock serializes refills from tasks relocating the same kind.
+        AutoLockHelperThreadState lock;
+        cell = source_->zone()->arenas.refillFreeListAndAllocate(
+            freeLists_, kind, ShouldCheckThresholds::DontCheckThresholds);
+        if (!cell) {
+            AutoEnterOOMUnsafeRegion oomUnsafe;
+            oomUnsafe.crash(ChunkSize, "Failed not allocate new chunk during GC");
+        }
+    }
+    return cell;
+}
+
+void
+RelocateArenasTask::deferCell(TenuredCell* cell)
+{
+    AutoEnterOOMUnsafeRegion oomUnsafe;
+    if (!deferredCells_.append(cell)) {
+        oomUnsafe.crash("Failed to defer a cell during compacting GC");
+    }
+}
+
+void
+RelocateArenasTask::deferUniqueId(TenuredCell* dst, TenuredCell* src)
+{
+    AutoEnterOOMUnsafeRegion oomUnsafe;
+    if (!deferredUniqueIds_.append(UniqueIdTransfer { dst, src })) {
+        oomUnsafe.crash("Failed to defer a unique ID during compacting GC");
+    }
+}
+
+void
+RelocateArenasTask::finish(Arena*& relocatedListOut, gcstats::Statistics& stats)
+{
+    MOZ_ASSERT(CurrentThreadCanAccessRuntime(runtime()));
+
+    Zone* zone = source_->zone();
+    for (const UniqueIdTransfer& transfer : deferredUniqueIds_) {
+        zone->transferUniqueId(transfer.dst, transfer.src);
+    }
+    deferredUniqueIds_.clearAndFree();
+
+    for (TenuredCell* cell : deferredCells_) {
+        AllocKind kind = cell->getAllocKind();
+        RelocateCell(zone, cell, kind, Arena::thingSize(kind), nullptr);
+    }
+    deferredCells_.clearAndFree();
+
+    if (!relocated_) {
+        return;
+    }
+
+#ifdef DEBUG
+    for (Arena* arena = relocated_; arena; arena = arena->next) {
+        CheckArenaRelocated(arena);
+    }
 #endif
+
+    relocatedTail_->next = relocatedListOut;
+    relocatedListOut = relocated_;
+    for (size_t i = 0; i < relocatedCount_; i++) {
+        stats.count(gcstats::STAT_ARENA_RELOCATED);
+    }
+
+    relocated_ = nullptr;
+    relocatedTail_ = nullptr;
+    relocatedCount_ = 0;
 }
 
 static inline bool
@@ -2485,28 +2961,16 @@ ShouldProtectRelocatedArenas(JS::gcreason::Reason reason)
 #endif
 }
 
-/*
- * Relocate all arenas identified by pickArenasToRelocate: for each arena,
- * relocate each cell within it, then add it to a list of relocated arenas.
- */
-Arena*
-ArenaList::relocateArenas(Arena* toRelocate, Arena* relocated, SliceBudget& sliceBudget,
-                          gcstats::Statistics& stats)
+void
+ArenaList::restoreRemainingArenas(Arena* arenas)
 {
     check();
-
-    while (Arena* arena = toRelocate) {
-        toRelocate = arena->next;
-        RelocateArena(arena, sliceBudget);
-        // Prepend to list of relocated arenas
-        arena->next = relocated;
-        relocated = arena;
-        stats.count(gcstats::STAT_ARENA_RELOCATED);
+    Arena** arenap = cursorp_;
+    while (*arenap) {
+        arenap = &(*arenap)->next;
     }
-
+    *arenap = arenas;
     check();
-
-    return relocated;
 }
 
 // Skip compacting zones unless we can free a certain proportion of their GC
@@ -2540,8 +3004,7 @@ CompactingAllocKinds()
 }
 
 bool
-ArenaLists::relocateArenas(Arena*& relocatedListOut, JS::gcreason::Reason reason,
-                           SliceBudget& sliceBudget, gcstats::Statistics& stats)
+ArenaLists::removeArenasToRelocate(ArenasToRelocate& toRelocate, JS::gcreason::Reason reason)
 {
     // This is only called from the main thread while we are doing a GC, so
     // there is no need to lock.
@@ -2561,15 +3024,15 @@ ArenaLists::relocateArenas(Arena*& relocatedListOut, JS::gcreason::Reason reason
             ArenaList& al = arenaLists(kind);
             Arena* allArenas = al.head();
             al.clear();
-            relocatedListOut = al.relocateArenas(allArenas, relocatedListOut, sliceBudget, stats);
+            toRelocate.add(kind, allArenas);
         }
     } else {
         size_t arenaCount = 0;
         size_t relocCount = 0;
-        AllAllocKindArray<Arena**> toRelocate;
+        AllAllocKindArray<Arena**> arenasToRelocate;
 
         for (auto kind : allocKindsToRelocate) {
-            toRelocate[kind] = arenaLists(kind).pickArenasToRelocate(arenaCount, relocCount);
+            arenasToRelocate[kind] = arenaLists(kind).pickArenasToRelocate(arenaCount, relocCount);
         }
 
         if (!ShouldRelocateZone(arenaCount, relocCount, reason)) {
@@ -2578,10 +3041,9 @@ ArenaLists::relocateArenas(Arena*& relocatedListOut, JS::gcreason::Reason reason
 
         zone_->prepareForCompacting();
         for (auto kind : allocKindsToRelocate) {
-            if (toRelocate[kind]) {
+            if (arenasToRelocate[kind]) {
                 ArenaList& al = arenaLists(kind);
-                Arena* arenas = al.removeRemainingArenas(toRelocate[kind]);
-                relocatedListOut = al.relocateArenas(arenas, relocatedListOut, sliceBudget, stats);
+                toRelocate.add(kind, al.removeRemainingArenas(arenasToRelocate[kind]));
             }
         }
     }
@@ -2589,9 +3051,85 @@ ArenaLists::relocateArenas(Arena*& relocatedListOut, JS::gcreason::Reason reason
     return true;
 }
 
+bool
+ArenaLists::restoreUnrelocatedArenas(ArenasToRelocate& toRelocate)
+{
+    bool restored = false;
+    for (auto kind : CompactingAllocKinds()) {
+        if (Arena* arenas = toRelocate.takeRemainingArenas(kind)) {
+            arenaLists(kind).restoreRemainingArenas(arenas);
+            restored = true;
+        }
+    }
+    return restored;
+}
+
+// Object kinds are relocated before other kinds because ObjectMoved hooks,
+// which are deferred to the main thread when relocating in parallel, may use
+// the object's group and shape.
+static const AllocKinds RelocatePhaseOne {
+    AllocKind::FUNCTION,
+    AllocKind::FUNCTION_EXTENDED,
+    AllocKind::OBJECT0,
+    AllocKind::OBJECT0_BACKGROUND,
+    AllocKind::OBJECT2,
+    AllocKind::OBJECT2_BACKGROUND,
+    AllocKind::OBJECT4,
+    AllocKind::OBJECT4_BACKGROUND,
+    AllocKind::OBJECT8,
+    AllocKind::OBJECT8_BACKGROUND,
+    AllocKind::OBJECT12,
+    AllocKind::OBJECT12_BACKGROUND,
+    AllocKind::OBJECT16,
+    AllocKind::OBJECT16_BACKGROUND
+};
+
+void
+GCRuntime::relocateArenaKinds(ArenasToRelocate& toRelocate, AllocKinds kinds, size_t bgTaskCount,
+                              Arena*& relocatedListOut, SliceBudget& sliceBudget)
+{
+    Maybe<RelocateArenasTask> fgTask;
+    Maybe<RelocateArenasTask> bgTasks[MaxCellUpdateBackgroundTasks];
+
+    size_t tasksStarted = 0;
+
+    {
+        AutoLockHelperThreadState lock;
+
+        for (size_t i = 0;
+             i < bgTaskCount && !toRelocate.isStopped() && toRelocate.hasArenas(kinds);
+             i++)
+        {
+            bgTasks[i].emplace(rt, &toRelocate, kinds, true, nullptr);
+            startTask(*bgTasks[i], gcstats::PhaseKind::COMPACT_MOVE_CELLS, lock);
+            tasksStarted++;
+        }
+
+        fgTask.emplace(rt, &toRelocate, kinds, tasksStarted != 0, &sliceBudget);
+    }
+
+    fgTask->runFromMainThread(rt);
+
+    {
+        AutoLockHelperThreadState lock;
+
+        for (size_t i = 0; i < tasksStarted; i++) {
+            joinTask(*bgTasks[i], gcstats::PhaseKind::COMPACT_MOVE_CELLS, lock);
+        }
+        for (size_t i = tasksStarted; i < MaxCellUpdateBackgroundTasks; i++) {
+            MOZ_ASSERT(bgTasks[i].isNothing());
+        }
+    }
+
+    fgTask->finish(relocatedListOut, stats());
+    for (size_t i = 0; i < tasksStarted; i++) {
+        bgTasks[i]->finish(relocatedListOut, stats());
+    }
+}
+
 bool
 GCRuntime::relocateArenas(Zone* zone, JS::gcreason::Reason reason, Arena*& relocatedListOut,
-                          SliceBudget& sliceBudget)
+                          SliceBudget& sliceBudget, IncrementalProgress* progressOut)
 {
     gcstats::AutoPhase ap(stats(), gcstats::PhaseKind::COMPACT_MOVE);
 
@@ -2600,10 +3138,32 @@ GCRuntime::relocateArenas(Zone* zone, JS::gcreason::Reason reason, Arena*& reloc
 
     js::CancelOffThreadIonCompile(rt, JS::Zone::Compact);
 
-    if (!zone->arenas.relocateArenas(relocatedListOut, reason, sliceBudget, stats())) {
+    *progressOut = Finished;
+
+    ArenasToRelocate toRelocate(zone);
+    if (!zone->arenas.removeArenasToRelocate(toRelocate, reason)) {
         return false;
     }
 
+    size_t bgTaskCount = CellUpdateBackgroundTaskCount();
+    AllocKinds phaseOneKinds = RelocatePhaseOne;
+    AllocKinds phaseTwoKinds = CompactingAllocKinds() - phaseOneKinds;
+
+    // When relocating all arenas, arenas filled earlier in the zone would be
+    // picked again in the next slice, so don't stop part way through.
+    SliceBudget unlimited = SliceBudget::unlimited();
+    SliceBudget& budget = ShouldRelocateAllArenas(reason) ? unlimited : sliceBudget;
+
+    relocateArenaKinds(toRelocate, phaseOneKinds, bgTaskCount, relocatedListOut, budget);
+    relocateArenaKinds(toRelocate, phaseTwoKinds, bgTaskCount, relocatedListOut, budget);
+
+    // If the budget ran out, put back the arenas we didn't get to. The rest
+    // of the zone is relocated in the next slice.
+    if (zone->arenas.restoreUnrelocatedArenas(toRelocate)) {
+        *progressOut = NotFinished;
+        return true;
+    }
+
 #ifdef DEBUG
     // Check that we did as much compaction as we should have. There
     // should always be less than one arena's worth of free cells.
@@ -2734,12 +3294,6 @@ FOR_EACH_ALLOCKIND(EXPAND_CASE)
 namespace js {
 namespace gc {
 
-struct ArenaListSegment
-{
-    Arena* begin;
-    Arena* end;
-};
-
 struct ArenasToUpdate
 {
     ArenasToUpdate(Zone* zone, AllocKinds kinds);
@@ -2866,20 +3420,6 @@ UpdatePointersTask::run()
 } // namespace gc
 } // namespace js
 
-static const size_t MinCellUpdateBackgroundTasks = 2;
-static const size_t MaxCellUpdateBackgroundTasks = 8;
-
-static size_t
-CellUpdateBackgroundTaskCount()
-{
-    if (!CanUseExtraThreads()) {
-        return 0;
-    }
-
-    size_t targetTaskCount = HelperThreadState().cpuCount / 2;
-    return Min(Max(targetTaskCount, MinCellUpdateBackgroundTasks), MaxCellUpdateBackgroundTasks);
-}
-
 static bool
 CanUpdateKindInBackground(AllocKind kind) {
     // We try to update as many GC things in parallel as we can, but there are
@@ -3338,12 +3878,17 @@ ArenaLists::backgroundFinalize(FreeOp* fop, Arena* listHead, Arena** empty)
 
     finalizedSorted.extractEmpty(empty);
 
+    zone->arenas.mergeBackgroundFinalized(thingKind, finalizedSorted);
+}
+
+void
+ArenaLists::mergeBackgroundFinalized(AllocKind thingKind, SortedArenaList& finalizedSorted)
+{
     // When arenas are queued for background finalization, all arenas are moved
     // to arenaListsToSweep[], leaving the arenaLists[] empty. However, new
     // arenas may be allocated before background finalization finishes; now that
     // finalization is complete, we want to merge these lists back together.
-    ArenaLists* lists = &zone->arenas;
-    ArenaList* al = &lists->arenaLists(thingKind);
+    ArenaList* al = &arenaLists(thingKind);
 
     // Flatten |finalizedSorted| into a regular ArenaList.
     ArenaList finalized = finalizedSorted.toArenaList();
@@ -3354,16 +3899,16 @@ ArenaLists::backgroundFinalize(FreeOp* fop, Arena* listHead, Arena** empty)
     // That safety is provided by the ReleaseAcquire memory ordering of the
     // background finalize state, which we explicitly set as the final step.
     {
-        AutoLockGC lock(lists->runtimeFromAnyThread());
-        MOZ_ASSERT(lists->concurrentUse(thingKind) == ConcurrentUse::BackgroundFinalize);
+        AutoLockGC lock(runtimeFromAnyThread());
+        MOZ_ASSERT(concurrentUse(thingKind) == ConcurrentUse::BackgroundFinalize);
 
         // Join |al| and |finalized| into a single list.
         *al = finalized.insertListWithCursorAtEnd(*al);
 
-        lists->arenaListsToSweep(thingKind) = nullptr;
+        arenaListsToSweep(thingKind) = nullptr;
     }
 
-    lists->concurrentUse(thingKind) = ConcurrentUse::None;
+    concurrentUse(thingKind) = ConcurrentUse::None;
 }
 
 void
@@ -3682,18 +4227,19 @@ void
 GCRuntime::startDecommit()
 {
     MOZ_ASSERT(CurrentThreadCanAccessRuntime(rt));
-    MOZ_ASSERT(!decommitTask.isRunning());
-
-    // If we are allocating heavily enough to trigger "high freqency" GC, then
-    // skip decommit so that we do not compete with the mutator.
-    if (schedulingState.inHighFrequencyGCMode()) {
-        return;
-    }
+    MOZ_ASSERT(!decommitTask.isRunning());
 
     BackgroundDecommitTask::ChunkVector toDecommit;
     {
         AutoLockGC lock(rt);
 
+        // If we are allocating heavily enough to trigger "high freqency" GC,
+        // then skip decommit so that we do not compete with the mutator,
+        // unless the embedding has asked us to release memory.
+        if (schedulingState.inHighFrequencyGCMode() && !memoryPressure) {
+            return;
+        }
+
         // Verify that all entries in the empty chunks pool are already decommitted.
         for (ChunkPool::Iter chunk(emptyChunks(lock)); !chunk.done(); chunk.next()) {
             MOZ_ASSERT(!chunk->info.numArenasFreeCommitted);
@@ -3758,58 +4304,320 @@ js::gc::BackgroundDecommitTask::run()
     }
 }
 
+namespace {
+
+/*
+ * The background finalization of one phase of BackgroundFinalizePhases for a
+ * set of zones, spread over the sweeping thread and some helper threads. Each
+ * zone's arena list of each kind in the phase is one work item, except that
+ * long lists are split into ranges of arenas, so that a large zone doesn't
+ * keep one thread busy while the others are done. The threads take items from
+ * a shared queue. All the ranges of a split list are merged back into one
+ * sorted list once the phase has finished.
+ */
+class BackgroundFinalizeWork
+{
+#ifdef DEBUG
+    static const size_t RangeArenas = 16;
+#else
+    static const size_t RangeArenas = 64;
+#endif
+
+    struct SplitList
+    {
+        Zone* zone;
+        AllocKind kind;
+        SortedArenaList finalized;
+
+        SplitList(Zone* zone, AllocKind kind)
+          : zone(zone), kind(kind), finalized(Arena::thingsPerArena(kind))
+        {}
+    };
+
+    struct Item
+    {
+        Arena* arenas;
+
+        // Null if |arenas| is the whole list of its zone and kind.
+        SplitList* split;
+    };
+
+    Vector<Item, 0, SystemAllocPolicy> items_;
+    Vector<UniquePtr<SplitList>, 0, SystemAllocPolicy> splits_;
+    mozilla::Atomic<size_t, mozilla::ReleaseAcquire> nextItem_;
+
+    // Protects the finalized lists of splits_ and emptyArenas_.
+    Mutex lock_;
+    Arena* emptyArenas_;
+
+    void runItem(FreeOp* fop, const Item& item, Arena** emptyArenas);
+
+  public:
+    BackgroundFinalizeWork()
+      : nextItem_(0),
+        lock_(mutexid::GCBackgroundFinalize),
+        emptyArenas_(nullptr)
+    {}
+
+    size_t itemCount() const {
+        return items_.length();
+    }
+
+    // Queue the arenas of |zone| and |kind| which need finalizing. On OOM,
+    // finalize them right away instead.
+    void addList(Zone* zone, AllocKind kind);
+
+    // Finalize queued items until there are none left. Called by every
+    // thread taking part in the phase.
+    void run();
+
+    // Called once every thread has returned from run().
+    void finishPhase();
+
+    Arena* takeEmptyArenas() {
+        Arena* arenas = emptyArenas_;
+        emptyArenas_ = nullptr;
+        return arenas;
+    }
+};
+
+class BackgroundFinalizeTask : public GCParallelTaskHelper<BackgroundFinalizeTask>
+{
+    BackgroundFinalizeWork* work_;
+
+  public:
+    BackgroundFinalizeTask(JSRuntime* rt, BackgroundFinalizeWork* work)
+      : GCParallelTaskHelper(rt),
+        work_(work)
+    {}
+
+    void run() {
+        AutoSetThreadIsSweeping threadIsSweeping;
+        work_->run();
+    }
+};
+
+} // anonymous namespace
+
+static const size_t MaxBackgroundFinalizeTasks = 8;
+
 void
-GCRuntime::sweepBackgroundThings(ZoneList& zones, LifoAlloc& freeBlocks)
+BackgroundFinalizeWork::addList(Zone* zone, AllocKind kind)
 {
-    freeBlocks.freeAll();
+    Arena* arenas = zone->arenas.arenaListsToSweep(kind);
+    MOZ_RELEASE_ASSERT(uintptr_t(arenas) != uintptr_t(-1));
+    if (!arenas) {
+        return;
+    }
 
-    if (zones.isEmpty()) {
+    size_t length = 0;
+    for (Arena* arena = arenas; arena; arena = arena->next) {
+        length++;
+    }
+
+    if (length < 2 * RangeArenas) {
+        if (!items_.append(Item { arenas, nullptr })) {
+            FreeOp fop(nullptr);
+            ArenaLists::backgroundFinalize(&fop, arenas, &emptyArenas_);
+        }
+        return;
+    }
+
+    size_t rangeCount = (length + RangeArenas - 1) / RangeArenas;
+    UniquePtr<SplitList> split = MakeUnique<SplitList>(zone, kind);
+    SplitList* splitList = split.get();
+    if (!split ||
+        !items_.reserve(items_.length() + rangeCount) ||
+        !splits_.append(std::move(split)))
+    {
+        FreeOp fop(nullptr);
+        ArenaLists::backgroundFinalize(&fop, arenas, &emptyArenas_);
+        return;
+    }
+
+    // Cut the list into null-terminated ranges.
+    Arena* range = arenas;
+    while (range) {
+        items_.infallibleAppend(Item { range, splitList });
+        Arena* last = range;
+        for (size_t i = 1; i < RangeArenas && last->next; i++) {
+            last = last->next;
+        }
+        range = last->next;
+        last->next = nullptr;
+    }
+}
+
+void
+BackgroundFinalizeWork::runItem(FreeOp* fop, const Item& item, Arena** emptyArenas)
+{
+    if (!item.split) {
+        ArenaLists::backgroundFinalize(fop, item.arenas, emptyArenas);
         return;
     }
 
+    AllocKind kind = item.split->kind;
+    SortedArenaList finalized(Arena::thingsPerArena(kind));
+
+    Arena* arenas = item.arenas;
+    auto unlimited = SliceBudget::unlimited();
+    FinalizeArenas(fop, &arenas, finalized, kind, unlimited, ArenaLists::KEEP_ARENAS);
+    MOZ_ASSERT(!arenas);
+
+    finalized.extractEmpty(emptyArenas);
+
+    LockGuard<Mutex> guard(lock_);
+    item.split->finalized.takeFrom(finalized);
+}
+
+void
+BackgroundFinalizeWork::run()
+{
     FreeOp fop(nullptr);
+    Arena* emptyArenas = nullptr;
 
-    // Sweep zones in order. The atoms zone must be finalized last as other
-    // zones may have direct pointers into it.
-    while (!zones.isEmpty()) {
-        Zone* zone = zones.removeFront();
-        Arena* emptyArenas = nullptr;
+    while (true) {
+        size_t i = nextItem_++;
+        if (i >= items_.length()) {
+            break;
+        }
+        runItem(&fop, items_[i], &emptyArenas);
+    }
+
+    if (emptyArenas) {
+        Arena* last = emptyArenas;
+        while (last->next) {
+            last = last->next;
+        }
+
+        LockGuard<Mutex> guard(lock_);
+        last->next = emptyArenas_;
+        emptyArenas_ = emptyArenas;
+    }
+}
+
+void
+BackgroundFinalizeWork::finishPhase()
+{
+    for (UniquePtr<SplitList>& split : splits_) {
+        split->zone->arenas.mergeBackgroundFinalized(split->kind, split->finalized);
+    }
+
+    items_.clear();
+    splits_.clear();
+    nextItem_ = 0;
+}
+
+// Finalize the arenas of |zones| in the order specified by
+// BackgroundFinalizePhases, and release the ones which are now empty.
+void
+GCRuntime::backgroundFinalizeZones(ZoneList& zones)
+{
+    BackgroundFinalizeWork work;
 
-        // We must finalize thing kinds in the order specified by
-        // BackgroundFinalizePhases.
-        for (auto phase : BackgroundFinalizePhases) {
+    for (auto phase : BackgroundFinalizePhases) {
+        // Queue this phase's lists, rotating each zone back to the end of the
+        // list for the next phase.
+        ZoneList phaseZones;
+        while (!zones.isEmpty()) {
+            Zone* zone = zones.removeFront();
             for (auto kind : phase.kinds) {
-                Arena* arenas = zone->arenas.arenaListsToSweep(kind);
-                MOZ_RELEASE_ASSERT(uintptr_t(arenas) != uintptr_t(-1));
-                if (arenas) {
-                    ArenaLists::backgroundFinalize(&fop, arenas, &emptyArenas);
-                }
+                work.addList(zone, kind);
             }
+            phaseZones.append(zone);
         }
+        zones.transferFrom(phaseZones);
 
-        AutoLockGC lock(rt);
+        if (!work.itemCount()) {
+            continue;
+        }
 
-        // Release any arenas that are now empty, dropping and reaquiring the GC
-        // lock every so often to avoid blocking the main thread from
-        // allocating chunks.
-        static const size_t LockReleasePeriod = 32;
-        size_t releaseCount = 0;
-        Arena* next;
-        for (Arena* arena = emptyArenas; arena; arena = next) {
-            next = arena->next;
+        // This thread takes part, so it needs one task less than there are
+        // items to run.
+        Maybe<BackgroundFinalizeTask> tasks[MaxBackgroundFinalizeTasks];
+        size_t taskCount = 0;
+        if (CanUseExtraThreads()) {
+            size_t maxTasks = Min(HelperThreadState().maxGCParallelThreads(),
+                                  MaxBackgroundFinalizeTasks);
+            taskCount = Min(maxTasks, work.itemCount() - 1);
+        }
+
+        size_t tasksStarted = 0;
+        if (taskCount) {
+            AutoLockHelperThreadState lock;
+            for (size_t i = 0; i < taskCount; i++) {
+                tasks[i].emplace(rt, &work);
+                if (!tasks[i]->startWithLockHeld(lock)) {
+                    tasks[i].reset();
+                    break;
+                }
+                tasksStarted++;
+            }
+        }
 
-            // We already calculated the zone's GC trigger after foreground
-            // sweeping finished. Now we must update this value.
-            arena->zone->threshold.updateForRemovedArena(tunables);
+        work.run();
 
-            releaseArena(arena, lock);
-            releaseCount++;
-            if (releaseCount % LockReleasePeriod == 0) {
-                lock.unlock();
-                lock.lock();
+        if (tasksStarted) {
+            AutoLockHelperThreadState lock;
+            for (size_t i = 0; i < tasksStarted; i++) {
+                tasks[i]->joinOrRunWithLockHeld(lock);
             }
         }
+
+        work.finishPhase();
+    }
+
+    AutoLockGC lock(rt);
+
+    // Release any arenas that are now empty, dropping and reaquiring the GC
+    // lock every so often to avoid blocking the main thread from
+    // allocating chunks.
+    static const size_t LockReleasePeriod = 32;
+    size_t releaseCount = 0;
+    Arena* next;
+    for (Arena* arena = work.takeEmptyArenas(); arena; arena = next) {
+        next = arena->next;
+
+        // We already calculated the zone's GC trigger after foreground
+        // sweeping finished. Now we must update this value.
+        arena->zone->threshold.updateForRemovedArena(tunables);
+
+        releaseArena(arena, lock);
+        releaseCount++;
+        if (releaseCount % LockReleasePeriod == 0) {
+            lock.unlock();
+            lock.lock();
+        }
+    }
+}
+
+void
+GCRuntime::sweepBackgroundThings(ZoneList& zones, LifoAlloc& freeBlocks)
+{
+    freeBlocks.freeAll();
+
+    if (zones.isEmpty()) {
+        return;
+    }
+
+    // The atoms zone must be finalized last as other zones may have direct
+    // pointers into it. The other zones are finalized together.
+    ZoneList atomsZone;
+    ZoneList otherZones;
+    while (!zones.isEmpty()) {
+        Zone* zone = zones.removeFront();
+        if (zone->isAtomsZone()) {
+            atomsZone.append(zone);
+        } else {
+            otherZones.append(zone);
+        }
     }
+
+    backgroundFinalizeZones(otherZones);
+    backgroundFinalizeZones(atomsZone);
+
+    otherZones.clear();
+    atomsZone.clear();
 }
 
 void
@@ -4265,6 +5073,11 @@ GCRuntime::purgeRuntime()
 
     for (GCRealmsIter realm(rt); !realm.done(); realm.next()) {
         realm->purge();
+
+        // The pc-to-line tables are rebuilt from the source notes on demand.
+        if (invocationKind == GC_SHRINK) {
+            realm->clearScriptLineTables();
+        }
     }
 
     for (GCZonesIter zone(rt); !zone.done(); zone.next()) {
@@ -4275,10 +5088,17 @@ GCRuntime::purgeRuntime()
 
     JSContext* cx = rt->mainContextFromOwnThread();
     freeUnusedLifoBlocksAfterSweeping(&cx->tempLifoAlloc());
+    if (invocationKind == GC_SHRINK) {
+        cx->lifoChunkPool().freeAll();
+    }
     cx->interpreterStack().purge(rt);
     cx->frontendCollectionPool().purge();
 
     rt->caches().purge();
+    rt->arrayBufferContentsPool.purge();
+    if (invocationKind == GC_SHRINK) {
+        PurgeAsmJSModuleCache(rt);
+    }
 
     if (auto cache = rt->maybeThisRuntimeSharedImmutableStrings()) {
         cache->purge();
@@ -4560,7 +5380,11 @@ DiscardJITCodeForGC(JSRuntime* rt)
     js::CancelOffThreadIonCompile(rt, JS::Zone::Mark);
     for (GCZonesIter zone(rt); !zone.done(); zone.next()) {
         gcstats::AutoPhase ap(rt->gc.stats(), gcstats::PhaseKind::MARK_DISCARD_CODE);
-        zone->discardJitCode(rt->defaultFreeOp());
+        if (zone->isPreservingCode()) {
+            zone->discardAgedJitCode(rt->defaultFreeOp());
+        } else {
+            zone->discardJitCode(rt->defaultFreeOp());
+        }
     }
 }
 
@@ -6271,6 +7095,12 @@ GCRuntime::drainMarkStack(SliceBudget& sliceBudget, gcstats::PhaseKind phase)
 
     /* Run a marking slice and return whether the stack is now empty. */
     gcstats::AutoPhase ap(stats(), phase);
+
+    if (ParallelMarker::canMarkInParallel(this, sliceBudget)) {
+        ParallelMarker pm(this);
+        pm.mark(sliceBudget);
+    }
+
     return marker.drainMarkStack(sliceBudget) ? Finished : NotFinished;
 }
 
@@ -6305,6 +7135,9 @@ SweepArenaList(Arena** arenasToSweep, SliceBudget& sliceBudget)
 
         *arenasToSweep = (*arenasToSweep)->next;
         AllocKind kind = MapTypeToFinalizeKind<T>::kind;
+
+        // The budget is shared by all zone sweep tasks running in this slice.
+        AutoLockHelperThreadState lock;
         sliceBudget.step(Arena::thingsPerArena(kind));
         if (sliceBudget.isOverBudget()) {
             return false;
@@ -6314,8 +7147,120 @@ SweepArenaList(Arena** arenasToSweep, SliceBudget& sliceBudget)
     return true;
 }
 
+static bool
+HasTypeInformationToSweep(Zone* zone)
+{
+    ArenaLists& al = zone->arenas;
+    return al.gcScriptArenasToUpdate || al.gcObjectGroupArenasToUpdate;
+}
+
+static bool
+SweepZoneTypeInformation(Zone* zone, SliceBudget& budget)
+{
+    ArenaLists& al = zone->arenas;
+    return SweepArenaList<JSScript>(&al.gcScriptArenasToUpdate.ref(), budget) &&
+           SweepArenaList<ObjectGroup>(&al.gcObjectGroupArenasToUpdate.ref(), budget);
+}
+
+static bool
+HasShapeTreeToSweep(Zone* zone)
+{
+    ArenaLists& al = zone->arenas;
+    return al.gcShapeArenasToUpdate || al.gcAccessorShapeArenasToUpdate;
+}
+
+static bool
+SweepZoneShapeTree(Zone* zone, SliceBudget& budget)
+{
+    ArenaLists& al = zone->arenas;
+    return SweepArenaList<Shape>(&al.gcShapeArenasToUpdate.ref(), budget) &&
+           SweepArenaList<AccessorShape>(&al.gcAccessorShapeArenasToUpdate.ref(), budget);
+}
+
+using ZoneSweepPredicate = bool (*)(Zone* zone);
+using ZoneSweepFunc = bool (*)(Zone* zone, SliceBudget& budget);
+
+// Sweep things in a single zone off the main thread. Type information and
+// shape trees never refer to things in other zones, so the task is given
+// exclusive access to its zone until it is joined.
+class SweepZoneTask : public GCParallelTaskHelper<SweepZoneTask>
+{
+    Zone* zone_;
+    ZoneSweepFunc sweep_;
+    SliceBudget& budget_;
+    gcstats::PhaseKind phase_;
+    AutoLockHelperThreadState& lock_;
+
+  public:
+    SweepZoneTask(JSRuntime* rt, Zone* zone, ZoneSweepFunc sweep, SliceBudget& budget,
+                  gcstats::PhaseKind phase, AutoLockHelperThreadState& lock)
+      : GCParallelTaskHelper(rt), zone_(zone), sweep_(sweep), budget_(budget), phase_(phase),
+        lock_(lock)
+    {
+        runtime()->gc.startTask(*this, phase_, lock_);
+    }
+
+    ~SweepZoneTask() {
+        runtime()->gc.joinTask(*this, phase_, lock_);
+    }
+
+    void run() {
+        AutoSetThreadIsSweeping threadIsSweeping;
+        zone_->setGCSweepTaskOwnerContext(TlsContext.get());
+        sweep_(zone_, budget_);
+        zone_->setGCSweepTaskOwnerContext(nullptr);
+    }
+};
+
+static const size_t MaxZoneSweepTasks = 8;
+
+static size_t
+ZoneSweepTaskCount()
+{
+    size_t targetTaskCount = HelperThreadState().cpuCount;
+    return Min(targetTaskCount, MaxZoneSweepTasks);
+}
+
+// Sweep the zones in the current sweep group in parallel, one task per zone,
+// until there is no work left or the slice budget is exhausted.
+static IncrementalProgress
+SweepZonesInParallel(JSRuntime* rt, SliceBudget& budget, ZoneSweepPredicate hasWork,
+                     ZoneSweepFunc sweep, gcstats::PhaseKind phase, bool sweepingTypes)
+{
+    SweepGroupZonesIter zone(rt);
+    while (!zone.done() && !budget.isOverBudget()) {
+        // OOM handling for type sweeping can only happen on the main thread,
+        // so the guards must outlive the tasks and the helper thread lock.
+        Maybe<AutoClearTypeInferenceStateOnOOM> clearStateOnOOM[MaxZoneSweepTasks];
+
+        AutoLockHelperThreadState lock;
+        Maybe<SweepZoneTask> tasks[MaxZoneSweepTasks];
+        for (size_t i = 0; !zone.done() && i < ZoneSweepTaskCount(); zone.next()) {
+            if (!hasWork(zone)) {
+                continue;
+            }
+
+            if (sweepingTypes) {
+                clearStateOnOOM[i].emplace(zone);
+            }
+            tasks[i].emplace(rt, zone, sweep, budget, phase, lock);
+            i++;
+        }
+
+        // Tasks run until budget or work is exhausted.
+    }
+
+    for (SweepGroupZonesIter zone(rt); !zone.done(); zone.next()) {
+        if (hasWork(zone)) {
+            return NotFinished;
+        }
+    }
+
+    return Finished;
+}
+
 IncrementalProgress
-GCRuntime::sweepTypeInformation(FreeOp* fop, SliceBudget& budget, Zone* zone)
+GCRuntime::sweepTypeInformation(FreeOp* fop, SliceBudget& budget)
 {
     // Sweep dead type information stored in scripts and object groups, but
     // don't finalize them yet. We have to sweep dead information from both live
@@ -6324,25 +7269,23 @@ GCRuntime::sweepTypeInformation(FreeOp* fop, SliceBudget& budget, Zone* zone)
     // TypeCompartment::markSetsUnknown, and if this happens after sweeping for
     // the sweep group finishes we won't be able to determine which things in
     // the zone are live.
+    //
+    // Zones are swept in parallel with each other. The data is copied into
+    // each zone's own type LifoAlloc, so this is safe as long as a zone is
+    // only swept by one task at a time.
 
-    gcstats::AutoPhase ap1(stats(), gcstats::PhaseKind::SWEEP_COMPARTMENTS);
-    gcstats::AutoPhase ap2(stats(), gcstats::PhaseKind::SWEEP_TYPES);
-
-    ArenaLists& al = zone->arenas;
-
-    AutoClearTypeInferenceStateOnOOM oom(zone);
-
-    if (!SweepArenaList<JSScript>(&al.gcScriptArenasToUpdate.ref(), budget)) {
-        return NotFinished;
-    }
+    gcstats::AutoPhase ap(stats(), gcstats::PhaseKind::SWEEP_COMPARTMENTS);
 
-    if (!SweepArenaList<ObjectGroup>(&al.gcObjectGroupArenasToUpdate.ref(), budget)) {
+    if (SweepZonesInParallel(rt, budget, HasTypeInformationToSweep, SweepZoneTypeInformation,
+                             gcstats::PhaseKind::SWEEP_TYPES, true) == NotFinished)
+    {
         return NotFinished;
     }
 
-    // Finish sweeping type information in the zone.
-    {
-        gcstats::AutoPhase ap(stats(), gcstats::PhaseKind::SWEEP_TYPES_END);
+    // Finish sweeping type information in the sweep group.
+    gcstats::AutoPhase ap2(stats(), gcstats::PhaseKind::SWEEP_TYPES);
+    gcstats::AutoPhase ap3(stats(), gcstats::PhaseKind::SWEEP_TYPES_END);
+    for (SweepGroupZonesIter zone(rt); !zone.done(); zone.next()) {
         zone->types.endSweep(rt);
     }
 
@@ -6552,23 +7495,13 @@ GCRuntime::finalizeAllocKind(FreeOp* fop, SliceBudget& budget, Zone* zone, Alloc
 }
 
 IncrementalProgress
-GCRuntime::sweepShapeTree(FreeOp* fop, SliceBudget& budget, Zone* zone)
+GCRuntime::sweepShapeTree(FreeOp* fop, SliceBudget& budget)
 {
     // Remove dead shapes from the shape tree, but don't finalize them yet.
+    // Each zone has its own property tree, so zones are swept in parallel.
 
-    gcstats::AutoPhase ap(stats(), gcstats::PhaseKind::SWEEP_SHAPE);
-
-    ArenaLists& al = zone->arenas;
-
-    if (!SweepArenaList<Shape>(&al.gcShapeArenasToUpdate.ref(), budget)) {
-        return NotFinished;
-    }
-
-    if (!SweepArenaList<AccessorShape>(&al.gcAccessorShapeArenasToUpdate.ref(), budget)) {
-        return NotFinished;
-    }
-
-    return Finished;
+    return SweepZonesInParallel(rt, budget, HasShapeTreeToSweep, SweepZoneShapeTree,
+                                gcstats::PhaseKind::SWEEP_SHAPE, false);
 }
 
 // An iterator for a standard container that provides an STL-like begin()/end()
@@ -6944,19 +7877,20 @@ GCRuntime::initSweepActions()
                            Call(&GCRuntime::sweepAtomsTable)),
                 MaybeYield(ZealMode::YieldBeforeSweepingCaches,
                            Call(&GCRuntime::sweepWeakCaches)),
+                MaybeYield(ZealMode::YieldBeforeSweepingTypes,
+                           Call(&GCRuntime::sweepTypeInformation)),
                 ForEachZoneInSweepGroup(rt,
                     Sequence(
-                        MaybeYield(ZealMode::YieldBeforeSweepingTypes,
-                                   Call(&GCRuntime::sweepTypeInformation)),
                         MaybeYield(ZealMode::YieldBeforeSweepingObjects,
                                    ForEachAllocKind(ForegroundObjectFinalizePhase.kinds,
                                                     Call(&GCRuntime::finalizeAllocKind))),
                         MaybeYield(ZealMode::YieldBeforeSweepingNonObjects,
                                    ForEachAllocKind(ForegroundNonObjectFinalizePhase.kinds,
-                                                    Call(&GCRuntime::finalizeAllocKind))),
-                        MaybeYield(ZealMode::YieldBeforeSweepingShapeTrees,
-                                   Call(&GCRuntime::sweepShapeTree)),
-                        Call(&GCRuntime::releaseSweptEmptyArenas))),
+                                                    Call(&GCRuntime::finalizeAllocKind))))),
+                MaybeYield(ZealMode::YieldBeforeSweepingShapeTrees,
+                           Call(&GCRuntime::sweepShapeTree)),
+                ForEachZoneInSweepGroup(rt,
+                    Call(&GCRuntime::releaseSweptEmptyArenas)),
                 Call(&GCRuntime::endSweepingSweepGroup)));
 
     return sweepActions != nullptr;
@@ -7109,6 +8043,7 @@ GCRuntime::compactPhase(JS::gcreason::Reason reason, SliceBudget& sliceBudget,
 
     ZoneList relocatedZones;
     Arena* relocatedArenas = nullptr;
+    Zone* unfinishedZone = nullptr;
     while (!zonesToMaybeCompact.ref().isEmpty()) {
 
         Zone* zone = zonesToMaybeCompact.ref().front();
@@ -7117,9 +8052,15 @@ GCRuntime::compactPhase(JS::gcreason::Reason reason, SliceBudget& sliceBudget,
         MOZ_ASSERT(nursery().isEmpty());
         zone->changeGCState(Zone::Finished, Zone::Compact);
 
-        if (relocateArenas(zone, reason, relocatedArenas, sliceBudget)) {
+        IncrementalProgress progress;
+        if (relocateArenas(zone, reason, relocatedArenas, sliceBudget, &progress)) {
             updateZonePointersToRelocatedCells(zone);
             relocatedZones.append(zone);
+            if (progress == NotFinished) {
+                // Relocate the rest of this zone in the next slice.
+                MOZ_ASSERT(sliceBudget.isOverBudget());
+                unfinishedZone = zone;
+            }
         } else {
             zone->changeGCState(Zone::Compact, Zone::Finished);
         }
@@ -7140,6 +8081,10 @@ GCRuntime::compactPhase(JS::gcreason::Reason reason, SliceBudget& sliceBudget,
         while (!relocatedZones.isEmpty());
     }
 
+    if (unfinishedZone) {
+        zonesToMaybeCompact.ref().prepend(unfinishedZone);
+    }
+
     if (ShouldProtectRelocatedArenas(reason)) {
         protectAndHoldArenas(relocatedArenas);
     } else {
@@ -7186,6 +8131,11 @@ GCRuntime::finishCollection()
     MOZ_ASSERT(zonesToMaybeCompact.ref().isEmpty());
 
     lastGCTime = currentTime;
+
+    // Refill the empty chunk reserve now rather than on the next chunk
+    // allocation, so that a burst of allocation after the GC is less likely
+    // to have to wait for the OS to map new chunks.
+    maybeStartBackgroundAllocation();
 }
 
 static const char*
@@ -7623,7 +8573,7 @@ GCRuntime::incrementalCollectSlice(SliceBudget& budget, JS::gcreason::Reason rea
         MOZ_ASSERT(!startedCompacting);
         incrementalState = State::Compact;
 
-        // Always yield before compacting since it is not incremental.
+        // Yield before compacting so that relocation starts with a full slice.
         if (isCompacting && !budget.isUnlimited()) {
             break;
         }
@@ -8115,6 +9065,12 @@ GCRuntime::collect(bool nonincrementalByAPI, SliceBudget budget, JS::gcreason::R
 
     stats().writeLogMessage("GC starting in state %s", StateName(incrementalState));
 
+    // The GC may poison or release JIT code in pages which a batch has left
+    // writable, so make them executable again first.
+    if (jit::AutoBatchJitCodeReprotection* batch = rt->jitCodeReprotectionBatch()) {
+        batch->flush();
+    }
+
     AutoTraceLog logGC(TraceLoggerForCurrentThread(), TraceLogger_GC);
     AutoStopVerifyingBarriers av(rt, IsShutdownGC(reason));
     AutoEnqueuePendingParseTasksAfterGC aept(*this);
@@ -8186,8 +9142,17 @@ GCRuntime::defaultBudget(JS::gcreason::Reason reason, int64_t millis)
     if (millis == 0) {
         if (reason == JS::gcreason::ALLOC_TRIGGER) {
             millis = defaultSliceBudget();
-        } else if (schedulingState.inHighFrequencyGCMode() && tunables.isDynamicMarkSliceEnabled()) {
-            millis = defaultSliceBudget() * IGC_MARK_SLICE_MULTIPLIER;
+        } else if (tunables.isDynamicMarkSliceEnabled()) {
+            int multiplier = 1;
+            if (schedulingState.inHighFrequencyGCMode()) {
+                multiplier = IGC_MARK_SLICE_MULTIPLIER;
+            }
+            if (isIncrementalGCInProgress() && incrementalState == State::Mark) {
+                size_t growth = stats().slices().length() / IGC_MARK_SLICE_GROWTH_SLICES;
+                multiplier = Max(multiplier,
+                                 int(Min(1 + growth, size_t(IGC_MAX_MARK_SLICE_MULTIPLIER))));
+            }
+            millis = defaultSliceBudget() * multiplier;
         } else {
             millis = defaultSliceBudget();
         }
@@ -8480,6 +9445,7 @@ js::NewRealm(JSContext* cx, JSPrincipals* principals, const JS::RealmOptions& op
             ReportOutOfMemory(cx);
             return nullptr;
         }
+        zoneHolder->initJitSpectreMitigations(options.creationOptions().spectreMitigations());
 
         zone = zoneHolder.get();
     }
@@ -8504,6 +9470,13 @@ js::NewRealm(JSContext* cx, JSPrincipals* principals, const JS::RealmOptions& op
         MOZ_RELEASE_ASSERT(realm->isSystem() == IsSystemCompartment(comp));
     }
 
+    // Likewise, JIT code compiled without Spectre mitigations must not be
+    // shared with realms that want them.
+    if (!zoneHolder) {
+        MOZ_RELEASE_ASSERT(zone->jitSpectreMitigations() ==
+                           options.creationOptions().spectreMitigations());
+    }
+
     AutoLockGC lock(rt);
 
     // Reserve space in the Vectors before we start mutating them.
@@ -8903,6 +9876,9 @@ JS::AssertGCThingIsNotNurseryAllocable(Cell* cell)
 {
     MOZ_ASSERT(cell);
     MOZ_ASSERT(!cell->is<JSObject>() && !cell->is<JSString>());
+#ifdef ENABLE_BIGINT
+    MOZ_ASSERT(!cell->is<JS::BigInt>());
+#endif
 }
 
 JS_FRIEND_API(void)
@@ -8916,8 +9892,7 @@ js::gc::AssertGCThingHasType(js::gc::Cell* cell, JS::TraceKind kind)
     MOZ_ASSERT(IsCellPointerValid(cell));
 
     if (IsInsideNursery(cell)) {
-        MOZ_ASSERT(kind == (cell->nurseryCellIsString() ? JS::TraceKind::String
-                                                        : JS::TraceKind::Object));
+        MOZ_ASSERT(kind == cell->getTraceKind());
         return;
     }
 
@@ -23,6 +23,7 @@ static const size_t INCREMENTAL_MARK_STACK_BASE_CAPACITY = 32768;
 namespace gc {
 
 struct Cell;
+class ParallelMarker;
 
 struct WeakKeyTableHashPolicy {
     typedef JS::GCCellPtr Lookup;
@@ -168,6 +169,13 @@ class MarkStack
 
     void setGCMode(JSGCMode gcMode);
 
+    /*
+     * Move whole entries from the top of this stack onto |dst| until at least
+     * |count| words have been moved or this stack is empty. Returns false
+     * without moving anything if |dst| cannot be grown.
+     */
+    MOZ_MUST_USE bool transferEntriesTo(MarkStack& dst, size_t count);
+
     void poisonUnused();
 
     size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
@@ -190,13 +198,13 @@ class MarkStack
     MOZ_MUST_USE bool pushTaggedPtr(Tag tag, Cell* ptr);
 
     // Index of the top of the stack.
-    MainThreadData<size_t> topIndex_;
+    MainThreadOrGCTaskData<size_t> topIndex_;
 
     // The maximum stack capacity to grow to.
-    MainThreadData<size_t> maxCapacity_;
+    MainThreadOrGCTaskData<size_t> maxCapacity_;
 
     // Vector containing allocated stack memory. Unused beyond topIndex_.
-    MainThreadData<StackVector> stack_;
+    MainThreadOrGCTaskData<StackVector> stack_;
 
 #ifdef DEBUG
     mutable size_t iteratorCount_;
@@ -237,6 +245,11 @@ class GCMarker : public JSTracer
     explicit GCMarker(JSRuntime* rt);
     MOZ_MUST_USE bool init(JSGCMode gcMode);
 
+    // Set up a marker owned by a parallel marking task. See
+    // gc/ParallelMarking.h.
+    MOZ_MUST_USE bool initForParallelMarking(size_t maxCap);
+    bool isParallelMarker() const { return isParallelMarker_; }
+
     void setMaxCapacity(size_t maxCap) { stack.setMaxCapacity(maxCap); }
     size_t maxCapacity() const { return stack.maxCapacity(); }
 
@@ -303,6 +316,13 @@ class GCMarker : public JSTracer
 
     MOZ_MUST_USE bool drainMarkStack(SliceBudget& budget);
 
+    // Drain the mark stack of a parallel marker, donating work to |pm| when
+    // other markers have run out. Returns false if the budget was exceeded.
+    MOZ_MUST_USE bool drainParallelMarkStack(gc::ParallelMarker& pm, SliceBudget& budget);
+
+    // Take over the remaining work of a parallel marker once it has stopped.
+    void takeParallelMarkerWork(GCMarker& other);
+
     void setGCMode(JSGCMode mode) { stack.setGCMode(mode); }
 
     size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
@@ -333,6 +353,14 @@ class GCMarker : public JSTracer
     // already been marked.
     inline void repush(JSObject* obj);
 
+    // Record a cell marked by a parallel marker whose children must be
+    // traced on the main thread.
+    void deferTracingChildren(JS::GCCellPtr thing);
+    void traceDeferredChildren(JS::GCCellPtr thing);
+
+    // Move all entries from |src| to this marker's stack.
+    void takeMarkStackEntries(gc::MarkStack& src);
+
     template <typename T> void markAndTraceChildren(T* thing);
     template <typename T> void markAndPush(T* thing);
     template <typename T> void markAndScan(T* thing);
@@ -377,30 +405,46 @@ class GCMarker : public JSTracer
     gc::MarkStack stack;
 
     /* The color is only applied to objects and functions. */
-    MainThreadData<gc::MarkColor> color;
+    MainThreadOrGCTaskData<gc::MarkColor> color;
 
     /* Pointer to the top of the stack of arenas we are delaying marking on. */
-    MainThreadData<js::gc::Arena*> unmarkedArenaStackTop;
+    MainThreadOrGCTaskData<js::gc::Arena*> unmarkedArenaStackTop;
 
     /*
      * If the weakKeys table OOMs, disable the linear algorithm and fall back
      * to iterating until the next GC.
      */
-    MainThreadData<bool> linearWeakMarkingDisabled_;
+    MainThreadOrGCTaskData<bool> linearWeakMarkingDisabled_;
+
+    /*
+     * Whether this marker belongs to a parallel marking task. Parallel markers
+     * only mark black, set mark bits atomically and never use the delayed
+     * marking list, which is shared through the arenas.
+     */
+    bool isParallelMarker_;
+
+    /*
+     * Cells marked by a parallel marker whose children could not be traced
+     * off the main thread.
+     */
+    using DeferredCellVector = Vector<JS::GCCellPtr, 0, SystemAllocPolicy>;
+    MainThreadOrGCTaskData<DeferredCellVector> deferredCells_;
 
 #ifdef DEBUG
     /* Count of arenas that are currently in the stack. */
-    MainThreadData<size_t> markLaterArenas;
+    MainThreadOrGCTaskData<size_t> markLaterArenas;
 
     /* Assert that start and stop are called with correct ordering. */
-    MainThreadData<bool> started;
+    MainThreadOrGCTaskData<bool> started;
 
     /*
      * If this is true, all marked objects must belong to a compartment being
      * GCed. This is used to look for compartment bugs.
      */
-    MainThreadData<bool> strictCompartmentChecking;
+    MainThreadOrGCTaskData<bool> strictCompartmentChecking;
 #endif // DEBUG
+
+    friend class gc::ParallelMarker;
 };
 
 } /* namespace js */
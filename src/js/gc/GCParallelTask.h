@@ -83,6 +83,12 @@ class GCParallelTask
     MOZ_MUST_USE bool startWithLockHeld(AutoLockHelperThreadState& locked);
     void joinWithLockHeld(AutoLockHelperThreadState& locked);
 
+    // Like joinWithLockHeld, but if no helper thread has picked the task up
+    // yet, take it back and run it on the current thread instead of waiting.
+    // Tasks started from a helper thread need this, as the limit on the
+    // number of GC helper threads may leave no other thread to run them.
+    void joinOrRunWithLockHeld(AutoLockHelperThreadState& locked);
+
     // Instead of dispatching to a helper, run the task on the current thread.
     void runFromMainThread(JSRuntime* rt);
 
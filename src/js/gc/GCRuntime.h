@@ -37,6 +37,8 @@ namespace gc {
 using BlackGrayEdgeVector = Vector<TenuredCell*, 0, SystemAllocPolicy>;
 using ZoneVector = Vector<JS::Zone*, 4, SystemAllocPolicy>;
 
+class AllocSite;
+class ArenasToRelocate;
 class AutoCallGCCallbacks;
 class AutoGCSession;
 class AutoRunParallelTask;
@@ -225,6 +227,7 @@ class ZoneList
     Zone* front() const;
 
     void append(Zone* zone);
+    void prepend(Zone* zone);
     void transferFrom(ZoneList& other);
     Zone* removeFront();
     void clear();
@@ -254,6 +257,10 @@ class GCRuntime
     MOZ_MUST_USE bool addRoot(Value* vp, const char* name);
     void removeRoot(Value* vp);
     void setMarkStackLimit(size_t limit, AutoLockGC& lock);
+    void setMemoryPressure(bool pressure, AutoLockGC& lock);
+    bool useHugePages() const { return hugePagesEnabled; }
+    bool useNumaLocalChunks() const { return numaLocalChunksEnabled; }
+    uint32_t numaNodeForChunks() const { return numaNode; }
 
     MOZ_MUST_USE bool setParameter(JSGCParamKey key, uint32_t value, AutoLockGC& lock);
     void resetParameter(JSGCParamKey key, AutoLockGC& lock);
@@ -369,6 +376,9 @@ class GCRuntime
 
     bool isCompactingGCEnabled() const;
 
+    uint32_t markingThreads() const { return markingThreadCount; }
+    uint32_t tenuringThreads() const { return tenuringThreadCount; }
+
     bool isShrinkingGC() const { return invocationKind == GC_SHRINK; }
 
     bool initSweepActions();
@@ -499,7 +509,7 @@ class GCRuntime
     MOZ_MUST_USE bool checkAllocatorState(JSContext* cx, AllocKind kind);
     template <AllowGC allowGC>
     JSObject* tryNewNurseryObject(JSContext* cx, size_t thingSize, size_t nDynamicSlots,
-                                  const Class* clasp);
+                                  const Class* clasp, AllocSite* site);
     template <AllowGC allowGC>
     static JSObject* tryNewTenuredObject(JSContext* cx, AllocKind kind, size_t thingSize,
                                          size_t nDynamicSlots);
@@ -507,6 +517,10 @@ class GCRuntime
     static T* tryNewTenuredThing(JSContext* cx, AllocKind kind, size_t thingSize);
     template <AllowGC allowGC>
     JSString* tryNewNurseryString(JSContext* cx, size_t thingSize, AllocKind kind);
+#ifdef ENABLE_BIGINT
+    template <AllowGC allowGC>
+    JS::BigInt* tryNewNurseryBigInt(JSContext* cx, size_t thingSize, AllocKind kind);
+#endif
     static TenuredCell* refillFreeListInGC(Zone* zone, AllocKind thingKind);
 
     void setParallelAtomsAllocEnabled(bool enabled);
@@ -554,12 +568,14 @@ class GCRuntime
      */
     friend class BackgroundDecommitTask;
     ChunkPool expireEmptyChunkPool(const AutoLockGC& lock);
+    unsigned emptyChunkReserve(const AutoLockGC& lock) const;
     void freeEmptyChunks(const AutoLockGC& lock);
     void prepareToFreeChunk(ChunkInfo& info);
 
     friend class BackgroundAllocTask;
     bool wantBackgroundAllocation(const AutoLockGC& lock) const;
     bool startBackgroundAllocTaskIfIdle();
+    void maybeStartBackgroundAllocation();
 
     void requestMajorGC(JS::gcreason::Reason reason);
     SliceBudget defaultBudget(JS::gcreason::Reason reason, int64_t millis);
@@ -638,14 +654,14 @@ class GCRuntime
     void sweepJitDataOnMainThread(FreeOp* fop);
     IncrementalProgress endSweepingSweepGroup(FreeOp* fop, SliceBudget& budget);
     IncrementalProgress performSweepActions(SliceBudget& sliceBudget);
-    IncrementalProgress sweepTypeInformation(FreeOp* fop, SliceBudget& budget, Zone* zone);
+    IncrementalProgress sweepTypeInformation(FreeOp* fop, SliceBudget& budget);
     IncrementalProgress releaseSweptEmptyArenas(FreeOp* fop, SliceBudget& budget, Zone* zone);
     void startSweepingAtomsTable();
     IncrementalProgress sweepAtomsTable(FreeOp* fop, SliceBudget& budget);
     IncrementalProgress sweepWeakCaches(FreeOp* fop, SliceBudget& budget);
     IncrementalProgress finalizeAllocKind(FreeOp* fop, SliceBudget& budget, Zone* zone,
                                           AllocKind kind);
-    IncrementalProgress sweepShapeTree(FreeOp* fop, SliceBudget& budget, Zone* zone);
+    IncrementalProgress sweepShapeTree(FreeOp* fop, SliceBudget& budget);
     void endSweepPhase(bool lastGC);
     bool allCCVisibleZonesWereCollected() const;
     void sweepZones(FreeOp* fop, bool destroyingRuntime);
@@ -655,6 +671,7 @@ class GCRuntime
     void maybeStartBackgroundSweep(AutoLockHelperThreadState& lock);
     void sweepFromBackgroundThread(AutoLockHelperThreadState& lock);
     void sweepBackgroundThings(ZoneList& zones, LifoAlloc& freeBlocks);
+    void backgroundFinalizeZones(ZoneList& zones);
     void assertBackgroundSweepingFinished();
     bool shouldCompact();
     void beginCompactPhase();
@@ -664,7 +681,10 @@ class GCRuntime
     void sweepTypesAfterCompacting(Zone* zone);
     void sweepZoneAfterCompacting(Zone* zone);
     MOZ_MUST_USE bool relocateArenas(Zone* zone, JS::gcreason::Reason reason,
-                                     Arena*& relocatedListOut, SliceBudget& sliceBudget);
+                                     Arena*& relocatedListOut, SliceBudget& sliceBudget,
+                                     IncrementalProgress* progressOut);
+    void relocateArenaKinds(ArenasToRelocate& toRelocate, AllocKinds kinds, size_t bgTaskCount,
+                            Arena*& relocatedListOut, SliceBudget& sliceBudget);
     void updateTypeDescrObjects(MovingTracer* trc, Zone* zone);
     void updateCellPointers(Zone* zone, AllocKinds kinds, size_t bgTaskCount);
     void updateAllCellPointers(MovingTracer* trc, Zone* zone);
@@ -742,6 +762,11 @@ class GCRuntime
     // so as to reduce the cost of operations on the available lists.
     GCLockData<ChunkPool> fullChunks_;
 
+    // Set by the embedding through JSGC_MEMORY_PRESSURE. While this is true
+    // the emptyChunks pool is not refilled and is emptied whenever chunks are
+    // expired, and free arenas are decommitted after every GC.
+    GCLockData<bool> memoryPressure;
+
     MainThreadData<RootedValueMap> rootsHash;
 
     // An incrementing id used to assign unique ids to cells that require one.
@@ -924,6 +949,40 @@ class GCRuntime
      */
     MainThreadData<bool> compactingEnabled;
 
+    /*
+     * The number of markers to use when draining the mark stack. Marking is
+     * serial when this is one.
+     *
+     * JSGC_MARKING_THREAD_COUNT
+     */
+    MainThreadData<uint32_t> markingThreadCount;
+
+    /*
+     * The number of tracers to use when tenuring in a minor GC. Tenuring is
+     * serial when this is one.
+     *
+     * JSGC_TENURING_THREAD_COUNT
+     */
+    MainThreadData<uint32_t> tenuringThreadCount;
+
+    /*
+     * Whether to ask for new chunks to be backed by huge pages. This is read
+     * when allocating chunks, which may happen off the main thread.
+     *
+     * JSGC_HUGE_PAGES
+     */
+    UnprotectedData<bool> hugePagesEnabled;
+
+    /*
+     * Whether to ask for new chunks to be placed on |numaNode|, the NUMA node
+     * the runtime was created on. Like hugePagesEnabled, these are read when
+     * allocating chunks off the main thread.
+     *
+     * JSGC_NUMA_LOCAL_CHUNKS
+     */
+    UnprotectedData<bool> numaLocalChunksEnabled;
+    UnprotectedData<uint32_t> numaNode;
+
     MainThreadData<bool> rootsRemoved;
 
     /*
@@ -1029,6 +1088,9 @@ class GCRuntime
     const void* addressOfStringNurseryCurrentEnd() {
         return nursery_.refNoCheck().addressOfCurrentStringEnd();
     }
+    void* addressOfNurseryAllocatedSites() {
+        return nursery_.refNoCheck().addressOfAllocatedSites();
+    }
     uint32_t* addressOfNurseryAllocCount() {
         return stats().addressOfAllocsSinceMinorGCNursery();
     }
@@ -150,7 +150,10 @@ PhaseKindGraphRoots = [
         JoinParallelTasksPhaseKind
     ]),
     PhaseKind("COMPACT", "Compact", 40, [
-        PhaseKind("COMPACT_MOVE", "Compact Move", 41),
+        PhaseKind("COMPACT_MOVE", "Compact Move", 41, [
+            PhaseKind("COMPACT_MOVE_CELLS", "Compact Move Cells", 71),
+            JoinParallelTasksPhaseKind
+        ]),
         PhaseKind("COMPACT_UPDATE", "Compact Update", 42, [
             MarkRootsPhaseKind,
             PhaseKind("COMPACT_UPDATE_CELLS", "Compact Update Cells", 43),
@@ -15,6 +15,9 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#ifdef _MSC_VER
+# include <intrin.h>
+#endif
 
 #include "jsfriendapi.h"
 #include "jspubtd.h"
@@ -596,6 +599,27 @@ static_assert(ArenasPerChunk == 62, "Do not accidentally change our heap's densi
 static_assert(ArenasPerChunk == 252, "Do not accidentally change our heap's density.");
 #endif
 
+/*
+ * Atomically set |mask| in the mark bitmap word at |word| and return the
+ * previous value of the word. Relaxed ordering is enough here: mark bits do
+ * not publish any other data, the only requirement is that concurrent markers
+ * agree on which of them set a given bit.
+ */
+static MOZ_ALWAYS_INLINE uintptr_t
+AtomicFetchOrMarkWord(uintptr_t* word, uintptr_t mask)
+{
+#if defined(_MSC_VER)
+# ifdef JS_64BIT
+    return uintptr_t(_InterlockedOr64(reinterpret_cast<volatile __int64*>(word),
+                                      __int64(mask)));
+# else
+    return uintptr_t(_InterlockedOr(reinterpret_cast<volatile long*>(word), long(mask)));
+# endif
+#else
+    return __atomic_fetch_or(word, mask, __ATOMIC_RELAXED);
+#endif
+}
+
 /* A chunk bitmap contains enough mark bits for all the cells in a chunk. */
 struct ChunkBitmap
 {
@@ -652,6 +676,18 @@ struct ChunkBitmap
         return true;
     }
 
+    // As markIfUnmarked, but safe to call when several threads are marking
+    // the same chunk at once. Only black marking is supported: parallel
+    // marking never marks gray.
+    MOZ_ALWAYS_INLINE bool markIfUnmarkedAtomic(const TenuredCell* cell) {
+        uintptr_t* word, mask;
+        getMarkWordAndMask(cell, ColorBit::BlackBit, &word, &mask);
+        if (*word & mask) {
+            return false;
+        }
+        return !(AtomicFetchOrMarkWord(word, mask) & mask);
+    }
+
     MOZ_ALWAYS_INLINE void markBlack(const TenuredCell* cell) {
         uintptr_t* word, mask;
         getMarkWordAndMask(cell, ColorBit::BlackBit, &word, &mask);
@@ -33,7 +33,11 @@ struct MightBeForwarded
                               mozilla::IsBaseOf<JSScript, T>::value ||
                               mozilla::IsBaseOf<js::LazyScript, T>::value ||
                               mozilla::IsBaseOf<js::Scope, T>::value ||
-                              mozilla::IsBaseOf<js::RegExpShared, T>::value;
+                              mozilla::IsBaseOf<js::RegExpShared, T>::value
+#ifdef ENABLE_BIGINT
+                              || mozilla::IsBaseOf<JS::BigInt, T>::value
+#endif
+                              ;
 };
 
 template <typename T>
@@ -8,6 +8,7 @@
 
 #include "mozilla/DebugOnly.h"
 #include "mozilla/IntegerRange.h"
+#include "mozilla/PodOperations.h"
 #include "mozilla/ReentrancyGuard.h"
 #include "mozilla/ScopeExit.h"
 #include "mozilla/TypeTraits.h"
@@ -16,7 +17,10 @@
 
 #include "builtin/ModuleObject.h"
 #include "gc/GCInternals.h"
+#include "gc/ParallelMarking.h"
+#include "gc/ParallelTenuring.h"
 #include "gc/Policy.h"
+#include "gc/Pretenuring.h"
 #include "jit/IonCode.h"
 #include "js/SliceBudget.h"
 #include "vm/ArgumentsObject.h"
@@ -229,7 +233,10 @@ js::CheckTracedThing(JSTracer* trc, T* thing)
     Zone* zone = thing->zoneFromAnyThread();
     JSRuntime* rt = trc->runtime();
 
-    if (!IsMovingTracer(trc) && !IsBufferGrayRootsTracer(trc) && !IsClearEdgesTracer(trc)) {
+    bool isParallelMarker = trc->isMarkingTracer() && GCMarker::fromTracer(trc)->isParallelMarker();
+    if (!IsMovingTracer(trc) && !IsBufferGrayRootsTracer(trc) && !IsClearEdgesTracer(trc) &&
+        !isParallelMarker)
+    {
         MOZ_ASSERT(CurrentThreadCanAccessZone(zone));
         MOZ_ASSERT(CurrentThreadCanAccessRuntime(rt));
     }
@@ -722,6 +729,22 @@ ShouldMark<JSString*>(GCMarker* gcmarker, JSString* str)
     return str->asTenured().zone()->shouldMarkInZone();
 }
 
+#ifdef ENABLE_BIGINT
+// BigInts can also be in the nursery. See ShouldMark<JSObject*> for comments.
+template <>
+bool
+ShouldMark<JS::BigInt*>(GCMarker* gcmarker, JS::BigInt* bi)
+{
+    if (IsOwnedByOtherRuntime(gcmarker->runtime(), bi)) {
+        return false;
+    }
+    if (IsInsideNursery(bi)) {
+        return false;
+    }
+    return bi->asTenured().zone()->shouldMarkInZone();
+}
+#endif
+
 template <typename T>
 void
 DoMarking(GCMarker* gcmarker, T* thing)
@@ -794,6 +817,57 @@ js::GCMarker::noteWeakEdge(T* edge)
     }
 }
 
+// Parallel markers may only trace the children of things whose tracing does
+// not touch state shared with other markers. Other things are marked by the
+// parallel marker but their children are traced later on the main thread.
+template <typename T>
+static inline bool
+CanTraceChildrenInParallel(T* thing)
+{
+    return true;
+}
+
+static inline bool
+CanTraceChildrenInParallel(JSObject* obj)
+{
+    // Class trace hooks may do arbitrary work.
+    return !obj->getClass()->hasTrace();
+}
+
+static inline bool
+CanTraceChildrenInParallel(ObjectGroup* group)
+{
+    // Tracing a group may sweep its type information.
+    return false;
+}
+
+static inline bool
+CanTraceChildrenInParallel(JSScript* script)
+{
+    // Tracing a script marks its realm and traces its JIT data.
+    return false;
+}
+
+static inline bool
+CanTraceChildrenInParallel(jit::JitCode* code)
+{
+    return false;
+}
+
+static inline bool
+CanTraceChildrenInParallel(LazyScript* lazy)
+{
+    // Weak edges are recorded in a per-zone vector.
+    return false;
+}
+
+static inline bool
+CanTraceChildrenInParallel(RegExpShared* shared)
+{
+    // Tracing may discard JIT code.
+    return false;
+}
+
 // The simplest traversal calls out to the fully generic traceChildren function
 // to visit the child edges. In the absence of other traversal mechanisms, this
 // function will rapidly grow the stack past its bounds and crash the process.
@@ -806,9 +880,14 @@ js::GCMarker::markAndTraceChildren(T* thing)
     if (ThingIsPermanentAtomOrWellKnownSymbol(thing)) {
         return;
     }
-    if (mark(thing)) {
-        thing->traceChildren(this);
+    if (!mark(thing)) {
+        return;
     }
+    if (MOZ_UNLIKELY(isParallelMarker()) && !CanTraceChildrenInParallel(thing)) {
+        deferTracingChildren(JS::GCCellPtr(thing));
+        return;
+    }
+    thing->traceChildren(this);
 }
 namespace js {
 template <> void GCMarker::traverse(BaseShape* thing) { markAndTraceChildren(thing); }
@@ -829,9 +908,14 @@ js::GCMarker::markAndScan(T* thing)
     if (ThingIsPermanentAtomOrWellKnownSymbol(thing)) {
         return;
     }
-    if (mark(thing)) {
-        eagerlyMarkChildren(thing);
+    if (!mark(thing)) {
+        return;
     }
+    if (MOZ_UNLIKELY(isParallelMarker()) && !CanTraceChildrenInParallel(thing)) {
+        deferTracingChildren(JS::GCCellPtr(thing));
+        return;
+    }
+    eagerlyMarkChildren(thing);
 }
 namespace js {
 template <> void GCMarker::traverse(JSString* thing) { markAndScan(thing); }
@@ -852,6 +936,10 @@ js::GCMarker::markAndPush(T* thing)
     if (!mark(thing)) {
         return;
     }
+    if (MOZ_UNLIKELY(isParallelMarker()) && !CanTraceChildrenInParallel(thing)) {
+        deferTracingChildren(JS::GCCellPtr(thing));
+        return;
+    }
     pushTaggedPtr(thing);
     markImplicitEdges(thing);
 }
@@ -952,6 +1040,11 @@ js::GCMarker::mark(T* thing)
     AssertShouldMarkInZone(thing);
     TenuredCell* cell = TenuredCell::fromPointer(thing);
 
+    if (MOZ_UNLIKELY(isParallelMarker())) {
+        MOZ_ASSERT(markColor() == MarkColor::Black);
+        return cell->markIfUnmarkedAtomic();
+    }
+
     if (!TypeParticipatesInCC<T>::value) {
         return cell->markIfUnmarked(MarkColor::Black);
     }
@@ -1662,6 +1755,26 @@ GCMarker::drainMarkStack(SliceBudget& budget)
     return true;
 }
 
+bool
+GCMarker::drainParallelMarkStack(ParallelMarker& pm, SliceBudget& budget)
+{
+    MOZ_ASSERT(isParallelMarker());
+    MOZ_ASSERT(!hasDelayedChildren());
+
+    while (!stack.isEmpty()) {
+        processMarkStackTop(budget);
+        if (budget.isOverBudget()) {
+            return false;
+        }
+
+        if (pm.needsWork() && stack.position() >= ParallelMarker::MinDonationWords) {
+            pm.donateWork(*this);
+        }
+    }
+
+    return true;
+}
+
 inline static bool
 ObjectDenseElementsMayBeMarkable(NativeObject* nobj)
 {
@@ -1715,6 +1828,64 @@ CheckForCompartmentMismatch(JSObject* obj, JSObject* obj2)
 #endif
 }
 
+static MOZ_ALWAYS_INLINE void
+PrefetchForMarking(const void* p)
+{
+#if defined(__GNUC__)
+    __builtin_prefetch(p);
+#endif
+}
+
+/*
+ * Objects found while scanning a value array are marked straight away but
+ * wait in this queue for a few steps before their children are scanned, so
+ * that the prefetch issued for them when they are queued has time to bring
+ * their header into the cache.
+ */
+class MarkPrefetchQueue
+{
+    static const size_t Capacity = 8;
+
+    JSObject* objects_[Capacity];
+    size_t head_;
+    size_t length_;
+
+  public:
+    MarkPrefetchQueue()
+      : head_(0), length_(0)
+    {}
+
+    bool isEmpty() const {
+        return length_ == 0;
+    }
+
+    // Queue |obj| and return the object which waited longest if the queue was
+    // full, or nullptr otherwise.
+    JSObject* exchange(JSObject* obj) {
+        PrefetchForMarking(obj);
+        if (length_ < Capacity) {
+            objects_[(head_ + length_++) % Capacity] = obj;
+            return nullptr;
+        }
+        JSObject* oldest = objects_[head_];
+        objects_[head_] = obj;
+        head_ = (head_ + 1) % Capacity;
+        return oldest;
+    }
+
+    JSObject* takeOldest() {
+        MOZ_ASSERT(!isEmpty());
+        JSObject* oldest = objects_[head_];
+        head_ = (head_ + 1) % Capacity;
+        length_--;
+        return oldest;
+    }
+};
+
+// Distance, in values, at which value arrays are prefetched ahead of the
+// scan: two cache lines.
+static const size_t ValueArrayPrefetchDistance = 2 * 64 / sizeof(HeapSlot);
+
 inline void
 GCMarker::processMarkStackTop(SliceBudget& budget)
 {
@@ -1726,6 +1897,14 @@ GCMarker::processMarkStackTop(SliceBudget& budget)
     HeapSlot* vp;
     HeapSlot* end;
     JSObject* obj;
+    MarkPrefetchQueue queue;
+
+    // Return the queued objects to the mark stack when stopping early.
+    auto flushQueue = [&]() {
+        while (!queue.isEmpty()) {
+            repush(queue.takeOldest());
+        }
+    };
 
     switch (stack.peekTag()) {
       case MarkStack::ValueArrayTag: {
@@ -1739,21 +1918,33 @@ GCMarker::processMarkStackTop(SliceBudget& budget)
       case MarkStack::ObjectTag: {
         obj = stack.popPtr().as<JSObject>();
         AssertShouldMarkInZone(obj);
+        if (MOZ_UNLIKELY(isParallelMarker()) && !CanTraceChildrenInParallel(obj)) {
+            return deferTracingChildren(JS::GCCellPtr(obj));
+        }
         goto scan_obj;
       }
 
       case MarkStack::GroupTag: {
         auto group = stack.popPtr().as<ObjectGroup>();
+        if (MOZ_UNLIKELY(isParallelMarker())) {
+            return deferTracingChildren(JS::GCCellPtr(group));
+        }
         return lazilyMarkChildren(group);
       }
 
       case MarkStack::JitCodeTag: {
         auto code = stack.popPtr().as<jit::JitCode>();
+        if (MOZ_UNLIKELY(isParallelMarker())) {
+            return deferTracingChildren(JS::GCCellPtr(code));
+        }
         return code->traceChildren(this);
       }
 
       case MarkStack::ScriptTag: {
         auto script = stack.popPtr().as<JSScript>();
+        if (MOZ_UNLIKELY(isParallelMarker())) {
+            return deferTracingChildren(JS::GCCellPtr(script));
+        }
         return script->traceChildren(this);
       }
 
@@ -1778,9 +1969,16 @@ GCMarker::processMarkStackTop(SliceBudget& budget)
         budget.step();
         if (budget.isOverBudget()) {
             pushValueArray(obj, vp, end);
+            flushQueue();
             return;
         }
 
+        if (size_t(end - vp) > ValueArrayPrefetchDistance &&
+            (uintptr_t(vp) & (64 - 1)) == 0)
+        {
+            PrefetchForMarking(vp + ValueArrayPrefetchDistance);
+        }
+
         const Value& v = *vp++;
         if (v.isString()) {
             traverseEdge(obj, v.toString());
@@ -1797,10 +1995,19 @@ GCMarker::processMarkStackTop(SliceBudget& budget)
 #endif
             CheckForCompartmentMismatch(obj, obj2);
             if (mark(obj2)) {
-                // Save the rest of this value array for later and start scanning obj2's children.
-                pushValueArray(obj, vp, end);
-                obj = obj2;
-                goto scan_obj;
+                if (MOZ_UNLIKELY(isParallelMarker()) && !CanTraceChildrenInParallel(obj2)) {
+                    deferTracingChildren(JS::GCCellPtr(obj2));
+                    continue;
+                }
+                // Queue obj2 and, once the queue is full, save the rest of
+                // this value array for later and start scanning the children
+                // of the object which waited longest.
+                JSObject* next = queue.exchange(obj2);
+                if (next) {
+                    pushValueArray(obj, vp, end);
+                    obj = next;
+                    goto scan_obj;
+                }
             }
         } else if (v.isSymbol()) {
             traverseEdge(obj, v.toSymbol());
@@ -1816,7 +2023,12 @@ GCMarker::processMarkStackTop(SliceBudget& budget)
             traverseEdge(obj, JS::GCCellPtr(cell, cell->getTraceKind()));
         }
     }
-    return;
+
+  scan_next_queued:
+    if (queue.isEmpty()) {
+        return;
+    }
+    obj = queue.takeOldest();
 
   scan_obj:
     {
@@ -1825,6 +2037,7 @@ GCMarker::processMarkStackTop(SliceBudget& budget)
         budget.step();
         if (budget.isOverBudget()) {
             repush(obj);
+            flushQueue();
             return;
         }
 
@@ -1835,7 +2048,7 @@ GCMarker::processMarkStackTop(SliceBudget& budget)
         NativeObject *nobj = CallTraceHook(TraverseObjectFunctor(), this, obj,
                                            CheckGeneration::DoChecks, this, obj);
         if (!nobj) {
-            return;
+            goto scan_next_queued;
         }
 
         Shape* shape = nobj->lastProperty();
@@ -1863,6 +2076,7 @@ GCMarker::processMarkStackTop(SliceBudget& budget)
             vp = nobj->getDenseElementsAllowCopyOnWrite();
             end = vp + nobj->getDenseInitializedLength();
 
+            PrefetchForMarking(vp);
             if (!nslots) {
                 goto scan_value_array;
             }
@@ -1876,6 +2090,7 @@ GCMarker::processMarkStackTop(SliceBudget& budget)
                 pushValueArray(nobj, vp, vp + nfixed);
                 vp = nobj->slots_;
                 end = vp + (nslots - nfixed);
+                PrefetchForMarking(vp);
                 goto scan_value_array;
             }
         }
@@ -2190,6 +2405,37 @@ MarkStack::setCapacityForMode(JSGCMode mode)
     return resize(capacity);
 }
 
+bool
+MarkStack::transferEntriesTo(MarkStack& dst, size_t count)
+{
+    MOZ_ASSERT(&dst != this);
+    MOZ_ASSERT(iteratorCount_ == 0);
+
+    // Entries can only be delimited from the top of the stack as array
+    // entries keep their tag in their last word.
+    size_t base = position();
+    while (base > 0 && position() - base < count) {
+        MarkStack::Tag tag = stack()[base - 1].tag();
+        size_t words = TagIsArrayTag(tag) ? ValueArrayWords : 1;
+        MOZ_ASSERT(base >= words);
+        base -= words;
+    }
+
+    size_t words = position() - base;
+    if (words == 0) {
+        return true;
+    }
+
+    if (!dst.ensureSpace(words)) {
+        return false;
+    }
+
+    mozilla::PodCopy(dst.topPtr(), &stack()[base], words);
+    dst.topIndex_ += words;
+    topIndex_ = base;
+    return true;
+}
+
 void
 MarkStack::setMaxCapacity(size_t maxCapacity)
 {
@@ -2476,7 +2722,8 @@ GCMarker::GCMarker(JSRuntime* rt)
   : JSTracer(rt, JSTracer::TracerKindTag::Marking, ExpandWeakMaps),
     stack(),
     color(MarkColor::Black),
-    unmarkedArenaStackTop(nullptr)
+    unmarkedArenaStackTop(nullptr),
+    isParallelMarker_(false)
 #ifdef DEBUG
   , markLaterArenas(0)
   , started(false)
@@ -2491,6 +2738,113 @@ GCMarker::init(JSGCMode gcMode)
     return stack.init(gcMode);
 }
 
+bool
+GCMarker::initForParallelMarking(size_t maxCap)
+{
+    MOZ_ASSERT(isMarkStackEmpty());
+
+    isParallelMarker_ = true;
+    linearWeakMarkingDisabled_ = true;
+#ifdef DEBUG
+    started = true;
+#endif
+
+    // Parallel markers start small and grow on demand as most of their work
+    // comes from other markers.
+    stack.setMaxCapacity(maxCap);
+    return stack.init(JSGC_MODE_INCREMENTAL);
+}
+
+static Cell*
+MarkStackEntryCell(const MarkStack::TaggedPtr& ptr)
+{
+    switch (ptr.tag()) {
+      case MarkStack::ValueArrayTag:
+        return ptr.asValueArrayObject();
+      case MarkStack::SavedValueArrayTag:
+        return ptr.asSavedValueArrayObject();
+      case MarkStack::ObjectTag:
+        return ptr.as<JSObject>();
+      case MarkStack::GroupTag:
+        return ptr.as<ObjectGroup>();
+      case MarkStack::JitCodeTag:
+        return ptr.as<jit::JitCode>();
+      case MarkStack::ScriptTag:
+        return ptr.as<JSScript>();
+      case MarkStack::TempRopeTag:
+        return ptr.asTempRope();
+      default:
+        MOZ_CRASH("Invalid tag in mark stack");
+    }
+}
+
+void
+GCMarker::takeMarkStackEntries(MarkStack& src)
+{
+    if (!src.transferEntriesTo(stack, src.position())) {
+        // Fall back to delayed marking for everything that didn't fit. The
+        // cells have already been marked so it is enough to rescan them.
+        for (MarkStackIter iter(src); !iter.done(); iter.next()) {
+            delayMarkingChildren(MarkStackEntryCell(iter.peekPtr()));
+        }
+        src.clear();
+    }
+}
+
+void
+GCMarker::takeParallelMarkerWork(GCMarker& other)
+{
+    MOZ_ASSERT(!isParallelMarker());
+    MOZ_ASSERT(other.isParallelMarker());
+    MOZ_ASSERT(markColor() == MarkColor::Black);
+
+    takeMarkStackEntries(other.stack);
+
+    for (JS::GCCellPtr thing : other.deferredCells_.ref()) {
+        traceDeferredChildren(thing);
+    }
+    other.deferredCells_.ref().clearAndFree();
+}
+
+void
+GCMarker::deferTracingChildren(JS::GCCellPtr thing)
+{
+    MOZ_ASSERT(isParallelMarker());
+    MOZ_ASSERT(thing.asCell()->asTenured().isMarkedBlack());
+
+    AutoEnterOOMUnsafeRegion oomUnsafe;
+    if (!deferredCells_.ref().append(thing)) {
+        oomUnsafe.crash("Failed to defer tracing of a cell's children during parallel marking");
+    }
+}
+
+void
+GCMarker::traceDeferredChildren(JS::GCCellPtr thing)
+{
+    MOZ_ASSERT(!isParallelMarker());
+    MOZ_ASSERT(thing.asCell()->asTenured().isMarkedBlack());
+
+    // Use the mark stack for kinds that can form deep graphs. Everything else
+    // is traced immediately.
+    switch (thing.kind()) {
+      case JS::TraceKind::Object:
+        pushTaggedPtr(&thing.as<JSObject>());
+        break;
+      case JS::TraceKind::ObjectGroup:
+        pushTaggedPtr(&thing.as<ObjectGroup>());
+        break;
+      case JS::TraceKind::Script:
+        pushTaggedPtr(&thing.as<JSScript>());
+        break;
+      case JS::TraceKind::JitCode:
+        pushTaggedPtr(&thing.as<jit::JitCode>());
+        break;
+      default:
+        js::TraceChildren(this, thing.asCell(), thing.kind());
+        break;
+    }
+}
+
 void
 GCMarker::start()
 {
@@ -2811,6 +3165,21 @@ TenuringTracer::traverse(JSString** strp)
     }
 }
 
+#ifdef ENABLE_BIGINT
+template <>
+void
+TenuringTracer::traverse(JS::BigInt** bip)
+{
+    // BigInts have no children, so we never visit their internals.
+    MOZ_ASSERT(!nursery().isInside(bip));
+
+    Cell** cellp = reinterpret_cast<Cell**>(bip);
+    if (IsInsideNursery(*cellp) && !nursery().getForwardedPointer(cellp)) {
+        *bip = moveToTenured(*bip);
+    }
+}
+#endif
+
 template <typename S>
 struct TenuringTraversalFunctor : public IdentityDefaultAdaptor<S> {
     template <typename T> S operator()(T* t, TenuringTracer* trc) {
@@ -2836,8 +3205,11 @@ js::gc::StoreBuffer::MonoTypeBuffer<T>::trace(StoreBuffer* owner, TenuringTracer
     if (last_) {
         last_.trace(mover);
     }
-    for (typename StoreSet::Range r = stores_.all(); !r.empty(); r.popFront()) {
-        r.front().trace(mover);
+
+    // Remove duplicates and trace in address order.
+    compact();
+    for (const T& edge : stores_) {
+        edge.trace(mover);
     }
 }
 
@@ -2980,7 +3352,8 @@ js::gc::StoreBuffer::CellPtrEdge::trace(TenuringTracer& mover) const
 
 #ifdef DEBUG
     auto traceKind = (*edge)->getTraceKind();
-    MOZ_ASSERT(traceKind == JS::TraceKind::Object || traceKind == JS::TraceKind::String);
+    MOZ_ASSERT(traceKind == JS::TraceKind::Object || traceKind == JS::TraceKind::String
+               IF_BIGINT(|| traceKind == JS::TraceKind::BigInt,));
 #endif
 
     // Bug 1376646: Make separate store buffers for strings and objects, and
@@ -2992,6 +3365,10 @@ js::gc::StoreBuffer::CellPtrEdge::trace(TenuringTracer& mover) const
 
     if ((*edge)->nurseryCellIsString()) {
         mover.traverse(reinterpret_cast<JSString**>(edge));
+#ifdef ENABLE_BIGINT
+    } else if ((*edge)->nurseryCellIsBigInt()) {
+        mover.traverse(reinterpret_cast<JS::BigInt**>(edge));
+#endif
     } else {
         mover.traverse(reinterpret_cast<JSObject**>(edge));
     }
@@ -3056,6 +3433,13 @@ js::TenuringTracer::traceObjectSlots(NativeObject* nobj, uint32_t start, uint32_
 void
 js::TenuringTracer::traceSlots(Value* vp, Value* end)
 {
+    if (MOZ_UNLIKELY(isParallel())) {
+        for (; vp != end; ++vp) {
+            traceSlotInParallel(vp);
+        }
+        return;
+    }
+
     for (; vp != end; ++vp) {
         traverse(vp);
     }
@@ -3092,9 +3476,53 @@ js::TenuringTracer::insertIntoObjectFixupList(RelocationOverlay* entry) {
 template <typename T>
 inline T*
 js::TenuringTracer::allocTenured(Zone* zone, AllocKind kind) {
+    if (MOZ_UNLIKELY(isParallel())) {
+        return static_cast<T*>(static_cast<Cell*>(parallelTask_->allocateCell(zone, kind)));
+    }
     return static_cast<T*>(static_cast<Cell*>(AllocateCellInGC(zone, kind)));
 }
 
+template <typename T>
+inline T*
+js::TenuringTracer::allocSlotsOrElements(Zone* zone, size_t count)
+{
+    T* buffer;
+    if (MOZ_UNLIKELY(isParallel())) {
+        // Zone malloc accounting may trigger a GC so it is deferred to the main
+        // thread.
+        buffer = js_pod_malloc<T>(count);
+        if (buffer) {
+            parallelTask_->noteMallocBytes(zone, count * sizeof(T));
+        }
+    } else {
+        buffer = zone->pod_malloc<T>(count);
+    }
+    return buffer;
+}
+
+inline void
+js::TenuringTracer::removeMallocedBuffer(void* buffer)
+{
+    if (MOZ_UNLIKELY(isParallel())) {
+        parallelTask_->tenurer().removeMallocedBuffer(buffer);
+        return;
+    }
+    nursery().removeMallocedBuffer(buffer);
+}
+
+inline void
+js::TenuringTracer::setElementsForwardingPointer(ObjectElements* oldHeader,
+                                                 ObjectElements* newHeader, uint32_t capacity)
+{
+    // Elements without space for a direct forwarding pointer are recorded in
+    // a table that is shared by all tracers.
+    if (MOZ_UNLIKELY(isParallel()) && capacity == 0) {
+        parallelTask_->tenurer().setElementsForwardingPointer(oldHeader, newHeader, capacity);
+        return;
+    }
+    nursery().setElementsForwardingPointer(oldHeader, newHeader, capacity);
+}
+
 JSObject*
 js::TenuringTracer::moveToTenuredSlow(JSObject* src)
 {
@@ -3215,7 +3643,7 @@ js::TenuringTracer::moveSlotsToTenured(NativeObject* dst, NativeObject* src)
     }
 
     if (!nursery().isInside(src->slots_)) {
-        nursery().removeMallocedBuffer(src->slots_);
+        removeMallocedBuffer(src->slots_);
         return 0;
     }
 
@@ -3224,7 +3652,7 @@ js::TenuringTracer::moveSlotsToTenured(NativeObject* dst, NativeObject* src)
 
     {
         AutoEnterOOMUnsafeRegion oomUnsafe;
-        dst->slots_ = zone->pod_malloc<HeapSlot>(count);
+        dst->slots_ = allocSlotsOrElements<HeapSlot>(zone, count);
         if (!dst->slots_) {
             oomUnsafe.crash(sizeof(HeapSlot) * count, "Failed to allocate slots while tenuring.");
         }
@@ -3247,7 +3675,7 @@ js::TenuringTracer::moveElementsToTenured(NativeObject* dst, NativeObject* src,
     /* TODO Bug 874151: Prefer to put element data inline if we have space. */
     if (!nursery().isInside(srcAllocatedHeader)) {
         MOZ_ASSERT(src->elements_ == dst->elements_);
-        nursery().removeMallocedBuffer(srcAllocatedHeader);
+        removeMallocedBuffer(srcAllocatedHeader);
         return 0;
     }
 
@@ -3262,8 +3690,7 @@ js::TenuringTracer::moveElementsToTenured(NativeObject* dst, NativeObject* src,
         dst->as<ArrayObject>().setFixedElements();
         js_memcpy(dst->getElementsHeader(), srcAllocatedHeader, nslots * sizeof(HeapSlot));
         dst->elements_ += numShifted;
-        nursery().setElementsForwardingPointer(srcHeader, dst->getElementsHeader(),
-                                               srcHeader->capacity);
+        setElementsForwardingPointer(srcHeader, dst->getElementsHeader(), srcHeader->capacity);
         return nslots * sizeof(HeapSlot);
     }
 
@@ -3273,7 +3700,8 @@ js::TenuringTracer::moveElementsToTenured(NativeObject* dst, NativeObject* src,
     ObjectElements* dstHeader;
     {
         AutoEnterOOMUnsafeRegion oomUnsafe;
-        dstHeader = reinterpret_cast<ObjectElements*>(zone->pod_malloc<HeapSlot>(nslots));
+        HeapSlot* slots = allocSlotsOrElements<HeapSlot>(zone, nslots);
+        dstHeader = reinterpret_cast<ObjectElements*>(slots);
         if (!dstHeader) {
             oomUnsafe.crash(sizeof(HeapSlot) * nslots,
                             "Failed to allocate elements while tenuring.");
@@ -3282,8 +3710,7 @@ js::TenuringTracer::moveElementsToTenured(NativeObject* dst, NativeObject* src,
 
     js_memcpy(dstHeader, srcAllocatedHeader, nslots * sizeof(HeapSlot));
     dst->elements_ = dstHeader->elements() + numShifted;
-    nursery().setElementsForwardingPointer(srcHeader, dst->getElementsHeader(),
-                                           srcHeader->capacity);
+    setElementsForwardingPointer(srcHeader, dst->getElementsHeader(), srcHeader->capacity);
     return nslots * sizeof(HeapSlot);
 }
 
@@ -3294,6 +3721,37 @@ js::TenuringTracer::insertIntoStringFixupList(RelocationOverlay* entry) {
     *stringTail = nullptr;
 }
 
+/* static */ HashNumber
+js::gc::DeduplicationStringHasher::hash(const Lookup& lookup)
+{
+    JSLinearString& str = lookup->asLinear();
+    JS::AutoCheckCannotGC nogc;
+    HashNumber hash = str.hasLatin1Chars()
+                      ? mozilla::HashString(str.latin1Chars(nogc), str.length())
+                      : mozilla::HashString(str.twoByteChars(nogc), str.length());
+    return mozilla::AddToHash(hash, lookup->zone());
+}
+
+/* static */ bool
+js::gc::DeduplicationStringHasher::match(JSString* existing, const Lookup& lookup)
+{
+    return existing->zone() == lookup->zone() &&
+           EqualStrings(&existing->asLinear(), &lookup->asLinear());
+}
+
+/*
+ * Surviving short strings with the same contents can share a single tenured
+ * cell, as strings have no identity. Only inline strings are deduplicated:
+ * their characters are stored in the cell, so no dependent string can point
+ * into them. Strings with a unique ID are left alone, as their address may be
+ * used as a hash key.
+ */
+static inline bool
+IsDeduplicatableString(JSString* str)
+{
+    return str->isInline() && !str->zone()->hasUniqueId(str);
+}
+
 JSString*
 js::TenuringTracer::moveToTenured(JSString* src)
 {
@@ -3304,10 +3762,28 @@ js::TenuringTracer::moveToTenured(JSString* src)
     Zone* zone = src->zone();
     zone->tenuredStrings++;
 
+    bool deduplicate = nursery().canDeduplicateStrings() && !isParallel() &&
+                       IsDeduplicatableString(src);
+    StringDeduplicationSet::AddPtr p;
+    if (deduplicate) {
+        p = stringDedupSet.lookupForAdd(src);
+        if (p) {
+            JSString* dst = *p;
+            RelocationOverlay::fromCell(src)->forwardTo(dst);
+            gcTracer.tracePromoteToTenured(src, dst);
+            return dst;
+        }
+    }
+
     JSString* dst = allocTenured<JSString>(zone, dstKind);
     tenuredSize += moveStringToTenured(dst, src, dstKind);
     tenuredCells++;
 
+    // Failing to add the string only loses sharing with later copies.
+    if (deduplicate) {
+        (void) stringDedupSet.add(p, dst);
+    }
+
     RelocationOverlay* overlay = RelocationOverlay::fromCell(src);
     overlay->forwardTo(dst);
     insertIntoStringFixupList(overlay);
@@ -3316,13 +3792,120 @@ js::TenuringTracer::moveToTenured(JSString* src)
     return dst;
 }
 
+#ifdef ENABLE_BIGINT
+JS::BigInt*
+js::TenuringTracer::moveToTenured(JS::BigInt* src)
+{
+    MOZ_ASSERT(IsInsideNursery(src));
+    MOZ_ASSERT(!src->zone()->usedByHelperThread());
+
+    AllocKind dstKind = src->getAllocKind();
+    Zone* zone = src->zone();
+    zone->tenuredBigInts++;
+
+    // Malloced digits are now owned by the tenured copy: the nursery sweep
+    // does not finalize BigInts that have been forwarded.
+    JS::BigInt* dst = allocTenured<JS::BigInt>(zone, dstKind);
+    js_memcpy(dst, src, sizeof(JS::BigInt));
+    dst->fixupAfterTenuring(src);
+    tenuredSize += sizeof(JS::BigInt);
+    tenuredCells++;
+
+    // BigInts have no children, so they need not go on a fixup list.
+    RelocationOverlay* overlay = RelocationOverlay::fromCell(src);
+    overlay->forwardTo(dst);
+
+    gcTracer.tracePromoteToTenured(src, dst);
+    return dst;
+}
+#endif
+
+// Read the first word of a nursery cell which another tracer may be in the
+// process of forwarding.
+static MOZ_ALWAYS_INLINE uintptr_t
+AtomicLoadCellHeader(const Cell* cell)
+{
+    const uintptr_t* word = reinterpret_cast<const uintptr_t*>(cell);
+#if defined(_MSC_VER)
+    return *reinterpret_cast<const volatile uintptr_t*>(word);
+#else
+    return __atomic_load_n(word, __ATOMIC_ACQUIRE);
+#endif
+}
+
+JSObject*
+js::TenuringTracer::moveToTenuredInParallel(JSObject* src)
+{
+    MOZ_ASSERT(isParallel());
+    MOZ_ASSERT(IsInsideNursery(src));
+
+    // The header is only rewritten when the cell is forwarded, so until then
+    // it still points to the object's group.
+    uintptr_t header = AtomicLoadCellHeader(src);
+    if (!(header & Cell::FORWARD_BIT)) {
+        const Class* clasp = reinterpret_cast<ObjectGroup*>(header)->clasp();
+        if (!ParallelTenurer::canMoveInParallel(clasp)) {
+            return nullptr;
+        }
+
+        if (parallelTask_->tenurer().claim(src)) {
+            if (clasp == &PlainObject::class_) {
+                return movePlainObjectToTenured(&src->as<PlainObject>());
+            }
+            return moveToTenuredSlow(src);
+        }
+
+        // Another tracer is moving the object. Wait for it to finish.
+        do {
+            header = AtomicLoadCellHeader(src);
+        } while (!(header & Cell::FORWARD_BIT));
+    }
+
+    return static_cast<JSObject*>(RelocationOverlay::fromCell(src)->forwardingAddress());
+}
+
+void
+js::TenuringTracer::traceSlotInParallel(Value* vp)
+{
+    if (!vp->isGCThing() || !IsInsideNursery(vp->toGCThing())) {
+        return;
+    }
+
+    if (vp->isObject()) {
+        if (JSObject* dst = moveToTenuredInParallel(&vp->toObject())) {
+            vp->setObject(*dst);
+            return;
+        }
+    }
+
+    parallelTask_->deferEdge(vp);
+}
+
+void
+js::TenuringTracer::traceDeferredEdge(Value* vp)
+{
+    MOZ_ASSERT(!isParallel());
+    traverse(vp);
+}
+
 void
 js::Nursery::collectToFixedPoint(TenuringTracer& mover, TenureCountCache& tenureCounts)
 {
+    if (ParallelTenurer::canTenureInParallel(this, mover)) {
+        ParallelTenurer pt(runtime(), this);
+        pt.tenure(mover, tenureCounts);
+    }
+
     for (RelocationOverlay* p = mover.objHead; p; p = p->next()) {
         JSObject* obj = static_cast<JSObject*>(p->forwardingAddress());
         mover.traceObject(obj);
 
+        // The old nursery header still holds the object's allocation site.
+        if (AllocSite* site = getObjectAllocSite(p)) {
+            site->noteTenured();
+            continue;
+        }
+
         TenureCount& entry = tenureCounts.findEntry(obj->groupRaw());
         if (entry.group == obj->groupRaw()) {
             entry.count++;
@@ -3409,7 +3992,11 @@ template <typename T>
 struct MightBeNurseryAllocated
 {
     static const bool value = mozilla::IsBaseOf<JSObject, T>::value ||
-                              mozilla::IsBaseOf<JSString, T>::value;
+                              mozilla::IsBaseOf<JSString, T>::value
+#ifdef ENABLE_BIGINT
+                              || mozilla::IsBaseOf<JS::BigInt, T>::value
+#endif
+                              ;
 };
 
 template <typename T>
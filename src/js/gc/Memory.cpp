@@ -30,6 +30,9 @@
 # include <sys/mman.h>
 # include <sys/resource.h>
 # include <sys/stat.h>
+# if defined(__linux__)
+#  include <sys/syscall.h>
+# endif
 # include <sys/types.h>
 # include <unistd.h>
 
@@ -68,6 +71,12 @@ SystemPageSize()
     return pageSize;
 }
 
+size_t
+SystemAllocGranularity()
+{
+    return allocGranularity;
+}
+
 static bool
 DecommitEnabled()
 {
@@ -296,6 +305,18 @@ MarkPagesInUse(void* p, size_t size)
     MOZ_ASSERT(OffsetFromAligned(p, pageSize) == 0);
 }
 
+bool
+MarkPagesHuge(void* p, size_t size)
+{
+    return false;
+}
+
+bool
+BindPagesToNumaNode(void* p, size_t size, uint32_t node)
+{
+    return false;
+}
+
 size_t
 GetPageFaultCount()
 {
@@ -375,6 +396,13 @@ DeallocateMappedContent(void* p, size_t /*length*/)
     MOZ_ALWAYS_TRUE(UnmapViewOfFile(reinterpret_cast<void*>(map)));
 }
 
+bool
+AdviseMappedContent(void* p, size_t length, JS::MappedArrayBufferAdvice advice)
+{
+    // Windows only has PrefetchVirtualMemory, which needs Windows 8.
+    return false;
+}
+
 #  else // Various APIs are unavailable.
 
 void*
@@ -423,6 +451,18 @@ MarkPagesInUse(void* p, size_t size)
     MOZ_ASSERT(OffsetFromAligned(p, pageSize) == 0);
 }
 
+bool
+MarkPagesHuge(void* p, size_t size)
+{
+    return false;
+}
+
+bool
+BindPagesToNumaNode(void* p, size_t size, uint32_t node)
+{
+    return false;
+}
+
 size_t
 GetPageFaultCount()
 {
@@ -444,6 +484,13 @@ DeallocateMappedContent(void* p, size_t length)
     // Not implemented.
 }
 
+bool
+AdviseMappedContent(void* p, size_t length, JS::MappedArrayBufferAdvice advice)
+{
+    // Not implemented.
+    return false;
+}
+
 #  endif
 
 #elif defined(SOLARIS)
@@ -515,6 +562,18 @@ MarkPagesInUse(void* p, size_t size)
     MOZ_ASSERT(OffsetFromAligned(p, pageSize) == 0);
 }
 
+bool
+MarkPagesHuge(void* p, size_t size)
+{
+    return false;
+}
+
+bool
+BindPagesToNumaNode(void* p, size_t size, uint32_t node)
+{
+    return false;
+}
+
 size_t
 GetPageFaultCount()
 {
@@ -535,6 +594,13 @@ DeallocateMappedContent(void* p, size_t length)
     // Not implemented.
 }
 
+bool
+AdviseMappedContent(void* p, size_t length, JS::MappedArrayBufferAdvice advice)
+{
+    // Not implemented.
+    return false;
+}
+
 #elif defined(XP_UNIX)
 
 void
@@ -860,6 +926,39 @@ MarkPagesInUse(void* p, size_t size)
     MOZ_ASSERT(OffsetFromAligned(p, pageSize) == 0);
 }
 
+bool
+MarkPagesHuge(void* p, size_t size)
+{
+#if defined(MADV_HUGEPAGE)
+    MOZ_ASSERT(OffsetFromAligned(p, pageSize) == 0);
+    return madvise(p, size, MADV_HUGEPAGE) == 0;
+#else
+    return false;
+#endif
+}
+
+bool
+BindPagesToNumaNode(void* p, size_t size, uint32_t node)
+{
+#if defined(__linux__) && defined(SYS_mbind)
+    MOZ_ASSERT(OffsetFromAligned(p, pageSize) == 0);
+
+    // Call mbind directly rather than depend on libnuma. MPOL_PREFERRED
+    // falls back to other nodes when this one is out of memory.
+    static const int MPOL_PREFERRED = 1;
+    static const size_t MaxNodes = 256;
+    static const size_t BitsPerWord = sizeof(unsigned long) * 8;
+    if (node >= MaxNodes) {
+        return false;
+    }
+    unsigned long nodeMask[MaxNodes / BitsPerWord] = {};
+    nodeMask[node / BitsPerWord] = 1ul << (node % BitsPerWord);
+    return syscall(SYS_mbind, p, size, MPOL_PREFERRED, nodeMask, MaxNodes + 1, 0) == 0;
+#else
+    return false;
+#endif
+}
+
 size_t
 GetPageFaultCount()
 {
@@ -930,6 +1029,35 @@ DeallocateMappedContent(void* p, size_t length)
     UnmapPages(reinterpret_cast<void*>(map), alignedLength);
 }
 
+bool
+AdviseMappedContent(void* p, size_t length, JS::MappedArrayBufferAdvice advice)
+{
+    int flag;
+    switch (advice) {
+      case JS::MappedArrayBufferAdvice::Normal:
+        flag = MADV_NORMAL;
+        break;
+      case JS::MappedArrayBufferAdvice::Sequential:
+        flag = MADV_SEQUENTIAL;
+        break;
+      case JS::MappedArrayBufferAdvice::Random:
+        flag = MADV_RANDOM;
+        break;
+      case JS::MappedArrayBufferAdvice::WillNeed:
+        flag = MADV_WILLNEED;
+        break;
+      default:
+        MOZ_CRASH("Unexpected advice");
+    }
+
+    // madvise needs a page aligned address, so advise from the start of the
+    // page. That page is part of the same mapping, as mappings are page
+    // aligned, and advice never changes the contents.
+    uintptr_t start = uintptr_t(p) - (uintptr_t(p) % pageSize);
+    size_t alignedLength = length + (uintptr_t(p) % pageSize);
+    return madvise(reinterpret_cast<void*>(start), alignedLength, flag) == 0;
+}
+
 #else
 #error "Memory mapping functions are not defined for your OS."
 #endif
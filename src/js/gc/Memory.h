@@ -8,6 +8,11 @@
 #define gc_Memory_h
 
 #include <stddef.h>
+#include <stdint.h>
+
+namespace JS {
+enum class MappedArrayBufferAdvice : uint8_t;
+} // namespace JS
 
 namespace js {
 namespace gc {
@@ -18,6 +23,10 @@ void InitMemorySubsystem();
 
 size_t SystemPageSize();
 
+// The granularity of MapAlignedPages, which is larger than the page size on
+// Windows.
+size_t SystemAllocGranularity();
+
 // Allocate or deallocate pages from the system with the given alignment.
 void* MapAlignedPages(size_t size, size_t alignment);
 void UnmapPages(void* p, size_t size);
@@ -31,6 +40,17 @@ bool MarkPagesUnused(void* p, size_t size);
 // platforms.
 void MarkPagesInUse(void* p, size_t size);
 
+// Ask the OS to back the given pages with huge pages where it can. Returns
+// whether the request was accepted. This is only supported on Linux with
+// transparent huge pages, and returns false elsewhere.
+bool MarkPagesHuge(void* p, size_t size);
+
+// Ask the OS to place the given pages on the given NUMA node when they are
+// first touched, rather than on the node of the thread that touches them.
+// Returns whether the request was accepted. This is only supported on Linux,
+// and returns false elsewhere.
+bool BindPagesToNumaNode(void* p, size_t size, uint32_t node);
+
 // Returns #(hard faults) + #(soft faults)
 size_t GetPageFaultCount();
 
@@ -41,6 +61,10 @@ void* AllocateMappedContent(int fd, size_t offset, size_t length, size_t alignme
 // Deallocate memory mapped content.
 void DeallocateMappedContent(void* p, size_t length);
 
+// Pass paging advice for part of some memory mapped content to the OS. Returns
+// false if the advice isn't supported on this platform.
+bool AdviseMappedContent(void* p, size_t length, JS::MappedArrayBufferAdvice advice);
+
 void* TestMapAlignedPagesLastDitch(size_t size, size_t alignment);
 
 void ProtectPages(void* p, size_t size);
@@ -17,10 +17,14 @@
 #include "gc/FreeOp.h"
 #include "gc/GCInternals.h"
 #include "gc/Memory.h"
+#include "gc/Pretenuring.h"
 #include "gc/PublicIterators.h"
 #include "jit/JitFrames.h"
 #include "jit/JitRealm.h"
 #include "vm/ArrayObject.h"
+#ifdef ENABLE_BIGINT
+#include "vm/BigIntType.h"
+#endif
 #include "vm/Debugger.h"
 #if defined(DEBUG)
 #include "vm/EnvironmentObject.h"
@@ -135,8 +139,15 @@ js::Nursery::Nursery(JSRuntime* rt)
   , profileThreshold_(0)
   , enableProfiling_(false)
   , canAllocateStrings_(false)
+  , canAllocateBigInts_(true)
+  , canDeduplicateStrings_(true)
+  , allocatedSites_(nullptr)
+  , currentAllocSite_(nullptr)
   , reportTenurings_(0)
   , minorGCTriggerReason_(JS::gcreason::NO_REASON)
+  , smoothedPromotionRate_(0.0)
+  , smoothedTenureRate_(0.0)
+  , hasPromotionRateSample_(false)
   , freeMallocedBuffersTask(nullptr)
 #ifdef JS_GC_ZEAL
   , lastCanary_(nullptr)
@@ -146,6 +157,14 @@ js::Nursery::Nursery(JSRuntime* rt)
     if (env && *env) {
         canAllocateStrings_ = (*env == '1');
     }
+    env = getenv("MOZ_NURSERY_BIGINTS");
+    if (env && *env) {
+        canAllocateBigInts_ = (*env == '1');
+    }
+    env = getenv("MOZ_NURSERY_DEDUP_STRINGS");
+    if (env && *env) {
+        canDeduplicateStrings_ = (*env == '1');
+    }
 }
 
 bool
@@ -311,7 +330,8 @@ js::Nursery::leaveZealMode() {
 #endif // JS_GC_ZEAL
 
 JSObject*
-js::Nursery::allocateObject(JSContext* cx, size_t size, size_t nDynamicSlots, const js::Class* clasp)
+js::Nursery::allocateObject(JSContext* cx, size_t size, size_t nDynamicSlots, const js::Class* clasp,
+                            AllocSite* site)
 {
     /* Ensure there's enough space to replace the contents with a RelocationOverlay. */
     MOZ_ASSERT(size >= sizeof(RelocationOverlay));
@@ -320,11 +340,13 @@ js::Nursery::allocateObject(JSContext* cx, size_t size, size_t nDynamicSlots, co
     MOZ_ASSERT_IF(clasp->hasFinalize(), CanNurseryAllocateFinalizedClass(clasp) ||
                                         clasp->isProxy());
 
-    /* Make the object allocation. */
-    JSObject* obj = static_cast<JSObject*>(allocate(size));
-    if (!obj) {
+    /* Make the object allocation, with space before it for its site. */
+    auto header = static_cast<ObjectLayout*>(allocate(objectHeaderSize() + size));
+    if (!header) {
         return nullptr;
     }
+    header->site = nullptr;
+    JSObject* obj = reinterpret_cast<JSObject*>(&header->cell);
 
     /* If we want external slots, add them. */
     HeapSlot* slots = nullptr;
@@ -347,6 +369,11 @@ js::Nursery::allocateObject(JSContext* cx, size_t size, size_t nDynamicSlots, co
         static_cast<NativeObject*>(obj)->initSlots(slots);
     }
 
+    if (site) {
+        header->site = site;
+        site->noteNurseryAlloc(*this);
+    }
+
     gcTracer.traceNurseryAlloc(obj, size);
     return obj;
 }
@@ -369,6 +396,24 @@ js::Nursery::allocateString(Zone* zone, size_t size, AllocKind kind)
     return cell;
 }
 
+#ifdef ENABLE_BIGINT
+Cell*
+js::Nursery::allocateBigInt(Zone* zone, size_t size, AllocKind kind)
+{
+    // BigInts share the string layout, with the zone stored in the header.
+    Cell* cell = allocateString(zone, size, kind);
+    if (!cell) {
+        return nullptr;
+    }
+
+    if (!bigInts_.append(static_cast<JS::BigInt*>(cell))) {
+        return nullptr;
+    }
+
+    return cell;
+}
+#endif
+
 void*
 js::Nursery::allocate(size_t size)
 {
@@ -395,14 +440,14 @@ js::Nursery::allocate(size_t size)
             return nullptr;
         }
         if (MOZ_UNLIKELY(chunkno == allocatedChunkCount())) {
-            mozilla::TimeStamp start = ReallyNow();
+            mozilla::TimeStamp start = InstrumentationClock::now();
             {
                 AutoLockGCBgAlloc lock(runtime());
                 if (!allocateNextChunk(chunkno, lock)) {
                     return nullptr;
                 }
             }
-            timeInChunkAlloc_ += ReallyNow() - start;
+            timeInChunkAlloc_ += InstrumentationClock::now() - start;
             MOZ_ASSERT(chunkno < allocatedChunkCount());
         }
         setCurrentChunk(chunkno);
@@ -569,9 +614,11 @@ js::Nursery::forwardBufferPointer(HeapSlot** pSlotsElems)
     MOZ_ASSERT(IsWriteableAddress(*pSlotsElems));
 }
 
-js::TenuringTracer::TenuringTracer(JSRuntime* rt, Nursery* nursery)
+js::TenuringTracer::TenuringTracer(JSRuntime* rt, Nursery* nursery,
+                                   ParallelTenuringTask* parallelTask)
   : JSTracer(rt, JSTracer::TracerKindTag::Tenuring, TraceWeakMapKeysValues)
   , nursery_(*nursery)
+  , parallelTask_(parallelTask)
   , tenuredSize(0)
   , tenuredCells(0)
   , objHead(nullptr)
@@ -717,13 +764,13 @@ js::Nursery::maybeClearProfileDurations()
 inline void
 js::Nursery::startProfile(ProfileKey key)
 {
-    startTimes_[key] = ReallyNow();
+    startTimes_[key] = InstrumentationClock::now();
 }
 
 inline void
 js::Nursery::endProfile(ProfileKey key)
 {
-    profileDurations_[key] = ReallyNow() - startTimes_[key];
+    profileDurations_[key] = InstrumentationClock::now() - startTimes_[key];
     totalDurations_[key] += profileDurations_[key];
 }
 
@@ -789,12 +836,14 @@ js::Nursery::collect(JS::gcreason::Reason reason)
     previousGC.reason = JS::gcreason::NO_REASON;
     if (!isEmpty()) {
         doCollection(reason, tenureCounts);
+        updateCollectionRates();
     } else {
         previousGC.nurseryUsedBytes = 0;
         previousGC.nurseryCapacity = spaceToEnd(maxChunkCount());
         previousGC.nurseryLazyCapacity = spaceToEnd(allocatedChunkCount());
         previousGC.tenuredBytes = 0;
         previousGC.tenuredCells = 0;
+        previousGC.duration = mozilla::TimeDuration();
     }
 
     // Resize the nursery.
@@ -826,17 +875,27 @@ js::Nursery::collect(JS::gcreason::Reason reason)
         }
     }
 
+    processAllocSites();
+
     mozilla::Maybe<AutoGCSession> session;
     for (ZonesIter zone(rt, SkipAtoms); !zone.done(); zone.next()) {
-        if (shouldPretenure && zone->allocNurseryStrings && zone->tenuredStrings >= 30 * 1000) {
+        bool pretenureStrings =
+            shouldPretenure && zone->allocNurseryStrings && zone->tenuredStrings >= 30 * 1000;
+        if (pretenureStrings || zone->allocSiteStateChanged) {
             if (!session.isSome()) {
                 session.emplace(rt, JS::HeapState::MinorCollecting);
             }
             CancelOffThreadIonCompile(zone);
             bool preserving = zone->isPreservingCode();
             zone->setPreservingCode(false);
-            zone->discardJitCode(rt->defaultFreeOp());
+
+            // Sites that became long-lived only need Ion code to be
+            // recompiled: baseline stubs check the site's state.
+            zone->discardJitCode(rt->defaultFreeOp(), /* discardBaselineCode = */ pretenureStrings);
             zone->setPreservingCode(preserving);
+            zone->allocSiteStateChanged = false;
+        }
+        if (pretenureStrings) {
             for (RealmsInZoneIter r(zone); !r.done(); r.next()) {
                 if (jit::JitRealm* jitRealm = r->jitRealm()) {
                     jitRealm->discardStubs();
@@ -846,6 +905,13 @@ js::Nursery::collect(JS::gcreason::Reason reason)
             zone->allocNurseryStrings = false;
         }
         zone->tenuredStrings = 0;
+
+        // The JITs never allocate BigInts, so unlike strings no code needs
+        // to be discarded when they start being allocated in the tenured heap.
+        if (shouldPretenure && zone->allocNurseryBigInts && zone->tenuredBigInts >= 30 * 1000) {
+            zone->allocNurseryBigInts = false;
+        }
+        zone->tenuredBigInts = 0;
     }
     session.reset(); // End the minor GC session, if running one.
     endProfile(ProfileKey::Pretenure);
@@ -875,6 +941,7 @@ js::Nursery::collect(JS::gcreason::Reason reason)
     rt->addTelemetry(JS_TELEMETRY_GC_NURSERY_BYTES, sizeOfHeapCommitted());
     rt->addTelemetry(JS_TELEMETRY_GC_PRETENURE_COUNT, pretenureCount);
 
+    rt->gc.stats().recordNurseryCollection(totalTime, previousGC.tenuredBytes);
     rt->gc.stats().endNurseryCollection(reason);
     gcTracer.traceMinorGCEnd();
     timeInChunkAlloc_ = mozilla::TimeDuration();
@@ -1015,6 +1082,7 @@ js::Nursery::doCollection(JS::gcreason::Reason reason, TenureCountCache& tenureC
     previousGC.nurseryUsedBytes = initialNurseryUsedBytes;
     previousGC.tenuredBytes = mover.tenuredSize;
     previousGC.tenuredCells = mover.tenuredCells;
+    previousGC.duration = InstrumentationClock::now() - startTimes_[ProfileKey::Total];
 }
 
 void
@@ -1100,6 +1168,9 @@ js::Nursery::sweep(JSTracer* trc)
 
     sweepDictionaryModeObjects();
     sweepMapAndSetObjects();
+#ifdef ENABLE_BIGINT
+    sweepBigInts();
+#endif
 }
 
 void
@@ -1244,6 +1315,12 @@ js::Nursery::maybeResizeNursery(JS::gcreason::Reason reason)
         }
     }
 
+    const TimeDuration pauseTarget = runtime()->gc.tunables.nurseryPauseTarget();
+    if (!pauseTarget.IsZero()) {
+        resizeForPauseTarget(pauseTarget);
+        return;
+    }
+
     /*
      * This incorrect promotion rate results in better nursery sizing
      * decisions, however we should to better tuning based on the real
@@ -1261,6 +1338,86 @@ js::Nursery::maybeResizeNursery(JS::gcreason::Reason reason)
     }
 }
 
+void
+js::Nursery::processAllocSites()
+{
+    AllocSite* site = allocatedSites_;
+    while (site) {
+        AllocSite* next = site->nextNurseryAllocated();
+        if (site->processMinorGC()) {
+            site->zone()->allocSiteStateChanged = true;
+        }
+        site = next;
+    }
+    allocatedSites_ = nullptr;
+}
+
+void
+js::Nursery::updateCollectionRates()
+{
+    // The weight given to the most recent collection. Averaging over several
+    // collections stops the nursery size from following every change in the
+    // mutator's behaviour.
+    static const double SampleWeight = 0.25;
+
+    if (previousGC.nurseryUsedBytes == 0) {
+        return;
+    }
+
+    double promotionRate = double(previousGC.tenuredBytes) / double(previousGC.nurseryUsedBytes);
+    if (hasPromotionRateSample_) {
+        smoothedPromotionRate_ += (promotionRate - smoothedPromotionRate_) * SampleWeight;
+    } else {
+        smoothedPromotionRate_ = promotionRate;
+        hasPromotionRateSample_ = true;
+    }
+
+    // Collections that tenure nothing say nothing about how fast we tenure,
+    // and very short ones are dominated by timer resolution.
+    double micros = previousGC.duration.ToMicroseconds();
+    if (previousGC.tenuredBytes == 0 || micros < 1.0) {
+        return;
+    }
+
+    double tenureRate = double(previousGC.tenuredBytes) / micros;
+    if (smoothedTenureRate_ != 0.0) {
+        smoothedTenureRate_ += (tenureRate - smoothedTenureRate_) * SampleWeight;
+    } else {
+        smoothedTenureRate_ = tenureRate;
+    }
+}
+
+void
+js::Nursery::resizeForPauseTarget(TimeDuration target)
+{
+    // Keep the current size until we know how fast we can tenure.
+    if (smoothedTenureRate_ == 0.0) {
+        return;
+    }
+
+    // Collecting a nursery of capacity C is expected to tenure C times the
+    // promotion rate bytes, which takes that divided by the tenure rate. The
+    // tenure rate is measured over the whole collection so fixed costs such
+    // as tracing roots are included. Pick the capacity that meets the target.
+    double maxCapacity = double(chunkCountLimit()) * NurseryChunkUsableSize;
+    double capacity = maxCapacity;
+    if (smoothedPromotionRate_ > 0.0) {
+        capacity = target.ToMicroseconds() * smoothedTenureRate_ / smoothedPromotionRate_;
+        capacity = Min(capacity, maxCapacity);
+    }
+    unsigned targetCount = Max(unsigned(capacity / NurseryChunkUsableSize), 1u);
+
+    // Move at most a factor of two towards the target each collection, and
+    // only shrink if the target is well below the current size. Otherwise
+    // noise in the measurements makes the size oscillate.
+    unsigned count = maxChunkCount();
+    if (targetCount > count) {
+        maxChunkCount_ = Min(targetCount, count * 2);
+    } else if (targetCount < count - count / 4) {
+        shrinkAllocableSpace(Max(targetCount, count / 2));
+    }
+}
+
 void
 js::Nursery::growAllocableSpace()
 {
@@ -1355,6 +1512,21 @@ js::Nursery::sweepMapAndSetObjects()
     setsWithNurseryMemory_.clearAndFree();
 }
 
+#ifdef ENABLE_BIGINT
+void
+js::Nursery::sweepBigInts()
+{
+    auto fop = runtime_->defaultFreeOp();
+
+    for (JS::BigInt* bi : bigInts_) {
+        if (!IsForwarded(bi)) {
+            bi->finalize(fop);
+        }
+    }
+    bigInts_.clear();
+}
+#endif
+
 JS_PUBLIC_API(void)
 JS::EnableNurseryStrings(JSContext* cx)
 {
@@ -55,14 +55,26 @@ class MapObject;
 class SetObject;
 
 namespace gc {
+class AllocSite;
 class AutoMaybeStartBackgroundAllocation;
 class AutoTraceSession;
 struct Cell;
 class MinorCollectionTracer;
+class ParallelTenurer;
+class ParallelTenuringTask;
 class RelocationOverlay;
 struct TenureCountCache;
 enum class AllocKind : uint8_t;
 class TenuredCell;
+
+// Hashes strings by zone and contents, for deduplicating the strings tenured
+// by a minor collection.
+struct DeduplicationStringHasher
+{
+    typedef JSString* Lookup;
+    static HashNumber hash(const Lookup& lookup);
+    static bool match(JSString* existing, const Lookup& lookup);
+};
 } /* namespace gc */
 
 namespace jit {
@@ -72,8 +84,15 @@ class MacroAssembler;
 class TenuringTracer : public JSTracer
 {
     friend class Nursery;
+    friend class gc::ParallelTenurer;
+    friend class gc::ParallelTenuringTask;
     Nursery& nursery_;
 
+    // The parallel tenuring task this tracer belongs to, if any. Such tracers
+    // only move objects that can be tenured off the main thread and leave
+    // other edges for the main thread. See gc/ParallelTenuring.h.
+    gc::ParallelTenuringTask* const parallelTask_;
+
     // Amount of data moved to the tenured generation during collection.
     size_t tenuredSize;
     // Number of cells moved to the tenured generation.
@@ -87,10 +106,18 @@ class TenuringTracer : public JSTracer
     gc::RelocationOverlay* stringHead;
     gc::RelocationOverlay** stringTail;
 
-    TenuringTracer(JSRuntime* rt, Nursery* nursery);
+    // Short strings tenured by this collection, which later nursery strings
+    // with the same contents are forwarded to instead of being copied.
+    typedef HashSet<JSString*, gc::DeduplicationStringHasher, SystemAllocPolicy>
+        StringDeduplicationSet;
+    StringDeduplicationSet stringDedupSet;
+
+    TenuringTracer(JSRuntime* rt, Nursery* nursery,
+                   gc::ParallelTenuringTask* parallelTask = nullptr);
 
   public:
     Nursery& nursery() { return nursery_; }
+    bool isParallel() const { return parallelTask_; }
 
     template <typename T> void traverse(T** thingp);
     template <typename T> void traverse(T* thingp);
@@ -101,6 +128,9 @@ class TenuringTracer : public JSTracer
     void traceSlots(JS::Value* vp, uint32_t nslots);
     void traceString(JSString* src);
 
+    // Trace an edge recorded by a parallel tracer.
+    void traceDeferredEdge(JS::Value* vp);
+
   private:
     inline void insertIntoObjectFixupList(gc::RelocationOverlay* entry);
     inline void insertIntoStringFixupList(gc::RelocationOverlay* entry);
@@ -111,11 +141,25 @@ class TenuringTracer : public JSTracer
     inline JSObject* movePlainObjectToTenured(PlainObject* src);
     JSObject* moveToTenuredSlow(JSObject* src);
     JSString* moveToTenured(JSString* src);
+#ifdef ENABLE_BIGINT
+    JS::BigInt* moveToTenured(JS::BigInt* src);
+#endif
 
     size_t moveElementsToTenured(NativeObject* dst, NativeObject* src, gc::AllocKind dstKind);
     size_t moveSlotsToTenured(NativeObject* dst, NativeObject* src);
     size_t moveStringToTenured(JSString* dst, JSString* src, gc::AllocKind dstKind);
 
+    template <typename T>
+    inline T* allocSlotsOrElements(JS::Zone* zone, size_t count);
+    inline void removeMallocedBuffer(void* buffer);
+    inline void setElementsForwardingPointer(ObjectElements* oldHeader,
+                                             ObjectElements* newHeader, uint32_t capacity);
+
+    // Move |src| if no other parallel tracer has, returning its new location,
+    // or return nullptr if it can't be moved off the main thread.
+    JSObject* moveToTenuredInParallel(JSObject* src);
+    void traceSlotInParallel(JS::Value* vp);
+
     void traceSlots(JS::Value* vp, JS::Value* end);
 };
 
@@ -143,11 +187,17 @@ class Nursery
         char byte;
     };
 
+    // Strings and BigInts store their zone in a header before the cell.
     struct StringLayout {
         JS::Zone* zone;
         CellAlignedByte cell;
     };
 
+    struct ObjectLayout {
+        gc::AllocSite* site;
+        CellAlignedByte cell;
+    };
+
     explicit Nursery(JSRuntime* rt);
     ~Nursery();
 
@@ -174,6 +224,10 @@ class Nursery
     void disableStrings();
     bool canAllocateStrings() const { return canAllocateStrings_; }
 
+    bool canAllocateBigInts() const { return canAllocateBigInts_; }
+
+    bool canDeduplicateStrings() const { return canDeduplicateStrings_; }
+
     /* Return true if no allocations have been made since the last collection. */
     bool isEmpty() const;
 
@@ -196,9 +250,11 @@ class Nursery
 
     /*
      * Allocate and return a pointer to a new GC object with its |slots|
-     * pointer pre-filled. Returns nullptr if the Nursery is full.
+     * pointer pre-filled, attributed to |site| if that is not null. Returns
+     * nullptr if the Nursery is full.
      */
-    JSObject* allocateObject(JSContext* cx, size_t size, size_t numDynamic, const js::Class* clasp);
+    JSObject* allocateObject(JSContext* cx, size_t size, size_t numDynamic, const js::Class* clasp,
+                             gc::AllocSite* site);
 
     /*
      * Allocate and return a pointer to a new string. Returns nullptr if the
@@ -223,6 +279,45 @@ class Nursery
         return offsetof(StringLayout, cell);
     }
 
+#ifdef ENABLE_BIGINT
+    /*
+     * Allocate and return a pointer to a new BigInt. The BigInt is finalized
+     * after the next minor GC unless it is tenured. Returns nullptr if the
+     * Nursery is full.
+     */
+    gc::Cell* allocateBigInt(JS::Zone* zone, size_t size, gc::AllocKind kind);
+
+    /*
+     * BigInt zones are stored just before the BigInt in nursery memory.
+     */
+    static JS::Zone* getBigIntZone(const JS::BigInt* bi) {
+#ifdef DEBUG
+        auto cell = reinterpret_cast<const js::gc::Cell*>(bi); // JS::BigInt type is incomplete here
+        MOZ_ASSERT(js::gc::IsInsideNursery(cell), "getBigIntZone must be passed a nursery BigInt");
+#endif
+
+        auto layout = reinterpret_cast<const uint8_t*>(bi) - offsetof(StringLayout, cell);
+        return reinterpret_cast<const StringLayout*>(layout)->zone;
+    }
+#endif
+
+    /*
+     * Object allocation sites are stored just before the object in nursery
+     * memory. See gc/Pretenuring.h.
+     */
+    static gc::AllocSite* getObjectAllocSite(const void* obj) {
+        auto layout = reinterpret_cast<const uint8_t*>(obj) - offsetof(ObjectLayout, cell);
+        return reinterpret_cast<const ObjectLayout*>(layout)->site;
+    }
+
+    static size_t objectHeaderSize() {
+        return offsetof(ObjectLayout, cell);
+    }
+
+    /* The site that object allocations are currently attributed to. */
+    gc::AllocSite* currentAllocSite() const { return currentAllocSite_; }
+    void setCurrentAllocSite(gc::AllocSite* site) { currentAllocSite_ = site; }
+
     /* Allocate a buffer for a given zone, using the nursery if possible. */
     void* allocateBuffer(JS::Zone* zone, size_t nbytes);
 
@@ -331,6 +426,7 @@ class Nursery
     const void* addressOfCurrentStringEnd() const {
         return (void*)&currentStringEnd_;
     }
+    void* addressOfAllocatedSites() { return &allocatedSites_; }
 
     void requestMinorGC(JS::gcreason::Reason reason) const;
 
@@ -403,6 +499,21 @@ class Nursery
     /* Whether we will nursery-allocate strings. */
     bool canAllocateStrings_;
 
+    /* Whether we will nursery-allocate BigInts. */
+    bool canAllocateBigInts_;
+
+    /*
+     * Whether tenuring shares one tenured copy between the short strings
+     * with identical contents which survive a minor collection.
+     */
+    bool canDeduplicateStrings_;
+
+    /* Sites that have allocated in the nursery since the last collection. */
+    gc::AllocSite* allocatedSites_;
+
+    /* The site that object allocations are currently attributed to. */
+    gc::AllocSite* currentAllocSite_;
+
     /* Report ObjectGroups with at least this many instances tenured. */
     int64_t reportTenurings_;
 
@@ -440,8 +551,19 @@ class Nursery
         size_t nurseryUsedBytes = 0;
         size_t tenuredBytes = 0;
         size_t tenuredCells = 0;
+        mozilla::TimeDuration duration;
     } previousGC;
 
+    /*
+     * Moving averages over recent collections of the promotion rate and of
+     * the number of bytes tenured per microsecond of collection time. These
+     * are used to size the nursery for JSGC_NURSERY_PAUSE_TARGET. The tenure
+     * rate is zero until a collection that tenured anything has been seen.
+     */
+    double smoothedPromotionRate_;
+    double smoothedTenureRate_;
+    bool hasPromotionRateSample_;
+
     /*
      * Calculate the promotion rate of the most recent minor GC.
      * The valid_for_tenuring parameter is used to return whether this
@@ -500,6 +622,15 @@ class Nursery
     Vector<MapObject*, 0, SystemAllocPolicy> mapsWithNurseryMemory_;
     Vector<SetObject*, 0, SystemAllocPolicy> setsWithNurseryMemory_;
 
+#ifdef ENABLE_BIGINT
+    /*
+     * BigInts allocated in the nursery. Their digits are malloced by GMP and
+     * may be reallocated at any time, so rather than tracking the buffers we
+     * finalize the BigInts that die in the nursery after minor GC.
+     */
+    Vector<JS::BigInt*, 0, SystemAllocPolicy> bigInts_;
+#endif
+
 #ifdef JS_GC_ZEAL
     struct Canary;
     Canary* lastCanary_;
@@ -570,9 +701,17 @@ class Nursery
 
     void sweepDictionaryModeObjects();
     void sweepMapAndSetObjects();
+#ifdef ENABLE_BIGINT
+    void sweepBigInts();
+#endif
+
+    /* Update the sites that have allocated since the last collection. */
+    void processAllocSites();
 
     /* Change the allocable space provided by the nursery. */
     void maybeResizeNursery(JS::gcreason::Reason reason);
+    void updateCollectionRates();
+    void resizeForPauseTarget(mozilla::TimeDuration target);
     void growAllocableSpace();
     void shrinkAllocableSpace(unsigned newCount);
     void minimizeAllocableSpace();
@@ -588,7 +727,9 @@ class Nursery
     static void printProfileDurations(const ProfileDurations& times);
 
     friend class TenuringTracer;
+    friend class gc::AllocSite;
     friend class gc::MinorCollectionTracer;
+    friend class gc::ParallelTenurer;
     friend class jit::MacroAssembler;
     friend struct NurseryChunk;
 };
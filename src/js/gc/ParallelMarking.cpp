@@ -0,0 +1,226 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gc/ParallelMarking.h"
+
+#include "mozilla/Move.h"
+
+#include "jsutil.h"
+
+#include "gc/GCInternals.h"
+#include "js/UniquePtr.h"
+#include "js/Vector.h"
+#include "vm/HelperThreads.h"
+#include "vm/Runtime.h"
+
+using namespace js;
+using namespace js::gc;
+
+using mozilla::Move;
+
+ParallelMarkTask::ParallelMarkTask(ParallelMarker* pm, JSRuntime* rt, const SliceBudget& budget)
+  : GCParallelTaskHelper(rt),
+    pm(pm),
+    marker_(rt),
+    budget(budget)
+{}
+
+bool
+ParallelMarkTask::init(size_t maxCapacity)
+{
+    return marker_.initForParallelMarking(maxCapacity);
+}
+
+void
+ParallelMarkTask::run()
+{
+    pm->runMarker(marker_, budget);
+}
+
+/* static */ bool
+ParallelMarker::canMarkInParallel(GCRuntime* gc, const SliceBudget& budget)
+{
+    // Work budgets count steps taken by a single marker and can't be shared.
+    // Gray marking and weak marking depend on state that is not safe to
+    // update from more than one thread.
+    GCMarker& marker = gc->marker;
+    return gc->markingThreads() > 1 &&
+           !budget.isWorkBudget() &&
+           marker.markColor() == MarkColor::Black &&
+           !marker.isWeakMarkingTracer() &&
+           !marker.isMarkStackEmpty() &&
+           CanUseExtraThreads();
+}
+
+ParallelMarker::ParallelMarker(GCRuntime* gc)
+  : gc(gc),
+    monitor(mutexid::GCParallelMarker),
+    activeMarkers(0),
+    done(false),
+    waitingMarkers(0),
+    hasPooledWork(false)
+{}
+
+size_t
+ParallelMarker::markerCount() const
+{
+    // One marker runs on the main thread.
+    size_t helperThreads = HelperThreadState().maxGCParallelThreads();
+    return Min(size_t(gc->markingThreads()), helperThreads + 1);
+}
+
+void
+ParallelMarker::mark(SliceBudget& budget)
+{
+    GCMarker& mainMarker = gc->marker;
+    MOZ_ASSERT(!mainMarker.isParallelMarker());
+
+    // If anything fails here we leave the work where it is and the caller
+    // carries on marking on the main thread.
+    workPool.setMaxCapacity(mainMarker.maxCapacity());
+    if (!workPool.init(JSGC_MODE_INCREMENTAL)) {
+        return;
+    }
+
+    Vector<UniquePtr<ParallelMarkTask>, 0, SystemAllocPolicy> tasks;
+    size_t count = markerCount();
+    if (!tasks.reserve(count)) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        auto task = js::MakeUnique<ParallelMarkTask>(this, gc->rt, budget);
+        if (!task || !task->init(mainMarker.maxCapacity())) {
+            break;
+        }
+        tasks.infallibleAppend(Move(task));
+    }
+    if (tasks.length() < 2) {
+        return;
+    }
+
+    if (!mainMarker.stack.transferEntriesTo(workPool, mainMarker.stack.position())) {
+        return;
+    }
+    hasPooledWork = true;
+
+    {
+        // Any tasks that fail to start are simply not run. Termination only
+        // depends on markers that have actually started.
+        AutoLockHelperThreadState helperLock;
+        for (size_t i = 1; i < tasks.length(); i++) {
+            if (!tasks[i]->startWithLockHeld(helperLock)) {
+                break;
+            }
+        }
+    }
+
+    tasks[0]->runFromMainThread(gc->rt);
+
+    for (auto& task : tasks) {
+        task->join();
+    }
+
+    // Everything is now back on the main thread. Trace the children that
+    // could not be traced in parallel and collect any unfinished work.
+    MOZ_ASSERT(activeMarkers == 0);
+    for (auto& task : tasks) {
+        mainMarker.takeParallelMarkerWork(task->marker());
+    }
+
+    mainMarker.takeMarkStackEntries(workPool);
+}
+
+void
+ParallelMarker::runMarker(GCMarker& marker, SliceBudget& budget)
+{
+    AutoLockMonitor lock(monitor);
+    if (done) {
+        return;
+    }
+
+    activeMarkers++;
+
+    while (getWork(marker, lock)) {
+        bool finished;
+        {
+            AutoUnlockMonitor unlock(monitor);
+            finished = marker.drainParallelMarkStack(*this, budget);
+        }
+        if (!finished) {
+            // Over budget. The remaining work on every marker's stack is
+            // returned to the main marker when they have all stopped.
+            stop(lock);
+        }
+    }
+
+    MOZ_ASSERT(activeMarkers > 0);
+    activeMarkers--;
+    lock.notifyAll();
+}
+
+bool
+ParallelMarker::getWork(GCMarker& marker, AutoLockMonitor& lock)
+{
+    MOZ_ASSERT(marker.isMarkStackEmpty() || done);
+
+    while (!done) {
+        if (!workPool.isEmpty()) {
+            // Leave some of the work for other markers if any are waiting.
+            size_t words = workPool.position();
+            if (waitingMarkers > 0) {
+                words = Max(words / 2, size_t(1));
+            }
+            if (!workPool.transferEntriesTo(marker.stack, words)) {
+                // Let the other markers finish the work. Whatever is left
+                // over is handled on the main thread.
+                stop(lock);
+                return false;
+            }
+            updateHasPooledWork(lock);
+            if (hasPooledWork) {
+                lock.notifyAll();
+            }
+            return true;
+        }
+
+        if (waitingMarkers + 1 == activeMarkers) {
+            // Everyone else is waiting and there is nothing left to do.
+            stop(lock);
+            return false;
+        }
+
+        waitingMarkers++;
+        lock.wait();
+        waitingMarkers--;
+    }
+
+    return false;
+}
+
+void
+ParallelMarker::donateWork(GCMarker& marker)
+{
+    AutoLockMonitor lock(monitor);
+
+    if (done || !workPool.isEmpty() || waitingMarkers == 0) {
+        return;
+    }
+
+    // Donating is best effort: on failure the marker keeps its work.
+    if (!marker.stack.transferEntriesTo(workPool, marker.stack.position() / 2)) {
+        return;
+    }
+
+    updateHasPooledWork(lock);
+    lock.notifyAll();
+}
+
+void
+ParallelMarker::stop(AutoLockMonitor& lock)
+{
+    done = true;
+    lock.notifyAll();
+}
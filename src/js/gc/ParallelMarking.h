@@ -0,0 +1,128 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef gc_ParallelMarking_h
+#define gc_ParallelMarking_h
+
+#include "mozilla/Atomics.h"
+
+#include "gc/GCMarker.h"
+#include "gc/GCParallelTask.h"
+#include "js/SliceBudget.h"
+#include "vm/Monitor.h"
+
+namespace js {
+namespace gc {
+
+class GCRuntime;
+class ParallelMarker;
+
+/*
+ * [SMDOC] Parallel marking
+ *
+ * When JSGC_MARKING_THREAD_COUNT is greater than one, draining the mark stack
+ * during black marking is shared between several markers: one running on the
+ * main thread and the rest on GC helper threads. Each marker has its own
+ * GCMarker and mark stack and sets mark bits atomically.
+ *
+ * Work is balanced through a shared pool: the main marker's stack is moved
+ * into the pool when marking starts and markers that run out of work take
+ * from it. Busy markers donate half of their stack to the pool whenever it is
+ * empty and another marker is waiting. Marking finishes once every marker is
+ * waiting and the pool is empty, or when the slice budget is exceeded.
+ *
+ * Not all tracing can happen off the main thread: things like scripts, object
+ * groups and objects with class trace hooks touch shared state when traced.
+ * Parallel markers mark such cells but hand them back to the main marker to
+ * trace their children, which happens serially once all markers have stopped.
+ * Any work left on a parallel marker's stack is also returned to the main
+ * marker at that point.
+ */
+
+// The maximum value of JSGC_MARKING_THREAD_COUNT.
+static const uint32_t MaxMarkingThreadCount = 64;
+
+class ParallelMarkTask : public GCParallelTaskHelper<ParallelMarkTask>
+{
+  public:
+    ParallelMarkTask(ParallelMarker* pm, JSRuntime* rt, const SliceBudget& budget);
+    ~ParallelMarkTask() {
+        join();
+    }
+
+    MOZ_MUST_USE bool init(size_t maxCapacity);
+
+    GCMarker& marker() { return marker_; }
+
+    void run();
+
+  private:
+    ParallelMarker* const pm;
+    GCMarker marker_;
+    SliceBudget budget;
+};
+
+class MOZ_RAII ParallelMarker
+{
+  public:
+    // Markers only donate work when their stack holds at least this many
+    // words, to avoid trading tiny amounts of work back and forth.
+    static const size_t MinDonationWords = 64;
+
+    static bool canMarkInParallel(GCRuntime* gc, const SliceBudget& budget);
+
+    explicit ParallelMarker(GCRuntime* gc);
+
+    // Drain the main marker's stack using all available markers. On return
+    // any work that remains, including children that must be traced on the
+    // main thread, is back on the main marker's stack.
+    void mark(SliceBudget& budget);
+
+    // Whether a marker is waiting for work that nobody has donated yet. This
+    // is checked by busy markers without taking the lock.
+    bool needsWork() const {
+        return waitingMarkers > 0 && !hasPooledWork;
+    }
+
+    void donateWork(GCMarker& marker);
+
+  private:
+    friend class ParallelMarkTask;
+
+    void runMarker(GCMarker& marker, SliceBudget& budget);
+    bool getWork(GCMarker& marker, AutoLockMonitor& lock);
+    void stop(AutoLockMonitor& lock);
+    void updateHasPooledWork(const AutoLockMonitor& lock) {
+        hasPooledWork = !workPool.isEmpty();
+    }
+
+    size_t markerCount() const;
+
+    GCRuntime* const gc;
+
+    // Protects all of the following fields except the atomics, which are
+    // only written while holding it.
+    Monitor monitor;
+
+    // Work donated by markers and not yet claimed.
+    MarkStack workPool;
+
+    // Number of markers that have started running and not yet stopped.
+    size_t activeMarkers;
+
+    // Set when marking is finished or the budget was exceeded.
+    bool done;
+
+    mozilla::Atomic<uint32_t, mozilla::Relaxed,
+                    mozilla::recordreplay::Behavior::DontPreserve> waitingMarkers;
+    mozilla::Atomic<bool, mozilla::Relaxed,
+                    mozilla::recordreplay::Behavior::DontPreserve> hasPooledWork;
+};
+
+} /* namespace gc */
+} /* namespace js */
+
+#endif /* gc_ParallelMarking_h */
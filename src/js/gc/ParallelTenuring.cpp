@@ -0,0 +1,445 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gc/ParallelTenuring.h"
+
+#include "mozilla/Move.h"
+
+#include "jsutil.h"
+
+#include "gc/Heap.h"
+#include "gc/Pretenuring.h"
+#include "gc/RelocationOverlay.h"
+#include "gc/Zone.h"
+#include "js/UniquePtr.h"
+#include "vm/ArrayObject.h"
+#include "vm/HelperThreads.h"
+#include "vm/NativeObject.h"
+#include "vm/Runtime.h"
+
+#include "gc/ArenaList-inl.h"
+#include "gc/Nursery-inl.h"
+
+using namespace js;
+using namespace js::gc;
+
+using mozilla::Move;
+
+ParallelTenuringTask::ParallelTenuringTask(ParallelTenurer* pt, JSRuntime* rt, Nursery* nursery)
+  : GCParallelTaskHelper(rt),
+    pt(pt),
+    mover_(rt, nursery, this)
+{}
+
+void
+ParallelTenuringTask::run()
+{
+    pt->runTask(*this);
+}
+
+ParallelTenuringTask::ZoneState&
+ParallelTenuringTask::zoneState(Zone* zone)
+{
+    for (ZoneState& state : zones) {
+        if (state.zone == zone) {
+            return state;
+        }
+    }
+
+    AutoEnterOOMUnsafeRegion oomUnsafe;
+    if (!zones.emplaceBack(zone)) {
+        oomUnsafe.crash("Failed to allocate zone state during parallel tenuring");
+    }
+    return zones.back();
+}
+
+TenuredCell*
+ParallelTenuringTask::allocateCell(Zone* zone, AllocKind kind)
+{
+    FreeLists& freeLists = zoneState(zone).freeLists;
+    TenuredCell* cell = freeLists.allocate(kind);
+    if (!cell) {
+        cell = pt->refillFreeListAndAllocate(zone, freeLists, kind);
+        if (!cell) {
+            AutoEnterOOMUnsafeRegion oomUnsafe;
+            oomUnsafe.crash(ChunkSize, "Failed to allocate new chunk during parallel tenuring");
+        }
+    }
+    return cell;
+}
+
+void
+ParallelTenuringTask::noteMallocBytes(Zone* zone, size_t nbytes)
+{
+    zoneState(zone).mallocBytes += nbytes;
+}
+
+void
+ParallelTenuringTask::deferEdge(Value* vp)
+{
+    AutoEnterOOMUnsafeRegion oomUnsafe;
+    if (!deferredEdges.append(vp)) {
+        oomUnsafe.crash("Failed to defer an edge during parallel tenuring");
+    }
+}
+
+void
+ParallelTenuringTask::noteTenured(RelocationOverlay* overlay, JSObject* obj)
+{
+    if (AllocSite* site = Nursery::getObjectAllocSite(overlay)) {
+        site->noteTenured();
+        return;
+    }
+
+    TenureCount& entry = tenureCounts.findEntry(obj->groupRaw());
+    if (entry.group == obj->groupRaw()) {
+        entry.count++;
+    } else if (!entry.group) {
+        entry.group = obj->groupRaw();
+        entry.count = 1;
+    }
+}
+
+void
+ParallelTenuringTask::finish(TenuringTracer& mainMover, TenureCountCache& mainTenureCounts)
+{
+    MOZ_ASSERT(!mainMover.isParallel());
+    MOZ_ASSERT(!mover_.objHead);
+    MOZ_ASSERT(!mover_.stringHead);
+
+    // Anything moved here is added to the main tracer's fixup list.
+    for (Value* vp : deferredEdges) {
+        mainMover.traceDeferredEdge(vp);
+    }
+    deferredEdges.clearAndFree();
+
+    for (ZoneState& state : zones) {
+        if (state.mallocBytes) {
+            state.zone->updateMallocCounter(state.mallocBytes);
+        }
+    }
+
+    mainMover.tenuredSize += mover_.tenuredSize;
+    mainMover.tenuredCells += mover_.tenuredCells;
+
+    for (const TenureCount& count : tenureCounts.entries) {
+        if (!count.group) {
+            continue;
+        }
+        TenureCount& entry = mainTenureCounts.findEntry(count.group);
+        if (entry.group == count.group) {
+            entry.count += count.count;
+        } else if (!entry.group) {
+            entry = count;
+        }
+    }
+}
+
+/* static */ bool
+ParallelTenurer::canTenureInParallel(Nursery* nursery, const TenuringTracer& mover)
+{
+#ifdef JS_GC_TRACE
+    // The GC trace log is not thread safe.
+    return false;
+#else
+    return nursery->runtime()->gc.tenuringThreads() > 1 &&
+           nursery->maxChunkCount() >= MinNurseryChunks &&
+           mover.objHead &&
+           CanUseExtraThreads();
+#endif
+}
+
+/* static */ bool
+ParallelTenurer::canMoveInParallel(const Class* clasp)
+{
+    // These classes have no trace, finalize or object moved hooks, so moving
+    // and tracing them only touches the object and its slots and elements.
+    return clasp == &PlainObject::class_ || clasp == &ArrayObject::class_;
+}
+
+ParallelTenurer::ParallelTenurer(JSRuntime* rt, Nursery* nursery)
+  : rt(rt),
+    nursery(nursery),
+    claimBits(nullptr),
+    monitor(mutexid::GCParallelTenuring),
+    activeTasks(0),
+    done(false),
+    waitingTasks(0),
+    hasPooledWork(false)
+{}
+
+ParallelTenurer::~ParallelTenurer()
+{
+    js_free(claimBits);
+}
+
+bool
+ParallelTenurer::initClaims()
+{
+    MOZ_ASSERT(!claimBits);
+    size_t words = nursery->allocatedChunkCount() * ClaimWordsPerChunk;
+    claimBits = js_pod_calloc<uintptr_t>(words);
+    return claimBits;
+}
+
+size_t
+ParallelTenurer::taskCount() const
+{
+    // One task runs on the main thread.
+    size_t helperThreads = HelperThreadState().maxGCParallelThreads();
+    return Min(size_t(rt->gc.tenuringThreads()), helperThreads + 1);
+}
+
+bool
+ParallelTenurer::claim(const Cell* cell)
+{
+    uintptr_t addr = uintptr_t(cell);
+    uintptr_t chunk = addr & ~ChunkMask;
+
+    // The set of chunks doesn't change during a collection.
+    const auto& chunks = nursery->chunks_;
+    for (size_t i = 0; i < chunks.length(); i++) {
+        if (uintptr_t(chunks[i]) == chunk) {
+            size_t bit = (addr & ChunkMask) >> CellAlignShift;
+            uintptr_t* word = &claimBits[i * ClaimWordsPerChunk + bit / JS_BITS_PER_WORD];
+            uintptr_t mask = uintptr_t(1) << (bit % JS_BITS_PER_WORD);
+            return !(AtomicFetchOrMarkWord(word, mask) & mask);
+        }
+    }
+
+    MOZ_CRASH("Claimed cell is not in the nursery");
+}
+
+TenuredCell*
+ParallelTenurer::refillFreeListAndAllocate(Zone* zone, FreeLists& freeLists, AllocKind kind)
+{
+    AutoLockMonitor lock(monitor);
+    return zone->arenas.refillFreeListAndAllocate(freeLists, kind,
+                                                  ShouldCheckThresholds::DontCheckThresholds);
+}
+
+void
+ParallelTenurer::removeMallocedBuffer(void* buffer)
+{
+    AutoLockMonitor lock(monitor);
+    nursery->removeMallocedBuffer(buffer);
+}
+
+void
+ParallelTenurer::setElementsForwardingPointer(ObjectElements* oldHeader,
+                                              ObjectElements* newHeader, uint32_t capacity)
+{
+    AutoLockMonitor lock(monitor);
+    nursery->setElementsForwardingPointer(oldHeader, newHeader, capacity);
+}
+
+static void
+AppendToFixupList(TenuringTracer& mover, RelocationOverlay* head, RelocationOverlay** tail)
+{
+    *mover.objTail = head;
+    mover.objTail = tail;
+}
+
+void
+ParallelTenurer::addSegment(TenuringTracer& mover, const Segment& segment)
+{
+    // If the pool can't grow then the main thread does this part.
+    if (!pool.append(segment)) {
+        AppendToFixupList(mover, segment.head, segment.tail);
+    }
+}
+
+void
+ParallelTenurer::splitWork(TenuringTracer& mover)
+{
+    RelocationOverlay* p = mover.objHead;
+    mover.objHead = nullptr;
+    mover.objTail = &mover.objHead;
+
+    Segment segment = { nullptr, nullptr };
+    size_t length = 0;
+    while (p) {
+        RelocationOverlay* next = p->next();
+        p->nextRef() = nullptr;
+
+        JSObject* obj = static_cast<JSObject*>(p->forwardingAddress());
+        if (!canMoveInParallel(obj->getClass())) {
+            AppendToFixupList(mover, p, &p->nextRef());
+        } else {
+            if (!segment.head) {
+                segment.head = p;
+            } else {
+                *segment.tail = p;
+            }
+            segment.tail = &p->nextRef();
+
+            if (++length == SegmentLength) {
+                addSegment(mover, segment);
+                segment = { nullptr, nullptr };
+                length = 0;
+            }
+        }
+
+        p = next;
+    }
+
+    if (segment.head) {
+        addSegment(mover, segment);
+    }
+}
+
+void
+ParallelTenurer::tenure(TenuringTracer& mover, TenureCountCache& tenureCounts)
+{
+    MOZ_ASSERT(!mover.isParallel());
+
+    // If anything fails here we leave the work where it is and the caller
+    // carries on serially.
+    if (!initClaims()) {
+        return;
+    }
+
+    Vector<UniquePtr<ParallelTenuringTask>, 0, SystemAllocPolicy> tasks;
+    size_t count = taskCount();
+    if (!tasks.reserve(count)) {
+        return;
+    }
+    for (size_t i = 0; i < count; i++) {
+        auto task = js::MakeUnique<ParallelTenuringTask>(this, rt, nursery);
+        if (!task) {
+            break;
+        }
+        tasks.infallibleAppend(Move(task));
+    }
+    if (tasks.length() < 2) {
+        return;
+    }
+
+    splitWork(mover);
+    if (pool.empty()) {
+        return;
+    }
+    hasPooledWork = true;
+
+    {
+        // Any tasks that fail to start are simply not run. Termination only
+        // depends on tasks that have actually started.
+        AutoLockHelperThreadState helperLock;
+        for (size_t i = 1; i < tasks.length(); i++) {
+            if (!tasks[i]->startWithLockHeld(helperLock)) {
+                break;
+            }
+        }
+    }
+
+    tasks[0]->runFromMainThread(rt);
+
+    for (auto& task : tasks) {
+        task->join();
+    }
+
+    MOZ_ASSERT(activeTasks == 0);
+    MOZ_ASSERT(pool.empty());
+
+    for (auto& task : tasks) {
+        task->finish(mover, tenureCounts);
+    }
+}
+
+void
+ParallelTenurer::runTask(ParallelTenuringTask& task)
+{
+    AutoLockMonitor lock(monitor);
+    if (done) {
+        return;
+    }
+
+    activeTasks++;
+
+    while (getWork(task.mover(), lock)) {
+        AutoUnlockMonitor unlock(monitor);
+        collectToFixedPoint(task);
+    }
+
+    MOZ_ASSERT(activeTasks > 0);
+    activeTasks--;
+    lock.notifyAll();
+}
+
+void
+ParallelTenurer::collectToFixedPoint(ParallelTenuringTask& task)
+{
+    TenuringTracer& mover = task.mover();
+    for (RelocationOverlay* p = mover.objHead; p; p = p->next()) {
+        JSObject* obj = static_cast<JSObject*>(p->forwardingAddress());
+        mover.traceObject(obj);
+        task.noteTenured(p, obj);
+
+        if (needsWork() && p->next()) {
+            donateWork(mover, p);
+        }
+    }
+
+    // Everything on the list has been traced.
+    mover.objHead = nullptr;
+    mover.objTail = &mover.objHead;
+}
+
+bool
+ParallelTenurer::getWork(TenuringTracer& mover, AutoLockMonitor& lock)
+{
+    MOZ_ASSERT(!mover.objHead);
+
+    while (!done) {
+        if (!pool.empty()) {
+            Segment segment = pool.popCopy();
+            mover.objHead = segment.head;
+            mover.objTail = segment.tail;
+            updateHasPooledWork(lock);
+            return true;
+        }
+
+        if (waitingTasks + 1 == activeTasks) {
+            // Everyone else is waiting and there is nothing left to do.
+            stop(lock);
+            return false;
+        }
+
+        waitingTasks++;
+        lock.wait();
+        waitingTasks--;
+    }
+
+    return false;
+}
+
+void
+ParallelTenurer::donateWork(TenuringTracer& mover, RelocationOverlay* current)
+{
+    AutoLockMonitor lock(monitor);
+
+    if (done || !pool.empty() || waitingTasks == 0) {
+        return;
+    }
+
+    // Give away everything after the entry currently being traced.
+    Segment segment = { current->next(), mover.objTail };
+    if (!pool.append(segment)) {
+        return;
+    }
+    current->nextRef() = nullptr;
+    mover.objTail = &current->nextRef();
+
+    updateHasPooledWork(lock);
+    lock.notifyAll();
+}
+
+void
+ParallelTenurer::stop(AutoLockMonitor& lock)
+{
+    done = true;
+    lock.notifyAll();
+}
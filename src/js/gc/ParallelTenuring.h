@@ -0,0 +1,198 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef gc_ParallelTenuring_h
+#define gc_ParallelTenuring_h
+
+#include "mozilla/Atomics.h"
+
+#include "gc/ArenaList.h"
+#include "gc/GCInternals.h"
+#include "gc/GCParallelTask.h"
+#include "gc/Nursery.h"
+#include "js/Vector.h"
+#include "vm/Monitor.h"
+
+namespace js {
+namespace gc {
+
+/*
+ * [SMDOC] Parallel tenuring
+ *
+ * When JSGC_TENURING_THREAD_COUNT is greater than one and the nursery is
+ * large, most of a minor GC -- tracing the objects that have been moved to
+ * the tenured heap and moving the nursery objects they point to -- is shared
+ * between a tracer on the main thread and tracers on GC helper threads.
+ *
+ * Roots and the store buffer are still traced serially. The objects this
+ * moves are split into segments of the fixup list and put in a shared pool.
+ * Each task runs its own TenuringTracer over its segments and appends the
+ * objects it moves to its own fixup list. Idle tasks take segments from the
+ * pool and busy tasks donate the rest of their list when the pool is empty,
+ * in the same way as parallel marking (see gc/ParallelMarking.h).
+ *
+ * Only plain objects and arrays, which have no class hooks, are moved or
+ * traced off the main thread. A task claims a nursery object by atomically
+ * setting its bit in a side bitmap; the winner copies the object and only
+ * then installs the forwarding pointer in its header, so other tasks can
+ * always read the object's class and wait for the forwarding pointer when
+ * they lose the race. Edges to any other kind of nursery thing are recorded
+ * and traced by the main thread's tracer once every task has finished, after
+ * which the serial fixed point loop completes the collection.
+ *
+ * Tasks allocate tenured cells from their own free lists, which are refilled
+ * under a lock. The same lock protects the nursery's buffer tables.
+ */
+
+// The maximum value of JSGC_TENURING_THREAD_COUNT.
+static const uint32_t MaxTenuringThreadCount = 64;
+
+class ParallelTenurer;
+
+class ParallelTenuringTask : public GCParallelTaskHelper<ParallelTenuringTask>
+{
+  public:
+    ParallelTenuringTask(ParallelTenurer* pt, JSRuntime* rt, Nursery* nursery);
+    ~ParallelTenuringTask() {
+        join();
+    }
+
+    ParallelTenurer& tenurer() { return *pt; }
+    TenuringTracer& mover() { return mover_; }
+
+    void run();
+
+    // Allocate a tenured cell from this task's free lists.
+    TenuredCell* allocateCell(JS::Zone* zone, AllocKind kind);
+
+    // Record memory allocated for object slots or elements of |zone|.
+    void noteMallocBytes(JS::Zone* zone, size_t nbytes);
+
+    // Record an edge that must be traced by the main thread.
+    void deferEdge(JS::Value* vp);
+
+    // Trace and account everything this task left for the main thread.
+    void finish(TenuringTracer& mainMover, TenureCountCache& mainTenureCounts);
+
+  private:
+    friend class ParallelTenurer;
+
+    struct ZoneState
+    {
+        JS::Zone* zone;
+        FreeLists freeLists;
+        size_t mallocBytes;
+
+        explicit ZoneState(JS::Zone* zone)
+          : zone(zone), mallocBytes(0)
+        {}
+    };
+
+    ZoneState& zoneState(JS::Zone* zone);
+    void noteTenured(RelocationOverlay* overlay, JSObject* obj);
+
+    ParallelTenurer* const pt;
+    TenuringTracer mover_;
+    Vector<ZoneState, 4, SystemAllocPolicy> zones;
+    Vector<JS::Value*, 0, SystemAllocPolicy> deferredEdges;
+    TenureCountCache tenureCounts;
+};
+
+class MOZ_RAII ParallelTenurer
+{
+  public:
+    // Parallel tenuring is only worth it for nurseries at least this large.
+    static const unsigned MinNurseryChunks = 4;
+
+    // The number of objects in each segment of the initial work.
+    static const size_t SegmentLength = 256;
+
+    static bool canTenureInParallel(Nursery* nursery, const TenuringTracer& mover);
+
+    // Whether objects of class |clasp| can be moved and traced by a parallel
+    // tracer.
+    static bool canMoveInParallel(const Class* clasp);
+
+    ParallelTenurer(JSRuntime* rt, Nursery* nursery);
+    ~ParallelTenurer();
+
+    // Trace the objects on |mover|'s fixup list, and everything they keep
+    // alive that can be moved off the main thread. On return the remaining
+    // work is on |mover|'s fixup list.
+    void tenure(TenuringTracer& mover, TenureCountCache& tenureCounts);
+
+    // Claim a nursery cell for moving. Returns false if another tracer
+    // already claimed it.
+    bool claim(const Cell* cell);
+
+    // Operations on state shared between tracers.
+    TenuredCell* refillFreeListAndAllocate(JS::Zone* zone, FreeLists& freeLists, AllocKind kind);
+    void removeMallocedBuffer(void* buffer);
+    void setElementsForwardingPointer(ObjectElements* oldHeader, ObjectElements* newHeader,
+                                      uint32_t capacity);
+
+  private:
+    friend class ParallelTenuringTask;
+
+    struct Segment
+    {
+        RelocationOverlay* head;
+        RelocationOverlay** tail;
+    };
+
+    static const size_t ClaimWordsPerChunk = ChunkSize / CellAlignBytes / JS_BITS_PER_WORD;
+
+    MOZ_MUST_USE bool initClaims();
+    size_t taskCount() const;
+
+    void splitWork(TenuringTracer& mover);
+    void addSegment(TenuringTracer& mover, const Segment& segment);
+
+    void runTask(ParallelTenuringTask& task);
+    void collectToFixedPoint(ParallelTenuringTask& task);
+    bool getWork(TenuringTracer& mover, AutoLockMonitor& lock);
+    void donateWork(TenuringTracer& mover, RelocationOverlay* current);
+    void stop(AutoLockMonitor& lock);
+
+    bool needsWork() const {
+        return waitingTasks > 0 && !hasPooledWork;
+    }
+    void updateHasPooledWork(const AutoLockMonitor& lock) {
+        hasPooledWork = !pool.empty();
+    }
+
+    JSRuntime* const rt;
+    Nursery* const nursery;
+
+    // One bit per cell-aligned word of each nursery chunk, indexed in the
+    // same order as the nursery's chunks and set by the tracer that claims the
+    // cell at that address.
+    uintptr_t* claimBits;
+
+    // Protects all of the following fields, except the atomics which are
+    // only written while holding it, and the nursery and arena list state
+    // used by tracers.
+    Monitor monitor;
+
+    // Work donated by tasks and not yet claimed.
+    Vector<Segment, 0, SystemAllocPolicy> pool;
+
+    // Number of tasks that have started running and not yet stopped.
+    size_t activeTasks;
+
+    // Set when there is nothing left to do or something failed.
+    bool done;
+
+    mozilla::Atomic<uint32_t, mozilla::Relaxed,
+                    mozilla::recordreplay::Behavior::DontPreserve> waitingTasks;
+    mozilla::Atomic<bool, mozilla::Relaxed,
+                    mozilla::recordreplay::Behavior::DontPreserve> hasPooledWork;
+};
+
+} /* namespace gc */
+} /* namespace js */
+
+#endif /* gc_ParallelTenuring_h */
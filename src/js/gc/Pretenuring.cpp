@@ -0,0 +1,62 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "gc/Pretenuring.h"
+
+#include "gc/Nursery.h"
+#include "vm/JSContext.h"
+
+using namespace js;
+using namespace js::gc;
+
+// The proportion of a site's nursery allocations that must be tenured for it
+// to be considered long-lived.
+static const double LongLivedSurvivalRate = 0.8;
+
+void
+AllocSite::noteNurseryAlloc(Nursery& nursery)
+{
+    if (nurseryAllocCount_++ != 0)
+        return;
+
+    MOZ_ASSERT(!nextNurseryAllocated_);
+    nextNurseryAllocated_ = nursery.allocatedSites_;
+    nursery.allocatedSites_ = this;
+}
+
+bool
+AllocSite::processMinorGC()
+{
+    uint32_t allocCount = nurseryAllocCount_;
+    uint32_t tenuredCount = nurseryTenuredCount_;
+    MOZ_ASSERT(tenuredCount <= allocCount);
+
+    nurseryAllocCount_ = 0;
+    nurseryTenuredCount_ = 0;
+    nextNurseryAllocated_ = nullptr;
+
+    if (state_ != State::Unknown || allocCount < MinAllocCount)
+        return false;
+
+    double survivalRate = double(tenuredCount) / double(allocCount);
+    if (survivalRate < LongLivedSurvivalRate)
+        return false;
+
+    state_ = State::LongLived;
+    return true;
+}
+
+AutoSetAllocSite::AutoSetAllocSite(JSContext* cx, AllocSite* site)
+  : nursery_(cx->nursery()),
+    prev_(nursery_.currentAllocSite())
+{
+    nursery_.setCurrentAllocSite(site);
+}
+
+AutoSetAllocSite::~AutoSetAllocSite()
+{
+    nursery_.setCurrentAllocSite(prev_);
+}
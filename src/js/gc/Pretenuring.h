@@ -0,0 +1,132 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef gc_Pretenuring_h
+#define gc_Pretenuring_h
+
+#include "mozilla/Atomics.h"
+#include "mozilla/Attributes.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "js/TypeDecls.h"
+
+namespace js {
+
+class Nursery;
+
+namespace gc {
+
+/*
+ * [SMDOC] Allocation site pretenuring
+ *
+ * Pretenuring by ObjectGroup (see Nursery::collect) is too coarse when one
+ * group is allocated from sites with very different lifetimes. Allocations
+ * made by JSOP_NEWOBJECT, JSOP_NEWINIT and JSOP_NEWARRAY once a script has
+ * baseline code are therefore attributed to an AllocSite, owned by the
+ * fallback IC stub for that op.
+ *
+ * Every nursery object has a header word before it holding its site, or null
+ * if the site is unknown, in the same way that nursery strings record their
+ * zone. Sites count their nursery allocations and, during tenuring, how many
+ * of those survived. After each minor GC the nursery looks at every site that
+ * allocated since the previous one, and marks sites whose objects mostly
+ * survive as long-lived. Long-lived sites allocate in the tenured heap: Ion
+ * code for the zone is discarded so it can be recompiled that way, and
+ * baseline stubs and the JIT allocation path check the site's state.
+ *
+ * Objects without a site still feed per-group pretenuring.
+ *
+ * Fallback stub memory is only freed after the next minor GC (see
+ * ICStubSpace::freeAllAfterMinorGC), so the nursery never refers to a site
+ * that has been freed.
+ */
+class AllocSite
+{
+  public:
+    enum class State : uint32_t
+    {
+        Unknown = 0,
+        LongLived
+    };
+
+    // The minimum number of nursery allocations a site must make between
+    // minor GCs for its survival rate to be used.
+    static const uint32_t MinAllocCount = 100;
+
+    explicit AllocSite(JS::Zone* zone)
+      : zone_(zone),
+        state_(State::Unknown),
+        nurseryAllocCount_(0),
+        nurseryTenuredCount_(0),
+        nextNurseryAllocated_(nullptr)
+    {}
+
+    JS::Zone* zone() const { return zone_; }
+    State state() const { return state_; }
+    bool isLongLived() const { return state_ == State::LongLived; }
+
+    // Count a nursery allocation, adding the site to the nursery's list of
+    // sites that have allocated since the last minor GC if this is the first.
+    void noteNurseryAlloc(Nursery& nursery);
+
+    // Count an object allocated here being tenured. This may be called by
+    // parallel tenuring tasks.
+    void noteTenured() {
+        nurseryTenuredCount_++;
+    }
+
+    // Update the state after a minor GC and reset the counts. Returns whether
+    // the site became long-lived.
+    bool processMinorGC();
+
+    AllocSite* nextNurseryAllocated() const { return nextNurseryAllocated_; }
+    void setNextNurseryAllocated(AllocSite* next) { nextNurseryAllocated_ = next; }
+
+    static size_t offsetOfState() {
+        return offsetof(AllocSite, state_);
+    }
+    static size_t offsetOfNurseryAllocCount() {
+        return offsetof(AllocSite, nurseryAllocCount_);
+    }
+    static size_t offsetOfNextNurseryAllocated() {
+        return offsetof(AllocSite, nextNurseryAllocated_);
+    }
+
+  private:
+    JS::Zone* const zone_;
+    State state_;
+
+    // Updated by JIT code, see MacroAssembler::updateAllocSite.
+    uint32_t nurseryAllocCount_;
+
+    mozilla::Atomic<uint32_t, mozilla::Relaxed,
+                    mozilla::recordreplay::Behavior::DontPreserve> nurseryTenuredCount_;
+
+    // Next site in Nursery::allocatedSites_.
+    AllocSite* nextNurseryAllocated_;
+
+    AllocSite(const AllocSite&) = delete;
+    AllocSite& operator=(const AllocSite&) = delete;
+};
+
+// Attribute object allocations made while this is live to |site|, and make
+// them in the tenured heap if the site is long-lived. |site| may be null.
+class MOZ_RAII AutoSetAllocSite
+{
+    Nursery& nursery_;
+    AllocSite* prev_;
+
+  public:
+    AutoSetAllocSite(JSContext* cx, AllocSite* site);
+    ~AutoSetAllocSite();
+};
+
+} /* namespace gc */
+} /* namespace js */
+
+#endif /* gc_Pretenuring_h */
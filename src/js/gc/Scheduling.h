@@ -418,7 +418,8 @@ class GCSchedulingTunables
     /*
      * JSGC_DYNAMIC_MARK_SLICE
      *
-     * Doubles the length of IGC slices when in the |highFrequencyGC| mode.
+     * Doubles the length of IGC slices when in the |highFrequencyGC| mode,
+     * and lengthens the slices of collections which spend many slices marking.
      */
     MainThreadData<bool> dynamicMarkSliceEnabled_;
 
@@ -439,6 +440,13 @@ class GCSchedulingTunables
      */
     UnprotectedData<uint32_t> nurseryFreeThresholdForIdleCollection_;
 
+    /*
+     * JSGC_NURSERY_PAUSE_TARGET
+     *
+     * If non-zero, size the nursery so that minor GCs take about this long.
+     */
+    MainThreadData<mozilla::TimeDuration> nurseryPauseTarget_;
+
   public:
     GCSchedulingTunables();
 
@@ -462,6 +470,7 @@ class GCSchedulingTunables
     uint32_t nurseryFreeThresholdForIdleCollection() const {
         return nurseryFreeThresholdForIdleCollection_;
     }
+    const mozilla::TimeDuration& nurseryPauseTarget() const { return nurseryPauseTarget_; }
 
     MOZ_MUST_USE bool setParameter(JSGCParamKey key, uint32_t value, const AutoLockGC& lock);
     void resetParameter(JSGCParamKey key, const AutoLockGC& lock);
@@ -8,12 +8,15 @@
 
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/DebugOnly.h"
+#include "mozilla/IntegerPrintfMacros.h"
 #include "mozilla/Sprintf.h"
 #include "mozilla/TimeStamp.h"
 
 #include <ctype.h>
+#include <math.h>
 #include <stdarg.h>
 #include <stdio.h>
+#include <string.h>
 #include <type_traits>
 
 #include "jsutil.h"
@@ -461,6 +464,7 @@ Statistics::formatDetailedDescription() const
   SCC Sweep Total (MaxPause): %.3fms (%.3fms)\n\
   HeapSize: %.3f MiB\n\
   Chunk Delta (magnitude): %+d  (%d)\n\
+  Huge Page Chunks: %d\n\
   Arenas Relocated: %.3f MiB\n\
   Trigger: %s\n\
 ";
@@ -489,6 +493,7 @@ Statistics::formatDetailedDescription() const
         double(preBytes) / bytesPerMiB,
         getCount(STAT_NEW_CHUNK) - getCount(STAT_DESTROY_CHUNK),
         getCount(STAT_NEW_CHUNK) + getCount(STAT_DESTROY_CHUNK),
+        getCount(STAT_HUGE_PAGE_CHUNK),
         double(ArenaSize * getCount(STAT_ARENA_RELOCATED)) / bytesPerMiB,
         thresholdBuffer);
 
@@ -616,6 +621,168 @@ Statistics::renderNurseryJson(JSRuntime* rt) const
     return printer.release();
 }
 
+uint64_t
+Histogram::countBelowPowerOfTwo(size_t exponent) const
+{
+    if (exponent > MaxExponent) {
+        return count_;
+    }
+
+    uint64_t limit = uint64_t(1) << exponent;
+    uint64_t result = 0;
+    for (size_t i = 0; i < BucketCount && bucketStart(i) < limit; i++) {
+        result += buckets_[i];
+    }
+    return result;
+}
+
+uint64_t
+Histogram::quantile(double q) const
+{
+    if (count_ == 0) {
+        return 0;
+    }
+
+    uint64_t target = uint64_t(ceil(q * double(count_)));
+    target = std::min(std::max(target, uint64_t(1)), count_);
+
+    uint64_t seen = 0;
+    for (size_t i = 0; i < BucketCount - 1; i++) {
+        seen += buckets_[i];
+        if (seen >= target) {
+            return std::min(bucketStart(i + 1) - 1, max_);
+        }
+    }
+    return max_;
+}
+
+// The name of a phase kind, as used in the paths of its phases.
+static const char*
+PhaseKindName(PhaseKind phaseKind)
+{
+    const char* path = phases[phaseKinds[phaseKind].firstPhase].path;
+    const char* dot = strrchr(path, '.');
+    return dot ? dot + 1 : path;
+}
+
+static void
+FormatJsonHistogram(const char* name, const Histogram& histogram, JSONPrinter& json)
+{
+    json.beginObjectProperty(name);
+    json.property("count", histogram.count());
+    json.property("sum", histogram.sum());
+    json.property("max", histogram.max());
+    json.property("p50", histogram.quantile(0.5));
+    json.property("p90", histogram.quantile(0.9));
+    json.property("p99", histogram.quantile(0.99));
+    json.property("p999", histogram.quantile(0.999));
+
+    // The counts of the non-empty buckets, keyed by their first value.
+    json.beginObjectProperty("buckets");
+    for (size_t i = 0; i < Histogram::BucketCount; i++) {
+        if (uint32_t count = histogram.bucketCount(i)) {
+            char start[24];
+            SprintfLiteral(start, "%" PRIu64, Histogram::bucketStart(i));
+            json.property(start, count);
+        }
+    }
+    json.endObject();
+
+    json.endObject();
+}
+
+UniqueChars
+Statistics::renderHistogramsJson() const
+{
+    Sprinter printer(nullptr, false);
+    if (!printer.init()) {
+        return UniqueChars(nullptr);
+    }
+    JSONPrinter json(printer);
+
+    json.beginObject();
+    FormatJsonHistogram("slice_pause_us", slicePauseHistogram, json);
+    FormatJsonHistogram("minor_gc_us", nurseryCollectionHistogram, json);
+    FormatJsonHistogram("minor_gc_tenured_bytes", tenuredBytesHistogram, json);
+    json.beginObjectProperty("phase_us");
+    for (auto kind : MajorGCPhaseKinds()) {
+        if (phaseKindHistograms[kind].count()) {
+            FormatJsonHistogram(PhaseKindName(kind), phaseKindHistograms[kind], json);
+        }
+    }
+    json.endObject();
+    json.endObject();
+
+    return printer.release();
+}
+
+static void
+FormatPrometheusHistogram(const char* name, const char* label, const Histogram& histogram,
+                          Sprinter& out)
+{
+    const char* separator = label ? "," : "";
+    label = label ? label : "";
+
+    // Prometheus buckets are cumulative, with inclusive upper bounds. Stop
+    // once the remaining buckets would repeat the total.
+    for (size_t exponent = 0; exponent <= Histogram::MaxExponent; exponent++) {
+        uint64_t count = histogram.countBelowPowerOfTwo(exponent);
+        out.printf("%s_bucket{%s%sle=\"%" PRIu64 "\"} %" PRIu64 "\n",
+                   name, label, separator, (uint64_t(1) << exponent) - 1, count);
+        if (count == histogram.count()) {
+            break;
+        }
+    }
+    out.printf("%s_bucket{%s%sle=\"+Inf\"} %" PRIu64 "\n",
+               name, label, separator, histogram.count());
+
+    const char* braceOpen = *label ? "{" : "";
+    const char* braceClose = *label ? "}" : "";
+    out.printf("%s_sum%s%s%s %" PRIu64 "\n", name, braceOpen, label, braceClose, histogram.sum());
+    out.printf("%s_count%s%s%s %" PRIu64 "\n", name, braceOpen, label, braceClose,
+               histogram.count());
+}
+
+UniqueChars
+Statistics::renderHistogramsPrometheus() const
+{
+    Sprinter printer(nullptr, false);
+    if (!printer.init()) {
+        return UniqueChars(nullptr);
+    }
+
+    printer.put("# HELP js_gc_slice_pause_microseconds Duration of major GC slices.\n"
+                "# TYPE js_gc_slice_pause_microseconds histogram\n");
+    FormatPrometheusHistogram("js_gc_slice_pause_microseconds", nullptr, slicePauseHistogram,
+                              printer);
+
+    printer.put("# HELP js_gc_minor_microseconds Duration of nursery collections.\n"
+                "# TYPE js_gc_minor_microseconds histogram\n");
+    FormatPrometheusHistogram("js_gc_minor_microseconds", nullptr, nurseryCollectionHistogram,
+                              printer);
+
+    printer.put("# HELP js_gc_minor_tenured_bytes Bytes tenured by nursery collections.\n"
+                "# TYPE js_gc_minor_tenured_bytes histogram\n");
+    FormatPrometheusHistogram("js_gc_minor_tenured_bytes", nullptr, tenuredBytesHistogram,
+                              printer);
+
+    printer.put("# HELP js_gc_phase_microseconds Time spent in each phase by major GCs.\n"
+                "# TYPE js_gc_phase_microseconds histogram\n");
+    for (auto kind : MajorGCPhaseKinds()) {
+        if (phaseKindHistograms[kind].count()) {
+            char label[64];
+            SprintfLiteral(label, "phase=\"%s\"", PhaseKindName(kind));
+            FormatPrometheusHistogram("js_gc_phase_microseconds", label,
+                                      phaseKindHistograms[kind], printer);
+        }
+    }
+
+    if (printer.hadOutOfMemory()) {
+        return UniqueChars(nullptr);
+    }
+    return printer.release();
+}
+
 #ifdef DEBUG
 void
 Statistics::writeLogMessage(const char* fmt, ...)
@@ -671,6 +838,12 @@ Statistics::renderJsonMessage(uint64_t timestamp, bool includeSlices) const
     formatJsonPhaseTimes(phaseTimes, json);
     json.endObject();
 
+    if (phaseCounters) {
+        json.beginObjectProperty("perf_counters"); // #25
+        formatJsonPhaseCounters(json);
+        json.endObject();
+    }
+
     json.endObject();
 
     return printer.release();
@@ -736,6 +909,10 @@ Statistics::formatJsonDescription(uint64_t timestamp, JSONPrinter& json) const
     json.property("major_gc_number", startingMajorGCNumber); // #20
     json.property("minor_gc_number", startingMinorGCNumber); // #21
     json.property("slice_number", startingSliceNumber); // #22
+    uint32_t hugePageChunks = getCount(STAT_HUGE_PAGE_CHUNK);
+    if (hugePageChunks) {
+        json.property("huge_page_chunks", hugePageChunks); // #23
+    }
 }
 
 void
@@ -785,6 +962,24 @@ Statistics::formatJsonPhaseTimes(const PhaseTimeTable& phaseTimes, JSONPrinter&
     }
 }
 
+void
+Statistics::formatJsonPhaseCounters(JSONPrinter& json) const
+{
+    MOZ_ASSERT(phaseCounters);
+    for (auto phase : AllPhases()) {
+        const PerfCounterValues& values = phaseCounters->totals[phase];
+        if (values.isZero()) {
+            continue;
+        }
+        json.beginObjectProperty(phases[phase].path);
+        for (size_t i = 0; i < size_t(PerfCounterKind::Limit); i++) {
+            PerfCounterKind kind = PerfCounterKind(i);
+            json.property(PerfCounterName(kind), values.counts[kind]);
+        }
+        json.endObject();
+    }
+}
+
 Statistics::Statistics(JSRuntime* rt)
   : runtime(rt),
     gcTimerFile(nullptr),
@@ -845,6 +1040,16 @@ Statistics::Statistics(JSRuntime* rt)
         enableProfiling_ = true;
         profileThreshold_ = TimeDuration::FromMilliseconds(atoi(env));
     }
+
+    // The counters count the thread which creates the runtime, which is the
+    // one that runs its GCs.
+    if (getenv("JS_GC_PERF_COUNTERS")) {
+        phaseCounters = MakeUnique<PhaseCounters>();
+        if (phaseCounters && !phaseCounters->counters.init()) {
+            fprintf(stderr, "JS_GC_PERF_COUNTERS: can't open the hardware performance counters\n");
+            phaseCounters = nullptr;
+        }
+    }
 }
 
 Statistics::~Statistics()
@@ -1069,6 +1274,13 @@ Statistics::endGC()
     const double mmu50 = computeMMU(TimeDuration::FromMilliseconds(50));
     runtime->addTelemetry(JS_TELEMETRY_GC_MMU_50, mmu50 * 100);
     thresholdTriggered = false;
+
+    for (auto kind : MajorGCPhaseKinds()) {
+        TimeDuration time = SumPhase(kind, phaseTimes);
+        if (!time.IsZero()) {
+            phaseKindHistograms[kind].record(uint64_t(time.ToMicroseconds()));
+        }
+    }
 }
 
 void
@@ -1095,6 +1307,13 @@ Statistics::endNurseryCollection(JS::gcreason::Reason reason)
     allocsSinceMinorGC = {0, 0};
 }
 
+void
+Statistics::recordNurseryCollection(TimeDuration duration, size_t tenuredBytes)
+{
+    nurseryCollectionHistogram.record(uint64_t(duration.ToMicroseconds()));
+    tenuredBytesHistogram.record(tenuredBytes);
+}
+
 void
 Statistics::beginSlice(const ZoneGCStats& zoneStats, JSGCInvocationKind gckind,
                        SliceBudget budget, JS::gcreason::Reason reason)
@@ -1111,7 +1330,7 @@ Statistics::beginSlice(const ZoneGCStats& zoneStats, JSGCInvocationKind gckind,
 
     if (!slices_.emplaceBack(budget,
                              reason,
-                             ReallyNow(),
+                             InstrumentationClock::now(),
                              GetPageFaultCount(),
                              runtime->gc.state()))
     {
@@ -1144,13 +1363,14 @@ Statistics::endSlice()
 
     if (!aborted) {
         auto& slice = slices_.back();
-        slice.end = ReallyNow();
+        slice.end = InstrumentationClock::now();
         slice.endFaults = GetPageFaultCount();
         slice.finalState = runtime->gc.state();
 
         writeLogMessage("end slice");
         TimeDuration sliceTime = slice.end - slice.start;
         runtime->addTelemetry(JS_TELEMETRY_GC_SLICE_MS, t(sliceTime));
+        slicePauseHistogram.record(uint64_t(sliceTime.ToMicroseconds()));
         runtime->addTelemetry(JS_TELEMETRY_GC_RESET, slice.wasReset());
         if (slice.wasReset()) {
             runtime->addTelemetry(JS_TELEMETRY_GC_RESET_REASON, uint32_t(slice.resetReason));
@@ -1241,6 +1461,12 @@ Statistics::endSlice()
 
         phaseStartTimes[Phase::MUTATOR] = mutatorStartTime;
         phaseTimes[Phase::MUTATOR] = mutatorTime;
+
+        if (phaseCounters) {
+            for (PerfCounterValues& values : phaseCounters->totals) {
+                values = PerfCounterValues();
+            }
+        }
     }
 
     aborted = false;
@@ -1318,7 +1544,7 @@ Statistics::resumePhases()
     {
         Phase resumePhase = suspendedPhases.popCopy();
         if (resumePhase == Phase::MUTATOR) {
-            timedGCTime += ReallyNow() - timedGCStart;
+            timedGCTime += InstrumentationClock::now() - timedGCStart;
         }
         recordPhaseBegin(resumePhase);
     }
@@ -1351,7 +1577,7 @@ Statistics::recordPhaseBegin(Phase phase)
     Phase current = currentPhase();
     MOZ_ASSERT(phases[phase].parent == current);
 
-    TimeStamp now = ReallyNow();
+    TimeStamp now = InstrumentationClock::now();
 
     if (current != Phase::NONE) {
         MOZ_ASSERT(now >= phaseStartTimes[currentPhase()], "Inconsistent time data; see bug 1400153");
@@ -1363,6 +1589,9 @@ Statistics::recordPhaseBegin(Phase phase)
 
     phaseStack.infallibleAppend(phase);
     phaseStartTimes[phase] = now;
+    if (phaseCounters && phase != Phase::MUTATOR) {
+        phaseCounters->counters.read(&phaseCounters->startValues[phase]);
+    }
     writeLogMessage("begin: %s", phases[phase].path);
 }
 
@@ -1373,7 +1602,7 @@ Statistics::recordPhaseEnd(Phase phase)
 
     MOZ_ASSERT(phaseStartTimes[phase]);
 
-    TimeStamp now = ReallyNow();
+    TimeStamp now = InstrumentationClock::now();
 
     // Make sure this phase ends after it starts.
     MOZ_ASSERT(now >= phaseStartTimes[phase], "Inconsistent time data; see bug 1400153");
@@ -1415,6 +1644,12 @@ Statistics::recordPhaseEnd(Phase phase)
     phaseTimes[phase] += t;
     phaseStartTimes[phase] = TimeStamp();
 
+    if (phaseCounters && phase != Phase::MUTATOR) {
+        PerfCounterValues values;
+        phaseCounters->counters.read(&values);
+        phaseCounters->totals[phase] += values - phaseCounters->startValues[phase];
+    }
+
 #ifdef DEBUG
     phaseEndTimes[phase] = now;
     writeLogMessage("end: %s", phases[phase].path);
@@ -1462,7 +1697,7 @@ Statistics::recordParallelPhase(PhaseKind phaseKind, TimeDuration duration)
 TimeStamp
 Statistics::beginSCC()
 {
-    return ReallyNow();
+    return InstrumentationClock::now();
 }
 
 void
@@ -1472,7 +1707,7 @@ Statistics::endSCC(unsigned scc, TimeStamp start)
         return;
     }
 
-    sccTimes[scc] += ReallyNow() - start;
+    sccTimes[scc] += InstrumentationClock::now() - start;
 }
 
 /*
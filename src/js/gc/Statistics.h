@@ -11,8 +11,11 @@
 #include "mozilla/Atomics.h"
 #include "mozilla/EnumeratedArray.h"
 #include "mozilla/IntegerRange.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/TimeStamp.h"
 
+#include <algorithm>
+
 #include "jspubtd.h"
 #include "NamespaceImports.h"
 
@@ -22,6 +25,7 @@
 #include "js/UniquePtr.h"
 #include "js/Vector.h"
 #include "vm/JSONPrinter.h"
+#include "vm/PerfCounters.h"
 
 namespace js {
 namespace gcstats {
@@ -43,6 +47,9 @@ enum Stat {
     // Number of arenas relocated by compacting GC.
     STAT_ARENA_RELOCATED,
 
+    // Number of new chunks the OS agreed to back with huge pages.
+    STAT_HUGE_PAGE_CHUNK,
+
     STAT_LIMIT
 };
 
@@ -92,6 +99,78 @@ struct ZoneGCStats
 const char* ExplainAbortReason(gc::AbortReason reason);
 const char* ExplainInvocationKind(JSGCInvocationKind gckind);
 
+/*
+ * A histogram of non-negative integer values, in the style of an HDR
+ * histogram: each power of two range is split into SubBuckets linear buckets,
+ * so values are recorded with a relative error of at most 25% in a fixed
+ * amount of memory whatever their range.
+ */
+class Histogram
+{
+  public:
+    static const size_t SubBucketBits = 2;
+    static const size_t SubBuckets = size_t(1) << SubBucketBits;
+
+    // Values of 2^MaxExponent and above are counted in the last bucket.
+    static const size_t MaxExponent = 48;
+    static const size_t BucketCount = (MaxExponent - SubBucketBits + 1) * SubBuckets;
+
+  private:
+    mozilla::Array<uint32_t, BucketCount> buckets_;
+    uint64_t count_;
+    uint64_t sum_;
+    uint64_t max_;
+
+    static size_t bucketIndex(uint64_t value) {
+        if (value < SubBuckets) {
+            return size_t(value);
+        }
+        size_t exponent = mozilla::FloorLog2(value);
+        if (exponent >= MaxExponent) {
+            return BucketCount - 1;
+        }
+        size_t subBucket = size_t(value >> (exponent - SubBucketBits)) & (SubBuckets - 1);
+        return (exponent - SubBucketBits + 1) * SubBuckets + subBucket;
+    }
+
+  public:
+    Histogram()
+      : count_(0), sum_(0), max_(0)
+    {
+        for (auto& bucket : buckets_) {
+            bucket = 0;
+        }
+    }
+
+    void record(uint64_t value) {
+        buckets_[bucketIndex(value)]++;
+        count_++;
+        sum_ += value;
+        max_ = std::max(max_, value);
+    }
+
+    uint64_t count() const { return count_; }
+    uint64_t sum() const { return sum_; }
+    uint64_t max() const { return max_; }
+    uint32_t bucketCount(size_t index) const { return buckets_[index]; }
+
+    // The smallest value counted in a bucket.
+    static uint64_t bucketStart(size_t index) {
+        if (index < SubBuckets) {
+            return index;
+        }
+        size_t exponent = index / SubBuckets + SubBucketBits - 1;
+        uint64_t subBucket = SubBuckets + index % SubBuckets;
+        return subBucket << (exponent - SubBucketBits);
+    }
+
+    // The number of values less than 2^exponent.
+    uint64_t countBelowPowerOfTwo(size_t exponent) const;
+
+    // An upper bound for the value at quantile |q| in [0, 1].
+    uint64_t quantile(double q) const;
+};
+
 /*
  * Struct for collecting timing statistics on a "phase tree". The tree is
  * specified as a limited DAG, but the timings are collected for the whole tree
@@ -217,6 +296,8 @@ struct Statistics
     void beginNurseryCollection(JS::gcreason::Reason reason);
     void endNurseryCollection(JS::gcreason::Reason reason);
 
+    void recordNurseryCollection(TimeDuration duration, size_t tenuredBytes);
+
     TimeStamp beginSCC();
     void endSCC(unsigned scc, TimeStamp start);
 
@@ -291,6 +372,18 @@ struct Statistics
     // Return JSON for the previous nursery collection.
     UniqueChars renderNurseryJson(JSRuntime* rt) const;
 
+    // Return the histograms of GC activity since the runtime was created, as
+    // JSON or in the Prometheus text exposition format.
+    UniqueChars renderHistogramsJson() const;
+    UniqueChars renderHistogramsPrometheus() const;
+
+    // The total duration of the major GC slices and nursery collections since
+    // the runtime was created.
+    TimeDuration totalPauseTime() const {
+        uint64_t micros = slicePauseHistogram.sum() + nurseryCollectionHistogram.sum();
+        return TimeDuration::FromMicroseconds(double(micros));
+    }
+
 #ifdef DEBUG
     // Print a logging message.
     void writeLogMessage(const char* fmt, ...);
@@ -378,6 +471,30 @@ struct Statistics
     /* Sweep times for SCCs of compartments. */
     Vector<TimeDuration, 0, SystemAllocPolicy> sccTimes;
 
+    /*
+     * Histograms over the lifetime of the runtime, of the duration of major
+     * GC slices and nursery collections in microseconds, of the bytes tenured
+     * by nursery collections, and of the time spent in each phase kind by
+     * major GCs in microseconds.
+     */
+    Histogram slicePauseHistogram;
+    Histogram nurseryCollectionHistogram;
+    Histogram tenuredBytesHistogram;
+    EnumeratedArray<PhaseKind, PhaseKind::LIMIT, Histogram> phaseKindHistograms;
+
+    /*
+     * Hardware performance counters for each phase of the current GC, if
+     * JS_GC_PERF_COUNTERS is set. Like phaseTimes, a phase's counts include
+     * its children's.
+     */
+    struct PhaseCounters
+    {
+        PerfCounters counters;
+        EnumeratedArray<Phase, Phase::LIMIT, PerfCounterValues> startValues;
+        EnumeratedArray<Phase, Phase::LIMIT, PerfCounterValues> totals;
+    };
+    UniquePtr<PhaseCounters> phaseCounters;
+
     JS::GCSliceCallback sliceCallback;
     JS::GCNurseryCollectionCallback nurseryCollectionCallback;
 
@@ -431,6 +548,7 @@ FOR_EACH_GC_PROFILE_TIME(DEFINE_TIME_KEY)
     void formatJsonDescription(uint64_t timestamp, JSONPrinter&) const;
     void formatJsonSliceDescription(unsigned i, const SliceData& slice, JSONPrinter&) const;
     void formatJsonPhaseTimes(const PhaseTimeTable& phaseTimes, JSONPrinter&) const;
+    void formatJsonPhaseCounters(JSONPrinter&) const;
     void formatJsonSlice(size_t sliceNum, JSONPrinter&) const;
 
     double computeMMU(TimeDuration resolution) const;
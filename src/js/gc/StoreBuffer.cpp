@@ -93,6 +93,96 @@ StoreBuffer::clear()
     bufferGeneric.clear();
 }
 
+template <typename T>
+void
+StoreBuffer::MonoTypeBuffer<T>::compact()
+{
+    size_t length = stores_.length();
+    MOZ_ASSERT(sortedCount_ <= length);
+    if (sortedCount_ == length) {
+        return;
+    }
+
+    // Sort the tail and remove duplicates within it.
+    T* tail = stores_.begin() + sortedCount_;
+    std::sort(tail, stores_.end());
+    size_t tailCount = std::unique(tail, stores_.end()) - tail;
+    stores_.shrinkTo(sortedCount_ + tailCount);
+
+    // Merge it into the prefix, working back from the end.
+    if (sortedCount_ != 0) {
+        scratch_.clear();
+        AutoEnterOOMUnsafeRegion oomUnsafe;
+        if (!scratch_.append(tail, tailCount)) {
+            oomUnsafe.crash("Failed to allocate for MonoTypeBuffer::compact.");
+        }
+
+        size_t i = sortedCount_;
+        size_t j = tailCount;
+        size_t out = sortedCount_ + tailCount;
+        while (j > 0) {
+            if (i > 0 && scratch_[j - 1] < stores_[i - 1]) {
+                stores_[--out] = stores_[--i];
+            } else {
+                stores_[--out] = scratch_[--j];
+            }
+        }
+
+        T* end = std::unique(stores_.begin(), stores_.end());
+        stores_.shrinkTo(end - stores_.begin());
+    }
+
+    sortedCount_ = stores_.length();
+}
+
+template <typename T>
+void
+StoreBuffer::MonoTypeBuffer<T>::remove(const T& v)
+{
+    // Remove every copy from the unsorted tail.
+    size_t i = sortedCount_;
+    while (i < stores_.length()) {
+        if (stores_[i] == v) {
+            stores_[i] = stores_.back();
+            stores_.popBack();
+        } else {
+            i++;
+        }
+    }
+
+    // Overwrite any copies in the sorted prefix with a neighbouring entry,
+    // which keeps the prefix sorted. The extra copy is dropped the next time
+    // the buffer is compacted.
+    T* begin = stores_.begin();
+    T* end = begin + sortedCount_;
+    auto range = std::equal_range(begin, end, v);
+    if (range.first == range.second) {
+        return;
+    }
+
+    if (range.first != begin) {
+        std::fill(range.first, range.second, *(range.first - 1));
+    } else if (range.second != end) {
+        std::fill(range.first, range.second, *range.second);
+    } else {
+        stores_.erase(begin, end);
+        sortedCount_ = 0;
+    }
+}
+
+template <typename T>
+bool
+StoreBuffer::MonoTypeBuffer<T>::contains(const T& v) const
+{
+    for (size_t i = sortedCount_; i < stores_.length(); i++) {
+        if (stores_[i] == v) {
+            return true;
+        }
+    }
+
+    return std::binary_search(stores_.begin(), stores_.begin() + sortedCount_, v);
+}
+
 void
 StoreBuffer::setAboutToOverflow(JS::gcreason::Reason reason)
 {
@@ -18,6 +18,7 @@
 #include "gc/Nursery.h"
 #include "js/AllocPolicy.h"
 #include "js/MemoryMetrics.h"
+#include "js/Vector.h"
 
 namespace js {
 namespace gc {
@@ -65,13 +66,29 @@ class StoreBuffer
      * This buffer holds only a single type of edge. Using this buffer is more
      * efficient than the generic buffer when many writes will be to the same
      * type of edge: e.g. Value or Cell*.
+     *
+     * Stores are appended to a vector without checking for duplicates, which
+     * is cheaper than hashing every store. The vector is a sorted prefix
+     * followed by a short unsorted tail. When the tail fills up it is sorted
+     * and merged into the prefix, dropping duplicates, so the buffer only
+     * grows with the number of distinct edges.
      */
     template<typename T>
     struct MonoTypeBuffer
     {
         /* The canonical set of stores. */
-        typedef HashSet<T, typename T::Hasher, SystemAllocPolicy> StoreSet;
-        StoreSet stores_;
+        typedef Vector<T, 0, SystemAllocPolicy> StoreVector;
+        StoreVector stores_;
+
+        /*
+         * The length of the sorted prefix of |stores_|. The prefix is in
+         * non-decreasing order, and only contains duplicates left behind by
+         * unput().
+         */
+        size_t sortedCount_;
+
+        /* Space used to merge the unsorted tail into the prefix. */
+        StoreVector scratch_;
 
         /*
          * A one element cache in front of the canonical set to speed up
@@ -82,11 +99,15 @@ class StoreBuffer
         /* Maximum number of entries before we request a minor GC. */
         const static size_t MaxEntries = 48 * 1024 / sizeof(T);
 
-        explicit MonoTypeBuffer() : last_(T()) {}
+        /* Maximum number of unsorted entries before they are merged. */
+        const static size_t MaxUnsortedEntries = 4 * 1024 / sizeof(T);
+
+        explicit MonoTypeBuffer() : sortedCount_(0), last_(T()) {}
 
         void clear() {
             last_ = T();
             stores_.clear();
+            sortedCount_ = 0;
         }
 
         /* Add one item to the buffer. */
@@ -102,34 +123,41 @@ class StoreBuffer
                 last_ = T();
                 return;
             }
-            stores_.remove(v);
+            remove(v);
         }
 
         /* Move any buffered stores to the canonical store set. */
         void sinkStore(StoreBuffer* owner) {
             if (last_) {
                 AutoEnterOOMUnsafeRegion oomUnsafe;
-                if (!stores_.put(last_)) {
+                if (!stores_.append(last_)) {
                     oomUnsafe.crash("Failed to allocate for MonoTypeBuffer::put.");
                 }
             }
             last_ = T();
 
-            if (MOZ_UNLIKELY(stores_.count() > MaxEntries)) {
-                owner->setAboutToOverflow(T::FullBufferReason);
+            if (MOZ_UNLIKELY(stores_.length() - sortedCount_ >= MaxUnsortedEntries)) {
+                compact();
+                if (stores_.length() > MaxEntries) {
+                    owner->setAboutToOverflow(T::FullBufferReason);
+                }
             }
         }
 
         bool has(StoreBuffer* owner, const T& v) {
             sinkStore(owner);
-            return stores_.has(v);
+            return contains(v);
         }
 
+        /* Sort the unsorted tail into the prefix and remove duplicates. */
+        void compact();
+
         /* Trace the source of all edges in the store buffer. */
         void trace(StoreBuffer* owner, TenuringTracer& mover);
 
         size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) {
-            return stores_.shallowSizeOfExcludingThis(mallocSizeOf);
+            return stores_.sizeOfExcludingThis(mallocSizeOf) +
+                   scratch_.sizeOfExcludingThis(mallocSizeOf);
         }
 
         bool isEmpty() const {
@@ -137,6 +165,9 @@ class StoreBuffer
         }
 
       private:
+        void remove(const T& v);
+        bool contains(const T& v) const;
+
         MonoTypeBuffer(const MonoTypeBuffer& other) = delete;
         MonoTypeBuffer& operator=(const MonoTypeBuffer& other) = delete;
     };
@@ -254,14 +285,6 @@ class StoreBuffer
         GenericBuffer& operator=(const GenericBuffer& other) = delete;
     };
 
-    template <typename Edge>
-    struct PointerEdgeHasher
-    {
-        typedef Edge Lookup;
-        static HashNumber hash(const Lookup& l) { return mozilla::HashGeneric(l.edge); }
-        static bool match(const Edge& k, const Lookup& l) { return k == l; }
-    };
-
     struct CellPtrEdge
     {
         Cell** edge;
@@ -270,6 +293,9 @@ class StoreBuffer
         explicit CellPtrEdge(Cell** v) : edge(v) {}
         bool operator==(const CellPtrEdge& other) const { return edge == other.edge; }
         bool operator!=(const CellPtrEdge& other) const { return edge != other.edge; }
+        bool operator<(const CellPtrEdge& other) const {
+            return uintptr_t(edge) < uintptr_t(other.edge);
+        }
 
         bool maybeInRememberedSet(const Nursery& nursery) const {
             MOZ_ASSERT(IsInsideNursery(*edge));
@@ -284,8 +310,6 @@ class StoreBuffer
 
         explicit operator bool() const { return edge != nullptr; }
 
-        typedef PointerEdgeHasher<CellPtrEdge> Hasher;
-
         static const auto FullBufferReason = JS::gcreason::FULL_CELL_PTR_BUFFER;
     };
 
@@ -297,6 +321,9 @@ class StoreBuffer
         explicit ValueEdge(JS::Value* v) : edge(v) {}
         bool operator==(const ValueEdge& other) const { return edge == other.edge; }
         bool operator!=(const ValueEdge& other) const { return edge != other.edge; }
+        bool operator<(const ValueEdge& other) const {
+            return uintptr_t(edge) < uintptr_t(other.edge);
+        }
 
         Cell* deref() const { return edge->isGCThing() ? static_cast<Cell*>(edge->toGCThing()) : nullptr; }
 
@@ -313,8 +340,6 @@ class StoreBuffer
 
         explicit operator bool() const { return edge != nullptr; }
 
-        typedef PointerEdgeHasher<ValueEdge> Hasher;
-
         static const auto FullBufferReason = JS::gcreason::FULL_VALUE_BUFFER;
     };
 
@@ -351,6 +376,16 @@ class StoreBuffer
             return !(*this == other);
         }
 
+        bool operator<(const SlotsEdge& other) const {
+            if (objectAndKind_ != other.objectAndKind_) {
+                return objectAndKind_ < other.objectAndKind_;
+            }
+            if (start_ != other.start_) {
+                return start_ < other.start_;
+            }
+            return count_ < other.count_;
+        }
+
         // True if this SlotsEdge range overlaps with the other SlotsEdge range,
         // false if they do not overlap.
         bool overlaps(const SlotsEdge& other) const {
@@ -391,14 +426,6 @@ class StoreBuffer
 
         explicit operator bool() const { return objectAndKind_ != 0; }
 
-        typedef struct {
-            typedef SlotsEdge Lookup;
-            static HashNumber hash(const Lookup& l) {
-                return mozilla::HashGeneric(l.objectAndKind_, l.start_, l.count_);
-            }
-            static bool match(const SlotsEdge& k, const Lookup& l) { return k == l; }
-        } Hasher;
-
         static const auto FullBufferReason = JS::gcreason::FULL_SLOT_BUFFER;
     };
 
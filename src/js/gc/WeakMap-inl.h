@@ -145,9 +145,16 @@ WeakMap<K, V>::markIteratively(GCMarker* marker)
             // the lookup key in the list of weak keys. Also record the
             // delegate, if any, because marking the delegate also marks
             // the entry.
+            //
+            // Marking the key itself can only mark the value, so there is no
+            // need to wait on it if the value is already marked, which is
+            // always the case for values that are not GC things. This keeps
+            // the table small for maps whose values are primitives or shared.
             JS::GCCellPtr weakKey(extractUnbarriered(e.front().key()));
             gc::WeakMarkable markable(this, weakKey);
-            addWeakEntry(marker, weakKey, markable);
+            if (!gc::IsMarked(marker->runtime(), &e.front().value())) {
+                addWeakEntry(marker, weakKey, markable);
+            }
             if (JSObject* delegate = getDelegate(e.front().key())) {
                 addWeakEntry(marker, JS::GCCellPtr(delegate), markable);
             }
@@ -6,6 +6,8 @@
 
 #include "gc/Zone-inl.h"
 
+#include "jsfriendapi.h"
+
 #include "gc/FreeOp.h"
 #include "gc/Policy.h"
 #include "gc/PublicIterators.h"
@@ -18,6 +20,7 @@
 #include "gc/GC-inl.h"
 #include "gc/Marking-inl.h"
 #include "vm/Realm-inl.h"
+#include "vm/TypeInference-inl.h"
 
 using namespace js;
 using namespace js::gc;
@@ -30,6 +33,7 @@ JS::Zone::Zone(JSRuntime* rt)
     // ProtectedData checks in CheckZone::check may read this field.
     helperThreadUse_(HelperThreadUse::None),
     helperThreadOwnerContext_(nullptr),
+    gcSweepTaskOwnerContext_(nullptr),
     debuggers(this, nullptr),
     uniqueIds_(this),
     suppressAllocationMetadataBuilder(this, false),
@@ -54,12 +58,16 @@ JS::Zone::Zone(JSRuntime* rt)
     gcDelayBytes(0),
     tenuredStrings(this, 0),
     allocNurseryStrings(this, true),
+    tenuredBigInts(this, 0),
+    allocNurseryBigInts(this, true),
+    allocSiteStateChanged(this, false),
     propertyTree_(this, this),
     baseShapes_(this, this),
     initialShapes_(this, this),
     nurseryShapes_(this),
     data(this, nullptr),
     isSystem(this, false),
+    jitSpectreMitigations_(true),
 #ifdef DEBUG
     gcLastSweepGroupIndex(0),
 #endif
@@ -269,6 +277,90 @@ Zone::discardJitCode(FreeOp* fop, bool discardBaselineCode)
     jitZone()->cfgSpace()->lifoAlloc().freeAll();
 }
 
+// Whether an IonScript which inlined |script| is still live, in which case
+// bailouts from that code might need the script's BaselineScript.
+static bool
+HasLiveInliningCompilation(TypeZone& types, JSScript* script)
+{
+    if (!script->types()) {
+        return false;
+    }
+    for (const RecompileInfo& info : script->types()->inlinedCompilations()) {
+        if (info.maybeIonScriptToInvalidate(types)) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+Zone::discardAgedJitCode(FreeOp* fop)
+{
+    uint32_t maxAge = jit::JitOptions.jitCodeDiscardAge;
+    if (!jitZone() || !maxAge || isAtomsZone()) {
+        return;
+    }
+
+    // Discard Ion code first, so that Baseline code which was only kept alive
+    // for bailouts from it can be discarded too.
+    size_t discardedBytes = 0;
+    RecompileInfoVector invalid;
+    for (auto script = cellIter<JSScript>(); !script.done(); script.next()) {
+        if (!script->hasIonScript() || script->jitCodeAge() < maxAge) {
+            continue;
+        }
+        if (!invalid.emplaceBack(script, script->ionScript()->compilationId())) {
+            // Ignore OOM, we'll find this script again on the next GC.
+            break;
+        }
+        discardedBytes += script->ionScript()->method()->instructionsSize();
+    }
+    if (!invalid.empty()) {
+        jit::Invalidate(types, fop, invalid, /* resetUses = */ true,
+                        /* cancelOffThread = */ false);
+    }
+
+    // Keep Baseline code on the stack, including for Ion frames which may
+    // bail out into it.
+    jit::MarkActiveBaselineScripts(this);
+
+    for (auto script = cellIter<JSScript>(); !script.done(); script.next()) {
+        if (!script->hasBaselineScript()) {
+            continue;
+        }
+
+        jit::BaselineScript* baseline = script->baselineScript();
+        if (baseline->active()) {
+            baseline->resetActive();
+            script->incJitCodeAge();
+            continue;
+        }
+
+        if (script->jitCodeAge() < maxAge ||
+            script->hasIonScript() ||
+            HasLiveInliningCompilation(types, script))
+        {
+            script->incJitCodeAge();
+            continue;
+        }
+
+        discardedBytes += baseline->method()->instructionsSize();
+        jit::FinishDiscardBaselineScript(fop, script);
+        script->resetWarmUpCounter();
+    }
+
+    if (discardedBytes) {
+        runtimeFromMainThread()->jitRuntime()->addAgedCodeBytesDiscarded(discardedBytes);
+    }
+}
+
+JS_FRIEND_API(uint64_t)
+js::GetAgedJitCodeBytesDiscarded(JSContext* cx)
+{
+    jit::JitRuntime* jitRuntime = cx->runtime()->jitRuntime();
+    return jitRuntime ? jitRuntime->agedCodeBytesDiscarded() : 0;
+}
+
 #ifdef JSGC_HASH_TABLE_CHECKS
 void
 JS::Zone::checkUniqueIdTableAfterMovingGC()
@@ -436,6 +528,20 @@ Zone::ownedByCurrentHelperThread()
     return helperThreadOwnerContext_ == TlsContext.get();
 }
 
+bool
+Zone::ownedByCurrentGCSweepTask() const
+{
+    return gcSweepTaskOwnerContext_ && gcSweepTaskOwnerContext_ == TlsContext.get();
+}
+
+void
+Zone::setGCSweepTaskOwnerContext(JSContext* cx)
+{
+    MOZ_ASSERT_IF(cx, TlsContext.get() == cx);
+    MOZ_ASSERT(!cx != !gcSweepTaskOwnerContext_);
+    gcSweepTaskOwnerContext_ = cx;
+}
+
 void Zone::releaseAtoms()
 {
     MOZ_ASSERT(hasKeptAtoms());
@@ -580,6 +686,16 @@ ZoneList::append(Zone* zone)
     transferFrom(singleZone);
 }
 
+void
+ZoneList::prepend(Zone* zone)
+{
+    ZoneList list(zone);
+    if (!isEmpty()) {
+        list.transferFrom(*this);
+    }
+    transferFrom(list);
+}
+
 void
 ZoneList::transferFrom(ZoneList& other)
 {
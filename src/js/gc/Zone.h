@@ -167,10 +167,17 @@ class Zone : public JS::shadow::Zone,
     // usedByHelperThread(), or nullptr when on the main thread.
     js::UnprotectedData<JSContext*> helperThreadOwnerContext_;
 
+    // The context of a GC helper thread that has been handed this zone to
+    // sweep while the main thread waits for it, or nullptr.
+    js::UnprotectedData<JSContext*> gcSweepTaskOwnerContext_;
+
   public:
     bool ownedByCurrentHelperThread();
     void setHelperThreadOwnerContext(JSContext* cx);
 
+    bool ownedByCurrentGCSweepTask() const;
+    void setGCSweepTaskOwnerContext(JSContext* cx);
+
     // Whether this zone was created for use by a helper thread.
     bool createdForHelperThread() const {
         return helperThreadUse_ != HelperThreadUse::None;
@@ -197,6 +204,10 @@ class Zone : public JS::shadow::Zone,
 
     void discardJitCode(js::FreeOp* fop, bool discardBaselineCode = true);
 
+    // Discard the JIT code of scripts which have not run for the last
+    // JitOptions.jitCodeDiscardAge GCs. Used when the zone is preserving code.
+    void discardAgedJitCode(js::FreeOp* fop);
+
     void addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf,
                                 size_t* typePool,
                                 size_t* regexpZone,
@@ -530,6 +541,13 @@ class Zone : public JS::shadow::Zone,
     js::ZoneData<uint32_t> tenuredStrings;
     js::ZoneData<bool> allocNurseryStrings;
 
+    js::ZoneData<uint32_t> tenuredBigInts;
+    js::ZoneData<bool> allocNurseryBigInts;
+
+    // Set when an allocation site in this zone becomes long-lived, so that Ion
+    // code can be discarded at the end of the minor GC.
+    js::ZoneData<bool> allocSiteStateChanged;
+
   private:
     // Shared Shape property tree.
     js::ZoneData<js::PropertyTree> propertyTree_;
@@ -570,6 +588,16 @@ class Zone : public JS::shadow::Zone,
 
     js::ZoneData<bool> isSystem;
 
+  private:
+    // Whether JIT code for this zone uses the Spectre mitigations enabled in
+    // JitOptions. This is set when the zone is created and never changes, so
+    // off thread compilations can read it.
+    bool jitSpectreMitigations_;
+
+  public:
+    bool jitSpectreMitigations() const { return jitSpectreMitigations_; }
+    void initJitSpectreMitigations(bool enabled) { jitSpectreMitigations_ = enabled; }
+
 #ifdef DEBUG
     js::MainThreadData<unsigned> gcLastSweepGroupIndex;
 #endif
@@ -630,7 +658,7 @@ class Zone : public JS::shadow::Zone,
 
     js::MainThreadData<bool> gcScheduled_;
     js::MainThreadData<bool> gcScheduledSaved_;
-    js::MainThreadData<bool> gcPreserveCode_;
+    js::MainThreadOrGCTaskData<bool> gcPreserveCode_;
     js::ZoneData<bool> keepShapeTables_;
 
     // Allow zones to be linked into a list
@@ -145,9 +145,12 @@ GetObject(const MDefinition* ins)
       case MDefinition::Opcode::TypedArrayLength:
       case MDefinition::Opcode::SetTypedObjectOffset:
       case MDefinition::Opcode::SetDisjointTypedElements:
+      case MDefinition::Opcode::TypedArrayFill:
+      case MDefinition::Opcode::TypedArraySearch:
       case MDefinition::Opcode::ArrayPopShift:
       case MDefinition::Opcode::ArrayPush:
       case MDefinition::Opcode::ArraySlice:
+      case MDefinition::Opcode::ArraySearch:
       case MDefinition::Opcode::LoadTypedArrayElementHole:
       case MDefinition::Opcode::StoreTypedArrayElementHole:
       case MDefinition::Opcode::LoadFixedSlot:
@@ -1449,7 +1449,12 @@ BacktrackingAllocator::processBundle(MIRGenerator* mir, LiveBundle* bundle)
 
             // If that didn't work, but we have one or more non-fixed bundles
             // known to be conflicting, maybe we can evict them and try again.
-            if ((attempt < MAX_ATTEMPTS || minimalBundle(bundle)) &&
+            // When allocating in linear scan order only minimal bundles, which
+            // must end up in a register, may evict others.
+            bool mayEvict = linearScan
+                            ? minimalBundle(bundle)
+                            : (attempt < MAX_ATTEMPTS || minimalBundle(bundle));
+            if (mayEvict &&
                 !fixed &&
                 !conflicting.empty() &&
                 maximumSpillWeight(conflicting) < computeSpillWeight(bundle))
@@ -2679,6 +2684,12 @@ BacktrackingAllocator::dumpAllocations()
 size_t
 BacktrackingAllocator::computePriority(LiveBundle* bundle)
 {
+    // When allocating in linear scan order, bundles which start earlier have
+    // a higher priority.
+    if (linearScan) {
+        return SIZE_MAX - bundle->firstRange()->from().bits();
+    }
+
     // The priority of a bundle is its total length, so that longer lived
     // bundles will be processed before shorter ones (even if the longer ones
     // have a low spill weight). See processBundle().
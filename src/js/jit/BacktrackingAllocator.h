@@ -624,6 +624,13 @@ class BacktrackingAllocator : protected RegisterAllocator
     // This flag is set when testing new allocator modifications.
     bool testbed;
 
+    // This flag is set to allocate bundles in order of their start position,
+    // linear scan style. Bundles are only evicted to make room for minimal
+    // bundles, and are otherwise split right away when no register is free.
+    // This avoids the repeated evict and requeue cycles which make
+    // backtracking allocation slow on very large functions.
+    bool linearScan;
+
     BitSet* liveIn;
     FixedList<VirtualRegister> vregs;
 
@@ -707,9 +714,11 @@ class BacktrackingAllocator : protected RegisterAllocator
     Vector<LiveBundle*, 4, SystemAllocPolicy> spilledBundles;
 
   public:
-    BacktrackingAllocator(MIRGenerator* mir, LIRGenerator* lir, LIRGraph& graph, bool testbed)
+    BacktrackingAllocator(MIRGenerator* mir, LIRGenerator* lir, LIRGraph& graph, bool testbed,
+                          bool linearScan = false)
       : RegisterAllocator(mir, lir, graph),
         testbed(testbed),
+        linearScan(linearScan),
         liveIn(nullptr),
         callRanges(nullptr)
     { }
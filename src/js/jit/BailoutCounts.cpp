@@ -0,0 +1,164 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "jit/BailoutCounts.h"
+
+#include "gc/Marking.h"
+#include "gc/PublicIterators.h"
+#include "jit/JitOptions.h"
+#include "jit/JitRealm.h"
+#include "vm/JSContext.h"
+#include "vm/JSScript.h"
+
+using namespace js;
+using namespace js::jit;
+
+// Bailouts of these kinds do not mean that a speculation failed, so they are
+// counted but never make Ion more conservative.
+static bool
+IsSpeculationFailure(BailoutKind kind)
+{
+    switch (kind) {
+      case Bailout_Inevitable:
+      case Bailout_DuringVMCall:
+      case Bailout_FirstExecution:
+      case Bailout_ArgumentCheck:
+      case Bailout_Debugger:
+      case Bailout_IonExceptionDebugMode:
+        return false;
+      default:
+        return true;
+    }
+}
+
+BailoutCounts::ScriptCounts*
+BailoutCounts::lookupOrAdd(JSScript* script, const LockGuard<Mutex>& lock)
+{
+    Map::AddPtr p = map_.lookupForAdd(script);
+    if (!p && !map_.add(p, script, ScriptCounts())) {
+        return nullptr;
+    }
+    return &p->value();
+}
+
+void
+BailoutCounts::recordBailout(JSScript* script, jsbytecode* pc, BailoutKind kind)
+{
+    LockGuard<Mutex> guard(lock_);
+
+    ScriptCounts* counts = lookupOrAdd(script, guard);
+    if (!counts) {
+        return;
+    }
+
+    uint32_t pcOffset = script->pcToOffset(pc);
+    for (Site& site : counts->sites) {
+        if (site.pcOffset == pcOffset && site.kind == kind) {
+            if (site.count < UINT32_MAX) {
+                site.count++;
+            }
+            return;
+        }
+    }
+
+    // Ignore OOM, the count is only a heuristic.
+    (void) counts->sites.append(Site { pcOffset, kind, 1 });
+}
+
+void
+BailoutCounts::recordInvalidation(JSScript* script)
+{
+    LockGuard<Mutex> guard(lock_);
+
+    ScriptCounts* counts = lookupOrAdd(script, guard);
+    if (counts && counts->invalidations < UINT32_MAX) {
+        counts->invalidations++;
+    }
+}
+
+bool
+BailoutCounts::hasFrequentBailoutSite(JSScript* script, uint32_t beginOffset, uint32_t endOffset)
+{
+    LockGuard<Mutex> guard(lock_);
+
+    Map::Ptr p = map_.lookup(script);
+    if (!p) {
+        return false;
+    }
+
+    for (const Site& site : p->value().sites) {
+        if (site.pcOffset >= beginOffset && site.pcOffset <= endOffset &&
+            site.count >= JitOptions.frequentBailoutSiteThreshold &&
+            IsSpeculationFailure(site.kind))
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+BailoutCounts::iterate(BailoutSiteCallback siteCallback, InvalidationCallback invalidationCallback,
+                       void* data)
+{
+    LockGuard<Mutex> guard(lock_);
+
+    for (Map::Range r = map_.all(); !r.empty(); r.popFront()) {
+        JSScript* script = r.front().key();
+        const ScriptCounts& counts = r.front().value();
+        if (siteCallback) {
+            for (const Site& site : counts.sites) {
+                siteCallback(data, script, site.pcOffset, BailoutKindString(site.kind),
+                             site.count);
+            }
+        }
+        if (invalidationCallback && counts.invalidations) {
+            invalidationCallback(data, script, counts.invalidations);
+        }
+    }
+}
+
+void
+BailoutCounts::sweep()
+{
+    LockGuard<Mutex> guard(lock_);
+
+    // This is also called after compacting GC, when it updates the keys of
+    // scripts which have moved.
+    for (Map::Enum e(map_); !e.empty(); e.popFront()) {
+        JSScript* script = e.front().key();
+        if (IsAboutToBeFinalizedUnbarriered(&script)) {
+            e.removeFront();
+        } else if (script != e.front().key()) {
+            e.rekeyFront(script);
+        }
+    }
+}
+
+size_t
+BailoutCounts::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const
+{
+    LockGuard<Mutex> guard(lock_);
+
+    size_t n = map_.shallowSizeOfExcludingThis(mallocSizeOf);
+    for (Map::Range r = map_.all(); !r.empty(); r.popFront()) {
+        n += r.front().value().sites.sizeOfExcludingThis(mallocSizeOf);
+    }
+    return n;
+}
+
+JS_FRIEND_API(void)
+js::IterateBailoutCounts(JSContext* cx, void* data, BailoutSiteCallback siteCallback,
+                         InvalidationCallback invalidationCallback)
+{
+    JS::AutoCheckCannotGC nogc(cx);
+
+    for (ZonesIter zone(cx->runtime(), SkipAtoms); !zone.done(); zone.next()) {
+        if (JitZone* jitZone = zone->jitZone()) {
+            jitZone->bailoutCounts().iterate(siteCallback, invalidationCallback, data);
+        }
+    }
+}
@@ -0,0 +1,85 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef jit_BailoutCounts_h
+#define jit_BailoutCounts_h
+
+#include "mozilla/MemoryReporting.h"
+
+#include "jsfriendapi.h"
+
+#include "jit/IonTypes.h"
+#include "js/AllocPolicy.h"
+#include "js/HashTable.h"
+#include "js/TypeDecls.h"
+#include "js/Vector.h"
+#include "threading/LockGuard.h"
+#include "vm/MutexIDs.h"
+
+namespace js {
+namespace jit {
+
+// Counts of the bailouts and invalidations of the Ion code for the scripts in
+// a zone. Bailouts are keyed by the script and bytecode offset they resumed
+// at and by their BailoutKind. Unlike IonScript::numBailouts, the counts are
+// kept across recompilations, so Ion can use them to stop making the
+// speculations which keep failing at a particular site.
+//
+// Counts are updated on the main thread and read by off thread Ion
+// compilations, so all accesses take the lock. Entries for dead scripts are
+// removed when the zone is swept.
+class BailoutCounts
+{
+    struct Site
+    {
+        uint32_t pcOffset;
+        BailoutKind kind;
+        uint32_t count;
+    };
+
+    struct ScriptCounts
+    {
+        Vector<Site, 1, SystemAllocPolicy> sites;
+        uint32_t invalidations;
+
+        ScriptCounts()
+          : invalidations(0)
+        {}
+    };
+
+    using Map = HashMap<JSScript*, ScriptCounts, DefaultHasher<JSScript*>, SystemAllocPolicy>;
+
+    mutable Mutex lock_;
+    Map map_;
+
+    // Returns nullptr on OOM, in which case the event is not counted.
+    ScriptCounts* lookupOrAdd(JSScript* script, const LockGuard<Mutex>& lock);
+
+  public:
+    BailoutCounts()
+      : lock_(mutexid::JitBailoutCounts)
+    {}
+
+    void recordBailout(JSScript* script, jsbytecode* pc, BailoutKind kind);
+    void recordInvalidation(JSScript* script);
+
+    // Whether a bailout with a kind that indicates a failed speculation has
+    // happened at least JitOptions.frequentBailoutSiteThreshold times at a
+    // bytecode offset of |script| in [beginOffset, endOffset].
+    bool hasFrequentBailoutSite(JSScript* script, uint32_t beginOffset, uint32_t endOffset);
+
+    void iterate(BailoutSiteCallback siteCallback, InvalidationCallback invalidationCallback,
+                 void* data);
+
+    void sweep();
+
+    size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
+};
+
+} // namespace jit
+} // namespace js
+
+#endif /* jit_BailoutCounts_h */
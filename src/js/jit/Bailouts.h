@@ -175,19 +175,39 @@ class ExceptionBailoutInfo
     jsbytecode* resumePC_;
     size_t numExprSlots_;
 
+    // When resuming in a finally block, the exception which Baseline expects
+    // on top of the expression stack, above |true|.
+    bool resumingInFinally_;
+    Value finallyException_;
+
   public:
     ExceptionBailoutInfo(size_t frameNo, jsbytecode* resumePC, size_t numExprSlots)
       : frameNo_(frameNo),
         resumePC_(resumePC),
-        numExprSlots_(numExprSlots)
+        numExprSlots_(numExprSlots),
+        resumingInFinally_(false)
     { }
 
     ExceptionBailoutInfo()
       : frameNo_(0),
         resumePC_(nullptr),
-        numExprSlots_(0)
+        numExprSlots_(0),
+        resumingInFinally_(false)
     { }
 
+    void setFinallyException(const Value& exception) {
+        MOZ_ASSERT(catchingException());
+        resumingInFinally_ = true;
+        finallyException_ = exception;
+    }
+    bool resumingInFinally() const {
+        return resumingInFinally_;
+    }
+    const Value& finallyException() const {
+        MOZ_ASSERT(resumingInFinally());
+        return finallyException_;
+    }
+
     bool catchingException() const {
         return !!resumePC_;
     }
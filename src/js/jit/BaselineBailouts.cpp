@@ -13,6 +13,7 @@
 #include "jit/BaselineIC.h"
 #include "jit/BaselineJIT.h"
 #include "jit/CompileInfo.h"
+#include "jit/JitRealm.h"
 #include "jit/JitSpewer.h"
 #include "jit/mips32/Simulator-mips32.h"
 #include "jit/mips64/Simulator-mips64.h"
@@ -1023,6 +1024,18 @@ InitFromBailout(JSContext* cx, size_t frameNo,
         }
     }
 
+    // When resuming in a finally block, push the same values the exception
+    // handler pushes for Baseline frames: |true| and the exception.
+    if (catchingException && excInfo->resumingInFinally()) {
+        JitSpew(JitSpew_BaselineBailouts, "      pushing finally block operands");
+        if (!builder.writeValue(BooleanValue(true), "StackValue")) {
+            return false;
+        }
+        if (!builder.writeValue(excInfo->finallyException(), "StackValue")) {
+            return false;
+        }
+    }
+
     // BaselineFrame::frameSize is the size of everything pushed since
     // the builder.resetFramePushed() call.
     uint32_t frameSize = builder.framePushed();
@@ -1082,6 +1095,12 @@ InitFromBailout(JSContext* cx, size_t frameNo,
                 // Note that none of that was pushed, but it's still reflected
                 // in exprStackSlots.
                 MOZ_ASSERT(exprStackSlots - expectedDepth == 1);
+            } else if (catchingException && excInfo->resumingInFinally()) {
+                // The two finally block operands are pushed on top of the
+                // expression stack before JSOP_FINALLY accounts for them.
+                MOZ_ASSERT(exprStackSlots == expectedDepth);
+                MOZ_ASSERT(blFrame->numValueSlots() ==
+                           script->nfixed() + expectedDepth + 2);
             } else {
                 // For fun.apply({}, arguments) the reconstructStackDepth will
                 // have stackdepth 4, but it could be that we inlined the
@@ -2090,9 +2109,10 @@ jit::FinishBailoutToBaseline(BaselineBailoutInfo* bailoutInfo)
         act->removeRematerializedFrame(outerFp);
     }
 
-    // If we are catching an exception, we need to unwind scopes.
+    // If we are catching an exception, we need to unwind scopes. The
+    // exception is no longer pending if we are resuming in a finally block.
     // See |SettleOnTryNote|
-    if (cx->isExceptionPending() && faultPC) {
+    if (faultPC) {
         EnvironmentIter ei(cx, topFrame, faultPC);
         UnwindEnvironment(cx, ei, tryPC);
     }
@@ -2103,6 +2123,12 @@ jit::FinishBailoutToBaseline(BaselineBailoutInfo* bailoutInfo)
             innerScript->filename(), innerScript->lineno(), innerScript->column(), innerScript->getWarmUpCount(),
             (unsigned) bailoutKind);
 
+    // Record the bailout before handling it, as the handlers below may
+    // invalidate the script.
+    innerScript->zone()->jitZone()->bailoutCounts().recordBailout(innerScript,
+                                                                  topFrame->overridePc(),
+                                                                  bailoutKind);
+
     switch (bailoutKind) {
       // Normal bailouts.
       case Bailout_Inevitable:
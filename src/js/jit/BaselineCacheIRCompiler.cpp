@@ -12,6 +12,7 @@
 #include "jit/VMFunctions.h"
 #include "proxy/DeadObjectProxy.h"
 #include "proxy/Proxy.h"
+#include "proxy/ScriptedProxyHandler.h"
 
 #include "jit/MacroAssembler-inl.h"
 #include "jit/SharedICHelpers-inl.h"
@@ -142,7 +143,11 @@ BaselineCacheIRCompiler::callVM(MacroAssembler& masm, const VMFunction& fun)
 {
     MOZ_ASSERT(inStubFrame_);
 
-    TrampolinePtr code = cx_->runtime()->jitRuntime()->getVMWrapper(fun);
+    JitRuntime* jitRuntime = cx_->runtime()->jitRuntime();
+    if (!jitRuntime->ensureVMWrapper(cx_, fun)) {
+        return false;
+    }
+    TrampolinePtr code = jitRuntime->getVMWrapper(fun);
     MOZ_ASSERT(fun.expectTailCall == NonTailCall);
 
     EmitBaselineCallVM(code, masm);
@@ -154,7 +159,11 @@ BaselineCacheIRCompiler::tailCallVM(MacroAssembler& masm, const VMFunction& fun)
 {
     MOZ_ASSERT(!inStubFrame_);
 
-    TrampolinePtr code = cx_->runtime()->jitRuntime()->getVMWrapper(fun);
+    JitRuntime* jitRuntime = cx_->runtime()->jitRuntime();
+    if (!jitRuntime->ensureVMWrapper(cx_, fun)) {
+        return false;
+    }
+    TrampolinePtr code = jitRuntime->getVMWrapper(fun);
     MOZ_ASSERT(fun.expectTailCall == TailCall);
     size_t argSize = fun.explicitStackSlots() * sizeof(void*);
 
@@ -631,6 +640,115 @@ BaselineCacheIRCompiler::emitCallProxyGetResult()
     return true;
 }
 
+bool
+BaselineCacheIRCompiler::emitCallScriptedProxyGetResult()
+{
+    Register proxy = allocator.useRegister(masm, reader.objOperandId());
+    Address targetAddr(stubAddress(reader.stubOffset()));
+    Address idAddr(stubAddress(reader.stubOffset()));
+    bool isSymbol = reader.readBool();
+    Address trapAddr(stubAddress(reader.stubOffset()));
+    Address targetShapeAddr(stubAddress(reader.stubOffset()));
+    bool isCrossRealm = reader.readBool();
+
+    AutoScratchRegister code(allocator, masm);
+    AutoScratchRegister callee(allocator, masm);
+    AutoScratchRegister scratch(allocator, masm);
+
+    // First, ensure the trap is non-lazy.
+    {
+        FailurePath* failure;
+        if (!addFailurePath(&failure)) {
+            return false;
+        }
+
+        masm.loadPtr(trapAddr, callee);
+        masm.branchIfFunctionHasNoJitEntry(callee, /* constructing */ false, failure->label());
+        masm.loadJitCodeRaw(callee, code);
+    }
+
+    allocator.discardStack(masm);
+
+    AutoStubFrame stubFrame(*this);
+    stubFrame.enter(masm, scratch);
+
+    if (isCrossRealm) {
+        masm.switchToObjectRealm(callee, scratch);
+    }
+
+    // Align the stack such that the JitFrameLayout is aligned on
+    // JitStackAlignment.
+    masm.alignJitStackBasedOnNArgs(3);
+
+    // The trap is called as handler.get(target, key, receiver).
+    masm.Push(TypedOrValueRegister(MIRType::Object, AnyRegister(proxy)));
+
+    masm.loadPtr(idAddr, scratch);
+    if (isSymbol) {
+        masm.andPtr(Imm32(~JSID_TYPE_MASK), scratch);
+    }
+    MIRType keyType = isSymbol ? MIRType::Symbol : MIRType::String;
+    masm.Push(TypedOrValueRegister(keyType, AnyRegister(scratch)));
+
+    masm.loadPtr(targetAddr, scratch);
+    masm.Push(TypedOrValueRegister(MIRType::Object, AnyRegister(scratch)));
+
+    masm.loadPtr(Address(proxy, ProxyObject::offsetOfReservedSlots()), scratch);
+    masm.unboxObject(Address(scratch, detail::ProxyReservedSlots::offsetOfSlot(
+                                          ScriptedProxyHandler::HANDLER_EXTRA)),
+                     scratch);
+    masm.Push(TypedOrValueRegister(MIRType::Object, AnyRegister(scratch)));
+
+    EmitBaselineCreateStubFrameDescriptor(masm, scratch, JitFrameLayout::Size());
+    masm.Push(Imm32(3));  // ActualArgc is 3
+    masm.Push(callee);
+    masm.Push(scratch);
+
+    // Handle arguments underflow.
+    Label noUnderflow;
+    masm.load16ZeroExtend(Address(callee, JSFunction::offsetOfNargs()), callee);
+    masm.branch32(Assembler::BelowOrEqual, callee, Imm32(3), &noUnderflow);
+    {
+        // Call the arguments rectifier.
+        TrampolinePtr argumentsRectifier = cx_->runtime()->jitRuntime()->getArgumentsRectifier();
+        masm.movePtr(argumentsRectifier, code);
+    }
+
+    masm.bind(&noUnderflow);
+    masm.callJit(code);
+
+    stubFrame.leave(masm, true);
+
+    if (isCrossRealm) {
+        masm.switchToBaselineFrameRealm(R1.scratchReg());
+    }
+
+    // The IR generator checked that the target had no property the result
+    // must agree with. Unless the trap changed the target, that still holds.
+    Label done;
+    masm.loadPtr(targetAddr, R1.scratchReg());
+    masm.loadPtr(Address(R1.scratchReg(), ShapedObject::offsetOfShape()), R1.scratchReg());
+    masm.branchPtr(Assembler::Equal, targetShapeAddr, R1.scratchReg(), &done);
+    {
+        AutoStubFrame checkFrame(*this);
+        checkFrame.enter(masm, R1.scratchReg());
+
+        masm.Push(JSReturnOperand);
+        masm.loadPtr(idAddr, R1.scratchReg());
+        masm.Push(R1.scratchReg());
+        masm.loadPtr(targetAddr, R1.scratchReg());
+        masm.Push(R1.scratchReg());
+
+        if (!callVM(masm, CheckProxyGetResultInfo)) {
+            return false;
+        }
+
+        checkFrame.leave(masm);
+    }
+    masm.bind(&done);
+    return true;
+}
+
 bool
 BaselineCacheIRCompiler::emitCallProxyGetByValueResult()
 {
@@ -21,6 +21,7 @@
 #include "jit/SharedICHelpers.h"
 #include "jit/VMFunctions.h"
 #include "js/UniquePtr.h"
+#include "vm/ArgumentsObject.h"
 #include "vm/AsyncFunction.h"
 #include "vm/AsyncIteration.h"
 #include "vm/EnvironmentObject.h"
@@ -69,6 +70,7 @@ BaselineCompiler::BaselineCompiler(JSContext* cx, TempAllocator& alloc, JSScript
 #ifdef JS_CODEGEN_NONE
     MOZ_CRASH();
 #endif
+    masm.setSpectreMitigations(SpectreMitigations(script->zone()->jitSpectreMitigations()));
 }
 
 bool
@@ -505,6 +507,10 @@ BaselineCompiler::emitPrologue()
         return false;
     }
 
+    // Mark the script's JIT code as recently used.
+    masm.movePtr(ImmGCPtr(script), R2.scratchReg());
+    masm.store8(Imm32(0), Address(R2.scratchReg(), JSScript::offsetOfJitCodeAge()));
+
     if (!emitWarmUpCounterIncrement()) {
         return false;
     }
@@ -613,7 +619,11 @@ BaselineCompiler::prepareVMCall()
 bool
 BaselineCompiler::callVM(const VMFunction& fun, CallVMPhase phase)
 {
-    TrampolinePtr code = cx->runtime()->jitRuntime()->getVMWrapper(fun);
+    JitRuntime* jitRuntime = cx->runtime()->jitRuntime();
+    if (!jitRuntime->ensureVMWrapper(cx, fun)) {
+        return false;
+    }
+    TrampolinePtr code = jitRuntime->getVMWrapper(fun);
 
 #ifdef DEBUG
     // Assert prepareVMCall() has been called.
@@ -3768,7 +3778,7 @@ BaselineCompiler::emit_JSOP_STRICTSPREADEVAL()
 }
 
 typedef bool (*OptimizeSpreadCallFn)(JSContext*, HandleValue, bool*);
-static const VMFunction OptimizeSpreadCallInfo =
+const VMFunction jit::OptimizeSpreadCallInfo =
     FunctionInfo<OptimizeSpreadCallFn>(OptimizeSpreadCall, "OptimizeSpreadCall");
 
 bool
@@ -3789,6 +3799,30 @@ BaselineCompiler::emit_JSOP_OPTIMIZE_SPREADCALL()
     return true;
 }
 
+typedef bool (*OptimizeArrayDestructuringFn)(JSContext*, HandleValue, uint32_t, bool*);
+const VMFunction jit::OptimizeArrayDestructuringInfo =
+    FunctionInfo<OptimizeArrayDestructuringFn>(OptimizeArrayDestructuring,
+                                               "OptimizeArrayDestructuring");
+
+bool
+BaselineCompiler::emit_JSOP_OPTIMIZE_DESTRUCTURING()
+{
+    frame.syncStack(0);
+    masm.loadValue(frame.addressOfStackValue(frame.peek(-1)), R0);
+
+    prepareVMCall();
+    pushArg(Imm32(GET_UINT32(pc)));
+    pushArg(R0);
+
+    if (!callVM(OptimizeArrayDestructuringInfo)) {
+        return false;
+    }
+
+    masm.boxNonDouble(JSVAL_TYPE_BOOLEAN, ReturnReg, R0);
+    frame.push(R0);
+    return true;
+}
+
 typedef bool (*ImplicitThisFn)(JSContext*, HandleObject, HandlePropertyName,
                                MutableHandleValue);
 const VMFunction jit::ImplicitThisInfo =
@@ -4731,6 +4765,53 @@ BaselineCompiler::emit_JSOP_ARGUMENTS()
                           Imm32(BaselineScript::NEEDS_ARGS_OBJ), &done);
     }
 
+    // Unless the arguments object has to forward formals to the call object,
+    // allocate it inline and fill it in from the frame's actual arguments, as
+    // Ion does in visitCreateArgumentsObject.
+    JSFunction* fun = script->functionNonDelazifying();
+    if (!fun->needsCallObject() || !script->argumentsAliasesFormals()) {
+        ArgumentsObject* templateObj =
+            cx->realm()->getOrCreateArgumentsTemplateObject(cx, script->hasMappedArgsObj());
+        if (!templateObj) {
+            return false;
+        }
+
+        AllocatableGeneralRegisterSet regs(GeneralRegisterSet::All());
+        regs.take(BaselineFrameReg);
+        Register obj = regs.takeAny();
+        Register temp = regs.takeAny();
+        Register envChain = regs.takeAny();
+        Register scratch = regs.takeAny();
+
+        // The reserved slots are left uninitialized, so we must not GC until
+        // ArgumentsObject::finishForIonPure has initialized them.
+        Label failure;
+        masm.createGCObject(obj, temp, TemplateObject(templateObj), gc::DefaultHeap, &failure,
+                            /* initContents = */ false);
+
+        masm.loadPtr(frame.addressOfEnvironmentChain(), envChain);
+        masm.computeEffectiveAddress(Address(BaselineFrameReg, BaselineFrame::FramePointerOffset),
+                                     temp);
+
+        masm.Push(BaselineFrameReg);
+        masm.setupUnalignedABICall(scratch);
+        masm.loadJSContext(scratch);
+        masm.passABIArg(scratch);
+        masm.passABIArg(temp);
+        masm.passABIArg(envChain);
+        masm.passABIArg(obj);
+        masm.callWithABI(JS_FUNC_TO_DATA_PTR(void*, ArgumentsObject::finishForIonPure));
+        masm.Pop(BaselineFrameReg);
+        masm.branchTestPtr(Assembler::Zero, ReturnReg, ReturnReg, &failure);
+
+        masm.storePtr(ReturnReg, frame.addressOfArgsObj());
+        masm.or32(Imm32(BaselineFrame::HAS_ARGS_OBJ), frame.addressOfFlags());
+        masm.tagValue(JSVAL_TYPE_OBJECT, ReturnReg, R0);
+        masm.jump(&done);
+
+        masm.bind(&failure);
+    }
+
     prepareVMCall();
 
     masm.loadBaselineFramePtr(BaselineFrameReg, R0.scratchReg());
@@ -5175,7 +5256,11 @@ BaselineCompiler::emit_JSOP_RESUME()
         pushArg(genObj);
         pushArg(scratch2);
 
-        TrampolinePtr code = cx->runtime()->jitRuntime()->getVMWrapper(GeneratorThrowOrReturnInfo);
+        JitRuntime* jitRuntime = cx->runtime()->jitRuntime();
+        if (!jitRuntime->ensureVMWrapper(cx, GeneratorThrowOrReturnInfo)) {
+            return false;
+        }
+        TrampolinePtr code = jitRuntime->getVMWrapper(GeneratorThrowOrReturnInfo);
 
         // Create the frame descriptor.
         masm.subStackPtrFrom(scratch1);
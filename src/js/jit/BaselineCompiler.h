@@ -165,6 +165,7 @@ namespace jit {
     _(JSOP_SPREADEVAL)         \
     _(JSOP_STRICTSPREADEVAL)   \
     _(JSOP_OPTIMIZE_SPREADCALL)\
+    _(JSOP_OPTIMIZE_DESTRUCTURING) \
     _(JSOP_IMPLICITTHIS)       \
     _(JSOP_GIMPLICITTHIS)      \
     _(JSOP_INSTANCEOF)         \
@@ -513,6 +514,8 @@ class BaselineCompiler final
 
 extern const VMFunction NewArrayCopyOnWriteInfo;
 extern const VMFunction ImplicitThisInfo;
+extern const VMFunction OptimizeSpreadCallInfo;
+extern const VMFunction OptimizeArrayDestructuringInfo;
 
 } // namespace jit
 } // namespace js
@@ -212,6 +212,21 @@ ICStub::makesGCCalls() const
     }
 }
 
+const CacheIRStubInfo*
+ICStub::cacheIRStubInfo() const
+{
+    switch (kind()) {
+      case CacheIR_Regular:
+        return toCacheIR_Regular()->stubInfo();
+      case CacheIR_Monitored:
+        return toCacheIR_Monitored()->stubInfo();
+      case CacheIR_Updated:
+        return toCacheIR_Updated()->stubInfo();
+      default:
+        return nullptr;
+    }
+}
+
 void
 ICStub::traceCode(JSTracer* trc, const char* name)
 {
@@ -454,6 +469,7 @@ DoWarmUpCounterFallbackOSR(JSContext* cx, BaselineFrame* frame, ICWarmUpCounter_
     jsbytecode* pc = stub->icEntry()->pc(script);
     MOZ_ASSERT(JSOp(*pc) == JSOP_LOOPENTRY);
 
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "WarmUpCounter(%d)", int(script->pcToOffset(pc)));
 
     if (!IonCompileScriptForBaseline(cx, frame, pc)) {
@@ -770,6 +786,7 @@ ICStubCompiler::getStubCode()
     // Compile new stubcode.
     JitContext jctx(cx, nullptr);
     StackMacroAssembler masm;
+    masm.setSpectreMitigations(SpectreMitigations(cx->zone()->jitSpectreMitigations()));
 #ifndef JS_USE_LINK_REGISTER
     // The first value contains the return addres,
     // which we pull into ICTailCallReg for tail calls.
@@ -811,7 +828,11 @@ ICStubCompiler::getStubCode()
 bool
 ICStubCompiler::tailCallVM(const VMFunction& fun, MacroAssembler& masm)
 {
-    TrampolinePtr code = cx->runtime()->jitRuntime()->getVMWrapper(fun);
+    JitRuntime* jitRuntime = cx->runtime()->jitRuntime();
+    if (!jitRuntime->ensureVMWrapper(cx, fun)) {
+        return false;
+    }
+    TrampolinePtr code = jitRuntime->getVMWrapper(fun);
     MOZ_ASSERT(fun.expectTailCall == TailCall);
     uint32_t argSize = fun.explicitStackSlots() * sizeof(void*);
     EmitBaselineTailCallVM(code, masm, argSize);
@@ -823,7 +844,11 @@ ICStubCompiler::callVM(const VMFunction& fun, MacroAssembler& masm)
 {
     MOZ_ASSERT(inStubFrame_);
 
-    TrampolinePtr code = cx->runtime()->jitRuntime()->getVMWrapper(fun);
+    JitRuntime* jitRuntime = cx->runtime()->jitRuntime();
+    if (!jitRuntime->ensureVMWrapper(cx, fun)) {
+        return false;
+    }
+    TrampolinePtr code = jitRuntime->getVMWrapper(fun);
     MOZ_ASSERT(fun.expectTailCall == NonTailCall);
 
     EmitBaselineCallVM(code, masm);
@@ -1607,6 +1632,7 @@ static bool
 DoToBoolFallback(JSContext* cx, BaselineFrame* frame, ICToBool_Fallback* stub, HandleValue arg,
                  MutableHandleValue ret)
 {
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "ToBool");
 
     MOZ_ASSERT(!arg.isBoolean());
@@ -1647,6 +1673,7 @@ ICToBool_Fallback::Compiler::generateStubCode(MacroAssembler& masm)
 static bool
 DoToNumberFallback(JSContext* cx, ICToNumber_Fallback* stub, HandleValue arg, MutableHandleValue ret)
 {
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "ToNumber");
     ret.set(arg);
     return ToNumber(cx, ret);
@@ -1714,6 +1741,7 @@ DoGetElemFallback(JSContext* cx, BaselineFrame* frame, ICGetElem_Fallback* stub_
     StackTypeSet* types = TypeScript::BytecodeTypes(script, pc);
 
     JSOp op = JSOp(*pc);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "GetElem(%s)", CodeName[op]);
 
     MOZ_ASSERT(op == JSOP_GETELEM || op == JSOP_CALLELEM);
@@ -1806,6 +1834,7 @@ DoGetElemSuperFallback(JSContext* cx, BaselineFrame* frame, ICGetElem_Fallback*
     StackTypeSet* types = TypeScript::BytecodeTypes(script, pc);
 
     JSOp op = JSOp(*pc);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "GetElemSuper(%s)", CodeName[op]);
 
     MOZ_ASSERT(op == JSOP_GETELEM_SUPER);
@@ -1944,6 +1973,7 @@ DoSetElemFallback(JSContext* cx, BaselineFrame* frame, ICSetElem_Fallback* stub_
     RootedScript outerScript(cx, script);
     jsbytecode* pc = stub->icEntry()->pc(script);
     JSOp op = JSOp(*pc);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "SetElem(%s)", CodeName[JSOp(*pc)]);
 
     MOZ_ASSERT(op == JSOP_SETELEM ||
@@ -2238,6 +2268,7 @@ DoInFallback(JSContext* cx, BaselineFrame* frame, ICIn_Fallback* stub_,
     // This fallback stub may trigger debug mode toggling.
     DebugModeOSRVolatileStub<ICIn_Fallback*> stub(frame, stub_);
 
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "In");
 
     if (!objValue.isObject()) {
@@ -2291,6 +2322,7 @@ DoHasOwnFallback(JSContext* cx, BaselineFrame* frame, ICHasOwn_Fallback* stub_,
     // This fallback stub may trigger debug mode toggling.
     DebugModeOSRVolatileStub<ICIn_Fallback*> stub(frame, stub_);
 
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "HasOwn");
 
     TryAttachStub<HasPropIRGenerator>("HasOwn", cx, frame, stub,
@@ -2344,6 +2376,7 @@ DoGetNameFallback(JSContext* cx, BaselineFrame* frame, ICGetName_Fallback* stub_
     RootedScript script(cx, frame->script());
     jsbytecode* pc = stub->icEntry()->pc(script);
     mozilla::DebugOnly<JSOp> op = JSOp(*pc);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "GetName(%s)", CodeName[JSOp(*pc)]);
 
     MOZ_ASSERT(op == JSOP_GETNAME || op == JSOP_GETGNAME);
@@ -2409,6 +2442,7 @@ DoBindNameFallback(JSContext* cx, BaselineFrame* frame, ICBindName_Fallback* stu
 {
     jsbytecode* pc = stub->icEntry()->pc(frame->script());
     mozilla::DebugOnly<JSOp> op = JSOp(*pc);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "BindName(%s)", CodeName[JSOp(*pc)]);
 
     MOZ_ASSERT(op == JSOP_BINDNAME || op == JSOP_BINDGNAME);
@@ -2459,6 +2493,7 @@ DoGetIntrinsicFallback(JSContext* cx, BaselineFrame* frame, ICGetIntrinsic_Fallb
     RootedScript script(cx, frame->script());
     jsbytecode* pc = stub->icEntry()->pc(script);
     mozilla::DebugOnly<JSOp> op = JSOp(*pc);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "GetIntrinsic(%s)", CodeName[JSOp(*pc)]);
 
     MOZ_ASSERT(op == JSOP_GETINTRINSIC);
@@ -2546,6 +2581,7 @@ DoGetPropFallback(JSContext* cx, BaselineFrame* frame, ICGetProp_Fallback* stub_
     RootedScript script(cx, frame->script());
     jsbytecode* pc = stub_->icEntry()->pc(script);
     JSOp op = JSOp(*pc);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "GetProp(%s)", CodeName[op]);
 
     MOZ_ASSERT(op == JSOP_GETPROP ||
@@ -2617,6 +2653,7 @@ DoGetPropSuperFallback(JSContext* cx, BaselineFrame* frame, ICGetProp_Fallback*
 
     RootedScript script(cx, frame->script());
     jsbytecode* pc = stub_->icEntry()->pc(script);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "GetPropSuper(%s)", CodeName[JSOp(*pc)]);
 
     MOZ_ASSERT(JSOp(*pc) == JSOP_GETPROP_SUPER);
@@ -2765,6 +2802,7 @@ DoSetPropFallback(JSContext* cx, BaselineFrame* frame, ICSetProp_Fallback* stub_
     RootedScript script(cx, frame->script());
     jsbytecode* pc = stub->icEntry()->pc(script);
     JSOp op = JSOp(*pc);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "SetProp(%s)", CodeName[op]);
 
     MOZ_ASSERT(op == JSOP_SETPROP ||
@@ -3597,6 +3635,7 @@ DoCallFallback(JSContext* cx, BaselineFrame* frame, ICCall_Fallback* stub_, uint
     RootedScript script(cx, frame->script());
     jsbytecode* pc = stub->icEntry()->pc(script);
     JSOp op = JSOp(*pc);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "Call(%s)", CodeName[op]);
 
     MOZ_ASSERT(argc == GET_ARGC(pc));
@@ -3736,6 +3775,7 @@ DoSpreadCallFallback(JSContext* cx, BaselineFrame* frame, ICCall_Fallback* stub_
     jsbytecode* pc = stub->icEntry()->pc(script);
     JSOp op = JSOp(*pc);
     bool constructing = (op == JSOP_SPREADNEW || op == JSOP_SPREADSUPERCALL);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "SpreadCall(%s)", CodeName[op]);
 
     // Ensure vp array is rooted - we may GC in here.
@@ -4269,6 +4309,12 @@ ICCallScriptedCompiler::generateStubCode(MacroAssembler& masm)
         }
     }
 
+    // Count the call, for the inliner's choice of targets.
+    size_t enteredCountOffset = callee_
+                                ? ICCall_Scripted::offsetOfEnteredCount()
+                                : ICCall_AnyScripted::offsetOfEnteredCount();
+    masm.add32(Imm32(1), Address(ICStubReg, enteredCountOffset));
+
     // Load the start of the target JitCode.
     Register code;
     if (!isConstructing_) {
@@ -4659,6 +4705,9 @@ ICCall_Native::Compiler::generateStubCode(MacroAssembler& masm)
     Address expectedCallee(ICStubReg, ICCall_Native::offsetOfCallee());
     masm.branchPtr(Assembler::NotEqual, expectedCallee, callee, &failure);
 
+    // Count the call, for the inliner's choice of targets.
+    masm.add32(Imm32(1), Address(ICStubReg, ICCall_Native::offsetOfEnteredCount()));
+
     regs.add(R1);
     regs.takeUnchecked(callee);
 
@@ -5264,6 +5313,7 @@ static bool
 DoGetIteratorFallback(JSContext* cx, BaselineFrame* frame, ICGetIterator_Fallback* stub,
                       HandleValue value, MutableHandleValue res)
 {
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "GetIterator");
 
     TryAttachStub<GetIteratorIRGenerator>("GetIterator", cx, frame, stub, BaselineCacheIRStubKind::Regular, value);
@@ -5309,6 +5359,7 @@ DoIteratorMoreFallback(JSContext* cx, BaselineFrame* frame, ICIteratorMore_Fallb
     // This fallback stub may trigger debug mode toggling.
     DebugModeOSRVolatileStub<ICIteratorMore_Fallback*> stub(frame, stub_);
 
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "IteratorMore");
 
     if (!IteratorMore(cx, iterObj, res)) {
@@ -5410,6 +5461,7 @@ ICIteratorMore_Native::Compiler::generateStubCode(MacroAssembler& masm)
 static void
 DoIteratorCloseFallback(JSContext* cx, ICIteratorClose_Fallback* stub, HandleValue iterValue)
 {
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "IteratorClose");
 
     CloseIterator(&iterValue.toObject());
@@ -5442,6 +5494,7 @@ DoInstanceOfFallback(JSContext* cx, BaselineFrame* frame, ICInstanceOf_Fallback*
     // This fallback stub may trigger debug mode toggling.
     DebugModeOSRVolatileStub<ICInstanceOf_Fallback*> stub(frame, stub_);
 
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "InstanceOf");
 
     if (!rhs.isObject()) {
@@ -5509,6 +5562,7 @@ static bool
 DoTypeOfFallback(JSContext* cx, BaselineFrame* frame, ICTypeOf_Fallback* stub, HandleValue val,
                  MutableHandleValue res)
 {
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "TypeOf");
 
     TryAttachStub<TypeOfIRGenerator>("TypeOf", cx, frame, stub, BaselineCacheIRStubKind::Regular, val);
@@ -5540,6 +5594,7 @@ static bool
 DoRetSubFallback(JSContext* cx, BaselineFrame* frame, ICRetSub_Fallback* stub,
                  HandleValue val, uint8_t** resumeAddr)
 {
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "RetSub");
 
     // |val| is the bytecode offset where we should resume.
@@ -5670,22 +5725,33 @@ ICCall_Scripted::ICCall_Scripted(JitCode* stubCode, ICStub* firstMonitorStub,
   : ICMonitoredStub(ICStub::Call_Scripted, stubCode, firstMonitorStub),
     callee_(callee),
     templateObject_(templateObject),
-    pcOffset_(pcOffset)
+    pcOffset_(pcOffset),
+    enteredCount_(0)
 { }
 
 /* static */ ICCall_Scripted*
 ICCall_Scripted::Clone(JSContext* cx, ICStubSpace* space, ICStub* firstMonitorStub,
                        ICCall_Scripted& other)
 {
-    return New<ICCall_Scripted>(cx, space, other.jitCode(), firstMonitorStub, other.callee_,
-                                other.templateObject_, other.pcOffset_);
+    ICCall_Scripted* res = New<ICCall_Scripted>(cx, space, other.jitCode(), firstMonitorStub,
+                                                other.callee_, other.templateObject_,
+                                                other.pcOffset_);
+    if (res) {
+        res->enteredCount_ = other.enteredCount_;
+    }
+    return res;
 }
 
 /* static */ ICCall_AnyScripted*
 ICCall_AnyScripted::Clone(JSContext* cx, ICStubSpace* space, ICStub* firstMonitorStub,
                           ICCall_AnyScripted& other)
 {
-    return New<ICCall_AnyScripted>(cx, space, other.jitCode(), firstMonitorStub, other.pcOffset_);
+    ICCall_AnyScripted* res = New<ICCall_AnyScripted>(cx, space, other.jitCode(),
+                                                      firstMonitorStub, other.pcOffset_);
+    if (res) {
+        res->enteredCount_ = other.enteredCount_;
+    }
+    return res;
 }
 
 ICCall_Native::ICCall_Native(JitCode* stubCode, ICStub* firstMonitorStub,
@@ -5694,7 +5760,8 @@ ICCall_Native::ICCall_Native(JitCode* stubCode, ICStub* firstMonitorStub,
   : ICMonitoredStub(ICStub::Call_Native, stubCode, firstMonitorStub),
     callee_(callee),
     templateObject_(templateObject),
-    pcOffset_(pcOffset)
+    pcOffset_(pcOffset),
+    enteredCount_(0)
 {
 #ifdef JS_SIMULATOR
     // The simulator requires VM calls to be redirected to a special swi
@@ -5709,8 +5776,13 @@ ICCall_Native::ICCall_Native(JitCode* stubCode, ICStub* firstMonitorStub,
 ICCall_Native::Clone(JSContext* cx, ICStubSpace* space, ICStub* firstMonitorStub,
                      ICCall_Native& other)
 {
-    return New<ICCall_Native>(cx, space, other.jitCode(), firstMonitorStub, other.callee_,
-                              other.templateObject_, other.pcOffset_);
+    ICCall_Native* res = New<ICCall_Native>(cx, space, other.jitCode(), firstMonitorStub,
+                                            other.callee_, other.templateObject_,
+                                            other.pcOffset_);
+    if (res) {
+        res->enteredCount_ = other.enteredCount_;
+    }
+    return res;
 }
 
 ICCall_ClassHook::ICCall_ClassHook(JitCode* stubCode, ICStub* firstMonitorStub,
@@ -5821,6 +5893,7 @@ DoUnaryArithFallback(JSContext* cx, BaselineFrame* frame, ICUnaryArith_Fallback*
     RootedScript script(cx, frame->script());
     jsbytecode* pc = stub->icEntry()->pc(script);
     JSOp op = JSOp(*pc);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "UnaryArith(%s)", CodeName[op]);
 
     switch (op) {
@@ -5895,6 +5968,7 @@ DoBinaryArithFallback(JSContext* cx, BaselineFrame* frame, ICBinaryArith_Fallbac
     RootedScript script(cx, frame->script());
     jsbytecode* pc = stub->icEntry()->pc(script);
     JSOp op = JSOp(*pc);
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "CacheIRBinaryArith(%s,%d,%d)", CodeName[op],
             int(lhs.isDouble() ? JSVAL_TYPE_DOUBLE : lhs.extractNonDoubleType()),
             int(rhs.isDouble() ? JSVAL_TYPE_DOUBLE : rhs.extractNonDoubleType()));
@@ -6031,6 +6105,7 @@ DoCompareFallback(JSContext* cx, BaselineFrame* frame, ICCompare_Fallback* stub_
     jsbytecode* pc = stub->icEntry()->pc(script);
     JSOp op = JSOp(*pc);
 
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "Compare(%s)", CodeName[op]);
 
     // Case operations in a CONDSWITCH are performing strict equality.
@@ -6136,12 +6211,16 @@ static bool
 DoNewArray(JSContext* cx, BaselineFrame* frame, ICNewArray_Fallback* stub, uint32_t length,
            MutableHandleValue res)
 {
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "NewArray");
 
     RootedObject obj(cx);
     if (stub->templateObject()) {
         RootedObject templateObject(cx, stub->templateObject());
-        obj = NewArrayOperationWithTemplate(cx, templateObject);
+        {
+            gc::AutoSetAllocSite setSite(cx, stub->allocSite());
+            obj = NewArrayOperationWithTemplate(cx, templateObject);
+        }
         if (!obj) {
             return false;
         }
@@ -6149,7 +6228,10 @@ DoNewArray(JSContext* cx, BaselineFrame* frame, ICNewArray_Fallback* stub, uint3
         RootedScript script(cx, frame->script());
         jsbytecode* pc = stub->icEntry()->pc(script);
 
-        obj = NewArrayOperation(cx, script, pc, length);
+        {
+            gc::AutoSetAllocSite setSite(cx, stub->allocSite());
+            obj = NewArrayOperation(cx, script, pc, length);
+        }
         if (!obj) {
             return false;
         }
@@ -6190,6 +6272,7 @@ ICNewArray_Fallback::Compiler::generateStubCode(MacroAssembler& masm)
 static bool
 DoNewObject(JSContext* cx, BaselineFrame* frame, ICNewObject_Fallback* stub, MutableHandleValue res)
 {
+    stub->incrementEnteredCount();
     FallbackICSpew(cx, stub, "NewObject");
 
     RootedObject obj(cx);
@@ -6197,11 +6280,15 @@ DoNewObject(JSContext* cx, BaselineFrame* frame, ICNewObject_Fallback* stub, Mut
     RootedObject templateObject(cx, stub->templateObject());
     if (templateObject) {
         MOZ_ASSERT(!templateObject->group()->maybePreliminaryObjectsDontCheckGeneration());
+        gc::AutoSetAllocSite setSite(cx, stub->allocSite());
         obj = NewObjectOperationWithTemplate(cx, templateObject);
     } else {
         RootedScript script(cx, frame->script());
         jsbytecode* pc = stub->icEntry()->pc(script);
-        obj = NewObjectOperation(cx, script, pc);
+        {
+            gc::AutoSetAllocSite setSite(cx, stub->allocSite());
+            obj = NewObjectOperation(cx, script, pc);
+        }
 
         if (obj && !obj->isSingleton() &&
             !obj->group()->maybePreliminaryObjectsDontCheckGeneration())
@@ -6211,7 +6298,7 @@ DoNewObject(JSContext* cx, BaselineFrame* frame, ICNewObject_Fallback* stub, Mut
                 return false;
             }
 
-            TryAttachStub<NewObjectIRGenerator>("NewObject", cx, frame, stub, BaselineCacheIRStubKind::Regular, JSOp(*pc), templateObject);
+            TryAttachStub<NewObjectIRGenerator>("NewObject", cx, frame, stub, BaselineCacheIRStubKind::Regular, JSOp(*pc), templateObject, stub->allocSite());
 
             stub->setTemplateObject(templateObject);
         }
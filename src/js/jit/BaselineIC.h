@@ -12,6 +12,7 @@
 #include "builtin/TypedObject.h"
 #include "gc/Barrier.h"
 #include "gc/GC.h"
+#include "gc/Pretenuring.h"
 #include "jit/BaselineICList.h"
 #include "jit/BaselineJIT.h"
 #include "jit/ICState.h"
@@ -689,6 +690,9 @@ class ICStub
     static bool NonCacheIRStubMakesGCCalls(Kind kind);
     bool makesGCCalls() const;
 
+    // The stub info of a CacheIR stub, or nullptr for other stubs.
+    const CacheIRStubInfo* cacheIRStubInfo() const;
+
     // Optimized stubs get purged on GC.  But some stubs can be active on the
     // stack during GC - specifically the ones that can make calls.  To ensure
     // that these do not get purged, all stubs that can make calls are allocated
@@ -719,17 +723,22 @@ class ICFallbackStub : public ICStub
     // last stub's "next_" field.
     ICStub** lastStubPtrAddr_;
 
+    // The number of times the fallback path has been taken.
+    uint32_t enteredCount_;
+
     ICFallbackStub(Kind kind, JitCode* stubCode)
       : ICStub(kind, ICStub::Fallback, stubCode),
         icEntry_(nullptr),
         state_(),
-        lastStubPtrAddr_(nullptr) {}
+        lastStubPtrAddr_(nullptr),
+        enteredCount_(0) {}
 
     ICFallbackStub(Kind kind, Trait trait, JitCode* stubCode)
       : ICStub(kind, trait, stubCode),
         icEntry_(nullptr),
         state_(),
-        lastStubPtrAddr_(nullptr)
+        lastStubPtrAddr_(nullptr),
+        enteredCount_(0)
     {
         MOZ_ASSERT(trait == ICStub::Fallback ||
                    trait == ICStub::MonitoredFallback);
@@ -756,6 +765,15 @@ class ICFallbackStub : public ICStub
         return state_;
     }
 
+    uint32_t enteredCount() const {
+        return enteredCount_;
+    }
+    void incrementEnteredCount() {
+        if (enteredCount_ < UINT32_MAX) {
+            enteredCount_++;
+        }
+    }
+
     // The icEntry and lastStubPtrAddr_ fields can't be initialized when the stub is
     // created since the stub is created at compile time, and we won't know the IC entry
     // address until after compile when the JitScript is created.  This method
@@ -2175,6 +2193,9 @@ class ICCall_Scripted : public ICMonitoredStub
     GCPtrObject templateObject_;
     uint32_t pcOffset_;
 
+    // The number of calls made through this stub, for the inliner.
+    uint32_t enteredCount_;
+
     ICCall_Scripted(JitCode* stubCode, ICStub* firstMonitorStub,
                     JSFunction* callee, JSObject* templateObject,
                     uint32_t pcOffset);
@@ -2190,12 +2211,19 @@ class ICCall_Scripted : public ICMonitoredStub
         return templateObject_;
     }
 
+    uint32_t enteredCount() const {
+        return enteredCount_;
+    }
+
     static size_t offsetOfCallee() {
         return offsetof(ICCall_Scripted, callee_);
     }
     static size_t offsetOfPCOffset() {
         return offsetof(ICCall_Scripted, pcOffset_);
     }
+    static size_t offsetOfEnteredCount() {
+        return offsetof(ICCall_Scripted, enteredCount_);
+    }
 };
 
 class ICCall_AnyScripted : public ICMonitoredStub
@@ -2204,19 +2232,28 @@ class ICCall_AnyScripted : public ICMonitoredStub
 
   protected:
     uint32_t pcOffset_;
+    uint32_t enteredCount_;
 
     ICCall_AnyScripted(JitCode* stubCode, ICStub* firstMonitorStub, uint32_t pcOffset)
       : ICMonitoredStub(ICStub::Call_AnyScripted, stubCode, firstMonitorStub),
-        pcOffset_(pcOffset)
+        pcOffset_(pcOffset),
+        enteredCount_(0)
     { }
 
   public:
     static ICCall_AnyScripted* Clone(JSContext* cx, ICStubSpace* space, ICStub* firstMonitorStub,
                                      ICCall_AnyScripted& other);
 
+    uint32_t enteredCount() const {
+        return enteredCount_;
+    }
+
     static size_t offsetOfPCOffset() {
         return offsetof(ICCall_AnyScripted, pcOffset_);
     }
+    static size_t offsetOfEnteredCount() {
+        return offsetof(ICCall_AnyScripted, enteredCount_);
+    }
 };
 
 // Compiler for Call_Scripted and Call_AnyScripted stubs.
@@ -2282,6 +2319,7 @@ class ICCall_Native : public ICMonitoredStub
     GCPtrFunction callee_;
     GCPtrObject templateObject_;
     uint32_t pcOffset_;
+    uint32_t enteredCount_;
 
 #ifdef JS_SIMULATOR
     void* native_;
@@ -2302,12 +2340,19 @@ class ICCall_Native : public ICMonitoredStub
         return templateObject_;
     }
 
+    uint32_t enteredCount() const {
+        return enteredCount_;
+    }
+
     static size_t offsetOfCallee() {
         return offsetof(ICCall_Native, callee_);
     }
     static size_t offsetOfPCOffset() {
         return offsetof(ICCall_Native, pcOffset_);
     }
+    static size_t offsetOfEnteredCount() {
+        return offsetof(ICCall_Native, enteredCount_);
+    }
 
 #ifdef JS_SIMULATOR
     static size_t offsetOfNative() {
@@ -3090,9 +3135,12 @@ class ICNewArray_Fallback : public ICFallbackStub
     // template object itself is not.
     GCPtrObjectGroup templateGroup_;
 
-    ICNewArray_Fallback(JitCode* stubCode, ObjectGroup* templateGroup)
+    // The site for arrays allocated here, see gc/Pretenuring.h.
+    gc::AllocSite allocSite_;
+
+    ICNewArray_Fallback(JitCode* stubCode, ObjectGroup* templateGroup, JS::Zone* zone)
       : ICFallbackStub(ICStub::NewArray_Fallback, stubCode),
-        templateObject_(nullptr), templateGroup_(templateGroup)
+        templateObject_(nullptr), templateGroup_(templateGroup), allocSite_(zone)
     {}
 
   public:
@@ -3107,7 +3155,7 @@ class ICNewArray_Fallback : public ICFallbackStub
         {}
 
         ICStub* getStub(ICStubSpace* space) override {
-            return newStub<ICNewArray_Fallback>(space, getStubCode(), templateGroup);
+            return newStub<ICNewArray_Fallback>(space, getStubCode(), templateGroup, cx->zone());
         }
     };
 
@@ -3128,6 +3176,10 @@ class ICNewArray_Fallback : public ICFallbackStub
         templateObject_ = nullptr;
         templateGroup_ = group;
     }
+
+    gc::AllocSite* allocSite() {
+        return &allocSite_;
+    }
 };
 
 
@@ -3139,8 +3191,12 @@ class ICNewObject_Fallback : public ICFallbackStub
 
     GCPtrObject templateObject_;
 
-    explicit ICNewObject_Fallback(JitCode* stubCode)
-      : ICFallbackStub(ICStub::NewObject_Fallback, stubCode), templateObject_(nullptr)
+    // The site for objects allocated here, see gc/Pretenuring.h.
+    gc::AllocSite allocSite_;
+
+    ICNewObject_Fallback(JitCode* stubCode, JS::Zone* zone)
+      : ICFallbackStub(ICStub::NewObject_Fallback, stubCode), templateObject_(nullptr),
+        allocSite_(zone)
     {}
 
   public:
@@ -3153,7 +3209,7 @@ class ICNewObject_Fallback : public ICFallbackStub
         {}
 
         ICStub* getStub(ICStubSpace* space) override {
-            return newStub<ICNewObject_Fallback>(space, getStubCode());
+            return newStub<ICNewObject_Fallback>(space, getStubCode(), cx->zone());
         }
     };
 
@@ -3164,6 +3220,10 @@ class ICNewObject_Fallback : public ICFallbackStub
     void setTemplateObject(JSObject* obj) {
         templateObject_ = obj;
     }
+
+    gc::AllocSite* allocSite() {
+        return &allocSite_;
+    }
 };
 
 inline bool
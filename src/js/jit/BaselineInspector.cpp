@@ -423,6 +423,74 @@ ParseCacheIRStub(ICStub* stub)
     }
 }
 
+bool
+BaselineInspector::neverExecuted(jsbytecode* start, jsbytecode* stop)
+{
+    if (!hasBaselineScript()) {
+        return false;
+    }
+
+    for (jsbytecode* pc = start; pc < stop; pc += GetBytecodeLength(pc)) {
+        ICEntry* entry = maybeICEntryFromPC(pc);
+        if (!entry) {
+            continue;
+        }
+
+        // Every other fallback stub counts its entries, and stubs are only
+        // attached by the fallback stub, so the op never ran if the count is
+        // still zero.
+        ICFallbackStub* stub = entry->fallbackStub();
+        if (stub->isWarmUpCounter_Fallback() || stub->isRest_Fallback()) {
+            continue;
+        }
+        return stub->enteredCount() == 0;
+    }
+
+    return false;
+}
+
+bool
+BaselineInspector::callCounts(jsbytecode* pc, JSFunction* target, uint64_t* targetCalls,
+                              uint64_t* totalCalls, bool* allTargetsCounted)
+{
+    if (!hasBaselineScript()) {
+        return false;
+    }
+
+    ICEntry* entry = maybeICEntryFromPC(pc);
+    if (!entry || !entry->fallbackStub()->isCall_Fallback()) {
+        return false;
+    }
+
+    *targetCalls = 0;
+    *totalCalls = entry->fallbackStub()->enteredCount();
+    *allTargetsCounted = true;
+
+    for (ICStub* stub = entry->firstStub(); stub != entry->fallbackStub(); stub = stub->next()) {
+        if (stub->isCall_Scripted()) {
+            ICCall_Scripted* scripted = stub->toCall_Scripted();
+            if (scripted->callee() == target) {
+                *targetCalls += scripted->enteredCount();
+            }
+            *totalCalls += scripted->enteredCount();
+        } else if (stub->isCall_Native()) {
+            ICCall_Native* native = stub->toCall_Native();
+            if (native->callee() == target) {
+                *targetCalls += native->enteredCount();
+            }
+            *totalCalls += native->enteredCount();
+        } else if (stub->isCall_AnyScripted()) {
+            *totalCalls += stub->toCall_AnyScripted()->enteredCount();
+            *allTargetsCounted = false;
+        } else {
+            // Other call stubs don't count their calls.
+            return false;
+        }
+    }
+
+    return true;
+}
+
 MIRType
 BaselineInspector::expectedResultType(jsbytecode* pc)
 {
@@ -828,6 +896,24 @@ BaselineInspector::getTemplateObjectGroup(jsbytecode* pc)
     return nullptr;
 }
 
+gc::AllocSite*
+BaselineInspector::getAllocSite(jsbytecode* pc)
+{
+    if (!hasBaselineScript()) {
+        return nullptr;
+    }
+
+    ICStub* stub = icEntryFromPC(pc).fallbackStub();
+    switch (stub->kind()) {
+      case ICStub::NewArray_Fallback:
+        return stub->toNewArray_Fallback()->allocSite();
+      case ICStub::NewObject_Fallback:
+        return stub->toNewObject_Fallback()->allocSite();
+      default:
+        return nullptr;
+    }
+}
+
 JSFunction*
 BaselineInspector::getSingleCallee(jsbytecode* pc)
 {
@@ -118,6 +118,19 @@ class BaselineInspector
     }
 
     MIRType expectedResultType(jsbytecode* pc);
+
+    // Whether Baseline code never executed the ops in [start, stop), judging
+    // from the first IC among them.
+    bool neverExecuted(jsbytecode* start, jsbytecode* stop);
+
+    // Reads the call counts of the call IC at |pc|: the calls to |target| made
+    // through stubs specialized on it, and all calls at the site, including
+    // those that went through the fallback stub. |allTargetsCounted| is false
+    // if some calls went through stubs which don't know their target. Returns
+    // false if there is no call IC at |pc|, or it has stubs which don't count
+    // their calls.
+    bool callCounts(jsbytecode* pc, JSFunction* target, uint64_t* targetCalls,
+                    uint64_t* totalCalls, bool* allTargetsCounted);
     MCompare::CompareType expectedCompareType(jsbytecode* pc);
     MIRType expectedBinaryArithSpecialization(jsbytecode* pc);
     MIRType expectedPropertyAccessInputType(jsbytecode* pc);
@@ -137,6 +150,10 @@ class BaselineInspector
     // object itself isn't.
     ObjectGroup* getTemplateObjectGroup(jsbytecode* pc);
 
+    // The allocation site for objects created by a JSOP_NEWARRAY,
+    // JSOP_NEWOBJECT or JSOP_NEWINIT op.
+    gc::AllocSite* getAllocSite(jsbytecode* pc);
+
     JSFunction* getSingleCallee(jsbytecode* pc);
 
     LexicalEnvironmentObject* templateNamedLambdaObject();
@@ -33,6 +33,8 @@
 
 using mozilla::BinarySearchIf;
 using mozilla::DebugOnly;
+using mozilla::TimeDuration;
+using mozilla::TimeStamp;
 
 using namespace js;
 using namespace js::jit;
@@ -282,6 +284,29 @@ jit::BaselineCompile(JSContext* cx, JSScript* script, bool forceDebugInstrumenta
     return status;
 }
 
+// Length of the windows in which JitOptions.baselineCompileBudgetMs applies.
+static const uint32_t BaselineCompileWindowMs = 16;
+
+static bool
+BaselineCompileBudgetExhausted(JSContext* cx, TimeStamp now)
+{
+    if (!JitOptions.baselineCompileBudgetMs) {
+        return false;
+    }
+
+    JitRuntime* jrt = cx->runtime()->jitRuntime();
+    TimeStamp& windowStart = jrt->baselineCompileWindowStart();
+    if (windowStart.IsNull() ||
+        (now - windowStart).ToMilliseconds() >= BaselineCompileWindowMs)
+    {
+        windowStart = now;
+        jrt->baselineCompileWindowTime() = TimeDuration();
+    }
+
+    return jrt->baselineCompileWindowTime().ToMilliseconds() >=
+           JitOptions.baselineCompileBudgetMs;
+}
+
 static MethodStatus
 CanEnterBaselineJIT(JSContext* cx, HandleScript script, InterpreterFrame* osrFrame)
 {
@@ -319,10 +344,24 @@ CanEnterBaselineJIT(JSContext* cx, HandleScript script, InterpreterFrame* osrFra
         return Method_Skipped;
     }
 
+    // If lots of scripts get warm at once, keep running some of them in the
+    // interpreter for now so the main thread isn't blocked compiling them all.
+    // Their warm-up counters keep counting, so they are compiled later.
+    TimeStamp start = TimeStamp::Now();
+    if (BaselineCompileBudgetExhausted(cx, start)) {
+        return Method_Skipped;
+    }
+
     // Frames can be marked as debuggee frames independently of its underlying
     // script being a debuggee script, e.g., when performing
     // Debugger.Frame.prototype.eval.
-    return BaselineCompile(cx, script, osrFrame && osrFrame->isDebuggee());
+    MethodStatus status = BaselineCompile(cx, script, osrFrame && osrFrame->isDebuggee());
+
+    if (JitOptions.baselineCompileBudgetMs) {
+        cx->runtime()->jitRuntime()->baselineCompileWindowTime() += TimeStamp::Now() - start;
+    }
+
+    return status;
 }
 
 MethodStatus
@@ -1211,6 +1250,7 @@ jit::ToggleBaselineProfiling(JSRuntime* runtime, bool enable)
         return;
     }
 
+    AutoBatchJitCodeReprotection batch(runtime);
     for (ZonesIter zone(runtime, SkipAtoms); !zone.done(); zone.next()) {
         for (auto script = zone->cellIter<JSScript>(); !script.done(); script.next()) {
             if (!script->hasBaselineScript()) {
@@ -1226,6 +1266,7 @@ jit::ToggleBaselineProfiling(JSRuntime* runtime, bool enable)
 void
 jit::ToggleBaselineTraceLoggerScripts(JSRuntime* runtime, bool enable)
 {
+    AutoBatchJitCodeReprotection batch(runtime);
     for (ZonesIter zone(runtime, SkipAtoms); !zone.done(); zone.next()) {
         for (auto script = zone->cellIter<JSScript>(); !script.done(); script.next()) {
             if (!script->hasBaselineScript()) {
@@ -1239,6 +1280,7 @@ jit::ToggleBaselineTraceLoggerScripts(JSRuntime* runtime, bool enable)
 void
 jit::ToggleBaselineTraceLoggerEngine(JSRuntime* runtime, bool enable)
 {
+    AutoBatchJitCodeReprotection batch(runtime);
     for (ZonesIter zone(runtime, SkipAtoms); !zone.done(); zone.next()) {
         for (auto script = zone->cellIter<JSScript>(); !script.done(); script.next()) {
             if (!script->hasBaselineScript()) {
@@ -12,6 +12,7 @@
 #include "jit/BaselineCacheIRCompiler.h"
 #include "jit/BaselineIC.h"
 #include "jit/CacheIRSpewer.h"
+#include "proxy/ScriptedProxyHandler.h"
 #include "vm/SelfHosting.h"
 
 #include "jit/MacroAssembler-inl.h"
@@ -1426,6 +1427,95 @@ GetPropIRGenerator::tryAttachXrayCrossCompartmentWrapper(HandleObject obj, ObjOp
     return true;
 }
 
+bool
+GetPropIRGenerator::tryAttachScriptedProxy(HandleObject obj, ObjOperandId objId, HandleId id)
+{
+    MOZ_ASSERT(obj->is<ProxyObject>());
+
+    if (obj->as<ProxyObject>().handler() != &ScriptedProxyHandler::singleton) {
+        return false;
+    }
+
+    // The trap is passed the key as a string or symbol.
+    if (!JSID_IS_ATOM(id) && !JSID_IS_SYMBOL(id)) {
+        return false;
+    }
+
+    JSObject* handler = ScriptedProxyHandler::handlerObject(obj);
+    if (!handler || !handler->isNative()) {
+        return false;
+    }
+
+    // Only handle get traps stored in a data property of the handler itself.
+    NativeObject* nhandler = &handler->as<NativeObject>();
+    Shape* trapShape = nhandler->lookupPure(NameToId(cx_->names().get));
+    if (!trapShape || !trapShape->isDataProperty()) {
+        return false;
+    }
+
+    const Value& trapVal = nhandler->getSlot(trapShape->slot());
+    if (!trapVal.isObject() || !trapVal.toObject().is<JSFunction>()) {
+        return false;
+    }
+
+    // See IsCacheableGetPropCallScripted.
+    JSFunction* trap = &trapVal.toObject().as<JSFunction>();
+    if (trap->isNativeWithCppEntry()) {
+        return false;
+    }
+    if (!trap->isNativeWithJitEntry()) {
+        if (!trap->hasScript()) {
+            *isTemporarilyUnoptimizable_ = true;
+            return false;
+        }
+        if (trap->isClassConstructor()) {
+            return false;
+        }
+    }
+
+    // The trap's result has to agree with a non-configurable property of the
+    // target, which the stub doesn't check. Attach only if the target has no
+    // such property, and can't resolve one lazily.
+    JSObject* target = obj->as<ProxyObject>().target();
+    if (!target->isNative() || ClassMayResolveId(cx_->names(), target->getClass(), id, target)) {
+        return false;
+    }
+    if (Shape* shape = target->as<NativeObject>().lookupPure(id)) {
+        if (!shape->configurable()) {
+            if (shape->isDataDescriptor() ? !shape->writable() : !shape->hasGetterObject()) {
+                return false;
+            }
+        }
+    }
+
+    writer.guardIsProxy(objId);
+    writer.guardHasProxyHandler(objId, &ScriptedProxyHandler::singleton);
+    maybeEmitIdGuard(id);
+
+    ObjOperandId handlerId = writer.loadScriptedProxyHandler(objId);
+    writer.guardShape(handlerId, nhandler->lastProperty());
+    if (nhandler->isFixedSlot(trapShape->slot())) {
+        writer.guardSlotIsSpecificObject(handlerId, /* isFixed = */ true,
+                                         NativeObject::getFixedSlotOffset(trapShape->slot()),
+                                         trap);
+    } else {
+        size_t dynamicSlotOffset = nhandler->dynamicSlotIndex(trapShape->slot()) * sizeof(Value);
+        writer.guardSlotIsSpecificObject(handlerId, /* isFixed = */ false, dynamicSlotOffset,
+                                         trap);
+    }
+
+    // Check the result after the call if the trap changed the target's
+    // shape.
+    ObjOperandId targetId = writer.loadWrapperTarget(objId);
+    writer.guardSpecificObject(targetId, target);
+    writer.callScriptedProxyGetResult(objId, target, id, trap,
+                                      target->as<NativeObject>().lastProperty());
+    writer.typeMonitorResult();
+
+    trackAttached("ScriptedProxy");
+    return true;
+}
+
 bool
 GetPropIRGenerator::tryAttachGenericProxy(HandleObject obj, ObjOperandId objId, HandleId id,
                                           bool handleDOMProxies)
@@ -1678,6 +1768,13 @@ GetPropIRGenerator::tryAttachProxy(HandleObject obj, ObjOperandId objId, HandleI
         }
         return tryAttachGenericProxy(obj, objId, id, /* handleDOMProxies = */ true);
       case ProxyStubType::Generic:
+        if (tryAttachScriptedProxy(obj, objId, id)) {
+            return true;
+        }
+        if (*isTemporarilyUnoptimizable_) {
+            // Scripted trap without JIT code. Just wait.
+            return false;
+        }
         return tryAttachGenericProxy(obj, objId, id, /* handleDOMProxies = */ false);
     }
 
@@ -2402,6 +2499,8 @@ GetPropIRGenerator::tryAttachProxyElement(HandleObject obj, ObjOperandId objId)
 void
 GetPropIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.valueProperty("base", val_);
@@ -2724,6 +2823,8 @@ GetNameIRGenerator::tryAttachEnvironmentName(ObjOperandId objId, HandleId id)
 void
 GetNameIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.valueProperty("base", ObjectValue(*env_));
@@ -2874,6 +2975,8 @@ BindNameIRGenerator::tryAttachEnvironmentName(ObjOperandId objId, HandleId id)
 void
 BindNameIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.valueProperty("base", ObjectValue(*env_));
@@ -3304,6 +3407,8 @@ HasPropIRGenerator::tryAttachStub()
 void
 HasPropIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.valueProperty("base", val_);
@@ -3707,6 +3812,8 @@ SetPropIRGenerator::tryAttachTypedObjectProperty(HandleObject obj, ObjOperandId
 void
 SetPropIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.opcodeProperty("op", JSOp(*pc_));
@@ -4686,6 +4793,8 @@ InstanceOfIRGenerator::tryAttachStub()
 void
 InstanceOfIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.valueProperty("lhs", lhsVal_);
@@ -4821,6 +4930,8 @@ GetIteratorIRGenerator::tryAttachNativeIterator(ObjOperandId objId, HandleObject
 void
 GetIteratorIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.valueProperty("val", val_);
@@ -5121,6 +5232,8 @@ CallIRGenerator::tryAttachStub()
 void
 CallIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.valueProperty("callee", callee_);
@@ -5547,6 +5660,8 @@ CompareIRGenerator::tryAttachStub()
 void
 CompareIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.valueProperty("lhs", lhsVal_);
@@ -5565,6 +5680,8 @@ ToBoolIRGenerator::ToBoolIRGenerator(JSContext* cx, HandleScript script, jsbytec
 void
 ToBoolIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.valueProperty("val", val_);
@@ -5699,6 +5816,8 @@ GetIntrinsicIRGenerator::GetIntrinsicIRGenerator(JSContext* cx, HandleScript scr
 void
 GetIntrinsicIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.valueProperty("val", val_);
@@ -5727,6 +5846,8 @@ UnaryArithIRGenerator::UnaryArithIRGenerator(JSContext* cx, HandleScript script,
 void
 UnaryArithIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.valueProperty("val", val_);
@@ -5817,6 +5938,8 @@ BinaryArithIRGenerator::BinaryArithIRGenerator(JSContext* cx, HandleScript scrip
 void
 BinaryArithIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.opcodeProperty("op", op_);
@@ -6161,19 +6284,23 @@ BinaryArithIRGenerator::tryAttachStringObjectConcat()
 
 NewObjectIRGenerator::NewObjectIRGenerator(JSContext* cx, HandleScript script,
                                            jsbytecode* pc, ICState::Mode mode, JSOp op,
-                                           HandleObject templateObj)
+                                           HandleObject templateObj, gc::AllocSite* site)
   : IRGenerator(cx, script, pc, CacheKind::NewObject, mode),
 #ifdef JS_CACHEIR_SPEW
     op_(op),
 #endif
-    templateObject_(templateObj)
+    templateObject_(templateObj),
+    site_(site)
 {
     MOZ_ASSERT(templateObject_);
+    MOZ_ASSERT(site_);
 }
 
 void
 NewObjectIRGenerator::trackAttached(const char* name)
 {
+    writer.setAttachedName(name);
+
 #ifdef JS_CACHEIR_SPEW
     if (const CacheIRSpewer::Guard& sp = CacheIRSpewer::Guard(*this, name)) {
         sp.opcodeProperty("op", op_);
@@ -6195,7 +6322,7 @@ NewObjectIRGenerator::tryAttachStub()
     // Don't attach stub if group is pretenured, as the stub
     // won't succeed.
     AutoSweepObjectGroup sweep(templateObject_->group());
-    if (templateObject_->group()->shouldPreTenure(sweep)) {
+    if (templateObject_->group()->shouldPreTenure(sweep) || site_->isLongLived()) {
         trackAttached(IRGenerator::NotAttached);
         return false;
     }
@@ -6207,7 +6334,7 @@ NewObjectIRGenerator::tryAttachStub()
 
     writer.guardNoAllocationMetadataBuilder();
     writer.guardObjectGroupNotPretenured(templateObject_->group());
-    writer.loadNewObjectFromTemplateResult(templateObject_);
+    writer.loadNewObjectFromTemplateResult(templateObject_, site_);
     writer.returnFromIC();
 
     trackAttached("NewObjectWithTemplate");
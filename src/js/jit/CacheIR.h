@@ -207,6 +207,7 @@ extern const char* const CacheKindNames[];
     _(GuardHasProxyHandler)               \
     _(GuardNotDOMProxy)                   \
     _(GuardSpecificObject)                \
+    _(GuardSlotIsSpecificObject)          \
     _(GuardSpecificAtom)                  \
     _(GuardSpecificSymbol)                \
     _(GuardSpecificInt32Immediate)        \
@@ -233,6 +234,7 @@ extern const char* const CacheKindNames[];
     _(LoadProto)                          \
     _(LoadEnclosingEnvironment)           \
     _(LoadWrapperTarget)                  \
+    _(LoadScriptedProxyHandler)           \
     _(LoadValueTag)                       \
                                           \
     _(TruncateDoubleToUInt32)             \
@@ -297,6 +299,7 @@ extern const char* const CacheKindNames[];
     _(CallNativeGetterResult)             \
     _(CallProxyGetResult)                 \
     _(CallProxyGetByValueResult)          \
+    _(CallScriptedProxyGetResult)         \
     _(CallProxyHasPropResult)             \
     _(CallObjectHasSparseElementResult)   \
     _(CallNativeGetElementResult)        \
@@ -467,6 +470,10 @@ class MOZ_RAII CacheIRWriter : public JS::CustomAutoRooter
     mutable uint32_t lastOffset_;
     mutable uint32_t lastIndex_;
 
+    // The name the generator gave the stub when it attached, for IC
+    // statistics. This is a static string, or nullptr.
+    const char* attachedName_;
+
     void assertSameCompartment(JSObject*);
 
     void writeOp(CacheOp op) {
@@ -533,11 +540,15 @@ class MOZ_RAII CacheIRWriter : public JS::CustomAutoRooter
         stubDataSize_(0),
         tooLarge_(false),
         lastOffset_(0),
-        lastIndex_(0)
+        lastIndex_(0),
+        attachedName_(nullptr)
     {}
 
     bool failed() const { return buffer_.oom() || tooLarge_; }
 
+    const char* attachedName() const { return attachedName_; }
+    void setAttachedName(const char* name) { attachedName_ = name; }
+
     uint32_t numInputOperands() const { return numInputOperands_; }
     uint32_t numOperandIds() const { return nextOperandId_; }
     uint32_t numInstructions() const { return nextInstructionId_; }
@@ -737,6 +748,15 @@ class MOZ_RAII CacheIRWriter : public JS::CustomAutoRooter
         writeOpWithOperandId(CacheOp::GuardSpecificObject, obj);
         addStubField(uintptr_t(expected), StubField::Type::JSObject);
     }
+    void guardSlotIsSpecificObject(ObjOperandId obj, bool isFixed, size_t offset,
+                                   JSObject* expected)
+    {
+        assertSameCompartment(expected);
+        writeOpWithOperandId(CacheOp::GuardSlotIsSpecificObject, obj);
+        buffer_.writeByte(uint32_t(isFixed));
+        addStubField(offset, StubField::Type::RawWord);
+        addStubField(uintptr_t(expected), StubField::Type::JSObject);
+    }
     void guardSpecificAtom(StringOperandId str, JSAtom* expected) {
         writeOpWithOperandId(CacheOp::GuardSpecificAtom, str);
         addStubField(uintptr_t(expected), StubField::Type::String);
@@ -872,6 +892,13 @@ class MOZ_RAII CacheIRWriter : public JS::CustomAutoRooter
         return res;
     }
 
+    ObjOperandId loadScriptedProxyHandler(ObjOperandId obj) {
+        ObjOperandId res(nextOperandId_++);
+        writeOpWithOperandId(CacheOp::LoadScriptedProxyHandler, obj);
+        writeOperandId(res);
+        return res;
+    }
+
     Int32OperandId truncateDoubleToUInt32(ValOperandId val) {
         Int32OperandId res(nextOperandId_++);
         writeOpWithOperandId(CacheOp::TruncateDoubleToUInt32, val);
@@ -1256,6 +1283,18 @@ class MOZ_RAII CacheIRWriter : public JS::CustomAutoRooter
         writeOpWithOperandId(CacheOp::CallProxyGetByValueResult, obj);
         writeOperandId(idVal);
     }
+    void callScriptedProxyGetResult(ObjOperandId obj, JSObject* target, jsid id, JSFunction* trap,
+                                    Shape* targetShape)
+    {
+        MOZ_ASSERT(JSID_IS_ATOM(id) || JSID_IS_SYMBOL(id));
+        writeOpWithOperandId(CacheOp::CallScriptedProxyGetResult, obj);
+        addStubField(uintptr_t(target), StubField::Type::JSObject);
+        addStubField(uintptr_t(JSID_BITS(id)), StubField::Type::Id);
+        buffer_.writeByte(uint32_t(JSID_IS_SYMBOL(id)));
+        addStubField(uintptr_t(trap), StubField::Type::JSObject);
+        addStubField(uintptr_t(targetShape), StubField::Type::Shape);
+        buffer_.writeByte(cx_->realm() != trap->realm());
+    }
     void callProxyHasPropResult(ObjOperandId obj, ValOperandId idVal, bool hasOwn) {
         writeOpWithOperandId(CacheOp::CallProxyHasPropResult, obj);
         writeOperandId(idVal);
@@ -1304,9 +1343,10 @@ class MOZ_RAII CacheIRWriter : public JS::CustomAutoRooter
         writeOp(CacheOp::LoadValueResult);
         addStubField(val.asRawBits(), StubField::Type::Value);
     }
-    void loadNewObjectFromTemplateResult(JSObject* templateObj) {
+    void loadNewObjectFromTemplateResult(JSObject* templateObj, gc::AllocSite* site) {
         writeOp(CacheOp::LoadNewObjectFromTemplateResult);
         addStubField(uintptr_t(templateObj), StubField::Type::JSObject);
+        addStubField(uintptr_t(site), StubField::Type::RawWord);
         // Bake in a monotonically increasing number to ensure we differentiate
         // between different baseline stubs that otherwise might share
         // stub code.
@@ -1554,6 +1594,7 @@ class MOZ_RAII GetPropIRGenerator : public IRGenerator
     bool tryAttachXrayCrossCompartmentWrapper(HandleObject obj, ObjOperandId objId, HandleId id);
     bool tryAttachFunction(HandleObject obj, ObjOperandId objId, HandleId id);
 
+    bool tryAttachScriptedProxy(HandleObject obj, ObjOperandId objId, HandleId id);
     bool tryAttachGenericProxy(HandleObject obj, ObjOperandId objId, HandleId id,
                                bool handleDOMProxies);
     bool tryAttachDOMProxyExpando(HandleObject obj, ObjOperandId objId, HandleId id);
@@ -2018,12 +2059,13 @@ class MOZ_RAII NewObjectIRGenerator : public IRGenerator
     JSOp op_;
  #endif
     HandleObject templateObject_;
+    gc::AllocSite* site_;
 
     void trackAttached(const char* name);
 
   public:
     NewObjectIRGenerator(JSContext* cx, HandleScript, jsbytecode* pc, ICState::Mode,
-                         JSOp op, HandleObject templateObj);
+                         JSOp op, HandleObject templateObj, gc::AllocSite* site);
 
     bool tryAttachStub();
 };
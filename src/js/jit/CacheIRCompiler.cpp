@@ -14,6 +14,7 @@
 #include "jslibmath.h"
 #include "jit/IonIC.h"
 #include "jit/SharedICHelpers.h"
+#include "proxy/ScriptedProxyHandler.h"
 
 #include "builtin/Boolean-inl.h"
 
@@ -1231,7 +1232,7 @@ CacheIRStubInfo::New(CacheKind kind, ICStubEngine engine, bool makesGCCalls,
     fieldTypes[numStubFields] = uint8_t(StubField::Type::Limit);
 
     return new(p) CacheIRStubInfo(kind, engine, makesGCCalls, stubDataOffset, codeStart,
-                                  writer.codeLength(), fieldTypes);
+                                  writer.codeLength(), fieldTypes, writer.attachedName());
 }
 
 bool
@@ -2059,6 +2060,26 @@ CacheIRCompiler::emitLoadWrapperTarget()
     return true;
 }
 
+bool
+CacheIRCompiler::emitLoadScriptedProxyHandler()
+{
+    Register obj = allocator.useRegister(masm, reader.objOperandId());
+    Register reg = allocator.defineRegister(masm, reader.objOperandId());
+
+    FailurePath* failure;
+    if (!addFailurePath(&failure)) {
+        return false;
+    }
+
+    // The handler slot holds null once the proxy has been revoked.
+    Address handlerAddr(reg,
+                        detail::ProxyReservedSlots::offsetOfSlot(ScriptedProxyHandler::HANDLER_EXTRA));
+    masm.loadPtr(Address(obj, ProxyObject::offsetOfReservedSlots()), reg);
+    masm.branchTestObject(Assembler::NotEqual, handlerAddr, failure->label());
+    masm.unboxObject(handlerAddr, reg);
+    return true;
+}
+
 bool
 CacheIRCompiler::emitLoadValueTag()
 {
@@ -3398,6 +3419,7 @@ CacheIRCompiler::emitLoadNewObjectFromTemplateResult()
     AutoScratchRegisterMaybeOutput scratch(allocator, masm, output);
 
     TemplateObject templateObj(objectStubFieldUnchecked(reader.stubOffset()));
+    auto* site = reinterpret_cast<gc::AllocSite*>(rawWordStubFieldUnchecked(reader.stubOffset()));
 
     // Consume the disambiguation id (2 halves)
     mozilla::Unused << reader.uint32Immediate();
@@ -3408,7 +3430,8 @@ CacheIRCompiler::emitLoadNewObjectFromTemplateResult()
         return false;
     }
 
-    masm.createGCObject(obj, scratch, templateObj, gc::DefaultHeap, failure->label());
+    masm.createGCObject(obj, scratch, templateObj, gc::DefaultHeap, failure->label(),
+                        /* initContents = */ true, site);
     masm.tagValue(JSVAL_TYPE_OBJECT, obj, output.valueReg());
     return true;
 }
@@ -3736,7 +3759,7 @@ CacheIRCompiler::emitMegamorphicLoadSlotByValueResult()
     masm.jump(failure->label());
 
     masm.bind(&ok);
-    if (JitOptions.spectreJitToCxxCalls) {
+    if (masm.spectre().jitToCxxCalls) {
         masm.speculationBarrier();
     }
     masm.setFramePushed(framePushed);
@@ -3987,7 +4010,7 @@ CacheIRCompiler::emitMegamorphicLoadSlotResult()
     masm.adjustStack(sizeof(Value));
 
     masm.branchIfFalseBool(scratch2, failure->label());
-    if (JitOptions.spectreJitToCxxCalls) {
+    if (masm.spectre().jitToCxxCalls) {
         masm.speculationBarrier();
     }
 
@@ -4058,6 +4081,38 @@ CacheIRCompiler::emitGuardGroupHasUnanalyzedNewScript()
     return true;
 }
 
+bool
+CacheIRCompiler::emitGuardSlotIsSpecificObject()
+{
+    Register obj = allocator.useRegister(masm, reader.objOperandId());
+    bool isFixed = reader.readBool();
+    StubFieldOffset offset(reader.stubOffset(), StubField::Type::RawWord);
+    StubFieldOffset expected(reader.stubOffset(), StubField::Type::JSObject);
+
+    AutoScratchRegister scratch1(allocator, masm);
+    AutoScratchRegister scratch2(allocator, masm);
+
+    FailurePath* failure;
+    if (!addFailurePath(&failure)) {
+        return false;
+    }
+
+    if (isFixed) {
+        masm.movePtr(obj, scratch2);
+    } else {
+        masm.loadPtr(Address(obj, NativeObject::offsetOfSlots()), scratch2);
+    }
+    emitLoadStubField(offset, scratch1);
+    masm.computeEffectiveAddress(BaseIndex(scratch2, scratch1, TimesOne), scratch2);
+
+    Address slot(scratch2, 0);
+    masm.branchTestObject(Assembler::NotEqual, slot, failure->label());
+    masm.unboxObject(slot, scratch2);
+    emitLoadStubField(expected, scratch1);
+    masm.branchPtr(Assembler::NotEqual, scratch1, scratch2, failure->label());
+    return true;
+}
+
 bool
 CacheIRCompiler::emitLoadObject()
 {
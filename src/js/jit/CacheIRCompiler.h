@@ -51,10 +51,12 @@ namespace jit {
     _(GuardXrayExpandoShapeAndDefaultProto)\
     _(GuardNoAllocationMetadataBuilder)   \
     _(GuardObjectGroupNotPretenured)      \
+    _(GuardSlotIsSpecificObject)          \
     _(LoadObject)                         \
     _(LoadProto)                          \
     _(LoadEnclosingEnvironment)           \
     _(LoadWrapperTarget)                  \
+    _(LoadScriptedProxyHandler)           \
     _(LoadValueTag)                       \
     _(LoadDOMExpandoValue)                \
     _(LoadDOMExpandoValueIgnoreGeneration)\
@@ -673,6 +675,7 @@ class MOZ_RAII CacheIRCompiler
         stubFieldPolicy_(policy)
     {
         MOZ_ASSERT(!writer.failed());
+        masm.setSpectreMitigations(SpectreMitigations(cx->zone()->jitSpectreMitigations()));
     }
 
     MOZ_MUST_USE bool addFailurePath(FailurePath** failure);
@@ -689,7 +692,7 @@ class MOZ_RAII CacheIRCompiler
         // (1) mitigations are enabled and (2) the object is used by other
         // instructions (if the object is *not* used by other instructions,
         // zeroing its register is pointless).
-        return JitOptions.spectreObjectMitigationsMisc && !allocator.isDeadAfterInstruction(objId);
+        return masm.spectre().objectMitigationsMisc && !allocator.isDeadAfterInstruction(objId);
     }
 
     void emitLoadTypedObjectResultShared(const Address& fieldAddr, Register scratch,
@@ -760,6 +763,9 @@ class MOZ_RAII CacheIRCompiler
         return (JSObject*)writer_.readStubFieldForIon(offset,
                                                       StubField::Type::JSObject).asWord();
     }
+    uintptr_t rawWordStubFieldUnchecked(uint32_t offset) {
+        return writer_.readStubFieldForIon(offset, StubField::Type::RawWord).asWord();
+    }
     JSString* stringStubField(uint32_t offset) {
         MOZ_ASSERT(stubFieldPolicy_ == StubFieldPolicy::Constant);
         return (JSString*)readStubWord(offset, StubField::Type::String);
@@ -863,16 +869,20 @@ class CacheIRStubInfo
     uint32_t length_;
     const uint8_t* fieldTypes_;
 
+    // The name the IR generator gave this stub, see CacheIRWriter.
+    const char* name_;
+
     CacheIRStubInfo(CacheKind kind, ICStubEngine engine, bool makesGCCalls,
                     uint32_t stubDataOffset, const uint8_t* code, uint32_t codeLength,
-                    const uint8_t* fieldTypes)
+                    const uint8_t* fieldTypes, const char* name)
       : kind_(kind),
         engine_(engine),
         makesGCCalls_(makesGCCalls),
         stubDataOffset_(stubDataOffset),
         code_(code),
         length_(codeLength),
-        fieldTypes_(fieldTypes)
+        fieldTypes_(fieldTypes),
+        name_(name)
     {
         MOZ_ASSERT(kind_ == kind, "Kind must fit in bitfield");
         MOZ_ASSERT(engine_ == engine, "Engine must fit in bitfield");
@@ -891,6 +901,10 @@ class CacheIRStubInfo
     uint32_t codeLength() const { return length_; }
     uint32_t stubDataOffset() const { return stubDataOffset_; }
 
+    // Stubs with the same CacheIR share their stub info, so this is the name
+    // of the first of them to be attached, or nullptr if it wasn't named.
+    const char* name() const { return name_; }
+
     size_t stubDataSize() const;
 
     StubField::Type fieldType(uint32_t i) const { return (StubField::Type)fieldTypes_[i]; }
@@ -10,6 +10,7 @@
 #include "mozilla/Attributes.h"
 #include "mozilla/Casting.h"
 #include "mozilla/DebugOnly.h"
+#include "mozilla/EndianUtils.h"
 #include "mozilla/EnumeratedArray.h"
 #include "mozilla/EnumeratedRange.h"
 #include "mozilla/MathAlgorithms.h"
@@ -22,6 +23,7 @@
 #include "jsmath.h"
 #include "jsnum.h"
 
+#include "builtin/Array.h"
 #include "builtin/Eval.h"
 #include "builtin/RegExp.h"
 #include "builtin/SelfHostingDefines.h"
@@ -1621,6 +1623,40 @@ PrepareAndExecuteRegExp(JSContext* cx, MacroAssembler& masm, Register regexp, Re
         masm.store32(temp2, pairCountAddress);
     }
 
+    masm.storePtr(lastIndex, startIndexAddress);
+
+    // If every match starts with a literal, search for it to find the first
+    // position the RegExp code needs to be tried at.
+    {
+        Label done;
+        masm.branchPtr(Assembler::Equal, Address(temp1, RegExpShared::offsetOfLiteralPrefix()),
+                       ImmWord(0), &done);
+
+        LiveGeneralRegisterSet volatileRegs;
+        if (input.volatile_()) {
+            volatileRegs.add(input);
+        }
+        if (regexp.volatile_()) {
+            volatileRegs.add(regexp);
+        }
+        if (temp1.volatile_()) {
+            volatileRegs.add(temp1);
+        }
+
+        masm.computeEffectiveAddress(startIndexAddress, temp2);
+        masm.PushRegsInMask(volatileRegs);
+        masm.setupUnalignedABICall(temp3);
+        masm.passABIArg(temp1);
+        masm.passABIArg(input);
+        masm.passABIArg(temp2);
+        masm.callWithABI(JS_FUNC_TO_DATA_PTR(void*, RegExpSearchLiteralPrefix));
+        masm.storeCallBoolResult(temp3);
+        masm.PopRegsInMask(volatileRegs);
+
+        masm.branchIfFalseBool(temp3, notFound);
+        masm.bind(&done);
+    }
+
     // Load the code pointer for the type of input string we have, and compute
     // the input start/end pointers in the InputOutputData.
     Register codePointer = temp1;
@@ -1663,7 +1699,6 @@ PrepareAndExecuteRegExp(JSContext* cx, MacroAssembler& masm, Register regexp, Re
         masm.computeEffectiveAddress(endIndexAddress, temp2);
         masm.storePtr(temp2, endIndexAddress);
     }
-    masm.storePtr(lastIndex, startIndexAddress);
     masm.store32(Imm32(RegExpRunStatus_Error), matchResultAddress);
 
     // Save any volatile inputs.
@@ -3361,7 +3396,7 @@ CodeGenerator::visitReturn(LReturn* lir)
     MOZ_ASSERT(ToRegister(result) == JSReturnReg);
 #endif
     // Don't emit a jump to the return label if this is the last block.
-    if (current->mir() != *gen->graph().poBegin()) {
+    if (!isLastBlock()) {
         masm.jump(&returnLabel_);
     }
 }
@@ -4505,7 +4540,7 @@ CodeGenerator::visitCallNative(LCallNative* call)
 
     // Until C++ code is instrumented against Spectre, prevent speculative
     // execution from returning any private data.
-    if (JitOptions.spectreJitToCxxCalls && !call->mir()->ignoresReturnValue() &&
+    if (gen->spectre().jitToCxxCalls && !call->mir()->ignoresReturnValue() &&
         call->mir()->hasLiveDefUses())
     {
         masm.speculationBarrier();
@@ -4667,7 +4702,7 @@ CodeGenerator::visitCallDOMNative(LCallDOMNative* call)
 
     // Until C++ code is instrumented against Spectre, prevent speculative
     // execution from returning any private data.
-    if (JitOptions.spectreJitToCxxCalls && call->mir()->hasLiveDefUses()) {
+    if (gen->spectre().jitToCxxCalls && call->mir()->hasLiveDefUses()) {
         masm.speculationBarrier();
     }
 
@@ -5309,6 +5344,21 @@ CodeGenerator::visitApplyArrayGeneric(LApplyArrayGeneric* apply)
     emitApplyGeneric(apply);
 }
 
+void
+CodeGenerator::visitOptimizeSpreadCall(LOptimizeSpreadCall* lir)
+{
+    pushArg(ToValue(lir, LOptimizeSpreadCall::Value));
+    callVM(OptimizeSpreadCallInfo, lir);
+}
+
+void
+CodeGenerator::visitOptimizeArrayDestructuring(LOptimizeArrayDestructuring* lir)
+{
+    pushArg(Imm32(lir->mir()->count()));
+    pushArg(ToValue(lir, LOptimizeArrayDestructuring::Value));
+    callVM(OptimizeArrayDestructuringInfo, lir);
+}
+
 void
 CodeGenerator::visitBail(LBail* lir)
 {
@@ -5973,7 +6023,25 @@ CodeGenerator::generateBody()
     }
 #endif
 
+    // Emit the code of cold blocks after the code of the other blocks, so it
+    // doesn't take up instruction cache lines and TLB entries on the hot path.
+    if (!blockOrder_.reserve(graph.numBlocks())) {
+        return false;
+    }
     for (size_t i = 0; i < graph.numBlocks(); i++) {
+        if (!graph.getBlock(i)->mir()->isCold()) {
+            blockOrder_.infallibleAppend(i);
+        }
+    }
+    for (size_t i = 0; i < graph.numBlocks(); i++) {
+        if (graph.getBlock(i)->mir()->isCold()) {
+            blockOrder_.infallibleAppend(i);
+        }
+    }
+    MOZ_ASSERT(blockOrder_[0] == 0, "the entry block must be emitted first");
+
+    for (currentIndex_ = 0; currentIndex_ < blockOrder_.length(); currentIndex_++) {
+        size_t i = blockOrder_[currentIndex_];
         current = graph.getBlock(i);
 
         // Don't emit any code for trivial blocks, containing just a goto. Such
@@ -5999,9 +6067,10 @@ CodeGenerator::generateBody()
             columnNumber = current->mir()->columnIndex();
 #endif
         }
-        JitSpew(JitSpew_Codegen, "# block%zu %s:%zu:%u%s:",
+        JitSpew(JitSpew_Codegen, "# block%zu %s:%zu:%u%s%s:",
                 i, filename ? filename : "?", lineNumber, columnNumber,
-                current->mir()->isLoopHeader() ? " (loop header)" : "");
+                current->mir()->isLoopHeader() ? " (loop header)" : "",
+                current->mir()->isCold() ? " (cold)" : "");
 #endif
 
         masm.bind(current->label());
@@ -6259,7 +6328,7 @@ CodeGenerator::visitNewArray(LNewArray* lir)
         templateObject.setConvertDoubleElements();
     }
     masm.createGCObject(objReg, tempReg, templateObject, lir->mir()->initialHeap(),
-                        ool->entry());
+                        ool->entry(), /* initContents = */ true, lir->mir()->allocSite());
 
     masm.bind(ool->rejoin());
 }
@@ -6614,7 +6683,7 @@ CodeGenerator::visitNewObject(LNewObject* lir)
 
     bool initContents = ShouldInitFixedSlots(lir, templateObject);
     masm.createGCObject(objReg, tempReg, templateObject, lir->mir()->initialHeap(), ool->entry(),
-                        initContents);
+                        initContents, lir->mir()->allocSite());
 
     masm.bind(ool->rejoin());
 }
@@ -7100,9 +7169,8 @@ RangeFront<ValueMap>(MacroAssembler& masm, Register range, Register i, Register
     masm.loadPtr(Address(front, ValueMap::offsetOfImplData()), front);
 
     MOZ_ASSERT(ValueMap::offsetOfImplDataElement() == 0, "offsetof(Data, element) is 0");
-    static_assert(ValueMap::sizeofImplData() == 24, "sizeof(Data) is 24");
-    masm.mulBy3(i, i);
-    masm.lshiftPtr(Imm32(3), i);
+    static_assert(ValueMap::sizeofImplData() == 16, "sizeof(Data) is 16");
+    masm.lshiftPtr(Imm32(4), i);
     masm.addPtr(i, front);
 }
 
@@ -7114,8 +7182,8 @@ RangeFront<ValueSet>(MacroAssembler& masm, Register range, Register i, Register
     masm.loadPtr(Address(front, ValueSet::offsetOfImplData()), front);
 
     MOZ_ASSERT(ValueSet::offsetOfImplDataElement() == 0, "offsetof(Data, element) is 0");
-    static_assert(ValueSet::sizeofImplData() == 16, "sizeof(Data) is 16");
-    masm.lshiftPtr(Imm32(4), i);
+    static_assert(ValueSet::sizeofImplData() == 8, "sizeof(Data) is 8");
+    masm.lshiftPtr(Imm32(3), i);
     masm.addPtr(i, front);
 }
 
@@ -7294,6 +7362,90 @@ CodeGenerator::visitGetNextEntryForIterator(LGetNextEntryForIterator* lir)
     }
 }
 
+// Call one of the pure lookups of MapObject and SetObject, which replace the
+// key with the result when they don't need to atomize it. The object and the
+// key are left on the stack, with the key on top, and we jump to |failure| if
+// the lookup could not be done without calling into the VM.
+static void
+CallMapOrSetLookupPure(MacroAssembler& masm, Register obj, ValueOperand key, Register temp0,
+                       Register temp1, void* fun, Label* failure)
+{
+    masm.Push(obj);
+    masm.Push(key);
+    masm.moveStackPtrTo(temp0);
+
+    masm.setupUnalignedABICall(temp1);
+    masm.passABIArg(obj);
+    masm.passABIArg(temp0);
+    masm.callWithABI(fun);
+    masm.branchIfFalseBool(ReturnReg, failure);
+}
+
+typedef bool (*MapObjectGetFn)(JSContext*, HandleObject, HandleValue, MutableHandleValue);
+static const VMFunction MapObjectGetInfo =
+    FunctionInfo<MapObjectGetFn>(MapObject::get, "MapObject::get");
+
+void
+CodeGenerator::visitMapObjectGet(LMapObjectGet* lir)
+{
+    Register map = ToRegister(lir->map());
+    ValueOperand key = ToValue(lir, LMapObjectGet::Key);
+    ValueOperand output = ToOutValue(lir);
+
+    Label failure, done;
+    CallMapOrSetLookupPure(masm, map, key, ToRegister(lir->temp0()), ToRegister(lir->temp1()),
+                           JS_FUNC_TO_DATA_PTR(void*, MapObject::getPure), &failure);
+    masm.loadValue(Address(masm.getStackPointer(), 0), output);
+    masm.addToStackPtr(Imm32(sizeof(Value) + sizeof(uintptr_t)));
+    masm.jump(&done);
+
+    // The ABI call clobbered the inputs, but this is a call instruction, so
+    // they are free to be reloaded from the stack.
+    masm.bind(&failure);
+    masm.Pop(key);
+    masm.Pop(map);
+    pushArg(key);
+    pushArg(map);
+    callVM(MapObjectGetInfo, lir);
+
+    masm.bind(&done);
+}
+
+typedef bool (*MapOrSetHasFn)(JSContext*, HandleObject, HandleValue, bool*);
+static const VMFunction MapObjectHasInfo =
+    FunctionInfo<MapOrSetHasFn>(MapObject::has, "MapObject::has");
+static const VMFunction SetObjectHasInfo =
+    FunctionInfo<MapOrSetHasFn>(SetObject::has, "SetObject::has");
+
+void
+CodeGenerator::visitMapOrSetHas(LMapOrSetHas* lir)
+{
+    Register obj = ToRegister(lir->object());
+    ValueOperand key = ToValue(lir, LMapOrSetHas::Key);
+    Register output = ToRegister(lir->output());
+    bool isMap = lir->mir()->mode() == MMapOrSetHas::Map;
+
+    void* fun = isMap
+                ? JS_FUNC_TO_DATA_PTR(void*, MapObject::hasPure)
+                : JS_FUNC_TO_DATA_PTR(void*, SetObject::hasPure);
+
+    Label failure, done;
+    CallMapOrSetLookupPure(masm, obj, key, ToRegister(lir->temp0()), ToRegister(lir->temp1()),
+                           fun, &failure);
+    masm.unboxBoolean(Address(masm.getStackPointer(), 0), output);
+    masm.addToStackPtr(Imm32(sizeof(Value) + sizeof(uintptr_t)));
+    masm.jump(&done);
+
+    masm.bind(&failure);
+    masm.Pop(key);
+    masm.Pop(obj);
+    pushArg(key);
+    pushArg(obj);
+    callVM(isMap ? MapObjectHasInfo : SetObjectHasInfo, lir);
+
+    masm.bind(&done);
+}
+
 void
 CodeGenerator::emitWasmCallBase(MWasmCall* mir, bool needsBoundsCheck)
 {
@@ -7581,6 +7733,60 @@ CodeGenerator::visitSetDisjointTypedElements(LSetDisjointTypedElements* lir)
     masm.callWithABI(JS_FUNC_TO_DATA_PTR(void*, js::SetDisjointTypedElements));
 }
 
+void
+CodeGenerator::visitTypedArrayFill(LTypedArrayFill* lir)
+{
+    Register object = ToRegister(lir->object());
+    Register value = ToRegister(lir->value());
+    Register start = ToRegister(lir->start());
+    Register end = ToRegister(lir->end());
+    Register temp = ToRegister(lir->temp());
+
+    masm.setupUnalignedABICall(temp);
+    masm.passABIArg(object);
+    masm.passABIArg(value);
+    masm.passABIArg(start);
+    masm.passABIArg(end);
+    masm.callWithABI(JS_FUNC_TO_DATA_PTR(void*, js::TypedArrayFillInt32));
+}
+
+void
+CodeGenerator::visitTypedArraySearch(LTypedArraySearch* lir)
+{
+    Register object = ToRegister(lir->object());
+    Register value = ToRegister(lir->value());
+    Register start = ToRegister(lir->start());
+    Register temp = ToRegister(lir->temp());
+    Register output = ToRegister(lir->output());
+
+    void* fun;
+    switch (lir->mir()->mode()) {
+      case MTypedArraySearch::IndexOf:
+        fun = JS_FUNC_TO_DATA_PTR(void*, js::TypedArrayIndexOfInt32);
+        break;
+      case MTypedArraySearch::LastIndexOf:
+        fun = JS_FUNC_TO_DATA_PTR(void*, js::TypedArrayLastIndexOfInt32);
+        break;
+      case MTypedArraySearch::Includes:
+        fun = JS_FUNC_TO_DATA_PTR(void*, js::TypedArrayIncludesInt32);
+        break;
+      default:
+        MOZ_CRASH("unexpected typed array search mode");
+    }
+
+    masm.setupUnalignedABICall(temp);
+    masm.passABIArg(object);
+    masm.passABIArg(value);
+    masm.passABIArg(start);
+    masm.callWithABI(fun);
+
+    if (lir->mir()->mode() == MTypedArraySearch::Includes) {
+        masm.storeCallBoolResult(output);
+    } else {
+        masm.storeCallInt32Result(output);
+    }
+}
+
 void
 CodeGenerator::visitTypedObjectDescr(LTypedObjectDescr* lir)
 {
@@ -8510,6 +8716,34 @@ CodeGenerator::visitConcat(LConcat* lir)
     emitConcat(lir, lhs, rhs, output);
 }
 
+void
+CodeGenerator::visitConcatN(LConcatN* lir)
+{
+    Register temp = ToRegister(lir->temp());
+    size_t numParts = lir->numOperands();
+
+    // Push the parts in reverse order, so they form an array in the order of
+    // the operands, and pass its address to the VM.
+    for (size_t i = numParts; i > 0; i--) {
+        const LAllocation* part = lir->getOperand(i - 1);
+        if (part->isConstant()) {
+            masm.Push(ImmGCPtr(part->toConstant()->toString()));
+        } else if (part->isRegister()) {
+            masm.Push(ToRegister(part));
+        } else {
+            masm.loadPtr(ToAddress(part), temp);
+            masm.Push(temp);
+        }
+    }
+    masm.moveStackPtrTo(temp);
+
+    pushArg(Imm32(numParts));
+    pushArg(temp);
+    callVM(ConcatStringPartsInfo, lir);
+
+    masm.freeStack(numParts * sizeof(JSString*));
+}
+
 static void
 CopyStringChars(MacroAssembler& masm, Register to, Register from, Register len,
                 Register byteOpScratch, CharEncoding fromEncoding, CharEncoding toEncoding)
@@ -9433,7 +9667,7 @@ CodeGenerator::visitBoundsCheckLower(LBoundsCheckLower* lir)
 void
 CodeGenerator::visitSpectreMaskIndex(LSpectreMaskIndex* lir)
 {
-    MOZ_ASSERT(JitOptions.spectreIndexMasking);
+    MOZ_ASSERT(gen->spectre().indexMasking);
 
     const LAllocation* length = lir->length();
     Register index = ToRegister(lir->index());
@@ -10078,6 +10312,52 @@ CodeGenerator::visitArraySlice(LArraySlice* lir)
     callVM(ArraySliceDenseInfo, lir);
 }
 
+void
+CodeGenerator::visitArraySearch(LArraySearch* lir)
+{
+    Register array = ToRegister(lir->array());
+    Register value = ToRegister(lir->value());
+    Register start = ToRegister(lir->start());
+    Register end = ToRegister(lir->end());
+    Register temp = ToRegister(lir->temp());
+    Register output = ToRegister(lir->output());
+
+    int32_t (*int32Fn)(ArrayObject*, int32_t, int32_t, int32_t);
+    int32_t (*objectFn)(ArrayObject*, JSObject*, int32_t, int32_t);
+    switch (lir->mir()->mode()) {
+      case MArraySearch::IndexOf:
+        int32Fn = ArraySearchInt32<ArraySearch::IndexOf>;
+        objectFn = ArraySearchObject<ArraySearch::IndexOf>;
+        break;
+      case MArraySearch::LastIndexOf:
+        int32Fn = ArraySearchInt32<ArraySearch::LastIndexOf>;
+        objectFn = ArraySearchObject<ArraySearch::LastIndexOf>;
+        break;
+      case MArraySearch::Includes:
+        int32Fn = ArraySearchInt32<ArraySearch::Includes>;
+        objectFn = ArraySearchObject<ArraySearch::Includes>;
+        break;
+      default:
+        MOZ_CRASH("unexpected array search mode");
+    }
+
+    masm.setupUnalignedABICall(temp);
+    masm.passABIArg(array);
+    masm.passABIArg(value);
+    masm.passABIArg(start);
+    masm.passABIArg(end);
+    if (lir->mir()->value()->type() == MIRType::Int32) {
+        masm.callWithABI(JS_FUNC_TO_DATA_PTR(void*, int32Fn));
+    } else {
+        masm.callWithABI(JS_FUNC_TO_DATA_PTR(void*, objectFn));
+    }
+    masm.storeCallInt32Result(output);
+
+    if (lir->mir()->mode() == MArraySearch::Includes) {
+        masm.cmp32Set(Assembler::GreaterThanOrEqual, output, Imm32(0), output);
+    }
+}
+
 typedef JSString* (*ArrayJoinFn)(JSContext*, HandleObject, HandleString);
 static const VMFunction ArrayJoinInfo = FunctionInfo<ArrayJoinFn>(jit::ArrayJoin, "ArrayJoin");
 
@@ -10388,11 +10668,13 @@ CodeGenerator::visitRest(LRest* lir)
 
 bool
 CodeGenerator::generateWasm(wasm::FuncTypeIdDesc funcTypeId, wasm::BytecodeOffset trapOffset,
+                            const mozilla::Maybe<uint32_t>& callCountGlobalDataOffset,
                             wasm::FuncOffsets* offsets)
 {
     JitSpew(JitSpew_Codegen, "# Emitting wasm code");
 
-    wasm::GenerateFunctionPrologue(masm, funcTypeId, mozilla::Nothing(), offsets);
+    wasm::GenerateFunctionPrologue(masm, funcTypeId, mozilla::Nothing(),
+                                   callCountGlobalDataOffset, offsets);
 
     if (omitOverRecursedCheck()) {
         masm.reserveStack(frameSize());
@@ -10488,6 +10770,15 @@ CodeGenerator::generate()
 
     masm.bind(&skipPrologue);
 
+    // Mark the script's JIT code as recently used. No registers are allocated
+    // yet, so it's safe to grab anything.
+    {
+        AllocatableGeneralRegisterSet temps(GeneralRegisterSet::All());
+        Register temp = temps.takeAny();
+        masm.movePtr(ImmGCPtr(gen->info().script()), temp);
+        masm.store8(Imm32(0), Address(temp, JSScript::offsetOfJitCodeAge()));
+    }
+
 #ifdef DEBUG
     // Assert that the argument types are correct.
     generateArgumentsChecks(/* assert = */ true);
@@ -12142,6 +12433,132 @@ CodeGenerator::visitStoreUnboxedScalar(LStoreUnboxedScalar* lir)
     }
 }
 
+// Whether DataView accesses in the host byte order can load and store the value
+// directly. Elsewhere unaligned accesses aren't safe, so the bytes are copied
+// through an aligned stack slot like byte-swapped accesses are.
+#if defined(JS_CODEGEN_X86) || defined(JS_CODEGEN_X64)
+static const bool DataViewUnalignedAccessOK = true;
+#else
+static const bool DataViewUnalignedAccessOK = false;
+#endif
+
+// Whether a DataView access of |type| in the given byte order has to go through
+// a stack slot. The masm has no byte swap instruction on all platforms, so
+// values in the other byte order are reversed as they're copied.
+static bool
+DataViewAccessNeedsCopy(Scalar::Type type, bool littleEndian, bool* swap)
+{
+    size_t size = Scalar::byteSize(type);
+    *swap = size > 1 && littleEndian != bool(MOZ_LITTLE_ENDIAN);
+    return size > 1 && (*swap || !DataViewUnalignedAccessOK);
+}
+
+// Copy |size| bytes from |src| to |dest| one at a time through |temp|,
+// reversing their order if |swap| is set.
+template <typename S, typename T>
+static void
+CopyDataViewBytes(MacroAssembler& masm, const S& src, const T& dest, size_t size, bool swap,
+                  Register temp)
+{
+    for (size_t i = 0; i < size; i++) {
+        S from = src;
+        from.offset += int32_t(i);
+        T to = dest;
+        to.offset += int32_t(swap ? size - 1 - i : i);
+        masm.load8ZeroExtend(from, temp);
+        masm.store8(temp, to);
+    }
+}
+
+template <typename T>
+static void
+EmitLoadDataViewElement(MacroAssembler& masm, const MLoadDataViewElement* mir, const T& source,
+                        AnyRegister out, Register temp, Label* fail)
+{
+    Scalar::Type type = mir->storageType();
+
+    bool swap;
+    if (!DataViewAccessNeedsCopy(type, mir->littleEndian(), &swap)) {
+        masm.loadFromTypedArray(type, source, out, temp, fail);
+        return;
+    }
+
+    // Uint32 values are checked after the slot is freed, so a bailout sees the
+    // frame it expects.
+    bool checkUint32 = type == Scalar::Uint32 && !out.isFloat();
+
+    masm.reserveStack(sizeof(double));
+    Address slot(masm.getStackPointer(), 0);
+    CopyDataViewBytes(masm, source, slot, Scalar::byteSize(type), swap, temp);
+    masm.loadFromTypedArray(checkUint32 ? Scalar::Int32 : type, slot, out, temp, nullptr);
+    masm.freeStack(sizeof(double));
+
+    if (checkUint32) {
+        masm.branchTest32(Assembler::Signed, out.gpr(), out.gpr(), fail);
+    }
+}
+
+void
+CodeGenerator::visitLoadDataViewElement(LLoadDataViewElement* lir)
+{
+    Register elements = ToRegister(lir->elements());
+    Register temp = lir->temp()->isBogusTemp() ? InvalidReg : ToRegister(lir->temp());
+    AnyRegister out = ToAnyRegister(lir->output());
+
+    const MLoadDataViewElement* mir = lir->mir();
+
+    Label fail;
+    if (lir->index()->isConstant()) {
+        Address source(elements, ToInt32(lir->index()));
+        EmitLoadDataViewElement(masm, mir, source, out, temp, &fail);
+    } else {
+        BaseIndex source(elements, ToRegister(lir->index()), TimesOne);
+        EmitLoadDataViewElement(masm, mir, source, out, temp, &fail);
+    }
+
+    if (fail.used()) {
+        bailoutFrom(&fail, lir->snapshot());
+    }
+}
+
+template <typename T>
+static void
+EmitStoreDataViewElement(MacroAssembler& masm, const MStoreDataViewElement* mir,
+                         const LAllocation* value, const T& dest, Register temp)
+{
+    Scalar::Type type = mir->writeType();
+
+    bool swap;
+    if (!DataViewAccessNeedsCopy(type, mir->littleEndian(), &swap)) {
+        StoreToTypedArray(masm, type, value, dest);
+        return;
+    }
+
+    masm.reserveStack(sizeof(double));
+    Address slot(masm.getStackPointer(), 0);
+    StoreToTypedArray(masm, type, value, slot);
+    CopyDataViewBytes(masm, slot, dest, Scalar::byteSize(type), swap, temp);
+    masm.freeStack(sizeof(double));
+}
+
+void
+CodeGenerator::visitStoreDataViewElement(LStoreDataViewElement* lir)
+{
+    Register elements = ToRegister(lir->elements());
+    const LAllocation* value = lir->value();
+    Register temp = lir->temp()->isBogusTemp() ? InvalidReg : ToRegister(lir->temp());
+
+    const MStoreDataViewElement* mir = lir->mir();
+
+    if (lir->index()->isConstant()) {
+        Address dest(elements, ToInt32(lir->index()));
+        EmitStoreDataViewElement(masm, mir, value, dest, temp);
+    } else {
+        BaseIndex dest(elements, ToRegister(lir->index()), TimesOne);
+        EmitStoreDataViewElement(masm, mir, value, dest, temp);
+    }
+}
+
 void
 CodeGenerator::visitStoreTypedArrayElementHole(LStoreTypedArrayElementHole* lir)
 {
@@ -12544,7 +12961,7 @@ CodeGenerator::visitGetDOMProperty(LGetDOMProperty* ins)
 
     // Until C++ code is instrumented against Spectre, prevent speculative
     // execution from returning any private data.
-    if (JitOptions.spectreJitToCxxCalls && ins->mir()->hasLiveDefUses()) {
+    if (gen->spectre().jitToCxxCalls && ins->mir()->hasLiveDefUses()) {
         masm.speculationBarrier();
     }
 
@@ -13032,7 +13449,7 @@ void
 CodeGenerator::visitWasmReturn(LWasmReturn* lir)
 {
     // Don't emit a jump to the return label if this is the last block.
-    if (current->mir() != *gen->graph().poBegin()) {
+    if (!isLastBlock()) {
         masm.jump(&returnLabel_);
     }
 }
@@ -13041,7 +13458,7 @@ void
 CodeGenerator::visitWasmReturnI64(LWasmReturnI64* lir)
 {
     // Don't emit a jump to the return label if this is the last block.
-    if (current->mir() != *gen->graph().poBegin()) {
+    if (!isLastBlock()) {
         masm.jump(&returnLabel_);
     }
 }
@@ -13050,7 +13467,7 @@ void
 CodeGenerator::visitWasmReturnVoid(LWasmReturnVoid* lir)
 {
     // Don't emit a jump to the return label if this is the last block.
-    if (current->mir() != *gen->graph().poBegin()) {
+    if (!isLastBlock()) {
         masm.jump(&returnLabel_);
     }
 }
@@ -13275,11 +13692,25 @@ CodeGenerator::visitInterruptCheck(LInterruptCheck* lir)
         masm.inc64(AbsoluteAddress(mozilla::recordreplay::ExecutionProgressCounter()));
     }
 
+#ifdef JS_CODEGEN_X64
+    if (const void* pollPage = gen->runtime->interruptPollPage()) {
+        masm.interruptPoll(pollPage, ool->entry());
+        masm.bind(ool->rejoin());
+        return;
+    }
+#endif
+
     const void* interruptAddr = gen->runtime->addressOfInterruptBits();
     masm.branch32(Assembler::NotEqual, AbsoluteAddress(interruptAddr), Imm32(0), ool->entry());
     masm.bind(ool->rejoin());
 }
 
+void
+CodeGenerator::visitIncrementPCCount(LIncrementPCCount* lir)
+{
+    masm.inc64(AbsoluteAddress(lir->mir()->counter()));
+}
+
 void
 CodeGenerator::visitWasmInterruptCheck(LWasmInterruptCheck* lir)
 {
@@ -13897,6 +14328,7 @@ CodeGenerator::emitIonToWasmCallBase(LIonToWasmCallBase<NumDefs>* lir)
             argMir = ToMIRType(sig.args()[i]);
             break;
           case wasm::ValType::I64:
+          case wasm::ValType::V128:
           case wasm::ValType::Ref:
           case wasm::ValType::AnyRef:
             // Don't forget to trace GC type arguments in TraceJitExitFrames
@@ -13955,6 +14387,7 @@ CodeGenerator::emitIonToWasmCallBase(LIonToWasmCallBase<NumDefs>* lir)
       case wasm::ExprType::Ref:
       case wasm::ExprType::AnyRef:
       case wasm::ExprType::I64:
+      case wasm::ExprType::V128:
         // Don't forget to trace GC type return value in TraceJitExitFrames
         // when they're enabled.
         MOZ_CRASH("unexpected return type when calling from ion to wasm");
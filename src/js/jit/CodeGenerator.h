@@ -73,6 +73,7 @@ class CodeGenerator final : public CodeGeneratorSpecific
 
     MOZ_MUST_USE bool generate();
     MOZ_MUST_USE bool generateWasm(wasm::FuncTypeIdDesc funcTypeId, wasm::BytecodeOffset trapOffset,
+                                   const mozilla::Maybe<uint32_t>& callCountGlobalDataOffset,
                                    wasm::FuncOffsets* offsets);
 
     MOZ_MUST_USE bool link(JSContext* cx, CompilerConstraintList* constraints);
@@ -197,6 +197,9 @@ class CompactBufferWriter
     size_t length() const {
         return buffer_.length();
     }
+    void shrinkTo(size_t length) {
+        buffer_.shrinkTo(length);
+    }
     uint8_t* buffer() {
         MOZ_ASSERT(!oom());
         return &buffer_[0];
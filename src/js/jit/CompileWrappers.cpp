@@ -125,6 +125,12 @@ CompileRuntime::addressOfInterruptBits()
     return runtime()->mainContextFromAnyThread()->addressOfInterruptBits();
 }
 
+const void*
+CompileRuntime::interruptPollPage()
+{
+    return runtime()->mainContextFromAnyThread()->interruptPollPage();
+}
+
 #ifdef DEBUG
 bool
 CompileRuntime::isInsideNursery(gc::Cell* cell)
@@ -202,6 +208,12 @@ CompileZone::addressOfStringNurseryPosition()
     return zone()->runtimeFromAnyThread()->gc.addressOfNurseryPosition();
 }
 
+void*
+CompileZone::addressOfNurseryAllocatedSites()
+{
+    return zone()->runtimeFromAnyThread()->gc.addressOfNurseryAllocatedSites();
+}
+
 const void*
 CompileZone::addressOfNurseryCurrentEnd()
 {
@@ -234,6 +246,14 @@ CompileZone::canNurseryAllocateStrings()
         zone()->allocNurseryStrings;
 }
 
+bool
+CompileZone::canNurseryAllocateBigInts()
+{
+    return nurseryExists() &&
+        zone()->runtimeFromAnyThread()->gc.nursery().canAllocateBigInts() &&
+        zone()->allocNurseryBigInts;
+}
+
 bool
 CompileZone::nurseryExists()
 {
@@ -305,6 +325,18 @@ CompileRealm::hasAllocationMetadataBuilder()
     return realm()->hasAllocationMetadataBuilder();
 }
 
+bool
+CompileRealm::hasSampledAllocationMetadataBuilder()
+{
+    return realm()->hasSampledAllocationMetadataBuilder();
+}
+
+const uint32_t*
+CompileRealm::addressOfAllocationsUntilSample()
+{
+    return realm()->savedStacks().addressOfAllocationsUntilSample();
+}
+
 // Note: This function is thread-safe because setSingletonAsValue sets a boolean
 // variable to false, and this boolean variable has no way to be resetted to
 // true. So even if there is a concurrent write, this concurrent write will
@@ -337,4 +369,5 @@ JitCompileOptions::JitCompileOptions(JSContext* cx)
 #ifdef ENABLE_WASM_GC
     wasmGcEnabled_ = cx->options().wasmGc();
 #endif
+    spectreMitigations_ = SpectreMitigations(cx->zone()->jitSpectreMitigations());
 }
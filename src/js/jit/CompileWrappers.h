@@ -7,6 +7,7 @@
 #ifndef jit_CompileWrappers_h
 #define jit_CompileWrappers_h
 
+#include "jit/JitOptions.h"
 #include "vm/JSContext.h"
 
 namespace js {
@@ -51,6 +52,7 @@ class CompileRuntime
     uint32_t* addressOfTenuredAllocCount();
     const void* addressOfJitStackLimit();
     const void* addressOfInterruptBits();
+    const void* interruptPollPage();
 
 #ifdef DEBUG
     bool isInsideNursery(gc::Cell* cell);
@@ -82,11 +84,13 @@ class CompileZone
     void* addressOfStringNurseryPosition();
     const void* addressOfNurseryCurrentEnd();
     const void* addressOfStringNurseryCurrentEnd();
+    void* addressOfNurseryAllocatedSites();
 
     uint32_t* addressOfNurseryAllocCount();
 
     bool nurseryExists();
     bool canNurseryAllocateStrings();
+    bool canNurseryAllocateBigInts();
     void setMinorGCShouldCancelIonCompilations();
 };
 
@@ -115,6 +119,8 @@ class CompileRealm
     const uint32_t* addressOfGlobalWriteBarriered();
 
     bool hasAllocationMetadataBuilder();
+    bool hasSampledAllocationMetadataBuilder();
+    const uint32_t* addressOfAllocationsUntilSample();
 
     // Mirror RealmOptions.
     void setSingletonsAsValues();
@@ -144,6 +150,10 @@ class JitCompileOptions
     }
 #endif
 
+    const SpectreMitigations& spectreMitigations() const {
+        return spectreMitigations_;
+    }
+
   private:
     bool cloneSingletons_;
     bool profilerSlowAssertionsEnabled_;
@@ -151,6 +161,7 @@ class JitCompileOptions
 #ifdef ENABLE_WASM_GC
     bool wasmGcEnabled_;
 #endif
+    SpectreMitigations spectreMitigations_;
 };
 
 } // namespace jit
@@ -27,6 +27,7 @@
 
 #include "jit/ExecutableAllocator.h"
 
+#include "gc/Memory.h"
 #include "jit/JitRealm.h"
 #include "js/MemoryMetrics.h"
 
@@ -97,8 +98,10 @@ ExecutablePool::available() const
 
 ExecutableAllocator::~ExecutableAllocator()
 {
-    for (size_t i = 0; i < m_smallPools.length(); i++) {
-        m_smallPools[i]->release(/* willDestroy = */true);
+    for (SmallExecPoolVector& smallPools : m_smallPools) {
+        for (size_t i = 0; i < smallPools.length(); i++) {
+            smallPools[i]->release(/* willDestroy = */true);
+        }
     }
 
     // If this asserts we have a pool leak.
@@ -107,16 +110,18 @@ ExecutableAllocator::~ExecutableAllocator()
 }
 
 ExecutablePool*
-ExecutableAllocator::poolForSize(size_t n)
+ExecutableAllocator::poolForSize(size_t n, CodeArena arena)
 {
+    SmallExecPoolVector& smallPools = m_smallPools[arena];
+
     // Try to fit in an existing small allocator.  Use the pool with the
     // least available space that is big enough (best-fit).  This is the
     // best strategy because (a) it maximizes the chance of the next
     // allocation fitting in a small pool, and (b) it minimizes the
     // potential waste when a small pool is next abandoned.
     ExecutablePool* minPool = nullptr;
-    for (size_t i = 0; i < m_smallPools.length(); i++) {
-        ExecutablePool* pool = m_smallPools[i];
+    for (size_t i = 0; i < smallPools.length(); i++) {
+        ExecutablePool* pool = smallPools[i];
         if (n <= pool->available() && (!minPool || pool->available() < minPool->available())) {
             minPool = pool;
         }
@@ -128,37 +133,37 @@ ExecutableAllocator::poolForSize(size_t n)
 
     // If the request is large, we just provide a unshared allocator
     if (n > ExecutableCodePageSize) {
-        return createPool(n);
+        return createPool(n, arena);
     }
 
     // Create a new allocator
-    ExecutablePool* pool = createPool(ExecutableCodePageSize);
+    ExecutablePool* pool = createPool(ExecutableCodePageSize, arena);
     if (!pool) {
         return nullptr;
     }
     // At this point, local |pool| is the owner.
 
-    if (m_smallPools.length() < maxSmallPools) {
+    if (smallPools.length() < maxSmallPools) {
         // We haven't hit the maximum number of live pools; add the new pool.
         // If append() OOMs, we just return an unshared allocator.
-        if (m_smallPools.append(pool)) {
+        if (smallPools.append(pool)) {
             pool->addRef();
         }
     } else {
         // Find the pool with the least space.
         int iMin = 0;
-        for (size_t i = 1; i < m_smallPools.length(); i++) {
-            if (m_smallPools[i]->available() < m_smallPools[iMin]->available()) {
+        for (size_t i = 1; i < smallPools.length(); i++) {
+            if (smallPools[i]->available() < smallPools[iMin]->available()) {
                 iMin = i;
             }
         }
 
         // If the new allocator will result in more free space than the small
         // pool with the least space, then we will use it instead
-        ExecutablePool* minPool = m_smallPools[iMin];
+        ExecutablePool* minPool = smallPools[iMin];
         if ((pool->available() - n) > minPool->available()) {
             minPool->release();
-            m_smallPools[iMin] = pool;
+            smallPools[iMin] = pool;
             pool->addRef();
         }
     }
@@ -182,14 +187,14 @@ ExecutableAllocator::roundUpAllocationSize(size_t request, size_t granularity)
 }
 
 ExecutablePool*
-ExecutableAllocator::createPool(size_t n)
+ExecutableAllocator::createPool(size_t n, CodeArena arena)
 {
     size_t allocSize = roundUpAllocationSize(n, ExecutableCodePageSize);
     if (allocSize == OVERSIZE_ALLOCATION) {
         return nullptr;
     }
 
-    ExecutablePool::Allocation a = systemAlloc(allocSize);
+    ExecutablePool::Allocation a = systemAlloc(allocSize, arena);
     if (!a.pages) {
         return nullptr;
     }
@@ -222,7 +227,7 @@ ExecutableAllocator::alloc(JSContext* cx, size_t n, ExecutablePool** poolp, Code
         return nullptr;
     }
 
-    *poolp = poolForSize(n);
+    *poolp = poolForSize(n, CodeArenaForKind(type));
     if (!*poolp) {
         return nullptr;
     }
@@ -252,18 +257,20 @@ ExecutableAllocator::releasePoolPages(ExecutablePool* pool)
 void
 ExecutableAllocator::purge()
 {
-    for (size_t i = 0; i < m_smallPools.length(); ) {
-        ExecutablePool* pool = m_smallPools[i];
-        if (pool->m_refCount > 1) {
-            // Releasing this pool is not going to deallocate it, so we might as
-            // well hold on to it and reuse it for future allocations.
-            i++;
-            continue;
-        }
+    for (SmallExecPoolVector& smallPools : m_smallPools) {
+        for (size_t i = 0; i < smallPools.length(); ) {
+            ExecutablePool* pool = smallPools[i];
+            if (pool->m_refCount > 1) {
+                // Releasing this pool is not going to deallocate it, so we might
+                // as well hold on to it and reuse it for future allocations.
+                i++;
+                continue;
+            }
 
-        MOZ_ASSERT(pool->m_refCount == 1);
-        pool->release();
-        m_smallPools.erase(&m_smallPools[i]);
+            MOZ_ASSERT(pool->m_refCount == 1);
+            pool->release();
+            smallPools.erase(&smallPools[i]);
+        }
     }
 }
 
@@ -337,10 +344,10 @@ ExecutableAllocator::poisonCode(JSRuntime* rt, JitPoisonRangeVector& ranges)
 }
 
 ExecutablePool::Allocation
-ExecutableAllocator::systemAlloc(size_t n)
+ExecutableAllocator::systemAlloc(size_t n, CodeArena arena)
 {
-    void* allocation =
-        AllocateExecutableMemory(n, ProtectionSetting::Executable, MemCheckKind::MakeNoAccess);
+    void* allocation = AllocateExecutableMemory(n, ProtectionSetting::Executable,
+                                                MemCheckKind::MakeNoAccess, arena);
     ExecutablePool::Allocation alloc = { reinterpret_cast<char*>(allocation), n };
     return alloc;
 }
@@ -350,3 +357,87 @@ ExecutableAllocator::systemRelease(const ExecutablePool::Allocation& alloc)
 {
     DeallocateExecutableMemory(alloc.pages, alloc.size);
 }
+
+AutoBatchJitCodeReprotection::AutoBatchJitCodeReprotection(JSRuntime* rt)
+  : rt_(rt),
+    active_(!rt->jitCodeReprotectionBatch())
+{
+    if (active_) {
+        rt_->setJitCodeReprotectionBatch(this);
+    }
+}
+
+AutoBatchJitCodeReprotection::~AutoBatchJitCodeReprotection()
+{
+    if (active_) {
+        flush();
+        rt_->setJitCodeReprotectionBatch(nullptr);
+    }
+}
+
+void
+AutoBatchJitCodeReprotection::flush()
+{
+    for (const PageRange& range : ranges_) {
+        if (!ExecutableAllocator::makeExecutable(reinterpret_cast<void*>(range.start),
+                                                 range.end - range.start))
+        {
+            MOZ_CRASH();
+        }
+    }
+    ranges_.clear();
+}
+
+bool
+AutoBatchJitCodeReprotection::makeWritable(void* addr, size_t size)
+{
+    MOZ_ASSERT(active_);
+
+    uintptr_t pageSize = js::gc::SystemPageSize();
+    uintptr_t start = uintptr_t(addr) & ~(pageSize - 1);
+    uintptr_t end = (uintptr_t(addr) + size + pageSize - 1) & ~(pageSize - 1);
+
+    // Find the first range which overlaps or is adjacent to the new one.
+    size_t lo = 0, hi = ranges_.length();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (ranges_[mid].end < start) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    size_t index = lo;
+
+    if (index < ranges_.length() &&
+        ranges_[index].start <= start && end <= ranges_[index].end)
+    {
+        // Already writable.
+        return true;
+    }
+
+    // Make sure the new range can be recorded before changing any protection.
+    // Flushing is fine here: the regions in the batch are only written to
+    // while their AutoWritableJitCode is live, and they cannot be nested.
+    if (ranges_.length() >= MaxRanges || !ranges_.reserve(ranges_.length() + 1)) {
+        flush();
+        if (!ranges_.reserve(1)) {
+            return false;
+        }
+        index = 0;
+    }
+
+    if (!ExecutableAllocator::makeWritable(reinterpret_cast<void*>(start), end - start)) {
+        return false;
+    }
+
+    // Insert the new range and merge it with any ranges it touches.
+    PageRange range = { start, end };
+    MOZ_ALWAYS_TRUE(ranges_.insert(ranges_.begin() + index, range));
+    while (index + 1 < ranges_.length() && ranges_[index + 1].start <= ranges_[index].end) {
+        ranges_[index].start = js::Min(ranges_[index].start, ranges_[index + 1].start);
+        ranges_[index].end = js::Max(ranges_[index].end, ranges_[index + 1].end);
+        ranges_.erase(ranges_.begin() + index + 1);
+    }
+    return true;
+}
@@ -91,6 +91,25 @@ enum class CodeKind : uint8_t {
     Count
 };
 
+// The arena of executable memory from which code of each kind is allocated.
+// Code of different arenas never shares a pool.
+static inline CodeArena
+CodeArenaForKind(CodeKind kind)
+{
+    switch (kind) {
+      case CodeKind::Ion:
+      case CodeKind::RegExp:
+        return CodeArena::Hot;
+      case CodeKind::Other:
+        return CodeArena::Stubs;
+      case CodeKind::Baseline:
+        return CodeArena::Cold;
+      case CodeKind::Count:
+        break;
+    }
+    MOZ_CRASH("Invalid CodeKind");
+}
+
 class ExecutableAllocator;
 class JitRuntime;
 
@@ -203,11 +222,11 @@ class ExecutableAllocator
     static size_t roundUpAllocationSize(size_t request, size_t granularity);
 
     // On OOM, this will return an Allocation where pages is nullptr.
-    ExecutablePool::Allocation systemAlloc(size_t n);
+    ExecutablePool::Allocation systemAlloc(size_t n, CodeArena arena);
     static void systemRelease(const ExecutablePool::Allocation& alloc);
 
-    ExecutablePool* createPool(size_t n);
-    ExecutablePool* poolForSize(size_t n);
+    ExecutablePool* createPool(size_t n, CodeArena arena);
+    ExecutablePool* poolForSize(size_t n, CodeArena arena);
 
     static void reprotectPool(JSRuntime* rt, ExecutablePool* pool, ProtectionSetting protection);
 
@@ -320,10 +339,11 @@ class ExecutableAllocator
     ExecutableAllocator(const ExecutableAllocator&) = delete;
     void operator=(const ExecutableAllocator&) = delete;
 
-    // These are strong references;  they keep pools alive.
+    // These are strong references;  they keep pools alive. Each arena has its
+    // own small pools, so that hot code isn't interleaved with cold code.
     static const size_t maxSmallPools = 4;
     typedef js::Vector<ExecutablePool*, maxSmallPools, js::SystemAllocPolicy> SmallExecPoolVector;
-    SmallExecPoolVector m_smallPools;
+    mozilla::EnumeratedArray<CodeArena, CodeArena::Count, SmallExecPoolVector> m_smallPools;
 
     // All live pools are recorded here, just for stats purposes.  These are
     // weak references;  they don't keep pools alive.  When a pool is destroyed
@@ -0,0 +1,232 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+// Statistics about the inline caches of Baseline and Ion code, for finding the
+// property accesses and calls that are megamorphic or keep falling back to the
+// VM.
+
+#include <string.h>
+
+#include "jsfriendapi.h"
+
+#include "gc/PublicIterators.h"
+#include "jit/BaselineIC.h"
+#include "jit/BaselineJIT.h"
+#include "jit/CacheIRCompiler.h"
+#include "jit/IonCode.h"
+#include "jit/IonIC.h"
+#include "vm/BytecodeUtil.h"
+#include "vm/JSContext.h"
+#include "vm/JSONPrinter.h"
+#include "vm/JSScript.h"
+#include "vm/Printer.h"
+
+#include "gc/GC-inl.h"
+
+using namespace js;
+using namespace js::jit;
+
+namespace {
+
+// The number of stubs attached to one IC, by the name the IR generator gave
+// them. ICs have few stubs, so a linear search is fine.
+class StubKindCounts
+{
+    struct Entry
+    {
+        const char* name;
+        uint32_t count;
+    };
+
+    Vector<Entry, 8, SystemAllocPolicy> entries_;
+
+  public:
+    MOZ_MUST_USE bool add(const char* name) {
+        for (Entry& entry : entries_) {
+            if (strcmp(entry.name, name) == 0) {
+                entry.count++;
+                return true;
+            }
+        }
+        return entries_.append(Entry { name, 1 });
+    }
+
+    void write(JSONPrinter& json) const {
+        json.beginObjectProperty("stubKinds");
+        for (const Entry& entry : entries_) {
+            json.property(entry.name, entry.count);
+        }
+        json.endObject();
+    }
+};
+
+} // anonymous namespace
+
+static const char*
+ICStateModeName(ICState::Mode mode)
+{
+    switch (mode) {
+      case ICState::Mode::Specialized:
+        return "Specialized";
+      case ICState::Mode::Megamorphic:
+        return "Megamorphic";
+      case ICState::Mode::Generic:
+        return "Generic";
+    }
+    MOZ_CRASH("Invalid ICState mode");
+}
+
+static void
+FilenameProperty(JSONPrinter& json, GenericPrinter& out, const char* name, JSScript* script)
+{
+    json.beginStringProperty(name);
+    for (const char* s = script->filename() ? script->filename() : ""; *s; s++) {
+        unsigned char c = *s;
+        if (c == '"' || c == '\\') {
+            out.putChar('\\');
+            out.putChar(c);
+        } else if (c < 0x20) {
+            out.printf("\\u%04x", c);
+        } else {
+            out.putChar(c);
+        }
+    }
+    json.endStringProperty();
+}
+
+static const char*
+StubKindName(const CacheIRStubInfo* stubInfo)
+{
+    if (stubInfo->name()) {
+        return stubInfo->name();
+    }
+    return CacheKindNames[uint8_t(stubInfo->kind())];
+}
+
+static void
+WriteSiteLocation(JSONPrinter& json, JSScript* script, jsbytecode* pc)
+{
+    json.property("pcOffset", uint32_t(script->pcToOffset(pc)));
+    json.property("line", uint32_t(PCToLineNumber(script, pc)));
+    json.property("op", CodeName[JSOp(*pc)]);
+}
+
+static bool
+WriteBaselineICs(JSONPrinter& json, JSScript* script)
+{
+    BaselineScript* baselineScript = script->baselineScript();
+
+    json.beginListProperty("baseline");
+    for (size_t i = 0; i < baselineScript->numICEntries(); i++) {
+        ICEntry& entry = baselineScript->icEntry(i);
+        if (!entry.isForOp() || !entry.hasStub()) {
+            continue;
+        }
+
+        ICFallbackStub* fallback = entry.fallbackStub();
+        StubKindCounts kinds;
+        for (ICStubConstIterator iter = fallback->beginChainConst(); !iter.atEnd(); iter++) {
+            const ICStub* stub = *iter;
+            const CacheIRStubInfo* stubInfo = stub->cacheIRStubInfo();
+            const char* name = stubInfo ? StubKindName(stubInfo) : ICStub::KindString(stub->kind());
+            if (!kinds.add(name)) {
+                return false;
+            }
+        }
+
+        json.beginObject();
+        WriteSiteLocation(json, script, entry.pc(script));
+        json.property("fallback", ICStub::KindString(fallback->kind()));
+        json.property("mode", ICStateModeName(fallback->state().mode()));
+        json.property("stubs", uint32_t(fallback->numOptimizedStubs()));
+        json.property("fallbackHits", fallback->enteredCount());
+        kinds.write(json);
+        json.endObject();
+    }
+    json.endList();
+    return true;
+}
+
+static bool
+WriteIonICs(JSONPrinter& json, GenericPrinter& out, JSScript* script)
+{
+    IonScript* ionScript = script->ionScript();
+
+    json.beginListProperty("ion");
+    for (size_t i = 0; i < ionScript->numICs(); i++) {
+        IonIC& ic = ionScript->getICFromIndex(i);
+
+        StubKindCounts kinds;
+        uint32_t numStubs = 0;
+        for (IonICStub* stub = ic.firstStub(); stub; stub = stub->next()) {
+            if (!kinds.add(StubKindName(stub->stubInfo()))) {
+                return false;
+            }
+            numStubs++;
+        }
+
+        json.beginObject();
+        json.property("kind", CacheKindNames[uint8_t(ic.kind())]);
+
+        // Idempotent caches aren't tied to a bytecode op.
+        if (!ic.idempotent()) {
+            if (ic.script() != script) {
+                FilenameProperty(json, out, "inlinedFrom", ic.script());
+                json.property("inlinedLine", uint32_t(ic.script()->lineno()));
+            }
+            WriteSiteLocation(json, ic.script(), ic.pc());
+        }
+        json.property("mode", ICStateModeName(ic.state().mode()));
+        json.property("stubs", numStubs);
+        json.property("fallbackHits", ic.enteredCount());
+        kinds.write(json);
+        json.endObject();
+    }
+    json.endList();
+    return true;
+}
+
+JS_FRIEND_API(bool)
+js::DumpICStats(JSContext* cx, FILE* fp)
+{
+    // Iterating the scripts of a zone doesn't allow GC, and nothing below
+    // allocates on the GC heap.
+    JS::AutoAssertNoGC nogc(cx);
+
+    Fprinter out(fp);
+    JSONPrinter json(out);
+    json.beginObject();
+    json.beginListProperty("scripts");
+
+    for (ZonesIter zone(cx->runtime(), SkipAtoms); !zone.done(); zone.next()) {
+        for (auto iter = zone->cellIter<JSScript>(); !iter.done(); iter.next()) {
+            JSScript* script = iter;
+            if (!script->hasBaselineScript()) {
+                continue;
+            }
+
+            json.beginObject();
+            FilenameProperty(json, out, "filename", script);
+            json.property("line", uint32_t(script->lineno()));
+            json.property("column", uint32_t(script->column()));
+            if (!WriteBaselineICs(json, script)) {
+                ReportOutOfMemory(cx);
+                return false;
+            }
+            if (script->hasIonScript() && !WriteIonICs(json, out, script)) {
+                ReportOutOfMemory(cx);
+                return false;
+            }
+            json.endObject();
+        }
+    }
+
+    json.endList();
+    json.endObject();
+    out.put("\n");
+    out.finish();
+    return true;
+}
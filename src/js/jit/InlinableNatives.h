@@ -29,12 +29,32 @@
                                     \
     _(Boolean)                      \
                                     \
+    _(DataViewGetInt8)              \
+    _(DataViewGetUint8)             \
+    _(DataViewGetInt16)             \
+    _(DataViewGetUint16)            \
+    _(DataViewGetInt32)             \
+    _(DataViewGetUint32)            \
+    _(DataViewGetFloat32)           \
+    _(DataViewGetFloat64)           \
+    _(DataViewSetInt8)              \
+    _(DataViewSetUint8)             \
+    _(DataViewSetInt16)             \
+    _(DataViewSetUint16)            \
+    _(DataViewSetInt32)             \
+    _(DataViewSetUint32)            \
+    _(DataViewSetFloat32)           \
+    _(DataViewSetFloat64)           \
+                                    \
     _(IntlGuardToCollator)          \
     _(IntlGuardToDateTimeFormat)    \
     _(IntlGuardToNumberFormat)      \
     _(IntlGuardToPluralRules)       \
     _(IntlGuardToRelativeTimeFormat) \
                                     \
+    _(MapGet)                       \
+    _(MapHas)                       \
+                                    \
     _(MathAbs)                      \
     _(MathFloor)                    \
     _(MathCeil)                     \
@@ -73,6 +93,8 @@
                                     \
     _(ReflectGetPrototypeOf)        \
                                     \
+    _(SetHas)                       \
+                                    \
     _(RegExpMatcher)                \
     _(RegExpSearcher)               \
     _(RegExpTester)                 \
@@ -120,6 +142,9 @@
     _(IntrinsicObjectHasPrototype)  \
     _(IntrinsicFinishBoundFunctionInit) \
     _(IntrinsicIsPackedArray)       \
+    _(IntrinsicArrayNativeIndexOf)  \
+    _(IntrinsicArrayNativeLastIndexOf) \
+    _(IntrinsicArrayNativeIncludes) \
                                     \
     _(IntrinsicGuardToArrayIterator) \
     _(IntrinsicGuardToMapIterator)  \
@@ -147,6 +172,10 @@
     _(IntrinsicTypedArrayLength)    \
     _(IntrinsicPossiblyWrappedTypedArrayLength)    \
     _(IntrinsicSetDisjointTypedElements) \
+    _(IntrinsicTypedArrayNativeFill) \
+    _(IntrinsicTypedArrayNativeIndexOf) \
+    _(IntrinsicTypedArrayNativeLastIndexOf) \
+    _(IntrinsicTypedArrayNativeIncludes) \
                                     \
     _(IntrinsicObjectIsTypedObject) \
     _(IntrinsicObjectIsTransparentTypedObject) \
@@ -50,6 +50,7 @@
 #include "util/Windows.h"
 #include "vm/Debugger.h"
 #include "vm/HelperThreads.h"
+#include "vm/PerfCounters.h"
 #include "vm/Realm.h"
 #include "vm/TraceLogging.h"
 #include "vtune/VTuneWrapper.h"
@@ -169,6 +170,7 @@ jit::InitializeIon()
 JitRuntime::JitRuntime()
   : execAlloc_(),
     nextCompilationId_(0),
+    agedCodeBytesDiscarded_(0),
     exceptionTailOffset_(0),
     bailoutTailOffset_(0),
     profilerExitFrameTailOffset_(0),
@@ -183,6 +185,7 @@ JitRuntime::JitRuntime()
     baselineDebugModeOSRHandler_(nullptr),
     trampolineCode_(nullptr),
     functionWrappers_(nullptr),
+    allVMWrappersGenerated_(false),
     jitcodeGlobalTable_(nullptr),
 #ifdef DEBUG
     ionBailAfter_(0),
@@ -302,18 +305,6 @@ JitRuntime::initialize(JSContext* cx)
     JitSpew(JitSpew_Codegen, "# Emitting interpreter stub");
     generateInterpreterStub(masm);
 
-    JitSpew(JitSpew_Codegen, "# Emitting VM function wrappers");
-    for (VMFunction* fun = VMFunction::functions; fun; fun = fun->next) {
-        if (functionWrappers_->has(fun)) {
-            // Duplicate VMFunction definition. See VMFunction::hash.
-            continue;
-        }
-        JitSpew(JitSpew_Codegen, "# VM function wrapper (%s)", fun->name());
-        if (!generateVMWrapper(cx, masm, *fun)) {
-            return false;
-        }
-    }
-
     JitSpew(JitSpew_Codegen, "# Emitting profiler exit frame tail stub");
     Label profilerExitTail;
     generateProfilerExitFrameTailStub(masm, &profilerExitTail);
@@ -648,6 +639,7 @@ void
 JitZone::sweep()
 {
     baselineCacheIRStubCodes_.sweep();
+    bailoutCounts_.sweep();
 }
 
 size_t
@@ -669,6 +661,7 @@ JitZone::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf,
     *jitZone += mallocSizeOf(this);
     *jitZone += baselineCacheIRStubCodes_.shallowSizeOfExcludingThis(mallocSizeOf);
     *jitZone += ionCacheIRStubInfoSet_.shallowSizeOfExcludingThis(mallocSizeOf);
+    *jitZone += bailoutCounts_.sizeOfExcludingThis(mallocSizeOf);
 
     *baselineStubsOptimized += optimizedStubSpace_.sizeOfExcludingThis(mallocSizeOf);
     *cachedCFG += cfgSpace_.sizeOfExcludingThis(mallocSizeOf);
@@ -696,7 +689,114 @@ JitRuntime::getVMWrapper(const VMFunction& f) const
 
     JitRuntime::VMWrapperMap::Ptr p = functionWrappers_->readonlyThreadsafeLookup(&f);
     MOZ_ASSERT(p);
-    return trampolineCode(p->value());
+    return TrampolinePtr(p->value());
+}
+
+bool
+JitRuntime::ensureVMWrapper(JSContext* cx, const VMFunction& f)
+{
+    MOZ_ASSERT(functionWrappers_);
+
+    if (allVMWrappersGenerated_ || functionWrappers_->readonlyThreadsafeLookup(&f)) {
+        return true;
+    }
+    return generateVMWrappers(cx, &f);
+}
+
+bool
+JitRuntime::ensureAllVMWrappers(JSContext* cx)
+{
+    if (allVMWrappersGenerated_) {
+        return true;
+    }
+    if (!generateVMWrappers(cx, nullptr)) {
+        return false;
+    }
+    allVMWrappersGenerated_ = true;
+    return true;
+}
+
+// Generate the wrapper for |only|, or if it's null, the wrappers for all the
+// VMFunctions which don't have one yet, into a new piece of code.
+bool
+JitRuntime::generateVMWrappers(JSContext* cx, const VMFunction* only)
+{
+    MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+    MOZ_ASSERT(!allVMWrappersGenerated_);
+
+    // Wrappers are shared by all realms, like the other trampolines.
+    AutoAllocInAtomsZone az(cx);
+
+    JitContext jctx(cx, nullptr);
+    StackMacroAssembler masm;
+
+    struct PendingWrapper
+    {
+        const VMFunction* fun;
+        uint32_t offset;
+    };
+    Vector<PendingWrapper, 0, TempAllocPolicy> pending(cx);
+    HashSet<const VMFunction*, VMFunction, TempAllocPolicy> seen(cx);
+
+    auto generate = [&](const VMFunction* fun) {
+        if (functionWrappers_->has(fun)) {
+            return true;
+        }
+
+        // Duplicate VMFunction definitions share a wrapper. See
+        // VMFunction::hash.
+        auto p = seen.lookupForAdd(fun);
+        if (p) {
+            return true;
+        }
+        if (!seen.add(p, fun)) {
+            return false;
+        }
+
+        JitSpew(JitSpew_Codegen, "# VM function wrapper (%s)", fun->name());
+        uint32_t offset;
+        if (!generateVMWrapper(cx, masm, *fun, &offset)) {
+            return false;
+        }
+        return pending.append(PendingWrapper { fun, offset });
+    };
+
+    if (only) {
+        if (!generate(only)) {
+            return false;
+        }
+    } else {
+        for (const VMFunction* fun = VMFunction::functions; fun; fun = fun->next) {
+            if (!generate(fun)) {
+                return false;
+            }
+        }
+    }
+
+    if (pending.empty()) {
+        return true;
+    }
+
+    Linker linker(masm);
+    AutoFlushICache afc("VMWrappers");
+    JitCode* code = linker.newCode(cx, CodeKind::Other);
+    if (!code) {
+        return false;
+    }
+
+#ifdef JS_ION_PERF
+    writePerfSpewerJitCodeProfile(code, "VMWrappers");
+#endif
+#ifdef MOZ_VTUNE
+    vtune::MarkStub(code, "VMWrappers");
+#endif
+
+    for (const PendingWrapper& wrapper : pending) {
+        if (!functionWrappers_->putNew(wrapper.fun, code->raw() + wrapper.offset)) {
+            return false;
+        }
+    }
+    return true;
 }
 
 void
@@ -1501,10 +1601,14 @@ OptimizeMIR(MIRGenerator* mir)
     if (mir->optimizationInfo().licmEnabled()) {
         AutoTraceLog log(logger, TraceLogger_LICM);
         // LICM can hoist instructions from conditional branches and trigger
-        // repeated bailouts. Disable it if this script is known to bailout
-        // frequently.
+        // repeated bailouts. LICM skips loops containing sites which bailed
+        // out frequently, but if a script has been invalidated for frequent
+        // bailouts without any such site, disable it for the whole script.
         JSScript* script = mir->info().script();
-        if (!script || !script->hadFrequentBailouts()) {
+        if (!script || !script->hadFrequentBailouts() ||
+            script->zone()->jitZone()->bailoutCounts().hasFrequentBailoutSite(script, 0,
+                                                                              script->length()))
+        {
             if (!LICM(mir, graph)) {
                 return false;
             }
@@ -1742,7 +1846,7 @@ OptimizeMIR(MIRGenerator* mir)
         // instructions. Since check uses are replaced with the actual index,
         // code motion after this pass could incorrectly move a load or store
         // before its bounds check.
-        if (!EliminateRedundantChecks(graph)) {
+        if (!EliminateRedundantChecks(mir, graph)) {
             return false;
         }
         gs.spewPass("Bounds Check Elimination");
@@ -1758,6 +1862,22 @@ OptimizeMIR(MIRGenerator* mir)
         AssertGraphCoherency(graph);
     }
 
+    if (!JitOptions.disableColdBlocks) {
+        AutoTraceLog log(logger, TraceLogger_MarkColdBlocks);
+        if (!MarkColdBlocks(mir, graph)) {
+            return false;
+        }
+        gs.spewPass("Mark Cold Blocks");
+    }
+
+    if (!mir->compilingWasm() && !JitOptions.disableInitPreBarrierElimination) {
+        AutoTraceLog log(logger, TraceLogger_EliminateInitPreBarriers);
+        if (!EliminateInitPreBarriers(mir, graph)) {
+            return false;
+        }
+        gs.spewPass("Eliminate Init Pre-Barriers");
+    }
+
     AssertGraphCoherency(graph, /* force = */ true);
 
     DumpMIRExpressions(graph);
@@ -1798,9 +1918,21 @@ GenerateLIR(MIRGenerator* mir)
 
         IonRegisterAllocator allocator = mir->optimizationInfo().registerAllocator();
 
+        // Backtracking allocation time grows quickly with the size of the
+        // function, so prefer faster allocation for huge functions unless a
+        // specific allocator was requested.
+        if (allocator == RegisterAllocator_Backtracking &&
+            JitOptions.forcedRegisterAllocator.isNothing() &&
+            JitOptions.linearScanVirtualRegisterThreshold &&
+            lir->numVirtualRegisters() >= JitOptions.linearScanVirtualRegisterThreshold)
+        {
+            allocator = RegisterAllocator_LinearScan;
+        }
+
         switch (allocator) {
           case RegisterAllocator_Backtracking:
-          case RegisterAllocator_Testbed: {
+          case RegisterAllocator_Testbed:
+          case RegisterAllocator_LinearScan: {
 #ifdef DEBUG
             if (JitOptions.fullDebugChecks) {
                 if (!integrity.record()) {
@@ -1810,7 +1942,8 @@ GenerateLIR(MIRGenerator* mir)
 #endif
 
             BacktrackingAllocator regalloc(mir, &lirgen, *lir,
-                                           allocator == RegisterAllocator_Testbed);
+                                           allocator == RegisterAllocator_Testbed,
+                                           allocator == RegisterAllocator_LinearScan);
             if (!regalloc.go()) {
                 return nullptr;
             }
@@ -1823,7 +1956,9 @@ GenerateLIR(MIRGenerator* mir)
             }
 #endif
 
-            gs.spewPass("Allocate Registers [Backtracking]");
+            gs.spewPass(allocator == RegisterAllocator_LinearScan
+                        ? "Allocate Registers [LinearScan]"
+                        : "Allocate Registers [Backtracking]");
             break;
           }
 
@@ -1875,12 +2010,54 @@ GenerateCode(MIRGenerator* mir, LIRGraph* lir)
     return codegen.release();
 }
 
+// If JitOptions.ionPerfCounters is set, report the hardware performance
+// counters of the thread during a back end compilation on stderr, as one JSON
+// object per line.
+class MOZ_RAII AutoReportIonPerfCounters
+{
+    MIRGenerator* mir_;
+    PerfCounters counters_;
+    PerfCounterValues start_;
+
+  public:
+    explicit AutoReportIonPerfCounters(MIRGenerator* mir)
+      : mir_(mir)
+    {
+        if (JitOptions.ionPerfCounters && counters_.init()) {
+            counters_.read(&start_);
+        }
+    }
+
+    ~AutoReportIonPerfCounters() {
+        if (!counters_.initialized()) {
+            return;
+        }
+
+        PerfCounterValues end;
+        counters_.read(&end);
+        PerfCounterValues values = end - start_;
+
+        JSScript* script = mir_->info().script();
+        const char* filename = script && script->filename() ? script->filename() : "wasm";
+        fprintf(stderr,
+                "{\"ion_compile\":\"%s:%u\",\"cycles\":%" PRIu64 ",\"instructions\":%" PRIu64
+                ",\"llc_misses\":%" PRIu64 ",\"dtlb_misses\":%" PRIu64 "}\n",
+                filename,
+                script ? unsigned(script->lineno()) : 0,
+                values.counts[PerfCounterKind::Cycles],
+                values.counts[PerfCounterKind::Instructions],
+                values.counts[PerfCounterKind::LLCMisses],
+                values.counts[PerfCounterKind::DTLBMisses]);
+    }
+};
+
 CodeGenerator*
 CompileBackEnd(MIRGenerator* mir)
 {
     // Everything in CompileBackEnd can potentially run on a helper thread.
     AutoEnterIonCompilation enter(mir->safeForMinorGC());
     AutoSpewEndFunction spewEndFunction(mir);
+    AutoReportIonPerfCounters reportPerfCounters(mir);
 
     if (!OptimizeMIR(mir)) {
         return nullptr;
@@ -2052,6 +2229,7 @@ IonCompile(JSContext* cx, JSScript* script,
     if (!alloc) {
         return AbortReason::Alloc;
     }
+    alloc->setUseHugePages();
 
     TempAllocator* temp = alloc->new_<TempAllocator>(alloc.get());
     if (!temp) {
@@ -2064,6 +2242,11 @@ IonCompile(JSContext* cx, JSScript* script,
         return AbortReason::Alloc;
     }
 
+    // The code generator runs off thread, where VM wrappers can't be created.
+    if (!cx->runtime()->jitRuntime()->ensureAllVMWrappers(cx)) {
+        return AbortReason::Alloc;
+    }
+
     if (!cx->realm()->jitRealm()->ensureIonStubsExist(cx)) {
         return AbortReason::Alloc;
     }
@@ -2919,6 +3102,7 @@ jit::InvalidateAll(FreeOp* fop, Zone* zone)
         return;
     }
     JSContext* cx = TlsContext.get();
+    AutoBatchJitCodeReprotection batch(cx->runtime());
     for (JitActivationIterator iter(cx); !iter.done(); ++iter) {
         if (iter->compartment()->zone() == zone) {
             JitSpew(JitSpew_IonInvalidate, "Invalidating all frames for GC");
@@ -2977,8 +3161,11 @@ jit::Invalidate(TypeZone& types, FreeOp* fop,
     }
 
     JSContext* cx = TlsContext.get();
-    for (JitActivationIterator iter(cx); !iter.done(); ++iter) {
-        InvalidateActivation(fop, iter, false);
+    {
+        AutoBatchJitCodeReprotection batch(cx->runtime());
+        for (JitActivationIterator iter(cx); !iter.done(); ++iter) {
+            InvalidateActivation(fop, iter, false);
+        }
     }
 
     // Drop the references added above. If a script was never active, its
@@ -3018,6 +3205,13 @@ void
 jit::Invalidate(JSContext* cx, const RecompileInfoVector& invalid, bool resetUses,
                 bool cancelOffThread)
 {
+    for (const RecompileInfo& info : invalid) {
+        if (info.maybeIonScriptToInvalidate(cx->zone()->types)) {
+            JSScript* script = info.script();
+            script->zone()->jitZone()->bailoutCounts().recordInvalidation(script);
+        }
+    }
+
     jit::Invalidate(cx->zone()->types, cx->runtime()->defaultFreeOp(), invalid, resetUses,
                     cancelOffThread);
 }
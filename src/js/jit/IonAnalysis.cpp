@@ -3834,7 +3834,7 @@ TryOptimizeLoadObjectOrNull(MDefinition* def, MDefinitionVector* peliminateList)
 }
 
 static inline MDefinition*
-PassthroughOperand(MDefinition* def)
+PassthroughOperand(MDefinition* def, const SpectreMitigations& spectre)
 {
     if (def->isConvertElementsToDoubles()) {
         return def->toConvertElementsToDoubles()->elements();
@@ -3842,7 +3842,7 @@ PassthroughOperand(MDefinition* def)
     if (def->isMaybeCopyElementsForWrite()) {
         return def->toMaybeCopyElementsForWrite()->object();
     }
-    if (!JitOptions.spectreObjectMitigationsMisc) {
+    if (!spectre.objectMitigationsMisc) {
         // If Spectre mitigations are enabled, LConvertUnboxedObjectToNative
         // needs to have its own def.
         if (def->isConvertUnboxedObjectToNative()) {
@@ -3866,7 +3866,7 @@ PassthroughOperand(MDefinition* def)
 // differences in constant offset, this offers a fast way to find redundant
 // checks.
 bool
-jit::EliminateRedundantChecks(MIRGraph& graph)
+jit::EliminateRedundantChecks(MIRGenerator* mir, MIRGraph& graph)
 {
     BoundsCheckMap checks(graph.alloc());
 
@@ -3926,7 +3926,7 @@ jit::EliminateRedundantChecks(MIRGraph& graph)
                 // Now that code motion passes have finished, replace
                 // instructions which pass through one of their operands
                 // (and perform additional checks) with that operand.
-                if (MDefinition* passthrough = PassthroughOperand(def)) {
+                if (MDefinition* passthrough = PassthroughOperand(def, mir->spectre())) {
                     def->replaceAllUsesWith(passthrough);
                 }
                 break;
@@ -4076,6 +4076,143 @@ jit::AddKeepAliveInstructions(MIRGraph& graph)
     return true;
 }
 
+// IonBuilder marks the blocks which Baseline code never executed as cold. Also
+// mark the blocks which end in a bailout or a trap, and the blocks which can
+// only be entered from cold blocks, so that code generation can move all of
+// them out of the way of the hot path.
+bool
+jit::MarkColdBlocks(MIRGenerator* mir, MIRGraph& graph)
+{
+    for (ReversePostorderIterator block(graph.rpoBegin()); block != graph.rpoEnd(); block++) {
+        if (mir->shouldCancel("Mark cold blocks")) {
+            return false;
+        }
+
+        // The entry blocks are entered from the prologue and OSR code, and
+        // loop headers are also entered from their backedge, which has not
+        // been visited yet.
+        if (*block == graph.entryBlock() || *block == graph.osrBlock() ||
+            block->isLoopHeader() || block->isCold())
+        {
+            continue;
+        }
+
+        if (block->lastIns()->isUnreachable()) {
+            block->setCold();
+            continue;
+        }
+
+        bool allPredecessorsCold = block->numPredecessors() > 0;
+        for (size_t i = 0; i < block->numPredecessors(); i++) {
+            if (!block->getPredecessor(i)->isCold()) {
+                allPredecessorsCold = false;
+                break;
+            }
+        }
+        if (allPredecessorsCold) {
+            block->setCold();
+        }
+    }
+
+    return true;
+}
+
+static bool
+IsFreshObjectAllocation(MInstruction* ins)
+{
+    return ins->isNewObject() || ins->isNewArray() || ins->isCreateThisWithTemplate();
+}
+
+// Whether |ins| can neither trigger a GC nor let the object it stores to
+// escape to code which could.
+static bool
+IsNonGCingInitInstruction(MInstruction* ins)
+{
+    switch (ins->op()) {
+      case MDefinition::Opcode::Constant:
+      case MDefinition::Opcode::Nop:
+      case MDefinition::Opcode::Box:
+      case MDefinition::Opcode::Unbox:
+      case MDefinition::Opcode::Slots:
+      case MDefinition::Opcode::Elements:
+      case MDefinition::Opcode::InitializedLength:
+      case MDefinition::Opcode::SetInitializedLength:
+      case MDefinition::Opcode::KeepAliveObject:
+      case MDefinition::Opcode::PostWriteBarrier:
+      case MDefinition::Opcode::PostWriteElementBarrier:
+      case MDefinition::Opcode::StoreFixedSlot:
+      case MDefinition::Opcode::StoreSlot:
+      case MDefinition::Opcode::StoreElement:
+        return true;
+      default:
+        return false;
+    }
+}
+
+// Incremental pre-barriers preserve the edges which existed when marking
+// started. An object allocated since the last instruction which could GC has
+// no such edges: either marking was already running when it was allocated, in
+// which case the object is in the nursery or allocated black and everything
+// stored into it is reachable from elsewhere, or no marking began before the
+// store. Drop the pre-barriers of the stores which initialize such objects.
+//
+// Post-barriers are kept, as the allocation can still return a tenured object
+// when the nursery is full or disabled.
+bool
+jit::EliminateInitPreBarriers(MIRGenerator* mir, MIRGraph& graph)
+{
+    for (ReversePostorderIterator block(graph.rpoBegin()); block != graph.rpoEnd(); block++) {
+        if (mir->shouldCancel("Eliminate init pre-barriers")) {
+            return false;
+        }
+
+        // The allocation itself may start an incremental GC, so at most the
+        // last object allocated is fresh.
+        MDefinition* freshObject = nullptr;
+
+        for (MInstructionIterator iter(block->begin()); iter != block->end(); iter++) {
+            MInstruction* ins = *iter;
+
+            if (IsFreshObjectAllocation(ins)) {
+                freshObject = ins;
+                continue;
+            }
+
+            if (!IsNonGCingInitInstruction(ins)) {
+                freshObject = nullptr;
+                continue;
+            }
+
+            if (!freshObject) {
+                continue;
+            }
+
+            if (ins->isStoreFixedSlot()) {
+                MStoreFixedSlot* store = ins->toStoreFixedSlot();
+                if (store->object() == freshObject) {
+                    store->setNeedsBarrier(false);
+                }
+            } else if (ins->isStoreSlot()) {
+                MStoreSlot* store = ins->toStoreSlot();
+                if (store->slots()->isSlots() &&
+                    store->slots()->toSlots()->object() == freshObject)
+                {
+                    store->setNeedsBarrier(false);
+                }
+            } else if (ins->isStoreElement()) {
+                MStoreElement* store = ins->toStoreElement();
+                if (store->elements()->isElements() &&
+                    store->elements()->toElements()->object() == freshObject)
+                {
+                    store->setNeedsBarrier(false);
+                }
+            }
+        }
+    }
+
+    return true;
+}
+
 bool
 LinearSum::multiply(int32_t scale)
 {
@@ -4891,11 +5028,16 @@ jit::AnalyzeArgumentsUsage(JSContext* cx, JSScript* scriptArg)
         }
     }
 
-    // If a script explicitly accesses the contents of 'arguments', and has
-    // formals which may be stored as part of a call object, don't use lazy
-    // arguments. The compiler can then assume that accesses through
-    // arguments[i] will be on unaliased variables.
-    if (script->funHasAnyAliasedFormal() && argumentsContentsObserved) {
+    // If a script explicitly accesses the contents of a mapped 'arguments',
+    // and has formals which may be stored as part of a call object, don't use
+    // lazy arguments. The compiler can then assume that accesses through
+    // arguments[i] will be on unaliased variables. An unmapped arguments
+    // object holds the values that were passed, which the frame's actual
+    // arguments keep: aliased formals are written to the call object instead,
+    // and scripts which write unaliased formals don't use lazy arguments.
+    if (script->funHasAnyAliasedFormal() && argumentsContentsObserved &&
+        script->hasMappedArgsObj())
+    {
         return true;
     }
 
@@ -97,11 +97,17 @@ void
 AssertExtendedGraphCoherency(MIRGraph& graph, bool underValueNumberer = false, bool force = false);
 
 MOZ_MUST_USE bool
-EliminateRedundantChecks(MIRGraph& graph);
+EliminateRedundantChecks(MIRGenerator* mir, MIRGraph& graph);
 
 MOZ_MUST_USE bool
 AddKeepAliveInstructions(MIRGraph& graph);
 
+MOZ_MUST_USE bool
+MarkColdBlocks(MIRGenerator* mir, MIRGraph& graph);
+
+MOZ_MUST_USE bool
+EliminateInitPreBarriers(MIRGenerator* mir, MIRGraph& graph);
+
 // Simple linear sum of the form 'n' or 'x + n'.
 struct SimpleLinearSum
 {
@@ -129,6 +129,7 @@ IonBuilder::IonBuilder(JSContext* analysisContext, CompileRealm* realm,
                        uint32_t loopDepth)
   : MIRGenerator(realm, options, temp, graph, info, optimizationInfo),
     backgroundCodegen_(nullptr),
+    queuedWarmUpCount_(0),
     actionableAbortScript_(nullptr),
     actionableAbortPc_(nullptr),
     actionableAbortMessage_(nullptr),
@@ -1608,6 +1609,13 @@ IonBuilder::visitBlock(const CFGBlock* cfgblock, MBasicBlock* mblock)
         mblock->setHitCount(script()->getHitCount(mblock->pc()));
     }
 
+    // The entry block has to be emitted first, so is never cold.
+    if (!JitOptions.disableColdBlocks && mblock != graph().entryBlock() &&
+        inspector->neverExecuted(cfgblock->startPc(), cfgblock->stopPc()))
+    {
+        mblock->setCold();
+    }
+
     // Optimization to move a predecessor that only has this block as successor
     // just before this block.  Skip this optimization if the previous block is
     // not part of the same function, as we might have to backtrack on inlining
@@ -1622,6 +1630,19 @@ IonBuilder::visitBlock(const CFGBlock* cfgblock, MBasicBlock* mblock)
     MOZ_TRY(setCurrentAndSpecializePhis(mblock));
     graph().addBlock(mblock);
 
+    // When collecting code coverage, count the jump targets in this block the
+    // way Baseline code does, so that executions in Ion code are not missing
+    // from the coverage. JSOP_LOOPHEAD is never compiled on its own, as loop
+    // bodies start after it, so count it when we visit the op following it.
+    bool countPCs = script()->hasScriptCounts() &&
+                    script()->realm()->collectCoverageForDebug();
+    if (countPCs && pc != script()->code()) {
+        jsbytecode* prev = pc - JSOP_LOOPHEAD_LENGTH;
+        if (JSOp(*prev) == JSOP_LOOPHEAD && script()->maybeGetPCCounts(prev)) {
+            insertPCCountIncrement(prev);
+        }
+    }
+
     while (pc < cfgblock->stopPc()) {
         if (!alloc().ensureBallast()) {
             return abort(AbortReason::Alloc);
@@ -1651,6 +1672,9 @@ IonBuilder::visitBlock(const CFGBlock* cfgblock, MBasicBlock* mblock)
 
         // Nothing in inspectOpcode() is allowed to advance the pc.
         JSOp op = JSOp(*pc);
+        if (countPCs && (BytecodeIsJumpTarget(op) || pc == script()->main())) {
+            insertPCCountIncrement(pc);
+        }
         MOZ_TRY(inspectOpcode(op));
 
 #ifdef DEBUG
@@ -2423,10 +2447,26 @@ IonBuilder::inspectOpcode(JSOp op)
         return jsop_hasown();
 
       case JSOP_SETRVAL:
-        MOZ_ASSERT(!script()->noScriptRval());
+        // Finally blocks save and restore the return value even if the
+        // script doesn't use it.
+        if (script()->noScriptRval()) {
+            current->pop();
+            return Ok();
+        }
         current->setSlot(info().returnValueSlot(), current->pop());
         return Ok();
 
+      case JSOP_GETRVAL:
+        if (script()->noScriptRval()) {
+            pushConstant(UndefinedValue());
+            return Ok();
+        }
+        current->push(current->getSlot(info().returnValueSlot()));
+        return Ok();
+
+      case JSOP_FINALLY:
+        return jsop_finally();
+
       case JSOP_INSTANCEOF:
         return jsop_instanceof();
 
@@ -2477,14 +2517,10 @@ IonBuilder::inspectOpcode(JSOp op)
         return Ok();
 
       case JSOP_OPTIMIZE_SPREADCALL:
-      {
-        // Assuming optimization isn't available doesn't affect correctness.
-        // TODO: Investigate dynamic checks.
-        MDefinition* arr = current->peek(-1);
-        arr->setImplicitlyUsedUnchecked();
-        pushConstant(BooleanValue(false));
-        return Ok();
-      }
+        return jsop_optimize_spreadcall();
+
+      case JSOP_OPTIMIZE_DESTRUCTURING:
+        return jsop_optimize_destructuring(GET_UINT32(pc));
 
       case JSOP_IMPORTMETA:
         return jsop_importmeta();
@@ -2551,8 +2587,6 @@ IonBuilder::inspectOpcode(JSOp op)
 
       // Misc
       case JSOP_DELNAME:
-      case JSOP_FINALLY:
-      case JSOP_GETRVAL:
       case JSOP_GOSUB:
       case JSOP_RETSUB:
       case JSOP_SETINTRINSIC:
@@ -3200,8 +3234,8 @@ IonBuilder::visitCompare(CFGCompare* compare)
 AbortReasonOr<Ok>
 IonBuilder::visitTry(CFGTry* try_)
 {
-    // We don't support try-finally. The ControlFlowGenerator should have
-    // aborted compilation in this case.
+    // For try-finally, the ControlFlowGenerator has already made the finally
+    // block part of the try block's normal completion.
 
     // Try-catch within inline frames is not yet supported.
     MOZ_ASSERT(!isInlineBuilder());
@@ -3237,6 +3271,37 @@ IonBuilder::visitTry(CFGTry* try_)
     return Ok();
 }
 
+AbortReasonOr<Ok>
+IonBuilder::jsop_finally()
+{
+    // Ion only enters finally blocks from the JSOP_GOSUB at the end of the
+    // try block, so push the operands that op would have pushed: |false| and
+    // the offset of the op following it, which Baseline uses if we bail out
+    // in the finally block. Exceptions bail out to the finally block in
+    // Baseline instead. The ControlFlowGenerator ensured no other JSOP_GOSUB
+    // in the try block targets this finally block, so the first one found
+    // after the start of the try block is the right one.
+    jsbytecode* gosub = nullptr;
+    for (const JSTryNote& tn : script()->trynotes()) {
+        jsbytecode* finallyStart = script()->main() + tn.start + tn.length;
+        if (tn.kind != JSTRY_FINALLY || GetNextPc(finallyStart) != pc) {
+            continue;
+        }
+        for (jsbytecode* p = script()->main() + tn.start; p < finallyStart; p = GetNextPc(p)) {
+            if (JSOp(*p) == JSOP_GOSUB && p + GET_JUMP_OFFSET(p) == finallyStart) {
+                gosub = p;
+                break;
+            }
+        }
+        break;
+    }
+    MOZ_ASSERT(gosub);
+
+    pushConstant(BooleanValue(false));
+    pushConstant(Int32Value(script()->pcToOffset(GetNextPc(gosub))));
+    return Ok();
+}
+
 AbortReasonOr<Ok>
 IonBuilder::visitReturn(CFGControlInstruction* control)
 {
@@ -4168,6 +4233,46 @@ IonBuilder::patchInlinedReturns(CallInfo& callInfo, MIRGraphReturns& returns, MB
     return phi;
 }
 
+// Self-hosted builtins such as Array.prototype.map are shared by all their
+// callers, so the calls they make to their callback are megamorphic unless the
+// builtin is inlined into a caller passing a function with a few known
+// targets. In that case the inlined call can itself be inlined, with a
+// polymorphic dispatch if needed (see getPolyCallTargets).
+static bool
+HasKnownCallbackTargets(CallInfo& callInfo)
+{
+    static const uint32_t MaxCallbackTargets = 4;
+
+    for (uint32_t i = 0; i < callInfo.argc(); i++) {
+        TemporaryTypeSet* types = callInfo.getArg(i)->resultTypeSet();
+        if (!types || types->baseFlags() != 0) {
+            continue;
+        }
+
+        unsigned objCount = types->getObjectCount();
+        if (objCount == 0 || objCount > MaxCallbackTargets) {
+            continue;
+        }
+
+        bool allInterpreted = true;
+        for (unsigned j = 0; j < objCount; j++) {
+            JSObject* obj = types->getSingleton(j);
+            if (!obj) {
+                ObjectGroup* group = types->getGroup(j);
+                obj = group ? group->maybeInterpretedFunction() : nullptr;
+            }
+            if (!obj || !obj->is<JSFunction>() || !obj->as<JSFunction>().isInterpreted()) {
+                allInterpreted = false;
+                break;
+            }
+        }
+        if (allInterpreted) {
+            return true;
+        }
+    }
+    return false;
+}
+
 IonBuilder::InliningDecision
 IonBuilder::makeInliningDecision(JSObject* targetArg, CallInfo& callInfo)
 {
@@ -4217,6 +4322,13 @@ IonBuilder::makeInliningDecision(JSObject* targetArg, CallInfo& callInfo)
         return DontInline(targetScript, "Vetoed: callee excessively large");
     }
 
+    // Callee must be called often enough from this call site, even if it is
+    // small: inlining a rarely called function mostly makes the caller bigger.
+    if (isColdCallTarget(target)) {
+        trackOptimizationOutcome(TrackedOutcome::CantInlineColdCallee);
+        return DontInline(targetScript, "Vetoed: callee rarely called from this site");
+    }
+
     // Callee must have been called a few times to have somewhat stable
     // type information, except for definite properties analysis,
     // as the caller has not run yet.
@@ -4292,11 +4404,20 @@ IonBuilder::makeInliningDecision(JSObject* targetArg, CallInfo& callInfo)
     // script, indicating at which depth we won't be able to inline all functions
     // we inlined this time. This solves the issue above, because we will only
     // inline f if it means we can also inline g.
+    //
+    // The max inlining depth of a self-hosted builtin reflects whichever caller
+    // compiled it last, so ignore it when this call site passes known
+    // callbacks that the builtin's loop can inline.
     if (targetScript->hasLoops() &&
         inliningDepth_ >= targetScript->baselineScript()->maxInliningDepth())
     {
-        trackOptimizationOutcome(TrackedOutcome::CantInlineExceededDepth);
-        return DontInline(targetScript, "Vetoed: exceeding allowed script inline depth");
+        if (target->isSelfHostedBuiltin() && HasKnownCallbackTargets(callInfo)) {
+            JitSpew(JitSpew_Inlining, "Inlining self-hosted %s:%u:%u for its known callbacks",
+                    targetScript->filename(), targetScript->lineno(), targetScript->column());
+        } else {
+            trackOptimizationOutcome(TrackedOutcome::CantInlineExceededDepth);
+            return DontInline(targetScript, "Vetoed: exceeding allowed script inline depth");
+        }
     }
 
     // Update the max depth at which we can inline the outer script.
@@ -4313,6 +4434,52 @@ IonBuilder::makeInliningDecision(JSObject* targetArg, CallInfo& callInfo)
     return InliningDecision_Inline;
 }
 
+bool
+IonBuilder::isColdCallTarget(JSFunction* target)
+{
+    if (JitOptions.disablePgo || info().analysisMode() != Analysis_None || !IsCallPC(pc)) {
+        return false;
+    }
+
+    uint64_t targetCalls, totalCalls;
+    bool allTargetsCounted;
+    if (!inspector->callCounts(pc, target, &targetCalls, &totalCalls, &allTargetsCounted)) {
+        return false;
+    }
+
+    // The call site itself rarely runs compared to the rest of the caller.
+    uint64_t coldFactor = optimizationInfo().inliningColdCallSiteFactor();
+    if (totalCalls * coldFactor < script()->getWarmUpCount()) {
+        return true;
+    }
+
+    // The target gets a small share of the calls at a polymorphic site.
+    if (allTargetsCounted && totalCalls >= optimizationInfo().inliningMinCallSiteCalls() &&
+        targetCalls * 100 < totalCalls * optimizationInfo().inliningMinTargetCallPercent())
+    {
+        return true;
+    }
+
+    return false;
+}
+
+uint64_t
+IonBuilder::baselineCallCount(JSObject* target)
+{
+    if (JitOptions.disablePgo || !target->is<JSFunction>()) {
+        return 0;
+    }
+
+    uint64_t targetCalls, totalCalls;
+    bool allTargetsCounted;
+    if (!inspector->callCounts(pc, &target->as<JSFunction>(), &targetCalls, &totalCalls,
+                               &allTargetsCounted))
+    {
+        return 0;
+    }
+    return targetCalls;
+}
+
 AbortReasonOr<Ok>
 IonBuilder::selectInliningTargets(const InliningTargets& targets, CallInfo& callInfo,
                                   BoolVector& choiceSet, uint32_t* numInlineable)
@@ -4321,7 +4488,7 @@ IonBuilder::selectInliningTargets(const InliningTargets& targets, CallInfo& call
     uint32_t totalSize = 0;
 
     // For each target, ask whether it may be inlined.
-    if (!choiceSet.reserve(targets.length())) {
+    if (!choiceSet.appendN(false, targets.length())) {
         return abort(AbortReason::Alloc);
     }
 
@@ -4331,7 +4498,27 @@ IonBuilder::selectInliningTargets(const InliningTargets& targets, CallInfo& call
         return Ok();
     }
 
+    // Visit the targets which Baseline saw called most often first, so that
+    // they get the call site's bytecode budget. The sort is stable, so the
+    // order of the targets is kept without call counts.
+    Vector<size_t, 8, JitAllocPolicy> order(alloc());
+    Vector<uint64_t, 8, JitAllocPolicy> calls(alloc());
+    if (!order.reserve(targets.length()) || !calls.reserve(targets.length())) {
+        return abort(AbortReason::Alloc);
+    }
     for (size_t i = 0; i < targets.length(); i++) {
+        calls.infallibleAppend(baselineCallCount(targets[i].target));
+
+        size_t pos = order.length();
+        order.infallibleAppend(i);
+        while (pos > 0 && calls[order[pos - 1]] < calls[i]) {
+            order[pos] = order[pos - 1];
+            pos--;
+        }
+        order[pos] = i;
+    }
+
+    for (size_t i : order) {
         JSObject* target = targets[i].target;
 
         trackOptimizationAttempt(TrackedStrategy::Call_Inline);
@@ -4359,6 +4546,7 @@ IonBuilder::selectInliningTargets(const InliningTargets& targets, CallInfo& call
                 totalSize += target->as<JSFunction>().nonLazyScript()->length();
                 bool offThread = options.offThreadCompilationAvailable();
                 if (totalSize > optimizationInfo().inlineMaxBytecodePerCallSite(offThread)) {
+                    trackOptimizationOutcome(TrackedOutcome::CantInlineBigCallSite);
                     inlineable = false;
                 }
             }
@@ -4367,7 +4555,7 @@ IonBuilder::selectInliningTargets(const InliningTargets& targets, CallInfo& call
             inlineable = false;
         }
 
-        choiceSet.infallibleAppend(inlineable);
+        choiceSet[i] = inlineable;
         if (inlineable) {
             *numInlineable += 1;
         }
@@ -5499,6 +5687,43 @@ IonBuilder::jsop_spreadcall()
     return pushTypeBarrier(apply, types, BarrierKind::TypeSet);
 }
 
+AbortReasonOr<Ok>
+IonBuilder::jsop_optimize_spreadcall()
+{
+    MDefinition* arr = current->peek(-1);
+
+    // Spreading a value which can't be an array always takes the slow path.
+    if (!arr->mightBeType(MIRType::Object)) {
+        arr->setImplicitlyUsedUnchecked();
+        pushConstant(BooleanValue(false));
+        return Ok();
+    }
+
+    MOptimizeSpreadCall* ins = MOptimizeSpreadCall::New(alloc(), arr);
+    current->add(ins);
+    current->push(ins);
+    return resumeAfter(ins);
+}
+
+AbortReasonOr<Ok>
+IonBuilder::jsop_optimize_destructuring(uint32_t count)
+{
+    MDefinition* arr = current->peek(-1);
+
+    // Destructuring a value which can't be an array always takes the slow
+    // path.
+    if (!arr->mightBeType(MIRType::Object)) {
+        arr->setImplicitlyUsedUnchecked();
+        pushConstant(BooleanValue(false));
+        return Ok();
+    }
+
+    MOptimizeArrayDestructuring* ins = MOptimizeArrayDestructuring::New(alloc(), arr, count);
+    current->add(ins);
+    current->push(ins);
+    return resumeAfter(ins);
+}
+
 AbortReasonOr<Ok>
 IonBuilder::jsop_funapplyarray(uint32_t argc)
 {
@@ -6516,10 +6741,17 @@ IonBuilder::newArrayTryTemplateObject(bool* emitted, JSObject* templateObject, u
     // Emit fastpath.
 
     gc::InitialHeap heap = templateObject->group()->initialHeap(constraints());
+    gc::AllocSite* site = inspector->getAllocSite(pc);
+    if (site && site->isLongLived()) {
+        heap = gc::TenuredHeap;
+    }
     MConstant* templateConst = MConstant::NewConstraintlessObject(alloc(), templateObject);
     current->add(templateConst);
 
     MNewArray* ins = MNewArray::New(alloc(), constraints(), length, templateConst, heap, pc);
+    if (heap == gc::DefaultHeap) {
+        ins->setAllocSite(site);
+    }
     current->add(ins);
     current->push(ins);
 
@@ -6665,10 +6897,17 @@ IonBuilder::newObjectTryTemplateObject(bool* emitted, JSObject* templateObject)
     }
 
     gc::InitialHeap heap = templateObject->group()->initialHeap(constraints());
+    gc::AllocSite* site = inspector->getAllocSite(pc);
+    if (site && site->isLongLived()) {
+        heap = gc::TenuredHeap;
+    }
     MConstant* templateConst = MConstant::NewConstraintlessObject(alloc(), templateObject);
     current->add(templateConst);
 
     MNewObject* ins = MNewObject::New(alloc(), constraints(), templateConst, heap, mode);
+    if (heap == gc::DefaultHeap) {
+        ins->setAllocSite(site);
+    }
     current->add(ins);
     current->push(ins);
 
@@ -7438,6 +7677,18 @@ IonBuilder::insertRecompileCheck()
     current->add(check);
 }
 
+void
+IonBuilder::insertPCCountIncrement(jsbytecode* pc)
+{
+    // The PCCounts are only freed after invalidating the Ion code of the
+    // realm, see Debugger::updateObservesCoverageOnDebuggees.
+    PCCounts* counts = script()->maybeGetPCCounts(pc);
+    if (!counts) {
+        return;
+    }
+    current->add(MIncrementPCCount::New(alloc(), &counts->numExec()));
+}
+
 JSObject*
 IonBuilder::testSingletonProperty(JSObject* obj, jsid id)
 {
@@ -7915,6 +8166,15 @@ IonBuilder::needsPostBarrier(MDefinition* value)
     if (value->mightBeType(MIRType::String) && zone->canNurseryAllocateStrings()) {
         return true;
     }
+#ifdef ENABLE_BIGINT
+    // There is no MIRType for BigInts, so consult the type set directly.
+    if (value->type() == MIRType::Value &&
+        (!value->resultTypeSet() || value->resultTypeSet()->hasType(TypeSet::BigIntType())) &&
+        zone->canNurseryAllocateBigInts())
+    {
+        return true;
+    }
+#endif
     return false;
 }
 
@@ -13858,7 +14118,7 @@ IonBuilder::addBoundsCheck(MDefinition* index, MDefinition* length)
         check->setNotMovable();
     }
 
-    if (JitOptions.spectreIndexMasking) {
+    if (spectre().indexMasking) {
         // Use a separate MIR instruction for the index masking. Doing this as
         // part of MBoundsCheck would be unsound because bounds checks can be
         // optimized or eliminated completely. Consider this:
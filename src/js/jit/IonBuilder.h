@@ -12,6 +12,7 @@
 
 #include "mozilla/LinkedList.h"
 #include "mozilla/Maybe.h"
+#include "mozilla/TimeStamp.h"
 
 #include "jit/BaselineInspector.h"
 #include "jit/BytecodeAnalysis.h"
@@ -136,6 +137,7 @@ class IonBuilder
     bool blockIsOSREntry(const CFGBlock* block, const CFGBlock* predecessor);
 
     void insertRecompileCheck();
+    void insertPCCountIncrement(jsbytecode* pc);
 
     bool usesEnvironmentChain();
 
@@ -504,6 +506,9 @@ class IonBuilder
     AbortReasonOr<Ok> jsop_funapplyarguments(uint32_t argc);
     AbortReasonOr<Ok> jsop_funapplyarray(uint32_t argc);
     AbortReasonOr<Ok> jsop_spreadcall();
+    AbortReasonOr<Ok> jsop_optimize_spreadcall();
+    AbortReasonOr<Ok> jsop_finally();
+    AbortReasonOr<Ok> jsop_optimize_destructuring(uint32_t count);
     AbortReasonOr<Ok> jsop_call(uint32_t argc, bool constructing, bool ignoresReturnValue);
     AbortReasonOr<Ok> jsop_eval(uint32_t argc);
     AbortReasonOr<Ok> jsop_label();
@@ -620,6 +625,8 @@ class IonBuilder
     // Oracles.
     InliningDecision canInlineTarget(JSFunction* target, CallInfo& callInfo);
     InliningDecision makeInliningDecision(JSObject* target, CallInfo& callInfo);
+    bool isColdCallTarget(JSFunction* target);
+    uint64_t baselineCallCount(JSObject* target);
     AbortReasonOr<Ok> selectInliningTargets(const InliningTargets& targets, CallInfo& callInfo,
                                             BoolVector& choiceSet, uint32_t* numInlineable);
 
@@ -644,6 +651,10 @@ class IonBuilder
     // Iterator intrinsics.
     InliningResult inlineNewIterator(CallInfo& callInfo, MNewIterator::Type type);
 
+    // Map and Set natives.
+    InliningResult inlineMapObjectGet(CallInfo& callInfo);
+    InliningResult inlineMapOrSetHas(CallInfo& callInfo, MMapOrSetHas::Mode mode);
+
     // Math natives.
     InliningResult inlineMathAbs(CallInfo& callInfo);
     InliningResult inlineMathFloor(CallInfo& callInfo);
@@ -703,6 +714,14 @@ class IonBuilder
     InliningResult inlineAtomicsBinop(CallInfo& callInfo, InlinableNative target);
     InliningResult inlineAtomicsIsLockFree(CallInfo& callInfo);
 
+    // DataView natives.
+    InliningResult inlineDataViewGet(CallInfo& callInfo, Scalar::Type type);
+    InliningResult inlineDataViewSet(CallInfo& callInfo, Scalar::Type type);
+    bool dataViewMeetsPreconditions(CallInfo& callInfo, uint32_t littleEndianArg,
+                                    bool* littleEndian);
+    void dataViewCheckBounds(CallInfo& callInfo, Scalar::Type type, MInstruction** elements,
+                             MDefinition** index);
+
     // Slot intrinsics.
     InliningResult inlineUnsafeSetReservedSlot(CallInfo& callInfo);
     InliningResult inlineUnsafeGetReservedSlot(CallInfo& callInfo,
@@ -725,6 +744,8 @@ class IonBuilder
     InliningResult inlineTypedArrayLength(CallInfo& callInfo);
     InliningResult inlinePossiblyWrappedTypedArrayLength(CallInfo& callInfo);
     InliningResult inlineSetDisjointTypedElements(CallInfo& callInfo);
+    InliningResult inlineTypedArrayNativeFill(CallInfo& callInfo);
+    InliningResult inlineTypedArrayNativeSearch(CallInfo& callInfo, MTypedArraySearch::Mode mode);
 
     // TypedObject intrinsics and natives.
     InliningResult inlineObjectIsTypeDescr(CallInfo& callInfo);
@@ -750,6 +771,7 @@ class IonBuilder
     InliningResult inlineObjectHasPrototype(CallInfo& callInfo);
     InliningResult inlineFinishBoundFunctionInit(CallInfo& callInfo);
     InliningResult inlineIsPackedArray(CallInfo& callInfo);
+    InliningResult inlineArrayNativeSearch(CallInfo& callInfo, MArraySearch::Mode mode);
     InliningResult inlineWasmCall(CallInfo& callInfo, JSFunction* target);
 
     // Testing functions.
@@ -894,6 +916,11 @@ class IonBuilder
     // performed by FinishOffThreadBuilder().
     CodeGenerator* backgroundCodegen_;
 
+    // The script's warm-up count and the time at which this builder was added
+    // to the off thread Ion worklist. Used to prioritize the worklist.
+    uint32_t queuedWarmUpCount_;
+    mozilla::TimeStamp queuedTime_;
+
     // Some aborts are actionable (e.g., using an unsupported bytecode). When
     // optimization tracking is enabled, the location and message of the abort
     // are recorded here so they may be propagated to the script's
@@ -918,6 +945,13 @@ class IonBuilder
     CodeGenerator* backgroundCodegen() const { return backgroundCodegen_; }
     void setBackgroundCodegen(CodeGenerator* codegen) { backgroundCodegen_ = codegen; }
 
+    void setQueued(uint32_t warmUpCount, mozilla::TimeStamp time) {
+        queuedWarmUpCount_ = warmUpCount;
+        queuedTime_ = time;
+    }
+    uint32_t queuedWarmUpCount() const { return queuedWarmUpCount_; }
+    mozilla::TimeStamp queuedTime() const { return queuedTime_; }
+
     CompilerConstraintList* constraints() {
         return constraints_;
     }
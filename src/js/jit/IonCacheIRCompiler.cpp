@@ -16,6 +16,7 @@
 #include "jit/VMFunctions.h"
 #include "proxy/DeadObjectProxy.h"
 #include "proxy/Proxy.h"
+#include "proxy/ScriptedProxyHandler.h"
 
 #include "jit/JSJitFrameIter-inl.h"
 #include "jit/MacroAssembler-inl.h"
@@ -328,7 +329,11 @@ IonCacheIRCompiler::callVM(MacroAssembler& masm, const VMFunction& fun)
 {
     MOZ_ASSERT(calledPrepareVMCall_);
 
-    TrampolinePtr code = cx_->runtime()->jitRuntime()->getVMWrapper(fun);
+    JitRuntime* jitRuntime = cx_->runtime()->jitRuntime();
+    if (!jitRuntime->ensureVMWrapper(cx_, fun)) {
+        return false;
+    }
+    TrampolinePtr code = jitRuntime->getVMWrapper(fun);
 
     uint32_t frameSize = fun.explicitStackSlots() * sizeof(void*);
     uint32_t descriptor = MakeFrameDescriptor(frameSize, FrameType::IonICCall,
@@ -1060,7 +1065,7 @@ IonCacheIRCompiler::emitCallNativeGetterResult()
     Address outparam(masm.getStackPointer(), IonOOLNativeExitFrameLayout::offsetOfResult());
     masm.loadValue(outparam, output.valueReg());
 
-    if (JitOptions.spectreJitToCxxCalls) {
+    if (masm.spectre().jitToCxxCalls) {
         masm.speculationBarrier();
     }
 
@@ -1125,7 +1130,7 @@ IonCacheIRCompiler::emitCallProxyGetResult()
     masm.loadValue(outparam, output.valueReg());
 
     // Spectre mitigation in case of speculative execution within C++ code.
-    if (JitOptions.spectreJitToCxxCalls) {
+    if (masm.spectre().jitToCxxCalls) {
         masm.speculationBarrier();
     }
 
@@ -1134,6 +1139,110 @@ IonCacheIRCompiler::emitCallProxyGetResult()
     return true;
 }
 
+bool
+IonCacheIRCompiler::emitCallScriptedProxyGetResult()
+{
+    AutoSaveLiveRegisters save(*this);
+    AutoOutputRegister output(*this);
+
+    Register proxy = allocator.useRegister(masm, reader.objOperandId());
+    JSObject* target = objectStubField(reader.stubOffset());
+    jsid id = idStubField(reader.stubOffset());
+    reader.readBool(); // isSymbol, only needed by Baseline.
+    JSFunction* trap = &objectStubField(reader.stubOffset())->as<JSFunction>();
+    Shape* targetShape = shapeStubField(reader.stubOffset());
+    AutoScratchRegister scratch(allocator, masm);
+
+    bool isCrossRealm = reader.readBool();
+    MOZ_ASSERT(isCrossRealm == (cx_->realm() != trap->realm()));
+
+    allocator.discardStack(masm);
+
+    uint32_t framePushedBefore = masm.framePushed();
+
+    // Construct IonICCallFrameLayout.
+    uint32_t descriptor = MakeFrameDescriptor(masm.framePushed(), FrameType::IonJS,
+                                              IonICCallFrameLayout::Size());
+    pushStubCodePointer();
+    masm.Push(Imm32(descriptor));
+    masm.Push(ImmPtr(GetReturnAddressToIonCode(cx_)));
+
+    // The JitFrameLayout pushed below will be aligned to JitStackAlignment,
+    // so we just have to make sure the stack is aligned after we push the
+    // |this| + argument Values.
+    uint32_t numArgs = Max<uint32_t>(trap->nargs(), 3);
+    uint32_t argSize = (numArgs + 1) * sizeof(Value);
+    uint32_t padding = ComputeByteAlignment(masm.framePushed() + argSize, JitStackAlignment);
+    MOZ_ASSERT(padding % sizeof(uintptr_t) == 0);
+    MOZ_ASSERT(padding < JitStackAlignment);
+    masm.reserveStack(padding);
+
+    // The trap is called as handler.get(target, key, receiver).
+    for (size_t i = 3; i < numArgs; i++) {
+        masm.Push(UndefinedValue());
+    }
+    masm.Push(TypedOrValueRegister(MIRType::Object, AnyRegister(proxy)));
+    masm.Push(IdToValue(id));
+    masm.Push(ObjectValue(*target));
+
+    masm.loadPtr(Address(proxy, ProxyObject::offsetOfReservedSlots()), scratch);
+    masm.unboxObject(Address(scratch, detail::ProxyReservedSlots::offsetOfSlot(
+                                          ScriptedProxyHandler::HANDLER_EXTRA)),
+                     scratch);
+    masm.Push(TypedOrValueRegister(MIRType::Object, AnyRegister(scratch)));
+
+    if (isCrossRealm) {
+        masm.switchToRealm(trap->realm(), scratch);
+    }
+
+    masm.movePtr(ImmGCPtr(trap), scratch);
+
+    descriptor = MakeFrameDescriptor(argSize + padding, FrameType::IonICCall,
+                                     JitFrameLayout::Size());
+    masm.Push(Imm32(3)); // argc
+    masm.Push(scratch);
+    masm.Push(Imm32(descriptor));
+
+    // Check stack alignment. Add sizeof(uintptr_t) for the return address.
+    MOZ_ASSERT(((masm.framePushed() + sizeof(uintptr_t)) % JitStackAlignment) == 0);
+
+    // See emitCallScriptedGetterResult.
+    MOZ_ASSERT(trap->hasJitEntry());
+    masm.loadJitCodeRaw(scratch, scratch);
+    masm.callJit(scratch);
+
+    if (isCrossRealm) {
+        static_assert(!JSReturnOperand.aliases(ReturnReg),
+                      "ReturnReg available as scratch after scripted calls");
+        masm.switchToRealm(cx_->realm(), ReturnReg);
+    }
+
+    masm.storeCallResultValue(output);
+    masm.freeStack(masm.framePushed() - framePushedBefore);
+
+    // The IR generator checked that the target had no property the result
+    // must agree with. Unless the trap changed the target, that still holds.
+    Label done;
+    masm.movePtr(ImmGCPtr(target), scratch);
+    masm.branchPtr(Assembler::Equal, Address(scratch, ShapedObject::offsetOfShape()),
+                   ImmGCPtr(targetShape), &done);
+    {
+        prepareVMCall(masm, save);
+
+        masm.Push(TypedOrValueRegister(output));
+        masm.Push(id, scratch);
+        masm.Push(ImmGCPtr(target));
+
+        if (!callVM(masm, CheckProxyGetResultInfo)) {
+            return false;
+        }
+
+        masm.storeCallResultValue(output);
+    }
+    masm.bind(&done);
+    return true;
+}
+
 bool
 IonCacheIRCompiler::emitCallProxyGetByValueResult()
 {
@@ -22,8 +22,7 @@ ControlFlowGenerator::ControlFlowGenerator(TempAllocator& temp, JSScript* script
     loops_(temp),
     switches_(temp),
     labels_(temp),
-    aborted_(false),
-    checkedTryFinally_(false)
+    aborted_(false)
 { }
 
 static inline int32_t
@@ -505,6 +504,9 @@ ControlFlowGenerator::processCfgEntry(CFGState& state)
       case CFGState::TRY:
         return processTryEnd(state);
 
+      case CFGState::TRY_FINALLY:
+        return processTryFinallyEnd(state);
+
       default:
         MOZ_CRASH("unknown cfgstate");
     }
@@ -557,20 +559,23 @@ ControlFlowGenerator::processLabelEnd(CFGState& state)
     return ControlStatus::Joined;
 }
 
-ControlFlowGenerator::ControlStatus
-ControlFlowGenerator::processTry()
+static bool
+TryHasFinally(JSScript* script, jsbytecode* pc)
 {
     MOZ_ASSERT(JSOp(*pc) == JSOP_TRY);
 
-    // Try-finally is not yet supported.
-    if (!checkedTryFinally_) {
-        for (const JSTryNote& tn : script->trynotes()) {
-            if (tn.kind == JSTRY_FINALLY) {
-                return ControlStatus::Abort;
-            }
+    for (const JSTryNote& tn : script->trynotes()) {
+        if (tn.kind == JSTRY_FINALLY && script->main() + tn.start == GetNextPc(pc)) {
+            return true;
         }
-        checkedTryFinally_ = true;
     }
+    return false;
+}
+
+ControlFlowGenerator::ControlStatus
+ControlFlowGenerator::processTry()
+{
+    MOZ_ASSERT(JSOp(*pc) == JSOP_TRY);
 
     jssrcnote* sn = GetSrcNote(gsn, script, pc);
     MOZ_ASSERT(SN_TYPE(sn) == SRC_TRY);
@@ -583,6 +588,35 @@ ControlFlowGenerator::processTry()
 
     jsbytecode* afterTry = endpc + GetJumpOffset(endpc);
 
+    // If there's a finally block, we compile it for the normal completion of
+    // the try block, which enters it with a JSOP_GOSUB right before endpc.
+    // Exceptions are handled by bailing out to the finally block.
+    jsbytecode* finallyStart = nullptr;
+    jsbytecode* finallyEnd = nullptr;
+    jsbytecode* stopAt = endpc;
+    if (TryHasFinally(script, pc)) {
+        jsbytecode* gosub = endpc - JSOP_GOSUB_LENGTH;
+        if (JSOp(*gosub) != JSOP_GOSUB) {
+            return ControlStatus::Abort;
+        }
+        finallyStart = gosub + GetJumpOffset(gosub);
+
+        // Non-local jumps out of the try block run the finally block from
+        // other JSOP_GOSUBs and return to different places, which we don't
+        // support.
+        for (jsbytecode* p = GetNextPc(pc); p < gosub; p = GetNextPc(p)) {
+            if (JSOp(*p) == JSOP_GOSUB && p + GetJumpOffset(p) == finallyStart) {
+                return ControlStatus::Abort;
+            }
+        }
+
+        // The finally block ends with JSOP_RETSUB and a JSOP_NOP marking the end
+        // of the try statement.
+        finallyEnd = afterTry - JSOP_NOP_LENGTH - JSOP_RETSUB_LENGTH;
+        MOZ_ASSERT(JSOp(*finallyEnd) == JSOP_RETSUB);
+        stopAt = gosub;
+    }
+
     // If controlflow in the try body is terminated (by a return or throw
     // statement), the code after the try-statement may still be reachable
     // via the catch block (which we don't compile) and OSR can enter it.
@@ -603,7 +637,7 @@ ControlFlowGenerator::processTry()
     current->setStopIns(CFGTry::New(alloc(), tryBlock, endpc, successor));
     current->setStopPc(pc);
 
-    if (!cfgStack_.append(CFGState::Try(endpc, successor))) {
+    if (!cfgStack_.append(CFGState::Try(stopAt, successor, finallyStart, finallyEnd))) {
         return ControlStatus::Error;
     }
 
@@ -623,6 +657,33 @@ ControlFlowGenerator::processTryEnd(CFGState& state)
     MOZ_ASSERT(state.state == CFGState::TRY);
     MOZ_ASSERT(state.try_.successor);
 
+    if (state.try_.finallyStart) {
+        // If control flow in the try block is terminated, only exceptions can
+        // reach the finally block, and we'd have to compile the code after
+        // the try statement without it.
+        if (!current) {
+            return ControlStatus::Abort;
+        }
+
+        // Continue with the finally block. JSOP_FINALLY pushes the operands
+        // JSOP_GOSUB would have pushed.
+        CFGBlock* finallyBlock = CFGBlock::New(alloc(), state.try_.finallyStart);
+        current->setStopIns(CFGGoto::New(alloc(), finallyBlock));
+        current->setStopPc(pc);
+
+        state.state = CFGState::TRY_FINALLY;
+        state.stopAt = state.try_.finallyEnd;
+
+        current = finallyBlock;
+        pc = current->startPc();
+
+        if (!addBlock(current)) {
+            return ControlStatus::Error;
+        }
+
+        return ControlStatus::Jumped;
+    }
+
     if (current) {
         current->setStopIns(CFGGoto::New(alloc(), state.try_.successor));
         current->setStopPc(pc);
@@ -639,6 +700,30 @@ ControlFlowGenerator::processTryEnd(CFGState& state)
     return ControlStatus::Joined;
 }
 
+ControlFlowGenerator::ControlStatus
+ControlFlowGenerator::processTryFinallyEnd(CFGState& state)
+{
+    MOZ_ASSERT(state.state == CFGState::TRY_FINALLY);
+    MOZ_ASSERT(state.try_.successor);
+
+    // Instead of JSOP_RETSUB, pop its operands and jump to the code after the
+    // try statement, which is where the JSOP_GOSUB would return to.
+    if (current) {
+        current->setStopIns(CFGGoto::New(alloc(), state.try_.successor, 2));
+        current->setStopPc(pc);
+    }
+
+    // Start parsing the code after this try-finally statement.
+    current = state.try_.successor;
+    pc = current->startPc();
+
+    if (!addBlock(current)) {
+        return ControlStatus::Error;
+    }
+
+    return ControlStatus::Joined;
+}
+
 ControlFlowGenerator::ControlStatus
 ControlFlowGenerator::processIfEnd(CFGState& state)
 {
@@ -2182,12 +2267,15 @@ ControlFlowGenerator::CFGState::Label(jsbytecode* exitpc)
 }
 
 ControlFlowGenerator::CFGState
-ControlFlowGenerator::CFGState::Try(jsbytecode* exitpc, CFGBlock* successor)
+ControlFlowGenerator::CFGState::Try(jsbytecode* exitpc, CFGBlock* successor,
+                                    jsbytecode* finallyStart, jsbytecode* finallyEnd)
 {
     CFGState state;
     state.state = TRY;
     state.stopAt = exitpc;
     state.try_.successor = successor;
+    state.try_.finallyStart = finallyStart;
+    state.try_.finallyEnd = finallyEnd;
     return state;
 }
 
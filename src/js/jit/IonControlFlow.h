@@ -718,7 +718,8 @@ class ControlFlowGenerator
             COND_SWITCH_BODY,   // switch() { case ...: X }
             AND_OR,             // && x, || x
             LABEL,              // label: x
-            TRY                 // try { x } catch(e) { }
+            TRY,                // try { x } catch(e) { }
+            TRY_FINALLY         // try { } finally { x }
         };
 
         State state;            // Current state of this control structure.
@@ -783,6 +784,11 @@ class ControlFlowGenerator
             } label;
             struct {
                 CFGBlock* successor;
+
+                // For try-finally, the start of the finally block and its
+                // JSOP_RETSUB. Otherwise nullptr.
+                jsbytecode* finallyStart;
+                jsbytecode* finallyEnd;
             } try_;
         };
 
@@ -808,7 +814,9 @@ class ControlFlowGenerator
         static CFGState CondSwitch(TempAllocator& alloc, jsbytecode* exitpc,
                                    jsbytecode* defaultTarget);
         static CFGState Label(jsbytecode* exitpc);
-        static CFGState Try(jsbytecode* exitpc, CFGBlock* successor);
+        static CFGState Try(jsbytecode* exitpc, CFGBlock* successor,
+                            jsbytecode* finallyStart = nullptr,
+                            jsbytecode* finallyEnd = nullptr);
     };
 
     Vector<CFGState, 8, JitAllocPolicy> cfgStack_;
@@ -816,7 +824,6 @@ class ControlFlowGenerator
     Vector<ControlFlowInfo, 0, JitAllocPolicy> switches_;
     Vector<ControlFlowInfo, 2, JitAllocPolicy> labels_;
     bool aborted_;
-    bool checkedTryFinally_;
 
   public:
     ControlFlowGenerator(TempAllocator& alloc, JSScript* script);
@@ -867,6 +874,7 @@ class ControlFlowGenerator
     ControlStatus processSwitchEnd(DeferredEdge* breaks, jsbytecode* exitpc);
     ControlStatus processTry();
     ControlStatus processTryEnd(CFGState& state);
+    ControlStatus processTryFinallyEnd(CFGState& state);
     ControlStatus processThrow();
     ControlStatus processTableSwitch(JSOp op, jssrcnote* sn);
     ControlStatus processContinue(JSOp op);
@@ -128,6 +128,8 @@ IonIC::trace(JSTracer* trc)
 IonGetPropertyIC::update(JSContext* cx, HandleScript outerScript, IonGetPropertyIC* ic,
                          HandleValue val, HandleValue idVal, MutableHandleValue res)
 {
+    ic->incrementEnteredCount();
+
     // Override the return value if we are invalidated (bug 728188).
     IonScript* ionScript = outerScript->ionScript();
     AutoDetectInvalidation adi(cx, res, ionScript);
@@ -208,6 +210,8 @@ IonGetPropertyIC::update(JSContext* cx, HandleScript outerScript, IonGetProperty
 IonGetPropSuperIC::update(JSContext* cx, HandleScript outerScript, IonGetPropSuperIC* ic,
                           HandleObject obj, HandleValue receiver, HandleValue idVal, MutableHandleValue res)
 {
+    ic->incrementEnteredCount();
+
     // Override the return value if we are invalidated (bug 728188).
     IonScript* ionScript = outerScript->ionScript();
     AutoDetectInvalidation adi(cx, res, ionScript);
@@ -250,6 +254,8 @@ IonGetPropSuperIC::update(JSContext* cx, HandleScript outerScript, IonGetPropSup
 IonSetPropertyIC::update(JSContext* cx, HandleScript outerScript, IonSetPropertyIC* ic,
                          HandleObject obj, HandleValue idVal, HandleValue rhs)
 {
+    ic->incrementEnteredCount();
+
     RootedShape oldShape(cx);
     RootedObjectGroup oldGroup(cx);
     IonScript* ionScript = outerScript->ionScript();
@@ -362,6 +368,8 @@ IonSetPropertyIC::update(JSContext* cx, HandleScript outerScript, IonSetProperty
 IonGetNameIC::update(JSContext* cx, HandleScript outerScript, IonGetNameIC* ic,
                      HandleObject envChain, MutableHandleValue res)
 {
+    ic->incrementEnteredCount();
+
     IonScript* ionScript = outerScript->ionScript();
     jsbytecode* pc = ic->pc();
     RootedPropertyName name(cx, ic->script()->getName(pc));
@@ -410,6 +418,8 @@ IonGetNameIC::update(JSContext* cx, HandleScript outerScript, IonGetNameIC* ic,
 IonBindNameIC::update(JSContext* cx, HandleScript outerScript, IonBindNameIC* ic,
                       HandleObject envChain)
 {
+    ic->incrementEnteredCount();
+
     IonScript* ionScript = outerScript->ionScript();
     jsbytecode* pc = ic->pc();
     RootedPropertyName name(cx, ic->script()->getName(pc));
@@ -443,6 +453,8 @@ IonBindNameIC::update(JSContext* cx, HandleScript outerScript, IonBindNameIC* ic
 IonGetIteratorIC::update(JSContext* cx, HandleScript outerScript, IonGetIteratorIC* ic,
                          HandleValue value)
 {
+    ic->incrementEnteredCount();
+
     IonScript* ionScript = outerScript->ionScript();
 
     if (ic->state().maybeTransition()) {
@@ -469,6 +481,8 @@ IonGetIteratorIC::update(JSContext* cx, HandleScript outerScript, IonGetIterator
 IonHasOwnIC::update(JSContext* cx, HandleScript outerScript, IonHasOwnIC* ic,
                     HandleValue val, HandleValue idVal, int32_t* res)
 {
+    ic->incrementEnteredCount();
+
     IonScript* ionScript = outerScript->ionScript();
 
     if (ic->state().maybeTransition()) {
@@ -503,6 +517,8 @@ IonHasOwnIC::update(JSContext* cx, HandleScript outerScript, IonHasOwnIC* ic,
 IonInIC::update(JSContext* cx, HandleScript outerScript, IonInIC* ic,
                 HandleValue key, HandleObject obj, bool* res)
 {
+    ic->incrementEnteredCount();
+
     IonScript* ionScript = outerScript->ionScript();
 
     if (ic->state().maybeTransition()) {
@@ -530,6 +546,8 @@ IonInIC::update(JSContext* cx, HandleScript outerScript, IonInIC* ic,
 IonInstanceOfIC::update(JSContext* cx, HandleScript outerScript, IonInstanceOfIC* ic,
                         HandleValue lhs, HandleObject rhs, bool* res)
 {
+    ic->incrementEnteredCount();
+
     IonScript* ionScript = outerScript->ionScript();
 
     if (ic->state().maybeTransition()) {
@@ -560,6 +578,8 @@ IonInstanceOfIC::update(JSContext* cx, HandleScript outerScript, IonInstanceOfIC
 IonUnaryArithIC::update(JSContext* cx, HandleScript outerScript, IonUnaryArithIC* ic,
                         HandleValue val, MutableHandleValue res)
 {
+    ic->incrementEnteredCount();
+
     IonScript* ionScript = outerScript->ionScript();
     RootedScript script(cx, ic->script());
     jsbytecode* pc = ic->pc();
@@ -609,6 +629,8 @@ IonUnaryArithIC::update(JSContext* cx, HandleScript outerScript, IonUnaryArithIC
 IonBinaryArithIC::update(JSContext* cx, HandleScript outerScript, IonBinaryArithIC* ic,
                          HandleValue lhs, HandleValue rhs, MutableHandleValue ret)
 {
+    ic->incrementEnteredCount();
+
     IonScript* ionScript = outerScript->ionScript();
     RootedScript script(cx, ic->script());
     jsbytecode* pc = ic->pc();
@@ -696,6 +718,8 @@ IonCompareIC::update(JSContext* cx,
                      HandleValue rhs,
                      bool* res)
 {
+    ic->incrementEnteredCount();
+
     IonScript* ionScript = outerScript->ionScript();
     RootedScript script(cx, ic->script());
     jsbytecode* pc = ic->pc();
@@ -92,6 +92,9 @@ class IonIC
     bool idempotent_ : 1;
     ICState state_;
 
+    // The number of times the IC's update function has been called.
+    uint32_t enteredCount_;
+
   protected:
     explicit IonIC(CacheKind kind)
       : codeRaw_(nullptr),
@@ -102,7 +105,8 @@ class IonIC
         pc_(nullptr),
         kind_(kind),
         idempotent_(false),
-        state_()
+        state_(),
+        enteredCount_(0)
     {}
 
     void attachStub(IonICStub* newStub, JitCode* code);
@@ -133,6 +137,15 @@ class IonIC
     CacheKind kind() const { return kind_; }
     uint8_t** codeRawPtr() { return &codeRaw_; }
 
+    IonICStub* firstStub() const { return firstStub_; }
+
+    uint32_t enteredCount() const { return enteredCount_; }
+    void incrementEnteredCount() {
+        if (enteredCount_ < UINT32_MAX) {
+            enteredCount_++;
+        }
+    }
+
     bool idempotent() const { return idempotent_; }
     void setIdempotent() { idempotent_ = true; }
 
@@ -54,6 +54,9 @@ OptimizationInfo::initNormalOptimizationInfo()
     compilerSmallFunctionWarmUpThreshold_ = CompilerSmallFunctionWarmupThreshold;
     inliningWarmUpThresholdFactor_ = 0.125;
     inliningRecompileThresholdFactor_ = 4;
+    inliningColdCallSiteFactor_ = 100;
+    inliningMinCallSiteCalls_ = 100;
+    inliningMinTargetCallPercent_ = 5;
 }
 
 void
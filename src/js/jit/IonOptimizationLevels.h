@@ -146,6 +146,18 @@ class OptimizationInfo
     // as a multiplication of inliningWarmUpThreshold.
     uint32_t inliningRecompileThresholdFactor_;
 
+    // A call site is too cold to inline at if Baseline saw fewer calls there
+    // than the caller's warm-up count divided by this factor.
+    uint32_t inliningColdCallSiteFactor_;
+
+    // How many calls Baseline has to have seen at a call site before its
+    // per-target call counts are used to choose which targets to inline.
+    uint32_t inliningMinCallSiteCalls_;
+
+    // The percentage of a call site's calls a target needs, for it to be
+    // inlined at a call site with counts for all its targets.
+    uint32_t inliningMinTargetCallPercent_;
+
     constexpr OptimizationInfo()
       : level_(OptimizationLevel::Normal),
         eaa_(false),
@@ -174,7 +186,10 @@ class OptimizationInfo
         compilerWarmUpThreshold_(0),
         compilerSmallFunctionWarmUpThreshold_(0),
         inliningWarmUpThresholdFactor_(0.0),
-        inliningRecompileThresholdFactor_(0)
+        inliningRecompileThresholdFactor_(0),
+        inliningColdCallSiteFactor_(0),
+        inliningMinCallSiteCalls_(0),
+        inliningMinTargetCallPercent_(0)
     { }
 
     void initNormalOptimizationInfo();
@@ -288,6 +303,18 @@ class OptimizationInfo
     uint32_t inliningRecompileThreshold() const {
         return inliningWarmUpThreshold() * inliningRecompileThresholdFactor_;
     }
+
+    uint32_t inliningColdCallSiteFactor() const {
+        return inliningColdCallSiteFactor_;
+    }
+
+    uint32_t inliningMinCallSiteCalls() const {
+        return inliningMinCallSiteCalls_;
+    }
+
+    uint32_t inliningMinTargetCallPercent() const {
+        return inliningMinTargetCallPercent_;
+    }
 };
 
 class OptimizationLevelInfo
@@ -717,6 +717,8 @@ ScalarTypeToMIRType(Scalar::Type type)
         return MIRType::Float32;
       case Scalar::Float64:
         return MIRType::Double;
+      case Scalar::Simd128:
+        return MIRType::Int32x4;
       case Scalar::MaxTypedArrayViewType:
         break;
     }
@@ -738,6 +740,8 @@ ScalarTypeToLength(Scalar::Type type)
       case Scalar::Float64:
       case Scalar::Uint8Clamped:
         return 1;
+      case Scalar::Simd128:
+        return 4;
       case Scalar::MaxTypedArrayViewType:
         break;
     }
@@ -279,6 +279,41 @@ HandleExceptionIon(JSContext* cx, const InlineFrameIterator& frame, ResumeFromEx
             }
             break;
 
+          case JSTRY_FINALLY:
+            if (cx->isExceptionPending()) {
+                // See corresponding comment in ProcessTryNotes.
+                if (inForOfIterClose) {
+                    break;
+                }
+
+                // Ion only compiles finally blocks for the normal completion
+                // of the try block. As for catch blocks, reset the warm-up
+                // counter if we bail out to run them for exceptions.
+                script->resetWarmUpCounter();
+
+                // Bailout at the start of the finally block, with the
+                // exception on the stack as in ProcessTryNotesBaseline.
+                RootedValue exception(cx);
+                if (!cx->getPendingException(&exception)) {
+                    exception = UndefinedValue();
+                }
+
+                jsbytecode* finallyPC = script->main() + tn->start + tn->length;
+                ExceptionBailoutInfo excInfo(frame.frameNo(), finallyPC, tn->stackDepth);
+                excInfo.setFinallyException(exception);
+                uint32_t retval = ExceptionHandlerBailout(cx, frame, rfe, excInfo, overrecursed);
+                if (retval == BAILOUT_RETURN_OK) {
+                    rfe->bailoutInfo->tryPC = UnwindEnvironmentToTryPc(frame.script(), tn);
+                    rfe->bailoutInfo->faultPC = frame.pc();
+                    cx->clearPendingException();
+                    return;
+                }
+
+                // Error on bailout clears pending exception.
+                MOZ_ASSERT(!cx->isExceptionPending());
+            }
+            break;
+
           default:
             MOZ_CRASH("Unexpected try note");
         }
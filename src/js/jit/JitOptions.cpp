@@ -130,6 +130,14 @@ DefaultJitOptions::DefaultJitOptions()
     // Toggles whether CacheIR stubs for binary arith operations are used
     SET_DEFAULT(disableCacheIRBinaryArith, false);
 
+    // Toggles whether Ion emits the code of blocks which are unlikely to run
+    // after the rest of the function.
+    SET_DEFAULT(disableColdBlocks, false);
+
+    // Toggles whether Ion drops the pre-barriers of stores which initialize
+    // objects it just allocated.
+    SET_DEFAULT(disableInitPreBarrierElimination, false);
+
     // Toggles whether sincos optimization is globally disabled.
     // See bug984018: The MacOS is the only one that has the sincos fast.
     #if defined(XP_MACOSX)
@@ -141,6 +149,10 @@ DefaultJitOptions::DefaultJitOptions()
     // Toggles whether sink code motion is globally disabled.
     SET_DEFAULT(disableSink, true);
 
+    // Toggles whether XDR encodes which tiers a script reached, so that
+    // decoded scripts can skip most of their warm-up.
+    SET_DEFAULT(disableXDRWarmUpHints, false);
+
     // Whether functions are compiled immediately.
     SET_DEFAULT(eagerCompilation, false);
 
@@ -161,6 +173,12 @@ DefaultJitOptions::DefaultJitOptions()
     // Duplicated in all.js - ensure both match.
     SET_DEFAULT(baselineWarmUpThreshold, 10);
 
+    // How many milliseconds of Baseline compilation the main thread may do in
+    // each 16ms window before further compilations are put off. When many
+    // scripts get warm at once this spreads their compilation out instead of
+    // blocking the event loop. Zero means no limit.
+    SET_DEFAULT(baselineCompileBudgetMs, 0);
+
     // Number of exception bailouts (resuming into catch/finally block) before
     // we invalidate and forbid Ion compilation.
     SET_DEFAULT(exceptionBailoutThreshold, 10);
@@ -170,6 +188,15 @@ DefaultJitOptions::DefaultJitOptions()
     // Duplicated in all.js - ensure both match.
     SET_DEFAULT(frequentBailoutThreshold, 10);
 
+    // Number of major GCs a script's JIT code can go unused before it is
+    // discarded, when the zone's JIT code is otherwise preserved. 0 disables
+    // discarding of unused code.
+    SET_DEFAULT(jitCodeDiscardAge, 8);
+
+    // Number of bailouts at a single bytecode site, across all compilations
+    // of a script, before Ion stops hoisting code in the loop containing it.
+    SET_DEFAULT(frequentBailoutSiteThreshold, 5);
+
     // Whether to run all debug checks in debug builds.
     // Disabling might make it more enjoyable to run JS in debug builds.
     SET_DEFAULT(fullDebugChecks, true);
@@ -188,6 +215,11 @@ DefaultJitOptions::DefaultJitOptions()
     // pc-relative jump and call instructions.
     SET_DEFAULT(jumpThreshold, UINT32_MAX);
 
+    // How many virtual registers a function's LIR may have before the
+    // backtracking allocator switches to linear scan allocation, which is
+    // much faster on very large functions. Zero disables the switch.
+    SET_DEFAULT(linearScanVirtualRegisterThreshold, 20000);
+
     // Branch pruning heuristic is based on a scoring system, which is look at
     // different metrics and provide a score. The score is computed as a
     // projection where each factor defines the weight of each metric. Then this
@@ -254,11 +286,23 @@ DefaultJitOptions::DefaultJitOptions()
     // as well as the transition from one tier to the other.
     SET_DEFAULT(wasmDelayTier2, false);
 
+    // Whether to report the hardware performance counters of each Ion back
+    // end compilation on stderr.
+    SET_DEFAULT(ionPerfCounters, false);
+
     // Until which wasm bytecode size should we accumulate functions, in order
     // to compile efficiently on helper threads. Baseline code compiles much
     // faster than Ion code so use scaled thresholds (see also bug 1320374).
+    // Cranelift sits in between.
     SET_DEFAULT(wasmBatchBaselineThreshold, 10000);
     SET_DEFAULT(wasmBatchIonThreshold, 1100);
+    SET_DEFAULT(wasmBatchCraneliftThreshold, 5000);
+
+    // How many function entries and loop iterations an instance of a module
+    // compiled for tiering must execute in baseline code before tier-2
+    // compilation of the module is started. Zero starts tier-2 compilation as
+    // soon as the baseline tier is done.
+    SET_DEFAULT(wasmTier2Threshold, 20000);
 
 #ifdef JS_TRACE_LOGGING
     // Toggles whether the traceLogger should be on or off.  In either case,
@@ -24,6 +24,7 @@ static const uint32_t MAX_MAIN_THREAD_LOCALS_AND_ARGS = 256;
 enum IonRegisterAllocator {
     RegisterAllocator_Backtracking,
     RegisterAllocator_Testbed,
+    RegisterAllocator_LinearScan,
     RegisterAllocator_Stupid
 };
 
@@ -36,6 +37,9 @@ LookupRegisterAllocator(const char* name)
     if (!strcmp(name, "testbed")) {
         return mozilla::Some(RegisterAllocator_Testbed);
     }
+    if (!strcmp(name, "linearscan")) {
+        return mozilla::Some(RegisterAllocator_LinearScan);
+    }
     if (!strcmp(name, "stupid")) {
         return mozilla::Some(RegisterAllocator_Stupid);
     }
@@ -66,8 +70,11 @@ struct DefaultJitOptions
     bool disableScalarReplacement;
     bool disableCacheIR;
     bool disableCacheIRBinaryArith;
+    bool disableColdBlocks;
+    bool disableInitPreBarrierElimination;
     bool disableSincos;
     bool disableSink;
+    bool disableXDRWarmUpHints;
     bool eagerCompilation;
     bool forceInlineCaches;
     bool fullDebugChecks;
@@ -75,22 +82,29 @@ struct DefaultJitOptions
     bool osr;
     bool wasmFoldOffsets;
     bool wasmDelayTier2;
+    bool ionPerfCounters;
 #ifdef JS_TRACE_LOGGING
     bool enableTraceLogger;
 #endif
     uint32_t baselineWarmUpThreshold;
+    uint32_t baselineCompileBudgetMs;
     uint32_t exceptionBailoutThreshold;
     uint32_t frequentBailoutThreshold;
+    uint32_t frequentBailoutSiteThreshold;
+    uint32_t jitCodeDiscardAge;
     uint32_t maxStackArgs;
     uint32_t osrPcMismatchesBeforeRecompile;
     uint32_t smallFunctionMaxBytecodeLength_;
     uint32_t jumpThreshold;
+    uint32_t linearScanVirtualRegisterThreshold;
     uint32_t branchPruningHitCountFactor;
     uint32_t branchPruningInstFactor;
     uint32_t branchPruningBlockSpanFactor;
     uint32_t branchPruningEffectfulInstFactor;
     uint32_t branchPruningThreshold;
     uint32_t wasmBatchIonThreshold;
+    uint32_t wasmBatchCraneliftThreshold;
+    uint32_t wasmTier2Threshold;
     uint32_t wasmBatchBaselineThreshold;
     mozilla::Maybe<uint32_t> forcedDefaultIonWarmUpThreshold;
     mozilla::Maybe<uint32_t> forcedDefaultIonSmallFunctionWarmUpThreshold;
@@ -119,6 +133,30 @@ struct DefaultJitOptions
 
 extern DefaultJitOptions JitOptions;
 
+// The Spectre mitigations used when generating a piece of JIT code. JitOptions
+// has the mitigations enabled for the process. Code for a zone created with
+// JS::RealmCreationOptions::setSpectreMitigations(false) runs only trusted
+// script, and is compiled without any of them. Code shared by all zones, such
+// as trampolines and wasm modules, always uses JitOptions.
+struct SpectreMitigations
+{
+    bool indexMasking;
+    bool objectMitigationsBarriers;
+    bool objectMitigationsMisc;
+    bool stringMitigations;
+    bool valueMasking;
+    bool jitToCxxCalls;
+
+    explicit SpectreMitigations(bool enabled = true)
+      : indexMasking(enabled && JitOptions.spectreIndexMasking),
+        objectMitigationsBarriers(enabled && JitOptions.spectreObjectMitigationsBarriers),
+        objectMitigationsMisc(enabled && JitOptions.spectreObjectMitigationsMisc),
+        stringMitigations(enabled && JitOptions.spectreStringMitigations),
+        valueMasking(enabled && JitOptions.spectreValueMasking),
+        jitToCxxCalls(enabled && JitOptions.spectreJitToCxxCalls)
+    {}
+};
+
 } // namespace jit
 } // namespace js
 
@@ -10,10 +10,12 @@
 #include "mozilla/Array.h"
 #include "mozilla/DebugOnly.h"
 #include "mozilla/MemoryReporting.h"
+#include "mozilla/TimeStamp.h"
 
 #include <utility>
 
 #include "builtin/TypedObject.h"
+#include "jit/BailoutCounts.h"
 #include "jit/CompileInfo.h"
 #include "jit/ICStubSpace.h"
 #include "jit/IonCode.h"
@@ -76,6 +78,9 @@ class JitRuntime
 
     MainThreadData<uint64_t> nextCompilationId_;
 
+    // Bytes of JIT code released by Zone::discardAgedJitCode.
+    MainThreadData<uint64_t> agedCodeBytesDiscarded_;
+
     // Shared exception-handler tail.
     WriteOnceData<uint32_t> exceptionTailOffset_;
 
@@ -134,13 +139,17 @@ class JitRuntime
     WriteOnceData<JitCode*> baselineDebugModeOSRHandler_;
     WriteOnceData<void*> baselineDebugModeOSRHandlerNoFrameRegPopAddr_;
 
-    // Code for trampolines and VMFunction wrappers.
+    // Code for trampolines.
     WriteOnceData<JitCode*> trampolineCode_;
 
-    // Map VMFunction addresses to the offset of the wrapper in
-    // trampolineCode_.
-    using VMWrapperMap = HashMap<const VMFunction*, uint32_t, VMFunction>;
+    // Map VMFunction addresses to their wrappers. Wrappers are generated on
+    // the main thread when Baseline code or an IC first needs them, and all
+    // at once before the first Ion compilation, since Ion generates code off
+    // thread. After that the map doesn't change and may be read from any
+    // thread.
+    using VMWrapperMap = HashMap<const VMFunction*, uint8_t*, VMFunction>;
     WriteOnceData<VMWrapperMap*> functionWrappers_;
+    WriteOnceData<bool> allVMWrappersGenerated_;
 
     // Global table of jitcode native address => bytecode address mappings.
     UnprotectedData<JitcodeGlobalTable*> jitcodeGlobalTable_;
@@ -166,6 +175,11 @@ class JitRuntime
     // Counter used to help dismbiguate stubs in CacheIR
     MainThreadData<uint64_t> disambiguationId_;
 
+    // Start of the current Baseline compilation window, and the time spent
+    // compiling Baseline code during it. See JitOptions.baselineCompileBudgetMs.
+    MainThreadData<mozilla::TimeStamp> baselineCompileWindowStart_;
+    MainThreadData<mozilla::TimeDuration> baselineCompileWindowTime_;
+
   private:
     void generateLazyLinkStub(MacroAssembler& masm);
     void generateInterpreterStub(MacroAssembler& masm);
@@ -182,7 +196,9 @@ class JitRuntime
     void generateFreeStub(MacroAssembler& masm);
     JitCode* generateDebugTrapHandler(JSContext* cx);
     JitCode* generateBaselineDebugModeOSRHandler(JSContext* cx, uint32_t* noFrameRegPopOffsetOut);
-    bool generateVMWrapper(JSContext* cx, MacroAssembler& masm, const VMFunction& f);
+    bool generateVMWrapper(JSContext* cx, MacroAssembler& masm, const VMFunction& f,
+                           uint32_t* wrapperOffset);
+    bool generateVMWrappers(JSContext* cx, const VMFunction* only);
 
     bool generateTLEventVM(MacroAssembler& masm, const VMFunction& f, bool enter);
 
@@ -219,7 +235,25 @@ class JitRuntime
         return IonCompilationId(nextCompilationId_++);
     }
 
+    // Ids are assigned when compilations are linked, so this is the number of
+    // Ion compilations which have produced code.
+    uint64_t numIonCompilations() const {
+        return nextCompilationId_;
+    }
+
+    uint64_t agedCodeBytesDiscarded() const {
+        return agedCodeBytesDiscarded_;
+    }
+    void addAgedCodeBytesDiscarded(uint64_t bytes) {
+        agedCodeBytesDiscarded_ += bytes;
+    }
+
+    // Return the wrapper for a VMFunction. The wrapper must exist: code
+    // generated on the main thread calls ensureVMWrapper first, and Ion calls
+    // ensureAllVMWrappers before compiling.
     TrampolinePtr getVMWrapper(const VMFunction& f) const;
+    MOZ_MUST_USE bool ensureVMWrapper(JSContext* cx, const VMFunction& f);
+    MOZ_MUST_USE bool ensureAllVMWrappers(JSContext* cx);
     JitCode* debugTrapHandler(JSContext* cx);
     JitCode* getBaselineDebugModeOSRHandler(JSContext* cx);
     void* getBaselineDebugModeOSRHandlerAddress(JSContext* cx, bool popFrameReg);
@@ -336,6 +370,13 @@ class JitRuntime
     uint64_t nextDisambiguationId() {
         return disambiguationId_++;
     }
+
+    mozilla::TimeStamp& baselineCompileWindowStart() {
+        return baselineCompileWindowStart_.ref();
+    }
+    mozilla::TimeDuration& baselineCompileWindowTime() {
+        return baselineCompileWindowTime_.ref();
+    }
 };
 
 enum class CacheKind : uint8_t;
@@ -401,6 +442,9 @@ class JitZone
                                                  IcStubCodeMapGCPolicy<CacheIRStubKey>>;
     BaselineCacheIRStubCodeMap baselineCacheIRStubCodes_;
 
+    // Bailout and invalidation counts for scripts in this Zone.
+    BailoutCounts bailoutCounts_;
+
   public:
     void sweep();
 
@@ -415,6 +459,9 @@ class JitZone
     CFGSpace* cfgSpace() {
         return &cfgSpace_;
     }
+    BailoutCounts& bailoutCounts() {
+        return bailoutCounts_;
+    }
 
     JitCode* getBaselineCacheIRStubCode(const CacheIRStubKey::Lookup& key,
                                         CacheIRStubInfo** stubInfo) {
@@ -627,6 +674,45 @@ void FinishInvalidation(FreeOp* fop, JSScript* script);
 const unsigned WINDOWS_BIG_FRAME_TOUCH_INCREMENT = 4096 - 1;
 #endif
 
+// This class groups the reprotections done by AutoWritableJitCode instances
+// during its lifetime. Regions made writable are left writable until the batch
+// ends, and the pages involved are then coalesced into ranges which are made
+// executable with one call each. This is useful when patching lots of JIT code
+// at once, e.g. when toggling instrumentation in every script.
+//
+// No JIT code may run while a batch is active, as the pages it has made
+// writable are not executable. Batches may be nested, in which case only the
+// outermost one has any effect.
+class MOZ_RAII AutoBatchJitCodeReprotection
+{
+    struct PageRange {
+        uintptr_t start;
+        uintptr_t end;
+    };
+
+    // Maximum number of disjoint ranges to keep writable at once.
+    static const size_t MaxRanges = 256;
+
+    JSRuntime* rt_;
+    bool active_;
+
+    // Sorted, disjoint and non-adjacent page ranges which have been made
+    // writable.
+    Vector<PageRange, 8, SystemAllocPolicy> ranges_;
+
+  public:
+    explicit AutoBatchJitCodeReprotection(JSRuntime* rt);
+    ~AutoBatchJitCodeReprotection();
+
+    // Make all regions in the batch executable again. Later calls to
+    // makeWritable will reprotect them as needed.
+    void flush();
+
+    // Make a region writable until the end of the batch. On failure the
+    // caller must reprotect the region itself.
+    MOZ_MUST_USE bool makeWritable(void* addr, size_t size);
+};
+
 // This class ensures JIT code is executable on its destruction. Creators
 // must call makeWritable(), and not attempt to write to the buffer if it fails.
 //
@@ -657,6 +743,12 @@ class MOZ_RAII AutoWritableJitCodeFallible
     {}
 
     MOZ_MUST_USE bool makeWritable() {
+        // Within a batch, the batch makes the code executable again.
+        if (AutoBatchJitCodeReprotection* batch = rt_->jitCodeReprotectionBatch()) {
+            if (batch->makeWritable(addr_, size_)) {
+                return true;
+            }
+        }
         madeWritable_ = ExecutableAllocator::makeWritable(addr_, size_);
         return madeWritable_;
     }
@@ -473,8 +473,76 @@ JitcodeGlobalTable::lookupForSamplerInfallible(void* ptr, JSRuntime* rt, uint64_
     return *entry;
 }
 
+size_t
+JitcodeGlobalTable::searchIndex(void* ptr) const
+{
+    size_t lo = 0, hi = index_.length();
+    while (lo < hi) {
+        size_t mid = lo + (hi - lo) / 2;
+        if (uintptr_t(index_[mid].nativeStartAddr) <= uintptr_t(ptr)) {
+            lo = mid + 1;
+        } else {
+            hi = mid;
+        }
+    }
+    return lo ? lo - 1 : index_.length();
+}
+
 JitcodeGlobalEntry*
 JitcodeGlobalTable::lookupInternal(void* ptr)
+{
+    size_t i = searchIndex(ptr);
+    if (i < index_.length()) {
+        const IndexEntry& indexEntry = index_[i];
+        if (indexEntry.entry && uintptr_t(ptr) < uintptr_t(indexEntry.nativeEndAddr)) {
+            MOZ_ASSERT(indexEntry.entry->containsPointer(ptr));
+            return indexEntry.entry;
+        }
+    }
+
+    if (!unindexedEntries_) {
+        return nullptr;
+    }
+    return lookupSkiplist(ptr);
+}
+
+void
+JitcodeGlobalTable::removeFromIndex(JitcodeGlobalEntry& entry)
+{
+    size_t i = searchIndex(entry.nativeStartAddr());
+    if (i < index_.length() && index_[i].entry == &entry) {
+        index_[i].entry = nullptr;
+        return;
+    }
+
+    MOZ_ASSERT(unindexedEntries_);
+    unindexedEntries_--;
+}
+
+void
+JitcodeGlobalTable::rebuildIndex()
+{
+    // Callers must suppress sampling.
+    MOZ_ASSERT(!TlsContext.get()->isProfilerSamplingEnabled());
+
+    // If the index can't be allocated, lookups use the skiplist.
+    index_.clear();
+    unindexedEntries_ = skiplistSize_;
+    if (!index_.reserve(skiplistSize_)) {
+        return;
+    }
+
+    // The skiplist is sorted by address, and entries do not overlap.
+    for (Range r(*this); !r.empty(); r.popFront()) {
+        JitcodeGlobalEntry* entry = r.front();
+        IndexEntry indexEntry = { entry->nativeStartAddr(), entry->nativeEndAddr(), entry };
+        index_.infallibleAppend(indexEntry);
+    }
+    unindexedEntries_ = 0;
+}
+
+JitcodeGlobalEntry*
+JitcodeGlobalTable::lookupSkiplist(void* ptr)
 {
     JitcodeGlobalEntry query = JitcodeGlobalEntry::MakeQuery(ptr);
     JitcodeGlobalEntry* searchTower[JitcodeSkiplistTower::MAX_HEIGHT];
@@ -547,6 +615,7 @@ JitcodeGlobalTable::addEntry(const JitcodeGlobalEntry& entry)
         }
     }
     skiplistSize_++;
+    unindexedEntries_++;
     // verifySkiplist(); - disabled for release.
 
     // Any entries that may directly contain nursery pointers must be marked
@@ -567,6 +636,8 @@ JitcodeGlobalTable::removeEntry(JitcodeGlobalEntry& entry, JitcodeGlobalEntry**
         removeFromNurseryList(&entry.ionEntry());
     }
 
+    removeFromIndex(entry);
+
     // Unlink query entry.
     for (int level = entry.tower_->height() - 1; level >= 0; level--) {
         JitcodeGlobalEntry* prevTowerEntry = prevTower[level];
@@ -883,6 +954,9 @@ JitcodeGlobalTable::sweep(JSRuntime* rt)
             entry->sweepChildren(rt);
         }
     }
+
+    // Fold the entries added and removed since the last GC into the index.
+    rebuildIndex();
 }
 
 template <class ShouldTraceProvider>
@@ -1038,10 +1038,26 @@ class JitcodeGlobalTable
     JitcodeGlobalEntry* startTower_[JitcodeSkiplistTower::MAX_HEIGHT];
     JitcodeSkiplistTower* freeTowers_[JitcodeSkiplistTower::MAX_HEIGHT];
 
+    // Sorted array of the entries' code ranges, which is much faster to
+    // search than the skiplist. The sampler looks up every frame's return
+    // address, so it uses this first.
+    //
+    // The index is only rebuilt when sweeping. Entries removed since then
+    // are left in place with a null entry pointer, and entries added since
+    // then are only in the skiplist, which is searched if the index does
+    // not have a matching entry and unindexedEntries_ is non-zero.
+    struct IndexEntry {
+        void* nativeStartAddr;
+        void* nativeEndAddr;
+        JitcodeGlobalEntry* entry;
+    };
+    Vector<IndexEntry, 0, SystemAllocPolicy> index_;
+    uint32_t unindexedEntries_;
+
   public:
     JitcodeGlobalTable()
       : alloc_(LIFO_CHUNK_SIZE), freeEntries_(nullptr), rand_(0), skiplistSize_(0),
-        nurseryEntries_(nullptr)
+        nurseryEntries_(nullptr), unindexedEntries_(0)
     {
         for (unsigned i = 0; i < JitcodeSkiplistTower::MAX_HEIGHT; i++) {
             startTower_[i] = nullptr;
@@ -1094,6 +1110,13 @@ class JitcodeGlobalTable
     MOZ_MUST_USE bool addEntry(const JitcodeGlobalEntry& entry);
 
     JitcodeGlobalEntry* lookupInternal(void* ptr);
+    JitcodeGlobalEntry* lookupSkiplist(void* ptr);
+
+    // Find the last index entry starting at or below ptr, or return
+    // index_.length() if there is none.
+    size_t searchIndex(void* ptr) const;
+    void removeFromIndex(JitcodeGlobalEntry& entry);
+    void rebuildIndex();
 
     // Initialize towerOut such that towerOut[i] (for i in [0, MAX_HEIGHT-1])
     // is a JitcodeGlobalEntry that is sorted to be <query, whose successor at
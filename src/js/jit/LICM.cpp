@@ -7,9 +7,11 @@
 #include "jit/LICM.h"
 
 #include "jit/IonAnalysis.h"
+#include "jit/JitRealm.h"
 #include "jit/JitSpewer.h"
 #include "jit/MIRGenerator.h"
 #include "jit/MIRGraph.h"
+#include "vm/JSScript.h"
 
 using namespace js;
 using namespace js::jit;
@@ -244,6 +246,32 @@ VisitLoop(MIRGraph& graph, MBasicBlock* header)
     }
 }
 
+// Test whether any bytecode in the loop, including its entry, has bailed out
+// frequently in earlier compilations of the script. Hoisted instructions bail
+// out to a resume point in the loop's preheader, so these bailouts are
+// attributed to the start of the loop.
+static bool
+LoopHasFrequentBailouts(MBasicBlock* header)
+{
+    JSScript* script = header->info().script();
+    if (!script) {
+        return false;
+    }
+
+    MBasicBlock* preheader = header->loopPredecessor();
+    MBasicBlock* backedge = header->backedge();
+
+    jsbytecode* begin = header->pc();
+    if (preheader->info().script() == script && preheader->pc() < begin) {
+        begin = preheader->pc();
+    }
+    jsbytecode* end = backedge->pc() > header->pc() ? backedge->pc() : header->pc();
+
+    BailoutCounts& counts = script->zone()->jitZone()->bailoutCounts();
+    return counts.hasFrequentBailoutSite(script, script->pcToOffset(begin),
+                                         script->pcToOffset(end));
+}
+
 bool
 jit::LICM(MIRGenerator* mir, MIRGraph& graph)
 {
@@ -268,10 +296,13 @@ jit::LICM(MIRGenerator* mir, MIRGraph& graph)
         // Hoisting out of a loop that has an entry from the OSR block in
         // addition to its normal entry is tricky. In theory we could clone
         // the instruction and insert phis.
-        if (!canOsr) {
-            VisitLoop(graph, header);
-        } else {
+        if (canOsr) {
             JitSpew(JitSpew_LICM, "  Skipping loop with header block%u due to OSR", header->id());
+        } else if (LoopHasFrequentBailouts(header)) {
+            JitSpew(JitSpew_LICM, "  Skipping loop with header block%u due to frequent bailouts",
+                    header->id());
+        } else {
+            VisitLoop(graph, header);
         }
 
         UnmarkLoopBlocks(graph, header);
@@ -6,6 +6,8 @@
 
 #include "jit/LoopUnroller.h"
 
+#include "jsnum.h"
+
 #include "jit/MIRGraph.h"
 
 #include "vm/JSScript-inl.h"
@@ -21,6 +23,24 @@ struct LoopUnroller
 {
     typedef HashMap<MDefinition*, MDefinition*,
                     PointerHasher<MDefinition*>, SystemAllocPolicy> DefinitionMap;
+    typedef HashSet<MDefinition*,
+                    PointerHasher<MDefinition*>, SystemAllocPolicy> DefinitionSet;
+
+    // Range of indexes 'phi + low' to 'phi + high' which the bounds checks
+    // in one iteration of the unrolled loop access, relative to the value of
+    // an induction variable at the start of that iteration.
+    struct VersionedRange
+    {
+        MPhi* phi;
+        MDefinition* length;
+        int32_t low;
+        int32_t high;
+
+        VersionedRange(MPhi* phi, MDefinition* length, int32_t low, int32_t high)
+          : phi(phi), length(length), low(low), high(high)
+        {}
+    };
+    typedef Vector<VersionedRange, 4, SystemAllocPolicy> VersionedRangeVector;
 
     explicit LoopUnroller(MIRGraph& graph)
       : graph(graph), alloc(graph.alloc()),
@@ -49,7 +69,17 @@ struct LoopUnroller
     // Map terms in the original loop to terms in the current unrolled iteration.
     DefinitionMap unrolledDefinitions;
 
+    // Bounds checks in the original loop which are not copied into the
+    // unrolled loop, and the index ranges which the unrolled loop's header
+    // must test instead. If any of these tests fail the unrolled loop exits
+    // and the original, checked loop runs the remaining iterations.
+    DefinitionSet versionedChecks;
+    VersionedRangeVector versionedRanges;
+
     MDefinition* getReplacementDefinition(MDefinition* def);
+    MOZ_MUST_USE bool tryVersionBoundsCheck(MBoundsCheck* check, size_t unrollCount);
+    MOZ_MUST_USE bool addVersionedRangeTests(LinearSum& remainingIterations,
+                                             MDefinition** pcondition);
     MResumePoint* makeReplacementResumePoint(MBasicBlock* block, MResumePoint* rp);
     MOZ_MUST_USE bool makeReplacementInstruction(MInstruction* ins);
 
@@ -81,6 +111,121 @@ LoopUnroller::getReplacementDefinition(MDefinition* def)
     return p->value();
 }
 
+bool
+LoopUnroller::tryVersionBoundsCheck(MBoundsCheck* check, size_t unrollCount)
+{
+    // Look for checks of the form 'phi + constant < length', where the phi is
+    // an induction variable of the loop which changes by a constant amount
+    // each iteration, and the length is loop invariant. Typically the length
+    // is an initialized length which LICM hoisted out of the loop.
+    if (!check->fallible()) {
+        return true;
+    }
+
+    MDefinition* length = check->length();
+    if (length->block()->id() >= header->id()) {
+        return true;
+    }
+
+    SimpleLinearSum index = ExtractLinearSum(check->index());
+    if (!index.term || !index.term->isPhi() || index.term->block() != header) {
+        return true;
+    }
+    MPhi* phi = index.term->toPhi();
+
+    SimpleLinearSum next = ExtractLinearSum(phi->getOperand(1));
+    if (next.term != phi || next.constant == 0) {
+        return true;
+    }
+
+    // Across the unrolled iterations the phi covers the values between its
+    // initial value and 'phi + (unrollCount - 1) * step'.
+    int32_t span;
+    if (!SafeMul(next.constant, int32_t(unrollCount - 1), &span)) {
+        return true;
+    }
+    int32_t low, high;
+    if (!SafeAdd(index.constant, check->minimum(), &low) ||
+        !SafeAdd(index.constant, check->maximum(), &high))
+    {
+        return true;
+    }
+    if (span < 0 ? !SafeAdd(low, span, &low) : !SafeAdd(high, span, &high)) {
+        return true;
+    }
+    if (high == INT32_MAX) {
+        return true;
+    }
+
+    if (!versionedChecks.put(check)) {
+        return false;
+    }
+
+    // Coalesce ranges over the same phi and length, so that a loop touching
+    // several adjacent elements only needs a single pair of tests.
+    for (size_t i = 0; i < versionedRanges.length(); i++) {
+        VersionedRange& range = versionedRanges[i];
+        if (range.phi == phi && range.length == length) {
+            range.low = Min(range.low, low);
+            range.high = Max(range.high, high);
+            return true;
+        }
+    }
+
+    return versionedRanges.append(VersionedRange(phi, length, low, high));
+}
+
+bool
+LoopUnroller::addVersionedRangeTests(LinearSum& remainingIterations, MDefinition** pcondition)
+{
+    // All of the tests have the form 'sum >= 0', so combine them into a
+    // single test on the minimum of the sums. This keeps the unrolled loop
+    // header ending in a single branch, and avoids adding critical edges.
+    MDefinition* condition = ConvertLinearSum(alloc, unrolledHeader, remainingIterations,
+                                              /* convertConstant = */ true);
+
+    for (size_t i = 0; i < versionedRanges.length(); i++) {
+        const VersionedRange& range = versionedRanges[i];
+        MDefinition* phi = getReplacementDefinition(range.phi);
+
+        // phi + low >= 0. This can be omitted if the phi's range shows it
+        // always holds.
+        bool needLower = true;
+        if (Range* r = range.phi->range()) {
+            if (r->hasInt32LowerBound() && int64_t(r->lower()) + range.low >= 0) {
+                needLower = false;
+            }
+        }
+
+        // length - phi - high - 1 >= 0
+        MOZ_ASSERT(range.high < INT32_MAX);
+        LinearSum lower(alloc);
+        LinearSum upper(alloc);
+        if (!lower.add(phi, 1) || !lower.add(range.low) ||
+            !upper.add(range.length, 1) || !upper.add(phi, -1) ||
+            !upper.add(-(range.high + 1)))
+        {
+            return false;
+        }
+
+        LinearSum* sums[] = { needLower ? &lower : nullptr, &upper };
+        for (size_t j = 0; j < ArrayLength(sums); j++) {
+            if (!sums[j]) {
+                continue;
+            }
+            MDefinition* sum = ConvertLinearSum(alloc, unrolledHeader, *sums[j],
+                                                /* convertConstant = */ true);
+            MMinMax* min = MMinMax::New(alloc, condition, sum, MIRType::Int32, false);
+            unrolledHeader->insertAtEnd(min);
+            min->computeRange(alloc);
+            condition = min;
+        }
+    }
+
+    *pcondition = condition;
+    return true;
+}
+
 bool
 LoopUnroller::makeReplacementInstruction(MInstruction* ins)
 {
@@ -93,6 +238,12 @@ LoopUnroller::makeReplacementInstruction(MInstruction* ins)
         }
     }
 
+    // Versioned bounds checks are covered by the tests in the unrolled loop
+    // header and just produce their index.
+    if (versionedChecks.has(ins)) {
+        return unrolledDefinitions.putNew(ins, inputs[0]);
+    }
+
     MInstruction* clone = ins->clone(alloc, inputs);
 
     unrolledBackedge->add(clone);
@@ -222,6 +373,17 @@ LoopUnroller::go(LoopIterationBound* bound)
         return true;
     }
 
+    // Find bounds checks in the loop body which we can test once per unrolled
+    // iteration instead of once per original iteration.
+    for (size_t i = 0; i < ArrayLength(bodyBlocks); i++) {
+        MBasicBlock* block = bodyBlocks[i];
+        for (MInstructionIterator iter(block->begin()); iter != block->end(); iter++) {
+            if (iter->isBoundsCheck() && !tryVersionBoundsCheck(iter->toBoundsCheck(), UnrollCount)) {
+                return false;
+            }
+        }
+    }
+
     // OK, we've checked everything, now unroll the loop.
 
     JitSpew(JitSpew_Unrolling, "Unrolling loop");
@@ -322,7 +484,26 @@ LoopUnroller::go(LoopIterationBound* bound)
         MDefinition* replacement = getReplacementDefinition(def);
         remainingIterationsInequality.replaceTerm(i, replacement);
     }
-    MCompare* compare = ConvertLinearInequality(alloc, unrolledHeader, remainingIterationsInequality);
+    MCompare* compare;
+    if (versionedRanges.empty()) {
+        compare = ConvertLinearInequality(alloc, unrolledHeader, remainingIterationsInequality);
+    } else {
+        JitSpew(JitSpew_Unrolling, "Versioning %u bounds checks",
+                unsigned(versionedChecks.count()));
+
+        MDefinition* condition = nullptr;
+        if (!addVersionedRangeTests(remainingIterationsInequality, &condition)) {
+            return false;
+        }
+        MOZ_ASSERT(condition);
+
+        MConstant* zero = MConstant::New(alloc, Int32Value(0));
+        unrolledHeader->insertAtEnd(zero);
+        zero->computeRange(alloc);
+        compare = MCompare::New(alloc, condition, zero, JSOP_GE);
+        unrolledHeader->insertAtEnd(compare);
+        compare->setCompareType(MCompare::Compare_Int32);
+    }
     MTest* unrolledTest = MTest::New(alloc, compare, unrolledBackedge, newPreheader);
     unrolledHeader->end(unrolledTest);
 
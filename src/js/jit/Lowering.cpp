@@ -576,6 +576,23 @@ LIRGenerator::visitApplyArray(MApplyArray* apply)
     assignSafepoint(lir, apply);
 }
 
+void
+LIRGenerator::visitOptimizeSpreadCall(MOptimizeSpreadCall* ins)
+{
+    LOptimizeSpreadCall* lir = new(alloc()) LOptimizeSpreadCall(useBoxAtStart(ins->value()));
+    defineReturn(lir, ins);
+    assignSafepoint(lir, ins);
+}
+
+void
+LIRGenerator::visitOptimizeArrayDestructuring(MOptimizeArrayDestructuring* ins)
+{
+    LOptimizeArrayDestructuring* lir =
+        new(alloc()) LOptimizeArrayDestructuring(useBoxAtStart(ins->value()));
+    defineReturn(lir, ins);
+    assignSafepoint(lir, ins);
+}
+
 void
 LIRGenerator::visitBail(MBail* bail)
 {
@@ -1716,6 +1733,13 @@ LIRGenerator::visitMathFunction(MMathFunction* ins)
         return;
     }
 
+#ifdef JS_CODEGEN_X64
+    if (ins->type() == MIRType::Double && LMathFunctionInlineD::IsSupported(ins->function())) {
+        lowerMathFunctionInlineD(ins);
+        return;
+    }
+#endif
+
     LInstruction* lir;
     if (ins->type() == MIRType::Double) {
         // Note: useRegisterAtStart is safe here, the temp is not a FP register.
@@ -2020,6 +2044,27 @@ LIRGenerator::visitConcat(MConcat* ins)
     assignSafepoint(lir, ins);
 }
 
+void
+LIRGenerator::visitConcatN(MConcatN* ins)
+{
+    MOZ_ASSERT(ins->type() == MIRType::String);
+
+    auto* lir = allocateVariadic<LConcatN>(ins->numOperands(), temp());
+    if (!lir) {
+        abort(AbortReason::Alloc, "OOM: LIRGenerator::visitConcatN");
+        return;
+    }
+
+    for (size_t i = 0; i < ins->numOperands(); i++) {
+        MDefinition* part = ins->getOperand(i);
+        MOZ_ASSERT(part->type() == MIRType::String);
+        lir->setOperand(i, useOrConstantAtStart(part));
+    }
+
+    defineReturn(lir, ins);
+    assignSafepoint(lir, ins);
+}
+
 void
 LIRGenerator::visitCharCodeAt(MCharCodeAt* ins)
 {
@@ -2778,6 +2823,12 @@ LIRGenerator::visitInterruptCheck(MInterruptCheck* ins)
     assignSafepoint(lir, ins);
 }
 
+void
+LIRGenerator::visitIncrementPCCount(MIncrementPCCount* ins)
+{
+    add(new(alloc()) LIncrementPCCount(), ins);
+}
+
 void
 LIRGenerator::visitWasmInterruptCheck(MWasmInterruptCheck* ins)
 {
@@ -2860,7 +2911,7 @@ LIRGenerator::visitTypeBarrier(MTypeBarrier* ins)
     // Handle typebarrier with Value as input.
     if (inputType == MIRType::Value) {
         LDefinition objTemp = hasSpecificObjects ? temp() : LDefinition::BogusTemp();
-        if (ins->canRedefineInput()) {
+        if (ins->canRedefineInput(gen->spectre())) {
             LTypeBarrierV* barrier =
                 new(alloc()) LTypeBarrierV(useBox(ins->input()), tempToUnbox(), objTemp);
             assignSnapshot(barrier, Bailout_TypeBarrierV);
@@ -2889,7 +2940,7 @@ LIRGenerator::visitTypeBarrier(MTypeBarrier* ins)
 
     if (needsObjectBarrier) {
         LDefinition tmp = hasSpecificObjects ? temp() : LDefinition::BogusTemp();
-        if (ins->canRedefineInput()) {
+        if (ins->canRedefineInput(gen->spectre())) {
             LTypeBarrierO* barrier =
                 new(alloc()) LTypeBarrierO(useRegister(ins->input()), tmp);
             assignSnapshot(barrier, Bailout_TypeBarrierO);
@@ -3066,6 +3117,28 @@ LIRGenerator::visitGetNextEntryForIterator(MGetNextEntryForIterator* ins)
     assignSafepoint(lir, ins);
 }
 
+void
+LIRGenerator::visitMapObjectGet(MMapObjectGet* ins)
+{
+    MOZ_ASSERT(ins->map()->type() == MIRType::Object);
+    auto lir = new(alloc()) LMapObjectGet(useRegisterAtStart(ins->map()),
+                                          useBoxAtStart(ins->key()),
+                                          tempFixed(CallTempReg0), tempFixed(CallTempReg1));
+    defineReturn(lir, ins);
+    assignSafepoint(lir, ins);
+}
+
+void
+LIRGenerator::visitMapOrSetHas(MMapOrSetHas* ins)
+{
+    MOZ_ASSERT(ins->object()->type() == MIRType::Object);
+    auto lir = new(alloc()) LMapOrSetHas(useRegisterAtStart(ins->object()),
+                                         useBoxAtStart(ins->key()),
+                                         tempFixed(CallTempReg0), tempFixed(CallTempReg1));
+    defineReturn(lir, ins);
+    assignSafepoint(lir, ins);
+}
+
 void
 LIRGenerator::visitTypedArrayLength(MTypedArrayLength* ins)
 {
@@ -3101,6 +3174,32 @@ LIRGenerator::visitSetDisjointTypedElements(MSetDisjointTypedElements* ins)
     add(lir, ins);
 }
 
+void
+LIRGenerator::visitTypedArrayFill(MTypedArrayFill* ins)
+{
+    MOZ_ASSERT(ins->type() == MIRType::None);
+    MOZ_ASSERT(ins->object()->type() == MIRType::Object);
+
+    auto lir = new(alloc()) LTypedArrayFill(useRegister(ins->object()),
+                                            useRegister(ins->value()),
+                                            useRegister(ins->start()),
+                                            useRegister(ins->end()),
+                                            temp());
+    add(lir, ins);
+}
+
+void
+LIRGenerator::visitTypedArraySearch(MTypedArraySearch* ins)
+{
+    MOZ_ASSERT(ins->object()->type() == MIRType::Object);
+
+    auto lir = new(alloc()) LTypedArraySearch(useRegister(ins->object()),
+                                              useRegister(ins->value()),
+                                              useRegister(ins->start()),
+                                              temp());
+    defineReturn(lir, ins);
+}
+
 void
 LIRGenerator::visitTypedObjectDescr(MTypedObjectDescr* ins)
 {
@@ -3472,12 +3571,12 @@ LIRGenerator::visitStoreElement(MStoreElement* ins)
 }
 
 static bool
-BoundsCheckNeedsSpectreTemp()
+BoundsCheckNeedsSpectreTemp(MIRGenerator* gen)
 {
     // On x86, spectreBoundsCheck32 can emit better code if it has a scratch
     // register and index masking is enabled.
 #ifdef JS_CODEGEN_X86
-    return JitOptions.spectreIndexMasking;
+    return gen->spectre().indexMasking;
 #else
     return false;
 #endif
@@ -3493,7 +3592,7 @@ LIRGenerator::visitStoreElementHole(MStoreElementHole* ins)
     const LUse elements = useRegister(ins->elements());
     const LAllocation index = useRegister(ins->index());
 
-    LDefinition spectreTemp = BoundsCheckNeedsSpectreTemp() ? temp() : LDefinition::BogusTemp();
+    LDefinition spectreTemp = BoundsCheckNeedsSpectreTemp(gen) ? temp() : LDefinition::BogusTemp();
 
     LInstruction* lir;
     switch (ins->value()->type()) {
@@ -3524,7 +3623,7 @@ LIRGenerator::visitFallibleStoreElement(MFallibleStoreElement* ins)
     const LUse elements = useRegister(ins->elements());
     const LAllocation index = useRegister(ins->index());
 
-    LDefinition spectreTemp = BoundsCheckNeedsSpectreTemp() ? temp() : LDefinition::BogusTemp();
+    LDefinition spectreTemp = BoundsCheckNeedsSpectreTemp(gen) ? temp() : LDefinition::BogusTemp();
 
     LInstruction* lir;
     switch (ins->value()->type()) {
@@ -3581,7 +3680,7 @@ LIRGenerator::visitConvertUnboxedObjectToNative(MConvertUnboxedObjectToNative* i
 {
     MOZ_ASSERT(ins->object()->type() == MIRType::Object);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (gen->spectre().objectMitigationsMisc) {
         auto* lir = new(alloc()) LConvertUnboxedObjectToNative(useRegisterAtStart(ins->object()),
                                                                temp());
         defineReuseInput(lir, ins, 0);
@@ -3634,7 +3733,7 @@ LIRGenerator::visitArrayPush(MArrayPush* ins)
 
     LUse object = useRegister(ins->object());
 
-    LDefinition spectreTemp = BoundsCheckNeedsSpectreTemp() ? temp() : LDefinition::BogusTemp();
+    LDefinition spectreTemp = BoundsCheckNeedsSpectreTemp(gen) ? temp() : LDefinition::BogusTemp();
 
     switch (ins->value()->type()) {
       case MIRType::Value:
@@ -3674,6 +3773,19 @@ LIRGenerator::visitArraySlice(MArraySlice* ins)
     assignSafepoint(lir, ins);
 }
 
+void
+LIRGenerator::visitArraySearch(MArraySearch* ins)
+{
+    MOZ_ASSERT(ins->array()->type() == MIRType::Object);
+
+    auto lir = new(alloc()) LArraySearch(useRegister(ins->array()),
+                                         useRegister(ins->value()),
+                                         useRegister(ins->start()),
+                                         useRegister(ins->end()),
+                                         temp());
+    defineReturn(lir, ins);
+}
+
 void
 LIRGenerator::visitArrayJoin(MArrayJoin* ins)
 {
@@ -3847,6 +3959,62 @@ LIRGenerator::visitStoreUnboxedScalar(MStoreUnboxedScalar* ins)
     }
 }
 
+void
+LIRGenerator::visitLoadDataViewElement(MLoadDataViewElement* ins)
+{
+    MOZ_ASSERT(ins->elements()->type() == MIRType::Elements);
+    MOZ_ASSERT(ins->index()->type() == MIRType::Int32);
+    MOZ_ASSERT(IsNumberType(ins->type()));
+
+    const LUse elements = useRegister(ins->elements());
+    const LAllocation index = useRegisterOrConstant(ins->index());
+
+    // Values wider than a byte may be copied a byte at a time through the temp,
+    // which has to be a byte register on x86. The temp is also used to convert
+    // Uint32 values to double.
+    LDefinition tempDef = LDefinition::BogusTemp();
+    if (Scalar::byteSize(ins->storageType()) > 1) {
+        tempDef = tempByteOpRegister();
+    }
+
+    LLoadDataViewElement* lir = new(alloc()) LLoadDataViewElement(elements, index, tempDef);
+    if (ins->fallible()) {
+        assignSnapshot(lir, Bailout_Overflow);
+    }
+    define(lir, ins);
+}
+
+void
+LIRGenerator::visitStoreDataViewElement(MStoreDataViewElement* ins)
+{
+    MOZ_ASSERT(ins->elements()->type() == MIRType::Elements);
+    MOZ_ASSERT(ins->index()->type() == MIRType::Int32);
+
+    if (ins->isFloatWrite()) {
+        MOZ_ASSERT_IF(ins->writeType() == Scalar::Float32, ins->value()->type() == MIRType::Float32);
+        MOZ_ASSERT_IF(ins->writeType() == Scalar::Float64, ins->value()->type() == MIRType::Double);
+    } else {
+        MOZ_ASSERT(ins->value()->type() == MIRType::Int32);
+    }
+
+    LUse elements = useRegister(ins->elements());
+    LAllocation index = useRegisterOrConstant(ins->index());
+
+    // Byte values are stored directly, so for byte writes the value has to be
+    // in a byte register on x86. Wider values are copied a byte at a time
+    // through the temp instead.
+    LAllocation value;
+    LDefinition tempDef = LDefinition::BogusTemp();
+    if (ins->isByteWrite()) {
+        value = useByteOpRegisterOrNonDoubleConstant(ins->value());
+    } else {
+        value = useRegisterOrNonDoubleConstant(ins->value());
+        tempDef = tempByteOpRegister();
+    }
+
+    add(new(alloc()) LStoreDataViewElement(elements, index, value, tempDef), ins);
+}
+
 void
 LIRGenerator::visitStoreTypedArrayElementHole(MStoreTypedArrayElementHole* ins)
 {
@@ -3872,7 +4040,7 @@ LIRGenerator::visitStoreTypedArrayElementHole(MStoreTypedArrayElementHole* ins)
         value = useRegisterOrNonDoubleConstant(ins->value());
     }
 
-    LDefinition spectreTemp = BoundsCheckNeedsSpectreTemp() ? temp() : LDefinition::BogusTemp();
+    LDefinition spectreTemp = BoundsCheckNeedsSpectreTemp(gen) ? temp() : LDefinition::BogusTemp();
     auto* lir =
         new(alloc()) LStoreTypedArrayElementHole(elements, length, index, value, spectreTemp);
     add(lir, ins);
@@ -4089,7 +4257,7 @@ LIRGenerator::visitGuardShape(MGuardShape* ins)
 {
     MOZ_ASSERT(ins->object()->type() == MIRType::Object);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (gen->spectre().objectMitigationsMisc) {
         auto* lir = new(alloc()) LGuardShape(useRegisterAtStart(ins->object()), temp());
         assignSnapshot(lir, ins->bailoutKind());
         defineReuseInput(lir, ins, 0);
@@ -4107,7 +4275,7 @@ LIRGenerator::visitGuardObjectGroup(MGuardObjectGroup* ins)
 {
     MOZ_ASSERT(ins->object()->type() == MIRType::Object);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (gen->spectre().objectMitigationsMisc) {
         auto* lir = new(alloc()) LGuardObjectGroup(useRegisterAtStart(ins->object()), temp());
         assignSnapshot(lir, ins->bailoutKind());
         defineReuseInput(lir, ins, 0);
@@ -4161,7 +4329,7 @@ LIRGenerator::visitGuardReceiverPolymorphic(MGuardReceiverPolymorphic* ins)
     MOZ_ASSERT(ins->object()->type() == MIRType::Object);
     MOZ_ASSERT(ins->type() == MIRType::Object);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (gen->spectre().objectMitigationsMisc) {
         auto* lir = new(alloc()) LGuardReceiverPolymorphic(useRegisterAtStart(ins->object()),
                                                            temp(), temp());
         assignSnapshot(lir, Bailout_ShapeGuard);
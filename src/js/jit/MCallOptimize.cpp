@@ -9,6 +9,7 @@
 #include "jsmath.h"
 
 #include "builtin/AtomicsObject.h"
+#include "builtin/DataViewObject.h"
 #include "builtin/intl/Collator.h"
 #include "builtin/intl/DateTimeFormat.h"
 #include "builtin/intl/NumberFormat.h"
@@ -136,6 +137,40 @@ IonBuilder::inlineNativeCall(CallInfo& callInfo, JSFunction* target)
       case InlinableNative::Boolean:
         return inlineBoolean(callInfo);
 
+      // DataView natives.
+      case InlinableNative::DataViewGetInt8:
+        return inlineDataViewGet(callInfo, Scalar::Int8);
+      case InlinableNative::DataViewGetUint8:
+        return inlineDataViewGet(callInfo, Scalar::Uint8);
+      case InlinableNative::DataViewGetInt16:
+        return inlineDataViewGet(callInfo, Scalar::Int16);
+      case InlinableNative::DataViewGetUint16:
+        return inlineDataViewGet(callInfo, Scalar::Uint16);
+      case InlinableNative::DataViewGetInt32:
+        return inlineDataViewGet(callInfo, Scalar::Int32);
+      case InlinableNative::DataViewGetUint32:
+        return inlineDataViewGet(callInfo, Scalar::Uint32);
+      case InlinableNative::DataViewGetFloat32:
+        return inlineDataViewGet(callInfo, Scalar::Float32);
+      case InlinableNative::DataViewGetFloat64:
+        return inlineDataViewGet(callInfo, Scalar::Float64);
+      case InlinableNative::DataViewSetInt8:
+        return inlineDataViewSet(callInfo, Scalar::Int8);
+      case InlinableNative::DataViewSetUint8:
+        return inlineDataViewSet(callInfo, Scalar::Uint8);
+      case InlinableNative::DataViewSetInt16:
+        return inlineDataViewSet(callInfo, Scalar::Int16);
+      case InlinableNative::DataViewSetUint16:
+        return inlineDataViewSet(callInfo, Scalar::Uint16);
+      case InlinableNative::DataViewSetInt32:
+        return inlineDataViewSet(callInfo, Scalar::Int32);
+      case InlinableNative::DataViewSetUint32:
+        return inlineDataViewSet(callInfo, Scalar::Uint32);
+      case InlinableNative::DataViewSetFloat32:
+        return inlineDataViewSet(callInfo, Scalar::Float32);
+      case InlinableNative::DataViewSetFloat64:
+        return inlineDataViewSet(callInfo, Scalar::Float64);
+
       // Intl natives.
       case InlinableNative::IntlGuardToCollator:
         return inlineGuardToClass(callInfo, &CollatorObject::class_);
@@ -148,6 +183,12 @@ IonBuilder::inlineNativeCall(CallInfo& callInfo, JSFunction* target)
       case InlinableNative::IntlGuardToRelativeTimeFormat:
         return inlineGuardToClass(callInfo, &RelativeTimeFormatObject::class_);
 
+      // Map natives.
+      case InlinableNative::MapGet:
+        return inlineMapObjectGet(callInfo);
+      case InlinableNative::MapHas:
+        return inlineMapOrSetHas(callInfo, MMapOrSetHas::Map);
+
       // Math natives.
       case InlinableNative::MathAbs:
         return inlineMathAbs(callInfo);
@@ -224,6 +265,10 @@ IonBuilder::inlineNativeCall(CallInfo& callInfo, JSFunction* target)
       case InlinableNative::ReflectGetPrototypeOf:
         return inlineReflectGetPrototypeOf(callInfo);
 
+      // Set natives.
+      case InlinableNative::SetHas:
+        return inlineMapOrSetHas(callInfo, MMapOrSetHas::Set);
+
       // RegExp natives.
       case InlinableNative::RegExpMatcher:
         return inlineRegExpMatcher(callInfo);
@@ -329,6 +374,12 @@ IonBuilder::inlineNativeCall(CallInfo& callInfo, JSFunction* target)
         return inlineFinishBoundFunctionInit(callInfo);
       case InlinableNative::IntrinsicIsPackedArray:
         return inlineIsPackedArray(callInfo);
+      case InlinableNative::IntrinsicArrayNativeIndexOf:
+        return inlineArrayNativeSearch(callInfo, MArraySearch::IndexOf);
+      case InlinableNative::IntrinsicArrayNativeLastIndexOf:
+        return inlineArrayNativeSearch(callInfo, MArraySearch::LastIndexOf);
+      case InlinableNative::IntrinsicArrayNativeIncludes:
+        return inlineArrayNativeSearch(callInfo, MArraySearch::Includes);
 
       // Map intrinsics.
       case InlinableNative::IntrinsicGuardToMapObject:
@@ -367,6 +418,14 @@ IonBuilder::inlineNativeCall(CallInfo& callInfo, JSFunction* target)
         return inlineTypedArrayLength(callInfo);
       case InlinableNative::IntrinsicSetDisjointTypedElements:
         return inlineSetDisjointTypedElements(callInfo);
+      case InlinableNative::IntrinsicTypedArrayNativeFill:
+        return inlineTypedArrayNativeFill(callInfo);
+      case InlinableNative::IntrinsicTypedArrayNativeIndexOf:
+        return inlineTypedArrayNativeSearch(callInfo, MTypedArraySearch::IndexOf);
+      case InlinableNative::IntrinsicTypedArrayNativeLastIndexOf:
+        return inlineTypedArrayNativeSearch(callInfo, MTypedArraySearch::LastIndexOf);
+      case InlinableNative::IntrinsicTypedArrayNativeIncludes:
+        return inlineTypedArrayNativeSearch(callInfo, MTypedArraySearch::Includes);
 
       // TypedObject intrinsics.
       case InlinableNative::IntrinsicObjectIsTypedObject:
@@ -1985,6 +2044,44 @@ IonBuilder::inlineFinishBoundFunctionInit(CallInfo& callInfo)
     return InliningStatus_Inlined;
 }
 
+IonBuilder::InliningResult
+IonBuilder::inlineArrayNativeSearch(CallInfo& callInfo, MArraySearch::Mode mode)
+{
+    MOZ_ASSERT(!callInfo.constructing());
+    MOZ_ASSERT(callInfo.argc() == 4);
+
+    MIRType returnType = mode == MArraySearch::Includes ? MIRType::Boolean : MIRType::Int32;
+    if (getInlineReturnType() != returnType) {
+        return InliningStatus_NotInlined;
+    }
+
+    // Only int32 and object search values are handled inline, other values
+    // use the native.
+    MDefinition* array = callInfo.getArg(0);
+    MDefinition* value = callInfo.getArg(1);
+    MDefinition* start = callInfo.getArg(2);
+    MDefinition* end = callInfo.getArg(3);
+    if (array->type() != MIRType::Object ||
+        (value->type() != MIRType::Int32 && value->type() != MIRType::Object) ||
+        start->type() != MIRType::Int32 ||
+        end->type() != MIRType::Int32)
+    {
+        return InliningStatus_NotInlined;
+    }
+
+    TemporaryTypeSet* arrayTypes = array->resultTypeSet();
+    if (!arrayTypes || arrayTypes->getKnownClass(constraints()) != &ArrayObject::class_) {
+        return InliningStatus_NotInlined;
+    }
+
+    auto* search = MArraySearch::New(alloc(), array, value, start, end, mode);
+    current->add(search);
+    current->push(search);
+
+    callInfo.setImplicitlyUsedUnchecked();
+    return InliningStatus_Inlined;
+}
+
 IonBuilder::InliningResult
 IonBuilder::inlineIsPackedArray(CallInfo& callInfo)
 {
@@ -2899,6 +2996,65 @@ IonBuilder::inlineGetNextEntryForIterator(CallInfo& callInfo, MGetNextEntryForIt
     return InliningStatus_Inlined;
 }
 
+static bool
+HasKnownClass(CompilerConstraintList* constraints, MDefinition* def, const Class* clasp)
+{
+    if (def->type() != MIRType::Object) {
+        return false;
+    }
+
+    TemporaryTypeSet* types = def->resultTypeSet();
+    return types && types->getKnownClass(constraints) == clasp;
+}
+
+IonBuilder::InliningResult
+IonBuilder::inlineMapObjectGet(CallInfo& callInfo)
+{
+    if (callInfo.argc() != 1 || callInfo.constructing()) {
+        return InliningStatus_NotInlined;
+    }
+
+    if (!HasKnownClass(constraints(), callInfo.thisArg(), &MapObject::class_)) {
+        return InliningStatus_NotInlined;
+    }
+
+    callInfo.setImplicitlyUsedUnchecked();
+
+    MMapObjectGet* ins = MMapObjectGet::New(alloc(), callInfo.thisArg(), callInfo.getArg(0));
+    current->add(ins);
+    current->push(ins);
+
+    MOZ_TRY(resumeAfter(ins));
+    MOZ_TRY(pushTypeBarrier(ins, getInlineReturnTypeSet(), BarrierKind::TypeSet));
+    return InliningStatus_Inlined;
+}
+
+IonBuilder::InliningResult
+IonBuilder::inlineMapOrSetHas(CallInfo& callInfo, MMapOrSetHas::Mode mode)
+{
+    if (callInfo.argc() != 1 || callInfo.constructing()) {
+        return InliningStatus_NotInlined;
+    }
+
+    if (getInlineReturnType() != MIRType::Boolean) {
+        return InliningStatus_NotInlined;
+    }
+
+    const Class* clasp = mode == MMapOrSetHas::Map ? &MapObject::class_ : &SetObject::class_;
+    if (!HasKnownClass(constraints(), callInfo.thisArg(), clasp)) {
+        return InliningStatus_NotInlined;
+    }
+
+    callInfo.setImplicitlyUsedUnchecked();
+
+    MMapOrSetHas* ins = MMapOrSetHas::New(alloc(), callInfo.thisArg(), callInfo.getArg(0), mode);
+    current->add(ins);
+    current->push(ins);
+
+    MOZ_TRY(resumeAfter(ins));
+    return InliningStatus_Inlined;
+}
+
 static bool
 IsArrayBufferObject(CompilerConstraintList* constraints, MDefinition* def)
 {
@@ -3209,6 +3365,78 @@ IonBuilder::inlineSetDisjointTypedElements(CallInfo& callInfo)
     return InliningStatus_Inlined;
 }
 
+IonBuilder::InliningResult
+IonBuilder::inlineTypedArrayNativeFill(CallInfo& callInfo)
+{
+    MOZ_ASSERT(!callInfo.constructing());
+    MOZ_ASSERT(callInfo.argc() == 4);
+
+    if (getInlineReturnType() != MIRType::Undefined) {
+        return InliningStatus_NotInlined;
+    }
+
+    // Only int32 values are handled inline, other numbers use the native.
+    MDefinition* obj = callInfo.getArg(0);
+    MDefinition* value = callInfo.getArg(1);
+    MDefinition* start = callInfo.getArg(2);
+    MDefinition* end = callInfo.getArg(3);
+    if (obj->type() != MIRType::Object ||
+        value->type() != MIRType::Int32 ||
+        start->type() != MIRType::Int32 ||
+        end->type() != MIRType::Int32)
+    {
+        return InliningStatus_NotInlined;
+    }
+
+    if (!IsTypedArrayObject(constraints(), obj)) {
+        return InliningStatus_NotInlined;
+    }
+
+    auto* fill = MTypedArrayFill::New(alloc(), obj, value, start, end);
+    current->add(fill);
+
+    pushConstant(UndefinedValue());
+
+    MOZ_TRY(resumeAfter(fill));
+    callInfo.setImplicitlyUsedUnchecked();
+    return InliningStatus_Inlined;
+}
+
+IonBuilder::InliningResult
+IonBuilder::inlineTypedArrayNativeSearch(CallInfo& callInfo, MTypedArraySearch::Mode mode)
+{
+    MOZ_ASSERT(!callInfo.constructing());
+    MOZ_ASSERT(callInfo.argc() == 3);
+
+    MIRType returnType = mode == MTypedArraySearch::Includes ? MIRType::Boolean : MIRType::Int32;
+    if (getInlineReturnType() != returnType) {
+        return InliningStatus_NotInlined;
+    }
+
+    // Only int32 search values are handled inline, other values use the
+    // native.
+    MDefinition* obj = callInfo.getArg(0);
+    MDefinition* value = callInfo.getArg(1);
+    MDefinition* start = callInfo.getArg(2);
+    if (obj->type() != MIRType::Object ||
+        value->type() != MIRType::Int32 ||
+        start->type() != MIRType::Int32)
+    {
+        return InliningStatus_NotInlined;
+    }
+
+    if (!IsTypedArrayObject(constraints(), obj)) {
+        return InliningStatus_NotInlined;
+    }
+
+    auto* search = MTypedArraySearch::New(alloc(), obj, value, start, mode);
+    current->add(search);
+    current->push(search);
+
+    callInfo.setImplicitlyUsedUnchecked();
+    return InliningStatus_Inlined;
+}
+
 IonBuilder::InliningResult
 IonBuilder::inlineObjectIsTypeDescr(CallInfo& callInfo)
 {
@@ -3986,6 +4214,136 @@ IonBuilder::atomicsCheckBounds(CallInfo& callInfo, MInstruction** elements, MDef
     addTypedArrayLengthAndData(obj, DoBoundsCheck, index, &length, elements);
 }
 
+bool
+IonBuilder::dataViewMeetsPreconditions(CallInfo& callInfo, uint32_t littleEndianArg,
+                                       bool* littleEndian)
+{
+    if (!HasKnownClass(constraints(), callInfo.thisArg(), &DataViewObject::class_)) {
+        return false;
+    }
+
+    // ToIndex() of anything but an int32 can have side effects or throw, and
+    // negative int32 offsets fail the (unsigned) bounds check below.
+    if (callInfo.getArg(0)->type() != MIRType::Int32) {
+        return false;
+    }
+
+    // The byte order determines the code we generate, so it has to be known.
+    *littleEndian = false;
+    if (callInfo.argc() > littleEndianArg) {
+        MDefinition* arg = callInfo.getArg(littleEndianArg);
+        if (!arg->isConstant() || !arg->toConstant()->valueToBoolean(littleEndian)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
+void
+IonBuilder::dataViewCheckBounds(CallInfo& callInfo, Scalar::Type type, MInstruction** elements,
+                                MDefinition** index)
+{
+    // DataViews have the same length and data slots as typed arrays. Detaching
+    // the buffer sets the length to zero, so the bounds check covers that too.
+    MDefinition* obj = callInfo.thisArg();
+    MInstruction* length = MTypedArrayLength::New(alloc(), obj);
+    current->add(length);
+
+    // The access has to fit in the view, i.e. |byteOffset + size <= length|.
+    // Check the offset against |max(length - (size - 1), 0)| rather than using
+    // MBoundsCheck's maximum, so the Spectre index masking uses the same limit.
+    int32_t size = int32_t(Scalar::byteSize(type));
+    MDefinition* limit = length;
+    if (size > 1) {
+        MConstant* adjust = constant(Int32Value(size - 1));
+        MSub* sub = MSub::New(alloc(), length, adjust, MIRType::Int32);
+        current->add(sub);
+
+        MMinMax* clamped = MMinMax::New(alloc(), sub, constant(Int32Value(0)), MIRType::Int32,
+                                        true);
+        current->add(clamped);
+        limit = clamped;
+    }
+
+    *index = addBoundsCheck(callInfo.getArg(0), limit);
+
+    *elements = MTypedArrayElements::New(alloc(), obj);
+    current->add(*elements);
+}
+
+IonBuilder::InliningResult
+IonBuilder::inlineDataViewGet(CallInfo& callInfo, Scalar::Type type)
+{
+    if (callInfo.argc() < 1 || callInfo.argc() > 2 || callInfo.constructing()) {
+        trackOptimizationOutcome(TrackedOutcome::CantInlineNativeBadForm);
+        return InliningStatus_NotInlined;
+    }
+
+    // Uint32 values which don't fit in an int32 bail out unless the result is
+    // known to be a double. Float32 values are converted to double when used.
+    MIRType returnType = getInlineReturnType();
+    MIRType knownType = MIRTypeForTypedArrayRead(type, returnType == MIRType::Double);
+    if (knownType == MIRType::Float32 ? returnType != MIRType::Double : knownType != returnType) {
+        return InliningStatus_NotInlined;
+    }
+
+    bool littleEndian;
+    if (!dataViewMeetsPreconditions(callInfo, 1, &littleEndian)) {
+        return InliningStatus_NotInlined;
+    }
+
+    callInfo.setImplicitlyUsedUnchecked();
+
+    MInstruction* elements;
+    MDefinition* index;
+    dataViewCheckBounds(callInfo, type, &elements, &index);
+
+    MLoadDataViewElement* load =
+        MLoadDataViewElement::New(alloc(), elements, index, type, littleEndian);
+    load->setResultType(knownType);
+    current->add(load);
+    current->push(load);
+
+    return InliningStatus_Inlined;
+}
+
+IonBuilder::InliningResult
+IonBuilder::inlineDataViewSet(CallInfo& callInfo, Scalar::Type type)
+{
+    if (callInfo.argc() < 2 || callInfo.argc() > 3 || callInfo.constructing()) {
+        trackOptimizationOutcome(TrackedOutcome::CantInlineNativeBadForm);
+        return InliningStatus_NotInlined;
+    }
+
+    // ToNumber() of anything else can have side effects, which have to happen
+    // before the bounds check.
+    MDefinition* value = callInfo.getArg(1);
+    if (!IsNumberType(value->type())) {
+        trackOptimizationOutcome(TrackedOutcome::CantInlineNativeBadType);
+        return InliningStatus_NotInlined;
+    }
+
+    bool littleEndian;
+    if (!dataViewMeetsPreconditions(callInfo, 2, &littleEndian)) {
+        return InliningStatus_NotInlined;
+    }
+
+    callInfo.setImplicitlyUsedUnchecked();
+
+    MInstruction* elements;
+    MDefinition* index;
+    dataViewCheckBounds(callInfo, type, &elements, &index);
+
+    MStoreDataViewElement* store =
+        MStoreDataViewElement::New(alloc(), elements, index, value, type, littleEndian);
+    current->add(store);
+    pushConstant(UndefinedValue());
+
+    MOZ_TRY(resumeAfter(store));
+    return InliningStatus_Inlined;
+}
+
 IonBuilder::InliningResult
 IonBuilder::inlineIsConstructing(CallInfo& callInfo)
 {
@@ -4110,6 +4468,7 @@ IonBuilder::inlineWasmCall(CallInfo& callInfo, JSFunction* target)
             conversion = MToDouble::New(alloc(), arg);
             break;
           case wasm::ValType::I64:
+          case wasm::ValType::V128:
           case wasm::ValType::AnyRef:
           case wasm::ValType::Ref:
             MOZ_CRASH("impossible per above check");
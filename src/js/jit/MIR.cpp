@@ -1388,6 +1388,19 @@ MWasmFloatConstant::congruentTo(const MDefinition* ins) const
            u.bits_ == ins->toWasmFloatConstant()->u.bits_;
 }
 
+HashNumber
+MWasmSimd128Constant::valueHash() const
+{
+    return mozilla::AddToHash(MNullaryInstruction::valueHash(), SimdConstant::hash(value_));
+}
+
+bool
+MWasmSimd128Constant::congruentTo(const MDefinition* ins) const
+{
+    return ins->isWasmSimd128Constant() &&
+           value_ == ins->toWasmSimd128Constant()->value();
+}
+
 #ifdef JS_JITSPEW
 void
 MControlInstruction::printOpcode(GenericPrinter& out) const
@@ -1824,7 +1837,47 @@ MConcat::foldsTo(TempAllocator& alloc)
         return lhs();
     }
 
-    return this;
+    // Merge this concatenation with the ones which only feed into it.
+    if (lhs()->type() != MIRType::String || rhs()->type() != MIRType::String) {
+        return this;
+    }
+
+    MDefinitionVector parts(alloc);
+    for (size_t i = 0; i < numOperands(); i++) {
+        MDefinition* operand = getOperand(i);
+        if ((operand->isConcat() || operand->isConcatN()) && operand->hasOneUse()) {
+            for (size_t j = 0; j < operand->numOperands(); j++) {
+                if (!parts.append(operand->getOperand(j))) {
+                    return nullptr;
+                }
+            }
+        } else if (!parts.append(operand)) {
+            return nullptr;
+        }
+    }
+
+    if (parts.length() == 2 || parts.length() > MConcatN::MaxParts) {
+        return this;
+    }
+
+    return MConcatN::New(alloc, parts);
+}
+
+MConcatN*
+MConcatN::New(TempAllocator& alloc, const MDefinitionVector& parts)
+{
+    MOZ_ASSERT(parts.length() > 2 && parts.length() <= MaxParts);
+
+    MConcatN* concat = new(alloc) MConcatN;
+    if (!concat->init(alloc, parts.length())) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < parts.length(); i++) {
+        MOZ_ASSERT(parts[i]->type() == MIRType::String);
+        concat->initOperand(i, parts[i]);
+    }
+    return concat;
 }
 
 static bool
@@ -2013,7 +2066,7 @@ MTypeBarrier::foldsTo(TempAllocator& alloc)
 }
 
 bool
-MTypeBarrier::canRedefineInput()
+MTypeBarrier::canRedefineInput(const SpectreMitigations& spectre)
 {
     // LTypeBarrier does not need its own def usually, because we can use the
     // input's allocation (LIRGenerator::redefineInput). However, if Spectre
@@ -2021,7 +2074,7 @@ MTypeBarrier::canRedefineInput()
     // speculatively executed paths, so LTypeBarrier needs to have its own def
     // then to guarantee all uses will see this potentially-zeroed value.
 
-    if (!JitOptions.spectreObjectMitigationsBarriers) {
+    if (!spectre.objectMitigationsBarriers) {
         return true;
     }
 
@@ -5160,7 +5213,8 @@ MNewArray::MNewArray(TempAllocator& alloc, CompilerConstraintList* constraints,
     initialHeap_(initialHeap),
     convertDoubleElements_(false),
     pc_(pc),
-    vmCall_(vmCall)
+    vmCall_(vmCall),
+    allocSite_(nullptr)
 {
     setResultType(MIRType::Object);
     if (templateObject()) {
@@ -5439,11 +5493,13 @@ MStoreSlot::printOpcode(GenericPrinter& out) const
 MDefinition*
 MFunctionEnvironment::foldsTo(TempAllocator& alloc)
 {
-    if (!input()->isLambda()) {
-        return this;
+    if (input()->isLambda()) {
+        return input()->toLambda()->environmentChain();
     }
-
-    return input()->toLambda()->environmentChain();
+    if (input()->isLambdaArrow()) {
+        return input()->toLambdaArrow()->environmentChain();
+    }
+    return this;
 }
 
 static bool
@@ -5575,6 +5631,53 @@ MLoadUnboxedObjectOrNull::foldsTo(TempAllocator& alloc)
     return this;
 }
 
+// Whether |store| can change the shape or group of an object. The stores
+// below are in the ObjectFields alias category because they write to an
+// object's elements header or typed object data, but they never change an
+// object's shape or group and never call into the VM in a way which could
+// run script. Guards on shapes and groups do not depend on these stores, so
+// they can be coalesced by GVN and hoisted by LICM across them.
+static bool
+StoreMayChangeShapeOrGroup(const MDefinition* store)
+{
+    switch (store->op()) {
+      case MDefinition::Opcode::SetInitializedLength:
+      case MDefinition::Opcode::SetArrayLength:
+      case MDefinition::Opcode::MaybeCopyElementsForWrite:
+      case MDefinition::Opcode::SetTypedObjectOffset:
+        return false;
+      default:
+        return true;
+    }
+}
+
+MDefinition::AliasType
+MGuardShape::mightAlias(const MDefinition* store) const
+{
+    if (!StoreMayChangeShapeOrGroup(store)) {
+        return AliasType::NoAlias;
+    }
+    return AliasType::MayAlias;
+}
+
+MDefinition::AliasType
+MGuardObjectGroup::mightAlias(const MDefinition* store) const
+{
+    if (!StoreMayChangeShapeOrGroup(store)) {
+        return AliasType::NoAlias;
+    }
+    return AliasType::MayAlias;
+}
+
+MDefinition::AliasType
+MGuardReceiverPolymorphic::mightAlias(const MDefinition* store) const
+{
+    if (!StoreMayChangeShapeOrGroup(store)) {
+        return AliasType::NoAlias;
+    }
+    return AliasType::MayAlias;
+}
+
 bool
 MGuardReceiverPolymorphic::congruentTo(const MDefinition* ins) const
 {
@@ -2271,6 +2271,9 @@ class MNewArray
 
     bool vmCall_;
 
+    // Site that nursery allocations are attributed to, if any.
+    gc::AllocSite* allocSite_;
+
     MNewArray(TempAllocator& alloc, CompilerConstraintList* constraints, uint32_t length,
               MConstant* templateConst, gc::InitialHeap initialHeap, jsbytecode* pc,
               bool vmCall = false);
@@ -2307,6 +2310,13 @@ class MNewArray
         return vmCall_;
     }
 
+    gc::AllocSite* allocSite() const {
+        return allocSite_;
+    }
+    void setAllocSite(gc::AllocSite* site) {
+        allocSite_ = site;
+    }
+
     bool convertDoubleElements() const {
         return convertDoubleElements_;
     }
@@ -2507,12 +2517,16 @@ class MNewObject
     Mode mode_;
     bool vmCall_;
 
+    // Site that nursery allocations are attributed to, if any.
+    gc::AllocSite* allocSite_;
+
     MNewObject(TempAllocator& alloc, CompilerConstraintList* constraints, MConstant* templateConst,
                gc::InitialHeap initialHeap, Mode mode, bool vmCall = false)
       : MUnaryInstruction(classOpcode, templateConst),
         initialHeap_(initialHeap),
         mode_(mode),
-        vmCall_(vmCall)
+        vmCall_(vmCall),
+        allocSite_(nullptr)
     {
         MOZ_ASSERT_IF(mode != ObjectLiteral, templateObject());
         setResultType(MIRType::Object);
@@ -2558,6 +2572,13 @@ class MNewObject
         return vmCall_;
     }
 
+    gc::AllocSite* allocSite() const {
+        return allocSite_;
+    }
+    void setAllocSite(gc::AllocSite* site) {
+        allocSite_ = site;
+    }
+
     MOZ_MUST_USE bool writeRecoverData(CompactBufferWriter& writer) const override;
     bool canRecoverOnBailout() const override {
         // The template object can safely be used in the recover instruction
@@ -3321,6 +3342,57 @@ class MApplyArray
     }
 };
 
+// Whether a spread call can pass its operand straight to MApplyArray, without
+// spreading it into an intermediate array. See js::OptimizeSpreadCall.
+class MOptimizeSpreadCall
+  : public MUnaryInstruction,
+    public BoxInputsPolicy::Data
+{
+    explicit MOptimizeSpreadCall(MDefinition* value)
+      : MUnaryInstruction(classOpcode, value)
+    {
+        setResultType(MIRType::Boolean);
+    }
+
+  public:
+    INSTRUCTION_HEADER(OptimizeSpreadCall)
+    TRIVIAL_NEW_WRAPPERS
+    NAMED_OPERANDS((0, value))
+
+    bool possiblyCalls() const override {
+        return true;
+    }
+};
+
+// Whether array destructuring can read the first |count| elements of its
+// operand directly. See js::OptimizeArrayDestructuring.
+class MOptimizeArrayDestructuring
+  : public MUnaryInstruction,
+    public BoxInputsPolicy::Data
+{
+    uint32_t count_;
+
+    MOptimizeArrayDestructuring(MDefinition* value, uint32_t count)
+      : MUnaryInstruction(classOpcode, value),
+        count_(count)
+    {
+        setResultType(MIRType::Boolean);
+    }
+
+  public:
+    INSTRUCTION_HEADER(OptimizeArrayDestructuring)
+    TRIVIAL_NEW_WRAPPERS
+    NAMED_OPERANDS((0, value))
+
+    uint32_t count() const {
+        return count_;
+    }
+
+    bool possiblyCalls() const override {
+        return true;
+    }
+};
+
 class MBail : public MNullaryInstruction
 {
   protected:
@@ -5563,6 +5635,8 @@ class MClz
     MDefinition* foldsTo(TempAllocator& alloc) override;
     void computeRange(TempAllocator& alloc) override;
     void collectRangeInfoPreTrunc() override;
+
+    ALLOW_CLONE(MClz)
 };
 
 class MCtz
@@ -5602,6 +5676,8 @@ class MCtz
     MDefinition* foldsTo(TempAllocator& alloc) override;
     void computeRange(TempAllocator& alloc) override;
     void collectRangeInfoPreTrunc() override;
+
+    ALLOW_CLONE(MCtz)
 };
 
 class MPopcnt
@@ -5633,6 +5709,8 @@ class MPopcnt
 
     MDefinition* foldsTo(TempAllocator& alloc) override;
     void computeRange(TempAllocator& alloc) override;
+
+    ALLOW_CLONE(MPopcnt)
 };
 
 // Inline implementation of Math.sqrt().
@@ -6548,6 +6626,50 @@ class MConcat
     ALLOW_CLONE(MConcat)
 };
 
+// Concatenation of three or more strings, formed by merging chains of MConcat
+// such as those of template literals. Builds the result in one step, without
+// the intermediate ropes of pairwise concatenation.
+class MConcatN
+  : public MVariadicInstruction,
+    public NoTypePolicy::Data
+{
+    MConcatN()
+      : MVariadicInstruction(classOpcode)
+    {
+        setMovable();
+        setResultType(MIRType::String);
+    }
+
+  public:
+    INSTRUCTION_HEADER(ConcatN)
+    static MConcatN* New(TempAllocator& alloc, const MDefinitionVector& parts);
+
+    // Upper bound on the number of parts, as they are all passed on the stack.
+    static const size_t MaxParts = 16;
+
+    bool congruentTo(const MDefinition* ins) const override {
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const override {
+        return AliasSet::None();
+    }
+    bool possiblyCalls() const override {
+        return true;
+    }
+
+    MOZ_MUST_USE bool writeRecoverData(CompactBufferWriter& writer) const override;
+    bool canRecoverOnBailout() const override {
+        return true;
+    }
+
+    bool canClone() const override {
+        return true;
+    }
+    MInstruction* clone(TempAllocator& alloc, const MDefinitionVector& inputs) const override {
+        return MConcatN::New(alloc, inputs);
+    }
+};
+
 class MCharCodeAt
   : public MBinaryInstruction,
     public MixPolicy<StringPolicy<0>, UnboxedInt32Policy<1> >::Data
@@ -7269,6 +7391,32 @@ class MInterruptCheck : public MNullaryInstruction
     }
 };
 
+// Increment the execution count of a jump target, for code coverage.
+class MIncrementPCCount : public MNullaryInstruction
+{
+    uint64_t* counter_;
+
+    explicit MIncrementPCCount(uint64_t* counter)
+      : MNullaryInstruction(classOpcode),
+        counter_(counter)
+    {
+        setGuard();
+    }
+
+  public:
+    INSTRUCTION_HEADER(IncrementPCCount)
+    TRIVIAL_NEW_WRAPPERS
+
+    uint64_t* counter() const {
+        return counter_;
+    }
+
+    // The counter is not read by any other MIR instruction.
+    AliasSet getAliasSet() const override {
+        return AliasSet::None();
+    }
+};
+
 // Check whether we need to fire the interrupt handler (in wasm code).
 class MWasmInterruptCheck
   : public MUnaryInstruction,
@@ -8316,6 +8464,53 @@ class MGetNextEntryForIterator
     }
 };
 
+// Map.prototype.get on a known MapObject.
+class MMapObjectGet
+  : public MBinaryInstruction,
+    public MixPolicy<ObjectPolicy<0>, BoxPolicy<1> >::Data
+{
+    MMapObjectGet(MDefinition* map, MDefinition* key)
+      : MBinaryInstruction(classOpcode, map, key)
+    {
+        setResultType(MIRType::Value);
+    }
+
+  public:
+    INSTRUCTION_HEADER(MapObjectGet)
+    TRIVIAL_NEW_WRAPPERS
+    NAMED_OPERANDS((0, map), (1, key))
+};
+
+// Map.prototype.has or Set.prototype.has on a known MapObject or SetObject.
+class MMapOrSetHas
+  : public MBinaryInstruction,
+    public MixPolicy<ObjectPolicy<0>, BoxPolicy<1> >::Data
+{
+  public:
+    enum Mode {
+        Map,
+        Set
+    };
+
+  private:
+    Mode mode_;
+
+    MMapOrSetHas(MDefinition* object, MDefinition* key, Mode mode)
+      : MBinaryInstruction(classOpcode, object, key), mode_(mode)
+    {
+        setResultType(MIRType::Boolean);
+    }
+
+  public:
+    INSTRUCTION_HEADER(MapOrSetHas)
+    TRIVIAL_NEW_WRAPPERS
+    NAMED_OPERANDS((0, object), (1, key))
+
+    Mode mode() const {
+        return mode_;
+    }
+};
+
 // Read the length of a typed array.
 class MTypedArrayLength
   : public MUnaryInstruction,
@@ -8341,6 +8536,8 @@ class MTypedArrayLength
     }
 
     void computeRange(TempAllocator& alloc) override;
+
+    ALLOW_CLONE(MTypedArrayLength)
 };
 
 // Load a typed array's elements vector.
@@ -8402,6 +8599,83 @@ class MSetDisjointTypedElements
     ALLOW_CLONE(MSetDisjointTypedElements)
 };
 
+// Store an int32 value in a range of the elements of a typed array.
+class MTypedArrayFill
+  : public MQuaternaryInstruction,
+    public NoTypePolicy::Data
+{
+    MTypedArrayFill(MDefinition* object, MDefinition* value, MDefinition* start,
+                    MDefinition* end)
+      : MQuaternaryInstruction(classOpcode, object, value, start, end)
+    {
+        MOZ_ASSERT(object->type() == MIRType::Object);
+        MOZ_ASSERT(value->type() == MIRType::Int32);
+        MOZ_ASSERT(start->type() == MIRType::Int32);
+        MOZ_ASSERT(end->type() == MIRType::Int32);
+        setResultType(MIRType::None);
+    }
+
+  public:
+    INSTRUCTION_HEADER(TypedArrayFill)
+    TRIVIAL_NEW_WRAPPERS
+    NAMED_OPERANDS((0, object), (1, value), (2, start), (3, end))
+
+    AliasSet getAliasSet() const override {
+        return AliasSet::Store(AliasSet::UnboxedElement);
+    }
+
+    ALLOW_CLONE(MTypedArrayFill)
+};
+
+// Search the elements of a typed array for an int32 value, starting at a
+// non-negative index.
+class MTypedArraySearch
+  : public MTernaryInstruction,
+    public NoTypePolicy::Data
+{
+  public:
+    enum Mode {
+        IndexOf,
+        LastIndexOf,
+        Includes
+    };
+
+  private:
+    Mode mode_;
+
+    MTypedArraySearch(MDefinition* object, MDefinition* value, MDefinition* start, Mode mode)
+      : MTernaryInstruction(classOpcode, object, value, start),
+        mode_(mode)
+    {
+        MOZ_ASSERT(object->type() == MIRType::Object);
+        MOZ_ASSERT(value->type() == MIRType::Int32);
+        MOZ_ASSERT(start->type() == MIRType::Int32);
+        setResultType(mode == Includes ? MIRType::Boolean : MIRType::Int32);
+        setMovable();
+    }
+
+  public:
+    INSTRUCTION_HEADER(TypedArraySearch)
+    TRIVIAL_NEW_WRAPPERS
+    NAMED_OPERANDS((0, object), (1, value), (2, start))
+
+    Mode mode() const {
+        return mode_;
+    }
+
+    bool congruentTo(const MDefinition* ins) const override {
+        if (!ins->isTypedArraySearch() || ins->toTypedArraySearch()->mode() != mode_) {
+            return false;
+        }
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const override {
+        return AliasSet::Load(AliasSet::UnboxedElement | AliasSet::TypedArrayLength);
+    }
+
+    ALLOW_CLONE(MTypedArraySearch)
+};
+
 // Load a binary data object's "elements", which is just its opaque
 // binary data space. Eventually this should probably be
 // unified with `MTypedArrayElements`.
@@ -8551,6 +8825,8 @@ class MNot
     bool canRecoverOnBailout() const override {
         return true;
     }
+
+    ALLOW_CLONE(MNot)
 };
 
 // Bailout if index + minimum < 0 or index + maximum >= length. The length used
@@ -8965,8 +9241,8 @@ class MStoreElementCommon
     bool needsBarrier() const {
         return needsBarrier_;
     }
-    void setNeedsBarrier() {
-        needsBarrier_ = true;
+    void setNeedsBarrier(bool needsBarrier = true) {
+        needsBarrier_ = needsBarrier;
     }
 };
 
@@ -9381,6 +9657,57 @@ class MArrayJoin
     MDefinition* foldsTo(TempAllocator& alloc) override;
 };
 
+// Search a range of the dense elements of a packed array for an int32 or
+// object value. LastIndexOf searches the range backwards.
+class MArraySearch
+  : public MQuaternaryInstruction,
+    public NoTypePolicy::Data
+{
+  public:
+    enum Mode {
+        IndexOf,
+        LastIndexOf,
+        Includes
+    };
+
+  private:
+    Mode mode_;
+
+    MArraySearch(MDefinition* array, MDefinition* value, MDefinition* start, MDefinition* end,
+                 Mode mode)
+      : MQuaternaryInstruction(classOpcode, array, value, start, end),
+        mode_(mode)
+    {
+        MOZ_ASSERT(array->type() == MIRType::Object);
+        MOZ_ASSERT(value->type() == MIRType::Int32 || value->type() == MIRType::Object);
+        MOZ_ASSERT(start->type() == MIRType::Int32);
+        MOZ_ASSERT(end->type() == MIRType::Int32);
+        setResultType(mode == Includes ? MIRType::Boolean : MIRType::Int32);
+        setMovable();
+    }
+
+  public:
+    INSTRUCTION_HEADER(ArraySearch)
+    TRIVIAL_NEW_WRAPPERS
+    NAMED_OPERANDS((0, array), (1, value), (2, start), (3, end))
+
+    Mode mode() const {
+        return mode_;
+    }
+
+    bool congruentTo(const MDefinition* ins) const override {
+        if (!ins->isArraySearch() || ins->toArraySearch()->mode() != mode_) {
+            return false;
+        }
+        return congruentIfOperandsEqual(ins);
+    }
+    AliasSet getAliasSet() const override {
+        return AliasSet::Load(AliasSet::ObjectFields | AliasSet::Element);
+    }
+
+    ALLOW_CLONE(MArraySearch)
+};
+
 // All barriered operations - MCompareExchangeTypedArrayElement,
 // MExchangeTypedArrayElement, and MAtomicTypedArrayElementBinop, as
 // well as MLoadUnboxedScalar and MStoreUnboxedScalar when they are
@@ -9669,6 +9996,106 @@ class MStoreUnboxedScalar
     ALLOW_CLONE(MStoreUnboxedScalar)
 };
 
+// Load a scalar from a DataView's data, at a byte offset which has already been
+// bounds checked. Unlike typed array elements, the offset needn't be aligned
+// and the value is stored in the byte order given by |littleEndian|.
+class MLoadDataViewElement
+  : public MBinaryInstruction,
+    public NoTypePolicy::Data
+{
+    Scalar::Type storageType_;
+    bool littleEndian_;
+
+    MLoadDataViewElement(MDefinition* elements, MDefinition* index, Scalar::Type storageType,
+                         bool littleEndian)
+      : MBinaryInstruction(classOpcode, elements, index),
+        storageType_(storageType),
+        littleEndian_(littleEndian)
+    {
+        setResultType(MIRType::Value);
+        setMovable();
+        MOZ_ASSERT(elements->type() == MIRType::Elements);
+        MOZ_ASSERT(index->type() == MIRType::Int32);
+        MOZ_ASSERT(storageType >= 0 && storageType < Scalar::MaxTypedArrayViewType);
+    }
+
+  public:
+    INSTRUCTION_HEADER(LoadDataViewElement)
+    TRIVIAL_NEW_WRAPPERS
+    NAMED_OPERANDS((0, elements), (1, index))
+
+    Scalar::Type storageType() const {
+        return storageType_;
+    }
+    bool littleEndian() const {
+        return littleEndian_;
+    }
+    bool fallible() const {
+        // Bailout if the result does not fit in an int32.
+        return storageType_ == Scalar::Uint32 && type() == MIRType::Int32;
+    }
+    AliasSet getAliasSet() const override {
+        return AliasSet::Load(AliasSet::UnboxedElement);
+    }
+
+    bool congruentTo(const MDefinition* ins) const override {
+        if (!ins->isLoadDataViewElement()) {
+            return false;
+        }
+        const MLoadDataViewElement* other = ins->toLoadDataViewElement();
+        if (storageType_ != other->storageType_ || littleEndian_ != other->littleEndian_) {
+            return false;
+        }
+        return congruentIfOperandsEqual(other);
+    }
+
+    bool canProduceFloat32() const override { return storageType_ == Scalar::Float32; }
+
+    ALLOW_CLONE(MLoadDataViewElement)
+};
+
+// Store a scalar to a DataView's data, at a byte offset which has already been
+// bounds checked. See MLoadDataViewElement.
+class MStoreDataViewElement
+  : public MTernaryInstruction,
+    public StoreUnboxedScalarBase,
+    public StoreDataViewElementPolicy::Data
+{
+    bool littleEndian_;
+
+    MStoreDataViewElement(MDefinition* elements, MDefinition* index, MDefinition* value,
+                          Scalar::Type storageType, bool littleEndian)
+      : MTernaryInstruction(classOpcode, elements, index, value),
+        StoreUnboxedScalarBase(storageType),
+        littleEndian_(littleEndian)
+    {
+        MOZ_ASSERT(elements->type() == MIRType::Elements);
+        MOZ_ASSERT(index->type() == MIRType::Int32);
+        MOZ_ASSERT(storageType >= 0 && storageType < Scalar::MaxTypedArrayViewType);
+    }
+
+  public:
+    INSTRUCTION_HEADER(StoreDataViewElement)
+    TRIVIAL_NEW_WRAPPERS
+    NAMED_OPERANDS((0, elements), (1, index), (2, value))
+
+    Scalar::Type storageType() const {
+        return writeType();
+    }
+    bool littleEndian() const {
+        return littleEndian_;
+    }
+    AliasSet getAliasSet() const override {
+        return AliasSet::Store(AliasSet::UnboxedElement);
+    }
+
+    bool canConsumeFloat32(MUse* use) const override {
+        return use == getUseFor(2) && writeType() == Scalar::Float32;
+    }
+
+    ALLOW_CLONE(MStoreDataViewElement)
+};
+
 class MStoreTypedArrayElementHole
   : public MQuaternaryInstruction,
     public StoreUnboxedScalarBase,
@@ -10551,6 +10978,7 @@ class MGuardShape
     AliasSet getAliasSet() const override {
         return AliasSet::Load(AliasSet::ObjectFields);
     }
+    AliasType mightAlias(const MDefinition* store) const override;
     bool appendRoots(MRootList& roots) const override {
         return roots.append(shape_);
     }
@@ -10596,6 +11024,7 @@ class MGuardReceiverPolymorphic
     AliasSet getAliasSet() const override {
         return AliasSet::Load(AliasSet::ObjectFields);
     }
+    AliasType mightAlias(const MDefinition* store) const override;
 
     bool appendRoots(MRootList& roots) const override;
 
@@ -10659,6 +11088,7 @@ class MGuardObjectGroup
     AliasSet getAliasSet() const override {
         return AliasSet::Load(AliasSet::ObjectFields);
     }
+    AliasType mightAlias(const MDefinition* store) const override;
     bool appendRoots(MRootList& roots) const override {
         return roots.append(group_);
     }
@@ -10980,8 +11410,8 @@ class MStoreSlot
     bool needsBarrier() const {
         return needsBarrier_;
     }
-    void setNeedsBarrier() {
-        needsBarrier_ = true;
+    void setNeedsBarrier(bool needsBarrier = true) {
+        needsBarrier_ = needsBarrier;
     }
     AliasSet getAliasSet() const override {
         return AliasSet::Store(AliasSet::DynamicSlot);
@@ -12247,7 +12677,7 @@ class MTypeBarrier
     }
     MDefinition* foldsTo(TempAllocator& alloc) override;
 
-    bool canRedefineInput();
+    bool canRedefineInput(const SpectreMitigations& spectre);
 
     bool alwaysBails() const {
         // If mirtype of input doesn't agree with mirtype of barrier,
@@ -14126,6 +14556,296 @@ class MWasmReinterpret
     ALLOW_CLONE(MWasmReinterpret)
 };
 
+// Wasm SIMD operations. Wasm has a single v128 type whose lanes are only given
+// an interpretation by the operations, so all the 128-bit values are carried
+// as MIRType::Int32x4 and each node records the wasm::SimdOp it implements.
+
+class MWasmSimd128Constant : public MNullaryInstruction
+{
+    SimdConstant value_;
+
+    explicit MWasmSimd128Constant(const SimdConstant& value)
+      : MNullaryInstruction(classOpcode),
+        value_(value)
+    {
+        setMovable();
+        setResultType(MIRType::Int32x4);
+    }
+
+  public:
+    INSTRUCTION_HEADER(WasmSimd128Constant)
+    TRIVIAL_NEW_WRAPPERS
+
+    HashNumber valueHash() const override;
+    bool congruentTo(const MDefinition* ins) const override;
+    AliasSet getAliasSet() const override {
+        return AliasSet::None();
+    }
+
+    const SimdConstant& value() const {
+        return value_;
+    }
+
+    ALLOW_CLONE(MWasmSimd128Constant)
+};
+
+// The lane-wise arithmetic, bitwise and comparison operations, and the
+// dynamic i8x16.swizzle.
+class MWasmBinarySimd128
+  : public MBinaryInstruction,
+    public NoTypePolicy::Data
+{
+    wasm::SimdOp simdOp_;
+
+    MWasmBinarySimd128(MDefinition* lhs, MDefinition* rhs, wasm::SimdOp simdOp)
+      : MBinaryInstruction(classOpcode, lhs, rhs),
+        simdOp_(simdOp)
+    {
+        MOZ_ASSERT(lhs->type() == MIRType::Int32x4);
+        MOZ_ASSERT(rhs->type() == MIRType::Int32x4);
+        setMovable();
+        setResultType(MIRType::Int32x4);
+        switch (simdOp) {
+          case wasm::SimdOp::I8x16Eq:
+          case wasm::SimdOp::I16x8Eq:
+          case wasm::SimdOp::I32x4Eq:
+          case wasm::SimdOp::V128And:
+          case wasm::SimdOp::V128Or:
+          case wasm::SimdOp::V128Xor:
+          case wasm::SimdOp::I8x16Add:
+          case wasm::SimdOp::I8x16AddSatS:
+          case wasm::SimdOp::I8x16AddSatU:
+          case wasm::SimdOp::I16x8Add:
+          case wasm::SimdOp::I16x8AddSatS:
+          case wasm::SimdOp::I16x8AddSatU:
+          case wasm::SimdOp::I16x8Mul:
+          case wasm::SimdOp::I32x4Add:
+          case wasm::SimdOp::I32x4Mul:
+            setCommutative();
+            break;
+          default:
+            // The floating point operations are not commutative once NaN
+            // payloads are taken into account.
+            break;
+        }
+    }
+
+  public:
+    INSTRUCTION_HEADER(WasmBinarySimd128)
+    TRIVIAL_NEW_WRAPPERS
+
+    wasm::SimdOp simdOp() const {
+        return simdOp_;
+    }
+
+    AliasSet getAliasSet() const override {
+        return AliasSet::None();
+    }
+    bool congruentTo(const MDefinition* ins) const override {
+        return ins->isWasmBinarySimd128() &&
+               ins->toWasmBinarySimd128()->simdOp() == simdOp_ &&
+               binaryCongruentTo(ins);
+    }
+
+    ALLOW_CLONE(MWasmBinarySimd128)
+};
+
+class MWasmUnarySimd128
+  : public MUnaryInstruction,
+    public NoTypePolicy::Data
+{
+    wasm::SimdOp simdOp_;
+
+    MWasmUnarySimd128(MDefinition* input, wasm::SimdOp simdOp)
+      : MUnaryInstruction(classOpcode, input),
+        simdOp_(simdOp)
+    {
+        MOZ_ASSERT(input->type() == MIRType::Int32x4);
+        setMovable();
+        setResultType(MIRType::Int32x4);
+    }
+
+  public:
+    INSTRUCTION_HEADER(WasmUnarySimd128)
+    TRIVIAL_NEW_WRAPPERS
+
+    wasm::SimdOp simdOp() const {
+        return simdOp_;
+    }
+
+    AliasSet getAliasSet() const override {
+        return AliasSet::None();
+    }
+    bool congruentTo(const MDefinition* ins) const override {
+        return ins->isWasmUnarySimd128() &&
+               ins->toWasmUnarySimd128()->simdOp() == simdOp_ &&
+               congruentIfOperandsEqual(ins);
+    }
+
+    ALLOW_CLONE(MWasmUnarySimd128)
+};
+
+// i8x16.shuffle: each byte of |lanes| selects one of the 32 bytes of the
+// concatenation of lhs and rhs.
+class MWasmShuffleSimd128
+  : public MBinaryInstruction,
+    public NoTypePolicy::Data
+{
+    SimdConstant lanes_;
+
+    MWasmShuffleSimd128(MDefinition* lhs, MDefinition* rhs, const SimdConstant& lanes)
+      : MBinaryInstruction(classOpcode, lhs, rhs),
+        lanes_(lanes)
+    {
+        MOZ_ASSERT(lhs->type() == MIRType::Int32x4);
+        MOZ_ASSERT(rhs->type() == MIRType::Int32x4);
+        setMovable();
+        setResultType(MIRType::Int32x4);
+    }
+
+  public:
+    INSTRUCTION_HEADER(WasmShuffleSimd128)
+    TRIVIAL_NEW_WRAPPERS
+
+    const SimdConstant& lanes() const {
+        return lanes_;
+    }
+
+    AliasSet getAliasSet() const override {
+        return AliasSet::None();
+    }
+    bool congruentTo(const MDefinition* ins) const override {
+        return ins->isWasmShuffleSimd128() &&
+               ins->toWasmShuffleSimd128()->lanes() == lanes_ &&
+               congruentIfOperandsEqual(ins);
+    }
+
+    ALLOW_CLONE(MWasmShuffleSimd128)
+};
+
+// The splats: replicate an Int32 or Float32 scalar into all the lanes.
+class MWasmScalarToSimd128
+  : public MUnaryInstruction,
+    public NoTypePolicy::Data
+{
+    wasm::SimdOp simdOp_;
+
+    MWasmScalarToSimd128(MDefinition* src, wasm::SimdOp simdOp)
+      : MUnaryInstruction(classOpcode, src),
+        simdOp_(simdOp)
+    {
+        MOZ_ASSERT(src->type() == MIRType::Int32 || src->type() == MIRType::Float32);
+        setMovable();
+        setResultType(MIRType::Int32x4);
+    }
+
+  public:
+    INSTRUCTION_HEADER(WasmScalarToSimd128)
+    TRIVIAL_NEW_WRAPPERS
+
+    wasm::SimdOp simdOp() const {
+        return simdOp_;
+    }
+
+    AliasSet getAliasSet() const override {
+        return AliasSet::None();
+    }
+    bool congruentTo(const MDefinition* ins) const override {
+        return ins->isWasmScalarToSimd128() &&
+               ins->toWasmScalarToSimd128()->simdOp() == simdOp_ &&
+               congruentIfOperandsEqual(ins);
+    }
+
+    ALLOW_CLONE(MWasmScalarToSimd128)
+};
+
+// The lane extractions, producing an Int32 or a Float32.
+class MWasmReduceSimd128
+  : public MUnaryInstruction,
+    public NoTypePolicy::Data
+{
+    wasm::SimdOp simdOp_;
+    uint32_t lane_;
+
+    MWasmReduceSimd128(MDefinition* src, wasm::SimdOp simdOp, MIRType outType, uint32_t lane)
+      : MUnaryInstruction(classOpcode, src),
+        simdOp_(simdOp),
+        lane_(lane)
+    {
+        MOZ_ASSERT(src->type() == MIRType::Int32x4);
+        MOZ_ASSERT(outType == MIRType::Int32 || outType == MIRType::Float32);
+        setMovable();
+        setResultType(outType);
+    }
+
+  public:
+    INSTRUCTION_HEADER(WasmReduceSimd128)
+    TRIVIAL_NEW_WRAPPERS
+
+    wasm::SimdOp simdOp() const {
+        return simdOp_;
+    }
+    uint32_t lane() const {
+        return lane_;
+    }
+
+    AliasSet getAliasSet() const override {
+        return AliasSet::None();
+    }
+    bool congruentTo(const MDefinition* ins) const override {
+        return ins->isWasmReduceSimd128() &&
+               ins->toWasmReduceSimd128()->simdOp() == simdOp_ &&
+               ins->toWasmReduceSimd128()->lane() == lane_ &&
+               congruentIfOperandsEqual(ins);
+    }
+
+    ALLOW_CLONE(MWasmReduceSimd128)
+};
+
+class MWasmReplaceLaneSimd128
+  : public MBinaryInstruction,
+    public NoTypePolicy::Data
+{
+    wasm::SimdOp simdOp_;
+    uint32_t lane_;
+
+    MWasmReplaceLaneSimd128(MDefinition* vector, MDefinition* value, wasm::SimdOp simdOp,
+                            uint32_t lane)
+      : MBinaryInstruction(classOpcode, vector, value),
+        simdOp_(simdOp),
+        lane_(lane)
+    {
+        MOZ_ASSERT(vector->type() == MIRType::Int32x4);
+        MOZ_ASSERT(value->type() == MIRType::Int32 || value->type() == MIRType::Float32);
+        setMovable();
+        setResultType(MIRType::Int32x4);
+    }
+
+  public:
+    INSTRUCTION_HEADER(WasmReplaceLaneSimd128)
+    TRIVIAL_NEW_WRAPPERS
+    NAMED_OPERANDS((0, vector), (1, value))
+
+    wasm::SimdOp simdOp() const {
+        return simdOp_;
+    }
+    uint32_t lane() const {
+        return lane_;
+    }
+
+    AliasSet getAliasSet() const override {
+        return AliasSet::None();
+    }
+    bool congruentTo(const MDefinition* ins) const override {
+        return ins->isWasmReplaceLaneSimd128() &&
+               ins->toWasmReplaceLaneSimd128()->simdOp() == simdOp_ &&
+               ins->toWasmReplaceLaneSimd128()->lane() == lane_ &&
+               congruentIfOperandsEqual(ins);
+    }
+
+    ALLOW_CLONE(MWasmReplaceLaneSimd128)
+};
+
 class MRotate
   : public MBinaryInstruction,
     public NoTypePolicy::Data
@@ -113,6 +113,10 @@ class MIRGenerator
         return stringsCanBeInNursery_;
     }
 
+    const SpectreMitigations& spectre() const {
+        return options.spectreMitigations();
+    }
+
     bool safeForMinorGC() const {
         return safeForMinorGC_;
     }
@@ -485,6 +485,7 @@ MBasicBlock::New(MIRGraph& graph, const CompileInfo& info, MBasicBlock* pred, Ki
 MBasicBlock::MBasicBlock(MIRGraph& graph, const CompileInfo& info, BytecodeSite* site, Kind kind)
   : unreachable_(false),
     specialized_(false),
+    cold_(false),
     graph_(graph),
     info_(info),
     predecessors_(graph.alloc()),
@@ -60,6 +60,10 @@ class MBasicBlock : public TempObject, public InlineListNode<MBasicBlock>
     // Keeps track if the phis has been type specialized already.
     bool specialized_;
 
+    // This block is unlikely to run, so its code is emitted after the code of
+    // the other blocks.
+    bool cold_;
+
     // Pushes a copy of a local variable or argument.
     void pushVariable(uint32_t slot) {
         push(slots_[slot]);
@@ -147,6 +151,13 @@ class MBasicBlock : public TempObject, public InlineListNode<MBasicBlock>
     bool unreachable() const {
         return unreachable_;
     }
+
+    void setCold() {
+        cold_ = true;
+    }
+    bool isCold() const {
+        return cold_;
+    }
     // Move the definition to the top of the stack.
     void pick(int32_t depth);
 
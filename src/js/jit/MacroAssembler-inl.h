@@ -469,7 +469,7 @@ MacroAssembler::branchTestObjClass(Condition cond, Register obj, const js::Class
     loadPtr(Address(obj, JSObject::offsetOfGroup()), scratch);
     branchPtr(cond, Address(scratch, ObjectGroup::offsetOfClasp()), ImmPtr(clasp), label);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (spectre_.objectMitigationsMisc) {
         spectreZeroRegister(cond, scratch, spectreRegToZero);
     }
 }
@@ -494,7 +494,7 @@ MacroAssembler::branchTestObjClass(Condition cond, Register obj, const Address&
     loadPtr(Address(scratch, ObjectGroup::offsetOfClasp()), scratch);
     branchPtr(cond, clasp, scratch, label);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (spectre_.objectMitigationsMisc) {
         spectreZeroRegister(cond, scratch, spectreRegToZero);
     }
 }
@@ -517,13 +517,13 @@ MacroAssembler::branchTestObjShape(Condition cond, Register obj, const Shape* sh
     MOZ_ASSERT(obj != scratch);
     MOZ_ASSERT(spectreRegToZero != scratch);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (spectre_.objectMitigationsMisc) {
         move32(Imm32(0), scratch);
     }
 
     branchPtr(cond, Address(obj, ShapedObject::offsetOfShape()), ImmGCPtr(shape), label);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (spectre_.objectMitigationsMisc) {
         spectreMovePtr(cond, scratch, spectreRegToZero);
     }
 }
@@ -543,13 +543,13 @@ MacroAssembler::branchTestObjShape(Condition cond, Register obj, Register shape,
     MOZ_ASSERT(obj != shape);
     MOZ_ASSERT(spectreRegToZero != scratch);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (spectre_.objectMitigationsMisc) {
         move32(Imm32(0), scratch);
     }
 
     branchPtr(cond, Address(obj, ShapedObject::offsetOfShape()), shape, label);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (spectre_.objectMitigationsMisc) {
         spectreMovePtr(cond, scratch, spectreRegToZero);
     }
 }
@@ -575,13 +575,13 @@ MacroAssembler::branchTestObjGroup(Condition cond, Register obj, const ObjectGro
     MOZ_ASSERT(obj != scratch);
     MOZ_ASSERT(spectreRegToZero != scratch);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (spectre_.objectMitigationsMisc) {
         move32(Imm32(0), scratch);
     }
 
     branchPtr(cond, Address(obj, JSObject::offsetOfGroup()), ImmGCPtr(group), label);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (spectre_.objectMitigationsMisc) {
         spectreMovePtr(cond, scratch, spectreRegToZero);
     }
 }
@@ -608,13 +608,13 @@ MacroAssembler::branchTestObjGroup(Condition cond, Register obj, Register group,
     MOZ_ASSERT(obj != group);
     MOZ_ASSERT(spectreRegToZero != scratch);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (spectre_.objectMitigationsMisc) {
         move32(Imm32(0), scratch);
     }
 
     branchPtr(cond, Address(obj, JSObject::offsetOfGroup()), group, label);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (spectre_.objectMitigationsMisc) {
         spectreMovePtr(cond, scratch, spectreRegToZero);
     }
 }
@@ -256,7 +256,7 @@ MacroAssembler::guardObjectType(Register obj, const TypeSet* types, Register scr
         return;
     }
 
-    if (JitOptions.spectreObjectMitigationsBarriers) {
+    if (spectre_.objectMitigationsBarriers) {
         move32(Imm32(0), scratch);
     }
 
@@ -267,7 +267,7 @@ MacroAssembler::guardObjectType(Register obj, const TypeSet* types, Register scr
                 continue;
             }
 
-            if (JitOptions.spectreObjectMitigationsBarriers) {
+            if (spectre_.objectMitigationsBarriers) {
                 if (--numBranches > 0) {
                     Label next;
                     branchPtr(NotEqual, obj, ImmGCPtr(singleton), &next);
@@ -294,7 +294,7 @@ MacroAssembler::guardObjectType(Register obj, const TypeSet* types, Register scr
         // If Spectre mitigations are enabled, we use the scratch register as
         // zero register. Without mitigations we can use it to store the group.
         Address groupAddr(obj, JSObject::offsetOfGroup());
-        if (!JitOptions.spectreObjectMitigationsBarriers) {
+        if (!spectre_.objectMitigationsBarriers) {
             loadPtr(groupAddr, scratch);
         }
 
@@ -309,7 +309,7 @@ MacroAssembler::guardObjectType(Register obj, const TypeSet* types, Register scr
                 return;
             }
 
-            if (JitOptions.spectreObjectMitigationsBarriers) {
+            if (spectre_.objectMitigationsBarriers) {
                 if (--numBranches > 0) {
                     Label next;
                     branchPtr(NotEqual, groupAddr, ImmGCPtr(group), &next);
@@ -751,7 +751,7 @@ MacroAssembler::storeUnboxedProperty(BaseIndex address, JSValueType type,
 // Inlined version of gc::CheckAllocatorState that checks the bare essentials
 // and bails for anything that cannot be handled with our jit allocators.
 void
-MacroAssembler::checkAllocatorState(Label* fail)
+MacroAssembler::checkAllocatorState(Label* fail, Register temp)
 {
     // Don't execute the inline path if we are tracing allocations.
     if (js::gc::gcTracer.traceEnabled()) {
@@ -768,8 +768,19 @@ MacroAssembler::checkAllocatorState(Label* fail)
 
     // Don't execute the inline path if the realm has an object metadata callback,
     // as the metadata to use for the object may vary between executions of the op.
-    if (GetJitContext()->realm->hasAllocationMetadataBuilder()) {
-        jump(fail);
+    // Object allocations which are sampled by SavedStacks only need metadata
+    // when they are picked: count them down, and only take the out of line path
+    // for the picked ones. This needs a temp register.
+    CompileRealm* realm = GetJitContext()->realm;
+    if (realm->hasAllocationMetadataBuilder()) {
+        if (temp == InvalidReg || !realm->hasSampledAllocationMetadataBuilder()) {
+            jump(fail);
+            return;
+        }
+
+        movePtr(ImmPtr(realm->addressOfAllocationsUntilSample()), temp);
+        branch32(Assembler::Equal, Address(temp, 0), Imm32(0), fail);
+        add32(Imm32(-1), Address(temp, 0));
     }
 }
 
@@ -788,7 +799,7 @@ MacroAssembler::shouldNurseryAllocate(gc::AllocKind allocKind, gc::InitialHeap i
 // this fills in the slots_ pointer.
 void
 MacroAssembler::nurseryAllocateObject(Register result, Register temp, gc::AllocKind allocKind,
-                                      size_t nDynamicSlots, Label* fail)
+                                      size_t nDynamicSlots, Label* fail, gc::AllocSite* site)
 {
     MOZ_ASSERT(IsNurseryAllocable(allocKind));
 
@@ -801,17 +812,31 @@ MacroAssembler::nurseryAllocateObject(Register result, Register temp, gc::AllocK
         return;
     }
 
+    // Allocations for long-lived sites are made in the tenured heap by the
+    // interpreter.
+    if (site) {
+        movePtr(ImmPtr(site), temp);
+        branch32(Assembler::Equal, Address(temp, gc::AllocSite::offsetOfState()),
+                 Imm32(int32_t(gc::AllocSite::State::LongLived)), fail);
+    }
+
     // No explicit check for nursery.isEnabled() is needed, as the comparison
     // with the nursery's end will always fail in such cases.
     CompileZone* zone = GetJitContext()->realm->zone();
     size_t thingSize = gc::Arena::thingSize(allocKind);
-    size_t totalSize = thingSize + nDynamicSlots * sizeof(HeapSlot);
+    size_t size = thingSize + nDynamicSlots * sizeof(HeapSlot);
+    size_t totalSize = js::Nursery::objectHeaderSize() + size;
     MOZ_ASSERT(totalSize < INT32_MAX);
     MOZ_ASSERT(totalSize % gc::CellAlignBytes == 0);
 
     bumpPointerAllocate(result, temp, fail,
         zone->addressOfNurseryPosition(),
-        zone->addressOfNurseryCurrentEnd(), totalSize, totalSize);
+        zone->addressOfNurseryCurrentEnd(), totalSize, size);
+    storePtr(ImmPtr(site), Address(result, -js::Nursery::objectHeaderSize()));
+
+    if (site) {
+        updateAllocSite(result, temp, site);
+    }
 
     if (nDynamicSlots) {
         computeEffectiveAddress(Address(result, thingSize), temp);
@@ -819,6 +844,30 @@ MacroAssembler::nurseryAllocateObject(Register result, Register temp, gc::AllocK
     }
 }
 
+// Inline version of AllocSite::noteNurseryAlloc.
+void
+MacroAssembler::updateAllocSite(Register result, Register temp, gc::AllocSite* site)
+{
+    Label done;
+    movePtr(ImmPtr(site), temp);
+    Address allocCount(temp, gc::AllocSite::offsetOfNurseryAllocCount());
+    add32(Imm32(1), allocCount);
+    branch32(Assembler::NotEqual, allocCount, Imm32(1), &done);
+
+    // This is the site's first allocation since the last minor GC, so add it
+    // to the nursery's list of sites.
+    void* sitesAddr = GetJitContext()->realm->zone()->addressOfNurseryAllocatedSites();
+    push(result);
+    movePtr(ImmPtr(sitesAddr), result);
+    loadPtr(Address(result, 0), result);
+    storePtr(result, Address(temp, gc::AllocSite::offsetOfNextNurseryAllocated()));
+    movePtr(ImmPtr(sitesAddr), result);
+    storePtr(temp, Address(result, 0));
+    pop(result);
+
+    bind(&done);
+}
+
 // Inlined version of FreeSpan::allocate. This does not fill in slots_.
 void
 MacroAssembler::freeListAllocate(Register result, Register temp, gc::AllocKind allocKind, Label* fail)
@@ -917,15 +966,16 @@ MacroAssembler::callFreeStub(Register slots)
 // Inlined equivalent of gc::AllocateObject, without failure case handling.
 void
 MacroAssembler::allocateObject(Register result, Register temp, gc::AllocKind allocKind,
-                               uint32_t nDynamicSlots, gc::InitialHeap initialHeap, Label* fail)
+                               uint32_t nDynamicSlots, gc::InitialHeap initialHeap, Label* fail,
+                               gc::AllocSite* site)
 {
     MOZ_ASSERT(gc::IsObjectAllocKind(allocKind));
 
-    checkAllocatorState(fail);
+    checkAllocatorState(fail, temp);
 
     if (shouldNurseryAllocate(allocKind, initialHeap)) {
         MOZ_ASSERT(initialHeap == gc::DefaultHeap);
-        return nurseryAllocateObject(result, temp, allocKind, nDynamicSlots, fail);
+        return nurseryAllocateObject(result, temp, allocKind, nDynamicSlots, fail, site);
     }
 
     if (!nDynamicSlots) {
@@ -957,7 +1007,8 @@ MacroAssembler::allocateObject(Register result, Register temp, gc::AllocKind all
 
 void
 MacroAssembler::createGCObject(Register obj, Register temp, const TemplateObject& templateObj,
-                               gc::InitialHeap initialHeap, Label* fail, bool initContents)
+                               gc::InitialHeap initialHeap, Label* fail, bool initContents,
+                               gc::AllocSite* site)
 {
     gc::AllocKind allocKind = templateObj.getAllocKind();
     MOZ_ASSERT(gc::IsObjectAllocKind(allocKind));
@@ -975,7 +1026,7 @@ MacroAssembler::createGCObject(Register obj, Register temp, const TemplateObject
         }
     }
 
-    allocateObject(obj, temp, allocKind, nDynamicSlots, initialHeap, fail);
+    allocateObject(obj, temp, allocKind, nDynamicSlots, initialHeap, fail, site);
     initGCThing(obj, temp, templateObj, initContents);
 }
 
@@ -1529,7 +1580,7 @@ MacroAssembler::loadStringChars(Register str, Register dest, CharEncoding encodi
 {
     MOZ_ASSERT(str != dest);
 
-    if (JitOptions.spectreStringMitigations) {
+    if (spectre_.stringMitigations) {
         if (encoding == CharEncoding::Latin1) {
             // If the string is a rope, zero the |str| register. The code below
             // depends on str->flags so this should block speculative execution.
@@ -1571,7 +1622,7 @@ MacroAssembler::loadNonInlineStringChars(Register str, Register dest, CharEncodi
 {
     MOZ_ASSERT(str != dest);
 
-    if (JitOptions.spectreStringMitigations) {
+    if (spectre_.stringMitigations) {
         // If the string is a rope, has inline chars, or has a different
         // character encoding, set str to a near-null value to prevent
         // speculative execution below (when reading str->nonInlineChars).
@@ -1618,7 +1669,7 @@ MacroAssembler::loadInlineStringChars(Register str, Register dest, CharEncoding
 {
     MOZ_ASSERT(str != dest);
 
-    if (JitOptions.spectreStringMitigations) {
+    if (spectre_.stringMitigations) {
         // Making this Spectre-safe is a bit complicated: using
         // computeEffectiveAddress and then zeroing the output register if
         // non-inline is not sufficient: when the index is very large, it would
@@ -1635,7 +1686,7 @@ MacroAssembler::loadRopeLeftChild(Register str, Register dest)
 {
     MOZ_ASSERT(str != dest);
 
-    if (JitOptions.spectreStringMitigations) {
+    if (spectre_.stringMitigations) {
         // Zero the output register if the input was not a rope.
         movePtr(ImmWord(0), dest);
         test32LoadPtr(Assembler::Zero,
@@ -1658,7 +1709,7 @@ MacroAssembler::loadDependentStringBase(Register str, Register dest)
 {
     MOZ_ASSERT(str != dest);
 
-    if (JitOptions.spectreStringMitigations) {
+    if (spectre_.stringMitigations) {
         // If the string does not have a base-string, zero the |str| register.
         // The code below loads str->base so this should block speculative
         // execution.
@@ -3364,7 +3415,7 @@ MacroAssembler::branchTestObjGroup(Condition cond, Register obj, const Address&
     loadPtr(Address(obj, JSObject::offsetOfGroup()), scratch);
     branchPtr(cond, group, scratch, label);
 
-    if (JitOptions.spectreObjectMitigationsMisc) {
+    if (spectre_.objectMitigationsMisc) {
         spectreZeroRegister(cond, scratch, spectreRegToZero);
     }
 }
@@ -3599,17 +3650,22 @@ MacroAssembler::wasmCallIndirect(const wasm::CallSiteDesc& desc, const wasm::Cal
 
     MOZ_ASSERT(callee.which() == wasm::CalleeDesc::WasmTable);
 
-    // Write the functype-id into the ABI functype-id register.
-    wasm::FuncTypeIdDesc funcTypeId = callee.wasmTableSigId();
-    switch (funcTypeId.kind()) {
-      case wasm::FuncTypeIdDescKind::Global:
-        loadWasmGlobalPtr(funcTypeId.globalDataOffset(), WasmTableCallSigReg);
-        break;
-      case wasm::FuncTypeIdDescKind::Immediate:
-        move32(Imm32(funcTypeId.immediate()), WasmTableCallSigReg);
-        break;
-      case wasm::FuncTypeIdDescKind::None:
-        break;
+    // Write the functype-id into the ABI functype-id register. The elements of
+    // uniform tables point at the callees' normal entries, which do not read
+    // it.
+    wasm::TableSigCheck sigCheck = callee.wasmTableSigCheck();
+    if (sigCheck == wasm::TableSigCheck::Dynamic) {
+        wasm::FuncTypeIdDesc funcTypeId = callee.wasmTableSigId();
+        switch (funcTypeId.kind()) {
+          case wasm::FuncTypeIdDescKind::Global:
+            loadWasmGlobalPtr(funcTypeId.globalDataOffset(), WasmTableCallSigReg);
+            break;
+          case wasm::FuncTypeIdDescKind::Immediate:
+            move32(Imm32(funcTypeId.immediate()), WasmTableCallSigReg);
+            break;
+          case wasm::FuncTypeIdDescKind::None:
+            break;
+        }
     }
 
     wasm::BytecodeOffset trapOffset(desc.lineOrBytecode());
@@ -3629,6 +3685,8 @@ MacroAssembler::wasmCallIndirect(const wasm::CallSiteDesc& desc, const wasm::Cal
 
     // Load the callee from the table.
     if (callee.wasmTableIsExternal()) {
+        MOZ_ASSERT(sigCheck == wasm::TableSigCheck::Dynamic);
+
         static_assert(sizeof(wasm::ExternalTableElem) == 8 || sizeof(wasm::ExternalTableElem) == 16,
                       "elements of external tables are two words");
         if (sizeof(wasm::ExternalTableElem) == 8) {
@@ -3656,6 +3714,12 @@ MacroAssembler::wasmCallIndirect(const wasm::CallSiteDesc& desc, const wasm::Cal
         branchTest32(Assembler::NonZero, scratch, scratch, &nonNull);
         wasmTrap(wasm::Trap::IndirectCallToNull, trapOffset);
         bind(&nonNull);
+
+        // Every non-null element of a uniform table has a signature which
+        // differs from the call's.
+        if (sigCheck == wasm::TableSigCheck::StaticFailure) {
+            wasmTrap(wasm::Trap::IndirectCallBadSig, trapOffset);
+        }
     }
 
     call(desc, scratch);
@@ -3783,7 +3847,7 @@ MacroAssembler::emitPreBarrierFastPath(JSRuntime* rt, MIRType type, Register tem
 void
 MacroAssembler::spectreMaskIndex(Register index, Register length, Register output)
 {
-    MOZ_ASSERT(JitOptions.spectreIndexMasking);
+    MOZ_ASSERT(spectre_.indexMasking);
     MOZ_ASSERT(length != output);
     MOZ_ASSERT(index != output);
 
@@ -3794,7 +3858,7 @@ MacroAssembler::spectreMaskIndex(Register index, Register length, Register outpu
 void
 MacroAssembler::spectreMaskIndex(Register index, const Address& length, Register output)
 {
-    MOZ_ASSERT(JitOptions.spectreIndexMasking);
+    MOZ_ASSERT(spectre_.indexMasking);
     MOZ_ASSERT(index != length.base);
     MOZ_ASSERT(length.base != output);
     MOZ_ASSERT(index != output);
@@ -3811,7 +3875,7 @@ MacroAssembler::boundsCheck32PowerOfTwo(Register index, uint32_t length, Label*
 
     // Note: it's fine to clobber the input register, as this is a no-op: it
     // only affects speculative execution.
-    if (JitOptions.spectreIndexMasking) {
+    if (spectre_.indexMasking) {
         and32(Imm32(length - 1), index);
     }
 }
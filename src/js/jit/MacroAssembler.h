@@ -30,9 +30,11 @@
 #else
 # error "Unknown architecture!"
 #endif
+#include "gc/Pretenuring.h"
 #include "jit/AtomicOp.h"
 #include "jit/IonInstrumentation.h"
 #include "jit/IonTypes.h"
+#include "jit/JitOptions.h"
 #include "jit/JitRealm.h"
 #include "jit/TemplateObject.h"
 #include "jit/VMFunctions.h"
@@ -1468,6 +1470,15 @@ class MacroAssembler : public MacroAssemblerSpecific
                                        FloatRegister floatTemp)
         DEFINED_ON(x86, x64);
 
+  public:
+    // ========================================================================
+    // Interrupt polls.
+
+    // Read from |page|, which JSContext::requestInterrupt makes inaccessible.
+    // The fault handler resumes execution at |onInterrupt|, so |onInterrupt|
+    // must expect the same machine state as the poll. Clobbers the flags.
+    void interruptPoll(const void* page, Label* onInterrupt) DEFINED_ON(x64);
+
   public:
     // ========================================================================
     // Convert floating point.
@@ -1498,7 +1509,7 @@ class MacroAssembler : public MacroAssemblerSpecific
     void wasmReserveStackChecked(uint32_t amount, wasm::BytecodeOffset trapOffset);
 
     // Emit a bounds check against the wasm heap limit, jumping to 'label' if
-    // 'cond' holds. If JitOptions.spectreMaskIndex is true, in speculative
+    // 'cond' holds. If Spectre index masking is enabled, in speculative
     // executions 'index' is saturated in-place to 'boundsCheckLimit'.
     void wasmBoundsCheck(Condition cond, Register index, Register boundsCheckLimit, Label* label)
         DEFINED_ON(arm, arm64, mips32, mips64, x86_shared);
@@ -2399,17 +2410,19 @@ class MacroAssembler : public MacroAssemblerSpecific
 
     // Inline allocation.
   private:
-    void checkAllocatorState(Label* fail);
+    void checkAllocatorState(Label* fail, Register temp = InvalidReg);
     bool shouldNurseryAllocate(gc::AllocKind allocKind, gc::InitialHeap initialHeap);
     void nurseryAllocateObject(Register result, Register temp, gc::AllocKind allocKind,
-                               size_t nDynamicSlots, Label* fail);
+                               size_t nDynamicSlots, Label* fail, gc::AllocSite* site);
+    void updateAllocSite(Register result, Register temp, gc::AllocSite* site);
     void bumpPointerAllocate(Register result, Register temp, Label* fail,
         void* posAddr, const void* curEddAddr,
         uint32_t totalSize, uint32_t size);
 
     void freeListAllocate(Register result, Register temp, gc::AllocKind allocKind, Label* fail);
     void allocateObject(Register result, Register temp, gc::AllocKind allocKind,
-                        uint32_t nDynamicSlots, gc::InitialHeap initialHeap, Label* fail);
+                        uint32_t nDynamicSlots, gc::InitialHeap initialHeap, Label* fail,
+                        gc::AllocSite* site = nullptr);
     void nurseryAllocateString(Register result, Register temp, gc::AllocKind allocKind,
                                Label* fail);
     void allocateString(Register result, Register temp, gc::AllocKind allocKind,
@@ -2429,7 +2442,8 @@ class MacroAssembler : public MacroAssemblerSpecific
     void callMallocStub(size_t nbytes, Register result, Label* fail);
     void callFreeStub(Register slots);
     void createGCObject(Register result, Register temp, const TemplateObject& templateObj,
-                        gc::InitialHeap initialHeap, Label* fail, bool initContents = true);
+                        gc::InitialHeap initialHeap, Label* fail, bool initContents = true,
+                        gc::AllocSite* site = nullptr);
 
     void initGCThing(Register obj, Register temp, const TemplateObject& templateObj,
                      bool initContents = true);
@@ -2540,6 +2554,19 @@ class MacroAssembler : public MacroAssemblerSpecific
     // Record locations of the call sites.
     Vector<CodeOffset, 0, SystemAllocPolicy> profilerCallSites_;
 
+  public:
+    // The Spectre mitigations to emit. These are the ones enabled in
+    // JitOptions, unless the code is compiled for a zone with its own.
+    const SpectreMitigations& spectre() const {
+        return spectre_;
+    }
+    void setSpectreMitigations(const SpectreMitigations& spectre) {
+        spectre_ = spectre;
+    }
+
+  private:
+    SpectreMitigations spectre_;
+
   public:
     void loadJitCodeRaw(Register callee, Register dest);
     void loadJitCodeNoArgCheck(Register callee, Register dest);
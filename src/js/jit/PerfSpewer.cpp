@@ -13,6 +13,15 @@
 # include <unistd.h>
 #endif
 
+#if defined(JS_ION_PERF) && defined(__linux__)
+# define JS_ION_PERF_JITDUMP
+# include <elf.h>
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/syscall.h>
+# include <time.h>
+#endif
+
 #ifdef JS_ION_PERF
 # include "jit/JitSpewer.h"
 # include "jit/LIR.h"
@@ -54,6 +63,171 @@ static FILE* PerfFilePtr = nullptr;
 
 static js::Mutex* PerfMutex;
 
+#ifdef JS_ION_PERF_JITDUMP
+
+// When IONPERF_JITDUMP is set, code is also described in the binary jitdump
+// format in a file jit-PID.dump, which unlike the perf map includes the code
+// itself and line information. Use this with
+//
+//   perf record -k mono ...
+//   perf inject --jit -i perf.data -o perf.jit.data
+//
+// The format is documented in tools/perf/Documentation/jitdump-specification.txt
+// in the Linux source tree.
+
+static FILE* JitDumpFilePtr = nullptr;
+static void* JitDumpMarker = nullptr;
+static uint64_t JitDumpCodeIndex = 0;
+
+static const uint32_t JitDumpMagic = 0x4A695444;
+static const uint32_t JitDumpVersion = 1;
+
+enum JitDumpRecordId : uint32_t {
+    JIT_CODE_LOAD = 0,
+    JIT_CODE_DEBUG_INFO = 2
+};
+
+struct JitDumpHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t totalSize;
+    uint32_t elfMach;
+    uint32_t pad1;
+    uint32_t pid;
+    uint64_t timestamp;
+    uint64_t flags;
+};
+
+struct JitDumpRecordHeader {
+    uint32_t id;
+    uint32_t totalSize;
+    uint64_t timestamp;
+};
+
+struct JitDumpCodeLoadRecord {
+    JitDumpRecordHeader header;
+    uint32_t pid;
+    uint32_t tid;
+    uint64_t vma;
+    uint64_t codeAddr;
+    uint64_t codeSize;
+    uint64_t codeIndex;
+    // Followed by the null terminated name and the code.
+};
+
+struct JitDumpDebugInfoRecord {
+    JitDumpRecordHeader header;
+    uint64_t codeAddr;
+    uint64_t numEntries;
+    // Followed by the entries.
+};
+
+struct JitDumpDebugEntry {
+    uint64_t addr;
+    int32_t lineno;
+    int32_t discriminator;
+    // Followed by the null terminated file name.
+};
+
+static uint64_t
+JitDumpTimestamp()
+{
+    // perf has to be told to use the same clock, with -k mono.
+    struct timespec ts;
+    if (clock_gettime(CLOCK_MONOTONIC, &ts)) {
+        return 0;
+    }
+    return uint64_t(ts.tv_sec) * 1000000000 + uint64_t(ts.tv_nsec);
+}
+
+static uint32_t
+JitDumpElfMachine()
+{
+#if defined(JS_CODEGEN_X64)
+    return EM_X86_64;
+#elif defined(JS_CODEGEN_X86)
+    return EM_386;
+#elif defined(JS_CODEGEN_ARM)
+    return EM_ARM;
+#elif defined(JS_CODEGEN_ARM64)
+    return EM_AARCH64;
+#elif defined(JS_CODEGEN_MIPS32) || defined(JS_CODEGEN_MIPS64)
+    return EM_MIPS;
+#else
+    return EM_NONE;
+#endif
+}
+
+static bool
+openJitDump(const char* dir)
+{
+    const ssize_t bufferSize = 256;
+    char filenameBuffer[bufferSize];
+
+    if (snprintf(filenameBuffer, bufferSize, "%sjit-%d.dump", dir, getpid()) >= bufferSize) {
+        return false;
+    }
+
+    int fd = open(filenameBuffer, O_CREAT | O_TRUNC | O_RDWR, 0666);
+    if (fd == -1) {
+        return false;
+    }
+
+    // perf finds the dump through this mapping, which shows up as an mmap
+    // event in the recorded profile.
+    long pageSize = sysconf(_SC_PAGESIZE);
+    JitDumpMarker = mmap(nullptr, pageSize, PROT_READ | PROT_EXEC, MAP_PRIVATE, fd, 0);
+    if (JitDumpMarker == MAP_FAILED) {
+        JitDumpMarker = nullptr;
+        close(fd);
+        return false;
+    }
+
+    MOZ_ASSERT(!JitDumpFilePtr);
+    JitDumpFilePtr = fdopen(fd, "wb");
+    if (!JitDumpFilePtr) {
+        munmap(JitDumpMarker, pageSize);
+        JitDumpMarker = nullptr;
+        close(fd);
+        return false;
+    }
+
+    JitDumpHeader header;
+    header.magic = JitDumpMagic;
+    header.version = JitDumpVersion;
+    header.totalSize = sizeof(header);
+    header.elfMach = JitDumpElfMachine();
+    header.pad1 = 0;
+    header.pid = getpid();
+    header.timestamp = JitDumpTimestamp();
+    header.flags = 0;
+    fwrite(&header, sizeof(header), 1, JitDumpFilePtr);
+    return true;
+}
+
+static void
+WriteJitDumpCodeLoad(uintptr_t address, size_t size, const char* name)
+{
+    size_t nameLength = strlen(name) + 1;
+
+    JitDumpCodeLoadRecord record;
+    record.header.id = JIT_CODE_LOAD;
+    record.header.totalSize = sizeof(record) + nameLength + size;
+    record.header.timestamp = JitDumpTimestamp();
+    record.pid = getpid();
+    record.tid = uint32_t(syscall(SYS_gettid));
+    record.vma = address;
+    record.codeAddr = address;
+    record.codeSize = size;
+    record.codeIndex = JitDumpCodeIndex++;
+
+    fwrite(&record, sizeof(record), 1, JitDumpFilePtr);
+    fwrite(name, nameLength, 1, JitDumpFilePtr);
+    fwrite(reinterpret_cast<const void*>(address), size, 1, JitDumpFilePtr);
+}
+
+#endif // JS_ION_PERF_JITDUMP
+
 static bool
 openPerfMap(const char* dir)
 {
@@ -74,6 +248,20 @@ openPerfMap(const char* dir)
     return true;
 }
 
+static void
+CheckJitDump(const char* dir)
+{
+#ifdef JS_ION_PERF_JITDUMP
+    const char* env = getenv("IONPERF_JITDUMP");
+    if (!env || !strcmp(env, "0")) {
+        return;
+    }
+    if (!openJitDump(dir)) {
+        fprintf(stderr, "Failed to open jitdump file.  Only writing the perf map.\n");
+    }
+#endif
+}
+
 void
 js::jit::CheckPerf() {
     if (!PerfChecked) {
@@ -104,12 +292,14 @@ js::jit::CheckPerf() {
             }
 
             if (openPerfMap(PERF_SPEW_DIR)) {
+                CheckJitDump(PERF_SPEW_DIR);
                 PerfChecked = true;
                 return;
             }
 
 #if defined(__ANDROID__)
             if (openPerfMap(PERF_SPEW_DIR_2)) {
+                CheckJitDump(PERF_SPEW_DIR_2);
                 PerfChecked = true;
                 return;
             }
@@ -146,6 +336,11 @@ namespace {
         ~AutoLockPerfMap() {
             MOZ_ASSERT(PerfFilePtr);
             fflush(PerfFilePtr);
+#ifdef JS_ION_PERF_JITDUMP
+            if (JitDumpFilePtr) {
+                fflush(JitDumpFilePtr);
+            }
+#endif
             PerfMutex->unlock();
         }
     };
@@ -208,6 +403,45 @@ PerfSpewer::WriteEntry(const AutoLockPerfMap&, uintptr_t address, size_t size,
             address,
             size,
             result.get());
+
+#ifdef JS_ION_PERF_JITDUMP
+    if (JitDumpFilePtr && result) {
+        WriteJitDumpCodeLoad(address, size, result.get());
+    }
+#endif
+}
+
+void
+PerfSpewer::WriteDebugInfo(const AutoLockPerfMap&, uintptr_t address,
+                           const char* filename, unsigned lineNumber)
+{
+#ifdef JS_ION_PERF_JITDUMP
+    // The line information for some code must come before the code itself.
+    if (!JitDumpFilePtr) {
+        return;
+    }
+
+    if (!filename) {
+        filename = "<unknown>";
+    }
+    size_t filenameLength = strlen(filename) + 1;
+
+    JitDumpDebugInfoRecord record;
+    record.header.id = JIT_CODE_DEBUG_INFO;
+    record.header.totalSize = sizeof(record) + sizeof(JitDumpDebugEntry) + filenameLength;
+    record.header.timestamp = JitDumpTimestamp();
+    record.codeAddr = address;
+    record.numEntries = 1;
+
+    JitDumpDebugEntry entry;
+    entry.addr = address;
+    entry.lineno = int32_t(lineNumber);
+    entry.discriminator = 0;
+
+    fwrite(&record, sizeof(record), 1, JitDumpFilePtr);
+    fwrite(&entry, sizeof(entry), 1, JitDumpFilePtr);
+    fwrite(filename, filenameLength, 1, JitDumpFilePtr);
+#endif
 }
 
 void
@@ -221,6 +455,8 @@ PerfSpewer::writeProfile(JSScript* script,
         uint32_t thisFunctionIndex = nextFunctionIndex++;
         size_t size = code->instructionsSize();
         if (size > 0) {
+            WriteDebugInfo(lock, reinterpret_cast<uintptr_t>(code->raw()),
+                           script->filename(), script->lineno());
             WriteEntry(lock, reinterpret_cast<uintptr_t>(code->raw()), size, "%s:%u: Func%02" PRIu32,
                        script->filename(), script->lineno(), thisFunctionIndex);
         }
@@ -258,6 +494,7 @@ PerfSpewer::writeProfile(JSScript* script,
             size_t size = blockEnd - blockStart;
 
             if (size > 0) {
+                WriteDebugInfo(lock, blockStart, r.filename, r.lineNumber);
                 WriteEntry(lock, blockStart, size, "%s:%u:%u: Func%02" PRIu32 "d-Block%" PRIu32,
                            r.filename, r.lineNumber, r.columnNumber, thisFunctionIndex, r.id);
             }
@@ -288,6 +525,8 @@ js::jit::writePerfSpewerBaselineProfile(JSScript* script, JitCode* code)
     size_t size = code->instructionsSize();
     if (size > 0) {
         AutoLockPerfMap lock;
+        PerfSpewer::WriteDebugInfo(lock, reinterpret_cast<uintptr_t>(code->raw()),
+                                   script->filename(), script->lineno());
         PerfSpewer::WriteEntry(lock, reinterpret_cast<uintptr_t>(code->raw()), size,
                                "%s:%u: Baseline", script->filename(), script->lineno());
     }
@@ -330,6 +569,7 @@ js::jit::writePerfSpewerWasmFunctionMap(uintptr_t base, uintptr_t size,
     }
 
     AutoLockPerfMap lock;
+    PerfSpewer::WriteDebugInfo(lock, base, filename, lineno);
     PerfSpewer::WriteEntry(lock, base, size, "%s:%u: Function %s", filename, lineno, funcName);
 }
 
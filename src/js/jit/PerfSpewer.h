@@ -79,6 +79,11 @@ class PerfSpewer
     static void WriteEntry(const AutoLockPerfMap&, uintptr_t address, size_t size,
                            const char* fmt, ...)
         MOZ_FORMAT_PRINTF(4, 5);
+
+    // Describe the source location of the code at address, for the entry
+    // written next at that address. Only used for jitdump output.
+    static void WriteDebugInfo(const AutoLockPerfMap&, uintptr_t address,
+                               const char* filename, unsigned lineNumber);
 };
 
 void writePerfSpewerBaselineProfile(JSScript* script, JitCode* code);
@@ -9,6 +9,8 @@
 #include "mozilla/Array.h"
 #include "mozilla/Atomics.h"
 #include "mozilla/DebugOnly.h"
+#include "mozilla/EnumeratedArray.h"
+#include "mozilla/EnumeratedRange.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/TaggedAnonymousMemory.h"
 #include "mozilla/XorShift128PlusRNG.h"
@@ -276,6 +278,13 @@ DecommitPages(void* addr, size_t bytes)
         MOZ_CRASH("DecommitPages failed");
     }
 }
+
+static void
+AdviseHugePages(void* addr, size_t bytes)
+{
+    // Large pages on Windows need the SeLockMemoryPrivilege and can't be
+    // committed in parts of a reservation, so we don't use them.
+}
 #else // !XP_WIN
 static void*
 ComputeRandomAllocationAddress()
@@ -296,8 +305,9 @@ ComputeRandomAllocationAddress()
     rand += 512 * 1024 * 1024;
 # endif
 
-    // Ensure page alignment.
-    uintptr_t mask = ~uintptr_t(gc::SystemPageSize() - 1);
+    // Align to huge pages, so that the hot arena at the start of the region
+    // can be backed by them.
+    uintptr_t mask = ~uintptr_t(HugeCodePageSize - 1);
     return (void*) uintptr_t(rand & mask);
 }
 
@@ -372,6 +382,18 @@ DecommitPages(void* addr, size_t bytes)
                                      -1, 0, "js-executable-memory");
     MOZ_RELEASE_ASSERT(addr == p);
 }
+
+static void
+AdviseHugePages(void* addr, size_t bytes)
+{
+#ifdef MADV_HUGEPAGE
+    // Committing pages replaces their mapping, so this has to be done after
+    // every commit. It's only advice: whether the kernel uses transparent huge
+    // pages depends on its configuration, and on the 2MB-aligned ranges of the
+    // mapping being committed with the same protection.
+    madvise(addr, bytes, MADV_HUGEPAGE);
+#endif
+}
 #endif
 
 template <size_t NumBits>
@@ -460,8 +482,8 @@ class ProcessExecutableMemory
     mozilla::Atomic<size_t, mozilla::ReleaseAcquire,
                     mozilla::recordreplay::Behavior::DontPreserve> pagesAllocated_;
 
-    // Page where we should try to allocate next.
-    size_t cursor_;
+    // Page in each arena where we should try to allocate next.
+    mozilla::EnumeratedArray<CodeArena, CodeArena::Count, size_t> cursors_;
 
     mozilla::Maybe<mozilla::non_crypto::XorShift128PlusRNG> rng_;
     PageBitSet<MaxCodePages> pages_;
@@ -471,10 +493,41 @@ class ProcessExecutableMemory
       : base_(nullptr),
         lock_(mutexid::ProcessExecutableRegion),
         pagesAllocated_(0),
-        cursor_(0),
+        cursors_(),
         rng_(),
         pages_()
-    {}
+    {
+        for (CodeArena arena : mozilla::MakeEnumeratedRange(CodeArena::Count)) {
+            cursors_[arena] = arenaFirstPage(arena);
+        }
+    }
+
+    // The hot and stub arenas take an eighth of the region each, and the cold
+    // arena the rest.
+    static size_t arenaFirstPage(CodeArena arena) {
+        switch (arena) {
+          case CodeArena::Hot:   return 0;
+          case CodeArena::Stubs: return MaxCodePages / 8;
+          case CodeArena::Cold:  return MaxCodePages / 4;
+          case CodeArena::Count: break;
+        }
+        MOZ_CRASH("Invalid arena");
+    }
+    static size_t arenaLimitPage(CodeArena arena) {
+        switch (arena) {
+          case CodeArena::Hot:   return MaxCodePages / 8;
+          case CodeArena::Stubs: return MaxCodePages / 4;
+          case CodeArena::Cold:  return MaxCodePages;
+          case CodeArena::Count: break;
+        }
+        MOZ_CRASH("Invalid arena");
+    }
+
+    static const size_t NoFreePages = size_t(-1);
+
+    // Returns the first of |numPages| free pages in [first, limit), searching
+    // from |page| and wrapping around, or NoFreePages. Must hold the lock.
+    size_t findFreePages(size_t page, size_t first, size_t limit, size_t numPages) const;
 
     MOZ_MUST_USE bool init() {
         pages_.init();
@@ -519,13 +572,43 @@ class ProcessExecutableMemory
                            uintptr_t(p) + bytes <= uintptr_t(base_) + MaxCodeBytesPerProcess);
     }
 
-    void* allocate(size_t bytes, ProtectionSetting protection, MemCheckKind checkKind);
+    void* allocate(size_t bytes, ProtectionSetting protection, MemCheckKind checkKind,
+                   CodeArena arena);
     void deallocate(void* addr, size_t bytes, bool decommit);
 };
 
+size_t
+ProcessExecutableMemory::findFreePages(size_t page, size_t first, size_t limit,
+                                       size_t numPages) const
+{
+    if (numPages > limit - first) {
+        return NoFreePages;
+    }
+
+    for (size_t i = first; i < limit; i++) {
+        // Make sure page + numPages - 1 is a valid index.
+        if (page < first || page + numPages > limit) {
+            page = first;
+        }
+
+        bool available = true;
+        for (size_t j = 0; j < numPages; j++) {
+            if (pages_.contains(page + j)) {
+                available = false;
+                break;
+            }
+        }
+        if (available) {
+            return page;
+        }
+        page++;
+    }
+    return NoFreePages;
+}
+
 void*
 ProcessExecutableMemory::allocate(size_t bytes, ProtectionSetting protection,
-                                  MemCheckKind checkKind)
+                                  MemCheckKind checkKind, CodeArena arena)
 {
     MOZ_ASSERT(initialized());
     MOZ_ASSERT(bytes > 0);
@@ -546,48 +629,38 @@ ProcessExecutableMemory::allocate(size_t bytes, ProtectionSetting protection,
 
         MOZ_ASSERT(bytes <= MaxCodeBytesPerProcess);
 
-        // Maybe skip a page to make allocations less predictable.
-        size_t page = cursor_ + (rng_.ref().next() % 2);
-
-        for (size_t i = 0; i < MaxCodePages; i++) {
-            // Make sure page + numPages - 1 is a valid index.
-            if (page + numPages > MaxCodePages) {
-                page = 0;
-            }
-
-            bool available = true;
-            for (size_t j = 0; j < numPages; j++) {
-                if (pages_.contains(page + j)) {
-                    available = false;
-                    break;
-                }
-            }
-            if (!available) {
-                page++;
-                continue;
-            }
+        size_t first = arenaFirstPage(arena);
+        size_t limit = arenaLimitPage(arena);
 
-            // Mark the pages as unavailable.
-            for (size_t j = 0; j < numPages; j++) {
-                pages_.insert(page + j);
+        // Maybe skip a page to make allocations less predictable.
+        size_t start = cursors_[arena] + (rng_.ref().next() % 2);
+
+        size_t page = findFreePages(start, first, limit, numPages);
+        bool inArena = page != NoFreePages;
+        if (!inArena) {
+            // The arena is full, so use any free pages in the region.
+            page = findFreePages(start, 0, MaxCodePages, numPages);
+            if (page == NoFreePages) {
+                return nullptr;
             }
+        }
 
-            pagesAllocated_ += numPages;
-            MOZ_ASSERT(pagesAllocated_ <= MaxCodePages);
+        // Mark the pages as unavailable.
+        for (size_t j = 0; j < numPages; j++) {
+            pages_.insert(page + j);
+        }
 
-            // If we allocated a small number of pages, move cursor_ to the
-            // next page. We don't do this for larger allocations to avoid
-            // skipping a large number of small holes.
-            if (numPages <= 2) {
-                cursor_ = page + numPages;
-            }
+        pagesAllocated_ += numPages;
+        MOZ_ASSERT(pagesAllocated_ <= MaxCodePages);
 
-            p = base_ + page * ExecutableCodePageSize;
-            break;
-        }
-        if (!p) {
-            return nullptr;
+        // If we allocated a small number of pages, move the arena's cursor to
+        // the next page. We don't do this for larger allocations to avoid
+        // skipping a large number of small holes.
+        if (inArena && numPages <= 2) {
+            cursors_[arena] = page + numPages;
         }
+
+        p = base_ + page * ExecutableCodePageSize;
     }
 
     // Commit the pages after releasing the lock.
@@ -596,6 +669,10 @@ ProcessExecutableMemory::allocate(size_t bytes, ProtectionSetting protection,
         return nullptr;
     }
 
+    if (arena == CodeArena::Hot) {
+        AdviseHugePages(p, bytes);
+    }
+
     SetMemCheckKind(p, bytes, checkKind);
 
     return p;
@@ -629,19 +706,25 @@ ProcessExecutableMemory::deallocate(void* addr, size_t bytes, bool decommit)
         pages_.remove(firstPage + i);
     }
 
-    // Move the cursor back so we can reuse pages instead of fragmenting the
-    // whole region.
-    if (firstPage < cursor_) {
-        cursor_ = firstPage;
+    // Move the cursor of the arena back so we can reuse pages instead of
+    // fragmenting the whole region.
+    for (CodeArena arena : mozilla::MakeEnumeratedRange(CodeArena::Count)) {
+        if (firstPage >= arenaFirstPage(arena) && firstPage < arenaLimitPage(arena)) {
+            if (firstPage < cursors_[arena]) {
+                cursors_[arena] = firstPage;
+            }
+            break;
+        }
     }
 }
 
 static ProcessExecutableMemory execMemory;
 
 void*
-js::jit::AllocateExecutableMemory(size_t bytes, ProtectionSetting protection, MemCheckKind checkKind)
+js::jit::AllocateExecutableMemory(size_t bytes, ProtectionSetting protection, MemCheckKind checkKind,
+                                  CodeArena arena)
 {
-    return execMemory.allocate(bytes, protection, checkKind);
+    return execMemory.allocate(bytes, protection, checkKind, arena);
 }
 
 void
@@ -650,6 +733,30 @@ js::jit::DeallocateExecutableMemory(void* addr, size_t bytes)
     execMemory.deallocate(addr, bytes, /* decommit = */ true);
 }
 
+bool
+js::jit::MapFileIntoExecutableMemory(void* addr, size_t bytes, int fd, size_t offset)
+{
+    MOZ_ASSERT((uintptr_t(addr) % gc::SystemPageSize()) == 0);
+    MOZ_ASSERT((offset % gc::SystemPageSize()) == 0);
+    execMemory.assertValidAddress(addr, bytes);
+
+#ifdef XP_WIN
+    // Views of a file cannot replace part of a VirtualAlloc reservation.
+    return false;
+#else
+    void* p = mmap(addr, bytes, PROT_READ | PROT_WRITE, MAP_FIXED | MAP_PRIVATE, fd, off_t(offset));
+    if (p == MAP_FAILED) {
+        // A failed MAP_FIXED mapping may have discarded the old pages.
+        if (!CommitPages(addr, bytes, ProtectionSetting::Writable)) {
+            MOZ_CRASH("MapFileIntoExecutableMemory failed");
+        }
+        return false;
+    }
+    MOZ_RELEASE_ASSERT(p == addr);
+    return true;
+#endif
+}
+
 bool
 js::jit::InitProcessExecutableMemory()
 {
@@ -27,6 +27,21 @@ static const size_t MaxCodeBytesPerProcess = 1 * 1024 * 1024 * 1024;
 // alignment though.
 static const size_t ExecutableCodePageSize = 64 * 1024;
 
+// Size of the huge pages which may back the hot arena, where the OS supports
+// them.
+static const size_t HugeCodePageSize = 2 * 1024 * 1024;
+
+// The executable memory region is split into arenas, so that code which runs
+// often is packed together and needs few TLB entries, instead of being
+// interleaved with code which is mostly cold. An arena which is full spills
+// into the rest of the region.
+enum class CodeArena {
+    Hot,    // Ion and regexp code. Backed by huge pages where available.
+    Stubs,  // IC stubs, trampolines and other shared code.
+    Cold,   // Baseline and wasm code.
+    Count
+};
+
 enum class ProtectionSetting {
     Protected, // Not readable, writable, or executable.
     Writable,
@@ -42,9 +57,18 @@ extern void ReleaseProcessExecutableMemory();
 
 // Allocate/deallocate executable pages.
 extern void* AllocateExecutableMemory(size_t bytes, ProtectionSetting protection,
-                                      MemCheckKind checkKind);
+                                      MemCheckKind checkKind,
+                                      CodeArena arena = CodeArena::Cold);
 extern void DeallocateExecutableMemory(void* addr, size_t bytes);
 
+// Replace |bytes| bytes of writable executable memory at |addr|, returned by
+// AllocateExecutableMemory, with a private copy-on-write mapping of the file
+// |fd| at |offset|. Both |addr| and |offset| must be page aligned. The pages
+// are deallocated as usual. Returns false if the file could not be mapped, in
+// which case the pages are writable but their contents are undefined.
+extern MOZ_MUST_USE bool MapFileIntoExecutableMemory(void* addr, size_t bytes, int fd,
+                                                     size_t offset);
+
 // Returns true if we can allocate a few more MB of executable code without
 // hitting our code limit. This function can be used to stop compiling things
 // that are optional (like Baseline and Ion code) when we're about to reach the
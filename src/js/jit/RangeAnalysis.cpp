@@ -1876,6 +1876,7 @@ GetTypedArrayRange(TempAllocator& alloc, Scalar::Type type)
       case Scalar::Int64:
       case Scalar::Float32:
       case Scalar::Float64:
+      case Scalar::Simd128:
       case Scalar::MaxTypedArrayViewType:
         break;
     }
@@ -602,6 +602,41 @@ RConcat::recover(JSContext* cx, SnapshotIterator& iter) const
     return true;
 }
 
+bool
+MConcatN::writeRecoverData(CompactBufferWriter& writer) const
+{
+    MOZ_ASSERT(canRecoverOnBailout());
+    writer.writeUnsigned(uint32_t(RInstruction::Recover_ConcatN));
+    writer.writeUnsigned(uint32_t(numOperands()));
+    return true;
+}
+
+RConcatN::RConcatN(CompactBufferReader& reader)
+  : numOperands_(reader.readUnsigned())
+{ }
+
+bool
+RConcatN::recover(JSContext* cx, SnapshotIterator& iter) const
+{
+    Rooted<StringVector> parts(cx, StringVector(cx));
+    if (!parts.reserve(numOperands_)) {
+        return false;
+    }
+
+    for (uint32_t i = 0; i < numOperands_; i++) {
+        parts.infallibleAppend(iter.read().toString());
+    }
+
+    JSString* str = ConcatStringsN(cx, parts);
+    if (!str) {
+        return false;
+    }
+
+    RootedValue result(cx, StringValue(str));
+    iter.storeInstructionResult(result);
+    return true;
+}
+
 RStringLength::RStringLength(CompactBufferReader& reader)
 {}
 
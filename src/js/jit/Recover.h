@@ -73,6 +73,7 @@ namespace jit {
     _(Mod)                                      \
     _(Not)                                      \
     _(Concat)                                   \
+    _(ConcatN)                                  \
     _(StringLength)                             \
     _(ArgumentsLength)                          \
     _(Floor)                                    \
@@ -343,6 +344,21 @@ class RConcat final : public RInstruction
     MOZ_MUST_USE bool recover(JSContext* cx, SnapshotIterator& iter) const override;
 };
 
+class RConcatN final : public RInstruction
+{
+  private:
+    uint32_t numOperands_;
+
+  public:
+    RINSTRUCTION_HEADER_(ConcatN)
+
+    uint32_t numOperands() const override {
+        return numOperands_;
+    }
+
+    MOZ_MUST_USE bool recover(JSContext* cx, SnapshotIterator& iter) const override;
+};
+
 class RStringLength final : public RInstruction
 {
   public:
@@ -6,6 +6,8 @@
 
 #include "jit/Snapshots.h"
 
+#include "mozilla/HashFunctions.h"
+
 #include "jit/CompileInfo.h"
 #include "jit/JitSpewer.h"
 #ifdef TRACK_SNAPSHOTS
@@ -554,6 +556,34 @@ SnapshotReader::readAllocation()
     return RValueAllocation::read(allocReader_);
 }
 
+uint32_t
+CompactBufferEntryTable::deduplicate(CompactBufferWriter& writer, uint32_t start)
+{
+    if (writer.oom()) {
+        return start;
+    }
+
+    uint32_t length = writer.length() - start;
+    const uint8_t* bytes = writer.buffer() + start;
+    HashNumber hash = mozilla::HashBytes(bytes, length);
+
+    EntryMap::AddPtr p = entries_.lookupForAdd(hash);
+    if (p) {
+        Entry& entry = p->value();
+        if (entry.length == length && memcmp(writer.buffer() + entry.offset, bytes, length) == 0) {
+            writer.shrinkTo(start);
+            return entry.offset;
+        }
+        entry.offset = start;
+        entry.length = length;
+        return start;
+    }
+
+    // Ignore OOM, we only fail to share this entry with later ones.
+    (void) entries_.add(p, hash, Entry { start, length });
+    return start;
+}
+
 SnapshotWriter::SnapshotWriter()
     // Based on the measurements made in Bug 962555 comment 20, this length
     // should be enough to prevent the reallocation of the hash table for at
@@ -681,7 +711,7 @@ SnapshotWriter::add(const RValueAllocation& alloc)
     return true;
 }
 
-void
+SnapshotOffset
 SnapshotWriter::endSnapshot()
 {
     // Place a sentinel for asserting on the other end.
@@ -691,6 +721,12 @@ SnapshotWriter::endSnapshot()
 
     JitSpew(JitSpew_IonSnapshots, "ending snapshot total size: %u bytes (start %u)",
             uint32_t(writer_.length() - lastStart_), lastStart_);
+
+    SnapshotOffset offset = snapshots_.deduplicate(writer_, lastStart_);
+    if (offset != lastStart_) {
+        JitSpew(JitSpew_IonSnapshots, "sharing snapshot at offset %u", offset);
+    }
+    return offset;
 }
 
 RecoverOffset
@@ -709,9 +745,9 @@ RecoverWriter::startRecover(uint32_t instructionCount, bool resumeAfter)
         (uint32_t(resumeAfter) << RECOVER_RESUMEAFTER_SHIFT) |
         (instructionCount << RECOVER_RINSCOUNT_SHIFT);
 
-    RecoverOffset recoverOffset = writer_.length();
+    lastStart_ = writer_.length();
     writer_.writeUnsigned(bits);
-    return recoverOffset;
+    return lastStart_;
 }
 
 void
@@ -723,8 +759,14 @@ RecoverWriter::writeInstruction(const MNode* rp)
     instructionsWritten_++;
 }
 
-void
+RecoverOffset
 RecoverWriter::endRecover()
 {
     MOZ_ASSERT(instructionCount_ == instructionsWritten_);
+
+    RecoverOffset offset = recovers_.deduplicate(writer_, lastStart_);
+    if (offset != lastStart_) {
+        JitSpew(JitSpew_IonSnapshots, "sharing recover instructions at offset %u", offset);
+    }
+    return offset;
 }
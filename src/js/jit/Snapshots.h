@@ -382,10 +382,35 @@ class RecoverWriter;
 
 // Collects snapshots in a contiguous buffer, which is copied into IonScript
 // memory after code generation.
+// Table of the entries written to a CompactBufferWriter, used to share a
+// single copy of the entries with identical encodings. Snapshots and recover
+// instructions are frequently repeated, for example for all the guards which
+// bail out to the same resume point with the same register allocation.
+class CompactBufferEntryTable
+{
+    struct Entry
+    {
+        uint32_t offset;
+        uint32_t length;
+    };
+
+    // Entries are keyed by the hash of their encoding. When two entries have
+    // the same hash but different encodings, only the last one is kept.
+    typedef HashMap<HashNumber, Entry, DefaultHasher<HashNumber>, SystemAllocPolicy> EntryMap;
+    EntryMap entries_;
+
+  public:
+    // Given the entry written at |start|, up to the end of |writer|, return
+    // the offset of an earlier entry with the same encoding and remove the new
+    // one from |writer|, or return |start| if there is no such entry.
+    uint32_t deduplicate(CompactBufferWriter& writer, uint32_t start);
+};
+
 class SnapshotWriter
 {
     CompactBufferWriter writer_;
     CompactBufferWriter allocWriter_;
+    CompactBufferEntryTable snapshots_;
 
     // Map RValueAllocations to an offset in the allocWriter_ buffer.  This is
     // useful as value allocations are repeated frequently.
@@ -412,7 +437,10 @@ class SnapshotWriter
     uint32_t allocWritten() const {
         return allocWritten_;
     }
-    void endSnapshot();
+
+    // Return the offset of the snapshot, which may differ from the one
+    // returned by startSnapshot if the same snapshot was already written.
+    SnapshotOffset endSnapshot();
 
     bool oom() const {
         return writer_.oom() || writer_.length() >= MAX_BUFFER_SIZE ||
@@ -439,16 +467,21 @@ class MNode;
 class RecoverWriter
 {
     CompactBufferWriter writer_;
+    CompactBufferEntryTable recovers_;
 
     uint32_t instructionCount_;
     uint32_t instructionsWritten_;
 
+    RecoverOffset lastStart_;
+
   public:
-    SnapshotOffset startRecover(uint32_t instructionCount, bool resumeAfter);
+    RecoverOffset startRecover(uint32_t instructionCount, bool resumeAfter);
 
     void writeInstruction(const MNode* rp);
 
-    void endRecover();
+    // As for SnapshotWriter::endSnapshot, return the final offset of the
+    // recover instructions.
+    RecoverOffset endRecover();
 
     size_t size() const {
         return writer_.length();
@@ -1035,6 +1035,17 @@ StoreTypedArrayHolePolicy::adjustInputs(TempAllocator& alloc, MInstruction* ins)
     return StoreUnboxedScalarPolicy::adjustValueInput(alloc, ins, store->arrayType(), store->value(), 3);
 }
 
+bool
+StoreDataViewElementPolicy::adjustInputs(TempAllocator& alloc, MInstruction* ins) const
+{
+    MStoreDataViewElement* store = ins->toStoreDataViewElement();
+    MOZ_ASSERT(store->elements()->type() == MIRType::Elements);
+    MOZ_ASSERT(store->index()->type() == MIRType::Int32);
+
+    return StoreUnboxedScalarPolicy::adjustValueInput(alloc, ins, store->writeType(),
+                                                      store->value(), 2);
+}
+
 bool
 StoreUnboxedObjectOrNullPolicy::adjustInputs(TempAllocator& alloc, MInstruction* ins) const
 {
@@ -1222,6 +1233,7 @@ FilterTypeSetPolicy::adjustInputs(TempAllocator& alloc, MInstruction* ins) const
     _(PowPolicy)                                \
     _(SameValuePolicy)                          \
     _(SignPolicy)                               \
+    _(StoreDataViewElementPolicy)               \
     _(StoreTypedArrayHolePolicy)                \
     _(StoreUnboxedScalarPolicy)                 \
     _(StoreUnboxedObjectOrNullPolicy)           \
@@ -448,6 +448,7 @@ class InstanceOfPolicy final : public TypePolicy
 };
 
 class StoreTypedArrayHolePolicy;
+class StoreDataViewElementPolicy;
 
 class StoreUnboxedScalarPolicy : public TypePolicy
 {
@@ -458,6 +459,7 @@ class StoreUnboxedScalarPolicy : public TypePolicy
                                               int valueOperand);
 
     friend class StoreTypedArrayHolePolicy;
+    friend class StoreDataViewElementPolicy;
 
   public:
     EMPTY_DATA_;
@@ -472,6 +474,14 @@ class StoreTypedArrayHolePolicy final : public StoreUnboxedScalarPolicy
     MOZ_MUST_USE bool adjustInputs(TempAllocator& alloc, MInstruction* ins) const override;
 };
 
+class StoreDataViewElementPolicy final : public StoreUnboxedScalarPolicy
+{
+  public:
+    constexpr StoreDataViewElementPolicy() { }
+    EMPTY_DATA_;
+    MOZ_MUST_USE bool adjustInputs(TempAllocator& alloc, MInstruction* ins) const override;
+};
+
 class StoreUnboxedObjectOrNullPolicy final : public TypePolicy
 {
   public:
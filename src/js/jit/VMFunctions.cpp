@@ -15,6 +15,7 @@
 #include "jit/JitRealm.h"
 #include "jit/mips32/Simulator-mips32.h"
 #include "jit/mips64/Simulator-mips64.h"
+#include "proxy/ScriptedProxyHandler.h"
 #include "vm/ArrayObject.h"
 #include "vm/Debugger.h"
 #include "vm/Interpreter.h"
@@ -556,6 +557,14 @@ InterruptCheck(JSContext* cx)
 {
     gc::MaybeVerifyBarriers(cx);
 
+    // An interrupt poll can fault after the interrupt it was requested for
+    // has already been handled, if requestInterrupt protected the poll page
+    // after handleInterrupt had reset it. Reset it again, or every poll would
+    // fault until the next interrupt.
+    if (!cx->hasAnyPendingInterrupt()) {
+        cx->resetInterruptPoll();
+    }
+
     return CheckForInterrupt(cx);
 }
 
@@ -1630,6 +1639,27 @@ CheckIsCallable(JSContext* cx, HandleValue v, CheckIsCallableKind kind)
     return true;
 }
 
+static MOZ_ALWAYS_INLINE NativeObject*
+MegamorphicCacheHolder(NativeObject* obj, const MegamorphicCache::Entry* entry)
+{
+    if (!entry->numHops) {
+        return obj;
+    }
+
+    for (uint16_t i = 0; i < entry->numHops; i++) {
+        JSObject* proto = obj->staticPrototype();
+        if (!proto || !proto->isNative()) {
+            return nullptr;
+        }
+        obj = &proto->as<NativeObject>();
+    }
+
+    if (obj->lastProperty() != entry->holderShape) {
+        return nullptr;
+    }
+    return obj;
+}
+
 template <bool HandleMissing>
 static MOZ_ALWAYS_INLINE bool
 GetNativeDataPropertyPure(JSContext* cx, NativeObject* obj, jsid id, Value* vp)
@@ -1642,12 +1672,36 @@ GetNativeDataPropertyPure(JSContext* cx, NativeObject* obj, jsid id, Value* vp)
 
     MOZ_ASSERT(JSID_IS_ATOM(id) || JSID_IS_SYMBOL(id));
 
+    MegamorphicCache& cache = cx->caches().megamorphicCache;
+    MegamorphicCache::Entry* entry;
+    Shape* receiverShape = obj->lastProperty();
+    ObjectGroup* receiverGroup = obj->groupRaw();
+    if (cache.lookup(receiverShape, receiverGroup, id, &entry)) {
+        if (NativeObject* holder = MegamorphicCacheHolder(obj, entry)) {
+            *vp = holder->getSlot(entry->slot);
+            return true;
+        }
+    }
+
+    // Results found on a prototype can only be cached if no object on the
+    // way has an uncacheable prototype, see MegamorphicCache.
+    bool cacheable = true;
+    uint16_t numHops = 0;
+
     while (true) {
         if (Shape* shape = obj->lastProperty()->search(cx, id)) {
             if (!shape->isDataProperty()) {
                 return false;
             }
 
+            if (!numHops) {
+                cache.fill(entry, receiverShape, receiverGroup, id, nullptr, shape->slot(), 0,
+                           shape->writable());
+            } else if (cacheable && !obj->hasUncacheableProto()) {
+                cache.fill(entry, receiverShape, receiverGroup, id, obj->lastProperty(),
+                           shape->slot(), numHops, false);
+            }
+
             *vp = obj->getSlot(shape->slot());
             return true;
         }
@@ -1671,6 +1725,12 @@ GetNativeDataPropertyPure(JSContext* cx, NativeObject* obj, jsid id, Value* vp)
         if (!proto->isNative()) {
             return false;
         }
+
+        if (obj->hasUncacheableProto() || numHops == UINT16_MAX) {
+            cacheable = false;
+        } else {
+            numHops++;
+        }
         obj = &proto->as<NativeObject>();
     }
 }
@@ -1761,19 +1821,31 @@ SetNativeDataPropertyPure(JSContext* cx, JSObject* obj, PropertyName* name, Valu
     }
 
     NativeObject* nobj = &obj->as<NativeObject>();
-    Shape* shape = nobj->lastProperty()->search(cx, NameToId(name));
-    if (!shape ||
-        !shape->isDataProperty() ||
-        !shape->writable())
-    {
-        return false;
+    jsid id = NameToId(name);
+
+    MegamorphicCache& cache = cx->caches().megamorphicCache;
+    MegamorphicCache::Entry* entry;
+    uint32_t slot;
+    if (cache.lookup(nobj->lastProperty(), nobj->groupRaw(), id, &entry) && entry->writable) {
+        slot = entry->slot;
+    } else {
+        Shape* shape = nobj->lastProperty()->search(cx, id);
+        if (!shape ||
+            !shape->isDataProperty() ||
+            !shape->writable())
+        {
+            return false;
+        }
+
+        slot = shape->slot();
+        cache.fill(entry, nobj->lastProperty(), nobj->groupRaw(), id, nullptr, slot, 0, true);
     }
 
-    if (NeedsTypeBarrier && !HasTypePropertyId(nobj, NameToId(name), *val)) {
+    if (NeedsTypeBarrier && !HasTypePropertyId(nobj, id, *val)) {
         return false;
     }
 
-    nobj->setSlot(shape->slot(), *val);
+    nobj->setSlot(slot, *val);
     return true;
 }
 
@@ -1969,6 +2041,22 @@ typedef JSString* (*ConcatStringsFn)(JSContext*, HandleString, HandleString);
 const VMFunction ConcatStringsInfo =
     FunctionInfo<ConcatStringsFn>(ConcatStrings<CanGC>, "ConcatStrings");
 
+static JSString*
+ConcatStringParts(JSContext* cx, JSString** parts, uint32_t numParts)
+{
+    // |parts| points to the JIT stack, which is not traced. Root the parts
+    // before anything can GC.
+    Rooted<StringVector> vec(cx, StringVector(cx));
+    if (!vec.append(parts, numParts)) {
+        return nullptr;
+    }
+    return ConcatStringsN(cx, vec);
+}
+
+typedef JSString* (*ConcatStringPartsFn)(JSContext*, JSString**, uint32_t);
+const VMFunction ConcatStringPartsInfo =
+    FunctionInfo<ConcatStringPartsFn>(ConcatStringParts, "ConcatStringParts");
+
 static JSString*
 ConvertObjectToStringForConcat(JSContext* cx, HandleValue obj)
 {
@@ -2045,10 +2133,27 @@ TrySkipAwait(JSContext* cx, HandleValue val, MutableHandleValue resolved)
     return true;
 }
 
+bool
+CheckProxyGetResult(JSContext* cx, HandleObject target, HandleId id, HandleValue trapResult,
+                    MutableHandleValue vp)
+{
+    if (!ScriptedProxyHandler::checkGetTrapResult(cx, target, id, trapResult)) {
+        return false;
+    }
+
+    vp.set(trapResult);
+    return true;
+}
+
 typedef bool (*ProxyGetPropertyFn)(JSContext*, HandleObject, HandleId, MutableHandleValue);
 const VMFunction ProxyGetPropertyInfo =
     FunctionInfo<ProxyGetPropertyFn>(ProxyGetProperty, "ProxyGetProperty");
 
+typedef bool (*CheckProxyGetResultFn)(JSContext*, HandleObject, HandleId, HandleValue,
+                                      MutableHandleValue);
+const VMFunction CheckProxyGetResultInfo =
+    FunctionInfo<CheckProxyGetResultFn>(CheckProxyGetResult, "CheckProxyGetResult");
+
 typedef bool (*ProxyGetPropertyByValueFn)(JSContext*, HandleObject, HandleValue, MutableHandleValue);
 const VMFunction ProxyGetPropertyByValueInfo =
     FunctionInfo<ProxyGetPropertyByValueFn>(ProxyGetPropertyByValue, "ProxyGetPropertyByValue");
@@ -964,6 +964,11 @@ DoConcatStringObject(JSContext* cx, HandleValue lhs, HandleValue rhs,
 MOZ_MUST_USE bool
 TrySkipAwait(JSContext* cx, HandleValue val, MutableHandleValue resolved);
 
+// Check the result of a scripted proxy's get trap the JITs called directly.
+MOZ_MUST_USE bool
+CheckProxyGetResult(JSContext* cx, HandleObject target, HandleId id, HandleValue trapResult,
+                    MutableHandleValue vp);
+
 // VMFunctions shared by JITs
 extern const VMFunction SetArrayLengthInfo;
 extern const VMFunction SetObjectElementInfo;
@@ -971,9 +976,11 @@ extern const VMFunction SetObjectElementInfo;
 extern const VMFunction StringsEqualInfo;
 extern const VMFunction StringsNotEqualInfo;
 extern const VMFunction ConcatStringsInfo;
+extern const VMFunction ConcatStringPartsInfo;
 extern const VMFunction StringSplitHelperInfo;
 
 extern const VMFunction ProxyGetPropertyInfo;
+extern const VMFunction CheckProxyGetResultInfo;
 extern const VMFunction ProxyGetPropertyByValueInfo;
 extern const VMFunction ProxySetPropertyInfo;
 extern const VMFunction ProxySetPropertyByValueInfo;
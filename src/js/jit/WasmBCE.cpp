@@ -6,6 +6,7 @@
 #include "jit/WasmBCE.h"
 #include "jit/MIRGenerator.h"
 #include "jit/MIRGraph.h"
+#include "jit/RangeAnalysis.h"
 #include "wasm/WasmTypes.h"
 
 using namespace js;
@@ -18,6 +19,14 @@ typedef js::HashMap<uint32_t, MDefinition*, DefaultHasher<uint32_t>, SystemAlloc
 // on SSA values that have already been checked. (in the same block or in a
 // dominating block). These bounds checks are redundant and thus eliminated.
 //
+// Bounds checks on indices which range analysis has bounded below the heap
+// minimum are eliminated as well. This covers the induction variables of
+// loops with constant trip counts, whose ranges are computed from the loop
+// condition: every iteration's access is then known to be in bounds without
+// a check. Loops with symbolic bounds keep their checks, since wasm has no
+// bailouts to fall back on if a check hoisted to the loop entry failed before
+// the loop's first faulting access.
+//
 // Note: This is safe in the presense of dynamic memory sizes as long as they
 // can ONLY GROW. If we allow SHRINKING the heap, this pass should be
 // RECONSIDERED.
@@ -26,6 +35,26 @@ typedef js::HashMap<uint32_t, MDefinition*, DefaultHasher<uint32_t>, SystemAlloc
 // check, but a set of checks that together dominate a redundant check?
 //
 // TODO (dbounov): Generalize to constant additions relative to one base
+// Whether |addr| is known to be below |minHeapLength|.
+//
+// The payload of the MConstant will be Double if the constant result is above
+// 2^31-1, but we don't care about that for BCE.
+static bool
+IsBelowMinHeapLength(MDefinition* addr, uint32_t minHeapLength)
+{
+    if (addr->isConstant()) {
+        return addr->toConstant()->type() == MIRType::Int32 &&
+               uint32_t(addr->toConstant()->toInt32()) < minHeapLength;
+    }
+
+    // Wasm arithmetic is truncated, so ranges account for wraparound. The
+    // index is unsigned, hence the test of the lower bound.
+    const Range* range = addr->range();
+    return addr->type() == MIRType::Int32 && range &&
+           range->hasInt32LowerBound() && range->lower() >= 0 &&
+           range->hasInt32UpperBound() && uint32_t(range->upper()) < minHeapLength;
+}
+
 bool
 jit::EliminateBoundsChecks(MIRGenerator* mir, MIRGraph& graph)
 {
@@ -42,20 +71,15 @@ jit::EliminateBoundsChecks(MIRGenerator* mir, MIRGraph& graph)
                 MWasmBoundsCheck* bc = def->toWasmBoundsCheck();
                 MDefinition* addr = bc->index();
 
-                // Eliminate constant-address bounds checks to addresses below
-                // the heap minimum.
-                //
-                // The payload of the MConstant will be Double if the constant
-                // result is above 2^31-1, but we don't care about that for BCE.
+                // Eliminate bounds checks to constant addresses, and to
+                // addresses with known ranges, below the heap minimum.
 
 #ifndef WASM_HUGE_MEMORY
                 MOZ_ASSERT(wasm::MaxMemoryAccessSize < wasm::GuardSize,
                            "Guard page handles partial out-of-bounds");
 #endif
 
-                if (addr->isConstant() && addr->toConstant()->type() == MIRType::Int32 &&
-                    uint32_t(addr->toConstant()->toInt32()) < mir->minWasmHeapLength())
-                {
+                if (IsBelowMinHeapLength(addr, mir->minWasmHeapLength())) {
                     bc->setRedundant();
                     if (JitOptions.spectreIndexMasking) {
                         bc->replaceAllUsesWith(addr);
@@ -26,7 +26,7 @@ void JitRuntime::generateExceptionTailStub(MacroAssembler&, void*, Label*) { MOZ
 void JitRuntime::generateBailoutTailStub(MacroAssembler&, Label*) { MOZ_CRASH(); }
 void JitRuntime::generateProfilerExitFrameTailStub(MacroAssembler&, Label*) { MOZ_CRASH(); }
 
-bool JitRuntime::generateVMWrapper(JSContext*, MacroAssembler&, const VMFunction&) { MOZ_CRASH(); }
+bool JitRuntime::generateVMWrapper(JSContext*, MacroAssembler&, const VMFunction&, uint32_t*) { MOZ_CRASH(); }
 
 FrameSizeClass FrameSizeClass::FromDepth(uint32_t) { MOZ_CRASH(); }
 FrameSizeClass FrameSizeClass::ClassLimit() { MOZ_CRASH(); }
@@ -50,6 +50,8 @@ CodeGeneratorShared::CodeGeneratorShared(MIRGenerator* gen, LIRGraph* graph, Mac
     gen(gen),
     graph(*graph),
     current(nullptr),
+    blockOrder_(),
+    currentIndex_(0),
     snapshots_(),
     recovers_(),
     deoptTable_(),
@@ -82,6 +84,8 @@ CodeGeneratorShared::CodeGeneratorShared(MIRGenerator* gen, LIRGraph* graph, Mac
         masm.enableProfilingInstrumentation();
     }
 
+    masm.setSpectreMitigations(gen->spectre());
+
     if (gen->compilingWasm()) {
         // Since wasm uses the system ABI which does not necessarily use a
         // regular array where all slots are sizeof(Value), it maintains the max
@@ -89,8 +93,8 @@ CodeGeneratorShared::CodeGeneratorShared(MIRGenerator* gen, LIRGraph* graph, Mac
         MOZ_ASSERT(graph->argumentSlotCount() == 0);
         frameDepth_ += gen->wasmMaxStackArgBytes();
 
-        static_assert(!SupportsSimd, "we need padding so that local slots are SIMD-aligned and "
-                                     "the stack must be kept SIMD-aligned too.");
+        // Wasm frames are not SIMD-aligned, so 128-bit stack slots are only
+        // ever accessed with unaligned loads and stores.
 
         if (gen->needsStaticStackAlignment()) {
             // An MWasmCall does not align the stack pointer at calls sites but
@@ -595,13 +599,13 @@ CodeGeneratorShared::encode(LRecoverInfo* recover)
     MOZ_ASSERT(mode != MResumePoint::Outer);
     bool resumeAfter = (mode == MResumePoint::ResumeAfter);
 
-    RecoverOffset offset = recovers_.startRecover(numInstructions, resumeAfter);
+    recovers_.startRecover(numInstructions, resumeAfter);
 
     for (MNode* insn : *recover) {
         recovers_.writeInstruction(insn);
     }
 
-    recovers_.endRecover();
+    RecoverOffset offset = recovers_.endRecover();
     recover->setRecoverOffset(offset);
     masm.propagateOOM(!recovers_.oom());
 }
@@ -622,7 +626,7 @@ CodeGeneratorShared::encode(LSnapshot* snapshot)
     JitSpew(JitSpew_IonSnapshots, "Encoding LSnapshot %p (LRecover %p)",
             (void*)snapshot, (void*) recoverInfo);
 
-    SnapshotOffset offset = snapshots_.startSnapshot(recoverOffset, snapshot->bailoutKind());
+    snapshots_.startSnapshot(recoverOffset, snapshot->bailoutKind());
 
 #ifdef TRACK_SNAPSHOTS
     uint32_t pcOpcode = 0;
@@ -653,7 +657,7 @@ CodeGeneratorShared::encode(LSnapshot* snapshot)
     }
 
     MOZ_ASSERT(allocIndex == snapshot->numSlots());
-    snapshots_.endSnapshot();
+    SnapshotOffset offset = snapshots_.endSnapshot();
     snapshot->setSnapshotOffset(offset);
     masm.propagateOOM(!snapshots_.oom());
 }
@@ -54,6 +54,12 @@ class CodeGeneratorShared : public LElementVisitor
     MIRGenerator* gen;
     LIRGraph& graph;
     LBlock* current;
+
+    // The ids of the blocks in the order their code is emitted: the blocks
+    // which aren't cold in RPO, then the cold blocks. |currentIndex_| is the
+    // position of |current|.
+    js::Vector<uint32_t, 0, SystemAllocPolicy> blockOrder_;
+    size_t currentIndex_;
     SnapshotWriter snapshots_;
     RecoverWriter recovers_;
     mozilla::Maybe<TrampolinePtr> deoptTable_;
@@ -329,18 +335,24 @@ class CodeGeneratorShared : public LElementVisitor
     // Test whether the given block can be reached via fallthrough from the
     // current block.
     inline bool isNextBlock(LBlock* block) {
+        MOZ_ASSERT(blockOrder_[currentIndex_] == current->mir()->id());
         uint32_t target = skipTrivialBlocks(block->mir())->id();
-        uint32_t i = current->mir()->id() + 1;
-        if (target < i) {
-            return false;
-        }
-        // Trivial blocks can be crossed via fallthrough.
-        for (; i != target; ++i) {
-            if (!graph.getBlock(i)->isTrivial()) {
+        for (size_t i = currentIndex_ + 1; i < blockOrder_.length(); i++) {
+            if (blockOrder_[i] == target) {
+                return true;
+            }
+            // Trivial blocks can be crossed via fallthrough.
+            if (!graph.getBlock(blockOrder_[i])->isTrivial()) {
                 return false;
             }
         }
-        return true;
+        return false;
+    }
+
+    // Test whether the current block is the last one emitted, so that it can
+    // fall through to the code after the body.
+    bool isLastBlock() const {
+        return currentIndex_ + 1 == blockOrder_.length();
     }
 
   protected:
@@ -938,6 +938,19 @@ class LInterruptCheck : public LInstructionHelper<0, 0, 0>
     }
 };
 
+class LIncrementPCCount : public LInstructionHelper<0, 0, 0>
+{
+  public:
+    LIR_HEADER(IncrementPCCount)
+
+    LIncrementPCCount()
+      : LInstructionHelper(classOpcode)
+    {}
+    MIncrementPCCount* mir() const {
+        return mir_->toIncrementPCCount();
+    }
+};
+
 class LWasmInterruptCheck : public LInstructionHelper<0, 1, 0>
 {
   public:
@@ -1715,6 +1728,38 @@ class LApplyArgsGeneric : public LCallInstructionHelper<BOX_PIECES, BOX_PIECES +
     }
 };
 
+class LOptimizeSpreadCall : public LCallInstructionHelper<1, BOX_PIECES, 0>
+{
+  public:
+    LIR_HEADER(OptimizeSpreadCall)
+
+    static const size_t Value = 0;
+
+    explicit LOptimizeSpreadCall(const LBoxAllocation& value)
+      : LCallInstructionHelper(classOpcode)
+    {
+        setBoxOperand(Value, value);
+    }
+};
+
+class LOptimizeArrayDestructuring : public LCallInstructionHelper<1, BOX_PIECES, 0>
+{
+  public:
+    LIR_HEADER(OptimizeArrayDestructuring)
+
+    static const size_t Value = 0;
+
+    explicit LOptimizeArrayDestructuring(const LBoxAllocation& value)
+      : LCallInstructionHelper(classOpcode)
+    {
+        setBoxOperand(Value, value);
+    }
+
+    MOptimizeArrayDestructuring* mir() const {
+        return mir_->toOptimizeArrayDestructuring();
+    }
+};
+
 class LApplyArrayGeneric : public LCallInstructionHelper<BOX_PIECES, BOX_PIECES + 2, 2>
 {
   public:
@@ -3844,6 +3889,27 @@ class LConcat : public LInstructionHelper<1, 2, 5>
     }
 };
 
+// Concatenate the strings in all operands with a VM call.
+class LConcatN : public LVariadicInstruction<1, 1>
+{
+  public:
+    LIR_HEADER(ConcatN)
+
+    LConcatN(uint32_t numOperands, const LDefinition& temp)
+      : LVariadicInstruction<1, 1>(classOpcode, numOperands)
+    {
+        setTemp(0, temp);
+        setIsCall();
+    }
+
+    const MConcatN* mir() const {
+        return mir_->toConcatN();
+    }
+    const LDefinition* temp() {
+        return getTemp(0);
+    }
+};
+
 // Get uint16 character code from a string.
 class LCharCodeAt : public LInstructionHelper<1, 2, 1>
 {
@@ -5228,6 +5294,68 @@ class LGetNextEntryForIterator : public LInstructionHelper<1, 2, 3>
     }
 };
 
+class LMapObjectGet : public LCallInstructionHelper<BOX_PIECES, 1 + BOX_PIECES, 2>
+{
+  public:
+    LIR_HEADER(MapObjectGet)
+
+    static const size_t Key = 1;
+
+    LMapObjectGet(const LAllocation& map, const LBoxAllocation& key, const LDefinition& temp0,
+                  const LDefinition& temp1)
+      : LCallInstructionHelper(classOpcode)
+    {
+        setOperand(0, map);
+        setBoxOperand(Key, key);
+        setTemp(0, temp0);
+        setTemp(1, temp1);
+    }
+
+    const MMapObjectGet* mir() const {
+        return mir_->toMapObjectGet();
+    }
+    const LAllocation* map() {
+        return getOperand(0);
+    }
+    const LDefinition* temp0() {
+        return getTemp(0);
+    }
+    const LDefinition* temp1() {
+        return getTemp(1);
+    }
+};
+
+class LMapOrSetHas : public LCallInstructionHelper<1, 1 + BOX_PIECES, 2>
+{
+  public:
+    LIR_HEADER(MapOrSetHas)
+
+    static const size_t Key = 1;
+
+    LMapOrSetHas(const LAllocation& object, const LBoxAllocation& key, const LDefinition& temp0,
+                 const LDefinition& temp1)
+      : LCallInstructionHelper(classOpcode)
+    {
+        setOperand(0, object);
+        setBoxOperand(Key, key);
+        setTemp(0, temp0);
+        setTemp(1, temp1);
+    }
+
+    const MMapOrSetHas* mir() const {
+        return mir_->toMapOrSetHas();
+    }
+    const LAllocation* object() {
+        return getOperand(0);
+    }
+    const LDefinition* temp0() {
+        return getTemp(0);
+    }
+    const LDefinition* temp1() {
+        return getTemp(1);
+    }
+};
+
 // Read the length of a typed array.
 class LTypedArrayLength : public LInstructionHelper<1, 1, 0>
 {
@@ -5299,6 +5427,71 @@ class LSetDisjointTypedElements : public LCallInstructionHelper<0, 3, 1>
     }
 };
 
+class LTypedArrayFill : public LCallInstructionHelper<0, 4, 1>
+{
+  public:
+    LIR_HEADER(TypedArrayFill)
+
+    LTypedArrayFill(const LAllocation& object, const LAllocation& value,
+                    const LAllocation& start, const LAllocation& end, const LDefinition& temp)
+      : LCallInstructionHelper(classOpcode)
+    {
+        setOperand(0, object);
+        setOperand(1, value);
+        setOperand(2, start);
+        setOperand(3, end);
+        setTemp(0, temp);
+    }
+
+    const LAllocation* object() {
+        return getOperand(0);
+    }
+    const LAllocation* value() {
+        return getOperand(1);
+    }
+    const LAllocation* start() {
+        return getOperand(2);
+    }
+    const LAllocation* end() {
+        return getOperand(3);
+    }
+    const LDefinition* temp() {
+        return getTemp(0);
+    }
+};
+
+class LTypedArraySearch : public LCallInstructionHelper<1, 3, 1>
+{
+  public:
+    LIR_HEADER(TypedArraySearch)
+
+    LTypedArraySearch(const LAllocation& object, const LAllocation& value,
+                      const LAllocation& start, const LDefinition& temp)
+      : LCallInstructionHelper(classOpcode)
+    {
+        setOperand(0, object);
+        setOperand(1, value);
+        setOperand(2, start);
+        setTemp(0, temp);
+    }
+
+    const MTypedArraySearch* mir() const {
+        return mir_->toTypedArraySearch();
+    }
+    const LAllocation* object() {
+        return getOperand(0);
+    }
+    const LAllocation* value() {
+        return getOperand(1);
+    }
+    const LAllocation* start() {
+        return getOperand(2);
+    }
+    const LDefinition* temp() {
+        return getTemp(0);
+    }
+};
+
 // Load a typed object's descriptor.
 class LTypedObjectDescr : public LInstructionHelper<1, 1, 0>
 {
@@ -6142,6 +6335,42 @@ class LArrayJoin : public LCallInstructionHelper<1, 2, 1>
     }
 };
 
+class LArraySearch : public LCallInstructionHelper<1, 4, 1>
+{
+  public:
+    LIR_HEADER(ArraySearch)
+
+    LArraySearch(const LAllocation& array, const LAllocation& value, const LAllocation& start,
+                 const LAllocation& end, const LDefinition& temp)
+      : LCallInstructionHelper(classOpcode)
+    {
+        setOperand(0, array);
+        setOperand(1, value);
+        setOperand(2, start);
+        setOperand(3, end);
+        setTemp(0, temp);
+    }
+
+    const MArraySearch* mir() const {
+        return mir_->toArraySearch();
+    }
+    const LAllocation* array() {
+        return getOperand(0);
+    }
+    const LAllocation* value() {
+        return getOperand(1);
+    }
+    const LAllocation* start() {
+        return getOperand(2);
+    }
+    const LAllocation* end() {
+        return getOperand(3);
+    }
+    const LDefinition* temp() {
+        return getTemp(0);
+    }
+};
+
 class LLoadUnboxedScalar : public LInstructionHelper<1, 2, 1>
 {
   public:
@@ -6224,6 +6453,64 @@ class LStoreUnboxedScalar : public LInstructionHelper<0, 3, 0>
     }
 };
 
+class LLoadDataViewElement : public LInstructionHelper<1, 2, 1>
+{
+  public:
+    LIR_HEADER(LoadDataViewElement)
+
+    LLoadDataViewElement(const LAllocation& elements, const LAllocation& index,
+                         const LDefinition& temp)
+      : LInstructionHelper(classOpcode)
+    {
+        setOperand(0, elements);
+        setOperand(1, index);
+        setTemp(0, temp);
+    }
+    const MLoadDataViewElement* mir() const {
+        return mir_->toLoadDataViewElement();
+    }
+    const LAllocation* elements() {
+        return getOperand(0);
+    }
+    const LAllocation* index() {
+        return getOperand(1);
+    }
+    const LDefinition* temp() {
+        return getTemp(0);
+    }
+};
+
+class LStoreDataViewElement : public LInstructionHelper<0, 3, 1>
+{
+  public:
+    LIR_HEADER(StoreDataViewElement)
+
+    LStoreDataViewElement(const LAllocation& elements, const LAllocation& index,
+                          const LAllocation& value, const LDefinition& temp)
+      : LInstructionHelper(classOpcode)
+    {
+        setOperand(0, elements);
+        setOperand(1, index);
+        setOperand(2, value);
+        setTemp(0, temp);
+    }
+    const MStoreDataViewElement* mir() const {
+        return mir_->toStoreDataViewElement();
+    }
+    const LAllocation* elements() {
+        return getOperand(0);
+    }
+    const LAllocation* index() {
+        return getOperand(1);
+    }
+    const LAllocation* value() {
+        return getOperand(2);
+    }
+    const LDefinition* temp() {
+        return getTemp(0);
+    }
+};
+
 class LStoreTypedArrayElementHole : public LInstructionHelper<0, 4, 1>
 {
   public:
@@ -726,7 +726,7 @@ LIRGeneratorShared::add(T* ins, MInstruction* mir)
 // redefines its input payload if its input is not constant. Therefore, it is
 // illegal to request a box's payload by adding VREG_DATA_OFFSET to its raw id.
 static inline uint32_t
-VirtualRegisterOfPayload(MDefinition* mir)
+VirtualRegisterOfPayload(MDefinition* mir, const SpectreMitigations& spectre)
 {
     if (mir->isBox()) {
         MDefinition* inner = mir->toBox()->getOperand(0);
@@ -734,8 +734,8 @@ VirtualRegisterOfPayload(MDefinition* mir)
             return inner->virtualRegister();
         }
     }
-    if (mir->isTypeBarrier() && mir->toTypeBarrier()->canRedefineInput()) {
-        return VirtualRegisterOfPayload(mir->toTypeBarrier()->input());
+    if (mir->isTypeBarrier() && mir->toTypeBarrier()->canRedefineInput(spectre)) {
+        return VirtualRegisterOfPayload(mir->toTypeBarrier()->input(), spectre);
     }
     return mir->virtualRegister() + VREG_DATA_OFFSET;
 }
@@ -755,7 +755,7 @@ LIRGeneratorShared::usePayload(MDefinition* mir, LUse::Policy policy)
 {
     MOZ_ASSERT(mir->type() == MIRType::Value);
 
-    return LUse(VirtualRegisterOfPayload(mir), policy);
+    return LUse(VirtualRegisterOfPayload(mir, gen->spectre()), policy);
 }
 
 LUse
@@ -763,7 +763,7 @@ LIRGeneratorShared::usePayloadAtStart(MDefinition* mir, LUse::Policy policy)
 {
     MOZ_ASSERT(mir->type() == MIRType::Value);
 
-    return LUse(VirtualRegisterOfPayload(mir), policy, true);
+    return LUse(VirtualRegisterOfPayload(mir, gen->spectre()), policy, true);
 }
 
 LUse
@@ -777,7 +777,8 @@ LIRGeneratorShared::fillBoxUses(LInstruction* lir, size_t n, MDefinition* mir)
 {
     ensureDefined(mir);
     lir->getOperand(n)->toUse()->setVirtualRegister(mir->virtualRegister() + VREG_TYPE_OFFSET);
-    lir->getOperand(n + 1)->toUse()->setVirtualRegister(VirtualRegisterOfPayload(mir));
+    uint32_t payloadVreg = VirtualRegisterOfPayload(mir, gen->spectre());
+    lir->getOperand(n + 1)->toUse()->setVirtualRegister(payloadVreg);
 }
 #endif
 
@@ -807,8 +808,9 @@ LIRGeneratorShared::useBox(MDefinition* mir, LUse::Policy policy, bool useAtStar
     ensureDefined(mir);
 
 #if defined(JS_NUNBOX32)
+    uint32_t payloadVreg = VirtualRegisterOfPayload(mir, gen->spectre());
     return LBoxAllocation(LUse(mir->virtualRegister(), policy, useAtStart),
-                          LUse(VirtualRegisterOfPayload(mir), policy, useAtStart));
+                          LUse(payloadVreg, policy, useAtStart));
 #else
     return LBoxAllocation(LUse(mir->virtualRegister(), policy, useAtStart));
 #endif
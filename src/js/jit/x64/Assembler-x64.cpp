@@ -180,6 +180,20 @@ Assembler::PatchJumpEntry(uint8_t* entry, uint8_t* target)
     *index = target;
 }
 
+/* static */
+uint8_t*
+Assembler::InterruptPollTarget(uint8_t* pc)
+{
+    // cmpl $rel32, (%r11): REX.B, CMP r/m32 imm32, ModRM /7 with r/m=r11.
+    static const uint8_t PollPrefix[] = { 0x41, 0x81, 0x3b };
+    static_assert(ScratchReg.code() == X86Encoding::r11, "the poll prefix encodes r11");
+
+    if (memcmp(pc, PollPrefix, sizeof(PollPrefix)) != 0) {
+        return nullptr;
+    }
+    return (uint8_t*) X86Encoding::GetRel32Target(pc + sizeof(PollPrefix) + sizeof(int32_t));
+}
+
 void
 Assembler::finish()
 {
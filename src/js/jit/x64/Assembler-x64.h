@@ -226,7 +226,11 @@ static_assert(JitStackAlignment % sizeof(Value) == 0 && JitStackValueAlignment >
 // this architecture or not. Rather than a method in the LIRGenerator, it is
 // here such that it is accessible from the entire codebase. Once full support
 // for SIMD is reached on all tier-1 platforms, this constant can be deleted.
+#ifdef ENABLE_WASM_SIMD
+static constexpr bool SupportsSimd = true;
+#else
 static constexpr bool SupportsSimd = false;
+#endif
 static constexpr uint32_t SimdMemoryAlignment = 16;
 
 static_assert(CodeAlignment % SimdMemoryAlignment == 0,
@@ -304,6 +308,10 @@ class Assembler : public AssemblerX86Shared
     static uint8_t* PatchableJumpAddress(JitCode* code, size_t index);
     static void PatchJumpEntry(uint8_t* entry, uint8_t* target);
 
+    // If |pc| is an interrupt poll emitted by MacroAssembler::interruptPoll,
+    // return the address it resumes at when it faults, otherwise null.
+    static uint8_t* InterruptPollTarget(uint8_t* pc);
+
     Assembler()
       : extendedJumpTable_(0)
     {
@@ -6,8 +6,11 @@
 
 #include "jit/x64/CodeGenerator-x64.h"
 
+#include "mozilla/Casting.h"
 #include "mozilla/MathAlgorithms.h"
 
+#include "jsmath.h"
+
 #include "jit/CodeGenerator.h"
 #include "jit/MIR.h"
 
@@ -18,6 +21,7 @@
 using namespace js;
 using namespace js::jit;
 
+using mozilla::BitwiseCast;
 using mozilla::DebugOnly;
 
 CodeGeneratorX64::CodeGeneratorX64(MIRGenerator* gen, LIRGraph* graph, MacroAssembler* masm)
@@ -417,6 +421,7 @@ CodeGeneratorX64::wasmStore(const wasm::MemoryAccessDesc& access, const LAllocat
           case Scalar::Int64:
           case Scalar::Float32:
           case Scalar::Float64:
+          case Scalar::Simd128:
           case Scalar::Uint8Clamped:
           case Scalar::MaxTypedArrayViewType:
             MOZ_CRASH("unexpected array type");
@@ -762,3 +767,409 @@ CodeGenerator::visitTestI64AndBranch(LTestI64AndBranch* lir)
     masm.testq(input, input);
     emitBranch(Assembler::NonZero, lir->ifTrue(), lir->ifFalse());
 }
+
+// The inline paths of LMathFunctionInlineD follow fdlibm's e_exp.c and
+// e_log.c operation for operation, with the same constants, so that they
+// round the same way. Inputs for which fdlibm takes a less common branch go
+// to the out of line call.
+namespace {
+
+const double ExpInvLn2 = BitwiseCast<double>(uint64_t(0x3ff71547652b82fe));
+const double ExpLn2Hi = BitwiseCast<double>(uint64_t(0x3fe62e42fee00000));
+const double ExpLn2Lo = BitwiseCast<double>(uint64_t(0x3dea39ef35793c76));
+const double ExpP[] = {
+    BitwiseCast<double>(uint64_t(0x3fc555555555553e)),
+    BitwiseCast<double>(uint64_t(0xbf66c16c16bebd93)),
+    BitwiseCast<double>(uint64_t(0x3f11566aaf25de2c)),
+    BitwiseCast<double>(uint64_t(0xbebbbd41c5d26bf1)),
+    BitwiseCast<double>(uint64_t(0x3e66376972bea4d0)),
+};
+
+const double LogLn2Hi = ExpLn2Hi;
+const double LogLn2Lo = ExpLn2Lo;
+const double LogLg[] = {
+    BitwiseCast<double>(uint64_t(0x3fe5555555555593)),
+    BitwiseCast<double>(uint64_t(0x3fd999999997fa04)),
+    BitwiseCast<double>(uint64_t(0x3fd2492494229359)),
+    BitwiseCast<double>(uint64_t(0x3fcc71c51d8e78af)),
+    BitwiseCast<double>(uint64_t(0x3fc7466496cb03de)),
+    BitwiseCast<double>(uint64_t(0x3fc39a09d078c69f)),
+    BitwiseCast<double>(uint64_t(0x3fc2f112df3e5244)),
+};
+
+// The largest high word of |x| for which exp(x) is computed inline, about 708.
+// Up to there 2^k is normal, so scaling by it is a single multiplication.
+const int32_t ExpMaxHighWord = 0x40862000;
+
+} // anonymous namespace
+
+class js::jit::OutOfLineMathFunctionD : public OutOfLineCodeBase<CodeGeneratorX64>
+{
+    LMathFunctionInlineD* ins_;
+
+  public:
+    explicit OutOfLineMathFunctionD(LMathFunctionInlineD* ins)
+      : ins_(ins)
+    { }
+
+    void accept(CodeGeneratorX64* codegen) override {
+        codegen->visitOutOfLineMathFunctionD(this);
+    }
+    LMathFunctionInlineD* ins() const {
+        return ins_;
+    }
+};
+
+// c = r - t*(P1+t*(P2+t*(P3+t*(P4+t*P5)))), where t = r*r. Leaves c in
+// |output|.
+static void
+EmitExpPolynomial(MacroAssembler& masm, FloatRegister r, FloatRegister output, FloatRegister acc)
+{
+    ScratchDoubleScope scratch(masm);
+
+    masm.moveDouble(r, output);
+    masm.mulDouble(r, output);
+
+    masm.loadConstantDouble(ExpP[4], acc);
+    masm.mulDouble(output, acc);
+    for (int i = 3; i >= 0; i--) {
+        masm.loadConstantDouble(ExpP[i], scratch);
+        masm.addDouble(scratch, acc);
+        masm.mulDouble(output, acc);
+    }
+
+    masm.moveDouble(r, output);
+    masm.subDouble(acc, output);
+}
+
+static void
+EmitExpD(MacroAssembler& masm, FloatRegister input, FloatRegister output, Register hx, Register k,
+         FloatRegister hi, FloatRegister lo, FloatRegister r, FloatRegister acc, Label* ool)
+{
+    Label small, done;
+
+    masm.moveDoubleToGPR64(input, Register64(hx));
+    masm.rshiftPtr(Imm32(32), hx);
+    masm.and32(Imm32(0x7fffffff), hx);
+
+    // Overflow, underflow, NaN, and results which need subnormal scaling.
+    masm.branch32(Assembler::Above, hx, Imm32(ExpMaxHighWord), ool);
+    masm.branch32(Assembler::BelowOrEqual, hx, Imm32(0x3fd62e42), &small);
+
+    // |x| > 0.5 ln2. Reduce x to r = hi - lo = x - k ln2, with
+    // k = (int)(x / ln2 + copysign(0.5, x)).
+    {
+        ScratchDoubleScope scratch(masm);
+        Label positive, rounded;
+
+        masm.loadConstantDouble(ExpInvLn2, output);
+        masm.mulDouble(input, output);
+        masm.moveDoubleToGPR64(input, Register64(k));
+        masm.branchTestPtr(Assembler::NotSigned, k, k, &positive);
+        masm.loadConstantDouble(-0.5, scratch);
+        masm.jump(&rounded);
+        masm.bind(&positive);
+        masm.loadConstantDouble(0.5, scratch);
+        masm.bind(&rounded);
+        masm.addDouble(scratch, output);
+        masm.vcvttsd2si(output, k);
+        masm.convertInt32ToDouble(k, output);
+
+        masm.loadConstantDouble(ExpLn2Hi, scratch);
+        masm.mulDouble(output, scratch);
+        masm.moveDouble(input, hi);
+        masm.subDouble(scratch, hi);
+        masm.loadConstantDouble(ExpLn2Lo, lo);
+        masm.mulDouble(output, lo);
+        masm.moveDouble(hi, r);
+        masm.subDouble(lo, r);
+    }
+
+    EmitExpPolynomial(masm, r, output, acc);
+
+    // y = 1 - ((lo - (r*c)/(2-c)) - hi), scaled by 2^k.
+    {
+        ScratchDoubleScope scratch(masm);
+
+        masm.moveDouble(r, acc);
+        masm.mulDouble(output, acc);
+        masm.loadConstantDouble(2.0, scratch);
+        masm.subDouble(output, scratch);
+        masm.divDouble(scratch, acc);
+        masm.subDouble(acc, lo);
+        masm.subDouble(hi, lo);
+        masm.loadConstantDouble(1.0, output);
+        masm.subDouble(lo, output);
+
+        masm.add32(Imm32(0x3ff), k);
+        masm.lshiftPtr(Imm32(52), k);
+        masm.moveGPR64ToDouble(Register64(k), scratch);
+        masm.mulDouble(scratch, output);
+    }
+    masm.jump(&done);
+
+    // |x| <= 0.5 ln2, so k = 0.
+    masm.bind(&small);
+    {
+        Label notTiny;
+        masm.branch32(Assembler::AboveOrEqual, hx, Imm32(0x3e300000), &notTiny);
+
+        // |x| < 2^-28: y = 1 + x.
+        masm.loadConstantDouble(1.0, output);
+        masm.addDouble(input, output);
+        masm.jump(&done);
+
+        masm.bind(&notTiny);
+    }
+
+    EmitExpPolynomial(masm, input, output, acc);
+
+    // y = 1 - ((x*c)/(c-2) - x)
+    {
+        ScratchDoubleScope scratch(masm);
+
+        masm.moveDouble(input, acc);
+        masm.mulDouble(output, acc);
+        masm.moveDouble(output, scratch);
+        masm.loadConstantDouble(2.0, hi);
+        masm.subDouble(hi, scratch);
+        masm.divDouble(scratch, acc);
+        masm.subDouble(input, acc);
+        masm.loadConstantDouble(1.0, output);
+        masm.subDouble(acc, output);
+    }
+
+    masm.bind(&done);
+}
+
+// Leaves dk*ln2_hi in |output| and dk*ln2_lo in |lo|.
+static void
+EmitLogScale(MacroAssembler& masm, Register k, FloatRegister output, FloatRegister lo)
+{
+    ScratchDoubleScope scratch(masm);
+
+    masm.convertInt32ToDouble(k, lo);
+    masm.loadConstantDouble(LogLn2Hi, output);
+    masm.mulDouble(lo, output);
+    masm.loadConstantDouble(LogLn2Lo, scratch);
+    masm.mulDouble(scratch, lo);
+}
+
+static void
+EmitLogD(MacroAssembler& masm, FloatRegister input, FloatRegister output, Register hx, Register k,
+         Register temp, FloatRegister f, FloatRegister a, FloatRegister z, FloatRegister w,
+         FloatRegister r, Label* ool)
+{
+    Label smallR, done;
+
+    masm.moveDoubleToGPR64(input, Register64(temp));
+    masm.movePtr(temp, hx);
+    masm.rshiftPtr(Imm32(32), hx);
+
+    // Zero, negative and subnormal inputs, Infinity and NaN.
+    masm.branch32(Assembler::LessThan, hx, Imm32(0x00100000), ool);
+    masm.branch32(Assembler::GreaterThanOrEqual, hx, Imm32(0x7ff00000), ool);
+
+    // k = exponent of x, and f = x' - 1, where x' is x scaled into
+    // [sqrt(2)/2, sqrt(2)) with the same low word.
+    masm.move32(hx, k);
+    masm.rshift32(Imm32(20), k);
+    masm.sub32(Imm32(1023), k);
+    masm.and32(Imm32(0x000fffff), hx);
+    {
+        ScratchRegisterScope scratch(masm);
+
+        // i = (hx + 0x95f64) & 0x100000; k += i >> 20
+        masm.move32(hx, scratch);
+        masm.add32(Imm32(0x95f64), scratch);
+        masm.and32(Imm32(0x100000), scratch);
+        masm.rshift32(Imm32(20), scratch);
+        masm.add32(scratch, k);
+        masm.lshift32(Imm32(20), scratch);
+
+        // The high word of x' is hx | (i ^ 0x3ff00000).
+        masm.xor32(Imm32(0x3ff00000), scratch);
+        masm.or32(hx, scratch);
+        masm.lshiftPtr(Imm32(32), scratch);
+        masm.move32(temp, temp);
+        masm.orPtr(scratch, temp);
+        masm.moveGPR64ToDouble(Register64(temp), f);
+    }
+    {
+        ScratchDoubleScope scratch(masm);
+        masm.loadConstantDouble(1.0, scratch);
+        masm.subDouble(scratch, f);
+    }
+
+    // |f| < 2^-20.
+    masm.move32(hx, temp);
+    masm.add32(Imm32(2), temp);
+    masm.and32(Imm32(0x000fffff), temp);
+    masm.branch32(Assembler::Below, temp, Imm32(3), ool);
+
+    // s = f/(2+f), z = s*s, w = z*z, left in |output|, |z| and |w|.
+    masm.loadConstantDouble(2.0, a);
+    masm.addDouble(f, a);
+    masm.moveDouble(f, output);
+    masm.divDouble(a, output);
+    masm.moveDouble(output, z);
+    masm.mulDouble(output, z);
+    masm.moveDouble(z, w);
+    masm.mulDouble(z, w);
+
+    // R = t2 + t1, with t1 = w*(Lg2+w*(Lg4+w*Lg6)) and
+    // t2 = z*(Lg1+w*(Lg3+w*(Lg5+w*Lg7))), left in |r|.
+    {
+        ScratchDoubleScope scratch(masm);
+
+        masm.loadConstantDouble(LogLg[5], a);
+        masm.mulDouble(w, a);
+        masm.loadConstantDouble(LogLg[3], scratch);
+        masm.addDouble(scratch, a);
+        masm.mulDouble(w, a);
+        masm.loadConstantDouble(LogLg[1], scratch);
+        masm.addDouble(scratch, a);
+        masm.mulDouble(w, a);
+
+        masm.loadConstantDouble(LogLg[6], r);
+        masm.mulDouble(w, r);
+        masm.loadConstantDouble(LogLg[4], scratch);
+        masm.addDouble(scratch, r);
+        masm.mulDouble(w, r);
+        masm.loadConstantDouble(LogLg[2], scratch);
+        masm.addDouble(scratch, r);
+        masm.mulDouble(w, r);
+        masm.loadConstantDouble(LogLg[0], scratch);
+        masm.addDouble(scratch, r);
+        masm.mulDouble(z, r);
+
+        masm.addDouble(a, r);
+    }
+
+    // (hx - 0x6147a) | (0x6b851 - hx) > 0
+    {
+        ScratchRegisterScope scratch(masm);
+        masm.move32(hx, temp);
+        masm.sub32(Imm32(0x6147a), temp);
+        masm.move32(Imm32(0x6b851), scratch);
+        masm.sub32(hx, scratch);
+        masm.or32(scratch, temp);
+    }
+    masm.branch32(Assembler::LessThanOrEqual, temp, Imm32(0), &smallR);
+
+    // hfsq = 0.5*f*f, left in |a|.
+    masm.loadConstantDouble(0.5, a);
+    masm.mulDouble(f, a);
+    masm.mulDouble(f, a);
+
+    // z = s*(hfsq+R)
+    masm.moveDouble(a, z);
+    masm.addDouble(r, z);
+    masm.mulDouble(output, z);
+    {
+        Label kZero;
+        masm.branchTest32(Assembler::Zero, k, k, &kZero);
+
+        // dk*ln2_hi - ((hfsq - (z + dk*ln2_lo)) - f)
+        EmitLogScale(masm, k, output, w);
+        masm.addDouble(w, z);
+        masm.subDouble(z, a);
+        masm.subDouble(f, a);
+        masm.subDouble(a, output);
+        masm.jump(&done);
+
+        // f - (hfsq - z)
+        masm.bind(&kZero);
+        masm.subDouble(z, a);
+        masm.moveDouble(f, output);
+        masm.subDouble(a, output);
+        masm.jump(&done);
+    }
+
+    masm.bind(&smallR);
+
+    // z = s*(f-R)
+    masm.moveDouble(f, z);
+    masm.subDouble(r, z);
+    masm.mulDouble(output, z);
+    {
+        Label kZero;
+        masm.branchTest32(Assembler::Zero, k, k, &kZero);
+
+        // dk*ln2_hi - ((z - dk*ln2_lo) - f)
+        EmitLogScale(masm, k, output, w);
+        masm.subDouble(w, z);
+        masm.subDouble(f, z);
+        masm.subDouble(z, output);
+        masm.jump(&done);
+
+        // f - z
+        masm.bind(&kZero);
+        masm.moveDouble(f, output);
+        masm.subDouble(z, output);
+    }
+
+    masm.bind(&done);
+}
+
+void
+CodeGenerator::visitMathFunctionInlineD(LMathFunctionInlineD* ins)
+{
+    FloatRegister input = ToFloatRegister(ins->input());
+    FloatRegister output = ToFloatRegister(ins->output());
+
+    OutOfLineMathFunctionD* ool = new(alloc()) OutOfLineMathFunctionD(ins);
+    addOutOfLineCode(ool, ins->mir());
+
+    switch (ins->mir()->function()) {
+      case MMathFunction::Exp:
+        EmitExpD(masm, input, output,
+                 ToRegister(ins->generalTemp(0)), ToRegister(ins->generalTemp(1)),
+                 ToFloatRegister(ins->floatTemp(0)), ToFloatRegister(ins->floatTemp(1)),
+                 ToFloatRegister(ins->floatTemp(2)), ToFloatRegister(ins->floatTemp(3)),
+                 ool->entry());
+        break;
+      case MMathFunction::Log:
+        EmitLogD(masm, input, output,
+                 ToRegister(ins->generalTemp(0)), ToRegister(ins->generalTemp(1)),
+                 ToRegister(ins->generalTemp(2)),
+                 ToFloatRegister(ins->floatTemp(0)), ToFloatRegister(ins->floatTemp(1)),
+                 ToFloatRegister(ins->floatTemp(2)), ToFloatRegister(ins->floatTemp(3)),
+                 ToFloatRegister(ins->floatTemp(4)), ool->entry());
+        break;
+      default:
+        MOZ_CRASH("Unexpected inline math function");
+    }
+
+    masm.bind(ool->rejoin());
+}
+
+void
+CodeGeneratorX64::visitOutOfLineMathFunctionD(OutOfLineMathFunctionD* ool)
+{
+    LMathFunctionInlineD* ins = ool->ins();
+    FloatRegister input = ToFloatRegister(ins->input());
+    FloatRegister output = ToFloatRegister(ins->output());
+    Register temp = ToRegister(ins->generalTemp(0));
+
+    void* funptr = nullptr;
+    switch (ins->mir()->function()) {
+      case MMathFunction::Exp:
+        funptr = JS_FUNC_TO_DATA_PTR(void*, js::math_exp_impl);
+        break;
+      case MMathFunction::Log:
+        funptr = JS_FUNC_TO_DATA_PTR(void*, js::math_log_impl);
+        break;
+      default:
+        MOZ_CRASH("Unexpected inline math function");
+    }
+
+    saveVolatile(output);
+    masm.setupUnalignedABICall(temp);
+    masm.passABIArg(input, MoveOp::DOUBLE);
+    masm.callWithABI(funptr, MoveOp::DOUBLE);
+    masm.storeCallFloatResult(output);
+    restoreVolatile(output);
+
+    masm.jump(ool->rejoin());
+}
@@ -12,6 +12,8 @@
 namespace js {
 namespace jit {
 
+class OutOfLineMathFunctionD;
+
 class CodeGeneratorX64 : public CodeGeneratorX86Shared
 {
   protected:
@@ -27,6 +29,9 @@ class CodeGeneratorX64 : public CodeGeneratorX86Shared
     void wasmStore(const wasm::MemoryAccessDesc& access, const LAllocation* value, Operand dstAddr);
     template <typename T> void emitWasmLoad(T* ins);
     template <typename T> void emitWasmStore(T* ins);
+
+  public:
+    void visitOutOfLineMathFunctionD(OutOfLineMathFunctionD* ool);
 };
 
 typedef CodeGeneratorX64 CodeGeneratorSpecific;
@@ -194,6 +194,51 @@ class LWasmTruncateToInt64 : public LInstructionHelper<1, 1, 1>
     }
 };
 
+// Math.exp and Math.log of a double, computed inline for inputs in their
+// common ranges and by calling the same function as LMathFunctionD otherwise.
+// The inline code performs the same floating point operations as fdlibm, so
+// the results don't depend on which path or tier computed them.
+class LMathFunctionInlineD : public LInstructionHelper<1, 1, 8>
+{
+  public:
+    LIR_HEADER(MathFunctionInlineD)
+
+    static const size_t NumGeneralTemps = 3;
+    static const size_t NumFloatTemps = 5;
+
+    static bool IsSupported(MMathFunction::Function function) {
+        return function == MMathFunction::Exp || function == MMathFunction::Log;
+    }
+
+    LMathFunctionInlineD(const LAllocation& input, const LDefinition* generalTemps,
+                         const LDefinition* floatTemps)
+      : LInstructionHelper(classOpcode)
+    {
+        setOperand(0, input);
+        for (size_t i = 0; i < NumGeneralTemps; i++) {
+            setTemp(i, generalTemps[i]);
+        }
+        for (size_t i = 0; i < NumFloatTemps; i++) {
+            setTemp(NumGeneralTemps + i, floatTemps[i]);
+        }
+    }
+
+    const LDefinition* generalTemp(size_t i) {
+        MOZ_ASSERT(i < NumGeneralTemps);
+        return getTemp(i);
+    }
+    const LDefinition* floatTemp(size_t i) {
+        MOZ_ASSERT(i < NumFloatTemps);
+        return getTemp(NumGeneralTemps + i);
+    }
+    MMathFunction* mir() const {
+        return mir_->toMathFunction();
+    }
+    const char* extraName() const {
+        return MMathFunction::FunctionName(mir()->function());
+    }
+};
+
 } // namespace jit
 } // namespace js
 
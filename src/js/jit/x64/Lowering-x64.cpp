@@ -233,6 +233,7 @@ LIRGenerator::visitWasmStore(MWasmStore* ins)
         break;
       case Scalar::Float32:
       case Scalar::Float64:
+      case Scalar::Simd128:
         valueAlloc = useRegisterAtStart(value);
         break;
       case Scalar::Uint8Clamped:
@@ -420,6 +421,28 @@ LIRGeneratorX64::lowerUModI64(MMod* mod)
     defineInt64Fixed(lir, mod, LInt64Allocation(LAllocation(AnyRegister(rdx))));
 }
 
+void
+LIRGeneratorX64::lowerMathFunctionInlineD(MMathFunction* ins)
+{
+    // Log needs all of the temps, exp two general and four float temps.
+    bool isLog = ins->function() == MMathFunction::Log;
+
+    LDefinition generalTemps[LMathFunctionInlineD::NumGeneralTemps];
+    for (size_t i = 0; i < LMathFunctionInlineD::NumGeneralTemps; i++) {
+        generalTemps[i] = (isLog || i < 2) ? temp() : LDefinition::BogusTemp();
+    }
+    LDefinition floatTemps[LMathFunctionInlineD::NumFloatTemps];
+    for (size_t i = 0; i < LMathFunctionInlineD::NumFloatTemps; i++) {
+        floatTemps[i] = (isLog || i < 4) ? tempDouble() : LDefinition::BogusTemp();
+    }
+
+    // The input is passed to the out of line call after the output has been
+    // written, so they can't share a register.
+    LMathFunctionInlineD* lir = new(alloc()) LMathFunctionInlineD(useRegister(ins->input()),
+                                                                  generalTemps, floatTemps);
+    define(lir, ins);
+}
+
 void
 LIRGenerator::visitWasmTruncateToInt64(MWasmTruncateToInt64* ins)
 {
@@ -45,6 +45,8 @@ class LIRGeneratorX64 : public LIRGeneratorX86Shared
     void lowerModI64(MMod* mod);
     void lowerUDivI64(MDiv* div);
     void lowerUModI64(MMod* mod);
+
+    void lowerMathFunctionInlineD(MMathFunction* ins);
 };
 
 typedef LIRGeneratorX64 LIRGeneratorSpecific;
@@ -868,14 +868,14 @@ MacroAssembler::spectreBoundsCheck32(Register index, Register length, Register m
     MOZ_ASSERT(index != scratch);
     MOZ_ASSERT(length != scratch);
 
-    if (JitOptions.spectreIndexMasking) {
+    if (spectre_.indexMasking) {
         move32(Imm32(0), scratch);
     }
 
     cmp32(index, length);
     j(Assembler::AboveOrEqual, failure);
 
-    if (JitOptions.spectreIndexMasking) {
+    if (spectre_.indexMasking) {
         cmovCCl(Assembler::AboveOrEqual, scratch, index);
     }
 }
@@ -892,14 +892,14 @@ MacroAssembler::spectreBoundsCheck32(Register index, const Address& length, Regi
     MOZ_ASSERT(index != scratch);
     MOZ_ASSERT(length.base != scratch);
 
-    if (JitOptions.spectreIndexMasking) {
+    if (spectre_.indexMasking) {
         move32(Imm32(0), scratch);
     }
 
     cmp32(index, Operand(length));
     j(Assembler::AboveOrEqual, failure);
 
-    if (JitOptions.spectreIndexMasking) {
+    if (spectre_.indexMasking) {
         cmovCCl(Assembler::AboveOrEqual, scratch, index);
     }
 }
@@ -518,15 +518,27 @@ MacroAssembler::branchValueIsNurseryCellImpl(Condition cond, const T& value, Reg
     MOZ_ASSERT(cond == Assembler::Equal || cond == Assembler::NotEqual);
     MOZ_ASSERT(temp != InvalidReg);
     Label done, checkAddress, checkObjectAddress;
+#ifdef ENABLE_BIGINT
+    Label checkBigIntAddress;
+#endif
 
     Register tag = temp;
     splitTag(value, tag);
     branchTestObject(Assembler::Equal, tag, &checkObjectAddress);
+#ifdef ENABLE_BIGINT
+    branch32(Assembler::Equal, tag, ImmTag(JSVAL_TAG_BIGINT), &checkBigIntAddress);
+#endif
     branchTestString(Assembler::NotEqual, tag, cond == Assembler::Equal ? &done : label);
 
     unboxString(value, temp);
     jump(&checkAddress);
 
+#ifdef ENABLE_BIGINT
+    bind(&checkBigIntAddress);
+    unboxNonDouble(value, temp, JSVAL_TYPE_BIGINT);
+    jump(&checkAddress);
+#endif
+
     bind(&checkObjectAddress);
     unboxObject(value, temp);
 
@@ -638,6 +650,9 @@ MacroAssembler::wasmLoad(const wasm::MemoryAccessDesc& access, Operand srcAddr,
       case Scalar::Float64:
         loadDouble(srcAddr, out.fpu());
         break;
+      case Scalar::Simd128:
+        loadUnalignedSimd128Int(srcAddr, out.fpu());
+        break;
       case Scalar::Int64:
         MOZ_CRASH("int64 loads must use load64");
       case Scalar::Uint8Clamped:
@@ -679,6 +694,7 @@ MacroAssembler::wasmLoadI64(const wasm::MemoryAccessDesc& access, Operand srcAdd
         break;
       case Scalar::Float32:
       case Scalar::Float64:
+      case Scalar::Simd128:
         MOZ_CRASH("non-int64 loads should use load()");
       case Scalar::Uint8Clamped:
       case Scalar::MaxTypedArrayViewType:
@@ -716,6 +732,9 @@ MacroAssembler::wasmStore(const wasm::MemoryAccessDesc& access, AnyRegister valu
       case Scalar::Float64:
         storeUncanonicalizedDouble(value.fpu(), dstAddr);
         break;
+      case Scalar::Simd128:
+        storeUnalignedSimd128Int(value.fpu(), dstAddr);
+        break;
       case Scalar::Uint8Clamped:
       case Scalar::MaxTypedArrayViewType:
         MOZ_CRASH("unexpected array type");
@@ -831,6 +850,20 @@ MacroAssembler::wasmTruncateFloat32ToUInt64(FloatRegister input, Register64 outp
     bind(oolRejoin);
 }
 
+// ========================================================================
+// Interrupt polls.
+
+void
+MacroAssembler::interruptPoll(const void* page, Label* onInterrupt)
+{
+    // Assembler::InterruptPollTarget relies on the poll being a CMP from
+    // ScratchReg.
+    ScratchRegisterScope scratch(*this);
+    MOZ_ASSERT(scratch == ScratchReg);
+    movePtr(ImmPtr(page), scratch);
+    cmplInterruptPoll(scratch, onInterrupt);
+}
+
 // ========================================================================
 // Convert floating point.
 
@@ -602,11 +602,10 @@ JitRuntime::generateBailoutHandler(MacroAssembler& masm, Label* bailoutTail)
 }
 
 bool
-JitRuntime::generateVMWrapper(JSContext* cx, MacroAssembler& masm, const VMFunction& f)
+JitRuntime::generateVMWrapper(JSContext* cx, MacroAssembler& masm, const VMFunction& f,
+                              uint32_t* wrapperOffset)
 {
-    MOZ_ASSERT(functionWrappers_);
-
-    uint32_t wrapperOffset = startTrampolineCode(masm);
+    *wrapperOffset = startTrampolineCode(masm);
 
     // Avoid conflicts with argument registers while discarding the result after
     // the function call.
@@ -781,7 +780,7 @@ JitRuntime::generateVMWrapper(JSContext* cx, MacroAssembler& masm, const VMFunct
                     f.explicitStackSlots() * sizeof(void*) +
                     f.extraValuesToPop * sizeof(Value)));
 
-    return functionWrappers_->putNew(&f, wrapperOffset);
+    return true;
 }
 
 uint32_t
@@ -860,7 +859,10 @@ JitRuntime::generateDebugTrapHandler(JSContext* cx)
     masm.movePtr(ImmPtr(nullptr), ICStubReg);
     EmitBaselineEnterStubFrame(masm, scratch3);
 
-    TrampolinePtr code = cx->runtime()->jitRuntime()->getVMWrapper(HandleDebugTrapInfo);
+    if (!ensureVMWrapper(cx, HandleDebugTrapInfo)) {
+        return nullptr;
+    }
+    TrampolinePtr code = getVMWrapper(HandleDebugTrapInfo);
     masm.push(scratch1);
     masm.push(scratch2);
     EmitBaselineCallVM(code, masm);
@@ -899,9 +899,8 @@ class AssemblerX86Shared : public AssemblerShared
         }
     }
 
-    // Comparison of EAX against the address given by a Label.
-    JmpSrc cmpSrc(Label* label) {
-        JmpSrc j = masm.cmp_eax();
+    // Link the rel32 immediate of a non-jump instruction to a Label.
+    void linkSrc(JmpSrc j, Label* label) {
         if (label->bound()) {
             // The jump can be immediately patched to the correct destination.
             masm.linkJump(j, JmpDst(label->offset()));
@@ -914,9 +913,22 @@ class AssemblerX86Shared : public AssemblerShared
             label->use(j.offset());
             masm.setNextJump(j, prev);
         }
+    }
+
+    // Comparison of EAX against the address given by a Label.
+    JmpSrc cmpSrc(Label* label) {
+        JmpSrc j = masm.cmp_eax();
+        linkSrc(j, label);
         return j;
     }
 
+    // An interrupt poll reading from |base|, which resumes at |label| when it
+    // faults. See X86Encoding::BaseAssembler::cmpl_mrel32.
+    void cmplInterruptPoll(Register base, Label* label) {
+        JmpSrc j = masm.cmpl_mrel32(base.encoding());
+        linkSrc(j, label);
+    }
+
     JmpSrc jSrc(Condition cond, RepatchLabel* label) {
         JmpSrc j = masm.jCC(static_cast<X86Encoding::Condition>(cond));
         if (label->bound()) {
@@ -2594,6 +2594,20 @@ public:
         return r;
     }
 
+    // Compare the word at |base| with an immediate which is linked to a label
+    // like a jump. The comparison itself is meaningless: the instruction is an
+    // interrupt poll, whose load faults when an interrupt is requested, and
+    // the fault handler resumes execution at the label. The encoding is fixed
+    // so the handler can find the label from the faulting pc.
+    MOZ_MUST_USE JmpSrc
+    cmpl_mrel32(RegisterID base)
+    {
+        m_formatter.oneByteOp(OP_GROUP1_EvIz, 0, base, GROUP1_OP_CMP);
+        JmpSrc r = m_formatter.immediateRel32();
+        spew("cmpl       .Lfrom%d, (%s)", r.offset(), GPReg64Name(base));
+        return r;
+    }
+
     void jmp_i(JmpDst dst)
     {
         int32_t diff = dst.offset() - m_formatter.size();
@@ -31,6 +31,8 @@ using mozilla::FloatingPoint;
 using mozilla::FloorLog2;
 using mozilla::Maybe;
 using mozilla::NegativeInfinity;
+using mozilla::Nothing;
+using mozilla::Some;
 using mozilla::SpecificNaN;
 
 using JS::GenericNaN;
@@ -364,6 +366,12 @@ CodeGenerator::visitWasmSelect(LWasmSelect* ins)
         } else {
             masm.loadDouble(falseExpr, out);
         }
+    } else if (mirType == MIRType::Int32x4) {
+        if (falseExpr.kind() == Operand::FPREG) {
+            masm.moveSimd128Int(ToFloatRegister(ins->falseExpr()), out);
+        } else {
+            masm.loadUnalignedSimd128Int(falseExpr, out);
+        }
     } else {
         MOZ_CRASH("unhandled type in visitWasmSelect!");
     }
@@ -444,6 +452,7 @@ CodeGeneratorX86Shared::visitOutOfLineLoadTypedArrayOutOfBounds(OutOfLineLoadTyp
 {
     switch (ool->viewType()) {
       case Scalar::Int64:
+      case Scalar::Simd128:
       case Scalar::MaxTypedArrayViewType:
         MOZ_CRASH("unexpected array type");
       case Scalar::Float32:
@@ -2889,5 +2898,263 @@ CodeGenerator::visitPopcntI64(LPopcntI64* lir)
     masm.popcnt64(input, output, temp);
 }
 
+void
+CodeGenerator::visitWasmSimd128Constant(LWasmSimd128Constant* ins)
+{
+    const SimdConstant& value = ins->value();
+    FloatRegister out = ToFloatRegister(ins->output());
+
+    static const uint8_t zeroes[16] = {};
+    if (memcmp(value.bytes(), zeroes, sizeof(zeroes)) == 0) {
+        masm.zeroSimd128Int(out);
+        return;
+    }
+    masm.loadConstantSimd128Int(value, out);
+}
+
+void
+CodeGenerator::visitWasmBinarySimd128(LWasmBinarySimd128* ins)
+{
+    FloatRegister lhs = ToFloatRegister(ins->lhs());
+    FloatRegister rhs = ToFloatRegister(ins->rhs());
+    FloatRegister out = ToFloatRegister(ins->output());
+    MOZ_ASSERT(lhs == out, "lhs is reused for the output");
+
+    switch (ins->mir()->simdOp()) {
+      case wasm::SimdOp::I8x16Swizzle: {
+        // pshufb selects a zero for the indices with the top bit set and only
+        // looks at the low four bits of the others, so saturate the indices
+        // above 15 into [0x80, 0xff] to get the zeroes wasm requires.
+        FloatRegister indices = ToFloatRegister(ins->temp());
+        static const SimdConstant saturate = SimdConstant::SplatX16(0x70);
+        masm.moveSimd128Int(rhs, indices);
+        {
+            ScratchSimd128Scope scratch(masm);
+            masm.loadConstantSimd128Int(saturate, scratch);
+            masm.addSatInt8x16(indices, Operand(scratch), SimdSign::Unsigned, indices);
+        }
+        masm.vpshufb(indices, lhs, out);
+        break;
+      }
+      case wasm::SimdOp::I8x16Eq:
+        masm.compareInt8x16(lhs, Operand(rhs), Assembler::Equal, out);
+        break;
+      case wasm::SimdOp::I16x8Eq:
+        masm.compareInt16x8(lhs, Operand(rhs), Assembler::Equal, out);
+        break;
+      case wasm::SimdOp::I32x4Eq:
+        masm.compareInt32x4(lhs, Operand(rhs), Assembler::Equal, out);
+        break;
+      case wasm::SimdOp::F32x4Eq:
+        masm.compareFloat32x4(lhs, Operand(rhs), Assembler::Equal, out);
+        break;
+      case wasm::SimdOp::V128And:
+        masm.bitwiseAndSimdInt(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::V128AndNot:
+        // The operands were swapped during lowering.
+        masm.bitwiseAndNotSimdInt(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::V128Or:
+        masm.bitwiseOrSimdInt(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::V128Xor:
+        masm.bitwiseXorSimdInt(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::I8x16Add:
+        masm.addInt8x16(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::I8x16AddSatS:
+        masm.addSatInt8x16(lhs, Operand(rhs), SimdSign::Signed, out);
+        break;
+      case wasm::SimdOp::I8x16AddSatU:
+        masm.addSatInt8x16(lhs, Operand(rhs), SimdSign::Unsigned, out);
+        break;
+      case wasm::SimdOp::I8x16Sub:
+        masm.subInt8x16(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::I8x16SubSatS:
+        masm.subSatInt8x16(lhs, Operand(rhs), SimdSign::Signed, out);
+        break;
+      case wasm::SimdOp::I8x16SubSatU:
+        masm.subSatInt8x16(lhs, Operand(rhs), SimdSign::Unsigned, out);
+        break;
+      case wasm::SimdOp::I16x8Add:
+        masm.addInt16x8(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::I16x8AddSatS:
+        masm.addSatInt16x8(lhs, Operand(rhs), SimdSign::Signed, out);
+        break;
+      case wasm::SimdOp::I16x8AddSatU:
+        masm.addSatInt16x8(lhs, Operand(rhs), SimdSign::Unsigned, out);
+        break;
+      case wasm::SimdOp::I16x8Sub:
+        masm.subInt16x8(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::I16x8SubSatS:
+        masm.subSatInt16x8(lhs, Operand(rhs), SimdSign::Signed, out);
+        break;
+      case wasm::SimdOp::I16x8SubSatU:
+        masm.subSatInt16x8(lhs, Operand(rhs), SimdSign::Unsigned, out);
+        break;
+      case wasm::SimdOp::I16x8Mul:
+        masm.mulInt16x8(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::I32x4Add:
+        masm.addInt32x4(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::I32x4Sub:
+        masm.subInt32x4(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::I32x4Mul:
+        // SIMD is only enabled with SSE4.1, which has pmulld.
+        masm.mulInt32x4(lhs, Operand(rhs), Nothing(), out);
+        break;
+      case wasm::SimdOp::F32x4Add:
+        masm.addFloat32x4(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::F32x4Sub:
+        masm.subFloat32x4(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::F32x4Mul:
+        masm.mulFloat32x4(lhs, Operand(rhs), out);
+        break;
+      case wasm::SimdOp::F32x4Div:
+        masm.divFloat32x4(lhs, Operand(rhs), out);
+        break;
+      default:
+        MOZ_CRASH("unexpected binary SIMD operation");
+    }
+}
+
+void
+CodeGenerator::visitWasmUnarySimd128(LWasmUnarySimd128* ins)
+{
+    Operand input = Operand(ToFloatRegister(ins->input()));
+    FloatRegister out = ToFloatRegister(ins->output());
+
+    switch (ins->mir()->simdOp()) {
+      case wasm::SimdOp::V128Not:
+        masm.notInt32x4(input, out);
+        break;
+      case wasm::SimdOp::I8x16Neg:
+        masm.negInt8x16(input, out);
+        break;
+      case wasm::SimdOp::I16x8Neg:
+        masm.negInt16x8(input, out);
+        break;
+      case wasm::SimdOp::I32x4Neg:
+        masm.negInt32x4(input, out);
+        break;
+      case wasm::SimdOp::F32x4Abs:
+        masm.absFloat32x4(input, out);
+        break;
+      case wasm::SimdOp::F32x4Neg:
+        masm.negFloat32x4(input, out);
+        break;
+      case wasm::SimdOp::F32x4Sqrt:
+        masm.packedSqrtFloat32x4(input, out);
+        break;
+      default:
+        MOZ_CRASH("unexpected unary SIMD operation");
+    }
+}
+
+void
+CodeGenerator::visitWasmShuffleSimd128(LWasmShuffleSimd128* ins)
+{
+    FloatRegister lhs = ToFloatRegister(ins->lhs());
+    FloatRegister rhs = ToFloatRegister(ins->rhs());
+    FloatRegister out = ToFloatRegister(ins->output());
+    FloatRegister temp = ToFloatRegister(ins->temp());
+
+    uint8_t lanes[16];
+    memcpy(lanes, ins->mir()->lanes().bytes(), sizeof(lanes));
+
+    // SSE4.1 implies SSSE3, so the pshufb path is always taken.
+    masm.shuffleInt8x16(lhs, rhs, out, Some(temp), Nothing(), lanes);
+}
+
+void
+CodeGenerator::visitWasmScalarToSimd128(LWasmScalarToSimd128* ins)
+{
+    FloatRegister out = ToFloatRegister(ins->output());
+
+    switch (ins->mir()->simdOp()) {
+      case wasm::SimdOp::I8x16Splat:
+        masm.splatX16(ToRegister(ins->src()), out);
+        break;
+      case wasm::SimdOp::I16x8Splat:
+        masm.splatX8(ToRegister(ins->src()), out);
+        break;
+      case wasm::SimdOp::I32x4Splat:
+        masm.splatX4(ToRegister(ins->src()), out);
+        break;
+      case wasm::SimdOp::F32x4Splat:
+        masm.splatX4(ToFloatRegister(ins->src()), out);
+        break;
+      default:
+        MOZ_CRASH("unexpected SIMD splat");
+    }
+}
+
+void
+CodeGenerator::visitWasmReduceSimd128(LWasmReduceSimd128* ins)
+{
+    FloatRegister src = ToFloatRegister(ins->src());
+    uint32_t lane = ins->mir()->lane();
+
+    switch (ins->mir()->simdOp()) {
+      case wasm::SimdOp::I8x16ExtractLaneS:
+        masm.extractLaneInt8x16(src, ToRegister(ins->output()), lane, SimdSign::Signed);
+        break;
+      case wasm::SimdOp::I8x16ExtractLaneU:
+        masm.extractLaneInt8x16(src, ToRegister(ins->output()), lane, SimdSign::Unsigned);
+        break;
+      case wasm::SimdOp::I16x8ExtractLaneS:
+        masm.extractLaneInt16x8(src, ToRegister(ins->output()), lane, SimdSign::Signed);
+        break;
+      case wasm::SimdOp::I16x8ExtractLaneU:
+        masm.extractLaneInt16x8(src, ToRegister(ins->output()), lane, SimdSign::Unsigned);
+        break;
+      case wasm::SimdOp::I32x4ExtractLane:
+        masm.extractLaneInt32x4(src, ToRegister(ins->output()), lane);
+        break;
+      case wasm::SimdOp::F32x4ExtractLane:
+        // Wasm does not canonicalize NaNs, see extractLaneFloat32x4.
+        masm.extractLaneFloat32x4(src, ToFloatRegister(ins->output()), lane,
+                                  /* canonicalize = */ false);
+        break;
+      default:
+        MOZ_CRASH("unexpected SIMD lane extraction");
+    }
+}
+
+void
+CodeGenerator::visitWasmReplaceLaneSimd128(LWasmReplaceLaneSimd128* ins)
+{
+    FloatRegister vector = ToFloatRegister(ins->vector());
+    FloatRegister out = ToFloatRegister(ins->output());
+    MOZ_ASSERT(vector == out, "vector is reused for the output");
+    uint32_t lane = ins->mir()->lane();
+
+    switch (ins->mir()->simdOp()) {
+      case wasm::SimdOp::I8x16ReplaceLane:
+        masm.insertLaneSimdInt(vector, ToRegister(ins->value()), out, lane, 16);
+        break;
+      case wasm::SimdOp::I16x8ReplaceLane:
+        masm.insertLaneSimdInt(vector, ToRegister(ins->value()), out, lane, 8);
+        break;
+      case wasm::SimdOp::I32x4ReplaceLane:
+        masm.insertLaneSimdInt(vector, ToRegister(ins->value()), out, lane, 4);
+        break;
+      case wasm::SimdOp::F32x4ReplaceLane:
+        masm.insertLaneFloat32x4(vector, ToFloatRegister(ins->value()), out, lane);
+        break;
+      default:
+        MOZ_CRASH("unexpected SIMD lane replacement");
+    }
+}
+
 } // namespace jit
 } // namespace js
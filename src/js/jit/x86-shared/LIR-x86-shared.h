@@ -373,6 +373,160 @@ class LInt64ToFloatingPoint : public LInstructionHelper<1, INT64_PIECES, 1>
     }
 };
 
+// Wasm SIMD. All the 128-bit values are in Simd128 registers, whatever their
+// lane interpretation.
+
+class LWasmSimd128Constant : public LInstructionHelper<1, 0, 0>
+{
+    SimdConstant value_;
+
+  public:
+    LIR_HEADER(WasmSimd128Constant);
+
+    explicit LWasmSimd128Constant(const SimdConstant& value)
+      : LInstructionHelper(classOpcode),
+        value_(value)
+    {}
+
+    const SimdConstant& value() const {
+        return value_;
+    }
+};
+
+class LWasmBinarySimd128 : public LInstructionHelper<1, 2, 1>
+{
+  public:
+    LIR_HEADER(WasmBinarySimd128);
+
+    LWasmBinarySimd128(const LAllocation& lhs, const LAllocation& rhs, const LDefinition& temp)
+      : LInstructionHelper(classOpcode)
+    {
+        setOperand(0, lhs);
+        setOperand(1, rhs);
+        setTemp(0, temp);
+    }
+
+    const LAllocation* lhs() {
+        return getOperand(0);
+    }
+    const LAllocation* rhs() {
+        return getOperand(1);
+    }
+    const LDefinition* temp() {
+        return getTemp(0);
+    }
+    MWasmBinarySimd128* mir() const {
+        return mir_->toWasmBinarySimd128();
+    }
+};
+
+class LWasmUnarySimd128 : public LInstructionHelper<1, 1, 0>
+{
+  public:
+    LIR_HEADER(WasmUnarySimd128);
+
+    explicit LWasmUnarySimd128(const LAllocation& input)
+      : LInstructionHelper(classOpcode)
+    {
+        setOperand(0, input);
+    }
+
+    const LAllocation* input() {
+        return getOperand(0);
+    }
+    MWasmUnarySimd128* mir() const {
+        return mir_->toWasmUnarySimd128();
+    }
+};
+
+class LWasmShuffleSimd128 : public LInstructionHelper<1, 2, 1>
+{
+  public:
+    LIR_HEADER(WasmShuffleSimd128);
+
+    LWasmShuffleSimd128(const LAllocation& lhs, const LAllocation& rhs, const LDefinition& temp)
+      : LInstructionHelper(classOpcode)
+    {
+        setOperand(0, lhs);
+        setOperand(1, rhs);
+        setTemp(0, temp);
+    }
+
+    const LAllocation* lhs() {
+        return getOperand(0);
+    }
+    const LAllocation* rhs() {
+        return getOperand(1);
+    }
+    const LDefinition* temp() {
+        return getTemp(0);
+    }
+    MWasmShuffleSimd128* mir() const {
+        return mir_->toWasmShuffleSimd128();
+    }
+};
+
+class LWasmScalarToSimd128 : public LInstructionHelper<1, 1, 0>
+{
+  public:
+    LIR_HEADER(WasmScalarToSimd128);
+
+    explicit LWasmScalarToSimd128(const LAllocation& src)
+      : LInstructionHelper(classOpcode)
+    {
+        setOperand(0, src);
+    }
+
+    const LAllocation* src() {
+        return getOperand(0);
+    }
+    MWasmScalarToSimd128* mir() const {
+        return mir_->toWasmScalarToSimd128();
+    }
+};
+
+class LWasmReduceSimd128 : public LInstructionHelper<1, 1, 0>
+{
+  public:
+    LIR_HEADER(WasmReduceSimd128);
+
+    explicit LWasmReduceSimd128(const LAllocation& src)
+      : LInstructionHelper(classOpcode)
+    {
+        setOperand(0, src);
+    }
+
+    const LAllocation* src() {
+        return getOperand(0);
+    }
+    MWasmReduceSimd128* mir() const {
+        return mir_->toWasmReduceSimd128();
+    }
+};
+
+class LWasmReplaceLaneSimd128 : public LInstructionHelper<1, 2, 0>
+{
+  public:
+    LIR_HEADER(WasmReplaceLaneSimd128);
+
+    LWasmReplaceLaneSimd128(const LAllocation& vector, const LAllocation& value)
+      : LInstructionHelper(classOpcode)
+    {
+        setOperand(0, vector);
+        setOperand(1, value);
+    }
+
+    const LAllocation* vector() {
+        return getOperand(0);
+    }
+    const LAllocation* value() {
+        return getOperand(1);
+    }
+    MWasmReplaceLaneSimd128* mir() const {
+        return mir_->toWasmReplaceLaneSimd128();
+    }
+};
+
 } // namespace jit
 } // namespace js
 
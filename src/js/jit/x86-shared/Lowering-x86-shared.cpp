@@ -357,6 +357,7 @@ LIRGenerator::visitAsmJSStoreHeap(MAsmJSStoreHeap* ins)
                                             limitAlloc, memoryBaseAlloc);
         break;
       case Scalar::Int64:
+      case Scalar::Simd128:
         MOZ_CRASH("NYI");
       case Scalar::Uint8Clamped:
       case Scalar::MaxTypedArrayViewType:
@@ -711,3 +712,70 @@ LIRGenerator::visitCopySign(MCopySign* ins)
         define(lir, ins);
     }
 }
+
+void
+LIRGenerator::visitWasmSimd128Constant(MWasmSimd128Constant* ins)
+{
+    define(new(alloc()) LWasmSimd128Constant(ins->value()), ins);
+}
+
+void
+LIRGenerator::visitWasmBinarySimd128(MWasmBinarySimd128* ins)
+{
+    MDefinition* lhs = ins->lhs();
+    MDefinition* rhs = ins->rhs();
+
+    // The x86 encodings compute ~lhs & rhs where wasm wants lhs & ~rhs.
+    if (ins->simdOp() == wasm::SimdOp::V128AndNot) {
+        Swap(lhs, rhs);
+    }
+
+    // The swizzle indices are saturated into a temp before the pshufb.
+    LDefinition indexTemp = ins->simdOp() == wasm::SimdOp::I8x16Swizzle
+                            ? temp(LDefinition::SIMD128INT)
+                            : LDefinition::BogusTemp();
+
+    // The rhs stays in a register: SSE requires the memory operands of the
+    // packed instructions to be 16-byte aligned, which stack slots are not.
+    auto* lir = new(alloc()) LWasmBinarySimd128(useRegisterAtStart(lhs),
+                                                lhs != rhs ? useRegister(rhs)
+                                                           : useRegisterAtStart(rhs),
+                                                indexTemp);
+    defineReuseInput(lir, ins, 0);
+}
+
+void
+LIRGenerator::visitWasmUnarySimd128(MWasmUnarySimd128* ins)
+{
+    // The masm helpers write the output before they read the input.
+    define(new(alloc()) LWasmUnarySimd128(useRegister(ins->input())), ins);
+}
+
+void
+LIRGenerator::visitWasmShuffleSimd128(MWasmShuffleSimd128* ins)
+{
+    auto* lir = new(alloc()) LWasmShuffleSimd128(useRegister(ins->lhs()),
+                                                 useRegister(ins->rhs()),
+                                                 temp(LDefinition::SIMD128INT));
+    define(lir, ins);
+}
+
+void
+LIRGenerator::visitWasmScalarToSimd128(MWasmScalarToSimd128* ins)
+{
+    define(new(alloc()) LWasmScalarToSimd128(useRegisterAtStart(ins->input())), ins);
+}
+
+void
+LIRGenerator::visitWasmReduceSimd128(MWasmReduceSimd128* ins)
+{
+    define(new(alloc()) LWasmReduceSimd128(useRegisterAtStart(ins->input())), ins);
+}
+
+void
+LIRGenerator::visitWasmReplaceLaneSimd128(MWasmReplaceLaneSimd128* ins)
+{
+    auto* lir = new(alloc()) LWasmReplaceLaneSimd128(useRegisterAtStart(ins->vector()),
+                                                     useRegister(ins->value()));
+    defineReuseInput(lir, ins, 0);
+}
@@ -797,7 +797,7 @@ MacroAssembler::wasmBoundsCheck(Condition cond, Register index, Register boundsC
 {
     cmp32(index, boundsCheckLimit);
     j(cond, label);
-    if (JitOptions.spectreIndexMasking) {
+    if (spectre_.indexMasking) {
         cmovCCl(cond, Operand(boundsCheckLimit), index);
     }
 }
@@ -807,7 +807,7 @@ MacroAssembler::wasmBoundsCheck(Condition cond, Register index, Address boundsCh
 {
     cmp32(index, Operand(boundsCheckLimit));
     j(cond, label);
-    if (JitOptions.spectreIndexMasking) {
+    if (spectre_.indexMasking) {
         cmovCCl(cond, Operand(boundsCheckLimit), index);
     }
 }
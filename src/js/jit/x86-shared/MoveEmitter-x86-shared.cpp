@@ -264,19 +264,19 @@ MoveEmitterX86::breakCycle(const MoveOperand& to, MoveOp::Type type)
       case MoveOp::SIMD128INT:
         if (to.isMemory()) {
             ScratchSimd128Scope scratch(masm);
-            masm.loadAlignedSimd128Int(toAddress(to), scratch);
-            masm.storeAlignedSimd128Int(scratch, cycleSlot());
+            masm.loadUnalignedSimd128Int(toAddress(to), scratch);
+            masm.storeUnalignedSimd128Int(scratch, cycleSlot());
         } else {
-            masm.storeAlignedSimd128Int(to.floatReg(), cycleSlot());
+            masm.storeUnalignedSimd128Int(to.floatReg(), cycleSlot());
         }
         break;
       case MoveOp::SIMD128FLOAT:
         if (to.isMemory()) {
             ScratchSimd128Scope scratch(masm);
-            masm.loadAlignedSimd128Float(toAddress(to), scratch);
-            masm.storeAlignedSimd128Float(scratch, cycleSlot());
+            masm.loadUnalignedSimd128Float(toAddress(to), scratch);
+            masm.storeUnalignedSimd128Float(scratch, cycleSlot());
         } else {
-            masm.storeAlignedSimd128Float(to.floatReg(), cycleSlot());
+            masm.storeUnalignedSimd128Float(to.floatReg(), cycleSlot());
         }
         break;
       case MoveOp::FLOAT32:
@@ -331,10 +331,10 @@ MoveEmitterX86::completeCycle(const MoveOperand& to, MoveOp::Type type)
         MOZ_ASSERT(pushedAtCycle_ - pushedAtStart_ >= Simd128DataSize);
         if (to.isMemory()) {
             ScratchSimd128Scope scratch(masm);
-            masm.loadAlignedSimd128Int(cycleSlot(), scratch);
-            masm.storeAlignedSimd128Int(scratch, toAddress(to));
+            masm.loadUnalignedSimd128Int(cycleSlot(), scratch);
+            masm.storeUnalignedSimd128Int(scratch, toAddress(to));
         } else {
-            masm.loadAlignedSimd128Int(cycleSlot(), to.floatReg());
+            masm.loadUnalignedSimd128Int(cycleSlot(), to.floatReg());
         }
         break;
       case MoveOp::SIMD128FLOAT:
@@ -342,10 +342,10 @@ MoveEmitterX86::completeCycle(const MoveOperand& to, MoveOp::Type type)
         MOZ_ASSERT(pushedAtCycle_ - pushedAtStart_ >= Simd128DataSize);
         if (to.isMemory()) {
             ScratchSimd128Scope scratch(masm);
-            masm.loadAlignedSimd128Float(cycleSlot(), scratch);
-            masm.storeAlignedSimd128Float(scratch, toAddress(to));
+            masm.loadUnalignedSimd128Float(cycleSlot(), scratch);
+            masm.storeUnalignedSimd128Float(scratch, toAddress(to));
         } else {
-            masm.loadAlignedSimd128Float(cycleSlot(), to.floatReg());
+            masm.loadUnalignedSimd128Float(cycleSlot(), to.floatReg());
         }
         break;
       case MoveOp::FLOAT32:
@@ -505,6 +505,8 @@ MoveEmitterX86::emitDoubleMove(const MoveOperand& from, const MoveOperand& to)
     }
 }
 
+// Stack slots are not SIMD-aligned in wasm frames, so 128-bit values are always
+// moved to and from memory with unaligned accesses.
 void
 MoveEmitterX86::emitSimd128IntMove(const MoveOperand& from, const MoveOperand& to)
 {
@@ -515,16 +517,16 @@ MoveEmitterX86::emitSimd128IntMove(const MoveOperand& from, const MoveOperand& t
         if (to.isFloatReg()) {
             masm.moveSimd128Int(from.floatReg(), to.floatReg());
         } else {
-            masm.storeAlignedSimd128Int(from.floatReg(), toAddress(to));
+            masm.storeUnalignedSimd128Int(from.floatReg(), toAddress(to));
         }
     } else if (to.isFloatReg()) {
-        masm.loadAlignedSimd128Int(toAddress(from), to.floatReg());
+        masm.loadUnalignedSimd128Int(toAddress(from), to.floatReg());
     } else {
         // Memory to memory move.
         MOZ_ASSERT(from.isMemory());
         ScratchSimd128Scope scratch(masm);
-        masm.loadAlignedSimd128Int(toAddress(from), scratch);
-        masm.storeAlignedSimd128Int(scratch, toAddress(to));
+        masm.loadUnalignedSimd128Int(toAddress(from), scratch);
+        masm.storeUnalignedSimd128Int(scratch, toAddress(to));
     }
 }
 
@@ -538,16 +540,16 @@ MoveEmitterX86::emitSimd128FloatMove(const MoveOperand& from, const MoveOperand&
         if (to.isFloatReg()) {
             masm.moveSimd128Float(from.floatReg(), to.floatReg());
         } else {
-            masm.storeAlignedSimd128Float(from.floatReg(), toAddress(to));
+            masm.storeUnalignedSimd128Float(from.floatReg(), toAddress(to));
         }
     } else if (to.isFloatReg()) {
-        masm.loadAlignedSimd128Float(toAddress(from), to.floatReg());
+        masm.loadUnalignedSimd128Float(toAddress(from), to.floatReg());
     } else {
         // Memory to memory move.
         MOZ_ASSERT(from.isMemory());
         ScratchSimd128Scope scratch(masm);
-        masm.loadAlignedSimd128Float(toAddress(from), scratch);
-        masm.storeAlignedSimd128Float(scratch, toAddress(to));
+        masm.loadUnalignedSimd128Float(toAddress(from), scratch);
+        masm.storeUnalignedSimd128Float(scratch, toAddress(to));
     }
 }
 
@@ -545,7 +545,8 @@ JS::ContextOptionsRef(JSContext* cx)
 }
 
 JS_PUBLIC_API(bool)
-JS::InitSelfHostedCode(JSContext* cx)
+JS::InitSelfHostedCode(JSContext* cx, const TranscodeRange& xdrCache,
+                       SelfHostedWriter xdrWriter)
 {
     MOZ_RELEASE_ASSERT(!cx->runtime()->hasInitializedSelfHosting(),
                        "JS::InitSelfHostedCode() called more than once");
@@ -564,7 +565,7 @@ JS::InitSelfHostedCode(JSContext* cx)
     }
 #endif
 
-    if (!rt->initSelfHosting(cx)) {
+    if (!rt->initSelfHosting(cx, xdrCache, xdrWriter)) {
         return false;
     }
 
@@ -3307,13 +3308,15 @@ JS::PropertySpecNameToPermanentId(JSContext* cx, const char* name, jsid* idp)
                                 js::PinAtom);
 }
 
-JS_PUBLIC_API(bool)
-JS_DefineProperties(JSContext* cx, HandleObject obj, const JSPropertySpec* ps)
+bool
+js::DefineProperties(JSContext* cx, HandleObject obj, const JSPropertySpec* ps, const jsid* ids)
 {
     RootedId id(cx);
 
     for (; ps->name; ps++) {
-        if (!PropertySpecNameToId(cx, ps->name, &id)) {
+        if (ids) {
+            id = *ids++;
+        } else if (!PropertySpecNameToId(cx, ps->name, &id)) {
             return false;
         }
 
@@ -3349,6 +3352,12 @@ JS_DefineProperties(JSContext* cx, HandleObject obj, const JSPropertySpec* ps)
     return true;
 }
 
+JS_PUBLIC_API(bool)
+JS_DefineProperties(JSContext* cx, HandleObject obj, const JSPropertySpec* ps)
+{
+    return DefineProperties(cx, obj, ps);
+}
+
 JS_PUBLIC_API(bool)
 JS::ObjectToCompletePropertyDescriptor(JSContext* cx,
                                        HandleObject obj,
@@ -3868,6 +3877,7 @@ JS::TransitiveCompileOptions::copyPODTransitiveOptions(const TransitiveCompileOp
     hasIntroductionInfo = rhs.hasIntroductionInfo;
     isProbablySystemCode = rhs.isProbablySystemCode;
     hideScriptFromDebugger = rhs.hideScriptFromDebugger;
+    eagerFunctionsSourceLength = rhs.eagerFunctionsSourceLength;
 };
 
 void
@@ -5621,6 +5631,24 @@ JS_Stringify(JSContext* cx, MutableHandleValue vp, HandleObject replacer,
     return callback(sb.rawTwoByteBegin(), sb.length(), data);
 }
 
+JS_PUBLIC_API(bool)
+JS_StringifyToUTF8(JSContext* cx, MutableHandleValue vp, HandleObject replacer,
+                   HandleValue space, mozilla::Vector<char>& out)
+{
+    AssertHeapIsIdle();
+    CHECK_THREAD(cx);
+    cx->check(replacer, space);
+    size_t initialLength = out.length();
+    if (!StringifyToUTF8(cx, vp, replacer, space, out)) {
+        return false;
+    }
+    if (out.length() == initialLength && !out.append("null", 4)) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+    return true;
+}
+
 JS_PUBLIC_API(bool)
 JS::ToJSONMaybeSafely(JSContext* cx, JS::HandleObject input,
                       JSONWriteCallback callback, void* data)
@@ -7115,6 +7143,12 @@ JS::DeserializeWasmModule(PRFileDesc* bytecode, UniqueChars filename, unsigned l
     return wasm::DeserializeModule(bytecode, std::move(filename), line);
 }
 
+JS_PUBLIC_API(RefPtr<JS::WasmModule>)
+JS::DeserializeWasmModuleFromFile(const char* filename)
+{
+    return wasm::DeserializeModuleFromFile(filename);
+}
+
 JS_PUBLIC_API(void)
 JS::SetProcessLargeAllocationFailureCallback(JS::LargeAllocationFailureCallback lafc)
 {
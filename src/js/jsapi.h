@@ -495,6 +495,10 @@ class JS_PUBLIC_API(ContextOptions) {
 #ifdef ENABLE_WASM_GC
         wasmGc_(false),
 #endif
+#ifdef ENABLE_WASM_SIMD
+        wasmSimd_(false),
+#endif
+        wasmFunctionCounts_(false),
         testWasmAwaitTier2_(false),
         throwOnAsmJSValidationFailure_(false),
         nativeRegExp_(true),
@@ -600,6 +604,20 @@ class JS_PUBLIC_API(ContextOptions) {
     }
 #endif
 
+#ifdef ENABLE_WASM_SIMD
+    bool wasmSimd() const { return wasmSimd_; }
+    ContextOptions& setWasmSimd(bool flag) {
+        wasmSimd_ = flag;
+        return *this;
+    }
+#endif
+
+    bool wasmFunctionCounts() const { return wasmFunctionCounts_; }
+    ContextOptions& setWasmFunctionCounts(bool flag) {
+        wasmFunctionCounts_ = flag;
+        return *this;
+    }
+
     bool throwOnAsmJSValidationFailure() const { return throwOnAsmJSValidationFailure_; }
     ContextOptions& setThrowOnAsmJSValidationFailure(bool flag) {
         throwOnAsmJSValidationFailure_ = flag;
@@ -698,6 +716,10 @@ class JS_PUBLIC_API(ContextOptions) {
 #ifdef ENABLE_WASM_GC
     bool wasmGc_ : 1;
 #endif
+#ifdef ENABLE_WASM_SIMD
+    bool wasmSimd_ : 1;
+#endif
+    bool wasmFunctionCounts_ : 1;
     bool testWasmAwaitTier2_ : 1;
     bool throwOnAsmJSValidationFailure_ : 1;
     bool nativeRegExp_ : 1;
@@ -716,13 +738,30 @@ class JS_PUBLIC_API(ContextOptions) {
 JS_PUBLIC_API(ContextOptions&)
 ContextOptionsRef(JSContext* cx);
 
+/**
+ * Called with the XDR bytecode of the self-hosted code after it has been
+ * compiled from source, so that the embedding can save it and pass it to
+ * later InitSelfHostedCode calls. Return false to fail initialization.
+ */
+typedef bool
+(* SelfHostedWriter)(JSContext* cx, const TranscodeRange& xdr);
+
 /**
  * Initialize the runtime's self-hosted code. Embeddings should call this
  * exactly once per runtime/context, before the first JS_NewGlobalObject
  * call.
+ *
+ * Compiling the self-hosted code from source is a large part of the cost of
+ * starting a runtime. An embedding which starts many runtimes can save the
+ * bytecode passed to |xdrWriter| once, for example to a file, and pass it as
+ * |xdrCache| from then on: the self-hosted code is then decoded from it rather
+ * than compiled. Both need a build id (see JS::SetProcessBuildIdOp), and a
+ * cache from a different build is ignored. |xdrCache| only needs to live
+ * until this returns, so it can be a mapped file.
  */
 JS_PUBLIC_API(bool)
-InitSelfHostedCode(JSContext* cx);
+InitSelfHostedCode(JSContext* cx, const TranscodeRange& xdrCache = TranscodeRange(),
+                   SelfHostedWriter xdrWriter = nullptr);
 
 /**
  * Asserts (in debug and release builds) that `obj` belongs to the current
@@ -1502,7 +1541,8 @@ class JS_PUBLIC_API(RealmCreationOptions)
         sharedMemoryAndAtomics_(false),
         streams_(false),
         secureContext_(false),
-        clampAndJitterTime_(true)
+        clampAndJitterTime_(true),
+        spectreMitigations_(true)
     {}
 
     JSTraceOp getTrace() const {
@@ -1588,6 +1628,17 @@ class JS_PUBLIC_API(RealmCreationOptions)
         return *this;
     }
 
+    // Whether JIT code for this realm uses the Spectre mitigations enabled by
+    // JS_SetGlobalJitCompilerOption. Embeddings can turn them off for realms
+    // which only ever run trusted code. The setting belongs to the realm's
+    // zone, since JIT code is shared within a zone: it takes effect for a
+    // realm which gets a new zone, and other realms must match their zone.
+    bool spectreMitigations() const { return spectreMitigations_; }
+    RealmCreationOptions& setSpectreMitigations(bool flag) {
+        spectreMitigations_ = flag;
+        return *this;
+    }
+
   private:
     JSTraceOp traceGlobal_;
     CompartmentSpecifier compSpec_;
@@ -1603,6 +1654,7 @@ class JS_PUBLIC_API(RealmCreationOptions)
     bool streams_;
     bool secureContext_;
     bool clampAndJitterTime_;
+    bool spectreMitigations_;
 };
 
 /**
@@ -2857,7 +2909,10 @@ extern JS_PUBLIC_API(JSObject*)
 JS_NewMappedArrayBufferWithContents(JSContext* cx, size_t nbytes, void* contents);
 
 /**
- * Create memory mapped array buffer contents.
+ * Create memory mapped array buffer contents for the |length| bytes of the file
+ * |fd| starting at |offset|, which must be a multiple of 8. Pages of the file
+ * are only read when they're first touched, so this doesn't read the file into
+ * memory. Returns null if the region isn't within the file or can't be mapped.
  * Caller must take care of closing fd after calling this function.
  */
 extern JS_PUBLIC_API(void*)
@@ -2873,6 +2928,44 @@ JS_CreateMappedArrayBufferContents(int fd, size_t offset, size_t length);
 extern JS_PUBLIC_API(void)
 JS_ReleaseMappedArrayBufferContents(void* contents, size_t length);
 
+namespace JS {
+
+/**
+ * How the contents of a mapped array buffer will be read, so the OS can page
+ * the file in ahead of use, or avoid doing so.
+ */
+enum class MappedArrayBufferAdvice : uint8_t {
+    // No particular pattern. This is the default for new mappings.
+    Normal,
+
+    // Mostly in order of increasing address: read ahead aggressively, and
+    // drop pages soon after they've been read.
+    Sequential,
+
+    // In no particular order: don't read ahead.
+    Random,
+
+    // Soon: start reading the range in now.
+    WillNeed
+};
+
+} /* namespace JS */
+
+/**
+ * Tell the OS how the |length| bytes at |contents|, all of which must be part
+ * of the same mapped array buffer contents, will be read. |contents| can be
+ * the pointer returned by JS_CreateMappedArrayBufferContents, or a pointer
+ * into the data of a mapped array buffer object, so that huge files can be
+ * advised a region at a time.
+ *
+ * The advice only affects paging, never the contents. Mappings are always
+ * copy-on-write: writes to the buffer are private and never reach the file.
+ * Returns false if the OS doesn't support the advice.
+ */
+extern JS_PUBLIC_API(bool)
+JS_AdviseMappedArrayBufferContents(void* contents, size_t length,
+                                   JS::MappedArrayBufferAdvice advice);
+
 extern JS_PUBLIC_API(JS::Value)
 JS_GetReservedSlot(JSObject* obj, uint32_t index);
 
@@ -4520,6 +4613,75 @@ JS_SetParallelParsingEnabled(JSContext* cx, bool enabled);
 extern JS_PUBLIC_API(void)
 JS_SetOffthreadIonCompilationEnabled(JSContext* cx, bool enabled);
 
+namespace JS {
+
+typedef void
+(* HelperThreadTaskCallback)();
+
+/*
+ * Run the engine's helper thread work (off-thread Ion and wasm compilation,
+ * parsing, source compression, parallel GC tasks and so on) on the embedder's
+ * own thread pool instead of threads created by the engine. This must be
+ * called after JS_Init and before the first context is created.
+ * |threadCount| is the most tasks that may run at once.
+ *
+ * Whenever there may be a task to run, the engine calls |callback|, which
+ * should arrange for JS::RunHelperThreadTask to be called once on one of the
+ * pool's threads. The callback may be called on any thread with engine locks
+ * held, so it must not block or call into the engine.
+ */
+extern JS_PUBLIC_API(void)
+SetHelperThreadTaskCallback(HelperThreadTaskCallback callback, size_t threadCount);
+
+/*
+ * Run the highest priority helper thread task, if any, on the current thread.
+ * This thread must not have a JSContext of its own, and must have about 2MB of
+ * stack. It must not be called after JS_ShutDown.
+ */
+extern JS_PUBLIC_API(void)
+RunHelperThreadTask();
+
+/*
+ * Bind each of the engine's helper threads to a NUMA node, spreading them
+ * over all of the nodes, so they don't migrate between nodes. This must be
+ * called before the first context is created, and has no effect on tasks run
+ * by JS::RunHelperThreadTask.
+ */
+extern JS_PUBLIC_API(void)
+SetHelperThreadNumaPinning(bool pin);
+
+/*
+ * Set the number of CPUs helper thread work may use, which also sets how many
+ * helper threads take tasks. Pass 0 to detect it again from the cores and CPU
+ * quota available to the process, for example after a container's quota has
+ * changed. This may be called at any time, but can't raise the count above
+ * the number of helper threads created at startup, which depends on the
+ * number of cores in the machine.
+ */
+extern JS_PUBLIC_API(void)
+SetHelperThreadCPUCount(size_t count);
+
+enum class HelperThreadTaskKind : uint8_t
+{
+    Ion,
+    Wasm,
+    PromiseTask,
+    Parse,
+    Compression,
+    GCParallel,
+
+    Limit
+};
+
+/*
+ * Limit how many helper threads may run tasks of the given kind at once, or
+ * pass 0 to go back to the default limit, which depends on the CPU count.
+ */
+extern JS_PUBLIC_API(void)
+SetHelperThreadTaskLimit(HelperThreadTaskKind kind, size_t maxThreads);
+
+} /* namespace JS */
+
 #define JIT_COMPILER_OPTIONS(Register)                                      \
     Register(BASELINE_WARMUP_TRIGGER, "baseline.warmup.trigger")            \
     Register(ION_WARMUP_TRIGGER, "ion.warmup.trigger")                      \
@@ -4802,6 +4964,18 @@ GetWasmModule(HandleObject obj);
 extern JS_PUBLIC_API(RefPtr<WasmModule>)
 DeserializeWasmModule(PRFileDesc* bytecode, JS::UniqueChars filename, unsigned line);
 
+/**
+ * Deserialize a module from a file holding the bytes that were passed to
+ * OptimizedEncodingListener::storeOptimizedEncoding() by this build. Where the
+ * platform allows it, the module's machine code is mapped copy-on-write from
+ * the file instead of being read and copied, and only the pages which need
+ * relocating are written. Returns null if the file cannot be read or was
+ * written by a different build.
+ */
+
+extern JS_PUBLIC_API(RefPtr<WasmModule>)
+DeserializeWasmModuleFromFile(const char* filename);
+
 /**
  * Convenience class for imitating a JS level for-of loop. Typical usage:
  *
@@ -5127,6 +5301,12 @@ struct JS_PUBLIC_API(PerformanceGroup) {
     uint64_t recentCPOW(uint64_t iteration) const;
     void addRecentCPOW(uint64_t iteration, uint64_t CPOW);
 
+    // The number of samples charged to this group by sampling-based CPU
+    // accounting (see `SetCpuSamplingInterval`). Unlike the counters above,
+    // this is never reset.
+    uint64_t cpuSamples() const;
+    void addCpuSamples(uint64_t samples);
+
     // Get rid of any data that pretends to be recent.
     void resetRecentData();
 
@@ -5159,6 +5339,9 @@ struct JS_PUBLIC_API(PerformanceGroup) {
     // iteration of the event loop.
     uint64_t recentCPOW_;
 
+    // The number of samples charged to this group.
+    uint64_t cpuSamples_;
+
     // The current iteration of the event loop. If necessary,
     // may safely overflow.
     uint64_t iteration_;
@@ -5233,6 +5416,26 @@ GetPerfMonitoringTestCpuRescheduling(JSContext*, uint64_t* stayed, uint64_t* mov
 extern JS_PUBLIC_API(void)
 AddCPOWPerformanceDelta(JSContext*, uint64_t delta);
 
+/**
+ * Turn on/off sampling-based CPU accounting.
+ *
+ * While it is on, the context is interrupted every `intervalMicroseconds`,
+ * and one sample is charged to the realm it is running code in, and to each
+ * of that realm's performance groups (see `PerformanceGroup::cpuSamples`).
+ * Unlike the stopwatch, this adds no cost when entering and leaving realms,
+ * and also counts time spent in JIT code. An interval of 0 turns it off.
+ *
+ * May return `false` if sampling could not be started.
+ */
+extern JS_PUBLIC_API(bool)
+SetCpuSamplingInterval(JSContext*, uint32_t intervalMicroseconds);
+
+/**
+ * The number of CPU samples charged to a realm.
+ */
+extern JS_PUBLIC_API(uint64_t)
+GetRealmCpuSamples(JS::Realm*);
+
 typedef bool
 (*StopwatchStartCallback)(uint64_t, void*);
 extern JS_PUBLIC_API(bool)
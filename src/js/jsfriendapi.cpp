@@ -1631,3 +1631,25 @@ js::LogDtor(void* self, const char* type, uint32_t sz)
         fun(self, type, sz);
     }
 }
+
+JS_FRIEND_API(void)
+js::SetSourceCompressionCodec(JSContext* cx, SourceCompressionCodec codec)
+{
+    cx->runtime()->setSourceCompressionCodec(codec);
+}
+
+JS_FRIEND_API(void)
+js::SetUncompressedSourceCacheMaxBytes(JSContext* cx, size_t maxBytes)
+{
+    cx->runtime()->caches().uncompressedSourceCache.setMaxBytes(maxBytes);
+}
+
+JS_FRIEND_API(JS::UniqueChars)
+js::RenderGCHistograms(JSContext* cx, GCHistogramFormat format)
+{
+    gcstats::Statistics& stats = cx->runtime()->gc.stats();
+    if (format == GCHistogramFormat::Prometheus) {
+        return stats.renderHistogramsPrometheus();
+    }
+    return stats.renderHistogramsJson();
+}
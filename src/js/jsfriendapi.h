@@ -1172,6 +1172,45 @@ StopPCCountProfiling(JSContext* cx);
 JS_FRIEND_API(void)
 PurgePCCounts(JSContext* cx);
 
+/*
+ * Start sampling the JS stack of |cx| every |intervalMicroseconds|. Samples
+ * are taken when the context handles the interrupts requested by a sampler
+ * thread, so they only land at interrupt checks in running code.
+ */
+JS_FRIEND_API(bool)
+StartStackSampling(JSContext* cx, uint32_t intervalMicroseconds);
+
+/*
+ * Stop the sampling started by StartStackSampling and, if |fp| is not null,
+ * write the profile to it in the Chrome DevTools .cpuprofile format.
+ */
+JS_FRIEND_API(bool)
+StopStackSampling(JSContext* cx, FILE* fp);
+
+/*
+ * Write the state of the inline caches of all Baseline and Ion compiled
+ * scripts to |fp| as JSON: for each IC, its bytecode location, ICState mode,
+ * number of attached stubs, the kinds of those stubs and the number of times
+ * the IC's fallback path has been taken.
+ */
+JS_FRIEND_API(bool)
+DumpICStats(JSContext* cx, FILE* fp);
+
+/*
+ * Start or stop recording, for each kind of engine mutex, how often it is
+ * acquired and contended, and how long threads wait for it and hold it. This
+ * slows down every lock and unlock while enabled. Returns false on OOM.
+ */
+JS_FRIEND_API(bool)
+SetMutexContentionProfiling(bool enabled);
+
+/*
+ * Print the totals recorded since contention profiling was first enabled to
+ * |fp|, as a table.
+ */
+JS_FRIEND_API(void)
+DumpMutexContentionProfile(FILE* fp);
+
 JS_FRIEND_API(size_t)
 GetPCCountScriptCount(JSContext* cx);
 
@@ -1538,6 +1577,11 @@ enum Type {
     MaxTypedArrayViewType,
 
     Int64,
+
+    /**
+     * A 128-bit wasm SIMD value, only used for memory accesses.
+     */
+    Simd128,
 };
 
 static inline size_t
@@ -1558,6 +1602,7 @@ byteSize(Type atype)
       case Int64:
       case Float64:
         return 8;
+      case Simd128:
         return 16;
       default:
         MOZ_CRASH("invalid scalar type");
@@ -1578,6 +1623,7 @@ isSignedIntType(Type atype) {
       case Uint32:
       case Float32:
       case Float64:
+      case Simd128:
         return false;
       default:
         MOZ_CRASH("invalid scalar type");
@@ -2987,6 +3033,74 @@ LogDtor(void* self, const char* type, uint32_t sz);
 #define JS_COUNT_DTOR(Class)                            \
     LogDtor((void*) this, #Class, sizeof(Class))
 
+typedef void
+(* BailoutSiteCallback)(void* data, JSScript* script, uint32_t pcOffset, const char* kind,
+                        uint32_t count);
+
+typedef void
+(* InvalidationCallback)(void* data, JSScript* script, uint32_t count);
+
+/**
+ * Report the bailouts and invalidations of Ion code recorded for the live
+ * scripts in the runtime. |siteCallback| is called once for each script,
+ * bytecode offset and kind of bailout, and |invalidationCallback| once for
+ * each script whose Ion code was invalidated. Either may be null. The
+ * callbacks must not GC or run script.
+ */
+extern JS_FRIEND_API(void)
+IterateBailoutCounts(JSContext* cx, void* data, BailoutSiteCallback siteCallback,
+                     InvalidationCallback invalidationCallback);
+
+/**
+ * Return the number of bytes of JIT code discarded so far because the scripts
+ * which owned it had not run during the last few GCs.
+ */
+extern JS_FRIEND_API(uint64_t)
+GetAgedJitCodeBytesDiscarded(JSContext* cx);
+
+enum class SourceCompressionCodec : uint8_t
+{
+    // Deflate, which gives the smallest sources.
+    Zlib,
+
+    // LZ4, which compresses less but decompresses several times faster, for
+    // embeddings which often need the source of functions.
+    LZ4
+};
+
+/**
+ * Set the codec used to compress the sources of scripts compiled from now on.
+ * Sources which are already compressed keep the codec they were compressed
+ * with.
+ */
+extern JS_FRIEND_API(void)
+SetSourceCompressionCodec(JSContext* cx, SourceCompressionCodec codec);
+
+/**
+ * Limit the memory used to cache decompressed chunks of source. When adding a
+ * chunk would take the cache over |maxBytes| the cache is emptied first. By
+ * default the cache is only emptied by GC; embeddings can pick a limit based
+ * on the memory of the device. Zero removes the limit.
+ */
+extern JS_FRIEND_API(void)
+SetUncompressedSourceCacheMaxBytes(JSContext* cx, size_t maxBytes);
+
+enum class GCHistogramFormat {
+    JSON,
+    Prometheus
+};
+
+/**
+ * Render the runtime's histograms of GC slice pauses, nursery collection
+ * times, bytes tenured by nursery collections and time spent in each GC phase
+ * kind, which are kept for the lifetime of the runtime. The JSON format has
+ * the count, sum, maximum, some quantiles and the non-empty buckets of each
+ * histogram; the Prometheus format follows its text exposition format. Times
+ * are in microseconds. Returns nullptr on OOM.
+ */
+extern JS_FRIEND_API(JS::UniqueChars)
+RenderGCHistograms(JSContext* cx, GCHistogramFormat format);
+
 } /* namespace js */
 
 #endif /* jsfriendapi_h */
@@ -12,6 +12,7 @@
 
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/FloatingPoint.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/RangedPtr.h"
 #include "mozilla/TextUtils.h"
@@ -1014,18 +1015,60 @@ ComputePrecisionInRange(JSContext* cx, int minPrecision, int maxPrecision, doubl
     return false;
 }
 
+/*
+ * Convert |d| like js_dtostr, using double-conversion. This is much faster and
+ * never allocates, but returns nullptr when more digits are requested than
+ * double-conversion supports.
+ */
+static char*
+FastDToStr(char* buf, size_t bufSize, JSDToStrMode mode, int precision, double d)
+{
+    const double_conversion::DoubleToStringConverter& converter
+        = double_conversion::DoubleToStringConverter::EcmaScriptConverter();
+    double_conversion::StringBuilder builder(buf, bufSize);
+
+    bool ok;
+    switch (mode) {
+      case DTOSTR_FIXED:
+        // Large numbers are converted as if by ToString.
+        if (mozilla::Abs(d) >= 1e21) {
+            ok = converter.ToShortest(d, &builder);
+        } else {
+            ok = converter.ToFixed(d, precision, &builder);
+        }
+        break;
+      case DTOSTR_STANDARD_EXPONENTIAL:
+        ok = converter.ToExponential(d, -1, &builder);
+        break;
+      case DTOSTR_EXPONENTIAL:
+        // |precision| includes the digit before the decimal point.
+        ok = converter.ToExponential(d, precision - 1, &builder);
+        break;
+      case DTOSTR_PRECISION:
+        ok = converter.ToPrecision(d, precision, &builder);
+        break;
+      default:
+        MOZ_CRASH("Unexpected mode");
+    }
+
+    return ok ? builder.Finalize() : nullptr;
+}
+
 static bool
 DToStrResult(JSContext* cx, double d, JSDToStrMode mode, int precision, const CallArgs& args)
 {
-    if (!EnsureDtoaState(cx)) {
-        return false;
-    }
-
     char buf[DTOSTR_VARIABLE_BUFFER_SIZE(MAX_PRECISION + 1)];
-    char* numStr = js_dtostr(cx->dtoaState, buf, sizeof buf, mode, precision, d);
+    char* numStr = FastDToStr(buf, sizeof buf, mode, precision, d);
     if (!numStr) {
-        JS_ReportOutOfMemory(cx);
-        return false;
+        if (!EnsureDtoaState(cx)) {
+            return false;
+        }
+
+        numStr = js_dtostr(cx->dtoaState, buf, sizeof buf, mode, precision, d);
+        if (!numStr) {
+            JS_ReportOutOfMemory(cx);
+            return false;
+        }
     }
     JSString* str = NewStringCopyZ<CanGC>(cx, numStr);
     if (!str) {
@@ -2018,12 +2061,185 @@ js::ToIndexSlow(JSContext* cx, JS::HandleValue v, const unsigned errorNumber, ui
     return true;
 }
 
+template <typename CharT>
+static MOZ_ALWAYS_INLINE bool
+ReadEightDigits(const CharT* s, uint32_t* value)
+{
+    return false;
+}
+
+template <>
+MOZ_ALWAYS_INLINE bool
+ReadEightDigits(const Latin1Char* s, uint32_t* value)
+{
+#if MOZ_LITTLE_ENDIAN
+    uint64_t chunk;
+    memcpy(&chunk, s, sizeof(chunk));
+    if (IsEightDigits(chunk)) {
+        *value = EightDigitsValue(chunk);
+        return true;
+    }
+#endif
+    return false;
+}
+
+// Read the decimal digits at |*sp| into |*significand|, skipping leading
+// zeros, and add the number of digits read to |*numDigits|. Returns false
+// when there are more significant digits than fit in a uint64_t.
+template <typename CharT>
+static MOZ_ALWAYS_INLINE bool
+ReadDecimalDigits(const CharT** sp, const CharT* end, uint64_t* significand,
+                  size_t* numSignificantDigits, size_t* numDigits)
+{
+    // 10^19 - 1 is the largest 19 digit number and fits in a uint64_t.
+    static const size_t MaxSignificantDigits = 19;
+
+    const CharT* s = *sp;
+    const CharT* start = s;
+    uint64_t value = *significand;
+    size_t n = *numSignificantDigits;
+    for (; s < end && IsAsciiDigit(*s); s++) {
+        uint32_t eight;
+        if (value != 0 && n + 8 <= MaxSignificantDigits && end - s >= 8 &&
+            ReadEightDigits(s, &eight))
+        {
+            value = value * 100000000 + eight;
+            n += 8;
+            s += 7;
+            continue;
+        }
+
+        unsigned digit = *s - '0';
+        if (value == 0 && digit == 0) {
+            continue;
+        }
+        if (n == MaxSignificantDigits) {
+            return false;
+        }
+        value = value * 10 + digit;
+        n++;
+    }
+
+    *numDigits += s - start;
+    *significand = value;
+    *numSignificantDigits = n;
+    *sp = s;
+    return true;
+}
+
+/*
+ * Parse the StrDecimalLiteral at |begin| the way js_strtod_harder does, when
+ * its value is exactly the result of a single correctly rounded floating
+ * point operation on two exactly representable numbers (Clinger's fast path).
+ * That is the case for the vast majority of short decimal strings, which then
+ * don't need to be copied and converted with bignum arithmetic. Returns false
+ * if the slow path must be used.
+ */
+template <typename CharT>
+static bool
+FastStrtod(const CharT* begin, const CharT* end, const CharT** dEnd, double* d)
+{
+    static const double powersOf10[] = {
+        1e0,  1e1,  1e2,  1e3,  1e4,  1e5,  1e6,  1e7,  1e8,  1e9,  1e10, 1e11,
+        1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+    };
+    static const int32_t MaxExactPowerOf10 = mozilla::ArrayLength(powersOf10) - 1;
+    static const uint64_t MaxExactInteger = uint64_t(1) << 53;
+
+    const CharT* s = begin;
+    bool negative = false;
+    if (s < end && (*s == '-' || *s == '+')) {
+        negative = *s == '-';
+        s++;
+    }
+
+    uint64_t significand = 0;
+    size_t numSignificantDigits = 0;
+    size_t numDigits = 0;
+    if (!ReadDecimalDigits(&s, end, &significand, &numSignificantDigits, &numDigits)) {
+        return false;
+    }
+
+    int32_t exponent = 0;
+    if (s < end && *s == '.') {
+        s++;
+        size_t numIntegerDigits = numDigits;
+        if (!ReadDecimalDigits(&s, end, &significand, &numSignificantDigits, &numDigits)) {
+            return false;
+        }
+        exponent = -int32_t(numDigits - numIntegerDigits);
+    }
+
+    // Leave "Infinity", "." and anything else without digits to the slow path.
+    if (numDigits == 0) {
+        return false;
+    }
+
+    // The exponent part is only consumed when it has digits.
+    if (s < end && (*s == 'e' || *s == 'E')) {
+        const CharT* e = s + 1;
+        bool negativeExponent = false;
+        if (e < end && (*e == '-' || *e == '+')) {
+            negativeExponent = *e == '-';
+            e++;
+        }
+        if (e < end && IsAsciiDigit(*e)) {
+            int32_t explicitExponent = 0;
+            for (; e < end && IsAsciiDigit(*e); e++) {
+                if (explicitExponent < 10000) {
+                    explicitExponent = explicitExponent * 10 + (*e - '0');
+                }
+            }
+            exponent += negativeExponent ? -explicitExponent : explicitExponent;
+            s = e;
+        }
+    }
+
+    double result;
+    if (significand == 0) {
+        result = 0;
+    } else {
+        if (significand > MaxExactInteger) {
+            return false;
+        }
+
+        if (exponent > MaxExactPowerOf10) {
+            // Move the excess of the exponent into the significand, if it
+            // stays exact. 10^16 is larger than MaxExactInteger.
+            int32_t excess = exponent - MaxExactPowerOf10;
+            if (excess > 15 ||
+                significand > MaxExactInteger / uint64_t(powersOf10[excess]))
+            {
+                return false;
+            }
+            significand *= uint64_t(powersOf10[excess]);
+            exponent = MaxExactPowerOf10;
+        }
+
+        if (exponent >= 0) {
+            result = double(significand) * powersOf10[exponent];
+        } else if (exponent >= -MaxExactPowerOf10) {
+            result = double(significand) / powersOf10[-exponent];
+        } else {
+            return false;
+        }
+    }
+
+    *d = negative ? -result : result;
+    *dEnd = s;
+    return true;
+}
+
 template <typename CharT>
 bool
 js_strtod(JSContext* cx, const CharT* begin, const CharT* end, const CharT** dEnd,
           double* d)
 {
     const CharT* s = SkipSpace(begin, end);
+    if (FastStrtod(s, end, dEnd, d)) {
+        return true;
+    }
+
     size_t length = end - s;
 
     Vector<char, 32> chars(cx);
@@ -8,6 +8,7 @@
 #define jsnum_h
 
 #include "mozilla/Compiler.h"
+#include "mozilla/EndianUtils.h"
 #include "mozilla/FloatingPoint.h"
 #include "mozilla/Range.h"
 #include "mozilla/Utf8.h"
@@ -195,6 +196,29 @@ template <typename CharT>
 extern MOZ_MUST_USE bool
 GetDecimalInteger(JSContext* cx, const CharT* start, const CharT* end, double* dp);
 
+#if MOZ_LITTLE_ENDIAN
+// Whether the eight chars in |chunk|, the first in the lowest byte, are all
+// ASCII digits.
+inline bool
+IsEightDigits(uint64_t chunk)
+{
+    return ((chunk & 0xF0F0F0F0F0F0F0F0ULL) |
+            (((chunk + 0x0606060606060606ULL) & 0xF0F0F0F0F0F0F0F0ULL) >> 4)) ==
+           0x3333333333333333ULL;
+}
+
+// Convert eight ASCII digits, the first in the lowest byte, to their value.
+inline uint32_t
+EightDigitsValue(uint64_t chunk)
+{
+    chunk -= 0x3030303030303030ULL;
+    chunk = (chunk * 10) + (chunk >> 8);
+    chunk = (((chunk & 0x000000FF000000FFULL) * (100 + (1000000ULL << 32))) +
+             (((chunk >> 16) & 0x000000FF000000FFULL) * (1 + (10000ULL << 32)))) >> 32;
+    return uint32_t(chunk);
+}
+#endif
+
 extern MOZ_MUST_USE bool
 StringToNumber(JSContext* cx, JSString* str, double* result);
 
@@ -1057,6 +1057,42 @@ ScriptedProxyHandler::has(JSContext* cx, HandleObject proxy, HandleId id, bool*
     return true;
 }
 
+/* static */ bool
+ScriptedProxyHandler::checkGetTrapResult(JSContext* cx, HandleObject target, HandleId id,
+                                         HandleValue trapResult)
+{
+    // Step 9.
+    Rooted<PropertyDescriptor> desc(cx);
+    if (!GetOwnPropertyDescriptor(cx, target, id, &desc)) {
+        return false;
+    }
+
+    // Step 10.
+    if (desc.object()) {
+        // Step 10a.
+        if (desc.isDataDescriptor() && !desc.configurable() && !desc.writable()) {
+            bool same;
+            if (!SameValue(cx, trapResult, desc.value(), &same)) {
+                return false;
+            }
+            if (!same) {
+                return js::Throw(cx, id, JSMSG_MUST_REPORT_SAME_VALUE);
+            }
+        }
+
+        // Step 10b.
+        if (desc.isAccessorDescriptor() &&
+            !desc.configurable() &&
+            (desc.getterObject() == nullptr) &&
+            !trapResult.isUndefined())
+        {
+            return js::Throw(cx, id, JSMSG_MUST_REPORT_UNDEFINED);
+        }
+    }
+
+    return true;
+}
+
 // ES8 rev 0c1bd3004329336774cbc90de727cd0cf5f11e93 9.5.8 Proxy.[[GetP]](P, Receiver)
 bool
 ScriptedProxyHandler::get(JSContext* cx, HandleObject proxy, HandleValue receiver, HandleId id,
@@ -1104,35 +1140,11 @@ ScriptedProxyHandler::get(JSContext* cx, HandleObject proxy, HandleValue receive
         }
     }
 
-    // Step 9.
-    Rooted<PropertyDescriptor> desc(cx);
-    if (!GetOwnPropertyDescriptor(cx, target, id, &desc)) {
+    // Steps 9-10.
+    if (!checkGetTrapResult(cx, target, id, trapResult)) {
         return false;
     }
 
-    // Step 10.
-    if (desc.object()) {
-        // Step 10a.
-        if (desc.isDataDescriptor() && !desc.configurable() && !desc.writable()) {
-            bool same;
-            if (!SameValue(cx, trapResult, desc.value(), &same)) {
-                return false;
-            }
-            if (!same) {
-                return js::Throw(cx, id, JSMSG_MUST_REPORT_SAME_VALUE);
-            }
-        }
-
-        // Step 10b.
-        if (desc.isAccessorDescriptor() &&
-            !desc.configurable() &&
-            (desc.getterObject() == nullptr) &&
-            !trapResult.isUndefined())
-        {
-            return js::Throw(cx, id, JSMSG_MUST_REPORT_UNDEFINED);
-        }
-    }
-
     // Step 11.
     vp.set(trapResult);
     return true;
@@ -93,6 +93,12 @@ class ScriptedProxyHandler : public BaseProxyHandler
     static const int REVOKE_SLOT = 0;
 
     static JSObject* handlerObject(const JSObject* proxy);
+
+    // Check the result of a get trap against the target's own property |id|,
+    // as in steps 9-10 of Proxy.[[Get]]. The JITs call the trap directly and
+    // then call this when the target may have changed.
+    static bool checkGetTrapResult(JSContext* cx, HandleObject target, HandleId id,
+                                   HandleValue trapResult);
 };
 
 bool
@@ -8,10 +8,13 @@
 
 #include "shell/OSObject.h"
 
+#include <algorithm>
 #include <errno.h>
 #include <stdlib.h>
+#include <sys/stat.h>
 #ifdef XP_WIN
 #include <direct.h>
+#include <io.h>
 #include <process.h>
 #include <string.h>
 #else
@@ -320,6 +323,206 @@ osfile_readRelativeToScript(JSContext* cx, unsigned argc, Value* vp)
     return ReadFile(cx, argc, vp, true);
 }
 
+// Convert |v| to an offset or length in a file, which can be larger than 4GB.
+static bool
+ToFileOffset(JSContext* cx, HandleValue v, const char* name, uint64_t* result)
+{
+    double d;
+    if (!JS::ToNumber(cx, v, &d)) {
+        return false;
+    }
+
+    // Large enough for any file, and small enough to be represented exactly.
+    if (d < 0 || d != JS::ToInteger(d) || d > double(uint64_t(1) << 53)) {
+        JS_ReportErrorASCII(cx, "%s must be a non-negative integer", name);
+        return false;
+    }
+
+    *result = uint64_t(d);
+    return true;
+}
+
+static bool
+StatFileSize(FILE* file, uint64_t* size)
+{
+#ifdef XP_WIN
+    struct _stat64 st;
+    if (_fstat64(fileno(file), &st) < 0) {
+        return false;
+    }
+#else
+    struct stat st;
+    if (fstat(fileno(file), &st) < 0) {
+        return false;
+    }
+#endif
+    *size = uint64_t(st.st_size);
+    return true;
+}
+
+// The "fd" JS_CreateMappedArrayBufferContents wants, which on Windows is the
+// file's HANDLE.
+static int
+FileDescriptorForMapping(FILE* file)
+{
+#ifdef XP_WIN
+    return int(_get_osfhandle(fileno(file)));
+#else
+    return fileno(file);
+#endif
+}
+
+static bool
+ParseMappedArrayBufferAdvice(JSContext* cx, HandleString str, JS::MappedArrayBufferAdvice* advice)
+{
+    static const struct {
+        const char* name;
+        JS::MappedArrayBufferAdvice advice;
+    } modes[] = {
+        { "normal", JS::MappedArrayBufferAdvice::Normal },
+        { "sequential", JS::MappedArrayBufferAdvice::Sequential },
+        { "random", JS::MappedArrayBufferAdvice::Random },
+        { "willneed", JS::MappedArrayBufferAdvice::WillNeed }
+    };
+
+    for (const auto& mode : modes) {
+        bool match;
+        if (!JS_StringEqualsAscii(cx, str, mode.name, &match)) {
+            return false;
+        }
+        if (match) {
+            *advice = mode.advice;
+            return true;
+        }
+    }
+
+    UniqueChars chars = JS_EncodeStringToUTF8(cx, str);
+    if (!chars) {
+        return false;
+    }
+    JS_ReportErrorUTF8(cx, "unknown mapping mode: %s", chars.get());
+    return false;
+}
+
+static bool
+osfile_mapFile(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    if (args.length() < 1 || !args[0].isString() ||
+        (args.length() > 1 && !args[1].isUndefined() && !args[1].isObject()))
+    {
+        JS_ReportErrorNumberASCII(cx, my_GetErrorMessage, nullptr, JSSMSG_INVALID_ARGS,
+                                  "mapFile");
+        return false;
+    }
+
+    RootedString givenPath(cx, args[0].toString());
+    RootedString str(cx, ResolvePath(cx, givenPath, RootRelative));
+    if (!str) {
+        return false;
+    }
+    UniqueChars filename = JS_EncodeStringToLatin1(cx, str);
+    if (!filename) {
+        return false;
+    }
+
+    uint64_t offset = 0;
+    uint64_t length = 0;
+    bool lengthGiven = false;
+    JS::MappedArrayBufferAdvice advice = JS::MappedArrayBufferAdvice::Normal;
+    if (args.get(1).isObject()) {
+        RootedObject opts(cx, &args[1].toObject());
+        RootedValue v(cx);
+        if (!JS_GetProperty(cx, opts, "offset", &v)) {
+            return false;
+        }
+        if (!v.isUndefined() && !ToFileOffset(cx, v, "offset", &offset)) {
+            return false;
+        }
+
+        if (!JS_GetProperty(cx, opts, "length", &v)) {
+            return false;
+        }
+        if (!v.isUndefined()) {
+            if (!ToFileOffset(cx, v, "length", &length)) {
+                return false;
+            }
+            lengthGiven = true;
+        }
+
+        if (!JS_GetProperty(cx, opts, "mode", &v)) {
+            return false;
+        }
+        if (!v.isUndefined()) {
+            RootedString mode(cx, JS::ToString(cx, v));
+            if (!mode || !ParseMappedArrayBufferAdvice(cx, mode, &advice)) {
+                return false;
+            }
+        }
+    }
+
+    if (offset % 8 != 0) {
+        JS_ReportErrorASCII(cx, "mapFile offset must be a multiple of 8");
+        return false;
+    }
+
+    FILE* file = fopen(filename.get(), "rb");
+    if (!file) {
+        /*
+         * Use Latin1 variant here because the encoding of the return value of
+         * strerror function can be non-UTF-8.
+         */
+        JS_ReportErrorLatin1(cx, "can't open %s: %s", filename.get(), strerror(errno));
+        return false;
+    }
+    AutoCloseFile autoClose(file);
+
+    uint64_t fileSize;
+    if (!StatFileSize(file, &fileSize)) {
+        JS_ReportErrorLatin1(cx, "can't stat %s: %s", filename.get(), strerror(errno));
+        return false;
+    }
+    if (offset >= fileSize) {
+        JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr,
+                                  JSMSG_OFFSET_LARGER_THAN_FILESIZE);
+        return false;
+    }
+    if (!lengthGiven) {
+        length = fileSize - offset;
+    }
+
+    // An ArrayBuffer can't be as large as the biggest files, so those have to
+    // be mapped a window at a time.
+    if (length == 0 || length > ArrayBufferObject::MaxBufferByteLength ||
+        length > fileSize - offset)
+    {
+        JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_BAD_ARRAY_LENGTH);
+        return false;
+    }
+
+    void* contents = JS_CreateMappedArrayBufferContents(FileDescriptorForMapping(file),
+                                                        size_t(offset), size_t(length));
+    if (!contents) {
+        JS_ReportErrorLatin1(cx, "can't map %s", filename.get());
+        return false;
+    }
+
+    // The advice is only a hint, so it doesn't matter if the OS ignores it.
+    if (advice != JS::MappedArrayBufferAdvice::Normal) {
+        (void) JS_AdviseMappedArrayBufferContents(contents, size_t(length), advice);
+    }
+
+    RootedObject obj(cx, JS_NewMappedArrayBufferWithContents(cx, size_t(length), contents));
+    if (!obj) {
+        JS_ReleaseMappedArrayBufferContents(contents, size_t(length));
+        return false;
+    }
+
+    args.rval().setObject(*obj);
+    return true;
+}
+
 static bool
 osfile_writeTypedArrayToFile(JSContext* cx, unsigned argc, Value* vp)
 {
@@ -625,6 +828,202 @@ osfile_close(JSContext* cx, unsigned argc, Value* vp) {
     return true;
 }
 
+static FileObject*
+ThisOpenFileObject(JSContext* cx, const CallArgs& args, const char* name)
+{
+    if (args.thisv().isObject()) {
+        JSObject* obj = js::CheckedUnwrap(&args.thisv().toObject());
+        if (obj && obj->is<FileObject>()) {
+            FileObject* fileObj = &obj->as<FileObject>();
+            if (fileObj->isOpen()) {
+                return fileObj;
+            }
+            JS_ReportErrorASCII(cx, "%s: file is closed", name);
+            return nullptr;
+        }
+    }
+
+    JS_ReportErrorNumberASCII(cx, js::shell::my_GetErrorMessage, nullptr, JSSMSG_INVALID_ARGS,
+                              name);
+    return nullptr;
+}
+
+static bool
+osfile_handle_readInto(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    Rooted<FileObject*> fileObj(cx, ThisOpenFileObject(cx, args, "readInto"));
+    if (!fileObj) {
+        return false;
+    }
+
+    if (!args.get(0).isObject() || !args[0].toObject().is<TypedArrayObject>()) {
+        JS_ReportErrorNumberASCII(cx, my_GetErrorMessage, nullptr, JSSMSG_INVALID_ARGS,
+                                  "readInto");
+        return false;
+    }
+    Rooted<TypedArrayObject*> view(cx, &args[0].toObject().as<TypedArrayObject>());
+
+    bool positional = !args.get(1).isUndefined();
+    uint64_t position = 0;
+    if (positional && !ToFileOffset(cx, args[1], "position", &position)) {
+        return false;
+    }
+
+    if (view->isSharedMemory()) {
+        // See the comments in FileAsTypedArray, above.
+        JS_ReportErrorASCII(cx, "can't read into a shared memory buffer");
+        return false;
+    }
+
+    FILE* file = fileObj->rcFile()->fp;
+    size_t length = view->byteLength();
+    size_t done = 0;
+    {
+        // Nothing here can GC, so the view's data can't move.
+        JS::AutoCheckCannotGC nogc;
+        char* buf = static_cast<char*>(view->dataPointerUnshared());
+
+        if (!positional) {
+            done = fread(buf, 1, length, file);
+            if (done < length && ferror(file)) {
+                JS_ReportErrorLatin1(cx, "can't read file: %s", strerror(errno));
+                return false;
+            }
+        } else {
+            // Positional reads leave the file position alone, so they can be
+            // mixed with sequential reads of the same file.
+            while (done < length) {
+#ifdef XP_WIN
+                // There is no pread on Windows, so seek the file descriptor
+                // directly, leaving the position of the stdio stream alone.
+                int fd = fileno(file);
+                __int64 saved = _lseeki64(fd, 0, SEEK_CUR);
+                int chunk = int(std::min(length - done, size_t(INT32_MAX)));
+                int n = -1;
+                if (saved >= 0 && _lseeki64(fd, __int64(position + done), SEEK_SET) >= 0) {
+                    n = _read(fd, buf + done, chunk);
+                    _lseeki64(fd, saved, SEEK_SET);
+                }
+#else
+                ssize_t n = pread(fileno(file), buf + done, length - done,
+                                  off_t(position + done));
+                if (n < 0 && errno == EINTR) {
+                    continue;
+                }
+#endif
+                if (n < 0) {
+                    JS_ReportErrorLatin1(cx, "can't read file: %s", strerror(errno));
+                    return false;
+                }
+                if (n == 0) {
+                    break;
+                }
+                done += size_t(n);
+            }
+        }
+    }
+
+    args.rval().setNumber(double(done));
+    return true;
+}
+
+static bool
+osfile_handle_size(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    FileObject* fileObj = ThisOpenFileObject(cx, args, "size");
+    if (!fileObj) {
+        return false;
+    }
+
+    uint64_t size;
+    if (!StatFileSize(fileObj->rcFile()->fp, &size)) {
+        JS_ReportErrorLatin1(cx, "can't stat file: %s", strerror(errno));
+        return false;
+    }
+
+    args.rval().setNumber(double(size));
+    return true;
+}
+
+static bool
+osfile_handle_close(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    // Closing a file twice is harmless.
+    if (args.thisv().isObject()) {
+        JSObject* obj = js::CheckedUnwrap(&args.thisv().toObject());
+        if (obj && obj->is<FileObject>()) {
+            obj->as<FileObject>().close();
+            args.rval().setUndefined();
+            return true;
+        }
+    }
+
+    JS_ReportErrorNumberASCII(cx, js::shell::my_GetErrorMessage, nullptr, JSSMSG_INVALID_ARGS,
+                              "close");
+    return false;
+}
+
+static const JSFunctionSpec osfile_handle_methods[] = {
+    JS_FN("readInto", osfile_handle_readInto, 1, 0),
+    JS_FN("size", osfile_handle_size, 0, 0),
+    JS_FN("close", osfile_handle_close, 0, 0),
+    JS_FS_END
+};
+
+static bool
+osfile_open(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    if (args.length() != 1 || !args[0].isString()) {
+        JS_ReportErrorNumberASCII(cx, my_GetErrorMessage, nullptr, JSSMSG_INVALID_ARGS,
+                                  "open");
+        return false;
+    }
+
+    RootedString givenPath(cx, args[0].toString());
+    RootedString str(cx, ResolvePath(cx, givenPath, RootRelative));
+    if (!str) {
+        return false;
+    }
+    UniqueChars filename = JS_EncodeStringToLatin1(cx, str);
+    if (!filename) {
+        return false;
+    }
+
+    RCFile* file = RCFile::create(cx, filename.get(), "rb");
+    if (!file) {
+        /*
+         * Use Latin1 variant here because the encoding of the return value of
+         * strerror function can be non-UTF-8.
+         */
+        JS_ReportErrorLatin1(cx, "can't open %s: %s", filename.get(), strerror(errno));
+        return false;
+    }
+
+    // The FileObject owns the file from here on, and closes it when it's
+    // finalized if close() wasn't called.
+    RootedObject fileObj(cx, FileObject::create(cx, file));
+    if (!fileObj) {
+        file->close();
+        js_delete(file);
+        return false;
+    }
+
+    if (!JS_DefineFunctions(cx, fileObj, osfile_handle_methods)) {
+        return false;
+    }
+
+    args.rval().setObject(*fileObj);
+    return true;
+}
+
 static const JSFunctionSpecWithHelp osfile_functions[] = {
     JS_FN_HELP("readFile", osfile_readFile, 1, 0,
 "readFile(filename, [\"binary\"])",
@@ -637,6 +1036,26 @@ static const JSFunctionSpecWithHelp osfile_functions[] = {
 "  Read filename into returned string. Filename is relative to the directory\n"
 "  containing the current script."),
 
+    JS_FN_HELP("mapFile", osfile_mapFile, 1, 0,
+"mapFile(filename, [{offset, length, mode}])",
+"  Return an ArrayBuffer whose contents are mapped from the file rather than\n"
+"  read into memory, so pages are only read when they are first touched.\n"
+"  |offset| must be a multiple of 8, and defaults to the start of the file;\n"
+"  |length| defaults to the rest of the file. Buffers are limited to 2GB, so\n"
+"  map larger files a window at a time. |mode| is how the buffer will be read:\n"
+"  \"normal\", \"sequential\", \"random\" or \"willneed\", passed on to the OS\n"
+"  as a paging hint. Writes to the buffer never reach the file."),
+
+    JS_FN_HELP("open", osfile_open, 1, 0,
+"open(filename)",
+"  Open filename for reading, returning a file object with these methods:\n"
+"    readInto(typedArray, [position]): read into the whole of typedArray,\n"
+"      from |position| if it is given and from the current position of the\n"
+"      file, which it advances, otherwise. Returns the number of bytes read,\n"
+"      which is only fewer than the length of typedArray at the end of the file.\n"
+"    size(): return the size of the file in bytes.\n"
+"    close(): close the file."),
+
     JS_FS_HELP_END
 };
 
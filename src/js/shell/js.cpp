@@ -20,6 +20,7 @@
 #include "mozilla/Unused.h"
 #include "mozilla/Variant.h"
 
+#include <algorithm>
 #include <chrono>
 #ifdef JS_POSIX_NSPR
 # include <dlfcn.h>
@@ -110,6 +111,7 @@
 #include "vm/JSContext.h"
 #include "vm/JSFunction.h"
 #include "vm/JSObject.h"
+#include "vm/JSONPrinter.h"
 #include "vm/JSScript.h"
 #include "vm/Monitor.h"
 #include "vm/MutexIDs.h"
@@ -519,6 +521,10 @@ static bool wasmForceCranelift = false;
 #ifdef ENABLE_WASM_GC
 static bool enableWasmGc = false;
 #endif
+#ifdef ENABLE_WASM_SIMD
+static bool enableWasmSimd = false;
+#endif
+static bool enableWasmFunctionCounts = false;
 static bool enableTestWasmAwaitTier2 = false;
 static bool enableAsyncStacks = false;
 static bool enableStreams = false;
@@ -527,6 +533,7 @@ static uint32_t gZealBits = 0;
 static uint32_t gZealFrequency = 0;
 #endif
 static bool printTiming = false;
+static bool benchMode = false;
 static const char* jsCacheDir = nullptr;
 static const char* jsCacheAsmJSPath = nullptr;
 static RCFile* gErrFile = nullptr;
@@ -535,6 +542,8 @@ static bool reportWarnings = true;
 static bool compileOnly = false;
 static bool fuzzingSafe = false;
 static bool disableOOMFunctions = false;
+static const char* selfHostedXDRPath = nullptr;
+static uint32_t workerPoolSize = 0;
 
 #ifdef DEBUG
 static bool dumpEntrainedVariables = false;
@@ -1751,6 +1760,17 @@ ParseCompileOptions(JSContext* cx, CompileOptions& options, HandleObject opts,
         options.setSourceIsLazy(v.toBoolean());
     }
 
+    if (!JS_GetProperty(cx, opts, "eagerFunctionsSourceLength", &v)) {
+        return false;
+    }
+    if (!v.isUndefined()) {
+        uint32_t u;
+        if (!ToUint32(cx, v, &u)) {
+            return false;
+        }
+        options.setEagerFunctionsSourceLength(u);
+    }
+
     return true;
 }
 
@@ -3859,6 +3879,37 @@ DestroyShellCompartmentPrivate(JSFreeOp* fop, JS::Compartment* compartment)
 
 static void SetWorkerContextOptions(JSContext* cx);
 static bool ShellBuildId(JS::BuildIdCharVector* buildId);
+static WorkerInput* WaitForWorkerInput();
+
+static void
+RunWorkerInput(JSContext* cx, WorkerInput* input)
+{
+    // Each input gets a fresh realm, which keeps the runtime's atoms, JIT
+    // code and self-hosting global from the inputs before it.
+    JS::RealmOptions compartmentOptions;
+    SetStandardRealmOptions(compartmentOptions);
+
+    RootedObject global(cx, NewGlobalObject(cx, compartmentOptions, nullptr));
+    if (!global) {
+        return;
+    }
+
+    JSAutoRealm ar(cx, global);
+
+    JS::CompileOptions options(cx);
+    options.setFileAndLine("<string>", 1)
+           .setIsRunOnce(true);
+
+    AutoReportException are(cx);
+    RootedScript script(cx);
+    JS::SourceBufferHolder srcBuf(input->chars.get(), input->length,
+                                  JS::SourceBufferHolder::NoOwnership);
+    if (!JS::Compile(cx, options, srcBuf, &script)) {
+        return;
+    }
+    RootedValue result(cx);
+    JS_ExecuteScript(cx, script, &result);
+}
 
 static void
 WorkerMain(WorkerInput* input)
@@ -3902,39 +3953,32 @@ WorkerMain(WorkerInput* input)
 
     EnvironmentPreparer environmentPreparer(cx);
 
-    do {
-        JS::RealmOptions compartmentOptions;
-        SetStandardRealmOptions(compartmentOptions);
-
-        RootedObject global(cx, NewGlobalObject(cx, compartmentOptions, nullptr));
-        if (!global) {
-            break;
-        }
-
-        JSAutoRealm ar(cx, global);
-
-        JS::CompileOptions options(cx);
-        options.setFileAndLine("<string>", 1)
-               .setIsRunOnce(true);
-
-        AutoReportException are(cx);
-        RootedScript script(cx);
-        JS::SourceBufferHolder srcBuf(input->chars.get(), input->length,
-                                      JS::SourceBufferHolder::NoOwnership);
-        if (!JS::Compile(cx, options, srcBuf, &script)) {
-            break;
-        }
-        RootedValue result(cx);
-        JS_ExecuteScript(cx, script, &result);
-    } while (0);
+    // With --worker-pool-size, the thread stays around after running its
+    // input, so that later evalInWorker calls don't have to create and
+    // initialize another context. A worker which quit isn't reused.
+    while (input) {
+        RunWorkerInput(cx, input);
+        js_delete(input);
+        input = sc->quitting ? nullptr : WaitForWorkerInput();
+    }
 
     KillWatchdog(cx);
     JS_SetGrayGCRootsTracer(cx, nullptr, nullptr);
 }
 
-// Workers can spawn other workers, so we need a lock to access workerThreads.
+// A pooled worker thread waiting for its next input.
+struct IdleWorker
+{
+    ConditionVariable wakeup;
+    WorkerInput* input = nullptr;
+};
+
+// Workers can spawn other workers, so we need a lock to access workerThreads
+// and idleWorkers.
 static Mutex* workerThreadsLock = nullptr;
 static Vector<js::Thread*, 0, SystemAllocPolicy> workerThreads;
+static Vector<IdleWorker*, 0, SystemAllocPolicy> idleWorkers;
+static bool workerThreadsShuttingDown = false;
 
 class MOZ_RAII AutoLockWorkerThreads : public LockGuard<Mutex>
 {
@@ -3947,6 +3991,34 @@ class MOZ_RAII AutoLockWorkerThreads : public LockGuard<Mutex>
     }
 };
 
+// Called by a worker which has finished its input. Returns the next input
+// handed to it by EvalInWorker, or nullptr if the worker should exit because
+// the pool is full or the shell is shutting down.
+static WorkerInput*
+WaitForWorkerInput()
+{
+    if (!workerPoolSize) {
+        return nullptr;
+    }
+
+    UniqueLock<Mutex> lock(*workerThreadsLock);
+    if (workerThreadsShuttingDown || idleWorkers.length() >= workerPoolSize) {
+        return nullptr;
+    }
+
+    IdleWorker idle;
+    if (!idleWorkers.append(&idle)) {
+        return nullptr;
+    }
+
+    // EvalInWorker and KillWorkerThreads remove the worker from idleWorkers
+    // before waking it up.
+    while (!idle.input && !workerThreadsShuttingDown) {
+        idle.wakeup.wait(lock);
+    }
+    return idle.input;
+}
+
 static bool
 EvalInWorker(JSContext* cx, unsigned argc, Value* vp)
 {
@@ -3997,6 +4069,17 @@ EvalInWorker(JSContext* cx, unsigned argc, Value* vp)
         return false;
     }
 
+    {
+        AutoLockWorkerThreads alwt;
+        if (!idleWorkers.empty()) {
+            IdleWorker* idle = idleWorkers.popCopy();
+            idle->input = input;
+            idle->wakeup.notify_one();
+            args.rval().setUndefined();
+            return true;
+        }
+    }
+
     Thread* thread;
     {
         AutoEnterOOMUnsafeRegion oomUnsafe;
@@ -4210,6 +4293,16 @@ KillWorkerThreads(JSContext* cx)
         return;
     }
 
+    // Let the pooled workers exit.
+    {
+        AutoLockWorkerThreads alwt;
+        workerThreadsShuttingDown = true;
+        for (IdleWorker* idle : idleWorkers) {
+            idle->wakeup.notify_one();
+        }
+        idleWorkers.clear();
+    }
+
     while (true) {
         // We need to leave the AutoLockWorkerThreads scope before we call
         // js::Thread::join, to avoid deadlocks when AutoLockWorkerThreads is
@@ -4226,9 +4319,11 @@ KillWorkerThreads(JSContext* cx)
     }
 
     workerThreads.clearAndFree();
+    idleWorkers.clearAndFree();
 
     js_delete(workerThreadsLock);
     workerThreadsLock = nullptr;
+    workerThreadsShuttingDown = false;
 }
 
 static void
@@ -4565,6 +4660,317 @@ Elapsed(JSContext* cx, unsigned argc, Value* vp)
     return false;
 }
 
+// The state benchmark() compares before and after its measured runs, and
+// watches during warm-up to tell when the function's code has settled.
+struct BenchmarkCounters
+{
+    uint64_t majorGCs = 0;
+    uint64_t minorGCs = 0;
+    mozilla::TimeDuration gcPauseTime;
+    uint64_t ionCompilations = 0;
+    uint64_t bailouts = 0;
+    uint64_t invalidations = 0;
+
+    void sample(JSContext* cx);
+};
+
+static void
+CountBenchmarkBailouts(void* data, JSScript* script, uint32_t pcOffset, const char* kind,
+                       uint32_t count)
+{
+    static_cast<BenchmarkCounters*>(data)->bailouts += count;
+}
+
+static void
+CountBenchmarkInvalidations(void* data, JSScript* script, uint32_t count)
+{
+    static_cast<BenchmarkCounters*>(data)->invalidations += count;
+}
+
+void
+BenchmarkCounters::sample(JSContext* cx)
+{
+    JSRuntime* rt = cx->runtime();
+    majorGCs = rt->gc.majorGCCount();
+    minorGCs = rt->gc.minorGCCount();
+    gcPauseTime = rt->gc.stats().totalPauseTime();
+    ionCompilations = rt->jitRuntime() ? rt->jitRuntime()->numIonCompilations() : 0;
+
+    // The bailout counts are only kept for live scripts, so these can go down
+    // across a GC. That's still a change for the warm-up to wait out.
+    bailouts = 0;
+    invalidations = 0;
+    js::IterateBailoutCounts(cx, this, CountBenchmarkBailouts, CountBenchmarkInvalidations);
+}
+
+static const char*
+BenchmarkTierName(JSFunction* fun)
+{
+    if (!fun->isInterpreted()) {
+        return "native";
+    }
+    if (!fun->hasScript()) {
+        return "lazy";
+    }
+    JSScript* script = fun->nonLazyScript();
+    if (script->hasIonScript()) {
+        return "ion";
+    }
+    if (script->hasBaselineScript()) {
+        return "baseline";
+    }
+    return "interpreter";
+}
+
+static bool
+GetBenchmarkOption(JSContext* cx, HandleObject opts, const char* name, uint32_t* value)
+{
+    if (!opts) {
+        return true;
+    }
+
+    RootedValue v(cx);
+    if (!JS_GetProperty(cx, opts, name, &v)) {
+        return false;
+    }
+    return v.isUndefined() || ToUint32(cx, v, value);
+}
+
+// The value at quantile |q| of |samples|, which are sorted, by the nearest
+// rank method, with a distribution-free confidence interval from the order
+// statistics around it: with the normal approximation to the binomial, the
+// true quantile lies between the samples at these ranks with about 95%
+// probability.
+static void
+WriteBenchmarkQuantile(JSONPrinter& json, const char* name, const Vector<double>& samples,
+                       double q)
+{
+    static const double Z95 = 1.959964;
+
+    size_t n = samples.length();
+    double rank = q * n;
+    double spread = Z95 * sqrt(n * q * (1 - q));
+    auto clampRank = [n](double r) {
+        return size_t(std::min(std::max(r, 0.0), double(n - 1)));
+    };
+
+    json.beginObjectProperty(name);
+    json.floatProperty("value", samples[clampRank(ceil(rank) - 1)], 6);
+    json.floatProperty("lower", samples[clampRank(floor(rank - spread) - 1)], 6);
+    json.floatProperty("upper", samples[clampRank(ceil(rank + spread) - 1)], 6);
+    json.endObject();
+}
+
+static bool
+Benchmark(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    RootedObject callee(cx, &args.callee());
+
+    if (!args.get(0).isObject() || !args[0].toObject().is<JSFunction>()) {
+        ReportUsageErrorASCII(cx, callee, "First argument must be a function");
+        return false;
+    }
+    RootedFunction fun(cx, &args[0].toObject().as<JSFunction>());
+
+    RootedObject opts(cx);
+    if (args.length() > 1) {
+        if (!args[1].isObject()) {
+            ReportUsageErrorASCII(cx, callee, "Second argument must be an object");
+            return false;
+        }
+        opts = &args[1].toObject();
+    }
+
+    uint32_t maxWarmup = 10000;
+    uint32_t stableCalls = 500;
+    uint32_t iterations = 100;
+    uint32_t minSampleMicros = 1000;
+    if (!GetBenchmarkOption(cx, opts, "maxWarmup", &maxWarmup) ||
+        !GetBenchmarkOption(cx, opts, "stableCalls", &stableCalls) ||
+        !GetBenchmarkOption(cx, opts, "iterations", &iterations) ||
+        !GetBenchmarkOption(cx, opts, "minSampleMicros", &minSampleMicros))
+    {
+        return false;
+    }
+    if (iterations == 0) {
+        ReportUsageErrorASCII(cx, callee, "iterations must be positive");
+        return false;
+    }
+
+    UniqueChars name;
+    if (opts) {
+        RootedValue v(cx);
+        if (!JS_GetProperty(cx, opts, "name", &v)) {
+            return false;
+        }
+        if (!v.isUndefined()) {
+            RootedString str(cx, ToString(cx, v));
+            if (!str) {
+                return false;
+            }
+            name = JS_EncodeStringToUTF8(cx, str);
+            if (!name) {
+                return false;
+            }
+        }
+    }
+
+    RootedValue fval(cx, ObjectValue(*fun));
+    RootedValue rval(cx);
+
+    // Warm up until the function has run |stableCalls| times in a row without
+    // changing tier, linking Ion code or bailing out, and without an Ion
+    // compilation in progress for it.
+    BenchmarkCounters last;
+    last.sample(cx);
+    const char* lastTier = BenchmarkTierName(fun);
+    uint32_t warmupCalls = 0;
+    uint32_t unchangedCalls = 0;
+    while (unchangedCalls < stableCalls && warmupCalls < maxWarmup) {
+        if (!js::Call(cx, fval, UndefinedHandleValue, &rval)) {
+            return false;
+        }
+        warmupCalls++;
+
+        BenchmarkCounters now;
+        now.sample(cx);
+        const char* tier = BenchmarkTierName(fun);
+        bool compiling = fun->hasScript() && fun->nonLazyScript()->isIonCompilingOffThread();
+        if (tier != lastTier || compiling ||
+            now.ionCompilations != last.ionCompilations ||
+            now.bailouts != last.bailouts ||
+            now.invalidations != last.invalidations)
+        {
+            unchangedCalls = 0;
+        } else {
+            unchangedCalls++;
+        }
+        last = now;
+        lastTier = tier;
+    }
+    bool stable = unchangedCalls >= stableCalls;
+
+    // Batch calls so that each sample takes long enough for the clock's
+    // resolution and the cost of reading it not to matter.
+    uint32_t batch = 1;
+    while (batch < (1 << 20)) {
+        mozilla::TimeStamp start = mozilla::TimeStamp::Now();
+        for (uint32_t i = 0; i < batch; i++) {
+            if (!js::Call(cx, fval, UndefinedHandleValue, &rval)) {
+                return false;
+            }
+        }
+        if ((mozilla::TimeStamp::Now() - start).ToMicroseconds() >= minSampleMicros) {
+            break;
+        }
+        batch *= 2;
+    }
+
+    // Nanoseconds per call, for each sample.
+    Vector<double> samples(cx);
+    if (!samples.reserve(iterations)) {
+        return false;
+    }
+
+    BenchmarkCounters before;
+    before.sample(cx);
+    for (uint32_t i = 0; i < iterations; i++) {
+        mozilla::TimeStamp start = mozilla::TimeStamp::Now();
+        for (uint32_t j = 0; j < batch; j++) {
+            if (!js::Call(cx, fval, UndefinedHandleValue, &rval)) {
+                return false;
+            }
+        }
+        double micros = (mozilla::TimeStamp::Now() - start).ToMicroseconds();
+        samples.infallibleAppend(micros * 1000 / batch);
+    }
+    BenchmarkCounters after;
+    after.sample(cx);
+
+    double sum = 0;
+    for (double sample : samples) {
+        sum += sample;
+    }
+    double mean = sum / iterations;
+    double squares = 0;
+    for (double sample : samples) {
+        squares += (sample - mean) * (sample - mean);
+    }
+    double stddev = iterations > 1 ? sqrt(squares / (iterations - 1)) : 0;
+    std::sort(samples.begin(), samples.end());
+
+    Sprinter sprinter(cx);
+    if (!sprinter.init()) {
+        return false;
+    }
+
+    {
+        JSONPrinter json(sprinter);
+        json.beginObject();
+        if (name) {
+            json.beginStringProperty("name");
+            for (const char* s = name.get(); *s; s++) {
+                unsigned char c = *s;
+                if (c == '"' || c == '\\') {
+                    sprinter.putChar('\\');
+                    sprinter.putChar(c);
+                } else if (c < 0x20) {
+                    sprinter.printf("\\u%04x", c);
+                } else {
+                    sprinter.putChar(c);
+                }
+            }
+            json.endStringProperty();
+        }
+
+        json.property("warmupCalls", warmupCalls);
+        json.formatProperty("stable", "%s", stable ? "true" : "false");
+        json.property("tier", BenchmarkTierName(fun));
+        json.property("batch", batch);
+        json.property("iterations", iterations);
+
+        // Times are in nanoseconds per call.
+        json.floatProperty("mean", mean, 6);
+        json.floatProperty("stddev", stddev, 6);
+        json.floatProperty("min", samples[0], 6);
+        json.floatProperty("max", samples[iterations - 1], 6);
+        WriteBenchmarkQuantile(json, "median", samples, 0.5);
+        WriteBenchmarkQuantile(json, "p99", samples, 0.99);
+
+        json.beginObjectProperty("gc");
+        json.property("majorGCs", after.majorGCs - before.majorGCs);
+        json.property("minorGCs", after.minorGCs - before.minorGCs);
+        json.property("pauseTime", after.gcPauseTime - before.gcPauseTime,
+                      JSONPrinter::MILLISECONDS);
+        json.endObject();
+
+        json.beginObjectProperty("jit");
+        json.property("ionCompilations", after.ionCompilations - before.ionCompilations);
+        json.property("bailouts", after.bailouts - before.bailouts);
+        json.property("invalidations", after.invalidations - before.invalidations);
+        json.endObject();
+
+        json.endObject();
+    }
+
+    if (sprinter.hadOutOfMemory()) {
+        return false;
+    }
+
+    if (benchMode) {
+        fprintf(gOutFile->fp, "%s\n", sprinter.string());
+        fflush(gOutFile->fp);
+    }
+
+    JSString* str = JS_NewStringCopyZ(cx, sprinter.string());
+    if (!str) {
+        return false;
+    }
+    args.rval().setString(str);
+    return true;
+}
+
 static bool
 Compile(JSContext* cx, unsigned argc, Value* vp)
 {
@@ -5485,6 +5891,112 @@ runOffThreadDecodedScript(JSContext* cx, unsigned argc, Value* vp)
     return JS_ExecuteScript(cx, script, args.rval());
 }
 
+static bool
+OffThreadParseJSON(JSContext* cx, unsigned argc, Value* vp)
+{
+    if (!CanUseExtraThreads()) {
+        JS_ReportErrorASCII(cx, "Can't use offThreadParseJSON with --no-threads");
+        return false;
+    }
+
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    if (args.length() < 1 || !args[0].isString()) {
+        JS_ReportErrorNumberASCII(cx, my_GetErrorMessage, nullptr, JSSMSG_INVALID_ARGS,
+                                  "offThreadParseJSON");
+        return false;
+    }
+
+    uint32_t chunkSize = 0;
+    if (args.length() >= 2 && !JS::ToUint32(cx, args[1], &chunkSize)) {
+        return false;
+    }
+
+    RootedString text(cx, args[0].toString());
+
+    OffThreadJob* job = NewOffThreadJob(cx, ScriptKind::JSON,
+                                        OffThreadJob::Source(UniqueTwoByteChars()));
+    if (!job) {
+        return false;
+    }
+
+    bool ok;
+    if (chunkSize) {
+        // Feed the text to the parse as UTF-8 chunks of |chunkSize| bytes, as
+        // an embedding would while it is downloaded.
+        UniqueChars utf8 = JS_EncodeStringToUTF8(cx, text);
+        if (!utf8) {
+            job->cancel();
+            DeleteOffThreadJob(cx, job);
+            return false;
+        }
+
+        const uint8_t* bytes = reinterpret_cast<const uint8_t*>(utf8.get());
+        size_t length = strlen(utf8.get());
+
+        JS::OffThreadCompileStream stream(JS::OffThreadCompileStream::Encoding::UTF8);
+        ok = true;
+        for (size_t i = 0; ok && i < length; i += chunkSize) {
+            ok = stream.consumeChunk(bytes + i, Min(size_t(chunkSize), length - i));
+        }
+        if (!ok) {
+            ReportOutOfMemory(cx);
+        } else {
+            ok = stream.parseJSON(cx, OffThreadCompileScriptCallback, job);
+        }
+    } else {
+        AutoStableStringChars stableChars(cx);
+        if (!stableChars.initTwoByte(cx, text)) {
+            job->cancel();
+            DeleteOffThreadJob(cx, job);
+            return false;
+        }
+
+        size_t length = text->length();
+        UniqueTwoByteChars chars(cx->pod_malloc<char16_t>(length + 1));
+        if (!chars) {
+            job->cancel();
+            DeleteOffThreadJob(cx, job);
+            return false;
+        }
+        mozilla::PodCopy(chars.get(), stableChars.twoByteChars(), length);
+
+        ok = JS::ParseJSONOffThread(cx, std::move(chars), length,
+                                    OffThreadCompileScriptCallback, job);
+    }
+
+    if (!ok) {
+        job->cancel();
+        DeleteOffThreadJob(cx, job);
+        return false;
+    }
+
+    args.rval().setInt32(job->id);
+    return true;
+}
+
+static bool
+FinishOffThreadParseJSON(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    if (OffThreadParsingMustWaitForGC(cx->runtime())) {
+        gc::FinishGC(cx);
+    }
+
+    OffThreadJob* job = LookupOffThreadJobForArgs(cx, ScriptKind::JSON, args, 0);
+    if (!job) {
+        return false;
+    }
+
+    JS::OffThreadToken* token = job->waitUntilDone(cx);
+    MOZ_ASSERT(token);
+
+    DeleteOffThreadJob(cx, job);
+
+    return JS::FinishOffThreadJSON(cx, token, args.rval());
+}
+
 struct MOZ_RAII FreeOnReturn
 {
     JSContext* cx;
@@ -5836,6 +6348,13 @@ NewGlobal(JSContext* cx, unsigned argc, Value* vp)
             creationOptions.setExistingCompartment(UncheckedUnwrap(&v.toObject()));
         }
 
+        if (!JS_GetProperty(cx, opts, "spectreMitigations", &v)) {
+            return false;
+        }
+        if (v.isBoolean()) {
+            creationOptions.setSpectreMitigations(v.toBoolean());
+        }
+
         if (!JS_GetProperty(cx, opts, "disableLazyParsing", &v)) {
             return false;
         }
@@ -5878,6 +6397,26 @@ NewGlobal(JSContext* cx, unsigned argc, Value* vp)
         }
     }
 
+    JS::Zone* existingZone = nullptr;
+    switch (creationOptions.compartmentSpecifier()) {
+      case JS::CompartmentSpecifier::NewCompartmentInExistingZone:
+        existingZone = creationOptions.zone();
+        break;
+      case JS::CompartmentSpecifier::ExistingCompartment:
+        existingZone = creationOptions.compartment()->zone();
+        break;
+      default:
+        break;
+    }
+    if (existingZone &&
+        existingZone->jitSpectreMitigations() != creationOptions.spectreMitigations())
+    {
+        JS_ReportErrorASCII(cx,
+                            "Cannot create realms with and without Spectre mitigations "
+                            "in the same zone");
+        return false;
+    }
+
     RootedObject global(cx, NewGlobalObject(cx, options, principals));
     if (principals) {
         JS_DropPrincipals(cx, principals);
@@ -6370,6 +6909,110 @@ DisableGeckoProfiling(JSContext* cx, unsigned argc, Value* vp)
     return true;
 }
 
+static bool
+StartStackSampling(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    uint32_t interval = 1000;
+    if (args.length() > 0) {
+        double d;
+        if (!ToNumber(cx, args[0], &d)) {
+            return false;
+        }
+        if (!(d >= 1 && d <= UINT32_MAX)) {
+            JS_ReportErrorASCII(cx, "startStackSampling: invalid interval");
+            return false;
+        }
+        interval = uint32_t(d);
+    }
+
+    if (!js::StartStackSampling(cx, interval)) {
+        return false;
+    }
+
+    args.rval().setUndefined();
+    return true;
+}
+
+static bool
+StopStackSampling(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    if (args.length() == 0) {
+        if (!js::StopStackSampling(cx, nullptr)) {
+            return false;
+        }
+        args.rval().setUndefined();
+        return true;
+    }
+
+    RootedString str(cx, JS::ToString(cx, args[0]));
+    if (!str) {
+        return false;
+    }
+
+    UniqueChars filename = JS_EncodeStringToLatin1(cx, str);
+    if (!filename) {
+        return false;
+    }
+
+    FILE* file = fopen(filename.get(), "w");
+    if (!file) {
+        JS_ReportErrorLatin1(cx, "can't open %s: %s", filename.get(), strerror(errno));
+        return false;
+    }
+
+    bool ok = js::StopStackSampling(cx, file);
+    fclose(file);
+    if (!ok) {
+        return false;
+    }
+
+    args.rval().setUndefined();
+    return true;
+}
+
+static bool
+DumpICStats(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+
+    if (args.length() == 0) {
+        if (!js::DumpICStats(cx, stdout)) {
+            return false;
+        }
+        args.rval().setUndefined();
+        return true;
+    }
+
+    RootedString str(cx, JS::ToString(cx, args[0]));
+    if (!str) {
+        return false;
+    }
+
+    UniqueChars filename = JS_EncodeStringToLatin1(cx, str);
+    if (!filename) {
+        return false;
+    }
+
+    FILE* file = fopen(filename.get(), "w");
+    if (!file) {
+        JS_ReportErrorLatin1(cx, "can't open %s: %s", filename.get(), strerror(errno));
+        return false;
+    }
+
+    bool ok = js::DumpICStats(cx, file);
+    fclose(file);
+    if (!ok) {
+        return false;
+    }
+
+    args.rval().setUndefined();
+    return true;
+}
+
 // Global mailbox that is used to communicate a shareable object value from one
 // worker to another.
 //
@@ -6727,6 +7370,29 @@ class StreamCacheEntryObject : public NativeObject
         args.rval().setObject(*buffer);
         return true;
     }
+    static bool getOptimizedBuffer(JSContext* cx, unsigned argc, Value* vp) {
+        CallArgs args = CallArgsFromVp(argc, vp);
+        if (!args.thisv().isObject() || !args.thisv().toObject().is<StreamCacheEntryObject>()) {
+            return false;
+        }
+
+        auto& cache = args.thisv().toObject().as<StreamCacheEntryObject>().cache();
+        if (!cache.hasOptimizedEncoding()) {
+            args.rval().setNull();
+            return true;
+        }
+
+        auto& bytes = cache.optimizedEncoding();
+        RootedArrayBufferObject buffer(cx, ArrayBufferObject::create(cx, bytes.length()));
+        if (!buffer) {
+            return false;
+        }
+
+        memcpy(buffer->dataPointer(), bytes.begin(), bytes.length());
+
+        args.rval().setObject(*buffer);
+        return true;
+    }
 
   public:
     static const unsigned RESERVED_SLOTS = 1;
@@ -6771,6 +7437,9 @@ class StreamCacheEntryObject : public NativeObject
         if (!JS_DefineFunction(cx, obj, "getBuffer", getBuffer, 0, 0)) {
             return false;
         }
+        if (!JS_DefineFunction(cx, obj, "getOptimizedBuffer", getOptimizedBuffer, 0, 0)) {
+            return false;
+        }
 
         args.rval().setObject(*obj);
         return true;
@@ -7028,6 +7697,43 @@ SetBufferStreamParams(JSContext* cx, unsigned argc, Value* vp)
     return true;
 }
 
+static bool
+WasmDeserializeFromFile(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    RootedObject callee(cx, &args.callee());
+
+    if (!args.get(0).isString()) {
+        ReportUsageErrorASCII(cx, callee, "First argument must be a String");
+        return false;
+    }
+
+    RootedString givenPath(cx, args[0].toString());
+    RootedString path(cx, ResolvePath(cx, givenPath, RootRelative));
+    if (!path) {
+        return false;
+    }
+
+    UniqueChars filename = JS_EncodeStringToLatin1(cx, path);
+    if (!filename) {
+        return false;
+    }
+
+    RefPtr<JS::WasmModule> module = JS::DeserializeWasmModuleFromFile(filename.get());
+    if (!module) {
+        JS_ReportErrorASCII(cx, "can't deserialize a wasm module from '%s'", filename.get());
+        return false;
+    }
+
+    JSObject* obj = module->createObject(cx);
+    if (!obj) {
+        return false;
+    }
+
+    args.rval().setObject(*obj);
+    return true;
+}
+
 static void
 ShutdownBufferStreams()
 {
@@ -7881,6 +8587,8 @@ static const JSFunctionSpecWithHelp shell_functions[] = {
 "      sourceIsLazy: if present and true, indicates that, after compilation, \n"
 "          script source should not be cached by the JS engine and should be \n"
 "          lazily loaded from the embedding as-needed.\n"
+"      eagerFunctionsSourceLength: if present, inner functions starting before\n"
+"         this source offset are compiled up front rather than lazily.\n"
 "      loadBytecode: if true, and if the source is a CacheEntryObject,\n"
 "         the bytecode would be loaded and decoded from the cache entry instead\n"
 "         of being parsed, then it would be executed as usual.\n"
@@ -8149,6 +8857,19 @@ JS_FN_HELP("parseBin", BinParse, 1, 0,
 "  is only one job pending. If an error occurred, throw the appropriate\n"
 "  exception; otherwise, run the script and return its value."),
 
+    JS_FN_HELP("offThreadParseJSON", OffThreadParseJSON, 1, 0,
+"offThreadParseJSON(text[, chunkSize])",
+"  Parse |text| as JSON on a helper thread, returning a job ID. If |chunkSize|\n"
+"  is given, the text is passed to the parse as UTF-8 chunks of that many bytes,\n"
+"  as if it were being streamed. To wait for the parse to finish and get the\n"
+"  value, call |finishOffThreadParseJSON| passing the job ID."),
+
+    JS_FN_HELP("finishOffThreadParseJSON", FinishOffThreadParseJSON, 0, 0,
+"finishOffThreadParseJSON([jobID])",
+"  Wait for an off-thread JSON parse to complete. The job ID can be ommitted if\n"
+"  there is only one job pending. If an error occurred, throw the appropriate\n"
+"  exception; otherwise, return the parsed value."),
+
     JS_FN_HELP("timeout", Timeout, 1, 0,
 "timeout([seconds], [func])",
 "  Get/Set the limit in seconds for the execution time for the current context.\n"
@@ -8201,6 +8922,17 @@ JS_FN_HELP("parseBin", BinParse, 1, 0,
 "elapsed()",
 "  Execution time elapsed for the current thread."),
 
+    JS_FN_HELP("benchmark", Benchmark, 2, 0,
+"benchmark(fun[, options])",
+"  Call fun until it has run options.stableCalls (500) times in a row without\n"
+"  changing JIT tier, linking Ion code or bailing out, or options.maxWarmup\n"
+"  (10000) times, then time options.iterations (100) samples of calls, batched\n"
+"  so that each sample takes at least options.minSampleMicros (1000). Return a\n"
+"  JSON string with the mean, median and p99 nanoseconds per call, with 95%\n"
+"  confidence intervals for the quantiles, and the GCs, GC pause time, Ion\n"
+"  compilations and bailouts during the samples. options.name is copied to\n"
+"  the result. With --bench, the result is also printed."),
+
     JS_FN_HELP("decompileFunction", DecompileFunction, 1, 0,
 "decompileFunction(func)",
 "  Decompile a function."),
@@ -8230,6 +8962,9 @@ JS_FN_HELP("parseBin", BinParse, 1, 0,
 "         debugger (default false)\n"
 "      disableLazyParsing: If true, don't create lazy scripts for functions\n"
 "         (default false).\n"
+"      spectreMitigations: If false, JIT code for the new zone is compiled\n"
+"         without Spectre mitigations (default true). A realm created in an\n"
+"         existing zone must use the same setting as that zone.\n"
 "      principal: if present, its value converted to a number must be an\n"
 "         integer that fits in 32 bits; use that as the new realm's\n"
 "         principal. Shell principals are toys, meant only for testing; one\n"
@@ -8300,7 +9035,13 @@ JS_FN_HELP("parseBin", BinParse, 1, 0,
 "streamCacheEntry(buffer)",
 "  Create a shell-only object that holds wasm bytecode and can be streaming-\n"
 "  compiled and cached by WebAssembly.{compile,instantiate}Streaming(). On a\n"
-"  second compilation of the same cache entry, the cached code will be used."),
+"  second compilation of the same cache entry, the cached code will be used.\n"
+"  Its getOptimizedBuffer() method returns the cached code, or null."),
+
+    JS_FN_HELP("wasmDeserializeFromFile", WasmDeserializeFromFile, 1, 0,
+"wasmDeserializeFromFile(filename)",
+"  Create a WebAssembly.Module from a file holding the cached code of a\n"
+"  streamCacheEntry, mapping the machine code from the file where possible."),
 
     JS_FN_HELP("printProfilerEvents", PrintProfilerEvents, 0, 0,
 "printProfilerEvents()",
@@ -8332,6 +9073,21 @@ JS_FN_HELP("parseBin", BinParse, 1, 0,
 "disableGeckoProfiling()",
 "  Disables Gecko Profiler instrumentation"),
 
+    JS_FN_HELP("startStackSampling", StartStackSampling, 1, 0,
+"startStackSampling([intervalMicroseconds])",
+"  Start sampling the JS stack every intervalMicroseconds (default 1000) with\n"
+"  the built-in stack sampler."),
+
+    JS_FN_HELP("stopStackSampling", StopStackSampling, 1, 0,
+"stopStackSampling([filename])",
+"  Stop the stack sampler started by startStackSampling, and write the profile\n"
+"  to filename in the Chrome DevTools .cpuprofile JSON format."),
+
+    JS_FN_HELP("dumpICStats", DumpICStats, 1, 0,
+"dumpICStats([filename])",
+"  Write the state of the inline caches of all Baseline and Ion compiled scripts\n"
+"  as JSON to filename, or to stdout if no filename is given."),
+
     JS_FN_HELP("isLatin1", IsLatin1, 1, 0,
 "isLatin1(s)",
 "  Return true iff the string's characters are stored as Latin1."),
@@ -9872,6 +10628,10 @@ SetContextOptions(JSContext* cx, const OptionParser& op)
 #ifdef ENABLE_WASM_GC
     enableWasmGc = op.getBoolOption("wasm-gc");
 #endif
+#ifdef ENABLE_WASM_SIMD
+    enableWasmSimd = op.getBoolOption("wasm-simd");
+#endif
+    enableWasmFunctionCounts = op.getBoolOption("wasm-function-counts");
     enableTestWasmAwaitTier2 = op.getBoolOption("test-wasm-await-tier2");
     enableAsyncStacks = !op.getBoolOption("no-async-stacks");
     enableStreams = op.getBoolOption("enable-streams");
@@ -9897,6 +10657,10 @@ SetContextOptions(JSContext* cx, const OptionParser& op)
 #ifdef ENABLE_WASM_GC
                              .setWasmGc(enableWasmGc)
 #endif
+#ifdef ENABLE_WASM_SIMD
+                             .setWasmSimd(enableWasmSimd)
+#endif
+                             .setWasmFunctionCounts(enableWasmFunctionCounts)
                              .setTestWasmAwaitTier2(enableTestWasmAwaitTier2)
                              .setNativeRegExp(enableNativeRegExp)
                              .setAsyncStack(enableAsyncStacks);
@@ -9937,6 +10701,16 @@ SetContextOptions(JSContext* cx, const OptionParser& op)
         }
     }
 
+    if (const char* str = op.getStringOption("source-compression")) {
+        if (strcmp(str, "zlib") == 0) {
+            SetSourceCompressionCodec(cx, SourceCompressionCodec::Zlib);
+        } else if (strcmp(str, "lz4") == 0) {
+            SetSourceCompressionCodec(cx, SourceCompressionCodec::LZ4);
+        } else {
+            return OptionFailure("source-compression", str);
+        }
+    }
+
     if (const char* str = op.getStringOption("ion-scalar-replacement")) {
         if (strcmp(str, "on") == 0) {
             jit::JitOptions.disableScalarReplacement = false;
@@ -10173,6 +10947,7 @@ SetContextOptions(JSContext* cx, const OptionParser& op)
     reportWarnings = op.getBoolOption('w');
     compileOnly = op.getBoolOption('c');
     printTiming = op.getBoolOption('b');
+    benchMode = op.getBoolOption("bench");
     enableCodeCoverage = op.getBoolOption("code-coverage");
     enableDisassemblyDumps = op.getBoolOption('D');
     cx->runtime()->profilingScripts = enableCodeCoverage || enableDisassemblyDumps;
@@ -10225,6 +11000,10 @@ SetWorkerContextOptions(JSContext* cx)
 #ifdef ENABLE_WASM_GC
                              .setWasmGc(enableWasmGc)
 #endif
+#ifdef ENABLE_WASM_SIMD
+                             .setWasmSimd(enableWasmSimd)
+#endif
+                             .setWasmFunctionCounts(enableWasmFunctionCounts)
                              .setTestWasmAwaitTier2(enableTestWasmAwaitTier2)
                              .setNativeRegExp(enableNativeRegExp);
 
@@ -10402,6 +11181,44 @@ class AutoLibraryLoader {
     }
 };
 
+static bool
+WriteSelfHostedXDRFile(JSContext* cx, const JS::TranscodeRange& xdr)
+{
+    FILE* file = fopen(selfHostedXDRPath, "wb");
+    if (!file) {
+        fprintf(stderr, "Can't open %s for writing: %s\n", selfHostedXDRPath, strerror(errno));
+        return false;
+    }
+    bool ok = fwrite(xdr.begin().get(), 1, xdr.length(), file) == xdr.length();
+    ok = fclose(file) == 0 && ok;
+    if (!ok) {
+        fprintf(stderr, "Can't write %s\n", selfHostedXDRPath);
+    }
+    return ok;
+}
+
+// Read the self-hosted bytecode saved by an earlier run, if there is any.
+static bool
+ReadSelfHostedXDRFile(JS::TranscodeBuffer& buffer)
+{
+    FILE* file = fopen(selfHostedXDRPath, "rb");
+    if (!file) {
+        return true;
+    }
+    AutoCloseFile autoClose(file);
+
+    uint8_t chunk[4096];
+    size_t n;
+    while ((n = fread(chunk, 1, sizeof(chunk), file)) > 0) {
+        if (!buffer.append(chunk, n)) {
+            return false;
+        }
+    }
+    if (ferror(file)) {
+        buffer.clear();
+    }
+    return true;
+}
 
 int
 main(int argc, char** argv, char** envp)
@@ -10458,6 +11275,8 @@ main(int argc, char** argv, char** envp)
         || !op.addBoolOption('s', "strict", "Check strictness")
         || !op.addBoolOption('D', "dump-bytecode", "Dump bytecode with exec count for all scripts")
         || !op.addBoolOption('b', "print-timing", "Print sub-ms runtime for each file that's run")
+        || !op.addBoolOption('\0', "bench", "Print the JSON result of each benchmark() call, for "
+                             "collecting results from a run of benchmark scripts")
         || !op.addStringOption('\0', "js-cache", "[path]",
                                "Enable the JS cache by specifying the path of the directory to use "
                                "to hold cache files")
@@ -10481,6 +11300,15 @@ main(int argc, char** argv, char** envp)
                             "background helper threads is the CPU count plus some constant.",
                             -1)
         || !op.addIntOption('\0', "thread-count", "COUNT", "Alias for --cpu-count.", -1)
+        || !op.addIntOption('\0', "worker-pool-size", "COUNT",
+                            "Keep up to COUNT idle evalInWorker threads and their contexts "
+                            "for reuse by later calls (default: 0)", 0)
+        || !op.addBoolOption('\0', "pin-helper-threads",
+                             "Bind each helper thread to a NUMA node, spreading them over "
+                             "all nodes")
+        || !op.addBoolOption('\0', "mutex-profile",
+                             "Record contention on the engine's mutexes, and print it to "
+                             "stderr on exit")
         || !op.addBoolOption('\0', "ion", "Enable IonMonkey (default)")
         || !op.addBoolOption('\0', "no-ion", "Disable IonMonkey")
         || !op.addBoolOption('\0', "no-asmjs", "Disable asm.js compilation")
@@ -10497,6 +11325,13 @@ main(int argc, char** argv, char** envp)
 #else
         || !op.addBoolOption('\0', "wasm-gc", "No-op")
 #endif
+#ifdef ENABLE_WASM_SIMD
+        || !op.addBoolOption('\0', "wasm-simd", "Enable wasm SIMD features (Ion only)")
+#else
+        || !op.addBoolOption('\0', "wasm-simd", "No-op")
+#endif
+        || !op.addBoolOption('\0', "wasm-function-counts",
+                             "Count the calls of each wasm function, see wasmFunctionCounts()")
         || !op.addBoolOption('\0', "no-native-regexp", "Disable native regexp compilation")
         || !op.addBoolOption('\0', "no-unboxed-objects", "Disable creating unboxed plain objects")
         || !op.addBoolOption('\0', "enable-streams", "Enable WHATWG Streams")
@@ -10512,6 +11347,8 @@ main(int argc, char** argv, char** envp)
 #endif
         || !op.addStringOption('\0', "spectre-mitigations", "on/off",
                                "Whether Spectre mitigations are enabled (default: off, on to enable)")
+        || !op.addStringOption('\0', "source-compression", "zlib/lz4",
+                               "Codec used to compress script sources (default: zlib)")
         || !op.addStringOption('\0', "cache-ir-stubs", "on/off/nobinary",
                                "Use CacheIR stubs (default: on, off to disable, nobinary to"
                                "just disable binary arith)")
@@ -10561,6 +11398,7 @@ main(int argc, char** argv, char** envp)
                                "Specify Ion register allocation:\n"
                                "  backtracking: Priority based backtracking register allocation (default)\n"
                                "  testbed: Backtracking allocator with experimental features\n"
+                               "  linearscan: Backtracking allocator in linear scan order, without eviction\n"
                                "  stupid: Simple block local register allocation")
         || !op.addBoolOption('\0', "ion-eager", "Always ion-compile methods (implies --baseline-eager)")
         || !op.addStringOption('\0', "ion-offthread-compile", "on/off",
@@ -10595,6 +11433,10 @@ main(int argc, char** argv, char** envp)
         || !op.addBoolOption('\0', "no-incremental-gc", "Disable Incremental GC")
         || !op.addStringOption('\0', "nursery-strings", "on/off",
                                "Allocate strings in the nursery")
+        || !op.addStringOption('\0', "selfhosted-xdr-path", "PATH",
+                               "Decode the self-hosted code from the bytecode in PATH rather "
+                               "than compiling it, and save the bytecode to PATH if it is "
+                               "missing or from another build")
         || !op.addIntOption('\0', "available-memory", "SIZE",
                             "Select GC settings based on available memory (MB)", 0)
         || !op.addStringOption('\0', "arm-hwcap", "[features]",
@@ -10699,6 +11541,15 @@ main(int argc, char** argv, char** envp)
     if (cpuCount >= 0) {
         SetFakeCPUCount(cpuCount);
     }
+    if (op.getIntOption("worker-pool-size") > 0) {
+        workerPoolSize = op.getIntOption("worker-pool-size");
+    }
+    if (op.getBoolOption("pin-helper-threads")) {
+        JS::SetHelperThreadNumaPinning(true);
+    }
+    if (op.getBoolOption("mutex-profile") && !js::SetMutexContentionProfiling(true)) {
+        return 1;
+    }
 
     size_t nurseryBytes = JS::DefaultNurseryBytes;
     nurseryBytes = op.getIntOption("nursery-size") * 1024L * 1024L;
@@ -10765,7 +11616,17 @@ main(int argc, char** argv, char** envp)
         }
     }
 
-    if (!JS::InitSelfHostedCode(cx)) {
+    selfHostedXDRPath = op.getStringOption("selfhosted-xdr-path");
+    if (selfHostedXDRPath) {
+        JS::TranscodeBuffer xdrCache;
+        if (!ReadSelfHostedXDRFile(xdrCache)) {
+            return 1;
+        }
+        JS::TranscodeRange xdrRange(xdrCache.begin(), xdrCache.length());
+        if (!JS::InitSelfHostedCode(cx, xdrRange, WriteSelfHostedXDRFile)) {
+            return 1;
+        }
+    } else if (!JS::InitSelfHostedCode(cx)) {
         return 1;
     }
 
@@ -10813,5 +11674,9 @@ main(int argc, char** argv, char** envp)
     CancelOffThreadJobsForRuntime(cx);
 
     JS_DestroyContext(cx);
+
+    if (op.getBoolOption("mutex-profile")) {
+        js::DumpMutexContentionProfile(stderr);
+    }
     return result;
 }
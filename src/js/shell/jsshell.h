@@ -113,7 +113,8 @@ enum class ScriptKind
 {
     Script,
     DecodeScript,
-    Module
+    Module,
+    JSON
 };
 
 class NonshrinkingGCObjectVector : public GCVector<JSObject*, 0, SystemAllocPolicy>
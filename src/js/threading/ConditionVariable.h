@@ -53,7 +53,9 @@ public:
   // Block the current thread of execution until this condition variable is
   // woken from another thread via notify_one or notify_all.
   void wait(UniqueLock<Mutex>& lock) {
+    lock.lock.beforeWait();
     impl_.wait(lock.lock);
+    lock.lock.afterWait();
   }
 
   // As with |wait|, block the current thread of execution until woken from
@@ -98,8 +100,10 @@ public:
   // encounter substantially longer delays, depending on system load.
   CVStatus wait_for(UniqueLock<Mutex>& lock,
                     const mozilla::TimeDuration& rel_time) {
-    return impl_.wait_for(lock.lock, rel_time) == mozilla::CVStatus::Timeout
-      ? CVStatus::Timeout : CVStatus::NoTimeout;
+    lock.lock.beforeWait();
+    mozilla::CVStatus status = impl_.wait_for(lock.lock, rel_time);
+    lock.lock.afterWait();
+    return status == mozilla::CVStatus::Timeout ? CVStatus::Timeout : CVStatus::NoTimeout;
   }
 
   // As with |wait_for|, block the current thread of execution until woken from
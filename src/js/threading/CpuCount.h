@@ -13,4 +13,24 @@ namespace js {
  */
 uint32_t GetCPUCount();
 
+/*
+ * Return the number of cores this process can actually use, which may be
+ * fewer than GetCPUCount() if the process is restricted to some of them, or
+ * has a CPU quota (as in a container with a cgroup CPU limit). Unlike
+ * GetCPUCount(), this is not cached and can change while the process runs.
+ */
+uint32_t GetAvailableCPUCount();
+
+/*
+ * Return the number of NUMA nodes on the system, or 1 if this isn't known.
+ */
+uint32_t GetNumaNodeCount();
+
+/*
+ * Return the NUMA node of the core the calling thread is running on, or 0 if
+ * this isn't known. Unless the thread is bound to a node, this can change at
+ * any time.
+ */
+uint32_t GetCurrentNumaNode();
+
 }
@@ -226,7 +226,9 @@ class ExclusiveWaitableData : public ExclusiveData<T>
 
         void wait() {
             auto* parent = static_cast<const ExclusiveWaitableData*>(this->parent());
+            parent->lock_.beforeWait();
             parent->condVar_.impl_.wait(parent->lock_);
+            parent->lock_.afterWait();
         }
 
         void notify_one() {
@@ -245,6 +247,186 @@ class ExclusiveWaitableData : public ExclusiveData<T>
     }
 };
 
+/**
+ * A reader-writer variant of `ExclusiveData`, for values which are read much
+ * more often than they are changed. Any number of threads may hold a read
+ * guard at once, which only gives const access, while a write guard gives
+ * exclusive access:
+ *
+ *     RWExclusiveData<Table> table(mutexid::SomeTable);
+ *
+ *     {
+ *         auto guard = table.readLock();
+ *         guard->lookup(key);
+ *     }
+ *
+ *     {
+ *         auto guard = table.writeLock();
+ *         guard->add(key, value);
+ *     }
+ *
+ * Writers are preferred: new readers wait while a writer is waiting, so a
+ * steady stream of readers can't starve writers. The mutex is only held while
+ * taking and dropping a guard, so holding a guard doesn't count as holding the
+ * mutex for the mutex ordering checks.
+ */
+template <typename T>
+class RWExclusiveData
+{
+    mutable Mutex lock_;
+    mutable ConditionVariable condVar_;
+    mutable T value_;
+
+    // The following are protected by |lock_|.
+    mutable size_t readers_;
+    mutable size_t waitingWriters_;
+    mutable bool writing_;
+
+    RWExclusiveData(const RWExclusiveData&) = delete;
+    RWExclusiveData& operator=(const RWExclusiveData&) = delete;
+
+    void acquireRead() const {
+        UniqueLock<Mutex> lock(lock_);
+        while (writing_ || waitingWriters_) {
+            condVar_.wait(lock);
+        }
+        readers_++;
+    }
+
+    void releaseRead() const {
+        UniqueLock<Mutex> lock(lock_);
+        MOZ_ASSERT(readers_ > 0);
+        readers_--;
+        if (readers_ == 0 && waitingWriters_) {
+            condVar_.notify_all();
+        }
+    }
+
+    void acquireWrite() const {
+        UniqueLock<Mutex> lock(lock_);
+        waitingWriters_++;
+        while (writing_ || readers_) {
+            condVar_.wait(lock);
+        }
+        waitingWriters_--;
+        writing_ = true;
+    }
+
+    void releaseWrite() const {
+        UniqueLock<Mutex> lock(lock_);
+        MOZ_ASSERT(writing_);
+        writing_ = false;
+        condVar_.notify_all();
+    }
+
+  public:
+    /**
+     * Create a new `RWExclusiveData`, constructing the protected value in
+     * place.
+     */
+    template <typename... Args>
+    explicit RWExclusiveData(const MutexId& id, Args&&... args)
+      : lock_(id),
+        value_(std::forward<Args>(args)...),
+        readers_(0),
+        waitingWriters_(0),
+        writing_(false)
+    {}
+
+    ~RWExclusiveData() {
+        MOZ_ASSERT(!readers_);
+        MOZ_ASSERT(!writing_);
+    }
+
+    /**
+     * An RAII class that provides shared, read-only access to the protected
+     * value.
+     */
+    class MOZ_STACK_CLASS ReadGuard
+    {
+        const RWExclusiveData* parent_;
+
+        ReadGuard(const ReadGuard&) = delete;
+        ReadGuard& operator=(const ReadGuard&) = delete;
+
+      public:
+        explicit ReadGuard(const RWExclusiveData& parent)
+          : parent_(&parent)
+        {
+            parent_->acquireRead();
+        }
+
+        ReadGuard(ReadGuard&& rhs)
+          : parent_(rhs.parent_)
+        {
+            MOZ_ASSERT(&rhs != this, "self-move disallowed!");
+            rhs.parent_ = nullptr;
+        }
+
+        const T& get() const {
+            MOZ_ASSERT(parent_);
+            return parent_->value_;
+        }
+
+        operator const T& () const { return get(); }
+        const T* operator->() const { return &get(); }
+
+        ~ReadGuard() {
+            if (parent_) {
+                parent_->releaseRead();
+            }
+        }
+    };
+
+    /**
+     * An RAII class that provides exclusive access to the protected value for
+     * reading and writing.
+     */
+    class MOZ_STACK_CLASS WriteGuard
+    {
+        const RWExclusiveData* parent_;
+
+        WriteGuard(const WriteGuard&) = delete;
+        WriteGuard& operator=(const WriteGuard&) = delete;
+
+      public:
+        explicit WriteGuard(const RWExclusiveData& parent)
+          : parent_(&parent)
+        {
+            parent_->acquireWrite();
+        }
+
+        WriteGuard(WriteGuard&& rhs)
+          : parent_(rhs.parent_)
+        {
+            MOZ_ASSERT(&rhs != this, "self-move disallowed!");
+            rhs.parent_ = nullptr;
+        }
+
+        T& get() const {
+            MOZ_ASSERT(parent_);
+            return parent_->value_;
+        }
+
+        operator T& () const { return get(); }
+        T* operator->() const { return &get(); }
+
+        ~WriteGuard() {
+            if (parent_) {
+                parent_->releaseWrite();
+            }
+        }
+    };
+
+    ReadGuard readLock() const {
+        return ReadGuard(*this);
+    }
+
+    WriteGuard writeLock() const {
+        return WriteGuard(*this);
+    }
+};
+
 } // namespace js
 
 #endif // threading_ExclusiveData_h
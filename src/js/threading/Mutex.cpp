@@ -6,10 +6,178 @@
 
 #include "threading/Mutex.h"
 
+#include "mozilla/IntegerPrintfMacros.h"
+
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+# include <intrin.h>
+#endif
+
+#include "jsfriendapi.h"
 #include "jsutil.h"
 
+#include "vm/MutexIDs.h"
+
 using namespace js;
 
+using mozilla::TimeDuration;
+using mozilla::TimeStamp;
+
+mozilla::Atomic<bool, mozilla::Relaxed, mozilla::recordreplay::Behavior::DontPreserve>
+js::Mutex::ProfilingContention(false);
+
+namespace {
+
+struct MutexContentionStats
+{
+  using Counter = mozilla::Atomic<uint64_t, mozilla::Relaxed,
+                                  mozilla::recordreplay::Behavior::DontPreserve>;
+
+  Counter acquisitions;
+  Counter contended;
+  Counter waitMicroseconds;
+  Counter maxWaitMicroseconds;
+  Counter holdMicroseconds;
+};
+
+static const size_t MutexKindCount = size_t(MutexIndex::Limit);
+
+struct MutexContentionTable
+{
+  MutexContentionStats kinds[MutexKindCount];
+};
+
+} // anonymous namespace
+
+static const char* const MutexNames[MutexKindCount] = {
+  "(other)",
+#define MUTEX_NAME(name, order) #name,
+  FOR_EACH_MUTEX(MUTEX_NAME)
+#undef MUTEX_NAME
+};
+
+// Allocated when profiling is first enabled, and only freed on shutdown, so
+// that mutexes on other threads never see it go away.
+static mozilla::Atomic<MutexContentionTable*> sContentionStats(nullptr);
+
+static MutexContentionStats&
+ContentionStatsFor(const MutexId& id)
+{
+  MutexContentionTable* table = sContentionStats;
+  MOZ_ASSERT(table);
+  return table->kinds[id.index < MutexKindCount ? id.index : 0];
+}
+
+static MOZ_ALWAYS_INLINE void
+SpinPause()
+{
+#if defined(_MSC_VER) && (defined(_M_IX86) || defined(_M_X64))
+  _mm_pause();
+#elif defined(__GNUC__) && (defined(__i386__) || defined(__x86_64__))
+  __builtin_ia32_pause();
+#elif defined(__GNUC__) && (defined(__aarch64__) || defined(__arm__))
+  asm volatile("yield" ::: "memory");
+#endif
+}
+
+void
+js::Mutex::lockSlow()
+{
+  bool profiling = ProfilingContention;
+  TimeStamp start = profiling ? TimeStamp::Now() : TimeStamp();
+  bool contended = held_;
+
+  if (contended) {
+    // Spin in case the holder releases the mutex soon. Spin for longer next
+    // time if it did, and for less if it didn't.
+    uint32_t limit = spinLimit_;
+    for (uint32_t spins = 0; held_ && spins < limit; spins++) {
+      SpinPause();
+    }
+    if (held_) {
+      spinLimit_ = limit / 2 > MinSpinLimit ? limit / 2 : MinSpinLimit;
+    } else {
+      spinLimit_ = limit * 2 < MaxSpinLimit ? limit * 2 : MaxSpinLimit;
+    }
+  }
+
+  MutexImpl::lock();
+
+  if (profiling) {
+    TimeStamp now = TimeStamp::Now();
+    uint64_t wait = uint64_t((now - start).ToMicroseconds());
+
+    MutexContentionStats& stats = ContentionStatsFor(id_);
+    stats.acquisitions++;
+    if (contended) {
+      stats.contended++;
+    }
+    stats.waitMicroseconds += wait;
+    uint64_t maxWait = stats.maxWaitMicroseconds;
+    while (wait > maxWait && !stats.maxWaitMicroseconds.compareExchange(maxWait, wait)) {
+      maxWait = stats.maxWaitMicroseconds;
+    }
+
+    acquireTime_ = now;
+  }
+}
+
+void
+js::Mutex::recordHoldTime()
+{
+  // The mutex may have been acquired before profiling was enabled.
+  if (acquireTime_.IsNull()) {
+    return;
+  }
+
+  TimeDuration held = TimeStamp::Now() - acquireTime_;
+  ContentionStatsFor(id_).holdMicroseconds += uint64_t(held.ToMicroseconds());
+  acquireTime_ = TimeStamp();
+}
+
+JS_FRIEND_API(bool)
+js::SetMutexContentionProfiling(bool enabled)
+{
+  if (enabled && !sContentionStats) {
+    MutexContentionTable* table = js_new<MutexContentionTable>();
+    if (!table) {
+      return false;
+    }
+    sContentionStats = table;
+  }
+
+  Mutex::ProfilingContention = enabled;
+  return true;
+}
+
+/* static */ void
+js::Mutex::ShutDownContentionProfiling()
+{
+  ProfilingContention = false;
+  js_delete(sContentionStats.exchange(nullptr));
+}
+
+JS_FRIEND_API(void)
+js::DumpMutexContentionProfile(FILE* fp)
+{
+  MutexContentionTable* table = sContentionStats;
+  if (!table) {
+    return;
+  }
+
+  fprintf(fp, "%-28s %12s %12s %12s %12s %12s\n",
+          "Mutex", "Acquired", "Contended", "Wait (us)", "Max wait", "Held (us)");
+  for (size_t i = 0; i < MutexKindCount; i++) {
+    const MutexContentionStats& s = table->kinds[i];
+    if (!s.acquisitions) {
+      continue;
+    }
+    fprintf(fp, "%-28s %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 " %12" PRIu64 "\n",
+            MutexNames[i], uint64_t(s.acquisitions), uint64_t(s.contended),
+            uint64_t(s.waitMicroseconds), uint64_t(s.maxWaitMicroseconds),
+            uint64_t(s.holdMicroseconds));
+  }
+}
+
 #ifdef DEBUG
 
 MOZ_THREAD_LOCAL(js::Mutex::MutexVector*) js::Mutex::HeldMutexStack;
@@ -57,7 +225,7 @@ js::Mutex::lock()
     }
   }
 
-  MutexImpl::lock();
+  lockAdaptive();
 
   AutoEnterOOMUnsafeRegion oomUnsafe;
   if (!stack.append(this)) {
@@ -70,7 +238,7 @@ js::Mutex::unlock()
 {
   auto& stack = heldMutexStack();
   MOZ_ASSERT(stack.back() == this);
-  MutexImpl::unlock();
+  unlockAdaptive();
   stack.popBack();
 }
 
@@ -86,4 +254,16 @@ js::Mutex::ownedByCurrentThread() const
   return false;
 }
 
+#else
+
+/* static */ bool
+js::Mutex::Init()
+{
+  return true;
+}
+
+/* static */ void
+js::Mutex::ShutDown()
+{}
+
 #endif
@@ -8,9 +8,12 @@
 #define threading_Mutex_h
 
 #include "mozilla/Assertions.h"
+#include "mozilla/Atomics.h"
+#include "mozilla/Likely.h"
 #include "mozilla/Move.h"
 #include "mozilla/PlatformMutex.h"
 #include "mozilla/ThreadLocal.h"
+#include "mozilla/TimeStamp.h"
 #include "mozilla/Vector.h"
 
 namespace js {
@@ -20,33 +23,25 @@ namespace js {
 // The mutex order defines the allowed order of mutex acqusition on a single
 // thread. Mutexes must be acquired in strictly increasing order. Mutexes with
 // the same order may not be held at the same time by that thread.
+//
+// The index identifies the kind of mutex to the contention profiler (see
+// MutexIndex in vm/MutexIDs.h).
 struct MutexId
 {
   const char* name;
   uint32_t order;
+  uint32_t index = 0;
 };
 
-#ifndef DEBUG
-
-class Mutex : public mozilla::detail::MutexImpl
-{
-public:
-  static bool Init() { return true; }
-  static void ShutDown() {}
-
-  explicit Mutex(const MutexId& id)
-    : mozilla::detail::MutexImpl(mozilla::recordreplay::Behavior::DontPreserve)
-  {}
-
-  using MutexImpl::lock;
-  using MutexImpl::unlock;
-};
-
-#else
-
-// In debug builds, js::Mutex is a wrapper over MutexImpl that checks correct
-// locking order is observed.
+// js::Mutex is an adaptive mutex: a thread which finds the mutex held spins
+// for a while before parking, as most of our critical sections are short and
+// parking costs two context switches. The spin limit of each mutex adapts to
+// how often spinning worked out for it.
+//
+// When contention profiling is enabled (see js::SetMutexContentionProfiling),
+// the time spent waiting for and holding each kind of mutex is recorded.
 //
+// In debug builds, js::Mutex also checks correct locking order is observed.
 // The class maintains a per-thread stack of currently-held mutexes to enable it
 // to check this.
 class Mutex : public mozilla::detail::MutexImpl
@@ -55,26 +50,89 @@ public:
   static bool Init();
   static void ShutDown();
 
+  // Stop profiling contention and free the profile, when shutting down the
+  // engine.
+  static void ShutDownContentionProfiling();
+
   explicit Mutex(const MutexId& id)
     : mozilla::detail::MutexImpl(mozilla::recordreplay::Behavior::DontPreserve),
-      id_(id)
+      id_(id),
+      held_(false),
+      spinLimit_(InitialSpinLimit)
   {
     MOZ_ASSERT(id_.order != 0);
   }
 
+#ifdef DEBUG
   void lock();
   void unlock();
   bool ownedByCurrentThread() const;
+#else
+  void lock() { lockAdaptive(); }
+  void unlock() { unlockAdaptive(); }
+#endif
+
+  // Condition variables release and reacquire the mutex while waiting
+  // without going through lock() and unlock(), so they tell us about it.
+  void beforeWait() {
+    if (MOZ_UNLIKELY(ProfilingContention)) {
+      recordHoldTime();
+    }
+    held_ = false;
+  }
+  void afterWait() {
+    held_ = true;
+    if (MOZ_UNLIKELY(ProfilingContention)) {
+      acquireTime_ = mozilla::TimeStamp::Now();
+    }
+  }
+
+  static mozilla::Atomic<bool, mozilla::Relaxed,
+                         mozilla::recordreplay::Behavior::DontPreserve> ProfilingContention;
 
 private:
+  static const uint32_t MinSpinLimit = 16;
+  static const uint32_t InitialSpinLimit = 128;
+  static const uint32_t MaxSpinLimit = 4096;
+
   const MutexId id_;
 
+  // Whether some thread holds the mutex. This is only a hint for other
+  // threads deciding whether to spin.
+  mozilla::Atomic<bool, mozilla::Relaxed,
+                  mozilla::recordreplay::Behavior::DontPreserve> held_;
+  mozilla::Atomic<uint32_t, mozilla::Relaxed,
+                  mozilla::recordreplay::Behavior::DontPreserve> spinLimit_;
+
+  // When the mutex was acquired, if contention profiling was enabled then.
+  // Only accessed by the thread holding the mutex.
+  mozilla::TimeStamp acquireTime_;
+
+  void lockAdaptive() {
+    if (MOZ_UNLIKELY(held_ || ProfilingContention)) {
+      lockSlow();
+    } else {
+      MutexImpl::lock();
+    }
+    held_ = true;
+  }
+  void unlockAdaptive() {
+    if (MOZ_UNLIKELY(ProfilingContention)) {
+      recordHoldTime();
+    }
+    held_ = false;
+    MutexImpl::unlock();
+  }
+
+  void lockSlow();
+  void recordHoldTime();
+
+#ifdef DEBUG
   using MutexVector = mozilla::Vector<const Mutex*>;
   static MOZ_THREAD_LOCAL(MutexVector*) HeldMutexStack;
   static MutexVector& heldMutexStack();
-};
-
 #endif
+};
 
 } // namespace js
 
@@ -71,6 +71,10 @@ CheckZone<Helper>::check() const
         return;
     }
 
+    if (zone->ownedByCurrentGCSweepTask()) {
+        return;
+    }
+
     if (zone->usedByHelperThread()) {
         // This may only be accessed by the helper thread using this zone.
         MOZ_ASSERT(zone->ownedByCurrentHelperThread());
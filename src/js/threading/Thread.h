@@ -192,6 +192,11 @@ void SetName(const char* name);
 // 'nameBuffer', including the terminating NUL.
 void GetName(char* nameBuffer, size_t len);
 
+// Restrict the current thread to the cores of the given NUMA node (see
+// GetNumaNodeCount). Returns false if this failed or isn't supported on this
+// platform, in which case the thread keeps running wherever it likes.
+bool BindToNumaNode(uint32_t node);
+
 } // namespace ThisThread
 
 namespace detail {
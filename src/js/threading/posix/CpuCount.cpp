@@ -3,8 +3,14 @@
  * License, v. 2.0. If a copy of the MPL was not distributed with this
  * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
 
+#include <stdio.h>
 #include <unistd.h>
 
+#if defined(__linux__)
+#include <sched.h>
+#include <sys/syscall.h>
+#endif
+
 #include "threading/CpuCount.h"
 
 uint32_t
@@ -28,3 +34,106 @@ js::GetCPUCount()
 
     return ncpus;
 }
+
+#if defined(__linux__)
+static bool
+ReadCgroupValues(const char* path, const char* format, long long* a, long long* b)
+{
+    FILE* fp = fopen(path, "r");
+    if (!fp) {
+        return false;
+    }
+    int n = b ? fscanf(fp, format, a, b) : fscanf(fp, format, a);
+    fclose(fp);
+    return n == (b ? 2 : 1);
+}
+
+// The CPU quota of the process's cgroup, rounded up to whole cores, or 0 if
+// it doesn't have one. Inside a container the cgroup filesystem is rooted at
+// the container's own cgroup, so this only looks at the root.
+static uint32_t
+CgroupCPUQuota()
+{
+    long long quota = -1, period = 0;
+
+    // cgroup v2 has "max 100000" or "<quota> <period>" in a single file.
+    if (!ReadCgroupValues("/sys/fs/cgroup/cpu.max", "%lld %lld", &quota, &period)) {
+        // cgroup v1 has them separately, with a quota of -1 for no limit.
+        if (!ReadCgroupValues("/sys/fs/cgroup/cpu/cpu.cfs_quota_us", "%lld", &quota, nullptr) ||
+            !ReadCgroupValues("/sys/fs/cgroup/cpu/cpu.cfs_period_us", "%lld", &period, nullptr))
+        {
+            return 0;
+        }
+    }
+
+    if (quota <= 0 || period <= 0) {
+        return 0;
+    }
+    return uint32_t((quota + period - 1) / period);
+}
+#endif
+
+uint32_t
+js::GetAvailableCPUCount()
+{
+    uint32_t ncpus = GetCPUCount();
+
+#if defined(__linux__)
+# if defined(CPU_COUNT)
+    cpu_set_t cpus;
+    if (sched_getaffinity(0, sizeof cpus, &cpus) == 0) {
+        int n = CPU_COUNT(&cpus);
+        if (n > 0 && uint32_t(n) < ncpus) {
+            ncpus = uint32_t(n);
+        }
+    }
+# endif
+
+    uint32_t quota = CgroupCPUQuota();
+    if (quota > 0 && quota < ncpus) {
+        ncpus = quota;
+    }
+#endif
+
+    return ncpus;
+}
+
+uint32_t
+js::GetNumaNodeCount()
+{
+    static uint32_t nnodes = 0;
+
+    if (nnodes == 0) {
+        nnodes = 1;
+#if defined(__linux__)
+        // This is a list of ranges like "0-3" or "0,2", so the node count is
+        // one more than the last number in it.
+        if (FILE* fp = fopen("/sys/devices/system/node/possible", "r")) {
+            unsigned n;
+            int c;
+            while (fscanf(fp, "%u", &n) == 1) {
+                nnodes = uint32_t(n) + 1;
+                c = fgetc(fp);
+                if (c != '-' && c != ',') {
+                    break;
+                }
+            }
+            fclose(fp);
+        }
+#endif
+    }
+
+    return nnodes;
+}
+
+uint32_t
+js::GetCurrentNumaNode()
+{
+#if defined(__linux__) && defined(SYS_getcpu)
+    unsigned cpu, node;
+    if (syscall(SYS_getcpu, &cpu, &node, nullptr) == 0) {
+        return uint32_t(node);
+    }
+#endif
+    return 0;
+}
@@ -20,6 +20,8 @@
 #endif
 
 #if defined(__linux__)
+#include <sched.h>
+#include <stdio.h>
 #include <sys/prctl.h>
 #endif
 
@@ -219,3 +221,44 @@ js::ThisThread::GetName(char* nameBuffer, size_t len)
     nameBuffer[0] = '\0';
   }
 }
+
+bool
+js::ThisThread::BindToNumaNode(uint32_t node)
+{
+#if defined(__linux__) && defined(CPU_SET)
+  char path[64];
+  snprintf(path, sizeof path, "/sys/devices/system/node/node%u/cpulist", unsigned(node));
+  FILE* fp = fopen(path, "r");
+  if (!fp) {
+    return false;
+  }
+
+  // The node's cores are a list of ranges like "0-7,16-23".
+  cpu_set_t cpus;
+  CPU_ZERO(&cpus);
+  bool any = false;
+  unsigned first, last;
+  while (fscanf(fp, "%u", &first) == 1) {
+    last = first;
+    int c = fgetc(fp);
+    if (c == '-') {
+      if (fscanf(fp, "%u", &last) != 1) {
+        break;
+      }
+      c = fgetc(fp);
+    }
+    for (unsigned cpu = first; cpu <= last && cpu < CPU_SETSIZE; cpu++) {
+      CPU_SET(cpu, &cpus);
+      any = true;
+    }
+    if (c != ',') {
+      break;
+    }
+  }
+  fclose(fp);
+
+  return any && pthread_setaffinity_np(pthread_self(), sizeof cpus, &cpus) == 0;
+#else
+  return false;
+#endif
+}
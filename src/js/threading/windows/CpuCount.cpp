@@ -20,3 +20,45 @@ js::GetCPUCount()
 
     return ncpus;
 }
+
+uint32_t
+js::GetAvailableCPUCount()
+{
+    uint32_t ncpus = GetCPUCount();
+
+    DWORD_PTR processMask, systemMask;
+    if (GetProcessAffinityMask(GetCurrentProcess(), &processMask, &systemMask)) {
+        uint32_t n = 0;
+        for (; processMask; processMask &= processMask - 1) {
+            n++;
+        }
+        if (n > 0 && n < ncpus) {
+            ncpus = n;
+        }
+    }
+
+    return ncpus;
+}
+
+uint32_t
+js::GetNumaNodeCount()
+{
+    static uint32_t nnodes = 0;
+
+    if (nnodes == 0) {
+        ULONG highest;
+        nnodes = GetNumaHighestNodeNumber(&highest) ? uint32_t(highest) + 1 : 1;
+    }
+
+    return nnodes;
+}
+
+uint32_t
+js::GetCurrentNumaNode()
+{
+    UCHAR node;
+    if (!GetNumaProcessorNode(UCHAR(GetCurrentProcessorNumber()), &node) || node == 0xff) {
+        return 0;
+    }
+    return uint32_t(node);
+}
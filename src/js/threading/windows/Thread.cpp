@@ -196,3 +196,13 @@ js::ThisThread::GetName(char* nameBuffer, size_t len)
   MOZ_RELEASE_ASSERT(len > 0);
   *nameBuffer = '\0';
 }
+
+bool
+js::ThisThread::BindToNumaNode(uint32_t node)
+{
+  ULONGLONG mask;
+  if (node > 0xff || !GetNumaNodeProcessorMask(UCHAR(node), &mask) || !mask) {
+    return false;
+  }
+  return SetThreadAffinityMask(GetCurrentThread(), DWORD_PTR(mask)) != 0;
+}
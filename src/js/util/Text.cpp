@@ -6,6 +6,7 @@
 
 #include "util/Text.h"
 
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/PodOperations.h"
 
 #include "gc/GC.h"
@@ -13,6 +14,11 @@
 #include "vm/JSContext.h"
 #include "vm/StringType.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define JS_TEXT_SSE2
+#  include <emmintrin.h>
+#endif
+
 using namespace JS;
 using namespace js;
 using js::gc::AutoSuppressGC;
@@ -37,6 +43,86 @@ js_strchr_limit(const Latin1Char* s, char16_t c, const Latin1Char* limit);
 template const char16_t*
 js_strchr_limit(const char16_t* s, char16_t c, const char16_t* limit);
 
+#ifdef JS_TEXT_SSE2
+
+// Loads 8 chars as 16-bit units.
+static MOZ_ALWAYS_INLINE __m128i
+LoadUnits(const Latin1Char* s)
+{
+    __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(s));
+    return _mm_unpacklo_epi8(bytes, _mm_setzero_si128());
+}
+
+static MOZ_ALWAYS_INLINE __m128i
+LoadUnits(const char16_t* s)
+{
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(s));
+}
+
+#endif // JS_TEXT_SSE2
+
+template <typename Char1, typename Char2>
+static MOZ_ALWAYS_INLINE size_t
+FindFirstMismatchImpl(const Char1* s1, const Char2* s2, size_t len)
+{
+    size_t i = 0;
+#ifdef JS_TEXT_SSE2
+    for (; len - i >= 8; i += 8) {
+        __m128i equal = _mm_cmpeq_epi16(LoadUnits(s1 + i), LoadUnits(s2 + i));
+        uint32_t mask = uint32_t(_mm_movemask_epi8(equal));
+        if (mask != 0xffff) {
+            return i + mozilla::CountTrailingZeroes32(~mask) / 2;
+        }
+    }
+#endif
+    for (; i < len; i++) {
+        if (s1[i] != s2[i]) {
+            return i;
+        }
+    }
+    return len;
+}
+
+size_t
+js::FindFirstMismatch(const Latin1Char* s1, const Latin1Char* s2, size_t len)
+{
+    size_t i = 0;
+#ifdef JS_TEXT_SSE2
+    for (; len - i >= 16; i += 16) {
+        __m128i v1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s1 + i));
+        __m128i v2 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(s2 + i));
+        uint32_t mask = uint32_t(_mm_movemask_epi8(_mm_cmpeq_epi8(v1, v2)));
+        if (mask != 0xffff) {
+            return i + mozilla::CountTrailingZeroes32(~mask);
+        }
+    }
+#endif
+    for (; i < len; i++) {
+        if (s1[i] != s2[i]) {
+            return i;
+        }
+    }
+    return len;
+}
+
+size_t
+js::FindFirstMismatch(const Latin1Char* s1, const char16_t* s2, size_t len)
+{
+    return FindFirstMismatchImpl(s1, s2, len);
+}
+
+size_t
+js::FindFirstMismatch(const char16_t* s1, const Latin1Char* s2, size_t len)
+{
+    return FindFirstMismatchImpl(s2, s1, len);
+}
+
+size_t
+js::FindFirstMismatch(const char16_t* s1, const char16_t* s2, size_t len)
+{
+    return FindFirstMismatchImpl(s1, s2, len);
+}
+
 int32_t
 js_fputs(const char16_t* s, FILE* f)
 {
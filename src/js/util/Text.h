@@ -62,6 +62,21 @@ EqualChars(const Char1* s1, const Char2* s2, size_t len)
     return mozilla::ArrayEqual(s1, s2, len);
 }
 
+// Return the index of the first char at which s1 and s2 differ, or len if
+// they are equal. Unlike EqualChars and CompareChars, these compare a vector
+// of chars at a time where possible, so they are better for long strings.
+extern size_t
+FindFirstMismatch(const Latin1Char* s1, const Latin1Char* s2, size_t len);
+
+extern size_t
+FindFirstMismatch(const Latin1Char* s1, const char16_t* s2, size_t len);
+
+extern size_t
+FindFirstMismatch(const char16_t* s1, const Latin1Char* s2, size_t len);
+
+extern size_t
+FindFirstMismatch(const char16_t* s1, const char16_t* s2, size_t len);
+
 // Return less than, equal to, or greater than zero depending on whether
 // s1 is less than, equal to, or greater than s2.
 template <typename Char1, typename Char2>
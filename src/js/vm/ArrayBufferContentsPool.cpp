@@ -0,0 +1,118 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "vm/ArrayBufferContentsPool.h"
+
+#include "mozilla/MathAlgorithms.h"
+#include "mozilla/PodOperations.h"
+
+#include <string.h>
+
+#include "js/Utility.h"
+#include "threading/LockGuard.h"
+#include "vm/MutexIDs.h"
+
+using namespace js;
+
+ArrayBufferContentsPool::ArrayBufferContentsPool()
+  : lock_(mutexid::ArrayBufferContentsPool)
+{
+    mozilla::PodArrayZero(heads_);
+    mozilla::PodArrayZero(counts_);
+}
+
+ArrayBufferContentsPool::~ArrayBufferContentsPool()
+{
+    purge();
+}
+
+/* static */ bool
+ArrayBufferContentsPool::sizeClass(size_t nbytes, size_t* index)
+{
+    if (nbytes < MinSize || nbytes > MaxSize || !mozilla::IsPowerOfTwo(nbytes)) {
+        return false;
+    }
+
+    *index = mozilla::FloorLog2(nbytes) - MinSizeLog2;
+    return true;
+}
+
+void*
+ArrayBufferContentsPool::take(size_t nbytes)
+{
+    size_t index;
+    if (!sizeClass(nbytes, &index)) {
+        return nullptr;
+    }
+
+    FreeContents* contents;
+    {
+        LockGuard<Mutex> guard(lock_);
+        contents = heads_[index];
+        if (!contents) {
+            return nullptr;
+        }
+        heads_[index] = contents->next;
+        counts_[index]--;
+    }
+
+    contents->next = nullptr;
+    return contents;
+}
+
+bool
+ArrayBufferContentsPool::put(void* p, size_t nbytes)
+{
+    size_t index;
+    if (!sizeClass(nbytes, &index)) {
+        return false;
+    }
+
+    {
+        LockGuard<Mutex> guard(lock_);
+        if (counts_[index] >= MaxBytesPerSizeClass / nbytes) {
+            return false;
+        }
+        counts_[index]++;
+    }
+
+    // Zero the contents without holding the lock, so the main thread can take
+    // other contents in the meantime.
+    memset(p, 0, nbytes);
+
+    LockGuard<Mutex> guard(lock_);
+    FreeContents* contents = static_cast<FreeContents*>(p);
+    contents->next = heads_[index];
+    heads_[index] = contents;
+    return true;
+}
+
+void
+ArrayBufferContentsPool::purge()
+{
+    FreeContents* lists[NumSizeClasses];
+    {
+        LockGuard<Mutex> guard(lock_);
+        for (size_t i = 0; i < NumSizeClasses; i++) {
+            lists[i] = heads_[i];
+            heads_[i] = nullptr;
+
+            // Contents still being zeroed by put() are added after this, and
+            // stay counted until they're taken or purged.
+            for (FreeContents* contents = lists[i]; contents; contents = contents->next) {
+                counts_[i]--;
+            }
+        }
+    }
+
+    for (FreeContents* contents : lists) {
+        while (contents) {
+            FreeContents* next = contents->next;
+            js_free(contents);
+            contents = next;
+        }
+    }
+}
@@ -0,0 +1,79 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef vm_ArrayBufferContentsPool_h
+#define vm_ArrayBufferContentsPool_h
+
+#include "mozilla/Attributes.h"
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "threading/Mutex.h"
+
+namespace js {
+
+// A cache of the malloced contents of finalized ArrayBuffers, for programs that
+// keep allocating buffers of the same few sizes, like I/O buffers. Contents are
+// zeroed when they're added to the pool, which usually happens on the helper
+// thread that finalizes ArrayBuffers, so taking zeroed contents from the pool
+// is cheaper for the main thread than calling calloc.
+//
+// Only power of two sizes from MinSize to MaxSize are pooled, so each size
+// class holds contents of exactly its size and nothing is rounded up. The pool
+// is emptied at the start of every GC, which returns everything that wasn't
+// reused since the previous GC to the system.
+//
+// The pool is shared by the main thread and GC helper threads.
+class ArrayBufferContentsPool
+{
+  public:
+    static const size_t MinSizeLog2 = 12;
+    static const size_t MaxSizeLog2 = 16;
+    static const size_t MinSize = size_t(1) << MinSizeLog2;
+    static const size_t MaxSize = size_t(1) << MaxSizeLog2;
+    static const size_t NumSizeClasses = MaxSizeLog2 - MinSizeLog2 + 1;
+
+    // The most memory kept in each size class.
+    static const size_t MaxBytesPerSizeClass = 1024 * 1024;
+
+  private:
+    // Pooled contents are linked through their first word, which is zeroed
+    // again when they're taken.
+    struct FreeContents
+    {
+        FreeContents* next;
+    };
+
+    Mutex lock_;
+    FreeContents* heads_[NumSizeClasses];
+
+    // The number of contents in each size class, including those being zeroed
+    // by put(), so the limit holds while the lock isn't held.
+    size_t counts_[NumSizeClasses];
+
+    static bool sizeClass(size_t nbytes, size_t* index);
+
+  public:
+    ArrayBufferContentsPool();
+    ~ArrayBufferContentsPool();
+
+    // Returns zeroed contents of |nbytes|, or nullptr if the pool has none.
+    // The contents are freed with js_free like any other.
+    void* take(size_t nbytes);
+
+    // Keep |p|, the |nbytes| of malloced contents of a buffer which is being
+    // freed. Returns false if that size isn't pooled or its size class is
+    // full, in which case the caller still owns |p|.
+    MOZ_MUST_USE bool put(void* p, size_t nbytes);
+
+    // Free all the pooled contents.
+    void purge();
+};
+
+} // namespace js
+
+#endif // vm_ArrayBufferContentsPool_h
@@ -463,7 +463,10 @@ ArrayBufferObject::class_constructor(JSContext* cx, unsigned argc, Value* vp)
 static ArrayBufferObject::BufferContents
 AllocateArrayBufferContents(JSContext* cx, uint32_t nbytes)
 {
-    uint8_t* p = cx->pod_callocCanGC<uint8_t>(nbytes, js::ArrayBufferContentsArena);
+    uint8_t* p = static_cast<uint8_t*>(cx->runtime()->arrayBufferContentsPool.take(nbytes));
+    if (!p) {
+        p = cx->pod_callocCanGC<uint8_t>(nbytes, js::ArrayBufferContentsArena);
+    }
     return ArrayBufferObject::BufferContents::create<ArrayBufferObject::PLAIN>(p);
 }
 
@@ -681,7 +684,10 @@ class js::WasmArrayRawBuffer
     }
 
   public:
-    static WasmArrayRawBuffer* Allocate(uint32_t numBytes, const Maybe<uint32_t>& maxSize);
+    // Without WASM_HUGE_MEMORY, address space is reserved up to |maxSize|, or
+    // up to |reservedSize| if it is larger, so the buffer can grow in place.
+    static WasmArrayRawBuffer* Allocate(uint32_t numBytes, const Maybe<uint32_t>& maxSize,
+                                        uint32_t reservedSize = 0);
     static void Release(void* mem);
 
     uint8_t* dataPointer() {
@@ -762,7 +768,8 @@ class js::WasmArrayRawBuffer
 };
 
 /* static */ WasmArrayRawBuffer*
-WasmArrayRawBuffer::Allocate(uint32_t numBytes, const Maybe<uint32_t>& maxSize)
+WasmArrayRawBuffer::Allocate(uint32_t numBytes, const Maybe<uint32_t>& maxSize,
+                             uint32_t reservedSize)
 {
     MOZ_RELEASE_ASSERT(numBytes <= ArrayBufferObject::MaxBufferByteLength);
 
@@ -770,7 +777,8 @@ WasmArrayRawBuffer::Allocate(uint32_t numBytes, const Maybe<uint32_t>& maxSize)
 #ifdef WASM_HUGE_MEMORY
     mappedSize = wasm::HugeMappedSize;
 #else
-    mappedSize = wasm::ComputeMappedSize(maxSize.valueOr(numBytes));
+    MOZ_ASSERT(reservedSize % wasm::PageSize == 0);
+    mappedSize = wasm::ComputeMappedSize(Max(maxSize.valueOr(numBytes), reservedSize));
 #endif
 
     MOZ_RELEASE_ASSERT(mappedSize <= SIZE_MAX - gc::SystemPageSize());
@@ -999,7 +1007,9 @@ ArrayBufferObject::releaseData(FreeOp* fop)
 
     switch (bufferKind()) {
       case PLAIN:
-        fop->free_(dataPointer());
+        if (!runtimeFromAnyThread()->arrayBufferContentsPool.put(dataPointer(), byteLength())) {
+            fop->free_(dataPointer());
+        }
         break;
       case MAPPED:
         gc::DeallocateMappedContent(dataPointer(), byteLength());
@@ -1142,7 +1152,20 @@ ArrayBufferObject::wasmMovingGrowToSize(uint32_t newSize,
         return false;
     }
 
-    WasmArrayRawBuffer* newRawBuf = WasmArrayRawBuffer::Allocate(newSize, Nothing());
+    // Reserve some space past the new size, so that the next grows are done in
+    // place instead of copying the whole memory again. If that much address
+    // space is not available, only reserve the new size.
+    uint32_t newPages = newSize / wasm::PageSize;
+    uint32_t reservedSize = newSize;
+    if (newPages / 2 <= (ArrayBufferObject::MaxBufferByteLength - newSize) / wasm::PageSize) {
+        reservedSize += (newPages / 2) * wasm::PageSize;
+    }
+
+    WasmArrayRawBuffer* newRawBuf = WasmArrayRawBuffer::Allocate(newSize, Nothing(),
+                                                                 reservedSize);
+    if (!newRawBuf && reservedSize > newSize) {
+        newRawBuf = WasmArrayRawBuffer::Allocate(newSize, Nothing());
+    }
     if (!newRawBuf) {
         return false;
     }
@@ -1414,7 +1437,7 @@ ArrayBufferObject::addSizeOfExcludingThis(JSObject* obj, mozilla::MallocSizeOf m
         }
         break;
       case MAPPED:
-        info->objectsNonHeapElementsNormal += buffer.byteLength();
+        info->objectsNonHeapElementsMapped += buffer.byteLength();
         break;
       case WASM:
         info->objectsNonHeapElementsWasm += buffer.byteLength();
@@ -1901,6 +1924,17 @@ JS_ReleaseMappedArrayBufferContents(void* contents, size_t length)
     gc::DeallocateMappedContent(contents, length);
 }
 
+JS_PUBLIC_API(bool)
+JS_AdviseMappedArrayBufferContents(void* contents, size_t length,
+                                   JS::MappedArrayBufferAdvice advice)
+{
+    MOZ_ASSERT(contents);
+    if (!length) {
+        return true;
+    }
+    return gc::AdviseMappedContent(contents, length, advice);
+}
+
 JS_FRIEND_API(bool)
 JS_IsMappedArrayBufferObject(JSObject* obj)
 {
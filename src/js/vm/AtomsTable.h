@@ -11,8 +11,12 @@
 #ifndef vm_AtomsTable_h
 #define vm_AtomsTable_h
 
+#include "mozilla/Atomics.h"
+
 #include "js/GCHashTable.h"
 #include "js/TypeDecls.h"
+#include "js/UniquePtr.h"
+#include "js/Vector.h"
 #include "vm/JSAtom.h"
 
 /*
@@ -24,6 +28,10 @@
  * threads. Concurrent access improves performance of off-thread parsing which
  * frequently creates large numbers of atoms. Locking is only required when
  * off-thread parsing is running.
+ *
+ * Each partition also has an index of its atoms which can be searched without
+ * taking the lock, so that looking up existing atoms, which is what most
+ * atomizations do, doesn't contend on the lock.
  */
 
 namespace js {
@@ -112,6 +120,62 @@ class FrozenAtomSet
     AtomSet::Range all() const { return mSet->all(); }
 };
 
+// An insert-only open addressing index of the atoms in a partition which can
+// be searched without holding the partition lock. Atoms are added with the
+// lock held and published with release stores, so readers which find an atom
+// see it fully initialized.
+//
+// The index doesn't support removal. It is rebuilt after the atoms are swept,
+// which is safe because off-thread parsing waits for atoms zone GCs to finish,
+// so there are no concurrent readers then. For the same reason, tables which
+// are replaced when the index grows are kept until there are no helper thread
+// zones, as readers on other threads may still be probing them.
+class ConcurrentAtomIndex
+{
+    using Slot = mozilla::Atomic<JSAtom*, mozilla::ReleaseAcquire>;
+
+    struct Table
+    {
+        uint32_t capacity;
+        UniquePtr<Slot[], JS::FreePolicy> slots;
+
+        explicit Table(uint32_t capacity) : capacity(capacity) {}
+    };
+
+    static const uint32_t InitialCapacity = 32;
+
+    mozilla::Atomic<Table*, mozilla::ReleaseAcquire> table_;
+
+    // The number of atoms in |table_|. Only accessed with the lock held.
+    uint32_t count_;
+
+    Vector<Table*, 0, SystemAllocPolicy> retired_;
+
+    static Table* newTable(uint32_t capacity);
+    static void insert(Table* table, JSAtom* atom);
+    void freeRetiredTables();
+
+  public:
+    ConcurrentAtomIndex();
+    ~ConcurrentAtomIndex();
+    bool init();
+
+    // Return the matching atom, or nullptr if the atom is not (yet) in the
+    // index. Can be called on any thread without holding the lock.
+    MOZ_ALWAYS_INLINE JSAtom* lookup(const AtomHasher::Lookup& lookup) const;
+
+    // Add an atom which was just added to the partition's atoms. The index is
+    // only an accelerator, so this doesn't fail: atoms which can't be added
+    // on OOM are still found by the locked lookup.
+    void add(JSRuntime* rt, JSAtom* atom);
+
+    // Replace the contents with |atoms|. Must only be called while no helper
+    // threads can be atomizing.
+    void rebuild(const AtomSet& atoms);
+
+    size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
+};
+
 class AtomsTable
 {
     static const size_t PartitionShift = 5;
@@ -135,6 +199,9 @@ class AtomsTable
 
         // Set of atoms added while the |atoms| set is being swept.
         AtomSet* atomsAddedWhileSweeping;
+
+        // Lock free index of |atoms|, not used while they are being swept.
+        ConcurrentAtomIndex index;
     };
 
     Partition* partitions[PartitionCount];
@@ -8,7 +8,9 @@
 
 #include "mozilla/FloatingPoint.h"
 #include "mozilla/HashFunctions.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/Maybe.h"
+#include "mozilla/PodOperations.h"
 #include "mozilla/Range.h"
 #include "mozilla/RangedPtr.h"
 
@@ -19,6 +21,7 @@
 
 #include "builtin/BigInt.h"
 #include "gc/Allocator.h"
+#include "gc/RelocationOverlay.h"
 #include "gc/Tracer.h"
 #include "js/Initialization.h"
 #include "js/Utility.h"
@@ -49,6 +52,9 @@ js_mp_free(void* ptr, size_t size)
     return js_free(ptr);
 }
 
+static_assert(sizeof(BigInt) >= sizeof(gc::RelocationOverlay),
+              "BigInts must be large enough to be forwarded out of the nursery");
+
 static bool memoryFunctionsInitialized = false;
 
 JS_PUBLIC_API(void)
@@ -72,10 +78,123 @@ BigInt::init()
     }
 }
 
+BigInt*
+BigInt::allocate(JSContext* cx, gc::InitialHeap heap /* = gc::DefaultHeap */)
+{
+    BigInt* x = AllocateBigInt(cx, heap);
+    if (!x) {
+        return nullptr;
+    }
+    x->reserved_ = gc::Cell::BIGINT_BIT;
+    return x;
+}
+
+void
+BigInt::initInline(bool negative, const mp_limb_t* limbs, size_t nlimbs)
+{
+    MOZ_ASSERT(nlimbs <= InlineLimbs);
+    MOZ_ASSERT_IF(nlimbs > 0, limbs[nlimbs - 1] != 0);
+
+    mozilla::PodCopy(inlineLimbs_, limbs, nlimbs);
+    num_->_mp_alloc = InlineLimbs;
+    num_->_mp_size = negative ? -int(nlimbs) : int(nlimbs);
+    num_->_mp_d = inlineLimbs_;
+}
+
+BigInt*
+BigInt::createInline(JSContext* cx, bool negative, const mp_limb_t* limbs, size_t nlimbs,
+                     gc::InitialHeap heap /* = gc::DefaultHeap */)
+{
+    BigInt* x = allocate(cx, heap);
+    if (!x) {
+        return nullptr;
+    }
+    x->initInline(negative, limbs, nlimbs);
+    return x;
+}
+
+#ifdef __SIZEOF_INT128__
+// Arithmetic on BigInts whose magnitude fits in an int128 is done directly,
+// with bounds on the operands which ensure the result fits too, and the
+// result is stored in inline limbs.
+# define JS_BIGINT_INT128
+
+typedef __int128 Int128;
+typedef unsigned __int128 Uint128;
+
+static const size_t Int128Limbs = 128 / GMP_NUMB_BITS;
+
+static_assert(GMP_NAIL_BITS == 0, "limbs must use all their bits");
+static_assert(128 % GMP_NUMB_BITS == 0, "an int128 must be a whole number of limbs");
+
+// If |x| has at most |maxBits| significant bits, store it in |*result|.
+static bool
+ToInt128(mpz_srcptr x, size_t maxBits, Int128* result)
+{
+    MOZ_ASSERT(maxBits < 128);
+
+    size_t nlimbs = mpz_size(x);
+    if (nlimbs > Int128Limbs || mpz_sizeinbase(x, 2) > maxBits) {
+        return false;
+    }
+
+    const mp_limb_t* limbs = mpz_limbs_read(x);
+    Uint128 magnitude = 0;
+    for (size_t i = nlimbs; i > 0; i--) {
+        magnitude = (magnitude << (GMP_NUMB_BITS - 1) << 1) | limbs[i - 1];
+    }
+    *result = mpz_sgn(x) < 0 ? -Int128(magnitude) : Int128(magnitude);
+    return true;
+}
+
+static BigInt*
+CreateFromInt128(JSContext* cx, Int128 v)
+{
+    bool negative = v < 0;
+    Uint128 magnitude = negative ? -Uint128(v) : Uint128(v);
+
+    mp_limb_t limbs[Int128Limbs];
+    size_t nlimbs = 0;
+    while (magnitude) {
+        limbs[nlimbs++] = mp_limb_t(magnitude);
+        magnitude = magnitude >> (GMP_NUMB_BITS - 1) >> 1;
+    }
+    return BigInt::createInline(cx, negative, limbs, nlimbs);
+}
+
+// BigInt::leftShift(x, shift) for |shift| < 128, when the result fits in an
+// int128. Right shifts round towards negative infinity.
+static bool
+ShiftInt128(Int128 x, int64_t shift, size_t xBits, Int128* result)
+{
+    bool negative = x < 0;
+    Uint128 magnitude = negative ? -Uint128(x) : Uint128(x);
+
+    if (shift >= 0) {
+        if (xBits + uint64_t(shift) > 126) {
+            return false;
+        }
+        magnitude <<= shift;
+    } else {
+        if (shift <= -127) {
+            *result = negative ? -1 : 0;
+            return true;
+        }
+        Uint128 lost = magnitude & ((Uint128(1) << -shift) - 1);
+        magnitude >>= -shift;
+        if (negative && lost) {
+            magnitude++;
+        }
+    }
+    *result = negative ? -Int128(magnitude) : Int128(magnitude);
+    return true;
+}
+#endif
+
 BigInt*
 BigInt::create(JSContext* cx)
 {
-    BigInt* x = Allocate<BigInt>(cx);
+    BigInt* x = allocate(cx);
     if (!x) {
         return nullptr;
     }
@@ -86,7 +205,13 @@ BigInt::create(JSContext* cx)
 BigInt*
 BigInt::createFromDouble(JSContext* cx, double d)
 {
-    BigInt* x = Allocate<BigInt>(cx);
+#ifdef JS_BIGINT_INT128
+    if (mozilla::Abs(d) < 9007199254740992.0 * 9007199254740992.0) {
+        return CreateFromInt128(cx, Int128(d));
+    }
+#endif
+
+    BigInt* x = allocate(cx);
     if (!x) {
         return nullptr;
     }
@@ -97,18 +222,14 @@ BigInt::createFromDouble(JSContext* cx, double d)
 BigInt*
 BigInt::createFromBoolean(JSContext* cx, bool b)
 {
-    BigInt* x = Allocate<BigInt>(cx);
-    if (!x) {
-        return nullptr;
-    }
-    mpz_init_set_ui(x->num_, b);
-    return x;
+    mp_limb_t one = 1;
+    return createInline(cx, false, &one, b ? 1 : 0);
 }
 
 BigInt*
 BigInt::createFromBytes(JSContext* cx, int sign, void* bytes, size_t nbytes)
 {
-    BigInt* x = Allocate<BigInt>(cx);
+    BigInt* x = allocate(cx);
     if (!x) {
         return nullptr;
     }
@@ -170,9 +291,14 @@ js::NumberToBigInt(JSContext* cx, double d)
 }
 
 BigInt*
-BigInt::copy(JSContext* cx, HandleBigInt x)
+BigInt::copy(JSContext* cx, HandleBigInt x, gc::InitialHeap heap /* = gc::DefaultHeap */)
 {
-    BigInt* bi = Allocate<BigInt>(cx);
+    size_t nlimbs = mpz_size(x->num_);
+    if (nlimbs <= InlineLimbs) {
+        return createInline(cx, mpz_sgn(x->num_) < 0, mpz_limbs_read(x->num_), nlimbs, heap);
+    }
+
+    BigInt* bi = allocate(cx, heap);
     if (!bi) {
         return nullptr;
     }
@@ -184,6 +310,13 @@ BigInt::copy(JSContext* cx, HandleBigInt x)
 BigInt*
 BigInt::add(JSContext* cx, HandleBigInt x, HandleBigInt y)
 {
+#ifdef JS_BIGINT_INT128
+    Int128 a, b;
+    if (ToInt128(x->num_, 126, &a) && ToInt128(y->num_, 126, &b)) {
+        return CreateFromInt128(cx, a + b);
+    }
+#endif
+
     BigInt* z = create(cx);
     if (!z) {
         return nullptr;
@@ -196,6 +329,13 @@ BigInt::add(JSContext* cx, HandleBigInt x, HandleBigInt y)
 BigInt*
 BigInt::sub(JSContext* cx, HandleBigInt x, HandleBigInt y)
 {
+#ifdef JS_BIGINT_INT128
+    Int128 a, b;
+    if (ToInt128(x->num_, 126, &a) && ToInt128(y->num_, 126, &b)) {
+        return CreateFromInt128(cx, a - b);
+    }
+#endif
+
     BigInt* z = create(cx);
     if (!z) {
         return nullptr;
@@ -208,6 +348,13 @@ BigInt::sub(JSContext* cx, HandleBigInt x, HandleBigInt y)
 BigInt*
 BigInt::mul(JSContext* cx, HandleBigInt x, HandleBigInt y)
 {
+#ifdef JS_BIGINT_INT128
+    Int128 a, b;
+    if (ToInt128(x->num_, 63, &a) && ToInt128(y->num_, 63, &b)) {
+        return CreateFromInt128(cx, a * b);
+    }
+#endif
+
     BigInt* z = create(cx);
     if (!z) {
         return nullptr;
@@ -289,6 +436,11 @@ BigInt::pow(JSContext* cx, HandleBigInt x, HandleBigInt y)
 BigInt*
 BigInt::neg(JSContext* cx, HandleBigInt x)
 {
+    size_t nlimbs = mpz_size(x->num_);
+    if (nlimbs <= InlineLimbs) {
+        return createInline(cx, mpz_sgn(x->num_) > 0, mpz_limbs_read(x->num_), nlimbs);
+    }
+
     BigInt* res = create(cx);
     if (!res) {
         return nullptr;
@@ -301,6 +453,16 @@ BigInt::neg(JSContext* cx, HandleBigInt x)
 BigInt*
 BigInt::lsh(JSContext* cx, HandleBigInt x, HandleBigInt y)
 {
+#ifdef JS_BIGINT_INT128
+    Int128 a, b;
+    if (ToInt128(x->num_, 126, &a) && ToInt128(y->num_, 126, &b) && b > -128 && b < 128) {
+        Int128 result;
+        if (ShiftInt128(a, int64_t(b), mpz_sizeinbase(x->num_, 2), &result)) {
+            return CreateFromInt128(cx, result);
+        }
+    }
+#endif
+
     BigInt* z = create(cx);
     if (!z) {
         return nullptr;
@@ -321,6 +483,16 @@ BigInt::lsh(JSContext* cx, HandleBigInt x, HandleBigInt y)
 BigInt*
 BigInt::rsh(JSContext* cx, HandleBigInt x, HandleBigInt y)
 {
+#ifdef JS_BIGINT_INT128
+    Int128 a, b;
+    if (ToInt128(x->num_, 126, &a) && ToInt128(y->num_, 126, &b) && b > -128 && b < 128) {
+        Int128 result;
+        if (ShiftInt128(a, -int64_t(b), mpz_sizeinbase(x->num_, 2), &result)) {
+            return CreateFromInt128(cx, result);
+        }
+    }
+#endif
+
     BigInt* z = create(cx);
     if (!z) {
         return nullptr;
@@ -341,6 +513,13 @@ BigInt::rsh(JSContext* cx, HandleBigInt x, HandleBigInt y)
 BigInt*
 BigInt::bitAnd(JSContext* cx, HandleBigInt x, HandleBigInt y)
 {
+#ifdef JS_BIGINT_INT128
+    Int128 a, b;
+    if (ToInt128(x->num_, 126, &a) && ToInt128(y->num_, 126, &b)) {
+        return CreateFromInt128(cx, a & b);
+    }
+#endif
+
     BigInt* z = create(cx);
     if (!z) {
         return nullptr;
@@ -353,6 +532,13 @@ BigInt::bitAnd(JSContext* cx, HandleBigInt x, HandleBigInt y)
 BigInt*
 BigInt::bitXor(JSContext* cx, HandleBigInt x, HandleBigInt y)
 {
+#ifdef JS_BIGINT_INT128
+    Int128 a, b;
+    if (ToInt128(x->num_, 126, &a) && ToInt128(y->num_, 126, &b)) {
+        return CreateFromInt128(cx, a ^ b);
+    }
+#endif
+
     BigInt* z = create(cx);
     if (!z) {
         return nullptr;
@@ -365,6 +551,13 @@ BigInt::bitXor(JSContext* cx, HandleBigInt x, HandleBigInt y)
 BigInt*
 BigInt::bitOr(JSContext* cx, HandleBigInt x, HandleBigInt y)
 {
+#ifdef JS_BIGINT_INT128
+    Int128 a, b;
+    if (ToInt128(x->num_, 126, &a) && ToInt128(y->num_, 126, &b)) {
+        return CreateFromInt128(cx, a | b);
+    }
+#endif
+
     BigInt* z = create(cx);
     if (!z) {
         return nullptr;
@@ -377,6 +570,13 @@ BigInt::bitOr(JSContext* cx, HandleBigInt x, HandleBigInt y)
 BigInt*
 BigInt::bitNot(JSContext* cx, HandleBigInt x)
 {
+#ifdef JS_BIGINT_INT128
+    Int128 a;
+    if (ToInt128(x->num_, 126, &a)) {
+        return CreateFromInt128(cx, ~a);
+    }
+#endif
+
     BigInt* z = create(cx);
     if (!z) {
         return nullptr;
@@ -875,7 +1075,9 @@ BigInt::writeBytes(BigInt* x, RangedPtr<uint8_t> buffer)
 void
 BigInt::finalize(js::FreeOp* fop)
 {
-    mpz_clear(num_);
+    if (!hasInlineLimbs()) {
+        mpz_clear(num_);
+    }
 }
 
 JSAtom*
@@ -916,6 +1118,10 @@ BigInt::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const
     // Use the total number of limbs allocated when calculating the size
     // (_mp_alloc), not the number of limbs currently in use (_mp_size).
     // See the Info node `(gmp)Integer Internals` for details.
+    if (hasInlineLimbs()) {
+        return 0;
+    }
+
     mpz_srcptr n = static_cast<mpz_srcptr>(num_);
     return sizeof(*n) + sizeof(mp_limb_t) * n->_mp_alloc;
 }
@@ -32,7 +32,7 @@ static bool StringToBigIntImpl(const mozilla::Range<const CharT>& chars,
 
 namespace JS {
 
-class BigInt final : public js::gc::TenuredCell
+class BigInt final : public js::gc::Cell
 {
     // StringToBigIntImpl modifies the num_ field of the res argument.
     template <typename CharT>
@@ -41,19 +41,44 @@ class BigInt final : public js::gc::TenuredCell
 
   protected:
     // Reserved word for Cell GC invariants. This also ensures minimum
-    // structure size.
+    // structure size. Cell::BIGINT_BIT is always set so that nursery BigInts
+    // can be told apart from nursery objects.
     uintptr_t reserved_;
 
   private:
+    // BigInts whose magnitude fits in InlineLimbs limbs keep the limbs in the
+    // cell, so creating and finalizing them doesn't touch the malloc heap.
+    // num_ then points at inlineLimbs_. GMP only ever reads such a number,
+    // as all operations store their result in a newly created BigInt.
+    static const size_t InlineLimbs = 128 / GMP_NUMB_BITS;
+
     mpz_t num_;
+    mp_limb_t inlineLimbs_[InlineLimbs];
+
+    bool hasInlineLimbs() const {
+        return num_->_mp_d == inlineLimbs_;
+    }
+
+    // Initialize num_ to use the inline limbs, from the |nlimbs| limbs of a
+    // magnitude, least significant first. The most significant limb must be
+    // nonzero.
+    void initInline(bool negative, const mp_limb_t* limbs, size_t nlimbs);
 
   protected:
-    BigInt() : reserved_(0) { }
+    BigInt() : reserved_(js::gc::Cell::BIGINT_BIT) { }
+
+    // Allocate a BigInt cell, leaving its number uninitialized.
+    static BigInt* allocate(JSContext* cx, js::gc::InitialHeap heap = js::gc::DefaultHeap);
 
   public:
     // Allocate and initialize a BigInt value
     static BigInt* create(JSContext* cx);
 
+    // Create a BigInt using inline limbs, from at most InlineLimbs limbs in
+    // the form taken by initInline.
+    static BigInt* createInline(JSContext* cx, bool negative, const mp_limb_t* limbs,
+                                size_t nlimbs, js::gc::InitialHeap heap = js::gc::DefaultHeap);
+
     static BigInt* createFromDouble(JSContext* cx, double d);
 
     static BigInt* createFromBoolean(JSContext* cx, bool b);
@@ -67,6 +92,66 @@ class BigInt final : public js::gc::TenuredCell
 
     void finalize(js::FreeOp* fop);
 
+    JS::Zone* zone() const {
+        if (isTenured()) {
+            return asTenured().zone();
+        }
+        return js::Nursery::getBigIntZone(this);
+    }
+
+    // Implement TenuredZone members needed for template instantiations.
+
+    JS::Zone* zoneFromAnyThread() const {
+        if (isTenured()) {
+            return asTenured().zoneFromAnyThread();
+        }
+        return js::Nursery::getBigIntZone(this);
+    }
+
+    void fixupAfterMovingGC() {}
+
+    // Called on the tenured copy of a nursery BigInt, to point it at its own
+    // inline limbs.
+    void fixupAfterTenuring(const BigInt* src) {
+        if (src->hasInlineLimbs()) {
+            num_->_mp_d = inlineLimbs_;
+        }
+    }
+
+    js::gc::AllocKind getAllocKind() const { return js::gc::AllocKind::BIGINT; }
+
+    static MOZ_ALWAYS_INLINE void readBarrier(BigInt* thing) {
+        if (js::gc::IsInsideNursery(thing)) {
+            return;
+        }
+        js::gc::TenuredCell::readBarrier(&thing->asTenured());
+    }
+
+    static MOZ_ALWAYS_INLINE void writeBarrierPre(BigInt* thing) {
+        if (!thing || js::gc::IsInsideNursery(thing)) {
+            return;
+        }
+        js::gc::TenuredCell::writeBarrierPre(&thing->asTenured());
+    }
+
+    static void writeBarrierPost(void* cellp, BigInt* prev, BigInt* next) {
+        // See JSObject::writeBarrierPost for a description of the logic here.
+        MOZ_ASSERT(cellp);
+
+        js::gc::StoreBuffer* buffer;
+        if (next && (buffer = next->storeBuffer())) {
+            if (prev && prev->storeBuffer()) {
+                return;
+            }
+            buffer->putCell(static_cast<js::gc::Cell**>(cellp));
+            return;
+        }
+
+        if (prev && (buffer = prev->storeBuffer())) {
+            buffer->unputCell(static_cast<js::gc::Cell**>(cellp));
+        }
+    }
+
     js::HashNumber hash();
 
     size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
@@ -76,7 +161,8 @@ class BigInt final : public js::gc::TenuredCell
 
     static void init();
 
-    static BigInt* copy(JSContext* cx, Handle<BigInt*> x);
+    static BigInt* copy(JSContext* cx, Handle<BigInt*> x,
+                        js::gc::InitialHeap heap = js::gc::DefaultHeap);
     static BigInt* add(JSContext* cx, Handle<BigInt*> x, Handle<BigInt*> y);
     static BigInt* sub(JSContext* cx, Handle<BigInt*> x, Handle<BigInt*> y);
     static BigInt* mul(JSContext* cx, Handle<BigInt*> x, Handle<BigInt*> y);
@@ -765,6 +765,7 @@ BytecodeParser::simulateOp(JSOp op, uint32_t offset, OffsetAndDefIndex* offsetSt
       case JSOP_ISNOITER:
       case JSOP_MOREITER:
       case JSOP_OPTIMIZE_SPREADCALL:
+      case JSOP_OPTIMIZE_DESTRUCTURING:
         // Keep the top value and push one more value.
         MOZ_ASSERT(nuses == 1);
         MOZ_ASSERT(ndefs == 2);
@@ -2111,6 +2112,7 @@ ExpressionDecompiler::decompilePC(jsbytecode* pc, uint8_t defIndex)
             return write("OBJ");
 
           case JSOP_OPTIMIZE_SPREADCALL:
+          case JSOP_OPTIMIZE_DESTRUCTURING:
             // For stack dump, defIndex == 0 is not used.
             MOZ_ASSERT(defIndex == 1);
             return write("OPTIMIZED");
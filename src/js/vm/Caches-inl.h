@@ -72,6 +72,7 @@ NewObjectCache::newObjectFromHit(JSContext* cx, EntryIndex entryIndex, gc::Initi
     }
 
     copyCachedToObject(obj, templateObj, entry->kind);
+    hits++;
 
     if (group->clasp()->shouldDelayMetadataBuilder()) {
         cx->realm()->setObjectPendingMetadata(cx, obj);
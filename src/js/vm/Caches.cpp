@@ -6,10 +6,20 @@
 
 #include "vm/Caches-inl.h"
 
+#include "mozilla/HashFunctions.h"
+#include "mozilla/Move.h"
 #include "mozilla/PodOperations.h"
 
+#include <string.h>
+
+#include "jsapi.h"
+
+#include "vm/StringType.h"
+
 using namespace js;
 
+using mozilla::AddToHash;
+using mozilla::HashString;
 using mozilla::PodZero;
 
 void
@@ -26,3 +36,130 @@ NewObjectCache::clearNurseryObjects(JSRuntime* rt)
         }
     }
 }
+
+template <typename Spec>
+const jsid*
+SpecIdCache::lookupOrAddSpecs(JSContext* cx, const Spec* specs)
+{
+    Map::AddPtr p = map_.lookupForAdd(specs);
+    if (p) {
+        return p->value().get();
+    }
+
+    size_t length = 0;
+    while (specs[length].name) {
+        length++;
+    }
+
+    // Allocate at least one id, so that empty arrays are cached as well.
+    IdArray ids(cx->pod_malloc<jsid>(length ? length : 1));
+    if (!ids) {
+        return nullptr;
+    }
+    for (size_t i = 0; i < length; i++) {
+        if (!JS::PropertySpecNameToPermanentId(cx, specs[i].name, &ids[i])) {
+            return nullptr;
+        }
+    }
+
+    // Atomizing may GC, but the GC doesn't touch this cache, so |p| is still
+    // valid.
+    const jsid* result = ids.get();
+    if (!map_.add(p, specs, std::move(ids))) {
+        ReportOutOfMemory(cx);
+        return nullptr;
+    }
+    return result;
+}
+
+const jsid*
+SpecIdCache::lookupOrAdd(JSContext* cx, const JSFunctionSpec* fs)
+{
+    return lookupOrAddSpecs(cx, fs);
+}
+
+const jsid*
+SpecIdCache::lookupOrAdd(JSContext* cx, const JSPropertySpec* ps)
+{
+    return lookupOrAddSpecs(cx, ps);
+}
+
+/* static */ HashNumber
+CompilationCacheHashPolicy::hash(const Lookup& l)
+{
+    JS::AutoCheckCannotGC nogc;
+    HashNumber hash = l.str->hasLatin1Chars()
+                      ? HashString(l.str->latin1Chars(nogc), l.str->length())
+                      : HashString(l.str->twoByteChars(nogc), l.str->length());
+    return AddToHash(hash, l.realm, uint8_t(l.kind), l.mutedErrors);
+}
+
+/* static */ bool
+CompilationCacheHashPolicy::match(const CompilationCacheEntry& entry, const Lookup& l)
+{
+    if (entry.realm != l.realm || entry.kind != l.kind || entry.mutedErrors != l.mutedErrors) {
+        return false;
+    }
+
+    // Filenames are usually the same pointer, into the caller's ScriptSource,
+    // which outlives the entry as the cache is emptied on every major GC.
+    if (entry.filename != l.filename &&
+        (!entry.filename || !l.filename || strcmp(entry.filename, l.filename) != 0))
+    {
+        return false;
+    }
+
+    return EqualStrings(entry.str, l.str);
+}
+
+JSScript*
+CompilationCache::takeScript(const CompilationCacheLookup& l)
+{
+    MOZ_ASSERT(l.kind == CompilationCacheKind::IndirectEval);
+
+    Set::Ptr p = set_.lookup(l);
+    if (!p) {
+        misses_++;
+        return nullptr;
+    }
+
+    hits_++;
+    JSScript* script = p->script;
+    set_.remove(p);
+    return script;
+}
+
+JSFunction*
+CompilationCache::lookupFunction(const CompilationCacheLookup& l)
+{
+    MOZ_ASSERT(l.kind == CompilationCacheKind::Function);
+
+    Set::Ptr p = set_.lookup(l);
+    if (!p) {
+        misses_++;
+        return nullptr;
+    }
+
+    hits_++;
+    return p->function;
+}
+
+void
+CompilationCache::add(const CompilationCacheLookup& l, JSScript* script, JSFunction* function)
+{
+    MOZ_ASSERT_IF(l.kind == CompilationCacheKind::IndirectEval, script && !function);
+    MOZ_ASSERT_IF(l.kind == CompilationCacheKind::Function, function && !script);
+
+    if (set_.has(l)) {
+        return;
+    }
+    if (set_.count() >= MaxEntries) {
+        set_.clear();
+    }
+
+    CompilationCacheEntry entry = { l.str, l.realm, l.filename, l.kind, l.mutedErrors,
+                                    script, function };
+
+    // The cache is only an optimization, so ignore OOM.
+    (void) set_.putNew(l, entry);
+}
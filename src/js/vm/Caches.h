@@ -9,6 +9,10 @@
 
 #include <new>
 
+#include "mozilla/HashFunctions.h"
+#include "mozilla/MathAlgorithms.h"
+#include "mozilla/PodOperations.h"
+
 #include "jsmath.h"
 
 #include "frontend/SourceNotes.h"
@@ -96,6 +100,107 @@ struct EvalCacheHashPolicy
 
 typedef GCHashSet<EvalCacheEntry, EvalCacheHashPolicy, SystemAllocPolicy> EvalCache;
 
+/*
+ * Cache of the code compiled from strings by indirect eval and the Function
+ * constructor, so that a realm compiles each source text once, wherever it
+ * is passed from. Unlike EvalCache, entries aren't tied to a call site.
+ *
+ * Indirect eval scripts without inner objects are reused directly, as
+ * EvalCache's scripts are, and are taken out of the cache while they run.
+ * Functions are kept as templates which are cloned with
+ * CloneFunctionAndScript, so each Function() call still returns a new
+ * function.
+ *
+ * Like EvalCache, entries aren't traced: the cache is emptied on major GCs,
+ * and entries with nursery strings are removed before minor GCs.
+ */
+enum class CompilationCacheKind : uint8_t
+{
+    IndirectEval,
+    Function
+};
+
+struct CompilationCacheEntry
+{
+    JSLinearString* str;
+    JS::Realm* realm;
+    const char* filename;
+    CompilationCacheKind kind;
+    bool mutedErrors;
+
+    // The script for IndirectEval entries, or the template function for
+    // Function entries.
+    JSScript* script;
+    JSFunction* function;
+
+    bool needsSweep() {
+        return !str->isTenured();
+    }
+};
+
+struct CompilationCacheLookup
+{
+    CompilationCacheLookup(JSLinearString* str, JS::Realm* realm, const char* filename,
+                           CompilationCacheKind kind, bool mutedErrors)
+      : str(str), realm(realm), filename(filename), kind(kind), mutedErrors(mutedErrors)
+    {}
+
+    JSLinearString* str;
+    JS::Realm* realm;
+    const char* filename;
+    CompilationCacheKind kind;
+    bool mutedErrors;
+};
+
+struct CompilationCacheHashPolicy
+{
+    typedef CompilationCacheLookup Lookup;
+
+    static HashNumber hash(const Lookup& l);
+    static bool match(const CompilationCacheEntry& entry, const Lookup& l);
+};
+
+class CompilationCache
+{
+    using Set = GCHashSet<CompilationCacheEntry, CompilationCacheHashPolicy, SystemAllocPolicy>;
+
+    // Templating code can generate any number of distinct strings, so the
+    // cache is emptied when it reaches this size rather than grow without
+    // bound.
+    static const size_t MaxEntries = 256;
+
+    Set set_;
+    uint64_t hits_;
+    uint64_t misses_;
+
+  public:
+    CompilationCache()
+      : hits_(0),
+        misses_(0)
+    {}
+
+    // Remove and return the cached script for an indirect eval, or return
+    // nullptr. The script is put back with add() once it has run.
+    JSScript* takeScript(const CompilationCacheLookup& l);
+
+    // Return the template function for a Function() call, or nullptr.
+    JSFunction* lookupFunction(const CompilationCacheLookup& l);
+
+    // Add an entry unless one for |l| exists. Failure to add is ignored.
+    void add(const CompilationCacheLookup& l, JSScript* script, JSFunction* function);
+
+    void sweep() {
+        set_.sweep();
+    }
+    void clear() {
+        set_.clear();
+    }
+
+    uint64_t hitCount() const { return hits_; }
+    uint64_t missCount() const { return misses_; }
+    uint32_t count() const { return set_.count(); }
+};
+
 /*
  * Cache for speeding up repetitive creation of objects in the VM.
  * When an object is created which matches the criteria in the 'key' section
@@ -144,21 +249,61 @@ class NewObjectCache
         char templateObject[MAX_OBJ_SIZE];
     };
 
-    using EntryArray = Entry[41]; // TODO: reconsider size;
+  public:
+    /*
+     * The cache is two-way set associative, so two hot keys which map to the
+     * same set don't keep evicting each other. Each set remembers which of
+     * its ways was used last, and a miss replaces the other one.
+     */
+    static const size_t Ways = 2;
+    static const size_t MaxSets = 64;
+    static const size_t DefaultSets = 32;
+
+  private:
+    using EntryArray = Entry[MaxSets * Ways];
     EntryArray entries;
 
+    // The way of each set which was hit or filled last.
+    uint8_t mostRecentWay[MaxSets];
+
+    // The number of sets in use, a power of two no larger than MaxSets.
+    size_t numSets;
+
+    // Counts of the objects created from cache hits, and of the entries
+    // filled after misses.
+    uint64_t hits;
+    uint64_t misses;
+
   public:
 
     using EntryIndex = int;
 
     NewObjectCache()
-      : entries{} // zeroes out the array
+      : entries{}, // zeroes out the array
+        mostRecentWay{},
+        numSets(DefaultSets),
+        hits(0),
+        misses(0)
     {}
 
     void purge() {
         new (&entries) EntryArray{}; // zeroes out the array
     }
 
+    /*
+     * Change the number of sets, which is rounded down to a power of two and
+     * clamped to [1, MaxSets]. This empties the cache.
+     */
+    void setNumSets(size_t sets) {
+        sets = mozilla::Clamp(sets, size_t(1), MaxSets);
+        numSets = size_t(1) << mozilla::FloorLog2(sets);
+        purge();
+    }
+    size_t sets() const { return numSets; }
+
+    uint64_t hitCount() const { return hits; }
+    uint64_t missCount() const { return misses; }
+
     /* Remove any cached items keyed on moved objects. */
     void clearNurseryObjects(JSRuntime* rt);
 
@@ -199,24 +344,40 @@ class NewObjectCache
     void invalidateEntriesForShape(JSContext* cx, HandleShape shape, HandleObject proto);
 
   private:
-    EntryIndex makeIndex(const Class* clasp, gc::Cell* key, gc::AllocKind kind) {
-        uintptr_t hash = (uintptr_t(clasp) ^ uintptr_t(key)) + size_t(kind);
-        return hash % mozilla::ArrayLength(entries);
+    size_t makeSet(const Class* clasp, gc::Cell* key, gc::AllocKind kind) {
+        HashNumber hash = mozilla::HashGeneric(clasp, key, size_t(kind));
+        return hash & (numSets - 1);
     }
 
+    /*
+     * On a hit, set *pentry to the matching entry. On a miss, set it to the
+     * entry a subsequent fill should replace.
+     */
     bool lookup(const Class* clasp, gc::Cell* key, gc::AllocKind kind, EntryIndex* pentry) {
-        *pentry = makeIndex(clasp, key, kind);
-        Entry* entry = &entries[*pentry];
+        size_t set = makeSet(clasp, key, kind);
+        Entry* ways = &entries[set * Ways];
 
         /* N.B. Lookups with the same clasp/key but different kinds map to different entries. */
-        return entry->clasp == clasp && entry->key == key;
+        for (size_t way = 0; way < Ways; way++) {
+            if (ways[way].clasp == clasp && ways[way].key == key && ways[way].kind == kind) {
+                mostRecentWay[set] = way;
+                *pentry = set * Ways + way;
+                return true;
+            }
+        }
+
+        static_assert(Ways == 2, "the replaced way must not be the most recently used one");
+        *pentry = set * Ways + (1 - mostRecentWay[set]);
+        return false;
     }
 
     void fill(EntryIndex entry_, const Class* clasp, gc::Cell* key, gc::AllocKind kind,
               NativeObject* obj) {
         MOZ_ASSERT(unsigned(entry_) < mozilla::ArrayLength(entries));
-        MOZ_ASSERT(entry_ == makeIndex(clasp, key, kind));
+        MOZ_ASSERT(size_t(entry_) / Ways == makeSet(clasp, key, kind));
         Entry* entry = &entries[entry_];
+        mostRecentWay[entry_ / Ways] = entry_ % Ways;
+        misses++;
 
         MOZ_ASSERT(!obj->hasDynamicSlots());
         MOZ_ASSERT(obj->hasEmptyElements() || obj->is<ArrayObject>());
@@ -238,6 +399,114 @@ class NewObjectCache
     }
 };
 
+/*
+ * Cache for the data property lookups performed by megamorphic property
+ * access stubs. Entries map a receiver's shape, group and property id to the
+ * slot holding the property, either on the receiver itself or on the object
+ * numHops steps along its prototype chain.
+ *
+ * The receiver's shape and group determine its own properties and its
+ * prototype, so entries for own properties remain valid until the shape is
+ * finalized. Entries for properties found on a prototype also record the
+ * holder's shape: shadowing a property or mutating the prototype of any
+ * object on the chain gives the holder a new shape (see
+ * ReshapeForShadowedProp and ReshapeForProtoMutation), so lookups check it on
+ * every hit. Missing properties are not cached, as defining the property on
+ * a prototype does not reshape the objects below it.
+ *
+ * Shapes and groups may be finalized or moved by the GC, so the entire cache
+ * is purged on a major GC and on compaction.
+ */
+class MegamorphicCache
+{
+  public:
+    struct Entry
+    {
+        Shape* shape;
+        ObjectGroup* group;
+        jsid id;
+
+        // Shape of the object holding the property, if numHops is non-zero.
+        Shape* holderShape;
+
+        uint32_t slot;
+        uint16_t numHops;
+
+        // Whether the property is a writable property of the receiver, so
+        // that the entry can also be used for stores.
+        bool writable;
+    };
+
+    static const size_t NumEntries = 1024;
+
+  private:
+    Entry entries_[NumEntries];
+
+    static size_t index(Shape* shape, ObjectGroup* group, jsid id) {
+        HashNumber hash = mozilla::HashGeneric(shape, group, JSID_BITS(id));
+        return hash % NumEntries;
+    }
+
+  public:
+    MegamorphicCache() {
+        purge();
+    }
+
+    void purge() {
+        mozilla::PodArrayZero(entries_);
+    }
+
+    /*
+     * Get the entry for the given lookup, return whether it holds a result
+     * for that lookup.
+     */
+    bool lookup(Shape* shape, ObjectGroup* group, jsid id, Entry** pentry) {
+        Entry* entry = &entries_[index(shape, group, id)];
+        *pentry = entry;
+        return entry->shape == shape && entry->group == group &&
+               JSID_BITS(entry->id) == JSID_BITS(id);
+    }
+
+    /* Fill an entry after a cache miss. */
+    void fill(Entry* entry, Shape* shape, ObjectGroup* group, jsid id, Shape* holderShape,
+              uint32_t slot, uint16_t numHops, bool writable)
+    {
+        MOZ_ASSERT(entry == &entries_[index(shape, group, id)]);
+        MOZ_ASSERT_IF(numHops, !writable);
+        entry->shape = shape;
+        entry->group = group;
+        entry->id = id;
+        entry->holderShape = holderShape;
+        entry->slot = slot;
+        entry->numHops = numHops;
+        entry->writable = writable;
+    }
+};
+
+/*
+ * The ids of the properties named by the JSFunctionSpec and JSPropertySpec
+ * arrays of the ClassSpecs, keyed by the address of the static array. Every
+ * new global defines the same builtins, so after the first realm their names
+ * don't need to be atomized again. The atoms are pinned and the symbols are
+ * well-known, so the ids are never traced and the cache is never purged.
+ */
+class SpecIdCache
+{
+    using IdArray = UniquePtr<jsid[], JS::FreePolicy>;
+    using Map = HashMap<const void*, IdArray, PointerHasher<const void*>, SystemAllocPolicy>;
+
+    Map map_;
+
+    template <typename Spec>
+    const jsid* lookupOrAddSpecs(JSContext* cx, const Spec* specs);
+
+  public:
+    // Return an array with the id of each entry of |fs| or |ps|, or nullptr
+    // after reporting an error.
+    const jsid* lookupOrAdd(JSContext* cx, const JSFunctionSpec* fs);
+    const jsid* lookupOrAdd(JSContext* cx, const JSPropertySpec* ps);
+};
+
 class RuntimeCaches
 {
   public:
@@ -246,15 +515,21 @@ class RuntimeCaches
     js::NewObjectCache newObjectCache;
     js::UncompressedSourceCache uncompressedSourceCache;
     js::EvalCache evalCache;
+    js::CompilationCache compilationCache;
+    js::MegamorphicCache megamorphicCache;
+    js::SpecIdCache specIdCache;
 
     void purgeForMinorGC(JSRuntime* rt) {
         newObjectCache.clearNurseryObjects(rt);
         evalCache.sweep();
+        compilationCache.sweep();
     }
 
     void purgeForCompaction() {
         newObjectCache.purge();
         evalCache.clear();
+        compilationCache.clear();
+        megamorphicCache.purge();
     }
 
     void purge() {
@@ -10,6 +10,7 @@
 #include "mozilla/Sprintf.h"
 
 #include <algorithm>
+#include <string.h>
 #include <type_traits>
 
 #include "util/Unicode.h" // unicode::REPLACEMENT_CHARACTER
@@ -34,14 +35,57 @@ JS::LossyTwoByteCharsToNewLatin1CharsZ(JSContext* cx,
     return Latin1CharsZ(latin1, len);
 }
 
+// Return the number of code units at the start of |chars| which are ASCII.
+// This tests a word at a time, with a mask of the bits which are set in every
+// non-ASCII code unit, so long runs of ASCII are skipped several characters per
+// load on every platform without needing vector instructions.
 template <typename CharT>
 static size_t
-GetDeflatedUTF8StringLength(const CharT* chars, size_t nchars)
+AsciiPrefixLength(const CharT* chars, size_t length)
+{
+    static_assert(sizeof(CharT) == 1 || sizeof(CharT) == 2, "bad CharT");
+    static const uintptr_t NonAsciiMask = sizeof(CharT) == 1
+                                          ? uintptr_t(-1) / 0xFF * 0x80
+                                          : uintptr_t(-1) / 0xFFFF * 0xFF80;
+    static const size_t UnitsPerWord = sizeof(uintptr_t) / sizeof(CharT);
+
+    size_t i = 0;
+    for (; i + UnitsPerWord <= length; i += UnitsPerWord) {
+        // memcpy keeps this free of alignment and aliasing problems, and
+        // compiles to a single load.
+        uintptr_t word;
+        memcpy(&word, chars + i, sizeof(word));
+        if (word & NonAsciiMask) {
+            break;
+        }
+    }
+    while (i < length && chars[i] < 0x80) {
+        i++;
+    }
+    return i;
+}
+
+static size_t
+GetDeflatedUTF8StringLength(const Latin1Char* chars, size_t nchars)
+{
+    // Latin1 characters above 0x7F take two bytes and the rest take one. This
+    // has no branches, so the compiler can vectorize it.
+    size_t nbytes = nchars;
+    for (size_t i = 0; i < nchars; i++) {
+        nbytes += chars[i] >> 7;
+    }
+    return nbytes;
+}
+
+static size_t
+GetDeflatedUTF8StringLength(const char16_t* chars, size_t nchars)
 {
     size_t nbytes = nchars;
-    for (const CharT* end = chars + nchars; chars < end; chars++) {
+    for (const char16_t* end = chars + nchars; chars < end; chars++) {
         char16_t c = *chars;
         if (c < 0x80) {
+            // Skip the rest of a run of ASCII, which takes a byte per char.
+            chars += AsciiPrefixLength(chars + 1, end - chars - 1);
             continue;
         }
         uint32_t v;
@@ -81,81 +125,110 @@ JS::GetDeflatedUTF8StringLength(JSFlatString* s)
            : ::GetDeflatedUTF8StringLength(s->twoByteChars(nogc), s->length());
 }
 
+// Encode |src| as UTF8 into the |capacity| bytes at |dst|, stopping before the
+// first character which doesn't fit. Returns the number of code units of |src|
+// which were encoded, and sets |*dstlenp| to the number of bytes written and
+// |*numcharsp| to the number of code points written.
 template <typename CharT>
-static void
-DeflateStringToUTF8Buffer(const CharT* src, size_t srclen, mozilla::RangedPtr<char> dst,
-                          size_t* dstlenp = nullptr, size_t* numcharsp = nullptr)
+static size_t
+DeflateStringToUTF8Buffer(const CharT* src, size_t srclen, char* dst, size_t capacity,
+                          size_t* dstlenp, size_t* numcharsp)
 {
-    size_t capacity = 0;
-    if (dstlenp) {
-        capacity = *dstlenp;
-        *dstlenp = 0;
-    }
-    if (numcharsp) {
-        *numcharsp = 0;
-    }
+    size_t i = 0;
+    size_t written = 0;
+    size_t numchars = 0;
+    while (i < srclen) {
+        // Copy runs of ASCII without encoding them.
+        size_t run = AsciiPrefixLength(src + i, std::min(srclen - i, capacity - written));
+        if (run) {
+            for (size_t k = 0; k < run; k++) {
+                dst[written + k] = char(src[i + k]);
+            }
+            i += run;
+            written += run;
+            numchars += run;
+            continue;
+        }
+        if (written == capacity) {
+            break;
+        }
 
-    while (srclen) {
         uint32_t v;
-        char16_t c = *src++;
-        srclen--;
+        size_t units = 1;
+        char16_t c = src[i];
         if (c >= 0xDC00 && c <= 0xDFFF) {
             v = unicode::REPLACEMENT_CHARACTER;
         } else if (c < 0xD800 || c > 0xDBFF) {
             v = c;
+        } else if (i + 1 == srclen) {
+            v = unicode::REPLACEMENT_CHARACTER;
         } else {
-            if (srclen < 1) {
+            char16_t c2 = src[i + 1];
+            if (c2 < 0xDC00 || c2 > 0xDFFF) {
                 v = unicode::REPLACEMENT_CHARACTER;
             } else {
-                char16_t c2 = *src;
-                if (c2 < 0xDC00 || c2 > 0xDFFF) {
-                    v = unicode::REPLACEMENT_CHARACTER;
-                } else {
-                    src++;
-                    srclen--;
-                    v = ((c - 0xD800) << 10) + (c2 - 0xDC00) + 0x10000;
-                }
-            }
-        }
-
-        size_t utf8Len;
-        if (v < 0x0080) {
-            /* no encoding necessary - performance hack */
-            if (dstlenp && *dstlenp + 1 > capacity) {
-                return;
-            }
-            *dst++ = char(v);
-            utf8Len = 1;
-        } else {
-            uint8_t utf8buf[4];
-            utf8Len = OneUcs4ToUtf8Char(utf8buf, v);
-            if (dstlenp && *dstlenp + utf8Len > capacity) {
-                return;
-            }
-            for (size_t i = 0; i < utf8Len; i++) {
-                *dst++ = char(utf8buf[i]);
+                v = ((c - 0xD800) << 10) + (c2 - 0xDC00) + 0x10000;
+                units = 2;
             }
         }
 
-        if (dstlenp) {
-            *dstlenp += utf8Len;
+        MOZ_ASSERT(v >= 0x80);
+        uint8_t utf8buf[4];
+        size_t utf8Len = OneUcs4ToUtf8Char(utf8buf, v);
+        if (utf8Len > capacity - written) {
+            break;
         }
-        if (numcharsp) {
-            (*numcharsp)++;
+        for (size_t k = 0; k < utf8Len; k++) {
+            dst[written + k] = char(utf8buf[k]);
         }
+        i += units;
+        written += utf8Len;
+        numchars++;
     }
+
+    *dstlenp = written;
+    *numcharsp = numchars;
+    return i;
 }
 
 JS_PUBLIC_API(void)
 JS::DeflateStringToUTF8Buffer(JSFlatString* src, mozilla::RangedPtr<char> dst,
                               size_t* dstlenp, size_t* numcharsp)
 {
+    // Without |dstlenp| the caller has promised there is room for all of it.
+    size_t capacity = dstlenp ? *dstlenp : SIZE_MAX;
+    size_t written, numchars;
+
+    JS::AutoCheckCannotGC nogc;
+    if (src->hasLatin1Chars()) {
+        ::DeflateStringToUTF8Buffer(src->latin1Chars(nogc), src->length(), dst.get(), capacity,
+                                    &written, &numchars);
+    } else {
+        ::DeflateStringToUTF8Buffer(src->twoByteChars(nogc), src->length(), dst.get(), capacity,
+                                    &written, &numchars);
+    }
+
+    if (dstlenp) {
+        *dstlenp = written;
+    }
+    if (numcharsp) {
+        *numcharsp = numchars;
+    }
+}
+
+JS_PUBLIC_API(size_t)
+JS::DeflateStringToUTF8BufferPartial(JSFlatString* src, size_t start, char* dst, size_t dstlen,
+                                     size_t* written)
+{
+    MOZ_ASSERT(start <= src->length());
+
+    size_t numchars;
     JS::AutoCheckCannotGC nogc;
     return src->hasLatin1Chars()
-           ? ::DeflateStringToUTF8Buffer(src->latin1Chars(nogc), src->length(), dst,
-                                         dstlenp, numcharsp)
-           : ::DeflateStringToUTF8Buffer(src->twoByteChars(nogc), src->length(), dst,
-                                         dstlenp, numcharsp);
+           ? ::DeflateStringToUTF8Buffer(src->latin1Chars(nogc) + start, src->length() - start,
+                                         dst, dstlen, written, &numchars)
+           : ::DeflateStringToUTF8Buffer(src->twoByteChars(nogc) + start, src->length() - start,
+                                         dst, dstlen, written, &numchars);
 }
 
 template <typename CharT>
@@ -178,7 +251,10 @@ JS::CharsToNewUTF8CharsZ(JSContext* maybeCx, const mozilla::Range<CharT> chars)
     }
 
     /* Encode to UTF8. */
-    ::DeflateStringToUTF8Buffer(str, chars.length(), mozilla::RangedPtr<char>(utf8, len));
+    size_t written, numchars;
+    MOZ_ALWAYS_TRUE(::DeflateStringToUTF8Buffer(str, chars.length(), utf8, len,
+                                                &written, &numchars) == chars.length());
+    MOZ_ASSERT(written == len);
     utf8[len] = '\0';
 
     return UTF8CharsZ(utf8, len);
@@ -273,13 +349,15 @@ enum class OnUTF8Error {
 // Scan UTF8 input and (internally, at least) convert it to a series of UTF-16
 // code units. But you can also do odd things like pass an empty lambda for
 // `dst`, in which case the output is discarded entirely--the only effect of
-// calling the template that way is error-checking.
+// calling the template that way is error-checking. Scanning starts at |start|,
+// so callers which have already dealt with a prefix of ASCII can skip it while
+// still reporting errors at their offset in the whole of |src|.
 template <OnUTF8Error ErrorAction, typename OutputFn>
 static bool
-InflateUTF8ToUTF16(JSContext* cx, const UTF8Chars src, OutputFn dst)
+InflateUTF8ToUTF16(JSContext* cx, const UTF8Chars src, OutputFn dst, size_t start = 0)
 {
     size_t srclen = src.length();
-    for (uint32_t i = 0; i < srclen; i++) {
+    for (uint32_t i = start; i < srclen; i++) {
         uint32_t v = uint32_t(src[i]);
         if (!(v & 0x80)) {
             // ASCII code unit.  Simple copy.
@@ -388,14 +466,19 @@ InflateUTF8StringHelper(JSContext* cx, const UTF8Chars src, size_t* outlen)
 
     *outlen = 0;
 
-    size_t len = 0;
+    // The ASCII prefix of |src| inflates to the same number of chars, so only
+    // the rest needs to be decoded, both when counting and when copying.
+    size_t srclen = src.length();
+    size_t asciiLen = AsciiPrefixLength(src.begin().get(), srclen);
+
+    size_t len = asciiLen;
     bool allASCII = true;
     auto count = [&len, &allASCII](char16_t c) -> LoopDisposition {
         len++;
         allASCII &= (c < 0x80);
         return LoopDisposition::Continue;
     };
-    if (!InflateUTF8ToUTF16<ErrorAction>(cx, src, count)) {
+    if (asciiLen < srclen && !InflateUTF8ToUTF16<ErrorAction>(cx, src, count, asciiLen)) {
         return CharsT();
     }
     *outlen = len;
@@ -407,21 +490,23 @@ InflateUTF8StringHelper(JSContext* cx, const UTF8Chars src, size_t* outlen)
     }
 
     if (allASCII) {
-        size_t srclen = src.length();
         MOZ_ASSERT(*outlen == srclen);
-        for (uint32_t i = 0; i < srclen; i++) {
+        for (size_t i = 0; i < srclen; i++) {
             dst[i] = CharT(src[i]);
         }
     } else {
+        for (size_t i = 0; i < asciiLen; i++) {
+            dst[i] = CharT(src[i]);
+        }
         constexpr OnUTF8Error errorMode = std::is_same<CharT, Latin1Char>::value
             ? OnUTF8Error::InsertQuestionMark
             : OnUTF8Error::InsertReplacementCharacter;
-        size_t j = 0;
+        size_t j = asciiLen;
         auto push = [dst, &j](char16_t c) -> LoopDisposition {
             dst[j++] = CharT(c);
             return LoopDisposition::Continue;
         };
-        MOZ_ALWAYS_TRUE((InflateUTF8ToUTF16<errorMode>(cx, src, push)));
+        MOZ_ALWAYS_TRUE((InflateUTF8ToUTF16<errorMode>(cx, src, push, asciiLen)));
         MOZ_ASSERT(j == len);
     }
     dst[*outlen] = 0;    // NUL char
@@ -429,6 +514,28 @@ InflateUTF8StringHelper(JSContext* cx, const UTF8Chars src, size_t* outlen)
     return CharsT(dst, *outlen);
 }
 
+JS_PUBLIC_API(size_t)
+JS::LossyInflateUTF8ToBuffer(const UTF8Chars utf8, char16_t* dst)
+{
+    size_t asciiLen = AsciiPrefixLength(utf8.begin().get(), utf8.length());
+    for (size_t i = 0; i < asciiLen; i++) {
+        dst[i] = char16_t(utf8[i]);
+    }
+
+    size_t j = asciiLen;
+    auto push = [dst, &j](char16_t c) -> LoopDisposition {
+        dst[j++] = c;
+        return LoopDisposition::Continue;
+    };
+
+    // Nothing is reported when replacing malformed input, so no context is
+    // needed.
+    MOZ_ALWAYS_TRUE((InflateUTF8ToUTF16<OnUTF8Error::InsertReplacementCharacter>(nullptr, utf8,
+                                                                                 push, asciiLen)));
+    MOZ_ASSERT(j <= utf8.length());
+    return j;
+}
+
 TwoByteCharsZ
 JS::UTF8CharsToNewTwoByteCharsZ(JSContext* cx, const UTF8Chars utf8, size_t* outlen)
 {
@@ -458,6 +565,11 @@ JS::LossyUTF8CharsToNewTwoByteCharsZ(JSContext* cx, const JS::ConstUTF8CharsZ& u
 JS::SmallestEncoding
 JS::FindSmallestEncoding(UTF8Chars utf8)
 {
+    size_t asciiLen = AsciiPrefixLength(utf8.begin().get(), utf8.length());
+    if (asciiLen == utf8.length()) {
+        return JS::SmallestEncoding::ASCII;
+    }
+
     JS::SmallestEncoding encoding = JS::SmallestEncoding::ASCII;
     auto onChar = [&encoding](char16_t c) -> LoopDisposition {
         if (c >= 0x80) {
@@ -471,7 +583,7 @@ JS::FindSmallestEncoding(UTF8Chars utf8)
         return LoopDisposition::Continue;
     };
     MOZ_ALWAYS_TRUE((InflateUTF8ToUTF16<OnUTF8Error::InsertReplacementCharacter>(
-                         /* cx = */ nullptr, utf8, onChar)));
+                         /* cx = */ nullptr, utf8, onChar, asciiLen)));
     return encoding;
 }
 
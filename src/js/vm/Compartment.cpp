@@ -250,14 +250,66 @@ Compartment::getNonWrapperObjectForCurrentCompartment(JSContext* cx, MutableHand
     return true;
 }
 
+bool
+Compartment::checkWrapperCacheGCNumber()
+{
+    uint64_t gcNumber = runtime_->gc.gcNumber();
+    if (wrapperCacheGCNumber_ == gcNumber) {
+        return true;
+    }
+
+    // A GC may have moved or finalized the objects in the cache.
+    purgeWrapperCache();
+    wrapperCacheGCNumber_ = gcNumber;
+    return false;
+}
+
+JSObject*
+Compartment::lookupWrapperCache(JSObject* key)
+{
+    if (!checkWrapperCacheGCNumber()) {
+        return nullptr;
+    }
+
+    WrapperCacheEntry& entry = wrapperCache_[wrapperCacheIndex(key)];
+    if (entry.key != key) {
+        return nullptr;
+    }
+
+    // Nuking or remapping the wrapper may have changed what it wraps.
+    JSObject* wrapper = entry.wrapper;
+    if (!wrapper->is<CrossCompartmentWrapperObject>() || Wrapper::wrappedObject(wrapper) != key) {
+        entry = WrapperCacheEntry();
+        return nullptr;
+    }
+
+    return wrapper;
+}
+
+void
+Compartment::addToWrapperCache(JSObject* key, JSObject* wrapper)
+{
+    MOZ_ASSERT(wrapper->is<CrossCompartmentWrapperObject>());
+    MOZ_ASSERT(Wrapper::wrappedObject(wrapper) == key);
+
+    checkWrapperCacheGCNumber();
+    wrapperCache_[wrapperCacheIndex(key)] = WrapperCacheEntry { key, wrapper };
+}
+
 bool
 Compartment::getOrCreateWrapper(JSContext* cx, HandleObject existing, MutableHandleObject obj)
 {
     // If we already have a wrapper for this value, use it.
+    if (JSObject* wrapper = lookupWrapperCache(obj)) {
+        obj.set(wrapper);
+        return true;
+    }
+
     RootedValue key(cx, ObjectValue(*obj));
     if (WrapperMap::Ptr p = crossCompartmentWrappers.lookup(CrossCompartmentKey(key))) {
         obj.set(&p->value().get().toObject());
         MOZ_ASSERT(obj->is<CrossCompartmentWrapperObject>());
+        addToWrapperCache(&key.toObject(), obj);
         return true;
     }
 
@@ -288,6 +340,10 @@ Compartment::getOrCreateWrapper(JSContext* cx, HandleObject existing, MutableHan
         return false;
     }
 
+    if (wrapper->is<CrossCompartmentWrapperObject>()) {
+        addToWrapperCache(&key.toObject(), wrapper);
+    }
+
     obj.set(wrapper);
     return true;
 }
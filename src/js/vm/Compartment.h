@@ -10,6 +10,7 @@
 #include "mozilla/LinkedList.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/MemoryReporting.h"
+#include "mozilla/PodOperations.h"
 #include "mozilla/Tuple.h"
 #include "mozilla/Variant.h"
 
@@ -384,6 +385,19 @@ class JS::Compartment
 
     js::WrapperMap crossCompartmentWrappers;
 
+    // A small direct-mapped cache in front of crossCompartmentWrappers, from
+    // recently wrapped objects to their wrappers. Entries are neither traced
+    // nor swept: the cache is purged when it is first used after a GC, and
+    // when wrappers are removed from the map.
+    struct WrapperCacheEntry
+    {
+        JSObject* key;
+        JSObject* wrapper;
+    };
+    static const size_t WrapperCacheSize = 32;
+    WrapperCacheEntry wrapperCache_[WrapperCacheSize] = {};
+    uint64_t wrapperCacheGCNumber_ = 0;
+
     using RealmVector = js::Vector<JS::Realm*, 1, js::SystemAllocPolicy>;
     RealmVector realms_;
 
@@ -452,6 +466,16 @@ class JS::Compartment
     bool getNonWrapperObjectForCurrentCompartment(JSContext* cx, js::MutableHandleObject obj);
     bool getOrCreateWrapper(JSContext* cx, js::HandleObject existing, js::MutableHandleObject obj);
 
+    static size_t wrapperCacheIndex(JSObject* key) {
+        return (uintptr_t(key) >> js::gc::CellAlignShift) % WrapperCacheSize;
+    }
+    bool checkWrapperCacheGCNumber();
+    JSObject* lookupWrapperCache(JSObject* key);
+    void addToWrapperCache(JSObject* key, JSObject* wrapper);
+    void purgeWrapperCache() {
+        mozilla::PodArrayZero(wrapperCache_);
+    }
+
   public:
     explicit Compartment(JS::Zone* zone);
 
@@ -480,6 +504,7 @@ class JS::Compartment
     }
 
     void removeWrapper(js::WrapperMap::Ptr p) {
+        purgeWrapperCache();
         crossCompartmentWrappers.remove(p);
     }
 
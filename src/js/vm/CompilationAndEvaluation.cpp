@@ -10,6 +10,7 @@
 
 #include "mozilla/Maybe.h" // mozilla::None, mozilla::Some
 #include "mozilla/TextUtils.h" // mozilla::IsAscii
+#include "mozilla/Utf8.h" // mozilla::Utf8Unit
 
 #include <algorithm> // std::all_of
 
@@ -68,17 +69,22 @@ CompileLatin1(JSContext* cx, const ReadOnlyCompileOptions& options,
     return CompileSourceBuffer(cx, options, source, script);
 }
 
+// UTF-8 source is tokenized as it is and stored in the ScriptSource without
+// being inflated to UTF-16. Malformed UTF-8 is reported by the tokenizer.
 static bool
 CompileUtf8(JSContext* cx, const ReadOnlyCompileOptions& options,
             const char* bytes, size_t length, JS::MutableHandleScript script)
 {
-    char16_t* chars = UTF8CharsToNewTwoByteCharsZ(cx, UTF8Chars(bytes, length), &length).get();
-    if (!chars) {
-        return false;
-    }
+    ScopeKind scopeKind = options.nonSyntacticScope ? ScopeKind::NonSyntactic : ScopeKind::Global;
 
-    SourceBufferHolder source(chars, length, SourceBufferHolder::GiveOwnership);
-    return CompileSourceBuffer(cx, options, source, script);
+    MOZ_ASSERT(!cx->zone()->isAtomsZone());
+    AssertHeapIsIdle();
+    CHECK_THREAD(cx);
+
+    auto units = reinterpret_cast<const mozilla::Utf8Unit*>(bytes);
+    script.set(frontend::CompileGlobalScript(cx, cx->tempLifoAlloc(), scopeKind, options,
+                                             units, length));
+    return !!script;
 }
 
 bool
@@ -516,17 +522,26 @@ Evaluate(JSContext* cx, AutoObjectVector& envChain, const ReadOnlyCompileOptions
 }
 
 extern JS_PUBLIC_API(bool)
-JS::EvaluateUtf8(JSContext* cx, const ReadOnlyCompileOptions& options,
+JS::EvaluateUtf8(JSContext* cx, const ReadOnlyCompileOptions& optionsArg,
                  const char* bytes, size_t length, MutableHandle<Value> rval)
 {
-    char16_t* chars = UTF8CharsToNewTwoByteCharsZ(cx, UTF8Chars(bytes, length), &length).get();
-    if (!chars) {
+    CompileOptions options(cx, optionsArg);
+    MOZ_ASSERT(!cx->zone()->isAtomsZone());
+    AssertHeapIsIdle();
+    CHECK_THREAD(cx);
+
+    // As in CompileUtf8, the source isn't inflated.
+    options.setIsRunOnce(true);
+    auto units = reinterpret_cast<const mozilla::Utf8Unit*>(bytes);
+    RootedScript script(cx, frontend::CompileGlobalScript(cx, cx->tempLifoAlloc(),
+                                                          ScopeKind::Global, options,
+                                                          units, length));
+    if (!script) {
         return false;
     }
 
-    SourceBufferHolder srcBuf(chars, length, SourceBufferHolder::GiveOwnership);
     RootedObject globalLexical(cx, &cx->global()->lexicalEnvironment());
-    return ::Evaluate(cx, ScopeKind::Global, globalLexical, options, srcBuf, rval);
+    return Execute(cx, script, *globalLexical, options.noScriptRval ? nullptr : rval.address());
 }
 
 extern JS_PUBLIC_API(bool)
@@ -6,6 +6,7 @@
 
 #include "vm/Compression.h"
 
+#include "mozilla/Compression.h"
 #include "mozilla/DebugOnly.h"
 #include "mozilla/MemoryChecking.h"
 #include "mozilla/PodOperations.h"
@@ -29,9 +30,12 @@ zlib_free(void* cx, void* addr)
     js_free(addr);
 }
 
-Compressor::Compressor(const unsigned char* inp, size_t inplen)
-    : inp(inp),
+Compressor::Compressor(const unsigned char* inp, size_t inplen, SourceCompressionCodec codec)
+    : codec(codec),
+      inp(inp),
       inplen(inplen),
+      out(nullptr),
+      outlen(0),
       initialized(false),
       finished(false),
       currentChunkSize(0),
@@ -80,6 +84,10 @@ Compressor::init()
     if (inplen >= UINT32_MAX) {
         return false;
     }
+    if (codec == SourceCompressionCodec::LZ4) {
+        // LZ4 keeps no state between chunks.
+        return true;
+    }
     // zlib is slow and we'd rather be done compression sooner
     // even if it means decompression is slower which penalizes
     // Function.toString()
@@ -96,13 +104,49 @@ void
 Compressor::setOutput(unsigned char* out, size_t outlen)
 {
     MOZ_ASSERT(outlen > outbytes);
+    this->out = out;
+    this->outlen = outlen;
     zs.next_out = out + outbytes;
     zs.avail_out = outlen - outbytes;
 }
 
+Compressor::Status
+Compressor::compressMoreLZ4()
+{
+    MOZ_ASSERT(out);
+    MOZ_ASSERT(outlen > outbytes);
+
+    // Compress a whole chunk at a time. If the compressed chunk doesn't fit
+    // in the remaining output nothing is written, and the caller grows the
+    // output buffer and calls us again to redo the chunk.
+    size_t chunk = chunkOffsets.length();
+    size_t chunkStart = chunk * CHUNK_SIZE;
+    size_t chunkBytes = chunkSize(inplen, chunk);
+
+    size_t written = mozilla::Compression::LZ4::compressLimitedOutput(
+        reinterpret_cast<const char*>(inp + chunkStart), chunkBytes,
+        reinterpret_cast<char*>(out + outbytes), outlen - outbytes);
+    if (!written) {
+        return MOREOUTPUT;
+    }
+
+    outbytes += written;
+    if (!chunkOffsets.append(outbytes)) {
+        return OOM;
+    }
+
+    bool done = chunkStart + chunkBytes == inplen;
+    MOZ_ASSERT_IF(done, chunkOffsets.length() == (inplen - 1) / CHUNK_SIZE + 1);
+    return done ? DONE : CONTINUE;
+}
+
 Compressor::Status
 Compressor::compressMore()
 {
+    if (codec == SourceCompressionCodec::LZ4) {
+        return compressMoreLZ4();
+    }
+
     MOZ_ASSERT(zs.next_out);
     uInt left = inplen - (zs.next_in - inp);
     if (left <= MAX_INPUT_SIZE) {
@@ -171,6 +215,7 @@ Compressor::finish(char* dest, size_t destBytes)
 
     CompressedDataHeader* compressedHeader = reinterpret_cast<CompressedDataHeader*>(dest);
     compressedHeader->compressedBytes = outbytes;
+    compressedHeader->codec = uint32_t(codec);
 
     size_t outbytesAligned = AlignBytes(outbytes, sizeof(uint32_t));
 
@@ -234,6 +279,18 @@ js::DecompressStringChunk(const unsigned char* inp, size_t chunk,
     MOZ_ASSERT(compressedStart < compressedEnd);
     MOZ_ASSERT(compressedEnd <= compressedBytes);
 
+    if (SourceCompressionCodec(header->codec) == SourceCompressionCodec::LZ4) {
+        size_t decompressedBytes;
+        bool ok = mozilla::Compression::LZ4::decompress(
+            reinterpret_cast<const char*>(inp + compressedStart), compressedEnd - compressedStart,
+            reinterpret_cast<char*>(out), outlen, &decompressedBytes);
+        MOZ_RELEASE_ASSERT(ok);
+        MOZ_RELEASE_ASSERT(decompressedBytes == outlen);
+        return true;
+    }
+
+    MOZ_ASSERT(SourceCompressionCodec(header->codec) == SourceCompressionCodec::Zlib);
+
     bool lastChunk = compressedEnd == compressedBytes;
 
     // Mark the memory we pass to zlib as initialized for MSan.
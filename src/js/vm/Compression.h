@@ -9,6 +9,7 @@
 
 #include <zlib.h>
 
+#include "jsfriendapi.h"
 #include "jstypes.h"
 
 #include "js/AllocPolicy.h"
@@ -19,23 +20,34 @@ namespace js {
 struct CompressedDataHeader
 {
     uint32_t compressedBytes;
+
+    // The SourceCompressionCodec the data was compressed with. This is stored
+    // with the data so that it can be decompressed after being transcoded, and
+    // after the runtime's codec is changed.
+    uint32_t codec;
 };
 
 class Compressor
 {
   public:
     // After compressing CHUNK_SIZE bytes, we will do a full flush so we can
-    // start decompression at that point.
+    // start decompression at that point. LZ4 compresses each chunk as an
+    // independent block.
     static const size_t CHUNK_SIZE = 64 * 1024;
 
   private:
     // Number of bytes we should hand to zlib each compressMore() call.
     static const size_t MAX_INPUT_SIZE = 2 * 1024;
 
+    SourceCompressionCodec codec;
     z_stream zs;
     const unsigned char* inp;
     size_t inplen;
     size_t outbytes;
+
+    // The output buffer, used by the LZ4 codec.
+    unsigned char* out;
+    size_t outlen;
     bool initialized;
     bool finished;
 
@@ -55,7 +67,8 @@ class Compressor
         OOM
     };
 
-    Compressor(const unsigned char* inp, size_t inplen);
+    Compressor(const unsigned char* inp, size_t inplen,
+               SourceCompressionCodec codec = SourceCompressionCodec::Zlib);
     ~Compressor();
     bool init();
     void setOutput(unsigned char* out, size_t outlen);
@@ -70,6 +83,10 @@ class Compressor
     // Append the chunk offsets to |dest|.
     void finish(char* dest, size_t destBytes);
 
+  private:
+    Status compressMoreLZ4();
+
+  public:
     static void toChunkOffset(size_t uncompressedOffset, size_t* chunk, size_t* chunkOffset) {
         *chunk = uncompressedOffset / CHUNK_SIZE;
         *chunkOffset = uncompressedOffset % CHUNK_SIZE;
@@ -93,7 +110,8 @@ bool DecompressString(const unsigned char* inp, size_t inplen,
                       unsigned char* out, size_t outlen);
 
 /*
- * Decompress a single chunk of at most Compressor::CHUNK_SIZE bytes.
+ * Decompress a single chunk of at most Compressor::CHUNK_SIZE bytes, using the
+ * codec recorded in the data's CompressedDataHeader.
  * |chunk| is the chunk index. The caller must know the length of the output
  * (the uncompressed chunk) and allocate |out| to a string of that length.
  */
@@ -12,6 +12,7 @@
 #include "mozilla/Unused.h"
 
 #include <algorithm>
+#include <cmath>
 #include <cstdlib>
 #include <cstring>
 #include <time.h>
@@ -29,6 +30,7 @@
 #if ENABLE_INTL_API && !MOZ_SYSTEM_ICU
 #include "unicode/basictz.h"
 #include "unicode/locid.h"
+#include "unicode/tztrans.h"
 #endif /* ENABLE_INTL_API && !MOZ_SYSTEM_ICU */
 
 #if ENABLE_INTL_API && (!MOZ_SYSTEM_ICU || defined(ICU_TZ_HAS_RECREATE_DEFAULT))
@@ -183,6 +185,9 @@ js::DateTimeInfo::internalUpdateTimeZoneAdjustment(ResetTimeZoneMode mode)
     utcRange_.reset();
     localRange_.reset();
 
+    transitions_ = nullptr;
+    transitionsComputed_ = false;
+
     {
         // Tell the analysis the |pFree| function pointer called by uprv_free
         // cannot GC.
@@ -203,7 +208,12 @@ js::DateTimeInfo::DateTimeInfo()
     internalUpdateTimeZoneAdjustment(ResetTimeZoneMode::ResetEvenIfOffsetUnchaged);
 }
 
-js::DateTimeInfo::~DateTimeInfo() = default;
+js::DateTimeInfo::~DateTimeInfo()
+{
+#if ENABLE_INTL_API && !MOZ_SYSTEM_ICU
+    transitions_ = nullptr;
+#endif /* ENABLE_INTL_API && !MOZ_SYSTEM_ICU */
+}
 
 int64_t
 js::DateTimeInfo::toClampedSeconds(int64_t milliseconds)
@@ -427,12 +437,163 @@ js::DateTimeInfo::computeLocalOffsetMilliseconds(int64_t utcSeconds)
 int32_t
 js::DateTimeInfo::internalGetOffsetMilliseconds(int64_t milliseconds, TimeZoneOffset offset)
 {
+    if (!transitionsComputed_) {
+        computeTransitions();
+
+        int32_t offsetMilliseconds;
+        if (lookupTransitions(milliseconds, offset, &offsetMilliseconds)) {
+            return offsetMilliseconds;
+        }
+    }
+
     int64_t seconds = toClampedSeconds(milliseconds);
     return offset == TimeZoneOffset::UTC
            ? getOrComputeValue(localRange_, seconds, &DateTimeInfo::computeLocalOffsetMilliseconds)
            : getOrComputeValue(utcRange_, seconds, &DateTimeInfo::computeUTCOffsetMilliseconds);
 }
 
+bool
+js::DateTimeInfo::TimeZoneTransitions::append(int64_t utcSeconds, int32_t offsetMilliseconds)
+{
+    int64_t localSeconds;
+    if (transitions_.empty()) {
+        localSeconds = utcSeconds + offsetMilliseconds / int32_t(msPerSecond);
+    } else {
+        const Transition& last = transitions_.back();
+        MOZ_ASSERT(utcSeconds > last.utcSeconds);
+
+        // Transitions which only change the time zone name don't matter.
+        if (offsetMilliseconds == last.offsetMilliseconds) {
+            return true;
+        }
+
+        int32_t laterOffset = Max(offsetMilliseconds, last.offsetMilliseconds);
+        localSeconds = utcSeconds + laterOffset / int32_t(msPerSecond);
+        if (localSeconds <= last.localSeconds) {
+            return false;
+        }
+    }
+
+    return transitions_.append(Transition { utcSeconds, localSeconds, offsetMilliseconds });
+}
+
+bool
+js::DateTimeInfo::TimeZoneTransitions::lookup(int64_t seconds, TimeZoneOffset offset,
+                                              int32_t* offsetMilliseconds) const
+{
+    // Offsets are less than a day, so the table covers all local times in
+    // this range, too.
+    if (seconds < StartSeconds + SecondsPerDay || seconds >= EndSeconds - SecondsPerDay) {
+        return false;
+    }
+
+    // Find the last transition at or before |seconds|.
+    const Transition* transition;
+    if (offset == TimeZoneOffset::UTC) {
+        transition = std::upper_bound(transitions_.begin(), transitions_.end(), seconds,
+                                      [](int64_t seconds, const Transition& transition) {
+            return seconds < transition.utcSeconds;
+        });
+    } else {
+        transition = std::upper_bound(transitions_.begin(), transitions_.end(), seconds,
+                                      [](int64_t seconds, const Transition& transition) {
+            return seconds < transition.localSeconds;
+        });
+    }
+    MOZ_ASSERT(transition != transitions_.begin());
+
+    *offsetMilliseconds = (transition - 1)->offsetMilliseconds;
+    return true;
+}
+
+bool
+js::DateTimeInfo::TimeZoneTransitions::operator==(const TimeZoneTransitions& other) const
+{
+    if (transitions_.length() != other.transitions_.length()) {
+        return false;
+    }
+    for (size_t i = 0; i < transitions_.length(); i++) {
+        const Transition& a = transitions_[i];
+        const Transition& b = other.transitions_[i];
+        if (a.utcSeconds != b.utcSeconds || a.offsetMilliseconds != b.offsetMilliseconds) {
+            return false;
+        }
+    }
+    return true;
+}
+
+/* static */ bool
+js::DateTimeInfo::lookupTransitions(int64_t milliseconds, TimeZoneOffset offset,
+                                    int32_t* offsetMilliseconds)
+{
+    const TimeZoneTransitions* transitions = transitions_;
+    if (!transitions) {
+        return false;
+    }
+
+    // Truncate to seconds like toClampedSeconds, so results don't depend on
+    // whether the table or the range caches were used.
+    int64_t seconds = milliseconds / int64_t(msPerSecond);
+    return transitions->lookup(seconds, offset, offsetMilliseconds);
+}
+
+void
+js::DateTimeInfo::computeTransitions()
+{
+    MOZ_ASSERT(!transitionsComputed_);
+    MOZ_ASSERT(!transitions_);
+
+    // Don't try again until the time zone changes, even when the table can't
+    // be used.
+    transitionsComputed_ = true;
+
+    auto transitions = js::MakeUnique<TimeZoneTransitions>();
+    if (!transitions) {
+        return;
+    }
+
+    int64_t seconds = TimeZoneTransitions::StartSeconds;
+    if (!transitions->append(seconds, computeLocalOffsetMilliseconds(seconds))) {
+        return;
+    }
+
+    {
+        // Tell the analysis ICU's allocation functions cannot GC.
+        JS::AutoSuppressGCAnalysis nogc;
+
+        // All ICU TimeZone classes derive from BasicTimeZone, see
+        // computeUTCOffsetMilliseconds.
+        auto* basicTz = static_cast<icu::BasicTimeZone*>(timeZone());
+
+        icu::TimeZoneTransition transition;
+        UDate date = UDate(seconds * msPerSecond);
+        constexpr bool inclusive = false;
+        while (basicTz->getNextTransition(date, inclusive, transition)) {
+            date = transition.getTime();
+            seconds = static_cast<int64_t>(std::floor(date / msPerSecond));
+            if (seconds >= TimeZoneTransitions::EndSeconds) {
+                break;
+            }
+
+            if (!transitions->append(seconds, computeLocalOffsetMilliseconds(seconds))) {
+                return;
+            }
+        }
+    }
+
+    for (const auto& table : transitionTables_) {
+        if (*table == *transitions) {
+            transitions_ = table.get();
+            return;
+        }
+    }
+
+    if (!transitionTables_.append(std::move(transitions))) {
+        return;
+    }
+    transitions_ = transitionTables_.back().get();
+}
+
 bool
 js::DateTimeInfo::internalTimeZoneDisplayName(char16_t* buf, size_t buflen,
                                               int64_t utcMilliseconds, const char* locale)
@@ -509,6 +670,11 @@ js::DateTimeInfo::timeZone()
 /* static */ js::ExclusiveData<js::DateTimeInfo>*
 js::DateTimeInfo::instance;
 
+#if ENABLE_INTL_API && !MOZ_SYSTEM_ICU
+/* static */ mozilla::Atomic<const js::DateTimeInfo::TimeZoneTransitions*, mozilla::ReleaseAcquire>
+js::DateTimeInfo::transitions_;
+#endif /* ENABLE_INTL_API && !MOZ_SYSTEM_ICU */
+
 /* static */ js::ExclusiveData<js::IcuTimeZoneStatus>*
 js::IcuTimeZoneState;
 
@@ -8,12 +8,15 @@
 #define vm_DateTime_h
 
 #include "mozilla/Assertions.h"
+#include "mozilla/Atomics.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/UniquePtr.h"
 
 #include <stdint.h>
 
+#include "js/AllocPolicy.h"
 #include "js/Utility.h"
+#include "js/Vector.h"
 #include "threading/ExclusiveData.h"
 
 #if ENABLE_INTL_API && !MOZ_SYSTEM_ICU
@@ -159,6 +162,11 @@ class DateTimeInfo
      * given time. The input time can be either at UTC or at local time.
      */
     static int32_t getOffsetMilliseconds(int64_t milliseconds, TimeZoneOffset offset) {
+        int32_t offsetMilliseconds;
+        if (lookupTransitions(milliseconds, offset, &offsetMilliseconds)) {
+            return offsetMilliseconds;
+        }
+
         auto guard = instance->lock();
         return guard->internalGetOffsetMilliseconds(milliseconds, offset);
     }
@@ -244,6 +252,59 @@ class DateTimeInfo
      */
     mozilla::UniquePtr<icu::TimeZone> timeZone_;
 
+    /**
+     * The offsets of a time zone from 1900 to 2100, computed from ICU's time
+     * zone transitions, so that getOffsetMilliseconds is a binary search for
+     * most dates.
+     */
+    class TimeZoneTransitions
+    {
+        struct Transition
+        {
+            // The UTC time of the transition.
+            int64_t utcSeconds;
+
+            // The earliest local time which is interpreted with the offset
+            // after the transition. Skipped and repeated local times are
+            // interpreted with the offset before the transition, as in
+            // computeUTCOffsetMilliseconds.
+            int64_t localSeconds;
+
+            // The offset after the transition.
+            int32_t offsetMilliseconds;
+        };
+
+        Vector<Transition, 0, SystemAllocPolicy> transitions_;
+
+      public:
+        static constexpr int64_t StartSeconds = -2208988800; /* 01/01/1900 */
+        static constexpr int64_t EndSeconds = 4102444800; /* 01/01/2100 */
+
+        // Return false on OOM and, as binary search on local times requires
+        // them to be sorted, when the local times don't increase.
+        MOZ_MUST_USE bool append(int64_t utcSeconds, int32_t offsetMilliseconds);
+
+        bool lookup(int64_t seconds, TimeZoneOffset offset, int32_t* offsetMilliseconds) const;
+
+        bool operator==(const TimeZoneTransitions& other) const;
+    };
+
+    /**
+     * The transitions of the current time zone, or nullptr if they haven't
+     * been computed since the last time zone change, or can't be used.
+     * Tables are immutable and only freed when the DateTimeInfo is destroyed,
+     * so lookups don't need to take the lock.
+     */
+    static mozilla::Atomic<const TimeZoneTransitions*, mozilla::ReleaseAcquire> transitions_;
+
+    /**
+     * All tables computed so far. A time zone change back to a previous time
+     * zone reuses its table.
+     */
+    Vector<mozilla::UniquePtr<TimeZoneTransitions>, 0, SystemAllocPolicy> transitionTables_;
+
+    bool transitionsComputed_;
+
     /**
      * Cached names of the standard and daylight savings display names of the
      * current time zone for the default locale.
@@ -299,6 +360,11 @@ class DateTimeInfo
 
     int32_t internalGetOffsetMilliseconds(int64_t milliseconds, TimeZoneOffset offset);
 
+    static bool lookupTransitions(int64_t milliseconds, TimeZoneOffset offset,
+                                  int32_t* offsetMilliseconds);
+
+    void computeTransitions();
+
     bool internalTimeZoneDisplayName(char16_t* buf, size_t buflen, int64_t utcMilliseconds,
                                      const char* locale);
 
@@ -25,6 +25,7 @@
 #include "gc/PublicIterators.h"
 #include "jit/BaselineDebugModeOSR.h"
 #include "jit/BaselineJIT.h"
+#include "jit/JitRealm.h"
 #include "js/CharacterEncoding.h"
 #include "js/Date.h"
 #include "js/SourceBufferHolder.h"
@@ -4080,6 +4081,7 @@ Debugger::getNewestFrame(JSContext* cx, unsigned argc, Value* vp)
 Debugger::clearAllBreakpoints(JSContext* cx, unsigned argc, Value* vp)
 {
     THIS_DEBUGGER(cx, argc, vp, "clearAllBreakpoints", args, dbg);
+    jit::AutoBatchJitCodeReprotection batch(cx->runtime());
     for (WeakGlobalObjectSet::Range r = dbg->debuggees.all(); !r.empty(); r.popFront()) {
         r.front()->realm()->clearBreakpointsIn(cx->runtime()->defaultFreeOp(), dbg, nullptr);
     }
@@ -4378,6 +4380,7 @@ Debugger::removeDebuggeeGlobal(FreeOp* fop, GlobalObject* global,
     }
 
     // Remove all breakpoints for the debuggee.
+    jit::AutoBatchJitCodeReprotection batch(fop->runtime());
     Breakpoint* nextbp;
     for (Breakpoint* bp = firstBreakpoint(); bp; bp = nextbp) {
         nextbp = bp->nextInDebugger();
@@ -27,10 +27,18 @@ GeneratorObject::create(JSContext* cx, AbstractFramePtr frame)
 
     RootedValue pval(cx);
     RootedObject fun(cx, frame.callee());
-    // FIXME: This would be faster if we could avoid doing a lookup to get
-    // the prototype for the instance.  Bug 906600.
-    if (!GetProperty(cx, fun, fun, cx->names().prototype, &pval)) {
-        return nullptr;
+
+    // The generator object of an async function is never exposed to script,
+    // so its prototype doesn't matter and every await-heavy call would pay
+    // for the lookup below. Generator functions have a "prototype" data
+    // property, which is usually already resolved and can be read without a
+    // full property lookup.
+    if (!frame.script()->isAsync() || frame.script()->isGenerator()) {
+        if (!GetPropertyPure(cx, fun, NameToId(cx->names().prototype), pval.address()) &&
+            !GetProperty(cx, fun, fun, cx->names().prototype, &pval))
+        {
+            return nullptr;
+        }
     }
     RootedObject proto(cx, pval.isObject() ? &pval.toObject() : nullptr);
     if (!proto) {
@@ -247,24 +247,31 @@ GlobalObject::resolveConstructor(JSContext* cx,
 
     // If we're operating on the self-hosting global, we don't want any
     // functions and properties on the builtins and their prototypes.
+    // The property names are shared by every realm in the runtime, so they
+    // only get atomized for the first one.
     if (!cx->runtime()->isSelfHostingGlobal(global)) {
+        SpecIdCache& specIds = cx->runtime()->caches().specIdCache;
         if (const JSFunctionSpec* funs = clasp->specPrototypeFunctions()) {
-            if (!JS_DefineFunctions(cx, proto, funs)) {
+            const jsid* ids = specIds.lookupOrAdd(cx, funs);
+            if (!ids || !DefineFunctions(cx, proto, funs, NotIntrinsic, ids)) {
                 return false;
             }
         }
         if (const JSPropertySpec* props = clasp->specPrototypeProperties()) {
-            if (!JS_DefineProperties(cx, proto, props)) {
+            const jsid* ids = specIds.lookupOrAdd(cx, props);
+            if (!ids || !DefineProperties(cx, proto, props, ids)) {
                 return false;
             }
         }
         if (const JSFunctionSpec* funs = clasp->specConstructorFunctions()) {
-            if (!JS_DefineFunctions(cx, ctor, funs)) {
+            const jsid* ids = specIds.lookupOrAdd(cx, funs);
+            if (!ids || !DefineFunctions(cx, ctor, funs, NotIntrinsic, ids)) {
                 return false;
             }
         }
         if (const JSPropertySpec* props = clasp->specConstructorProperties()) {
-            if (!JS_DefineProperties(cx, ctor, props)) {
+            const jsid* ids = specIds.lookupOrAdd(cx, props);
+            if (!ids || !DefineProperties(cx, ctor, props, ids)) {
                 return false;
             }
         }
@@ -20,6 +20,7 @@
 #include "util/NativeStack.h"
 #include "vm/Debugger.h"
 #include "vm/ErrorReporting.h"
+#include "vm/JSONParser.h"
 #include "vm/SharedImmutableStringsCache.h"
 #include "vm/Time.h"
 #include "vm/TraceLogging.h"
@@ -37,6 +38,7 @@ using namespace js;
 
 using mozilla::Maybe;
 using mozilla::Unused;
+using mozilla::Utf8Unit;
 using mozilla::TimeDuration;
 using mozilla::TimeStamp;
 
@@ -121,6 +123,54 @@ JS::SetProfilingThreadCallbacks(JS::RegisterThreadCallback registerThread,
     HelperThreadState().unregisterThread = unregisterThread;
 }
 
+JS_PUBLIC_API(void)
+JS::SetHelperThreadTaskCallback(JS::HelperThreadTaskCallback callback, size_t threadCount)
+{
+    MOZ_ASSERT(callback);
+    MOZ_ASSERT(threadCount > 0);
+
+    // This must be called before the threads have been initialized.
+    MOZ_ASSERT(!HelperThreadState().threads);
+
+    HelperThreadState().dispatchTaskCallback = callback;
+    HelperThreadState().cpuCount = threadCount;
+    HelperThreadState().threadCount = ThreadCountForCPUCount(threadCount);
+}
+
+JS_PUBLIC_API(void)
+JS::SetHelperThreadNumaPinning(bool pin)
+{
+    // This must be called before the threads have been initialized.
+    MOZ_ASSERT(!HelperThreadState().threads);
+
+    HelperThreadState().pinThreadsToNumaNodes = pin;
+}
+
+JS_PUBLIC_API(void)
+JS::SetHelperThreadCPUCount(size_t count)
+{
+    if (count == 0) {
+        count = ClampDefaultCPUCount(GetAvailableCPUCount());
+    }
+    HelperThreadState().setCPUCount(count);
+}
+
+JS_PUBLIC_API(void)
+JS::SetHelperThreadTaskLimit(JS::HelperThreadTaskKind kind, size_t maxThreads)
+{
+    MOZ_ASSERT(kind < JS::HelperThreadTaskKind::Limit);
+    HelperThreadState().setTaskLimit(kind, maxThreads);
+}
+
+JS_PUBLIC_API(void)
+JS::RunHelperThreadTask()
+{
+    MOZ_ASSERT(!TlsContext.get());
+
+    AutoLockHelperThreadState lock;
+    HelperThreadState().runTaskFromExternalThread(lock);
+}
+
 /* static */ void
 HelperThread::WakeupAll()
 {
@@ -260,6 +310,8 @@ js::StartOffThreadIonCompile(jit::IonBuilder* builder, const AutoLockHelperThrea
         return false;
     }
 
+    builder->setQueued(builder->script()->getWarmUpCount(), ReallyNow());
+
     // The build is moving off-thread. Freeze the LifoAlloc to prevent any
     // unwanted mutations.
     builder->alloc().lifoAlloc()->setReadOnly();
@@ -544,6 +596,7 @@ ParseTask::trace(JSTracer* trc)
     TraceManuallyBarrieredEdge(trc, &parseGlobal, "ParseTask::parseGlobal");
     scripts.trace(trc);
     sourceObjects.trace(trc);
+    traceResults(trc);
 }
 
 size_t
@@ -579,6 +632,34 @@ ScriptParseTask::parse(JSContext* cx)
     }
 }
 
+Utf8ScriptParseTask::Utf8ScriptParseTask(JSContext* cx, const Utf8Unit* units, size_t length,
+                                         JS::OffThreadCompileCallback callback,
+                                         void* callbackData)
+  : ParseTask(ParseTaskKind::Script, cx, callback, callbackData),
+    units(units),
+    length(length)
+{}
+
+void
+Utf8ScriptParseTask::parse(JSContext* cx)
+{
+    MOZ_ASSERT(cx->helperThread());
+
+    Rooted<ScriptSourceObject*> sourceObject(cx);
+
+    ScopeKind scopeKind = options.nonSyntacticScope ? ScopeKind::NonSyntactic : ScopeKind::Global;
+
+    JSScript* script = frontend::CompileGlobalScript(cx, cx->tempLifoAlloc(), scopeKind,
+                                                     options, units, length,
+                                                     /* sourceObjectOut = */ &sourceObject.get());
+    if (script) {
+        scripts.infallibleAppend(script);
+    }
+    if (sourceObject) {
+        sourceObjects.infallibleAppend(sourceObject);
+    }
+}
+
 ModuleParseTask::ModuleParseTask(JSContext* cx, JS::SourceBufferHolder& srcBuf,
                                  JS::OffThreadCompileCallback callback, void* callbackData)
   : ParseTask(ParseTaskKind::Module, cx, callback, callbackData),
@@ -659,7 +740,11 @@ MultiScriptsDecodeTask::MultiScriptsDecodeTask(JSContext* cx, JS::TranscodeSourc
                                                JS::OffThreadCompileCallback callback,
                                                void* callbackData)
   : ParseTask(ParseTaskKind::MultiScriptsDecode, cx, callback, callbackData),
-    sources(&sources)
+    sources(&sources),
+    sourcesBegin(0),
+    sourcesEnd(sources.length()),
+    whole(nullptr),
+    unfinishedParts(1)
 {}
 
 void
@@ -667,14 +752,14 @@ MultiScriptsDecodeTask::parse(JSContext* cx)
 {
     MOZ_ASSERT(cx->helperThread());
 
-    if (!scripts.reserve(sources->length()) ||
-        !sourceObjects.reserve(sources->length()))
-    {
+    size_t numSources = sourcesEnd - sourcesBegin;
+    if (!scripts.reserve(numSources) || !sourceObjects.reserve(numSources)) {
         ReportOutOfMemory(cx); // This sets |outOfMemory|.
         return;
     }
 
-    for (auto& source : *sources) {
+    for (size_t i = sourcesBegin; i < sourcesEnd; i++) {
+        JS::TranscodeSource& source = (*sources)[i];
         CompileOptions opts(cx, options);
         opts.setFileAndLine(source.filename, source.lineno);
 
@@ -695,6 +780,65 @@ MultiScriptsDecodeTask::parse(JSContext* cx)
     }
 }
 
+MultiScriptsDecodeTask*
+MultiScriptsDecodeTask::finishPart(const AutoLockHelperThreadState& lock)
+{
+    MultiScriptsDecodeTask* task = whole ? whole : this;
+    MOZ_ASSERT(task->unfinishedParts > 0);
+    if (--task->unfinishedParts) {
+        return nullptr;
+    }
+
+    // Everything is still in the parts' zones, which are merged along with
+    // the task's own when it is finished.
+    for (auto& part : task->parts) {
+        if (!task->scripts.appendAll(part->scripts) ||
+            !task->sourceObjects.appendAll(part->sourceObjects))
+        {
+            task->outOfMemory = true;
+        }
+        for (auto& error : part->errors) {
+            if (!task->errors.append(std::move(error))) {
+                task->outOfMemory = true;
+            }
+        }
+        task->overRecursed |= part->overRecursed;
+        task->outOfMemory |= part->outOfMemory;
+    }
+    return task;
+}
+
+JSONParseTask::JSONParseTask(JSContext* cx, JS::UniqueTwoByteChars chars, size_t length,
+                             JS::OffThreadCompileCallback callback, void* callbackData)
+  : ParseTask(ParseTaskKind::JSON, cx, callback, callbackData),
+    chars(std::move(chars)),
+    length(length),
+    result(UndefinedValue())
+{}
+
+void
+JSONParseTask::parse(JSContext* cx)
+{
+    MOZ_ASSERT(cx->helperThread());
+
+    mozilla::Range<const char16_t> range(chars.get(), length);
+    Rooted<JSONParser<char16_t>> parser(cx, JSONParser<char16_t>(cx, range));
+
+    RootedValue value(cx);
+    if (parser.parse(&value)) {
+        result = value;
+    }
+
+    // The text is not needed once the parse is done.
+    chars.reset();
+}
+
+void
+JSONParseTask::traceResults(JSTracer* trc)
+{
+    TraceRoot(trc, &result, "JSONParseTask::result");
+}
+
 void
 js::CancelOffThreadParses(JSRuntime* rt)
 {
@@ -872,16 +1016,34 @@ QueueOffThreadParseTask(JSContext* cx, ParseTask* task)
 
     bool mustWait = OffThreadParsingMustWaitForGC(cx->runtime());
 
+    // The other parts of a multiple script decode are queued along with it.
+    MultiScriptsDecodeTask* multiTask = task->kind == ParseTaskKind::MultiScriptsDecode
+                                        ? static_cast<MultiScriptsDecodeTask*>(task)
+                                        : nullptr;
+    size_t numParts = multiTask ? multiTask->parts.length() : 0;
+
     auto& queue = mustWait ? HelperThreadState().parseWaitingOnGC(lock)
                            : HelperThreadState().parseWorklist(lock);
-    if (!queue.append(task)) {
+    if (!queue.reserve(queue.length() + 1 + numParts)) {
         ReportOutOfMemory(cx);
         return false;
     }
 
+    queue.infallibleAppend(task);
+    for (size_t i = 0; i < numParts; i++) {
+        queue.infallibleAppend(multiTask->parts[i].get());
+    }
+
     if (!mustWait) {
         task->activate(cx->runtime());
-        HelperThreadState().notifyOne(GlobalHelperThreadState::PRODUCER, lock);
+        for (size_t i = 0; i < numParts; i++) {
+            multiTask->parts[i]->activate(cx->runtime());
+        }
+        if (numParts) {
+            HelperThreadState().notifyAll(GlobalHelperThreadState::PRODUCER, lock);
+        } else {
+            HelperThreadState().notifyOne(GlobalHelperThreadState::PRODUCER, lock);
+        }
     }
 
     return true;
@@ -933,6 +1095,20 @@ js::StartOffThreadParseScript(JSContext* cx, const ReadOnlyCompileOptions& optio
     return true;
 }
 
+bool
+js::StartOffThreadParseScript(JSContext* cx, const ReadOnlyCompileOptions& options,
+                              const Utf8Unit* units, size_t length,
+                              JS::OffThreadCompileCallback callback, void* callbackData)
+{
+    auto task = cx->make_unique<Utf8ScriptParseTask>(cx, units, length, callback, callbackData);
+    if (!task || !StartOffThreadParseTask(cx, task.get(), options)) {
+        return false;
+    }
+
+    Unused << task.release();
+    return true;
+}
+
 bool
 js::StartOffThreadParseModule(JSContext* cx, const ReadOnlyCompileOptions& options,
                               JS::SourceBufferHolder& srcBuf,
@@ -961,16 +1137,84 @@ js::StartOffThreadDecodeScript(JSContext* cx, const ReadOnlyCompileOptions& opti
     return true;
 }
 
+// Batches are only split when every part would get at least this many sources,
+// as each part needs its own global.
+static const size_t MinSourcesPerDecodePart = 4;
+
+static bool
+CreateMultiScriptsDecodeParts(JSContext* cx, MultiScriptsDecodeTask* task,
+                              const ReadOnlyCompileOptions& options)
+{
+    size_t numSources = task->sources->length();
+    size_t numParts = Min(HelperThreadState().maxParseThreads(),
+                          numSources / MinSourcesPerDecodePart);
+    if (numParts <= 1) {
+        return true;
+    }
+
+    gc::AutoSuppressGC nogc(cx);
+    gc::AutoSuppressNurseryCellAlloc noNurseryAlloc(cx);
+    AutoSuppressAllocationMetadataBuilder suppressMetadata(cx);
+
+    size_t sourcesPerPart = (numSources + numParts - 1) / numParts;
+    task->sourcesEnd = sourcesPerPart;
+
+    for (size_t begin = sourcesPerPart; begin < numSources; begin += sourcesPerPart) {
+        auto part = cx->make_unique<MultiScriptsDecodeTask>(cx, *task->sources, nullptr, nullptr);
+        if (!part) {
+            return false;
+        }
+        part->sourcesBegin = begin;
+        part->sourcesEnd = Min(begin + sourcesPerPart, numSources);
+        part->whole = task;
+
+        JSObject* global = CreateGlobalForOffThreadParse(cx, nogc);
+        if (!global) {
+            return false;
+        }
+
+        AutoSetCreatedForHelperThread createdForHelper(global);
+
+        if (!part->init(cx, options, global)) {
+            return false;
+        }
+        if (!task->parts.append(std::move(part))) {
+            ReportOutOfMemory(cx);
+            return false;
+        }
+
+        createdForHelper.forget();
+    }
+
+    task->unfinishedParts = 1 + task->parts.length();
+    return true;
+}
+
 bool
 js::StartOffThreadDecodeMultiScripts(JSContext* cx, const ReadOnlyCompileOptions& options,
                                      JS::TranscodeSources& sources,
                                      JS::OffThreadCompileCallback callback, void* callbackData)
 {
     auto task = cx->make_unique<MultiScriptsDecodeTask>(cx, sources, callback, callbackData);
-    if (!task || !StartOffThreadParseTask(cx, task.get(), options)) {
+    if (!task) {
         return false;
     }
 
+    // The zones of any parts which were created are released if the task
+    // can't be started.
+    auto releaseParts = mozilla::MakeScopeExit([&] {
+        for (auto& part : task->parts) {
+            part->parseGlobal->zone()->clearUsedByHelperThread();
+        }
+    });
+
+    if (!CreateMultiScriptsDecodeParts(cx, task.get(), options) ||
+        !StartOffThreadParseTask(cx, task.get(), options))
+    {
+        return false;
+    }
+
+    releaseParts.release();
     Unused << task.release();
     return true;
 }
@@ -997,6 +1241,26 @@ js::StartOffThreadDecodeBinAST(JSContext* cx, const ReadOnlyCompileOptions& opti
 
 #endif /* JS_BUILD_BINAST */
 
+bool
+js::StartOffThreadParseJSON(JSContext* cx, JS::UniqueTwoByteChars chars, size_t length,
+                            JS::OffThreadCompileCallback callback, void* callbackData)
+{
+    auto task = cx->make_unique<JSONParseTask>(cx, std::move(chars), length, callback,
+                                               callbackData);
+    if (!task) {
+        return false;
+    }
+
+    // The options are only used for the parse global, as JSON has no source.
+    CompileOptions options(cx);
+    if (!StartOffThreadParseTask(cx, task.get(), options)) {
+        return false;
+    }
+
+    Unused << task.release();
+    return true;
+}
+
 void
 js::EnqueuePendingParseTasksAfterGC(JSRuntime* rt)
 {
@@ -1095,10 +1359,20 @@ GlobalHelperThreadState::ensureInitialized()
         return false;
     }
 
+    activeThreadCount_ = Min(threadCount, ThreadCountForCPUCount(cpuCount));
+
     for (size_t i = 0; i < threadCount; i++) {
         threads->infallibleEmplaceBack();
         HelperThread& helper = (*threads)[i];
 
+        if (dispatchTaskCallback) {
+            continue;
+        }
+
+        if (pinThreadsToNumaNodes) {
+            helper.numaNode = uint32_t(i % GetNumaNodeCount());
+        }
+
         helper.thread = mozilla::Some(Thread(Thread::Options().setStackSize(HELPER_STACK_SIZE)));
         if (!helper.thread->init(HelperThread::ThreadMain, &helper)) {
             goto error;
@@ -1120,18 +1394,57 @@ GlobalHelperThreadState::ensureInitialized()
 GlobalHelperThreadState::GlobalHelperThreadState()
  : cpuCount(0),
    threadCount(0),
+   pinThreadsToNumaNodes(false),
    threads(nullptr),
    registerThread(nullptr),
    unregisterThread(nullptr),
+   dispatchTaskCallback(nullptr),
    wasmTier2GeneratorsFinished_(0),
+   terminating_(false),
+   activeThreadCount_(0),
    helperLock(mutexid::GlobalHelperThreadState)
 {
-    cpuCount = ClampDefaultCPUCount(GetCPUCount());
-    threadCount = ThreadCountForCPUCount(cpuCount);
+    // Create enough threads for all of the machine's cores, but only use as
+    // many as the process can run on at the moment. Limits on the process,
+    // such as a container's CPU quota, may change later.
+    threadCount = ThreadCountForCPUCount(ClampDefaultCPUCount(GetCPUCount()));
+    cpuCount = Min(ClampDefaultCPUCount(GetAvailableCPUCount()), threadCount);
 
     MOZ_ASSERT(cpuCount > 0, "GetCPUCount() seems broken");
 }
 
+void
+GlobalHelperThreadState::setCPUCount(size_t count)
+{
+    AutoLockHelperThreadState lock;
+
+    cpuCount = Max<size_t>(Min(count, threadCount), 1);
+    if (!threads) {
+        // ensureInitialized will work out the number of active threads.
+        return;
+    }
+
+    activeThreadCount_ = Min(threadCount, ThreadCountForCPUCount(cpuCount));
+
+    // Wake up any threads which have just become active. Threads which are no
+    // longer active finish their current task first.
+    notifyAll(PRODUCER, lock);
+}
+
+bool
+GlobalHelperThreadState::isActiveThread(const HelperThread* thread) const
+{
+    MOZ_ASSERT(threads);
+    return size_t(thread - threads->begin()) < activeThreadCount_;
+}
+
+size_t
+GlobalHelperThreadState::taskLimit(JS::HelperThreadTaskKind kind, size_t defaultLimit) const
+{
+    size_t limit = taskLimits_[size_t(kind)];
+    return limit ? Min(limit, threadCount) : defaultLimit;
+}
+
 void
 GlobalHelperThreadState::finish()
 {
@@ -1156,6 +1469,17 @@ GlobalHelperThreadState::finishThreads()
     }
 
     MOZ_ASSERT(CanUseExtraThreads());
+
+    if (dispatchTaskCallback) {
+        // We can't interrupt the tasks the embedder's threads are running, so
+        // wait for them to finish.
+        AutoLockHelperThreadState lock;
+        terminating_ = true;
+        while (hasActiveThreads(lock)) {
+            wait(lock, CONSUMER);
+        }
+    }
+
     for (auto& thread : *threads) {
         thread.destroy();
     }
@@ -1190,15 +1514,55 @@ GlobalHelperThreadState::wait(AutoLockHelperThreadState& locked, CondVar which,
 }
 
 void
-GlobalHelperThreadState::notifyAll(CondVar which, const AutoLockHelperThreadState&)
+GlobalHelperThreadState::notifyAll(CondVar which, const AutoLockHelperThreadState& lock)
 {
     whichWakeup(which).notify_all();
+
+    if (which == PRODUCER && dispatchTaskCallback && threads) {
+        for (size_t i = 0; i < threads->length(); i++) {
+            dispatch(lock);
+        }
+    }
 }
 
 void
-GlobalHelperThreadState::notifyOne(CondVar which, const AutoLockHelperThreadState&)
+GlobalHelperThreadState::notifyOne(CondVar which, const AutoLockHelperThreadState& lock)
 {
     whichWakeup(which).notify_one();
+
+    if (which == PRODUCER) {
+        dispatch(lock);
+    }
+}
+
+void
+GlobalHelperThreadState::dispatch(const AutoLockHelperThreadState&)
+{
+    if (dispatchTaskCallback && !terminating_) {
+        dispatchTaskCallback();
+    }
+}
+
+void
+GlobalHelperThreadState::runTaskFromExternalThread(AutoLockHelperThreadState& lock)
+{
+    MOZ_ASSERT(dispatchTaskCallback);
+
+    if (!threads || terminating_) {
+        return;
+    }
+
+    // Tasks are accounted to idle slots as if they ran on our own threads,
+    // which keeps the per-kind thread limits working. If every slot is busy,
+    // there'll be another dispatch when one of their tasks finishes.
+    for (auto& helper : *threads) {
+        if (helper.idle() && isActiveThread(&helper)) {
+            if (helper.runExternalTask(lock)) {
+                notifyAll(CONSUMER, lock);
+            }
+            return;
+        }
+    }
 }
 
 bool
@@ -1273,7 +1637,7 @@ GlobalHelperThreadState::checkTaskThreadLimit(size_t maxThreads, bool isMaster)
             if (thread.currentTask->is<T>()) {
                 count++;
             }
-        } else {
+        } else if (isActiveThread(&thread)) {
             idle++;
         }
         if (count >= maxThreads) {
@@ -1412,7 +1776,11 @@ GlobalHelperThreadState::maxIonCompilationThreads() const
     if (IsHelperThreadSimulatingOOM(js::THREAD_TYPE_ION)) {
         return 1;
     }
-    return threadCount;
+
+    // Leave a core free for GC and other helper tasks, so that a backlog of
+    // Ion compilations can't starve them.
+    return taskLimit(JS::HelperThreadTaskKind::Ion,
+                     Min(activeThreadCount(), Max<size_t>(cpuCount - 1, 1)));
 }
 
 size_t
@@ -1421,7 +1789,7 @@ GlobalHelperThreadState::maxWasmCompilationThreads() const
     if (IsHelperThreadSimulatingOOM(js::THREAD_TYPE_WASM)) {
         return 1;
     }
-    return cpuCount;
+    return taskLimit(JS::HelperThreadTaskKind::Wasm, cpuCount);
 }
 
 size_t
@@ -1436,7 +1804,7 @@ GlobalHelperThreadState::maxPromiseHelperThreads() const
     if (IsHelperThreadSimulatingOOM(js::THREAD_TYPE_WASM)) {
         return 1;
     }
-    return cpuCount;
+    return taskLimit(JS::HelperThreadTaskKind::PromiseTask, cpuCount);
 }
 
 size_t
@@ -1445,7 +1813,7 @@ GlobalHelperThreadState::maxParseThreads() const
     if (IsHelperThreadSimulatingOOM(js::THREAD_TYPE_PARSE)) {
         return 1;
     }
-    return cpuCount;
+    return taskLimit(JS::HelperThreadTaskKind::Parse, cpuCount);
 }
 
 size_t
@@ -1457,7 +1825,7 @@ GlobalHelperThreadState::maxCompressionThreads() const
 
     // Compression is triggered on major GCs to compress ScriptSources. It is
     // considered low priority work.
-    return 1;
+    return taskLimit(JS::HelperThreadTaskKind::Compression, 1);
 }
 
 size_t
@@ -1466,7 +1834,7 @@ GlobalHelperThreadState::maxGCParallelThreads() const
     if (IsHelperThreadSimulatingOOM(js::THREAD_TYPE_GCPARALLEL)) {
         return 1;
     }
-    return threadCount;
+    return taskLimit(JS::HelperThreadTaskKind::GCParallel, activeThreadCount());
 }
 
 bool
@@ -1552,8 +1920,40 @@ GlobalHelperThreadState::canStartPromiseHelperTask(const AutoLockHelperThreadSta
                                                     /*isMaster=*/true);
 }
 
+// Queued builders gain one point of priority per this many milliseconds, so
+// that builders for cooler scripts are not starved forever.
+static const uint32_t IonBuilderAgingMs = 10;
+
+// Queued builders whose script has not run at all for this long are cancelled
+// instead of being compiled.
+static const uint32_t IonBuilderStaleMs = 5000;
+
+static uint64_t
+IonBuilderHotness(jit::IonBuilder* builder, TimeStamp now)
+{
+    JSScript* script = builder->script();
+    uint32_t warmUpCount = script->getWarmUpCount();
+
+    // Warm-up since the builder was queued shows how often the script is
+    // running right now, so it counts twice.
+    uint32_t recentWarmUp = warmUpCount > builder->queuedWarmUpCount()
+                            ? warmUpCount - builder->queuedWarmUpCount()
+                            : 0;
+    uint64_t hotness = (uint64_t(warmUpCount) + recentWarmUp) / script->length();
+
+    uint64_t age = uint64_t((now - builder->queuedTime()).ToMilliseconds()) / IonBuilderAgingMs;
+    return hotness + age;
+}
+
 static bool
-IonBuilderHasHigherPriority(jit::IonBuilder* first, jit::IonBuilder* second)
+IonBuilderIsStale(jit::IonBuilder* builder, TimeStamp now)
+{
+    return builder->script()->getWarmUpCount() <= builder->queuedWarmUpCount() &&
+           (now - builder->queuedTime()).ToMilliseconds() > IonBuilderStaleMs;
+}
+
+static bool
+IonBuilderHasHigherPriority(jit::IonBuilder* first, jit::IonBuilder* second, TimeStamp now)
 {
     // Return true if priority(first) > priority(second).
     //
@@ -1570,9 +1970,8 @@ IonBuilderHasHigherPriority(jit::IonBuilder* first, jit::IonBuilder* second)
         return !first->scriptHasIonScript();
     }
 
-    // A higher warm-up counter indicates a higher priority.
-    return first->script()->getWarmUpCount() / first->script()->length() >
-           second->script()->getWarmUpCount() / second->script()->length();
+    // A hotter or longer waiting script indicates a higher priority.
+    return IonBuilderHotness(first, now) > IonBuilderHotness(second, now);
 }
 
 bool
@@ -1594,10 +1993,31 @@ GlobalHelperThreadState::highestPriorityPendingIonCompile(const AutoLockHelperTh
     auto& worklist = ionWorklist(lock);
     MOZ_ASSERT(!worklist.empty());
 
+    TimeStamp now = ReallyNow();
+
+    // Cancel builders whose scripts have stopped running while they waited.
+    // Like other cancelled compilations, they are finished without code and
+    // cleaned up when the main thread next links compilations.
+    for (size_t i = 0; i < worklist.length(); i++) {
+        jit::IonBuilder* builder = worklist[i];
+        if (IonBuilderIsStale(builder, now)) {
+            builder->alloc().lifoAlloc()->setReadWrite();
+            FinishOffThreadIonCompile(builder, lock);
+            remove(worklist, &i);
+
+            JSRuntime* rt = builder->script()->runtimeFromAnyThread();
+            rt->mainContextFromAnyThread()->requestInterrupt(InterruptReason::AttachIonCompilations);
+        }
+    }
+
+    if (worklist.empty()) {
+        return nullptr;
+    }
+
     // Get the highest priority IonBuilder which has not started compilation yet.
     size_t index = 0;
     for (size_t i = 1; i < worklist.length(); i++) {
-        if (IonBuilderHasHigherPriority(worklist[i], worklist[index])) {
+        if (IonBuilderHasHigherPriority(worklist[i], worklist[index], now)) {
             index = i;
         }
     }
@@ -1657,6 +2077,29 @@ GlobalHelperThreadState::canStartGCParallelTask(const AutoLockHelperThreadState&
            checkTaskThreadLimit<GCParallelTask*>(maxGCParallelThreads());
 }
 
+GCParallelTask*
+GlobalHelperThreadState::takeGCParallelTask(const AutoLockHelperThreadState& lock, uint32_t node)
+{
+    GCParallelTaskVector& worklist = gcParallelWorklist(lock);
+    MOZ_ASSERT(!worklist.empty());
+
+    // Sweeping and the like mostly touch the memory of the runtime's chunks,
+    // so when they have been placed on a node, run the task near them. The
+    // worklist is short, and is otherwise taken from the back.
+    if (GetNumaNodeCount() > 1) {
+        for (size_t i = worklist.length(); i != 0; i--) {
+            GCParallelTask* task = worklist[i - 1];
+            GCRuntime& gc = task->runtime()->gc;
+            if (gc.useNumaLocalChunks() && gc.numaNodeForChunks() == node) {
+                worklist.erase(&worklist[i - 1]);
+                return task;
+            }
+        }
+    }
+
+    return worklist.popCopy();
+}
+
 js::GCParallelTask::~GCParallelTask()
 {
     // Only most-derived classes' destructors may do the join: base class
@@ -1744,6 +2187,32 @@ js::GCParallelTask::runFromMainThread(JSRuntime* rt)
     duration_ = TimeSince(timeStart);
 }
 
+void
+js::GCParallelTask::joinOrRunWithLockHeld(AutoLockHelperThreadState& lock)
+{
+    if (isDispatched(lock)) {
+        GlobalHelperThreadState::GCParallelTaskVector& worklist =
+            HelperThreadState().gcParallelWorklist(lock);
+        for (size_t i = 0; i < worklist.length(); i++) {
+            if (worklist[i] != this) {
+                continue;
+            }
+
+            worklist.erase(&worklist[i]);
+            {
+                AutoUnlockHelperThreadState unlock(lock);
+                TimeStamp timeStart = ReallyNow();
+                runTask();
+                duration_ = TimeSince(timeStart);
+            }
+            setFinished(lock);
+            break;
+        }
+    }
+
+    joinWithLockHeld(lock);
+}
+
 void
 js::GCParallelTask::runFromHelperThread(AutoLockHelperThreadState& lock)
 {
@@ -1779,7 +2248,7 @@ HelperThread::handleGCParallelWorkload(AutoLockHelperThreadState& lock)
     TraceLoggerThread* logger = TraceLoggerForCurrentThread();
     AutoTraceLog logCompile(logger, TraceLogger_GC);
 
-    currentTask.emplace(HelperThreadState().gcParallelWorklist(lock).popCopy());
+    currentTask.emplace(HelperThreadState().takeGCParallelTask(lock, currentNumaNode()));
     gcParallelTask()->runFromHelperThread(lock);
     currentTask.reset();
 }
@@ -1790,6 +2259,12 @@ LeaveParseTaskZone(JSRuntime* rt, ParseTask* task)
     // Mark the zone as no longer in use by a helper thread, and available
     // to be collected by the GC.
     rt->clearUsedByHelperThread(task->parseGlobal->zoneFromAnyThread());
+
+    if (task->kind == ParseTaskKind::MultiScriptsDecode) {
+        for (auto& part : static_cast<MultiScriptsDecodeTask*>(task)->parts) {
+            rt->clearUsedByHelperThread(part->parseGlobal->zoneFromAnyThread());
+        }
+    }
 }
 
 ParseTask*
@@ -1998,6 +2473,30 @@ GlobalHelperThreadState::finishModuleParseTask(JSContext* cx, JS::OffThreadToken
     return module;
 }
 
+bool
+GlobalHelperThreadState::finishJSONParseTask(JSContext* cx, JS::OffThreadToken* token,
+                                             MutableHandleValue vp)
+{
+    Rooted<UniquePtr<ParseTask>> parseTask(cx, finishParseTaskCommon(cx, ParseTaskKind::JSON,
+                                                                     token));
+    if (!parseTask) {
+        return false;
+    }
+
+    Value result = static_cast<JSONParseTask*>(parseTask.get().get())->result;
+    if (result.isUndefined()) {
+        // No error was reported, but no value produced. Assume we hit out of
+        // memory.
+        MOZ_ASSERT(false, "Expected value");
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+    cx->releaseCheck(result);
+    vp.set(result);
+    return true;
+}
+
 void
 GlobalHelperThreadState::cancelParseTask(JSRuntime* rt, ParseTaskKind kind,
                                          JS::OffThreadToken* token)
@@ -2025,6 +2524,12 @@ GlobalHelperThreadState::mergeParseTaskRealm(JSContext* cx, ParseTask* parseTask
 
     // Move the parsed script and all its contents into the desired realm.
     gc::MergeRealms(parseTask->parseGlobal->as<GlobalObject>().realm(), dest);
+
+    if (parseTask->kind == ParseTaskKind::MultiScriptsDecode) {
+        for (auto& part : static_cast<MultiScriptsDecodeTask*>(parseTask)->parts) {
+            gc::MergeRealms(part->parseGlobal->as<GlobalObject>().realm(), dest);
+        }
+    }
 }
 
 void
@@ -2078,12 +2583,19 @@ HelperThread::ThreadMain(void* arg)
 {
     ThisThread::SetName("JS Helper");
 
+    HelperThread* helper = static_cast<HelperThread*>(arg);
+    if (HelperThreadState().pinThreadsToNumaNodes) {
+        // This is only a hint to keep the thread near its memory, so carry
+        // on if it fails.
+        ThisThread::BindToNumaNode(helper->numaNode);
+    }
+
     // Helper threads are allowed to run differently during recording and
     // replay, as compiled scripts and GCs are allowed to vary. Because of
     // this, no recorded events at all should occur while on helper threads.
     mozilla::recordreplay::AutoDisallowThreadEvents d;
 
-    static_cast<HelperThread*>(arg)->threadLoop();
+    helper->threadLoop();
     Mutex::ShutDown();
 }
 
@@ -2173,8 +2685,13 @@ HelperThread::handleIonWorkload(AutoLockHelperThreadState& locked)
     MOZ_ASSERT(idle());
 
     // Find the IonBuilder in the worklist with the highest priority, and
-    // remove it from the worklist.
+    // remove it from the worklist. This may find that everything left in the
+    // worklist was stale.
     jit::IonBuilder* builder = HelperThreadState().highestPriorityPendingIonCompile(locked);
+    if (!builder) {
+        HelperThreadState().notifyAll(GlobalHelperThreadState::CONSUMER, locked);
+        return;
+    }
 
     // The build is taken by this thread. Unfreeze the LifoAlloc to allow
     // mutations.
@@ -2314,12 +2831,21 @@ HelperThread::handleParseWorkload(AutoLockHelperThreadState& locked)
         cx->atomsZoneFreeLists().clear();
     }
 
-    // The callback is invoked while we are still off thread.
-    task->callback(task, task->callbackData);
+    // The parts of a multiple script decode are reported together, when the
+    // last of them finishes.
+    ParseTask* finished = task;
+    if (task->kind == ParseTaskKind::MultiScriptsDecode) {
+        finished = static_cast<MultiScriptsDecodeTask*>(task)->finishPart(locked);
+    }
+
+    if (finished) {
+        // The callback is invoked while we are still off thread.
+        finished->callback(finished, finished->callbackData);
 
-    // FinishOffThreadScript will need to be called on the script to
-    // migrate it into the correct compartment.
-    HelperThreadState().parseFinishedList(locked).insertBack(task);
+        // FinishOffThreadScript will need to be called on the script to
+        // migrate it into the correct compartment.
+        HelperThreadState().parseFinishedList(locked).insertBack(finished);
+    }
 
 #ifdef DEBUG
     runtime->decOffThreadParsesRunning();
@@ -2539,16 +3065,16 @@ const HelperThread::TaskSpec HelperThread::taskSpecs[] = {
         &GlobalHelperThreadState::canStartGCParallelTask,
         &HelperThread::handleGCParallelWorkload
     },
-    {
-        THREAD_TYPE_ION,
-        &GlobalHelperThreadState::canStartIonCompile,
-        &HelperThread::handleIonWorkload
-    },
     {
         THREAD_TYPE_WASM,
         &GlobalHelperThreadState::canStartWasmTier1Compile,
         &HelperThread::handleWasmTier1Workload
     },
+    {
+        THREAD_TYPE_ION,
+        &GlobalHelperThreadState::canStartIonCompile,
+        &HelperThread::handleIonWorkload
+    },
     {
         THREAD_TYPE_PROMISE_TASK,
         &GlobalHelperThreadState::canStartPromiseHelperTask,
@@ -2632,7 +3158,12 @@ HelperThread::threadLoop()
         // lists). Unlocking the HelperThreadState between task selection and
         // execution is not well-defined.
 
-        const TaskSpec* task = findHighestPriorityTask(lock);
+        // Threads beyond the active count don't take tasks, but stay around
+        // in case the count grows again.
+        const TaskSpec* task = nullptr;
+        if (HelperThreadState().isActiveThread(this)) {
+            task = findHighestPriorityTask(lock);
+        }
         if (!task) {
             AUTO_PROFILER_LABEL("HelperThread::threadLoop::wait", IDLE);
             HelperThreadState().wait(lock, GlobalHelperThreadState::PRODUCER);
@@ -2647,6 +3178,46 @@ HelperThread::threadLoop()
     unregisterWithProfilerIfNeeded();
 }
 
+bool
+HelperThread::runExternalTask(AutoLockHelperThreadState& lock)
+{
+    MOZ_ASSERT(idle());
+    MOZ_ASSERT(thread.isNothing());
+
+    const TaskSpec* task = findHighestPriorityTask(lock);
+    if (!task) {
+        return false;
+    }
+
+    // The embedder's threads may run tasks for different slots each time, so
+    // each task gets a context of its own, on the current thread's stack.
+    JS::AutoSuppressGCAnalysis nogc;
+    JSContext cx(nullptr, JS::ContextOptions());
+    {
+        AutoEnterOOMUnsafeRegion oomUnsafe;
+        if (!cx.init(ContextKind::HelperThread)) {
+            oomUnsafe.crash("HelperThread cx.init()");
+        }
+    }
+    cx.setHelperThread(this);
+    JS_SetNativeStackQuota(&cx, HELPER_STACK_QUOTA);
+
+    js::oom::SetThreadType(task->type);
+    (this->*(task->handleWorkload))(lock);
+    js::oom::SetThreadType(js::THREAD_TYPE_NONE);
+
+    // The context's memory goes away with it.
+    shouldFreeUnusedMemory = false;
+    cx.setHelperThread(nullptr);
+
+    // Keep running tasks while there are more of them, one at a time so the
+    // embedder can schedule its own work in between.
+    if (findHighestPriorityTask(lock)) {
+        HelperThreadState().dispatch(lock);
+    }
+    return true;
+}
+
 const HelperThread::TaskSpec*
 HelperThread::findHighestPriorityTask(const AutoLockHelperThreadState& locked)
 {
@@ -2661,6 +3232,15 @@ HelperThread::findHighestPriorityTask(const AutoLockHelperThreadState& locked)
     return nullptr;
 }
 
+uint32_t
+HelperThread::currentNumaNode() const
+{
+    if (HelperThreadState().pinThreadsToNumaNodes && thread.isSome()) {
+        return numaNode;
+    }
+    return GetCurrentNumaNode();
+}
+
 void
 HelperThread::maybeFreeUnusedMemory(JSContext* cx)
 {
@@ -2670,6 +3250,7 @@ HelperThread::maybeFreeUnusedMemory(JSContext* cx)
 
     if (shouldFreeUnusedMemory) {
         cx->tempLifoAlloc().freeAll();
+        cx->lifoChunkPool().freeAll();
         shouldFreeUnusedMemory = false;
     }
 }
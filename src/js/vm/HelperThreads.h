@@ -13,11 +13,13 @@
 #ifndef vm_HelperThreads_h
 #define vm_HelperThreads_h
 
+#include "mozilla/Atomics.h"
 #include "mozilla/Attributes.h"
 #include "mozilla/GuardObjects.h"
 #include "mozilla/PodOperations.h"
 #include "mozilla/TimeStamp.h"
 #include "mozilla/TypeTraits.h"
+#include "mozilla/Utf8.h"
 #include "mozilla/Variant.h"
 
 #include "jsapi.h"
@@ -56,7 +58,8 @@ enum class ParseTaskKind
     Module,
     ScriptDecode,
     BinAST,
-    MultiScriptsDecode
+    MultiScriptsDecode,
+    JSON
 };
 
 namespace wasm {
@@ -87,13 +90,22 @@ class GlobalHelperThreadState
     // do not want to allow more than one such ModuleGenerator to run at a time.
     static const size_t MaxTier2GeneratorTasks = 1;
 
-    // Number of CPUs to treat this machine as having when creating threads.
-    // May be accessed without locking.
-    size_t cpuCount;
+    using AtomicSize = mozilla::Atomic<size_t, mozilla::Relaxed,
+                                       mozilla::recordreplay::Behavior::DontPreserve>;
 
-    // Number of threads to create. May be accessed without locking.
+    // Number of CPUs to treat this machine as having, which the per-kind
+    // thread limits are based on. This can change while running (see
+    // setCPUCount), and may be accessed without locking.
+    AtomicSize cpuCount;
+
+    // Number of threads to create, which is the most that can take tasks. May
+    // be accessed without locking.
     size_t threadCount;
 
+    // Whether to bind each thread to a NUMA node. May be accessed without
+    // locking.
+    bool pinThreadsToNumaNodes;
+
     typedef Vector<jit::IonBuilder*, 0, SystemAllocPolicy> IonBuilderVector;
     typedef Vector<ParseTask*, 0, SystemAllocPolicy> ParseTaskVector;
     typedef mozilla::LinkedList<ParseTask> ParseTaskList;
@@ -108,6 +120,11 @@ class GlobalHelperThreadState
     WriteOnceData<JS::RegisterThreadCallback> registerThread;
     WriteOnceData<JS::UnregisterThreadCallback> unregisterThread;
 
+    // If set, tasks are run by the embedder's threads through
+    // JS::RunHelperThreadTask, and |threads| holds slots for the tasks that
+    // are running rather than threads of our own.
+    WriteOnceData<JS::HelperThreadTaskCallback> dispatchTaskCallback;
+
   private:
     // The lists below are all protected by |lock|.
 
@@ -122,6 +139,21 @@ class GlobalHelperThreadState
     // Count of finished Tier2Generator tasks.
     uint32_t wasmTier2GeneratorsFinished_;
 
+    // Set when shutting down, to stop the embedder's threads from starting
+    // new tasks.
+    bool terminating_;
+
+    // The number of threads, starting from the first, which may take new
+    // tasks. The others wait until this grows again. Written with the lock
+    // held.
+    AtomicSize activeThreadCount_;
+
+    // Limits on the number of threads running each kind of task, set by the
+    // embedder, or zero for the default limits.
+    AtomicSize taskLimits_[size_t(JS::HelperThreadTaskKind::Limit)];
+
+    size_t taskLimit(JS::HelperThreadTaskKind kind, size_t defaultLimit) const;
+
     // Async tasks that, upon completion, are dispatched back to the JSContext's
     // owner thread via embedding callbacks instead of a finished list.
     PromiseHelperTaskVector promiseHelperTasks_;
@@ -162,6 +194,19 @@ class GlobalHelperThreadState
 
     GlobalHelperThreadState();
 
+    // Change the number of CPUs helper work may use, and the number of
+    // threads which take tasks along with it.
+    void setCPUCount(size_t count);
+
+    void setTaskLimit(JS::HelperThreadTaskKind kind, size_t maxThreads) {
+        taskLimits_[size_t(kind)] = maxThreads;
+    }
+
+    size_t activeThreadCount() const {
+        return activeThreadCount_;
+    }
+    bool isActiveThread(const HelperThread* thread) const;
+
     bool ensureInitialized();
     void finish();
     void finishThreads();
@@ -189,6 +234,13 @@ class GlobalHelperThreadState
     void notifyAll(CondVar which, const AutoLockHelperThreadState&);
     void notifyOne(CondVar which, const AutoLockHelperThreadState&);
 
+    // Ask the embedder to run a task on one of its threads, if tasks are run
+    // that way.
+    void dispatch(const AutoLockHelperThreadState&);
+
+    // Run a task on the current thread, which belongs to the embedder.
+    void runTaskFromExternalThread(AutoLockHelperThreadState& locked);
+
     // Helper method for removing items from the vectors below while iterating over them.
     template <typename T>
     void remove(T& vector, size_t* index)
@@ -265,6 +317,10 @@ class GlobalHelperThreadState
         return gcParallelWorklist_;
     }
 
+    // Remove and return a GC parallel task to run on a thread on the given
+    // NUMA node, preferring tasks whose runtime's chunks are on that node.
+    GCParallelTask* takeGCParallelTask(const AutoLockHelperThreadState& lock, uint32_t node);
+
     bool canStartWasmCompile(const AutoLockHelperThreadState& lock, wasm::CompileMode mode);
 
     bool canStartWasmTier1Compile(const AutoLockHelperThreadState& lock);
@@ -280,6 +336,8 @@ class GlobalHelperThreadState
     // Used by a major GC to signal processing enqueued compression tasks.
     void startHandlingCompressionTasks(const AutoLockHelperThreadState&);
 
+    // Remove and return the highest priority pending Ion compilation, after
+    // cancelling any stale ones. Returns nullptr if nothing is left.
     jit::IonBuilder* highestPriorityPendingIonCompile(const AutoLockHelperThreadState& lock);
   private:
     void scheduleCompressionTasks(const AutoLockHelperThreadState&);
@@ -303,6 +361,7 @@ class GlobalHelperThreadState
     JSScript* finishScriptDecodeTask(JSContext* cx, JS::OffThreadToken* token);
     bool finishMultiScriptsDecodeTask(JSContext* cx, JS::OffThreadToken* token, MutableHandle<ScriptVector> scripts);
     JSObject* finishModuleParseTask(JSContext* cx, JS::OffThreadToken* token);
+    bool finishJSONParseTask(JSContext* cx, JS::OffThreadToken* token, MutableHandleValue vp);
 
 #if defined(JS_BUILD_BINAST)
     JSScript* finishBinASTDecodeTask(JSContext* cx, JS::OffThreadToken* token);
@@ -371,6 +430,12 @@ struct HelperThread
      */
     bool shouldFreeUnusedMemory;
 
+    /* The NUMA node this thread is bound to, if threads are pinned. */
+    uint32_t numaNode;
+
+    /* The NUMA node this thread is running on. */
+    uint32_t currentNumaNode() const;
+
     /* The current task being executed by this thread, if any. */
     mozilla::Maybe<HelperTaskUnion> currentTask;
 
@@ -412,6 +477,10 @@ struct HelperThread
     static void ThreadMain(void* arg);
     void threadLoop();
 
+    // Run the highest priority task on the current thread, for
+    // JS::RunHelperThreadTask. Returns whether there was a task to run.
+    bool runExternalTask(AutoLockHelperThreadState& locked);
+
     static void WakeupAll();
 
     void ensureRegisteredWithProfiler();
@@ -614,6 +683,12 @@ StartOffThreadParseScript(JSContext* cx, const JS::ReadOnlyCompileOptions& optio
                           JS::SourceBufferHolder& srcBuf,
                           JS::OffThreadCompileCallback callback, void* callbackData);
 
+// As above, for UTF-8 source, which is parsed without being inflated.
+bool
+StartOffThreadParseScript(JSContext* cx, const JS::ReadOnlyCompileOptions& options,
+                          const mozilla::Utf8Unit* units, size_t length,
+                          JS::OffThreadCompileCallback callback, void* callbackData);
+
 bool
 StartOffThreadParseModule(JSContext* cx, const JS::ReadOnlyCompileOptions& options,
                           JS::SourceBufferHolder& srcBuf,
@@ -638,6 +713,11 @@ StartOffThreadDecodeMultiScripts(JSContext* cx, const JS::ReadOnlyCompileOptions
                                  JS::TranscodeSources& sources,
                                  JS::OffThreadCompileCallback callback, void* callbackData);
 
+/* Start parsing JSON text, which the parse takes ownership of. */
+bool
+StartOffThreadParseJSON(JSContext* cx, JS::UniqueTwoByteChars chars, size_t length,
+                        JS::OffThreadCompileCallback callback, void* callbackData);
+
 /*
  * Called at the end of GC to enqueue any Parse tasks that were waiting on an
  * atoms-zone GC to finish.
@@ -731,6 +811,10 @@ struct ParseTask : public mozilla::LinkedListElement<ParseTask>, public JS::OffT
 
     void trace(JSTracer* trc);
 
+    // Trace the results held by a subclass, which like |scripts| are only
+    // traced when the parse global's zone is not in use by a helper thread.
+    virtual void traceResults(JSTracer* trc) {}
+
     size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
     size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
         return mallocSizeOf(this) + sizeOfExcludingThis(mallocSizeOf);
@@ -746,6 +830,17 @@ struct ScriptParseTask : public ParseTask
     void parse(JSContext* cx) override;
 };
 
+// A script parse of UTF-8 source, which the embedding keeps alive.
+struct Utf8ScriptParseTask : public ParseTask
+{
+    const mozilla::Utf8Unit* units;
+    size_t length;
+
+    Utf8ScriptParseTask(JSContext* cx, const mozilla::Utf8Unit* units, size_t length,
+                        JS::OffThreadCompileCallback callback, void* callbackData);
+    void parse(JSContext* cx) override;
+};
+
 struct ModuleParseTask : public ParseTask
 {
     JS::SourceBufferHolder data;
@@ -777,13 +872,54 @@ struct BinASTDecodeTask : public ParseTask
 
 #endif /* JS_BUILD_BINAST */
 
+// Large batches of sources are split into parts which are decoded in parallel,
+// each by its own task in its own zone. The task that was returned as the
+// token decodes the first part. It is reported, with the results of all the
+// parts in source order, once every part has finished.
 struct MultiScriptsDecodeTask : public ParseTask
 {
     JS::TranscodeSources* sources;
 
+    // The range of |sources| decoded by this task.
+    size_t sourcesBegin;
+    size_t sourcesEnd;
+
+    // For the task returned as the token, the tasks decoding the other parts.
+    // These are never put in the finished list.
+    Vector<UniquePtr<MultiScriptsDecodeTask>, 0, SystemAllocPolicy> parts;
+
+    // For the other parts, the task returned as the token.
+    MultiScriptsDecodeTask* whole;
+
+    // For the task returned as the token, the number of parts (including its
+    // own) which have not finished decoding. Protected by the helper thread
+    // lock.
+    size_t unfinishedParts;
+
     MultiScriptsDecodeTask(JSContext* cx, JS::TranscodeSources& sources,
                            JS::OffThreadCompileCallback callback, void* callbackData);
     void parse(JSContext* cx) override;
+
+    // Called when this part has finished decoding. Returns the task to report
+    // if this was the last part to finish, and nullptr otherwise.
+    MultiScriptsDecodeTask* finishPart(const AutoLockHelperThreadState& lock);
+};
+
+// Parses JSON text, as JSON.parse does without a reviver. The value is created
+// in the parse global's zone and moves to the target realm with the rest of
+// its contents.
+struct JSONParseTask : public ParseTask
+{
+    JS::UniqueTwoByteChars chars;
+    size_t length;
+
+    // The parsed value, or undefined if the parse failed.
+    Value result;
+
+    JSONParseTask(JSContext* cx, JS::UniqueTwoByteChars chars, size_t length,
+                  JS::OffThreadCompileCallback callback, void* callbackData);
+    void parse(JSContext* cx) override;
+    void traceResults(JSTracer* trc) override;
 };
 
 // Return whether, if a new parse task was started, it would need to wait for
@@ -817,6 +953,10 @@ class SourceCompressionTask
     // The source to be compressed.
     ScriptSourceHolder sourceHolder_;
 
+    // The codec to compress with, copied from the runtime when the task is
+    // created as the runtime's setting can change while the task is queued.
+    SourceCompressionCodec codec_;
+
     // The resultant compressed string. If the compressed string is larger
     // than the original, or we OOM'd during compression, or nothing else
     // except the task is holding the ScriptSource alive when scheduled to
@@ -828,7 +968,8 @@ class SourceCompressionTask
     SourceCompressionTask(JSRuntime* rt, ScriptSource* source)
       : runtime_(rt),
         majorGCNumber_(rt->gc.majorGCCount()),
-        sourceHolder_(source)
+        sourceHolder_(source),
+        codec_(rt->sourceCompressionCodec())
     { }
 
     bool runtimeMatches(JSRuntime* runtime) const {
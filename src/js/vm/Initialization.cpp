@@ -30,6 +30,7 @@
 #endif
 #include "vm/DateTime.h"
 #include "vm/HelperThreads.h"
+#include "vm/JSScript.h"
 #include "vm/Runtime.h"
 #include "vm/Time.h"
 #include "vm/TraceLogging.h"
@@ -89,6 +90,8 @@ JS::detail::InitWithFailureDiagnostic(bool isDebugBuild)
 
     PRMJ_NowInit();
 
+    js::InstrumentationClock::init();
+
     js::SliceBudget::Init();
 
     // The first invocation of `ProcessCreation` creates a temporary thread
@@ -113,6 +116,8 @@ JS::detail::InitWithFailureDiagnostic(bool isDebugBuild)
 
     RETURN_IF_FAIL(js::Mutex::Init());
 
+    RETURN_IF_FAIL(js::InitSharedBytecodeTable());
+
     RETURN_IF_FAIL(js::wasm::Init());
 
     js::gc::InitMemorySubsystem(); // Ensure gc::SystemPageSize() works.
@@ -174,6 +179,8 @@ JS_ShutDown(void)
 
     js::DestroyHelperThreadsState();
 
+    js::ShutDownSharedBytecodeTable();
+
 #ifdef JS_SIMULATOR
     js::jit::SimulatorProcess::destroy();
 #endif
@@ -188,6 +195,7 @@ JS_ShutDown(void)
     js::wasm::ShutDown();
 
     js::Mutex::ShutDown();
+    js::Mutex::ShutDownContentionProfiling();
 
     // The only difficult-to-address reason for the restriction that you can't
     // call JS_Init/stuff/JS_ShutDown multiple times is the Windows PRMJ
@@ -627,7 +627,13 @@ GetElemOptimizedArguments(JSContext* cx, AbstractFramePtr frame, MutableHandleVa
         if (rref.isInt32()) {
             int32_t i = rref.toInt32();
             if (i >= 0 && uint32_t(i) < frame.numActualArgs()) {
-                res.set(frame.unaliasedActual(i));
+                // Lazy unmapped arguments can coexist with aliased formals,
+                // whose frame slots still hold the values passed in. See
+                // jit::AnalyzeArgumentsUsage.
+                MOZ_ASSERT_IF(frame.script()->hasMappedArgsObj() &&
+                              uint32_t(i) < frame.numFormalArgs(),
+                              !frame.script()->formalIsAliased(i));
+                res.set(frame.unaliasedActual(i, DONT_CHECK_ALIASING));
                 *done = true;
                 return true;
             }
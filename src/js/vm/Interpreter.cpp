@@ -3572,6 +3572,19 @@ CASE(JSOP_OPTIMIZE_SPREADCALL)
 }
 END_CASE(JSOP_OPTIMIZE_SPREADCALL)
 
+CASE(JSOP_OPTIMIZE_DESTRUCTURING)
+{
+    ReservedRooted<Value> val(&rootValue0, REGS.sp[-1]);
+
+    bool optimized = false;
+    if (!OptimizeArrayDestructuring(cx, val, GET_UINT32(REGS.pc), &optimized)) {
+        goto error;
+    }
+
+    PUSH_BOOLEAN(optimized);
+}
+END_CASE(JSOP_OPTIMIZE_DESTRUCTURING)
+
 CASE(JSOP_THROWMSG)
 {
     MOZ_ALWAYS_FALSE(ThrowMsgOperation(cx, GET_UINT16(REGS.pc)));
@@ -3910,15 +3923,56 @@ CASE(JSOP_UNINITIALIZED)
 END_CASE(JSOP_UNINITIALIZED)
 
 CASE(JSOP_GETARG)
+CASE(JSOP_GETLOCAL)
 {
-    unsigned i = GET_ARGNO(REGS.pc);
-    if (script->argsObjAliasesFormals()) {
-        PUSH_COPY(REGS.fp()->argsObj().arg(i));
-    } else {
-        PUSH_COPY(REGS.fp()->unaliasedFormal(i));
-    }
+    /*
+     * Runs of GETARG and GETLOCAL, as when pushing the operands of arithmetic
+     * or the arguments of a call, are executed here without dispatching each
+     * op separately. When interrupts are enabled every op must go through
+     * dispatch, so the run stops after the first op.
+     */
+    do {
+        if (JSOp(*REGS.pc) == JSOP_GETARG) {
+            unsigned i = GET_ARGNO(REGS.pc);
+            if (script->argsObjAliasesFormals()) {
+                PUSH_COPY(REGS.fp()->argsObj().arg(i));
+            } else {
+                PUSH_COPY(REGS.fp()->unaliasedFormal(i));
+            }
+            REGS.pc += JSOP_GETARG_LENGTH;
+        } else {
+            MOZ_ASSERT(JSOp(*REGS.pc) == JSOP_GETLOCAL);
+            uint32_t i = GET_LOCALNO(REGS.pc);
+            PUSH_COPY_SKIP_CHECK(REGS.fp()->unaliasedLocal(i));
+
+#ifdef DEBUG
+            // Derived class constructors store the TDZ Value in the .this slot
+            // before a super() call.
+            if (IsUninitializedLexical(REGS.sp[-1])) {
+                MOZ_ASSERT(script->isDerivedClassConstructor());
+                JSOp next = JSOp(*GetNextPc(REGS.pc));
+                MOZ_ASSERT(next == JSOP_CHECKTHIS || next == JSOP_CHECKRETURN ||
+                           next == JSOP_CHECKTHISREINIT);
+            }
+#endif
+
+            /*
+             * Skip the same-compartment assertion if the local will be
+             * immediately popped. We do not guarantee sync for dead locals
+             * when coming in from the method JIT, and a GETLOCAL followed by
+             * POP is not considered to be a use of the variable.
+             */
+            if (REGS.pc[JSOP_GETLOCAL_LENGTH] != JSOP_POP) {
+                cx->debugOnlyCheck(REGS.sp[-1]);
+            }
+            REGS.pc += JSOP_GETLOCAL_LENGTH;
+        }
+        SANITY_CHECKS();
+    } while ((JSOp(*REGS.pc) == JSOP_GETARG || JSOp(*REGS.pc) == JSOP_GETLOCAL) &&
+             !activation.opMask());
+
+    DISPATCH_TO(*REGS.pc | activation.opMask());
 }
-END_CASE(JSOP_GETARG)
 
 CASE(JSOP_SETARG)
 {
@@ -3931,33 +3985,6 @@ CASE(JSOP_SETARG)
 }
 END_CASE(JSOP_SETARG)
 
-CASE(JSOP_GETLOCAL)
-{
-    uint32_t i = GET_LOCALNO(REGS.pc);
-    PUSH_COPY_SKIP_CHECK(REGS.fp()->unaliasedLocal(i));
-
-#ifdef DEBUG
-    // Derived class constructors store the TDZ Value in the .this slot
-    // before a super() call.
-    if (IsUninitializedLexical(REGS.sp[-1])) {
-        MOZ_ASSERT(script->isDerivedClassConstructor());
-        JSOp next = JSOp(*GetNextPc(REGS.pc));
-        MOZ_ASSERT(next == JSOP_CHECKTHIS || next == JSOP_CHECKRETURN || next == JSOP_CHECKTHISREINIT);
-    }
-#endif
-
-    /*
-     * Skip the same-compartment assertion if the local will be immediately
-     * popped. We do not guarantee sync for dead locals when coming in from the
-     * method JIT, and a GETLOCAL followed by POP is not considered to be
-     * a use of the variable.
-     */
-    if (REGS.pc[JSOP_GETLOCAL_LENGTH] != JSOP_POP) {
-        cx->debugOnlyCheck(REGS.sp[-1]);
-    }
-}
-END_CASE(JSOP_GETLOCAL)
-
 CASE(JSOP_SETLOCAL)
 {
     uint32_t i = GET_LOCALNO(REGS.pc);
@@ -5505,6 +5532,35 @@ js::OptimizeSpreadCall(JSContext* cx, HandleValue arg, bool* optimized)
     return stubChain->tryOptimizeArray(cx, obj.as<ArrayObject>(), optimized);
 }
 
+bool
+js::OptimizeArrayDestructuring(JSContext* cx, HandleValue arg, uint32_t count, bool* optimized)
+{
+    // Array destructuring of the first |count| elements can read them by
+    // index, without creating an iterator, when the conditions for
+    // OptimizeSpreadCall are met and in addition:
+    //   * the array has at least |count| elements, so every element read
+    //     is in bounds
+    //   * %ArrayIteratorPrototype% does not have or inherit a 'return'
+    //     method, so not closing the iterator is unobservable
+    if (!arg.isObject()) {
+        *optimized = false;
+        return true;
+    }
+
+    RootedObject obj(cx, &arg.toObject());
+    if (!IsPackedArray(obj) || obj->as<ArrayObject>().length() < count) {
+        *optimized = false;
+        return true;
+    }
+
+    ForOfPIC::Chain* stubChain = ForOfPIC::getOrCreate(cx);
+    if (!stubChain) {
+        return false;
+    }
+
+    return stubChain->tryOptimizeArrayDestructuring(cx, obj.as<ArrayObject>(), optimized);
+}
+
 JSObject*
 js::NewObjectOperation(JSContext* cx, HandleScript script, jsbytecode* pc,
                        NewObjectKind newKind /* = GenericObject */)
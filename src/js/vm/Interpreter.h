@@ -540,6 +540,9 @@ SpreadCallOperation(JSContext* cx, HandleScript script, jsbytecode* pc, HandleVa
 bool
 OptimizeSpreadCall(JSContext* cx, HandleValue arg, bool* optimized);
 
+bool
+OptimizeArrayDestructuring(JSContext* cx, HandleValue arg, uint32_t count, bool* optimized);
+
 JSObject*
 NewObjectOperation(JSContext* cx, HandleScript script, jsbytecode* pc,
                    NewObjectKind newKind = GenericObject);
@@ -795,6 +795,38 @@ NativeIterator::NativeIterator(JSContext* cx, Handle<PropertyIteratorObject*> pr
     MOZ_ASSERT(!*hadError);
 }
 
+NativeIterator::NativeIterator(Handle<PropertyIteratorObject*> propIter,
+                               Handle<JSObject*> objBeingIterated, const NativeIterator& cached)
+  : objectBeingIterated_(objBeingIterated),
+    iterObj_(propIter),
+    guardsEnd_(guardsBegin()),
+    propertyCursor_(reinterpret_cast<GCPtrFlatString*>(guardsBegin() + cached.guardCount())),
+    propertiesEnd_(propertyCursor_),
+    guardKey_(cached.guardKey()),
+    flags_(0) // note: no Flags::Initialized
+{
+    MOZ_ASSERT(!cached.hasUnvisitedPropertyDeletion());
+
+    propIter->setNativeIterator(this);
+
+    // As in the constructor above, grow the counts before each construction
+    // so the GC always knows about everything that has been initialized.
+    for (GCPtrFlatString* str = cached.propertiesBegin(); str < cached.propertiesEnd(); str++) {
+        GCPtrFlatString* loc = propertiesEnd_;
+        propertiesEnd_++;
+        new (loc) GCPtrFlatString(*str);
+    }
+
+    for (HeapReceiverGuard* guard = cached.guardsBegin(); guard < cached.guardsEnd(); guard++) {
+        HeapReceiverGuard* loc = guardsEnd_;
+        guardsEnd_++;
+        new (loc) HeapReceiverGuard(ReceiverGuard(*guard));
+    }
+
+    MOZ_ASSERT(static_cast<void*>(guardsEnd_) == propertyCursor_);
+    markInitialized();
+}
+
 static inline PropertyIteratorObject*
 VectorToKeyIterator(JSContext* cx, HandleObject obj, AutoIdVector& props, uint32_t numGuards)
 {
@@ -850,8 +882,10 @@ CanCompareIterableObjectToCache(JSObject* obj)
 
 using ReceiverGuardVector = Vector<ReceiverGuard, 8>;
 
+// Return the cached iterator for objects with the same shapes and prototypes
+// as |obj|, whether or not it is reusable.
 static MOZ_ALWAYS_INLINE PropertyIteratorObject*
-LookupInIteratorCache(JSContext* cx, JSObject* obj, uint32_t* numGuards)
+LookupCachedIterator(JSContext* cx, JSObject* obj, uint32_t* numGuards)
 {
     MOZ_ASSERT(*numGuards == 0);
 
@@ -885,15 +919,51 @@ LookupInIteratorCache(JSContext* cx, JSObject* obj, uint32_t* numGuards)
 
     PropertyIteratorObject* iterobj = *p;
     MOZ_ASSERT(iterobj->compartment() == cx->compartment());
+    return iterobj;
+}
 
-    NativeIterator* ni = iterobj->getNativeIterator();
-    if (!ni->isReusable()) {
+static MOZ_ALWAYS_INLINE PropertyIteratorObject*
+LookupInIteratorCache(JSContext* cx, JSObject* obj, uint32_t* numGuards)
+{
+    PropertyIteratorObject* iterobj = LookupCachedIterator(cx, obj, numGuards);
+    if (!iterobj || !iterobj->getNativeIterator()->isReusable()) {
         return nullptr;
     }
-
     return iterobj;
 }
 
+// Create an iterator for |obj| from the properties of |cachedIterobj|, the
+// cached iterator for its shapes, when the cached iterator is in use. This is
+// common when walking objects nested in objects of the same shape, and avoids
+// enumerating |obj| again.
+static PropertyIteratorObject*
+CopyCachedIterator(JSContext* cx, HandleObject obj, PropertyIteratorObject* cachedIterobj)
+{
+    Rooted<PropertyIteratorObject*> cached(cx, cachedIterobj);
+
+    if (obj->isSingleton() && !JSObject::setIteratedSingleton(cx, obj)) {
+        return nullptr;
+    }
+    MarkObjectGroupFlags(cx, obj, OBJECT_FLAG_ITERATED);
+
+    Rooted<PropertyIteratorObject*> propIter(cx, NewPropertyIteratorObject(cx));
+    if (!propIter) {
+        return nullptr;
+    }
+
+    const NativeIterator* cachedNi = cached->getNativeIterator();
+    size_t extraCount = cachedNi->numKeys() + cachedNi->guardCount() * 2;
+    void* mem = cx->pod_malloc_with_extra<NativeIterator, GCPtrFlatString>(extraCount);
+    if (!mem) {
+        return nullptr;
+    }
+
+    // This also registers |ni| with |propIter|.
+    NativeIterator* ni = new (mem) NativeIterator(propIter, obj, *cachedNi);
+    RegisterEnumerator(ObjectRealm::get(obj), ni);
+    return propIter;
+}
+
 static bool
 CanStoreInIteratorCache(JSObject* obj)
 {
@@ -955,11 +1025,19 @@ JSObject*
 js::GetIterator(JSContext* cx, HandleObject obj)
 {
     uint32_t numGuards = 0;
-    if (PropertyIteratorObject* iterobj = LookupInIteratorCache(cx, obj, &numGuards)) {
+    if (PropertyIteratorObject* iterobj = LookupCachedIterator(cx, obj, &numGuards)) {
         NativeIterator* ni = iterobj->getNativeIterator();
-        ni->changeObjectBeingIterated(*obj);
-        RegisterEnumerator(ObjectRealm::get(obj), ni);
-        return iterobj;
+        if (ni->isReusable()) {
+            ni->changeObjectBeingIterated(*obj);
+            RegisterEnumerator(ObjectRealm::get(obj), ni);
+            return iterobj;
+        }
+
+        // Leave the cached iterator in the cache, it will usually be reusable
+        // again once the loop using it ends.
+        if (!ni->hasUnvisitedPropertyDeletion()) {
+            return CopyCachedIterator(cx, obj, iterobj);
+        }
     }
 
     if (numGuards > 0 && !CanStoreInIteratorCache(obj)) {
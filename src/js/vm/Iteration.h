@@ -114,6 +114,15 @@ struct NativeIterator
                    Handle<JSObject*> objBeingIterated, const AutoIdVector& props,
                    uint32_t numGuards, uint32_t guardKey, bool* hadError);
 
+    /**
+     * Initialize a NativeIterator for |objBeingIterated|, allocated like the
+     * cached iterator |cached|, with the same properties and guards. The
+     * iterator cache must have matched |cached| to |objBeingIterated|. This
+     * can't fail.
+     */
+    NativeIterator(Handle<PropertyIteratorObject*> propIter, Handle<JSObject*> objBeingIterated,
+                   const NativeIterator& cached);
+
     /** Initialize an |ObjectRealm::enumerators| sentinel. */
     NativeIterator();
 
@@ -280,6 +289,12 @@ struct NativeIterator
         return flags_ == Flags::Initialized;
     }
 
+    bool hasUnvisitedPropertyDeletion() const {
+        MOZ_ASSERT(isInitialized());
+
+        return flags_ & Flags::HasUnvisitedPropertyDeletion;
+    }
+
     void markHasUnvisitedPropertyDeletion() {
         MOZ_ASSERT(isInitialized());
 
@@ -12,6 +12,7 @@
 
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/EndianUtils.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/RangedPtr.h"
 #include "mozilla/Unused.h"
 
@@ -276,8 +277,168 @@ class AtomsTable::AutoLock
     }
 };
 
+ConcurrentAtomIndex::ConcurrentAtomIndex()
+  : table_(nullptr),
+    count_(0)
+{}
+
+ConcurrentAtomIndex::~ConcurrentAtomIndex()
+{
+    Table* table = table_;
+    js_delete(table);
+    freeRetiredTables();
+}
+
+/* static */ ConcurrentAtomIndex::Table*
+ConcurrentAtomIndex::newTable(uint32_t capacity)
+{
+    MOZ_ASSERT(mozilla::IsPowerOfTwo(capacity));
+
+    Table* table = js_new<Table>(capacity);
+    if (!table) {
+        return nullptr;
+    }
+
+    // Zeroed slots are empty.
+    table->slots.reset(js_pod_calloc<Slot>(capacity));
+    if (!table->slots) {
+        js_delete(table);
+        return nullptr;
+    }
+
+    return table;
+}
+
+/* static */ void
+ConcurrentAtomIndex::insert(Table* table, JSAtom* atom)
+{
+    uint32_t mask = table->capacity - 1;
+    for (uint32_t i = atom->hash() & mask; ; i = (i + 1) & mask) {
+        if (!table->slots[i]) {
+            table->slots[i] = atom;
+            return;
+        }
+    }
+}
+
+void
+ConcurrentAtomIndex::freeRetiredTables()
+{
+    for (Table* table : retired_) {
+        js_delete(table);
+    }
+    retired_.clearAndFree();
+}
+
+bool
+ConcurrentAtomIndex::init()
+{
+    Table* table = newTable(InitialCapacity);
+    if (!table) {
+        return false;
+    }
+
+    table_ = table;
+    return true;
+}
+
+MOZ_ALWAYS_INLINE JSAtom*
+ConcurrentAtomIndex::lookup(const AtomHasher::Lookup& lookup) const
+{
+    // The table is never more than 3/4 full, so the probe finds an empty slot
+    // if the atom isn't there.
+    const Table* table = table_;
+    uint32_t mask = table->capacity - 1;
+    for (uint32_t i = lookup.hash & mask; ; i = (i + 1) & mask) {
+        JSAtom* atom = table->slots[i];
+        if (!atom) {
+            return nullptr;
+        }
+        if (AtomHasher::match(AtomStateEntry(atom, false), lookup)) {
+            return atom;
+        }
+    }
+}
+
+void
+ConcurrentAtomIndex::add(JSRuntime* rt, JSAtom* atom)
+{
+    Table* table = table_;
+    if ((count_ + 1) * 4 > table->capacity * 3) {
+        Table* grown = newTable(table->capacity * 2);
+        if (!grown) {
+            return;
+        }
+
+        for (uint32_t i = 0; i < table->capacity; i++) {
+            if (JSAtom* existing = table->slots[i]) {
+                insert(grown, existing);
+            }
+        }
+
+        // Only helper threads in other zones can be reading the old table.
+        // Helper thread zones are created on the main thread, so this can't
+        // change under us: if we're on a helper thread, there are some.
+        bool canFreeOldTable = !rt->hasHelperThreadZones();
+        if (!canFreeOldTable && !retired_.append(table)) {
+            js_delete(grown);
+            return;
+        }
+
+        table_ = grown;
+        if (canFreeOldTable) {
+            js_delete(table);
+            freeRetiredTables();
+        }
+        table = grown;
+    }
+
+    insert(table, atom);
+    count_++;
+}
+
+void
+ConcurrentAtomIndex::rebuild(const AtomSet& atoms)
+{
+    freeRetiredTables();
+
+    Table* table = table_;
+    uint32_t capacity = uint32_t(Max(size_t(InitialCapacity),
+                                     mozilla::RoundUpPow2(size_t(atoms.count()) * 2)));
+    Table* resized = capacity != table->capacity ? newTable(capacity) : nullptr;
+    if (resized) {
+        js_delete(table);
+        table_ = table = resized;
+    } else {
+        for (uint32_t i = 0; i < table->capacity; i++) {
+            table->slots[i] = nullptr;
+        }
+    }
+    count_ = 0;
+
+    for (auto r = atoms.all(); !r.empty(); r.popFront()) {
+        if ((count_ + 1) * 4 > table->capacity * 3) {
+            break;
+        }
+        insert(table, r.front().asPtrUnbarriered());
+        count_++;
+    }
+}
+
+size_t
+ConcurrentAtomIndex::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const
+{
+    const Table* table = table_;
+    size_t size = mallocSizeOf(table) + mallocSizeOf(table->slots.get());
+    for (const Table* retired : retired_) {
+        size += mallocSizeOf(retired) + mallocSizeOf(retired->slots.get());
+    }
+    return size + retired_.sizeOfExcludingThis(mallocSizeOf);
+}
+
 AtomsTable::Partition::Partition(uint32_t index)
-  : lock(MutexId { mutexid::AtomsTable.name, mutexid::AtomsTable.order + index }),
+  : lock(MutexId { mutexid::AtomsTable.name, mutexid::AtomsTable.order + index,
+                   mutexid::AtomsTable.index }),
     atoms(InitialTableSize),
     atomsAddedWhileSweeping(nullptr)
 {}
@@ -299,7 +460,7 @@ AtomsTable::init()
 {
     for (size_t i = 0; i < PartitionCount; i++) {
         partitions[i] = js_new<Partition>(i);
-        if (!partitions[i]) {
+        if (!partitions[i] || !partitions[i]->index.init()) {
             return false;
         }
     }
@@ -438,6 +599,7 @@ AtomsTable::sweepAll(JSRuntime* rt)
                 e.removeFront();
             }
         }
+        partitions[i]->index.rebuild(atoms);
     }
 }
 
@@ -554,6 +716,8 @@ AtomsTable::mergeAtomsAddedWhileSweeping(Partition& part)
     }
 
     js_delete(newAtoms);
+
+    part.index.rebuild(part.atoms);
 }
 
 bool
@@ -587,6 +751,7 @@ AtomsTable::sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const
     for (size_t i = 0; i < PartitionCount; i++) {
         size += sizeof(Partition);
         size += partitions[i]->atoms.shallowSizeOfExcludingThis(mallocSizeOf);
+        size += partitions[i]->index.sizeOfExcludingThis(mallocSizeOf);
     }
     return size;
 }
@@ -708,6 +873,17 @@ AtomsTable::atomizeAndCopyChars(JSContext* cx,
                                 const AtomHasher::Lookup& lookup)
 {
     Partition& part = *partitions[getPartitionIndex(lookup)];
+
+    // Look for an existing atom without taking the lock first. Helper threads
+    // never see the atoms being swept, as they wait for atoms zone GCs.
+    if (!part.atomsAddedWhileSweeping) {
+        if (JSAtom* atom = part.index.lookup(lookup)) {
+            if (!pin || atom->isPinned()) {
+                return AtomStateEntry(atom, false).asPtr(cx);
+            }
+        }
+    }
+
     AutoLock lock(cx->runtime(), part.lock);
 
     AtomSet& atoms = part.atoms;
@@ -756,6 +932,11 @@ AtomsTable::atomizeAndCopyChars(JSContext* cx,
         return nullptr;
     }
 
+    // Atoms added while sweeping are indexed when the sets are merged.
+    if (addSet == &atoms) {
+        part.index.add(cx->runtime(), atom);
+    }
+
     return atom;
 }
 
@@ -34,6 +34,7 @@
 
 #include "builtin/String.h"
 #include "gc/FreeOp.h"
+#include "gc/Memory.h"
 #include "gc/Marking.h"
 #include "jit/Ion.h"
 #include "jit/PcScriptCache.h"
@@ -58,6 +59,8 @@
 #include "vm/JSScript.h"
 #include "vm/Realm.h"
 #include "vm/Shape.h"
+#include "vm/StackSampler.h"
+#include "wasm/WasmSignalHandlers.h"
 
 #include "vm/Compartment-inl.h"
 #include "vm/JSObject-inl.h"
@@ -127,6 +130,10 @@ JSContext::init(ContextKind kind)
         if (!wasm::EnsureSignalHandlers(this)) {
             return false;
         }
+
+        if (!initInterruptPollPage()) {
+            return false;
+        }
     } else {
         atomsZoneFreeLists_ = js_new<gc::FreeLists>();
         if (!atomsZoneFreeLists_) {
@@ -141,6 +148,45 @@ JSContext::init(ContextKind kind)
     return true;
 }
 
+bool
+JSContext::initInterruptPollPage()
+{
+#ifdef JS_CODEGEN_X64
+    // The fault handler is part of the wasm signal handlers. Faults while
+    // recording or replaying would have to happen at the same points in
+    // every execution, which interrupts don't.
+    if (!wasm::HaveSignalHandlers() || mozilla::recordreplay::IsRecordingOrReplaying()) {
+        return true;
+    }
+
+    size_t size = gc::SystemAllocGranularity();
+    interruptPollPage_ = gc::MapAlignedPages(size, size);
+    if (!interruptPollPage_) {
+        return false;
+    }
+    gc::MakePagesReadOnly(interruptPollPage_, size);
+#endif
+    return true;
+}
+
+void
+JSContext::resetInterruptPoll()
+{
+    if (!interruptPollPage_) {
+        return;
+    }
+
+    size_t size = gc::SystemAllocGranularity();
+    gc::MakePagesReadOnly(interruptPollPage_, size);
+
+    // requestInterrupt sets interruptBits_ before it protects the page, so if
+    // it ran since the bits were cleared, protect the page again in case its
+    // protection came before ours was removed.
+    if (hasAnyPendingInterrupt()) {
+        gc::ProtectPages(interruptPollPage_, size);
+    }
+}
+
 JSContext*
 js::NewContext(uint32_t maxBytes, uint32_t maxNurseryBytes, JSRuntime* parentRuntime)
 {
@@ -1378,6 +1424,7 @@ JSContext::JSContext(JSRuntime* runtime, const JS::ContextOptions& options)
     ionReturnOverride_(MagicValue(JS_ARG_POISON)),
     jitStackLimit(UINTPTR_MAX),
     jitStackLimitNoInterrupt(UINTPTR_MAX),
+    interruptPollPage_(nullptr),
     getIncumbentGlobalCallback(nullptr),
     enqueuePromiseJobCallback(nullptr),
     enqueuePromiseJobCallbackData(nullptr),
@@ -1386,7 +1433,8 @@ JSContext::JSContext(JSRuntime* runtime, const JS::ContextOptions& options)
     stopDrainingJobQueue(false),
     canSkipEnqueuingJobs(false),
     promiseRejectionTrackerCallback(nullptr),
-    promiseRejectionTrackerCallbackData(nullptr)
+    promiseRejectionTrackerCallbackData(nullptr),
+    stackSampler(nullptr)
 {
     MOZ_ASSERT(static_cast<JS::RootingContext*>(this) ==
                JS::RootingContext::get(this));
@@ -1419,6 +1467,10 @@ JSContext::~JSContext()
     js::jit::Simulator::Destroy(simulator_);
 #endif
 
+    if (interruptPollPage_) {
+        gc::UnmapPages(interruptPollPage_, gc::SystemAllocGranularity());
+    }
+
 #ifdef JS_TRACE_LOGGING
     if (traceLogger) {
         DestroyTraceLogger(traceLogger);
@@ -1427,6 +1479,9 @@ JSContext::~JSContext()
 
     js_delete(atomsZoneFreeLists_.ref());
 
+    // The destructor stops the sampler thread.
+    js_delete(stackSampler.ref());
+
     MOZ_ASSERT(TlsContext.get() == this);
     TlsContext.set(nullptr);
 }
@@ -36,6 +36,7 @@ class DebugModeOSRVolatileJitFrameIter;
 namespace gc {
 class AutoCheckCanAccessAtomsDuringGC;
 class AutoSuppressNurseryCellAlloc;
+class StackSampler;
 }
 
 typedef HashSet<Shape*> ShapeSet;
@@ -99,6 +100,8 @@ enum class InterruptReason : uint32_t
     AttachIonCompilations = 1 << 1,
     CallbackUrgent = 1 << 2,
     CallbackCanWait = 1 << 3,
+    Sample = 1 << 4,
+    CpuSample = 1 << 5,
 };
 
 } /* namespace js */
@@ -630,10 +633,17 @@ struct JSContext : public JS::RootingContext,
     static const size_t TEMP_LIFO_ALLOC_PRIMARY_CHUNK_SIZE = 4 * 1024;
   private:
     js::ThreadData<js::LifoAlloc> tempLifoAlloc_;
+
+    // Memory of the LifoAlloc chunks freed on this thread, for reuse by the
+    // next LifoAllocs that need one.
+    js::ThreadData<js::LifoChunkPool> lifoChunkPool_;
   public:
     js::LifoAlloc& tempLifoAlloc() { return tempLifoAlloc_.ref(); }
     const js::LifoAlloc& tempLifoAlloc() const { return tempLifoAlloc_.ref(); }
 
+    js::LifoChunkPool& lifoChunkPool() { return lifoChunkPool_.ref(); }
+    const js::LifoChunkPool& lifoChunkPool() const { return lifoChunkPool_.ref(); }
+
     js::ThreadData<uint32_t> debuggerMutations;
 
     // Cache for jit::GetPcScript().
@@ -850,6 +860,28 @@ struct JSContext : public JS::RootingContext,
     void requestInterrupt(js::InterruptReason reason);
     bool handleInterrupt();
 
+    // Ion code polls for interrupts at loop heads by reading this page,
+    // rather than testing interruptBits_: requestInterrupt makes the page
+    // inaccessible, and the fault handler resumes the faulting poll at its
+    // out of line interrupt check, so the polls cost a load and no branch.
+    // Null when the platform doesn't support polls, in which case Ion code
+    // tests interruptBits_.
+    void* interruptPollPage() const {
+        return interruptPollPage_;
+    }
+
+    // Make the poll page readable again, unless another interrupt has been
+    // requested.
+    void resetInterruptPoll();
+
+  private:
+    bool initInterruptPollPage();
+
+    // Set by init, before the context runs any JS, and only read after.
+    void* interruptPollPage_;
+
+  public:
+
     MOZ_ALWAYS_INLINE bool hasAnyPendingInterrupt() const {
         static_assert(sizeof(interruptBits_) == sizeof(uint32_t), "Assumed by JIT callers");
         return interruptBits_ != 0;
@@ -929,6 +961,9 @@ struct JSContext : public JS::RootingContext,
     js::ThreadData<JSPromiseRejectionTrackerCallback> promiseRejectionTrackerCallback;
     js::ThreadData<void*> promiseRejectionTrackerCallbackData;
 
+    // The sampling profiler started by js::StartStackSampling, if any.
+    js::ThreadData<js::StackSampler*> stackSampler;
+
     JSObject* getIncumbentGlobal(JSContext* cx);
     bool enqueuePromiseJob(JSContext* cx, js::HandleFunction job, js::HandleObject promise,
                            js::HandleObject incumbentGlobal);
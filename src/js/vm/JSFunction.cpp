@@ -1409,8 +1409,18 @@ JSFunction::isDerivedClassConstructor()
 JSFunction::getLength(JSContext* cx, HandleFunction fun, uint16_t* length)
 {
     MOZ_ASSERT(!fun->isBoundFunction());
-    if (fun->isInterpretedLazy() && !getOrCreateScript(cx, fun)) {
-        return false;
+
+    // Don't compile a lazy function only to read its length, as binding a
+    // function or reading its length property would otherwise do.
+    if (fun->isInterpretedLazy()) {
+        LazyScript* lazy = fun->lazyScriptOrNull();
+        if (lazy && !lazy->isBinAST()) {
+            *length = lazy->funLength();
+            return true;
+        }
+        if (!getOrCreateScript(cx, fun)) {
+            return false;
+        }
     }
 
     *length = fun->isNative() ? fun->nargs() : fun->nonLazyScript()->funLength();
@@ -1793,9 +1803,14 @@ JSFunction::createScriptForLazilyInterpretedFunction(JSContext* cx, HandleFuncti
                     return false;
                 }
 
-                // XXX There are no UTF-8 ScriptSources now, so just crash so this
-                //     gets filled in later.
-                MOZ_CRASH("UTF-8 lazy function compilation not implemented yet");
+                if (!frontend::CompileLazyFunction(cx, lazy, units.get(), lazyLength)) {
+                    // The frontend shouldn't fail after linking the function and the
+                    // non-lazy script together.
+                    MOZ_ASSERT(fun->isInterpretedLazy());
+                    MOZ_ASSERT(fun->lazyScript() == lazy);
+                    MOZ_ASSERT(!lazy->hasScript());
+                    return false;
+                }
             } else {
                 MOZ_ASSERT(lazy->scriptSource()->hasSourceType<char16_t>());
 
@@ -1938,6 +1953,48 @@ const JSFunctionSpec js::function_methods[] = {
     // clang-format on
 };
 
+static bool
+CompileDynamicFunctionText(JSContext* cx, MutableHandleFunction fun, const CompileOptions& options,
+                           HandleString functionText, const Maybe<uint32_t>& parameterListEnd,
+                           bool isGenerator, bool isAsync)
+{
+    using namespace frontend;
+
+    AutoStableStringChars stableChars(cx);
+    if (!stableChars.initTwoByte(cx, functionText)) {
+        return false;
+    }
+
+    mozilla::Range<const char16_t> chars = stableChars.twoByteRange();
+    SourceBufferHolder::Ownership ownership = stableChars.maybeGiveOwnershipToCaller()
+                                              ? SourceBufferHolder::GiveOwnership
+                                              : SourceBufferHolder::NoOwnership;
+    SourceBufferHolder srcBuf(chars.begin().get(), chars.length(), ownership);
+    if (isAsync) {
+        if (isGenerator) {
+            if (!CompileStandaloneAsyncGenerator(cx, fun, options, srcBuf, parameterListEnd)) {
+                return false;
+            }
+        } else {
+            if (!CompileStandaloneAsyncFunction(cx, fun, options, srcBuf, parameterListEnd)) {
+                return false;
+            }
+        }
+    } else {
+        if (isGenerator) {
+            if (!CompileStandaloneGenerator(cx, fun, options, srcBuf, parameterListEnd)) {
+                return false;
+            }
+        } else {
+            if (!CompileStandaloneFunction(cx, fun, options, srcBuf, parameterListEnd)) {
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
 // ES2018 draft rev 2aea8f3e617b49df06414eb062ab44fad87661d3
 // 19.2.1.1.1 CreateDynamicFunction( constructor, newTarget, kind, args )
 static bool
@@ -2091,54 +2148,51 @@ CreateDynamicFunction(JSContext* cx, const CallArgs& args, GeneratorKind generat
 
     // Step 30-37 (reordered).
     RootedObject globalLexical(cx, &global->lexicalEnvironment());
-    JSFunction::Flags flags = (isGenerator || isAsync)
-                              ? JSFunction::INTERPRETED_LAMBDA_GENERATOR_OR_ASYNC
-                              : JSFunction::INTERPRETED_LAMBDA;
     gc::AllocKind allocKind = isAsync ? gc::AllocKind::FUNCTION_EXTENDED
                                       : gc::AllocKind::FUNCTION;
-    RootedFunction fun(cx, NewFunctionWithProto(cx, nullptr, 0,
-                                                flags, globalLexical,
-                                                anonymousAtom, defaultProto,
-                                                allocKind, TenuredObject));
-    if (!fun) {
-        return false;
-    }
-
-    if (!JSFunction::setTypeForScriptedFunction(cx, fun)) {
-        return false;
-    }
 
-    // Steps 7.a-b, 8.a-b, 9.a-b, 16-28.
-    AutoStableStringChars stableChars(cx);
-    if (!stableChars.initTwoByte(cx, functionText)) {
-        return false;
+    // The text determines the kind of function, so a function compiled from
+    // the same text with the same options is cloned instead of parsing the
+    // text again.
+    CompilationCache& cache = cx->caches().compilationCache;
+    RootedFunction fun(cx);
+    {
+        CompilationCacheLookup lookup(&functionText->asLinear(), cx->realm(), filename,
+                                      CompilationCacheKind::Function, mutedErrors);
+        fun = cache.lookupFunction(lookup);
     }
 
-    mozilla::Range<const char16_t> chars = stableChars.twoByteRange();
-    SourceBufferHolder::Ownership ownership = stableChars.maybeGiveOwnershipToCaller()
-                                              ? SourceBufferHolder::GiveOwnership
-                                              : SourceBufferHolder::NoOwnership;
-    SourceBufferHolder srcBuf(chars.begin().get(), chars.length(), ownership);
-    if (isAsync) {
-        if (isGenerator) {
-            if (!CompileStandaloneAsyncGenerator(cx, &fun, options, srcBuf, parameterListEnd)) {
-                return false;
-            }
-        } else {
-            if (!CompileStandaloneAsyncFunction(cx, &fun, options, srcBuf, parameterListEnd)) {
-                return false;
-            }
+    if (fun) {
+        RootedScope emptyGlobalScope(cx, &global->emptyGlobalScope());
+        fun = CloneFunctionAndScript(cx, fun, globalLexical, emptyGlobalScope, allocKind);
+        if (!fun) {
+            return false;
         }
     } else {
-        if (isGenerator) {
-            if (!CompileStandaloneGenerator(cx, &fun, options, srcBuf, parameterListEnd)) {
-                return false;
-            }
-        } else {
-            if (!CompileStandaloneFunction(cx, &fun, options, srcBuf, parameterListEnd)) {
-                return false;
-            }
+        JSFunction::Flags flags = (isGenerator || isAsync)
+                                  ? JSFunction::INTERPRETED_LAMBDA_GENERATOR_OR_ASYNC
+                                  : JSFunction::INTERPRETED_LAMBDA;
+        fun = NewFunctionWithProto(cx, nullptr, 0, flags, globalLexical, anonymousAtom,
+                                   defaultProto, allocKind, TenuredObject);
+        if (!fun) {
+            return false;
+        }
+
+        if (!JSFunction::setTypeForScriptedFunction(cx, fun)) {
+            return false;
         }
+
+        // Steps 7.a-b, 8.a-b, 9.a-b, 16-28.
+        if (!CompileDynamicFunctionText(cx, &fun, options, functionText, parameterListEnd,
+                                        isGenerator, isAsync))
+        {
+            return false;
+        }
+
+        // Compiling may have moved the string out of the nursery.
+        CompilationCacheLookup lookup(&functionText->asLinear(), cx->realm(), filename,
+                                      CompilationCacheKind::Function, mutedErrors);
+        cache.add(lookup, nullptr, fun);
     }
 
     // Steps 6, 29.
@@ -6,21 +6,32 @@
 
 #include "vm/JSONParser.h"
 
+#include "mozilla/EndianUtils.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/Range.h"
 #include "mozilla/RangedPtr.h"
 #include "mozilla/Sprintf.h"
 #include "mozilla/TextUtils.h"
 
 #include <ctype.h>
+#include <string.h>
 
 #include "jsnum.h"
 
 #include "builtin/Array.h"
+#include "gc/Tracer.h"
 #include "util/StringBuffer.h"
+#include "vm/ErrorReporting.h"
 #include "vm/Realm.h"
+#include "vm/Shape.h"
 
 #include "vm/NativeObject-inl.h"
 
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define JS_JSONPARSER_SSE2
+#  include <emmintrin.h>
+#endif
+
 using namespace js;
 
 using mozilla::IsAsciiDigit;
@@ -55,6 +66,11 @@ JSONParserBase::trace(JSTracer* trc)
             elem.properties().trace(trc);
         }
     }
+
+    for (ObjectLayout& layout : objectLayouts) {
+        TraceNullableRoot(trc, &layout.group, "JSONParser layout group");
+        TraceNullableRoot(trc, &layout.shape, "JSONParser layout shape");
+    }
 }
 
 template <typename CharT>
@@ -80,6 +96,23 @@ JSONParser<CharT>::getTextPosition(uint32_t* column, uint32_t* line)
     *line = row;
 }
 
+static void
+ReportOffThreadError(JSContext* cx, unsigned errorNumber, ...)
+{
+    ErrorMetadata metadata;
+    metadata.filename = nullptr;
+    metadata.lineNumber = 0;
+    metadata.columnNumber = 0;
+    metadata.lineLength = 0;
+    metadata.tokenOffset = 0;
+    metadata.isMuted = false;
+
+    va_list args;
+    va_start(args, errorNumber);
+    ReportCompileError(cx, std::move(metadata), nullptr, JSREPORT_ERROR, errorNumber, args);
+    va_end(args);
+}
+
 template <typename CharT>
 void
 JSONParser<CharT>::error(const char* msg)
@@ -94,8 +127,14 @@ JSONParser<CharT>::error(const char* msg)
         char lineNumber[MaxWidth];
         SprintfLiteral(lineNumber, "%" PRIu32, line);
 
-        JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_JSON_BAD_PARSE,
-                                  msg, lineNumber, columnNumber);
+        // Off thread parses can't create the exception, so the error is saved
+        // and reported when the parse is finished.
+        if (cx->helperThread()) {
+            ReportOffThreadError(cx, JSMSG_JSON_BAD_PARSE, msg, lineNumber, columnNumber);
+        } else {
+            JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_JSON_BAD_PARSE,
+                                      msg, lineNumber, columnNumber);
+        }
     }
 }
 
@@ -105,6 +144,154 @@ JSONParserBase::errorReturn()
     return errorHandling == NoError;
 }
 
+static inline bool
+IsJSONWhitespace(char16_t c)
+{
+    return c == '\t' || c == '\r' || c == '\n' || c == ' ';
+}
+
+static inline bool
+IsJSONStringSpecial(char16_t c)
+{
+    return c == '"' || c == '\\' || c <= 0x001F;
+}
+
+/*
+ * Vectorized scanning for the long runs of plain string chars and whitespace
+ * in large inputs. Each of these returns a mask with sizeof(CharT) bits set
+ * for each of the chars at |p| which the scan stops at.
+ */
+#ifdef JS_JSONPARSER_SSE2
+
+static MOZ_ALWAYS_INLINE uint32_t
+StringSpecialMask(const Latin1Char* p)
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i special = _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('"')),
+                                   _mm_cmpeq_epi8(v, _mm_set1_epi8('\\')));
+    __m128i control = _mm_cmpeq_epi8(_mm_subs_epu8(v, _mm_set1_epi8(0x1F)),
+                                     _mm_setzero_si128());
+    return uint32_t(_mm_movemask_epi8(_mm_or_si128(special, control)));
+}
+
+static MOZ_ALWAYS_INLINE uint32_t
+StringSpecialMask(const char16_t* p)
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i special = _mm_or_si128(_mm_cmpeq_epi16(v, _mm_set1_epi16('"')),
+                                   _mm_cmpeq_epi16(v, _mm_set1_epi16('\\')));
+    __m128i control = _mm_cmpeq_epi16(_mm_subs_epu16(v, _mm_set1_epi16(0x1F)),
+                                      _mm_setzero_si128());
+    return uint32_t(_mm_movemask_epi8(_mm_or_si128(special, control)));
+}
+
+static MOZ_ALWAYS_INLINE uint32_t
+NonWhitespaceMask(const Latin1Char* p)
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8(' ')),
+                                           _mm_cmpeq_epi8(v, _mm_set1_epi8('\n'))),
+                              _mm_or_si128(_mm_cmpeq_epi8(v, _mm_set1_epi8('\r')),
+                                           _mm_cmpeq_epi8(v, _mm_set1_epi8('\t'))));
+    return uint32_t(_mm_movemask_epi8(ws)) ^ 0xffff;
+}
+
+static MOZ_ALWAYS_INLINE uint32_t
+NonWhitespaceMask(const char16_t* p)
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(p));
+    __m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi16(v, _mm_set1_epi16(' ')),
+                                           _mm_cmpeq_epi16(v, _mm_set1_epi16('\n'))),
+                              _mm_or_si128(_mm_cmpeq_epi16(v, _mm_set1_epi16('\r')),
+                                           _mm_cmpeq_epi16(v, _mm_set1_epi16('\t'))));
+    return uint32_t(_mm_movemask_epi8(ws)) ^ 0xffff;
+}
+
+#endif // JS_JSONPARSER_SSE2
+
+// Return the number of chars from |p| before the first quote, backslash or
+// control char, or before |end|.
+template <typename CharT>
+static MOZ_ALWAYS_INLINE size_t
+ScanStringChars(const CharT* p, const CharT* end)
+{
+    const CharT* start = p;
+#ifdef JS_JSONPARSER_SSE2
+    static const size_t CharsPerVector = sizeof(__m128i) / sizeof(CharT);
+    for (; size_t(end - p) >= CharsPerVector; p += CharsPerVector) {
+        if (uint32_t mask = StringSpecialMask(p)) {
+            return (p - start) + mozilla::CountTrailingZeroes32(mask) / sizeof(CharT);
+        }
+    }
+#endif
+    while (p < end && !IsJSONStringSpecial(*p)) {
+        p++;
+    }
+    return p - start;
+}
+
+// Return the number of whitespace chars from |p|. Most whitespace runs are a
+// single space or a newline and some indentation, so only use vectors after
+// the first few chars.
+template <typename CharT>
+static MOZ_ALWAYS_INLINE size_t
+ScanWhitespace(const CharT* p, const CharT* end)
+{
+    const CharT* start = p;
+    for (size_t i = 0; i < 4; i++) {
+        if (p == end || !IsJSONWhitespace(*p)) {
+            return p - start;
+        }
+        p++;
+    }
+#ifdef JS_JSONPARSER_SSE2
+    static const size_t CharsPerVector = sizeof(__m128i) / sizeof(CharT);
+    for (; size_t(end - p) >= CharsPerVector; p += CharsPerVector) {
+        if (uint32_t mask = NonWhitespaceMask(p)) {
+            return (p - start) + mozilla::CountTrailingZeroes32(mask) / sizeof(CharT);
+        }
+    }
+#endif
+    while (p < end && IsJSONWhitespace(*p)) {
+        p++;
+    }
+    return p - start;
+}
+
+// Parse a run of fewer than 16 decimal digits, which fits in a double exactly.
+static MOZ_ALWAYS_INLINE double
+ParseShortInteger(const Latin1Char* digits, size_t length)
+{
+    MOZ_ASSERT(length < 16);
+
+    uint64_t value = 0;
+    size_t i = 0;
+#if MOZ_LITTLE_ENDIAN
+    if (length >= 8) {
+        uint64_t chunk;
+        memcpy(&chunk, digits, sizeof(chunk));
+        value = EightDigitsValue(chunk);
+        i = 8;
+    }
+#endif
+    for (; i < length; i++) {
+        value = value * 10 + (digits[i] - '0');
+    }
+    return double(value);
+}
+
+static MOZ_ALWAYS_INLINE double
+ParseShortInteger(const char16_t* digits, size_t length)
+{
+    MOZ_ASSERT(length < 16);
+
+    uint64_t value = 0;
+    for (size_t i = 0; i < length; i++) {
+        value = value * 10 + (digits[i] - '0');
+    }
+    return double(value);
+}
+
 template <typename CharT>
 template <JSONParserBase::StringType ST>
 JSONParserBase::Token
@@ -128,7 +315,8 @@ JSONParser<CharT>::readString()
      * string directly from the source text.
      */
     CharPtr start = current;
-    for (; current < end; current++) {
+    current += ScanStringChars(current.get(), end.get());
+    if (current < end) {
         if (*current == '"') {
             size_t length = current - start;
             current++;
@@ -141,14 +329,12 @@ JSONParser<CharT>::readString()
             return stringToken(str);
         }
 
-        if (*current == '\\') {
-            break;
-        }
-
         if (*current <= 0x001F) {
             error("bad control character in string literal");
             return token(Error);
         }
+
+        MOZ_ASSERT(*current == '\\');
     }
 
     /*
@@ -238,11 +424,7 @@ JSONParser<CharT>::readString()
         }
 
         start = current;
-        for (; current < end; current++) {
-            if (*current == '"' || *current == '\\' || *current <= 0x001F) {
-                break;
-            }
-        }
+        current += ScanStringChars(current.get(), end.get());
     } while (current < end);
 
     error("unterminated string");
@@ -292,7 +474,7 @@ JSONParser<CharT>::readNumber()
             // largest number a double can represent with integral precision),
             // parse it using a decimal-only parser.  This comparison is
             // conservative but faster than a fully-precise check.
-            double d = ParseDecimalNumber(chars);
+            double d = ParseShortInteger(chars.begin().get(), chars.length());
             return numberToken(negative ? -d : d);
         }
 
@@ -350,19 +532,11 @@ JSONParser<CharT>::readNumber()
     return numberToken(negative ? -d : d);
 }
 
-static inline bool
-IsJSONWhitespace(char16_t c)
-{
-    return c == '\t' || c == '\r' || c == '\n' || c == ' ';
-}
-
 template <typename CharT>
 JSONParserBase::Token
 JSONParser<CharT>::advance()
 {
-    while (current < end && IsJSONWhitespace(*current)) {
-        current++;
-    }
+    current += ScanWhitespace(current.get(), end.get());
     if (current >= end) {
         error("unexpected end of data");
         return token(Error);
@@ -445,9 +619,7 @@ JSONParser<CharT>::advanceAfterObjectOpen()
 {
     MOZ_ASSERT(current[-1] == '{');
 
-    while (current < end && IsJSONWhitespace(*current)) {
-        current++;
-    }
+    current += ScanWhitespace(current.get(), end.get());
     if (current >= end) {
         error("end of data while reading object contents");
         return token(Error);
@@ -500,9 +672,7 @@ JSONParser<CharT>::advanceAfterArrayElement()
 {
     AssertPastValue(current);
 
-    while (current < end && IsJSONWhitespace(*current)) {
-        current++;
-    }
+    current += ScanWhitespace(current.get(), end.get());
     if (current >= end) {
         error("end of data when ',' or ']' was expected");
         return token(Error);
@@ -528,9 +698,7 @@ JSONParser<CharT>::advancePropertyName()
 {
     MOZ_ASSERT(current[-1] == ',');
 
-    while (current < end && IsJSONWhitespace(*current)) {
-        current++;
-    }
+    current += ScanWhitespace(current.get(), end.get());
     if (current >= end) {
         error("end of data when property name was expected");
         return token(Error);
@@ -550,9 +718,7 @@ JSONParser<CharT>::advancePropertyColon()
 {
     MOZ_ASSERT(current[-1] == '"');
 
-    while (current < end && IsJSONWhitespace(*current)) {
-        current++;
-    }
+    current += ScanWhitespace(current.get(), end.get());
     if (current >= end) {
         error("end of data after property name when ':' was expected");
         return token(Error);
@@ -573,9 +739,7 @@ JSONParser<CharT>::advanceAfterProperty()
 {
     AssertPastValue(current);
 
-    while (current < end && IsJSONWhitespace(*current)) {
-        current++;
-    }
+    current += ScanWhitespace(current.get(), end.get());
     if (current >= end) {
         error("end of data after property value in object");
         return token(Error);
@@ -595,12 +759,53 @@ JSONParser<CharT>::advanceAfterProperty()
     return token(Error);
 }
 
+// Whether the ids of |properties| are those of |shape|'s properties, in order.
+static bool
+ShapeHasPropertyIds(Shape* shape, const IdValuePair* properties, size_t nproperties)
+{
+    if (shape->slotSpan() != nproperties) {
+        return false;
+    }
+
+    for (size_t i = nproperties; i > 0; i--) {
+        if (shape->propid() != properties[i - 1].id) {
+            return false;
+        }
+        shape = shape->previous();
+    }
+    return true;
+}
+
 inline bool
 JSONParserBase::finishObject(MutableHandleValue vp, PropertyVector& properties)
 {
     MOZ_ASSERT(&properties == &stack.back().properties());
 
-    JSObject* obj = ObjectGroup::newPlainObject(cx, properties.begin(), properties.length(), GenericObject);
+    size_t depth = stack.length() - 1;
+    ObjectLayout* layout = depth < ObjectLayoutDepths ? &objectLayouts[depth] : nullptr;
+
+    JSObject* obj;
+    if (layout && layout->shape &&
+        ShapeHasPropertyIds(layout->shape, properties.begin(), properties.length()))
+    {
+        RootedObjectGroup group(cx, layout->group);
+        RootedShape shape(cx, layout->shape);
+        obj = ObjectGroup::newPlainObjectWithLayout(cx, group, shape, properties.begin(),
+                                                    properties.length(), GenericObject);
+    } else {
+        obj = ObjectGroup::newPlainObject(cx, properties.begin(), properties.length(),
+                                          GenericObject);
+        if (obj && layout && obj->is<PlainObject>() && !obj->isSingleton()) {
+            PlainObject& plain = obj->as<PlainObject>();
+            if (!plain.inDictionaryMode() &&
+                properties.length() > 0 &&
+                plain.slotSpan() == properties.length())
+            {
+                layout->group = plain.group();
+                layout->shape = plain.lastProperty();
+            }
+        }
+    }
     if (!obj) {
         return false;
     }
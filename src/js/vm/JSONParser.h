@@ -17,6 +17,9 @@
 
 namespace js {
 
+class ObjectGroup;
+class Shape;
+
 // JSONParser base class. JSONParser is templatized to work on either Latin1
 // or TwoByte input strings, JSONParserBase holds all state and methods that
 // can be shared between the two encodings.
@@ -103,6 +106,17 @@ class MOZ_STACK_CLASS JSONParserBase
     Vector<ElementVector*, 5> freeElements;
     Vector<PropertyVector*, 5> freeProperties;
 
+    // The group and shape of the last object finished at each of the first
+    // few nesting depths. Record-style data has many objects with the same
+    // keys at the same depth, and objects whose keys match the cached shape
+    // can be made without looking up their group by all their keys.
+    struct ObjectLayout {
+        ObjectGroup* group = nullptr;
+        Shape* shape = nullptr;
+    };
+    static const size_t ObjectLayoutDepths = 8;
+    ObjectLayout objectLayouts[ObjectLayoutDepths];
+
 #ifdef DEBUG
     Token lastToken;
 #endif
@@ -130,7 +144,11 @@ class MOZ_STACK_CLASS JSONParserBase
 #ifdef DEBUG
       , lastToken(std::move(other.lastToken))
 #endif
-    {}
+    {
+        for (size_t i = 0; i < ObjectLayoutDepths; i++) {
+            objectLayouts[i] = other.objectLayouts[i];
+        }
+    }
 
 
     Value numberValue() const {
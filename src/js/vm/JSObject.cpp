@@ -3213,10 +3213,12 @@ PropertySpecNameToId(JSContext* cx, const char* name, MutableHandleId id,
 
 static bool
 DefineFunctionFromSpec(JSContext* cx, HandleObject obj, const JSFunctionSpec* fs, unsigned flags,
-                       DefineAsIntrinsic intrinsic)
+                       DefineAsIntrinsic intrinsic, const jsid* idp)
 {
     RootedId id(cx);
-    if (!PropertySpecNameToId(cx, fs->name, &id)) {
+    if (idp) {
+        id = *idp;
+    } else if (!PropertySpecNameToId(cx, fs->name, &id)) {
         return false;
     }
 
@@ -3235,10 +3237,12 @@ DefineFunctionFromSpec(JSContext* cx, HandleObject obj, const JSFunctionSpec* fs
 
 bool
 js::DefineFunctions(JSContext* cx, HandleObject obj, const JSFunctionSpec* fs,
-                    DefineAsIntrinsic intrinsic)
+                    DefineAsIntrinsic intrinsic, const jsid* ids)
 {
-    for (; fs->name; fs++) {
-        if (!DefineFunctionFromSpec(cx, obj, fs, fs->flags, intrinsic)) {
+    for (size_t i = 0; fs[i].name; i++) {
+        if (!DefineFunctionFromSpec(cx, obj, &fs[i], fs[i].flags, intrinsic,
+                                    ids ? &ids[i] : nullptr))
+        {
             return false;
         }
     }
@@ -668,9 +668,18 @@ enum DefineAsIntrinsic {
     AsIntrinsic
 };
 
+/*
+ * Define the functions of |fs| on |obj|. If |ids| is not null, it holds the id
+ * of each entry of |fs|, as returned by SpecIdCache.
+ */
 extern bool
 DefineFunctions(JSContext* cx, HandleObject obj, const JSFunctionSpec* fs,
-                DefineAsIntrinsic intrinsic);
+                DefineAsIntrinsic intrinsic, const jsid* ids = nullptr);
+
+/* Like JS_DefineProperties, with the same optional ids as DefineFunctions. */
+extern bool
+DefineProperties(JSContext* cx, HandleObject obj, const JSPropertySpec* ps,
+                 const jsid* ids = nullptr);
 
 /* ES6 draft rev 36 (2015 March 17) 7.1.1 ToPrimitive(vp[, preferredType]) */
 extern bool
@@ -36,6 +36,7 @@
 #include "jit/BaselineJIT.h"
 #include "jit/Ion.h"
 #include "jit/IonCode.h"
+#include "jit/IonOptimizationLevels.h"
 #include "jit/JitRealm.h"
 #include "js/CompileOptions.h"
 #include "js/MemoryMetrics.h"
@@ -44,6 +45,7 @@
 #include "js/UniquePtr.h"
 #include "js/Utility.h"
 #include "js/Wrapper.h"
+#include "threading/ExclusiveData.h"
 #include "util/StringBuffer.h"
 #include "util/Text.h"
 #include "vm/ArgumentsObject.h"
@@ -261,6 +263,7 @@ XDRRelazificationInfo(XDRState<mode>* xdr, HandleFunction fun, HandleScript scri
         uint32_t toStringEnd = script->toStringEnd();
         uint32_t lineno = script->lineno();
         uint32_t column = script->column();
+        uint16_t funLength = script->funLength();
 
         if (mode == XDR_ENCODE) {
             packedFields = lazy->packedFields();
@@ -270,6 +273,7 @@ XDRRelazificationInfo(XDRState<mode>* xdr, HandleFunction fun, HandleScript scri
             MOZ_ASSERT(toStringEnd == lazy->toStringEnd());
             MOZ_ASSERT(lineno == lazy->lineno());
             MOZ_ASSERT(column == lazy->column());
+            MOZ_ASSERT_IF(!lazy->isBinAST(), funLength == lazy->funLength());
             // We can assert we have no inner functions because we don't
             // relazify scripts with inner functions.  See
             // JSFunction::createScriptForLazilyInterpretedFunction.
@@ -288,6 +292,7 @@ XDRRelazificationInfo(XDRState<mode>* xdr, HandleFunction fun, HandleScript scri
             }
 
             lazy->setToStringEnd(toStringEnd);
+            lazy->setFunLength(funLength);
 
             // As opposed to XDRLazyScript, we need to restore the runtime bits
             // of the script, as we are trying to match the fact this function
@@ -358,6 +363,8 @@ js::XDRScript(XDRState<mode>* xdr, HandleScope scriptEnclosingScope,
         NeedsHomeObject,
         IsDerivedClassConstructor,
         IsDefaultClassConstructor,
+        HadBaselineScript,
+        HadIonScript,
     };
 
     uint32_t length, lineno, column, nfixed, nslots;
@@ -503,6 +510,14 @@ js::XDRScript(XDRState<mode>* xdr, HandleScope scriptEnclosingScope,
         if (script->isDefaultClassConstructor()) {
             scriptBits |= (1 << IsDefaultClassConstructor);
         }
+        if (!jit::JitOptions.disableXDRWarmUpHints) {
+            if (script->hasBaselineScript()) {
+                scriptBits |= (1 << HadBaselineScript);
+            }
+            if (script->hasIonScript()) {
+                scriptBits |= (1 << HadIonScript);
+            }
+        }
     }
 
     MOZ_TRY(xdr->codeUint32(&prologueLength));
@@ -692,36 +707,57 @@ js::XDRScript(XDRState<mode>* xdr, HandleScope scriptEnclosingScope,
     }
 
     if (mode == XDR_DECODE) {
-        if (!script->createScriptData(cx, length, nsrcnotes, natoms)) {
+        // The bytecode and source notes are not copied out of the buffer
+        // unless no other script in the runtime already shares them.
+        const uint8_t* code;
+        const uint8_t* notes;
+        MOZ_TRY(xdr->peekData(&code, length));
+        MOZ_TRY(xdr->peekData(&notes, nsrcnotes));
+
+        Rooted<GCVector<JSAtom*>> atoms(cx, GCVector<JSAtom*>(cx));
+        if (!atoms.reserve(natoms)) {
             return xdr->fail(JS::TranscodeResult_Throw);
         }
-    }
-
-    auto scriptDataGuard = mozilla::MakeScopeExit([&] {
-        if (mode == XDR_DECODE) {
-            script->freeScriptData();
+        for (uint32_t i = 0; i != natoms; ++i) {
+            RootedAtom tmp(cx);
+            MOZ_TRY(XDRAtom(xdr, &tmp));
+            atoms.infallibleAppend(tmp);
         }
-    });
 
-    jsbytecode* code = script->code();
-    MOZ_TRY(xdr->codeBytes(code, length));
-    MOZ_TRY(xdr->codeBytes(code + length, nsrcnotes));
+        if (!script->createOrShareScriptData(cx, atoms.begin(), natoms,
+                                             reinterpret_cast<const jsbytecode*>(code), length,
+                                             reinterpret_cast<const jssrcnote*>(notes),
+                                             nsrcnotes))
+        {
+            return xdr->fail(JS::TranscodeResult_Throw);
+        }
+    } else {
+        jsbytecode* code = script->code();
+        MOZ_TRY(xdr->codeBytes(code, length));
+        MOZ_TRY(xdr->codeBytes(code + length, nsrcnotes));
 
-    for (uint32_t i = 0; i != natoms; ++i) {
-        if (mode == XDR_DECODE) {
-            RootedAtom tmp(cx);
-            MOZ_TRY(XDRAtom(xdr, &tmp));
-            script->atoms()[i].init(tmp);
-        } else {
+        for (uint32_t i = 0; i != natoms; ++i) {
             RootedAtom tmp(cx, script->atoms()[i]);
             MOZ_TRY(XDRAtom(xdr, &tmp));
         }
     }
 
-    scriptDataGuard.release();
-    if (mode == XDR_DECODE) {
-        if (!script->shareScriptData(cx)) {
-            return xdr->fail(JS::TranscodeResult_Throw);
+    if (mode == XDR_DECODE && !jit::JitOptions.disableXDRWarmUpHints) {
+        // Scripts that had JIT code when they were encoded are likely to be
+        // hot again, so don't make them warm up from scratch. Ion still needs
+        // Baseline to collect type information first, so only part of its
+        // threshold is skipped.
+        uint32_t warmUp = 0;
+        if (scriptBits & (1 << HadIonScript)) {
+            const jit::OptimizationInfo* info =
+                jit::IonOptimizations.get(jit::OptimizationLevel::Normal);
+            warmUp = std::max(info->compilerWarmUpThreshold(script) / 2,
+                              jit::JitOptions.baselineWarmUpThreshold);
+        } else if (scriptBits & (1 << HadBaselineScript)) {
+            warmUp = jit::JitOptions.baselineWarmUpThreshold;
+        }
+        if (warmUp) {
+            script->incWarmUpCounter(warmUp);
         }
     }
 
@@ -1005,6 +1041,7 @@ js::XDRLazyScript(XDRState<mode>* xdr, HandleScope enclosingScope,
         uint32_t toStringEnd;
         uint32_t lineno;
         uint32_t column;
+        uint16_t funLength;
         uint64_t packedFields;
 
         if (mode == XDR_ENCODE) {
@@ -1020,6 +1057,7 @@ js::XDRLazyScript(XDRState<mode>* xdr, HandleScope enclosingScope,
             toStringEnd = lazy->toStringEnd();
             lineno = lazy->lineno();
             column = lazy->column();
+            funLength = lazy->isBinAST() ? 0 : lazy->funLength();
             packedFields = lazy->packedFields();
         }
 
@@ -1029,6 +1067,7 @@ js::XDRLazyScript(XDRState<mode>* xdr, HandleScope enclosingScope,
         MOZ_TRY(xdr->codeUint32(&toStringEnd));
         MOZ_TRY(xdr->codeUint32(&lineno));
         MOZ_TRY(xdr->codeUint32(&column));
+        MOZ_TRY(xdr->codeUint16(&funLength));
         MOZ_TRY(xdr->codeUint64(&packedFields));
 
         if (mode == XDR_DECODE) {
@@ -1039,6 +1078,7 @@ js::XDRLazyScript(XDRState<mode>* xdr, HandleScope enclosingScope,
                 return xdr->fail(JS::TranscodeResult_Throw);
             }
             lazy->setToStringEnd(toStringEnd);
+            lazy->setFunLength(funLength);
             fun->initLazyScript(lazy);
         }
     }
@@ -1630,10 +1670,15 @@ UncompressedSourceCache::lookup(const ScriptSourceChunk& ssc, AutoHoldEntry& hol
 }
 
 bool
-UncompressedSourceCache::put(const ScriptSourceChunk& ssc, SourceData data, AutoHoldEntry& holder)
+UncompressedSourceCache::put(const ScriptSourceChunk& ssc, SourceData data, size_t nbytes,
+                             AutoHoldEntry& holder)
 {
     MOZ_ASSERT(!holder_);
 
+    if (maxBytes_ && bytes_ + nbytes > maxBytes_) {
+        purge();
+    }
+
     if (!map_) {
         map_ = MakeUnique<Map>();
         if (!map_) {
@@ -1644,6 +1689,7 @@ UncompressedSourceCache::put(const ScriptSourceChunk& ssc, SourceData data, Auto
     if (!map_->put(ssc, std::move(data))) {
         return false;
     }
+    bytes_ += nbytes;
 
     holdEntry(holder, ssc);
     return true;
@@ -1664,6 +1710,7 @@ UncompressedSourceCache::purge()
     }
 
     map_ = nullptr;
+    bytes_ = 0;
 }
 
 size_t
@@ -1717,7 +1764,7 @@ ScriptSource::chunkUnits(JSContext* cx, UncompressedSourceCache::AutoHoldEntry&
 
     const Unit* ret = decompressed.get();
     if (!cx->caches().uncompressedSourceCache.put(ssc, ToSourceData(std::move(decompressed)),
-                                                  holder))
+                                                  lengthWithNull * sizeof(Unit), holder))
     {
         JS_ReportOutOfMemory(cx);
         return nullptr;
@@ -2125,6 +2172,24 @@ ScriptSource::setSourceCopy(JSContext* cx, SourceBufferHolder& srcBuf)
     return true;
 }
 
+bool
+ScriptSource::setSourceCopy(JSContext* cx, const Utf8Unit* units, size_t length)
+{
+    MOZ_ASSERT(!hasSourceText());
+
+    // UTF-8 source is stored as it is, without inflating it to UTF-16.
+    JSRuntime* runtime = cx->zone()->runtimeFromAnyThread();
+    auto& cache = runtime->sharedImmutableStrings();
+    auto deduped = cache.getOrCreate(reinterpret_cast<const char*>(units), length);
+    if (!deduped) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+    setSource<Utf8Unit>(std::move(*deduped));
+    return true;
+}
+
 void
 ScriptSource::trace(JSTracer* trc)
 {
@@ -2168,7 +2233,7 @@ SourceCompressionTask::workEncodingSpecific()
     }
 
     const Unit* chars = source->data.as<ScriptSource::Uncompressed<Unit>>().units();
-    Compressor comp(reinterpret_cast<const unsigned char*>(chars), inputBytes);
+    Compressor comp(reinterpret_cast<const unsigned char*>(chars), inputBytes, codec_);
     if (!comp.init()) {
         return;
     }
@@ -2851,9 +2916,16 @@ ScriptSource::setSourceMapURL(JSContext* cx, const char16_t* sourceMapURL)
 
 SharedScriptData*
 js::SharedScriptData::new_(JSContext* cx, uint32_t codeLength,
-                           uint32_t srcnotesLength, uint32_t natoms)
+                           uint32_t srcnotesLength, uint32_t natoms,
+                           SharedBytecode* bytecode)
 {
-    size_t dataLength = natoms * sizeof(GCPtrAtom) + codeLength + srcnotesLength;
+    MOZ_ASSERT_IF(bytecode, bytecode->codeLength() == codeLength);
+    MOZ_ASSERT_IF(bytecode, bytecode->numNotes() == srcnotesLength);
+
+    size_t dataLength = natoms * sizeof(GCPtrAtom);
+    if (!bytecode) {
+        dataLength += codeLength + srcnotesLength;
+    }
     size_t allocLength = offsetof(SharedScriptData, data_) + dataLength;
     auto entry = reinterpret_cast<SharedScriptData*>(cx->pod_malloc<uint8_t>(allocLength));
     if (!entry) {
@@ -2869,6 +2941,7 @@ js::SharedScriptData::new_(JSContext* cx, uint32_t codeLength,
     entry->natoms_ = natoms;
     entry->codeLength_ = codeLength;
     entry->noteLength_ = srcnotesLength;
+    entry->bytecode_ = bytecode;
 
     /*
      * Call constructors to initialize the storage that will be accessed as a
@@ -2887,18 +2960,51 @@ js::SharedScriptData::new_(JSContext* cx, uint32_t codeLength,
     return entry;
 }
 
+inline void
+js::ScriptBytecodeHasher::Lookup::computeHash()
+{
+    hash = mozilla::AddToHash(mozilla::HashBytes(atoms, natoms * sizeof(GCPtrAtom)),
+                              mozilla::HashBytes(code, codeLength),
+                              mozilla::HashBytes(notes, numNotes));
+}
+
 inline
 js::ScriptBytecodeHasher::Lookup::Lookup(SharedScriptData* data)
   : scriptData(data),
-    hash(mozilla::HashBytes(scriptData->data(), scriptData->dataLength()))
-{
+    atoms(reinterpret_cast<const uint8_t*>(data->atoms())),
+    natoms(data->natoms()),
+    code(data->code()),
+    codeLength(data->codeLength()),
+    notes(data->notes()),
+    numNotes(data->numNotes())
+{
+    computeHash();
     scriptData->incRefCount();
 }
 
+inline
+js::ScriptBytecodeHasher::Lookup::Lookup(JSAtom* const* atoms, uint32_t natoms,
+                                         const jsbytecode* code, uint32_t codeLength,
+                                         const jssrcnote* notes, uint32_t numNotes)
+  : scriptData(nullptr),
+    atoms(reinterpret_cast<const uint8_t*>(atoms)),
+    natoms(natoms),
+    code(code),
+    codeLength(codeLength),
+    notes(notes),
+    numNotes(numNotes)
+{
+    static_assert(sizeof(GCPtrAtom) == sizeof(JSAtom*),
+                  "atoms are compared as the bytes of their pointers");
+    computeHash();
+}
+
 inline
 js::ScriptBytecodeHasher::Lookup::~Lookup()
 {
-    scriptData->decRefCount();
+    if (scriptData) {
+        scriptData->decRefCount();
+    }
 }
 
 bool
@@ -2930,9 +3036,150 @@ JSScript::setScriptData(js::SharedScriptData* data)
     scriptData_->incRefCount();
 }
 
+namespace {
+
+struct SharedBytecodeHasher
+{
+    struct Lookup
+    {
+        const jsbytecode* code;
+        uint32_t codeLength;
+        const jssrcnote* notes;
+        uint32_t numNotes;
+        HashNumber hash;
+
+        Lookup(const jsbytecode* code, uint32_t codeLength,
+               const jssrcnote* notes, uint32_t numNotes)
+          : code(code),
+            codeLength(codeLength),
+            notes(notes),
+            numNotes(numNotes),
+            hash(mozilla::AddToHash(mozilla::HashBytes(code, codeLength),
+                                    mozilla::HashBytes(notes, numNotes)))
+        {}
+
+        explicit Lookup(const SharedBytecode* entry)
+          : code(entry->code()),
+            codeLength(entry->codeLength()),
+            notes(entry->notes()),
+            numNotes(entry->numNotes()),
+            hash(entry->hash())
+        {}
+    };
+
+    static HashNumber hash(const Lookup& l) {
+        return l.hash;
+    }
+    static bool match(SharedBytecode* entry, const Lookup& l) {
+        return entry->codeLength() == l.codeLength &&
+               entry->numNotes() == l.numNotes &&
+               mozilla::ArrayEqual(entry->code(), l.code, l.codeLength) &&
+               mozilla::ArrayEqual(entry->notes(), l.notes, l.numNotes);
+    }
+};
+
+using SharedBytecodeSet = HashSet<SharedBytecode*, SharedBytecodeHasher, SystemAllocPolicy>;
+
+} // anonymous namespace
+
+static ExclusiveData<SharedBytecodeSet>* sSharedBytecodes = nullptr;
+
+bool
+js::InitSharedBytecodeTable()
+{
+    MOZ_ASSERT(!sSharedBytecodes);
+    sSharedBytecodes = js_new<ExclusiveData<SharedBytecodeSet>>(mutexid::SharedBytecodeTable);
+    return sSharedBytecodes;
+}
+
+void
+js::ShutDownSharedBytecodeTable()
+{
+    // Every runtime is gone, so any remaining entries belong to scripts the
+    // embedding leaked, and are leaked with them.
+    js_delete(sSharedBytecodes);
+    sSharedBytecodes = nullptr;
+}
+
+/* static */ SharedBytecode*
+SharedBytecode::getOrCreate(const jsbytecode* code, uint32_t codeLength,
+                            const jssrcnote* notes, uint32_t noteLength)
+{
+    MOZ_ASSERT(sSharedBytecodes);
+
+    SharedBytecodeHasher::Lookup lookup(code, codeLength, notes, noteLength);
+
+    auto bytecodes = sSharedBytecodes->lock();
+    SharedBytecodeSet::AddPtr p = bytecodes->lookupForAdd(lookup);
+    if (p) {
+        (*p)->refCount_++;
+        return *p;
+    }
+
+    size_t allocLength = offsetof(SharedBytecode, data_) + codeLength + noteLength;
+    auto entry = reinterpret_cast<SharedBytecode*>(js_pod_malloc<uint8_t>(allocLength));
+    if (!entry) {
+        return nullptr;
+    }
+
+    entry->refCount_ = 1;
+    entry->hash_ = lookup.hash;
+    entry->codeLength_ = codeLength;
+    entry->noteLength_ = noteLength;
+    PodCopy(entry->data_, reinterpret_cast<const uint8_t*>(code), codeLength);
+    PodCopy(entry->data_ + codeLength, reinterpret_cast<const uint8_t*>(notes), noteLength);
+
+    if (!bytecodes->add(p, entry)) {
+        js_free(entry);
+        return nullptr;
+    }
+    return entry;
+}
+
+void
+SharedBytecode::release()
+{
+    auto bytecodes = sSharedBytecodes->lock();
+
+    MOZ_ASSERT(refCount_ != 0);
+    if (--refCount_ == 0) {
+        bytecodes->remove(SharedBytecodeHasher::Lookup(this));
+        js_free(this);
+    }
+}
+
+// Return a copy of |ssd| whose bytecode and source notes are in the
+// process-wide table, or nullptr after reporting OOM.
+static SharedScriptData*
+NewWithSharedBytecode(JSContext* cx, SharedScriptData* ssd)
+{
+    MOZ_ASSERT(!ssd->hasSharedBytecode());
+
+    SharedBytecode* bytecode = SharedBytecode::getOrCreate(ssd->code(), ssd->codeLength(),
+                                                           ssd->notes(), ssd->numNotes());
+    if (!bytecode) {
+        ReportOutOfMemory(cx);
+        return nullptr;
+    }
+
+    SharedScriptData* shared = SharedScriptData::new_(cx, ssd->codeLength(), ssd->numNotes(),
+                                                      ssd->natoms(), bytecode);
+    if (!shared) {
+        bytecode->release();
+        return nullptr;
+    }
+
+    for (uint32_t i = 0; i < ssd->natoms(); i++) {
+        shared->atoms()[i].init(ssd->atoms()[i]);
+    }
+    return shared;
+}
+
 /*
  * Takes ownership of its *ssd parameter and either adds it into the runtime's
- * ScriptDataTable or frees it if a matching entry already exists.
+ * ScriptDataTable or frees it if a matching entry already exists. Entries
+ * added to the table share their bytecode and source notes with the other
+ * runtimes in the process.
  *
  * Sets the |code| and |atoms| fields on the given JSScript.
  */
@@ -2947,15 +3194,34 @@ JSScript::shareScriptData(JSContext* cx)
     // counted, it also will be freed after releasing the lock if necessary.
     ScriptBytecodeHasher::Lookup lookup(ssd);
 
+    {
+        AutoLockScriptData lock(cx->runtime());
+        if (ScriptDataTable::Ptr p = cx->scriptDataTable(lock).lookup(lookup)) {
+            MOZ_ASSERT(ssd != *p);
+            freeScriptData();
+            setScriptData(*p);
+            return true;
+        }
+    }
+
+    // Allocating may GC, which can't happen with the lock held.
+    SharedScriptData* shared = NewWithSharedBytecode(cx, ssd);
+    if (!shared) {
+        freeScriptData();
+        return false;
+    }
+    freeScriptData();
+    setScriptData(shared);
+
     AutoLockScriptData lock(cx->runtime());
 
+    // Another thread may have added the same data in the meantime.
     ScriptDataTable::AddPtr p = cx->scriptDataTable(lock).lookupForAdd(lookup);
     if (p) {
-        MOZ_ASSERT(ssd != *p);
         freeScriptData();
         setScriptData(*p);
     } else {
-        if (!cx->scriptDataTable(lock).add(p, ssd)) {
+        if (!cx->scriptDataTable(lock).add(p, shared)) {
             freeScriptData();
             ReportOutOfMemory(cx);
             return false;
@@ -2969,6 +3235,37 @@ JSScript::shareScriptData(JSContext* cx)
     return true;
 }
 
+bool
+JSScript::createOrShareScriptData(JSContext* cx, JSAtom* const* atoms, uint32_t natoms,
+                                  const jsbytecode* code, uint32_t codeLength,
+                                  const jssrcnote* notes, uint32_t numNotes)
+{
+    MOZ_ASSERT(!scriptData());
+
+    ScriptBytecodeHasher::Lookup lookup(atoms, natoms, code, codeLength, notes, numNotes);
+
+    {
+        AutoLockScriptData lock(cx->runtime());
+        if (ScriptDataTable::Ptr p = cx->scriptDataTable(lock).lookup(lookup)) {
+            setScriptData(*p);
+            return true;
+        }
+    }
+
+    if (!createScriptData(cx, codeLength, numNotes, natoms)) {
+        return false;
+    }
+
+    SharedScriptData* ssd = scriptData();
+    for (uint32_t i = 0; i < natoms; i++) {
+        ssd->atoms()[i].init(atoms[i]);
+    }
+    mozilla::PodCopy(ssd->code(), code, codeLength);
+    mozilla::PodCopy(ssd->notes(), notes, numNotes);
+
+    return shareScriptData(cx);
+}
+
 void
 js::SweepScriptData(JSRuntime* rt)
 {
@@ -3003,7 +3300,7 @@ js::FreeScriptData(JSRuntime* rt)
         fprintf(stderr, "ERROR: GC found live SharedScriptData %p with ref count %d at shutdown\n",
                 scriptData, scriptData->refCount());
 #endif
-        js_free(e.front());
+        e.front()->destroy();
     }
 
     table.clear();
@@ -3673,6 +3970,7 @@ JSScript::finalize(FreeOp* fop)
 
     destroyScriptCounts();
     destroyDebugScript(fop);
+    destroyLineTable();
 
     if (data) {
         JS_POISON(data, 0xdb, computedSizeOfData(), MemCheckKind::MakeNoAccess);
@@ -3802,6 +4100,118 @@ js::PCToLineNumber(unsigned startLine, jssrcnote* notes, jsbytecode* code, jsbyt
     return lineno;
 }
 
+/* static */ UniquePtr<ScriptLineTable>
+ScriptLineTable::create(JSScript* script)
+{
+    UniquePtr<ScriptLineTable> table(js_new<ScriptLineTable>(script->lineno()));
+    if (!table || !table->init(script)) {
+        return nullptr;
+    }
+    return table;
+}
+
+bool
+ScriptLineTable::init(JSScript* script)
+{
+    // Record the position after each note which changes it, as the linear
+    // walk in PCToLineNumber above would compute it for that offset.
+    unsigned lineno = startLine_;
+    unsigned column = 0;
+    uint32_t offset = 0;
+    for (jssrcnote* sn = script->notes(); !SN_IS_TERMINATOR(sn); sn = SN_NEXT(sn)) {
+        offset += SN_DELTA(sn);
+
+        SrcNoteType type = SN_TYPE(sn);
+        if (type == SRC_SETLINE) {
+            lineno = unsigned(GetSrcNoteOffset(sn, SrcNote::SetLine::Line));
+            column = 0;
+        } else if (type == SRC_NEWLINE) {
+            lineno++;
+            column = 0;
+        } else if (type == SRC_COLSPAN) {
+            ptrdiff_t colspan = SN_OFFSET_TO_COLSPAN(GetSrcNoteOffset(sn, SrcNote::ColSpan::Span));
+            MOZ_ASSERT(ptrdiff_t(column) + colspan >= 0);
+            column += colspan;
+        } else {
+            continue;
+        }
+
+        if (!entries_.empty() && entries_.back().offset == offset) {
+            entries_.back().line = lineno;
+            entries_.back().column = column;
+        } else if (!entries_.append(Entry { offset, lineno, column })) {
+            return false;
+        }
+    }
+
+    entries_.shrinkStorageToFit();
+    return true;
+}
+
+unsigned
+ScriptLineTable::lookup(uint32_t offset, unsigned* columnp) const
+{
+    // Find the last entry at or before |offset|.
+    size_t low = 0;
+    size_t high = entries_.length();
+    while (low < high) {
+        size_t mid = low + (high - low) / 2;
+        if (entries_[mid].offset <= offset) {
+            low = mid + 1;
+        } else {
+            high = mid;
+        }
+    }
+
+    if (low == 0) {
+        if (columnp) {
+            *columnp = 0;
+        }
+        return startLine_;
+    }
+
+    const Entry& entry = entries_[low - 1];
+    if (columnp) {
+        *columnp = entry.column;
+    }
+    return entry.line;
+}
+
+const ScriptLineTable*
+JSScript::getOrCreateLineTable()
+{
+    ScriptLineTableMap* map = realm()->scriptLineTableMap.get();
+    if (map) {
+        if (ScriptLineTableMap::Ptr p = map->lookup(this)) {
+            return p->value().get();
+        }
+    } else {
+        realm()->scriptLineTableMap = js::MakeUnique<ScriptLineTableMap>();
+        map = realm()->scriptLineTableMap.get();
+        if (!map) {
+            return nullptr;
+        }
+    }
+
+    UniqueScriptLineTable table = ScriptLineTable::create(this);
+    if (!table) {
+        return nullptr;
+    }
+    const ScriptLineTable* result = table.get();
+    if (!map->putNew(this, std::move(table))) {
+        return nullptr;
+    }
+    return result;
+}
+
+void
+JSScript::destroyLineTable()
+{
+    if (ScriptLineTableMap* map = realm()->scriptLineTableMap.get()) {
+        map->remove(this);
+    }
+}
+
 unsigned
 js::PCToLineNumber(JSScript* script, jsbytecode* pc, unsigned* columnp)
 {
@@ -3810,6 +4220,17 @@ js::PCToLineNumber(JSScript* script, jsbytecode* pc, unsigned* columnp)
         return 0;
     }
 
+    // Stack captures and profiler samples look up many pcs in large scripts,
+    // so those get a table. Off-thread users such as Ion compilations can't
+    // touch the realm's map, and scan the notes instead.
+    if (script->numNotes() >= ScriptLineTable::MinNotes &&
+        CurrentThreadCanAccessRuntime(script->runtimeFromAnyThread()))
+    {
+        if (const ScriptLineTable* table = script->getOrCreateLineTable()) {
+            return table->lookup(script->pcToOffset(pc), columnp);
+        }
+    }
+
     return PCToLineNumber(script->lineno(), script->notes(), script->code(), pc, columnp);
 }
 
@@ -4803,7 +5224,8 @@ LazyScript::LazyScript(JSFunction* fun, ScriptSourceObject& sourceObject,
     toStringStart_(toStringStart),
     toStringEnd_(sourceEnd),
     lineno_(lineno),
-    column_(column)
+    column_(column),
+    funLength_(0)
 {
     MOZ_ASSERT(function_);
     MOZ_ASSERT(sourceObject_);
@@ -263,6 +263,53 @@ using ScriptNameMap = HashMap<JSScript*,
                               DefaultHasher<JSScript*>,
                               SystemAllocPolicy>;
 
+// The line and column of each bytecode offset of a script, built from its
+// source notes so that PCToLineNumber can binary search it instead of walking
+// the notes from the start of the script on every call. Each entry holds from
+// its offset up to the offset of the next one; offsets before the first entry
+// are on the script's first line, at column zero.
+class ScriptLineTable
+{
+  public:
+    // Scripts with fewer source notes than this are cheap enough to scan.
+    static const uint32_t MinNotes = 256;
+
+  private:
+    struct Entry
+    {
+        uint32_t offset;
+        uint32_t line;
+        uint32_t column;
+    };
+
+    uint32_t startLine_;
+    Vector<Entry, 0, SystemAllocPolicy> entries_;
+
+    MOZ_MUST_USE bool init(JSScript* script);
+
+  public:
+    explicit ScriptLineTable(uint32_t startLine)
+      : startLine_(startLine)
+    {}
+
+    // Returns null on OOM, without reporting it.
+    static js::UniquePtr<ScriptLineTable> create(JSScript* script);
+
+    unsigned lookup(uint32_t offset, unsigned* columnp) const;
+
+    size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
+        return mallocSizeOf(this) + entries_.sizeOfExcludingThis(mallocSizeOf);
+    }
+};
+
+// Like ScriptCountsMap, this is keyed by a weak reference to the script, whose
+// entry is removed when it is finalized. Shrinking GCs discard all the tables.
+using UniqueScriptLineTable = js::UniquePtr<ScriptLineTable>;
+using ScriptLineTableMap = HashMap<JSScript*,
+                                   UniqueScriptLineTable,
+                                   DefaultHasher<JSScript*>,
+                                   SystemAllocPolicy>;
+
 class DebugScript
 {
     friend class ::JSScript;
@@ -422,13 +469,21 @@ class UncompressedSourceCache
     UniquePtr<Map> map_ = nullptr;
     AutoHoldEntry* holder_ = nullptr;
 
+    // The number of bytes of decompressed source in the cache, and the limit
+    // past which the cache is purged before adding more. Zero means that the
+    // cache is only purged on GC.
+    size_t bytes_ = 0;
+    size_t maxBytes_ = 0;
+
   public:
     UncompressedSourceCache() = default;
 
+    void setMaxBytes(size_t maxBytes) { maxBytes_ = maxBytes; }
+
     template<typename Unit>
     const Unit* lookup(const ScriptSourceChunk& ssc, AutoHoldEntry& asp);
 
-    bool put(const ScriptSourceChunk& ssc, SourceData data, AutoHoldEntry& asp);
+    bool put(const ScriptSourceChunk& ssc, SourceData data, size_t nbytes, AutoHoldEntry& asp);
 
     void purge();
 
@@ -716,6 +771,8 @@ class ScriptSource
                                       const JS::ReadOnlyCompileOptions& options,
                                       const mozilla::Maybe<uint32_t>& parameterListEnd = mozilla::Nothing());
     MOZ_MUST_USE bool setSourceCopy(JSContext* cx, JS::SourceBufferHolder& srcBuf);
+    MOZ_MUST_USE bool setSourceCopy(JSContext* cx, const mozilla::Utf8Unit* units,
+                                    size_t length);
     void setSourceRetrievable() { sourceRetrievable_ = true; }
     bool sourceRetrievable() const { return sourceRetrievable_; }
     bool hasSourceText() const { return hasUncompressedSource() || hasCompressedSource(); }
@@ -1272,6 +1329,61 @@ template<XDRMode mode>
 XDRResult
 XDRScriptConst(XDRState<mode>* xdr, MutableHandleValue vp);
 
+/*
+ * The bytecode and source notes of a script, shared by the SharedScriptData of
+ * every runtime in the process with an identical script. Unlike atoms, these
+ * bytes don't point into any runtime, so contexts loading the same library
+ * code on different threads keep a single copy of it. Entries are immutable
+ * and live in a process-wide table between JS_Init and JS_ShutDown.
+ */
+class SharedBytecode
+{
+    // Only modified with the table locked, so that a lookup can't return an
+    // entry which is being freed.
+    uint32_t refCount_;
+
+    HashNumber hash_;
+    uint32_t codeLength_;
+    uint32_t noteLength_;
+    uint8_t data_[1];
+
+  public:
+    // Return the entry with this bytecode and these source notes, creating it
+    // if there is none, with a reference for the caller. Returns nullptr on
+    // OOM without reporting it.
+    static SharedBytecode* getOrCreate(const jsbytecode* code, uint32_t codeLength,
+                                       const jssrcnote* notes, uint32_t noteLength);
+
+    void release();
+
+    HashNumber hash() const {
+        return hash_;
+    }
+    uint32_t codeLength() const {
+        return codeLength_;
+    }
+    const jsbytecode* code() const {
+        return reinterpret_cast<const jsbytecode*>(data_);
+    }
+    uint32_t numNotes() const {
+        return noteLength_;
+    }
+    const jssrcnote* notes() const {
+        return reinterpret_cast<const jssrcnote*>(data_ + codeLength_);
+    }
+
+  private:
+    SharedBytecode() = delete;
+    SharedBytecode(const SharedBytecode&) = delete;
+    SharedBytecode& operator=(const SharedBytecode&) = delete;
+};
+
+extern MOZ_MUST_USE bool
+InitSharedBytecodeTable();
+
+extern void
+ShutDownSharedBytecodeTable();
+
 /*
  * Common data that can be shared between many scripts in a single runtime.
  */
@@ -1286,11 +1398,19 @@ class SharedScriptData
     uint32_t natoms_;
     uint32_t codeLength_;
     uint32_t noteLength_;
+
+    // Once the data is in the runtime's table, the bytecode and source notes
+    // are shared with other runtimes, and |data_| only holds the atoms.
+    SharedBytecode* bytecode_;
+
     uintptr_t data_[1];
 
   public:
+    // If |bytecode| is null, the bytecode and source notes are stored inline
+    // and have to be initialized by the caller.
     static SharedScriptData* new_(JSContext* cx, uint32_t codeLength,
-                                  uint32_t srcnotesLength, uint32_t natoms);
+                                  uint32_t srcnotesLength, uint32_t natoms,
+                                  SharedBytecode* bytecode = nullptr);
 
     uint32_t refCount() const {
         return refCount_;
@@ -1302,12 +1422,23 @@ class SharedScriptData
         MOZ_ASSERT(refCount_ != 0);
         uint32_t remain = --refCount_;
         if (remain == 0) {
-            js_free(this);
+            destroy();
         }
     }
 
+    void destroy() {
+        if (bytecode_) {
+            bytecode_->release();
+        }
+        js_free(this);
+    }
+
     size_t dataLength() const {
-        return (natoms_ * sizeof(GCPtrAtom)) + codeLength_ + noteLength_;
+        size_t length = natoms_ * sizeof(GCPtrAtom);
+        if (!bytecode_) {
+            length += codeLength_ + noteLength_;
+        }
+        return length;
     }
     const uint8_t* data() const {
         return reinterpret_cast<const uint8_t*>(data_);
@@ -1329,7 +1460,12 @@ class SharedScriptData
     uint32_t codeLength() const {
         return codeLength_;
     }
+    // The bytecode is never modified once it's shared, so handing out a
+    // mutable pointer to the shared copy is fine.
     jsbytecode* code() {
+        if (bytecode_) {
+            return const_cast<jsbytecode*>(bytecode_->code());
+        }
         return reinterpret_cast<jsbytecode*>(data() + natoms_ * sizeof(GCPtrAtom));
     }
 
@@ -1337,9 +1473,16 @@ class SharedScriptData
         return noteLength_;
     }
     jssrcnote* notes() {
+        if (bytecode_) {
+            return const_cast<jssrcnote*>(bytecode_->notes());
+        }
         return reinterpret_cast<jssrcnote*>(data() + natoms_ * sizeof(GCPtrAtom) + codeLength_);
     }
 
+    bool hasSharedBytecode() const {
+        return bytecode_ != nullptr;
+    }
+
     void traceChildren(JSTracer* trc);
 
   private:
@@ -1350,14 +1493,28 @@ class SharedScriptData
 
 struct ScriptBytecodeHasher
 {
+    // Lookups are either for the contents of a SharedScriptData, which is
+    // kept alive until the lookup is destroyed, or for atoms, bytecode and
+    // source notes which live somewhere else, such as in an XDR buffer being
+    // decoded.
     class Lookup {
         friend struct ScriptBytecodeHasher;
 
         SharedScriptData* scriptData;
+        const uint8_t* atoms;
+        uint32_t natoms;
+        const jsbytecode* code;
+        uint32_t codeLength;
+        const jssrcnote* notes;
+        uint32_t numNotes;
         HashNumber hash;
 
+        void computeHash();
+
       public:
         explicit Lookup(SharedScriptData* data);
+        Lookup(JSAtom* const* atoms, uint32_t natoms, const jsbytecode* code,
+               uint32_t codeLength, const jssrcnote* notes, uint32_t numNotes);
         ~Lookup();
     };
 
@@ -1365,17 +1522,23 @@ struct ScriptBytecodeHasher
         return l.hash;
     }
     static bool match(SharedScriptData* entry, const Lookup& lookup) {
-        const SharedScriptData* data = lookup.scriptData;
-        if (entry->natoms() != data->natoms()) {
+        if (entry->natoms() != lookup.natoms) {
             return false;
         }
-        if (entry->codeLength() != data->codeLength()) {
+        if (entry->codeLength() != lookup.codeLength) {
             return false;
         }
-        if (entry->numNotes() != data->numNotes()) {
+        if (entry->numNotes() != lookup.numNotes) {
             return false;
         }
-        return mozilla::ArrayEqual<uint8_t>(entry->data(), data->data(), data->dataLength());
+        if (lookup.natoms &&
+            !mozilla::ArrayEqual<uint8_t>(reinterpret_cast<const uint8_t*>(entry->atoms()),
+                                          lookup.atoms, lookup.natoms * sizeof(GCPtrAtom)))
+        {
+            return false;
+        }
+        return mozilla::ArrayEqual(entry->code(), lookup.code, lookup.codeLength) &&
+               mozilla::ArrayEqual(entry->notes(), lookup.notes, lookup.numNotes);
     }
 };
 
@@ -1515,6 +1678,13 @@ class JSScript : public js::gc::TenuredCell
     /* Number of type sets used in this script for dynamic type monitoring. */
     uint16_t nTypeSets_ = 0;
 
+    // 8-bit fields.
+
+    // Number of major GCs since the script last entered its Baseline or Ion
+    // code. JIT code is cleared to 0 in its prologue and aged by
+    // Zone::discardAgedJitCode.
+    uint8_t jitCodeAge_ = 0;
+
     // Bit fields.
 
   public:
@@ -2324,6 +2494,14 @@ class JSScript : public js::gc::TenuredCell
     bool createScriptData(JSContext* cx, uint32_t codeLength, uint32_t srcnotesLength,
                           uint32_t natoms);
     bool shareScriptData(JSContext* cx);
+
+    // Use the runtime's existing SharedScriptData for the given atoms,
+    // bytecode and source notes if there is one, and otherwise copy them into
+    // new shared data. This lets XDR decoding read the bytecode and notes in
+    // place from the buffer being decoded.
+    bool createOrShareScriptData(JSContext* cx, JSAtom* const* atoms, uint32_t natoms,
+                                 const jsbytecode* code, uint32_t codeLength,
+                                 const jssrcnote* notes, uint32_t numNotes);
     void freeScriptData();
     void setScriptData(js::SharedScriptData* data);
 
@@ -2334,6 +2512,14 @@ class JSScript : public js::gc::TenuredCell
     static size_t offsetOfWarmUpCounter() { return offsetof(JSScript, warmUpCount); }
     void resetWarmUpCounter() { incWarmUpResetCounter(); warmUpCount = 0; }
 
+    uint8_t jitCodeAge() const { return jitCodeAge_; }
+    void incJitCodeAge() {
+        if (jitCodeAge_ < UINT8_MAX) {
+            jitCodeAge_++;
+        }
+    }
+    static size_t offsetOfJitCodeAge() { return offsetof(JSScript, jitCodeAge_); }
+
     uint16_t getWarmUpResetCount() const { return warmUpResetCount; }
     uint16_t incWarmUpResetCounter(uint16_t amount = 1) { return warmUpResetCount += amount; }
     void resetWarmUpResetCounter() { warmUpResetCount = 0; }
@@ -2355,6 +2541,11 @@ class JSScript : public js::gc::TenuredCell
     void destroyScriptName();
     void clearHasScriptCounts();
 
+    // The script's entry in Realm::scriptLineTableMap, created on first use.
+    // Returns null if the table can't be allocated.
+    const js::ScriptLineTable* getOrCreateLineTable();
+    void destroyLineTable();
+
     jsbytecode* main() const {
         return code() + mainOffset();
     }
@@ -2814,6 +3005,10 @@ class LazyScript : public gc::TenuredCell
     uint32_t lineno_;
     uint32_t column_;
 
+    // The value of the function's length property, so that it can be read
+    // without delazifying the function. Not known for BinAST functions.
+    uint16_t funLength_;
+
     LazyScript(JSFunction* fun, ScriptSourceObject& sourceObject,
                void* table, uint64_t packedFields,
                uint32_t begin, uint32_t end, uint32_t toStringStart,
@@ -3071,6 +3266,14 @@ class LazyScript : public gc::TenuredCell
         return column_;
     }
 
+    uint16_t funLength() const {
+        MOZ_ASSERT(!isBinAST());
+        return funLength_;
+    }
+    void setFunLength(uint16_t funLength) {
+        funLength_ = funLength;
+    }
+
     void setToStringEnd(uint32_t toStringEnd) {
         MOZ_ASSERT(toStringStart_ <= toStringEnd);
         MOZ_ASSERT(toStringEnd_ >= sourceEnd_);
@@ -6,7 +6,12 @@
 
 #include "js/MemoryMetrics.h"
 
+#include "mozilla/XorShift128PlusRNG.h"
+
+#include <math.h>
+
 #include "gc/GC.h"
+#include "gc/GCInternals.h"
 #include "gc/Heap.h"
 #include "gc/Nursery.h"
 #include "gc/PublicIterators.h"
@@ -29,7 +34,10 @@
 #include "wasm/WasmJS.h"
 #include "wasm/WasmModule.h"
 
+#include "gc/PrivateIterators-inl.h"
+
 using mozilla::MallocSizeOf;
+using mozilla::Maybe;
 using mozilla::PodCopy;
 
 using namespace js;
@@ -357,7 +365,8 @@ StatsRealmCallback(JSContext* cx, void* data, Handle<Realm*> realm)
                                   &realmStats.varNamesSet,
                                   &realmStats.nonSyntacticLexicalScopesTable,
                                   &realmStats.jitRealm,
-                                  &realmStats.scriptCountsMap);
+                                  &realmStats.scriptCountsMap,
+                                  &realmStats.scriptLineTables);
 }
 
 static void
@@ -1020,4 +1029,280 @@ AddServoSizeOf(JSContext* cx, MallocSizeOf mallocSizeOf, ObjectPrivateVisitor* o
     return true;
 }
 
+// The malloc heap memory of a cell, for SampledHeapStats. Unlike
+// StatsCellCallback, this doesn't measure things which are shared between
+// cells, such as script sources and wasm code. Only objects and scripts are
+// attributed to a realm.
+static size_t
+SizeOfCellMallocHeap(MallocSizeOf mallocSizeOf, gc::Cell* cell, JS::TraceKind traceKind,
+                     Realm** realm)
+{
+    *realm = nullptr;
+
+    switch (traceKind) {
+      case JS::TraceKind::Object: {
+        JSObject* obj = static_cast<JSObject*>(cell);
+        *realm = obj->maybeCCWRealm();
+        JS::ClassInfo info;
+        obj->addSizeOfExcludingThis(mallocSizeOf, &info);
+        return info.sizeOfAllThings();
+      }
+
+      case JS::TraceKind::Script: {
+        JSScript* script = static_cast<JSScript*>(cell);
+        *realm = script->realm();
+        size_t size = script->sizeOfData(mallocSizeOf) +
+                      script->sizeOfTypeScript(mallocSizeOf) +
+                      jit::SizeOfIonData(script, mallocSizeOf);
+        size_t fallbackStubs = 0;
+        jit::AddSizeOfBaselineData(script, mallocSizeOf, &size, &fallbackStubs);
+        return size + fallbackStubs;
+      }
+
+      case JS::TraceKind::String:
+        return static_cast<JSString*>(cell)->sizeOfExcludingThis(mallocSizeOf);
+
+#ifdef ENABLE_BIGINT
+      case JS::TraceKind::BigInt:
+        return static_cast<JS::BigInt*>(cell)->sizeOfExcludingThis(mallocSizeOf);
+#endif
+
+      case JS::TraceKind::LazyScript:
+        return static_cast<LazyScript*>(cell)->sizeOfExcludingThis(mallocSizeOf);
+
+      case JS::TraceKind::Shape: {
+        JS::ShapeInfo info;
+        static_cast<Shape*>(cell)->addSizeOfExcludingThis(mallocSizeOf, &info);
+        return info.sizeOfAllThings();
+      }
+
+      case JS::TraceKind::ObjectGroup:
+        return static_cast<ObjectGroup*>(cell)->sizeOfExcludingThis(mallocSizeOf);
+
+      case JS::TraceKind::Scope:
+        return static_cast<Scope*>(cell)->sizeOfExcludingThis(mallocSizeOf);
+
+      case JS::TraceKind::RegExpShared:
+        return static_cast<RegExpShared*>(cell)->sizeOfExcludingThis(mallocSizeOf);
+
+      default:
+        // Symbols, base shapes and JIT code have no malloc heap memory of
+        // their own.
+        return 0;
+    }
+}
+
+// Each arena is sampled independently with probability p = 1 / N, so the sum
+// of N * x over the sampled arenas is an unbiased estimate of the sum of the
+// sizes x of all the arenas, with a variance estimated by the sum of
+// N * (N - 1) * x * x over the sampled arenas.
+struct SizeAccumulator
+{
+    double sum;
+    double sumOfSquares;
+
+    SizeAccumulator()
+      : sum(0), sumOfSquares(0)
+    {}
+
+    void add(size_t size) {
+        sum += double(size);
+        sumOfSquares += double(size) * double(size);
+    }
+
+    SizeEstimate estimate(uint32_t sampleInterval) const {
+        double n = sampleInterval;
+        SizeEstimate result;
+        result.estimate = size_t(n * sum);
+        result.errorBound = size_t(2 * sqrt(n * (n - 1) * sumOfSquares));
+        return result;
+    }
+};
+
+struct SizeAccumulators
+{
+    SizeAccumulator gcHeapThings;
+    SizeAccumulator mallocHeap;
+};
+
+struct SampledHeapStats::State
+{
+    // The sizes of the cells of one realm in the arena being measured.
+    struct ArenaRealmSizes
+    {
+        size_t realmIndex;
+        size_t gcHeapThings;
+        size_t mallocHeap;
+    };
+
+    using RealmIndexMap = HashMap<Realm*, size_t, DefaultHasher<Realm*>, SystemAllocPolicy>;
+
+    uint64_t majorGCNumber;
+    mozilla::non_crypto::XorShift128PlusRNG rng;
+
+    // The position of the measurement in the heap.
+    size_t zoneIndex;
+    gc::AllocKind kind;
+    Maybe<gc::ArenaIter> arenaIter;
+
+    // Indexed like SampledHeapStats::zones_ and realms_.
+    Vector<SizeAccumulators, 0, SystemAllocPolicy> zoneSizes;
+    Vector<SizeAccumulators, 0, SystemAllocPolicy> realmSizes;
+    RealmIndexMap realmIndices;
+
+    Vector<ArenaRealmSizes, 1, SystemAllocPolicy> arenaRealmSizes;
+
+    explicit State(JSRuntime* rt)
+      : majorGCNumber(rt->gc.majorGCCount()),
+        rng(rt->forkRandomKeyGenerator()),
+        zoneIndex(0),
+        kind(gc::AllocKind::FIRST)
+    {}
+
+    bool addRealm(RealmSizeEstimateVector& realms, Realm* realm, size_t* index) {
+        RealmIndexMap::AddPtr p = realmIndices.lookupForAdd(realm);
+        if (p) {
+            *index = p->value();
+            return true;
+        }
+
+        *index = realms.length();
+        return realms.emplaceBack(realm) &&
+               realmSizes.growBy(1) &&
+               realmIndices.add(p, realm, *index);
+    }
+
+    bool addArenaRealmSizes(size_t realmIndex, size_t gcHeapThings, size_t mallocHeap) {
+        for (ArenaRealmSizes& sizes : arenaRealmSizes) {
+            if (sizes.realmIndex == realmIndex) {
+                sizes.gcHeapThings += gcHeapThings;
+                sizes.mallocHeap += mallocHeap;
+                return true;
+            }
+        }
+        return arenaRealmSizes.append(ArenaRealmSizes { realmIndex, gcHeapThings, mallocHeap });
+    }
+};
+
+SampledHeapStats::SampledHeapStats(MallocSizeOf mallocSizeOf, uint32_t sampleInterval)
+  : mallocSizeOf_(mallocSizeOf),
+    sampleInterval_(sampleInterval)
+{
+    MOZ_ASSERT(sampleInterval > 0);
+}
+
+SampledHeapStats::~SampledHeapStats()
+{}
+
+bool
+SampledHeapStats::step(JSContext* cx, size_t arenaBudget, bool* done)
+{
+    *done = false;
+
+    // Rather than finishing an incremental GC, as CollectRuntimeStats does,
+    // wait for it to finish. It will start the measurement again anyway.
+    if (JS::IsIncrementalGCInProgress(cx)) {
+        return true;
+    }
+
+    JSRuntime* rt = cx->runtime();
+    gc::AutoPrepareForTracing prep(cx);
+
+    // Arenas and realms may have been freed by a GC since the last slice.
+    if (!state_ || state_->majorGCNumber != rt->gc.majorGCCount()) {
+        zones_.clear();
+        realms_.clear();
+        state_ = js::MakeUnique<State>(rt);
+        if (!state_) {
+            return false;
+        }
+
+        for (ZonesIter zone(rt, WithAtoms); !zone.done(); zone.next()) {
+            if (!zones_.emplaceBack(zone.get()) || !state_->zoneSizes.growBy(1)) {
+                return false;
+            }
+        }
+        for (RealmsIter realm(rt); !realm.done(); realm.next()) {
+            size_t index;
+            if (!state_->addRealm(realms_, realm, &index)) {
+                return false;
+            }
+        }
+    }
+
+    State& state = *state_;
+    size_t measured = 0;
+    for (; state.zoneIndex < zones_.length(); state.zoneIndex++) {
+        ZoneSizeEstimate& zoneEstimate = zones_[state.zoneIndex];
+        SizeAccumulators& zoneSizes = state.zoneSizes[state.zoneIndex];
+
+        while (state.kind < gc::AllocKind::LIMIT) {
+            if (state.arenaIter.isNothing()) {
+                state.arenaIter.emplace(zoneEstimate.zone, state.kind);
+            }
+
+            for (gc::ArenaIter& iter = *state.arenaIter; !iter.done(); iter.next()) {
+                if (arenaBudget && measured == arenaBudget) {
+                    return true;
+                }
+
+                zoneEstimate.gcHeapArenas += gc::ArenaSize;
+                if (state.rng.next() % sampleInterval_ != 0) {
+                    continue;
+                }
+                measured++;
+
+                gc::Arena* arena = iter.get();
+                JS::TraceKind traceKind = gc::MapAllocToTraceKind(state.kind);
+                size_t thingSize = gc::Arena::thingSize(state.kind);
+                size_t gcHeapThings = 0;
+                size_t mallocHeap = 0;
+                state.arenaRealmSizes.clear();
+                for (gc::ArenaCellIterUnbarriered cell(arena); !cell.done(); cell.next()) {
+                    Realm* realm;
+                    size_t cellMallocHeap =
+                        SizeOfCellMallocHeap(mallocSizeOf_, cell.getCell(), traceKind, &realm);
+                    gcHeapThings += thingSize;
+                    mallocHeap += cellMallocHeap;
+
+                    if (realm) {
+                        size_t realmIndex;
+                        if (!state.addRealm(realms_, realm, &realmIndex) ||
+                            !state.addArenaRealmSizes(realmIndex, thingSize, cellMallocHeap))
+                        {
+                            return false;
+                        }
+                    }
+                }
+
+                zoneSizes.gcHeapThings.add(gcHeapThings);
+                zoneSizes.mallocHeap.add(mallocHeap);
+                for (const State::ArenaRealmSizes& sizes : state.arenaRealmSizes) {
+                    SizeAccumulators& realmSizes = state.realmSizes[sizes.realmIndex];
+                    realmSizes.gcHeapThings.add(sizes.gcHeapThings);
+                    realmSizes.mallocHeap.add(sizes.mallocHeap);
+                }
+            }
+
+            state.arenaIter.reset();
+            state.kind = gc::AllocKind(size_t(state.kind) + 1);
+        }
+
+        state.kind = gc::AllocKind::FIRST;
+    }
+
+    for (size_t i = 0; i < zones_.length(); i++) {
+        zones_[i].gcHeapThings = state.zoneSizes[i].gcHeapThings.estimate(sampleInterval_);
+        zones_[i].mallocHeap = state.zoneSizes[i].mallocHeap.estimate(sampleInterval_);
+    }
+    for (size_t i = 0; i < realms_.length(); i++) {
+        realms_[i].gcHeapThings = state.realmSizes[i].gcHeapThings.estimate(sampleInterval_);
+        realms_[i].mallocHeap = state.realmSizes[i].mallocHeap.estimate(sampleInterval_);
+    }
+
+    state_.reset();
+    *done = true;
+    return true;
+}
+
 } // namespace JS
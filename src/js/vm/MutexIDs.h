@@ -26,6 +26,8 @@
   _(WasmLazyStubsTier1,          250) \
   _(WasmLazyStubsTier2,          251) \
                                       \
+  _(GCParallelTenuring,          275) \
+                                      \
   _(GlobalHelperThreadState,     300) \
                                       \
   _(GCLock,                      400) \
@@ -55,19 +57,41 @@
   _(WasmStreamEnd,               500) \
   _(WasmStreamStatus,            500) \
   _(WasmRuntimeInstances,        500) \
+  _(AsmJSModuleCache,            500) \
+  _(GCParallelMarker,            500) \
+  _(GCBackgroundFinalize,        500) \
+  _(JitBailoutCounts,            500) \
+  _(StackSampler,                500) \
+  _(CpuSampler,                  500) \
+  _(ModuleGraphCompilation,      500) \
+                                      \
+  _(SharedBytecodeTable,         501) \
                                       \
   _(IcuTimeZoneStateMutex,       600) \
   _(ThreadId,                    600) \
   _(WasmCodeSegmentMap,          600) \
   _(WasmDeferredValidation,      600) \
   _(TraceLoggerGraphState,       600) \
+  _(ArrayBufferContentsPool,     600) \
   _(VTuneLock,                   600)
 
 namespace js {
+
+// Each kind of mutex above, for the contention profiler. Mutexes created with
+// other ids count as Unknown.
+enum class MutexIndex : uint32_t
+{
+  Unknown = 0,
+#define DEFINE_MUTEX_INDEX(name, order) name,
+  FOR_EACH_MUTEX(DEFINE_MUTEX_INDEX)
+#undef DEFINE_MUTEX_INDEX
+  Limit
+};
+
 namespace mutexid {
 
 #define DEFINE_MUTEX_ID(name, order)  \
-static const MutexId name { #name, order };
+static const MutexId name { #name, order, uint32_t(MutexIndex::name) };
 FOR_EACH_MUTEX(DEFINE_MUTEX_ID)
 #undef DEFINE_MUTEX_ID
 
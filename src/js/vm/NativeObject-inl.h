@@ -230,7 +230,12 @@ NativeObject::shiftDenseElementsUnchecked(uint32_t count)
     MOZ_ASSERT(count > 0);
     MOZ_ASSERT(count < header->initializedLength);
 
-    if (MOZ_UNLIKELY(header->numShiftedElements() + count > ObjectElements::MaxShiftedElements)) {
+    uint32_t numShifted = header->numShiftedElements();
+    if (MOZ_UNLIKELY(numShifted > 0 &&
+                     (numShifted + count > ObjectElements::MaxShiftedElements ||
+                      (numShifted + count > ObjectElements::ShiftedElementsSlack &&
+                       numShifted + count > header->initializedLength - count))))
+    {
         moveShiftedElements();
         header = getElementsHeader();
     }
@@ -261,27 +266,18 @@ NativeObject::moveDenseElements(uint32_t dstStart, uint32_t srcStart, uint32_t c
      *
      * Since normal marking never happens on B, it is very important that the
      * write barrier is invoked here on B, despite the fact that it exists in
-     * the array before and after the move.
+     * the array before and after the move. Rather than barriering each store,
+     * trigger the pre-barrier once on every value in the range that is read
+     * or overwritten, after which the values can be moved with memmove.
      */
     if (JS::shadow::Zone::asShadowZone(zone())->needsIncrementalBarrier()) {
-        uint32_t numShifted = getElementsHeader()->numShiftedElements();
-        if (dstStart < srcStart) {
-            HeapSlot* dst = elements_ + dstStart;
-            HeapSlot* src = elements_ + srcStart;
-            for (uint32_t i = 0; i < count; i++, dst++, src++) {
-                dst->set(this, HeapSlot::Element, dst - elements_ + numShifted, *src);
-            }
-        } else {
-            HeapSlot* dst = elements_ + dstStart + count - 1;
-            HeapSlot* src = elements_ + srcStart + count - 1;
-            for (uint32_t i = 0; i < count; i++, dst--, src--) {
-                dst->set(this, HeapSlot::Element, dst - elements_ + numShifted, *src);
-            }
-        }
-    } else {
-        memmove(elements_ + dstStart, elements_ + srcStart, count * sizeof(HeapSlot));
-        elementsRangeWriteBarrierPost(dstStart, count);
+        uint32_t start = Min(dstStart, srcStart);
+        uint32_t end = Min(Max(dstStart, srcStart) + count, getDenseInitializedLength());
+        prepareElementRangeForOverwrite(start, end);
     }
+
+    memmove(elements_ + dstStart, elements_ + srcStart, count * sizeof(HeapSlot));
+    elementsRangeWriteBarrierPost(dstStart, count);
 }
 
 inline void
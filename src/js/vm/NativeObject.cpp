@@ -3074,6 +3074,56 @@ js::NativeDeleteProperty(JSContext* cx, HandleNativeObject obj, HandleId id,
     return SuppressDeletedProperty(cx, obj, id);
 }
 
+bool
+js::TryCopyShapeAndSlots(JSContext* cx, HandleNativeObject target, HandleNativeObject from,
+                         bool* copied)
+{
+    *copied = false;
+
+    if (target->inDictionaryMode() ||
+        !target->lastProperty()->isEmptyShape() ||
+        target->getDenseInitializedLength() > 0 ||
+        !target->isExtensible() ||
+        target->getClass()->getAddProperty() ||
+        from->inDictionaryMode() ||
+        from->zone() != target->zone() ||
+        from->is<TypedArrayObject>())
+    {
+        return true;
+    }
+
+    // The properties must be the ones |target| would end up with if they
+    // were added one by one, and |target| must have the empty shape the
+    // lineage starts from, which also means both objects have the same
+    // class, prototype and number of fixed slots.
+    Shape* shape = from->lastProperty();
+    if (shape->isEmptyShape()) {
+        return true;
+    }
+    for (; !shape->isEmptyShape(); shape = shape->previous()) {
+        if (!shape->isDataProperty() || shape->attributes() != JSPROP_ENUMERATE) {
+            return true;
+        }
+    }
+    if (shape != target->lastProperty()) {
+        return true;
+    }
+
+    RootedShape fromShape(cx, from->lastProperty());
+    if (!target->setLastProperty(cx, fromShape)) {
+        return false;
+    }
+
+    for (Shape::Range<NoGC> r(fromShape); !r.empty(); r.popFront()) {
+        Shape* prop = &r.front();
+        UpdateShapeTypeAndValueForWritableDataProp(cx, target, prop, prop->propid(),
+                                                   from->getSlot(prop->slot()));
+    }
+
+    *copied = true;
+    return true;
+}
+
 bool
 js::CopyDataPropertiesNative(JSContext* cx, HandlePlainObject target, HandleNativeObject from,
                              HandlePlainObject excludedItems, bool* optimized)
@@ -3095,6 +3145,18 @@ js::CopyDataPropertiesNative(JSContext* cx, HandlePlainObject target, HandleNati
         return true;
     }
 
+    // Spreading an object into an empty literal of the same kind can share
+    // its shape. Properties are defined here, so the prototype chain doesn't
+    // matter.
+    if (!excludedItems) {
+        if (!TryCopyShapeAndSlots(cx, target, from, optimized)) {
+            return false;
+        }
+        if (*optimized) {
+            return true;
+        }
+    }
+
     // Collect all enumerable data properties.
     using ShapeVector = GCVector<Shape*, 8>;
     Rooted<ShapeVector> shapes(cx, ShapeVector(cx));
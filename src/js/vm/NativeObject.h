@@ -176,7 +176,10 @@ ArraySetLength(JSContext* cx, Handle<ArrayObject*> obj, HandleId id,
  * to the next element and moving the ObjectElements header in memory (so it's
  * stored where the shifted Value used to be).
  *
- * Shifted elements can be moved when we grow the array, when the array is
+ * The shifted elements are moved back once they outnumber the remaining
+ * elements, so that a queue which is pushed to as well as shifted doesn't
+ * move its elements more often than every length shifts. Shifted elements
+ * can also be moved when we grow the array, when the array is
  * made non-extensible (for simplicity, shifted elements are not supported on
  * objects that are non-extensible, have copy-on-write elements, or on arrays
  * with non-writable length).
@@ -216,13 +219,20 @@ class ObjectElements
     };
 
     // The flags word stores both the flags and the number of shifted elements.
-    // Allow shifting 2047 elements before actually moving the elements.
-    static const size_t NumShiftedElementsBits = 11;
+    // Allow shifting 2047 elements, or as many elements as remain, before
+    // actually moving the elements. Moving them then costs no more than the
+    // shifts before it, so an array used as a queue with push and shift
+    // stays O(1) per operation however long it is, and the shifted space is
+    // at most about the size of the remaining elements.
+    static const size_t NumShiftedElementsBits = 24;
     static const size_t MaxShiftedElements = (1 << NumShiftedElementsBits) - 1;
     static const size_t NumShiftedElementsShift = 32 - NumShiftedElementsBits;
     static const size_t FlagsMask = (1 << NumShiftedElementsShift) - 1;
-    static_assert(MaxShiftedElements == 2047,
-                  "MaxShiftedElements should match the comment");
+    static const size_t ShiftedElementsSlack = 2047;
+    static_assert(ShiftedElementsSlack == 2047,
+                  "ShiftedElementsSlack should match the comment");
+    static_assert(FROZEN <= FlagsMask,
+                  "the flags must fit below the number of shifted elements");
 
   private:
     friend class ::JSObject;
@@ -1693,6 +1703,15 @@ bool IsPackedArray(JSObject* obj);
 extern void
 AddPropertyTypesAfterProtoChange(JSContext* cx, NativeObject* obj, ObjectGroup* oldGroup);
 
+// If |target| is empty and |from| only has writable, enumerable and
+// configurable data properties, added to an object with the same empty shape
+// as |target|, give |target| the shape of |from| and copy its slots, and set
+// |*copied|. This is how defining or assigning |from|'s properties on |target|
+// one by one would leave |target|, as long as no setters are involved.
+extern bool
+TryCopyShapeAndSlots(JSContext* cx, HandleNativeObject target, HandleNativeObject from,
+                     bool* copied);
+
 // Specializations of 7.3.23 CopyDataProperties(...) for NativeObjects.
 extern bool
 CopyDataPropertiesNative(JSContext* cx, HandlePlainObject target, HandleNativeObject from,
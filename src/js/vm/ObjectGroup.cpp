@@ -1421,6 +1421,62 @@ ObjectGroup::newPlainObject(JSContext* cx, IdValuePair* properties, size_t nprop
     return obj;
 }
 
+/* static */ JSObject*
+ObjectGroup::newPlainObjectWithLayout(JSContext* cx, HandleObjectGroup group, HandleShape shape,
+                                      IdValuePair* properties, size_t nproperties,
+                                      NewObjectKind newKind)
+{
+    MOZ_ASSERT(shape->slotSpan() == nproperties);
+    MOZ_ASSERT(newKind != SingletonObject);
+
+    mozilla::Maybe<AutoSweepObjectGroup> sweep;
+    sweep.emplace(group);
+
+    // The group may have switched to an unboxed layout since |shape| was made.
+    if (group->maybeUnboxedLayout(*sweep)) {
+        sweep.reset();
+        return UnboxedPlainObject::createWithProperties(cx, group, newKind, properties);
+    }
+
+    if (!group->unknownProperties(*sweep)) {
+        for (size_t i = 0; i < nproperties; i++) {
+            jsid id = IdToTypeId(properties[i].id);
+            TypeSet::Type type = GetValueTypeForTable(properties[i].value);
+            HeapTypeSet* types = group->maybeGetProperty(*sweep, id);
+            if (!types || !types->hasType(type)) {
+                AddTypePropertyId(cx, group, nullptr, id, type);
+            }
+        }
+    }
+
+    if (group->maybePreliminaryObjects(*sweep)) {
+        newKind = TenuredObject;
+    }
+
+    sweep.reset();
+
+    gc::AllocKind allocKind = gc::GetGCObjectKind(nproperties);
+    RootedPlainObject obj(cx, NewObjectWithGroup<PlainObject>(cx, group, allocKind,
+                                                              newKind));
+
+    if (!obj || !obj->setLastProperty(cx, shape)) {
+        return nullptr;
+    }
+
+    for (size_t i = 0; i < nproperties; i++) {
+        obj->setSlot(i, properties[i].value);
+    }
+
+    sweep.emplace(group);
+
+    if (group->maybePreliminaryObjects(*sweep)) {
+        group->maybePreliminaryObjects(*sweep)->registerNewObject(obj);
+        group->maybePreliminaryObjects(*sweep)->maybeAnalyze(cx, group);
+    }
+
+    return obj;
+}
+
 /////////////////////////////////////////////////////////////////////
 // ObjectGroupRealm AllocationSiteTable
 /////////////////////////////////////////////////////////////////////
@@ -567,6 +567,15 @@ class ObjectGroup : public gc::TenuredCell
                                     IdValuePair* properties, size_t nproperties,
                                     NewObjectKind newKind);
 
+    // Like newPlainObject, for properties whose ids are the same, in the same
+    // order, as those of |shape|, which is the last property of an object
+    // newPlainObject made with |group|. This avoids the table lookup, which
+    // hashes all the ids, when making many objects with the same layout.
+    static JSObject* newPlainObjectWithLayout(JSContext* cx, HandleObjectGroup group,
+                                              HandleShape shape,
+                                              IdValuePair* properties, size_t nproperties,
+                                              NewObjectKind newKind);
+
     // Static accessors for ObjectGroupRealm AllocationSiteTable.
 
     // Get a non-singleton group to use for objects created at the specified
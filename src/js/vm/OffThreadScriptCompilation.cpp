@@ -7,26 +7,41 @@
 #include "js/OffThreadScriptCompilation.h"
 
 #include "mozilla/Assertions.h" // MOZ_ASSERT
+#include "mozilla/LinkedList.h" // mozilla::LinkedList
 #include "mozilla/Range.h" // mozilla::Range
+#include "mozilla/Utf8.h" // mozilla::Utf8Unit
 #include "mozilla/Vector.h" // mozilla::Vector
 
 #include <stddef.h> // size_t
+#include <string.h> // memcpy
+#include <utility> // std::move
 
+#include "jsapi.h" // JS::CompileModule
 #include "jspubtd.h" // js::CurrentThreadCanAccessRuntime
 #include "jstypes.h" // JS_PUBLIC_API
 
+#include "builtin/ModuleObject.h" // js::ModuleObject, js::RequestedModuleObject
+#include "gc/GC.h" // js::gc::FinishGC
+#include "js/CharacterEncoding.h" // JS::LossyInflateUTF8ToBuffer
 #include "js/CompileOptions.h" // JS::ReadOnlyCompileOptions
-#include "vm/HelperThreads.h" // js::OffThreadParsingMustWaitForGC, js::StartOffThreadParseScript
+#include "js/SourceBufferHolder.h" // JS::SourceBufferHolder
+#include "threading/ConditionVariable.h" // js::ConditionVariable
+#include "threading/Mutex.h" // js::Mutex
+#include "vm/HelperThreads.h" // js::OffThreadParsingMustWaitForGC, js::StartOffThreadParse*
+#include "vm/JSAtom.h" // js::AtomizeString
 #include "vm/JSContext.h" // JSContext
+#include "vm/MutexIDs.h" // js::mutexid
 #include "vm/Runtime.h" // js::CanUseExtraThreads
 
 using namespace js;
 
 using JS::ReadOnlyCompileOptions;
 
+using mozilla::Utf8Unit;
+
 enum class OffThread
 {
-    Compile, Decode, DecodeBinAST
+    Compile, Decode, DecodeBinAST, ParseJSON
 };
 
 static bool
@@ -50,7 +65,9 @@ CanDoOffThread(JSContext* cx, const ReadOnlyCompileOptions& options, size_t leng
         // be faster to just start it synchronously on the main thread unless the
         // script is huge.
         if (OffThreadParsingMustWaitForGC(cx->runtime())) {
-            if (what == OffThread::Compile && length < HUGE_SRC_LENGTH) {
+            if ((what == OffThread::Compile || what == OffThread::ParseJSON) &&
+                length < HUGE_SRC_LENGTH)
+            {
                 return false;
             }
             if (what == OffThread::Decode && length < HUGE_BC_LENGTH) {
@@ -96,6 +113,16 @@ JS::CompileOffThread(JSContext* cx, const ReadOnlyCompileOptions& options,
     return StartOffThreadParseScript(cx, options, srcBuf, callback, callbackData);
 }
 
+JS_PUBLIC_API(bool)
+JS::CompileOffThreadUtf8(JSContext* cx, const ReadOnlyCompileOptions& options,
+                         const char* bytes, size_t length,
+                         OffThreadCompileCallback callback, void* callbackData)
+{
+    MOZ_ASSERT(CanCompileOffThread(cx, options, length));
+    return StartOffThreadParseScript(cx, options, reinterpret_cast<const Utf8Unit*>(bytes),
+                                     length, callback, callbackData);
+}
+
 JS_PUBLIC_API(JSScript*)
 JS::FinishOffThreadScript(JSContext* cx, JS::OffThreadToken* token)
 {
@@ -112,6 +139,206 @@ JS::CancelOffThreadScript(JSContext* cx, JS::OffThreadToken* token)
     HelperThreadState().cancelParseTask(cx->runtime(), ParseTaskKind::Script, token);
 }
 
+// The number of bytes in the UTF-8 sequence starting with |lead|, or 1 if
+// |lead| can't start one.
+static size_t
+UTF8SequenceLength(uint8_t lead)
+{
+    size_t n = 0;
+    while (n < 8 && (lead & (0x80 >> n))) {
+        n++;
+    }
+    return n >= 2 && n <= 4 ? n : 1;
+}
+
+static bool
+IsUTF8ContinuationByte(uint8_t unit)
+{
+    return (unit & 0xC0) == 0x80;
+}
+
+bool
+JS::OffThreadCompileStream::appendUTF8(const uint8_t* begin, size_t length)
+{
+    // Finish the code point which the last chunk left incomplete. If the
+    // sequence turns out to be malformed, the copy of it is cut short and the
+    // decoder replaces it.
+    if (partialLength_) {
+        size_t expected = UTF8SequenceLength(partial_[0]);
+        while (partialLength_ < expected && length && IsUTF8ContinuationByte(*begin)) {
+            partial_[partialLength_++] = *begin++;
+            length--;
+        }
+        if (partialLength_ < expected && !length) {
+            return true;
+        }
+
+        char16_t units[4];
+        size_t n = LossyInflateUTF8ToBuffer(UTF8Chars(reinterpret_cast<char*>(partial_),
+                                                      partialLength_),
+                                            units);
+        partialLength_ = 0;
+        if (!chars_.append(units, n)) {
+            return false;
+        }
+    }
+
+    // Hold back a code point which continues in the next chunk.
+    size_t complete = length;
+    for (size_t i = 1; i <= 3 && i <= length; i++) {
+        uint8_t unit = begin[length - i];
+        if (IsUTF8ContinuationByte(unit)) {
+            continue;
+        }
+        if (UTF8SequenceLength(unit) > i) {
+            complete = length - i;
+        }
+        break;
+    }
+
+    size_t oldLength = chars_.length();
+    if (!chars_.growByUninitialized(complete)) {
+        return false;
+    }
+    size_t n = LossyInflateUTF8ToBuffer(UTF8Chars(reinterpret_cast<const char*>(begin), complete),
+                                        chars_.begin() + oldLength);
+    chars_.shrinkTo(oldLength + n);
+
+    partialLength_ = length - complete;
+    memcpy(partial_, begin + complete, partialLength_);
+    return true;
+}
+
+bool
+JS::OffThreadCompileStream::appendUTF16(const uint8_t* begin, size_t length)
+{
+    if (partialLength_) {
+        if (!length) {
+            return true;
+        }
+        partial_[1] = *begin++;
+        length--;
+        partialLength_ = 0;
+
+        char16_t unit;
+        memcpy(&unit, partial_, sizeof(unit));
+        if (!chars_.append(unit)) {
+            return false;
+        }
+    }
+
+    size_t units = length / sizeof(char16_t);
+    size_t oldLength = chars_.length();
+    if (!chars_.growByUninitialized(units)) {
+        return false;
+    }
+    memcpy(chars_.begin() + oldLength, begin, units * sizeof(char16_t));
+
+    if (length % sizeof(char16_t)) {
+        partial_[0] = begin[length - 1];
+        partialLength_ = 1;
+    }
+    return true;
+}
+
+bool
+JS::OffThreadCompileStream::consumeChunk(const uint8_t* begin, size_t length)
+{
+    if (encoding_ == Encoding::UTF8) {
+        return appendUTF8(begin, length);
+    }
+    return appendUTF16(begin, length);
+}
+
+bool
+JS::OffThreadCompileStream::takeChars(JSContext* cx, UniqueTwoByteChars* chars, size_t* length)
+{
+    if (partialLength_) {
+        partialLength_ = 0;
+        if (!chars_.append(char16_t(0xFFFD))) {
+            ReportOutOfMemory(cx);
+            return false;
+        }
+    }
+
+    // Make sure that even an empty source has a buffer to hand over.
+    if (!chars_.reserve(1)) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+    *length = chars_.length();
+    chars->reset(chars_.extractOrCopyRawBuffer());
+    if (!*chars) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+    return true;
+}
+
+bool
+JS::OffThreadCompileStream::compile(JSContext* cx, const ReadOnlyCompileOptions& options,
+                                    OffThreadCompileCallback callback, void* callbackData)
+{
+    MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+
+    UniqueTwoByteChars chars;
+    size_t length;
+    if (!takeChars(cx, &chars, &length)) {
+        return false;
+    }
+
+    JS::SourceBufferHolder srcBuf(chars.release(), length,
+                                  JS::SourceBufferHolder::GiveOwnership);
+    return StartOffThreadParseScript(cx, options, srcBuf, callback, callbackData);
+}
+
+bool
+JS::OffThreadCompileStream::parseJSON(JSContext* cx, OffThreadCompileCallback callback,
+                                      void* callbackData)
+{
+    MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+
+    UniqueTwoByteChars chars;
+    size_t length;
+    if (!takeChars(cx, &chars, &length)) {
+        return false;
+    }
+
+    return StartOffThreadParseJSON(cx, std::move(chars), length, callback, callbackData);
+}
+
+JS_PUBLIC_API(bool)
+JS::CanParseJSONOffThread(JSContext* cx, size_t length)
+{
+    JS::CompileOptions options(cx);
+    return CanDoOffThread(cx, options, length, OffThread::ParseJSON);
+}
+
+JS_PUBLIC_API(bool)
+JS::ParseJSONOffThread(JSContext* cx, UniqueTwoByteChars chars, size_t length,
+                       OffThreadCompileCallback callback, void* callbackData)
+{
+    MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+    return StartOffThreadParseJSON(cx, std::move(chars), length, callback, callbackData);
+}
+
+JS_PUBLIC_API(bool)
+JS::FinishOffThreadJSON(JSContext* cx, JS::OffThreadToken* token, JS::MutableHandleValue vp)
+{
+    MOZ_ASSERT(cx);
+    MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+    return HelperThreadState().finishJSONParseTask(cx, token, vp);
+}
+
+JS_PUBLIC_API(void)
+JS::CancelOffThreadJSON(JSContext* cx, JS::OffThreadToken* token)
+{
+    MOZ_ASSERT(cx);
+    MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+    HelperThreadState().cancelParseTask(cx->runtime(), ParseTaskKind::JSON, token);
+}
+
 JS_PUBLIC_API(bool)
 JS::CompileOffThreadModule(JSContext* cx, const ReadOnlyCompileOptions& options,
                            JS::SourceBufferHolder& srcBuf,
@@ -202,3 +429,266 @@ JS::CancelMultiOffThreadScriptsDecoder(JSContext* cx, JS::OffThreadToken* token)
     MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
     HelperThreadState().cancelParseTask(cx->runtime(), ParseTaskKind::MultiScriptsDecode, token);
 }
+
+namespace {
+
+// The state of a CompileModuleGraph call.
+class ModuleGraphCompilation
+{
+    // A module being parsed off thread.
+    struct PendingParse : public mozilla::LinkedListElement<PendingParse>
+    {
+        ModuleGraphCompilation* compilation;
+        size_t index;
+
+        // The parse task only borrows the source, so it is kept here until the
+        // parse has finished.
+        JS::UniqueTwoByteChars chars;
+
+        // Set by the helper thread when the parse finishes.
+        JS::OffThreadToken* token;
+
+        PendingParse(ModuleGraphCompilation* compilation, size_t index,
+                     JS::UniqueTwoByteChars chars)
+          : compilation(compilation),
+            index(index),
+            chars(std::move(chars)),
+            token(nullptr)
+        {}
+    };
+
+    JSContext* cx;
+    const ReadOnlyCompileOptions& options;
+    JS::ModuleGraphLoader& loader;
+    JS::MutableHandle<JS::GCVector<JSObject*>> modules;
+    JS::MutableHandle<JS::GCVector<JSString*>> keys;
+
+    // The index of each key in |keys|. The keys are atoms, which stay alive
+    // and do not move as |keys| roots them.
+    HashMap<JSAtom*, size_t, DefaultHasher<JSAtom*>, SystemAllocPolicy> indices;
+
+    // The parses of each module, indexed like |modules|, and the number of
+    // parses which have not finished yet.
+    Vector<UniquePtr<PendingParse>, 0, SystemAllocPolicy> parses;
+    size_t outstandingParses;
+
+    // Parsed modules whose imports have not been loaded yet.
+    Vector<size_t, 0, SystemAllocPolicy> unscanned;
+
+    // Parses which have finished off thread but not been finished on the main
+    // thread. Protected by |lock|.
+    Mutex lock;
+    ConditionVariable parseFinished;
+    mozilla::LinkedList<PendingParse> finishedParses;
+
+    static void onParseFinished(JS::OffThreadToken* token, void* data);
+
+    bool addModule(JS::HandleString referrerKey, JS::HandleString specifier);
+    bool scanImports(size_t index);
+    PendingParse* waitForParse();
+    void cancelOutstandingParses();
+
+  public:
+    ModuleGraphCompilation(JSContext* cx, const ReadOnlyCompileOptions& options,
+                           JS::ModuleGraphLoader& loader,
+                           JS::MutableHandle<JS::GCVector<JSObject*>> modules,
+                           JS::MutableHandle<JS::GCVector<JSString*>> keys)
+      : cx(cx),
+        options(options),
+        loader(loader),
+        modules(modules),
+        keys(keys),
+        outstandingParses(0),
+        lock(mutexid::ModuleGraphCompilation)
+    {}
+
+    bool run(JS::HandleString rootSpecifier);
+};
+
+} // namespace
+
+/* static */ void
+ModuleGraphCompilation::onParseFinished(JS::OffThreadToken* token, void* data)
+{
+    PendingParse* parse = static_cast<PendingParse*>(data);
+    ModuleGraphCompilation* compilation = parse->compilation;
+
+    LockGuard<Mutex> guard(compilation->lock);
+    parse->token = token;
+    compilation->finishedParses.insertBack(parse);
+    compilation->parseFinished.notify_one();
+}
+
+bool
+ModuleGraphCompilation::addModule(JS::HandleString referrerKey, JS::HandleString specifier)
+{
+    RootedString resolved(cx, loader.resolve(cx, referrerKey, specifier));
+    if (!resolved) {
+        return false;
+    }
+
+    RootedAtom key(cx, AtomizeString(cx, resolved));
+    if (!key) {
+        return false;
+    }
+
+    auto p = indices.lookupForAdd(key);
+    if (p) {
+        return true;
+    }
+
+    size_t index = modules.length();
+    if (!indices.add(p, key.get(), index) ||
+        !modules.append(nullptr) ||
+        !keys.append(key.get()) ||
+        !parses.append(nullptr))
+    {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+    JS::OwningCompileOptions moduleOptions(cx);
+    if (!moduleOptions.copy(cx, options)) {
+        return false;
+    }
+
+    JS::UniqueTwoByteChars chars;
+    size_t length = 0;
+    if (!loader.fetch(cx, key, moduleOptions, chars, &length)) {
+        return false;
+    }
+
+    JS::SourceBufferHolder srcBuf(chars.get(), length, JS::SourceBufferHolder::NoOwnership);
+
+    if (!JS::CanCompileOffThread(cx, moduleOptions, length)) {
+        RootedObject module(cx);
+        if (!JS::CompileModule(cx, moduleOptions, srcBuf, &module)) {
+            return false;
+        }
+        modules[index].set(module);
+        if (!unscanned.append(index)) {
+            ReportOutOfMemory(cx);
+            return false;
+        }
+        return true;
+    }
+
+    parses[index] = MakeUnique<PendingParse>(this, index, std::move(chars));
+    if (!parses[index]) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+    if (!StartOffThreadParseModule(cx, moduleOptions, srcBuf, onParseFinished,
+                                   parses[index].get()))
+    {
+        return false;
+    }
+
+    outstandingParses++;
+    return true;
+}
+
+bool
+ModuleGraphCompilation::scanImports(size_t index)
+{
+    RootedString referrerKey(cx, keys[index]);
+    RootedString specifier(cx);
+
+    Rooted<ModuleObject*> module(cx, &modules[index]->as<ModuleObject>());
+    for (uint32_t i = 0; i < module->requestedModules().getDenseInitializedLength(); i++) {
+        const Value& request = module->requestedModules().getDenseElement(i);
+        specifier = request.toObject().as<RequestedModuleObject>().moduleSpecifier();
+        if (!addModule(referrerKey, specifier)) {
+            return false;
+        }
+    }
+    return true;
+}
+
+ModuleGraphCompilation::PendingParse*
+ModuleGraphCompilation::waitForParse()
+{
+    MOZ_ASSERT(outstandingParses);
+
+    // Parses which start during an incremental GC wait for it to end, so
+    // finish it rather than waiting for them forever.
+    if (OffThreadParsingMustWaitForGC(cx->runtime())) {
+        gc::FinishGC(cx);
+    }
+
+    UniqueLock<Mutex> guard(lock);
+    while (finishedParses.isEmpty()) {
+        parseFinished.wait(guard);
+    }
+
+    outstandingParses--;
+    return finishedParses.popFirst();
+}
+
+void
+ModuleGraphCompilation::cancelOutstandingParses()
+{
+    while (outstandingParses) {
+        PendingParse* parse = waitForParse();
+        JS::CancelOffThreadModule(cx, parse->token);
+    }
+}
+
+bool
+ModuleGraphCompilation::run(JS::HandleString rootSpecifier)
+{
+    if (!addModule(nullptr, rootSpecifier)) {
+        cancelOutstandingParses();
+        return false;
+    }
+
+    while (true) {
+        // Load the imports of the modules parsed so far, to get as many
+        // parses as possible running before waiting.
+        while (!unscanned.empty()) {
+            if (!scanImports(unscanned.popCopy())) {
+                cancelOutstandingParses();
+                return false;
+            }
+        }
+
+        if (!outstandingParses) {
+            break;
+        }
+
+        PendingParse* parse = waitForParse();
+        size_t index = parse->index;
+        JSObject* module = JS::FinishOffThreadModule(cx, parse->token);
+        parses[index] = nullptr;
+        if (!module) {
+            cancelOutstandingParses();
+            return false;
+        }
+
+        modules[index].set(module);
+        if (!unscanned.append(index)) {
+            ReportOutOfMemory(cx);
+            cancelOutstandingParses();
+            return false;
+        }
+    }
+
+    MOZ_ASSERT(modules.length() == keys.length());
+    return true;
+}
+
+JS_PUBLIC_API(bool)
+JS::CompileModuleGraph(JSContext* cx, const ReadOnlyCompileOptions& options,
+                       HandleString rootSpecifier, ModuleGraphLoader& loader,
+                       MutableHandle<GCVector<JSObject*>> modules,
+                       MutableHandle<GCVector<JSString*>> keys)
+{
+    MOZ_ASSERT(cx);
+    MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx->runtime()));
+    MOZ_ASSERT(modules.empty());
+    MOZ_ASSERT(keys.empty());
+
+    ModuleGraphCompilation compilation(cx, options, loader, modules, keys);
+    return compilation.run(rootSpecifier);
+}
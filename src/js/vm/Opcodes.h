@@ -2364,14 +2364,23 @@
      *   Operands:
      *   Stack: => import.meta
      */ \
-    macro(JSOP_IMPORTMETA,    232, "importmeta", NULL,      1,  0,  1,  JOF_BYTE)
+    macro(JSOP_IMPORTMETA,    232, "importmeta", NULL,      1,  0,  1,  JOF_BYTE) \
+    /*
+     * Pops the top stack value, pushes the value and a boolean value that
+     * indicates whether array destructuring of its first 'count' elements
+     * can read them directly, without using the iterator protocol.
+     *   Category: Statements
+     *   Type: Array
+     *   Operands: uint32_t count
+     *   Stack: arr => arr, optimized
+     */ \
+    macro(JSOP_OPTIMIZE_DESTRUCTURING, 233, "optimize-destructuring", NULL, 5, 1, 2, JOF_UINT32)
 
 /*
  * In certain circumstances it may be useful to "pad out" the opcode space to
  * a power of two.  Use this macro to do so.
  */
 #define FOR_EACH_TRAILING_UNUSED_OPCODE(macro) \
-    macro(233) \
     macro(234) \
     macro(235) \
     macro(236) \
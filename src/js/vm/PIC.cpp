@@ -37,11 +37,24 @@ js::ForOfPIC::Chain::initialize(JSContext* cx)
         return false;
     }
 
+    // Get the canonical %IteratorPrototype% and Object.prototype
+    RootedNativeObject iteratorProto(cx,
+        GlobalObject::getOrCreateIteratorPrototype(cx, cx->global()));
+    if (!iteratorProto) {
+        return false;
+    }
+    RootedNativeObject objectProto(cx, GlobalObject::getOrCreateObjectPrototype(cx, cx->global()));
+    if (!objectProto) {
+        return false;
+    }
+
     // From this point on, we can't fail.  Set initialized and fill the fields
     // for the canonical Array.prototype and ArrayIterator.prototype objects.
     initialized_ = true;
     arrayProto_ = arrayProto;
     arrayIteratorProto_ = arrayIteratorProto;
+    iteratorProto_ = iteratorProto;
+    objectProto_ = objectProto;
 
     // Shortcut returns below means Array for-of will never be optimizable,
     // do set disabled_ now, and clear it later when we succeed.
@@ -157,6 +170,58 @@ js::ForOfPIC::Chain::tryOptimizeArray(JSContext* cx, HandleArrayObject array, bo
     return true;
 }
 
+bool
+js::ForOfPIC::Chain::tryOptimizeArrayDestructuring(JSContext* cx, HandleArrayObject array,
+                                                   bool* optimized)
+{
+    if (!tryOptimizeArray(cx, array, optimized)) {
+        return false;
+    }
+
+    if (*optimized && !isIteratorReturnStillAbsent(cx)) {
+        *optimized = false;
+    }
+    return true;
+}
+
+bool
+js::ForOfPIC::Chain::isIteratorReturnStillAbsent(JSContext* cx)
+{
+    // Ensure PIC is initialized and not disabled.
+    MOZ_ASSERT(initialized_ && !disabled_);
+
+    // Ensure the prototype chain of ArrayIterator.prototype is unchanged.
+    // Object.prototype's own prototype is immutable.
+    if (arrayIteratorProto_->staticPrototype() != iteratorProto_ ||
+        iteratorProto_->staticPrototype() != objectProto_)
+    {
+        return false;
+    }
+
+    // ArrayIterator.prototype's shape is guarded by isArrayNextStillSane, so
+    // it only needs to be checked the first time around.
+    if (!iteratorProtoShape_ && arrayIteratorProto_->lookup(cx, cx->names().return_)) {
+        return false;
+    }
+
+    // Whenever the shape of one of the remaining prototypes changes, look
+    // for 'return' again and remember the new shape if it's still absent.
+    if (iteratorProto_->lastProperty() != iteratorProtoShape_) {
+        if (iteratorProto_->lookup(cx, cx->names().return_)) {
+            return false;
+        }
+        iteratorProtoShape_ = iteratorProto_->lastProperty();
+    }
+    if (objectProto_->lastProperty() != objectProtoShape_) {
+        if (objectProto_->lookup(cx, cx->names().return_)) {
+            return false;
+        }
+        objectProtoShape_ = objectProto_->lastProperty();
+    }
+
+    return true;
+}
+
 bool
 js::ForOfPIC::Chain::hasMatchingStub(ArrayObject* obj)
 {
@@ -211,6 +276,11 @@ js::ForOfPIC::Chain::reset()
     arrayIteratorProtoNextSlot_ = -1;
     canonicalNextFunc_ = UndefinedValue();
 
+    iteratorProto_ = nullptr;
+    objectProto_ = nullptr;
+    iteratorProtoShape_ = nullptr;
+    objectProtoShape_ = nullptr;
+
     initialized_ = false;
 }
 
@@ -241,9 +311,13 @@ js::ForOfPIC::Chain::trace(JSTracer* trc)
 
     TraceEdge(trc, &arrayProto_, "ForOfPIC Array.prototype.");
     TraceEdge(trc, &arrayIteratorProto_, "ForOfPIC ArrayIterator.prototype.");
+    TraceEdge(trc, &iteratorProto_, "ForOfPIC %IteratorPrototype%.");
+    TraceEdge(trc, &objectProto_, "ForOfPIC Object.prototype.");
 
     TraceEdge(trc, &arrayProtoShape_, "ForOfPIC Array.prototype shape.");
     TraceEdge(trc, &arrayIteratorProtoShape_, "ForOfPIC ArrayIterator.prototype shape.");
+    TraceNullableEdge(trc, &iteratorProtoShape_, "ForOfPIC %IteratorPrototype% shape.");
+    TraceNullableEdge(trc, &objectProtoShape_, "ForOfPIC Object.prototype shape.");
 
     TraceEdge(trc, &canonicalIteratorFunc_, "ForOfPIC ArrayValues builtin.");
     TraceEdge(trc, &canonicalNextFunc_, "ForOfPIC ArrayIterator.prototype.next builtin.");
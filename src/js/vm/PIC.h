@@ -165,6 +165,12 @@ struct ForOfPIC
      *  ArrayIterator.prototype's canonical value for 'next' (canonicalNextFunc_)
      *      To quickly retrieve and ensure that the 'next' method for ArrayIterator
      *      objects has not changed.
+     *
+     *  %IteratorPrototype% and Object.prototype (iteratorProto_, objectProto_)
+     *  and the shapes they had when neither defined 'return'
+     *  (iteratorProtoShape_, objectProtoShape_)
+     *      To ensure that closing an ArrayIterator early has no observable
+     *      effect, so array destructuring can read elements directly.
      */
     class Chain : public BaseChain
     {
@@ -185,6 +191,14 @@ struct ForOfPIC
         uint32_t arrayIteratorProtoNextSlot_;
         GCPtrValue canonicalNextFunc_;
 
+        // The rest of ArrayIterator.prototype's prototype chain, and the shapes
+        // of these objects when they were last seen without a 'return'
+        // property. The shapes are null until checked.
+        GCPtrNativeObject iteratorProto_;
+        GCPtrNativeObject objectProto_;
+        GCPtrShape iteratorProtoShape_;
+        GCPtrShape objectProtoShape_;
+
         // Initialization flag marking lazy initialization of above fields.
         bool initialized_;
 
@@ -204,6 +218,10 @@ struct ForOfPIC
             canonicalIteratorFunc_(UndefinedValue()),
             arrayIteratorProtoShape_(nullptr),
             arrayIteratorProtoNextSlot_(-1),
+            iteratorProto_(nullptr),
+            objectProto_(nullptr),
+            iteratorProtoShape_(nullptr),
+            objectProtoShape_(nullptr),
             initialized_(false),
             disabled_(false)
         {}
@@ -214,6 +232,13 @@ struct ForOfPIC
         // Try to optimize this chain for an object.
         bool tryOptimizeArray(JSContext* cx, HandleArrayObject array, bool* optimized);
 
+        // Try to optimize array destructuring for an object. In addition to
+        // the requirements of tryOptimizeArray, ArrayIterator objects must not
+        // have a 'return' method, as the iterator is closed without being
+        // exhausted when the array has more elements than the pattern.
+        bool tryOptimizeArrayDestructuring(JSContext* cx, HandleArrayObject array,
+                                           bool* optimized);
+
         // Check if the global array-related objects have not been messed with
         // in a way that would disable this PIC.
         bool isArrayStateStillSane();
@@ -228,6 +253,9 @@ struct ForOfPIC
         void sweep(FreeOp* fop);
 
       private:
+        // Check if ArrayIterator objects still don't have a 'return' method.
+        bool isIteratorReturnStillAbsent(JSContext* cx);
+
         // Check if a matching optimized stub for the given object exists.
         bool hasMatchingStub(ArrayObject* obj);
 
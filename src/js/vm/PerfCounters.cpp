@@ -0,0 +1,155 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "vm/PerfCounters.h"
+
+#include "mozilla/Assertions.h"
+
+#include <string.h>
+
+#ifdef XP_LINUX
+# include <linux/perf_event.h>
+# include <sys/ioctl.h>
+# include <sys/syscall.h>
+# include <unistd.h>
+#endif
+
+using namespace js;
+
+const char*
+js::PerfCounterName(PerfCounterKind kind)
+{
+    switch (kind) {
+#define PERF_COUNTER_NAME(name, text) case PerfCounterKind::name: return text;
+FOR_EACH_PERF_COUNTER(PERF_COUNTER_NAME)
+#undef PERF_COUNTER_NAME
+      case PerfCounterKind::Limit:
+        break;
+    }
+    MOZ_CRASH("bad PerfCounterKind");
+}
+
+PerfCounters::PerfCounters()
+  : numCounters_(0)
+{
+    for (auto& fd : fds_) {
+        fd = -1;
+    }
+}
+
+PerfCounters::~PerfCounters()
+{
+#ifdef XP_LINUX
+    // Close the group leader last.
+    for (size_t i = numCounters_; i != 0; i--) {
+        close(fds_[i - 1]);
+    }
+#endif
+}
+
+#ifdef XP_LINUX
+static void
+SetPerfEventConfig(PerfCounterKind kind, struct perf_event_attr* attr)
+{
+    switch (kind) {
+      case PerfCounterKind::Cycles:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_CPU_CYCLES;
+        return;
+      case PerfCounterKind::Instructions:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_INSTRUCTIONS;
+        return;
+      case PerfCounterKind::LLCMisses:
+        attr->type = PERF_TYPE_HARDWARE;
+        attr->config = PERF_COUNT_HW_CACHE_MISSES;
+        return;
+      case PerfCounterKind::DTLBMisses:
+        attr->type = PERF_TYPE_HW_CACHE;
+        attr->config = PERF_COUNT_HW_CACHE_DTLB |
+                       (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                       (PERF_COUNT_HW_CACHE_RESULT_MISS << 16);
+        return;
+      case PerfCounterKind::Limit:
+        break;
+    }
+    MOZ_CRASH("bad PerfCounterKind");
+}
+#endif
+
+bool
+PerfCounters::init()
+{
+    MOZ_ASSERT(!initialized());
+
+#ifdef XP_LINUX
+    for (size_t i = 0; i < Count; i++) {
+        PerfCounterKind kind = PerfCounterKind(i);
+
+        struct perf_event_attr attr;
+        memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        SetPerfEventConfig(kind, &attr);
+        attr.read_format = PERF_FORMAT_GROUP;
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+
+        // The group starts disabled, and all its counters are started
+        // together below.
+        bool leader = numCounters_ == 0;
+        attr.disabled = leader;
+
+        int groupFd = leader ? -1 : fds_[0];
+        int fd = int(syscall(__NR_perf_event_open, &attr, 0, -1, groupFd, 0));
+        if (fd < 0) {
+            // Without the cycle counter there is nothing worth reporting.
+            if (kind == PerfCounterKind::Cycles) {
+                return false;
+            }
+            continue;
+        }
+
+        fds_[numCounters_] = fd;
+        kinds_[numCounters_] = kind;
+        numCounters_++;
+    }
+
+    if (ioctl(fds_[0], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP) < 0) {
+        for (size_t i = numCounters_; i != 0; i--) {
+            close(fds_[i - 1]);
+        }
+        numCounters_ = 0;
+        return false;
+    }
+
+    return true;
+#else
+    return false;
+#endif
+}
+
+void
+PerfCounters::read(PerfCounterValues* values) const
+{
+    *values = PerfCounterValues();
+    if (!initialized()) {
+        return;
+    }
+
+#ifdef XP_LINUX
+    // With PERF_FORMAT_GROUP, the leader's fd reads the number of counters
+    // followed by their values.
+    uint64_t buffer[1 + Count];
+    ssize_t expected = ssize_t((1 + numCounters_) * sizeof(uint64_t));
+    if (::read(fds_[0], buffer, sizeof(buffer)) != expected || buffer[0] != numCounters_) {
+        return;
+    }
+
+    for (size_t i = 0; i < numCounters_; i++) {
+        values->counts[kinds_[i]] = buffer[1 + i];
+    }
+#endif
+}
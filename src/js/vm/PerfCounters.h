@@ -0,0 +1,105 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef vm_PerfCounters_h
+#define vm_PerfCounters_h
+
+#include "mozilla/Attributes.h"
+#include "mozilla/EnumeratedArray.h"
+
+#include <stdint.h>
+
+namespace js {
+
+#define FOR_EACH_PERF_COUNTER(_)     \
+    _(Cycles,       "cycles")        \
+    _(Instructions, "instructions")  \
+    _(LLCMisses,    "llc_misses")    \
+    _(DTLBMisses,   "dtlb_misses")
+
+enum class PerfCounterKind
+{
+#define DEFINE_PERF_COUNTER_KIND(name, text) name,
+FOR_EACH_PERF_COUNTER(DEFINE_PERF_COUNTER_KIND)
+#undef DEFINE_PERF_COUNTER_KIND
+    Limit
+};
+
+const char* PerfCounterName(PerfCounterKind kind);
+
+// Values of the hardware performance counters, either as read from the
+// counters or as the difference between two readings.
+struct PerfCounterValues
+{
+    mozilla::EnumeratedArray<PerfCounterKind, PerfCounterKind::Limit, uint64_t> counts;
+
+    PerfCounterValues() {
+        for (auto& count : counts) {
+            count = 0;
+        }
+    }
+
+    bool isZero() const {
+        for (auto count : counts) {
+            if (count) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    PerfCounterValues& operator+=(const PerfCounterValues& other) {
+        for (size_t i = 0; i < size_t(PerfCounterKind::Limit); i++) {
+            counts[PerfCounterKind(i)] += other.counts[PerfCounterKind(i)];
+        }
+        return *this;
+    }
+
+    // The counters only count up, but clamp at zero in case one was reset.
+    PerfCounterValues operator-(const PerfCounterValues& other) const {
+        PerfCounterValues result;
+        for (size_t i = 0; i < size_t(PerfCounterKind::Limit); i++) {
+            PerfCounterKind kind = PerfCounterKind(i);
+            result.counts[kind] = counts[kind] > other.counts[kind]
+                                  ? counts[kind] - other.counts[kind]
+                                  : 0;
+        }
+        return result;
+    }
+};
+
+// The hardware performance counters of the thread which calls init(), as a
+// perf_event_open group on Linux. Elsewhere, or if the kernel doesn't allow
+// access to the counters, init() fails and the counters read as zero.
+// Counters which the hardware doesn't have read as zero as well.
+class PerfCounters
+{
+    static const size_t Count = size_t(PerfCounterKind::Limit);
+
+    // The fd of the group leader is the first one in |fds_|.
+    int fds_[Count];
+
+    // The kinds of the counters in the group, in the order they are read.
+    PerfCounterKind kinds_[Count];
+    size_t numCounters_;
+
+  public:
+    PerfCounters();
+    ~PerfCounters();
+
+    PerfCounters(const PerfCounters&) = delete;
+    PerfCounters& operator=(const PerfCounters&) = delete;
+
+    MOZ_MUST_USE bool init();
+    bool initialized() const { return numCounters_ > 0; }
+
+    // Read the counters. Must be called on the thread which called init().
+    void read(PerfCounterValues* values) const;
+};
+
+} /* namespace js */
+
+#endif /* vm_PerfCounters_h */
@@ -190,7 +190,9 @@ Realm::ensureJitRealmExists(JSContext* cx)
 void
 js::DtoaCache::checkCacheAfterMovingGC()
 {
-    MOZ_ASSERT(!s || !IsForwarded(s));
+    for (const Entry& entry : entries) {
+        MOZ_ASSERT(!entry.s || !IsForwarded(entry.s));
+    }
 }
 
 namespace {
@@ -582,6 +584,15 @@ Realm::fixupScriptMapsAfterMovingGC()
             }
         }
     }
+
+    if (scriptLineTableMap) {
+        for (ScriptLineTableMap::Enum e(*scriptLineTableMap); !e.empty(); e.popFront()) {
+            JSScript* script = e.front().key();
+            if (!IsAboutToBeFinalizedUnbarriered(&script) && script != e.front().key()) {
+                e.rekeyFront(script);
+            }
+        }
+    }
 }
 
 #ifdef JSGC_HASH_TABLE_CHECKS
@@ -624,6 +635,16 @@ Realm::checkScriptMapsAfterMovingGC()
             MOZ_RELEASE_ASSERT(ptr.found() && &*ptr == &r.front());
         }
     }
+
+    if (scriptLineTableMap) {
+        for (auto r = scriptLineTableMap->all(); !r.empty(); r.popFront()) {
+            JSScript* script = r.front().key();
+            MOZ_ASSERT(script->realm() == this);
+            CheckGCThingAfterMovingGC(script);
+            auto ptr = scriptLineTableMap->lookup(script);
+            MOZ_RELEASE_ASSERT(ptr.found() && &*ptr == &r.front());
+        }
+    }
 }
 #endif
 
@@ -653,6 +674,7 @@ Realm::clearTables()
     objectGroups_.clearTables();
     savedStacks_.clear();
     varNames_.clear();
+    scriptLineTableMap.reset();
 }
 
 void
@@ -921,6 +943,12 @@ Realm::clearScriptNames()
     scriptNameMap.reset();
 }
 
+void
+Realm::clearScriptLineTables()
+{
+    scriptLineTableMap.reset();
+}
+
 void
 Realm::clearBreakpointsIn(FreeOp* fop, js::Debugger* dbg, HandleObject handler)
 {
@@ -967,7 +995,8 @@ Realm::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf,
                               size_t* varNamesSet,
                               size_t* nonSyntacticLexicalEnvironmentsArg,
                               size_t* jitRealm,
-                              size_t* scriptCountsMapArg)
+                              size_t* scriptCountsMapArg,
+                              size_t* scriptLineTablesArg)
 {
     *realmObject += mallocSizeOf(this);
     objectGroups_.addSizeOfExcludingThis(mallocSizeOf, tiAllocationSiteTables,
@@ -994,6 +1023,13 @@ Realm::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf,
             *scriptCountsMapArg += r.front().value()->sizeOfIncludingThis(mallocSizeOf);
         }
     }
+
+    if (scriptLineTableMap) {
+        *scriptLineTablesArg += scriptLineTableMap->shallowSizeOfIncludingThis(mallocSizeOf);
+        for (auto r = scriptLineTableMap->all(); !r.empty(); r.popFront()) {
+            *scriptLineTablesArg += r.front().value()->sizeOfIncludingThis(mallocSizeOf);
+        }
+    }
 }
 
 mozilla::HashCodeScrambler
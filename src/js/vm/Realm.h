@@ -8,6 +8,8 @@
 #define vm_Realm_h
 
 #include "mozilla/Atomics.h"
+#include "mozilla/Casting.h"
+#include "mozilla/HashFunctions.h"
 #include "mozilla/LinkedList.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/MemoryReporting.h"
@@ -44,29 +46,48 @@ class SetObject;
 struct NativeIterator;
 
 /*
- * A single-entry cache for some base-10 double-to-string conversions. This
- * helps date-format-xparb.js.  It also avoids skewing the results for
- * v8-splay.js when measured by the SunSpider harness, where the splay tree
- * initialization (which includes many repeated double-to-string conversions)
- * is erroneously included in the measurement; see bug 562553.
+ * A small direct-mapped cache for double-to-string conversions. This helps
+ * date-format-xparb.js and code which serializes the same numbers over and
+ * over. It also avoids skewing the results for v8-splay.js when measured by
+ * the SunSpider harness, where the splay tree initialization (which includes
+ * many repeated double-to-string conversions) is erroneously included in the
+ * measurement; see bug 562553.
  */
 class DtoaCache {
-    double       d;
-    int          base;
-    JSFlatString* s;      // if s==nullptr, d and base are not valid
+    struct Entry {
+        double       d;
+        int          base;
+        JSFlatString* s;      // if s==nullptr, d and base are not valid
+    };
+
+    static const size_t NumEntriesLog2 = 4;
+    static const size_t NumEntries = size_t(1) << NumEntriesLog2;
+    Entry entries[NumEntries];
+
+    static size_t index(int base, double d) {
+        uint64_t bits = mozilla::BitwiseCast<uint64_t>(d);
+        uint32_t hash = uint32_t(bits) ^ uint32_t(bits >> 32) ^ uint32_t(base);
+        return (hash * mozilla::kGoldenRatioU32) >> (32 - NumEntriesLog2);
+    }
 
   public:
-    DtoaCache() : s(nullptr) {}
-    void purge() { s = nullptr; }
+    DtoaCache() { purge(); }
+    void purge() {
+        for (Entry& entry : entries) {
+            entry.s = nullptr;
+        }
+    }
 
     JSFlatString* lookup(int base, double d) {
-        return this->s && base == this->base && d == this->d ? this->s : nullptr;
+        const Entry& entry = entries[index(base, d)];
+        return entry.s && base == entry.base && d == entry.d ? entry.s : nullptr;
     }
 
     void cache(int base, double d, JSFlatString* s) {
-        this->base = base;
-        this->d = d;
-        this->s = s;
+        Entry& entry = entries[index(base, d)];
+        entry.base = base;
+        entry.d = d;
+        entry.s = s;
     }
 
 #ifdef JSGC_HASH_TABLE_CHECKS
@@ -422,6 +443,7 @@ class JS::Realm : public JS::shadow::Realm
     js::UniquePtr<js::ScriptCountsMap> scriptCountsMap;
     js::UniquePtr<js::ScriptNameMap> scriptNameMap;
     js::UniquePtr<js::DebugScriptMap> debugScriptMap;
+    js::UniquePtr<js::ScriptLineTableMap> scriptLineTableMap;
 
     /*
      * Lazily initialized script source object to use for scripts cloned
@@ -473,7 +495,8 @@ class JS::Realm : public JS::shadow::Realm
                                 size_t* varNamesSet,
                                 size_t* nonSyntacticLexicalScopes,
                                 size_t* jitRealm,
-                                size_t* scriptCountsMapArg);
+                                size_t* scriptCountsMapArg,
+                                size_t* scriptLineTablesArg);
 
     JS::Zone* zone() {
         return zone_;
@@ -559,6 +582,7 @@ class JS::Realm : public JS::shadow::Realm
 
     void clearScriptCounts();
     void clearScriptNames();
+    void clearScriptLineTables();
 
     void purge();
 
@@ -611,6 +635,12 @@ class JS::Realm : public JS::shadow::Realm
     const void* addressOfMetadataBuilder() const {
         return &allocationMetadataBuilder_;
     }
+
+    // Whether the metadata builder only builds metadata for the allocations
+    // which SavedStacks samples, see SavedStacks::addressOfAllocationsUntilSample.
+    bool hasSampledAllocationMetadataBuilder() const {
+        return allocationMetadataBuilder_ == &js::SavedStacks::metadataBuilder;
+    }
     void setAllocationMetadataBuilder(const js::AllocationMetadataBuilder* builder);
     void forgetAllocationMetadataBuilder();
     void setNewObjectMetadata(JSContext* cx, JS::HandleObject obj);
@@ -991,7 +991,7 @@ js::StringHasRegExpMetaChars(JSLinearString* str)
 /* RegExpShared */
 
 RegExpShared::RegExpShared(JSAtom* source, RegExpFlag flags)
-  : source(source), flags(flags), canStringMatch(false), parenCount(0)
+  : source(source), literalPrefix(nullptr), flags(flags), canStringMatch(false), parenCount(0)
 {}
 
 void
@@ -1003,6 +1003,7 @@ RegExpShared::traceChildren(JSTracer* trc)
     }
 
     TraceNullableEdge(trc, &source, "RegExpShared source");
+    TraceNullableEdge(trc, &literalPrefix, "RegExpShared literal prefix");
     for (auto& comp : compilationArray) {
         TraceNullableEdge(trc, &comp.jitCode, "RegExpShared code");
     }
@@ -1039,6 +1040,95 @@ RegExpShared::compile(JSContext* cx, MutableHandleRegExpShared re, HandleLinearS
     return compile(cx, re, pattern, input, mode, force);
 }
 
+typedef Vector<char16_t, 32> LiteralPrefixVector;
+
+static bool
+AppendLiteralPrefix(irregexp::RegExpAtom* atom, bool unicodeMode, LiteralPrefixVector& prefix,
+                    bool* complete)
+{
+    *complete = false;
+    const irregexp::CharacterVector& data = atom->data();
+    for (size_t i = 0; i < data.length(); i++) {
+        char16_t c = data[i];
+        // In unicode mode a lone surrogate must not match half of a pair, which
+        // a plain substring search doesn't know about.
+        if (unicodeMode && unicode::IsSurrogate(c)) {
+            return true;
+        }
+        if (!prefix.append(c)) {
+            return false;
+        }
+    }
+    *complete = true;
+    return true;
+}
+
+// Append to |prefix| the literal characters which every match of |tree| starts
+// with. |*complete| is set when all of |tree| is literal, so that the caller
+// can continue with the term following it.
+static bool
+AppendLiteralPrefix(irregexp::RegExpTree* tree, bool unicodeMode, LiteralPrefixVector& prefix,
+                    bool* complete)
+{
+    *complete = false;
+
+    if (tree->IsAtom()) {
+        return AppendLiteralPrefix(tree->AsAtom(), unicodeMode, prefix, complete);
+    }
+
+    if (tree->IsText()) {
+        const irregexp::TextElementVector& elements = tree->AsText()->elements();
+        for (size_t i = 0; i < elements.length(); i++) {
+            if (elements[i].text_type() != irregexp::TextElement::ATOM) {
+                return true;
+            }
+            if (!AppendLiteralPrefix(elements[i].atom(), unicodeMode, prefix, complete)) {
+                return false;
+            }
+            if (!*complete) {
+                return true;
+            }
+        }
+        *complete = true;
+        return true;
+    }
+
+    if (tree->IsEmpty()) {
+        *complete = true;
+        return true;
+    }
+
+    if (tree->IsCapture()) {
+        return AppendLiteralPrefix(tree->AsCapture()->body(), unicodeMode, prefix, complete);
+    }
+
+    if (tree->IsAlternative()) {
+        const irregexp::RegExpTreeVector& nodes = tree->AsAlternative()->nodes();
+        for (size_t i = 0; i < nodes.length(); i++) {
+            if (!AppendLiteralPrefix(nodes[i], unicodeMode, prefix, complete)) {
+                return false;
+            }
+            if (!*complete) {
+                return true;
+            }
+        }
+        *complete = true;
+        return true;
+    }
+
+    // Assertions, quantifiers, classes, disjunctions and lookarounds end the
+    // literal prefix.
+    return true;
+}
+
+static bool
+StartsWithDotStar(JSAtom* pattern)
+{
+    return pattern->length() >= 2 &&
+           pattern->latin1OrTwoByteChar(0) == '.' &&
+           pattern->latin1OrTwoByteChar(1) == '*';
+}
+
 /* static */ bool
 RegExpShared::compile(JSContext* cx, MutableHandleRegExpShared re, HandleAtom pattern,
                       HandleLinearString input, CompilationMode mode, ForceByteCodeEnum force)
@@ -1063,6 +1153,27 @@ RegExpShared::compile(JSContext* cx, MutableHandleRegExpShared re, HandleAtom pa
 
     re->parenCount = data.capture_count;
 
+    // Find the literal text all matches start with, so execution can search
+    // for it with StringFindPattern instead of trying the RegExp code at every
+    // position. MatchOnly parsing may strip a leading '.*', which leaves a tree
+    // whose prefix is not valid for Normal executions, so don't look at those.
+    if (!re->literalPrefix && !re->canStringMatch && !re->ignoreCase() && !re->sticky() &&
+        (mode == Normal || !StartsWithDotStar(pattern)))
+    {
+        LiteralPrefixVector prefix(cx);
+        bool complete;
+        if (!AppendLiteralPrefix(data.tree, re->unicode(), prefix, &complete)) {
+            return false;
+        }
+        if (!prefix.empty()) {
+            JSAtom* atom = AtomizeChars(cx, prefix.begin(), prefix.length());
+            if (!atom) {
+                return false;
+            }
+            re->literalPrefix = atom;
+        }
+    }
+
     JitCodeTables tables;
     irregexp::RegExpCode code = irregexp::CompilePattern(cx, re, &data, input,
                                                          false /* global() */,
@@ -1180,6 +1291,15 @@ RegExpShared::execute(JSContext* cx, MutableHandleRegExpShared re, HandleLinearS
         return RegExpRunStatus_Success;
     }
 
+    // Skip ahead to the first place a match can start.
+    if (re->literalPrefix) {
+        int res = StringFindPattern(input, re->literalPrefix, start);
+        if (res == -1) {
+            return RegExpRunStatus_Success_NotFound;
+        }
+        start = res;
+    }
+
     do {
         jit::JitCode* code = re->compilation(mode, input->hasLatin1Chars()).jitCode;
         if (!code) {
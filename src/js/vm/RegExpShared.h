@@ -90,6 +90,13 @@ class RegExpShared : public gc::TenuredCell
     /* Source to the RegExp, for lazy compilation. */
     GCPtr<JSAtom*>     source;
 
+    /*
+     * Literal text every match must start with, or null. Execution searches
+     * for it before running the RegExp code, to skip over input which can't
+     * match.
+     */
+    GCPtr<JSAtom*>     literalPrefix;
+
     RegExpFlag         flags;
     bool               canStringMatch;
     size_t             parenCount;
@@ -152,6 +159,7 @@ class RegExpShared : public gc::TenuredCell
     size_t pairCount() const            { return getParenCount() + 1; }
 
     JSAtom* getSource() const           { return source; }
+    JSAtom* getLiteralPrefix() const    { return literalPrefix; }
     RegExpFlag getFlags() const         { return flags; }
     bool ignoreCase() const             { return flags & IgnoreCaseFlag; }
     bool global() const                 { return flags & GlobalFlag; }
@@ -176,6 +184,10 @@ class RegExpShared : public gc::TenuredCell
         return offsetof(RegExpShared, source);
     }
 
+    static size_t offsetOfLiteralPrefix() {
+        return offsetof(RegExpShared, literalPrefix);
+    }
+
     static size_t offsetOfFlags() {
         return offsetof(RegExpShared, flags);
     }
@@ -28,6 +28,7 @@
 #include "builtin/Promise.h"
 #include "gc/FreeOp.h"
 #include "gc/GCInternals.h"
+#include "gc/Memory.h"
 #include "gc/PublicIterators.h"
 #include "jit/arm/Simulator-arm.h"
 #include "jit/arm64/vixl/Simulator-vixl.h"
@@ -46,6 +47,7 @@
 #include "vm/JSAtom.h"
 #include "vm/JSObject.h"
 #include "vm/JSScript.h"
+#include "vm/StackSampler.h"
 #include "vm/TraceLogging.h"
 #include "vm/TraceLoggingGraph.h"
 
@@ -164,17 +166,20 @@ JSRuntime::JSRuntime(JSRuntime* parentRuntime)
     jitSupportsSimd(false),
     offthreadIonCompilationEnabled_(true),
     parallelParsingEnabled_(true),
+    sourceCompressionCodec_(js::SourceCompressionCodec::Zlib),
 #ifdef DEBUG
     offThreadParsesRunning_(0),
     offThreadParsingBlocked_(false),
 #endif
     autoWritableJitCodeActive_(false),
+    jitCodeReprotectionBatch_(nullptr),
     oomCallback(nullptr),
     debuggerMallocSizeOf(ReturnZeroSize),
     performanceMonitoring_(),
     stackFormat_(parentRuntime ? js::StackFormat::Default
                                : js::StackFormat::SpiderMonkey),
     wasmInstances(mutexid::WasmRuntimeInstances),
+    asmJSModuleCache(mutexid::AsmJSModuleCache),
     moduleResolveHook(),
     moduleMetadataHook()
 {
@@ -283,6 +288,9 @@ JSRuntime::destroyRuntime()
         CancelOffThreadParses(this);
         CancelOffThreadCompressions(this);
 
+        /* Release the cached asm.js modules, and the sources they hold. */
+        PurgeAsmJSModuleCache(this);
+
         /* Remove persistent GC roots. */
         gc.finishRoots();
 
@@ -371,6 +379,7 @@ JSRuntime::addSizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf, JS::Runtim
     rtSizes->contexts += mallocSizeOf(cx);
     rtSizes->contexts += cx->sizeOfExcludingThis(mallocSizeOf);
     rtSizes->temporary += cx->tempLifoAlloc().sizeOfExcludingThis(mallocSizeOf);
+    rtSizes->temporary += cx->lifoChunkPool().sizeOfExcludingThis(mallocSizeOf);
     rtSizes->interpreterStack += cx->interpreterStack().sizeOfExcludingThis(mallocSizeOf);
 #ifdef JS_TRACE_LOGGING
     if (cx->traceLogger) {
@@ -507,15 +516,16 @@ JSContext::requestInterrupt(InterruptReason reason)
     interruptBits_ |= uint32_t(reason);
     jitStackLimit = UINTPTR_MAX;
 
+    // Ion code at loop heads reads this page; see interruptPollPage().
+    if (interruptPollPage_) {
+        gc::ProtectPages(interruptPollPage_, gc::SystemAllocGranularity());
+    }
+
     if (reason == InterruptReason::CallbackUrgent) {
         // If this interrupt is urgent (slow script dialog for instance), take
         // additional steps to interrupt corner cases where the above fields are
         // not regularly polled.
-        FutexThread::lock();
-        if (fx.isWaiting()) {
-            fx.notify(FutexThread::NotifyForJSInterrupt);
-        }
-        fx.unlock();
+        fx.notifyIfWaitingForInterrupt();
         wasm::InterruptRunningCode(this);
     }
 }
@@ -528,8 +538,17 @@ JSContext::handleInterrupt()
         bool invokeCallback =
             hasPendingInterrupt(InterruptReason::CallbackUrgent) ||
             hasPendingInterrupt(InterruptReason::CallbackCanWait);
+        if (hasPendingInterrupt(InterruptReason::Sample) && stackSampler) {
+            stackSampler->sample();
+        }
+        if (hasPendingInterrupt(InterruptReason::CpuSample)) {
+            if (CpuSampler* sampler = runtime()->performanceMonitoring().cpuSampler()) {
+                sampler->sample(this);
+            }
+        }
         interruptBits_ = 0;
         resetJitStackLimit();
+        resetInterruptPoll();
         return HandleInterrupt(this, invokeCallback);
     }
     return true;
@@ -834,6 +853,11 @@ js::CurrentThreadCanAccessRuntime(const JSRuntime* rt)
 bool
 js::CurrentThreadCanAccessZone(Zone* zone)
 {
+    // GC helper threads may be handed a zone to sweep by the main thread.
+    if (zone->ownedByCurrentGCSweepTask()) {
+        return true;
+    }
+
     // Helper thread zones can only be used by their owning thread.
     if (zone->usedByHelperThread()) {
         return zone->ownedByCurrentHelperThread();
@@ -22,6 +22,8 @@
 #include <algorithm>
 #include <setjmp.h>
 
+#include "jsfriendapi.h"
+
 #include "builtin/AtomicsObject.h"
 #include "builtin/intl/SharedIntlData.h"
 #include "builtin/Promise.h"
@@ -40,6 +42,7 @@
 #include "js/Utility.h"
 #include "js/Vector.h"
 #include "threading/Thread.h"
+#include "vm/ArrayBufferContentsPool.h"
 #include "vm/Caches.h"
 #include "vm/CodeCoverage.h"
 #include "vm/CommonPropertyNames.h"
@@ -51,6 +54,7 @@
 #include "vm/Stack.h"
 #include "vm/Stopwatch.h"
 #include "vm/SymbolType.h"
+#include "wasm/AsmJS.h"
 #include "wasm/WasmTypes.h"
 
 namespace js {
@@ -96,6 +100,7 @@ class Activation;
 class ActivationIterator;
 
 namespace jit {
+class AutoBatchJitCodeReprotection;
 class JitRuntime;
 class JitActivation;
 struct PcScriptCache;
@@ -594,7 +599,8 @@ struct JSRuntime : public js::MallocProvider<JSRuntime>
         return selfHostingGlobal_;
     }
 
-    bool initSelfHosting(JSContext* cx);
+    bool initSelfHosting(JSContext* cx, const JS::TranscodeRange& xdrCache,
+                         JS::SelfHostedWriter xdrWriter);
     void finishSelfHosting();
     void traceSelfHostingGlobal(JSTracer* trc);
     bool isSelfHostingGlobal(JSObject* global) {
@@ -865,12 +871,16 @@ struct JSRuntime : public js::MallocProvider<JSRuntime>
     mozilla::Atomic<bool, mozilla::SequentiallyConsistent,
                     mozilla::recordreplay::Behavior::DontPreserve> parallelParsingEnabled_;
 
+    // The codec new source compression tasks use.
+    js::MainThreadData<js::SourceCompressionCodec> sourceCompressionCodec_;
+
 #ifdef DEBUG
     mozilla::Atomic<uint32_t> offThreadParsesRunning_;
     mozilla::Atomic<bool> offThreadParsingBlocked_;
 #endif
 
     js::MainThreadData<bool> autoWritableJitCodeActive_;
+    js::MainThreadData<js::jit::AutoBatchJitCodeReprotection*> jitCodeReprotectionBatch_;
 
   public:
 
@@ -889,6 +899,13 @@ struct JSRuntime : public js::MallocProvider<JSRuntime>
         return parallelParsingEnabled_;
     }
 
+    void setSourceCompressionCodec(js::SourceCompressionCodec codec) {
+        sourceCompressionCodec_ = codec;
+    }
+    js::SourceCompressionCodec sourceCompressionCodec() const {
+        return sourceCompressionCodec_;
+    }
+
 #ifdef DEBUG
 
     void incOffThreadParsesRunning() {
@@ -921,6 +938,13 @@ struct JSRuntime : public js::MallocProvider<JSRuntime>
         autoWritableJitCodeActive_ = b;
     }
 
+    js::jit::AutoBatchJitCodeReprotection* jitCodeReprotectionBatch() const {
+        return jitCodeReprotectionBatch_;
+    }
+    void setJitCodeReprotectionBatch(js::jit::AutoBatchJitCodeReprotection* batch) {
+        jitCodeReprotectionBatch_ = batch;
+    }
+
     /* See comment for JS::SetOutOfMemoryCallback in jsapi.h. */
     js::MainThreadData<JS::OutOfMemoryCallback> oomCallback;
     js::MainThreadData<void*> oomCallbackData;
@@ -969,11 +993,19 @@ struct JSRuntime : public js::MallocProvider<JSRuntime>
   public:
     js::RuntimeCaches& caches() { return caches_.ref(); }
 
+    // Zeroed contents of finalized ArrayBuffers, for reuse by new ones.
+    // Accessed by the main thread and by GC helper threads.
+    js::ArrayBufferContentsPool arrayBufferContentsPool;
+
     // List of all the live wasm::Instances in the runtime. Equal to the union
     // of all instances registered in all JS::Realms. Accessed from watchdog
     // threads for purposes of wasm::InterruptRunningCode().
     js::ExclusiveData<js::wasm::InstanceVector> wasmInstances;
 
+    // asm.js modules compiled in any realm of the runtime, for reuse by the
+    // others. Accessed by the main thread and by off-thread parse tasks.
+    js::ExclusiveData<js::AsmJSModuleCache> asmJSModuleCache;
+
     // The implementation-defined abstract operation HostResolveImportedModule.
     js::MainThreadData<JS::ModuleResolveHook> moduleResolveHook;
 
@@ -1386,6 +1386,22 @@ captureIsSatisfied(JSContext* cx, JSPrincipals* principals, const JSAtom* source
     return capture.match(m);
 }
 
+// Whether the chain of SavedFrames starting at |frame| has at most |maxFrames|
+// frames. A limit of zero means there is no limit.
+static bool
+SavedFrameChainFits(SavedFrame* frame, size_t maxFrames)
+{
+    if (maxFrames == 0) {
+        return true;
+    }
+    for (size_t n = 0; frame; frame = frame->getParent()) {
+        if (++n > maxFrames) {
+            return false;
+        }
+    }
+    return true;
+}
+
 bool
 SavedStacks::insertFrames(JSContext* cx, MutableHandleSavedFrame frame,
                           JS::StackCapture&& capture)
@@ -1432,6 +1448,16 @@ SavedStacks::insertFrames(JSContext* cx, MutableHandleSavedFrame frame,
                    ? FrameIter::IGNORE_DEBUGGER_EVAL_PREV_LINK
                    : FrameIter::FOLLOW_DEBUGGER_EVAL_PREV_LINK);
 
+    // Captures with a frame limit, like the ones for Error objects, can also
+    // use the LiveSavedFrameCache when there is no Debugger, as then there are
+    // no evalInFramePrev links and both iteration strategies see the same
+    // frames. A cached SavedFrame is only used if its chain fits within the
+    // remaining limit, and frames are only added to the cache if the capture
+    // reached the end of the stack, so that every cached chain is complete.
+    bool useCache = capture.is<JS::AllFrames>() ||
+                    (capture.is<JS::MaxFrames>() && cx->runtime()->debuggerList().isEmpty());
+    bool populateCache = useCache;
+
     // Once we've seen one frame with its hasCachedSavedFrame bit set, all its
     // parents (that can be cached) ought to have it set too.
     DebugOnly<bool> seenCached = false;
@@ -1445,13 +1471,24 @@ SavedStacks::insertFrames(JSContext* cx, MutableHandleSavedFrame frame,
             seenCached |= framePtr->hasCachedSavedFrame();
         }
 
-        if (capture.is<JS::AllFrames>() && framePtr && framePtr->hasCachedSavedFrame()) {
+        if (useCache && framePtr && framePtr->hasCachedSavedFrame()) {
             auto* cache = activation.getLiveSavedFrameCache(cx);
             if (!cache) {
                 return false;
             }
             cache->find(cx, *framePtr, iter.pc(), &parent);
 
+            // Don't use a chain with more frames than the capture wants. The
+            // cache entry is still valid, so stop looking at the cache and
+            // leave it alone.
+            if (parent && capture.is<JS::MaxFrames>() &&
+                !SavedFrameChainFits(parent, capture.as<JS::MaxFrames>().maxFrames))
+            {
+                parent.set(nullptr);
+                useCache = false;
+                populateCache = false;
+            }
+
             // Even though iter.hasCachedSavedFrame() was true, we can't
             // necessarily stop walking the stack here. We can get cache misses
             // for two reasons:
@@ -1498,13 +1535,14 @@ SavedStacks::insertFrames(JSContext* cx, MutableHandleSavedFrame frame,
         if (captureIsSatisfied(cx, principals, location.source(), capture)) {
             // The stack should end after the frame we just saved.
             parent.set(nullptr);
+            populateCache = false;
             break;
         }
 
         ++iter;
         framePtr = LiveSavedFrameCache::FramePtr::create(iter);
 
-        if (iter.activation() != &activation && capture.is<JS::AllFrames>()) {
+        if (iter.activation() != &activation && useCache) {
             // If there were no cache hits in the entire activation, clear its
             // cache so we'll be able to push new ones when we build the
             // SavedFrame chain.
@@ -1548,6 +1586,11 @@ SavedStacks::insertFrames(JSContext* cx, MutableHandleSavedFrame frame,
             if (!adoptAsyncStack(cx, &parent, causeAtom, maxFrames)) {
                 return false;
             }
+
+            // The async stack was clipped to this capture's limit.
+            if (!capture.is<JS::AllFrames>()) {
+                populateCache = false;
+            }
             break;
         }
 
@@ -1579,7 +1622,7 @@ SavedStacks::insertFrames(JSContext* cx, MutableHandleSavedFrame frame,
             return false;
         }
 
-        if (capture.is<JS::AllFrames>() && lookup->framePtr) {
+        if (populateCache && lookup->framePtr) {
             auto* cache = lookup->activation->getLiveSavedFrameCache(cx);
             if (!cache || !cache->insert(cx, *lookup->framePtr, lookup->pc, frame)) {
                 return false;
@@ -1850,14 +1893,48 @@ SavedStacks::chooseSamplingProbability(Realm* realm)
     }
     MOZ_ASSERT(foundAnyDebuggers);
 
-    if (!bernoulliSeeded) {
+    if (!samplingRNGSeeded) {
         mozilla::Array<uint64_t, 2> seed;
         GenerateXorShift128PlusSeed(seed);
-        bernoulli.setRandomState(seed[0], seed[1]);
-        bernoulliSeeded = true;
+        samplingRNG.setState(seed[0], seed[1]);
+        samplingRNGSeeded = true;
+    }
+
+    samplingProbability = probability;
+    if (probability > 0 && probability < 1) {
+        invLogNotSamplingProbability = 1 / log1p(-probability);
+    }
+    chooseAllocationsUntilSample();
+}
+
+void
+SavedStacks::chooseAllocationsUntilSample()
+{
+    if (samplingProbability >= 1) {
+        allocationsUntilSample = 0;
+        return;
+    }
+    if (samplingProbability <= 0) {
+        allocationsUntilSample = UINT32_MAX;
+        return;
+    }
+
+    // |x| is uniformly distributed in (0, 1].
+    double x = 1 - samplingRNG.nextDouble();
+    double skip = floor(log(x) * invLogNotSamplingProbability);
+    allocationsUntilSample = skip < double(UINT32_MAX) ? uint32_t(skip) : UINT32_MAX;
+}
+
+bool
+SavedStacks::sampleAllocation()
+{
+    if (allocationsUntilSample > 0) {
+        allocationsUntilSample--;
+        return false;
     }
 
-    bernoulli.setProbability(probability);
+    chooseAllocationsUntilSample();
+    return samplingProbability > 0;
 }
 
 JSObject*
@@ -1867,7 +1944,7 @@ SavedStacks::MetadataBuilder::build(JSContext* cx, HandleObject target,
     RootedObject obj(cx, target);
 
     SavedStacks& stacks = cx->realm()->savedStacks();
-    if (!stacks.bernoulli.trial()) {
+    if (!stacks.sampleAllocation()) {
         return nullptr;
     }
 
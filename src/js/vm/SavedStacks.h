@@ -8,8 +8,8 @@
 #define vm_SavedStacks_h
 
 #include "mozilla/Attributes.h"
-#include "mozilla/FastBernoulliTrial.h"
 #include "mozilla/Maybe.h"
+#include "mozilla/XorShift128PlusRNG.h"
 
 #include "js/HashTable.h"
 #include "js/Wrapper.h"
@@ -157,8 +157,11 @@ class SavedStacks {
   public:
     SavedStacks()
       : frames(),
-        bernoulliSeeded(false),
-        bernoulli(1.0, 0x59fdad7f6b4cc573, 0x91adf38db96a9354),
+        samplingRNGSeeded(false),
+        samplingRNG(0x59fdad7f6b4cc573, 0x91adf38db96a9354),
+        samplingProbability(1.0),
+        invLogNotSamplingProbability(0),
+        allocationsUntilSample(0),
         creatingSavedFrame(false)
     { }
 
@@ -177,7 +180,14 @@ class SavedStacks {
     // Set the sampling random number generator's state to |state0| and
     // |state1|. One or the other must be non-zero. See the comments for
     // mozilla::non_crypto::XorShift128PlusRNG::setState for details.
-    void setRNGState(uint64_t state0, uint64_t state1) { bernoulli.setRandomState(state0, state1); }
+    void setRNGState(uint64_t state0, uint64_t state1) { samplingRNG.setState(state0, state1); }
+
+    // The number of allocations which are skipped before the next one is
+    // sampled by the metadata builder. JIT code allocating objects inline
+    // decrements it, and takes the out of line path once it reaches zero.
+    const uint32_t* addressOfAllocationsUntilSample() const {
+        return &allocationsUntilSample;
+    }
 
     size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf);
 
@@ -193,8 +203,20 @@ class SavedStacks {
 
   private:
     SavedFrame::Set frames;
-    bool bernoulliSeeded;
-    mozilla::FastBernoulliTrial bernoulli;
+
+    // Each allocation is sampled independently with |samplingProbability|, so
+    // the number of allocations skipped before the next sample follows a
+    // geometric distribution. We draw it once per sample rather than doing a
+    // trial for every allocation.
+    bool samplingRNGSeeded;
+    mozilla::non_crypto::XorShift128PlusRNG samplingRNG;
+    double samplingProbability;
+    double invLogNotSamplingProbability;
+    uint32_t allocationsUntilSample;
+
+    void chooseAllocationsUntilSample();
+    bool sampleAllocation();
+
     bool creatingSavedFrame;
 
     // Similar to mozilla::ReentrancyGuard, but instead of asserting against
@@ -2393,6 +2393,13 @@ static const JSFunctionSpec intrinsic_functions[] = {
     JS_FN("std_Array_reverse",                   array_reverse,                0,0),
     JS_FNINFO("std_Array_splice",                array_splice, &array_splice_info, 2,0),
     JS_FN("ArrayNativeSort",                     intrinsic_ArrayNativeSort,    1,0),
+    JS_FN("ArrayNativeCopyWithin",               intrinsic_ArrayNativeCopyWithin, 4,0),
+    JS_INLINABLE_FN("ArrayNativeIndexOf",        intrinsic_ArrayNativeIndexOf, 4,0,
+                    IntrinsicArrayNativeIndexOf),
+    JS_INLINABLE_FN("ArrayNativeLastIndexOf",    intrinsic_ArrayNativeLastIndexOf, 4,0,
+                    IntrinsicArrayNativeLastIndexOf),
+    JS_INLINABLE_FN("ArrayNativeIncludes",       intrinsic_ArrayNativeIncludes, 4,0,
+                    IntrinsicArrayNativeIncludes),
 
     JS_FN("std_Date_now",                        date_now,                     0,0),
     JS_FN("std_Date_valueOf",                    date_valueOf,                 0,0),
@@ -2603,6 +2610,15 @@ static const JSFunctionSpec intrinsic_functions[] = {
           intrinsic_PossiblyWrappedTypedArrayHasDetachedBuffer, 1, 0),
 
     JS_FN("MoveTypedArrayElements",  intrinsic_MoveTypedArrayElements,  4,0),
+    JS_FN("TypedArrayNativeSort",    intrinsic_TypedArrayNativeSort,    1,0),
+    JS_INLINABLE_FN("TypedArrayNativeFill", intrinsic_TypedArrayNativeFill, 4,0,
+                    IntrinsicTypedArrayNativeFill),
+    JS_INLINABLE_FN("TypedArrayNativeIndexOf", intrinsic_TypedArrayNativeIndexOf, 3,0,
+                    IntrinsicTypedArrayNativeIndexOf),
+    JS_INLINABLE_FN("TypedArrayNativeLastIndexOf", intrinsic_TypedArrayNativeLastIndexOf, 3,0,
+                    IntrinsicTypedArrayNativeLastIndexOf),
+    JS_INLINABLE_FN("TypedArrayNativeIncludes", intrinsic_TypedArrayNativeIncludes, 3,0,
+                    IntrinsicTypedArrayNativeIncludes),
     JS_FN("SetFromTypedArrayApproach",intrinsic_SetFromTypedArrayApproach, 4, 0),
     JS_FN("SetOverlappingTypedElements",intrinsic_SetOverlappingTypedElements,3,0),
 
@@ -2638,6 +2654,7 @@ static const JSFunctionSpec intrinsic_functions[] = {
     JS_FN("TypedObjectIsAttached",          js::TypedObjectIsAttached, 1, 0),
     JS_FN("TypedObjectTypeDescr",           js::TypedObjectTypeDescr, 1, 0),
     JS_FN("ClampToUint8",                   js::ClampToUint8, 1, 0),
+    JS_FN("TypedObjectCopyBytes",           js::TypedObjectCopyBytes, 4, 0),
     JS_FN("GetTypedObjectModule",           js::GetTypedObjectModule, 0, 0),
 
     JS_INLINABLE_FN("ObjectIsTypeDescr"    ,          js::ObjectIsTypeDescr, 1, 0,
@@ -2741,6 +2758,8 @@ static const JSFunctionSpec intrinsic_functions[] = {
     JS_INLINABLE_FN("RegExpInstanceOptimizable", RegExpInstanceOptimizable, 1,0,
                     RegExpInstanceOptimizable),
     JS_FN("RegExpGetSubstitution", intrinsic_RegExpGetSubstitution, 5,0),
+    JS_FN("RegExpGlobalReplaceString", RegExpGlobalReplaceString, 4,0),
+    JS_FN("RegExpSplitOpt", RegExpSplitOpt, 3,0),
     JS_FN("GetElemBaseForLambda", intrinsic_GetElemBaseForLambda, 1,0),
     JS_FN("GetStringDataProperty", intrinsic_GetStringDataProperty, 2,0),
     JS_INLINABLE_FN("GetFirstDollarIndex", GetFirstDollarIndex, 1,0,
@@ -2949,8 +2968,30 @@ VerifyGlobalNames(JSContext* cx, Handle<GlobalObject*> shg)
     return true;
 }
 
+static bool
+CompileSelfHostedScript(JSContext* cx, MutableHandleScript script)
+{
+    uint32_t srcLen = GetRawScriptsSize();
+
+    const unsigned char* compressed = compressedSources;
+    uint32_t compressedLen = GetCompressedSize();
+    auto src = cx->make_pod_array<char>(srcLen);
+    if (!src || !DecompressString(compressed, compressedLen,
+                                  reinterpret_cast<unsigned char*>(src.get()), srcLen))
+    {
+        return false;
+    }
+
+    CompileOptions options(cx);
+    FillSelfHostingCompileOptions(options);
+    options.setIsRunOnce(true);
+
+    return CompileUtf8(cx, options, src.get(), srcLen, script);
+}
+
 bool
-JSRuntime::initSelfHosting(JSContext* cx)
+JSRuntime::initSelfHosting(JSContext* cx, const JS::TranscodeRange& xdrCache,
+                           JS::SelfHostedWriter xdrWriter)
 {
     MOZ_ASSERT(!selfHostingGlobal_);
 
@@ -2982,22 +3023,39 @@ JSRuntime::initSelfHosting(JSContext* cx)
      */
     AutoSelfHostingErrorReporter errorReporter(cx);
 
-    uint32_t srcLen = GetRawScriptsSize();
+    // XDR checks the build id when decoding, so bytecode from another build
+    // is ignored, as is bytecode which is corrupt.
+    bool canUseXDR = bool(GetBuildId);
 
-    const unsigned char* compressed = compressedSources;
-    uint32_t compressedLen = GetCompressedSize();
-    auto src = cx->make_pod_array<char>(srcLen);
-    if (!src || !DecompressString(compressed, compressedLen,
-                                  reinterpret_cast<unsigned char*>(src.get()), srcLen))
-    {
-        return false;
+    RootedScript script(cx);
+    if (canUseXDR && xdrCache.length()) {
+        JS::TranscodeResult result = JS::DecodeScript(cx, xdrCache, &script);
+        if (result == JS::TranscodeResult_Throw) {
+            return false;
+        }
+        MOZ_ASSERT_IF(result != JS::TranscodeResult_Ok, !script);
     }
 
-    CompileOptions options(cx);
-    FillSelfHostingCompileOptions(options);
+    if (!script) {
+        if (!CompileSelfHostedScript(cx, &script)) {
+            return false;
+        }
+
+        // Encode the script before running it, as running it may change the
+        // singleton objects it contains.
+        if (canUseXDR && xdrWriter) {
+            JS::TranscodeBuffer buffer;
+            if (JS::EncodeScript(cx, buffer, script) != JS::TranscodeResult_Ok) {
+                return false;
+            }
+            if (!xdrWriter(cx, JS::TranscodeRange(buffer.begin(), buffer.length()))) {
+                return false;
+            }
+        }
+    }
 
     RootedValue rv(cx);
-    if (!EvaluateUtf8(cx, options, src.get(), srcLen, &rv)) {
+    if (!JS_ExecuteScript(cx, script, &rv)) {
         return false;
     }
 
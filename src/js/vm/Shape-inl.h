@@ -303,8 +303,8 @@ ShapeTable::searchUnchecked(jsid id)
     }
 
     /* Hit: return entry. */
-    Shape* shape = entry->shape();
-    if (shape && shape->propidRaw() == id) {
+    if (entry->matches(id)) {
+        MOZ_ASSERT(entry->shape()->propidRaw() == id);
         return *entry;
     }
 
@@ -342,8 +342,8 @@ ShapeTable::searchUnchecked(jsid id)
             return (Adding == MaybeAdding::Adding && firstRemoved) ? *firstRemoved : *entry;
         }
 
-        shape = entry->shape();
-        if (shape && shape->propidRaw() == id) {
+        if (entry->matches(id)) {
+            MOZ_ASSERT(entry->shape()->propidRaw() == id);
             MOZ_ASSERT(collisionFlag);
             return *entry;
         }
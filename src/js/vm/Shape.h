@@ -240,6 +240,14 @@ class ShapeTable {
 
         Shape* shape_;
 
+        // The id of the shape, so that searches compare ids without loading
+        // the shapes they pass over. This is never the id being searched
+        // for in free and removed entries: entries are allocated zeroed,
+        // which isn't the id of any property, and are emptied to JSID_EMPTY.
+        // Property ids are atoms, symbols or integers, none of which are
+        // moved by the GC.
+        jsid id_;
+
         Entry() = delete;
         Entry(const Entry&) = delete;
         Entry& operator=(const Entry&) = delete;
@@ -250,27 +258,22 @@ class ShapeTable {
         bool isLive() const { return !isFree() && !isRemoved(); }
         bool hadCollision() const { return uintptr_t(shape_) & SHAPE_COLLISION; }
 
-        void setFree() { shape_ = nullptr; }
-        void setRemoved() { shape_ = SHAPE_REMOVED; }
+        void setFree() { shape_ = nullptr; id_ = JSID_EMPTY; }
+        void setRemoved() { shape_ = SHAPE_REMOVED; id_ = JSID_EMPTY; }
 
         Shape* shape() const {
             return reinterpret_cast<Shape*>(uintptr_t(shape_) & ~SHAPE_COLLISION);
         }
 
-        void setShape(Shape* shape) {
-            MOZ_ASSERT(isFree());
-            MOZ_ASSERT(shape);
-            MOZ_ASSERT(shape != SHAPE_REMOVED);
-            shape_ = shape;
-            MOZ_ASSERT(!hadCollision());
-        }
+        // Whether this is the live entry for |id|.
+        bool matches(jsid id) const { return id_ == id; }
+
+        inline void setShape(Shape* shape);
 
         void flagCollision() {
             shape_ = reinterpret_cast<Shape*>(uintptr_t(shape_) | SHAPE_COLLISION);
         }
-        void setPreservingCollision(Shape* shape) {
-            shape_ = reinterpret_cast<Shape*>(uintptr_t(shape) | uintptr_t(hadCollision()));
-        }
+        inline void setPreservingCollision(Shape* shape);
     };
 
   private:
@@ -1178,6 +1181,9 @@ class Shape : public gc::TenuredCell
         JS_STATIC_ASSERT(offsetof(Shape, immutableFlags) == offsetof(js::shadow::Shape, immutableFlags));
         JS_STATIC_ASSERT(FIXED_SLOTS_SHIFT == js::shadow::Shape::FIXED_SLOTS_SHIFT);
         JS_STATIC_ASSERT(FIXED_SLOTS_MASK == js::shadow::Shape::FIXED_SLOTS_MASK);
+        static_assert(sizeof(Shape) == 4 * sizeof(uintptr_t) + sizeof(uint64_t),
+                      "Shapes are allocated in bulk: the slot, fixed slot count, "
+                      "attrs and flags must keep sharing a single word");
     }
 };
 
@@ -1633,6 +1639,24 @@ Shape::matches(const StackShape& other) const
                                 other.rawGetter, other.rawSetter);
 }
 
+inline void
+ShapeTable::Entry::setShape(Shape* shape)
+{
+    MOZ_ASSERT(isFree());
+    MOZ_ASSERT(shape);
+    MOZ_ASSERT(shape != SHAPE_REMOVED);
+    shape_ = shape;
+    id_ = shape->propidRaw();
+    MOZ_ASSERT(!hadCollision());
+}
+
+inline void
+ShapeTable::Entry::setPreservingCollision(Shape* shape)
+{
+    shape_ = reinterpret_cast<Shape*>(uintptr_t(shape) | uintptr_t(hadCollision()));
+    id_ = shape ? shape->propidRaw() : JSID_EMPTY;
+}
+
 Shape*
 ReshapeForAllocKind(JSContext* cx, Shape* shape, TaggedProto proto,
                     gc::AllocKind allocKind);
@@ -18,8 +18,6 @@
 
 namespace js {
 
-class FutexWaiter;
-
 /*
  * SharedArrayRawBuffer
  *
@@ -55,10 +53,6 @@ class SharedArrayRawBuffer
     size_t   mappedSize_;         // Does not include the page for the header
     bool     preparedForWasm_;
 
-    // A list of structures representing tasks waiting on some
-    // location within this buffer.
-    FutexWaiter* waiters_;
-
     uint8_t* basePointer() {
         SharedMem<uint8_t*> p = dataPointerShared() - gc::SystemPageSize();
         MOZ_ASSERT(p.asValue() % gc::SystemPageSize() == 0);
@@ -73,8 +67,7 @@ class SharedArrayRawBuffer
         length_(length),
         maxSize_(maxSize),
         mappedSize_(mappedSize),
-        preparedForWasm_(preparedForWasm),
-        waiters_(nullptr)
+        preparedForWasm_(preparedForWasm)
     {
         MOZ_ASSERT(buffer == dataPointerShared());
     }
@@ -97,18 +90,6 @@ class SharedArrayRawBuffer
     // max must be Something for wasm, Nothing for other uses
     static SharedArrayRawBuffer* Allocate(uint32_t initial, const mozilla::Maybe<uint32_t>& max);
 
-    // This may be called from multiple threads.  The caller must take
-    // care of mutual exclusion.
-    FutexWaiter* waiters() const {
-        return waiters_;
-    }
-
-    // This may be called from multiple threads.  The caller must take
-    // care of mutual exclusion.
-    void setWaiters(FutexWaiter* waiters) {
-        waiters_ = waiters;
-    }
-
     SharedMem<uint8_t*> dataPointerShared() const {
         uint8_t* ptr = reinterpret_cast<uint8_t*>(const_cast<SharedArrayRawBuffer*>(this));
         return SharedMem<uint8_t*>::shared(ptr + sizeof(SharedArrayRawBuffer));
@@ -0,0 +1,315 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "vm/StackSampler.h"
+
+#include "mozilla/IntegerPrintfMacros.h"
+#include "mozilla/Move.h"
+
+#include "jsfriendapi.h"
+
+#include "js/Printf.h"
+#include "threading/LockGuard.h"
+#include "util/Text.h"
+#include "vm/JSContext.h"
+#include "vm/JSONPrinter.h"
+#include "vm/JSScript.h"
+#include "vm/Printer.h"
+#include "vm/Stack.h"
+#include "vm/StringType.h"
+
+using namespace js;
+
+using mozilla::TimeDuration;
+using mozilla::TimeStamp;
+
+StackSampler::StackSampler(JSContext* cx, uint32_t intervalMicroseconds)
+  : cx_(cx),
+    interval_(TimeDuration::FromMicroseconds(intervalMicroseconds)),
+    lock_(mutexid::StackSampler),
+    stopping_(false)
+{}
+
+StackSampler::~StackSampler()
+{
+    stop();
+}
+
+bool
+StackSampler::start()
+{
+    MOZ_ASSERT(!thread_.joinable());
+
+    // Node 0 is the root of the tree.
+    if (!nodes_.emplaceBack(UINT32_MAX)) {
+        return false;
+    }
+
+    startTime_ = lastSampleTime_ = TimeStamp::Now();
+    return thread_.init(threadMain, this);
+}
+
+void
+StackSampler::stop()
+{
+    if (!thread_.joinable()) {
+        return;
+    }
+
+    {
+        LockGuard<Mutex> guard(lock_);
+        stopping_ = true;
+        wakeup_.notify_all();
+    }
+    thread_.join();
+}
+
+/* static */ void
+StackSampler::threadMain(StackSampler* sampler)
+{
+    ThisThread::SetName("JS Stack Sampler");
+
+    UniqueLock<Mutex> lock(sampler->lock_);
+    while (!sampler->stopping_) {
+        if (sampler->wakeup_.wait_for(lock, sampler->interval_) == CVStatus::Timeout &&
+            !sampler->stopping_)
+        {
+            sampler->cx_->requestInterrupt(InterruptReason::Sample);
+        }
+    }
+}
+
+bool
+StackSampler::lookupOrAddFrame(UniqueChars functionName, UniqueChars url, uint32_t line,
+                               uint32_t* index)
+{
+    UniqueChars key = JS_smprintf("%s\t%s\t%" PRIu32, functionName.get(), url.get(), line);
+    if (!key) {
+        return false;
+    }
+
+    FrameMap::AddPtr p = frameMap_.lookupForAdd(key.get());
+    if (p) {
+        *index = p->value();
+        return true;
+    }
+
+    uint32_t newIndex = frames_.length();
+    const char* keyChars = key.get();
+    if (!frames_.append(Frame { std::move(key), std::move(functionName), std::move(url), line })) {
+        return false;
+    }
+    if (!frameMap_.add(p, keyChars, newIndex)) {
+        frames_.popBack();
+        return false;
+    }
+
+    *index = newIndex;
+    return true;
+}
+
+bool
+StackSampler::lookupOrAddChild(uint32_t parent, uint32_t frame, uint32_t* child)
+{
+    uint64_t key = (uint64_t(parent) << 32) | frame;
+    ChildMap::AddPtr p = childMap_.lookupForAdd(key);
+    if (p) {
+        *child = p->value();
+        return true;
+    }
+
+    uint32_t newIndex = nodes_.length();
+    if (!nodes_.emplaceBack(frame)) {
+        return false;
+    }
+    if (!nodes_[parent].children.append(newIndex) || !childMap_.add(p, key, newIndex)) {
+        return false;
+    }
+
+    *child = newIndex;
+    return true;
+}
+
+void
+StackSampler::sample()
+{
+    MOZ_ASSERT(CurrentThreadCanAccessRuntime(cx_->runtime()));
+
+    // Frames of the stack, youngest first.
+    Vector<uint32_t, 64, SystemAllocPolicy> stack;
+
+    // The profile is only a heuristic, so drop samples on OOM.
+    for (FrameIter iter(cx_); !iter.done() && stack.length() < MaxSampleDepth; ++iter) {
+        UniqueChars functionName;
+        if (JSAtom* atom = iter.maybeFunctionDisplayAtom()) {
+            functionName = StringToNewUTF8CharsZ(nullptr, *atom);
+        } else {
+            functionName = DuplicateString(iter.isFunctionFrame() ? "(anonymous)" : "(top level)");
+        }
+        UniqueChars url = DuplicateString(iter.filename() ? iter.filename() : "");
+        if (!functionName || !url) {
+            return;
+        }
+
+        uint32_t line = iter.hasScript() ? iter.script()->lineno() : iter.computeLine();
+
+        uint32_t frame;
+        if (!lookupOrAddFrame(std::move(functionName), std::move(url), line, &frame)) {
+            return;
+        }
+        if (!stack.append(frame)) {
+            return;
+        }
+    }
+
+    uint32_t node = 0;
+    for (size_t i = stack.length(); i != 0; i--) {
+        if (!lookupOrAddChild(node, stack[i - 1], &node)) {
+            return;
+        }
+    }
+
+    TimeStamp now = TimeStamp::Now();
+    uint32_t delta = uint32_t((now - lastSampleTime_).ToMicroseconds());
+    if (!samples_.append(node) || !timeDeltas_.append(delta)) {
+        return;
+    }
+    nodes_[node].hitCount++;
+    lastSampleTime_ = now;
+}
+
+static void
+PutJSONEscaped(GenericPrinter& out, const char* s)
+{
+    for (; *s; s++) {
+        unsigned char c = *s;
+        if (c == '"' || c == '\\') {
+            out.putChar('\\');
+            out.putChar(c);
+        } else if (c < 0x20) {
+            out.printf("\\u%04x", c);
+        } else {
+            out.putChar(c);
+        }
+    }
+}
+
+void
+StackSampler::writeNode(JSONPrinter& json, GenericPrinter& out, uint32_t index)
+{
+    const Node& node = nodes_[index];
+
+    json.beginObject();
+    json.property("id", index + 1);
+
+    json.beginObjectProperty("callFrame");
+    if (index == 0) {
+        json.property("functionName", "(root)");
+        json.property("scriptId", "0");
+        json.property("url", "");
+        json.property("lineNumber", -1);
+    } else {
+        const Frame& frame = frames_[node.frame];
+        json.beginStringProperty("functionName");
+        PutJSONEscaped(out, frame.functionName.get());
+        json.endStringProperty();
+        json.property("scriptId", "0");
+        json.beginStringProperty("url");
+        PutJSONEscaped(out, frame.url.get());
+        json.endStringProperty();
+
+        // Chrome's line numbers are zero-based.
+        json.property("lineNumber", int32_t(frame.line) - 1);
+    }
+    json.property("columnNumber", -1);
+    json.endObject();
+
+    json.property("hitCount", node.hitCount);
+
+    json.beginListProperty("children");
+    for (uint32_t child : node.children) {
+        json.value(int(child + 1));
+    }
+    json.endList();
+
+    json.endObject();
+}
+
+void
+StackSampler::writeProfile(GenericPrinter& out)
+{
+    MOZ_ASSERT(!thread_.joinable());
+
+    JSONPrinter json(out);
+    json.beginObject();
+
+    json.beginListProperty("nodes");
+    for (uint32_t i = 0; i < nodes_.length(); i++) {
+        writeNode(json, out, i);
+    }
+    json.endList();
+
+    // Times are in microseconds.
+    json.property("startTime", uint64_t(0));
+    json.property("endTime", uint64_t((lastSampleTime_ - startTime_).ToMicroseconds()));
+
+    json.beginListProperty("samples");
+    for (uint32_t node : samples_) {
+        json.value(int(node + 1));
+    }
+    json.endList();
+
+    json.beginListProperty("timeDeltas");
+    for (uint32_t delta : timeDeltas_) {
+        json.value(int(delta));
+    }
+    json.endList();
+
+    json.endObject();
+    out.put("\n");
+}
+
+JS_FRIEND_API(bool)
+js::StartStackSampling(JSContext* cx, uint32_t intervalMicroseconds)
+{
+    MOZ_ASSERT(intervalMicroseconds > 0);
+
+    if (cx->stackSampler) {
+        JS_ReportErrorASCII(cx, "The stack sampler is already running");
+        return false;
+    }
+
+    UniquePtr<StackSampler> sampler = MakeUnique<StackSampler>(cx, intervalMicroseconds);
+    if (!sampler || !sampler->start()) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+
+    cx->stackSampler = sampler.release();
+    return true;
+}
+
+JS_FRIEND_API(bool)
+js::StopStackSampling(JSContext* cx, FILE* fp)
+{
+    StackSampler* sampler = cx->stackSampler;
+    if (!sampler) {
+        JS_ReportErrorASCII(cx, "The stack sampler is not running");
+        return false;
+    }
+
+    sampler->stop();
+    cx->stackSampler = nullptr;
+
+    if (fp) {
+        Fprinter out(fp);
+        sampler->writeProfile(out);
+        out.finish();
+    }
+
+    js_delete(sampler);
+    return true;
+}
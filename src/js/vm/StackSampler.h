@@ -0,0 +1,111 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef vm_StackSampler_h
+#define vm_StackSampler_h
+
+#include "mozilla/HashFunctions.h"
+#include "mozilla/TimeStamp.h"
+
+#include "js/AllocPolicy.h"
+#include "js/HashTable.h"
+#include "js/Utility.h"
+#include "js/Vector.h"
+#include "threading/ConditionVariable.h"
+#include "threading/Mutex.h"
+#include "threading/Thread.h"
+
+struct JSContext;
+
+namespace js {
+
+class GenericPrinter;
+class JSONPrinter;
+
+// A sampling profiler for the JS stack of a single context, which doesn't
+// need an external sampler like the Gecko profiler does. A sampler thread
+// requests an interrupt of the context every interval, and the context records
+// its stack with a FrameIter when it handles the interrupt. This sees
+// interpreter, Baseline, Ion (including inlined) and wasm frames, but only
+// takes samples at the points where the running code checks for interrupts,
+// so time spent in long native calls is attributed to their caller's next
+// interrupt check.
+//
+// Samples are aggregated into a prefix tree of frames, and the profile is
+// written in the JSON format of Chrome's DevTools (.cpuprofile), which other
+// profile viewers read as well.
+class StackSampler
+{
+    // A function, identified by its name, the URL of its script and the line
+    // it starts at.
+    struct Frame
+    {
+        UniqueChars key;
+        UniqueChars functionName;
+        UniqueChars url;
+        uint32_t line;
+    };
+
+    struct Node
+    {
+        uint32_t frame;
+        uint32_t hitCount;
+        Vector<uint32_t, 0, SystemAllocPolicy> children;
+
+        explicit Node(uint32_t frame)
+          : frame(frame), hitCount(0)
+        {}
+    };
+
+    // Maps (parent node, frame) to the child node.
+    using ChildMap = HashMap<uint64_t, uint32_t, DefaultHasher<uint64_t>, SystemAllocPolicy>;
+    using FrameMap = HashMap<const char*, uint32_t, mozilla::CStringHasher, SystemAllocPolicy>;
+
+    static const size_t MaxSampleDepth = 1024;
+
+    JSContext* cx_;
+    mozilla::TimeDuration interval_;
+
+    Mutex lock_;
+    ConditionVariable wakeup_;
+    bool stopping_;
+    Thread thread_;
+
+    // The following are only accessed by the context's thread.
+    Vector<Frame, 0, SystemAllocPolicy> frames_;
+    FrameMap frameMap_;
+    Vector<Node, 0, SystemAllocPolicy> nodes_;
+    ChildMap childMap_;
+    Vector<uint32_t, 0, SystemAllocPolicy> samples_;
+    Vector<uint32_t, 0, SystemAllocPolicy> timeDeltas_;
+    mozilla::TimeStamp startTime_;
+    mozilla::TimeStamp lastSampleTime_;
+
+    static void threadMain(StackSampler* sampler);
+
+    bool lookupOrAddFrame(UniqueChars functionName, UniqueChars url, uint32_t line,
+                          uint32_t* index);
+    bool lookupOrAddChild(uint32_t parent, uint32_t frame, uint32_t* child);
+
+    void writeNode(JSONPrinter& json, GenericPrinter& out, uint32_t index);
+
+  public:
+    StackSampler(JSContext* cx, uint32_t intervalMicroseconds);
+    ~StackSampler();
+
+    MOZ_MUST_USE bool start();
+    void stop();
+
+    // Record the current stack of the context. Called when the context
+    // handles an InterruptReason::Sample interrupt.
+    void sample();
+
+    void writeProfile(GenericPrinter& out);
+};
+
+} /* namespace js */
+
+#endif /* vm_StackSampler_h */
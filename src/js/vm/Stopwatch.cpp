@@ -8,6 +8,7 @@
 
 #include "mozilla/ArrayUtils.h"
 #include "mozilla/IntegerTypeTraits.h"
+#include "mozilla/Move.h"
 #include "mozilla/Unused.h"
 
 #if defined(XP_WIN)
@@ -15,7 +16,9 @@
 #endif // defined(XP_WIN)
 
 #include "gc/PublicIterators.h"
+#include "threading/LockGuard.h"
 #include "util/Windows.h"
+#include "vm/JSContext.h"
 #include "vm/Realm.h"
 #include "vm/Runtime.h"
 
@@ -199,6 +202,7 @@ void
 PerformanceMonitoring::dispose(JSRuntime* rt)
 {
     reset();
+    cpuSampler_.reset();
     for (RealmsIter r(rt); !r.done(); r.next()) {
         r->performanceMonitoring.unlink();
     }
@@ -235,6 +239,114 @@ PerformanceGroupHolder::getGroups(JSContext* cx)
     return &groups_;
 }
 
+void
+PerformanceGroupHolder::addCpuSample(JSContext* cx)
+{
+    ++cpuSamples_;
+
+    const PerformanceGroupVector* groups = getGroups(cx);
+    if (!groups) {
+        return;
+    }
+
+    for (auto& group : *groups) {
+        group->addCpuSamples(1);
+    }
+}
+
+bool
+PerformanceMonitoring::setCpuSamplingInterval(JSContext* cx, uint32_t intervalMicroseconds)
+{
+    cpuSampler_.reset();
+    if (!intervalMicroseconds) {
+        return true;
+    }
+
+    UniquePtr<CpuSampler> sampler = MakeUnique<CpuSampler>(cx, intervalMicroseconds);
+    if (!sampler || !sampler->start()) {
+        return false;
+    }
+
+    cpuSampler_ = std::move(sampler);
+    return true;
+}
+
+CpuSampler::CpuSampler(JSContext* cx, uint32_t intervalMicroseconds)
+  : cx_(cx)
+  , interval_(mozilla::TimeDuration::FromMicroseconds(intervalMicroseconds))
+  , lock_(mutexid::CpuSampler)
+  , stopping_(false)
+  , requestPending_(false)
+{ }
+
+CpuSampler::~CpuSampler()
+{
+    stop();
+}
+
+bool
+CpuSampler::start()
+{
+    MOZ_ASSERT(!thread_.joinable());
+    return thread_.init(threadMain, this);
+}
+
+void
+CpuSampler::stop()
+{
+    if (!thread_.joinable()) {
+        return;
+    }
+
+    {
+        LockGuard<Mutex> guard(lock_);
+        stopping_ = true;
+        wakeup_.notify_all();
+    }
+    thread_.join();
+}
+
+/* static */ void
+CpuSampler::threadMain(CpuSampler* sampler)
+{
+    ThisThread::SetName("JS CPU Sampler");
+
+    UniqueLock<Mutex> lock(sampler->lock_);
+    while (!sampler->stopping_) {
+        if (sampler->wakeup_.wait_for(lock, sampler->interval_) == CVStatus::Timeout &&
+            !sampler->stopping_ && !sampler->requestPending_)
+        {
+            sampler->requestPending_ = true;
+            sampler->requestTime_ = mozilla::TimeStamp::Now();
+            sampler->cx_->requestInterrupt(InterruptReason::CpuSample);
+        }
+    }
+}
+
+void
+CpuSampler::sample(JSContext* cx)
+{
+    MOZ_ASSERT(cx == cx_);
+
+    mozilla::TimeStamp requestTime;
+    {
+        LockGuard<Mutex> guard(lock_);
+        if (!requestPending_) {
+            return;
+        }
+        requestPending_ = false;
+        requestTime = requestTime_;
+    }
+
+    if (mozilla::TimeStamp::Now() - requestTime > interval_ * MaxSampleLatency) {
+        return;
+    }
+
+    if (JS::Realm* realm = cx->realm()) {
+        realm->performanceMonitoring.addCpuSample(cx);
+    }
+}
+
 AutoStopwatch::AutoStopwatch(JSContext* cx MOZ_GUARD_OBJECT_NOTIFIER_PARAM_IN_IMPL)
   : cx_(cx)
   , iteration_(0)
@@ -468,6 +580,7 @@ PerformanceGroup::PerformanceGroup()
     : recentCycles_(0)
     , recentTicks_(0)
     , recentCPOW_(0)
+    , cpuSamples_(0)
     , iteration_(0)
     , isActive_(false)
     , isUsedInThisIteration_(false)
@@ -570,6 +683,18 @@ PerformanceGroup::addRecentCPOW(uint64_t iteration, uint64_t CPOW)
     recentCPOW_ += CPOW;
 }
 
+uint64_t
+PerformanceGroup::cpuSamples() const
+{
+    return cpuSamples_;
+}
+
+void
+PerformanceGroup::addCpuSamples(uint64_t samples)
+{
+    cpuSamples_ += samples;
+}
+
 
 bool
 PerformanceGroup::isActive() const
@@ -685,6 +810,18 @@ AddCPOWPerformanceDelta(JSContext* cx, uint64_t delta)
     cx->runtime()->performanceMonitoring().totalCPOWTime += delta;
 }
 
+JS_PUBLIC_API(bool)
+SetCpuSamplingInterval(JSContext* cx, uint32_t intervalMicroseconds)
+{
+    return cx->runtime()->performanceMonitoring().setCpuSamplingInterval(cx, intervalMicroseconds);
+}
+
+JS_PUBLIC_API(uint64_t)
+GetRealmCpuSamples(JS::Realm* realm)
+{
+    return realm->performanceMonitoring.cpuSamples();
+}
+
 
 } // namespace js
 
@@ -8,10 +8,16 @@
 #define vm_Stopwatch_h
 
 #include "mozilla/RefPtr.h"
+#include "mozilla/TimeStamp.h"
 #include "mozilla/Vector.h"
 
 #include "jsapi.h"
 
+#include "js/UniquePtr.h"
+#include "threading/ConditionVariable.h"
+#include "threading/Mutex.h"
+#include "threading/Thread.h"
+
 /*
   An API for following in real-time the amount of CPU spent executing
   webpages, add-ons, etc.
@@ -43,9 +49,24 @@ struct PerformanceGroupHolder {
      */
     const PerformanceGroupVector* getGroups(JSContext*);
 
+    /**
+     * Charge a CPU sample to this realm and to its groups.
+     *
+     * Pre-condition: Execution must have entered the realm.
+     */
+    void addCpuSample(JSContext*);
+
+    /**
+     * The number of CPU samples charged to this realm, see CpuSampler.
+     */
+    uint64_t cpuSamples() const {
+        return cpuSamples_;
+    }
+
     explicit PerformanceGroupHolder(JSRuntime* runtime)
       : runtime_(runtime)
       , initialized_(false)
+      , cpuSamples_(0)
     {  }
     ~PerformanceGroupHolder();
     void unlink();
@@ -58,6 +79,57 @@ struct PerformanceGroupHolder {
     // The groups to which this compartment belongs. Filled if and only
     // if `initialized_` is `true`.
     PerformanceGroupVector groups_;
+
+    uint64_t cpuSamples_;
+};
+
+/**
+ * Sampling-based CPU accounting.
+ *
+ * A helper thread interrupts the main context at a fixed rate, and the
+ * interrupt handler charges one sample to the realm the context is running
+ * code in, and to the groups of that realm. Unlike `AutoStopwatch`, this adds
+ * nothing to the cost of entering and leaving realms, and it also counts the
+ * time spent in JIT code.
+ *
+ * Samples are taken where the running code checks for interrupts, so time
+ * spent in a long native call is charged to the realm that makes the next
+ * check. An interrupt that is handled more than `MaxSampleLatency` intervals
+ * after it was requested was most likely requested while no JS was running,
+ * and is not charged to anyone.
+ */
+class CpuSampler {
+  public:
+    CpuSampler(JSContext* cx, uint32_t intervalMicroseconds);
+    ~CpuSampler();
+
+    MOZ_MUST_USE bool start();
+    void stop();
+
+    /**
+     * Called by the context when it handles an `InterruptReason::CpuSample`
+     * interrupt.
+     */
+    void sample(JSContext* cx);
+
+  private:
+    static const uint32_t MaxSampleLatency = 10;
+
+    static void threadMain(CpuSampler* sampler);
+
+    JSContext* cx_;
+    mozilla::TimeDuration interval_;
+
+    Mutex lock_;
+    ConditionVariable wakeup_;
+    bool stopping_;
+
+    // `true` from the time the thread requests an interrupt until the
+    // context handles it, so that only one sample is pending at a time.
+    bool requestPending_;
+    mozilla::TimeStamp requestTime_;
+
+    Thread thread_;
 };
 
 /**
@@ -170,6 +242,18 @@ struct PerformanceMonitoring {
         return isMonitoringCPOW_;
     }
 
+    /**
+     * Start/stop sampling-based CPU accounting, see `CpuSampler`. An
+     * interval of 0 stops it.
+     *
+     * May return `false` if the sampler thread cannot be started.
+     */
+    bool setCpuSamplingInterval(JSContext* cx, uint32_t intervalMicroseconds);
+
+    CpuSampler* cpuSampler() {
+        return cpuSampler_.get();
+    }
+
     /**
      * Callbacks called when we start executing an event/when we have
      * run to completion (including enqueued microtasks).
@@ -294,6 +378,11 @@ struct PerformanceMonitoring {
      */
     PerformanceGroupVector recentGroups_;
 
+    /**
+     * The sampler for sampling-based CPU accounting, if it is active.
+     */
+    js::UniquePtr<CpuSampler> cpuSampler_;
+
     /**
      * The highest value of the timestamp counter encountered
      * during this iteration.
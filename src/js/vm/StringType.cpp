@@ -821,6 +821,34 @@ js::ConcatStrings(JSContext* cx,
         return str;
     }
 
+    /*
+     * Appending a short string to a rope which ends in a short leaf, as in
+     * |s += x| loops over small pieces, would make the rope one level deeper
+     * every time. Merge the leaf and the new string into one inline string
+     * instead, so the rope only grows deeper when the inline string is full
+     * and there are fewer nodes to visit when flattening.
+     */
+    if (left->isRope() && right->isLinear()) {
+        JSString* leftRight = left->asRope().rightChild();
+        size_t mergedLength = leftRight->length() + rightLen;
+        bool mergedIsLatin1 = leftRight->hasLatin1Chars() && right->hasLatin1Chars();
+        if (leftRight->isLinear() &&
+            (mergedIsLatin1
+             ? JSInlineString::lengthFits<Latin1Char>(mergedLength)
+             : JSInlineString::lengthFits<char16_t>(mergedLength)))
+        {
+            typename MaybeRooted<JSString*, allowGC>::RootType leftLeft(cx,
+                left->asRope().leftChild());
+            typename MaybeRooted<JSString*, allowGC>::RootType leftRightRoot(cx, leftRight);
+            typename MaybeRooted<JSString*, allowGC>::RootType merged(cx,
+                ConcatStrings<allowGC>(cx, leftRightRoot, right));
+            if (!merged) {
+                return nullptr;
+            }
+            return JSRope::new_<allowGC>(cx, leftLeft, merged, wholeLength);
+        }
+    }
+
     return JSRope::new_<allowGC>(cx, left, right, wholeLength);
 }
 
@@ -830,6 +858,105 @@ js::ConcatStrings<CanGC>(JSContext* cx, HandleString left, HandleString right);
 template JSString*
 js::ConcatStrings<NoGC>(JSContext* cx, JSString* const& left, JSString* const& right);
 
+// Results of ConcatStringsN up to this length are built as a single flat
+// string, which is cheaper than creating ropes and flattening them later.
+static const size_t ConcatNFlatLimit = 1024;
+
+template <typename CharT>
+static JSString*
+ConcatStringsNFlat(JSContext* cx, Handle<StringVector> parts, size_t wholeLength)
+{
+    if (JSInlineString::lengthFits<CharT>(wholeLength)) {
+        CharT* buf;
+        JSInlineString* str = AllocateInlineString<CanGC>(cx, wholeLength, &buf);
+        if (!str) {
+            return nullptr;
+        }
+
+        for (JSString* part : parts) {
+            CopyChars(buf, part->asLinear());
+            buf += part->length();
+        }
+        *buf = 0;
+        return str;
+    }
+
+    auto chars = cx->make_pod_array<CharT>(wholeLength + 1);
+    if (!chars) {
+        return nullptr;
+    }
+
+    CharT* buf = chars.get();
+    for (JSString* part : parts) {
+        CopyChars(buf, part->asLinear());
+        buf += part->length();
+    }
+    *buf = 0;
+
+    return NewStringDontDeflate<CanGC>(cx, std::move(chars), wholeLength);
+}
+
+static JSString*
+ConcatStringsNRope(JSContext* cx, Handle<StringVector> parts, size_t start, size_t end)
+{
+    MOZ_ASSERT(start < end);
+    if (end - start == 1) {
+        return parts[start];
+    }
+
+    size_t middle = start + (end - start) / 2;
+    RootedString left(cx, ConcatStringsNRope(cx, parts, start, middle));
+    if (!left) {
+        return nullptr;
+    }
+    RootedString right(cx, ConcatStringsNRope(cx, parts, middle, end));
+    if (!right) {
+        return nullptr;
+    }
+    return ConcatStrings<CanGC>(cx, left, right);
+}
+
+JSString*
+js::ConcatStringsN(JSContext* cx, Handle<StringVector> parts)
+{
+    MOZ_ASSERT(!parts.empty());
+
+    size_t wholeLength = 0;
+    for (JSString* part : parts) {
+        MOZ_ASSERT_IF(!part->isAtom(), cx->isInsideCurrentZone(part));
+        wholeLength += part->length();
+        if (MOZ_UNLIKELY(wholeLength > JSString::MAX_LENGTH)) {
+            js::ReportAllocationOverflow(cx);
+            return nullptr;
+        }
+    }
+
+    if (wholeLength > ConcatNFlatLimit) {
+        return ConcatStringsNRope(cx, parts, 0, parts.length());
+    }
+
+    // Flattening a part can turn another part which is one of its children
+    // into a two-byte dependent string, so only check the encoding after all
+    // of them are linear.
+    for (size_t i = 0; i < parts.length(); i++) {
+        if (!parts[i]->ensureLinear(cx)) {
+            return nullptr;
+        }
+    }
+
+    bool isLatin1 = true;
+    for (JSString* part : parts) {
+        if (!part->hasLatin1Chars()) {
+            isLatin1 = false;
+            break;
+        }
+    }
+
+    return isLatin1
+           ? ConcatStringsNFlat<Latin1Char>(cx, parts, wholeLength)
+           : ConcatStringsNFlat<char16_t>(cx, parts, wholeLength);
+}
+
 template <typename CharT>
 JSFlatString*
 JSDependentString::undependInternal(JSContext* cx)
@@ -903,14 +1030,14 @@ js::EqualChars(JSLinearString* str1, JSLinearString* str2)
             return ArrayEqual(str1->twoByteChars(nogc), str2->twoByteChars(nogc), len);
         }
 
-        return EqualChars(str2->latin1Chars(nogc), str1->twoByteChars(nogc), len);
+        return FindFirstMismatch(str2->latin1Chars(nogc), str1->twoByteChars(nogc), len) == len;
     }
 
     if (str2->hasLatin1Chars()) {
         return ArrayEqual(str1->latin1Chars(nogc), str2->latin1Chars(nogc), len);
     }
 
-    return EqualChars(str1->latin1Chars(nogc), str2->twoByteChars(nogc), len);
+    return FindFirstMismatch(str1->latin1Chars(nogc), str2->twoByteChars(nogc), len) == len;
 }
 
 bool
@@ -989,6 +1116,20 @@ js::CompareChars(const char16_t* s1, size_t len1, JSLinearString* s2)
            : CompareChars(s1, len1, s2->twoByteChars(nogc), s2->length());
 }
 
+// Like CompareChars, but finds the first differing char a vector at a time.
+template <typename Char1, typename Char2>
+static int32_t
+CompareCharsVectorized(const Char1* s1, size_t len1, const Char2* s2, size_t len2)
+{
+    size_t n = Min(len1, len2);
+    size_t i = FindFirstMismatch(s1, s2, n);
+    if (i < n) {
+        return int32_t(s1[i]) - int32_t(s2[i]);
+    }
+
+    return int32_t(len1 - len2);
+}
+
 static int32_t
 CompareStringsImpl(JSLinearString* str1, JSLinearString* str2)
 {
@@ -999,14 +1140,14 @@ CompareStringsImpl(JSLinearString* str1, JSLinearString* str2)
     if (str1->hasLatin1Chars()) {
         const Latin1Char* chars1 = str1->latin1Chars(nogc);
         return str2->hasLatin1Chars()
-               ? CompareChars(chars1, len1, str2->latin1Chars(nogc), len2)
-               : CompareChars(chars1, len1, str2->twoByteChars(nogc), len2);
+               ? CompareCharsVectorized(chars1, len1, str2->latin1Chars(nogc), len2)
+               : CompareCharsVectorized(chars1, len1, str2->twoByteChars(nogc), len2);
     }
 
     const char16_t* chars1 = str1->twoByteChars(nogc);
     return str2->hasLatin1Chars()
-           ? CompareChars(chars1, len1, str2->latin1Chars(nogc), len2)
-           : CompareChars(chars1, len1, str2->twoByteChars(nogc), len2);
+           ? CompareCharsVectorized(chars1, len1, str2->latin1Chars(nogc), len2)
+           : CompareCharsVectorized(chars1, len1, str2->twoByteChars(nogc), len2);
 }
 
 bool
@@ -1614,6 +1614,13 @@ ConcatStrings(JSContext* cx,
               typename MaybeRooted<JSString*, allowGC>::HandleType left,
               typename MaybeRooted<JSString*, allowGC>::HandleType right);
 
+/*
+ * Concatenate all of |parts|, building a single flat string when the result is
+ * short and a balanced rope over the parts otherwise.
+ */
+extern JSString*
+ConcatStringsN(JSContext* cx, Handle<StringVector> parts);
+
 /*
  * Test if strings are equal. The caller can call the function even if str1
  * or str2 are not GC-allocated things.
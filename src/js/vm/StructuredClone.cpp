@@ -42,13 +42,16 @@
 
 #include "builtin/DataViewObject.h"
 #include "builtin/MapObject.h"
+#include "ds/IdValuePair.h"
 #include "js/Date.h"
 #include "js/GCHashTable.h"
 #include "js/Wrapper.h"
+#include "vm/ArrayObject.h"
 #ifdef ENABLE_BIGINT
 #include "vm/BigIntType.h"
 #endif
 #include "vm/JSContext.h"
+#include "vm/ObjectGroup.h"
 #include "vm/RegExpObject.h"
 #include "vm/SavedFrame.h"
 #include "vm/SharedArrayObject.h"
@@ -57,6 +60,7 @@
 #include "wasm/WasmJS.h"
 
 #include "vm/InlineCharBuffer-inl.h"
+#include "vm/JSAtom-inl.h"
 #include "vm/JSContext-inl.h"
 #include "vm/JSObject-inl.h"
 
@@ -117,6 +121,11 @@ enum StructuredDataType : uint32_t {
     SCTAG_BIGINT,
     SCTAG_BIGINT_OBJECT,
 
+    SCTAG_DENSE_INT32_ARRAY_OBJECT,
+    SCTAG_DENSE_DOUBLE_ARRAY_OBJECT,
+    SCTAG_PLAIN_OBJECT_WITH_LAYOUT,
+    SCTAG_DETACHED_ARRAY_BUFFER_OBJECT,
+
     SCTAG_TYPED_ARRAY_V1_MIN = 0xFFFF0100,
     SCTAG_TYPED_ARRAY_V1_INT8 = SCTAG_TYPED_ARRAY_V1_MIN + Scalar::Int8,
     SCTAG_TYPED_ARRAY_V1_UINT8 = SCTAG_TYPED_ARRAY_V1_MIN + Scalar::Uint8,
@@ -151,6 +160,29 @@ enum StructuredDataType : uint32_t {
  *     extraData (64 bits), eg byte length for ArrayBuffers
  */
 
+/*
+ * Arrays whose elements are all dense int32 values or numbers are written in
+ * bulk, without keys or an SCTAG_END_OF_KEYS:
+ *   <SCTAG_DENSE_INT32_ARRAY_OBJECT, length>
+ *   array of int32 elements, padded to 64 bits
+ * or
+ *   <SCTAG_DENSE_DOUBLE_ARRAY_OBJECT, length>
+ *   array of double elements
+ *
+ * Plain objects whose properties are all enumerable data properties with
+ * primitive values are written with the index of their layout, the ordered
+ * list of their property names. The first object with a layout defines it:
+ *   <SCTAG_PLAIN_OBJECT_WITH_LAYOUT, layoutIndex>
+ *   if layoutIndex is the number of layouts defined so far:
+ *     nproperties (64 bits)
+ *     array of property names, as <SCTAG_STRING, length> strings
+ *   array of property values, one for each name
+ *
+ * ArrayBuffers detached into a same-process clone (see JS::CloneDataPolicy):
+ *   <SCTAG_DETACHED_ARRAY_BUFFER_OBJECT, byteLength>
+ *   pointer (64 bits), owned by the clone data until read
+ */
+
 // Data associated with an SCTAG_TRANSFER_MAP_HEADER that tells whether the
 // contents have been read out yet or not.
 enum TransferableMapHeader {
@@ -306,6 +338,57 @@ SharedArrayRawBufferRefs::releaseAll()
     refs_.clear();
 }
 
+DetachedArrayBufferContents&
+DetachedArrayBufferContents::operator=(DetachedArrayBufferContents&& other)
+{
+    releaseAll();
+    contents_ = std::move(other.contents_);
+    return *this;
+}
+
+DetachedArrayBufferContents::~DetachedArrayBufferContents()
+{
+    releaseAll();
+}
+
+bool
+DetachedArrayBufferContents::reserveOne(JSContext* cx)
+{
+    if (!contents_.reserve(contents_.length() + 1)) {
+        ReportOutOfMemory(cx);
+        return false;
+    }
+    return true;
+}
+
+void
+DetachedArrayBufferContents::infallibleAdd(void* contents)
+{
+    contents_.infallibleAppend(contents);
+}
+
+bool
+DetachedArrayBufferContents::take(void* contents)
+{
+    for (void*& p : contents_) {
+        if (p == contents) {
+            p = contents_.back();
+            contents_.popBack();
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+DetachedArrayBufferContents::releaseAll()
+{
+    for (void* p : contents_) {
+        js_free(p);
+    }
+    contents_.clear();
+}
+
 // SCOutput provides an interface to write raw data -- eg uint64_ts, doubles,
 // arrays of bytes -- into a structured clone data output stream. It also knows
 // how to free any transferable data within that stream.
@@ -383,6 +466,8 @@ class SCInput {
     template <class T>
     MOZ_MUST_USE bool readArray(T* p, size_t nelems);
 
+    JSStructuredCloneData& data() { return buf; }
+
     bool reportTruncated() {
          JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_SC_BAD_SERIALIZED_DATA,
                                    "truncated");
@@ -396,6 +481,7 @@ class SCInput {
     }
 
     JSContext* cx;
+    JSStructuredCloneData& buf;
     BufferIterator point;
 };
 
@@ -407,7 +493,8 @@ struct JSStructuredCloneReader {
                                      const JSStructuredCloneCallbacks* cb,
                                      void* cbClosure)
         : in(in), allowedScope(scope), objs(in.context()), allObjs(in.context()),
-          callbacks(cb), closure(cbClosure) { }
+          layoutKeys(in.context()), layoutStarts(in.context()),
+          layoutTemplates(in.context()), callbacks(cb), closure(cbClosure) { }
 
     SCInput& input() { return in; }
     bool read(MutableHandleValue vp);
@@ -431,6 +518,9 @@ struct JSStructuredCloneReader {
                                      bool v1Read = false);
     MOZ_MUST_USE bool readDataView(uint32_t byteLength, MutableHandleValue vp);
     MOZ_MUST_USE bool readArrayBuffer(uint32_t nbytes, MutableHandleValue vp);
+    MOZ_MUST_USE bool readDetachedArrayBuffer(uint32_t nbytes, MutableHandleValue vp);
+    MOZ_MUST_USE bool readDenseArray(uint32_t tag, uint32_t length, MutableHandleValue vp);
+    MOZ_MUST_USE bool readPlainObjectWithLayout(uint32_t layoutIndex, MutableHandleValue vp);
     MOZ_MUST_USE bool readSharedArrayBuffer(MutableHandleValue vp);
     MOZ_MUST_USE bool readSharedWasmMemory(uint32_t nbytes, MutableHandleValue vp);
     MOZ_MUST_USE bool readV1ArrayBuffer(uint32_t arrayType, uint32_t nelems, MutableHandleValue vp);
@@ -461,6 +551,15 @@ struct JSStructuredCloneReader {
     // one `undefined` placeholder value (the readTypedArray hack).
     AutoValueVector allObjs;
 
+    // The property names of the layouts defined by SCTAG_PLAIN_OBJECT_WITH_LAYOUT
+    // records, stored contiguously: those of layout i start at layoutStarts[i].
+    AutoIdVector layoutKeys;
+    Vector<size_t> layoutStarts;
+
+    // For each layout, an object read with it whose group and shape are
+    // reused for later objects with the layout, or undefined.
+    AutoValueVector layoutTemplates;
+
     // The user defined callbacks that will be used for cloning.
     const JSStructuredCloneCallbacks* callbacks;
 
@@ -485,6 +584,9 @@ struct JSStructuredCloneWriter {
           memory(out.context()),
           transferable(out.context(), tVal),
           transferableObjects(out.context(), TransferableObjectsSet(cx)),
+          layouts(out.context(), LayoutMap()),
+          detachedBuffers(out.context()),
+          detachedBufferOffsets(out.context()),
           cloneDataPolicy(cloneDataPolicy)
     {
         out.setCallbacks(cb, cbClosure, OwnTransferablePolicy::NoTransferables);
@@ -515,6 +617,10 @@ struct JSStructuredCloneWriter {
 
     bool writeString(uint32_t tag, JSString* str);
     bool writeArrayBuffer(HandleObject obj);
+    bool writeDetachedArrayBuffer(Handle<ArrayBufferObject*> buffer);
+    bool detachArrayBuffers();
+    bool writeDenseArray(HandleObject obj, uint32_t tag);
+    bool writePlainObjectWithLayout(HandleObject obj);
     bool writeTypedArray(HandleObject obj);
     bool writeDataView(HandleObject obj);
     bool writeSharedArrayBuffer(HandleObject obj);
@@ -585,6 +691,22 @@ struct JSStructuredCloneWriter {
     typedef GCHashSet<JSObject*, TransferableObjectsHasher> TransferableObjectsSet;
     Rooted<TransferableObjectsSet> transferableObjects;
 
+    // The layouts of the plain objects written as SCTAG_PLAIN_OBJECT_WITH_LAYOUT,
+    // mapping the last property of the objects to the index of their layout.
+    using LayoutMap = GCHashMap<Shape*,
+                                uint32_t,
+                                MovableCellHasher<Shape*>,
+                                SystemAllocPolicy>;
+    Rooted<LayoutMap> layouts;
+
+    // ArrayBuffers whose contents will be detached into the clone data once
+    // everything has been written, and the offsets of the placeholders for
+    // the pointers to their contents.
+    //
+    // NB: These can span multiple compartments, like objs.
+    AutoObjectVector detachedBuffers;
+    Vector<size_t> detachedBufferOffsets;
+
     const JS::CloneDataPolicy cloneDataPolicy;
 
     friend bool JS_WriteString(JSStructuredCloneWriter* w, HandleString str);
@@ -681,7 +803,7 @@ StructuredCloneHasTransferObjects(const JSStructuredCloneData& data)
 namespace js {
 
 SCInput::SCInput(JSContext* cx, JSStructuredCloneData& data)
-    : cx(cx), point(data)
+    : cx(cx), buf(data), point(data)
 {
 
     static_assert(JSStructuredCloneData::BufferList::kSegmentAlignment % 8 == 0,
@@ -900,12 +1022,20 @@ SCOutput::writeArray(const T* p, size_t nelems)
         return true;
     }
 
+#if MOZ_LITTLE_ENDIAN
+    // The elements are already in the serialized byte order, so append them
+    // all at once.
+    if (!buf.AppendBytes(reinterpret_cast<const char*>(p), nelems * sizeof(T))) {
+        return false;
+    }
+#else
     for (size_t i = 0; i < nelems; i++) {
         T value = NativeEndian::swapToLittleEndian(p[i]);
         if (!buf.AppendBytes(reinterpret_cast<char*>(&value), sizeof(value))) {
             return false;
         }
     }
+#endif
 
     // Zero-pad to 8 bytes boundary.
     size_t padbytes = ComputePadding(nelems, sizeof(T));
@@ -1336,10 +1466,71 @@ JSStructuredCloneWriter::writeArrayBuffer(HandleObject obj)
     Rooted<ArrayBufferObject*> buffer(context(), &CheckedUnwrap(obj)->as<ArrayBufferObject>());
     JSAutoRealm ar(context(), buffer);
 
+    JS::StructuredCloneScope scope = output().scope();
+    if (buffer->byteLength() != 0 &&
+        buffer->byteLength() >= cloneDataPolicy.detachArrayBufferThreshold() &&
+        (scope == JS::StructuredCloneScope::SameProcessSameThread ||
+         scope == JS::StructuredCloneScope::SameProcessDifferentThread) &&
+        buffer->isPlain() &&
+        buffer->hasStealableContents())
+    {
+        return writeDetachedArrayBuffer(buffer);
+    }
+
     return out.writePair(SCTAG_ARRAY_BUFFER_OBJECT, buffer->byteLength()) &&
            out.writeBytes(buffer->dataPointer(), buffer->byteLength());
 }
 
+bool
+JSStructuredCloneWriter::writeDetachedArrayBuffer(Handle<ArrayBufferObject*> buffer)
+{
+    // Only a placeholder for the pointer to the contents is written now. As
+    // with transferred ArrayBuffers, the contents are stolen once everything
+    // has been written, so that views of the buffer are written intact.
+    if (!out.writePair(SCTAG_DETACHED_ARRAY_BUFFER_OBJECT, buffer->byteLength())) {
+        return false;
+    }
+    if (!detachedBuffers.append(buffer.get()) || !detachedBufferOffsets.append(out.tell())) {
+        return false;
+    }
+    return out.write(0);
+}
+
+bool
+JSStructuredCloneWriter::detachArrayBuffers()
+{
+    JSContext* cx = context();
+    Rooted<ArrayBufferObject*> buffer(cx);
+    for (size_t i = 0; i < detachedBuffers.length(); i++) {
+        buffer = &detachedBuffers[i]->as<ArrayBufferObject>();
+        JSAutoRealm ar(cx, buffer);
+
+        // The buffer may have been detached while its views were written.
+        if (buffer->isDetached()) {
+            JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_TYPED_ARRAY_DETACHED);
+            return false;
+        }
+
+        if (!out.buf.detachedContents_.reserveOne(cx)) {
+            return false;
+        }
+
+        ArrayBufferObject::BufferContents contents =
+            ArrayBufferObject::stealContents(cx, buffer, buffer->hasStealableContents());
+        if (!contents) {
+            return false; // out of memory
+        }
+        MOZ_ASSERT(contents.kind() == ArrayBufferObject::PLAIN);
+        out.buf.detachedContents_.infallibleAdd(contents.data());
+
+        auto point = out.iter();
+        point += detachedBufferOffsets[i];
+        point.write(NativeEndian::swapToLittleEndian(reinterpret_cast<uint64_t>(contents.data())));
+    }
+
+    return true;
+}
+
 bool
 JSStructuredCloneWriter::writeSharedArrayBuffer(HandleObject obj)
 {
@@ -1480,6 +1671,175 @@ TryAppendNativeProperties(JSContext* cx, HandleObject obj, AutoIdVector& entries
     return true;
 }
 
+// If |obj| is an array whose only own properties are its length and dense
+// int32 or number elements, return the tag to write it in bulk with, or zero.
+static uint32_t
+DenseArrayTag(JSObject* obj)
+{
+    if (!obj->is<ArrayObject>()) {
+        return 0;
+    }
+
+    ArrayObject& arr = obj->as<ArrayObject>();
+    uint32_t length = arr.length();
+    if (length == 0 || arr.isIndexed() || arr.getDenseInitializedLength() != length) {
+        return 0;
+    }
+
+    Shape* shape = arr.lastProperty();
+    if (shape->previous() && !shape->previous()->isEmptyShape()) {
+        return 0;
+    }
+
+    bool allInt32 = true;
+    for (uint32_t i = 0; i < length; i++) {
+        const Value& v = arr.getDenseElement(i);
+        if (!v.isInt32()) {
+            if (!v.isDouble()) {
+                return 0;
+            }
+            allInt32 = false;
+        }
+    }
+
+    return allInt32 ? SCTAG_DENSE_INT32_ARRAY_OBJECT : SCTAG_DENSE_DOUBLE_ARRAY_OBJECT;
+}
+
+bool
+JSStructuredCloneWriter::writeDenseArray(HandleObject obj, uint32_t tag)
+{
+    ArrayObject& arr = obj->as<ArrayObject>();
+    uint32_t length = arr.length();
+    if (!out.writePair(tag, length)) {
+        return false;
+    }
+
+    // Convert the elements in chunks with an even number of int32 elements,
+    // so that only the last chunk is padded.
+    static const size_t ChunkLength = 512;
+    if (tag == SCTAG_DENSE_INT32_ARRAY_OBJECT) {
+        uint32_t chunk[ChunkLength];
+        for (uint32_t start = 0; start < length; start += ChunkLength) {
+            size_t n = std::min(size_t(length - start), ChunkLength);
+            for (size_t i = 0; i < n; i++) {
+                chunk[i] = uint32_t(arr.getDenseElement(start + i).toInt32());
+            }
+            if (!out.writeArray(chunk, n)) {
+                ReportOutOfMemory(context());
+                return false;
+            }
+        }
+    } else {
+        MOZ_ASSERT(tag == SCTAG_DENSE_DOUBLE_ARRAY_OBJECT);
+        uint64_t chunk[ChunkLength];
+        for (uint32_t start = 0; start < length; start += ChunkLength) {
+            size_t n = std::min(size_t(length - start), ChunkLength);
+            for (size_t i = 0; i < n; i++) {
+                double d = arr.getDenseElement(start + i).toNumber();
+                chunk[i] = BitwiseCast<uint64_t>(CanonicalizeNaN(d));
+            }
+            if (!out.writeArray(chunk, n)) {
+                ReportOutOfMemory(context());
+                return false;
+            }
+        }
+    }
+
+    return true;
+}
+
+// The most properties a plain object can have to be written with
+// SCTAG_PLAIN_OBJECT_WITH_LAYOUT.
+static const size_t MaxLayoutProperties = 64;
+
+// Whether |obj| is a plain object whose own properties are all enumerable,
+// string-keyed data properties with primitive values, stored in the order
+// they were added, so that it can be written with SCTAG_PLAIN_OBJECT_WITH_LAYOUT.
+// Writing the values of such an object can't run any script, so there is no
+// need to check for changes to its properties after writing each one.
+static bool
+HasSimpleLayout(JSObject* obj)
+{
+    if (!obj->is<PlainObject>()) {
+        return false;
+    }
+
+    PlainObject& plain = obj->as<PlainObject>();
+    size_t nprops = plain.slotSpan();
+    if (plain.inDictionaryMode() ||
+        plain.isIndexed() ||
+        plain.getDenseInitializedLength() != 0 ||
+        nprops == 0 ||
+        nprops > MaxLayoutProperties)
+    {
+        return false;
+    }
+
+    size_t count = 0;
+    for (Shape::Range<NoGC> r(plain.lastProperty()); !r.empty(); r.popFront()) {
+        Shape& shape = r.front();
+        if (!shape.isDataProperty() ||
+            !shape.enumerable() ||
+            !JSID_IS_ATOM(shape.propid()) ||
+            plain.getSlot(shape.slot()).isObject())
+        {
+            return false;
+        }
+        count++;
+    }
+
+    return count == nprops;
+}
+
+bool
+JSStructuredCloneWriter::writePlainObjectWithLayout(HandleObject obj)
+{
+    JSContext* cx = context();
+    HandlePlainObject plain = obj.as<PlainObject>();
+    size_t nprops = plain->slotSpan();
+
+    LayoutMap::AddPtr p = layouts.lookupForAdd(plain->lastProperty());
+    if (p) {
+        if (!out.writePair(SCTAG_PLAIN_OBJECT_WITH_LAYOUT, p->value())) {
+            return false;
+        }
+    } else {
+        uint32_t layoutIndex = layouts.count();
+        if (!layouts.add(p, plain->lastProperty(), layoutIndex)) {
+            ReportOutOfMemory(cx);
+            return false;
+        }
+
+        // Define the layout, with the names in slot order.
+        AutoIdVector names(cx);
+        if (!names.resize(nprops)) {
+            return false;
+        }
+        for (Shape::Range<NoGC> r(plain->lastProperty()); !r.empty(); r.popFront()) {
+            names[r.front().slot()].set(r.front().propid());
+        }
+
+        if (!out.writePair(SCTAG_PLAIN_OBJECT_WITH_LAYOUT, layoutIndex) || !out.write(nprops)) {
+            return false;
+        }
+        for (size_t i = 0; i < nprops; i++) {
+            if (!writeString(SCTAG_STRING, JSID_TO_ATOM(names[i]))) {
+                return false;
+            }
+        }
+    }
+
+    RootedValue v(cx);
+    for (size_t i = 0; i < nprops; i++) {
+        v = plain->getSlot(i);
+        if (!startWrite(v)) {
+            return false;
+        }
+    }
+
+    return true;
+}
+
 bool
 JSStructuredCloneWriter::traverseObject(HandleObject obj, ESClass cls)
 {
@@ -1757,7 +2117,14 @@ JSStructuredCloneWriter::startWrite(HandleValue v)
 
         switch (cls) {
           case ESClass::Object:
+            if (HasSimpleLayout(obj)) {
+                return writePlainObjectWithLayout(obj);
+            }
+            return traverseObject(obj, cls);
           case ESClass::Array:
+            if (uint32_t tag = DenseArrayTag(obj)) {
+                return writeDenseArray(obj, tag);
+            }
             return traverseObject(obj, cls);
           case ESClass::Number: {
             RootedValue unboxed(context());
@@ -2118,7 +2485,7 @@ JSStructuredCloneWriter::write(HandleValue v)
     }
 
     memory.clear();
-    return transferOwnership();
+    return detachArrayBuffers() && transferOwnership();
 }
 
 bool
@@ -2337,6 +2704,191 @@ JSStructuredCloneReader::readArrayBuffer(uint32_t nbytes, MutableHandleValue vp)
     return in.readArray(buffer.dataPointer(), nbytes);
 }
 
+bool
+JSStructuredCloneReader::readDetachedArrayBuffer(uint32_t nbytes, MutableHandleValue vp)
+{
+    JSContext* cx = context();
+
+    if (allowedScope == JS::StructuredCloneScope::DifferentProcess ||
+        allowedScope == JS::StructuredCloneScope::DifferentProcessForIndexedDB)
+    {
+        JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_SC_BAD_SERIALIZED_DATA,
+                                  "invalid input");
+        return false;
+    }
+
+    void* content;
+    if (!in.readPtr(&content)) {
+        return false;
+    }
+
+    // Take the contents from the input buffer first. This fails if they were
+    // already read, or if the data was copied from the clone data owning them.
+    if (!in.data().detachedContents_.take(content)) {
+        JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_SC_BAD_SERIALIZED_DATA,
+                                  "ArrayBuffer contents not owned by the input");
+        return false;
+    }
+
+    JSObject* obj = JS_NewArrayBufferWithContents(cx, nbytes, content);
+    if (!obj) {
+        js_free(content);
+        return false;
+    }
+    vp.setObject(*obj);
+    return true;
+}
+
+bool
+JSStructuredCloneReader::readDenseArray(uint32_t tag, uint32_t length, MutableHandleValue vp)
+{
+    AutoValueVector values(context());
+
+    // Read the elements in the same chunks as the writer, only the last of
+    // which can be padded. The vector grows with each chunk, so that a bogus
+    // length fails as truncated data rather than with a huge allocation.
+    static const size_t ChunkLength = 512;
+    for (uint32_t start = 0; start < length; start += ChunkLength) {
+        size_t n = std::min(size_t(length - start), ChunkLength);
+        if (!values.growBy(n)) {
+            return false;
+        }
+
+        if (tag == SCTAG_DENSE_INT32_ARRAY_OBJECT) {
+            uint32_t chunk[ChunkLength];
+            if (!in.readArray(chunk, n)) {
+                return in.reportTruncated();
+            }
+            for (size_t i = 0; i < n; i++) {
+                values[start + i].setInt32(int32_t(chunk[i]));
+            }
+        } else {
+            MOZ_ASSERT(tag == SCTAG_DENSE_DOUBLE_ARRAY_OBJECT);
+            uint64_t chunk[ChunkLength];
+            if (!in.readArray(chunk, n)) {
+                return in.reportTruncated();
+            }
+            for (size_t i = 0; i < n; i++) {
+                double d = BitwiseCast<double>(chunk[i]);
+                if (!checkDouble(d)) {
+                    return false;
+                }
+                values[start + i].setNumber(d);
+            }
+        }
+    }
+
+    JSObject* obj = ObjectGroup::newArrayObject(context(), values.begin(), length,
+                                                GenericObject);
+    if (!obj) {
+        return false;
+    }
+    vp.setObject(*obj);
+    return true;
+}
+
+bool
+JSStructuredCloneReader::readPlainObjectWithLayout(uint32_t layoutIndex, MutableHandleValue vp)
+{
+    JSContext* cx = context();
+
+    if (layoutIndex > layoutStarts.length()) {
+        JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_SC_BAD_SERIALIZED_DATA,
+                                  "invalid object layout");
+        return false;
+    }
+
+    if (layoutIndex == layoutStarts.length()) {
+        // Read the definition of a new layout.
+        uint64_t nprops;
+        if (!in.read(&nprops)) {
+            return false;
+        }
+        if (nprops == 0 || nprops > MaxLayoutProperties) {
+            JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_SC_BAD_SERIALIZED_DATA,
+                                      "invalid object layout");
+            return false;
+        }
+
+        if (!layoutStarts.append(layoutKeys.length()) ||
+            !layoutTemplates.append(UndefinedValue()))
+        {
+            return false;
+        }
+
+        for (size_t i = 0; i < nprops; i++) {
+            uint32_t tag, data;
+            if (!in.readPair(&tag, &data)) {
+                return false;
+            }
+            if (tag != SCTAG_STRING) {
+                JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr,
+                                          JSMSG_SC_BAD_SERIALIZED_DATA,
+                                          "property key expected");
+                return false;
+            }
+
+            JSString* str = readString(data);
+            if (!str) {
+                return false;
+            }
+            JSAtom* atom = AtomizeString(cx, str);
+            if (!atom || !layoutKeys.append(AtomToId(atom))) {
+                return false;
+            }
+        }
+    }
+
+    size_t start = layoutStarts[layoutIndex];
+    size_t end = layoutIndex + 1 < layoutStarts.length()
+                 ? layoutStarts[layoutIndex + 1]
+                 : layoutKeys.length();
+    size_t nprops = end - start;
+
+    Rooted<IdValueVector> properties(cx, IdValueVector(cx));
+    if (!properties.reserve(nprops)) {
+        return false;
+    }
+
+    RootedValue val(cx);
+    for (size_t i = 0; i < nprops; i++) {
+        if (!startRead(&val)) {
+            return false;
+        }
+        if (val.isObject()) {
+            JS_ReportErrorNumberASCII(cx, GetErrorMessage, nullptr, JSMSG_SC_BAD_SERIALIZED_DATA,
+                                      "primitive property value expected");
+            return false;
+        }
+        properties.infallibleAppend(IdValuePair(layoutKeys[start + i], val));
+    }
+
+    // Objects after the first with a layout reuse its group and shape, which
+    // saves looking up the group and building the shape for each object.
+    JSObject* obj;
+    if (layoutTemplates[layoutIndex].isObject()) {
+        PlainObject& templateObj = layoutTemplates[layoutIndex].toObject().as<PlainObject>();
+        RootedObjectGroup group(cx, templateObj.group());
+        RootedShape shape(cx, templateObj.lastProperty());
+        obj = ObjectGroup::newPlainObjectWithLayout(cx, group, shape, properties.begin(),
+                                                    nprops, GenericObject);
+    } else {
+        obj = ObjectGroup::newPlainObject(cx, properties.begin(), nprops, GenericObject);
+        if (obj && obj->is<PlainObject>() && !obj->isSingleton()) {
+            PlainObject& plain = obj->as<PlainObject>();
+            if (!plain.inDictionaryMode() && plain.slotSpan() == nprops) {
+                layoutTemplates[layoutIndex].setObject(plain);
+            }
+        }
+    }
+    if (!obj) {
+        return false;
+    }
+
+    vp.setObject(*obj);
+    return true;
+}
+
 bool
 JSStructuredCloneReader::readSharedArrayBuffer(MutableHandleValue vp)
 {
@@ -2640,6 +3192,25 @@ JSStructuredCloneReader::startRead(MutableHandleValue vp)
         }
         break;
 
+      case SCTAG_DETACHED_ARRAY_BUFFER_OBJECT:
+        if (!readDetachedArrayBuffer(data, vp)) {
+            return false;
+        }
+        break;
+
+      case SCTAG_DENSE_INT32_ARRAY_OBJECT:
+      case SCTAG_DENSE_DOUBLE_ARRAY_OBJECT:
+        if (!readDenseArray(tag, data, vp)) {
+            return false;
+        }
+        break;
+
+      case SCTAG_PLAIN_OBJECT_WITH_LAYOUT:
+        if (!readPlainObjectWithLayout(data, vp)) {
+            return false;
+        }
+        break;
+
       case SCTAG_SHARED_ARRAY_BUFFER_OBJECT:
         if (!readSharedArrayBuffer(vp)) {
             return false;
@@ -17,6 +17,10 @@
 #include <string.h>
 #include <time.h>
 
+#if defined(MOZ_HAVE_RDTSC) && !(defined(_WIN32) && (defined(_M_IX86) || defined(_M_AMD64)))
+#include <cpuid.h>
+#endif
+
 #include "jstypes.h"
 #include "jsutil.h"
 
@@ -399,3 +403,89 @@ PRMJ_FormatTime(char* buf, size_t buflen, const char* fmt, const PRMJTime* prtm,
 #endif
     return result;
 }
+
+using js::InstrumentationClock;
+
+mozilla::Atomic<uint32_t, mozilla::ReleaseAcquire>
+InstrumentationClock::state_(InstrumentationClock::Unavailable);
+mozilla::TimeStamp InstrumentationClock::baseTime_;
+uint64_t InstrumentationClock::baseTicks_ = 0;
+double InstrumentationClock::microsPerTick_ = 0;
+
+#ifdef MOZ_HAVE_RDTSC
+// Whether the timestamp counter ticks at a constant rate in every P-, C- and
+// T-state, as reported by CPUID leaf 0x80000007. Without that, the counter
+// can't be converted to time with one frequency.
+static bool
+HasInvariantTimestampCounter()
+{
+    static const uint32_t PowerManagementLeaf = 0x80000007;
+    static const uint32_t InvariantTSCBit = 1 << 8;
+
+#if defined(_WIN32) && (defined(_M_IX86) || defined(_M_AMD64))
+    int regs[4];
+    __cpuid(regs, 0x80000000);
+    if (uint32_t(regs[0]) < PowerManagementLeaf) {
+        return false;
+    }
+    __cpuid(regs, PowerManagementLeaf);
+    return uint32_t(regs[3]) & InvariantTSCBit;
+#else
+    unsigned eax, ebx, ecx, edx;
+    if (!__get_cpuid(PowerManagementLeaf, &eax, &ebx, &ecx, &edx)) {
+        return false;
+    }
+    return edx & InvariantTSCBit;
+#endif
+}
+#endif
+
+/* static */ void
+InstrumentationClock::init()
+{
+#ifdef MOZ_HAVE_RDTSC
+    // ReadTimestampCounter always returns zero while recording or replaying.
+    if (mozilla::recordreplay::IsRecordingOrReplaying() || !HasInvariantTimestampCounter()) {
+        return;
+    }
+
+    baseTime_ = ReallyNow();
+    baseTicks_ = ReadTimestampCounter();
+    state_ = Uncalibrated;
+#endif
+}
+
+/* static */ mozilla::TimeStamp
+InstrumentationClock::calibrateOrNow()
+{
+    mozilla::TimeStamp now = ReallyNow();
+
+#ifdef MOZ_HAVE_RDTSC
+    if (state_ != Uncalibrated) {
+        return now;
+    }
+
+    uint64_t ticks = ReadTimestampCounter();
+    mozilla::TimeDuration elapsed = now - baseTime_;
+    if (elapsed < mozilla::TimeDuration::FromMilliseconds(CalibrationMillis)) {
+        return now;
+    }
+
+    // Only one thread calibrates; the others carry on with ReallyNow().
+    if (!state_.compareExchange(Uncalibrated, Calibrating)) {
+        return now;
+    }
+
+    if (ticks <= baseTicks_) {
+        state_ = Unavailable;
+        return now;
+    }
+
+    // Calibrating from the base to this read makes the clock continuous: it
+    // returns |now| for |ticks|.
+    microsPerTick_ = elapsed.ToMicroseconds() / double(ticks - baseTicks_);
+    state_ = Calibrated;
+#endif
+
+    return now;
+}
@@ -7,6 +7,7 @@
 #ifndef vm_Time_h
 #define vm_Time_h
 
+#include "mozilla/Atomics.h"
 #include "mozilla/RecordReplay.h"
 #include "mozilla/TimeStamp.h"
 
@@ -183,6 +184,65 @@ ReallyNow()
     return mozilla::TimeStamp::Now();
 }
 
+// A cheap monotonic clock for the engine's timing instrumentation, like the
+// GC's phase times and the nursery's profile, which read the clock many times
+// per collection.
+//
+// On x86 CPUs with an invariant timestamp counter, which ticks at a constant
+// rate whatever the power state and is synchronized between cores, now()
+// reads the counter and converts it to a TimeStamp with a frequency
+// calibrated against ReallyNow(). Elsewhere, and for reads before the
+// calibration, it is ReallyNow(), which on Linux and macOS is already read
+// through the vDSO or commpage without a system call.
+//
+// The calibration is done by the first read at least CalibrationMillis after
+// init(), and is continuous with the reads before it. From then on the clock
+// drifts from ReallyNow() by the calibration error, a few parts per million,
+// so only compare its TimeStamps with each other.
+class InstrumentationClock
+{
+    enum State : uint32_t {
+        Uncalibrated,
+        Calibrating,
+        Calibrated,
+        Unavailable
+    };
+
+    static const uint32_t CalibrationMillis = 20;
+
+    static mozilla::Atomic<uint32_t, mozilla::ReleaseAcquire> state_;
+
+    // Valid once the state is Uncalibrated; the frequency once it is
+    // Calibrated.
+    static mozilla::TimeStamp baseTime_;
+    static uint64_t baseTicks_;
+    static double microsPerTick_;
+
+    static mozilla::TimeStamp calibrateOrNow();
+
+  public:
+    // Called by JS_Init.
+    static void init();
+
+    static mozilla::TimeStamp now() {
+#ifdef MOZ_HAVE_RDTSC
+        if (state_ == Calibrated) {
+            // Signed, in case another core's counter is a few ticks behind.
+            int64_t ticks = int64_t(ReadTimestampCounter() - baseTicks_);
+            return baseTime_ +
+                   mozilla::TimeDuration::FromMicroseconds(double(ticks) * microsPerTick_);
+        }
+        return calibrateOrNow();
+#else
+        return ReallyNow();
+#endif
+    }
+
+    static bool usesTimestampCounter() {
+        return state_ == Calibrated;
+    }
+};
+
 } // namespace js
 
 #endif /* vm_Time_h */
@@ -20,6 +20,7 @@
 #include "threading/LockGuard.h"
 #include "util/Text.h"
 #include "vm/JSScript.h"
+#include "vm/Printer.h"
 #include "vm/Runtime.h"
 #include "vm/Time.h"
 #include "vm/TraceLoggingGraph.h"
@@ -159,6 +160,14 @@ TraceLoggerThread::init()
         return false;
     }
 
+    MOZ_ASSERT(traceLoggerState);
+    if (traceLoggerState->isRingBufferEnabled()) {
+        uint64_t start = rdtsc() - traceLoggerState->startupTime;
+        if (!ringBuffer.init(TraceLoggerThreadState::RingBufferCapacity, start)) {
+            return false;
+        }
+    }
+
     return true;
 }
 
@@ -353,6 +362,7 @@ TraceLoggerThread::sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const
     size += graphStack.sizeOfExcludingThis(mallocSizeOf);
 #endif
     size += events.sizeOfExcludingThis(mallocSizeOf);
+    size += ringBuffer.sizeOfExcludingThis(mallocSizeOf);
     if (graph.get()) {
         size += graph->sizeOfIncludingThis(mallocSizeOf);
     }
@@ -764,6 +774,11 @@ TraceLoggerThread::log(uint32_t id)
 
     MOZ_ASSERT(traceLoggerState);
 
+    if (ringBuffer.initialized()) {
+        ringBuffer.push(rdtsc() - traceLoggerState->startupTime, id);
+        return;
+    }
+
     // We request for 3 items to add, since if we don't have enough room
     // we record the time it took to make more space. To log this information
     // we need 2 extra free entries.
@@ -856,6 +871,44 @@ void TraceLoggerThread::clear()
         silentFail("Cannot reset event buffer.");
     }
 
+    if (ringBuffer.initialized()) {
+        ringBuffer.clear(rdtsc() - traceLoggerState->startupTime);
+    }
+}
+
+bool
+TraceLoggerThread::dumpRingBuffer(GenericPrinter& out, double seconds)
+{
+    if (!ringBuffer.initialized()) {
+        return true;
+    }
+
+    MOZ_ASSERT(traceLoggerState);
+    double ticksPerSecond = traceLoggerState->ticksPerSecond();
+    uint64_t now = rdtsc() - traceLoggerState->startupTime;
+    double window = seconds * ticksPerSecond;
+    uint64_t start = window < double(now) ? now - uint64_t(window) : 0;
+
+    // The ring buffer is walked newest first, so collect the events before
+    // printing them.
+    Vector<EventEntry, 0, SystemAllocPolicy> entries;
+    bool oom = false;
+    ringBuffer.forEachEventSince(start, [&](uint64_t time, uint32_t textId) {
+        if (!oom && !entries.emplaceBack(time, textId)) {
+            oom = true;
+        }
+    });
+    if (oom) {
+        return false;
+    }
+
+    for (size_t i = entries.length(); i != 0; i--) {
+        const EventEntry& entry = entries[i - 1];
+        const char* text = maybeEventText(entry.textId);
+        double micros = ticksPerSecond > 0 ? entry.time / ticksPerSecond * 1e6 : 0;
+        out.printf("%.3f %s\n", micros, text ? text : "(unknown)");
+    }
+    return true;
 }
 
 TraceLoggerThreadState::~TraceLoggerThreadState()
@@ -987,6 +1040,8 @@ TraceLoggerThreadState::init()
                 "  EnableOffThread         Start logging helper threads immediately.\n"
                 "  EnableGraph             Enable the tracelogging graph.\n"
                 "  EnableGraphFile         Enable flushing tracelogger data to a file.\n"
+                "  RingBuffer              Only keep the most recent events of each thread,\n"
+                "                          in a fixed size buffer. Excludes the graph.\n"
                 "  Errors                  Report errors during tracing to stderr.\n"
             );
             printf("\n");
@@ -1007,6 +1062,11 @@ TraceLoggerThreadState::init()
             graphFileEnabled = true;
             jit::JitOptions.enableTraceLogger = true;
         }
+        if (strstr(options, "RingBuffer")) {
+            ringBufferEnabled = true;
+            graphEnabled = false;
+            graphFileEnabled = false;
+        }
         if (strstr(options, "Errors")) {
             spewErrors = true;
         }
@@ -1019,6 +1079,7 @@ TraceLoggerThreadState::init()
     }
 
     startupTime = rdtsc();
+    startupTimeStamp = mozilla::TimeStamp::Now();
 
 #ifdef DEBUG
     initialized = true;
@@ -1027,6 +1088,16 @@ TraceLoggerThreadState::init()
     return true;
 }
 
+double
+TraceLoggerThreadState::ticksPerSecond()
+{
+    double elapsed = (mozilla::TimeStamp::Now() - startupTimeStamp).ToSeconds();
+    if (elapsed <= 0) {
+        return 0;
+    }
+    return (rdtsc() - startupTime) / elapsed;
+}
+
 void
 TraceLoggerThreadState::enableTextId(JSContext* cx, uint32_t textId)
 {
@@ -1258,8 +1329,13 @@ JS::StartTraceLogger(JSContext *cx)
     traceLoggerState->enableTextIdsForProfiler();
     jit::JitOptions.enableTraceLogger = true;
 
-    // Reset the start time to profile start so it aligns with sampling.
-    traceLoggerState->startupTime = rdtsc();
+    // Reset the start time to profile start so it aligns with sampling. The
+    // ring buffers store times relative to the previous event, so keep the
+    // start time when they are in use.
+    if (!traceLoggerState->isRingBufferEnabled()) {
+        traceLoggerState->startupTime = rdtsc();
+        traceLoggerState->startupTimeStamp = mozilla::TimeStamp::Now();
+    }
 
     if (cx->traceLogger) {
         cx->traceLogger->enable();
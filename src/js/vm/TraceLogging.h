@@ -11,6 +11,7 @@
 #include "mozilla/LinkedList.h"
 #include "mozilla/Maybe.h"
 #include "mozilla/MemoryReporting.h"
+#include "mozilla/TimeStamp.h"
 #include "mozilla/Vector.h"
 
 #include <utility>
@@ -71,6 +72,7 @@ namespace jit {
  */
 
 class AutoTraceLog;
+class GenericPrinter;
 class TraceLoggerEventPayload;
 class TraceLoggerThread;
 
@@ -252,6 +254,10 @@ class TraceLoggerThread : public mozilla::LinkedListElement<TraceLoggerThread>
 
     ContinuousSpace<EventEntry> events;
 
+    // In ring buffer mode, events are recorded here instead of in |events|,
+    // and are never flushed to the graph.
+    EventRingBuffer ringBuffer;
+
     // Every time the events get flushed, this count is increased by one.
     // Together with events.lastEntryId(), this gives an unique id for every
     // event.
@@ -288,6 +294,10 @@ class TraceLoggerThread : public mozilla::LinkedListElement<TraceLoggerThread>
 
     void silentFail(const char* error);
 
+    // Print the events of the ring buffer which happened in the last
+    // |seconds|, oldest first. Returns false on OOM.
+    bool dumpRingBuffer(GenericPrinter& out, double seconds);
+
     size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
     size_t sizeOfIncludingThis(mozilla::MallocSizeOf mallocSizeOf) const;
 
@@ -383,6 +393,7 @@ class TraceLoggerThreadState
     bool helperThreadEnabled;
     bool graphEnabled;
     bool graphFileEnabled;
+    bool ringBufferEnabled;
     bool spewErrors;
     mozilla::LinkedList<TraceLoggerThread> threadLoggers;
 
@@ -418,8 +429,14 @@ class TraceLoggerThreadState
     uint32_t nextDictionaryId;
 
   public:
+    // The number of events kept by each thread in ring buffer mode.
+    static const uint32_t RingBufferCapacity = 1 << 18;
+
     uint64_t startupTime;
 
+    // The TimeStamp at startupTime, used to convert event times to seconds.
+    mozilla::TimeStamp startupTimeStamp;
+
     // Mutex to guard the data structures used to hold the payload data:
     // textIdPayloads, payloadDictionary & dictionaryData.
     Mutex lock;
@@ -433,6 +450,7 @@ class TraceLoggerThreadState
         helperThreadEnabled(false),
         graphEnabled(false),
         graphFileEnabled(false),
+        ringBufferEnabled(false),
         spewErrors(false),
         nextTextId(TraceLogger_Last),
         nextDictionaryId(0),
@@ -488,6 +506,10 @@ class TraceLoggerThreadState
 
     bool isGraphFileEnabled()  { return graphFileEnabled; }
     bool isGraphEnabled()      { return graphEnabled;  }
+    bool isRingBufferEnabled() { return ringBufferEnabled; }
+
+    // The number of rdtsc ticks per second, measured since startup.
+    double ticksPerSecond();
 
     void enableTextIdsForProfiler();
     void disableTextIdsForProfiler();
@@ -7,6 +7,8 @@
 #ifndef TraceLoggingTypes_h
 #define TraceLoggingTypes_h
 
+#include "mozilla/MathAlgorithms.h"
+
 #include "builtin/String.h"
 
 #include "js/AllocPolicy.h"
@@ -73,6 +75,8 @@
     _(EdgeCaseAnalysis)                               \
     _(EliminateRedundantChecks)                       \
     _(AddKeepAliveInstructions)                       \
+    _(MarkColdBlocks)                                 \
+    _(EliminateInitPreBarriers)                       \
     _(GenerateLIR)                                    \
     _(RegisterAllocation)                             \
     _(GenerateCode)                                   \
@@ -311,6 +315,122 @@ class ContinuousSpace {
     }
 };
 
+// A compact event, recorded in an EventRingBuffer. The time is stored as
+// the difference to the time of the previous event.
+struct CompactEventEntry {
+    uint32_t timeDelta;
+    uint32_t textId;
+};
+
+// A fixed size buffer of the most recent events of a thread, which overwrites
+// the oldest events when it is full. This never allocates after init(), so a
+// thread can keep logging into it indefinitely, and the buffer can be dumped
+// on demand like a flight recorder.
+//
+// A time difference that doesn't fit in 32 bits is split over two entries:
+// an entry with the TimeExtension id holding the high bits comes before the
+// event itself, which holds the low bits.
+class EventRingBuffer {
+    CompactEventEntry* data_;
+    uint32_t capacity_;
+
+    // The number of entries pushed since the last clear(). The next entry is
+    // written at index |count_ % capacity_|.
+    uint64_t count_;
+
+    // The time of the most recent event.
+    uint64_t lastTime_;
+
+    void pushEntry(uint32_t timeDelta, uint32_t textId) {
+        CompactEventEntry& entry = data_[count_ & (capacity_ - 1)];
+        entry.timeDelta = timeDelta;
+        entry.textId = textId;
+        count_++;
+    }
+
+  public:
+    static const uint32_t TimeExtension = UINT32_MAX;
+
+    EventRingBuffer()
+      : data_(nullptr),
+        capacity_(0),
+        count_(0),
+        lastTime_(0)
+    { }
+
+    ~EventRingBuffer() {
+        js_free(data_);
+    }
+
+    // |capacity| must be a power of two.
+    bool init(uint32_t capacity, uint64_t startTime) {
+        MOZ_ASSERT(!data_);
+        MOZ_ASSERT(mozilla::IsPowerOfTwo(capacity));
+        data_ = js_pod_malloc<CompactEventEntry>(capacity);
+        if (!data_) {
+            return false;
+        }
+        capacity_ = capacity;
+        count_ = 0;
+        lastTime_ = startTime;
+        return true;
+    }
+
+    bool initialized() const {
+        return !!data_;
+    }
+
+    void push(uint64_t time, uint32_t textId) {
+        MOZ_ASSERT(initialized());
+        MOZ_ASSERT(textId != TimeExtension);
+
+        // The counters of some platforms aren't monotonic across cores.
+        uint64_t delta = time > lastTime_ ? time - lastTime_ : 0;
+        if (MOZ_UNLIKELY(delta > UINT32_MAX)) {
+            pushEntry(uint32_t(delta >> 32), TimeExtension);
+        }
+        pushEntry(uint32_t(delta), textId);
+        lastTime_ += delta;
+    }
+
+    void clear(uint64_t startTime) {
+        count_ = 0;
+        lastTime_ = startTime;
+    }
+
+    // Call |f(time, textId)| for the retained events with a time at or after
+    // |startTime|, newest first.
+    template <typename F>
+    void forEachEventSince(uint64_t startTime, F f) const {
+        uint64_t retained = count_ < capacity_ ? count_ : capacity_;
+        uint64_t time = lastTime_;
+        uint64_t i = count_;
+        while (i > count_ - retained) {
+            const CompactEventEntry& entry = data_[--i & (capacity_ - 1)];
+            MOZ_ASSERT(entry.textId != TimeExtension);
+            if (time < startTime) {
+                break;
+            }
+
+            f(time, entry.textId);
+
+            uint64_t delta = entry.timeDelta;
+            if (i > count_ - retained) {
+                const CompactEventEntry& prev = data_[(i - 1) & (capacity_ - 1)];
+                if (prev.textId == TimeExtension) {
+                    delta |= uint64_t(prev.timeDelta) << 32;
+                    i--;
+                }
+            }
+            time = delta < time ? time - delta : 0;
+        }
+    }
+
+    size_t sizeOfExcludingThis(mozilla::MallocSizeOf mallocSizeOf) const {
+        return mallocSizeOf(data_);
+    }
+};
+
 // The layout of the event log in memory and in the log file.
 // Readable by JS using TypedArrays.
 struct EventEntry {
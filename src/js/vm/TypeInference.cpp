@@ -4733,7 +4733,8 @@ ObjectGroup::sweep(const AutoSweepObjectGroup& sweep)
 
     if (auto* layout = maybeUnboxedLayout(sweep)) {
         // Remove unboxed layouts that are about to be finalized from the
-        // realm wide list while we are still on the main thread.
+        // realm wide list before the group is finalized in the background.
+        // This may happen on a GC helper thread that owns the zone.
         ObjectGroup* group = this;
         if (IsAboutToBeFinalizedUnbarriered(&group)) {
             layout->detachFromRealm();
@@ -4984,7 +4985,14 @@ TypeZone::endSweep(JSRuntime* rt)
 {
     sweepReleaseTypes = false;
 
-    rt->gc.freeAllLifoBlocksAfterSweeping(&sweepTypeLifoAlloc.ref());
+    // Nothing refers to the data in the swept pool anymore. Scripts which run
+    // after this GC rebuild their type information, so keep as many chunks as
+    // are needed for the live data, to be reused instead of allocating new
+    // ones, and free the rest.
+    LifoAlloc& sweepAlloc = sweepTypeLifoAlloc.ref();
+    size_t liveBytes = typeLifoAlloc().computedSizeOfExcludingThis();
+    typeLifoAlloc().reuseReleasedChunksFrom(&sweepAlloc, liveBytes);
+    rt->gc.freeAllLifoBlocksAfterSweeping(&sweepAlloc);
 }
 
 void
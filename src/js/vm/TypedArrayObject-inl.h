@@ -144,6 +144,26 @@ ConvertNumber(From src)
     return To(src);
 }
 
+// Convert |count| elements of |src| to the element type of |dest|. The two
+// ranges must not overlap, and neither may be shared memory.
+template<typename To, typename From>
+inline void
+ConvertElements(To* dest, const From* src, size_t count)
+{
+    for (size_t i = 0; i < count; i++) {
+        dest[i] = ConvertNumber<To>(src[i]);
+    }
+}
+
+// Vectorized versions of the most common conversions, defined in
+// TypedArrayObject.cpp.
+template<> void ConvertElements<float, double>(float* dest, const double* src, size_t count);
+template<> void ConvertElements<double, float>(double* dest, const float* src, size_t count);
+template<> void ConvertElements<float, uint8_t>(float* dest, const uint8_t* src, size_t count);
+template<> void ConvertElements<double, uint8_t>(double* dest, const uint8_t* src, size_t count);
+template<> void ConvertElements<float, int32_t>(float* dest, const int32_t* src, size_t count);
+template<> void ConvertElements<double, int32_t>(double* dest, const int32_t* src, size_t count);
+
 template<typename NativeType> struct TypeIDOfType;
 template<> struct TypeIDOfType<int8_t> { static const Scalar::Type id = Scalar::Int8; };
 template<> struct TypeIDOfType<uint8_t> { static const Scalar::Type id = Scalar::Uint8; };
@@ -188,6 +208,20 @@ class SharedOps
         js::jit::AtomicOperations::podMoveSafeWhenRacy(dest, src, nelem);
     }
 
+    template<typename T>
+    static void podFill(SharedMem<T*> dest, T value, size_t nelem) {
+        for (size_t i = 0; i < nelem; i++) {
+            js::jit::AtomicOperations::storeSafeWhenRacy(dest + i, value);
+        }
+    }
+
+    template<typename To, typename From>
+    static void convertElements(SharedMem<To*> dest, SharedMem<From*> src, size_t nelem) {
+        for (size_t i = 0; i < nelem; i++) {
+            store(dest + i, ConvertNumber<To>(load(src + i)));
+        }
+    }
+
     static SharedMem<void*> extract(TypedArrayObject* obj) {
         return obj->dataPointerEither();
     }
@@ -238,6 +272,17 @@ class UnsharedOps
         std::copy_n(start, n, result);
     }
 
+    template<typename T>
+    static void podFill(SharedMem<T*> dest, T value, size_t nelem) {
+        auto* first = dest.unwrapUnshared();
+        std::fill(first, first + nelem, value);
+    }
+
+    template<typename To, typename From>
+    static void convertElements(SharedMem<To*> dest, SharedMem<From*> src, size_t nelem) {
+        ConvertElements(dest.unwrapUnshared(), src.unwrapUnshared(), nelem);
+    }
+
     static SharedMem<void*> extract(TypedArrayObject* obj) {
         return SharedMem<void*>::unshared(obj->dataPointerUnshared());
     }
@@ -283,59 +328,43 @@ class ElementSpecific
         switch (source->type()) {
           case Scalar::Int8: {
             SharedMem<int8_t*> src = data.cast<int8_t*>();
-            for (uint32_t i = 0; i < count; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(Ops::load(src++)));
-            }
+            Ops::convertElements(dest, src, count);
             break;
           }
           case Scalar::Uint8:
           case Scalar::Uint8Clamped: {
             SharedMem<uint8_t*> src = data.cast<uint8_t*>();
-            for (uint32_t i = 0; i < count; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(Ops::load(src++)));
-            }
+            Ops::convertElements(dest, src, count);
             break;
           }
           case Scalar::Int16: {
             SharedMem<int16_t*> src = data.cast<int16_t*>();
-            for (uint32_t i = 0; i < count; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(Ops::load(src++)));
-            }
+            Ops::convertElements(dest, src, count);
             break;
           }
           case Scalar::Uint16: {
             SharedMem<uint16_t*> src = data.cast<uint16_t*>();
-            for (uint32_t i = 0; i < count; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(Ops::load(src++)));
-            }
+            Ops::convertElements(dest, src, count);
             break;
           }
           case Scalar::Int32: {
             SharedMem<int32_t*> src = data.cast<int32_t*>();
-            for (uint32_t i = 0; i < count; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(Ops::load(src++)));
-            }
+            Ops::convertElements(dest, src, count);
             break;
           }
           case Scalar::Uint32: {
             SharedMem<uint32_t*> src = data.cast<uint32_t*>();
-            for (uint32_t i = 0; i < count; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(Ops::load(src++)));
-            }
+            Ops::convertElements(dest, src, count);
             break;
           }
           case Scalar::Float32: {
             SharedMem<float*> src = data.cast<float*>();
-            for (uint32_t i = 0; i < count; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(Ops::load(src++)));
-            }
+            Ops::convertElements(dest, src, count);
             break;
           }
           case Scalar::Float64: {
             SharedMem<double*> src = data.cast<double*>();
-            for (uint32_t i = 0; i < count; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(Ops::load(src++)));
-            }
+            Ops::convertElements(dest, src, count);
             break;
           }
           default:
@@ -345,6 +374,23 @@ class ElementSpecific
         return true;
     }
 
+    /*
+     * Store the number |value|, converted to the element type, in the
+     * elements of |target| from |start| to |end| (exclusive).
+     */
+    static void
+    fill(TypedArrayObject* target, double value, uint32_t start, uint32_t end)
+    {
+        MOZ_ASSERT(TypeIDOfType<T>::id == target->type(),
+                   "calling wrong fill specialization");
+        MOZ_ASSERT(!target->hasDetachedBuffer(), "target isn't detached");
+        MOZ_ASSERT(start <= end);
+        MOZ_ASSERT(end <= target->length());
+
+        SharedMem<T*> dest = target->dataPointerEither().template cast<T*>() + start;
+        Ops::podFill(dest, doubleToNative(value), end - start);
+    }
+
     /*
      * Copy |source[0]| to |source[len]| (exclusive) elements into the typed
      * array |target|, starting at index |offset|.  |source| must not be a
@@ -511,60 +557,36 @@ class ElementSpecific
 
         switch (source->type()) {
           case Scalar::Int8: {
-            int8_t* src = static_cast<int8_t*>(data);
-            for (uint32_t i = 0; i < len; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(*src++));
-            }
+            Ops::convertElements(dest, SharedMem<int8_t*>::unshared(data), len);
             break;
           }
           case Scalar::Uint8:
           case Scalar::Uint8Clamped: {
-            uint8_t* src = static_cast<uint8_t*>(data);
-            for (uint32_t i = 0; i < len; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(*src++));
-            }
+            Ops::convertElements(dest, SharedMem<uint8_t*>::unshared(data), len);
             break;
           }
           case Scalar::Int16: {
-            int16_t* src = static_cast<int16_t*>(data);
-            for (uint32_t i = 0; i < len; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(*src++));
-            }
+            Ops::convertElements(dest, SharedMem<int16_t*>::unshared(data), len);
             break;
           }
           case Scalar::Uint16: {
-            uint16_t* src = static_cast<uint16_t*>(data);
-            for (uint32_t i = 0; i < len; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(*src++));
-            }
+            Ops::convertElements(dest, SharedMem<uint16_t*>::unshared(data), len);
             break;
           }
           case Scalar::Int32: {
-            int32_t* src = static_cast<int32_t*>(data);
-            for (uint32_t i = 0; i < len; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(*src++));
-            }
+            Ops::convertElements(dest, SharedMem<int32_t*>::unshared(data), len);
             break;
           }
           case Scalar::Uint32: {
-            uint32_t* src = static_cast<uint32_t*>(data);
-            for (uint32_t i = 0; i < len; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(*src++));
-            }
+            Ops::convertElements(dest, SharedMem<uint32_t*>::unshared(data), len);
             break;
           }
           case Scalar::Float32: {
-            float* src = static_cast<float*>(data);
-            for (uint32_t i = 0; i < len; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(*src++));
-            }
+            Ops::convertElements(dest, SharedMem<float*>::unshared(data), len);
             break;
           }
           case Scalar::Float64: {
-            double* src = static_cast<double*>(data);
-            for (uint32_t i = 0; i < len; ++i) {
-                Ops::store(dest++, ConvertNumber<T>(*src++));
-            }
+            Ops::convertElements(dest, SharedMem<double*>::unshared(data), len);
             break;
           }
           default:
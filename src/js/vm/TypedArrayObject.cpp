@@ -10,13 +10,21 @@
 #include "mozilla/Alignment.h"
 #include "mozilla/Casting.h"
 #include "mozilla/FloatingPoint.h"
+#include "mozilla/MathAlgorithms.h"
 #include "mozilla/PodOperations.h"
 #include "mozilla/TextUtils.h"
 
+#include <algorithm>
+#include <limits>
 #include <string.h>
+#include <type_traits>
 #ifndef XP_WIN
 # include <sys/mman.h>
 #endif
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#  define JS_TYPEDARRAY_SSE2
+#  include <emmintrin.h>
+#endif
 
 #include "jsapi.h"
 #include "jsnum.h"
@@ -1476,6 +1484,536 @@ js::TypedArray_bufferGetter(JSContext* cx, unsigned argc, Value* vp)
     return CallNonGenericMethod<TypedArrayObject::is, BufferGetterImpl>(cx, args);
 }
 
+// Sort keys are unsigned integers of the same width as the elements, which
+// compare in the same order as the elements: ascending for integers, and for
+// floating point numbers, -Infinity < ... < -0 < +0 < ... < +Infinity. NaNs
+// have no sort key, they are moved to the end separately.
+template <typename T, typename Key>
+struct TypedArraySortKey
+{
+    static const bool isFloatingPoint = false;
+    static const Key signBit = std::is_signed<T>::value ? Key(1) << (sizeof(Key) * 8 - 1) : 0;
+
+    static Key toKey(T v) { return Key(v) ^ signBit; }
+    static T fromKey(Key k) { return T(k ^ signBit); }
+};
+
+template <typename T, typename Key>
+struct FloatingTypedArraySortKey
+{
+    static const bool isFloatingPoint = true;
+    static const Key signBit = Key(1) << (sizeof(Key) * 8 - 1);
+
+    // Flip all the bits of negative numbers, and only the sign bit of
+    // positive numbers.
+    static Key toKey(T v) {
+        Key bits = mozilla::BitwiseCast<Key>(v);
+        return (bits & signBit) ? ~bits : (bits | signBit);
+    }
+    static T fromKey(Key k) {
+        return mozilla::BitwiseCast<T>((k & signBit) ? (k ^ signBit) : ~k);
+    }
+};
+
+template <>
+struct TypedArraySortKey<float, uint32_t> : FloatingTypedArraySortKey<float, uint32_t> {};
+
+template <>
+struct TypedArraySortKey<double, uint64_t> : FloatingTypedArraySortKey<double, uint64_t> {};
+
+// Below this length, comparison sorting the keys is faster than making a
+// pass over them for each byte.
+static const uint32_t TypedArrayRadixSortMinLength = 64;
+
+// LSD radix sort, one byte per pass. Passes in which every key has the same
+// digit are skipped, which makes small ranges of large element types cheap.
+template <typename Key>
+static void
+RadixSortKeys(Key* keys, Key* scratch, uint32_t length)
+{
+    static const size_t Passes = sizeof(Key);
+    uint32_t counts[Passes][256] = {};
+    for (uint32_t i = 0; i < length; i++) {
+        Key k = keys[i];
+        for (size_t pass = 0; pass < Passes; pass++) {
+            counts[pass][(k >> (pass * 8)) & 0xff]++;
+        }
+    }
+
+    Key* src = keys;
+    Key* dst = scratch;
+    for (size_t pass = 0; pass < Passes; pass++) {
+        uint32_t* count = counts[pass];
+        size_t shift = pass * 8;
+        if (count[(src[0] >> shift) & 0xff] == length) {
+            continue;
+        }
+
+        uint32_t sum = 0;
+        for (size_t digit = 0; digit < 256; digit++) {
+            uint32_t n = count[digit];
+            count[digit] = sum;
+            sum += n;
+        }
+        for (uint32_t i = 0; i < length; i++) {
+            Key k = src[i];
+            dst[count[(k >> shift) & 0xff]++] = k;
+        }
+        std::swap(src, dst);
+    }
+
+    if (src != keys) {
+        mozilla::PodCopy(keys, src, length);
+    }
+}
+
+template <typename T, typename Key>
+static bool
+SortTypedArrayElements(JSContext* cx, Handle<TypedArrayObject*> tarray)
+{
+    typedef TypedArraySortKey<T, Key> SortKey;
+
+    uint32_t length = tarray->length();
+    bool useRadixSort = length >= TypedArrayRadixSortMinLength;
+
+    // Allocate before reading the data pointer, which may move if we GC.
+    UniquePtr<Key[], JS::FreePolicy> keys(cx->pod_malloc<Key>(length));
+    if (!keys) {
+        return false;
+    }
+    UniquePtr<Key[], JS::FreePolicy> scratch;
+    if (useRadixSort) {
+        scratch.reset(cx->pod_malloc<Key>(length));
+        if (!scratch) {
+            return false;
+        }
+    }
+
+    // Work on a copy of the elements, to be safe if the memory is shared.
+    JS::AutoCheckCannotGC nogc;
+    SharedMem<T*> data = tarray->dataPointerEither().cast<T*>();
+    uint32_t keyCount = 0;
+    for (uint32_t i = 0; i < length; i++) {
+        T v = jit::AtomicOperations::loadSafeWhenRacy(data + i);
+        if (SortKey::isFloatingPoint && v != v) {
+            continue;
+        }
+        keys[keyCount++] = SortKey::toKey(v);
+    }
+
+    if (useRadixSort && keyCount > 0) {
+        RadixSortKeys(keys.get(), scratch.get(), keyCount);
+    } else {
+        std::sort(keys.get(), keys.get() + keyCount);
+    }
+
+    for (uint32_t i = 0; i < keyCount; i++) {
+        jit::AtomicOperations::storeSafeWhenRacy(data + i, SortKey::fromKey(keys[i]));
+    }
+    for (uint32_t i = keyCount; i < length; i++) {
+        jit::AtomicOperations::storeSafeWhenRacy(data + i, T(JS::GenericNaN()));
+    }
+    return true;
+}
+
+bool
+js::intrinsic_TypedArrayNativeSort(JSContext* cx, unsigned argc, Value* vp)
+{
+    // This function is called from the self-hosted %TypedArray%.prototype.sort
+    // when no comparator was passed, and sorts the elements in place.
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 1);
+
+    Rooted<TypedArrayObject*> tarray(cx, &args[0].toObject().as<TypedArrayObject>());
+    MOZ_ASSERT(!tarray->hasDetachedBuffer());
+
+    bool ok;
+    switch (tarray->type()) {
+      case Scalar::Int8:
+        ok = SortTypedArrayElements<int8_t, uint8_t>(cx, tarray);
+        break;
+      case Scalar::Uint8:
+      case Scalar::Uint8Clamped:
+        ok = SortTypedArrayElements<uint8_t, uint8_t>(cx, tarray);
+        break;
+      case Scalar::Int16:
+        ok = SortTypedArrayElements<int16_t, uint16_t>(cx, tarray);
+        break;
+      case Scalar::Uint16:
+        ok = SortTypedArrayElements<uint16_t, uint16_t>(cx, tarray);
+        break;
+      case Scalar::Int32:
+        ok = SortTypedArrayElements<int32_t, uint32_t>(cx, tarray);
+        break;
+      case Scalar::Uint32:
+        ok = SortTypedArrayElements<uint32_t, uint32_t>(cx, tarray);
+        break;
+      case Scalar::Float32:
+        ok = SortTypedArrayElements<float, uint32_t>(cx, tarray);
+        break;
+      case Scalar::Float64:
+        ok = SortTypedArrayElements<double, uint64_t>(cx, tarray);
+        break;
+      default:
+        MOZ_CRASH("unexpected typed array type");
+    }
+    if (!ok) {
+        return false;
+    }
+
+    args.rval().setObject(*tarray);
+    return true;
+}
+
+bool
+js::intrinsic_TypedArrayNativeFill(JSContext* cx, unsigned argc, Value* vp)
+{
+    // This function is called from the self-hosted %TypedArray%.prototype.fill
+    // after the arguments have been converted, to store |value| in the
+    // elements from |start| to |end| (exclusive).
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 4);
+
+    TypedArrayObject* tarray = &args[0].toObject().as<TypedArrayObject>();
+    MOZ_ASSERT(!tarray->hasDetachedBuffer());
+    double value = args[1].toNumber();
+    uint32_t start = uint32_t(args[2].toNumber());
+    uint32_t end = uint32_t(args[3].toNumber());
+
+    if (start < end) {
+        switch (tarray->type()) {
+#define FILL_TYPED_ARRAY(T, N) \
+          case Scalar::N: \
+            if (tarray->isSharedMemory()) { \
+                ElementSpecific<T, SharedOps>::fill(tarray, value, start, end); \
+            } else { \
+                ElementSpecific<T, UnsharedOps>::fill(tarray, value, start, end); \
+            } \
+            break;
+JS_FOR_EACH_TYPED_ARRAY(FILL_TYPED_ARRAY)
+#undef FILL_TYPED_ARRAY
+          default:
+            MOZ_CRASH("unexpected typed array type");
+        }
+    }
+
+    args.rval().setUndefined();
+    return true;
+}
+
+enum class TypedArraySearch { IndexOf, LastIndexOf, Includes };
+
+// Convert the number being searched for to the element type. Returns false if
+// no element can be equal to it.
+template <typename T>
+static bool
+SearchValueToNative(double d, T* result)
+{
+    if (!std::is_floating_point<T>::value &&
+        !(d >= double(std::numeric_limits<T>::min()) &&
+          d <= double(std::numeric_limits<T>::max())))
+    {
+        return false;
+    }
+
+    // For floating point elements this also rejects NaN, which is not equal
+    // to anything, and doubles which can't be represented as floats.
+    T v = T(d);
+    if (double(v) != d) {
+        return false;
+    }
+    *result = v;
+    return true;
+}
+
+#ifdef JS_TYPEDARRAY_SSE2
+// Lane-wise equality of the elements in two vectors. Floating point lanes
+// compare like numbers, so -0 and +0 are equal.
+template <typename T> static inline __m128i CompareEqualLanes(__m128i a, __m128i b);
+
+template <> inline __m128i CompareEqualLanes<int8_t>(__m128i a, __m128i b) {
+    return _mm_cmpeq_epi8(a, b);
+}
+template <> inline __m128i CompareEqualLanes<uint8_t>(__m128i a, __m128i b) {
+    return _mm_cmpeq_epi8(a, b);
+}
+template <> inline __m128i CompareEqualLanes<int16_t>(__m128i a, __m128i b) {
+    return _mm_cmpeq_epi16(a, b);
+}
+template <> inline __m128i CompareEqualLanes<uint16_t>(__m128i a, __m128i b) {
+    return _mm_cmpeq_epi16(a, b);
+}
+template <> inline __m128i CompareEqualLanes<int32_t>(__m128i a, __m128i b) {
+    return _mm_cmpeq_epi32(a, b);
+}
+template <> inline __m128i CompareEqualLanes<uint32_t>(__m128i a, __m128i b) {
+    return _mm_cmpeq_epi32(a, b);
+}
+template <> inline __m128i CompareEqualLanes<float>(__m128i a, __m128i b) {
+    return _mm_castps_si128(_mm_cmpeq_ps(_mm_castsi128_ps(a), _mm_castsi128_ps(b)));
+}
+template <> inline __m128i CompareEqualLanes<double>(__m128i a, __m128i b) {
+    return _mm_castpd_si128(_mm_cmpeq_pd(_mm_castsi128_pd(a), _mm_castsi128_pd(b)));
+}
+
+// Returns a bit mask with the bits for the bytes of the lanes of |block|
+// which are equal to the lanes of |needle| set.
+template <typename T>
+static inline uint32_t
+MatchLanes(const T* block, __m128i needle)
+{
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(block));
+    return uint32_t(_mm_movemask_epi8(CompareEqualLanes<T>(v, needle)));
+}
+#endif
+
+// Returns the index of the first element in [start, end) equal to |target|,
+// or -1. The elements must not be in shared memory.
+template <typename T>
+static int32_t
+FindElementForward(const T* data, uint32_t start, uint32_t end, T target)
+{
+    uint32_t i = start;
+#ifdef JS_TYPEDARRAY_SSE2
+    static const uint32_t Lanes = 16 / sizeof(T);
+    T lanes[Lanes];
+    std::fill(lanes, lanes + Lanes, target);
+    __m128i needle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+    for (; end - i >= Lanes; i += Lanes) {
+        if (uint32_t mask = MatchLanes(data + i, needle)) {
+            return int32_t(i + mozilla::CountTrailingZeroes32(mask) / sizeof(T));
+        }
+    }
+#endif
+    for (; i < end; i++) {
+        if (data[i] == target) {
+            return int32_t(i);
+        }
+    }
+    return -1;
+}
+
+// Returns the index of the last element in [0, end) equal to |target|, or -1.
+// The elements must not be in shared memory.
+template <typename T>
+static int32_t
+FindElementBackward(const T* data, uint32_t end, T target)
+{
+    uint32_t i = end;
+#ifdef JS_TYPEDARRAY_SSE2
+    static const uint32_t Lanes = 16 / sizeof(T);
+    T lanes[Lanes];
+    std::fill(lanes, lanes + Lanes, target);
+    __m128i needle = _mm_loadu_si128(reinterpret_cast<const __m128i*>(lanes));
+    while (i >= Lanes) {
+        i -= Lanes;
+        if (uint32_t mask = MatchLanes(data + i, needle)) {
+            return int32_t(i + (31 - mozilla::CountLeadingZeroes32(mask)) / sizeof(T));
+        }
+    }
+#endif
+    while (i > 0) {
+        i--;
+        if (data[i] == target) {
+            return int32_t(i);
+        }
+    }
+    return -1;
+}
+
+template <typename T>
+static int32_t
+SearchTypedArrayElements(TypedArrayObject* tarray, double searchValue, uint32_t k,
+                         TypedArraySearch search)
+{
+    // The length is zero if the buffer was detached after the search was
+    // started, in which case nothing is found.
+    uint32_t length = tarray->length();
+    uint32_t start, end;
+    if (search == TypedArraySearch::LastIndexOf) {
+        if (length == 0) {
+            return -1;
+        }
+        start = 0;
+        end = std::min(k, length - 1) + 1;
+    } else {
+        if (k >= length) {
+            return -1;
+        }
+        start = k;
+        end = length;
+    }
+
+    JS::AutoCheckCannotGC nogc;
+    SharedMem<T*> data = tarray->dataPointerEither().cast<T*>();
+
+    T target;
+    if (!SearchValueToNative(searchValue, &target)) {
+        // Includes uses SameValueZero, for which NaN is equal to NaN.
+        if (search != TypedArraySearch::Includes || !mozilla::IsNaN(searchValue)) {
+            return -1;
+        }
+        for (uint32_t i = start; i < end; i++) {
+            T v = jit::AtomicOperations::loadSafeWhenRacy(data + i);
+            if (v != v) {
+                return int32_t(i);
+            }
+        }
+        return -1;
+    }
+
+    if (tarray->isSharedMemory()) {
+        if (search == TypedArraySearch::LastIndexOf) {
+            for (uint32_t i = end; i > start; i--) {
+                if (jit::AtomicOperations::loadSafeWhenRacy(data + (i - 1)) == target) {
+                    return int32_t(i - 1);
+                }
+            }
+        } else {
+            for (uint32_t i = start; i < end; i++) {
+                if (jit::AtomicOperations::loadSafeWhenRacy(data + i) == target) {
+                    return int32_t(i);
+                }
+            }
+        }
+        return -1;
+    }
+
+    if (search == TypedArraySearch::LastIndexOf) {
+        return FindElementBackward(data.unwrapUnshared(), end, target);
+    }
+    return FindElementForward(data.unwrapUnshared(), start, end, target);
+}
+
+static int32_t
+SearchTypedArray(TypedArrayObject* tarray, double d, uint32_t k, TypedArraySearch search)
+{
+    switch (tarray->type()) {
+      case Scalar::Int8:
+        return SearchTypedArrayElements<int8_t>(tarray, d, k, search);
+      case Scalar::Uint8:
+      case Scalar::Uint8Clamped:
+        return SearchTypedArrayElements<uint8_t>(tarray, d, k, search);
+      case Scalar::Int16:
+        return SearchTypedArrayElements<int16_t>(tarray, d, k, search);
+      case Scalar::Uint16:
+        return SearchTypedArrayElements<uint16_t>(tarray, d, k, search);
+      case Scalar::Int32:
+        return SearchTypedArrayElements<int32_t>(tarray, d, k, search);
+      case Scalar::Uint32:
+        return SearchTypedArrayElements<uint32_t>(tarray, d, k, search);
+      case Scalar::Float32:
+        return SearchTypedArrayElements<float>(tarray, d, k, search);
+      case Scalar::Float64:
+        return SearchTypedArrayElements<double>(tarray, d, k, search);
+      default:
+        MOZ_CRASH("unexpected typed array type");
+    }
+}
+
+static int32_t
+SearchTypedArray(TypedArrayObject* tarray, const Value& searchElement, uint32_t k,
+                 TypedArraySearch search)
+{
+    // Typed array elements are numbers, so nothing else can be found.
+    if (!searchElement.isNumber()) {
+        return -1;
+    }
+    return SearchTypedArray(tarray, searchElement.toNumber(), k, search);
+}
+
+// These are called from the self-hosted %TypedArray%.prototype.indexOf,
+// lastIndexOf and includes with the non-negative index to start searching
+// from, after the arguments have been converted.
+
+bool
+js::intrinsic_TypedArrayNativeIndexOf(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 3);
+
+    TypedArrayObject* tarray = &args[0].toObject().as<TypedArrayObject>();
+    uint32_t k = uint32_t(args[2].toNumber());
+    args.rval().setInt32(SearchTypedArray(tarray, args[1], k, TypedArraySearch::IndexOf));
+    return true;
+}
+
+bool
+js::intrinsic_TypedArrayNativeLastIndexOf(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 3);
+
+    TypedArrayObject* tarray = &args[0].toObject().as<TypedArrayObject>();
+    uint32_t k = uint32_t(args[2].toNumber());
+    args.rval().setInt32(SearchTypedArray(tarray, args[1], k, TypedArraySearch::LastIndexOf));
+    return true;
+}
+
+bool
+js::intrinsic_TypedArrayNativeIncludes(JSContext* cx, unsigned argc, Value* vp)
+{
+    CallArgs args = CallArgsFromVp(argc, vp);
+    MOZ_ASSERT(args.length() == 3);
+
+    TypedArrayObject* tarray = &args[0].toObject().as<TypedArrayObject>();
+    uint32_t k = uint32_t(args[2].toNumber());
+    args.rval().setBoolean(SearchTypedArray(tarray, args[1], k, TypedArraySearch::Includes) >= 0);
+    return true;
+}
+
+void
+js::TypedArrayFillInt32(TypedArrayObject* tarray, int32_t value, int32_t start, int32_t end)
+{
+    AutoUnsafeCallWithABI unsafe;
+    MOZ_ASSERT(!tarray->hasDetachedBuffer());
+    MOZ_ASSERT(start >= 0);
+    MOZ_ASSERT(end <= int32_t(tarray->length()));
+
+    if (start >= end) {
+        return;
+    }
+
+    switch (tarray->type()) {
+#define FILL_TYPED_ARRAY(T, N) \
+      case Scalar::N: \
+        if (tarray->isSharedMemory()) { \
+            ElementSpecific<T, SharedOps>::fill(tarray, value, start, end); \
+        } else { \
+            ElementSpecific<T, UnsharedOps>::fill(tarray, value, start, end); \
+        } \
+        break;
+JS_FOR_EACH_TYPED_ARRAY(FILL_TYPED_ARRAY)
+#undef FILL_TYPED_ARRAY
+      default:
+        MOZ_CRASH("unexpected typed array type");
+    }
+}
+
+int32_t
+js::TypedArrayIndexOfInt32(TypedArrayObject* tarray, int32_t value, int32_t k)
+{
+    AutoUnsafeCallWithABI unsafe;
+    MOZ_ASSERT(k >= 0);
+    return SearchTypedArray(tarray, double(value), uint32_t(k), TypedArraySearch::IndexOf);
+}
+
+int32_t
+js::TypedArrayLastIndexOfInt32(TypedArrayObject* tarray, int32_t value, int32_t k)
+{
+    AutoUnsafeCallWithABI unsafe;
+    MOZ_ASSERT(k >= 0);
+    return SearchTypedArray(tarray, double(value), uint32_t(k), TypedArraySearch::LastIndexOf);
+}
+
+bool
+js::TypedArrayIncludesInt32(TypedArrayObject* tarray, int32_t value, int32_t k)
+{
+    AutoUnsafeCallWithABI unsafe;
+    MOZ_ASSERT(k >= 0);
+    return SearchTypedArray(tarray, double(value), uint32_t(k), TypedArraySearch::Includes) >= 0;
+}
+
 /* static */ const JSPropertySpec
 TypedArrayObject::protoAccessors[] = {
     JS_PSG("length", TypedArray_lengthGetter, 0),
@@ -1486,6 +2024,122 @@ TypedArrayObject::protoAccessors[] = {
     JS_PS_END
 };
 
+// Vectorized element type conversions for ElementSpecific::setFromTypedArray.
+// These produce the same results as ConvertNumber: double to float conversion
+// rounds to nearest, like the C++ cast, and the others are exact.
+
+template<>
+void
+js::ConvertElements<float, double>(float* dest, const double* src, size_t count)
+{
+    size_t i = 0;
+#ifdef JS_TYPEDARRAY_SSE2
+    for (; count - i >= 4; i += 4) {
+        __m128 lo = _mm_cvtpd_ps(_mm_loadu_pd(src + i));
+        __m128 hi = _mm_cvtpd_ps(_mm_loadu_pd(src + i + 2));
+        _mm_storeu_ps(dest + i, _mm_movelh_ps(lo, hi));
+    }
+#endif
+    for (; i < count; i++) {
+        dest[i] = float(src[i]);
+    }
+}
+
+template<>
+void
+js::ConvertElements<double, float>(double* dest, const float* src, size_t count)
+{
+    size_t i = 0;
+#ifdef JS_TYPEDARRAY_SSE2
+    for (; count - i >= 4; i += 4) {
+        __m128 v = _mm_loadu_ps(src + i);
+        _mm_storeu_pd(dest + i, _mm_cvtps_pd(v));
+        _mm_storeu_pd(dest + i + 2, _mm_cvtps_pd(_mm_movehl_ps(v, v)));
+    }
+#endif
+    for (; i < count; i++) {
+        dest[i] = double(src[i]);
+    }
+}
+
+template<>
+void
+js::ConvertElements<float, uint8_t>(float* dest, const uint8_t* src, size_t count)
+{
+    size_t i = 0;
+#ifdef JS_TYPEDARRAY_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; count - i >= 16; i += 16) {
+        __m128i bytes = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        __m128i lo = _mm_unpacklo_epi8(bytes, zero);
+        __m128i hi = _mm_unpackhi_epi8(bytes, zero);
+        _mm_storeu_ps(dest + i, _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)));
+        _mm_storeu_ps(dest + i + 4, _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)));
+        _mm_storeu_ps(dest + i + 8, _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)));
+        _mm_storeu_ps(dest + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)));
+    }
+#endif
+    for (; i < count; i++) {
+        dest[i] = float(src[i]);
+    }
+}
+
+template<>
+void
+js::ConvertElements<double, uint8_t>(double* dest, const uint8_t* src, size_t count)
+{
+    size_t i = 0;
+#ifdef JS_TYPEDARRAY_SSE2
+    const __m128i zero = _mm_setzero_si128();
+    for (; count - i >= 8; i += 8) {
+        __m128i bytes = _mm_loadl_epi64(reinterpret_cast<const __m128i*>(src + i));
+        __m128i words = _mm_unpacklo_epi8(bytes, zero);
+        __m128i lo = _mm_unpacklo_epi16(words, zero);
+        __m128i hi = _mm_unpackhi_epi16(words, zero);
+        _mm_storeu_pd(dest + i, _mm_cvtepi32_pd(lo));
+        _mm_storeu_pd(dest + i + 2, _mm_cvtepi32_pd(_mm_srli_si128(lo, 8)));
+        _mm_storeu_pd(dest + i + 4, _mm_cvtepi32_pd(hi));
+        _mm_storeu_pd(dest + i + 6, _mm_cvtepi32_pd(_mm_srli_si128(hi, 8)));
+    }
+#endif
+    for (; i < count; i++) {
+        dest[i] = double(src[i]);
+    }
+}
+
+template<>
+void
+js::ConvertElements<float, int32_t>(float* dest, const int32_t* src, size_t count)
+{
+    size_t i = 0;
+#ifdef JS_TYPEDARRAY_SSE2
+    for (; count - i >= 4; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_ps(dest + i, _mm_cvtepi32_ps(v));
+    }
+#endif
+    for (; i < count; i++) {
+        dest[i] = float(src[i]);
+    }
+}
+
+template<>
+void
+js::ConvertElements<double, int32_t>(double* dest, const int32_t* src, size_t count)
+{
+    size_t i = 0;
+#ifdef JS_TYPEDARRAY_SSE2
+    for (; count - i >= 4; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i*>(src + i));
+        _mm_storeu_pd(dest + i, _mm_cvtepi32_pd(v));
+        _mm_storeu_pd(dest + i + 2, _mm_cvtepi32_pd(_mm_srli_si128(v, 8)));
+    }
+#endif
+    for (; i < count; i++) {
+        dest[i] = double(src[i]);
+    }
+}
+
 template<typename T>
 static inline bool
 SetFromTypedArray(Handle<TypedArrayObject*> target, Handle<TypedArrayObject*> source,
@@ -1861,6 +2515,7 @@ TypedArrayObject::getElement(uint32_t index)
       case Scalar::Uint8Clamped:
         return Uint8ClampedArray::getIndexValue(this, index);
       case Scalar::Int64:
+      case Scalar::Simd128:
       case Scalar::MaxTypedArrayViewType:
         break;
     }
@@ -1907,6 +2562,7 @@ TypedArrayObject::setElement(TypedArrayObject& obj, uint32_t index, double d)
         Float64Array::setIndexValue(obj, index, d);
         return;
       case Scalar::Int64:
+      case Scalar::Simd128:
       case Scalar::MaxTypedArrayViewType:
         break;
     }
@@ -193,6 +193,26 @@ class TypedArrayObject : public ArrayBufferViewObject
 
 MOZ_MUST_USE bool TypedArray_bufferGetter(JSContext* cx, unsigned argc, Value* vp);
 
+// Sort the elements of an unwrapped typed array in place, in the default sort
+// order. Used by the self-hosted %TypedArray%.prototype.sort.
+extern bool
+intrinsic_TypedArrayNativeSort(JSContext* cx, unsigned argc, Value* vp);
+
+// Fill, and search for a value in, the elements of an unwrapped typed array.
+// Used by the self-hosted %TypedArray%.prototype.fill, indexOf, lastIndexOf and
+// includes once their arguments have been converted.
+extern bool
+intrinsic_TypedArrayNativeFill(JSContext* cx, unsigned argc, Value* vp);
+
+extern bool
+intrinsic_TypedArrayNativeIndexOf(JSContext* cx, unsigned argc, Value* vp);
+
+extern bool
+intrinsic_TypedArrayNativeLastIndexOf(JSContext* cx, unsigned argc, Value* vp);
+
+extern bool
+intrinsic_TypedArrayNativeIncludes(JSContext* cx, unsigned argc, Value* vp);
+
 extern TypedArrayObject*
 TypedArrayCreateWithTemplate(JSContext* cx, HandleObject templateObj, int32_t len);
 
@@ -320,6 +340,21 @@ extern void
 SetDisjointTypedElements(TypedArrayObject* target, uint32_t targetOffset,
                          TypedArrayObject* unsafeSrcCrossCompartment);
 
+// Versions of intrinsic_TypedArrayNativeFill, intrinsic_TypedArrayNativeIndexOf,
+// intrinsic_TypedArrayNativeLastIndexOf and intrinsic_TypedArrayNativeIncludes
+// for int32 values, called from Ion code.
+extern void
+TypedArrayFillInt32(TypedArrayObject* tarray, int32_t value, int32_t start, int32_t end);
+
+extern int32_t
+TypedArrayIndexOfInt32(TypedArrayObject* tarray, int32_t value, int32_t k);
+
+extern int32_t
+TypedArrayLastIndexOfInt32(TypedArrayObject* tarray, int32_t value, int32_t k);
+
+extern bool
+TypedArrayIncludesInt32(TypedArrayObject* tarray, int32_t value, int32_t k);
+
 } // namespace js
 
 template <>
@@ -0,0 +1,243 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#include "js/UbiNodeSnapshot.h"
+
+#include "mozilla/HashFunctions.h"
+#include "mozilla/Move.h"
+
+#include "js/AllocPolicy.h"
+#include "js/HashTable.h"
+#include "js/UbiNodeBreadthFirst.h"
+#include "js/Vector.h"
+#include "util/Text.h"
+
+namespace JS {
+namespace ubi {
+
+namespace {
+
+struct TwoByteCharsHasher
+{
+    using Lookup = const char16_t*;
+
+    static js::HashNumber hash(Lookup l) {
+        return mozilla::HashString(l);
+    }
+    static bool match(const char16_t* key, Lookup l) {
+        size_t length = js_strlen(key);
+        return js_strlen(l) == length && js::EqualChars(key, l, length);
+    }
+};
+
+class HeapSnapshotWriter
+{
+    // Edge names are interned by their contents, which needs a copy of each
+    // one. Stop interning new names after this many, to bound the memory
+    // used on heaps with many distinct property names: later names are
+    // defined again each time they're used.
+    static const size_t MaxInternedEdgeNames = 1 << 16;
+
+    template <typename Key, typename Hasher = js::DefaultHasher<Key>>
+    using StringMap = js::HashMap<Key, uint32_t, Hasher, js::SystemAllocPolicy>;
+
+    FILE* fp_;
+    uint32_t nextString_;
+
+    // Type names and class names are static strings, so we can use their
+    // addresses as keys.
+    StringMap<const char16_t*> typeNames_;
+    StringMap<const char*> classNames_;
+    StringMap<const char16_t*, TwoByteCharsHasher> edgeNames_;
+    js::Vector<UniqueTwoByteChars, 0, js::SystemAllocPolicy> edgeNameChars_;
+
+    void writeVarint(uint64_t n) {
+        while (n >= 0x80) {
+            putc(int((n & 0x7f) | 0x80), fp_);
+            n >>= 7;
+        }
+        putc(int(n), fp_);
+    }
+
+    void writeTag(SnapshotRecord tag) {
+        writeVarint(uint64_t(tag));
+    }
+
+    template <typename CharT>
+    uint32_t defineString(const CharT* chars) {
+        size_t length = 0;
+        while (chars[length]) {
+            length++;
+        }
+
+        writeTag(SnapshotRecord::String);
+        writeVarint(length);
+        for (size_t i = 0; i < length; i++) {
+            // Class names are ASCII, so this doesn't need to widen them any
+            // more carefully.
+            writeVarint(uint64_t(char16_t(chars[i])));
+        }
+        return nextString_++;
+    }
+
+    template <typename Map, typename CharT>
+    MOZ_MUST_USE bool internStaticString(Map& map, const CharT* chars, uint32_t* index) {
+        typename Map::AddPtr p = map.lookupForAdd(chars);
+        if (p) {
+            *index = p->value();
+            return true;
+        }
+        *index = defineString(chars);
+        return map.add(p, chars, *index);
+    }
+
+    MOZ_MUST_USE bool internEdgeName(const char16_t* name, uint32_t* index) {
+        auto p = edgeNames_.lookupForAdd(name);
+        if (p) {
+            *index = p->value();
+            return true;
+        }
+
+        *index = defineString(name);
+        if (edgeNames_.count() >= MaxInternedEdgeNames) {
+            return true;
+        }
+
+        UniqueTwoByteChars copy = js::DuplicateString(name);
+        if (!copy) {
+            return false;
+        }
+        const char16_t* key = copy.get();
+        return edgeNameChars_.append(std::move(copy)) && edgeNames_.add(p, key, *index);
+    }
+
+  public:
+    explicit HeapSnapshotWriter(FILE* fp)
+      : fp_(fp),
+        nextString_(0)
+    {}
+
+    void writeHeader() {
+        fputs("UBIS", fp_);
+        writeVarint(SnapshotFormatVersion);
+    }
+
+    MOZ_MUST_USE bool writeNode(const Node& node, mozilla::MallocSizeOf mallocSizeOf) {
+        uint32_t typeName;
+        if (!internStaticString(typeNames_, node.typeName(), &typeName)) {
+            return false;
+        }
+
+        uint32_t className = 0;
+        if (const char* name = node.jsObjectClassName()) {
+            if (!internStaticString(classNames_, name, &className)) {
+                return false;
+            }
+            className++;
+        }
+
+        writeTag(SnapshotRecord::Node);
+        writeVarint(node.identifier());
+        writeVarint(typeName);
+        writeVarint(uint64_t(node.coarseType()));
+        writeVarint(node.size(mallocSizeOf));
+        writeVarint(className);
+        return true;
+    }
+
+    void writeOrigin(const Node& node) {
+        writeTag(SnapshotRecord::Origin);
+        writeVarint(node.identifier());
+    }
+
+    MOZ_MUST_USE bool writeEdge(const Edge& edge) {
+        uint32_t name = 0;
+        if (edge.name) {
+            if (!internEdgeName(edge.name.get(), &name)) {
+                return false;
+            }
+            name++;
+        }
+
+        writeTag(SnapshotRecord::Edge);
+        writeVarint(edge.referent.identifier());
+        writeVarint(name);
+        return true;
+    }
+
+    MOZ_MUST_USE bool finish() {
+        writeTag(SnapshotRecord::End);
+        return fflush(fp_) == 0 && !ferror(fp_);
+    }
+
+    bool hadError() const {
+        return ferror(fp_);
+    }
+};
+
+// A BreadthFirst handler which writes each node when it is first reached,
+// and each edge when it is traversed.
+class HeapSnapshotHandler
+{
+    HeapSnapshotWriter& writer_;
+    mozilla::MallocSizeOf mallocSizeOf_;
+    Node currentOrigin_;
+
+  public:
+    struct NodeData { };
+    using Traversal = BreadthFirst<HeapSnapshotHandler>;
+
+    HeapSnapshotHandler(HeapSnapshotWriter& writer, mozilla::MallocSizeOf mallocSizeOf)
+      : writer_(writer),
+        mallocSizeOf_(mallocSizeOf)
+    {}
+
+    bool operator()(Traversal& traversal, Node origin, const Edge& edge, NodeData* referentData,
+                    bool first)
+    {
+        // BreadthFirst reports all of the edges of an origin together.
+        if (origin != currentOrigin_) {
+            writer_.writeOrigin(origin);
+            currentOrigin_ = origin;
+        }
+
+        if (!writer_.writeEdge(edge)) {
+            return false;
+        }
+        if (first && !writer_.writeNode(edge.referent, mallocSizeOf_)) {
+            return false;
+        }
+
+        // Stop at the first write error rather than traversing the rest of
+        // the heap for nothing.
+        return !writer_.hadError();
+    }
+};
+
+} // anonymous namespace
+
+JS_PUBLIC_API(bool)
+WriteHeapSnapshot(JSContext* cx, const Node& root, FILE* fp, mozilla::MallocSizeOf mallocSizeOf,
+                  bool wantNames, const JS::AutoRequireNoGC& noGC)
+{
+    HeapSnapshotWriter writer(fp);
+    writer.writeHeader();
+    if (!writer.writeNode(root, mallocSizeOf)) {
+        return false;
+    }
+
+    HeapSnapshotHandler handler(writer, mallocSizeOf);
+    HeapSnapshotHandler::Traversal traversal(cx, handler, noGC);
+    traversal.wantNames = wantNames;
+    if (!traversal.addStartVisited(root) || !traversal.traverse()) {
+        return false;
+    }
+
+    return writer.finish();
+}
+
+} // namespace ubi
+} // namespace JS
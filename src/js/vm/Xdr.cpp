@@ -392,6 +392,21 @@ XDRIncrementalEncoder::linearize(JS::TranscodeBuffer& buffer)
         }
     }
 
+    // Reserve the space for all the slices up front, such that large caches
+    // are not copied each time the buffer grows. Nodes which are no longer
+    // reachable from the top-level are counted as well, so this might reserve
+    // a bit more than what is linearized below.
+    size_t totalLength = 0;
+    for (SlicesTree::Range r = tree_.all(); !r.empty(); r.popFront()) {
+        for (const Slice& slice : r.front().value()) {
+            totalLength += slice.sliceLength;
+        }
+    }
+    if (!buffer.reserve(buffer.length() + totalLength)) {
+        ReportOutOfMemory(cx());
+        return fail(JS::TranscodeResult_Throw);
+    }
+
     // Visit the tree parts in a depth first order, to linearize the bits.
     Vector<SlicesNode::ConstRange> depthFirst(cx());
 
@@ -6390,6 +6390,7 @@ ValidateGlobalVariable(JSContext* cx, const AsmJSGlobal& global, HandleValue imp
             val->emplace(d);
             return true;
           }
+          case ValType::V128:
           case ValType::Ref:
           case ValType::AnyRef: {
             MOZ_CRASH("not available in asm.js");
@@ -7289,6 +7290,137 @@ LookupAsmJSModuleInCache(JSContext* cx, AsmJSParser& parser, bool* loadedFromCac
     return true;
 }
 
+/*****************************************************************************/
+// Runtime-wide module cache
+
+AsmJSModuleCache::~AsmJSModuleCache()
+{}
+
+void
+js::PurgeAsmJSModuleCache(JSRuntime* rt)
+{
+    // Release the modules after dropping the lock, as freeing their code takes
+    // other locks.
+    AsmJSModuleCache::EntryVector entries;
+    {
+        auto cache = rt->asmJSModuleCache.lock();
+        entries = std::move(cache->entries);
+    }
+}
+
+static bool
+MatchesRuntimeCacheEntry(AsmJSParser& parser, const AsmJSModuleCache::Entry& entry)
+{
+    const AsmJSMetadata& metadata = entry.module->metadata().asAsmJS();
+
+    // The module's metadata, including its source offsets and ScriptSource,
+    // is shared by every realm which reuses it.
+    FunctionBox* funbox = parser.pc->functionBox();
+    if (metadata.toStringStart != funbox->toStringStart ||
+        metadata.srcStart != funbox->functionNode->body()->pn_pos.begin ||
+        metadata.strict != (parser.pc->sc()->strict() &&
+                            !parser.pc->sc()->hasExplicitUseStrict()))
+    {
+        return false;
+    }
+
+    ScriptSource* source = metadata.scriptSource.get();
+    if (source->mutedErrors() != parser.ss->mutedErrors()) {
+        return false;
+    }
+    const char* filename = source->filename();
+    const char* parserFilename = parser.ss->filename();
+    if (filename != parserFilename &&
+        (!filename || !parserFilename || strcmp(filename, parserFilename)))
+    {
+        return false;
+    }
+
+    const char16_t* begin = parser.tokenStream.codeUnitPtrAt(ModuleChars::beginOffset(parser));
+    const char16_t* limit = parser.tokenStream.rawLimit();
+    if (uint32_t(limit - begin) < entry.length ||
+        mozilla::HashString(begin, entry.length) != entry.hash)
+    {
+        return false;
+    }
+
+    // A failure to allocate the decompressed chars is treated as a miss.
+    ModuleCharsForLookup moduleChars;
+    if (!moduleChars.deserialize(entry.moduleChars.begin())) {
+        return false;
+    }
+    return moduleChars.match(parser);
+}
+
+static bool
+LookupAsmJSModuleInRuntimeCache(JSContext* cx, AsmJSParser& parser, bool* loadedFromCache,
+                                SharedModule* module, UniqueChars* compilationTimeReport)
+{
+    int64_t before = PRMJ_Now();
+
+    *loadedFromCache = false;
+
+    {
+        auto cache = cx->runtime()->asmJSModuleCache.lock();
+        for (const AsmJSModuleCache::Entry& entry : cache->entries) {
+            if (MatchesRuntimeCacheEntry(parser, entry)) {
+                *module = entry.module;
+                break;
+            }
+        }
+    }
+
+    if (!*module) {
+        return true;
+    }
+
+    if (!parser.tokenStream.advance((*module)->metadata().asAsmJS().srcEndBeforeCurly())) {
+        return false;
+    }
+
+    int64_t after = PRMJ_Now();
+    int ms = (after - before) / PRMJ_USEC_PER_MSEC;
+    *compilationTimeReport = JS_smprintf("reused from another realm in %dms", ms);
+    if (!*compilationTimeReport) {
+        return false;
+    }
+
+    *loadedFromCache = true;
+    return true;
+}
+
+static void
+StoreAsmJSModuleInRuntimeCache(JSContext* cx, AsmJSParser& parser, const Module& module)
+{
+    // Caching is only an optimization, so failures are ignored.
+    ModuleCharsForStore moduleChars;
+    if (!moduleChars.init(parser)) {
+        return;
+    }
+
+    AsmJSModuleCache::Entry entry;
+    uint32_t begin = ModuleChars::beginOffset(parser);
+    entry.length = ModuleChars::endOffset(parser) - begin;
+    entry.hash = mozilla::HashString(parser.tokenStream.codeUnitPtrAt(begin), entry.length);
+    if (!entry.moduleChars.resize(moduleChars.serializedSize())) {
+        return;
+    }
+    moduleChars.serialize(entry.moduleChars.begin());
+    entry.module = &module;
+
+    // The evicted entry is released after dropping the lock, as freeing its
+    // module takes other locks.
+    AsmJSModuleCache::Entry evicted;
+    {
+        auto cache = cx->runtime()->asmJSModuleCache.lock();
+        if (cache->entries.length() == AsmJSModuleCache::MaxEntries) {
+            evicted = std::move(cache->entries[0]);
+            cache->entries.erase(cache->entries.begin());
+        }
+        Unused << cache->entries.append(std::move(entry));
+    }
+}
+
 /*****************************************************************************/
 // Top-level js::CompileAsmJS
 
@@ -7414,12 +7546,19 @@ js::CompileAsmJS(JSContext* cx, AsmJSParser& parser, ParseNode* stmtList, bool*
         return NoExceptionPending(cx);
     }
 
-    // Before spending any time parsing the module, try to look it up in the
+    // Before spending any time parsing the module, try to reuse a module
+    // compiled by another realm of this runtime, and then to look it up in the
     // embedding's cache using the chars about to be parsed as the key.
     bool loadedFromCache;
     SharedModule module;
     UniqueChars message;
-    if (!LookupAsmJSModuleInCache(cx, parser, &loadedFromCache, &module, &message)) {
+    if (!LookupAsmJSModuleInRuntimeCache(cx, parser, &loadedFromCache, &module, &message)) {
+        return false;
+    }
+    bool loadedFromRuntimeCache = loadedFromCache;
+    if (!loadedFromCache &&
+        !LookupAsmJSModuleInCache(cx, parser, &loadedFromCache, &module, &message))
+    {
         return false;
     }
 
@@ -7448,6 +7587,10 @@ js::CompileAsmJS(JSContext* cx, AsmJSParser& parser, ParseNode* stmtList, bool*
         }
     }
 
+    if (!loadedFromRuntimeCache) {
+        StoreAsmJSModuleInRuntimeCache(cx, parser, *module);
+    }
+
     // Hand over ownership to a GC object wrapper which can then be referenced
     // from the module function.
     Rooted<WasmModuleObject*> moduleObj(cx, WasmModuleObject::create(cx, *module));
@@ -21,6 +21,8 @@
 
 #include "NamespaceImports.h"
 
+#include "wasm/WasmTypes.h"
+
 namespace js {
 
 namespace frontend {
@@ -35,6 +37,38 @@ class FullParseHandler;
 
 using AsmJSParser = frontend::Parser<frontend::FullParseHandler, char16_t>;
 
+// Compiled asm.js modules, shared by all the realms of a runtime so that a
+// module which is loaded into several of them is only validated and compiled
+// once. An entry is reused only when the module's source chars, its offsets
+// in the source and its source's filename all match, since the module's
+// metadata is shared along with its code.
+class AsmJSModuleCache
+{
+  public:
+    struct Entry
+    {
+        HashNumber hash;
+        uint32_t length;
+        wasm::Bytes moduleChars;
+        RefPtr<const wasm::Module> module;
+    };
+    typedef Vector<Entry, 0, SystemAllocPolicy> EntryVector;
+
+    // Lookups are a linear search, so keep the cache small. The oldest entry
+    // is evicted first.
+    static const size_t MaxEntries = 16;
+
+    EntryVector entries;
+
+    AsmJSModuleCache() = default;
+    ~AsmJSModuleCache();
+};
+
+// Drop all the modules held by the runtime's cache. Called by shrinking GCs
+// and at runtime destruction.
+extern void
+PurgeAsmJSModuleCache(JSRuntime* rt);
+
 // This function takes over parsing of a function starting with "use asm". The
 // return value indicates whether an error was reported which the caller should
 // propagate. If no error was reported, the function may still fail to validate
@@ -108,6 +108,7 @@
 
 #include "wasm/WasmBaselineCompile.h"
 
+#include "mozilla/ArrayUtils.h"
 #include "mozilla/MathAlgorithms.h"
 #include "mozilla/Maybe.h"
 
@@ -3113,6 +3114,18 @@ class BaseCompiler final : public BaseCompilerInterface
         return true;
     }
 
+    MOZ_MUST_USE bool peek2xConstI32(int32_t* c0, int32_t* c1) {
+        MOZ_ASSERT(stk_.length() >= 2);
+        const Stk& v0 = stk_[stk_.length() - 1];
+        const Stk& v1 = stk_[stk_.length() - 2];
+        if (v0.kind() != Stk::ConstI32 || v1.kind() != Stk::ConstI32) {
+            return false;
+        }
+        *c0 = v0.i32val();
+        *c1 = v1.i32val();
+        return true;
+    }
+
     MOZ_MUST_USE bool peekConstI64(int64_t* c) {
         Stk& v = stk_.back();
         if (v.kind() != Stk::ConstI64) {
@@ -3452,6 +3465,7 @@ class BaseCompiler final : public BaseCompilerInterface
         GenerateFunctionPrologue(masm,
                                  env_.funcTypes[func_.index]->id,
                                  env_.mode() == CompileMode::Tier1 ? Some(func_.index) : Nothing(),
+                                 env_.funcCallCountGlobalDataOffset(func_.index),
                                  &offsets_);
 
         // Initialize DebugFrame fields before the stack overflow trap so that
@@ -3503,6 +3517,8 @@ class BaseCompiler final : public BaseCompilerInterface
 
         fr.zeroLocals(&ra);
 
+        addTierUpCheck(BytecodeOffset(func_.lineOrBytecode));
+
         if (env_.debugEnabled()) {
             insertBreakablePoint(CallSiteDesc::EnterFrame);
         }
@@ -3877,7 +3893,8 @@ class BaseCompiler final : public BaseCompilerInterface
         loadI32(indexVal, RegI32(WasmTableCallIndexReg));
 
         CallSiteDesc desc(call.lineOrBytecode, CallSiteDesc::Dynamic);
-        CalleeDesc callee = CalleeDesc::wasmTable(table, funcType.id);
+        CalleeDesc callee = CalleeDesc::wasmTable(table, funcType.id,
+                                                  env_.tableSigCheck(table, funcType));
         masm.wasmCallIndirect(desc, callee, NeedsBoundsCheck(true));
     }
 
@@ -3939,6 +3956,24 @@ class BaseCompiler final : public BaseCompilerInterface
         masm.wasmInterruptCheck(tmp, bytecodeOffset());
     }
 
+    // Count function entries and loop iterations so that the instance can
+    // request tier-2 compilation once the baseline code is hot.
+    void addTierUpCheck(BytecodeOffset trapOffset) {
+        if (env_.mode() != CompileMode::Tier1) {
+            return;
+        }
+
+        ScratchI32 tmp(*this);
+        masm.loadWasmTlsRegFromFrame(tmp);
+
+        Address counter(tmp, offsetof(TlsData, tierUpCounter));
+        Label ok;
+        masm.add32(Imm32(-1), counter);
+        masm.branch32(Assembler::GreaterThanOrEqual, counter, Imm32(0), &ok);
+        masm.wasmTrap(Trap::CheckTierUp, trapOffset);
+        masm.bind(&ok);
+    }
+
     void jumpTable(const LabelVector& labels, Label* theTable) {
         // Flush constant pools to ensure that the table is never interrupted by
         // constant pool entries.
@@ -6020,9 +6055,10 @@ class BaseCompiler final : public BaseCompilerInterface
     MOZ_MUST_USE RegI32 maybeLoadTlsForAccess(const AccessCheck& check);
     MOZ_MUST_USE RegI32 maybeLoadTlsForAccess(const AccessCheck& check, RegI32 specific);
     MOZ_MUST_USE bool emitLoad(ValType type, Scalar::Type viewType);
-    MOZ_MUST_USE bool loadCommon(MemoryAccessDesc* access, ValType type);
+    MOZ_MUST_USE bool loadCommon(MemoryAccessDesc* access, AccessCheck check, ValType type);
     MOZ_MUST_USE bool emitStore(ValType resultType, Scalar::Type viewType);
-    MOZ_MUST_USE bool storeCommon(MemoryAccessDesc* access, ValType resultType);
+    MOZ_MUST_USE bool storeCommon(MemoryAccessDesc* access, AccessCheck check,
+                                  ValType resultType);
     MOZ_MUST_USE bool emitSelect();
 
     template<bool isSetLocal> MOZ_MUST_USE bool emitSetOrTeeLocal(uint32_t slot);
@@ -6158,8 +6194,10 @@ class BaseCompiler final : public BaseCompilerInterface
     void emitAtomicXchg64(MemoryAccessDesc* access, ValType type, WantResult wantResult);
 #ifdef ENABLE_WASM_BULKMEM_OPS
     MOZ_MUST_USE bool emitMemOrTableCopy(bool isMem);
+    MOZ_MUST_USE bool emitMemCopyInline();
     MOZ_MUST_USE bool emitMemOrTableDrop(bool isMem);
     MOZ_MUST_USE bool emitMemFill();
+    MOZ_MUST_USE bool emitMemFillInline();
     MOZ_MUST_USE bool emitMemOrTableInit(bool isMem);
 #endif
     MOZ_MUST_USE bool emitStructNew();
@@ -7639,6 +7677,7 @@ BaseCompiler::emitLoop()
         masm.nopAlign(CodeAlignment);
         masm.bind(&controlItem(0).label);
         addInterruptCheck();
+        addTierUpCheck(bytecodeOffset());
     }
 
     return true;
@@ -8823,10 +8862,8 @@ BaseCompiler::maybeLoadTlsForAccess(const AccessCheck& check, RegI32 specific)
 }
 
 bool
-BaseCompiler::loadCommon(MemoryAccessDesc* access, ValType type)
+BaseCompiler::loadCommon(MemoryAccessDesc* access, AccessCheck check, ValType type)
 {
-    AccessCheck check;
-
     RegI32 tls, temp1, temp2, temp3;
     needLoadTemps(*access, &temp1, &temp2, &temp3);
 
@@ -8915,14 +8952,12 @@ BaseCompiler::emitLoad(ValType type, Scalar::Type viewType)
     }
 
     MemoryAccessDesc access(viewType, addr.align, addr.offset, bytecodeOffset());
-    return loadCommon(&access, type);
+    return loadCommon(&access, AccessCheck(), type);
 }
 
 bool
-BaseCompiler::storeCommon(MemoryAccessDesc* access, ValType resultType)
+BaseCompiler::storeCommon(MemoryAccessDesc* access, AccessCheck check, ValType resultType)
 {
-    AccessCheck check;
-
     RegI32 tls;
     RegI32 temp = needStoreTemp(*access, resultType);
 
@@ -8996,7 +9031,7 @@ BaseCompiler::emitStore(ValType resultType, Scalar::Type viewType)
     }
 
     MemoryAccessDesc access(viewType, addr.align, addr.offset, bytecodeOffset());
-    return storeCommon(&access, resultType);
+    return storeCommon(&access, AccessCheck(), resultType);
 }
 
 bool
@@ -9393,7 +9428,7 @@ BaseCompiler::emitAtomicLoad(ValType type, Scalar::Type viewType)
                             Synchronization::Load());
 
     if (Scalar::byteSize(viewType) <= sizeof(void*)) {
-        return loadCommon(&access, type);
+        return loadCommon(&access, AccessCheck(), type);
     }
 
     MOZ_ASSERT(type == ValType::I64 && Scalar::byteSize(viewType) == 8);
@@ -9511,7 +9546,7 @@ BaseCompiler::emitAtomicStore(ValType type, Scalar::Type viewType)
                             Synchronization::Store());
 
     if (Scalar::byteSize(viewType) <= sizeof(void*)) {
-        return storeCommon(&access, type);
+        return storeCommon(&access, AccessCheck(), type);
     }
 
     MOZ_ASSERT(type == ValType::I64 && Scalar::byteSize(viewType) == 8);
@@ -9653,6 +9688,38 @@ BaseCompiler::emitWake()
 }
 
 #ifdef ENABLE_WASM_BULKMEM_OPS
+// The accesses used by the inline expansions of memory.copy and memory.fill,
+// widest first.
+static const Scalar::Type InlineMemoryAccessTypes[] = {
+#ifdef JS_64BIT
+    Scalar::Int64,
+#endif
+    Scalar::Int32,
+    Scalar::Uint16,
+    Scalar::Uint8
+};
+
+static const size_t NumInlineMemoryAccessTypes = mozilla::ArrayLength(InlineMemoryAccessTypes);
+
+// Compute how many accesses of each of the InlineMemoryAccessTypes cover
+// |length| bytes when the widest accesses are used first.
+static void
+SplitInlineMemoryAccesses(uint32_t length, uint32_t counts[NumInlineMemoryAccessTypes])
+{
+    for (size_t i = 0; i < NumInlineMemoryAccessTypes; i++) {
+        uint32_t size = Scalar::byteSize(InlineMemoryAccessTypes[i]);
+        counts[i] = length / size;
+        length %= size;
+    }
+    MOZ_ASSERT(length == 0);
+}
+
+static ValType
+InlineMemoryAccessValType(Scalar::Type viewType)
+{
+    return viewType == Scalar::Int64 ? ValType::I64 : ValType::I32;
+}
+
 bool
 BaseCompiler::emitMemOrTableCopy(bool isMem)
 {
@@ -9667,6 +9734,14 @@ BaseCompiler::emitMemOrTableCopy(bool isMem)
         return true;
     }
 
+    // A zero length still has to check the offsets, leave it to the runtime.
+    int32_t signedLength;
+    if (isMem && peekConstI32(&signedLength) && signedLength != 0 &&
+        uint32_t(signedLength) <= MaxInlineMemoryCopyLength)
+    {
+        return emitMemCopyInline();
+    }
+
     SymbolicAddress callee = isMem ? SymbolicAddress::MemCopy
                                    : SymbolicAddress::TableCopy;
     emitInstanceCall(lineOrBytecode, SigPIII_, ExprType::Void, callee);
@@ -9679,6 +9754,81 @@ BaseCompiler::emitMemOrTableCopy(bool isMem)
     return true;
 }
 
+// Expand a memory.copy of a small constant, non-zero length into loads and
+// stores. All the loads are done before any store, so overlapping ranges
+// behave like memmove, and the stores go from the highest address down, so
+// that an out-of-bounds destination traps on the first store before anything
+// has been written. The offsets are all below the guard limit, so only the
+// first access of each range needs a bounds check.
+bool
+BaseCompiler::emitMemCopyInline()
+{
+    int32_t signedLength;
+    MOZ_ALWAYS_TRUE(popConstI32(&signedLength));
+    uint32_t length = uint32_t(signedLength);
+    MOZ_ASSERT(length != 0 && length <= MaxInlineMemoryCopyLength);
+
+    RegI32 src = popI32();
+    RegI32 dest = popI32();
+
+    uint32_t counts[NumInlineMemoryAccessTypes];
+    SplitInlineMemoryAccesses(length, counts);
+
+    // Load the source bytes onto the value stack, from low to high.
+    AccessCheck check;
+    uint32_t offset = 0;
+    for (size_t i = 0; i < NumInlineMemoryAccessTypes; i++) {
+        Scalar::Type viewType = InlineMemoryAccessTypes[i];
+        for (uint32_t n = 0; n < counts[i]; n++) {
+            RegI32 temp = needI32();
+            moveI32(src, temp);
+            pushI32(temp);
+
+            MemoryAccessDesc access(viewType, 1, offset, bytecodeOffset());
+            if (!loadCommon(&access, check, InlineMemoryAccessValType(viewType))) {
+                return false;
+            }
+            check.omitBoundsCheck = true;
+            offset += Scalar::byteSize(viewType);
+        }
+    }
+
+    // Store them from the value stack to the destination, from high to low.
+    check = AccessCheck();
+    for (size_t i = NumInlineMemoryAccessTypes; i > 0; i--) {
+        Scalar::Type viewType = InlineMemoryAccessTypes[i - 1];
+        ValType type = InlineMemoryAccessValType(viewType);
+        for (uint32_t n = 0; n < counts[i - 1]; n++) {
+            offset -= Scalar::byteSize(viewType);
+
+            if (type == ValType::I64) {
+                RegI64 value = popI64();
+                RegI32 temp = needI32();
+                moveI32(dest, temp);
+                pushI32(temp);
+                pushI64(value);
+            } else {
+                RegI32 value = popI32();
+                RegI32 temp = needI32();
+                moveI32(dest, temp);
+                pushI32(temp);
+                pushI32(value);
+            }
+
+            MemoryAccessDesc access(viewType, 1, offset, bytecodeOffset());
+            if (!storeCommon(&access, check, type)) {
+                return false;
+            }
+            check.omitBoundsCheck = true;
+        }
+    }
+    MOZ_ASSERT(offset == 0);
+
+    freeI32(dest);
+    freeI32(src);
+    return true;
+}
+
 bool
 BaseCompiler::emitMemOrTableDrop(bool isMem)
 {
@@ -9721,6 +9871,14 @@ BaseCompiler::emitMemFill()
         return true;
     }
 
+    int32_t signedLength;
+    int32_t signedValue;
+    if (peek2xConstI32(&signedLength, &signedValue) && signedLength != 0 &&
+        uint32_t(signedLength) <= MaxInlineMemoryFillLength)
+    {
+        return emitMemFillInline();
+    }
+
     emitInstanceCall(lineOrBytecode, SigPIII_, ExprType::Void, SymbolicAddress::MemFill);
 
     Label ok;
@@ -9731,6 +9889,64 @@ BaseCompiler::emitMemFill()
     return true;
 }
 
+// Like emitMemCopyInline, for a memory.fill with a constant value.
+bool
+BaseCompiler::emitMemFillInline()
+{
+    int32_t signedLength;
+    int32_t signedValue;
+    MOZ_ALWAYS_TRUE(popConstI32(&signedLength));
+    MOZ_ALWAYS_TRUE(popConstI32(&signedValue));
+    uint32_t length = uint32_t(signedLength);
+    uint8_t value = uint8_t(signedValue);
+    MOZ_ASSERT(length != 0 && length <= MaxInlineMemoryFillLength);
+
+    RegI32 dest = popI32();
+
+    uint32_t counts[NumInlineMemoryAccessTypes];
+    SplitInlineMemoryAccesses(length, counts);
+
+    AccessCheck check;
+    uint32_t offset = length;
+    for (size_t i = NumInlineMemoryAccessTypes; i > 0; i--) {
+        Scalar::Type viewType = InlineMemoryAccessTypes[i - 1];
+        ValType type = InlineMemoryAccessValType(viewType);
+        for (uint32_t n = 0; n < counts[i - 1]; n++) {
+            offset -= Scalar::byteSize(viewType);
+
+            RegI32 temp = needI32();
+            moveI32(dest, temp);
+            pushI32(temp);
+            switch (viewType) {
+              case Scalar::Int64:
+                pushI64(int64_t(value * UINT64_C(0x0101010101010101)));
+                break;
+              case Scalar::Int32:
+                pushI32(int32_t(value * 0x01010101U));
+                break;
+              case Scalar::Uint16:
+                pushI32(int32_t(value * 0x0101));
+                break;
+              case Scalar::Uint8:
+                pushI32(int32_t(value));
+                break;
+              default:
+                MOZ_CRASH("unexpected inline memory access");
+            }
+
+            MemoryAccessDesc access(viewType, 1, offset, bytecodeOffset());
+            if (!storeCommon(&access, check, type)) {
+                return false;
+            }
+            check.omitBoundsCheck = true;
+        }
+    }
+    MOZ_ASSERT(offset == 0);
+
+    freeI32(dest);
+    return true;
+}
+
 bool
 BaseCompiler::emitMemOrTableInit(bool isMem)
 {
@@ -11140,7 +11356,8 @@ js::wasm::BaselineCompileFunctions(const ModuleEnvironment& env, LifoAlloc& lifo
         if (!locals.appendAll(env.funcTypes[func.index]->args())) {
             return false;
         }
-        if (!DecodeLocalEntries(d, env.kind, env.types, env.gcTypesEnabled(), &locals)) {
+        if (!DecodeLocalEntries(d, env.kind, env.types, env.gcTypesEnabled(),
+                                env.simdEnabled(), &locals)) {
             return false;
         }
 
@@ -19,6 +19,7 @@
 #include "wasm/WasmBuiltins.h"
 
 #include "mozilla/Atomics.h"
+#include "mozilla/MathAlgorithms.h"
 
 #include "fdlibm.h"
 #include "jslibmath.h"
@@ -241,6 +242,17 @@ CheckInterrupt(JSContext* cx, JitActivation* activation)
     return resumePC;
 }
 
+// Has the same return-value convention as HandleTrap().
+static void*
+CheckTierUp(JitActivation* activation)
+{
+    activation->wasmExitFP()->tls->instance->checkTierUp();
+
+    void* resumePC = activation->wasmTrapData().resumePC;
+    activation->finishWasmTrap();
+    return resumePC;
+}
+
 // The calling convention between this function and its caller in the stub
 // generated by GenerateTrapExit() is:
 //   - return nullptr if the stub should jump to the throw stub to unwind
@@ -274,6 +286,8 @@ WasmHandleTrap()
         return ReportError(cx, JSMSG_WASM_UNALIGNED_ACCESS);
       case Trap::CheckInterrupt:
         return CheckInterrupt(cx, activation);
+      case Trap::CheckTierUp:
+        return CheckTierUp(activation);
       case Trap::StackOverflow:
         // TlsData::setInterrupt() causes a fake stack overflow. Since
         // TlsData::setInterrupt() is called racily, it's possible for a real
@@ -799,7 +813,19 @@ wasm::NeedsBuiltinThunk(SymbolicAddress sym)
 // Each JS builtin can have several overloads. These must all be enumerated in
 // PopulateTypedNatives() so they can be included in the process-wide thunk set.
 
+// Math.abs has no double-typed C++ implementation of its own.
+static double
+math_abs_impl(double x)
+{
+    return mozilla::Abs(x);
+}
+
 #define FOR_EACH_UNARY_NATIVE(_)   \
+    _(math_abs, MathAbs)           \
+    _(math_sqrt, MathSqrt)         \
+    _(math_floor, MathFloor)       \
+    _(math_ceil, MathCeil)         \
+    _(math_round, MathRound)       \
     _(math_sin, MathSin)           \
     _(math_tan, MathTan)           \
     _(math_cos, MathCos)           \
@@ -826,6 +852,8 @@ wasm::NeedsBuiltinThunk(SymbolicAddress sym)
     _(ecmaAtan2, MathATan2)        \
     _(ecmaHypot, MathHypot)        \
     _(ecmaPow, MathPow)            \
+    _(math_max_impl, MathMax)      \
+    _(math_min_impl, MathMin)      \
 
 #define DEFINE_UNARY_FLOAT_WRAPPER(func, _)        \
     static float func##_impl_f32(float x) {    \
@@ -21,10 +21,12 @@
 #include "mozilla/BinarySearch.h"
 #include "mozilla/EnumeratedRange.h"
 
+#include "gc/Memory.h"
 #include "jit/ExecutableAllocator.h"
 #ifdef JS_ION_PERF
 # include "jit/PerfSpewer.h"
 #endif
+#include "jit/ProcessExecutableMemory.h"
 #include "vtune/VTuneWrapper.h"
 #include "wasm/WasmModule.h"
 #include "wasm/WasmProcess.h"
@@ -425,10 +427,20 @@ ModuleSegment::initialize(const CodeTier& codeTier,
     return CodeSegment::initialize(codeTier);
 }
 
+// The machine code is preceded by enough padding to make it page aligned when
+// the serialization starts at a page aligned address, and followed by the rest
+// of the padding so that the serialized size does not depend on the address.
+
+static size_t
+SerializedCodePadding()
+{
+    return gc::SystemPageSize() - 1;
+}
+
 size_t
 ModuleSegment::serializedSize() const
 {
-    return sizeof(uint32_t) + length();
+    return 3 * sizeof(uint32_t) + SerializedCodePadding() + length();
 }
 
 void
@@ -443,32 +455,52 @@ ModuleSegment::serialize(uint8_t* cursor, const LinkData& linkData) const
 {
     MOZ_ASSERT(tier() == Tier::Serialized);
 
+    uint8_t* codeBegin = cursor + 3 * sizeof(uint32_t);
+    uint32_t leading = ComputeByteAlignment(uintptr_t(codeBegin), gc::SystemPageSize());
+    uint32_t trailing = SerializedCodePadding() - leading;
+
     cursor = WriteScalar<uint32_t>(cursor, length());
+    cursor = WriteScalar<uint32_t>(cursor, leading);
+    cursor = WriteScalar<uint32_t>(cursor, trailing);
+    memset(cursor, 0, leading);
+    cursor += leading;
     uint8_t* serializedBase = cursor;
     cursor = WriteBytes(cursor, base(), length());
     StaticallyUnlink(serializedBase, linkData);
+    memset(cursor, 0, trailing);
+    cursor += trailing;
     return cursor;
 }
 
 /* static */ const uint8_t*
 ModuleSegment::deserialize(const uint8_t* cursor, const LinkData& linkData,
-                           UniqueModuleSegment* segment)
+                           const SerializedFile* file, UniqueModuleSegment* segment)
 {
-    uint32_t length;
+    uint32_t length, leading, trailing;
     cursor = ReadScalar<uint32_t>(cursor, &length);
-    if (!cursor) {
-        return nullptr;
-    }
+    cursor = ReadScalar<uint32_t>(cursor, &leading);
+    cursor = ReadScalar<uint32_t>(cursor, &trailing);
+    cursor += leading;
 
     UniqueCodeBytes bytes = AllocateCodeBytes(length);
     if (!bytes) {
         return nullptr;
     }
 
-    cursor = ReadBytes(cursor, bytes.get(), length);
-    if (!cursor) {
-        return nullptr;
+    // Map the code from the file when it is page aligned there, so that the
+    // kernel only copies the pages that relinking touches and the unmodified
+    // pages stay shared with the page cache and other processes.
+    size_t pageSize = gc::SystemPageSize();
+    bool mapped = file &&
+                  (size_t(cursor - file->begin) % pageSize) == 0 &&
+                  jit::MapFileIntoExecutableMemory(bytes.get(), JS_ROUNDUP(length, pageSize),
+                                                   file->fd, size_t(cursor - file->begin));
+    if (mapped) {
+        cursor += length;
+    } else {
+        cursor = ReadBytes(cursor, bytes.get(), length);
     }
+    cursor += trailing;
 
     *segment = js::MakeUnique<ModuleSegment>(Tier::Serialized, std::move(bytes), length, linkData);
     if (!*segment) {
@@ -1136,7 +1168,7 @@ CodeTier::serialize(uint8_t* cursor, const LinkData& linkData) const
 
 /* static */ const uint8_t*
 CodeTier::deserialize(const uint8_t* cursor, const LinkData& linkData,
-                      UniqueCodeTier* codeTier)
+                      const SerializedFile* file, UniqueCodeTier* codeTier)
 {
     auto metadata = js::MakeUnique<MetadataTier>(Tier::Serialized);
     if (!metadata) {
@@ -1148,7 +1180,7 @@ CodeTier::deserialize(const uint8_t* cursor, const LinkData& linkData,
     }
 
     UniqueModuleSegment segment;
-    cursor = ModuleSegment::deserialize(cursor, linkData, &segment);
+    cursor = ModuleSegment::deserialize(cursor, linkData, file, &segment);
     if (!cursor) {
         return nullptr;
     }
@@ -1555,6 +1587,7 @@ Code::serialize(uint8_t* cursor, const LinkData& linkData) const
 Code::deserialize(const uint8_t* cursor,
                   const LinkData& linkData,
                   Metadata& metadata,
+                  const SerializedFile* file,
                   SharedCode* out)
 {
     cursor = metadata.deserialize(cursor);
@@ -1563,7 +1596,7 @@ Code::deserialize(const uint8_t* cursor,
     }
 
     UniqueCodeTier codeTier;
-    cursor = CodeTier::deserialize(cursor, linkData, &codeTier);
+    cursor = CodeTier::deserialize(cursor, linkData, file, &codeTier);
     if (!cursor) {
         return nullptr;
     }
@@ -88,6 +88,19 @@ struct FreeCode {
 
 using UniqueCodeBytes = UniquePtr<uint8_t, FreeCode>;
 
+// A file being deserialized, mapped read-only at |begin|. The machine code of
+// a serialized ModuleSegment is stored page aligned relative to the start of
+// the serialization, so when the file holds nothing else the code can be
+// mapped into executable memory from the file instead of being copied.
+
+struct SerializedFile
+{
+    int fd;
+    const uint8_t* begin;
+
+    SerializedFile(int fd, const uint8_t* begin) : fd(fd), begin(begin) {}
+};
+
 class Code;
 class CodeTier;
 class ModuleSegment;
@@ -193,6 +206,7 @@ class ModuleSegment : public CodeSegment
     size_t serializedSize() const;
     uint8_t* serialize(uint8_t* cursor, const LinkData& linkData) const;
     static const uint8_t* deserialize(const uint8_t* cursor, const LinkData& linkData,
+                                      const SerializedFile* file,
                                       UniqueModuleSegment* segment);
 
     const CodeRange* lookupRange(const void* pc) const;
@@ -348,6 +362,7 @@ struct MetadataCacheablePod
     Maybe<uint32_t>       maxMemoryLength;
     Maybe<uint32_t>       startFuncIndex;
     Maybe<uint32_t>       nameCustomSectionIndex;
+    Maybe<uint32_t>       funcCallCountsGlobalDataOffset;
     bool                  filenameIsURL;
 
     explicit MetadataCacheablePod(ModuleKind kind)
@@ -614,6 +629,7 @@ class CodeTier
     size_t serializedSize() const;
     uint8_t* serialize(uint8_t* cursor, const LinkData& linkData) const;
     static const uint8_t* deserialize(const uint8_t* cursor, const LinkData& linkData,
+                                      const SerializedFile* file,
                                       UniqueCodeTier* codeTier);
     void addSizeOfMisc(MallocSizeOf mallocSizeOf, size_t* code, size_t* data) const;
 };
@@ -748,13 +764,16 @@ class Code : public ShareableBase<Code>
 
     // A Code object is serialized as the length and bytes of the machine code
     // after statically unlinking it; the Code is then later recreated from the
-    // machine code and other parts.
+    // machine code and other parts. The machine code is position independent
+    // once unlinked: relinking only patches the internal and symbolic links
+    // recorded in the LinkData.
 
     size_t serializedSize() const;
     uint8_t* serialize(uint8_t* cursor, const LinkData& linkData) const;
     static const uint8_t* deserialize(const uint8_t* cursor,
                                       const LinkData& linkData,
                                       Metadata& metadata,
+                                      const SerializedFile* file,
                                       SharedCode* code);
 };
 
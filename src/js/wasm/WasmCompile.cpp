@@ -90,6 +90,12 @@ CompileArgs::CompileArgs(JSContext* cx, ScriptedCaller&& scriptedCaller)
 #endif
     sharedMemoryEnabled = cx->realm()->creationOptions().getSharedMemoryAndAtomicsEnabled();
     gcTypesConfigured = gcEnabled ? HasGcTypes::True : HasGcTypes::False;
+#ifdef ENABLE_WASM_SIMD
+    simdEnabled = cx->options().wasmSimd();
+#else
+    simdEnabled = false;
+#endif
+    functionCountsEnabled = cx->options().wasmFunctionCounts();
     testTiering = cx->options().testWasmAwaitTier2() || JitOptions.wasmDelayTier2;
 
     // Debug information such as source view or debug traps will require
@@ -398,7 +404,8 @@ CompilerEnvironment::CompilerEnvironment(CompileMode mode,
     tier_(tier),
     optimizedBackend_(optimizedBackend),
     debug_(debugEnabled),
-    gcTypes_(gcTypesConfigured)
+    gcTypes_(gcTypesConfigured),
+    simd_(false)
 {
 }
 
@@ -430,6 +437,12 @@ CompilerEnvironment::computeParameters(Decoder& d, HasGcTypes gcFeatureOptIn)
     bool argTestTiering = args_->testTiering && !gcEnabled;
     bool argDebugEnabled = args_->debugEnabled;
 
+    // SIMD is only implemented by Ion on SSE4.1 hardware, so a module which
+    // may use it is compiled once, with Ion only. It is not available with
+    // the gc types, which need baseline, when debugging, nor with Cranelift.
+    bool simdEnabled = args_->simdEnabled && !gcEnabled && !argDebugEnabled &&
+                       !args_->forceCranelift && IonCanCompileSimd();
+
     uint32_t codeSectionSize = 0;
 
     SectionRange range;
@@ -448,8 +461,11 @@ CompilerEnvironment::computeParameters(Decoder& d, HasGcTypes gcFeatureOptIn)
     // HasCompilerSupport() should prevent failure here
     MOZ_RELEASE_ASSERT(baselineEnabled || ionEnabled);
 
-    if (baselineEnabled && ionEnabled && !debugEnabled && CanUseExtraThreads() &&
-        (TieringBeneficial(codeSectionSize) || argTestTiering))
+    if (simdEnabled) {
+        mode_ = CompileMode::Once;
+        tier_ = Tier::Optimized;
+    } else if (baselineEnabled && ionEnabled && !debugEnabled && CanUseExtraThreads() &&
+               (TieringBeneficial(codeSectionSize) || argTestTiering))
     {
         mode_ = CompileMode::Tier1;
         tier_ = Tier::Baseline;
@@ -467,6 +483,7 @@ CompilerEnvironment::computeParameters(Decoder& d, HasGcTypes gcFeatureOptIn)
 
     debug_ = debugEnabled ? DebugEnabled::True : DebugEnabled::False;
     gcTypes_ = gcEnabled ? HasGcTypes::True : HasGcTypes::False;
+    simd_ = simdEnabled;
     state_ = Computed;
 }
 
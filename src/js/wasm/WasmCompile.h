@@ -54,6 +54,8 @@ struct CompileArgs : ShareableBase<CompileArgs>
     bool ionEnabled;
     bool sharedMemoryEnabled;
     HasGcTypes gcTypesConfigured;
+    bool simdEnabled;
+    bool functionCountsEnabled;
     bool testTiering;
 
     explicit CompileArgs(ScriptedCaller&& scriptedCaller)
@@ -64,6 +66,8 @@ struct CompileArgs : ShareableBase<CompileArgs>
         ionEnabled(false),
         sharedMemoryEnabled(false),
         gcTypesConfigured(HasGcTypes::False),
+        simdEnabled(false),
+        functionCountsEnabled(false),
         testTiering(false)
     {}
 
@@ -48,6 +48,7 @@ enum class TypeCode
     I64                                  = 0x7e,  // SLEB128(-0x02)
     F32                                  = 0x7d,  // SLEB128(-0x03)
     F64                                  = 0x7c,  // SLEB128(-0x04)
+    V128                                 = 0x7b,  // SLEB128(-0x05)
 
     // A function pointer with any signature
     AnyFunc                              = 0x70,  // SLEB128(-0x10)
@@ -113,6 +114,10 @@ enum class Trap
     // CheckForInterrupt(). This trap is resumable.
     CheckInterrupt,
 
+    // Baseline code in a module compiled for tiering has become hot and the
+    // engine must start tier-2 compilation. This trap is resumable.
+    CheckTierUp,
+
     // Signal an error that was reported in C++ code.
     ThrowReported,
 
@@ -365,6 +370,7 @@ enum class Op
 
     FirstPrefix                          = 0xfc,
     MiscPrefix                           = 0xfc,
+    SimdPrefix                           = 0xfd,
     ThreadPrefix                         = 0xfe,
     MozPrefix                            = 0xff,
 
@@ -409,6 +415,82 @@ enum class MiscOp
     Limit
 };
 
+// Opcodes from the fixed-width SIMD proposal.  They are prefixed by
+// SimdPrefix and, unlike the other prefixed opcodes, encoded as a varU32.
+// Only the operations which have a direct SSE4.1 lowering are listed.
+enum class SimdOp
+{
+    // Memory and constants
+    V128Load                             = 0x00,
+    V128Store                            = 0x0b,
+    V128Const                            = 0x0c,
+
+    // Lane rearrangement
+    I8x16Shuffle                         = 0x0d,
+    I8x16Swizzle                         = 0x0e,
+
+    // Splats and lane accesses
+    I8x16Splat                           = 0x0f,
+    I16x8Splat                           = 0x10,
+    I32x4Splat                           = 0x11,
+    F32x4Splat                           = 0x13,
+    I8x16ExtractLaneS                    = 0x15,
+    I8x16ExtractLaneU                    = 0x16,
+    I8x16ReplaceLane                     = 0x17,
+    I16x8ExtractLaneS                    = 0x18,
+    I16x8ExtractLaneU                    = 0x19,
+    I16x8ReplaceLane                     = 0x1a,
+    I32x4ExtractLane                     = 0x1b,
+    I32x4ReplaceLane                     = 0x1c,
+    F32x4ExtractLane                     = 0x1f,
+    F32x4ReplaceLane                     = 0x20,
+
+    // Comparisons
+    I8x16Eq                              = 0x23,
+    I16x8Eq                              = 0x2d,
+    I32x4Eq                              = 0x37,
+    F32x4Eq                              = 0x41,
+
+    // Bitwise operations
+    V128Not                              = 0x4d,
+    V128And                              = 0x4e,
+    V128AndNot                           = 0x4f,
+    V128Or                               = 0x50,
+    V128Xor                              = 0x51,
+
+    // Integer arithmetic
+    I8x16Neg                             = 0x61,
+    I8x16Add                             = 0x6e,
+    I8x16AddSatS                         = 0x6f,
+    I8x16AddSatU                         = 0x70,
+    I8x16Sub                             = 0x71,
+    I8x16SubSatS                         = 0x72,
+    I8x16SubSatU                         = 0x73,
+    I16x8Neg                             = 0x81,
+    I16x8Add                             = 0x8e,
+    I16x8AddSatS                         = 0x8f,
+    I16x8AddSatU                         = 0x90,
+    I16x8Sub                             = 0x91,
+    I16x8SubSatS                         = 0x92,
+    I16x8SubSatU                         = 0x93,
+    I16x8Mul                             = 0x95,
+    I32x4Neg                             = 0xa1,
+    I32x4Add                             = 0xae,
+    I32x4Sub                             = 0xb1,
+    I32x4Mul                             = 0xb5,
+
+    // Floating point arithmetic
+    F32x4Abs                             = 0xe0,
+    F32x4Neg                             = 0xe1,
+    F32x4Sqrt                            = 0xe3,
+    F32x4Add                             = 0xe4,
+    F32x4Sub                             = 0xe5,
+    F32x4Mul                             = 0xe6,
+    F32x4Div                             = 0xe7,
+
+    Limit                                = 0x100
+};
+
 // Opcodes from threads proposal as of June 30, 2017
 enum class ThreadOp
 {
@@ -603,6 +685,18 @@ static const unsigned MaxBrTableElems        =  1000000;
 static const unsigned MaxMemoryInitialPages  =    16384;
 static const unsigned MaxCodeSectionBytes    = MaxModuleBytes;
 
+// memory.copy and memory.fill with a constant length of at most these many
+// bytes are expanded into inline loads and stores instead of calling into the
+// runtime.
+
+#ifdef JS_64BIT
+static const unsigned MaxInlineMemoryCopyLength = 64;
+static const unsigned MaxInlineMemoryFillLength = 64;
+#else
+static const unsigned MaxInlineMemoryCopyLength = 32;
+static const unsigned MaxInlineMemoryFillLength = 32;
+#endif
+
 // A magic value of the FramePointer to indicate after a return to the entry
 // stub that an exception has been caught and that we should throw.
 
@@ -54,7 +54,8 @@ GenerateCraneliftCode(WasmMacroAssembler& masm, const CraneliftCompiledFunc& fun
                       const FuncTypeIdDesc& funcTypeId, uint32_t lineOrBytecode,
                       FuncOffsets* offsets)
 {
-    wasm::GenerateFunctionPrologue(masm, funcTypeId, mozilla::Nothing(), offsets);
+    wasm::GenerateFunctionPrologue(masm, funcTypeId, mozilla::Nothing(), mozilla::Nothing(),
+                                   offsets);
 
     // Omit the check when framePushed is small and we know there's no
     // recursion.
@@ -572,7 +572,9 @@ GenerateCallableEpilogue(MacroAssembler& masm, unsigned framePushed, ExitReason
 
 void
 wasm::GenerateFunctionPrologue(MacroAssembler& masm, const FuncTypeIdDesc& funcTypeId,
-                               const Maybe<uint32_t>& tier1FuncIndex, FuncOffsets* offsets)
+                               const Maybe<uint32_t>& tier1FuncIndex,
+                               const Maybe<uint32_t>& callCountGlobalDataOffset,
+                               FuncOffsets* offsets)
 {
     // Flush pending pools so they do not get dumped between the 'begin' and
     // 'normalEntry' offsets since the difference must be less than UINT8_MAX
@@ -615,6 +617,14 @@ wasm::GenerateFunctionPrologue(MacroAssembler& masm, const FuncTypeIdDesc& funcT
     masm.bind(&normalEntry);
     GenerateCallablePrologue(masm, &offsets->normalEntry);
 
+    // Count the call. Tier-1 code counts the calls it forwards to Tier-2 code
+    // and Tier-2 code is entered after its own count, so every call is counted
+    // exactly once.
+    if (callCountGlobalDataOffset) {
+        masm.add32(Imm32(1), Address(WasmTlsReg, offsetof(TlsData, globalArea) +
+                                                 *callCountGlobalDataOffset));
+    }
+
     // Tiering works as follows.  The Code owns a jumpTable, which has one
     // pointer-sized element for each function up to the largest funcIndex in
     // the module.  Each table element is an address into the Tier-1 or the
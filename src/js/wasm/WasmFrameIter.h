@@ -226,6 +226,7 @@ GenerateJitEntryPrologue(jit::MacroAssembler& masm, Offsets* offsets);
 void
 GenerateFunctionPrologue(jit::MacroAssembler& masm, const FuncTypeIdDesc& funcTypeId,
                          const mozilla::Maybe<uint32_t>& tier1FuncIndex,
+                         const mozilla::Maybe<uint32_t>& callCountGlobalDataOffset,
                          FuncOffsets* offsets);
 void
 GenerateFunctionEpilogue(jit::MacroAssembler& masm, unsigned framePushed, FuncOffsets* offsets);
@@ -90,6 +90,9 @@ ModuleGenerator::ModuleGenerator(const CompileArgs& args, ModuleEnvironment* env
     finishedFuncDefs_(false)
 {
     MOZ_ASSERT(IsCompilingWasm());
+
+    // The generator's masm holds the code of the whole module.
+    lifo_.setUseHugePages();
 }
 
 ModuleGenerator::~ModuleGenerator()
@@ -300,6 +303,19 @@ ModuleGenerator::init(Metadata* maybeAsmJSMetadata)
         global.setOffset(globalDataOffset);
     }
 
+    // Each function defined by the module counts its calls in an instance's
+    // global data when the calls are being counted.
+    if (compileArgs_->functionCountsEnabled && !isAsmJS() && env_->numFuncDefs()) {
+        uint32_t globalDataOffset;
+        if (!allocateGlobalBytes(env_->numFuncDefs() * sizeof(uint32_t), sizeof(uint32_t),
+                                 &globalDataOffset))
+        {
+            return false;
+        }
+
+        env_->funcCallCountsGlobalDataOffset = Some(globalDataOffset);
+    }
+
     // Accumulate all exported functions, whether by explicit export or
     // implicitly by being an element of an external (imported or exported)
     // table or by being the start function. The FuncExportVector stored in
@@ -820,9 +836,25 @@ ModuleGenerator::compileFuncDef(uint32_t funcIndex, uint32_t lineOrBytecode,
 
     uint32_t threshold;
     switch (tier()) {
-      case Tier::Baseline:  threshold = JitOptions.wasmBatchBaselineThreshold; break;
-      case Tier::Optimized: threshold = JitOptions.wasmBatchIonThreshold;      break;
-      default:              MOZ_CRASH("Invalid tier value");                   break;
+      case Tier::Baseline:
+        threshold = JitOptions.wasmBatchBaselineThreshold;
+        break;
+      case Tier::Optimized:
+        threshold = env_->optimizedBackend() == OptimizedBackend::Cranelift
+                    ? JitOptions.wasmBatchCraneliftThreshold
+                    : JitOptions.wasmBatchIonThreshold;
+        break;
+      default:
+        MOZ_CRASH("Invalid tier value");
+        break;
+    }
+
+    // Don't let helper threads sit idle while a full batch accumulates. When
+    // fewer tasks are in flight than there are threads to run them, as at the
+    // start of compilation or when streaming compilation waits for bytecode,
+    // launch smaller batches.
+    if (parallel_ && outstanding_ < tasks_.length() / 2) {
+        threshold /= 4;
     }
 
     batchedBytecode_ += funcBytecodeLength;
@@ -995,6 +1027,7 @@ ModuleGenerator::finishMetadata(const Bytes& bytecode)
     metadata_->tables = std::move(env_->tables);
     metadata_->globals = std::move(env_->globals);
     metadata_->nameCustomSectionIndex = env_->nameCustomSectionIndex;
+    metadata_->funcCallCountsGlobalDataOffset = env_->funcCallCountsGlobalDataOffset;
     metadata_->moduleName = env_->moduleName;
     metadata_->funcNames = std::move(env_->funcNames);
 
@@ -1143,7 +1176,13 @@ ModuleGenerator::finishModule(const ShareableBytes& bytecode,
     }
 
     if (mode() == CompileMode::Tier1) {
-        module->startTier2(*compileArgs_, bytecode, maybeTier2Listener);
+        // Tests that wait for tier-2 need it to start without the code
+        // having to become hot first.
+        if (JitOptions.wasmTier2Threshold && !compileArgs_->testTiering) {
+            module->deferTier2(*compileArgs_, bytecode, maybeTier2Listener);
+        } else {
+            module->startTier2(*compileArgs_, bytecode, maybeTier2Listener);
+        }
     } else if (tier() == Tier::Serialized && maybeTier2Listener) {
         module->serialize(*linkData_, *maybeTier2Listener);
     }
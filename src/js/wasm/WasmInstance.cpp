@@ -22,6 +22,7 @@
 #include "jit/BaselineJIT.h"
 #include "jit/InlinableNatives.h"
 #include "jit/JitCommon.h"
+#include "jit/JitOptions.h"
 #include "jit/JitRealm.h"
 #include "util/StringBuffer.h"
 #include "util/Text.h"
@@ -139,6 +140,7 @@ Instance::callImport(JSContext* cx, uint32_t funcImportIndex, unsigned argc, con
             break;
           }
           case ValType::I64:
+          case ValType::V128:
             MOZ_CRASH("unhandled type in callImport");
         }
     }
@@ -210,6 +212,7 @@ Instance::callImport(JSContext* cx, uint32_t funcImportIndex, unsigned argc, con
           case ValType::Ref:    MOZ_CRASH("case guarded above");
           case ValType::AnyRef: MOZ_CRASH("case guarded above");
           case ValType::I64:    MOZ_CRASH("NYI");
+          case ValType::V128:   MOZ_CRASH("NYI");
         }
         if (!TypeScript::ArgTypes(script, i)->hasType(type)) {
             return true;
@@ -604,6 +607,7 @@ void
 Instance::initElems(const ElemSegment& seg, uint32_t dstOffset, uint32_t srcOffset, uint32_t len)
 {
     Table& table = *tables_[seg.tableIndex];
+    bool uniform = metadata().tables[seg.tableIndex].isUniform();
     MOZ_ASSERT(dstOffset <= table.length());
     MOZ_ASSERT(len <= table.length() - dstOffset);
 
@@ -639,7 +643,11 @@ Instance::initElems(const ElemSegment& seg, uint32_t dstOffset, uint32_t srcOffs
                 continue;
             }
         }
-        void* code = codeBaseTier + codeRanges[funcToCodeRange[funcIndex]].funcTableEntry();
+        // The signatures of calls through a uniform table are checked at the
+        // call site, so its elements skip the callees' checks.
+        const CodeRange& codeRange = codeRanges[funcToCodeRange[funcIndex]];
+        void* code = codeBaseTier + (uniform ? codeRange.funcNormalEntry()
+                                             : codeRange.funcTableEntry());
         table.set(dstOffset + i, code, this);
     }
 }
@@ -812,6 +820,7 @@ Instance::Instance(JSContext* cx,
     tlsData()->cx = cx;
     tlsData()->resetInterrupt(cx);
     tlsData()->jumpTable = code_->tieringJumpTable();
+    tlsData()->tierUpCounter = INT32_MAX;
     tlsData()->addressOfNeedsIncrementalBarrier =
         (uint8_t*)cx->compartment()->zone()->addressOfNeedsIncrementalBarrier();
 
@@ -1128,6 +1137,8 @@ Instance::callExport(JSContext* cx, uint32_t funcIndex, CallArgs args)
             break;
           case ValType::I64:
             MOZ_CRASH("unexpected i64 flowing into callExport");
+          case ValType::V128:
+            MOZ_CRASH("unexpected v128 flowing into callExport");
           case ValType::F32:
             if (!RoundFloat32(cx, v, (float*)&exportArgs[i])) {
                 return false;
@@ -1191,6 +1202,8 @@ Instance::callExport(JSContext* cx, uint32_t funcIndex, CallArgs args)
         break;
       case ExprType::I64:
         MOZ_CRASH("unexpected i64 flowing from callExport");
+      case ExprType::V128:
+        MOZ_CRASH("unexpected v128 flowing from callExport");
       case ExprType::F32:
         args.rval().set(NumberValue(*(float*)retAddr));
         break;
@@ -1215,6 +1228,27 @@ Instance::callExport(JSContext* cx, uint32_t funcIndex, CallArgs args)
     return true;
 }
 
+bool
+Instance::hasFuncCallCounts() const
+{
+    return metadata().funcCallCountsGlobalDataOffset.isSome();
+}
+
+uint32_t
+Instance::funcCallCount(uint32_t funcIndex) const
+{
+    MOZ_ASSERT(hasFuncCallCounts());
+
+    uint32_t numFuncImports = metadata(code().stableTier()).funcImports.length();
+    MOZ_ASSERT(funcIndex >= numFuncImports);
+
+    uint32_t offset = *metadata().funcCallCountsGlobalDataOffset +
+                      (funcIndex - numFuncImports) * sizeof(uint32_t);
+
+    // The count is updated racily by the running wasm code.
+    return *reinterpret_cast<const uint32_t*>(globalData() + offset);
+}
+
 JSAtom*
 Instance::getFuncDisplayAtom(JSContext* cx, uint32_t funcIndex) const
 {
@@ -1234,6 +1268,29 @@ Instance::ensureProfilingLabels(bool profilingEnabled) const
     return code_->ensureProfilingLabels(profilingEnabled);
 }
 
+void
+Instance::initTierUp(const Module& module)
+{
+    MOZ_ASSERT(module.hasDeferredTier2());
+    MOZ_ASSERT(!tierUpModule_);
+
+    tierUpModule_ = &module;
+    tlsData()->tierUpCounter = int32_t(Min(JitOptions.wasmTier2Threshold, uint32_t(INT32_MAX)));
+}
+
+void
+Instance::checkTierUp()
+{
+    // Baseline code may keep counting down after tier-2 has been requested,
+    // so reset the counter to trap as rarely as possible.
+    tlsData()->tierUpCounter = INT32_MAX;
+
+    if (tierUpModule_) {
+        tierUpModule_->requestTier2();
+        tierUpModule_ = nullptr;
+    }
+}
+
 void
 Instance::onMovingGrowMemory(uint8_t* prevMemoryBase)
 {
@@ -31,12 +31,16 @@
 namespace js {
 namespace wasm {
 
+class Module;
+
 // Instance represents a wasm instance and provides all the support for runtime
 // execution of code in the instance. Instances share various immutable data
 // structures with the Module from which they were instantiated and other
 // instances instantiated from the same Module. However, an Instance has no
 // direct reference to its source Module which allows a Module to be destroyed
-// while it still has live Instances.
+// while it still has live Instances. The exception is a Module whose tier-2
+// compilation is deferred: its instances keep it alive until one of them has
+// become hot and requested tier-2 compilation.
 //
 // The instance's code may be shared among multiple instances provided none of
 // those instances are being debugged. Instances that are being debugged own
@@ -57,6 +61,7 @@ class Instance
     ElemSegmentVector               passiveElemSegments_;
     const UniqueDebugState          maybeDebug_;
     StructTypeDescrVector           structTypeDescrs_;
+    RefPtr<const Module>            tierUpModule_;
 
     // Internal helpers:
     const void** addressOfFuncTypeId(const FuncTypeIdDesc& funcTypeId) const;
@@ -137,6 +142,12 @@ class Instance
     JSAtom* getFuncDisplayAtom(JSContext* cx, uint32_t funcIndex) const;
     void ensureProfilingLabels(bool profilingEnabled) const;
 
+    // When the Module was compiled with JS::ContextOptions::wasmFunctionCounts,
+    // each function defined by the module counts its calls in this instance.
+
+    bool hasFuncCallCounts() const;
+    uint32_t funcCallCount(uint32_t funcIndex) const;
+
     // Initially, calls to imports in wasm code call out through the generic
     // callImport method. If the imported callee gets JIT compiled and the types
     // match up, callImport will patch the code to instead call through a thunk
@@ -145,6 +156,13 @@ class Instance
 
     void deoptimizeImportExit(uint32_t funcImportIndex);
 
+    // When a Module defers tier-2 compilation, its baseline code counts down
+    // TlsData::tierUpCounter and calls checkTierUp() when the instance has
+    // become hot, which then requests tier-2 compilation of the Module.
+
+    void initTierUp(const Module& module);
+    void checkTierUp();
+
     // Called by Wasm(Memory|Table)Object when a moving resize occurs:
 
     void onMovingGrowMemory(uint8_t* prevMemoryBase);
@@ -224,6 +224,9 @@ class FunctionCompiler
               case ValType::F64:
                 ins = MConstant::New(alloc(), DoubleValue(0.0), MIRType::Double);
                 break;
+              case ValType::V128:
+                ins = MWasmSimd128Constant::New(alloc(), SimdConstant::SplatX4(0));
+                break;
               case ValType::Ref:
               case ValType::AnyRef:
                 MOZ_CRASH("ion support for ref/anyref value NYI");
@@ -315,6 +318,79 @@ class FunctionCompiler
         return constant;
     }
 
+#ifdef ENABLE_WASM_SIMD
+    MDefinition* constant(const SimdConstant& v)
+    {
+        if (inDeadCode()) {
+            return nullptr;
+        }
+        auto* cst = MWasmSimd128Constant::New(alloc(), v);
+        curBlock_->add(cst);
+        return cst;
+    }
+
+    MDefinition* binarySimd128(MDefinition* lhs, MDefinition* rhs, SimdOp op)
+    {
+        if (inDeadCode()) {
+            return nullptr;
+        }
+        auto* ins = MWasmBinarySimd128::New(alloc(), lhs, rhs, op);
+        curBlock_->add(ins);
+        return ins;
+    }
+
+    MDefinition* unarySimd128(MDefinition* src, SimdOp op)
+    {
+        if (inDeadCode()) {
+            return nullptr;
+        }
+        auto* ins = MWasmUnarySimd128::New(alloc(), src, op);
+        curBlock_->add(ins);
+        return ins;
+    }
+
+    MDefinition* shuffleSimd128(MDefinition* lhs, MDefinition* rhs, const SimdConstant& lanes)
+    {
+        if (inDeadCode()) {
+            return nullptr;
+        }
+        auto* ins = MWasmShuffleSimd128::New(alloc(), lhs, rhs, lanes);
+        curBlock_->add(ins);
+        return ins;
+    }
+
+    MDefinition* scalarToSimd128(MDefinition* src, SimdOp op)
+    {
+        if (inDeadCode()) {
+            return nullptr;
+        }
+        auto* ins = MWasmScalarToSimd128::New(alloc(), src, op);
+        curBlock_->add(ins);
+        return ins;
+    }
+
+    MDefinition* reduceSimd128(MDefinition* src, SimdOp op, ValType outType, uint32_t lane)
+    {
+        if (inDeadCode()) {
+            return nullptr;
+        }
+        auto* ins = MWasmReduceSimd128::New(alloc(), src, op, ToMIRType(outType), lane);
+        curBlock_->add(ins);
+        return ins;
+    }
+
+    MDefinition* replaceLaneSimd128(MDefinition* vector, MDefinition* value, uint32_t lane,
+                                    SimdOp op)
+    {
+        if (inDeadCode()) {
+            return nullptr;
+        }
+        auto* ins = MWasmReplaceLaneSimd128::New(alloc(), vector, value, op, lane);
+        curBlock_->add(ins);
+        return ins;
+    }
+#endif
+
     template <class T>
     MDefinition* unary(MDefinition* op)
     {
@@ -1095,7 +1171,8 @@ class FunctionCompiler
             MOZ_ASSERT(funcType.id.kind() != FuncTypeIdDescKind::None);
             MOZ_ASSERT(env_.tables.length() == 1);
             const TableDesc& table = env_.tables[0];
-            callee = CalleeDesc::wasmTable(table, funcType.id);
+            callee = CalleeDesc::wasmTable(table, funcType.id,
+                                           env_.tableSigCheck(table, funcType));
         }
 
         CallSiteDesc desc(call.lineOrBytecode_, CallSiteDesc::Dynamic);
@@ -2982,6 +3059,147 @@ EmitAtomicXchg(FunctionCompiler& f, ValType type, Scalar::Type viewType)
 #endif // ENABLE_WASM_THREAD_OPS
 
 #ifdef ENABLE_WASM_BULKMEM_OPS
+// The accesses used by the inline expansions of memory.copy and memory.fill,
+// widest first.
+static const Scalar::Type InlineMemoryAccessTypes[] = {
+#ifdef ENABLE_WASM_SIMD
+    Scalar::Simd128,
+#endif
+#ifdef JS_64BIT
+    Scalar::Int64,
+#endif
+    Scalar::Int32,
+    Scalar::Uint16,
+    Scalar::Uint8
+};
+
+static ValType
+InlineMemoryAccessValType(Scalar::Type viewType)
+{
+    switch (viewType) {
+#ifdef ENABLE_WASM_SIMD
+      case Scalar::Simd128:
+        return ValType::V128;
+#endif
+      case Scalar::Int64:
+        return ValType::I64;
+      default:
+        return ValType::I32;
+    }
+}
+
+// Split |length| bytes into the widest accesses available, in increasing
+// address order.
+struct InlineMemoryAccess
+{
+    Scalar::Type viewType;
+    uint32_t offset;
+};
+
+typedef Vector<InlineMemoryAccess, 16, SystemAllocPolicy> InlineMemoryAccessVector;
+
+static bool
+SplitInlineMemoryAccesses(FunctionCompiler& f, uint32_t length,
+                          InlineMemoryAccessVector* accesses)
+{
+    uint32_t offset = 0;
+    for (Scalar::Type viewType : InlineMemoryAccessTypes) {
+#ifdef ENABLE_WASM_SIMD
+        // Vector registers are only used for wasm code when SIMD is enabled.
+        if (viewType == Scalar::Simd128 && !f.env().simdEnabled()) {
+            continue;
+        }
+#endif
+        uint32_t size = Scalar::byteSize(viewType);
+        while (length - offset >= size) {
+            if (!accesses->append(InlineMemoryAccess { viewType, offset })) {
+                return false;
+            }
+            offset += size;
+        }
+    }
+    MOZ_ASSERT(offset == length);
+    return true;
+}
+
+// Expand a memory.copy of a small constant, non-zero length into loads and
+// stores. All the loads happen before any store, so overlapping ranges behave
+// like memmove, and the stores go from the highest address down, so that an
+// out-of-bounds destination traps on the first store before anything has been
+// written. Every access uses the same base, so only the first access of each
+// range needs a bounds check.
+static bool
+EmitMemCopyInline(FunctionCompiler& f, MDefinition* dst, MDefinition* src, uint32_t length)
+{
+    MOZ_ASSERT(length != 0 && length <= MaxInlineMemoryCopyLength);
+
+    InlineMemoryAccessVector accesses;
+    if (!SplitInlineMemoryAccesses(f, length, &accesses)) {
+        return false;
+    }
+
+    Vector<MDefinition*, 16, SystemAllocPolicy> values;
+    for (const InlineMemoryAccess& a : accesses) {
+        MemoryAccessDesc access(a.viewType, 1, a.offset, f.bytecodeOffset());
+        MDefinition* value = f.load(src, &access, InlineMemoryAccessValType(a.viewType));
+        if (!value || !values.append(value)) {
+            return false;
+        }
+    }
+
+    for (size_t i = accesses.length(); i > 0; i--) {
+        const InlineMemoryAccess& a = accesses[i - 1];
+        MemoryAccessDesc access(a.viewType, 1, a.offset, f.bytecodeOffset());
+        f.store(dst, &access, values[i - 1]);
+    }
+
+    return true;
+}
+
+// Like EmitMemCopyInline, for a memory.fill with a constant value.
+static bool
+EmitMemFillInline(FunctionCompiler& f, MDefinition* start, uint8_t value, uint32_t length)
+{
+    MOZ_ASSERT(length != 0 && length <= MaxInlineMemoryFillLength);
+
+    InlineMemoryAccessVector accesses;
+    if (!SplitInlineMemoryAccesses(f, length, &accesses)) {
+        return false;
+    }
+
+    for (size_t i = accesses.length(); i > 0; i--) {
+        const InlineMemoryAccess& a = accesses[i - 1];
+
+        MDefinition* pattern;
+        switch (a.viewType) {
+#ifdef ENABLE_WASM_SIMD
+          case Scalar::Simd128:
+            pattern = f.constant(SimdConstant::SplatX16(int8_t(value)));
+            break;
+#endif
+          case Scalar::Int64:
+            pattern = f.constant(int64_t(value * UINT64_C(0x0101010101010101)));
+            break;
+          case Scalar::Int32:
+            pattern = f.constant(Int32Value(int32_t(value * 0x01010101U)), MIRType::Int32);
+            break;
+          case Scalar::Uint16:
+            pattern = f.constant(Int32Value(value * 0x0101), MIRType::Int32);
+            break;
+          case Scalar::Uint8:
+            pattern = f.constant(Int32Value(value), MIRType::Int32);
+            break;
+          default:
+            MOZ_CRASH("unexpected inline memory access");
+        }
+
+        MemoryAccessDesc access(a.viewType, 1, a.offset, f.bytecodeOffset());
+        f.store(start, &access, pattern);
+    }
+
+    return true;
+}
+
 static bool
 EmitMemOrTableCopy(FunctionCompiler& f, bool isMem)
 {
@@ -2996,6 +3214,14 @@ EmitMemOrTableCopy(FunctionCompiler& f, bool isMem)
 
     uint32_t lineOrBytecode = f.readCallSiteLineOrBytecode();
 
+    // A zero length still has to check the offsets, leave it to the runtime.
+    if (isMem && len->isConstant()) {
+        uint32_t length = uint32_t(len->toConstant()->toInt32());
+        if (length != 0 && length <= MaxInlineMemoryCopyLength) {
+            return EmitMemCopyInline(f, dst, src, length);
+        }
+    }
+
     CallCompileState args(f, lineOrBytecode);
     if (!f.startCall(&args)) {
         return false;
@@ -3093,6 +3319,13 @@ EmitMemFill(FunctionCompiler& f)
 
     uint32_t lineOrBytecode = f.readCallSiteLineOrBytecode();
 
+    if (len->isConstant() && val->isConstant()) {
+        uint32_t length = uint32_t(len->toConstant()->toInt32());
+        if (length != 0 && length <= MaxInlineMemoryFillLength) {
+            return EmitMemFillInline(f, start, uint8_t(val->toConstant()->toInt32()), length);
+        }
+    }
+
     CallCompileState args(f, lineOrBytecode);
     if (!f.startCall(&args)) {
         return false;
@@ -3186,6 +3419,99 @@ EmitMemOrTableInit(FunctionCompiler& f, bool isMem)
 }
 #endif // ENABLE_WASM_BULKMEM_OPS
 
+#ifdef ENABLE_WASM_SIMD
+static bool
+EmitV128Const(FunctionCompiler& f)
+{
+    V128 v128;
+    if (!f.iter().readV128Const(&v128)) {
+        return false;
+    }
+
+    f.iter().setResult(f.constant(SimdConstant::CreateX16((int8_t*)v128.bytes)));
+    return true;
+}
+
+static bool
+EmitBinarySimd128(FunctionCompiler& f, SimdOp op)
+{
+    MDefinition* lhs;
+    MDefinition* rhs;
+    if (!f.iter().readBinary(ValType::V128, &lhs, &rhs)) {
+        return false;
+    }
+
+    f.iter().setResult(f.binarySimd128(lhs, rhs, op));
+    return true;
+}
+
+static bool
+EmitUnarySimd128(FunctionCompiler& f, SimdOp op)
+{
+    MDefinition* src;
+    if (!f.iter().readUnary(ValType::V128, &src)) {
+        return false;
+    }
+
+    f.iter().setResult(f.unarySimd128(src, op));
+    return true;
+}
+
+static bool
+EmitShuffleSimd128(FunctionCompiler& f)
+{
+    MDefinition* lhs;
+    MDefinition* rhs;
+    V128 lanes;
+    if (!f.iter().readShuffle(&lhs, &rhs, &lanes)) {
+        return false;
+    }
+
+    f.iter().setResult(f.shuffleSimd128(lhs, rhs,
+                                        SimdConstant::CreateX16((int8_t*)lanes.bytes)));
+    return true;
+}
+
+static bool
+EmitSplatSimd128(FunctionCompiler& f, ValType inType, SimdOp op)
+{
+    MDefinition* src;
+    if (!f.iter().readSplat(inType, &src)) {
+        return false;
+    }
+
+    f.iter().setResult(f.scalarToSimd128(src, op));
+    return true;
+}
+
+static bool
+EmitExtractLaneSimd128(FunctionCompiler& f, ValType outType, uint32_t numLanes, SimdOp op)
+{
+    uint32_t lane;
+    MDefinition* src;
+    if (!f.iter().readExtractLane(outType, numLanes, &lane, &src)) {
+        return false;
+    }
+
+    f.iter().setResult(f.reduceSimd128(src, op, outType, lane));
+    return true;
+}
+
+static bool
+EmitReplaceLaneSimd128(FunctionCompiler& f, ValType laneType, uint32_t numLanes, SimdOp op)
+{
+    uint32_t lane;
+    MDefinition* vector;
+    MDefinition* value;
+    if (!f.iter().readReplaceLane(laneType, numLanes, &lane, &vector, &value)) {
+        return false;
+    }
+
+    f.iter().setResult(f.replaceLaneSimd128(vector, value, lane, op));
+    return true;
+}
+#endif
+
 static bool
 EmitBodyExprs(FunctionCompiler& f)
 {
@@ -3640,6 +3966,90 @@ EmitBodyExprs(FunctionCompiler& f)
             break;
           }
 
+#ifdef ENABLE_WASM_SIMD
+          // SIMD operations
+          case uint16_t(Op::SimdPrefix): {
+            if (!f.env().simdEnabled()) {
+                return f.iter().unrecognizedOpcode(&op);
+            }
+            switch (op.b1) {
+              case uint16_t(SimdOp::V128Load):
+                CHECK(EmitLoad(f, ValType::V128, Scalar::Simd128));
+              case uint16_t(SimdOp::V128Store):
+                CHECK(EmitStore(f, ValType::V128, Scalar::Simd128));
+              case uint16_t(SimdOp::V128Const):
+                CHECK(EmitV128Const(f));
+              case uint16_t(SimdOp::I8x16Shuffle):
+                CHECK(EmitShuffleSimd128(f));
+              case uint16_t(SimdOp::I8x16Splat):
+              case uint16_t(SimdOp::I16x8Splat):
+              case uint16_t(SimdOp::I32x4Splat):
+                CHECK(EmitSplatSimd128(f, ValType::I32, SimdOp(op.b1)));
+              case uint16_t(SimdOp::F32x4Splat):
+                CHECK(EmitSplatSimd128(f, ValType::F32, SimdOp(op.b1)));
+              case uint16_t(SimdOp::I8x16ExtractLaneS):
+              case uint16_t(SimdOp::I8x16ExtractLaneU):
+                CHECK(EmitExtractLaneSimd128(f, ValType::I32, 16, SimdOp(op.b1)));
+              case uint16_t(SimdOp::I16x8ExtractLaneS):
+              case uint16_t(SimdOp::I16x8ExtractLaneU):
+                CHECK(EmitExtractLaneSimd128(f, ValType::I32, 8, SimdOp(op.b1)));
+              case uint16_t(SimdOp::I32x4ExtractLane):
+                CHECK(EmitExtractLaneSimd128(f, ValType::I32, 4, SimdOp(op.b1)));
+              case uint16_t(SimdOp::F32x4ExtractLane):
+                CHECK(EmitExtractLaneSimd128(f, ValType::F32, 4, SimdOp(op.b1)));
+              case uint16_t(SimdOp::I8x16ReplaceLane):
+                CHECK(EmitReplaceLaneSimd128(f, ValType::I32, 16, SimdOp(op.b1)));
+              case uint16_t(SimdOp::I16x8ReplaceLane):
+                CHECK(EmitReplaceLaneSimd128(f, ValType::I32, 8, SimdOp(op.b1)));
+              case uint16_t(SimdOp::I32x4ReplaceLane):
+                CHECK(EmitReplaceLaneSimd128(f, ValType::I32, 4, SimdOp(op.b1)));
+              case uint16_t(SimdOp::F32x4ReplaceLane):
+                CHECK(EmitReplaceLaneSimd128(f, ValType::F32, 4, SimdOp(op.b1)));
+              case uint16_t(SimdOp::V128Not):
+              case uint16_t(SimdOp::I8x16Neg):
+              case uint16_t(SimdOp::I16x8Neg):
+              case uint16_t(SimdOp::I32x4Neg):
+              case uint16_t(SimdOp::F32x4Abs):
+              case uint16_t(SimdOp::F32x4Neg):
+              case uint16_t(SimdOp::F32x4Sqrt):
+                CHECK(EmitUnarySimd128(f, SimdOp(op.b1)));
+              case uint16_t(SimdOp::I8x16Swizzle):
+              case uint16_t(SimdOp::I8x16Eq):
+              case uint16_t(SimdOp::I16x8Eq):
+              case uint16_t(SimdOp::I32x4Eq):
+              case uint16_t(SimdOp::F32x4Eq):
+              case uint16_t(SimdOp::V128And):
+              case uint16_t(SimdOp::V128AndNot):
+              case uint16_t(SimdOp::V128Or):
+              case uint16_t(SimdOp::V128Xor):
+              case uint16_t(SimdOp::I8x16Add):
+              case uint16_t(SimdOp::I8x16AddSatS):
+              case uint16_t(SimdOp::I8x16AddSatU):
+              case uint16_t(SimdOp::I8x16Sub):
+              case uint16_t(SimdOp::I8x16SubSatS):
+              case uint16_t(SimdOp::I8x16SubSatU):
+              case uint16_t(SimdOp::I16x8Add):
+              case uint16_t(SimdOp::I16x8AddSatS):
+              case uint16_t(SimdOp::I16x8AddSatU):
+              case uint16_t(SimdOp::I16x8Sub):
+              case uint16_t(SimdOp::I16x8SubSatS):
+              case uint16_t(SimdOp::I16x8SubSatU):
+              case uint16_t(SimdOp::I16x8Mul):
+              case uint16_t(SimdOp::I32x4Add):
+              case uint16_t(SimdOp::I32x4Sub):
+              case uint16_t(SimdOp::I32x4Mul):
+              case uint16_t(SimdOp::F32x4Add):
+              case uint16_t(SimdOp::F32x4Sub):
+              case uint16_t(SimdOp::F32x4Mul):
+              case uint16_t(SimdOp::F32x4Div):
+                CHECK(EmitBinarySimd128(f, SimdOp(op.b1)));
+              default:
+                return f.iter().unrecognizedOpcode(&op);
+            }
+            break;
+          }
+#endif
+
           // Thread operations
           case uint16_t(Op::ThreadPrefix): {
 #ifdef ENABLE_WASM_THREAD_OPS
@@ -3907,7 +4317,8 @@ wasm::IonCompileFunctions(const ModuleEnvironment& env, LifoAlloc& lifo,
         if (!locals.appendAll(env.funcTypes[func.index]->args())) {
             return false;
         }
-        if (!DecodeLocalEntries(d, env.kind, env.types, env.gcTypesEnabled(), &locals)) {
+        if (!DecodeLocalEntries(d, env.kind, env.types, env.gcTypesEnabled(),
+                                env.simdEnabled(), &locals)) {
             return false;
         }
 
@@ -3958,7 +4369,9 @@ wasm::IonCompileFunctions(const ModuleEnvironment& env, LifoAlloc& lifo,
 
             BytecodeOffset prologueTrapOffset(func.lineOrBytecode);
             FuncOffsets offsets;
-            if (!codegen.generateWasm(funcTypeId, prologueTrapOffset, &offsets)) {
+            if (!codegen.generateWasm(funcTypeId, prologueTrapOffset,
+                                      env.funcCallCountGlobalDataOffset(func.index), &offsets))
+            {
                 return false;
             }
 
@@ -3985,3 +4398,14 @@ js::wasm::IonCanCompile()
     return false;
 #endif
 }
+
+bool
+js::wasm::IonCanCompileSimd()
+{
+#ifdef ENABLE_WASM_SIMD
+    // The lowerings of the lane operations and of the shuffles use SSE4.1.
+    return IonCanCompile() && CPUInfo::IsSSE41Present();
+#else
+    return false;
+#endif
+}
@@ -30,6 +30,11 @@ namespace wasm {
 bool
 IonCanCompile();
 
+// Return whether IonCompileFunction() can compile the SIMD operations on the
+// current device.
+bool
+IonCanCompileSimd();
+
 // Generates very fast code at the expense of compilation time.
 MOZ_MUST_USE bool
 IonCompileFunctions(const ModuleEnvironment& env, LifoAlloc& lifo,
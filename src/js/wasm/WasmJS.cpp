@@ -177,7 +177,8 @@ ToWebAssemblyValue(JSContext* cx, ValType targetType, HandleValue v, MutableHand
         return true;
       }
       case ValType::Ref:
-      case ValType::I64: {
+      case ValType::I64:
+      case ValType::V128: {
         break;
       }
     }
@@ -201,6 +202,7 @@ ToJSValue(const Val& val)
         return ObjectValue(*(JSObject*)val.ptr());
       case ValType::Ref:
       case ValType::I64:
+      case ValType::V128:
         break;
     }
     MOZ_CRASH("unexpected type when translating to a JS value");
@@ -2344,6 +2346,8 @@ WasmGlobalObject::trace(JSTracer* trc, JSObject* obj)
         break;
       case ValType::Ref:
         MOZ_CRASH("Ref NYI");
+      case ValType::V128:
+        MOZ_CRASH("v128 globals NYI");
     }
 }
 
@@ -2402,6 +2406,8 @@ WasmGlobalObject::create(JSContext* cx, HandleVal hval, bool isMutable)
         break;
       case ValType::Ref:
         MOZ_CRASH("Ref NYI");
+      case ValType::V128:
+        MOZ_CRASH("v128 globals NYI");
     }
 
     obj->initReservedSlot(TYPE_SLOT, Int32Value(int32_t(val.type().bitsUnsafe())));
@@ -2488,6 +2494,7 @@ WasmGlobalObject::construct(JSContext* cx, unsigned argc, Value* vp)
       case ValType::F64:    globalVal = Val(double(0.0)); break;
       case ValType::AnyRef: globalVal = Val(nullptr);     break;
       case ValType::Ref:    MOZ_CRASH("Ref NYI");
+      case ValType::V128:   MOZ_CRASH("v128 globals NYI");
     }
 
     // Override with non-undefined value, if provided.
@@ -2528,6 +2535,8 @@ WasmGlobalObject::valueGetterImpl(JSContext* cx, const CallArgs& args)
         return false;
       case ValType::Ref:
         MOZ_CRASH("Ref NYI");
+      case ValType::V128:
+        MOZ_CRASH("v128 globals NYI");
     }
     MOZ_CRASH();
 }
@@ -2586,6 +2595,8 @@ WasmGlobalObject::valueSetterImpl(JSContext* cx, const CallArgs& args)
         MOZ_CRASH("unexpected i64 when setting global's value");
       case ValType::Ref:
         MOZ_CRASH("Ref NYI");
+      case ValType::V128:
+        MOZ_CRASH("v128 globals NYI");
     }
 
     args.rval().setUndefined();
@@ -2638,6 +2649,7 @@ WasmGlobalObject::val(MutableHandleVal outval) const
       case ValType::F64:    outval.set(Val(cell->f64));           return;
       case ValType::AnyRef: outval.set(Val(cell->ptr));           return;
       case ValType::Ref:    MOZ_CRASH("Ref NYI");
+      case ValType::V128:   MOZ_CRASH("v128 globals NYI");
     }
     MOZ_CRASH("unexpected Global type");
 }
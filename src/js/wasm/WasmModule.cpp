@@ -19,9 +19,17 @@
 #include "wasm/WasmModule.h"
 
 #include <chrono>
+#include <stdio.h>
 #include <thread>
+#ifdef XP_UNIX
+# include <fcntl.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+# include <unistd.h>
+#endif
 
 #include "builtin/TypedObject.h"
+#include "gc/Memory.h"
 #include "jit/JitOptions.h"
 #include "threading/LockGuard.h"
 #include "util/NSPR.h"
@@ -47,7 +55,7 @@ class Module::Tier2GeneratorTaskImpl : public Tier2GeneratorTask
 
   public:
     Tier2GeneratorTaskImpl(const CompileArgs& compileArgs, const ShareableBytes& bytecode,
-                           Module& module)
+                           const Module& module)
       : compileArgs_(&compileArgs),
         bytecode_(&bytecode),
         module_(&module),
@@ -78,7 +86,7 @@ Module::~Module()
 void
 Module::startTier2(const CompileArgs& args,
                    const ShareableBytes& bytecode,
-                   JS::OptimizedEncodingListener* listener)
+                   JS::OptimizedEncodingListener* listener) const
 {
     MOZ_ASSERT(!testingTier2Active_);
 
@@ -95,6 +103,32 @@ Module::startTier2(const CompileArgs& args,
     StartOffThreadWasmTier2Generator(std::move(task));
 }
 
+void
+Module::deferTier2(const CompileArgs& args,
+                   const ShareableBytes& bytecode,
+                   JS::OptimizedEncodingListener* listener)
+{
+    MOZ_ASSERT(!hasDeferredTier2());
+    MOZ_ASSERT(!tier2Requested_);
+
+    deferredTier2Args_ = &args;
+    deferredTier2Bytecode_ = &bytecode;
+    deferredTier2Listener_ = listener;
+}
+
+void
+Module::requestTier2() const
+{
+    MOZ_ASSERT(hasDeferredTier2());
+
+    // Instances of a module can run on several threads at once.
+    if (!tier2Requested_.compareExchange(false, true)) {
+        return;
+    }
+
+    startTier2(*deferredTier2Args_, *deferredTier2Bytecode_, deferredTier2Listener_);
+}
+
 bool
 Module::finishTier2(const LinkData& linkData2, UniqueCodeTier code2) const
 {
@@ -237,7 +271,8 @@ Module::serialize(const LinkData& linkData, uint8_t* begin, size_t size) const
 }
 
 /* static */ MutableModule
-Module::deserialize(const uint8_t* begin, size_t size, Metadata* maybeMetadata)
+Module::deserialize(const uint8_t* begin, size_t size, Metadata* maybeMetadata,
+                    const SerializedFile* file)
 {
     MutableMetadata metadata(maybeMetadata);
     if (!metadata) {
@@ -306,7 +341,7 @@ Module::deserialize(const uint8_t* begin, size_t size, Metadata* maybeMetadata)
     }
 
     SharedCode code;
-    cursor = Code::deserialize(cursor, linkData, *metadata, &code);
+    cursor = Code::deserialize(cursor, linkData, *metadata, file, &code);
     if (!cursor) {
         return nullptr;
     }
@@ -325,14 +360,21 @@ Module::deserialize(const uint8_t* begin, size_t size, Metadata* maybeMetadata)
 void
 Module::serialize(const LinkData& linkData, JS::OptimizedEncodingListener& listener) const
 {
+    // Serialize at a page aligned address, so that the machine code is page
+    // aligned relative to the start of the encoding and a file holding the
+    // encoding can be mapped by DeserializeModuleFromFile().
+    size_t pageSize = gc::SystemPageSize();
+    size_t size = serializedSize(linkData);
+
     Vector<uint8_t, 0, SystemAllocPolicy> bytes;
-    if (!bytes.resize(serializedSize(linkData))) {
+    if (!bytes.resize(size + pageSize - 1)) {
         return;
     }
 
-    serialize(linkData, bytes.begin(), bytes.length());
+    uint8_t* begin = (uint8_t*)AlignBytes(uintptr_t(bytes.begin()), pageSize);
+    serialize(linkData, begin, size);
 
-    listener.storeOptimizedEncoding(bytes.begin(), bytes.length());
+    listener.storeOptimizedEncoding(begin, size);
 }
 
 /* virtual */ JSObject*
@@ -452,6 +494,85 @@ wasm::DeserializeModule(PRFileDesc* bytecodeFile, UniqueChars filename, unsigned
     return RefPtr<JS::WasmModule>(const_cast<Module*>(module.get()));
 }
 
+// Whether a serialized module was written by this build. Module::deserialize()
+// asserts this, since its other callers only see encodings they produced.
+static bool
+HasCurrentBuildId(const uint8_t* begin, size_t size)
+{
+    JS::BuildIdCharVector currentBuildId;
+    if (!GetOptimizedEncodingBuildId(&currentBuildId)) {
+        return false;
+    }
+
+    uint32_t length;
+    if (size < sizeof(length)) {
+        return false;
+    }
+    memcpy(&length, begin, sizeof(length));
+    return length == currentBuildId.length() &&
+           size - sizeof(length) >= length &&
+           memcmp(begin + sizeof(length), currentBuildId.begin(), length) == 0;
+}
+
+RefPtr<JS::WasmModule>
+wasm::DeserializeModuleFromFile(const char* filename)
+{
+    MutableModule module;
+
+#ifdef XP_UNIX
+    int fd = open(filename, O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return nullptr;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size <= 0) {
+        close(fd);
+        return nullptr;
+    }
+    size_t size = size_t(st.st_size);
+
+    // Only the metadata is read through this mapping; the machine code is
+    // mapped separately into executable memory by ModuleSegment::deserialize().
+    void* p = mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (p == MAP_FAILED) {
+        close(fd);
+        return nullptr;
+    }
+
+    const uint8_t* begin = static_cast<const uint8_t*>(p);
+    if (HasCurrentBuildId(begin, size)) {
+        SerializedFile file(fd, begin);
+        module = Module::deserialize(begin, size, nullptr, &file);
+    }
+
+    munmap(p, size);
+    close(fd);
+#else
+    FILE* fp = fopen(filename, "rb");
+    if (!fp) {
+        return nullptr;
+    }
+
+    Bytes bytes;
+    uint8_t buffer[4096];
+    size_t n;
+    while ((n = fread(buffer, 1, sizeof(buffer), fp)) > 0) {
+        if (!bytes.append(buffer, n)) {
+            fclose(fp);
+            return nullptr;
+        }
+    }
+    fclose(fp);
+
+    if (HasCurrentBuildId(bytes.begin(), bytes.length())) {
+        module = Module::deserialize(bytes.begin(), bytes.length());
+    }
+#endif
+
+    return RefPtr<JS::WasmModule>(module.get());
+}
+
 /* virtual */ void
 Module::addSizeOfMisc(MallocSizeOf mallocSizeOf,
                       Metadata::SeenSet* seenMetadata,
@@ -1321,6 +1442,10 @@ Module::instantiate(JSContext* cx,
         return false;
     }
 
+    if (hasDeferredTier2() && !tier2Requested_) {
+        instance->instance().initTierUp(*this);
+    }
+
     if (!CreateExportObject(cx, instance, funcImports, table, memory, globalObjs, exports_)) {
         return false;
     }
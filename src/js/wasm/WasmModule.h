@@ -38,6 +38,8 @@ struct CompileArgs;
 
 typedef RefPtr<JS::OptimizedEncodingListener> Tier2Listener;
 
+struct CompileArgs;
+
 // Module represents a compiled wasm module and primarily provides three
 // operations: instantiation, tiered compilation, serialization. A Module can be
 // instantiated any number of times to produce new Instance objects. A Module
@@ -86,6 +88,16 @@ class Module : public JS::WasmModule
 
     mutable Atomic<bool>    testingTier2Active_;
 
+    // When tier-2 compilation is deferred until the baseline code of an
+    // instance becomes hot, these fields hold the arguments for startTier2().
+    // They are set before the Module is shared and tier2Requested_ ensures
+    // that only the first instance to become hot starts the compilation.
+
+    RefPtr<const CompileArgs> deferredTier2Args_;
+    SharedBytes               deferredTier2Bytecode_;
+    Tier2Listener             deferredTier2Listener_;
+    mutable Atomic<bool>      tier2Requested_;
+
     bool instantiateFunctions(JSContext* cx, Handle<FunctionVector> funcImports) const;
     bool instantiateMemory(JSContext* cx, MutableHandleWasmMemoryObject memory) const;
     bool instantiateTable(JSContext* cx,
@@ -124,7 +136,8 @@ class Module : public JS::WasmModule
         debugUnlinkedCode_(std::move(debugUnlinkedCode)),
         debugLinkData_(std::move(debugLinkData)),
         debugBytecode_(debugBytecode),
-        testingTier2Active_(false)
+        testingTier2Active_(false),
+        tier2Requested_(false)
     {
         MOZ_ASSERT_IF(metadata().debugEnabled, debugUnlinkedCode_ && debugLinkData_);
     }
@@ -159,9 +172,21 @@ class Module : public JS::WasmModule
 
     void startTier2(const CompileArgs& args,
                     const ShareableBytes& bytecode,
-                    JS::OptimizedEncodingListener* listener);
+                    JS::OptimizedEncodingListener* listener) const;
     bool finishTier2(const LinkData& linkData2, UniqueCodeTier code2) const;
 
+    // Instead of starting tier-2 compilation immediately, ModuleGenerator may
+    // defer it until an instance's baseline code has executed enough function
+    // entries and loop iterations (see JitOptions.wasmTier2Threshold), so that
+    // modules which stay cold are never compiled with the optimizing tier.
+    // Instances of such a module call requestTier2() when they become hot.
+
+    void deferTier2(const CompileArgs& args,
+                    const ShareableBytes& bytecode,
+                    JS::OptimizedEncodingListener* listener);
+    bool hasDeferredTier2() const { return !!deferredTier2Args_; }
+    void requestTier2() const;
+
     void testingBlockOnTier2Complete() const;
     bool testingTier2Active() const { return testingTier2Active_; }
 
@@ -171,7 +196,8 @@ class Module : public JS::WasmModule
     void serialize(const LinkData& linkData, uint8_t* begin, size_t size) const;
     void serialize(const LinkData& linkData, JS::OptimizedEncodingListener& listener) const;
     static RefPtr<Module> deserialize(const uint8_t* begin, size_t size,
-                                      Metadata* maybeMetadata = nullptr);
+                                      Metadata* maybeMetadata = nullptr,
+                                      const SerializedFile* file = nullptr);
 
     // JS API and JS::WasmModule implementation:
 
@@ -201,6 +227,9 @@ GetOptimizedEncodingBuildId(JS::BuildIdCharVector* buildId);
 RefPtr<JS::WasmModule>
 DeserializeModule(PRFileDesc* bytecode, UniqueChars filename, unsigned line);
 
+RefPtr<JS::WasmModule>
+DeserializeModuleFromFile(const char* filename);
+
 } // namespace wasm
 } // namespace js
 
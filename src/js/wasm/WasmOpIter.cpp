@@ -39,6 +39,11 @@ using namespace js::wasm;
 # else
 #  define WASM_THREAD_OP(code) break
 # endif
+# ifdef ENABLE_WASM_SIMD
+#  define WASM_SIMD_OP(code) return code
+# else
+#  define WASM_SIMD_OP(code) break
+# endif
 
 OpKind
 wasm::Classify(OpBytes op)
@@ -295,6 +300,77 @@ wasm::Classify(OpBytes op)
           }
           break;
       }
+      case Op::SimdPrefix: {
+          switch (SimdOp(op.b1)) {
+            case SimdOp::Limit:
+              // Reject Limit for SimdPrefix encoding
+              break;
+            case SimdOp::V128Load:
+              WASM_SIMD_OP(OpKind::Load);
+            case SimdOp::V128Store:
+              WASM_SIMD_OP(OpKind::Store);
+            case SimdOp::V128Const:
+              WASM_SIMD_OP(OpKind::V128);
+            case SimdOp::I8x16Shuffle:
+              WASM_SIMD_OP(OpKind::Shuffle);
+            case SimdOp::I8x16Splat:
+            case SimdOp::I16x8Splat:
+            case SimdOp::I32x4Splat:
+            case SimdOp::F32x4Splat:
+              WASM_SIMD_OP(OpKind::Splat);
+            case SimdOp::I8x16ExtractLaneS:
+            case SimdOp::I8x16ExtractLaneU:
+            case SimdOp::I16x8ExtractLaneS:
+            case SimdOp::I16x8ExtractLaneU:
+            case SimdOp::I32x4ExtractLane:
+            case SimdOp::F32x4ExtractLane:
+              WASM_SIMD_OP(OpKind::ExtractLane);
+            case SimdOp::I8x16ReplaceLane:
+            case SimdOp::I16x8ReplaceLane:
+            case SimdOp::I32x4ReplaceLane:
+            case SimdOp::F32x4ReplaceLane:
+              WASM_SIMD_OP(OpKind::ReplaceLane);
+            case SimdOp::V128Not:
+            case SimdOp::I8x16Neg:
+            case SimdOp::I16x8Neg:
+            case SimdOp::I32x4Neg:
+            case SimdOp::F32x4Abs:
+            case SimdOp::F32x4Neg:
+            case SimdOp::F32x4Sqrt:
+              WASM_SIMD_OP(OpKind::Unary);
+            case SimdOp::I8x16Swizzle:
+            case SimdOp::I8x16Eq:
+            case SimdOp::I16x8Eq:
+            case SimdOp::I32x4Eq:
+            case SimdOp::F32x4Eq:
+            case SimdOp::V128And:
+            case SimdOp::V128AndNot:
+            case SimdOp::V128Or:
+            case SimdOp::V128Xor:
+            case SimdOp::I8x16Add:
+            case SimdOp::I8x16AddSatS:
+            case SimdOp::I8x16AddSatU:
+            case SimdOp::I8x16Sub:
+            case SimdOp::I8x16SubSatS:
+            case SimdOp::I8x16SubSatU:
+            case SimdOp::I16x8Add:
+            case SimdOp::I16x8AddSatS:
+            case SimdOp::I16x8AddSatU:
+            case SimdOp::I16x8Sub:
+            case SimdOp::I16x8SubSatS:
+            case SimdOp::I16x8SubSatU:
+            case SimdOp::I16x8Mul:
+            case SimdOp::I32x4Add:
+            case SimdOp::I32x4Sub:
+            case SimdOp::I32x4Mul:
+            case SimdOp::F32x4Add:
+            case SimdOp::F32x4Sub:
+            case SimdOp::F32x4Mul:
+            case SimdOp::F32x4Div:
+              WASM_SIMD_OP(OpKind::Binary);
+          }
+          break;
+      }
       case Op::ThreadPrefix: {
           switch (ThreadOp(op.b1)) {
             case ThreadOp::Limit:
@@ -429,5 +505,6 @@ wasm::Classify(OpBytes op)
 # undef WASM_GC_OP
 # undef WASM_BULK_OP
 # undef WASM_THREAD_OP
+# undef WASM_SIMD_OP
 
 #endif
@@ -51,6 +51,7 @@ class StackType
           case TypeCode::I64:
           case TypeCode::F32:
           case TypeCode::F64:
+          case TypeCode::V128:
           case TypeCode::AnyRef:
           case TypeCode::Ref:
           case TypeCode::Limit:
@@ -67,6 +68,7 @@ class StackType
         I64    = uint8_t(ValType::I64),
         F32    = uint8_t(ValType::F32),
         F64    = uint8_t(ValType::F64),
+        V128   = uint8_t(ValType::V128),
 
         AnyRef = uint8_t(ValType::AnyRef),
         Ref    = uint8_t(ValType::Ref),
@@ -143,6 +145,7 @@ enum class OpKind {
     I64,
     F32,
     F64,
+    V128,
     Br,
     BrIf,
     BrTable,
@@ -540,6 +543,7 @@ class MOZ_STACK_CLASS OpIter : private Policy
     MOZ_MUST_USE bool readI64Const(int64_t* i64);
     MOZ_MUST_USE bool readF32Const(float* f32);
     MOZ_MUST_USE bool readF64Const(double* f64);
+    MOZ_MUST_USE bool readV128Const(V128* v128);
     MOZ_MUST_USE bool readRefNull(ValType* type);
     MOZ_MUST_USE bool readCall(uint32_t* calleeIndex, ValueVector* argValues);
     MOZ_MUST_USE bool readCallIndirect(uint32_t* funcTypeIndex, Value* callee, ValueVector* argValues);
@@ -579,6 +583,12 @@ class MOZ_STACK_CLASS OpIter : private Policy
     MOZ_MUST_USE bool readStructSet(uint32_t* typeIndex, uint32_t* fieldIndex, Value* ptr, Value* val);
     MOZ_MUST_USE bool readStructNarrow(ValType* inputType, ValType* outputType, Value* ptr);
     MOZ_MUST_USE bool readReferenceType(ValType* type, const char* const context);
+    MOZ_MUST_USE bool readExtractLane(ValType resultType, uint32_t numLanes, uint32_t* lane,
+                                      Value* input);
+    MOZ_MUST_USE bool readReplaceLane(ValType operandType, uint32_t numLanes, uint32_t* lane,
+                                      Value* vector, Value* operand);
+    MOZ_MUST_USE bool readSplat(ValType operandType, Value* operand);
+    MOZ_MUST_USE bool readShuffle(Value* lhs, Value* rhs, V128* lanes);
 
     // At a location where readOp is allowed, peek at the next opcode
     // without consuming it or updating any internal state.
@@ -955,6 +965,9 @@ OpIter<Policy>::readBlockType(ExprType* type)
       case uint8_t(ExprType::AnyRef):
         known = env_.gcTypesEnabled() == HasGcTypes::True;
         break;
+      case uint8_t(ExprType::V128):
+        known = env_.simdEnabled();
+        break;
       case uint8_t(ExprType::Limit):
         break;
     }
@@ -1696,6 +1709,21 @@ OpIter<Policy>::readF64Const(double* f64)
            push(ValType::F64);
 }
 
+template <typename Policy>
+inline bool
+OpIter<Policy>::readV128Const(V128* v128)
+{
+    MOZ_ASSERT(Classify(op_) == OpKind::V128);
+
+    for (uint8_t& byte : v128->bytes) {
+        if (!readFixedU8(&byte)) {
+            return fail("unable to read V128 constant");
+        }
+    }
+
+    return push(ValType::V128);
+}
+
 template <typename Policy>
 inline bool
 OpIter<Policy>::readRefNull(ValType* type)
@@ -2357,6 +2385,105 @@ OpIter<Policy>::readStructNarrow(ValType* inputType, ValType* outputType, Value*
     return push(*outputType);
 }
 
+template <typename Policy>
+inline bool
+OpIter<Policy>::readExtractLane(ValType resultType, uint32_t numLanes, uint32_t* lane,
+                                Value* input)
+{
+    MOZ_ASSERT(Classify(op_) == OpKind::ExtractLane);
+
+    uint8_t laneByte;
+    if (!readFixedU8(&laneByte)) {
+        return fail("unable to read lane index");
+    }
+    if (laneByte >= numLanes) {
+        return fail("lane index out of range");
+    }
+    *lane = laneByte;
+
+    if (!popWithType(ValType::V128, input)) {
+        return false;
+    }
+
+    infalliblePush(resultType);
+
+    return true;
+}
+
+template <typename Policy>
+inline bool
+OpIter<Policy>::readReplaceLane(ValType operandType, uint32_t numLanes, uint32_t* lane,
+                                Value* vector, Value* operand)
+{
+    MOZ_ASSERT(Classify(op_) == OpKind::ReplaceLane);
+
+    uint8_t laneByte;
+    if (!readFixedU8(&laneByte)) {
+        return fail("unable to read lane index");
+    }
+    if (laneByte >= numLanes) {
+        return fail("lane index out of range");
+    }
+    *lane = laneByte;
+
+    if (!popWithType(operandType, operand)) {
+        return false;
+    }
+
+    if (!popWithType(ValType::V128, vector)) {
+        return false;
+    }
+
+    infalliblePush(ValType::V128);
+
+    return true;
+}
+
+template <typename Policy>
+inline bool
+OpIter<Policy>::readSplat(ValType operandType, Value* operand)
+{
+    MOZ_ASSERT(Classify(op_) == OpKind::Splat);
+
+    if (!popWithType(operandType, operand)) {
+        return false;
+    }
+
+    infalliblePush(ValType::V128);
+
+    return true;
+}
+
+template <typename Policy>
+inline bool
+OpIter<Policy>::readShuffle(Value* lhs, Value* rhs, V128* lanes)
+{
+    MOZ_ASSERT(Classify(op_) == OpKind::Shuffle);
+
+    // Each lane index selects one of the 32 bytes of the concatenation of the
+    // two operands.
+    for (uint8_t& lane : lanes->bytes) {
+        if (!readFixedU8(&lane)) {
+            return fail("unable to read shuffle lane index");
+        }
+        if (lane >= 32) {
+            return fail("shuffle lane index out of range");
+        }
+    }
+
+    if (!popWithType(ValType::V128, rhs)) {
+        return false;
+    }
+
+    if (!popWithType(ValType::V128, lhs)) {
+        return false;
+    }
+
+    infalliblePush(ValType::V128);
+
+    return true;
+}
+
 } // namespace wasm
 } // namespace js
 
@@ -22,6 +22,8 @@
 #include "mozilla/ScopeExit.h"
 #include "mozilla/ThreadLocal.h"
 
+#include "gc/Memory.h"
+#include "jit/MacroAssembler.h"
 #include "vm/Runtime.h"
 #include "wasm/WasmInstance.h"
 
@@ -429,11 +431,38 @@ struct AutoHandlingTrap
     }
 };
 
+// Ion code polls for interrupts by reading JSContext::interruptPollPage(),
+// which requestInterrupt makes inaccessible. Resume a faulting poll at the out
+// of line interrupt check it's linked to.
 static MOZ_MUST_USE bool
-HandleTrap(CONTEXT* context, JSContext* cx)
+HandleInterruptPoll(CONTEXT* context, JSContext* cx, uint8_t* faultAddr)
+{
+#ifdef JS_CODEGEN_X64
+    uint8_t* page = static_cast<uint8_t*>(cx->interruptPollPage());
+    if (!page || faultAddr < page || faultAddr >= page + gc::SystemAllocGranularity()) {
+        return false;
+    }
+
+    // Only polls read the page, so the faulting instruction is one.
+    uint8_t** ppc = ContextToPC(context);
+    uint8_t* target = jit::Assembler::InterruptPollTarget(*ppc);
+    MOZ_RELEASE_ASSERT(target, "only interrupt polls read the poll page");
+    *ppc = target;
+    return true;
+#else
+    return false;
+#endif
+}
+
+static MOZ_MUST_USE bool
+HandleTrap(CONTEXT* context, JSContext* cx, uint8_t* faultAddr)
 {
     MOZ_ASSERT(sAlreadyHandlingTrap.get());
 
+    if (cx && HandleInterruptPoll(context, cx, faultAddr)) {
+        return true;
+    }
+
     uint8_t* pc = *ContextToPC(context);
     const CodeSegment* codeSegment = LookupCodeSegment(pc);
     if (!codeSegment || !codeSegment->isModule()) {
@@ -480,7 +509,11 @@ WasmTrapHandler(LPEXCEPTION_POINTERS exception)
         return EXCEPTION_CONTINUE_SEARCH;
     }
 
-    if (!HandleTrap(exception->ContextRecord, TlsContext.get())) {
+    uint8_t* faultAddr = nullptr;
+    if (record->ExceptionCode == EXCEPTION_ACCESS_VIOLATION) {
+        faultAddr = reinterpret_cast<uint8_t*>(record->ExceptionInformation[1]);
+    }
+    if (!HandleTrap(exception->ContextRecord, TlsContext.get(), faultAddr)) {
         return EXCEPTION_CONTINUE_SEARCH;
     }
 
@@ -561,7 +594,8 @@ HandleMachException(JSContext* cx, const ExceptionRequest& request)
     {
         AutoNoteSingleThreadedRegion anstr;
         AutoHandlingTrap aht;
-        if (!HandleTrap(&context, cx)) {
+        uint8_t* faultAddr = reinterpret_cast<uint8_t*>(request.body.code[1]);
+        if (!HandleTrap(&context, cx, faultAddr)) {
             return false;
         }
     }
@@ -751,7 +785,7 @@ WasmTrapHandler(int signum, siginfo_t* info, void* context)
     if (!sAlreadyHandlingTrap.get()) {
         AutoHandlingTrap aht;
         MOZ_RELEASE_ASSERT(signum == SIGSEGV || signum == SIGBUS || signum == kWasmTrapSignal);
-        if (HandleTrap((CONTEXT*)context, TlsContext.get())) {
+        if (HandleTrap((CONTEXT*)context, TlsContext.get(), (uint8_t*)info->si_addr)) {
             return;
         }
     }
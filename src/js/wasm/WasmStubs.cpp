@@ -180,6 +180,8 @@ StoreABIReturn(MacroAssembler& masm, const FuncExport& fe, Register argv)
       case ExprType::AnyRef:
         masm.storePtr(ReturnReg, Address(argv, 0));
         break;
+      case ExprType::V128:
+        MOZ_CRASH("v128 is not allowed in signatures");
       case ExprType::Limit:
         MOZ_CRASH("Limit");
     }
@@ -797,6 +799,8 @@ GenerateJitEntry(MacroAssembler& masm, size_t funcExportIndex, const FuncExport&
         break;
       case ExprType::I64:
         MOZ_CRASH("unexpected return type when calling from ion to wasm");
+      case ExprType::V128:
+        MOZ_CRASH("v128 is not allowed in signatures");
       case ExprType::Limit:
         MOZ_CRASH("Limit");
     }
@@ -1008,6 +1012,7 @@ wasm::GenerateDirectCallFromJit(MacroAssembler& masm,
       case wasm::ExprType::Ref:
       case wasm::ExprType::AnyRef:
       case wasm::ExprType::I64:
+      case wasm::ExprType::V128:
         MOZ_CRASH("unexpected return type when calling from ion to wasm");
       case wasm::ExprType::Limit:
         MOZ_CRASH("Limit");
@@ -1168,7 +1173,7 @@ GenerateImportFunction(jit::MacroAssembler& masm, const FuncImport& fi, FuncType
 {
     AssertExpectedSP(masm);
 
-    GenerateFunctionPrologue(masm, funcTypeId, Nothing(), offsets);
+    GenerateFunctionPrologue(masm, funcTypeId, Nothing(), Nothing(), offsets);
 
     MOZ_ASSERT(masm.framePushed() == 0);
     unsigned framePushed = StackDecrementForCall(WasmStackAlignment,
@@ -1349,6 +1354,8 @@ GenerateImportInterpExit(MacroAssembler& masm, const FuncImport& fi, uint32_t fu
         masm.branchTest32(Assembler::Zero, ReturnReg, ReturnReg, throwLabel);
         masm.loadPtr(argv, ReturnReg);
         break;
+      case ExprType::V128:
+        MOZ_CRASH("v128 is not allowed in signatures");
       case ExprType::Limit:
         MOZ_CRASH("Limit");
     }
@@ -1522,6 +1529,8 @@ GenerateImportJitExit(MacroAssembler& masm, const FuncImport& fi, Label* throwLa
       case ExprType::AnyRef:
         MOZ_CRASH("anyref returned by import (jit exit) NYI");
         break;
+      case ExprType::V128:
+        MOZ_CRASH("v128 is not allowed in signatures");
       case ExprType::Limit:
         MOZ_CRASH("Limit");
     }
@@ -1727,10 +1736,11 @@ static const LiveRegisterSet RegsToPreserve(
     FloatRegisterSet(FloatRegisters::AllDoubleMask));
 static_assert(!SupportsSimd, "high lanes of SIMD registers need to be saved too");
 #else
+// With SIMD the full 128 bits of every register are saved, PushRegsInMask uses
+// unaligned stores for them.
 static const LiveRegisterSet RegsToPreserve(
     GeneralRegisterSet(Registers::AllMask & ~(uint32_t(1) << Registers::StackPointer)),
-    FloatRegisterSet(FloatRegisters::AllDoubleMask));
-static_assert(!SupportsSimd, "high lanes of SIMD registers need to be saved too");
+    FloatRegisterSet(SupportsSimd ? FloatRegisters::AllMask : FloatRegisters::AllDoubleMask));
 #endif
 
 // Generate a stub which calls WasmReportTrap() and can be executed by having
@@ -70,6 +70,7 @@ Val::Val(const LitVal& val)
       case ValType::F64: u.f64_ = val.f64(); return;
       case ValType::Ref:
       case ValType::AnyRef: u.ptr_ = val.ptr(); return;
+      case ValType::V128:   break;
     }
     MOZ_CRASH();
 }
@@ -101,6 +102,8 @@ Val::writePayload(uint8_t* dst) const
             JSObject::writeBarrierPost((JSObject**)dst, nullptr, u.ptr_);
         }
         return;
+      case ValType::V128:
+        break;
     }
     MOZ_CRASH("unexpected Val type");
 }
@@ -200,6 +203,7 @@ IsImmediateType(ValType vt)
       case ValType::F64:
       case ValType::AnyRef:
         return true;
+      case ValType::V128:
       case ValType::Ref:
         return false;
     }
@@ -221,6 +225,7 @@ EncodeImmediateType(ValType vt)
         return 3;
       case ValType::AnyRef:
         return 4;
+      case ValType::V128:
       case ValType::Ref:
         break;
     }
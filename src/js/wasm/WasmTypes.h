@@ -291,6 +291,7 @@ class ExprType
           case TypeCode::I64:
           case TypeCode::F32:
           case TypeCode::F64:
+          case TypeCode::V128:
           case TypeCode::AnyRef:
           case TypeCode::Ref:
           case TypeCode::BlockVoid:
@@ -310,6 +311,7 @@ class ExprType
         I64    = uint8_t(TypeCode::I64),
         F32    = uint8_t(TypeCode::F32),
         F64    = uint8_t(TypeCode::F64),
+        V128   = uint8_t(TypeCode::V128),
         AnyRef = uint8_t(TypeCode::AnyRef),
         Ref    = uint8_t(TypeCode::Ref),
 
@@ -401,6 +403,7 @@ class ValType
           case TypeCode::I64:
           case TypeCode::F32:
           case TypeCode::F64:
+          case TypeCode::V128:
           case TypeCode::AnyRef:
           case TypeCode::Ref:
             return true;
@@ -416,6 +419,7 @@ class ValType
         I64    = uint8_t(TypeCode::I64),
         F32    = uint8_t(TypeCode::F32),
         F64    = uint8_t(TypeCode::F64),
+        V128   = uint8_t(TypeCode::V128),
 
         AnyRef = uint8_t(TypeCode::AnyRef),
         Ref    = uint8_t(TypeCode::Ref),
@@ -512,6 +516,8 @@ SizeOf(ValType vt)
       case ValType::I64:
       case ValType::F64:
         return 8;
+      case ValType::V128:
+        return 16;
       case ValType::AnyRef:
       case ValType::Ref:
         return sizeof(intptr_t);
@@ -527,6 +533,9 @@ ToMIRType(ValType vt)
       case ValType::I64:    return jit::MIRType::Int64;
       case ValType::F32:    return jit::MIRType::Float32;
       case ValType::F64:    return jit::MIRType::Double;
+      // Ion's register allocation already knows how to hold a 128-bit vector
+      // of this type, so all v128 values use it whatever their lane shape.
+      case ValType::V128:   return jit::MIRType::Int32x4;
       case ValType::Ref:    return jit::MIRType::Pointer;
       case ValType::AnyRef: return jit::MIRType::Pointer;
     }
@@ -539,6 +548,14 @@ IsNumberType(ValType vt)
     return !vt.isRefOrAnyRef();
 }
 
+// A V128 holds the bits of a 128-bit SIMD value in the order in which
+// v128.const encodes them, lane 0 first.
+
+struct V128
+{
+    uint8_t bytes[16];
+};
+
 // ExprType utilities
 
 inline
@@ -574,6 +591,7 @@ ToCString(ExprType type)
       case ExprType::I64:     return "i64";
       case ExprType::F32:     return "f32";
       case ExprType::F64:     return "f64";
+      case ExprType::V128:    return "v128";
       case ExprType::AnyRef:  return "anyref";
       case ExprType::Ref:     return "ref";
       case ExprType::Limit:;
@@ -1972,6 +1990,13 @@ struct TableDesc
     uint32_t globalDataOffset;
     Limits limits;
 
+    // If a table is not external and all the functions in the element segments
+    // have the same signature, uniformFuncIndex is one of those functions and
+    // otherwise it is UINT32_MAX. The elements of a uniform table point at the
+    // functions' normal entries, which skip the signature check, and
+    // call_indirect checks the signature statically at the call site instead.
+    uint32_t uniformFuncIndex;
+
     TableDesc() = default;
     TableDesc(TableKind kind, const Limits& limits)
      : kind(kind),
@@ -1980,8 +2005,13 @@ struct TableDesc
 #endif
        external(false),
        globalDataOffset(UINT32_MAX),
-       limits(limits)
+       limits(limits),
+       uniformFuncIndex(UINT32_MAX)
     {}
+
+    bool isUniform() const {
+        return uniformFuncIndex != UINT32_MAX;
+    }
 };
 
 typedef Vector<TableDesc, 0, SystemAllocPolicy> TableDescVector;
@@ -2038,6 +2068,11 @@ struct TlsData
     // baseline-compiled function.
     void** jumpTable;
 
+    // When compiling with tiering and tier-2 compilation has been deferred,
+    // baseline code decrements this counter on function entry and at loop
+    // headers, and traps with Trap::CheckTierUp when it becomes negative.
+    int32_t tierUpCounter;
+
     // The globalArea must be the last field.  Globals for the module start here
     // and are inline in this structure.  16-byte alignment is required for SIMD
     // data.
@@ -2128,6 +2163,17 @@ struct ExternalTableElem
     TlsData* tls;
 };
 
+// How the signature of a call_indirect through a wasm table is checked. The
+// signature is checked by the callee's table entry unless the table is uniform,
+// in which case the check succeeds or fails statically.
+
+enum class TableSigCheck
+{
+    Dynamic,
+    StaticSuccess,
+    StaticFailure
+};
+
 // CalleeDesc describes how to compile one of the variety of asm.js/wasm calls.
 // This is hoisted into WasmTypes.h for sharing between Ion and Baseline.
 
@@ -2169,6 +2215,7 @@ class CalleeDesc
             uint32_t globalDataOffset_;
             uint32_t minLength_;
             bool external_;
+            TableSigCheck sigCheck_;
             FuncTypeIdDesc funcTypeId_;
         } table;
         SymbolicAddress builtin_;
@@ -2188,12 +2235,14 @@ class CalleeDesc
         c.u.import.globalDataOffset_ = globalDataOffset;
         return c;
     }
-    static CalleeDesc wasmTable(const TableDesc& desc, FuncTypeIdDesc funcTypeId) {
+    static CalleeDesc wasmTable(const TableDesc& desc, FuncTypeIdDesc funcTypeId,
+                                TableSigCheck sigCheck) {
         CalleeDesc c;
         c.which_ = WasmTable;
         c.u.table.globalDataOffset_ = desc.globalDataOffset;
         c.u.table.minLength_ = desc.limits.initial;
         c.u.table.external_ = desc.external;
+        c.u.table.sigCheck_ = sigCheck;
         c.u.table.funcTypeId_ = funcTypeId;
         return c;
     }
@@ -2241,6 +2290,10 @@ class CalleeDesc
         MOZ_ASSERT(which_ == WasmTable);
         return u.table.external_;
     }
+    TableSigCheck wasmTableSigCheck() const {
+        MOZ_ASSERT(which_ == WasmTable);
+        return u.table.sigCheck_;
+    }
     FuncTypeIdDesc wasmTableSigId() const {
         MOZ_ASSERT(which_ == WasmTable);
         return u.table.funcTypeId_;
@@ -416,9 +416,12 @@ wasm::EncodeLocalEntries(Encoder& e, const ValTypeVector& locals)
     return true;
 }
 
+// v128 is only accepted for locals; the other uses of a value type (function
+// signatures, globals and struct fields) would need 128-bit support in the
+// stubs and in the runtime.
 static bool
 DecodeValType(Decoder& d, ModuleKind kind, uint32_t numTypes, HasGcTypes gcTypesEnabled,
-              ValType* type)
+              ValType* type, bool simdEnabled = false)
 {
     uint8_t uncheckedCode;
     uint32_t uncheckedRefTypeIndex;
@@ -450,6 +453,12 @@ DecodeValType(Decoder& d, ModuleKind kind, uint32_t numTypes, HasGcTypes gcTypes
         *type = ValType(ValType::Code(uncheckedCode), uncheckedRefTypeIndex);
         return true;
       }
+      case uint8_t(ValType::V128):
+        if (!simdEnabled) {
+            break;
+        }
+        *type = ValType::V128;
+        return true;
       default:
         break;
     }
@@ -467,7 +476,7 @@ ValidateRefType(Decoder& d, const TypeDefVector& types, ValType type)
 
 bool
 wasm::DecodeLocalEntries(Decoder& d, ModuleKind kind, const TypeDefVector& types,
-                         HasGcTypes gcTypesEnabled, ValTypeVector* locals)
+                         HasGcTypes gcTypesEnabled, bool simdEnabled, ValTypeVector* locals)
 {
     uint32_t numLocalEntries;
     if (!d.readVarU32(&numLocalEntries)) {
@@ -485,7 +494,7 @@ wasm::DecodeLocalEntries(Decoder& d, ModuleKind kind, const TypeDefVector& types
         }
 
         ValType type;
-        if (!DecodeValType(d, kind, types.length(), gcTypesEnabled, &type)) {
+        if (!DecodeValType(d, kind, types.length(), gcTypesEnabled, &type, simdEnabled)) {
             return false;
         }
         if (!ValidateRefType(d, types, type)) {
@@ -990,6 +999,112 @@ DecodeFunctionBodyExprs(const ModuleEnvironment& env, const FuncType& funcType,
             CHECK(iter.readConversion(ValType::AnyRef, ValType::I32, &nothing));
             break;
           }
+#endif
+#ifdef ENABLE_WASM_SIMD
+          case uint16_t(Op::SimdPrefix): {
+            if (!env.simdEnabled()) {
+                return iter.unrecognizedOpcode(&op);
+            }
+            switch (op.b1) {
+              case uint16_t(SimdOp::V128Load): {
+                LinearMemoryAddress<Nothing> addr;
+                CHECK(iter.readLoad(ValType::V128, 16, &addr));
+              }
+              case uint16_t(SimdOp::V128Store): {
+                LinearMemoryAddress<Nothing> addr;
+                CHECK(iter.readStore(ValType::V128, 16, &addr, &nothing));
+              }
+              case uint16_t(SimdOp::V128Const): {
+                V128 unused;
+                CHECK(iter.readV128Const(&unused));
+              }
+              case uint16_t(SimdOp::I8x16Shuffle): {
+                V128 unusedLanes;
+                CHECK(iter.readShuffle(&nothing, &nothing, &unusedLanes));
+              }
+              case uint16_t(SimdOp::I8x16Splat):
+              case uint16_t(SimdOp::I16x8Splat):
+              case uint16_t(SimdOp::I32x4Splat):
+                CHECK(iter.readSplat(ValType::I32, &nothing));
+              case uint16_t(SimdOp::F32x4Splat):
+                CHECK(iter.readSplat(ValType::F32, &nothing));
+              case uint16_t(SimdOp::I8x16ExtractLaneS):
+              case uint16_t(SimdOp::I8x16ExtractLaneU): {
+                uint32_t unusedLane;
+                CHECK(iter.readExtractLane(ValType::I32, 16, &unusedLane, &nothing));
+              }
+              case uint16_t(SimdOp::I16x8ExtractLaneS):
+              case uint16_t(SimdOp::I16x8ExtractLaneU): {
+                uint32_t unusedLane;
+                CHECK(iter.readExtractLane(ValType::I32, 8, &unusedLane, &nothing));
+              }
+              case uint16_t(SimdOp::I32x4ExtractLane): {
+                uint32_t unusedLane;
+                CHECK(iter.readExtractLane(ValType::I32, 4, &unusedLane, &nothing));
+              }
+              case uint16_t(SimdOp::F32x4ExtractLane): {
+                uint32_t unusedLane;
+                CHECK(iter.readExtractLane(ValType::F32, 4, &unusedLane, &nothing));
+              }
+              case uint16_t(SimdOp::I8x16ReplaceLane): {
+                uint32_t unusedLane;
+                CHECK(iter.readReplaceLane(ValType::I32, 16, &unusedLane, &nothing, &nothing));
+              }
+              case uint16_t(SimdOp::I16x8ReplaceLane): {
+                uint32_t unusedLane;
+                CHECK(iter.readReplaceLane(ValType::I32, 8, &unusedLane, &nothing, &nothing));
+              }
+              case uint16_t(SimdOp::I32x4ReplaceLane): {
+                uint32_t unusedLane;
+                CHECK(iter.readReplaceLane(ValType::I32, 4, &unusedLane, &nothing, &nothing));
+              }
+              case uint16_t(SimdOp::F32x4ReplaceLane): {
+                uint32_t unusedLane;
+                CHECK(iter.readReplaceLane(ValType::F32, 4, &unusedLane, &nothing, &nothing));
+              }
+              case uint16_t(SimdOp::V128Not):
+              case uint16_t(SimdOp::I8x16Neg):
+              case uint16_t(SimdOp::I16x8Neg):
+              case uint16_t(SimdOp::I32x4Neg):
+              case uint16_t(SimdOp::F32x4Abs):
+              case uint16_t(SimdOp::F32x4Neg):
+              case uint16_t(SimdOp::F32x4Sqrt):
+                CHECK(iter.readUnary(ValType::V128, &nothing));
+              case uint16_t(SimdOp::I8x16Swizzle):
+              case uint16_t(SimdOp::I8x16Eq):
+              case uint16_t(SimdOp::I16x8Eq):
+              case uint16_t(SimdOp::I32x4Eq):
+              case uint16_t(SimdOp::F32x4Eq):
+              case uint16_t(SimdOp::V128And):
+              case uint16_t(SimdOp::V128AndNot):
+              case uint16_t(SimdOp::V128Or):
+              case uint16_t(SimdOp::V128Xor):
+              case uint16_t(SimdOp::I8x16Add):
+              case uint16_t(SimdOp::I8x16AddSatS):
+              case uint16_t(SimdOp::I8x16AddSatU):
+              case uint16_t(SimdOp::I8x16Sub):
+              case uint16_t(SimdOp::I8x16SubSatS):
+              case uint16_t(SimdOp::I8x16SubSatU):
+              case uint16_t(SimdOp::I16x8Add):
+              case uint16_t(SimdOp::I16x8AddSatS):
+              case uint16_t(SimdOp::I16x8AddSatU):
+              case uint16_t(SimdOp::I16x8Sub):
+              case uint16_t(SimdOp::I16x8SubSatS):
+              case uint16_t(SimdOp::I16x8SubSatU):
+              case uint16_t(SimdOp::I16x8Mul):
+              case uint16_t(SimdOp::I32x4Add):
+              case uint16_t(SimdOp::I32x4Sub):
+              case uint16_t(SimdOp::I32x4Mul):
+              case uint16_t(SimdOp::F32x4Add):
+              case uint16_t(SimdOp::F32x4Sub):
+              case uint16_t(SimdOp::F32x4Mul):
+              case uint16_t(SimdOp::F32x4Div):
+                CHECK(iter.readBinary(ValType::V128, &nothing, &nothing));
+              default:
+                return iter.unrecognizedOpcode(&op);
+            }
+            break;
+          }
 #endif
           case uint16_t(Op::ThreadPrefix): {
 #ifdef ENABLE_WASM_THREAD_OPS
@@ -1186,7 +1301,8 @@ wasm::ValidateFunctionBody(const ModuleEnvironment& env, uint32_t funcIndex, uin
 
     const uint8_t* bodyBegin = d.currentPosition();
 
-    if (!DecodeLocalEntries(d, ModuleKind::Wasm, env.types, env.gcTypesEnabled(), &locals)) {
+    if (!DecodeLocalEntries(d, ModuleKind::Wasm, env.types, env.gcTypesEnabled(),
+                            env.simdEnabled(), &locals)) {
         return false;
     }
 
@@ -2262,6 +2378,25 @@ DecodeStartSection(Decoder& d, ModuleEnvironment* env)
     return d.finishSection(*range, "start");
 }
 
+// Returns a function whose signature is shared by all the functions in the
+// element segments, or UINT32_MAX if there is no such function. Passive
+// segments are included since table.init may store their elements.
+static uint32_t
+UniformElemFuncIndex(const ModuleEnvironment& env)
+{
+    uint32_t uniformFuncIndex = UINT32_MAX;
+    for (const SharedElemSegment& seg : env.elemSegments) {
+        for (uint32_t funcIndex : seg->elemFuncIndices) {
+            if (uniformFuncIndex == UINT32_MAX) {
+                uniformFuncIndex = funcIndex;
+            } else if (*env.funcTypes[funcIndex] != *env.funcTypes[uniformFuncIndex]) {
+                return UINT32_MAX;
+            }
+        }
+    }
+    return uniformFuncIndex;
+}
+
 static bool
 DecodeElemSection(Decoder& d, ModuleEnvironment* env)
 {
@@ -2380,6 +2515,16 @@ DecodeElemSection(Decoder& d, ModuleEnvironment* env)
         env->elemSegments.infallibleAppend(std::move(seg));
     }
 
+    // If every function which can be stored in an internal table has the same
+    // signature, the signature of a call_indirect through the table can be
+    // checked at compile time. Cranelift always emits the dynamic check, so it
+    // needs the elements to point at the callees' table entries.
+    if (env->tables.length() == 1 && !env->tables[0].external &&
+        env->optimizedBackend() != OptimizedBackend::Cranelift)
+    {
+        env->tables[0].uniformFuncIndex = UniformElemFuncIndex(*env);
+    }
+
     return d.finishSection(*range, "elem");
 }
 
@@ -78,6 +78,7 @@ struct CompilerEnvironment
             OptimizedBackend optimizedBackend_;
             DebugEnabled     debug_;
             HasGcTypes       gcTypes_;
+            bool             simd_;
         };
     };
 
@@ -126,6 +127,10 @@ struct CompilerEnvironment
         MOZ_ASSERT(isComputed());
         return gcTypes_;
     }
+    bool simd() const {
+        MOZ_ASSERT(isComputed());
+        return simd_;
+    }
 };
 
 // ModuleEnvironment contains all the state necessary to process or render
@@ -183,6 +188,7 @@ struct ModuleEnvironment
     Maybe<uint32_t>           startFuncIndex;
     ElemSegmentVector         elemSegments;
     MaybeSectionRange         codeSection;
+    Maybe<uint32_t>           funcCallCountsGlobalDataOffset;
 
     // Fields decoded as part of the wasm module tail:
     DataSegmentEnvVector      dataSegments;
@@ -237,6 +243,9 @@ struct ModuleEnvironment
     HasGcTypes gcTypesEnabled() const {
         return compilerEnv->gcTypes();
     }
+    bool simdEnabled() const {
+        return compilerEnv->simd();
+    }
     bool usesMemory() const {
         return memoryUsage != MemoryUsage::None;
     }
@@ -252,6 +261,22 @@ struct ModuleEnvironment
     bool funcIsImport(uint32_t funcIndex) const {
         return funcIndex < funcImportGlobalDataOffsets.length();
     }
+    Maybe<uint32_t> funcCallCountGlobalDataOffset(uint32_t funcIndex) const {
+        if (!funcCallCountsGlobalDataOffset) {
+            return Nothing();
+        }
+        MOZ_ASSERT(!funcIsImport(funcIndex));
+        return Some(*funcCallCountsGlobalDataOffset +
+                    uint32_t(funcIndex - numFuncImports()) * sizeof(uint32_t));
+    }
+    TableSigCheck tableSigCheck(const TableDesc& table, const FuncType& funcType) const {
+        if (!table.isUniform()) {
+            return TableSigCheck::Dynamic;
+        }
+        return funcType == *funcTypes[table.uniformFuncIndex]
+               ? TableSigCheck::StaticSuccess
+               : TableSigCheck::StaticFailure;
+    }
 };
 
 // The Encoder class appends bytes to the Bytes object it is given during
@@ -744,6 +769,17 @@ class Decoder
         if (MOZ_LIKELY(!IsPrefixByte(u8))) {
             return true;
         }
+        if (u8 == uint8_t(Op::SimdPrefix)) {
+            // SIMD opcodes are a varU32 rather than a single byte.
+            static_assert(size_t(SimdOp::Limit) <= UINT16_MAX, "fits");
+            uint32_t u32;
+            if (!readVarU32(&u32) || u32 >= uint32_t(SimdOp::Limit)) {
+                op->b1 = 0;     // Make it sane
+                return false;
+            }
+            op->b1 = uint16_t(u32);
+            return true;
+        }
         if (!readFixedU8(&u8)) {
             op->b1 = 0;         // Make it sane
             return false;
@@ -880,7 +916,7 @@ DecodeValidatedLocalEntries(Decoder& d, ValTypeVector* locals);
 
 MOZ_MUST_USE bool
 DecodeLocalEntries(Decoder& d, ModuleKind kind, const TypeDefVector& types,
-                   HasGcTypes gcTypesEnabled, ValTypeVector* locals);
+                   HasGcTypes gcTypesEnabled, bool simdEnabled, ValTypeVector* locals);
 
 // Returns whether the given [begin, end) prefix of a module's bytecode starts a
 // code section and, if so, returns the SectionRange of that code section.
@@ -261,6 +261,15 @@ LossyUTF8CharsToNewTwoByteCharsZ(JSContext* cx, const UTF8Chars utf8, size_t* ou
 extern JS_PUBLIC_API(TwoByteCharsZ)
 LossyUTF8CharsToNewTwoByteCharsZ(JSContext* cx, const ConstUTF8CharsZ& utf8, size_t* outlen);
 
+/*
+ * Decode |utf8| into |dst| as LossyUTF8CharsToNewTwoByteCharsZ() does, and
+ * return the number of char16_t written. |dst| must have room for
+ * utf8.length() char16_t, which is the most that can be written. This needs no
+ * JSContext, so it can be used on any thread.
+ */
+extern JS_PUBLIC_API(size_t)
+LossyInflateUTF8ToBuffer(const UTF8Chars utf8, char16_t* dst);
+
 /*
  * Returns the length of the char buffer required to encode |s| as UTF8.
  * Does not include the null-terminator.
@@ -284,6 +293,20 @@ JS_PUBLIC_API(void)
 DeflateStringToUTF8Buffer(JSFlatString* src, mozilla::RangedPtr<char> dst,
                           size_t* dstlenp = nullptr, size_t* numcharsp = nullptr);
 
+/*
+ * Encode as much of |src|, starting at code unit |start|, as UTF8 into the
+ * |dstlen| bytes at |dst| as fits, without computing the encoded length of the
+ * string first. A character is never split between two calls. Does not write
+ * the null terminator.
+ *
+ * Returns the number of code units of |src| which were encoded, so a caller
+ * with a fixed-size buffer can flush it and call again from |start| plus that
+ * number. |*written| is set to the number of bytes written.
+ */
+JS_PUBLIC_API(size_t)
+DeflateStringToUTF8BufferPartial(JSFlatString* src, size_t start, char* dst, size_t dstlen,
+                                 size_t* written);
+
 /*
  * The smallest character encoding capable of fully representing a particular
  * string.
@@ -847,6 +847,12 @@ static const uint32_t JSCLASS_SKIP_NURSERY_FINALIZE =   1 << (JSCLASS_HIGH_FLAGS
 static const uint32_t JSCLASS_USERBIT2 =                1 << (JSCLASS_HIGH_FLAGS_SHIFT + 6);
 static const uint32_t JSCLASS_USERBIT3 =                1 << (JSCLASS_HIGH_FLAGS_SHIFT + 7);
 
+// Classes with a finalize hook, except proxies, must set one of these flags.
+// Objects of a class marked JSCLASS_BACKGROUND_FINALIZE are finalized on a
+// helper thread, so its finalizer must only release memory or resources which
+// are owned by the object and must not touch the runtime, other GC things or
+// any main thread state. Other classes use JSCLASS_FOREGROUND_FINALIZE and are
+// finalized on the main thread while sweeping.
 static const uint32_t JSCLASS_BACKGROUND_FINALIZE =     1 << (JSCLASS_HIGH_FLAGS_SHIFT + 8);
 static const uint32_t JSCLASS_FOREGROUND_FINALIZE =     1 << (JSCLASS_HIGH_FLAGS_SHIFT + 9);
 
@@ -119,6 +119,15 @@ class JS_PUBLIC_API(TransitiveCompileOptions)
     bool isProbablySystemCode = false;
     bool hideScriptFromDebugger = false;
 
+    /**
+     * Inner functions which start before this offset in the source text are
+     * fully compiled along with the script instead of being lazily parsed, so
+     * that their first call does not have to parse them again. Startup code
+     * tends to come first in a script; for an off-thread compilation this
+     * moves its delazification to the helper thread.
+     */
+    uint32_t eagerFunctionsSourceLength = 0;
+
     /**
      * |introductionType| is a statically allocated C string: one of "eval",
      * "Function", or "GeneratorFunction".
@@ -320,6 +329,11 @@ class JS_PUBLIC_API(OwningCompileOptions) final
         return *this;
     }
 
+    OwningCompileOptions& setEagerFunctionsSourceLength(uint32_t length) {
+        eagerFunctionsSourceLength = length;
+        return *this;
+    }
+
     OwningCompileOptions& setNonSyntacticScope(bool n) {
         nonSyntacticScope = n;
         return *this;
@@ -495,6 +509,11 @@ class MOZ_STACK_CLASS JS_PUBLIC_API(CompileOptions) final
         return *this;
     }
 
+    CompileOptions& setEagerFunctionsSourceLength(uint32_t length) {
+        eagerFunctionsSourceLength = length;
+        return *this;
+    }
+
     CompileOptions& setNonSyntacticScope(bool n) {
         nonSyntacticScope = n;
         return *this;
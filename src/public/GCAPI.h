@@ -195,7 +195,8 @@ typedef enum JSGCParamKey {
     JSGC_DYNAMIC_HEAP_GROWTH = 17,
 
     /**
-     * If true, high-frequency GCs will use a longer mark slice.
+     * If true, high-frequency GCs and GCs that have spent many slices marking
+     * will use a longer mark slice.
      *
      * Pref: javascript.options.mem.gc_dynamic_mark_slice
      * Default: DynamicMarkSliceEnabled
@@ -265,6 +266,86 @@ typedef enum JSGCParamKey {
      * Pref: None
      */
     JSGC_NURSERY_FREE_THRESHOLD_FOR_IDLE_COLLECTION = 27,
+
+    /**
+     * Number of threads to use for marking.
+     *
+     * When this is greater than one, black marking of the mark stack is
+     * shared between this many markers running on the main thread and on
+     * GC helper threads. The actual number of markers is also limited by the
+     * number of helper threads available.
+     *
+     * Default: MarkingThreadCount
+     * Pref: None
+     */
+    JSGC_MARKING_THREAD_COUNT = 28,
+
+    /**
+     * Number of threads to use for tenuring during minor GC.
+     *
+     * When this is greater than one and the nursery is large, tracing the
+     * objects promoted during a minor GC is shared between this many tracers
+     * running on the main thread and on GC helper threads. The actual number
+     * of tracers is also limited by the number of helper threads available.
+     *
+     * Default: TenuringThreadCount
+     * Pref: None
+     */
+    JSGC_TENURING_THREAD_COUNT = 29,
+
+    /**
+     * Target pause time for minor GCs in microseconds.
+     *
+     * When this is non-zero the nursery is sized so that collecting it is
+     * expected to take about this long, based on the recent promotion rate
+     * and the rate at which data has been tenured. The size is still limited
+     * by JSGC_MAX_NURSERY_BYTES. When zero the nursery grows and shrinks
+     * based on the promotion rate alone.
+     *
+     * Default: NurseryPauseTarget
+     * Pref: None
+     */
+    JSGC_NURSERY_PAUSE_TARGET = 30,
+
+    /**
+     * Whether the embedding is under memory pressure.
+     *
+     * Setting this to a non-zero value releases empty chunks and decommits
+     * free arenas in the background straight away. While it is set, no empty
+     * chunks are kept in reserve or allocated ahead of time, and free arenas
+     * are decommitted after every GC, even when GCs are frequent. Set it back
+     * to zero when the pressure has passed.
+     *
+     * Default: 0
+     * Pref: None
+     */
+    JSGC_MEMORY_PRESSURE = 31,
+
+    /**
+     * Whether to ask the OS to back newly allocated GC chunks, including
+     * nursery chunks, with huge pages.
+     *
+     * This uses transparent huge pages on Linux and has no effect elsewhere.
+     * The number of chunks for which the request succeeded is reported in the
+     * GC statistics.
+     *
+     * Default: HugePagesEnabled
+     * Pref: None
+     */
+    JSGC_HUGE_PAGES = 32,
+
+    /**
+     * Whether to ask the OS to place newly allocated GC chunks on the NUMA
+     * node the runtime was created on, rather than on the node of whichever
+     * thread first touches them (which may be a helper thread on another
+     * node).
+     *
+     * This only has an effect on Linux systems with more than one node.
+     *
+     * Default: NumaLocalChunksEnabled
+     * Pref: None
+     */
+    JSGC_NUMA_LOCAL_CHUNKS = 33,
 } JSGCParamKey;
 
 /*
@@ -625,6 +706,8 @@ struct JS_PUBLIC_API(GCDescription) {
     char16_t* formatSummaryMessage(JSContext* cx) const;
     char16_t* formatJSON(JSContext* cx, uint64_t timestamp) const;
 
+    // These times come from the engine's instrumentation clock, which can
+    // drift from TimeStamp::Now() by a few parts per million.
     mozilla::TimeStamp startTime(JSContext* cx) const;
     mozilla::TimeStamp endTime(JSContext* cx) const;
     mozilla::TimeStamp lastSliceStart(JSContext* cx) const;
@@ -10,6 +10,8 @@
 #ifndef js_JSON_h
 #define js_JSON_h
 
+#include "mozilla/Vector.h" // mozilla::Vector
+
 #include <stdint.h> // uint32_t
 
 #include "jstypes.h" // JS_PUBLIC_API
@@ -33,6 +35,16 @@ extern JS_PUBLIC_API(bool)
 JS_Stringify(JSContext* cx, JS::MutableHandle<JS::Value> value, JS::Handle<JSObject*> replacer,
              JS::Handle<JS::Value> space, JSONWriteCallback callback, void* data);
 
+/**
+ * Performs the JSON.stringify operation like JS_Stringify, except appending
+ * the result to |out| as UTF-8. This is faster than transcoding the result of
+ * JS_Stringify, as the text is encoded as it is written.
+ */
+extern JS_PUBLIC_API(bool)
+JS_StringifyToUTF8(JSContext* cx, JS::MutableHandle<JS::Value> value,
+                   JS::Handle<JSObject*> replacer, JS::Handle<JS::Value> space,
+                   mozilla::Vector<char>& out);
+
 namespace JS {
 
 /**
@@ -20,6 +20,7 @@
 #include "js/AllocPolicy.h"
 #include "js/HashTable.h"
 #include "js/TracingAPI.h"
+#include "js/UniquePtr.h"
 #include "js/Utility.h"
 #include "js/Vector.h"
 
@@ -169,6 +170,7 @@ struct ClassInfo
     macro(Objects, MallocHeap, objectsMallocHeapMisc) \
     macro(Objects, NonHeap,    objectsNonHeapElementsNormal) \
     macro(Objects, NonHeap,    objectsNonHeapElementsShared) \
+    macro(Objects, NonHeap,    objectsNonHeapElementsMapped) \
     macro(Objects, NonHeap,    objectsNonHeapElementsWasm) \
     macro(Objects, NonHeap,    objectsNonHeapCodeWasm)
 
@@ -827,7 +829,8 @@ struct RealmStats
     macro(Other,   MallocHeap, varNamesSet) \
     macro(Other,   MallocHeap, nonSyntacticLexicalScopesTable) \
     macro(Other,   MallocHeap, jitRealm) \
-    macro(Other,   MallocHeap, scriptCountsMap)
+    macro(Other,   MallocHeap, scriptCountsMap) \
+    macro(Other,   MallocHeap, scriptLineTables)
 
     RealmStats()
       : FOR_EACH_SIZE(ZERO_SIZE)
@@ -1020,6 +1023,87 @@ extern JS_PUBLIC_API(bool)
 AddServoSizeOf(JSContext* cx, mozilla::MallocSizeOf mallocSizeOf,
                ObjectPrivateVisitor* opv, ServoSizes* sizes);
 
+struct SizeEstimate
+{
+    SizeEstimate()
+      : estimate(0), errorBound(0)
+    {}
+
+    size_t estimate;
+
+    // Twice the standard error of |estimate|, so the actual size is within
+    // |errorBound| of |estimate| about 95% of the time.
+    size_t errorBound;
+};
+
+struct ZoneSizeEstimate
+{
+    explicit ZoneSizeEstimate(JS::Zone* zone)
+      : zone(zone), gcHeapArenas(0)
+    {}
+
+    JS::Zone* zone;
+
+    // The size of the zone's arenas, which is exact.
+    size_t gcHeapArenas;
+
+    // The size of the live GC things in those arenas, and of the malloc heap
+    // memory hanging off them.
+    SizeEstimate gcHeapThings;
+    SizeEstimate mallocHeap;
+};
+
+struct RealmSizeEstimate
+{
+    explicit RealmSizeEstimate(JS::Realm* realm)
+      : realm(realm)
+    {}
+
+    JS::Realm* realm;
+
+    // As for ZoneSizeEstimate, for the objects and scripts of the realm.
+    SizeEstimate gcHeapThings;
+    SizeEstimate mallocHeap;
+};
+
+typedef js::Vector<ZoneSizeEstimate, 0, js::SystemAllocPolicy> ZoneSizeEstimateVector;
+typedef js::Vector<RealmSizeEstimate, 0, js::SystemAllocPolicy> RealmSizeEstimateVector;
+
+// A much cheaper, approximate version of CollectRuntimeStats, for reporting
+// the memory used by each zone and realm often. Only a random sample of one
+// in |sampleInterval| of the tenured heap's arenas is measured, and the sizes
+// are scaled up to estimate the totals. The measurement can also be done in
+// slices which each measure a bounded number of arenas, with the mutator
+// running in between.
+//
+// Any major GC starting while the measurement is unfinished discards the
+// progress made, and the measurement waits while incremental GCs are in
+// progress. The nursery is not measured: see RuntimeSizes::gc.
+class JS_PUBLIC_API(SampledHeapStats)
+{
+    struct State;
+
+    mozilla::MallocSizeOf mallocSizeOf_;
+    uint32_t sampleInterval_;
+    js::UniquePtr<State> state_;
+
+    ZoneSizeEstimateVector zones_;
+    RealmSizeEstimateVector realms_;
+
+  public:
+    SampledHeapStats(mozilla::MallocSizeOf mallocSizeOf, uint32_t sampleInterval);
+    ~SampledHeapStats();
+
+    // Measure at most |arenaBudget| more of the sampled arenas, or all of the
+    // remaining ones if |arenaBudget| is zero. |*done| is set once the
+    // results are available. Returns false on OOM.
+    MOZ_MUST_USE bool step(JSContext* cx, size_t arenaBudget, bool* done);
+
+    // The results, which are valid until the next GC.
+    const ZoneSizeEstimateVector& zones() const { return zones_; }
+    const RealmSizeEstimateVector& realms() const { return realms_; }
+};
+
 } // namespace JS
 
 #undef DECL_SIZE
@@ -11,19 +11,26 @@
 #ifndef js_OffThreadScriptCompilation_h
 #define js_OffThreadScriptCompilation_h
 
+#include "mozilla/Attributes.h" // MOZ_MUST_USE
 #include "mozilla/Range.h" // mozilla::Range
 #include "mozilla/Vector.h" // mozilla::Vector
 
 #include <stddef.h> // size_t
+#include <stdint.h> // uint8_t
 
 #include "jstypes.h" // JS_PUBLIC_API
 
+#include "js/AllocPolicy.h" // js::SystemAllocPolicy
 #include "js/CompileOptions.h" // JS::ReadOnlyCompileOptions
 #include "js/GCVector.h" // JS::GCVector
 #include "js/Transcoding.h" // JS::TranscodeSource
+#include "js/TypeDecls.h" // JS::HandleString, JS::MutableHandleValue
+#include "js/Utility.h" // JS::UniqueTwoByteChars
+#include "js/Vector.h" // js::Vector
 
 struct JSContext;
 class JSScript;
+class JSString;
 
 namespace JS {
 
@@ -64,12 +71,114 @@ extern JS_PUBLIC_API(bool)
 CompileOffThread(JSContext* cx, const ReadOnlyCompileOptions& options, SourceBufferHolder& srcBuf,
                  OffThreadCompileCallback callback, void* callbackData);
 
+/*
+ * As CompileOffThread, for UTF-8 source. The source is compiled and stored as
+ * UTF-8, without being inflated to UTF-16 first; malformed UTF-8 is reported as
+ * a syntax error. The |length| bytes at |bytes| must remain live until the
+ * callback is invoked.
+ */
+extern JS_PUBLIC_API(bool)
+CompileOffThreadUtf8(JSContext* cx, const ReadOnlyCompileOptions& options,
+                     const char* bytes, size_t length,
+                     OffThreadCompileCallback callback, void* callbackData);
+
 extern JS_PUBLIC_API(JSScript*)
 FinishOffThreadScript(JSContext* cx, OffThreadToken* token);
 
 extern JS_PUBLIC_API(void)
 CancelOffThreadScript(JSContext* cx, OffThreadToken* token);
 
+/*
+ * Streaming off thread compilation.
+ *
+ * An OffThreadCompileStream collects the source of a script, or the text of a
+ * JSON value, as it arrives, so that it can be parsed off thread as soon as
+ * its last chunk has arrived. UTF-8 chunks are decoded as they are added, so
+ * the decoding overlaps the download. Chunks can end in the middle of a code
+ * point.
+ *
+ * consumeChunk can be called on any thread, though not on several at once.
+ * When the source is complete, call compile (or parseJSON) on the runtime's
+ * main thread to start the parse, which then continues as if CompileOffThread
+ * (or ParseJSONOffThread) had been called: the callback is invoked and the
+ * matching Finish or Cancel function must be called with its token. The parse
+ * owns the source, so the stream need not outlive it.
+ */
+class JS_PUBLIC_API(OffThreadCompileStream)
+{
+  public:
+    enum class Encoding
+    {
+        UTF8,
+
+        // UTF-16 in the platform's byte order.
+        UTF16
+    };
+
+  private:
+    Encoding encoding_;
+    js::Vector<char16_t, 0, js::SystemAllocPolicy> chars_;
+
+    // The bytes at the end of the last chunk which start a code point, or a
+    // UTF-16 code unit, which continues in the next chunk.
+    uint8_t partial_[4];
+    size_t partialLength_;
+
+    bool appendUTF8(const uint8_t* begin, size_t length);
+    bool appendUTF16(const uint8_t* begin, size_t length);
+
+    // Hand over the source collected so far, reporting an error on failure.
+    bool takeChars(JSContext* cx, UniqueTwoByteChars* chars, size_t* length);
+
+  public:
+    explicit OffThreadCompileStream(Encoding encoding)
+      : encoding_(encoding),
+        partialLength_(0)
+    {}
+
+    /* Add the next |length| bytes of the source. Return false on OOM. */
+    MOZ_MUST_USE bool consumeChunk(const uint8_t* begin, size_t length);
+
+    /*
+     * Start parsing the source. A code point left incomplete by the last chunk
+     * is replaced with U+FFFD. Unlike CompileOffThread the parse always runs
+     * off thread, as the embedding can't check CanCompileOffThread before the
+     * length is known. Return false after reporting an error on failure.
+     */
+    MOZ_MUST_USE bool compile(JSContext* cx, const ReadOnlyCompileOptions& options,
+                              OffThreadCompileCallback callback, void* callbackData);
+
+    /* Start parsing the source as JSON, as compile does for a script. */
+    MOZ_MUST_USE bool parseJSON(JSContext* cx, OffThreadCompileCallback callback,
+                                void* callbackData);
+};
+
+/*
+ * Off thread JSON parsing.
+ *
+ * ParseJSONOffThread parses |chars| as JSON.parse does without a reviver, on
+ * a helper thread and in a zone of its own, so that parsing a large response
+ * doesn't block the main thread. The parse takes ownership of |chars|. As for
+ * an off thread compile, the callback is invoked off thread when the parse
+ * finishes, after which one of these must be called on the main thread:
+ *
+ * - FinishOffThreadJSON, to move the parsed value into the current realm. On
+ *   failure the SyntaxError or OOM is reported and false is returned.
+ * - CancelOffThreadJSON, to free the resources without using the value.
+ */
+extern JS_PUBLIC_API(bool)
+CanParseJSONOffThread(JSContext* cx, size_t length);
+
+extern JS_PUBLIC_API(bool)
+ParseJSONOffThread(JSContext* cx, UniqueTwoByteChars chars, size_t length,
+                   OffThreadCompileCallback callback, void* callbackData);
+
+extern JS_PUBLIC_API(bool)
+FinishOffThreadJSON(JSContext* cx, OffThreadToken* token, MutableHandleValue vp);
+
+extern JS_PUBLIC_API(void)
+CancelOffThreadJSON(JSContext* cx, OffThreadToken* token);
+
 extern JS_PUBLIC_API(bool)
 CompileOffThreadModule(JSContext* cx, const ReadOnlyCompileOptions& options,
                        SourceBufferHolder& srcBuf, OffThreadCompileCallback callback,
@@ -109,6 +218,55 @@ FinishMultiOffThreadScriptsDecoder(JSContext* cx, OffThreadToken* token,
 extern JS_PUBLIC_API(void)
 CancelMultiOffThreadScriptsDecoder(JSContext* cx, OffThreadToken* token);
 
+/*
+ * Off thread compilation of a module graph.
+ *
+ * CompileModuleGraph parses the module |rootSpecifier| and every module it
+ * imports, directly or indirectly. Each module is parsed off thread as soon as
+ * the module importing it has been parsed, so the time taken is bounded by the
+ * longest chain of imports rather than by the total size of the graph.
+ * Modules which CanCompileOffThread says are not worth parsing off thread are
+ * parsed on the main thread while it waits for the others.
+ *
+ * This must be called on the runtime's main thread, and returns once the whole
+ * graph has been parsed. On success |modules| holds the source text module
+ * records with the root first, and |keys| the key each of them was resolved
+ * to. The modules have not been instantiated: the embedding should add them
+ * to the map its module resolve hook uses, then call ModuleInstantiate on the
+ * root. On failure an error has been reported and no parses are left running.
+ */
+class JS_PUBLIC_API(ModuleGraphLoader)
+{
+  protected:
+    ModuleGraphLoader() = default;
+    virtual ~ModuleGraphLoader() = default;
+
+  public:
+    /*
+     * Resolve |specifier|, requested by the module which was resolved to
+     * |referrerKey|, or by the embedding if |referrerKey| is null, to a key
+     * identifying the module. Specifiers which resolve to equal keys are
+     * loaded once. Return null after reporting an error on failure.
+     */
+    virtual JSString* resolve(JSContext* cx, HandleString referrerKey,
+                              HandleString specifier) = 0;
+
+    /*
+     * Fetch the source of the module which was resolved to |key|. |options|
+     * starts as a copy of the options passed to CompileModuleGraph and can be
+     * changed, to give the module's filename for example. Return false after
+     * reporting an error on failure.
+     */
+    virtual bool fetch(JSContext* cx, HandleString key, OwningCompileOptions& options,
+                       UniqueTwoByteChars& chars, size_t* length) = 0;
+};
+
+extern JS_PUBLIC_API(bool)
+CompileModuleGraph(JSContext* cx, const ReadOnlyCompileOptions& options,
+                   HandleString rootSpecifier, ModuleGraphLoader& loader,
+                   MutableHandle<GCVector<JSObject*>> modules,
+                   MutableHandle<GCVector<JSString*>> keys);
+
 #if defined(JS_BUILD_BINAST)
 
 extern JS_PUBLIC_API(bool)
@@ -207,12 +207,15 @@ enum TransferableOwnership {
 class CloneDataPolicy
 {
     bool sharedArrayBuffer_;
+    size_t detachArrayBufferThreshold_;
 
   public:
-    // The default is to allow all policy-controlled aspects.
+    // The default is to allow all policy-controlled aspects, and to copy the
+    // contents of all ArrayBuffers.
 
     CloneDataPolicy() :
-      sharedArrayBuffer_(true)
+      sharedArrayBuffer_(true),
+      detachArrayBufferThreshold_(SIZE_MAX)
     {}
 
     // In the JS engine, SharedArrayBuffers can only be cloned intra-process
@@ -231,6 +234,23 @@ class CloneDataPolicy
     bool isSharedArrayBufferAllowed() const {
         return sharedArrayBuffer_;
     }
+
+    // Cloning an ArrayBuffer normally copies its contents into the clone
+    // data. Clients which clone within a process, and which do not use an
+    // ArrayBuffer again after cloning it, may instead have the contents of
+    // ArrayBuffers of at least |nbytes| bytes moved into the clone data
+    // without copying. Such ArrayBuffers are detached, as if they had been
+    // transferred. ArrayBuffers are always copied for DifferentProcess clones
+    // and when their contents cannot be stolen (as for wasm memories).
+
+    CloneDataPolicy& detachArrayBuffersAtLeast(size_t nbytes) {
+        detachArrayBufferThreshold_ = nbytes;
+        return *this;
+    }
+
+    size_t detachArrayBufferThreshold() const {
+        return detachArrayBufferThreshold_;
+    }
 };
 
 } /* namespace JS */
@@ -376,6 +396,32 @@ namespace js
         js::Vector<js::SharedArrayRawBuffer*, 0, js::SystemAllocPolicy> refs_;
     };
 
+    // The contents of ArrayBuffers which were detached into structured clone
+    // data rather than copied (see JS::CloneDataPolicy). The clone data owns
+    // them until they are read.
+    class DetachedArrayBufferContents
+    {
+      public:
+        DetachedArrayBufferContents() = default;
+        DetachedArrayBufferContents(DetachedArrayBufferContents&& other) = default;
+        DetachedArrayBufferContents& operator=(DetachedArrayBufferContents&& other);
+        ~DetachedArrayBufferContents();
+
+        // Make room for one more set of contents, so that adding them once
+        // their ArrayBuffer has been detached can't fail.
+        MOZ_MUST_USE bool reserveOne(JSContext* cx);
+        void infallibleAdd(void* contents);
+
+        // Give up ownership of |contents|, returning false if they are not
+        // owned.
+        MOZ_MUST_USE bool take(void* contents);
+
+        void releaseAll();
+
+      private:
+        js::Vector<void*, 0, js::SystemAllocPolicy> contents_;
+    };
+
     template <typename T, typename AllocPolicy> struct BufferIterator;
 }
 
@@ -403,8 +449,10 @@ class MOZ_NON_MEMMOVABLE JS_PUBLIC_API(JSStructuredCloneData) {
     void* closure_ = nullptr;
     OwnTransferablePolicy ownTransferables_ = OwnTransferablePolicy::NoTransferables;
     js::SharedArrayRawBufferRefs refsHeld_;
+    js::DetachedArrayBufferContents detachedContents_;
 
     friend struct JSStructuredCloneWriter;
+    friend struct JSStructuredCloneReader;
     friend class JS_PUBLIC_API(JSAutoStructuredCloneBuffer);
     template <typename T, typename AllocPolicy> friend struct js::BufferIterator;
 
@@ -495,6 +543,7 @@ class MOZ_NON_MEMMOVABLE JS_PUBLIC_API(JSStructuredCloneData) {
 
     void Clear() {
         discardTransferables();
+        detachedContents_.releaseAll();
         bufList_.Clear();
     }
 
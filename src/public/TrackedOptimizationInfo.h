@@ -201,6 +201,8 @@ namespace JS {
     _(CantInlineBigCallee)                                              \
     _(CantInlineBigCalleeInlinedBytecodeLength)                         \
     _(CantInlineNotHot)                                                 \
+    _(CantInlineColdCallee)                                             \
+    _(CantInlineBigCallSite)                                            \
     _(CantInlineNotInDispatch)                                          \
     _(CantInlineUnreachable)                                            \
     _(CantInlineNativeBadForm)                                          \
@@ -0,0 +1,71 @@
+/* -*- Mode: C++; tab-width: 8; indent-tabs-mode: nil; c-basic-offset: 4 -*-
+ * vim: set ts=8 sts=4 et sw=4 tw=99:
+ * This Source Code Form is subject to the terms of the Mozilla Public
+ * License, v. 2.0. If a copy of the MPL was not distributed with this
+ * file, You can obtain one at http://mozilla.org/MPL/2.0/. */
+
+#ifndef js_UbiNodeSnapshot_h
+#define js_UbiNodeSnapshot_h
+
+#include "mozilla/MemoryReporting.h"
+
+#include <stdio.h>
+
+#include "js/GCAPI.h"
+#include "js/UbiNode.h"
+
+namespace JS {
+namespace ubi {
+
+// Write the graph of the nodes reachable from |root| to |fp|, as a stream of
+// records written while it is traversed breadth first. Apart from the set of
+// nodes the traversal has visited, no memory proportional to the size of the
+// graph is used, so large heaps can be saved without holding a copy of the
+// graph in memory.
+//
+// Every integer in the stream is an unsigned LEB128 varint. The stream starts
+// with the four bytes "UBIS" and the format version, followed by records which
+// each start with a tag:
+//
+//   SnapshotRecord::String, length, UTF-16 code units
+//     Define the next string. Strings are numbered from zero in the order
+//     they're defined, and are only defined before the first use of their
+//     number. Each code unit is a separate varint, so ASCII takes one byte.
+//
+//   SnapshotRecord::Node, id, type name, coarse type, size, class name
+//     A node reached for the first time. The type name is a string number,
+//     and the class name is a string number plus one, or zero if the node is
+//     not a JS object.
+//
+//   SnapshotRecord::Origin, id
+//     The following Edge records are for edges out of the node with this id.
+//
+//   SnapshotRecord::Edge, referent id, name
+//     An edge to the given node. The name is a string number plus one, or zero
+//     if the edge has no name or |wantNames| is false.
+//
+//   SnapshotRecord::End
+//
+// Edges are only written for nodes the traversal has reached, before the node
+// records of the referents reached through them. Returns false on OOM or if
+// writing to |fp| fails.
+enum class SnapshotRecord : uint8_t
+{
+    String = 0,
+    Node,
+    Origin,
+    Edge,
+    End
+};
+
+static const uint32_t SnapshotFormatVersion = 1;
+
+extern JS_PUBLIC_API(bool)
+WriteHeapSnapshot(JSContext* cx, const Node& root, FILE* fp,
+                  mozilla::MallocSizeOf mallocSizeOf, bool wantNames,
+                  const JS::AutoRequireNoGC& noGC);
+
+} // namespace ubi
+} // namespace JS
+
+#endif // js_UbiNodeSnapshot_h